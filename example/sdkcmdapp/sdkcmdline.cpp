@@ -1,11 +1,23 @@
 #include <leafra/leafra_core.h>
 #include <leafra/leafra_chunker.h>
 #include <leafra/types.h>
+#include <leafra/leafra_filemanager.h>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <vector>
 #include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <random>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
 
 using namespace leafra;
 
@@ -20,6 +32,8 @@ using namespace leafra;
  *   ./sdkcmdline                    - Process internal sample document
  *   ./sdkcmdline file1.txt          - Process single file
  *   ./sdkcmdline file1.pdf file2.txt - Process multiple files
+ *   ./sdkcmdline --benchmark corpus/ queries.txt - Ingest + query benchmark, reported as JSON
+ *   ./sdkcmdline --stress           - Growth curves from 1k to 1M chunks per index type (CSV + JSON)
  * 
  * Supported Platforms: macOS, Linux, Windows
  * Not supported: iOS, Android (command line tool for development)
@@ -41,6 +55,22 @@ void print_usage(const char* program_name) {
     std::cout << "  --print_chunks_brief N    - Print first N lines of each chunk" << std::endl;
     std::cout << "  --semantic_search \"query\" [max_results] - Perform semantic search (default: 5 results)" << std::endl;
     std::cout << "  --semantic_search_llm \"query\" [max_results] - Perform semantic search with LLM response generation (default: 5 results)" << std::endl;
+    std::cout << "  --benchmark corpus_dir query_file - Ingest a corpus, replay queries and report JSON metrics" << std::endl;
+    std::cout << "      --iterations N            - Timed passes over the query file (default: 3)" << std::endl;
+    std::cout << "      --warmup N                - Untimed passes before measuring (default: 1)" << std::endl;
+    std::cout << "      --benchmark_llm           - Answer each query with the LLM (time-to-first-token, decode tok/s)" << std::endl;
+    std::cout << "      --benchmark_output file   - Also write the JSON report to a file" << std::endl;
+    std::cout << "      --index_type TYPE         - FAISS index type (FLAT, HNSW, IVF_FLAT, ...)" << std::endl;
+    std::cout << "      --chunk_size N            - Chunk size in tokens" << std::endl;
+    std::cout << "      --batch_size N            - Embedding inference batch size" << std::endl;
+    std::cout << "  --stress                  - Ingest growing corpora per index type and report growth curves (CSV + JSON)" << std::endl;
+    std::cout << "      --stress_sizes LIST       - Corpus sizes in chunks (default: 1000,10000,100000,1000000)" << std::endl;
+    std::cout << "      --stress_index_types LIST - Index types to run (default: FLAT,IVF_FLAT,IVF_PQ,HNSW,SQ8,HNSW_SQ,BINARY)" << std::endl;
+    std::cout << "      --stress_corpus DIR       - Replay these files instead of synthesizing documents" << std::endl;
+    std::cout << "      --stress_queries N        - Searches timed at each size (default: 50)" << std::endl;
+    std::cout << "      --stress_document_chunks N - Chunks per synthesized document (default: 20)" << std::endl;
+    std::cout << "      --stress_output PREFIX    - Write PREFIX.csv and PREFIX.json (default: leafra_stress)" << std::endl;
+    std::cout << "      (--chunk_size and --batch_size apply too)" << std::endl;
     std::cout << "\nSupported file types:" << std::endl;
     std::cout << "  • Text files (.txt)" << std::endl;
     std::cout << "  • PDF files (.pdf)" << std::endl;
@@ -54,6 +84,8 @@ void print_usage(const char* program_name) {
     std::cout << "  " << program_name << " --print_chunks_brief 3 doc.txt # Process and show first 3 lines of each chunk" << std::endl;
     std::cout << "  " << program_name << " --semantic_search \"machine learning\"     # Search indexed content (5 results)" << std::endl;
     std::cout << "  " << program_name << " --semantic_search \"AI technology\" 10  # Search with 10 results" << std::endl;
+    std::cout << "  " << program_name << " --benchmark corpus/ queries.txt --iterations 5 --benchmark_output bench.json" << std::endl;
+    std::cout << "  " << program_name << " --stress --stress_sizes 1000,10000,100000 --stress_index_types FLAT,HNSW" << std::endl;
 }
 
 void create_sample_text_file(const std::string& filename) {
@@ -157,6 +189,709 @@ bool file_exists(const std::string& filename) {
     return file.good();
 }
 
+// ==============================================================================
+// Benchmark mode
+// ==============================================================================
+
+struct BenchmarkOptions {
+    std::string corpus_dir;
+    std::string query_file;
+    std::string output_path;
+    int iterations = 3;
+    int warmup = 1;
+    bool llm = false;
+    int max_results = 5;
+    std::string index_type;     // Empty keeps the default configuration
+    int chunk_size = 0;
+    int batch_size = 0;
+};
+
+// Benchmark runs use their own database so earlier runs never make the corpus look unchanged
+static const char* kBenchmarkDatabaseName = "leafra_benchmark.db";
+
+std::vector<std::string> collect_corpus_files(const std::string& directory) {
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file(ec) && it->path().filename().string()[0] != '.') {
+            files.push_back(it->path().string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+std::vector<std::string> read_query_file(const std::string& path) {
+    std::vector<std::string> queries;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty() && line[0] != '#') {
+            queries.push_back(line);
+        }
+    }
+    return queries;
+}
+
+// Remove the benchmark database and the index files stored next to it
+void remove_benchmark_database(const std::string& name = kBenchmarkDatabaseName) {
+    std::filesystem::path db_path = FileManager::getAbsolutePath(StorageType::AppStorage, name);
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(db_path.parent_path(), ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().filename().string().rfind(name, 0) == 0) {
+            std::filesystem::remove(it->path(), ec);
+        }
+    }
+}
+
+double peak_rss_mb() {
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);  // bytes
+#else
+        return static_cast<double>(usage.ru_maxrss) / 1024.0;             // kilobytes
+#endif
+    }
+#endif
+    return 0.0;
+}
+
+double elapsed_ms_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Nearest-rank percentile of sorted values
+double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+std::string json_escape(const std::string& value) {
+    std::string out;
+    for (char c : value) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) >= 0x20) {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+std::string latency_json(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (double sample : samples) {
+        total += sample;
+    }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3)
+        << "{\"count\": " << samples.size()
+        << ", \"mean_ms\": " << (samples.empty() ? 0.0 : total / samples.size())
+        << ", \"p50_ms\": " << percentile(samples, 0.50)
+        << ", \"p95_ms\": " << percentile(samples, 0.95)
+        << ", \"p99_ms\": " << percentile(samples, 0.99)
+        << ", \"max_ms\": " << (samples.empty() ? 0.0 : samples.back()) << "}";
+    return oss.str();
+}
+
+int run_benchmark(const std::shared_ptr<LeafraCore>& sdk, Config config, const BenchmarkOptions& options) {
+    print_separator("Benchmark");
+    std::vector<std::string> corpus = collect_corpus_files(options.corpus_dir);
+    std::vector<std::string> queries = read_query_file(options.query_file);
+    if (corpus.empty()) {
+        std::cerr << "❌ Error: No files found in corpus directory: " << options.corpus_dir << std::endl;
+        return 1;
+    }
+    if (queries.empty()) {
+        std::cerr << "❌ Error: No queries found in query file: " << options.query_file << std::endl;
+        return 1;
+    }
+    std::cout << "📁 Corpus: " << corpus.size() << " file(s) in " << options.corpus_dir << std::endl;
+    std::cout << "🔎 Queries: " << queries.size() << " x " << options.iterations << " iteration(s), "
+              << options.warmup << " warm-up" << std::endl;
+
+    // Per-message logging would dominate the timings
+    config.debug_mode = false;
+    config.chunking.print_chunks_full = false;
+    config.chunking.print_chunks_brief = false;
+    config.leafra_document_database_name = kBenchmarkDatabaseName;
+    if (!options.index_type.empty()) {
+        config.vector_search.index_type = options.index_type;
+    }
+    if (options.chunk_size > 0) {
+        config.chunking.chunk_size = options.chunk_size;
+    }
+    if (options.batch_size > 0) {
+        config.embedding_inference.batch_size = options.batch_size;
+    }
+    config.llm.enabled = options.llm;
+
+    remove_benchmark_database();
+    if (sdk->initialize(config) != ResultCode::SUCCESS) {
+        std::cerr << "❌ Failed to initialize SDK!" << std::endl;
+        return 1;
+    }
+
+    // Ingestion
+    std::cout << "⏱️  Ingesting corpus..." << std::endl;
+    sdk->reset_metrics();
+    auto ingest_start = std::chrono::steady_clock::now();
+    ResultCode ingest_result = sdk->process_user_files(corpus);
+    double ingest_ms = elapsed_ms_since(ingest_start);
+    PipelineMetrics ingest_metrics = sdk->get_metrics();
+    uint64_t documents = ingest_metrics.stage(PipelineStage::PARSE).count;
+    uint64_t chunks = ingest_metrics.stage(PipelineStage::CHUNK).items;
+    double ingest_seconds = ingest_ms / 1000.0;
+    std::cout << "✅ Ingested " << documents << " document(s), " << chunks << " chunk(s) in "
+              << std::fixed << std::setprecision(2) << ingest_seconds << " s" << std::endl;
+
+    // Queries: warm-up passes prime caches and lazily loaded models; timed passes follow
+    std::vector<double> latencies;
+    std::vector<double> first_token_latencies;
+    uint64_t decoded_tokens = 0;
+    double decode_ms = 0.0;
+    int failed_queries = 0;
+    sdk->clear_search_cache();
+    for (int pass = 0; pass < options.warmup + options.iterations; ++pass) {
+        bool timed = pass >= options.warmup;
+        if (pass == options.warmup) {
+            sdk->reset_metrics();
+            std::cout << "⏱️  Running timed query passes..." << std::endl;
+        }
+        for (const auto& query : queries) {
+            // Identical queries would otherwise be answered from the result cache after the first pass
+            sdk->clear_search_cache();
+            std::vector<FaissIndex::SearchResult> results;
+            ResultCode result;
+            auto query_start = std::chrono::steady_clock::now();
+            if (options.llm) {
+                std::chrono::steady_clock::time_point first_token;
+                uint64_t tokens = 0;
+                auto token_callback = [&first_token, &tokens](const std::string& token, bool is_final) -> bool {
+                    if (!token.empty()) {
+                        if (tokens++ == 0) {
+                            first_token = std::chrono::steady_clock::now();
+                        }
+                    }
+                    return true;
+                };
+                result = sdk->semantic_search_with_llm(query, options.max_results, results, token_callback);
+                if (timed && result == ResultCode::SUCCESS && tokens > 0) {
+                    first_token_latencies.push_back(std::chrono::duration<double, std::milli>(first_token - query_start).count());
+                    decoded_tokens += tokens - 1;
+                    decode_ms += elapsed_ms_since(first_token);
+                }
+            } else {
+                result = sdk->semantic_search(query, options.max_results, results);
+            }
+            double latency_ms = elapsed_ms_since(query_start);
+            if (!timed) {
+                continue;
+            }
+            if (result == ResultCode::SUCCESS) {
+                latencies.push_back(latency_ms);
+            } else {
+                failed_queries++;
+            }
+        }
+    }
+    PipelineMetrics query_metrics = sdk->get_metrics();
+
+    // Report
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n";
+    json << "  \"sdk_version\": \"" << json_escape(LeafraCore::get_version()) << "\",\n";
+    json << "  \"platform\": \"" << json_escape(LeafraCore::get_platform()) << "\",\n";
+    json << "  \"config\": {\"index_type\": \"" << json_escape(config.vector_search.index_type)
+         << "\", \"chunk_size\": " << config.chunking.chunk_size
+         << ", \"overlap_percentage\": " << config.chunking.overlap_percentage
+         << ", \"embedding_framework\": \"" << json_escape(config.embedding_inference.framework)
+         << "\", \"embedding_batch_size\": " << config.embedding_inference.batch_size
+         << ", \"max_threads\": " << config.max_threads
+         << ", \"max_results\": " << options.max_results
+         << ", \"llm\": " << (options.llm ? "true" : "false") << "},\n";
+    json << "  \"ingest\": {\"files\": " << corpus.size()
+         << ", \"documents\": " << documents
+         << ", \"chunks\": " << chunks
+         << ", \"seconds\": " << ingest_seconds
+         << ", \"docs_per_second\": " << (ingest_seconds > 0.0 ? documents / ingest_seconds : 0.0)
+         << ", \"chunks_per_second\": " << (ingest_seconds > 0.0 ? chunks / ingest_seconds : 0.0)
+         << ", \"success\": " << (ingest_result == ResultCode::SUCCESS ? "true" : "false") << "},\n";
+    json << "  \"queries\": {\"distinct\": " << queries.size()
+         << ", \"iterations\": " << options.iterations
+         << ", \"warmup\": " << options.warmup
+         << ", \"failed\": " << failed_queries
+         << ", \"latency\": " << latency_json(latencies) << "},\n";
+    if (options.llm) {
+        json << "  \"llm\": {\"time_to_first_token\": " << latency_json(first_token_latencies)
+             << ", \"decoded_tokens\": " << decoded_tokens
+             << ", \"decode_tokens_per_second\": " << (decode_ms > 0.0 ? decoded_tokens * 1000.0 / decode_ms : 0.0) << "},\n";
+    }
+    json << "  \"stages\": [";
+    bool first_stage = true;
+    for (const PipelineMetrics* metrics : {&ingest_metrics, &query_metrics}) {
+        for (const StageMetrics& stage : metrics->stages) {
+            if (stage.count == 0) {
+                continue;
+            }
+            json << (first_stage ? "\n" : ",\n");
+            first_stage = false;
+            json << "    {\"phase\": \"" << (metrics == &ingest_metrics ? "ingest" : "query")
+                 << "\", \"name\": \"" << stage.name << "\", \"count\": " << stage.count
+                 << ", \"items\": " << stage.items << ", \"total_ms\": " << stage.total_ms
+                 << ", \"p50_ms\": " << stage.p50_ms << ", \"p95_ms\": " << stage.p95_ms
+                 << ", \"p99_ms\": " << stage.p99_ms << ", \"max_ms\": " << stage.max_ms << "}";
+        }
+    }
+    json << "\n  ],\n";
+    json << "  \"peak_rss_mb\": " << peak_rss_mb() << "\n";
+    json << "}\n";
+
+    sdk->shutdown();
+    remove_benchmark_database();
+
+    print_separator("Benchmark Results");
+    std::cout << json.str();
+    if (!options.output_path.empty()) {
+        std::ofstream output(options.output_path);
+        output << json.str();
+        if (!output.good()) {
+            std::cerr << "❌ Error: Could not write benchmark report: " << options.output_path << std::endl;
+            return 1;
+        }
+        std::cout << "📄 Benchmark report written to " << options.output_path << std::endl;
+    }
+    return ingest_result == ResultCode::SUCCESS && failed_queries == 0 ? 0 : 1;
+} //run_benchmark
+
+// ==============================================================================
+// Stress mode
+// ==============================================================================
+
+struct StressOptions {
+    std::vector<size_t> sizes = {1000, 10000, 100000, 1000000};    // Corpus sizes in chunks, reached one after another
+    std::vector<std::string> index_types = {"FLAT", "IVF_FLAT", "IVF_PQ", "HNSW", "SQ8", "HNSW_SQ", "BINARY"};
+    std::string corpus_dir;         // Replay these files (cycled, copied under new names) instead of synthesizing text
+    std::string output_prefix = "leafra_stress";    // Growth curves go to <prefix>.csv and <prefix>.json
+    int queries = 50;               // Searches timed at each size
+    int document_chunks = 20;       // Chunks per synthesized document
+    int page_bytes = 4096;          // Page size of synthesized documents (parsing.text_page_bytes)
+    int max_results = 5;
+    int chunk_size = 0;             // 0 keeps the default configuration
+    int batch_size = 0;
+};
+
+// One corpus size of one index type
+struct StressRow {
+    std::string index_type;
+    size_t target_chunks = 0;
+    uint64_t documents = 0;         // Cumulative
+    uint64_t chunks = 0;            // Cumulative
+    uint64_t step_chunks = 0;       // Added since the previous size
+    double step_ingest_seconds = 0.0;
+    double ingest_ms_per_chunk = 0.0;   // Flat when ingest scales linearly
+    double faiss_add_p95_ms = 0.0;  // Per document
+    uint64_t faiss_saves = 0;       // Full index snapshots during the step
+    double faiss_save_mean_ms = 0.0;
+    double faiss_save_max_ms = 0.0;
+    double search_p50_ms = 0.0;
+    double search_p95_ms = 0.0;
+    double search_p99_ms = 0.0;
+    int failed_queries = 0;
+    uint64_t index_memory_bytes = 0;
+    uint64_t db_bytes = 0;          // Database, WAL and index files
+    double peak_rss_mb = 0.0;
+    std::string error;
+};
+
+static const char* kStressDatabaseName = "leafra_stress.db";
+
+// Growth exponents above these flag a metric as scaling worse than expected
+static constexpr double kFlatExponentLimit = 0.25;     // Per-chunk costs should not grow with the corpus
+static constexpr double kLinearExponentLimit = 1.25;   // Totals (memory, DB size, snapshot time) and FLAT search grow at most linearly
+
+std::vector<std::string> split_list(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Bytes of the database and every file stored next to it under its name (WAL, index files)
+uint64_t database_files_bytes(const std::string& name) {
+    std::filesystem::path db_path = FileManager::getAbsolutePath(StorageType::AppStorage, name);
+    uint64_t bytes = 0;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(db_path.parent_path(), ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().filename().string().rfind(name, 0) == 0 && it->is_regular_file(ec)) {
+            bytes += it->file_size(ec);
+        }
+    }
+    return bytes;
+}
+
+/**
+ * Deterministic text from a fixed pseudo-word vocabulary, so every run and index type
+ * ingests the same corpus and queries share words with it
+ */
+class StressCorpus {
+public:
+    explicit StressCorpus(uint32_t seed) : rng_(seed) {
+        static const char* kSyllables[] = {"ka", "lo", "mi", "ra", "te", "su", "no", "vi", "de", "pa", "shi", "qu",
+                                           "ber", "tan", "gor", "mel", "fin", "dra", "cor", "lun", "sta", "vex", "ul", "om"};
+        const size_t syllables = sizeof(kSyllables) / sizeof(kSyllables[0]);
+        for (size_t i = 0; i < 4096; ++i) {
+            std::string word;
+            size_t length = 2 + rng_() % 3;
+            for (size_t s = 0; s < length; ++s) {
+                word += kSyllables[rng_() % syllables];
+            }
+            vocabulary_.push_back(word);
+        }
+    }
+
+    std::string document(size_t words) {
+        std::string text;
+        text.reserve(words * 8);
+        // Paragraphs keep to a topic: a window of the vocabulary, so chunks differ from each other
+        size_t topic = zipf_word();
+        for (size_t i = 0; i < words; ++i) {
+            if (i % 120 == 0) {
+                topic = zipf_word();
+                text += i == 0 ? "" : "\n\n";
+            }
+            text += vocabulary_[(topic + rng_() % 64) % vocabulary_.size()];
+            text += (i % 14 == 13) ? ". " : " ";
+        }
+        return text;
+    }
+
+    std::string query() {
+        std::string text;
+        size_t topic = zipf_word();
+        size_t words = 3 + rng_() % 4;
+        for (size_t i = 0; i < words; ++i) {
+            text += (i ? " " : "") + vocabulary_[(topic + rng_() % 64) % vocabulary_.size()];
+        }
+        return text;
+    }
+
+private:
+    // Few topics are common, most are rare, as in real collections
+    size_t zipf_word() {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng_);
+        return static_cast<size_t>(std::pow(u, 3.0) * static_cast<double>(vocabulary_.size()));
+    }
+
+    std::mt19937 rng_;
+    std::vector<std::string> vocabulary_;
+};
+
+std::string stress_csv(const std::vector<StressRow>& rows) {
+    std::ostringstream csv;
+    csv << std::fixed << std::setprecision(3);
+    csv << "index_type,target_chunks,documents,chunks,step_chunks,step_ingest_seconds,ingest_ms_per_chunk,"
+        << "faiss_add_p95_ms,faiss_saves,faiss_save_mean_ms,faiss_save_max_ms,search_p50_ms,search_p95_ms,search_p99_ms,"
+        << "failed_queries,index_memory_bytes,db_bytes,peak_rss_mb,error\n";
+    for (const StressRow& row : rows) {
+        csv << row.index_type << "," << row.target_chunks << "," << row.documents << "," << row.chunks << ","
+            << row.step_chunks << "," << row.step_ingest_seconds << "," << row.ingest_ms_per_chunk << ","
+            << row.faiss_add_p95_ms << "," << row.faiss_saves << "," << row.faiss_save_mean_ms << ","
+            << row.faiss_save_max_ms << "," << row.search_p50_ms << "," << row.search_p95_ms << ","
+            << row.search_p99_ms << "," << row.failed_queries << "," << row.index_memory_bytes << ","
+            << row.db_bytes << "," << row.peak_rss_mb << ",\"" << row.error << "\"\n";
+    }
+    return csv.str();
+}
+
+// Log-log slope of each metric between consecutive sizes of an index type: 1 is linear, 0 flat
+std::string stress_growth_json(const std::vector<StressRow>& rows, int& flagged) {
+    struct Curve {
+        const char* metric;
+        double (*value)(const StressRow&);
+        double limit;
+    };
+    static const Curve kCurves[] = {
+        {"ingest_ms_per_chunk", [](const StressRow& row) { return row.ingest_ms_per_chunk; }, kFlatExponentLimit},
+        {"faiss_save_mean_ms", [](const StressRow& row) { return row.faiss_save_mean_ms; }, kLinearExponentLimit},
+        {"search_p50_ms", [](const StressRow& row) { return row.search_p50_ms; }, kLinearExponentLimit},
+        {"index_memory_bytes", [](const StressRow& row) { return static_cast<double>(row.index_memory_bytes); }, kLinearExponentLimit},
+        {"db_bytes", [](const StressRow& row) { return static_cast<double>(row.db_bytes); }, kLinearExponentLimit},
+    };
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    bool first = true;
+    flagged = 0;
+    for (size_t i = 1; i < rows.size(); ++i) {
+        const StressRow& from = rows[i - 1];
+        const StressRow& to = rows[i];
+        if (from.index_type != to.index_type || !from.error.empty() || !to.error.empty() || to.chunks <= from.chunks) {
+            continue;
+        }
+        const double size_ratio = std::log(static_cast<double>(to.chunks) / static_cast<double>(from.chunks));
+        for (const Curve& curve : kCurves) {
+            const double a = curve.value(from);
+            const double b = curve.value(to);
+            if (a <= 0.0 || b <= 0.0) {
+                continue;   // e.g. no snapshot was taken during one of the steps
+            }
+            const double exponent = std::log(b / a) / size_ratio;
+            const bool superlinear = exponent > curve.limit;
+            flagged += superlinear ? 1 : 0;
+            json << (first ? "\n" : ",\n");
+            first = false;
+            json << "    {\"index_type\": \"" << json_escape(to.index_type) << "\", \"metric\": \"" << curve.metric
+                 << "\", \"from_chunks\": " << from.chunks << ", \"to_chunks\": " << to.chunks
+                 << ", \"exponent\": " << exponent << ", \"limit\": " << curve.limit
+                 << ", \"superlinear\": " << (superlinear ? "true" : "false") << "}";
+            if (superlinear) {
+                std::cout << "⚠️  " << to.index_type << " " << curve.metric << " grows as n^" << std::setprecision(2)
+                          << exponent << " from " << from.chunks << " to " << to.chunks << " chunks" << std::endl;
+            }
+        }
+    }
+    json << (first ? "]" : "\n  ]");
+    return "[" + json.str();
+}
+
+int run_stress(const std::shared_ptr<LeafraCore>& sdk, Config config, const StressOptions& options) {
+    print_separator("Stress");
+    std::vector<std::string> replay;
+    if (!options.corpus_dir.empty()) {
+        replay = collect_corpus_files(options.corpus_dir);
+        if (replay.empty()) {
+            std::cerr << "❌ Error: No files found in corpus directory: " << options.corpus_dir << std::endl;
+            return 1;
+        }
+    }
+    std::vector<size_t> sizes = options.sizes;
+    std::sort(sizes.begin(), sizes.end());
+    std::cout << "📈 Sizes:";
+    for (size_t size : sizes) {
+        std::cout << " " << size;
+    }
+    std::cout << " chunks, " << options.index_types.size() << " index type(s), "
+              << (replay.empty() ? "synthesized corpus" : std::to_string(replay.size()) + " replayed file(s)") << std::endl;
+
+    // Per-message logging would dominate the timings
+    config.debug_mode = false;
+    config.chunking.print_chunks_full = false;
+    config.chunking.print_chunks_brief = false;
+    config.leafra_document_database_name = kStressDatabaseName;
+    config.parsing.text_page_bytes = options.page_bytes;
+    config.llm.enabled = false;
+    if (options.chunk_size > 0) {
+        config.chunking.chunk_size = options.chunk_size;
+    }
+    if (options.batch_size > 0) {
+        config.embedding_inference.batch_size = options.batch_size;
+    }
+
+    // Words per synthesized document: chunk_size tokens at about 0.75 words per token, less the overlap
+    const size_t words_per_chunk = std::max<size_t>(1, static_cast<size_t>(
+        static_cast<double>(config.chunking.chunk_size) * (1.0 - config.chunking.overlap_percentage) * 0.75));
+    const std::filesystem::path work_dir = std::filesystem::temp_directory_path() / "leafra_stress_corpus";
+
+    std::vector<StressRow> rows;
+    for (const std::string& index_type : options.index_types) {
+        config.vector_search.index_type = index_type;
+        remove_benchmark_database(kStressDatabaseName);
+        std::error_code ec;
+        std::filesystem::remove_all(work_dir, ec);
+        std::filesystem::create_directories(work_dir, ec);
+        if (sdk->initialize(config) != ResultCode::SUCCESS) {
+            StressRow row;
+            row.index_type = index_type;
+            row.error = "initialize failed";
+            rows.push_back(row);
+            std::cerr << "❌ " << index_type << ": failed to initialize SDK" << std::endl;
+            continue;
+        }
+
+        StressCorpus corpus(42);    // Same corpus and queries for every index type
+        uint64_t documents = 0;
+        uint64_t chunks = 0;
+        size_t next_file = 0;
+        double chunks_per_document = static_cast<double>(replay.empty() ? options.document_chunks : 1);
+        for (size_t target : sizes) {
+            StressRow row;
+            row.index_type = index_type;
+            row.target_chunks = target;
+            sdk->reset_metrics();
+            double ingest_ms = 0.0;
+            uint64_t step_documents = 0;
+            while (chunks < target && row.error.empty()) {
+                // Write the next batch, sized from the chunks per document seen so far
+                size_t batch = static_cast<size_t>(std::ceil(static_cast<double>(target - chunks) / std::max(chunks_per_document, 1.0)));
+                batch = std::min<size_t>(std::max<size_t>(batch, 1), 1000);
+                std::vector<std::string> files;
+                for (size_t i = 0; i < batch; ++i, ++next_file) {
+                    std::filesystem::path file;
+                    if (replay.empty()) {
+                        file = work_dir / ("doc_" + std::to_string(next_file) + ".txt");
+                        std::ofstream out(file);
+                        out << corpus.document(static_cast<size_t>(options.document_chunks) * words_per_chunk);
+                    } else {
+                        // A new name per cycle, so a replayed file counts as a new document every time
+                        const std::filesystem::path source = replay[next_file % replay.size()];
+                        file = work_dir / (std::to_string(next_file) + "_" + source.filename().string());
+                        std::filesystem::copy_file(source, file, std::filesystem::copy_options::overwrite_existing, ec);
+                    }
+                    files.push_back(file.string());
+                }
+                auto start = std::chrono::steady_clock::now();
+                ResultCode result = sdk->process_user_files(files);
+                ingest_ms += elapsed_ms_since(start);
+                for (const std::string& file : files) {
+                    std::filesystem::remove(file, ec);
+                }
+
+                PipelineMetrics metrics = sdk->get_metrics();
+                const uint64_t step_chunks = metrics.stage(PipelineStage::CHUNK).items - row.step_chunks;
+                const uint64_t batch_documents = metrics.stage(PipelineStage::PARSE).count - step_documents;
+                row.step_chunks += step_chunks;
+                step_documents += batch_documents;
+                chunks += step_chunks;
+                documents += batch_documents;
+                if (batch_documents > 0 && step_chunks > 0) {
+                    chunks_per_document = static_cast<double>(step_chunks) / static_cast<double>(batch_documents);
+                }
+                if (result != ResultCode::SUCCESS) {
+                    row.error = "ingest failed";
+                } else if (step_chunks == 0) {
+                    row.error = "corpus stopped growing (files skipped as unchanged or duplicates?)";
+                }
+            }
+            PipelineMetrics ingest_metrics = sdk->get_metrics();
+            row.documents = documents;
+            row.chunks = chunks;
+            row.step_ingest_seconds = ingest_ms / 1000.0;
+            row.ingest_ms_per_chunk = row.step_chunks > 0 ? ingest_ms / static_cast<double>(row.step_chunks) : 0.0;
+            row.faiss_add_p95_ms = ingest_metrics.stage(PipelineStage::FAISS_ADD).p95_ms;
+            const StageMetrics& saves = ingest_metrics.stage(PipelineStage::FAISS_SAVE);
+            row.faiss_saves = saves.count;
+            row.faiss_save_mean_ms = saves.count > 0 ? saves.total_ms / static_cast<double>(saves.count) : 0.0;
+            row.faiss_save_max_ms = saves.max_ms;
+            row.index_memory_bytes = ingest_metrics.memory_usage(MemorySubsystem::FAISS_INDEX).current_bytes;
+
+            // Distinct queries each time; the cache is cleared so every search runs the full path
+            std::vector<double> latencies;
+            for (int q = 0; q < options.queries; ++q) {
+                sdk->clear_search_cache();
+                std::vector<FaissIndex::SearchResult> results;
+                auto start = std::chrono::steady_clock::now();
+                ResultCode result = sdk->semantic_search(corpus.query(), options.max_results, results);
+                double latency_ms = elapsed_ms_since(start);
+                if (result == ResultCode::SUCCESS) {
+                    latencies.push_back(latency_ms);
+                } else {
+                    row.failed_queries++;
+                }
+            }
+            std::sort(latencies.begin(), latencies.end());
+            row.search_p50_ms = percentile(latencies, 0.50);
+            row.search_p95_ms = percentile(latencies, 0.95);
+            row.search_p99_ms = percentile(latencies, 0.99);
+            row.db_bytes = database_files_bytes(kStressDatabaseName);
+            row.peak_rss_mb = peak_rss_mb();
+
+            std::cout << std::fixed << std::setprecision(3) << "📊 " << index_type << " @ " << row.chunks << " chunks: "
+                      << row.ingest_ms_per_chunk << " ms/chunk ingest, search p50 " << row.search_p50_ms << " ms, index "
+                      << (row.index_memory_bytes >> 20) << " MB, DB " << (row.db_bytes >> 20) << " MB"
+                      << (row.error.empty() ? "" : " - " + row.error) << std::endl;
+            rows.push_back(row);
+            if (!row.error.empty()) {
+                break;
+            }
+        }
+        sdk->shutdown();
+        remove_benchmark_database(kStressDatabaseName);
+        std::filesystem::remove_all(work_dir, ec);
+    }
+
+    // Report
+    int flagged = 0;
+    const std::string growth = stress_growth_json(rows, flagged);
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n";
+    json << "  \"sdk_version\": \"" << json_escape(LeafraCore::get_version()) << "\",\n";
+    json << "  \"platform\": \"" << json_escape(LeafraCore::get_platform()) << "\",\n";
+    json << "  \"config\": {\"chunk_size\": " << config.chunking.chunk_size
+         << ", \"overlap_percentage\": " << config.chunking.overlap_percentage
+         << ", \"embedding_framework\": \"" << json_escape(config.embedding_inference.framework)
+         << "\", \"embedding_batch_size\": " << config.embedding_inference.batch_size
+         << ", \"index_storage\": \"" << json_escape(config.vector_search.index_storage)
+         << "\", \"corpus\": \"" << (replay.empty() ? "synthetic" : json_escape(options.corpus_dir))
+         << "\", \"document_chunks\": " << options.document_chunks
+         << ", \"page_bytes\": " << options.page_bytes
+         << ", \"queries\": " << options.queries << "},\n";
+    json << "  \"results\": [";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const StressRow& row = rows[i];
+        json << (i ? ",\n" : "\n");
+        json << "    {\"index_type\": \"" << json_escape(row.index_type) << "\", \"target_chunks\": " << row.target_chunks
+             << ", \"documents\": " << row.documents << ", \"chunks\": " << row.chunks
+             << ", \"step_chunks\": " << row.step_chunks << ", \"step_ingest_seconds\": " << row.step_ingest_seconds
+             << ", \"ingest_ms_per_chunk\": " << row.ingest_ms_per_chunk << ", \"faiss_add_p95_ms\": " << row.faiss_add_p95_ms
+             << ", \"faiss_saves\": " << row.faiss_saves << ", \"faiss_save_mean_ms\": " << row.faiss_save_mean_ms
+             << ", \"faiss_save_max_ms\": " << row.faiss_save_max_ms << ", \"search_p50_ms\": " << row.search_p50_ms
+             << ", \"search_p95_ms\": " << row.search_p95_ms << ", \"search_p99_ms\": " << row.search_p99_ms
+             << ", \"failed_queries\": " << row.failed_queries << ", \"index_memory_bytes\": " << row.index_memory_bytes
+             << ", \"db_bytes\": " << row.db_bytes << ", \"peak_rss_mb\": " << row.peak_rss_mb;
+        if (!row.error.empty()) {
+            json << ", \"error\": \"" << json_escape(row.error) << "\"";
+        }
+        json << "}";
+    }
+    json << "\n  ],\n";
+    json << "  \"growth\": " << growth << "\n";
+    json << "}\n";
+
+    print_separator("Stress Results");
+    std::cout << json.str();
+    bool written = true;
+    for (const auto& output : {std::make_pair(std::string(".json"), json.str()), std::make_pair(std::string(".csv"), stress_csv(rows))}) {
+        std::ofstream file(options.output_prefix + output.first);
+        file << output.second;
+        if (!file.good()) {
+            std::cerr << "❌ Error: Could not write stress report: " << options.output_prefix << output.first << std::endl;
+            written = false;
+        }
+    }
+    if (written) {
+        std::cout << "📄 Growth curves written to " << options.output_prefix << ".csv and " << options.output_prefix << ".json" << std::endl;
+    }
+    if (flagged > 0) {
+        std::cout << "⚠️  " << flagged << " metric(s) grew faster than expected (see \"growth\")" << std::endl;
+    }
+    bool failed = !written;
+    for (const StressRow& row : rows) {
+        failed = failed || !row.error.empty() || row.failed_queries > 0;
+    }
+    return failed ? 1 : 0;
+} //run_stress
+
 int main(int argc, char* argv[]) {
     print_separator("LeafraSDK Command Line Application");
     
@@ -170,6 +905,29 @@ int main(int argc, char* argv[]) {
     bool semantic_search_llm_mode = false;
     std::string search_query;
     int max_results = 5;
+    bool benchmark_mode = false;
+    BenchmarkOptions benchmark;
+    bool stress_mode = false;
+    StressOptions stress;
+    
+    // Read the non-negative number following option argv[i]
+    auto read_count = [argc, argv](int& i, int& value) -> bool {
+        std::string option = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "❌ Error: " << option << " requires a number argument" << std::endl;
+            return false;
+        }
+        try {
+            value = std::stoi(argv[++i]);
+        } catch (const std::exception& e) {
+            value = -1;
+        }
+        if (value < 0) {
+            std::cerr << "❌ Error: Invalid number for " << option << ": " << argv[i] << std::endl;
+            return false;
+        }
+        return true;
+    };
     
     // Parse arguments
     for (int i = 1; i < argc; i++) {
@@ -178,6 +936,85 @@ int main(int argc, char* argv[]) {
         if (arg == "-h" || arg == "--help" || arg == "help") {
             print_usage(argv[0]);
             return 0;
+        } else if (arg == "--benchmark") {
+            if (i + 2 >= argc) {
+                std::cerr << "❌ Error: --benchmark requires a corpus directory and a query file" << std::endl;
+                return 1;
+            }
+            benchmark.corpus_dir = argv[++i];
+            benchmark.query_file = argv[++i];
+            if (!std::filesystem::is_directory(benchmark.corpus_dir)) {
+                std::cerr << "❌ Error: Corpus directory not found: " << benchmark.corpus_dir << std::endl;
+                return 1;
+            }
+            if (!file_exists(benchmark.query_file)) {
+                std::cerr << "❌ Error: Query file not found: " << benchmark.query_file << std::endl;
+                return 1;
+            }
+            benchmark_mode = true;
+            demo_mode = false;
+        } else if (arg == "--iterations") {
+            if (!read_count(i, benchmark.iterations)) {
+                return 1;
+            }
+        } else if (arg == "--warmup") {
+            if (!read_count(i, benchmark.warmup)) {
+                return 1;
+            }
+        } else if (arg == "--chunk_size") {
+            if (!read_count(i, benchmark.chunk_size)) {
+                return 1;
+            }
+        } else if (arg == "--batch_size") {
+            if (!read_count(i, benchmark.batch_size)) {
+                return 1;
+            }
+        } else if (arg == "--benchmark_llm") {
+            benchmark.llm = true;
+        } else if (arg == "--stress") {
+            stress_mode = true;
+            demo_mode = false;
+        } else if (arg == "--stress_queries") {
+            if (!read_count(i, stress.queries)) {
+                return 1;
+            }
+        } else if (arg == "--stress_document_chunks") {
+            if (!read_count(i, stress.document_chunks)) {
+                return 1;
+            }
+        } else if (arg == "--stress_sizes" || arg == "--stress_index_types" || arg == "--stress_corpus" || arg == "--stress_output") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ Error: " << arg << " requires an argument" << std::endl;
+                return 1;
+            }
+            std::string value = argv[++i];
+            if (arg == "--stress_sizes") {
+                stress.sizes.clear();
+                for (const std::string& size : split_list(value)) {
+                    try {
+                        stress.sizes.push_back(static_cast<size_t>(std::stoull(size)));
+                    } catch (const std::exception& e) {
+                        std::cerr << "❌ Error: Invalid corpus size: " << size << std::endl;
+                        return 1;
+                    }
+                }
+            } else if (arg == "--stress_index_types") {
+                stress.index_types = split_list(value);
+            } else if (arg == "--stress_corpus") {
+                if (!std::filesystem::is_directory(value)) {
+                    std::cerr << "❌ Error: Corpus directory not found: " << value << std::endl;
+                    return 1;
+                }
+                stress.corpus_dir = value;
+            } else {
+                stress.output_prefix = value;
+            }
+        } else if (arg == "--benchmark_output" || arg == "--index_type") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ Error: " << arg << " requires an argument" << std::endl;
+                return 1;
+            }
+            (arg == "--index_type" ? benchmark.index_type : benchmark.output_path) = argv[++i];
         } else if (arg == "--print_chunks_full") {
             print_chunks_full = true;
         } else if (arg == "--print_chunks_brief") {
@@ -262,7 +1099,7 @@ int main(int argc, char* argv[]) {
         }
     }
     
-    if (input_files.empty() && !demo_mode && !semantic_search_mode) {
+    if (input_files.empty() && !demo_mode && !semantic_search_mode && !benchmark_mode && !stress_mode) {
         std::cerr << "❌ Error: No valid files found!" << std::endl;
         print_usage(argv[0]);
         return 1;
@@ -277,6 +1114,10 @@ int main(int argc, char* argv[]) {
             create_sample_text_file(sample_file);
             input_files.push_back(sample_file);
             std::cout << "📄 Demo Mode: Created sample document: " << sample_file << std::endl;
+        } else if (benchmark_mode) {
+            std::cout << "⏱️  Benchmark Mode: " << benchmark.corpus_dir << " / " << benchmark.query_file << std::endl;
+        } else if (stress_mode) {
+            std::cout << "📈 Stress Mode: " << (stress.corpus_dir.empty() ? "synthesized corpus" : stress.corpus_dir) << std::endl;
         } else if (semantic_search_mode) {
             // Semantic search mode - no files needed, searches indexed content
             std::cout << "🔍 Semantic Search Mode: Searching indexed content" << std::endl;
@@ -357,7 +1198,7 @@ int main(int argc, char* argv[]) {
         std::cout << "Application: " << config.name << std::endl;
         std::cout << "Platform: Desktop (macOS/Linux/Windows)" << std::endl;
         std::cout << "Purpose: End-to-end SDK testing and development" << std::endl;
-        std::cout << "Mode: " << (demo_mode ? "Demo (sample document)" : "User files") << std::endl;
+        std::cout << "Mode: " << (demo_mode ? "Demo (sample document)" : benchmark_mode ? "Benchmark" : stress_mode ? "Stress" : "User files") << std::endl;
         std::cout << "Files to process: " << input_files.size() << std::endl;
         std::cout << "Chunking Enabled: " << (config.chunking.enabled ? "Yes" : "No") << std::endl;
         std::cout << "Chunk Size: " << config.chunking.chunk_size << " tokens" << std::endl;
@@ -373,6 +1214,24 @@ int main(int argc, char* argv[]) {
         std::cout << "Embedding Model Path: " << config.embedding_inference.model_path << std::endl;
         
         
+        if (benchmark_mode) {
+            benchmark.max_results = max_results;
+            return run_benchmark(sdk, config, benchmark);
+        }
+        if (stress_mode) {
+            stress.max_results = max_results;
+            stress.chunk_size = benchmark.chunk_size;
+            stress.batch_size = benchmark.batch_size;
+            if (!benchmark.index_type.empty()) {
+                stress.index_types = {benchmark.index_type};
+            }
+            if (stress.sizes.empty() || stress.index_types.empty() || stress.document_chunks == 0) {
+                std::cerr << "❌ Error: --stress needs at least one size, index type and chunk per document" << std::endl;
+                return 1;
+            }
+            return run_stress(sdk, config, stress);
+        }
+        
         // Set up event callback to monitor SDK operations
         std::vector<std::string> events;
         sdk->set_event_callback([&events](const std::string& event) {
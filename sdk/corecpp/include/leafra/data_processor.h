@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types.h"
+#include <functional>
 
 namespace leafra {
 
@@ -19,15 +20,34 @@ enum class ProcessingAlgorithm {
  */
 struct ProcessingOptions {
     ProcessingAlgorithm algorithm = ProcessingAlgorithm::SIMPLE_TRANSFORM;
-    byte_t threshold = 128;
-    size_t buffer_size = 1024;
+    byte_t threshold = 128;                 // FILTER: bytes below this are dropped
+    size_t buffer_size = 1024;              // process_stream: bytes read per step (0 = DataProcessor::get_buffer_size())
 };
 
 /**
- * @brief Data processing utility class
+ * @brief Byte transform stage for raw payloads before parsing
+ *
+ * Every algorithm runs as a SIMD kernel (SSE2/SSSE3 on x86, NEON on ARM): SIMPLE_TRANSFORM
+ * adds one to each byte, ACCUMULATE is a running byte sum (an in-register prefix sum per 16
+ * bytes), FILTER keeps bytes at or above the threshold (compress-store through a shuffle
+ * table). Output goes into caller memory or into a vector whose capacity is reused, and the
+ * span overloads accept output == input to transform in place.
+ *
+ * Example usage:
+ *
+ * DataProcessor processor;
+ * ProcessingOptions options;
+ * options.algorithm = ProcessingAlgorithm::FILTER;
+ * processor.process_in_place(payload, options);              // payload shrinks to the kept bytes
+ * processor.process_stream(read_from_file, write_to_parser, options);
  */
 class LEAFRA_API DataProcessor {
 public:
+    // Fill up to capacity bytes; return how many were read (0 at the end of the input)
+    using ReadFn = std::function<size_t(byte_t* data, size_t capacity)>;
+    // Consume one processed block; return false to stop the stream
+    using WriteFn = std::function<bool(const byte_t* data, size_t size)>;
+    
     DataProcessor();
     ~DataProcessor();
     
@@ -56,9 +76,39 @@ public:
                                data_buffer_t& output,
                                const ProcessingOptions& options);
     
+    /**
+     * @brief Process a buffer into caller memory
+     * @param input Input bytes
+     * @param size Number of input bytes
+     * @param output At least size bytes; may be input itself (in place)
+     * @param output_size Set to the bytes written (fewer than size only for FILTER)
+     * @param options Processing options
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode process(const byte_t* input, size_t size, byte_t* output, size_t& output_size,
+                       const ProcessingOptions& options);
+    
+    /**
+     * @brief Process a buffer in place, resizing it to the output (capacity kept)
+     * @param data Buffer to transform
+     * @param options Processing options
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode process_in_place(data_buffer_t& data, const ProcessingOptions& options);
+    
+    /**
+     * @brief Stream input through the stage one buffer_size block at a time
+     * @param read Source of input blocks, read into one reused buffer
+     * @param write Sink for each processed block (the data is only valid during the call)
+     * @param options Processing options; ACCUMULATE carries its sum across blocks
+     * @return ERROR_INVALID_PARAMETER for REVERSE (needs the whole input) or missing callbacks,
+     *         ERROR_PROCESSING_FAILED if write stopped the stream
+     */
+    ResultCode process_stream(const ReadFn& read, const WriteFn& write, const ProcessingOptions& options);
+    
     /**
      * @brief Get number of processed items
-     * @return Number of processed items
+     * @return Number of input bytes processed since the last reset_statistics()
      */
     size_t get_processed_count() const;
     
@@ -83,6 +133,7 @@ public:
 private:
     size_t processed_count_ = 0;
     size_t buffer_size_ = 1024;
+    data_buffer_t stream_buffer_;           // process_stream block, reused across calls
 };
 
 } // namespace leafra 
\ No newline at end of file
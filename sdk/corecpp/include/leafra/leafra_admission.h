@@ -0,0 +1,145 @@
+#pragma once
+
+#include "types.h"
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief Resources whose concurrent use is bounded by the AdmissionController
+ */
+enum class AdmissionResource : int32_t {
+    EMBEDDER = 0,       // Embedding model calls (query embeds, ingestion batches)
+    INDEX = 1,          // Vector index searches
+    LLM = 2,            // LLM calls (RAG answers, llm_inference)
+    COUNT = 3
+};
+
+/**
+ * @brief Name of a resource as reported in AdmissionMetrics::name ("embedder", "index", "llm")
+ */
+LEAFRA_API const char* admission_resource_name(AdmissionResource resource);
+
+/**
+ * @brief Priority lane a request waits in; interactive requests are admitted ahead of bulk work
+ */
+enum class AdmissionLane : int32_t {
+    INTERACTIVE = 0,    // Searches and generations a user is waiting for
+    BULK = 1            // Ingestion
+};
+
+/**
+ * @brief Queue depth and waiting time of one resource
+ */
+struct LEAFRA_API AdmissionMetrics {
+    std::string name;
+    size_t slots = 0;                   // Concurrent users allowed (0 = unbounded)
+    size_t in_flight = 0;               // Current users
+    size_t queued_interactive = 0;      // Interactive requests waiting now
+    size_t queued_bulk = 0;             // Bulk requests waiting now
+    size_t peak_queued = 0;             // High-water mark of both lanes together
+    uint64_t admitted = 0;              // Requests admitted since startup or the last reset
+    uint64_t rejected = 0;              // Interactive requests turned away because the lane was full
+    double total_wait_ms = 0.0;         // Time admitted requests spent queued
+    double max_wait_ms = 0.0;
+};
+
+/**
+ * @brief Bounds how many callers use each resource at once, serving interactive requests first
+ *
+ * LeafraCore's entry points run on whatever thread calls them, so a burst of searches with an
+ * ingestion in the background would otherwise oversubscribe the embedder and the LLM and make
+ * every request slow. Each use of a resource holds a Permit: when all of the resource's slots
+ * are taken the caller waits, interactive callers in arrival order ahead of any bulk caller,
+ * which only gets a slot when no interactive one is waiting. Once max_queued interactive
+ * callers are waiting for a resource, further ones are turned away at once (the caller reports
+ * ERROR_BUSY), so overload shows up as fast failures rather than ever longer queues. Bulk
+ * callers always wait; their number is bounded by the ingestion workers.
+ *
+ * Example usage:
+ *
+ * AdmissionController::Permit permit(admission, AdmissionResource::EMBEDDER, AdmissionLane::INTERACTIVE);
+ * if (!permit.admitted()) {
+ *     return ResultCode::ERROR_BUSY;
+ * }
+ * embed(query);
+ */
+class LEAFRA_API AdmissionController {
+public:
+    struct Options {
+        bool enabled = true;                    // false: every permit is admitted at once (still counted)
+        std::array<size_t, static_cast<size_t>(AdmissionResource::COUNT)> slots{{1, 4, 1}};  // Per resource (0 = unbounded)
+        size_t max_queued = 32;                 // Interactive callers waiting per resource before new ones are rejected (0 = no limit)
+    };
+
+    AdmissionController() = default;
+
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    /**
+     * @brief Set the slots and queue limit; waiters are re-evaluated against the new slots
+     */
+    void configure(const Options& options);
+    Options options() const;
+
+    /**
+     * @brief Queue depth and waits of every resource (index = AdmissionResource)
+     */
+    std::vector<AdmissionMetrics> snapshot() const;
+
+    /**
+     * @brief Restart the counters, waits and high-water marks
+     */
+    void reset();
+
+    /**
+     * @brief One use of a resource: waits for a slot on construction, frees it on destruction
+     */
+    class LEAFRA_API Permit {
+    public:
+        Permit(AdmissionController& controller, AdmissionResource resource, AdmissionLane lane);
+        ~Permit();
+        Permit(const Permit&) = delete;
+        Permit& operator=(const Permit&) = delete;
+
+        // false if the lane was full; the caller must not use the resource then
+        bool admitted() const { return admitted_; }
+        double wait_ms() const { return wait_ms_; }
+
+    private:
+        AdmissionController& controller_;
+        size_t resource_;
+        bool admitted_ = false;
+        double wait_ms_ = 0.0;
+    };
+
+private:
+    struct ResourceState {
+        size_t in_flight = 0;
+        std::deque<uint64_t> queued[2];         // Tickets waiting, per AdmissionLane
+        size_t peak_queued = 0;
+        uint64_t admitted = 0;
+        uint64_t rejected = 0;
+        double total_wait_ms = 0.0;
+        double max_wait_ms = 0.0;
+    };
+
+    // Callers hold mutex_
+    bool has_slot_locked(size_t resource) const;
+
+    mutable std::mutex mutex_;
+    std::condition_variable released_cv_;
+    Options options_;
+    std::array<ResourceState, static_cast<size_t>(AdmissionResource::COUNT)> resources_;
+    uint64_t next_ticket_ = 0;
+};
+
+} // namespace leafra
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief Monotonic bump allocator for objects that all die together
+ *
+ * Allocations are carved out of a few blocks that double in size, and are never freed one
+ * by one: release() or destruction frees everything in one shot. The ingestion pipeline
+ * gives each document its own arena, so the thousands of small strings and vectors a
+ * document needs cost a handful of malloc calls, and parallel workers stop contending on
+ * the allocator for them.
+ *
+ * Not thread-safe: an arena belongs to one document (one thread) at a time.
+ *
+ * Plays the role of std::pmr::monotonic_buffer_resource, which Apple's libc++ only ships
+ * from iOS 17 / macOS 14 on, below the SDK's deployment targets.
+ *
+ * Example usage:
+ *
+ * MonotonicArena arena(64 * 1024);
+ * ArenaVector<ArenaString> hashes{ArenaAllocator<ArenaString>(arena)};
+ * hashes.emplace_back("0123456789abcdef", hashes.get_allocator());
+ */
+class LEAFRA_API MonotonicArena {
+public:
+    /**
+     * @param first_block_bytes Size of the first block (later ones double, up to 1 MB each)
+     */
+    explicit MonotonicArena(size_t first_block_bytes = 4096);
+    ~MonotonicArena();
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    /**
+     * @brief Carve bytes out of the current block (a new block is allocated when it is full)
+     * @throws std::bad_alloc if a block can't be allocated
+     */
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        const uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor_) + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        if (cursor_ && aligned <= reinterpret_cast<uintptr_t>(end_) && bytes <= reinterpret_cast<uintptr_t>(end_) - aligned) {
+            cursor_ = reinterpret_cast<char*>(aligned + bytes);
+            bytes_used_ += bytes;
+            return reinterpret_cast<void*>(aligned);
+        }
+        return allocate_block(bytes, alignment);
+    }
+
+    /**
+     * @brief Free every block; whatever was allocated from the arena is gone
+     */
+    void release();
+
+    size_t bytes_used() const { return bytes_used_; }        // Bytes handed out since construction / release()
+    size_t memory_bytes() const { return reserved_bytes_; }  // Heap bytes held in blocks
+    size_t block_count() const { return block_count_; }
+
+private:
+    struct Block {
+        Block* next;
+    };
+
+    void* allocate_block(size_t bytes, size_t alignment);
+
+    Block* blocks_ = nullptr;           // Most recent first
+    char* cursor_ = nullptr;            // Free space of the most recent block
+    char* end_ = nullptr;
+    size_t first_block_bytes_;
+    size_t next_block_bytes_;
+    size_t bytes_used_ = 0;
+    size_t reserved_bytes_ = 0;
+    size_t block_count_ = 0;
+};
+
+/**
+ * @brief Standard allocator handing out MonotonicArena memory (deallocate is a no-op)
+ *
+ * A container keeps the arena it was constructed with; elements that allocate themselves
+ * (strings in an ArenaVector) need the allocator passed explicitly, e.g. emplace_back(text, get_allocator()).
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit ArenaAllocator(MonotonicArena& arena) noexcept : arena_(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t count) {
+        if (count > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}   // Freed with the arena
+
+    MonotonicArena* arena() const noexcept { return arena_; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena_ == other.arena(); }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept { return arena_ != other.arena(); }
+
+private:
+    MonotonicArena* arena_;
+};
+
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+} // namespace leafra
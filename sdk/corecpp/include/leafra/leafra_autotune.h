@@ -0,0 +1,92 @@
+#pragma once
+
+#include "types.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief What LeafraCore::autotune optimizes for
+ */
+enum class AutotuneTarget : int32_t {
+    LATENCY = 0,                            // Fastest single query / generation
+    THROUGHPUT = 1                          // Most work done while engines share the device (ingestion)
+};
+
+/**
+ * @brief One measured setting: the value tried and what one unit of work cost with it
+ */
+struct LEAFRA_API AutotuneTrial {
+    int32_t value = 0;                      // Setting tried (threads, rows per batch)
+    double cost = 0.0;                      // Milliseconds per unit of work (row, token); <= 0 = failed
+};
+
+/**
+ * @brief Settings LeafraCore::autotune measured on this device, applied by initialize on later launches
+ *
+ * A profile belongs to the device it was measured on (platform, architecture, core counts)
+ * and to the model files it was measured with: the embedding settings only apply while the
+ * same embedding model is configured, the LLM settings only with the same LLM. Values of 0
+ * were not tuned.
+ *
+ * Stored as "key=value" lines, so a profile from a newer SDK with more keys still loads.
+ *
+ * Example usage:
+ *
+ * DeviceProfile profile;
+ * if (DeviceProfile::load(path, profile) && profile.device == fingerprint) {
+ *     profile.apply(config.embedding_inference, config.llm);
+ * }
+ */
+struct LEAFRA_API DeviceProfile {
+    std::string device;                     // Fingerprint of the device it was measured on
+    AutotuneTarget target = AutotuneTarget::LATENCY;
+    std::string embedding_model;            // Embedding model file the embedding values were measured with
+    int32_t embedding_batch_size = 0;       // Rows per embedding backend call
+    std::string llm_model;                  // LLM file the LLM values were measured with
+    int32_t llm_threads = 0;                // llama.cpp generation threads
+    int32_t llm_batch_threads = 0;          // llama.cpp prompt processing threads
+
+    /**
+     * @brief Overlay the tuned values that belong to the configured models onto their configs
+     *
+     * Thread counts set explicitly (> 0) are kept, like ThreadBudget does.
+     * @param embedding Config::embedding_inference
+     * @param llm Config::llm
+     * @return true if any value was applied
+     */
+    bool apply(EmbeddingModelConfig& embedding, LLMConfig& llm) const;
+
+    /**
+     * @brief Write the profile (to a temporary file renamed over path, so a crash leaves the old one)
+     * @return true on success
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * @brief Read a profile written by save
+     * @return false if the file is missing or isn't a device profile
+     */
+    static bool load(const std::string& path, DeviceProfile& profile);
+
+    /**
+     * @brief Model file name a profile records for a model path (directories stripped)
+     */
+    static std::string model_name(const std::string& model_path);
+
+    /**
+     * @brief Pick a setting from measured trials
+     *
+     * The cheapest trial wins, except that a smaller value whose cost is within tolerance
+     * of the cheapest is preferred (fewer threads leave cores to other engines, smaller
+     * batches let queries in sooner).
+     * @param trials Measured trials (failed ones are ignored)
+     * @param tolerance Relative slack, e.g. 0.1 = up to 10% slower
+     * @return The chosen value, or 0 if no trial succeeded
+     */
+    static int32_t pick(const std::vector<AutotuneTrial>& trials, double tolerance);
+};
+
+} // namespace leafra
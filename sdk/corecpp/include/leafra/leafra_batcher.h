@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief Coalesces concurrent calls into batches (dynamic micro-batching)
+ *
+ * Callers block in submit(). The first caller of a batch leads it: while another batch is
+ * running it waits up to the window for more callers to join (or until max_batch have),
+ * then closes the batch, runs it on its own thread and hands every caller its result.
+ * A call arriving while nothing is running goes ahead at once, so an idle system pays no
+ * latency for batching; under load, calls that would have queued behind each other share
+ * one run instead.
+ *
+ * If the run function throws, every caller of that batch gets the exception.
+ *
+ * Example usage:
+ *
+ * MicroBatcher<std::string, std::vector<float> > batcher(options, [&](std::vector<std::string>& texts,
+ *                                                                     std::vector<std::vector<float> >& out) {
+ *     model.embed_batch(texts, out);       // out is sized to texts
+ * });
+ * std::vector<float> embedding = batcher.submit(text);
+ */
+template<typename Request, typename Result>
+class MicroBatcher {
+public:
+    struct Options {
+        size_t max_batch = 8;                        // Calls per batch (<= 1 = every call runs alone)
+        std::chrono::microseconds window{2000};      // Longest a batch waits for more calls while another batch runs
+    };
+
+    struct Stats {
+        uint64_t batches = 0;                        // Runs
+        uint64_t requests = 0;                       // Calls served by them
+        size_t largest_batch = 0;
+    };
+
+    // Runs one closed batch; results is sized to requests and results[i] answers requests[i]
+    using RunBatch = std::function<void(std::vector<Request>& requests, std::vector<Result>& results)>;
+
+    MicroBatcher(const Options& options, RunBatch run) : options_(options), run_(std::move(run)) {}
+
+    MicroBatcher(const MicroBatcher&) = delete;
+    MicroBatcher& operator=(const MicroBatcher&) = delete;
+
+    /**
+     * @brief Run a call, batched with whichever calls arrive alongside it
+     * @return The call's result
+     */
+    Result submit(Request request) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        std::shared_ptr<Batch> batch = open_;
+        const bool leader = !batch;
+        if (leader) {
+            batch = std::make_shared<Batch>();
+            if (options_.max_batch > 1) {
+                open_ = batch;
+            }
+        }
+        const size_t slot = batch->requests.size();
+        batch->requests.push_back(std::move(request));
+
+        if (!leader) {
+            if (batch->requests.size() >= options_.max_batch) {
+                open_.reset();
+                changed_cv_.notify_all();
+            }
+            changed_cv_.wait(lock, [&batch] { return batch->done; });
+            return take(batch, slot);
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + options_.window;
+        changed_cv_.wait_until(lock, deadline, [this, &batch] { return open_ != batch || running_ == 0; });
+        if (open_ == batch) {
+            open_.reset();
+        }
+        running_++;
+        lock.unlock();
+
+        std::vector<Result> results(batch->requests.size());
+        std::exception_ptr error;
+        try {
+            run_(batch->requests, results);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        running_--;
+        stats_.batches++;
+        stats_.requests += batch->requests.size();
+        stats_.largest_batch = std::max(stats_.largest_batch, batch->requests.size());
+        batch->results = std::move(results);
+        batch->error = error;
+        batch->done = true;
+        changed_cv_.notify_all();
+        return take(batch, slot);
+    } //submit
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    const Options& options() const { return options_; }
+
+private:
+    struct Batch {
+        std::vector<Request> requests;
+        std::vector<Result> results;
+        std::exception_ptr error;
+        bool done = false;
+    };
+
+    // Callers hold mutex_
+    static Result take(const std::shared_ptr<Batch>& batch, size_t slot) {
+        if (batch->error) {
+            std::rethrow_exception(batch->error);
+        }
+        return std::move(batch->results[slot]);
+    }
+
+    Options options_;
+    RunBatch run_;
+    mutable std::mutex mutex_;
+    std::condition_variable changed_cv_;    // A batch filled up or finished
+    std::shared_ptr<Batch> open_;           // Batch still accepting calls
+    size_t running_ = 0;                    // Batches being run
+    Stats stats_;
+};
+
+} // namespace leafra
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "types.h"
+#include "leafra_sqlite.h"
+#include <cstdint>
+#include <string>
+
+namespace leafra {
+
+/**
+ * @brief What a prebuilt corpus bundle was made with, stored in its bundle_manifest table
+ */
+struct LEAFRA_API BundleManifest {
+    int32_t format_version = 0;         // Bundle layout version (RagBundle::kFormatVersion when written)
+    std::string sdk_version;            // SDK that exported it
+    int64_t created_at = 0;             // Unix seconds
+    std::string embedding_model;        // Framework and model file name the embeddings came from
+    int32_t dimension = 0;              // Embedding dimension
+    std::string index_type;             // vector_search.index_type at export
+    std::string metric;                 // vector_search.metric at export
+    int32_t index_dimension = 0;        // vector_search.index_dimension at export
+    int64_t chunk_size = 0;             // chunking.chunk_size
+    double chunk_overlap = 0.0;         // chunking.overlap_percentage
+    std::string chunk_unit;             // "characters", "tokens" or "exact_tokens"
+    int64_t documents = 0;              // Rows in docs
+    int64_t chunks = 0;                 // Rows in chunks
+    int64_t faiss_delta_id = 0;         // Highest FAISS delta id issued when it was taken (index files never fold in later ones)
+    bool delta = false;                 // A delta (LeafraCore::export_delta) rather than a whole corpus
+    int64_t delta_since = 0;            // Delta: sync_log generation it starts after
+    int64_t delta_through = 0;          // Delta: sync_log generation it brings the corpus up to
+    std::string checksum;               // RagBundle::checksum of the bundle (hex)
+};
+
+/**
+ * @brief Prebuilt corpus bundles: a self-contained copy of the RAG database plus a manifest
+ *
+ * A bundle is an ordinary SQLite file (documents, chunks, embeddings and every FAISS index
+ * blob), so it can also be opened or attached read-only with any SQLite tool. The manifest
+ * records the embedding model, dimension and chunking it was built with, and a checksum over
+ * the contents of every other table, so a truncated or modified bundle is never imported.
+ * A delta is laid out the same way but only holds the documents added after one sync_log
+ * generation (docs, chunks, chunk_embeddings, doc_texts, doc_centroids rows) and the
+ * (url, collection) of the documents removed since, in a sync_removals table.
+ *
+ * Example usage:
+ *
+ * BundleManifest manifest;
+ * if (RagBundle::read_manifest(bundle_db, manifest) && RagBundle::verify(bundle_db, manifest)) { ... }
+ */
+class LEAFRA_API RagBundle {
+public:
+    static constexpr int32_t kFormatVersion = 1;
+    static constexpr int32_t kDeltaFormatVersion = 2;   // Deltas, so SDKs from before them never import one as a whole corpus
+
+    /**
+     * @brief Digest of every table's rows except the manifest, tables by name, rows in storage order
+     * @param hex_digest Output digest (16 hex characters)
+     * @return false if a table can't be read
+     */
+    static bool checksum(SQLiteDatabase& db, std::string& hex_digest);
+
+    /**
+     * @brief Fill in the counts, format version and checksum, then store the manifest (replacing any)
+     * @param manifest Manifest to store (its checksum, counts, faiss_delta_id and format_version are overwritten)
+     */
+    static bool write_manifest(SQLiteDatabase& db, BundleManifest& manifest);
+
+    /**
+     * @brief Read the manifest
+     * @return false if the database has no (complete) manifest
+     */
+    static bool read_manifest(SQLiteDatabase& db, BundleManifest& manifest);
+
+    /**
+     * @brief Recompute the checksum and compare it with the manifest's
+     */
+    static bool verify(SQLiteDatabase& db, const BundleManifest& manifest);
+};
+
+} // namespace leafra
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace leafra {
+
+/**
+ * @brief Bounded least-recently-used cache
+ *
+ * Lookups and inserts are O(1): entries live in a recency list and an index maps
+ * keys to list positions. Inserting past capacity evicts the least recently used
+ * entry. A capacity of 0 disables the cache (every lookup misses, puts are dropped).
+ *
+ * Not thread-safe: callers must serialize access to a single instance.
+ *
+ * Example usage:
+ *
+ * LRUCache<std::string, std::vector<float> > cache(128);
+ * cache.put("query", embedding);
+ * if (const auto* cached = cache.get("query")) { ... }
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key> >
+class LRUCache {
+public:
+    explicit LRUCache(size_t capacity = 0) : capacity_(capacity) {}
+
+    /**
+     * @brief Look up an entry and mark it most recently used
+     * @return Pointer to the cached value (valid until the next put/erase/clear), or nullptr on a miss
+     */
+    const Value* get(const Key& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            misses_++;
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, it->second);
+        hits_++;
+        return &it->second->second;
+    }
+
+    /**
+     * @brief Insert or replace an entry, evicting the least recently used one when full
+     */
+    void put(const Key& key, Value value) {
+        if (capacity_ == 0) {
+            return;
+        }
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            it->second->second = std::move(value);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        entries_.emplace_front(key, std::move(value));
+        index_[key] = entries_.begin();
+        trim();
+    }
+
+    /**
+     * @brief Remove an entry and hand its value to the caller (counts as a hit, or a miss if absent)
+     * @return true if the key was cached
+     */
+    bool take(const Key& key, Value& value) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            misses_++;
+            return false;
+        }
+        value = std::move(it->second->second);
+        entries_.erase(it->second);
+        index_.erase(it);
+        hits_++;
+        return true;
+    }
+
+    bool erase(const Key& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            return false;
+        }
+        entries_.erase(it->second);
+        index_.erase(it);
+        return true;
+    }
+
+    /**
+     * @brief Remove every entry for which predicate(key, value) is true
+     * @return Number of entries removed
+     */
+    template<typename Predicate>
+    size_t erase_if(Predicate predicate) {
+        size_t removed = 0;
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            if (predicate(it->first, it->second)) {
+                index_.erase(it->first);
+                it = entries_.erase(it);
+                removed++;
+            } else {
+                ++it;
+            }
+        }
+        return removed;
+    }
+
+    /**
+     * @brief Drop up to count of the least recently used entries, keeping the capacity (memory pressure)
+     * @return Number of entries removed
+     */
+    size_t evict(size_t count) {
+        size_t removed = 0;
+        while (removed < count && !entries_.empty()) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+            evictions_++;
+            removed++;
+        }
+        return removed;
+    }
+
+    /**
+     * @brief Call f(key, value) for every entry, most recently used first (recency unchanged)
+     */
+    template<typename F>
+    void for_each(F f) const {
+        for (const auto& entry : entries_) {
+            f(entry.first, entry.second);
+        }
+    }
+
+    void clear() {
+        entries_.clear();
+        index_.clear();
+    }
+
+    void set_capacity(size_t capacity) {
+        capacity_ = capacity;
+        trim();
+    }
+
+    void reset_stats() {
+        hits_ = 0;
+        misses_ = 0;
+        evictions_ = 0;
+    }
+
+    size_t size() const { return index_.size(); }
+    size_t capacity() const { return capacity_; }
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+    uint64_t evictions() const { return evictions_; }
+
+private:
+    void trim() {
+        while (index_.size() > capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+            evictions_++;
+        }
+    }
+
+    using entry_list_t = std::list<std::pair<Key, Value> >;
+
+    size_t capacity_;
+    entry_list_t entries_;                   // Most recently used first
+    std::unordered_map<Key, typename entry_list_t::iterator, Hash> index_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+};
+
+} // namespace leafra
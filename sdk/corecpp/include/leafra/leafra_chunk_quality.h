@@ -0,0 +1,49 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <string_view>
+
+namespace leafra {
+
+/**
+ * @brief Cheap text statistics of a chunk, gathered in one pass over its bytes
+ */
+struct ChunkQualityScore {
+    size_t bytes = 0;                   // UTF-8 bytes of the chunk
+    size_t characters = 0;              // Non-whitespace code points
+    double alpha_ratio = 0.0;           // Share of characters that are letters (any non-ASCII code point counts as one)
+    double tokens_per_byte = 0.0;       // Tokenizer tokens per UTF-8 byte (0 when no token count is known)
+    double entropy = 0.0;               // Shannon entropy (bits) of the non-whitespace ASCII characters
+    size_t ascii_characters = 0;        // Characters the entropy was taken over
+};
+
+/**
+ * @brief Pre-embedding filter for chunks that carry no retrievable text
+ *
+ * Page numbers, table-of-contents dot leaders, base64 blobs and OCR garbage fail at least one
+ * of the ChunkQualityConfig thresholds: they are short, low on letters, tokenize into many
+ * short pieces, or have a character distribution far from prose.
+ *
+ * Example usage:
+ *
+ * ChunkQualityScore score = ChunkQuality::score(chunk.content, batch.tokens.length(i));
+ * if (ChunkQuality::rejection_reason(score, config.chunk_quality)) { ... leave the chunk out ... }
+ */
+class LEAFRA_API ChunkQuality {
+public:
+    /**
+     * @brief Score a chunk
+     * @param text Chunk text (UTF-8)
+     * @param token_count Tokens the tokenizer produced for the chunk (0 = unknown, skips the token check)
+     */
+    static ChunkQualityScore score(std::string_view text, size_t token_count);
+
+    /**
+     * @brief First threshold the score fails
+     * @return "length", "alpha_ratio", "tokens_per_byte" or "entropy", nullptr if the chunk passes
+     */
+    static const char* rejection_reason(const ChunkQualityScore& score, const ChunkQualityConfig& config);
+};
+
+} // namespace leafra
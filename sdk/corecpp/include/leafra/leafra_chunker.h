@@ -2,11 +2,14 @@
 
 #include "types.h"
 #include "leafra_unicode.h"
+#include "leafra_threadpool.h"
 #include <string>
 #include <string_view>
 #include <vector>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <utility>
 
 // Platform-specific macros
 #ifdef _WIN32
@@ -31,6 +34,7 @@ namespace leafra {
  * @brief Forward declarations
  */
 class LeafraChunker;
+class StreamingChunker;
 
 /**
  * @brief Result code enum
@@ -42,9 +46,29 @@ class LeafraChunker;
  */
 enum class ChunkSizeUnit : int32_t {
     CHARACTERS = 0,  // Chunk size in UTF-8 characters (Unicode code points, not bytes)
-    TOKENS = 1       // Chunk size in tokens (approximate)
+    TOKENS = 1,      // Chunk size in tokens (approximate)
+    EXACT_TOKENS = 2 // Chunk size in tokenizer tokens (requires ChunkingOptions::tokenizer)
 };
 
+/**
+ * @brief How chunk boundaries are chosen
+ */
+enum class ChunkingStrategy : int32_t {
+    FIXED = 0,       // Fixed-size windows, optionally snapped to word boundaries
+    SENTENCE = 1     // Whole sentences packed up to chunk_size, breaking at headings and preferring paragraph ends
+};
+
+/**
+ * @brief [begin, end) byte range of each token in the tokenized text
+ */
+using TokenOffsets = std::vector<std::pair<size_t, size_t>>;
+
+/**
+ * @brief Tokenizer used by ChunkSizeUnit::EXACT_TOKENS
+ * Fills ids and the matching byte offsets into text; returns false on failure.
+ */
+using TokenizeFunction = std::function<bool(const std::string& text, std::vector<int>& ids, TokenOffsets& offsets)>;
+
 /**
  * @brief Enum for token approximation methods
  * NOTE: Simplified to use single unified approach of ~4 chars/token for consistency.
@@ -61,6 +85,7 @@ struct TextChunk {
     size_t start_index = 0;
     size_t end_index = 0;
     size_t page_number = 0;
+    size_t end_page_number = 0;   // Page of the chunk's last byte (differs from page_number when it spans a page break)
     size_t estimated_tokens = 0;  // Estimated token count for this chunk
     
     // SentencePiece token IDs (empty if SentencePiece not used)
@@ -71,7 +96,7 @@ struct TextChunk {
     
     TextChunk() = default;
     TextChunk(std::string_view text, size_t start, size_t end, size_t page = 0)
-        : content(text), start_index(start), end_index(end), page_number(page), estimated_tokens(0) {}
+        : content(text), start_index(start), end_index(end), page_number(page), end_page_number(page), estimated_tokens(0) {}
     
     // Helper method to get content as string when needed
     std::string to_string() const {
@@ -89,6 +114,49 @@ struct TextChunk {
     }
 };
 
+/**
+ * @brief Columnar token IDs and embeddings of a document's chunks
+ * 
+ * Row i belongs to chunks[i]. All rows' token IDs share one buffer and the embeddings
+ * form one rows x dimension matrix, so the tokenizer, embedder, SQLite and FAISS stages
+ * read and write them in place instead of through a vector per chunk.
+ */
+struct LEAFRA_API ChunkBatch {
+    TokenIdBatch tokens;                // Token IDs per row (empty until tokenized)
+    std::vector<float> embeddings;      // rows() * dimension floats, row-major
+    std::vector<uint8_t> embedded;      // 1 = the row's embedding is filled in
+    std::vector<uint8_t> skipped;       // 1 = leave the row out (not embedded or stored); empty = none skipped
+    size_t dimension = 0;               // Floats per embedding (0 = no embeddings yet)
+    
+    size_t rows() const { return embedded.size(); }
+    bool has_tokens(size_t row) const { return row < tokens.size() && tokens.length(row) > 0; }
+    bool has_embedding(size_t row) const { return row < embedded.size() && embedded[row] != 0; }
+    bool is_skipped(size_t row) const { return row < skipped.size() && skipped[row] != 0; }
+    float* embedding(size_t row) { return embeddings.data() + row * dimension; }
+    const float* embedding(size_t row) const { return embeddings.data() + row * dimension; }
+    
+    size_t embedding_count() const {
+        size_t count = 0;
+        for (uint8_t flag : embedded) count += flag;
+        return count;
+    }
+    
+    // Size the matrix for row_count embeddings of dim floats, all marked missing
+    void reset_embeddings(size_t row_count, size_t dim) {
+        dimension = dim;
+        embeddings.assign(row_count * dim, 0.0f);
+        embedded.assign(row_count, 0);
+    }
+    
+    void clear() {
+        tokens.clear();
+        embeddings.clear();
+        embedded.clear();
+        skipped.clear();
+        dimension = 0;
+    }
+};
+
 /**
  * @brief Chunking options structure
  */
@@ -98,7 +166,11 @@ struct ChunkingOptions {
     bool preserve_word_boundaries = true; // Whether to avoid breaking words
     bool include_metadata = true;       // Whether to include chunk metadata
     ChunkSizeUnit size_unit = ChunkSizeUnit::TOKENS;  // Unit for chunk_size (CHARACTERS = UTF-8 chars, TOKENS = approximate)
+    ChunkingStrategy strategy = ChunkingStrategy::FIXED;  // Boundary strategy (SENTENCE is ignored by EXACT_TOKENS, which already prefers sentence ends)
     TokenApproximationMethod token_method = TokenApproximationMethod::SIMPLE;  // Token approximation method
+    TokenizeFunction tokenizer;         // Tokenizer for EXACT_TOKENS - the document is tokenized once and chunks get its token IDs
+    TaskSubmitFunction submit_task;     // Worker threads for indexing large texts in parallel (empty = sequential)
+    size_t parallel_segment_bytes = 0;  // Segment size for parallel indexing; used for texts of at least two segments (0 = sequential)
     
     ChunkingOptions() = default;
     ChunkingOptions(size_t size, double overlap)
@@ -109,12 +181,67 @@ struct ChunkingOptions {
         : chunk_size(size), overlap_percentage(overlap), size_unit(unit), token_method(method) {}
 };
 
+/**
+ * @brief Reusable scratch memory for chunking calls
+ * 
+ * Keep one per thread and pass it to every call: its buffers keep their capacity
+ * between documents, so steady-state chunking doesn't reallocate them.
+ */
+class LEAFRA_API ChunkingScratch {
+public:
+    // Heap bytes held for reuse by the next call
+    size_t memory_bytes() const;
+
+private:
+    friend class LeafraChunker;
+    UnicodeCacher cacher;                   // Index of the text being chunked
+    std::vector<size_t> page_starts;        // Byte offset where each page begins
+    std::vector<int> token_ids;             // Whole-document tokens (EXACT_TOKENS)
+    TokenOffsets token_offsets;
+};
+
+/**
+ * @brief Receiver for chunks produced by StreamingChunker
+ * The chunk's content view is only valid during the call. Return false to stop chunking.
+ */
+using ChunkSink = std::function<bool(TextChunk& chunk)>;
+
+/**
+ * @brief Chunks together with the text they view
+ * 
+ * The text is either owned (pages joined by chunk_document, held on the heap so moving
+ * the result never invalidates chunk views) or borrowed from chunk_text's caller, who
+ * must keep it alive. Passing the same result to the next call reuses its buffer.
+ */
+struct LEAFRA_API ChunkedDocument {
+    std::vector<TextChunk> chunks;          // content views into text()
+    ChunkBatch batch;                       // Token IDs / embeddings of chunks, filled by the stages after chunking (cleared by each call)
+    
+    std::string_view text() const { return text_ ? std::string_view(*text_) : std::string_view(); }
+    bool owns_text() const { return storage_ && text_ == storage_.get(); }
+    const std::vector<size_t>& page_starts() const { return page_starts_; }  // Byte offset where each joined page begins in text()
+    
+    // Heap bytes held by the chunks, their batch and the joined text (borrowed text not included)
+    size_t memory_bytes() const;
+
+private:
+    friend class LeafraChunker;
+    std::unique_ptr<std::string> storage_;  // Joined pages
+    const std::string* text_ = nullptr;     // storage_ or the borrowed text
+    std::vector<size_t> page_starts_;
+};
+
 /**
  * @brief Text chunking utility class
  * 
  * This class provides functionality to split text documents into chunks
  * with configurable size and overlap. It can handle single documents
  * or multi-page documents represented as vectors of text.
+ * 
+ * The const overloads taking a ChunkedDocument and ChunkingScratch are reentrant:
+ * they keep no state in the chunker, so one instance can serve several threads as
+ * long as each thread brings its own scratch. The older overloads write into the
+ * chunker and are not.
  */
 class LEAFRA_API LeafraChunker {
 public:
@@ -140,6 +267,19 @@ public:
                          const ChunkingOptions& options,
                          std::vector<TextChunk>& chunks);
 
+    /**
+     * @brief Reentrant chunking of a single text, borrowing it
+     * @param text Input text - chunks view it directly, so it must outlive result
+     * @param options Chunking options (by value - the chunker keeps nothing)
+     * @param result Output chunks
+     * @param scratch Caller-owned scratch memory
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode chunk_text(const std::string& text,
+                         ChunkingOptions options,
+                         ChunkedDocument& result,
+                         ChunkingScratch& scratch) const;
+
     
     // ========== DOCUMENT CHUNKING METHODS ==========
     
@@ -153,6 +293,32 @@ public:
     ResultCode chunk_document(const std::vector<std::string>& pages,
                              const ChunkingOptions& options,
                              std::vector<TextChunk>& chunks);
+
+    /**
+     * @brief Reentrant chunking of a multi-page document
+     * @param pages Vector of text pages (joined into result's own buffer)
+     * @param options Chunking options (by value - the chunker keeps nothing)
+     * @param result Output chunks and the text they view
+     * @param scratch Caller-owned scratch memory
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode chunk_document(const std::vector<std::string>& pages,
+                             ChunkingOptions options,
+                             ChunkedDocument& result,
+                             ChunkingScratch& scratch) const;
+
+    /**
+     * @brief Reentrant chunking of pages viewed in the caller's own storage
+     * @param pages Views of the text pages - copied once, straight into result's buffer
+     * @param options Chunking options (by value - the chunker keeps nothing)
+     * @param result Output chunks and the text they view
+     * @param scratch Caller-owned scratch memory
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode chunk_document(const std::vector<std::string_view>& pages,
+                             ChunkingOptions options,
+                             ChunkedDocument& result,
+                             ChunkingScratch& scratch) const;
     
 
     // ========== STATISTICS AND CONFIGURATION ==========
@@ -213,6 +379,7 @@ private:
      * @return Best position to split at
      */
     size_t find_word_boundary(const std::string& text, 
+                             const UnicodeCacher& cacher,
                              size_t target_position, 
                              size_t search_window = 50) const;
     
@@ -223,19 +390,54 @@ private:
      * @param end End position in text
      * @param page_number Page number (0-based)
      * @param global_start Global start position across all pages
+     * @param trim_whitespace Whether to trim leading/trailing whitespace from the content
      * @return TextChunk object
      */
     TextChunk create_chunk(const std::string& text,
+                          const UnicodeCacher& cacher,
                           size_t start,
                           size_t end,
                           size_t page_number,
-                          size_t global_start);
+                          size_t global_start,
+                          bool trim_whitespace) const;
     
     /**
      * @brief Advanced token approximation with heuristics
      */
     static size_t estimate_tokens_advanced(const std::string& text);
 
+    /**
+     * @brief Validate options and convert CHARACTERS sizes to TOKENS
+     * @param options Options to check, converted in place
+     * @return ResultCode indicating success or failure
+     */
+    static ResultCode normalize_options(ChunkingOptions& options);
+
+    /**
+     * @brief Set a chunk's start and end page from its byte range
+     * @param page_starts Global byte offset where each page begins (sorted)
+     * @param text Text the chunk's content views
+     * @param text_offset Global byte offset of text[0]
+     * @param chunk Chunk with global start/end indices
+     */
+    static void assign_page_range(const std::vector<size_t>& page_starts,
+                                  const std::string& text,
+                                  size_t text_offset,
+                                  TextChunk& chunk);
+
+    /**
+     * @brief Validate options, chunk prepared text and assign page numbers
+     * @param text Text to chunk (joined pages or the borrowed text)
+     * @param options Chunking options
+     * @param chunks Output chunks
+     * @param scratch Scratch memory; page_starts must already be filled in
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode chunk_prepared_text(const std::string& text,
+                                  ChunkingOptions options,
+                                  std::vector<TextChunk>& chunks,
+                                  ChunkingScratch& scratch) const;
+
     // ========== IMPROVED TOKEN CHUNKING METHODS (PRIVATE) ==========
     
     /**
@@ -246,8 +448,129 @@ private:
      * @return ResultCode indicating success or failure
      */
     ResultCode actual_chunker(const std::string& text,
+                             const UnicodeCacher& cacher,
                              const ChunkingOptions& options,
-                             std::vector<TextChunk>& chunks);
+                             std::vector<TextChunk>& chunks) const;
+    
+    /**
+     * @brief Run the chunking cursor over a window of text
+     * @param text Window text
+     * @param options Chunking options (chunk_size in tokens)
+     * @param chars_per_token Sampled density used to size chunks
+     * @param start_pos Byte position the cursor starts from
+     * @param final_window Whether the text ends with this window; if not, the cursor stops
+     *                     before the first chunk that more text could still change
+     * @param has_previous_chunks Whether earlier windows already produced chunks
+     * @param chunks Output chunks (appended, window-relative indices)
+     * @param resume_pos Byte position the next window should start from
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode chunk_window(const std::string& text,
+                           const UnicodeCacher& cacher,
+                           const ChunkingOptions& options,
+                           double chars_per_token,
+                           size_t start_pos,
+                           bool final_window,
+                           bool has_previous_chunks,
+                           std::vector<TextChunk>& chunks,
+                           size_t& resume_pos) const;
+    
+    /**
+     * @brief chunk_window specialized on the boundary mode and on the text being ASCII-only
+     *
+     * chunk_window picks the instantiation once per window, so the loop carries no option
+     * branches; with Ascii set, byte positions are character indices. Defined and
+     * instantiated in leafra_chunker.cpp.
+     */
+    template <bool PreserveWordBoundaries, bool Ascii>
+    ResultCode chunk_window_kernel(const std::string& text,
+                                   const UnicodeCacher& cacher,
+                                   const ChunkingOptions& options,
+                                   double chars_per_token,
+                                   size_t start_pos,
+                                   bool final_window,
+                                   bool has_previous_chunks,
+                                   std::vector<TextChunk>& chunks,
+                                   size_t& resume_pos) const;
+    
+
+    /**
+     * @brief A sentence, heading or table row - the smallest piece sentence chunking keeps whole
+     */
+    struct SentenceUnit {
+        size_t begin = 0;           // Byte range in the text
+        size_t end = 0;
+        size_t tokens = 0;          // Estimated tokens
+        bool block_start = false;   // First unit of a paragraph, heading or table
+        bool heading = false;       // Heading line - always starts a new chunk
+        bool joined_to_next = false; // Table row followed by another row of the same table
+    };
+    
+    /**
+     * @brief Split text into sentence units, detecting paragraphs, headings and tables line by line
+     * @param text Input text
+     * @param options Chunking options (token estimation method)
+     * @param units Output units in text order
+     */
+    void find_sentence_units(const std::string& text,
+                             const ChunkingOptions& options,
+                             std::vector<SentenceUnit>& units) const;
+    
+    /**
+     * @brief Sentence chunking: pack whole sentences up to the token budget
+     * 
+     * A heading always starts a new chunk; when a chunk is full it ends at the last paragraph
+     * (or table) start if that keeps it at least half full, otherwise at the last sentence.
+     * Overlap carries trailing whole sentences into the next chunk. Sentences longer than the
+     * budget are cut at word boundaries.
+     * 
+     * @param text Input text to chunk
+     * @param options Chunking options (chunk_size in tokens)
+     * @param chunks Output vector of text chunks
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode sentence_chunker(const std::string& text,
+                               const UnicodeCacher& cacher,
+                               const ChunkingOptions& options,
+                               std::vector<TextChunk>& chunks) const;
+    
+    /**
+     * @brief Exact token chunking: tokenize the text once and cut at token counts
+     * @param text Input text to chunk
+     * @param options Chunking options (chunk_size in tokens, tokenizer set)
+     * @param chunks Output chunks, each carrying its slice of the document's token IDs
+     * @param scratch Scratch memory for the document's tokens
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode token_chunker(const std::string& text,
+                            const UnicodeCacher& cacher,
+                            const ChunkingOptions& options,
+                            std::vector<TextChunk>& chunks,
+                            ChunkingScratch& scratch) const;
+    
+    /**
+     * @brief Pick the chunk end token, preferring sentence then word boundaries
+     * @param offsets Token byte offsets
+     * @param start First token of the chunk
+     * @param end Token limit (exclusive) for the chunk
+     * @param preserve_word_boundaries Whether to back off to a word boundary
+     * @return End token (exclusive), start < result <= end
+     */
+    size_t find_token_boundary(const UnicodeCacher& cacher,
+                              const TokenOffsets& offsets,
+                              size_t start,
+                              size_t end,
+                              bool preserve_word_boundaries) const;
+    
+    /**
+     * @brief Whether a token begins a new word (whitespace at or just before its first byte)
+     */
+    bool token_starts_word(const UnicodeCacher& cacher, const TokenOffsets& offsets, size_t token) const;
+    
+    /**
+     * @brief Whether the text before a token ends a sentence
+     */
+    bool token_starts_sentence(const UnicodeCacher& cacher, const TokenOffsets& offsets, size_t token) const;
     
     /**
      * @brief Find optimal chunk end position based on target token count
@@ -259,7 +582,9 @@ private:
      * @param chars_per_token Sampled characters per token ratio for this text
      * @return Optimal end position
      */
+    template <bool Ascii>
     size_t find_optimal_chunk_end(const std::string& text,
+                                 const UnicodeCacher& cacher,
                                  size_t start_pos,
                                  size_t target_tokens,
                                  const ChunkingOptions& options,
@@ -287,7 +612,8 @@ private:
      * @param pos Current position
      * @return Position of next word start
      */
-    size_t find_next_word_start(const std::string& text, size_t pos) const;
+    template <bool Ascii>
+    size_t find_next_word_start(const std::string& text, const UnicodeCacher& cacher, size_t pos) const;
     
     /**
      * @brief Sample text density to learn actual characters per token ratio
@@ -295,19 +621,83 @@ private:
      * @param options Chunking options
      * @return Actual characters per token ratio for this text
      */
-    double sample_text_density(const std::string& text, const ChunkingOptions& options) const;
+    double sample_text_density(const std::string& text, const UnicodeCacher& cacher, const ChunkingOptions& options) const;
 
 private:
+    friend class StreamingChunker;
+    
     ChunkingOptions default_options_;
     size_t last_chunk_count_ = 0;
     size_t last_total_characters_ = 0;
     
-    // Combined document text storage for zero-copy string_view chunks
-    std::string combined_text_;
+    // State behind the non-reentrant overloads - their chunks view last_document_
+    ChunkedDocument last_document_;
+    ChunkingScratch scratch_;
+};
+
+/**
+ * @brief Incremental chunking: push pages in, chunks come out through a sink
+ * 
+ * Only the text after the last emitted chunk (plus a little context before it) stays
+ * buffered, so memory is bounded by the page size and chunk window rather than by the
+ * document. Chunk boundaries follow the same rules as actual_chunker; the token density
+ * is sampled from the head of the document instead of the whole of it, so chunk sizes can
+ * differ slightly from chunk_document on text whose density drifts. EXACT_TOKENS needs the
+ * whole document tokenized up front and is not supported here.
+ * 
+ * Example usage:
+ * 
+ * StreamingChunker stream(chunker, options, [&](TextChunk& chunk) {
+ *     embed(chunk.content);            // content is only valid inside the sink
+ *     return true;
+ * });
+ * for (const auto& page : pages) stream.add_page(page);
+ * stream.finish();
+ */
+class LEAFRA_API StreamingChunker {
+public:
+    /**
+     * @brief Start a stream
+     * @param chunker Chunker providing the boundary rules; must outlive the stream
+     * @param options Chunking options (TOKENS or CHARACTERS)
+     * @param sink Receives chunks in document order
+     */
+    StreamingChunker(const LeafraChunker& chunker, ChunkingOptions options, ChunkSink sink);
+    
+    /**
+     * @brief Append the next page and emit every chunk that is now settled
+     * @param page Page text (copied into the stream's buffer)
+     * @return ResultCode - ERROR_CANCELLED if the sink stopped the stream
+     */
+    ResultCode add_page(std::string_view page);
+    
+    /**
+     * @brief Emit the remaining chunks and close the stream
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode finish();
+    
+    size_t chunk_count() const { return chunk_count_; }
+    size_t page_count() const { return page_starts_.size(); }
+    size_t buffered_bytes() const { return buffer_.size(); }
+
+private:
+    ResultCode process(bool final_window);
+    
+    const LeafraChunker& chunker_;
+    ChunkingOptions options_;
+    ChunkSink sink_;
+    ResultCode status_ = ResultCode::SUCCESS;
+    bool finished_ = false;
     
-    // Unicode caching for performance optimization
-    UnicodeCacher documentCacher;
-    UnicodeCacher chunkCacher;
+    std::string buffer_;                    // Unconsumed text plus some context before it
+    size_t buffer_offset_ = 0;              // Global byte offset of buffer_[0]
+    size_t cursor_ = 0;                     // Where the chunking cursor resumes in buffer_
+    std::vector<size_t> page_starts_;       // Global byte offset where each page begins
+    double chars_per_token_ = 0.0;          // Sampled once from the document head (0 = not yet)
+    size_t chunk_count_ = 0;
+    UnicodeCacher cacher_;
+    std::vector<TextChunk> pending_;
 };
 
 } // namespace leafra 
\ No newline at end of file
@@ -1,8 +1,14 @@
 #pragma once
 
 #include "types.h"
+#include "leafra_metrics.h"
+#include "leafra_governor.h"
+#include "leafra_autotune.h"
+#include "leafra_search_results.h"
 #include <memory>
 #include <functional>
+#include <future>
+#include <unordered_map>
 
 #ifdef LEAFRA_HAS_FAISS
 #include "leafra_faiss.h"
@@ -16,6 +22,299 @@ class FaissIndex;
 struct TextChunk;
 struct ChunkTokenInfo;
 
+/**
+ * @brief Handle to an asynchronous ingestion job
+ *
+ * Returned by LeafraCore::process_user_files_async. The handle can be used to
+ * wait for completion, poll progress counters or request cancellation. Cancellation
+ * is cooperative: files already being stored are finished, remaining files are skipped.
+ */
+class LEAFRA_API IngestionJob {
+public:
+    struct State;
+
+    explicit IngestionJob(std::shared_ptr<State> state);
+    ~IngestionJob();
+
+    /**
+     * @brief Request cancellation of the job
+     */
+    void cancel();
+
+    /**
+     * @brief Check if cancellation was requested
+     */
+    bool is_cancelled() const;
+
+    /**
+     * @brief Check if the job has finished (successfully, with errors or cancelled)
+     */
+    bool is_done() const;
+
+    /**
+     * @brief Block until the job finishes
+     * @return Final ResultCode of the job (ERROR_CANCELLED if cancelled)
+     */
+    ResultCode wait() const;
+
+    /**
+     * @brief Get a future that becomes ready with the job's final ResultCode
+     */
+    std::shared_future<ResultCode> get_future() const;
+
+    /**
+     * @brief Number of files submitted with the job
+     */
+    size_t get_total_files() const;
+
+    /**
+     * @brief Number of files that reached COMPLETED, FAILED or CANCELLED
+     */
+    size_t get_finished_files() const;
+
+    /**
+     * @brief Number of files that failed to ingest
+     */
+    size_t get_failed_files() const;
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief Hit/miss counters of the semantic search caches (see SearchCacheConfig)
+ */
+struct LEAFRA_API SearchCacheStats {
+    uint64_t embedding_hits = 0;            // Queries served from the embedding cache
+    uint64_t embedding_misses = 0;          // Queries that had to be embedded
+    uint64_t embedding_evictions = 0;       // Embeddings dropped to stay within capacity
+    size_t embedding_entries = 0;           // Embeddings currently cached
+    uint64_t result_hits = 0;               // Searches served from the result cache
+    uint64_t result_misses = 0;             // Searches that ran FAISS (including stale entries)
+    uint64_t result_evictions = 0;          // Result lists dropped to stay within capacity
+    size_t result_entries = 0;              // Result lists currently cached
+    uint64_t answer_hits = 0;               // semantic_search_with_llm answers replayed from the answer cache
+    uint64_t answer_misses = 0;             // Answers that had to be generated
+    size_t answer_entries = 0;              // Chunk sets with cached answers
+};
+
+/**
+ * @brief Size and reclaimable free space of the document database (see DatabaseConfig::auto_vacuum)
+ */
+struct LEAFRA_API DatabaseSpaceStats {
+    uint64_t file_bytes = 0;                // Database file size (pages * page size, WAL not included)
+    uint64_t free_bytes = 0;                // Bytes on the freelist - left behind by deleted rows and rewritten blobs
+    double free_ratio = 0.0;                // free_bytes / file_bytes, the fragmentation the vacuum scheduler watches
+    bool incremental_vacuum = false;        // Created with auto_vacuum = INCREMENTAL (free pages can be released)
+    uint64_t vacuumed_bytes = 0;            // Released by incremental vacuum since initialize
+};
+
+/**
+ * @brief Text fields LeafraCore::hydrate fills into search results (combined as a bit mask)
+ *
+ * doc_id, chunk_index and page_number are integers and always filled in.
+ */
+enum class SearchResultFields : uint32_t {
+    IDS = 0,                                // Only ids, score and chunk position
+    CONTENT = 1,                            // Chunk text
+    FILENAME = 2,                           // Source document filename
+    ALL = 3
+};
+
+/**
+ * @brief Shortcuts a search took to finish within its deadline (combined as a bit mask, see SearchDeadline)
+ *
+ * Listed in the order they are taken as the time left shrinks.
+ */
+enum class SearchDegradation : uint32_t {
+    NONE = 0,
+    SKIPPED_RERANK = 1,                     // Candidates kept in index order (no exact re-score, no LLM re-ranker)
+    REDUCED_PROBES = 2,                     // Fewer IVF lists / HNSW candidates visited than configured (lower recall)
+    UNHYDRATED = 4,                         // Hits carry ids and scores only; hydrate() fills in the rest
+    KEYWORD_FALLBACK = 8                    // FTS5 keyword hits instead of a vector search (distance holds BM25)
+};
+
+/**
+ * @brief Time budget of one search or RAG call, and the shortcuts it took to keep it
+ *
+ * Before each stage the time left is compared with what that stage typically takes (its
+ * median in get_metrics()); when the rest of the call won't fit, it degrades in
+ * SearchDegradation order instead of running late. A stage that has started is not
+ * interrupted, so a call can still overrun by about one stage.
+ */
+struct LEAFRA_API SearchDeadline {
+    double budget_ms = 0.0;                 // Time the call may take (<= 0 = no deadline)
+    uint32_t degradations = 0;              // Out: SearchDegradation flags applied
+    double elapsed_ms = 0.0;                // Out: time the call took
+
+    bool degraded(SearchDegradation degradation) const {
+        return (degradations & static_cast<uint32_t>(degradation)) != 0;
+    }
+};
+
+/**
+ * @brief Where one search or RAG call spent its time, for attributing a slow query to a stage
+ *
+ * Filled in by the semantic_search / semantic_search_with_llm overloads taking it; stages the
+ * call skipped (cache hits, no LLM) stay 0. Durations are wall-clock milliseconds.
+ */
+struct LEAFRA_API QueryStats {
+    double total_ms = 0.0;                  // Whole call
+    double tokenize_ms = 0.0;               // Query tokenization
+    double embed_ms = 0.0;                  // Query embedding inference
+    double ann_ms = 0.0;                    // Vector index search (or the keyword fallback)
+    double rerank_ms = 0.0;                 // Exact re-score of lossy candidates, plus the LLM re-ranker in RAG
+    double hydrate_ms = 0.0;                // Loading chunk text for the hits
+    double prompt_build_ms = 0.0;           // RAG: prompt assembly within the context budget
+    double prefill_ms = 0.0;                // RAG: prompt evaluation
+    double ttft_ms = 0.0;                   // RAG: call start to first answer token
+    double decode_ms = 0.0;                 // RAG: token generation after the first token
+    int32_t candidates = 0;                 // Hits fetched from the index (above max_results when re-scored)
+    int32_t results = 0;                    // Hits returned
+    int32_t context_chunks = 0;             // RAG: passages in the prompt
+    int32_t prompt_tokens = 0;              // RAG: prompt length, of which reused_prompt_tokens came from the KV cache
+    int32_t reused_prompt_tokens = 0;
+    int32_t generated_tokens = 0;
+    bool embedding_cache_hit = false;       // Query embedding served from the query cache
+    bool result_cache_hit = false;          // Hits served from the result cache (no embedding or index search)
+    bool answer_cache_hit = false;          // RAG: answer served from the answer cache
+    uint32_t degradations = 0;              // SearchDegradation flags, when a deadline was given
+};
+
+/**
+ * @brief What one ingested document produced, as counted by the ingestion pipeline
+ */
+struct LEAFRA_API IngestDocumentReport {
+    std::string file_path;
+    size_t pages = 0;
+    size_t text_chars = 0;                  // Parsed text of all pages
+    size_t chunks = 0;
+    size_t tokens = 0;                      // Chunk tokens incl. the passage prefix (0 without the tokenizer)
+    double elapsed_ms = 0.0;                // Parse to store
+};
+
+/**
+ * @brief Chunk statistics of the last ingestion run (see get_last_ingest_report())
+ *
+ * Ingestion only records a few counters per document; totals and ratios are computed when the
+ * report is asked for.
+ */
+struct LEAFRA_API IngestReport {
+    std::vector<IngestDocumentReport> documents;    // Documents chunked by the run, in store order
+    size_t total_pages = 0;
+    size_t total_text_chars = 0;
+    size_t total_chunks = 0;
+    size_t total_tokens = 0;
+    double avg_chunks_per_document = 0.0;
+    double avg_tokens_per_chunk = 0.0;
+    double chars_per_token = 0.0;           // Document text per chunk token (overlap counts once)
+};
+
+/**
+ * @brief How closely a candidate embedding model (e.g. a quantized export) reproduces the loaded one
+ */
+struct LEAFRA_API EmbeddingModelValidation {
+    int32_t k = 0;                          // Neighbours compared per query
+    size_t samples = 0;                     // Texts embedded by both models
+    size_t dimension = 0;
+    double recall_at_k = 0.0;               // Mean share of the loaded model's k nearest neighbours the candidate also ranks top k
+    double min_recall_at_k = 0.0;           // Worst single query
+    double mean_cosine = 0.0;               // Mean cosine between the two models' embeddings of the same text
+    double reference_ms = 0.0;              // Time to embed the samples with the loaded model
+    double candidate_ms = 0.0;              // Same with the candidate
+    bool candidate_quantized = false;       // Candidate's outputs are quantized and dequantized on read
+};
+
+#ifdef LEAFRA_HAS_FAISS
+/**
+ * @brief Search-as-you-type session, created by LeafraCore::create_search_session
+ *
+ * search() is called on every keystroke, from any thread. Each call first waits out the
+ * debounce interval; a newer call arriving meanwhile, or while it embeds, searches or
+ * hydrates, makes it stale and it returns ERROR_CANCELLED at its next stage boundary
+ * instead of finishing work nobody will see. Consecutive queries share work: the previous
+ * results are re-scored exactly against the new query alongside the index candidates
+ * (so a hit that is still good stays even when a reduced-probe search misses it), and
+ * hits already hydrated are reused rather than read from the database again.
+ *
+ * The session must not outlive the LeafraCore that created it.
+ */
+class LEAFRA_API SearchSession {
+public:
+    struct State;
+
+    struct Options {
+        int32_t debounce_ms = 80;                    // Wait before a search starts, for the next keystroke (0 = none)
+        size_t max_cached_rows = 512;                // Hydrated hits kept for reuse (beyond it, only the current results are)
+        FaissIndex::SearchParams search_params;      // Probe settings for every search, e.g. a low ef_search (see semantic_search)
+    };
+
+    struct Stats {
+        uint64_t searches = 0;                       // Searches that completed
+        uint64_t superseded = 0;                     // Searches cancelled by a newer one (or cancel())
+        uint64_t reused_rows = 0;                    // Hits served from the hydrated rows
+        uint64_t hydrated_rows = 0;                  // Hits read from the database
+    };
+
+    explicit SearchSession(std::shared_ptr<State> state);
+    ~SearchSession();
+
+    /**
+     * @brief Search for the current input, superseding any search still running for older input
+     * @param query Current input (empty clears the results and cancels older searches)
+     * @param max_results Maximum number of results to return
+     * @param results Output hits, best first
+     * @return ResultCode indicating success or failure (ERROR_CANCELLED if newer input superseded it)
+     */
+    ResultCode search(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results);
+
+    /**
+     * @brief Make every running search stale, e.g. when the search field closes
+     */
+    void cancel();
+
+    /**
+     * @brief Forget the previous results and hydrated rows, so the next search starts from scratch
+     */
+    void reset();
+
+    Stats get_stats() const;
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief Opaque position in a paged semantic search (LeafraCore::semantic_search_page / next_page)
+ *
+ * Holds the query embedding, the index shards searched, the candidate ranking fetched so
+ * far and the ids already returned, so a further page neither re-embeds the query nor
+ * hydrates a hit twice. Pages come from the index as it was when the first page was
+ * searched; hits deleted since are skipped. Safe to page from one thread at a time per cursor.
+ */
+class LEAFRA_API SearchCursor {
+public:
+    struct State;
+
+    explicit SearchCursor(std::shared_ptr<State> state);
+    ~SearchCursor();
+
+    /**
+     * @brief Check if next_page may return more hits
+     */
+    bool has_more() const;
+
+    /**
+     * @brief Hits returned by the pages so far
+     */
+    size_t get_returned() const;
+
+private:
+    friend class LeafraCore;
+    std::shared_ptr<State> state_;
+};
+#endif
+
 /**
  * @brief Main SDK interface class
  * 
@@ -36,6 +335,15 @@ public:
     
     /**
      * @brief Initialize the SDK with configuration
+     * 
+     * With config.attach_read_only the SDK searches a store another process writes, e.g. an
+     * app extension searching the main app's corpus in config.storage_directory (the app
+     * group container). The database must exist; its connection is made query-only and
+     * ingestion, removal, re-indexing, bundle import and restore return ERROR_NOT_IMPLEMENTED.
+     * With vector_search.index_storage "file" and mmap_index_file the writer's index file is
+     * mapped rather than copied into this process. Searches re-open the index when the writer
+     * has committed since (checked every attach_refresh_interval_ms).
+     * 
      * @param config Configuration parameters
      * @return ResultCode indicating success or failure
      */
@@ -47,12 +355,42 @@ public:
      */
     ResultCode shutdown();
     
+    /**
+     * @brief Switch a running SDK to a new configuration without a full shutdown / initialize
+     *
+     * Settings read per call (chunking, search and sampling parameters, thread counts, caches,
+     * logging) take effect in place. The embedding model, tokenizer and LLM are only loaded
+     * again if their load-time settings changed; if the new LLM fails to load the previous
+     * one is restored. A change to the database, the FAISS index layout or the thread pool
+     * sizes still restarts everything.
+     *
+     * Like initialize, call it while no ingestion or search runs on another thread.
+     * @param config The complete new configuration (compared against get_config())
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode reconfigure(const Config& config);
+    
     /**
      * @brief Check if SDK is initialized
      * @return true if initialized, false otherwise
      */
     bool is_initialized() const;
     
+    /**
+     * @brief Readiness of the embedding model
+     * 
+     * With Config::background_load, initialize returns before the model is loaded; calls
+     * that need it wait for the load. Otherwise the future has resolved when initialize returns.
+     * @return Future yielding true once the model is loaded, false if it failed or isn't configured
+     */
+    std::shared_future<bool> embedding_model_ready() const;
+    
+    /**
+     * @brief Readiness of the LLM (see embedding_model_ready)
+     * @return Future yielding true once the model is loaded, false if it failed or isn't configured
+     */
+    std::shared_future<bool> llm_ready() const;
+    
     /**
      * @brief Get current configuration
      * @return Current configuration
@@ -70,16 +408,152 @@ public:
     /**
      * @brief Process user files through the SDK
      * @param file_paths Vector of file paths to process
+     * @param collection Collection to index the files in ("" = default collection; [A-Za-z0-9_-], at most 64 chars)
      * @return ResultCode indicating success or failure
      */
-    ResultCode process_user_files(const std::vector<std::string>& file_paths);
+    ResultCode process_user_files(const std::vector<std::string>& file_paths, const std::string& collection = "");
     
+    /**
+     * @brief Process user files in the background
+     * @param file_paths Vector of file paths to process
+     * @param options Progress / completion callbacks
+     * @return Job handle, or nullptr if the SDK is not initialized
+     */
+    shared_ptr<IngestionJob> process_user_files_async(const std::vector<std::string>& file_paths,
+                                                      const IngestionOptions& options = IngestionOptions());
+
+    /**
+     * @brief Index every supported document under a directory
+     * @param root Directory to enumerate
+     * @param extensions Extensions to include, e.g. {"pdf", "docx"} (empty = every extension a parser supports)
+     * @param recursive Descend into subdirectories (hidden files and directories and symlinks are skipped)
+     * @param collection Collection to index the files in (see process_user_files)
+     * @return ResultCode indicating success or failure (ERROR_NOT_FOUND if root is not a directory)
+     *
+     * Sizes and modification times are taken during enumeration, so unchanged documents are
+     * skipped without another stat, and the largest files are handed to the pipeline first.
+     */
+    ResultCode process_directory(const std::string& root, const std::vector<std::string>& extensions = {},
+                                 bool recursive = true, const std::string& collection = "");
+
+    /**
+     * @brief Index a directory in the background (enumeration runs on the calling thread)
+     * @param root Directory to enumerate
+     * @param extensions Extensions to include (empty = every supported extension)
+     * @param recursive Descend into subdirectories
+     * @param options Progress / completion callbacks and target collection
+     * @return Job handle, or nullptr if the SDK is not initialized or root is not a directory
+     */
+    shared_ptr<IngestionJob> process_directory_async(const std::string& root, const std::vector<std::string>& extensions,
+                                                     bool recursive, const IngestionOptions& options = IngestionOptions());
+
+    /**
+     * @brief Keep a directory indexed: changed files are re-ingested, deleted files removed
+     * @param root Directory to watch (see FileWatcher for the platform backends)
+     * @param extensions Extensions to watch (empty = every supported extension)
+     * @param recursive Watch subdirectories too
+     * @param options Progress / completion callbacks of the ingestion jobs, and their collection
+     * @return ResultCode indicating success or failure
+     *
+     * Only changes made after this call are picked up - index the current contents with
+     * process_directory first. Changes are batched for Config::watch_debounce_ms, then
+     * queued as async ingestion jobs that run one after another. Replaces a previous watch.
+     */
+    ResultCode watch_directory(const std::string& root, const std::vector<std::string>& extensions = {},
+                               bool recursive = true, const IngestionOptions& options = IngestionOptions());
+
+    /**
+     * @brief Stop the watch started by watch_directory (queued jobs still run)
+     */
+    void stop_watching();
+
+    /**
+     * @brief Ingest a queued file next, e.g. the document the user just opened
+     * @param file_path File passed to a running or waiting ingestion job (not started yet)
+     * @return true if a job had the file queued (false: it's being ingested, done, or not queued)
+     *
+     * The file moves to the front of its job, and the job counts as INTERACTIVE until the file
+     * has started: a job of lower priority ingesting meanwhile pauses after the documents it
+     * has in flight, so the file is stored within a few documents' time.
+     */
+    bool bump_priority(const std::string& file_path);
+
+    /**
+     * @brief Continue ingestion runs that were interrupted (app suspended or killed, job cancelled)
+     * @param max_files Most files to ingest in this job (0 = all), so it fits a short background task window
+     * @param options Progress / completion callbacks (the collection is ignored: each file goes back to its own)
+     * @return Job handle, or nullptr if the SDK is not initialized or nothing is pending
+     *
+     * Every run records its files in the database and marks each one done in the transaction
+     * that stores its document, so this picks up the files an earlier run didn't finish,
+     * oldest first. Failed files are retried a few times before they are left alone. Cancel
+     * the job when the background window expires (e.g. BGProcessingTask's expiration
+     * handler): files not stored yet remain pending for the next call.
+     */
+    shared_ptr<IngestionJob> resume_pending_jobs(size_t max_files = 0, const IngestionOptions& options = IngestionOptions());
+
+    /**
+     * @brief Number of files resume_pending_jobs would pick up
+     */
+    size_t get_pending_ingestion_count();
+
+    /**
+     * @brief Remove stored documents with their chunks and vectors
+     * @param doc_ids Document ids, e.g. SearchResult::doc_id (unknown ids are ignored)
+     * @param removed Optional output: number of documents removed
+     * @return ResultCode indicating success or failure
+     *
+     * Waits for running ingestion. The whole set is removed in one transaction: one DELETE
+     * for the chunks and one for the documents, and a single pass over each affected
+     * collection's FAISS index, persisted as one tombstone delta, so removing a folder costs
+     * about as much as removing one document.
+     */
+    ResultCode remove_documents(const std::vector<int64_t>& doc_ids, size_t* removed = nullptr);
+    
+    /**
+     * @brief Add text to the end of a stored document without re-ingesting it (notes, transcripts, logs)
+     * 
+     * Chunking continues from the last stored chunk's overlap, so the cost is proportional to
+     * the appended text: only the new tail chunks are embedded and inserted, with new ids.
+     * The text is appended as given (start it with a newline for a new paragraph). The
+     * document's file fingerprint is left as it was; re-ingesting the file replaces the
+     * appended chunks with the file's own.
+     * 
+     * @param doc_id Document id, e.g. SearchResult::doc_id
+     * @param text Text to append
+     * @param chunks_added Optional output: number of chunks stored
+     * @return ResultCode indicating success or failure (ERROR_INVALID_PARAMETER for an unknown document)
+     */
+    ResultCode append_to_document(int64_t doc_id, const std::string& text, size_t* chunks_added = nullptr);
+    
+    /**
+     * @brief Remove the stored documents of files (see remove_documents by id)
+     * @param file_paths Paths of indexed files; the files themselves may already be deleted
+     * @param removed Optional output: number of documents removed
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode remove_documents(const std::vector<std::string>& file_paths, size_t* removed = nullptr);
+
     /**
      * @brief Set event callback
      * @param callback Function to be called on events
      */
     void set_event_callback(callback_t callback);
     
+    /**
+     * @brief Set a callback receiving typed events (type, message, timestamp, file path)
+     * @param callback Called for every event, before the message callback (both may be set)
+     * 
+     * With Config::async_events, callbacks run on a dispatcher thread and progress
+     * events may be coalesced or dropped; other events are always delivered, in order.
+     */
+    void set_typed_event_callback(event_callback_t callback);
+    
+    /**
+     * @brief Block until every event raised so far has been delivered to the callbacks
+     */
+    void flush_events();
+    
     /**
      * @brief Get SDK version information
      * @return Version string
@@ -99,15 +573,514 @@ public:
      */
     static std::vector<ChunkTokenInfo> extract_chunk_token_info(const std::vector<TextChunk>& chunks);
     
+    /**
+     * @brief Embed a search query with the configured embedding model
+     * 
+     * Low-latency path used by semantic_search: the query is tokenized directly (no
+     * document chunking) and embedded in a single small-bucket inference.
+     * 
+     * @param query Search query string
+     * @param embedding Output embedding vector
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode embed_query(const std::string& query, std::vector<float>& embedding);
+    
+    /**
+     * @brief Get hit/miss counters of the query embedding and search result caches
+     * @return Current cache statistics
+     */
+    SearchCacheStats get_search_cache_stats() const;
+    
+    /**
+     * @brief Drop every cached query embedding and search result and reset the counters
+     */
+    void clear_search_cache();
+    
+    /**
+     * @brief Size of the document database and how much of it is free pages
+     */
+    DatabaseSpaceStats get_database_space_stats() const;
+    
+    /**
+     * @brief Release free pages to the file system now, in DatabaseConfig::vacuum_pages_per_slice slices
+     * @param max_pages Pages to release at most (<= 0 = the whole freelist)
+     * @return ResultCode indicating success or failure (SUCCESS without effect on databases not in INCREMENTAL mode)
+     * 
+     * Without this call the same happens in the background once the database has been idle for
+     * vacuum_idle_ms and more than vacuum_min_free_ratio of it is free. Ingestion waits for at most
+     * one slice - never for a blocking full VACUUM.
+     */
+    ResultCode reclaim_database_space(int64_t max_pages = 0);
+    
+    /**
+     * @brief Get per-stage counts and latency percentiles of the ingestion and query pipeline
+     * @return Snapshot of every PipelineStage since initialization or the last reset_metrics(),
+     *         plus current / high-water memory per MemorySubsystem and the process resident size
+     * 
+     * Always collected (a few relaxed atomic increments per operation), so it can back
+     * production telemetry.
+     */
+    PipelineMetrics get_metrics() const;
+    
+    /**
+     * @brief Get chunk counts and token statistics of the most recent ingestion run
+     * @return Per-document counters of the last process_user_files / process_directory / async run
+     *         (or the one in progress), with totals and averages derived from them
+     * 
+     * Per-chunk dumps stay behind ChunkingConfig::print_chunks_full / print_chunks_brief and debug_mode.
+     */
+    IngestReport get_last_ingest_report() const;
+    
+    /**
+     * @brief Zero every pipeline stage's counters and histogram and restart memory high-water marks
+     */
+    void reset_metrics();
+    
+    /**
+     * @brief Cap the memory one subsystem may hold (Config::memory_budget_mb caps their sum)
+     * @param subsystem Subsystem to cap
+     * @param bytes Budget in bytes (0 = none)
+     * 
+     * Checked after every ingested document: going over a budget logs a warning, raises an
+     * EventType::WARNING event and, once per excursion, reclaims the excess in ReclaimPriority
+     * order (see handle_memory_pressure) - the LLM only if the caches didn't cover it.
+     */
+    void set_memory_budget(MemorySubsystem subsystem, uint64_t bytes);
+    
+    /**
+     * @brief Report the device's thermal / power state as the host app observes it
+     * @param state Thermal state, battery level, charging and low-power mode
+     * @return SUCCESS, or ERROR_INITIALIZATION_FAILED before initialize()
+     * 
+     * Use where native code can't see the state (battery level on iOS, battery saver on
+     * Android). From the first report on the governor stops sampling the platform itself.
+     */
+    ResultCode report_power_state(const PowerState& state);
+    
+    /**
+     * @brief Get the power state the governor acts on and the throughput limits in effect
+     */
+    GovernorState get_governor_state() const;
+    
+    /**
+     * @brief Measure this device's engines and keep the settings that suit them as its device profile
+     * 
+     * Runs short benchmarks on the loaded engines: embedding calls at each batch size up to the
+     * backend maximum, and an LLM prompt evaluation plus a few decoded tokens at each candidate
+     * thread count (LLM thread counts set in the config are kept). The chosen values take effect
+     * at once and are written to Config::device_profile_name, which initialize() applies on later
+     * launches on the same device with the same model files. Run it once while the SDK is idle,
+     * e.g. on first launch; the LLM conversation state is restored afterwards.
+     * 
+     * Settings that change retrieval quality, need an index rebuild or a model reload (index
+     * type, HNSW M, chunk size, CoreML compute units, n_batch / n_ubatch, GPU layers) stay as
+     * configured.
+     * 
+     * @param budget_ms Rough time limit for all benchmarks (the LLM gets two thirds when both are measured)
+     * @param target LATENCY favours the fastest single call, THROUGHPUT settings that share the device well
+     * @param profile Receives the resulting profile (optional)
+     * @return SUCCESS, ERROR_INITIALIZATION_FAILED before initialize() or with nothing to measure,
+     *         ERROR_PROCESSING_FAILED if the profile could not be written
+     */
+    ResultCode autotune(int32_t budget_ms, AutotuneTarget target = AutotuneTarget::LATENCY, DeviceProfile* profile = nullptr);
+    
+    /**
+     * @brief Start recording a timeline of pipeline, inference, FAISS, SQLite and llama decode spans
+     * 
+     * Clears any previous trace. See leafra_trace.h; Config::trace_enabled starts it at initialize().
+     */
+    void start_trace();
+    
+    /**
+     * @brief Stop recording and write the trace as Chrome Trace Event JSON
+     * @param output_path File to write (open in chrome://tracing or ui.perfetto.dev); empty only stops
+     * @return SUCCESS, or ERROR_PROCESSING_FAILED if the file could not be written
+     */
+    ResultCode stop_trace(const std::string& output_path);
+    
+    /**
+     * @brief Write the whole corpus (documents, chunks, embeddings, FAISS indexes) to one bundle file
+     * 
+     * Waits for running ingestion and snapshots every index first. The bundle is a compacted
+     * SQLite file with a manifest (embedding model, dimension, chunking, checksum), so devices
+     * running the same embedding model can import_bundle it instead of ingesting the documents.
+     * 
+     * @param path Bundle file to create (absolute; must not exist yet)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode export_bundle(const std::string& path);
+    
+    /**
+     * @brief Replace the corpus with a bundle written by export_bundle
+     * 
+     * The bundle's checksum must verify and its embedding model and dimension must match this
+     * SDK's, otherwise nothing changes. The database is overwritten in one sequential pass and
+     * the FAISS indexes are reloaded from it; documents ingested before are gone.
+     * 
+     * @param path Bundle file
+     * @return ResultCode indicating success or failure (ERROR_INVALID_PARAMETER for a corrupt or incompatible bundle)
+     */
+    ResultCode import_bundle(const std::string& path);
+    
+    /**
+     * @brief Back up the corpus while the SDK keeps running
+     * 
+     * Pages are copied Config::database.backup_pages_per_step at a time with a short pause between
+     * steps, so ingestion and searches carry on; documents stored meanwhile make it into the copy.
+     * The backup is a bundle-style SQLite file with a manifest; with vector_search.index_storage
+     * "file" the index files are copied to "<path>.indexes" (compaction waits for the backup).
+     * Only the calling thread is blocked - see backup_database_async.
+     * 
+     * @param path Backup file (replaced if it exists)
+     * @return ResultCode indicating success or failure (ERROR_CANCELLED if shutdown interrupted it)
+     */
+    ResultCode backup_database(const std::string& path);
+    
+    /**
+     * @brief backup_database on a background thread
+     * @return Future that becomes ready with the backup's ResultCode (an error at once if a backup is running)
+     */
+    std::shared_future<ResultCode> backup_database_async(const std::string& path);
+    
+    /**
+     * @brief Replace the corpus with a backup written by backup_database
+     * 
+     * Checked like import_bundle; the FAISS indexes are reloaded from the backup, on top of its
+     * index files up to the delta recorded in its manifest.
+     * 
+     * @param path Backup file
+     * @return ResultCode indicating success or failure (ERROR_INVALID_PARAMETER for a corrupt or incompatible backup)
+     */
+    ResultCode restore_database(const std::string& path);
+    
+    /**
+     * @brief Write the documents added and removed after a sync generation to a delta file
+     * 
+     * For ingesting on a desktop build and syncing to phones: the desktop parses and embeds,
+     * and each device applies the delta with import_delta instead of embedding the documents
+     * itself. The delta holds the rows, chunks and stored embeddings of the documents added
+     * since (and still present), the url and collection of those removed, and a manifest with
+     * a checksum like a bundle's. Every stored or removed document advances the generation.
+     * 
+     * @param path Delta file to create (absolute; must not exist yet)
+     * @param since_generation Generation the receiving device applied up to (0 = every document)
+     * @param generation Optional output: generation the delta brings a device up to
+     * @return ResultCode indicating success or failure (ERROR_INVALID_PARAMETER without vector_search.embedding_storage)
+     */
+    ResultCode export_delta(const std::string& path, int64_t since_generation, int64_t* generation = nullptr);
+    
+    /**
+     * @brief Apply a delta written by export_delta, without re-embedding its documents
+     * 
+     * Checked like import_bundle. The documents the delta removes, and earlier copies of the
+     * ones it adds (same url and collection), are removed first; the added documents get new
+     * ids and their stored embeddings go into the FAISS indexes as they are, logged as index
+     * deltas. Applying a delta twice, or one overlapping the last, leaves the same corpus.
+     * 
+     * @param path Delta file
+     * @param applied_generation Exporter generation this device applied up to (the last *generation returned; 0 = none)
+     * @param generation Optional output: exporter generation the corpus is at now, to pass next time
+     * @return ResultCode indicating success or failure (ERROR_INVALID_PARAMETER for a corrupt or incompatible
+     *         delta, or one that starts after applied_generation)
+     */
+    ResultCode import_delta(const std::string& path, int64_t applied_generation, int64_t* generation = nullptr);
+    
+    /**
+     * @brief Sync generation of this store: since_generation for the next export_delta from it (0 without SQLite)
+     */
+    int64_t get_sync_generation();
+    
 #ifdef LEAFRA_HAS_FAISS
     /**
      * @brief Perform semantic search on processed document chunks
+     * 
+     * Safe to call from several threads at once: searches that arrive while others run share
+     * one query embedding inference and one index search (vector_search.query_batch_size).
+     * 
      * @param query Search query string
      * @param max_results Maximum number of results to return
      * @param results Output vector for search results (ID and distance pairs)
+     * @param search_params FAISS probe settings for this query, e.g. a low ef_search for type-ahead
+     *                      (unset fields fall back to vector_search.nprobe / ef_search)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode semantic_search(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results,
+                               const FaissIndex::SearchParams& search_params = FaissIndex::SearchParams());
+    
+    /**
+     * @brief Semantic search into a result set that owns the hits' text in one arena
+     * 
+     * Same hits as semantic_search, but chunk text is copied once from the database into
+     * the set and every document's filename is stored once, so building the results is
+     * one text allocation instead of two strings per hit.
+     * 
+     * @param query Search query string
+     * @param max_results Maximum number of results to return
+     * @param results Output hits, best first (views valid until results is reused or destroyed)
+     * @param search_params FAISS probe settings (see above)
      * @return ResultCode indicating success or failure
      */
-    ResultCode semantic_search(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results);
+    ResultCode semantic_search(const std::string& query, int max_results, SearchResultSet& results,
+                               const FaissIndex::SearchParams& search_params = FaissIndex::SearchParams());
+    
+    /**
+     * @brief Semantic search that degrades rather than overrun a time budget, e.g. for type-ahead
+     * 
+     * Runs like semantic_search until the time left is short, then skips the re-score of
+     * lossy-index candidates, visits fewer IVF lists / HNSW candidates, returns the hits
+     * without text, or (when even a reduced vector search won't fit) answers from the FTS5
+     * keyword index. Degraded results are not stored in the result cache.
+     * 
+     * @param query Search query string
+     * @param max_results Maximum number of results to return
+     * @param results Output vector for search results
+     * @param deadline Budget in; the degradations applied and the time taken out
+     * @param search_params FAISS probe settings (see above; lowered further if the budget requires)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode semantic_search(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results,
+                               SearchDeadline& deadline, const FaissIndex::SearchParams& search_params = FaissIndex::SearchParams(),
+                               QueryStats* stats = nullptr);
+    
+    /**
+     * @brief Semantic search that reports where its time went (see QueryStats)
+     * @param stats Output per-stage durations, candidate counts and cache hits
+     */
+    ResultCode semantic_search(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results,
+                               QueryStats& stats, const FaissIndex::SearchParams& search_params = FaissIndex::SearchParams());
+    
+    /**
+     * @brief Semantic search restricted to chunks matching a filter (documents, filename, date or page range)
+     * 
+     * The filter is resolved to FAISS ids with one database query and applied inside the index
+     * scan, so max_results matching chunks come back without over-fetching. A filter admitting
+     * at most vector_search.exact_scan_max_chunks chunks skips the index: the stored embeddings
+     * are scored exactly in SQLite (vec_dot/vec_l2/vec_cosine) and the best max_results returned.
+     * 
+     * @param query Search query string
+     * @param filter Chunks that may be returned (an empty filter searches everything)
+     * @param max_results Maximum number of results to return
+     * @param results Output vector for search results (empty if nothing matches the filter)
+     * @param search_params FAISS probe settings (see above)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode semantic_search(const std::string& query, const SearchFilter& filter, int max_results,
+                               std::vector<FaissIndex::SearchResult>& results,
+                               const FaissIndex::SearchParams& search_params = FaissIndex::SearchParams());
+    
+    /**
+     * @brief Semantic search over selected collections
+     * 
+     * Every collection has its own FAISS index; the selected shards are searched in parallel
+     * on the worker pool and their top-k lists merged. semantic_search searches all of them.
+     * 
+     * @param query Search query string
+     * @param collections Collections to search (empty = all; unknown names are skipped)
+     * @param max_results Maximum number of results to return
+     * @param results Output vector for search results, best first across all searched collections
+     * @param search_params FAISS probe settings (see semantic_search)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode semantic_search_collections(const std::string& query, const std::vector<std::string>& collections,
+                                           int max_results, std::vector<FaissIndex::SearchResult>& results,
+                                           const FaissIndex::SearchParams& search_params = FaissIndex::SearchParams());
+    
+    /**
+     * @brief Ranking-only semantic search: ids, scores and chunk positions, no text
+     * 
+     * Returns the same hits as semantic_search with only id, distance, doc_id, chunk_index
+     * and page_number set, for callers that re-rank, dedupe or count first and show only a
+     * few hits; hydrate() fills the text of the ones that are shown. Not served from or
+     * stored in the search result cache.
+     * 
+     * @param query Search query string
+     * @param max_results Maximum number of results to return
+     * @param results Output hits, best first (content and filename empty)
+     * @param documents Output filename of every document a hit comes from, by doc_id
+     * @param search_params FAISS probe settings (see semantic_search)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode semantic_search_ids(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results,
+                                   std::unordered_map<int64_t, std::string>& documents,
+                                   const FaissIndex::SearchParams& search_params = FaissIndex::SearchParams());
+    
+    /**
+     * @brief Fill in the text of search hits, e.g. those semantic_search_ids returned that are shown
+     * 
+     * One batched lookup by FAISS id; hits no longer in the database are dropped.
+     * 
+     * @param results Hits to hydrate, in rank order
+     * @param fields SearchResultFields to fill in, combined as a bit mask
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode hydrate(std::vector<FaissIndex::SearchResult>& results,
+                       uint32_t fields = static_cast<uint32_t>(SearchResultFields::ALL));
+    
+    /**
+     * @brief Start a search-as-you-type session (see SearchSession)
+     * @param options Debounce, row reuse and probe settings of the session
+     * @return Session handle, or nullptr if the SDK is not initialized
+     */
+    shared_ptr<SearchSession> create_search_session(const SearchSession::Options& options = SearchSession::Options());
+    
+    /**
+     * @brief First page of a paged semantic search ("more results" without searching again)
+     * 
+     * Searches like semantic_search for page_size hits and returns a cursor for next_page.
+     * @param query Search query string
+     * @param page_size Hits per page
+     * @param results Output first page, best first
+     * @param cursor Output cursor for the following pages
+     * @param search_params FAISS probe settings for every page (see semantic_search)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode semantic_search_page(const std::string& query, int page_size, std::vector<FaissIndex::SearchResult>& results,
+                                    shared_ptr<SearchCursor>& cursor,
+                                    const FaissIndex::SearchParams& search_params = FaissIndex::SearchParams());
+    
+    /**
+     * @brief Next page of a paged semantic search
+     * 
+     * Serves the page from the candidates already fetched when it can; otherwise re-searches
+     * the shards with the stored query embedding at double the previous k (at least enough
+     * for the page). Only the page's own hits are hydrated.
+     * 
+     * @param cursor Cursor from semantic_search_page, advanced past the page
+     * @param results Output page, best first (empty once the results are exhausted)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode next_page(SearchCursor& cursor, std::vector<FaissIndex::SearchResult>& results);
+    
+    /**
+     * @brief Names of the collections that have a FAISS index ("" is the default collection)
+     */
+    std::vector<std::string> list_collections() const;
+    
+    /**
+     * @brief Rebuild one collection's FAISS index from its stored chunk embeddings
+     * 
+     * Waits for running ingestion, builds the new index off to the side and swaps it in;
+     * searches in flight finish on the old one. Requires embedding_storage other than "none".
+     * 
+     * @param collection Collection name ("" = default collection)
+     * @return ResultCode indicating success or failure (ERROR_NOT_FOUND for an unknown collection)
+     */
+    ResultCode rebuild_collection(const std::string& collection);
+    
+    /**
+     * @brief Re-embed the corpus with another embedding model in the background, then switch to it
+     * 
+     * The new model is loaded next to the current one and every stored chunk is embedded again,
+     * behind searches and ingestion, into a shadow table while both carry on with the current
+     * model. At the end ingestion waits briefly: chunks stored meanwhile are embedded too, every
+     * collection's index is rebuilt from the new embeddings and saved, and model, tokenizer and
+     * indexes are swapped in at once, so a search runs entirely on the old ones or the new ones.
+     * The model and a version are recorded per index (index_models); an index built with another
+     * model than the loaded one is not searched. Chunks keep their boundaries. Pass the new model
+     * in the Config of the next initialize, or its indexes won't be searched.
+     * 
+     * @param model Embedding model to index with (replaces embedding_inference)
+     * @param tokenizer Its tokenizer (replaces tokenizer)
+     * @param dimension Embedding dimension of the model (replaces vector_search.dimension)
+     * @return Future that becomes ready with the re-index's ResultCode (an error at once if one is running)
+     */
+    std::shared_future<ResultCode> reindex_embeddings_async(const EmbeddingModelConfig& model, const TokenizerConfig& tokenizer,
+                                                            int32_t dimension);
+    
+    /**
+     * @brief Progress of the running or last re-index
+     */
+    ReindexProgress get_reindex_progress() const;
+    
+    /**
+     * @brief Stop a running re-index before its swap; the current model and indexes stay in use
+     */
+    void cancel_reindex();
+    
+    /**
+     * @brief Compare a candidate embedding model against the loaded one before switching to it
+     * 
+     * Meant for quantized or palettized exports of the loaded model: both embed the same texts,
+     * every text is searched against the others by brute force with vector_search.metric, and
+     * recall@k is the share of the loaded model's k nearest neighbours the candidate also finds.
+     * The candidate shares the loaded tokenizer and is unloaded before returning; the samples are
+     * embedded behind ingestion like re-index work.
+     * 
+     * @param candidate Embedding model to validate (same tokenizer and dimension as the loaded one)
+     * @param sample_texts Texts to compare on; empty samples up to sample_size stored chunks
+     * @param k Neighbours per query
+     * @param validation Receives recall, agreement and timing
+     * @param sample_size Chunks sampled when sample_texts is empty
+     * @return ResultCode indicating success or failure (ERROR_INVALID_PARAMETER for fewer than k + 1 texts or another dimension)
+     */
+    ResultCode validate_embedding_model(const EmbeddingModelConfig& candidate, const std::vector<std::string>& sample_texts,
+                                        int32_t k, EmbeddingModelValidation& validation, int32_t sample_size = 500);
+    
+    /**
+     * @brief Identifier of the loaded embedding model as recorded in index_models
+     * @return Framework, model file name, tokenizer and dimension, e.g. "coreml:e5.mlpackage+multilingual-e5-small/384"
+     */
+    std::string get_embedding_model_id() const;
+    
+    /**
+     * @brief Run several semantic searches at once (e.g. a query plus its LLM rewrites)
+     * 
+     * All queries are embedded in one batched inference and searched with a single FAISS
+     * batch search; the union of hits is hydrated from the database in one pass.
+     * 
+     * @param queries Search query strings
+     * @param max_results Maximum number of results per query
+     * @param results Output result list per query, in query order (empty for a query that failed to embed)
+     * @param search_params FAISS probe settings (see semantic_search)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode semantic_search_batch(const std::vector<std::string>& queries, int max_results,
+                                     std::vector<std::vector<FaissIndex::SearchResult>>& results,
+                                     const FaissIndex::SearchParams& search_params = FaissIndex::SearchParams());
+    
+    /**
+     * @brief Run semantic_search_batch and fuse the per-query rankings by reciprocal rank
+     * @param queries Search query strings
+     * @param max_results Maximum number of fused results (and results per query)
+     * @param results Output vector of hydrated chunks; distance holds the fused score (higher is better)
+     * @param search_params FAISS probe settings (see semantic_search)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode semantic_search_fused(const std::vector<std::string>& queries, int max_results,
+                                     std::vector<FaissIndex::SearchResult>& results,
+                                     const FaissIndex::SearchParams& search_params = FaissIndex::SearchParams());
+    
+    /**
+     * @brief Search chunks with BM25 keyword matching and vector similarity, fused by reciprocal rank
+     * 
+     * Exact terms (part numbers, names) are found by the FTS5 keyword index even when the
+     * embedding model misses them. With alpha == 0, or while no embedding model is ready,
+     * only the keyword index is queried and the model is never run.
+     * 
+     * @param query Search query string
+     * @param max_results Maximum number of results to return
+     * @param alpha Weight of the vector ranking in [0, 1] (0 = keyword only, 1 = vector only)
+     * @param results Output vector of hydrated chunks; distance holds the fused score (higher is better)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode hybrid_search(const std::string& query, int max_results, float alpha, std::vector<FaissIndex::SearchResult>& results);
+    
+    /**
+     * @brief Turn search hits into passages that include their neighbouring chunks
+     * 
+     * Neighbours of all hits are fetched with one batched query. A hit grows outward from
+     * its chunk, nearest chunks first, while its estimated tokens stay within max_tokens;
+     * hits of one document whose passages touch or overlap become a single passage (text
+     * shared through chunk overlap included once), which keeps the rank, id and score of
+     * its best hit. Hits without doc_id / chunk_index are left as they are.
+     * 
+     * @param results Hydrated hits in rank order (e.g. from semantic_search), replaced with the passages
+     * @param before Chunks to add before each hit
+     * @param after Chunks to add after each hit
+     * @param max_tokens Most estimated tokens per hit's passage (0 = no limit; the hit itself is always kept)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode expand_context(std::vector<FaissIndex::SearchResult>& results, int before, int after, int max_tokens = 0);
     
 #ifdef LEAFRA_HAS_LLAMACPP
     /**
@@ -119,6 +1092,57 @@ public:
      * @return ResultCode indicating success or failure
      */
     ResultCode semantic_search_with_llm(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results, token_callback_t callback);
+    
+    /**
+     * @brief semantic_search_with_llm with a time budget for everything before the answer streams
+     * 
+     * The budget covers retrieval, re-ranking and the prompt evaluation up to the first token;
+     * retrieval degrades as in the deadline semantic_search (hits always keep their text) and
+     * the LLM re-ranker is skipped unless its run and the prompt evaluation both fit.
+     * 
+     * @param deadline Budget in; the degradations applied and the call's total time out
+     * @param stats If set, receives the per-stage breakdown (see QueryStats)
+     */
+    ResultCode semantic_search_with_llm(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results,
+                                        token_callback_t callback, SearchDeadline& deadline, QueryStats* stats = nullptr);
+    
+    /**
+     * @brief semantic_search_with_llm that reports where its time went, first token and decode included
+     * @param stats Output per-stage durations, token counts and cache hits
+     */
+    ResultCode semantic_search_with_llm(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results,
+                                        token_callback_t callback, QueryStats& stats);
+#endif
+    
+    /**
+     * @brief Completion of an asynchronous search: the result code and the hits (empty on failure)
+     */
+    using search_completion_t = std::function<void(ResultCode result, std::vector<FaissIndex::SearchResult>&& results)>;
+    
+    /**
+     * @brief Queue a semantic_search on the SDK's request threads and return at once
+     * 
+     * Requests wait in a queue instead of on threads of their own, so a caller can keep any
+     * number in flight; as many run at a time as the request pool has threads (the embedding
+     * plus LLM slots of Config::admission). Requests still queued at shutdown complete with
+     * ERROR_CANCELLED. leafra_core_coro.h wraps this for C++20 coroutines.
+     * 
+     * @param query Search query string
+     * @param max_results Maximum number of results to return
+     * @param completion Runs on a request thread when the search is done (must not call shutdown)
+     * @return false if the request wasn't queued (not initialized or shutting down); completion isn't called then
+     */
+    bool semantic_search_async(const std::string& query, int max_results, search_completion_t completion);
+    
+#ifdef LEAFRA_HAS_LLAMACPP
+    /**
+     * @brief Queue a semantic_search_with_llm on the SDK's request threads and return at once
+     * @param callback Receives the answer tokens on a request thread (return false to stop)
+     * @param completion Runs after the last token with the result code and the context chunks used
+     * @return false if the request wasn't queued; neither function is called then
+     */
+    bool semantic_search_with_llm_async(const std::string& query, int max_results, token_callback_t callback,
+                                        search_completion_t completion);
 #endif
 #endif
 
@@ -130,8 +1154,53 @@ public:
      * @return ResultCode indicating success or failure
      */
     ResultCode llm_inference(const std::string& prompt, std::string& response);
+    
+    /**
+     * @brief Save the LLM conversation state (KV cache and tokens) so it can be resumed without re-evaluation
+     * @param path Session file path
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode save_llm_session(const std::string& path);
+    
+    /**
+     * @brief Restore an LLM conversation state saved with the same model
+     * @param path Session file path
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode load_llm_session(const std::string& path);
+    
+    /**
+     * @brief Release the LLM's memory while keeping the RAG index and embedding model up
+     * 
+     * The conversation context is lost; the next call that needs the LLM reloads it.
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode unload_llm();
+    
+    /**
+     * @brief Load the configured LLM again (unloading it first if it is resident)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode reload_llm();
+    
+    /**
+     * @brief Replace the resident LLM, e.g. with a smaller quantization of the same model
+     * @param llm_config Configuration of the model to load (the previous one is restored if it fails)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode swap_llm(const LLMConfig& llm_config);
 #endif
     
+    /**
+     * @brief React to a platform low-memory warning (didReceiveMemoryWarning, onTrimMemory)
+     * @param pressure MODERATE shrinks caches and scratch buffers; CRITICAL also swaps the LLM to
+     *                 LLMConfig::low_memory_model_path if one is set, otherwise unloads it
+     * 
+     * Memory is reclaimed in ReclaimPriority order: query caches, then chunking scratch and the
+     * SQLite page cache, then saved hot chunk KV states, then the LLM.
+     */
+    void handle_memory_pressure(MemoryPressure pressure = MemoryPressure::CRITICAL);
+    
     /**
      * @brief Create SDK instance
      * @return Shared pointer to LeafraCore instance
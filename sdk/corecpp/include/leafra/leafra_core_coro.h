@@ -0,0 +1,86 @@
+#pragma once
+
+#include "leafra_core.h"
+#include "leafra_coro.h"
+
+#if defined(LEAFRA_HAS_COROUTINES) && defined(LEAFRA_HAS_FAISS)
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace leafra {
+namespace co {
+
+/**
+ * @brief Result of semantic_search_co
+ */
+struct SearchResults {
+    ResultCode result = ResultCode::SUCCESS;
+    std::vector<FaissIndex::SearchResult> hits;
+};
+
+namespace detail {
+
+struct search_awaiter {
+    LeafraCore& core;
+    std::string query;
+    int max_results;
+    SearchResults out;
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> awaiting) {
+        // Once queued, the completion may resume (and finish) the coroutine before submit returns
+        const bool queued = core.semantic_search_async(query, max_results,
+            [this, awaiting](ResultCode result, std::vector<FaissIndex::SearchResult>&& hits) {
+                out.result = result;
+                out.hits = std::move(hits);
+                awaiting.resume();
+            });
+        if (!queued) {
+            out.result = ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        return queued;
+    }
+    SearchResults await_resume() { return std::move(out); }
+};
+
+} // namespace detail
+
+/**
+ * @brief semantic_search as a coroutine: suspends while the search waits and runs on a request thread
+ *
+ * The awaiting coroutine is resumed on the SDK's request thread; hop back to your own
+ * executor afterwards if the continuation does more than a little work.
+ */
+inline task<SearchResults> semantic_search_co(LeafraCore& core, std::string query, int max_results) {
+    co_return co_await detail::search_awaiter{core, std::move(query), max_results, {}};
+}
+
+#ifdef LEAFRA_HAS_LLAMACPP
+/**
+ * @brief semantic_search_with_llm as an async token stream (queued before this returns)
+ */
+inline token_stream semantic_search_with_llm_co(LeafraCore& core, const std::string& query, int max_results) {
+    std::pair<token_stream, token_stream::producer> created = token_stream::create();
+    token_stream::producer feed = created.second;
+    const bool queued = core.semantic_search_with_llm_async(query, max_results,
+        [feed](const std::string& token, bool is_final) {
+            if (is_final || token.empty()) {
+                return true;
+            }
+            return feed.push(token);
+        },
+        [feed](ResultCode result, std::vector<FaissIndex::SearchResult>&& sources) {
+            feed.finish(result, std::move(sources));
+        });
+    if (!queued) {
+        feed.finish(ResultCode::ERROR_INITIALIZATION_FAILED, {});
+    }
+    return std::move(created.first);
+}
+#endif
+
+} // namespace co
+} // namespace leafra
+
+#endif
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <utility>
 
 namespace leafra {
 
@@ -50,6 +51,10 @@ namespace leafra {
  *     std::vector<float>(10)  // Pre-allocate output buffer
  * };
  * bool success = model.predict(inputs, output_buffers);  // No allocation
+ * 
+ * // Zero-copy: CoreML reads and writes these buffers directly; keep them stable between calls
+ * std::vector<float> features(512), mask(128), result(10);
+ * model.predict_into({features.data(), mask.data()}, {512, 128}, {result.data()});
  */
 class LEAFRA_API CoreMLModel {
 public:
@@ -60,9 +65,29 @@ public:
         CPUAndNeuralEngine   // CPU and Neural Engine
     };
 
+    // Element type of a multi-array input or output (models exported with int ids / fp16 I/O)
+    enum class DataType {
+        Float32,
+        Float16,             // IEEE 754 half precision stored as uint16_t (the Neural Engine's native precision)
+        Int32,
+        Float64
+    };
+
+    // Caller-owned buffer for predict_into, in any DataType (converted if it isn't the model's)
+    struct InputBuffer {
+        const void* data = nullptr;
+        size_t size = 0;                    // Elements (getInputSize() or a supported flexible size)
+        DataType type = DataType::Float32;
+    };
+
+    struct OutputBuffer {
+        void* data = nullptr;               // Room for getOutputSize() elements of type
+        DataType type = DataType::Float32;
+    };
+
     /**
      * @brief Construct CoreML model from file
-     * @param model_path Path to .mlpackage or .mlmodel file
+     * @param model_path Path to a compiled .mlmodelc (see compileModel for .mlpackage / .mlmodel sources)
      * @param compute_units Compute units to use for inference
      * @throws std::runtime_error if model loading fails
      */
@@ -100,8 +125,42 @@ public:
     const std::vector<std::string>& getOutputNames() const { return output_names_; }
     const std::vector<size_t>& getInputSizes() const { return input_sizes_; }
     const std::vector<size_t>& getOutputSizes() const { return output_sizes_; }
+    DataType getInputDataType(size_t index) const { return index < input_types_.size() ? input_types_[index] : DataType::Float32; }
+    DataType getOutputDataType(size_t index) const { return index < output_types_.size() ? output_types_[index] : DataType::Float32; }
+    static size_t getDataTypeSize(DataType type);
+
+    /**
+     * @brief Compiled model to load for model_path, compiling .mlmodel / .mlpackage sources
+     * 
+     * With a cache directory the compiled model is kept there under the source's content hash
+     * and the OS version, so later launches skip compilation (once per OS update otherwise).
+     * The stable path also lets CoreML reuse its on-device specialization of the model across
+     * launches. Older compiled copies of the same model are removed. Without a cache directory
+     * the model is compiled into a temporary directory every time.
+     * 
+     * @param model_path .mlmodel, .mlpackage or .mlmodelc (returned unchanged)
+     * @param cache_dir Directory holding compiled models (empty = don't cache)
+     * @return Path of the compiled .mlmodelc, or empty if compilation failed
+     */
+    static std::string compileModel(const std::string& model_path, const std::string& cache_dir);
+
+    /**
+     * @brief Application Support/LeafraSDK/CoreMLCache (excluded from backups)
+     */
+    static std::string defaultCompiledModelCacheDirectory();
+
+    /**
+     * @brief Input sizes accepted by a flexible-shape input (enumerated or range shape constraint)
+     * 
+     * getInputSize() stays the default size. Enumerated shapes return every allowed size in
+     * ascending order; range shapes return {min, max}; fixed-shape inputs return {getInputSize()}.
+     */
+    std::vector<size_t> getSupportedInputSizes(size_t index) const;
+    bool isInputSizeRange(size_t index) const { return index < input_size_ranges_.size() && input_size_ranges_[index].second > 0; }
+    bool isInputSizeSupported(size_t index, size_t size) const;
 
     // Prediction methods (handles both single and multiple inputs/outputs)
+    // Float vectors are converted to / from the model's Int32, Float16 or Float64 inputs and outputs
     std::vector<std::vector<float> > predict(const std::vector<std::vector<float> >& inputs,
                                             const std::vector<std::string>& input_names = {});
 
@@ -111,6 +170,52 @@ public:
                 const std::vector<std::string>& input_names = {},
                 const std::vector<std::string>& output_names = {});
 
+    /**
+     * @brief Zero-copy prediction over caller-owned buffers
+     *
+     * Inputs are wrapped as [1, size] MLMultiArrays (initWithDataPointer) instead of being
+     * copied, and outputs are bound through MLPredictionOptions.outputBackings (iOS 16 /
+     * macOS 13; copied out of CoreML's array otherwise) so results land in the caller's
+     * buffers. The wrappers and the feature provider are kept for the next call with the same
+     * buffer pointers and sizes: keep the buffers alive and stable (e.g. one set per sequence
+     * length) and write new values into them between calls. Not thread-safe.
+     *
+     * @param inputs One Float32 buffer per model input (alphabetical order of names)
+     * @param input_sizes Element count of each input (getInputSize() or a supported flexible size)
+     * @param outputs One buffer per model output, each with room for getOutputSize() floats
+     * @return true on success
+     */
+    bool predict_into(const std::vector<const float*>& inputs, const std::vector<size_t>& input_sizes,
+                      const std::vector<float*>& outputs);
+
+    /**
+     * @brief Zero-copy prediction over caller-owned buffers of any DataType
+     *
+     * Buffers whose type is the model's (getInputDataType / getOutputDataType) are bound
+     * directly - e.g. int32 token ids into an Int32 input, with no conversion loop. Others are
+     * converted through scratch buffers kept between calls.
+     *
+     * @param inputs One buffer per model input (alphabetical order of names)
+     * @param outputs One buffer per model output (alphabetical order of names)
+     * @return true on success
+     */
+    bool predict_into(const std::vector<InputBuffer>& inputs, const std::vector<OutputBuffer>& outputs);
+
+    /**
+     * @brief Batched prediction for many samples in a single CoreML dispatch
+     * 
+     * Uses MLArrayBatchProvider / predictionsFromBatch so CoreML can schedule the whole
+     * batch on the Neural Engine / GPU at once instead of paying per-prediction overhead.
+     * 
+     * @param batch_inputs One entry per sample, each holding the model inputs (alphabetical order of names)
+     * @param input_names Optional expected input names (validated against the model)
+     * @return One entry per sample holding the model outputs (alphabetical order of names)
+     * @throws std::runtime_error if validation or prediction fails
+     */
+    std::vector<std::vector<std::vector<float> > > predict_batch(
+        const std::vector<std::vector<std::vector<float> > >& batch_inputs,
+        const std::vector<std::string>& input_names = {});
+
 private:
     void* model_ptr_;  // Opaque pointer to implementation
     
@@ -119,6 +224,10 @@ private:
     std::vector<std::string> output_names_;  // For public API
     std::vector<size_t> input_sizes_;
     std::vector<size_t> output_sizes_;
+    std::vector<DataType> input_types_;
+    std::vector<DataType> output_types_;
+    std::vector<std::vector<size_t> > input_enumerated_sizes_;           // Empty unless the input has an enumerated shape constraint
+    std::vector<std::pair<size_t, size_t> > input_size_ranges_;          // {0, 0} unless the input has a range shape constraint
     std::string model_description_;
     
     // Cached NSString objects for internal CoreML API calls (avoid conversions)
@@ -0,0 +1,296 @@
+#pragma once
+
+#include "types.h"
+
+// The SDK builds as C++17; these coroutine types (and leafra_core_coro.h) are for C++20 callers only
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define LEAFRA_HAS_COROUTINES 1
+#endif
+#endif
+
+#if defined(LEAFRA_HAS_COROUTINES) && defined(LEAFRA_HAS_FAISS)
+#include "leafra_faiss.h"
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace leafra {
+namespace co {
+
+/**
+ * @brief Lazily started coroutine producing a T, resumed by whoever co_awaits it
+ *
+ * Starts when awaited (or passed to sync_wait) and resumes its awaiter when it completes,
+ * on the thread that completed it. Exceptions propagate to the awaiter.
+ */
+template <typename T>
+class task {
+public:
+    struct promise_type {
+        std::optional<T> value;
+        std::exception_ptr error;
+        std::coroutine_handle<> continuation;
+
+        task get_return_object() { return task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct final_awaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> done) noexcept {
+                std::coroutine_handle<> continuation = done.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+        final_awaiter final_suspend() noexcept { return {}; }
+
+        template <typename U>
+        void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    task(task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    task& operator=(task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+    ~task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+    T await_resume() {
+        if (handle_.promise().error) {
+            std::rethrow_exception(handle_.promise().error);
+        }
+        return std::move(*handle_.promise().value);
+    }
+
+private:
+    explicit task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+// Fire-and-forget coroutine driving a task from sync_wait
+struct detached {
+    struct promise_type {
+        detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+/**
+ * @brief Run a task to completion, blocking the calling thread (tests, blocking bridges)
+ */
+template <typename T>
+T sync_wait(task<T> work) {
+    std::promise<T> result;
+    std::future<T> done = result.get_future();
+    auto run = [](task<T>& awaited, std::promise<T>& out) -> detail::detached {
+        try {
+            out.set_value(co_await awaited);
+        } catch (...) {
+            out.set_exception(std::current_exception());
+        }
+    };
+    run(work, result);
+    return done.get();
+}
+
+/**
+ * @brief Streamed tokens of one answer, consumed with co_await next()
+ *
+ * The producer (the SDK's request thread) resumes a consumer waiting in next() directly, so
+ * the consumer's code runs on that thread until it awaits the next token; tokens that arrive
+ * while the consumer does something else are buffered. Destroying the stream stops the
+ * generation at its next token.
+ *
+ * Example usage:
+ *
+ * token_stream answer = semantic_search_with_llm_co(core, question, 5);   // leafra_core_coro.h
+ * while (std::optional<std::string> token = co_await answer.next()) {
+ *     ui.append(*token);
+ * }
+ * if (answer.result() != ResultCode::SUCCESS) { ... }
+ */
+class token_stream {
+    struct state;
+
+public:
+    /**
+     * @brief Producer side of a stream (copyable; every copy feeds the same stream)
+     */
+    class producer {
+    public:
+        /**
+         * @brief Hand a token to the consumer
+         * @return false once the consumer has dropped the stream (stop generating)
+         */
+        bool push(std::string token) const {
+            std::coroutine_handle<> waiter;
+            {
+                std::lock_guard<std::mutex> lock(state_->mutex);
+                if (state_->dropped || state_->done) {
+                    return false;
+                }
+                state_->tokens.push_back(std::move(token));
+                waiter = std::exchange(state_->waiter, {});
+            }
+            if (waiter) {
+                waiter.resume();
+            }
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            return !state_->dropped;
+        }
+
+        /**
+         * @brief End the stream; next() returns the buffered tokens, then nullopt
+         */
+        void finish(ResultCode result, std::vector<FaissIndex::SearchResult>&& sources) const {
+            std::coroutine_handle<> waiter;
+            {
+                std::lock_guard<std::mutex> lock(state_->mutex);
+                if (state_->done) {
+                    return;
+                }
+                state_->done = true;
+                state_->result = result;
+                state_->sources = std::move(sources);
+                waiter = std::exchange(state_->waiter, {});
+            }
+            if (waiter) {
+                waiter.resume();
+            }
+        }
+
+    private:
+        friend class token_stream;
+        explicit producer(std::shared_ptr<token_stream::state> state) : state_(std::move(state)) {}
+
+        std::shared_ptr<token_stream::state> state_;
+    };
+
+    /**
+     * @brief A new stream and the producer that feeds it
+     */
+    static std::pair<token_stream, producer> create() {
+        auto shared = std::make_shared<state>();
+        return {token_stream(shared), producer(shared)};
+    }
+
+    token_stream(token_stream&& other) noexcept = default;
+    token_stream& operator=(token_stream&& other) noexcept {
+        if (this != &other) {
+            drop();
+            state_ = std::move(other.state_);
+        }
+        return *this;
+    }
+    token_stream(const token_stream&) = delete;
+    token_stream& operator=(const token_stream&) = delete;
+    ~token_stream() { drop(); }
+
+    /**
+     * @brief Awaitable yielding the next token, or nullopt after the last one
+     *
+     * Only one next() may be pending at a time.
+     */
+    auto next() {
+        struct awaiter {
+            state& stream;
+
+            bool await_ready() {
+                std::lock_guard<std::mutex> lock(stream.mutex);
+                return !stream.tokens.empty() || stream.done;
+            }
+            bool await_suspend(std::coroutine_handle<> consumer) {
+                std::lock_guard<std::mutex> lock(stream.mutex);
+                if (!stream.tokens.empty() || stream.done) {
+                    return false;
+                }
+                stream.waiter = consumer;
+                return true;
+            }
+            std::optional<std::string> await_resume() {
+                std::lock_guard<std::mutex> lock(stream.mutex);
+                if (stream.tokens.empty()) {
+                    return std::nullopt;
+                }
+                std::string token = std::move(stream.tokens.front());
+                stream.tokens.pop_front();
+                return token;
+            }
+        };
+        return awaiter{*state_};
+    }
+
+    /**
+     * @brief Result code of the call (valid once next() returned nullopt)
+     */
+    ResultCode result() const {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->result;
+    }
+
+    /**
+     * @brief Context chunks the answer was grounded on (valid once next() returned nullopt)
+     */
+    const std::vector<FaissIndex::SearchResult>& sources() const { return state_->sources; }
+
+private:
+    struct state {
+        std::mutex mutex;
+        std::deque<std::string> tokens;
+        std::coroutine_handle<> waiter;     // Consumer suspended in next()
+        bool done = false;
+        bool dropped = false;               // Consumer destroyed the stream
+        ResultCode result = ResultCode::SUCCESS;
+        std::vector<FaissIndex::SearchResult> sources;
+    };
+
+    explicit token_stream(std::shared_ptr<state> shared) : state_(std::move(shared)) {}
+
+    void drop() {
+        if (state_) {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->dropped = true;
+            state_->waiter = {};
+        }
+    }
+
+    std::shared_ptr<state> state_;
+};
+
+} // namespace co
+} // namespace leafra
+
+#endif
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "types.h"
+#include "leafra_chunker.h"
+#include <condition_variable>
+#include <functional>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+namespace leafra {
+
+class ThreadPool;
+
+/**
+ * @brief One padded batch of embedding inputs, laid out row-major
+ *
+ * The scheduler owns and reuses a single instance, so backends receive the same
+ * preallocated buffers on every call. Token-based backends read token_ids /
+ * attention_mask ([rows x sequence_length]); text-based backends read texts.
+ */
+struct EmbeddingBatch {
+    size_t rows = 0;                        // Number of samples in this batch
+    size_t sequence_length = 0;             // Padded length of every row (0 for text-based backends)
+    std::vector<int32_t> token_ids;         // rows * sequence_length token IDs (padded with pad_token)
+    std::vector<int32_t> attention_mask;    // rows * sequence_length mask (1 = real token, 0 = padding)
+    std::vector<size_t> lengths;            // Real (unpadded) token count per row
+    std::vector<std::string> texts;         // Raw text per row (text-based backends only)
+
+    const int32_t* row_tokens(size_t row) const { return token_ids.data() + row * sequence_length; }
+    const int32_t* row_mask(size_t row) const { return attention_mask.data() + row * sequence_length; }
+};
+
+// Base interface for embedding inference backends
+class IEmbeddingBackend {
+public:
+    virtual ~IEmbeddingBackend() = default;
+
+    // Get backend name for logging ("coreml", "tensorflow_lite", "executorch", "llamacpp")
+    virtual std::string getName() const = 0;
+
+    // Check if the backend has a model loaded and ready for inference
+    virtual bool isReady() const = 0;
+
+    // Whether the backend consumes token IDs (true) or raw text (false)
+    virtual bool requiresTokenIds() const { return true; }
+
+    // Fixed input length rows are padded/trimmed to (0 = no fixed length)
+    virtual size_t getSequenceLength() const = 0;
+
+    // Shorter padded lengths the model also accepts, ascending (empty = only getSequenceLength())
+    virtual std::vector<size_t> getSequenceBuckets() const { return {}; }
+
+    // Number of floats produced per row
+    virtual size_t getEmbeddingDimension() const = 0;
+
+    // Largest batch a single embedBatch call accepts
+    virtual size_t getMaxBatchSize() const = 0;
+
+    // Whether outputs are dequantized from an integer or half precision tensor (quantized model)
+    virtual bool isQuantized() const { return false; }
+
+    // Whether embedBatch already writes L2-normalized rows (normalization fused into pooling)
+    virtual bool normalizesOutput() const { return false; }
+
+    // Embed every row of the batch into output (rows * getEmbeddingDimension() floats, preallocated)
+    virtual bool embedBatch(const EmbeddingBatch& batch, float* output) = 0;
+};
+
+/**
+ * @brief Batching front end shared by every embedding backend
+ *
+ * Owns batching, padding/trimming to the backend's sequence length, the attention
+ * mask and optional L2 normalization of the outputs, so backends only have to
+ * run inference on a ready-made batch. Calls are serialized: backends are not
+ * required to be thread-safe.
+ *
+ * Backends exposing sequence buckets get every row routed to the smallest bucket
+ * that fits its tokens, and batches are formed per bucket - short chunks and
+ * queries no longer pay for attention over a full-length padded sequence.
+ *
+ * With Options::pipeline_depth > 1, bulk embedding is double-buffered: inference
+ * runs on a dedicated thread while the calling thread pads the next batch and
+ * normalizes / stores the previous one, so the accelerator isn't left idle during
+ * CPU preparation. The backend still only sees one call at a time.
+ *
+ * Interactive calls (single queries, Priority::Interactive batches) take precedence
+ * over bulk ones: a bulk call drains its in-flight batches and steps aside between
+ * batches while a query is waiting, so a search issued during a large import waits
+ * for at most one batch rather than the whole document.
+ */
+class LEAFRA_API EmbeddingScheduler {
+public:
+    struct Options {
+        size_t batch_size = 32;             // Rows per backend call (clamped to the backend maximum)
+        int32_t pad_token = 0;              // Token used to pad rows to the sequence length
+        bool normalize = true;              // L2-normalize every output embedding
+        size_t pipeline_depth = 2;          // Batches in flight while embedding many rows (1 = prepare and infer in turn)
+    };
+
+    enum class Priority {
+        Bulk,                               // Ingestion: yields to waiting interactive calls between batches
+        Interactive                         // Search queries
+    };
+
+    EmbeddingScheduler(std::unique_ptr<IEmbeddingBackend> backend, const Options& options);
+    ~EmbeddingScheduler();
+
+    EmbeddingScheduler(const EmbeddingScheduler&) = delete;
+    EmbeddingScheduler& operator=(const EmbeddingScheduler&) = delete;
+
+    /**
+     * @brief Embed every chunk that has token IDs (or text, for text-based backends)
+     * 
+     * Chunks that already carry an embedding are left untouched.
+     * 
+     * @param chunks Chunks to embed (modified in-place with embeddings)
+     * @param priority Bulk for ingestion, Interactive for batched search queries
+     * @return Number of embeddings successfully generated
+     */
+    size_t embed_chunks(std::vector<TextChunk>& chunks, Priority priority = Priority::Bulk);
+
+    /**
+     * @brief Embed a document's chunks straight into its columnar batch
+     * 
+     * Rows come from batch.tokens (or chunks[i].content for text-based backends) and
+     * embeddings are written into batch.embeddings; rows already marked embedded are
+     * left untouched. The matrix is sized for chunks.size() rows on first use.
+     * 
+     * @param chunks The document's chunks (row i of batch belongs to chunks[i])
+     * @param batch Token IDs in, embeddings out
+     * @return Number of embeddings successfully generated
+     */
+    size_t embed_chunk_batch(const std::vector<TextChunk>& chunks, ChunkBatch& batch);
+
+    /**
+     * @brief Embed a single token sequence
+     * @param token_ids Token IDs (trimmed to the backend's sequence length)
+     * @param embedding Output embedding
+     * @return true on success
+     */
+    bool embed_tokens(const std::vector<int>& token_ids, std::vector<float>& embedding);
+
+    /**
+     * @brief Embed a single text (text-based backends only, e.g. llama.cpp)
+     * @param text Text to embed
+     * @param embedding Output embedding
+     * @return true on success
+     */
+    bool embed_text(std::string_view text, std::vector<float>& embedding);
+
+    /**
+     * @brief Padded length a row of token_count tokens is routed to
+     * @return Smallest bucket >= token_count, or the backend's full sequence length
+     */
+    size_t select_sequence_length(size_t token_count) const;
+
+    bool is_ready() const { return backend_ && backend_->isReady(); }
+    const IEmbeddingBackend& backend() const { return *backend_; }
+    const Options& options() const { return options_; }
+    size_t get_effective_batch_size() const;
+
+    /**
+     * @brief Change the rows per backend call from the next batch on (options().batch_size keeps the configured value)
+     * @param batch_size New batch size (0 is treated as 1)
+     */
+    void set_batch_size(size_t batch_size);
+
+private:
+    struct PendingRow {
+        const int* token_ids;
+        size_t token_count;
+        std::string_view text;
+    };
+
+    struct BatchJob {
+        size_t begin;
+        size_t end;
+        size_t sequence_length;
+    };
+
+    // One batch of the inference pipeline: filled by the caller, run on inference_thread_
+    struct BatchSlot {
+        EmbeddingBatch batch;
+        std::vector<float> output;
+        bool ok = false;
+        bool done = false;                  // Guarded by pipeline_mutex_
+    };
+
+    // Counts an interactive call as waiting from before it queues on mutex_ until it has run
+    class InteractiveCall {
+    public:
+        explicit InteractiveCall(EmbeddingScheduler& scheduler);
+        ~InteractiveCall();
+        InteractiveCall(const InteractiveCall&) = delete;
+        InteractiveCall& operator=(const InteractiveCall&) = delete;
+
+    private:
+        EmbeddingScheduler& scheduler_;
+    };
+
+    using StoreEmbedding = std::function<void(size_t index, const float* embedding)>;
+
+    size_t embed_rows(std::vector<PendingRow>& rows, std::vector<size_t>& indices, const StoreEmbedding& store,
+                      std::unique_lock<std::mutex>* bulk_lock);
+    std::vector<size_t> run_pipelined(const std::vector<PendingRow>& rows, const std::vector<BatchJob>& jobs,
+                                      const std::function<void(const BatchJob& job, const float* output)>& store_job,
+                                      std::unique_lock<std::mutex>* bulk_lock);
+    void yield_to_interactive(std::unique_lock<std::mutex>* bulk_lock);
+    bool run_batch(const std::vector<PendingRow>& rows, size_t begin, size_t end, size_t sequence_length);
+    bool run_single(const PendingRow& pending, size_t sequence_length, std::vector<float>& embedding);
+    bool infer(const EmbeddingBatch& batch, float* output);
+    void prepare_batch(EmbeddingBatch& batch, const std::vector<PendingRow>& rows, size_t begin, size_t end, size_t sequence_length);
+    void fill_row(EmbeddingBatch& batch, size_t row, const PendingRow& pending);
+
+    std::unique_ptr<IEmbeddingBackend> backend_;
+    Options options_;
+    std::atomic<size_t> batch_size_{1};     // Rows per backend call in effect (throttled by the governor)
+    std::vector<size_t> sequence_buckets_;  // Ascending, always ending with the backend's sequence length
+    std::mutex mutex_;
+    EmbeddingBatch batch_;                  // Reused between calls
+    std::vector<float> output_;             // Reused between calls
+    std::vector<PendingRow> single_row_;    // Reused by the single-sequence (query) paths
+    std::vector<BatchSlot> slots_;          // Pipeline buffers, reused between calls
+    std::mutex pipeline_mutex_;
+    std::condition_variable pipeline_cv_;
+    std::atomic<int32_t> interactive_waiting_{0};
+    std::mutex interactive_mutex_;
+    std::condition_variable interactive_cv_;
+    std::unique_ptr<ThreadPool> inference_thread_;  // Declared last: joined before the slots and backend go away
+};
+
+/**
+ * @brief Check whether an embedding framework was compiled into this build
+ * @param framework Framework name ("coreml", "tensorflow_lite", "tensorflow", "executorch", "llamacpp")
+ */
+LEAFRA_API bool is_embedding_framework_available(const std::string& framework);
+
+/**
+ * @brief Create the embedding backend selected by EmbeddingModelConfig::framework
+ * @param config SDK configuration (embedding_inference selects and configures the backend)
+ * @return Ready backend, or nullptr if the framework is unknown, not compiled in, or the model failed to load
+ */
+LEAFRA_API std::unique_ptr<IEmbeddingBackend> create_embedding_backend(const Config& config);
+
+} // namespace leafra
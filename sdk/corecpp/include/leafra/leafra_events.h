@@ -0,0 +1,99 @@
+#pragma once
+
+#include "types.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace leafra {
+
+/**
+ * @brief Delivers SDK events to a handler, inline or from a dispatcher thread
+ *
+ * In synchronous mode post() calls the handler before returning, as event callbacks always
+ * did. In asynchronous mode events go through a bounded queue drained by one dispatcher
+ * thread, so a slow consumer (e.g. a React Native bridge) only delays its own events:
+ * - a queued INGESTION_PROGRESS event at the tail is replaced by the next one (coalescing)
+ * - with the queue full, progress events are dropped and other events wait for space
+ * Either way the handler is never called concurrently and events arrive in posting order.
+ *
+ * Example usage:
+ *
+ * EventDispatcher events;
+ * events.set_handler([](const Event& event) { std::cout << event.message << std::endl; });
+ * events.configure(true, 1024, true);
+ * events.post(EventType::INGESTION_PROGRESS, "Parsed report.pdf", "/docs/report.pdf");
+ * events.flush();
+ */
+class LEAFRA_API EventDispatcher {
+public:
+    EventDispatcher() = default;
+
+    /**
+     * @brief Delivers queued events and stops the dispatcher thread
+     */
+    ~EventDispatcher();
+
+    EventDispatcher(const EventDispatcher&) = delete;
+    EventDispatcher& operator=(const EventDispatcher&) = delete;
+
+    /**
+     * @brief Replace the handler; waits for a delivery in progress to finish
+     */
+    void set_handler(event_callback_t handler);
+
+    /**
+     * @brief Switch between inline and dispatcher-thread delivery
+     * @param async Deliver from a dispatcher thread
+     * @param capacity Queued events before progress events are dropped (async only)
+     * @param coalesce_progress Replace a queued progress event with the next one (async only)
+     *
+     * Switching to synchronous delivery first delivers everything still queued.
+     */
+    void configure(bool async, size_t capacity, bool coalesce_progress);
+
+    bool is_async() const { return async_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Raise an event, stamped with the current time
+     */
+    void post(EventType type, std::string message, std::string file_path = std::string());
+
+    /**
+     * @brief Block until every event posted so far has been delivered
+     */
+    void flush();
+
+    /**
+     * @brief Progress events dropped for a full queue / replaced by a newer one
+     */
+    uint64_t dropped_count() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t coalesced_count() const { return coalesced_.load(std::memory_order_relaxed); }
+
+private:
+    void deliver(const Event& event);
+    void dispatch_loop();
+    void stop_thread();
+
+    std::recursive_mutex handler_mutex_;    // Held while the handler runs (re-entered by inline posts from a handler)
+    event_callback_t handler_;
+
+    std::mutex queue_mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::condition_variable idle_;
+    std::deque<Event> queue_;
+    size_t capacity_ = 1024;
+    bool coalesce_progress_ = true;
+    bool delivering_ = false;
+    bool stopping_ = false;
+    std::thread thread_;
+    std::atomic<bool> async_{false};
+
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> coalesced_{0};
+};
+
+} // namespace leafra
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "types.h"
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace leafra {
+
+/**
+ * @brief ExecuTorch program wrapper for embedding inference
+ *
+ * RAII wrapper around an ExecuTorch .pte program and one loaded method. Delegates
+ * (XNNPACK, CoreML, Vulkan) are chosen when the model is exported and lowered; at run
+ * time their backends only need to be linked in, and load fails if one the program
+ * uses is missing. Input and output tensors are allocated once when the method is
+ * loaded: rows are written straight into the input tensors and read straight from the
+ * output tensors, so a batched execute needs no per-call allocation or copy.
+ *
+ * Example usage:
+ *
+ * try {
+ *     ExecuTorchModel model("model.pte", ExecuTorchModel::Options());
+ *     for (size_t row = 0; row < rows; ++row) {           // rows <= getBatchSize()
+ *         model.setTokenRow(0, row, ids.data(), ids.size(), pad_id);
+ *         model.setMaskRow(1, row, ids.size());
+ *     }
+ *     model.execute();
+ *     const float* embedding = model.getOutputRow(0, 0);  // getOutputSize(0) floats
+ * } catch (const std::exception& e) {
+ *     // Handle error: e.what()
+ * }
+ *
+ * Not thread-safe: callers must serialize access to a single instance.
+ */
+class LEAFRA_API ExecuTorchModel {
+public:
+    /**
+     * @brief Method and runtime options
+     */
+    struct Options {
+        std::string method_name = "forward";    // Method of the program to load
+        int32_t num_threads = -1;               // CPU threadpool size used by XNNPACK and the portable kernels (-1 = runtime default)
+    };
+
+    /**
+     * @brief Load a program from file and its method
+     * @param model_path Path to .pte file (the read-only program is shared by every instance built from it)
+     * @param options Method and runtime options
+     * @throws std::runtime_error if the program or method fails to load (e.g. a delegate backend is not linked in)
+     */
+    ExecuTorchModel(const std::string& model_path, const Options& options);
+
+    /**
+     * @brief Destructor - releases the method before its memory and the program
+     */
+    ~ExecuTorchModel();
+
+    // Non-copyable but movable
+    ExecuTorchModel(const ExecuTorchModel&) = delete;
+    ExecuTorchModel& operator=(const ExecuTorchModel&) = delete;
+    ExecuTorchModel(ExecuTorchModel&&) noexcept;
+    ExecuTorchModel& operator=(ExecuTorchModel&&) noexcept;
+
+    /**
+     * @brief Check if the method is loaded and ready for execution
+     */
+    bool isValid() const;
+
+    // Method introspection (shapes are the exported static shapes)
+    size_t getInputCount() const;
+    size_t getOutputCount() const;
+    size_t getInputSequenceLength(size_t index) const;   // Elements per sample of an input tensor
+    size_t getOutputSize(size_t index) const;            // Elements per sample of an output tensor
+    std::vector<int32_t> getOutputDims(size_t index) const;
+    size_t getBatchSize() const;                         // Leading dimension of the inputs
+    size_t getSequenceLength() const;                    // Second dimension of the inputs
+    std::vector<std::string> getBackendNames() const;    // Delegate backends the method was lowered to
+
+    /**
+     * @brief Write one row of token IDs into an input tensor, padding the remainder
+     * @param input_index Input tensor index
+     * @param row Row within the batch
+     * @param token_ids Token IDs (trimmed to the sequence length)
+     * @param count Number of token IDs
+     * @param pad_value Value used for positions after count
+     * @throws std::runtime_error on out-of-range indices or unsupported tensor type
+     */
+    void setTokenRow(size_t input_index, size_t row, const int* token_ids, size_t count, int pad_value);
+
+    /**
+     * @brief Write one row of an attention mask (1 for the first real_count positions, 0 after)
+     * @throws std::runtime_error on out-of-range indices or unsupported tensor type
+     */
+    void setMaskRow(size_t input_index, size_t row, size_t real_count);
+
+    /**
+     * @brief Fill one row of an input tensor with a constant (e.g. token_type_ids)
+     * @throws std::runtime_error on out-of-range indices or unsupported tensor type
+     */
+    void fillRow(size_t input_index, size_t row, int value);
+
+    /**
+     * @brief Execute the method on the current input tensors
+     * @throws std::runtime_error if execution fails
+     */
+    void execute();
+
+    /**
+     * @brief Pointer to one row of a float32 output tensor (valid until the next execute)
+     * @throws std::runtime_error on out-of-range indices or non-float outputs
+     */
+    const float* getOutputRow(size_t output_index, size_t row) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+} // namespace leafra
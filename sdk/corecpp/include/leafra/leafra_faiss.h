@@ -19,6 +19,11 @@ class SQLiteDatabase;
  * This class provides a simplified interface to FAISS (Facebook AI Similarity Search)
  * for building and querying vector indices. It supports various index types and
  * distance metrics for embedding-based search.
+ * 
+ * Thread safety: searches and getters may run concurrently with each other and with
+ * one writer. Writers (add/remove/train/save/restore/migrate) are serialized among
+ * themselves and block searches only while they mutate or swap the live index -
+ * migrate() trains the replacement off to the side and saves serialize alongside searches.
  */
 class LEAFRA_API FaissIndex {
 public:
@@ -30,7 +35,11 @@ public:
         IVF_FLAT,       // Inverted file with exact post-verification
         IVF_PQ,         // Inverted file with product quantization
         HNSW,           // Hierarchical Navigable Small World graphs (now supported with OpenMP)
-        LSH             // Locality-Sensitive Hashing
+        LSH,            // Locality-Sensitive Hashing
+        SQ8,            // Exhaustive scan over 8-bit scalar-quantized codes (1 byte per dimension, needs training)
+        SQ_FP16,        // Exhaustive scan over fp16 codes (2 bytes per dimension, no training)
+        HNSW_SQ,        // HNSW graph over 8-bit scalar-quantized codes (needs training)
+        BINARY          // Sign bit per dimension (d / 8 bytes), Hamming scan; re-score candidates against exact vectors
     };
     
     /**
@@ -39,7 +48,7 @@ public:
     enum class MetricType {
         L2,             // Euclidean distance
         INNER_PRODUCT,  // Inner product (for normalized vectors, equivalent to cosine)
-        COSINE          // Cosine similarity
+        COSINE          // Cosine similarity (inner product; vectors and queries are L2-normalized by the index)
     };
 
     /**
@@ -56,17 +65,45 @@ public:
         std::string content;        // Chunk text content
         std::string filename;       // Source document filename
         
+        // Byte range of content in the document's extracted text, pages joined by a blank line (-1 = not stored)
+        int64_t text_start = -1;
+        int64_t text_end = -1;
+        int64_t page_text_start = -1;   // Where content starts within its page's text
+        
         SearchResult(int64_t id = -1, float distance = 0.0f) 
             : id(id), distance(distance) {}
     };
 
+    /**
+     * @brief Per-call search settings trading latency for recall (0 keeps the index's own setting)
+     * 
+     * allowed_ids restricts the scan itself through a FAISS IDSelector (an offset range for one run
+     * of ascending ids, a bitmap otherwise), so k filtered results come back without over-fetching.
+     * Not supported by LSH indexes; BINARY indexes scan the allowed codes themselves.
+     */
+    struct SearchParams {
+        int nprobe;                 // IVF: inverted lists visited per query (capped at nlist)
+        int ef_search;              // HNSW: candidate list size during search (FAISS uses at least k)
+        size_t max_codes;           // IVF: maximum codes scanned per query
+        const std::vector<int64_t>* allowed_ids;   // Only these vector IDs may be returned (nullptr = all); must outlive the call
+        
+        SearchParams(int nprobe = 0, int ef_search = 0, size_t max_codes = 0)
+            : nprobe(nprobe), ef_search(ef_search), max_codes(max_codes), allowed_ids(nullptr) {}
+        
+        bool is_default() const { return nprobe <= 0 && ef_search <= 0 && max_codes == 0 && !allowed_ids; }
+    };
+
     /**
      * @brief Constructor
      * @param dimension Vector dimension
      * @param index_type Type of FAISS index to create
      * @param metric Distance metric to use
+     * @param index_dimension Leading dimensions the index stores, each vector re-normalized after the cut
+     *        (Matryoshka truncation; 0 or >= dimension keeps them all). Callers still pass and search with
+     *        full vectors. A restored index keeps the dimensions it was saved with.
      */
-    FaissIndex(int dimension, IndexType index_type = IndexType::FLAT, MetricType metric = MetricType::L2);
+    FaissIndex(int dimension, IndexType index_type = IndexType::FLAT, MetricType metric = MetricType::L2,
+               int index_dimension = 0);
     
     /**
      * @brief Destructor
@@ -103,9 +140,11 @@ public:
      * @param query_vector Query vector (dimension floats)
      * @param k Number of nearest neighbors to find
      * @param results Output vector for search results
+     * @param params Probe settings for this call (ignored by index types without them)
      * @return ResultCode indicating success or failure
      */
-    ResultCode search(const float* query_vector, int k, std::vector<SearchResult>& results);
+    ResultCode search(const float* query_vector, int k, std::vector<SearchResult>& results,
+                      const SearchParams& params = SearchParams());
     
     /**
      * @brief Batch search for multiple query vectors
@@ -113,10 +152,27 @@ public:
      * @param query_count Number of query vectors
      * @param k Number of nearest neighbors per query
      * @param results Output vector for all search results (query_count * k results)
+     * @param params Probe settings for this call (ignored by index types without them)
      * @return ResultCode indicating success or failure
      */
     ResultCode batch_search(const float* query_vectors, int query_count, int k, 
-                           std::vector<std::vector<SearchResult>>& results);
+                           std::vector<std::vector<SearchResult>>& results,
+                           const SearchParams& params = SearchParams());
+    
+    /**
+     * @brief Copy stored vectors out of the index by ID
+     * 
+     * Vectors come back as the index holds them: unit length for COSINE, cut to the stored
+     * dimensions of a reduced index, and decoded approximations for lossy types (IVF_PQ, SQ8,
+     * SQ_FP16, HNSW_SQ). Not supported by LSH.
+     * 
+     * @param ids Vector IDs to look up
+     * @param count Number of IDs
+     * @param vectors Output buffer (get_index_dimension() * count floats); rows of missing IDs are left untouched
+     * @param found Output flags, found[i] != 0 if ids[i] is stored (and not removed)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode get_vectors(const int64_t* ids, int count, float* vectors, std::vector<char>& found) const;
     
     /**
      * @brief Train the index (required for some index types like IVF)
@@ -142,22 +198,93 @@ public:
     
     /**
      * @brief Get the number of vectors in the index
-     * @return Number of vectors
+     * @return Number of live vectors (tombstoned vectors are not counted)
      */
     int64_t get_count() const;
     
     /**
-     * @brief Get the dimension of vectors in the index
+     * @brief Get the number of removed vectors still physically held by the index
+     * @return Tombstone count (always 0 for FLAT and LSH, which remove in place)
+     */
+    int64_t get_tombstone_count() const;
+    
+    /**
+     * @brief Get the share of physically stored vectors that are tombstoned
+     * @return Ratio in [0, 1] (use to decide when to purge_tombstones)
+     */
+    double get_tombstone_ratio() const;
+    
+    /**
+     * @brief Get the index generation, bumped whenever the indexed vectors change
+     * @return Generation counter (compare for equality to detect changes, e.g. to invalidate cached results)
+     */
+    uint64_t get_generation() const;
+    
+    /**
+     * @brief Get the heap memory held by the index
+     * @return Bytes of stored vectors/codes, inverted lists, graph links and ID maps
+     */
+    uint64_t get_memory_bytes() const;
+    
+    /**
+     * @brief Get the dimension of vectors passed to the index
      * @return Vector dimension
      */
     int get_dimension() const;
     
+    /**
+     * @brief Get the dimensions the index stores (below get_dimension() for a reduced index)
+     * @return Stored vector dimension
+     */
+    int get_index_dimension() const;
+    
     /**
      * @brief Check if the index is trained (applicable for some index types)
      * @return True if trained, false otherwise
      */
     bool is_trained() const;
     
+    /**
+     * @brief Get the type of the index currently held (changes after migrate or restoring a migrated index)
+     * @return Index type
+     */
+    IndexType get_index_type() const;
+    
+    /**
+     * @brief Let restores accept an index that was already migrated from FLAT to target_type
+     * 
+     * Without it, restore_from_db/restore_from_file report a type mismatch when a FLAT index
+     * finds the IVF snapshot written after an earlier migrate.
+     * 
+     * @param target_type Type a FLAT index of this corpus migrates to
+     */
+    void set_migration_target(IndexType target_type);
+    
+    /**
+     * @brief Run exact searches of a FLAT index on the GPU (Metal builds only)
+     * 
+     * The GPU keeps its own float32 copy of the vectors, brought up to date by the next search
+     * after a change (appends copy just the new rows). Searches with allowed_ids, and indexes
+     * that are not FLAT (including a migrated AUTO index) or hold fewer than min_vectors, stay
+     * on the CPU, as does everything after a GPU failure.
+     * 
+     * @param min_vectors Vector count below which the CPU scan is faster than a GPU round trip
+     * @return false if this build or device has no Metal support
+     */
+    bool enable_gpu_search(int64_t min_vectors);
+    
+    /**
+     * @brief Size of the OpenMP team FAISS uses inside this index's calls
+     * 
+     * Applies to adds, training, migrations, tombstone purges and batched searches (one
+     * thread per worker, so large bulk adds build HNSW graphs and assign IVF lists in
+     * parallel). Single-query searches always run on the calling thread: they already fan
+     * out across the query pool, and nested teams would oversubscribe the cores.
+     * 
+     * @param threads Threads per call (<= 0 = the OpenMP default, one per core)
+     */
+    void set_thread_count(int threads);
+    
     /**
      * @brief Get index type as string
      * @return String representation of index type
@@ -172,6 +299,12 @@ public:
 
     /**
      * @brief Save FAISS index to SQLite database as blob
+     * 
+     * Writes a full snapshot and, in the same transaction, drops the delta log for the
+     * definition (compaction). Prefer append_vectors_to_db for per-document updates.
+     * The index is serialized straight into a preallocated BLOB in 1 MB pieces, so saving
+     * (and restoring) needs no in-memory copy of the serialized index.
+     * 
      * @param db SQLite database reference
      * @param definition Table/field definition string for storage identification
      * @return ResultCode indicating success or failure
@@ -180,22 +313,169 @@ public:
     
     /**
      * @brief Restore FAISS index from SQLite database blob
+     * 
+     * Loads the base blob (if any) and replays the delta log on top of it.
+     * 
      * @param db SQLite database reference  
      * @param definition Table/field definition string for storage identification
-     * @return ResultCode indicating success or failure
+     * @return ResultCode indicating success or failure (ERROR_NOT_FOUND if neither a blob nor deltas exist)
      */
     ResultCode restore_from_db(SQLiteDatabase& db, const std::string& definition);
 
+    /**
+     * @brief Save FAISS index to a standalone file next to the database (file storage mode)
+     * 
+     * Writes "<base_path>.<watermark>.faiss", where the watermark is the last delta id folded
+     * into the file, then trims those deltas from the log and removes older index files.
+     * 
+     * @param db SQLite database holding the delta log
+     * @param definition Table/field definition string for storage identification
+     * @param base_path Absolute path prefix for the index file
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode save_to_file(SQLiteDatabase& db, const std::string& definition, const std::string& base_path);
+
+    /**
+     * @brief Restore FAISS index from the newest standalone index file and replay newer deltas
+     * 
+     * With use_mmap, IVF inverted lists are memory-mapped read-only instead of being read into
+     * the heap; they are loaded into memory on the first add/remove/train. Falls back to
+     * restore_from_db when no index file exists yet.
+     * 
+     * @param db SQLite database holding the delta log
+     * @param definition Table/field definition string for storage identification
+     * @param base_path Absolute path prefix for the index file
+     * @param use_mmap Memory-map the file instead of reading it
+     * @return ResultCode indicating success or failure (ERROR_NOT_FOUND if no index exists anywhere)
+     */
+    ResultCode restore_from_file(SQLiteDatabase& db, const std::string& definition, const std::string& base_path,
+                                 bool use_mmap);
+
+    /**
+     * @brief Delete every index file save_to_file wrote for base_path, with its inverted lists file
+     * 
+     * For when the database holding their delta log is replaced (their watermarks no longer apply).
+     * 
+     * @param base_path Absolute path prefix passed to save_to_file
+     */
+    static void remove_index_files(const std::string& base_path);
+
+    /**
+     * @brief Copy the newest index file save_to_file wrote for base_path, and its inverted lists file, into a directory
+     * 
+     * File names are kept, so lists files are still found next to their index file. Used by backups,
+     * and by restores with the backup's copy as base_path.
+     * 
+     * @param base_path Absolute path prefix passed to save_to_file
+     * @param directory Existing destination directory
+     * @param watermark Output, watermark of the copied file (-1 if there was none)
+     * @return ResultCode::SUCCESS also when there was nothing to copy
+     */
+    static ResultCode copy_index_files(const std::string& base_path, const std::string& directory, int64_t& watermark);
+
+    /**
+     * @brief Keep IVF inverted lists in a memory-mapped file instead of the heap (file storage mode)
+     * 
+     * Only the coarse quantizer and the list table stay resident; a search pages in just the
+     * nprobe lists it visits. save_to_file gives each snapshot its own copy of the lists
+     * ("<index file>.ivfdata", a clone on APFS), and a restored snapshot's lists are mapped
+     * read-only until the first change copies them to path. Call before restoring.
+     * 
+     * @param path Live lists file, overwritten as needed ("" keeps lists of later IVF indexes on the heap)
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode set_on_disk_lists(const std::string& path);
+
+    /**
+     * @brief Check if the index is currently served from a read-only memory mapping
+     */
+    bool is_memory_mapped() const;
+
+    /**
+     * @brief Start reading the files a search pages in (mmapped index, on-disk inverted lists) into the page cache
+     * @return Bytes requested (0 when the index lives entirely on the heap)
+     */
+    uint64_t prefetch() const;
+
+    /**
+     * @brief Persist vectors already added to the index as one append-only delta
+     * 
+     * Writes only the given ids and vectors (O(batch) bytes) instead of re-serializing the
+     * whole index. Deltas are replayed by restore_from_db and folded into the base blob by
+     * save_to_db.
+     * 
+     * @param db SQLite database reference
+     * @param definition Table/field definition string for storage identification
+     * @param vectors Vectors (count * dimension floats)
+     * @param ids Vector IDs
+     * @param count Number of vectors
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode append_vectors_to_db(SQLiteDatabase& db, const std::string& definition,
+                                    const float* vectors, const int64_t* ids, int count);
+
+    /**
+     * @brief Persist removed vector IDs as one append-only tombstone delta
+     * @param db SQLite database reference
+     * @param definition Table/field definition string for storage identification
+     * @param ids Removed vector IDs
+     * @param count Number of IDs
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode append_removals_to_db(SQLiteDatabase& db, const std::string& definition, const int64_t* ids, int count);
+
+    /**
+     * @brief Number of vectors and tombstones in the delta log since the last save_to_db
+     * @return Pending delta entries (use to decide when to compact)
+     */
+    int64_t get_pending_delta_count() const;
+
     /**
      * @brief Remove vectors from the index by their IDs
+     * 
+     * FLAT and LSH indexes drop the vectors in place. IVF lists don't renumber on removal and
+     * HNSW graphs can't remove at all, so for those types the vectors are only tombstoned:
+     * searches skip them through an IDSelector until purge_tombstones rebuilds the index.
+     * 
      * @param ids Vector IDs to remove
      * @param count Number of IDs to remove
      * @return ResultCode indicating success or failure
-     * @note Not all index types support efficient removal. This method requires ID mapping to be enabled.
+     * @note This method requires ID mapping to be enabled.
      */
     ResultCode remove_vectors(const int64_t* ids, int count);
+    
+    /**
+     * @brief Rebuild the index from its live vectors, dropping every tombstoned one
+     * 
+     * Live vectors are reconstructed from the index itself (IVF_PQ vectors are re-encoded from
+     * their decoded form) and re-added under their IDs; IVF training is kept. Cost is O(live vectors),
+     * so call it when get_tombstone_ratio crosses a threshold rather than after every removal.
+     * 
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode purge_tombstones();
+    
+    /**
+     * @brief Train an IVF or scalar-quantized index on the live vectors and swap it in for the current index
+     * 
+     * The replacement is trained on an evenly strided sample (at most 256 vectors per IVF list,
+     * 65536 for the SQ value ranges) and filled next to the current index, which is only replaced
+     * once the new one is complete; on failure the current index is left as it was. Vector IDs are kept. Callers must save a full
+     * snapshot afterwards (save_to_db / save_to_file) so the migration survives a restart.
+     * 
+     * @param target_type IVF_FLAT, IVF_PQ, SQ8 or HNSW_SQ
+     * @param nlist Number of inverted lists (0 = 4 * sqrt(vector count)); capped so every list gets 39+ training vectors
+     * @param pq_m Subquantizers for IVF_PQ (0 or a non-divisor of the dimension = largest divisor <= dimension / 8)
+     * @param pq_nbits Bits per IVF_PQ subquantizer
+     * @return ResultCode indicating success or failure (ERROR_INVALID_PARAMETER if there are too few vectors to train)
+     */
+    ResultCode migrate(IndexType target_type, int nlist, int pq_m = 0, int pq_nbits = 8);
 
 private:
+    ResultCode restore_base_from_db(SQLiteDatabase& db, const std::string& definition);
+    ResultCode replay_deltas_from_db(SQLiteDatabase& db, const std::string& definition, int64_t& replayed,
+                                     int64_t after_delta_id);
+
     class Impl;
     std::unique_ptr<Impl> pImpl;
 };
@@ -4,6 +4,10 @@
 #include <string>
 #include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
 
 namespace leafra {
 
@@ -37,6 +41,78 @@ public:
         FileInfo() : size_bytes(0), creation_time(0), modification_time(0), is_directory(false) {}
     };
 
+    /**
+     * @brief How a mapped file will be read (passed to the OS as a readahead hint)
+     */
+    enum class AccessHint {
+        Sequential,      // Front to back once (text, CSV)
+        Random,          // Jumps around (PDF cross-reference tables, ZIP central directories)
+        Normal           // No hint
+    };
+
+    /**
+     * @brief Read-only view of a whole file
+     *
+     * Memory-mapped (mmap / MapViewOfFile) where possible, so the bytes are the OS page
+     * cache itself: nothing is copied, and re-parsing a file shortly after hits the cache.
+     * Files that can't be mapped are read into memory instead; callers see no difference.
+     * The view stays valid until the MappedFile is destroyed or moved from.
+     */
+    class LEAFRA_API MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief Map a file by absolute path (closes a previous mapping first)
+         * @return false if the file can't be opened or read
+         */
+        bool open(const std::string& full_path, AccessHint hint = AccessHint::Sequential);
+
+        void close();
+
+        bool isOpen() const { return open_; }
+        bool isMapped() const { return mapping_ != nullptr; }   // false: contents were read into memory
+        const char* data() const { return mapping_ ? static_cast<const char*>(mapping_) : buffer_.data(); }
+        size_t size() const { return mapping_ ? size_ : buffer_.size(); }
+        std::string_view view() const { return std::string_view(data(), size()); }
+
+    private:
+        void* mapping_ = nullptr;
+        size_t size_ = 0;
+        std::string buffer_;
+        bool open_ = false;
+    };
+
+    /**
+     * @brief Map a file from the specified storage location read-only
+     * @param storage_type Storage location
+     * @param relative_path Relative path to the file
+     * @param hint Expected access pattern
+     * @return Mapping (isOpen() is false if the file couldn't be opened)
+     */
+    static MappedFile mapFile(StorageType storage_type, const std::string& relative_path,
+                              AccessHint hint = AccessHint::Sequential);
+
+    /**
+     * @brief Map a file by absolute path read-only (used by the parsing adapters)
+     */
+    static MappedFile mapFile(const std::string& full_path, AccessHint hint = AccessHint::Sequential);
+
+    /**
+     * @brief Ask the OS to start reading a file into the page cache, without waiting for it
+     *
+     * Used to warm model weights and memory-mapped indexes after startup, so the first
+     * query doesn't pay for the disk reads. Nothing is copied or kept mapped.
+     * @param full_path Absolute path to the file
+     * @return Bytes requested, 0 if the file can't be mapped or the platform has no hint (Windows)
+     */
+    static uint64_t prefetchFile(const std::string& full_path);
+
     /**
      * @brief Create a file in the specified storage location
      * @param storage_type Where to create the file (app storage or document storage)
@@ -125,6 +201,16 @@ public:
      */
     static std::string getStorageBasePath(StorageType storage_type);
 
+    /**
+     * @brief Use a directory of the caller's choosing as a storage location's base
+     *
+     * For storage several processes share, e.g. an iOS app group container the app's
+     * extensions also open. Applies process-wide to every path resolved afterwards.
+     * @param storage_type Storage location
+     * @param absolute_path Existing directory ("" = the platform location again)
+     */
+    static void setStorageBasePath(StorageType storage_type, const std::string& absolute_path);
+
 private:
     /**
      * @brief Initialize storage directories if they don't exist
@@ -148,4 +234,71 @@ private:
     static bool ensureParentDirectoriesExist(const std::string& full_path);
 };
 
+/**
+ * @brief Watches a directory tree and reports debounced file changes
+ *
+ * Backed by inotify on Linux / Android, FSEvents on macOS and kqueue on iOS. Notifications
+ * only mark directories dirty; once no notification arrived for debounce_ms, the dirty
+ * directories are rescanned against the previous snapshot. The cost of a change is thus
+ * proportional to the directories it touched, not to the size of the tree. Hidden entries
+ * and symlinks are ignored, like in LeafraCore::process_directory.
+ *
+ * On iOS kqueue watches directories only: files rewritten in place (same name, no rename)
+ * are picked up with the next change in their directory. Atomic saves are reported directly.
+ */
+class LEAFRA_API FileWatcher {
+public:
+    /**
+     * @brief One debounced batch of changes (canonical paths)
+     */
+    struct Changes {
+        std::vector<std::string> modified;   // Created or modified files
+        std::vector<std::string> removed;    // Deleted files (or files in deleted directories)
+    };
+    using ChangeCallback = std::function<void(const Changes& changes)>;
+
+    struct Options {
+        bool recursive = true;               // Watch subdirectories too
+        int debounce_ms = 500;               // Quiet period before dirty directories are rescanned
+        std::vector<std::string> extensions; // Only report files with these extensions, e.g. "pdf" (empty = all)
+    };
+
+    FileWatcher();
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Snapshot root and start watching it (the current contents are not reported)
+     * @param root Directory to watch
+     * @param options Recursion, debounce interval and extension filter
+     * @param callback Called from the watcher thread with each batch of changes
+     * @return ERROR_NOT_FOUND if root is not a directory, ERROR_NOT_IMPLEMENTED on platforms without a backend
+     */
+    ResultCode start(const std::string& root, const Options& options, ChangeCallback callback);
+
+    /**
+     * @brief Start watching a directory in one of the SDK storage locations
+     * @param storage_type Storage location (typically DocumentStorage)
+     * @param relative_path Directory relative to the storage root ("" = the root itself)
+     */
+    ResultCode start(StorageType storage_type, const std::string& relative_path, const Options& options, ChangeCallback callback);
+
+    /**
+     * @brief Stop watching; returns once no callback is running anymore (don't call it from the callback)
+     */
+    void stop();
+
+    bool isRunning() const;
+
+    /**
+     * @brief Whether this platform has a watcher backend
+     */
+    static bool isSupported();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
 } // namespace leafra 
\ No newline at end of file
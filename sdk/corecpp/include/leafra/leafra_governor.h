@@ -0,0 +1,158 @@
+#pragma once
+
+#include "types.h"
+#include "platform_utils.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace leafra {
+
+/**
+ * @brief Throughput knobs the governor scales
+ */
+struct LEAFRA_API ThroughputLimits {
+    size_t ingest_workers = 1;          // Documents prepared concurrently
+    size_t embedding_batch_size = 1;    // Rows per embedding backend call
+    int32_t llm_threads = 1;            // llama.cpp generation threads
+    int32_t llm_batch_threads = 1;      // llama.cpp prompt processing threads
+    int32_t faiss_threads = 1;          // FAISS OpenMP threads per index build / batched search
+};
+
+/**
+ * @brief What the governor currently sees and enforces
+ */
+struct LEAFRA_API GovernorState {
+    PowerState power;                   // Last sampled (or host-reported) power state
+    double scale = 1.0;                 // Fraction of the unthrottled limits in effect
+    ThroughputLimits limits;            // Limits in effect
+    int32_t interactive_calls = 0;      // Searches / generations in flight
+    size_t ingest_allowance = 0;        // Documents ingestion may prepare right now
+};
+
+/**
+ * @brief Scales ingestion, embedding and LLM throughput with the device's thermal and power state
+ *
+ * Running flat out until the OS throttles makes every later request slow, foreground search
+ * included. The governor trades peak throughput for predictable latency instead:
+ * - the unthrottled limits (ThreadBudget and the configured batch size) are scaled by the
+ *   thermal state (fair 0.75, serious 0.5, critical 0.25), halved again in low-power mode and
+ *   again on a low battery that isn't charging
+ * - while a search or generation is in flight, ingestion prepares at most
+ *   Options::interactive_ingest_workers documents at a time, so queries get the cores
+ *
+ * The power state is sampled from PlatformUtils at most every Options::poll_interval_ms, from
+ * update() at document and query boundaries (no thread of its own), unless the host reports it
+ * with report_power_state() (e.g. Android PowerManager battery saver, which native code can't
+ * read); from then on only reported states are used.
+ *
+ * Example usage:
+ *
+ * ThroughputGovernor governor;
+ * governor.configure(ThroughputGovernor::Options(), ceiling);
+ * {
+ *     ThroughputGovernor::IngestPermit permit(governor);   // Ingestion worker, per document
+ *     prepare_document();
+ * }
+ * {
+ *     ThroughputGovernor::InteractiveScope query(governor); // Search entry point
+ *     search();
+ * }
+ */
+class LEAFRA_API ThroughputGovernor {
+public:
+    struct Options {
+        bool enabled = true;                    // false: limits stay at the ceiling and ingestion is never held back
+        int32_t poll_interval_ms = 5000;        // Minimum time between power state samples
+        int32_t low_battery_percent = 20;       // At or below this charge (not charging) throughput is halved
+        size_t interactive_ingest_workers = 1;  // Documents prepared concurrently while a query runs (0 = pause ingestion)
+    };
+
+    ThroughputGovernor() = default;
+
+    ThroughputGovernor(const ThroughputGovernor&) = delete;
+    ThroughputGovernor& operator=(const ThroughputGovernor&) = delete;
+
+    /**
+     * @brief Set the options and the unthrottled limits, then sample the power state
+     */
+    void configure(const Options& options, const ThroughputLimits& ceiling);
+
+    /**
+     * @brief Replace the unthrottled limits (e.g. after an LLM swap changed its thread count)
+     */
+    void set_ceiling(const ThroughputLimits& ceiling);
+    ThroughputLimits ceiling() const;
+
+    /**
+     * @brief Sample the power state if the poll interval has passed and rescale
+     * @param force Sample regardless of the poll interval
+     * @return true if the limits changed
+     */
+    bool update(bool force = false);
+
+    /**
+     * @brief Use a power state observed by the host instead of sampling the platform
+     * @return true if the limits changed
+     */
+    bool report_power_state(const PowerState& state);
+
+    ThroughputLimits limits() const;
+    GovernorState state() const;
+
+    /**
+     * @brief Fraction of the unthrottled limits a power state allows
+     */
+    static double throttle_scale(const PowerState& power, int32_t low_battery_percent);
+
+    /**
+     * @brief Scale every limit, keeping each at least 1
+     */
+    static ThroughputLimits scale_limits(const ThroughputLimits& ceiling, double scale);
+
+    /**
+     * @brief Marks a search or generation in flight for its lifetime
+     */
+    class InteractiveScope {
+    public:
+        explicit InteractiveScope(ThroughputGovernor& governor);
+        ~InteractiveScope();
+        InteractiveScope(const InteractiveScope&) = delete;
+        InteractiveScope& operator=(const InteractiveScope&) = delete;
+
+    private:
+        ThroughputGovernor& governor_;
+    };
+
+    /**
+     * @brief Admission for one document's preparation; blocks while ingestion is at its allowance
+     */
+    class IngestPermit {
+    public:
+        explicit IngestPermit(ThroughputGovernor& governor);
+        ~IngestPermit();
+        IngestPermit(const IngestPermit&) = delete;
+        IngestPermit& operator=(const IngestPermit&) = delete;
+
+    private:
+        ThroughputGovernor& governor_;
+    };
+
+private:
+    bool apply_locked(const PowerState& power);
+    size_t ingest_allowance_locked() const;
+
+    mutable std::mutex mutex_;
+    std::condition_variable permits_cv_;
+    Options options_;
+    ThroughputLimits ceiling_;
+    ThroughputLimits limits_;
+    PowerState power_;
+    double scale_ = 1.0;
+    bool host_reported_ = false;
+    int64_t last_poll_ms_ = -1;
+    int32_t interactive_calls_ = 0;
+    size_t active_ingest_ = 0;
+};
+
+} // namespace leafra
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace leafra {
+
+/**
+ * @brief Streaming 64-bit FNV-1a hash used to detect changed documents and chunks
+ *
+ * Meant for change detection only - it is fast and stable across platforms, but not
+ * collision resistant against deliberately crafted input.
+ *
+ * Example usage:
+ *
+ * std::string file_hash;
+ * if (ContentHasher::hash_file(path, file_hash)) { ... }
+ * std::string chunk_hash = ContentHasher::hash_text(chunk.content);
+ */
+class LEAFRA_API ContentHasher {
+public:
+    void update(const void* data, size_t size);
+    void update(std::string_view text) { update(text.data(), text.size()); }
+    uint64_t digest() const { return state_; }
+
+    static constexpr size_t kHexDigestSize = 16;
+
+    /**
+     * @brief Digest as 16 lowercase hex characters
+     */
+    std::string hex_digest() const;
+
+    /**
+     * @brief Write the hex digest to out (kHexDigestSize chars, not terminated) without allocating
+     */
+    void hex_digest(char* out) const;
+
+    /**
+     * @brief Hex digest of a string
+     */
+    static std::string hash_text(std::string_view text);
+
+    /**
+     * @brief Hex digest of a file's bytes, read in fixed-size blocks
+     * @return false if the file can't be read
+     */
+    static bool hash_file(const std::string& path, std::string& hex_digest);
+
+private:
+    uint64_t state_ = 14695981039346656037ULL;  // FNV-1a 64-bit offset basis
+};
+
+} // namespace leafra
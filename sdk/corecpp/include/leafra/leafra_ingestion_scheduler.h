@@ -0,0 +1,127 @@
+#pragma once
+
+#include "types.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief Orders ingestion runs by priority, and the files within a run, so urgent documents go first
+ *
+ * Runs take turns: one run holds the turn at a time, and the next turn goes to the waiting
+ * run with the highest priority (the one registered first among equals). The holder asks
+ * next() for each file it starts; next() stops handing out files as soon as a run of a higher
+ * priority is waiting, so the holder finishes the documents it has in flight, releases its
+ * turn and waits for another one to do the rest. Runs are preempted between documents only.
+ *
+ * bump() moves a file that wasn't handed out yet to the front of its run and makes the run
+ * INTERACTIVE until the file is handed out, which preempts a lower priority holder too.
+ *
+ * Example usage:
+ *
+ * IngestionScheduler::Run run(scheduler, file_paths, IngestionPriority::NORMAL);
+ * do {
+ *     run.acquire();
+ *     size_t index = 0;
+ *     while (run.next(index)) {
+ *         ingest(file_paths[index]);
+ *     }
+ *     run.release();
+ * } while (run.preempted());
+ */
+class LEAFRA_API IngestionScheduler {
+public:
+    /**
+     * @brief One ingestion run's files, registered with the scheduler for its lifetime
+     */
+    class LEAFRA_API Run {
+    public:
+        /**
+         * @param scheduler Scheduler the run takes turns on
+         * @param file_paths Files of the run (must outlive it)
+         * @param priority Scheduling class of the run
+         */
+        Run(IngestionScheduler& scheduler, const std::vector<std::string>& file_paths, IngestionPriority priority);
+        ~Run();
+
+        Run(const Run&) = delete;
+        Run& operator=(const Run&) = delete;
+
+        /**
+         * @brief Block until this run holds the turn
+         */
+        void acquire();
+
+        /**
+         * @brief Give up the turn (no-op if not held)
+         */
+        void release();
+
+        /**
+         * @brief Take the next file: bumped files first, then in list order
+         * @param index Output index into file_paths
+         * @return false if every file was handed out, or a higher priority run is waiting
+         */
+        bool next(size_t& index);
+
+        /**
+         * @brief Check if files are left and a higher priority run is waiting for the turn
+         */
+        bool preempted() const;
+
+        /**
+         * @brief Number of files not handed out yet
+         */
+        size_t remaining() const;
+
+    private:
+        friend class IngestionScheduler;
+
+        IngestionScheduler& scheduler_;
+        const std::vector<std::string>& file_paths_;
+        IngestionPriority priority_;
+        uint64_t ticket_ = 0;                  // Registration order, breaks ties between equal priorities
+        std::vector<uint8_t> taken_;           // Per file: handed out by next()
+        size_t cursor_ = 0;                    // Files before it were all handed out
+        std::deque<size_t> bumped_;            // Bumped files, in bump order (may hold taken ones)
+        size_t remaining_ = 0;
+        bool waiting_ = false;                 // Blocked in acquire()
+    };
+
+    IngestionScheduler() = default;
+
+    IngestionScheduler(const IngestionScheduler&) = delete;
+    IngestionScheduler& operator=(const IngestionScheduler&) = delete;
+
+    /**
+     * @brief Move a file to the front of every run that hasn't handed it out yet
+     * @param file_path Path as it was passed to the run
+     * @return true if a run had the file pending
+     */
+    bool bump(const std::string& file_path);
+
+    /**
+     * @brief Number of registered runs (holding, waiting or between turns)
+     */
+    size_t run_count() const;
+
+private:
+    // Callers hold mutex_
+    static IngestionPriority effective_priority(const Run& run);
+    const Run* next_holder_locked() const;
+    bool outranked_locked(const Run& run) const;
+
+    mutable std::mutex mutex_;
+    std::condition_variable turn_cv_;
+    std::vector<Run*> runs_;
+    const Run* holder_ = nullptr;
+    uint64_t next_ticket_ = 0;
+};
+
+} // namespace leafra
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+
+namespace leafra {
+
+/**
+ * @brief How large buffers and mapped model files are backed (Config::large_pages)
+ */
+enum class LargePagePolicy : int32_t {
+    OFF = 0,                                // Regular pages
+    TRANSPARENT = 1,                        // madvise(MADV_HUGEPAGE): the kernel backs them with 2 MB pages as it can
+    EXPLICIT = 2                            // Reserved huge pages (MAP_HUGETLB) for bulk buffers, TRANSPARENT for the rest
+};
+
+/**
+ * @brief Large page usage reported in PipelineMetrics::large_pages
+ */
+struct LEAFRA_API LargePageMetrics {
+    std::string policy = "off";             // Policy in effect
+    bool supported = false;                 // The kernel has transparent huge pages enabled for madvise
+    uint64_t huge_resident_bytes = 0;       // Resident memory backed by huge pages (AnonHugePages, FilePmdMapped, Private_Hugetlb)
+    uint64_t explicit_bytes = 0;            // Held in reserved huge pages by LargePageAllocator
+    uint64_t explicit_fallbacks = 0;        // EXPLICIT allocations the reserved pool couldn't serve (advised instead)
+    uint64_t advised_regions = 0;           // Buffers and mappings advised since startup
+};
+
+/**
+ * @brief Huge page backing for the SDK's multi-gigabyte buffers (Linux and Android only)
+ *
+ * FLAT/HNSW vectors, bulk rebuild matrices and mmapped model weights are accessed at random
+ * during ANN search and attention; with 4 KB pages that is mostly TLB misses. Under a policy
+ * other than OFF, FaissIndex advises its storage after every change that grows it, rebuilds
+ * copy vectors into LargePageAllocator buffers, and LeafraCore advises the mappings of the
+ * LLM and embedding model files. Elsewhere, and for buffers under one huge page, every call
+ * here is a no-op.
+ *
+ * Example usage:
+ *
+ * large_pages::set_policy(LargePagePolicy::TRANSPARENT);
+ * large_pages::advise(codes.data(), codes.size());
+ * std::vector<float, LargePageAllocator<float> > matrix(rows * dimension);
+ */
+namespace large_pages {
+
+constexpr size_t kHugePageBytes = size_t(2) * 1024 * 1024;
+
+/**
+ * @brief Parse a Config::large_pages value ("off", "transparent", "explicit")
+ * @return false for anything else (policy is left unchanged)
+ */
+LEAFRA_API bool parse_policy(const std::string& name, LargePagePolicy& policy);
+
+LEAFRA_API const char* policy_name(LargePagePolicy policy);
+
+/**
+ * @brief Set the process-wide policy; buffers advised or allocated earlier keep their pages
+ */
+LEAFRA_API void set_policy(LargePagePolicy policy);
+
+LEAFRA_API LargePagePolicy policy();
+
+/**
+ * @brief Whether madvise(MADV_HUGEPAGE) can take effect (THP mode "always" or "madvise")
+ */
+LEAFRA_API bool supported();
+
+/**
+ * @brief Advise an allocated buffer; only the 2 MB pages wholly inside it are covered
+ * @return Bytes advised (0 under OFF, for small buffers or if the kernel refuses)
+ */
+LEAFRA_API size_t advise(const void* data, size_t bytes);
+
+/**
+ * @brief Advise every mapping of a file in this process (found in /proc/self/maps)
+ * @param path File whose mappings to advise, e.g. the mmapped llama.cpp weights
+ * @return Bytes advised
+ *
+ * File-backed huge pages also need a kernel built with CONFIG_READ_ONLY_THP_FOR_FS;
+ * otherwise the advice is accepted and the mapping keeps regular pages.
+ */
+LEAFRA_API size_t advise_file(const std::string& path);
+
+/**
+ * @brief Allocate a buffer for LargePageAllocator (regular heap below one huge page)
+ * @throws std::bad_alloc if no memory is available
+ */
+LEAFRA_API void* allocate(size_t bytes);
+LEAFRA_API void deallocate(void* data, size_t bytes) noexcept;
+
+/**
+ * @brief Current usage and counters for PipelineMetrics
+ */
+LEAFRA_API LargePageMetrics metrics();
+
+} // namespace large_pages
+
+/**
+ * @brief Standard allocator for bulk matrices: buffers of a huge page or more are mapped
+ *        directly so they can be backed per the large page policy
+ */
+template<typename T>
+class LargePageAllocator {
+public:
+    using value_type = T;
+
+    LargePageAllocator() noexcept = default;
+    template<typename U>
+    LargePageAllocator(const LargePageAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        if (count > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(large_pages::allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* data, size_t count) noexcept { large_pages::deallocate(data, count * sizeof(T)); }
+
+    template<typename U>
+    bool operator==(const LargePageAllocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const LargePageAllocator<U>&) const noexcept { return false; }
+};
+
+} // namespace leafra
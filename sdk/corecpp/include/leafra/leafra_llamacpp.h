@@ -7,6 +7,7 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <future>
 #include <cstdint>
 #include "types.h"
 
@@ -38,7 +39,10 @@ using TokenCallback = leafra::token_callback_t;
  */
 struct GenerationStats {
     int32_t prompt_tokens = 0;      // Number of tokens in prompt
+    int32_t reused_prompt_tokens = 0; // Prompt tokens already in the KV cache from the previous call (not re-evaluated)
     int32_t generated_tokens = 0;   // Number of tokens generated
+    int32_t draft_tokens = 0;       // Speculative tokens proposed by the draft model
+    int32_t accepted_draft_tokens = 0; // Speculative tokens the target model kept
     double prompt_eval_time = 0.0;  // Time to evaluate prompt (ms)
     double generation_time = 0.0;   // Time to generate tokens (ms)
     double tokens_per_second = 0.0; // Generation speed (tokens/sec)
@@ -46,6 +50,19 @@ struct GenerationStats {
     GenerationStats() = default;
 };
 
+/**
+ * @brief In-memory copy of the conversation state (KV cache plus the tokens it holds)
+ * 
+ * Restoring one skips re-evaluating the conversation so far. Only valid for the model
+ * (and context size) it was taken from.
+ */
+struct SessionSnapshot {
+    std::vector<uint8_t> state;     // Serialized KV cache of the conversation sequence
+    std::vector<int32_t> tokens;    // Tokens the cache holds, in position order
+    
+    bool empty() const { return tokens.empty(); }
+};
+
 /**
  * @brief LlamaCpp model wrapper for text generation
  */
@@ -99,6 +116,34 @@ public:
         int32_t max_tokens = 0
     );
     
+    /**
+     * @brief Generate text with streaming callback from an already tokenized prompt
+     *
+     * Lets callers that assemble prompts against a token budget skip re-tokenizing
+     * the text they just measured. The tokens must include any special tokens (BOS).
+     * @param tokens Prompt token IDs
+     * @param callback Function called for each generated token
+     * @param max_tokens Maximum number of tokens to generate (0 = use config default)
+     * @return true if generation completed successfully
+     */
+    bool generate_from_tokens(
+        const std::vector<int32_t>& tokens,
+        TokenCallback callback,
+        int32_t max_tokens = 0
+    );
+    
+    /**
+     * @brief Same as above for tokens held in a caller's buffer
+     * @param tokens First prompt token ID
+     * @param count Number of tokens
+     */
+    bool generate_from_tokens(
+        const int32_t* tokens,
+        size_t count,
+        TokenCallback callback,
+        int32_t max_tokens = 0
+    );
+    
     /**
      * @brief Continue text generation from current context
      * @param additional_prompt Additional text to append to context
@@ -141,6 +186,19 @@ public:
      */
     double calculate_perplexity(const std::string& text);
     
+    /**
+     * @brief Calculate the perplexity of several texts in shared batches
+     * 
+     * Texts that fit one batch are decoded together as parallel sequences (up to
+     * LLMConfig::n_seq_max per decode). Texts longer than the context are scored with a
+     * sliding window of n_ctx tokens advancing by half a window, so every token is
+     * predicted with at least half a window of context.
+     * 
+     * @param texts Input texts
+     * @return Perplexity per text (-1.0 for texts with fewer than two tokens), or an empty vector on error
+     */
+    std::vector<double> score_texts(const std::vector<std::string>& texts);
+    
     /**
      * @brief Get embeddings for text (if supported by model)
      * @param text Input text
@@ -148,6 +206,33 @@ public:
      */
     std::vector<float> get_embeddings(const std::string& text);
     
+    /**
+     * @brief Get embeddings for many texts in as few decodes as possible
+     * 
+     * Texts are packed into one batch as distinct sequences (up to LLMConfig::n_seq_max at a
+     * time) and the model's pooled output is read per sequence. Models without pooling, and
+     * texts longer than a ubatch, are embedded one at a time. Model state is restored afterwards.
+     * 
+     * @param texts Input texts
+     * @return texts.size() x get_embedding_dimension() row-major matrix, or an empty vector on error
+     */
+    std::vector<float> get_embeddings_batch(const std::vector<std::string>& texts);
+    
+    /**
+     * @brief Score how relevant each passage is to a query (higher = more relevant)
+     * 
+     * The score is the logit margin of answering "yes" over "no" to whether the passage is
+     * relevant. The query prompt is evaluated once and shared; passages are decoded up to
+     * LLMConfig::n_seq_max at a time as parallel sequences. Model state is restored afterwards.
+     * 
+     * @param query Query text
+     * @param passages Candidate passages
+     * @param max_passage_tokens Tokens of each passage considered (longer passages are truncated)
+     * @return One score per passage, or an empty vector on error
+     */
+    std::vector<float> score_relevance(const std::string& query, const std::vector<std::string>& passages,
+                                       int32_t max_passage_tokens = 256);
+    
     /**
      * @brief Get vocabulary size
      * @return Number of tokens in vocabulary
@@ -166,6 +251,21 @@ public:
      */
     int32_t get_context_used() const;
     
+    /**
+     * @brief Get the memory held by the loaded model
+     * @param kv_cache_bytes Set to the KV cache size of the generation and draft contexts (F16 K and V per position)
+     * @param weight_bytes Set to the size of the model and draft model weights (also counted by
+     *        any other instance sharing them through ModelRegistry)
+     */
+    void get_memory_usage(uint64_t& kv_cache_bytes, uint64_t& weight_bytes) const;
+    
+    /**
+     * @brief Change the generation and prompt processing thread counts of the loaded contexts
+     * @param n_threads Threads for token generation
+     * @param n_threads_batch Threads for prompt processing
+     */
+    void set_threads(int32_t n_threads, int32_t n_threads_batch);
+    
     /**
      * @brief Get model configuration
      * @return Current model configuration
@@ -202,15 +302,86 @@ public:
      */
     bool supports_embeddings() const;
     
+    /**
+     * @brief Get embedding dimension of the loaded model
+     * @return Number of floats returned by get_embeddings, 0 if no model is loaded
+     */
+    int32_t get_embedding_dimension() const;
+    
+    /**
+     * @brief Run a one-token decode so the first request doesn't pay for paging in
+     *        mmapped weights and compiling GPU kernels
+     * 
+     * Clears the conversation context, so call it before set_system_prompt.
+     * @return true if the decode succeeded
+     */
+    bool warm_up();
+    
     /**
      * @brief Set system prompt (if model supports it)
      * @param system_prompt System prompt text
      * @return true if successful
      */
     bool set_system_prompt(const std::string& system_prompt);
+    
+    /**
+     * @brief Evaluate tokens into the KV cache without generating
+     * 
+     * A later prompt starting with these tokens reuses them from the cache (with
+     * LLMConfig::reuse_prompt_cache), so a fixed prompt prefix can be evaluated while the
+     * rest of the prompt is still being prepared.
+     * 
+     * @param tokens Prompt prefix
+     * @return false if the model isn't loaded, the tokens don't fit the context, or evaluation failed
+     */
+    bool prefill_tokens(const std::vector<int32_t>& tokens);
+    
+    /**
+     * @brief Capture the current conversation state
+     * @param snapshot Output snapshot
+     * @return true if successful
+     */
+    bool save_snapshot(SessionSnapshot& snapshot);
+    
+    /**
+     * @brief Replace the conversation state with a snapshot taken from this model
+     * @param snapshot Snapshot from save_snapshot
+     * @return true if successful (on failure the context is reset)
+     */
+    bool restore_snapshot(const SessionSnapshot& snapshot);
+    
+    /**
+     * @brief Make the KV cache hold a snapshot that begins a prompt, so only the rest of it is evaluated
+     * 
+     * Nothing is restored when the cache already holds at least the snapshot's prefix of the
+     * prompt. KV entries are tied to their positions, so the snapshot only applies to prompts
+     * that start with exactly its tokens.
+     * 
+     * @param snapshot Snapshot from save_snapshot
+     * @param prompt Prompt about to be passed to generate_from_tokens
+     * @return true if the cache now holds the snapshot's tokens (false if they don't begin the prompt or restoring failed)
+     */
+    bool restore_prefix_snapshot(const SessionSnapshot& snapshot, const std::vector<int32_t>& prompt);
+    
+    /**
+     * @brief Write the conversation state to a file
+     * @param path Session file path
+     * @return true if successful
+     */
+    bool save_session(const std::string& path);
+    
+    /**
+     * @brief Restore the conversation state from a file written by save_session with the same model
+     * @param path Session file path
+     * @return true if successful (on failure the context is reset)
+     */
+    bool load_session(const std::string& path);
 
     /**
      * @brief Generate response for a chat conversation
+     * 
+     * A leading system message is rendered and tokenized once and cached, so later turns
+     * with the same system prompt only tokenize the rest of the conversation.
      * @param messages Vector of chat messages (conversation history)
      * @param max_tokens Maximum number of tokens to generate
      * @return Generated response or empty string on error
@@ -230,6 +401,21 @@ public:
         int32_t max_tokens = 0
     );
     
+    /**
+     * @brief Queue a generation that is decoded together with other queued generations
+     * 
+     * Each request runs in its own KV sequence with its own sampler; up to LLMConfig::n_seq_max - 1
+     * of them share every llama_decode, and queued requests join as soon as a sequence and enough
+     * context are free. With n_seq_max = 1 requests run one after another. The conversation
+     * (generate_text, chat, sessions) keeps sequence 0 and is not disturbed.
+     * 
+     * @param prompt Prompt text
+     * @param callback Function called for each generated token, from the scheduler thread
+     * @param max_tokens Maximum number of tokens to generate (0 = config n_predict)
+     * @return Future that becomes true once the generation completed, false if it failed
+     */
+    std::future<bool> submit_generation(const std::string& prompt, TokenCallback callback, int32_t max_tokens = 0);
+    
     /**
      * @brief Format chat messages using the model's built-in chat template
      * @param messages Vector of chat messages
@@ -311,6 +497,20 @@ namespace utils {
      */
     LLMConfig get_recommended_config(const std::string& model_path);
     
+    /**
+     * @brief Largest number of layers to offload to the GPU that fits in its memory
+     * 
+     * Reads the layer count and per-layer tensor sizes from the GGUF header, adds each layer's
+     * KV cache for config.n_ctx (type_k/type_v), and fits the last layers (then the output
+     * layer) into what the GPU device reports free - on iOS also what the process may still
+     * allocate - less config.gpu_memory_margin_mb.
+     * 
+     * @param model_path Path to the model file
+     * @param config Context size, KV cache types and memory margin to size for
+     * @return Layers to offload (0 without a GPU or a readable header)
+     */
+    int32_t recommend_gpu_layers(const std::string& model_path, const LLMConfig& config);
+    
     /**
      * @brief Get list of available built-in chat templates
      * @return Vector of template names
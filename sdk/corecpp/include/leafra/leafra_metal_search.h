@@ -0,0 +1,68 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace leafra {
+
+/**
+ * @brief Exact k-NN over a float32 vector mirror on the GPU (Metal, Apple platforms only)
+ *
+ * Rows live in one shared-storage MTLBuffer (unified memory, so uploads are plain memcpys),
+ * padded to a multiple of 4 floats. A search scores up to 16 queries per dispatch, one GPU
+ * thread per (row, query), then a second kernel keeps the best k of each 512-row chunk; the CPU
+ * merges those candidates. Scores match IndexFlat: squared L2 distances (ascending) or inner
+ * products (descending). Calls must be serialized by the owner.
+ *
+ * Example usage:
+ *
+ * auto gpu = MetalFlatSearch::create(dimension, true);
+ * if (gpu && gpu->append(vectors, rows)) {
+ *     gpu->search(query, 1, 10, distances, offsets);   // Offsets are row numbers in append order
+ * }
+ */
+class LEAFRA_API MetalFlatSearch {
+public:
+    /**
+     * @brief Create a GPU mirror
+     * @param inner_product true scores by inner product, false by squared L2 distance
+     * @return nullptr if there is no Metal device or the kernels fail to compile
+     */
+    static std::unique_ptr<MetalFlatSearch> create(int dimension, bool inner_product);
+
+    ~MetalFlatSearch();
+
+    MetalFlatSearch(const MetalFlatSearch&) = delete;
+    MetalFlatSearch& operator=(const MetalFlatSearch&) = delete;
+
+    /**
+     * @brief Append rows (dimension floats each) after the ones already mirrored
+     * @return false if the buffer could not grow (the mirror is then left empty)
+     */
+    bool append(const float* vectors, size_t rows);
+
+    /**
+     * @brief Drop every mirrored row (keeps the buffer)
+     */
+    void clear();
+
+    /**
+     * @brief k nearest rows for each of n queries
+     * @param distances Output, n * k scores, best first
+     * @param offsets Output, n * k row numbers (-1 for empty slots)
+     * @return false if the GPU work failed (outputs undefined; search on the CPU instead)
+     */
+    bool search(const float* queries, size_t n, size_t k, float* distances, int64_t* offsets);
+
+    size_t size() const;
+    size_t memory_bytes() const;
+
+private:
+    struct Impl;
+    explicit MetalFlatSearch(std::unique_ptr<Impl> impl);
+    std::unique_ptr<Impl> pImpl;
+};
+
+} // namespace leafra
@@ -0,0 +1,403 @@
+#pragma once
+
+#include "types.h"
+#include "leafra_admission.h"
+#include "leafra_large_pages.h"
+#include "leafra_trace.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief Instrumented steps of the ingestion and query pipeline
+ */
+enum class PipelineStage : int32_t {
+    PARSE = 0,          // Document text extraction (cache hits included)
+    CHUNK = 1,          // Splitting a parsed document into chunks
+    TOKENIZE = 2,       // SentencePiece encoding of a document's chunks
+    EMBED = 3,          // Embedding model inference for a document's chunks
+    QUERY_EMBED = 4,    // Tokenize + embed of search queries
+    FAISS_ADD = 5,      // Adding a document's vectors to its collection index
+    FAISS_SEARCH = 6,   // Index search for one query batch
+    DB_INSERT = 7,      // Document + chunk insert transaction
+    DB_HYDRATE = 8,     // Loading chunk text for search hits
+    LLM_PROMPT_EVAL = 9,// Prompt processing up to the first generated token
+    LLM_DECODE = 10,    // Token generation after the first token
+    FAISS_SAVE = 11,    // Full snapshot of a collection index (compaction, rebuild, restore)
+    COUNT = 12
+};
+
+/**
+ * @brief Name of a stage as reported in StageMetrics::name ("parse", "faiss_search", ...)
+ */
+LEAFRA_API const char* pipeline_stage_name(PipelineStage stage);
+
+/**
+ * @brief Components whose memory is accounted separately (see MemoryAccountant)
+ */
+enum class MemorySubsystem : int32_t {
+    CHUNKING_SCRATCH = 0,   // Per-thread ChunkingScratch: UnicodeCacher index and token buffers
+    DOCUMENTS = 1,          // Page text, chunks, token IDs and embeddings of documents being ingested
+    FAISS_INDEX = 2,        // Vectors and index structures of every loaded collection
+    SQLITE = 3,             // SQLite heap (page cache, statements) as reported by sqlite3_memory_used
+    LLM_KV_CACHE = 4,       // llama.cpp KV caches of the generation (and draft) context
+    LLM_WEIGHTS = 5,        // llama.cpp model weights (memory-mapped, so partly reclaimable)
+    QUERY_CACHES = 6,       // In-memory query embedding, search result and answer caches
+    COUNT = 7
+};
+
+/**
+ * @brief Order in which MemoryAccountant::reclaim asks components for memory (lowest first)
+ */
+enum class ReclaimPriority : int32_t {
+    CACHE = 0,              // Results that are cheap to recompute (query embeddings, search results, answers)
+    SCRATCH = 1,            // Buffers kept for reuse (chunking scratch, SQLite page cache)
+    WARM_STATE = 2,         // Saved state that spares expensive work (LLM prompt KV snapshots)
+    MODEL = 3               // Loaded models (the LLM swaps to its low-memory variant or unloads)
+};
+
+/**
+ * @brief How hard the platform is pressing for memory (LeafraCore::handle_memory_pressure)
+ */
+enum class MemoryPressure : int32_t {
+    MODERATE = 0,           // Give back caches and scratch buffers (Android TRIM_MEMORY_RUNNING_LOW, UI_HIDDEN, BACKGROUND)
+    CRITICAL = 1            // Models too (iOS memory warning, Android TRIM_MEMORY_RUNNING_CRITICAL, COMPLETE)
+};
+
+/**
+ * @brief Name of a subsystem as reported in MemoryMetrics::name ("chunking_scratch", "faiss_index", ...)
+ */
+LEAFRA_API const char* memory_subsystem_name(MemorySubsystem subsystem);
+
+/**
+ * @brief Current and high-water memory of one subsystem
+ */
+struct LEAFRA_API MemoryMetrics {
+    std::string name;
+    uint64_t current_bytes = 0;
+    uint64_t peak_bytes = 0;        // High-water mark since startup or the last reset
+    uint64_t budget_bytes = 0;      // 0 = no budget
+};
+
+/**
+ * @brief Aggregated timings of one pipeline stage
+ */
+struct LEAFRA_API StageMetrics {
+    std::string name;
+    uint64_t count = 0;             // Recorded operations
+    uint64_t items = 0;             // Units processed (pages, chunks, tokens, vectors, hits)
+    double total_ms = 0.0;          // Sum of operation latencies
+    double p50_ms = 0.0;            // Latency percentiles, from log-scaled buckets (within ~6%)
+    double p95_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+/**
+ * @brief Snapshot of every stage's metrics (index = PipelineStage)
+ */
+struct LEAFRA_API PipelineMetrics {
+    std::vector<StageMetrics> stages;
+    std::vector<MemoryMetrics> memory;      // index = MemorySubsystem
+    uint64_t tracked_bytes = 0;             // Sum of every subsystem's current_bytes
+    uint64_t tracked_peak_bytes = 0;        // High-water mark of that sum
+    uint64_t tracked_budget_bytes = 0;      // Budget for the sum (0 = none)
+    uint64_t resident_bytes = 0;            // Process resident set size (0 if the platform doesn't report it)
+    uint64_t peak_resident_bytes = 0;       // Process high-water resident set size
+    std::vector<AdmissionMetrics> admission; // Queue depth per resource, index = AdmissionResource (empty outside LeafraCore)
+    LargePageMetrics large_pages;           // Huge page backing (filled by LeafraCore)
+
+    const StageMetrics& stage(PipelineStage stage) const { return stages[static_cast<size_t>(stage)]; }
+    const MemoryMetrics& memory_usage(MemorySubsystem subsystem) const { return memory[static_cast<size_t>(subsystem)]; }
+    const AdmissionMetrics& queue(AdmissionResource resource) const { return admission[static_cast<size_t>(resource)]; }
+};
+
+/**
+ * @brief Lock-free latency histogram with log-scaled microsecond buckets
+ *
+ * Values below 16 us get a bucket each; above that every power of two is split into 16
+ * buckets, so a reported percentile is within about 6% of the true value. Recording is a
+ * handful of relaxed atomic increments, cheap enough to leave on in production.
+ */
+class LEAFRA_API LatencyHistogram {
+public:
+    static constexpr size_t kSubBucketBits = 4;
+    static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    static constexpr size_t kBucketCount = kSubBuckets * (64 - kSubBucketBits + 1);
+
+    void record(uint64_t micros, uint64_t items = 1);
+    void reset();
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t items() const { return items_.load(std::memory_order_relaxed); }
+    uint64_t total_micros() const { return total_micros_.load(std::memory_order_relaxed); }
+    uint64_t max_micros() const { return max_micros_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Upper bound of the bucket holding the q-th quantile (0 if nothing was recorded)
+     * @param q Quantile in [0, 1]
+     */
+    uint64_t percentile_micros(double q) const;
+
+    static size_t bucket_index(uint64_t micros);
+    static uint64_t bucket_upper_bound(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> items_{0};
+    std::atomic<uint64_t> total_micros_{0};
+    std::atomic<uint64_t> max_micros_{0};
+};
+
+/**
+ * @brief One histogram per pipeline stage, safe to record into from any thread
+ *
+ * Example usage:
+ *
+ * {
+ *     PipelineMetricsRecorder::ScopedStage timing(metrics_, PipelineStage::PARSE);
+ *     document = parser.parseFile(path);
+ *     timing.set_items(document.getPageCount());
+ * }
+ * PipelineMetrics snapshot = metrics_.snapshot();
+ */
+class LEAFRA_API PipelineMetricsRecorder {
+public:
+    void record(PipelineStage stage, std::chrono::steady_clock::duration elapsed, uint64_t items = 1);
+    PipelineMetrics snapshot() const;
+    void reset();
+
+    /**
+     * @brief Median latency of a stage so far, for budgeting the next operation (0 = none recorded)
+     */
+    double typical_ms(PipelineStage stage) const;
+
+    /**
+     * @brief Records the time from construction to destruction into a stage
+     *
+     * While tracing is on, the operation is also recorded as a "pipeline" trace span.
+     */
+    class ScopedStage {
+    public:
+        ScopedStage(PipelineMetricsRecorder& recorder, PipelineStage stage)
+            : recorder_(recorder), stage_(stage), start_(std::chrono::steady_clock::now()),
+              span_("pipeline", pipeline_stage_name(stage)) {}
+        ~ScopedStage() { finish(); }
+        ScopedStage(const ScopedStage&) = delete;
+        ScopedStage& operator=(const ScopedStage&) = delete;
+
+        void set_items(uint64_t items) { items_ = items; }
+
+        // Leave this operation out of the metrics (e.g. it failed or did no work); traces still show it
+        void cancel() { done_ = true; }
+
+        // Record now rather than at destruction, leaving trailing work out of the timing
+        void finish() {
+            if (!done_) {
+                recorder_.record(stage_, std::chrono::steady_clock::now() - start_, items_);
+                done_ = true;
+            }
+            if (span_.active()) {
+                span_.arg("items", items_);
+                span_.end();
+            }
+        }
+
+    private:
+        PipelineMetricsRecorder& recorder_;
+        PipelineStage stage_;
+        std::chrono::steady_clock::time_point start_;
+        trace::Span span_;
+        uint64_t items_ = 1;
+        bool done_ = false;
+    };
+
+private:
+    std::array<LatencyHistogram, static_cast<size_t>(PipelineStage::COUNT)> stages_;
+};
+
+/**
+ * @brief Process-wide byte counts per MemorySubsystem, with high-water marks and budgets
+ *
+ * Components report their own sizes - there are no tagged allocators - either as deltas
+ * (Reservation, for memory that comes and goes with a work item or thread) or as an absolute
+ * value polled from the component (set, e.g. FaissIndex::get_memory_bytes()). Process-wide
+ * because budgets guard the one process the OS kills, and because thread-local reservations
+ * can outlive any single LeafraCore.
+ *
+ * Example usage:
+ *
+ * MemoryAccountant& memory = MemoryAccountant::instance();
+ * MemoryAccountant::Reservation held(MemorySubsystem::DOCUMENTS);
+ * held.resize(document.memory_bytes());
+ * memory.set(MemorySubsystem::FAISS_INDEX, index.get_memory_bytes());
+ * if (memory.over_budget()) { ... }
+ *
+ * Components that can give memory back also register a reclaimer: reclaim() asks them in
+ * ReclaimPriority order until enough is freed, so caches go long before models do.
+ *
+ * MemoryAccountant::Reclaimer cache_reclaimer("query_caches", MemorySubsystem::QUERY_CACHES, ReclaimPriority::CACHE,
+ *                                             [&] { return cache_bytes(); },
+ *                                             [&](uint64_t bytes) { return evict_oldest(bytes); });
+ * memory.reclaim(memory.excess());
+ */
+class LEAFRA_API MemoryAccountant {
+public:
+    static MemoryAccountant& instance();
+
+    void add(MemorySubsystem subsystem, int64_t delta_bytes);
+    void set(MemorySubsystem subsystem, uint64_t bytes);
+
+    // Raise a subsystem's high-water mark to a peak the component tracked itself (e.g. sqlite3_memory_highwater)
+    void note_peak(MemorySubsystem subsystem, uint64_t bytes);
+
+    uint64_t current(MemorySubsystem subsystem) const;
+    uint64_t peak(MemorySubsystem subsystem) const;
+    uint64_t total() const { return total_.load(std::memory_order_relaxed); }
+    uint64_t total_peak() const { return total_peak_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Set the bytes a subsystem (or with set_total_budget, all of them together) may hold; 0 = no budget
+     */
+    void set_budget(MemorySubsystem subsystem, uint64_t bytes);
+    void set_total_budget(uint64_t bytes) { total_budget_.store(bytes, std::memory_order_relaxed); }
+    uint64_t total_budget() const { return total_budget_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Whether any subsystem, or the total, currently holds more than its budget
+     */
+    bool over_budget() const;
+
+    /**
+     * @brief Bytes held beyond a budget (the total's, or a subsystem's), 0 when within every budget
+     * @param subsystem Subsystem whose budget to check (COUNT = the total budget)
+     */
+    uint64_t excess(MemorySubsystem subsystem = MemorySubsystem::COUNT) const;
+
+    // Bytes a component could free now
+    using ReclaimableFn = std::function<uint64_t()>;
+    // Free about bytes (UINT64_MAX = all it can); returns the bytes freed (0 if freed later, e.g. by other threads)
+    using ReclaimFn = std::function<uint64_t(uint64_t bytes)>;
+
+    /**
+     * @brief Register a component that can give memory back (see Reclaimer for a scoped registration)
+     * @return Id for remove_reclaimer
+     *
+     * The callbacks run on the thread calling reclaim, with the registry locked: they must not
+     * register or remove reclaimers themselves.
+     */
+    uint64_t add_reclaimer(const std::string& name, MemorySubsystem subsystem, ReclaimPriority priority,
+                           ReclaimableFn reclaimable, ReclaimFn reclaim);
+
+    /**
+     * @brief Unregister a reclaimer, waiting for a reclaim that is using it
+     */
+    void remove_reclaimer(uint64_t id);
+
+    /**
+     * @brief Bytes the registered reclaimers could free
+     * @param max_priority Reclaimers above this priority are not counted
+     * @param subsystem Only count reclaimers of this subsystem (COUNT = all)
+     */
+    uint64_t reclaimable(ReclaimPriority max_priority = ReclaimPriority::MODEL,
+                         MemorySubsystem subsystem = MemorySubsystem::COUNT) const;
+
+    /**
+     * @brief Ask reclaimers, lowest priority first, to free memory until bytes are freed
+     * @param bytes Bytes to free (UINT64_MAX = all they can)
+     * @param max_priority Reclaimers above this priority are left alone
+     * @param subsystem Only ask reclaimers of this subsystem (COUNT = all)
+     * @return Bytes freed
+     */
+    uint64_t reclaim(uint64_t bytes, ReclaimPriority max_priority = ReclaimPriority::MODEL,
+                     MemorySubsystem subsystem = MemorySubsystem::COUNT);
+
+    /**
+     * @brief Usage of every subsystem (index = MemorySubsystem)
+     */
+    std::vector<MemoryMetrics> snapshot() const;
+
+    /**
+     * @brief Restart high-water marks from the current usage
+     */
+    void reset_peaks();
+
+    /**
+     * @brief Bytes held on behalf of one owner, returned to the accountant on destruction
+     */
+    class Reservation {
+    public:
+        explicit Reservation(MemorySubsystem subsystem) : subsystem_(subsystem) {}
+        ~Reservation() { resize(0); }
+        Reservation(const Reservation&) = delete;
+        Reservation& operator=(const Reservation&) = delete;
+
+        // Account bytes in place of what was held before
+        void resize(uint64_t bytes) {
+            if (bytes != bytes_) {
+                MemoryAccountant::instance().add(subsystem_, static_cast<int64_t>(bytes) - static_cast<int64_t>(bytes_));
+                bytes_ = bytes;
+            }
+        }
+        uint64_t bytes() const { return bytes_; }
+
+    private:
+        MemorySubsystem subsystem_;
+        uint64_t bytes_ = 0;
+    };
+
+    /**
+     * @brief Reclaimer registration, removed on destruction
+     */
+    class Reclaimer {
+    public:
+        Reclaimer(const std::string& name, MemorySubsystem subsystem, ReclaimPriority priority,
+                  ReclaimableFn reclaimable, ReclaimFn reclaim)
+            : id_(MemoryAccountant::instance().add_reclaimer(name, subsystem, priority, std::move(reclaimable), std::move(reclaim))) {}
+        ~Reclaimer() { MemoryAccountant::instance().remove_reclaimer(id_); }
+        Reclaimer(const Reclaimer&) = delete;
+        Reclaimer& operator=(const Reclaimer&) = delete;
+
+    private:
+        uint64_t id_;
+    };
+
+private:
+    static constexpr size_t kCount = static_cast<size_t>(MemorySubsystem::COUNT);
+
+    struct ReclaimerEntry {
+        uint64_t id;
+        std::string name;
+        MemorySubsystem subsystem;
+        ReclaimPriority priority;
+        ReclaimableFn reclaimable;
+        ReclaimFn reclaim;
+    };
+
+    std::array<std::atomic<uint64_t>, kCount> current_{};
+    std::array<std::atomic<uint64_t>, kCount> peak_{};
+    std::array<std::atomic<uint64_t>, kCount> budget_{};
+    std::atomic<uint64_t> total_{0};
+    std::atomic<uint64_t> total_peak_{0};
+    std::atomic<uint64_t> total_budget_{0};
+
+    mutable std::mutex reclaim_mutex_;      // Guards reclaimers_, held while their callbacks run
+    std::vector<ReclaimerEntry> reclaimers_;    // By priority, then registration order
+    uint64_t next_reclaimer_id_ = 1;
+};
+
+/**
+ * @brief Resident set size of this process, current and high-water
+ * @return false if the platform doesn't report it (both are then 0)
+ */
+LEAFRA_API bool process_resident_memory(uint64_t& resident_bytes, uint64_t& peak_resident_bytes);
+
+} // namespace leafra
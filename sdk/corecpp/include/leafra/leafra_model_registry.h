@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace leafra {
+
+/**
+ * @brief Process-wide, refcounted cache of loaded models shared by every LeafraCore instance
+ *
+ * Entries are held weakly: acquire() returns the instance already loaded under a key while
+ * anyone still holds it, and otherwise loads and registers a new one. The last holder to let
+ * go frees the model, so two cores configured with the same files keep one copy of the
+ * weights and the second one starts without reading them again.
+ *
+ * Only immutable state belongs here (weights, vocabularies). Anything a call mutates
+ * (llama.cpp contexts and KV caches, TensorFlow Lite interpreters) stays with its owner.
+ * Keys must name everything that makes two loads differ: the path plus the load-time options.
+ *
+ * Example usage:
+ *
+ * std::shared_ptr<llama_model> weights = ModelRegistry<llama_model>::instance().acquire(key, [&]() {
+ *     return std::shared_ptr<llama_model>(llama_model_load_from_file(path, params), llama_model_free);
+ * });
+ */
+template <typename T>
+class ModelRegistry {
+public:
+    using Loader = std::function<std::shared_ptr<T>()>;
+
+    static ModelRegistry& instance() {
+        static ModelRegistry registry;
+        return registry;
+    }
+
+    /**
+     * @brief Get the model loaded under key, loading it with load if nobody holds one
+     *
+     * The registry lock is held while loading, so cores starting together load a model once.
+     * @param key Model path plus the load options that change the result
+     * @param load Loads the model; returns nullptr on failure (nothing is registered then)
+     * @param shared Set to true if an already loaded model was returned (optional)
+     * @return The model, or nullptr if load failed
+     */
+    std::shared_ptr<T> acquire(const std::string& key, const Loader& load, bool* shared = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            if (std::shared_ptr<T> existing = it->second.lock()) {
+                if (shared) {
+                    *shared = true;
+                }
+                return existing;
+            }
+        }
+        if (shared) {
+            *shared = false;
+        }
+
+        std::shared_ptr<T> loaded = load();
+        if (!loaded) {
+            return nullptr;
+        }
+        // Drop entries whose model is gone before adding this one
+        for (auto entry = entries_.begin(); entry != entries_.end();) {
+            entry = entry->second.expired() ? entries_.erase(entry) : std::next(entry);
+        }
+        entries_[key] = loaded;
+        return loaded;
+    }
+
+    /**
+     * @brief Number of models currently held by someone
+     */
+    size_t live_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t count = 0;
+        for (const auto& entry : entries_) {
+            count += entry.second.expired() ? 0 : 1;
+        }
+        return count;
+    }
+
+private:
+    ModelRegistry() = default;
+    ModelRegistry(const ModelRegistry&) = delete;
+    ModelRegistry& operator=(const ModelRegistry&) = delete;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::weak_ptr<T>> entries_;
+};
+
+} // namespace leafra
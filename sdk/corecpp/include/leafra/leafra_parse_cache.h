@@ -0,0 +1,69 @@
+#pragma once
+
+#include "types.h"
+#include "leafra_parsing.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace leafra {
+
+/**
+ * @brief On-disk cache of parsed documents, keyed by file content hash and parser cache key
+ *
+ * Re-indexing with new chunking settings or a new embedding model re-reads every file, but
+ * the extracted text only changes when the file or the parser does. Each entry is one file
+ * in the cache directory, so ingestion workers read and write entries concurrently without
+ * touching the database. Entries are written under a temporary name and renamed into place,
+ * so readers never see a partial entry. trim() evicts least recently used entries.
+ *
+ * Example usage:
+ *
+ * ParseCache cache(FileManager::getAbsolutePath(StorageType::AppStorage, "parse_cache"), 512ull << 20);
+ * if (!cache.load(hash, parser.getCacheKey(path), document)) {
+ *     document = parser.parseFile(path);
+ *     cache.store(hash, parser.getCacheKey(path), document);
+ * }
+ */
+class LEAFRA_API ParseCache {
+public:
+    /**
+     * @param directory Cache directory (created on first store)
+     * @param max_bytes Size trim() shrinks the cache to (0 = unlimited)
+     */
+    ParseCache(std::string directory, uint64_t max_bytes);
+
+    /**
+     * @brief Load a cached document; filePath is left for the caller to set
+     * @return false if there is no valid entry for this content and parser
+     */
+    bool load(const std::string& content_hash, const std::string& parser_key, ParsedDocument& document) const;
+
+    /**
+     * @brief Store a successfully parsed document (invalid or streamed documents are ignored)
+     * @return true if the entry was written
+     */
+    bool store(const std::string& content_hash, const std::string& parser_key, const ParsedDocument& document) const;
+
+    /**
+     * @brief Remove least recently used entries until the cache fits max_bytes
+     * @return Number of entries removed
+     */
+    size_t trim() const;
+
+    const std::string& directory() const { return directory_; }
+
+    /**
+     * @brief Binary encoding of a document's type, title, author, metadata and pages
+     */
+    static void serialize(const ParsedDocument& document, std::string& out);
+    static bool deserialize(std::string_view data, ParsedDocument& document);
+
+private:
+    std::string entryPath(const std::string& content_hash, const std::string& parser_key) const;
+
+    std::string directory_;
+    uint64_t max_bytes_;
+};
+
+} // namespace leafra
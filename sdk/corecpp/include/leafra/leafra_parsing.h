@@ -1,14 +1,31 @@
 #pragma once
 
+#include "types.h"
+#include "leafra_threadpool.h"
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace leafra {
 
 // Forward declarations
 struct ParsedDocument;
+class ZipReader;
+
+// Receiver for pages yielded by a streaming parse, in page order. The text is only
+// valid during the call. Return false to stop parsing.
+using PageSink = std::function<bool(size_t pageIndex, std::string_view text)>;
+
+class IFileParsingAdapter;
+
+// Builds an adapter the first time one of its extensions is parsed
+using AdapterFactory = std::function<std::unique_ptr<IFileParsingAdapter>()>;
 
 // Base interface for file parsing adapters
 class IFileParsingAdapter {
@@ -21,11 +38,26 @@ public:
     // Parse the file and return structured data
     virtual ParsedDocument parse(const std::string& filePath) const = 0;
     
+    // Parse the file page by page: each page goes to sink as soon as it's extracted and the
+    // returned document carries only metadata (pages stays empty). The default parses the
+    // whole file first and replays its pages.
+    virtual ParsedDocument parse(const std::string& filePath, const PageSink& sink) const;
+    
     // Get supported file extensions
     virtual std::vector<std::string> getSupportedExtensions() const = 0;
     
     // Get adapter name for logging
     virtual std::string getName() const = 0;
+    
+    // Identifies the text this adapter produces: name, extraction version and any settings that
+    // change page text. Used to key cached parses; bump the version when extraction changes.
+    virtual std::string getCacheKey() const { return getName() + "/1"; }
+    
+    // Apply parsing settings; submit_task lets parse() spread one file's work over workers (default: ignored)
+    virtual void configure(const TaskSubmitFunction& submit_task, const ParsingConfig& config) {
+        (void)submit_task;
+        (void)config;
+    }
 };
 
 // Parsed document structure
@@ -35,17 +67,78 @@ struct ParsedDocument {
     std::string title;
     std::string author;
     std::vector<std::string> pages;  // Text content per page
+    size_t streamedPageCount = 0;    // Pages handed to the sink by a streaming parse (pages stays empty)
     std::unordered_map<std::string, std::string> metadata;
     bool isValid = false;
+    DocumentLimit limit = DocumentLimit::NONE;  // Limit that cut extraction short; pages past it are missing or empty
     std::string errorMessage;
     
     // Helper methods
     std::string getAllText() const;
-    size_t getPageCount() const { return pages.size(); }
+    size_t getPageCount() const { return pages.empty() ? streamedPageCount : pages.size(); }
     bool hasMetadata(const std::string& key) const;
     std::string getMetadata(const std::string& key, const std::string& defaultValue = "") const;
 };
 
+// Name of a limit for logs and events ("max_pages", "page_time", ...)
+const char* documentLimitName(DocumentLimit limit);
+
+// Per-document extraction limits of a ParsingConfig (max_pages, max_text_mb, page_timeout_ms,
+// document_timeout_ms), created when a parse starts. Adapters charge every page as it's extracted
+// and stop once exhausted(); pages over the page or text limit are refused (left out), a page
+// that ran over a time limit is kept but is the last one. PDFium can't be interrupted inside a
+// page, so the time limits take effect between pages. Safe to charge from several workers.
+class ExtractionBudget {
+public:
+    explicit ExtractionBudget(const ParsingConfig& config);
+    
+    // Any limit set
+    bool active() const { return max_pages_ > 0 || max_text_bytes_ > 0 || page_timeout_ms_ > 0 || document_timeout_ms_ > 0; }
+    
+    // Pages worth extracting at all (0 = no limit)
+    size_t maxPages() const { return max_pages_; }
+    
+    // Account for one extracted page that took page_ms; false if it's over the page or text limit
+    bool charge(size_t page_bytes, double page_ms);
+    
+    // A limit was hit (or the document time ran out): extract no further pages
+    bool exhausted();
+    
+    DocumentLimit limit() const { return static_cast<DocumentLimit>(limit_.load(std::memory_order_relaxed)); }
+    
+    // Cap a known page count at maxPages(), recording MAX_PAGES if it was over
+    void capPages(size_t& page_count);
+    
+    // Apply the page and text limits to an already extracted document (e.g. a cached parse),
+    // dropping the pages past them and setting document.limit
+    void apply(ParsedDocument& document);
+
+private:
+    void hit(DocumentLimit limit);
+    
+    size_t max_pages_ = 0;
+    size_t max_text_bytes_ = 0;
+    double page_timeout_ms_ = 0.0;
+    double document_timeout_ms_ = 0.0;
+    std::chrono::steady_clock::time_point start_;
+    std::atomic<size_t> pages_{0};
+    std::atomic<size_t> text_bytes_{0};
+    std::atomic<int32_t> limit_{static_cast<int32_t>(DocumentLimit::NONE)};
+};
+
+// Settings for removeRepeatedLines
+struct RepeatedLineOptions {
+    size_t min_pages = 4;                   // Documents with fewer non-empty pages are left alone
+    double min_ratio = 0.6;                 // A line is boilerplate once it sits at a page edge on this share of pages
+    size_t edge_lines = 3;                  // Non-blank lines looked at from the top and from the bottom of each page
+};
+
+// Strip headers, footers, page numbers and legal lines that repeat across pages. The first and
+// last edge_lines lines of every page are hashed (case, spacing and digits ignored, so "Page 3 of 12"
+// matches "Page 4 of 12") and counted once per page; lines reaching the threshold are removed
+// from every page edge they appear at. Returns the number of bytes removed.
+size_t removeRepeatedLines(std::vector<std::string>& pages, const RepeatedLineOptions& options);
+
 // PDF parsing adapter using PDFium
 class PDFParsingAdapter : public IFileParsingAdapter {
 public:
@@ -54,45 +147,100 @@ public:
     
     bool canHandle(const std::string& extension) const override;
     ParsedDocument parse(const std::string& filePath) const override;
+    ParsedDocument parse(const std::string& filePath, const PageSink& sink) const override;
     std::vector<std::string> getSupportedExtensions() const override;
     std::string getName() const override;
+    std::string getCacheKey() const override;
+    
+    /**
+     * @brief Extract the pages of large PDFs on several document handles at once
+     * 
+     * PDFs of at least config.pdf_parallel_min_pages pages are split into contiguous page
+     * ranges; each range is walked on a document handle of its own by one of submit_task's
+     * workers (the calling thread takes part too). Parses of different files stay serialized.
+     * With config.pdf_strip_boilerplate, repeated headers and footers are removed once all pages
+     * are in (streaming parses then collect the pages before handing them out). The per-document
+     * limits (config.max_pages, max_text_mb, page_timeout_ms, document_timeout_ms) are checked
+     * page by page on every path, so a huge or pathological PDF stops early.
+     */
+    void configure(const TaskSubmitFunction& submit_task, const ParsingConfig& config) override;
 
 private:
     bool initializePDFium();
     void shutdownPDFium();
-    std::string extractTextFromPage(void* page) const;
+    void extractTextFromPage(void* page, std::string& text) const;
     void extractMetadata(void* document, ParsedDocument& result) const;
+    ParsedDocument parseDocument(const std::string& filePath, const PageSink* sink) const;
+    void extractPage(void* document, int index, std::string& text) const;
+    void extractPages(void* document, int first, int last, std::vector<std::string>& pages, ExtractionBudget& budget) const;
+    void extractPagesInParallel(void* document, const std::string& filePath, const void* data, size_t size,
+                                int pageCount, std::vector<std::string>& pages, ExtractionBudget& budget) const;
     
     bool pdfiumInitialized_;
+    TaskSubmitFunction submit_task_;        // Workers for parallel page extraction (empty = sequential)
+    size_t parallel_min_pages_ = 0;         // Smallest page count extracted in parallel (0 = never)
+    size_t max_document_handles_ = 1;       // Page ranges (one document handle each) per parallel parse
+    bool strip_boilerplate_ = false;        // Remove lines repeated across page edges (removeRepeatedLines)
+    RepeatedLineOptions boilerplate_;
+    ParsingConfig limits_;                  // Per-document page, text and time limits (ExtractionBudget)
 };
 
 // Text file parsing adapter
+//
+// Files are memory-mapped and split into synthetic pages of about text_page_bytes, cut
+// at a Markdown heading or paragraph/line break near the target size. The streaming
+// parse hands out views into the mapping, so no text is copied.
 class TextParsingAdapter : public IFileParsingAdapter {
 public:
     bool canHandle(const std::string& extension) const override;
     ParsedDocument parse(const std::string& filePath) const override;
+    ParsedDocument parse(const std::string& filePath, const PageSink& sink) const override;
     std::vector<std::string> getSupportedExtensions() const override;
     std::string getName() const override;
+    std::string getCacheKey() const override;
+    void configure(const TaskSubmitFunction& submit_task, const ParsingConfig& config) override;
+
+private:
+    size_t page_bytes_ = 256 * 1024;        // Synthetic page size (0 = the whole file is one page)
 };
 
-// DOCX parsing adapter (placeholder for future implementation)
+// DOCX parsing adapter
+//
+// word/document.xml is inflated and scanned in fixed-size blocks, so only the current
+// page is held in memory. Pages are cut at explicit page breaks, Word's rendered page
+// breaks and section breaks. Legacy binary .doc files are rejected with an error.
 class DOCXParsingAdapter : public IFileParsingAdapter {
 public:
     bool canHandle(const std::string& extension) const override;
     ParsedDocument parse(const std::string& filePath) const override;
+    ParsedDocument parse(const std::string& filePath, const PageSink& sink) const override;
     std::vector<std::string> getSupportedExtensions() const override;
     std::string getName() const override;
 };
 
-// Excel parsing adapter (placeholder for future implementation)
+// Excel parsing adapter
+//
+// Each .xlsx worksheet is streamed row by row into tab-separated lines and becomes one
+// or more pages of about sheet_page_bytes, cut at row boundaries; only the shared string
+// table is kept whole. CSV files are read in blocks and paged the same way. Legacy
+// binary .xls files are rejected with an error.
 class ExcelParsingAdapter : public IFileParsingAdapter {
 public:
     bool canHandle(const std::string& extension) const override;
     ParsedDocument parse(const std::string& filePath) const override;
+    ParsedDocument parse(const std::string& filePath, const PageSink& sink) const override;
     std::vector<std::string> getSupportedExtensions() const override;
     std::string getName() const override;
+    std::string getCacheKey() const override;
+    void configure(const TaskSubmitFunction& submit_task, const ParsingConfig& config) override;
+
+private:
+    size_t page_bytes_ = 256 * 1024;        // Page size within a sheet (0 = one page per sheet)
 };
 
+// Read docProps/core.xml of an Office Open XML package (title, author, dates) into result
+void readOfficeCoreProperties(ZipReader& zip, ParsedDocument& result);
+
 // Main parsing wrapper class
 class FileParsingWrapper {
 public:
@@ -108,23 +256,53 @@ public:
     // Register a parsing adapter
     void registerAdapter(std::unique_ptr<IFileParsingAdapter> adapter);
     
+    // Register an adapter that is only constructed (and configured) on first use of one of extensions
+    void registerAdapter(std::vector<std::string> extensions, AdapterFactory factory);
+    
     // Parse a file (automatically detects type from extension)
     ParsedDocument parseFile(const std::string& filePath) const;
     
+    // Parse a file page by page into sink (see IFileParsingAdapter::parse)
+    ParsedDocument parseFile(const std::string& filePath, const PageSink& sink) const;
+    
     // Get list of all supported file extensions
     std::vector<std::string> getSupportedExtensions() const;
     
-    // Get adapter for specific file extension
+    // Get adapter for specific file extension, constructing it on first use
     const IFileParsingAdapter* getAdapterForFile(const std::string& filePath) const;
     
     // Check if file type is supported
     bool isFileTypeSupported(const std::string& filePath) const;
+    
+    // Cache key of the adapter that would parse this file (empty if unsupported)
+    std::string getCacheKey(const std::string& filePath) const;
+    
+    // Hand the worker pool and parsing settings to every registered adapter (adapters constructed later get them too)
+    void configure(const TaskSubmitFunction& submit_task, const ParsingConfig& config);
 
 private:
-    std::vector<std::unique_ptr<IFileParsingAdapter>> adapters_;
+    // One registered adapter; adapter is built by factory behind created the first time it's needed
+    struct AdapterSlot {
+        std::vector<std::string> extensions;
+        AdapterFactory factory;
+        std::unique_ptr<IFileParsingAdapter> adapter;
+        std::atomic<IFileParsingAdapter*> ready{nullptr};  // Published once adapter is constructed and configured
+        std::once_flag created;
+    };
+    
+    std::vector<std::unique_ptr<AdapterSlot>> adapters_;
     bool initialized_;
     
+    // Settings replayed onto adapters constructed after configure()
+    mutable std::mutex config_mutex_;
+    bool configured_ = false;
+    TaskSubmitFunction submit_task_;
+    ParsingConfig config_;
+    
     // Helper methods
+    ParsingConfig limits() const;           // Snapshot of config_ for a parse's ExtractionBudget
+    const AdapterSlot* findSlot(const std::string& filePath) const;
+    IFileParsingAdapter* ensureAdapter(const AdapterSlot& slot) const;
     std::string extractFileExtension(const std::string& filePath) const;
     std::string normalizeExtension(const std::string& extension) const;
 };
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "types.h"
+#include "leafra_arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief One hit of a SearchResultSet; the text views point into the set that holds it
+ */
+struct LEAFRA_API SearchHit {
+    int64_t id = -1;                        // Vector ID (FAISS ID)
+    float distance = 0.0f;                  // Distance/similarity score
+    int64_t doc_id = -1;                    // Document ID from database
+    int chunk_index = -1;                   // Chunk index within document
+    int page_number = -1;                   // Page number where chunk appears
+    std::string_view content;               // Chunk text content
+    std::string_view filename;              // Source document filename (shared by every hit of the document)
+    int64_t text_start = -1;                // Byte range of content in the extracted text, pages joined by a blank line (-1 = not stored)
+    int64_t text_end = -1;
+    int64_t page_text_start = -1;           // Where content starts within its page's text
+};
+
+/**
+ * @brief Search results that own their text in one arena
+ *
+ * Chunk text is copied once, from the database into the set's arena, and each document's
+ * filename is stored once however many of its chunks are hits. reset() sizes the arena for
+ * the results about to be added, so building a set is typically one text allocation plus
+ * the hit array, instead of two strings per hit.
+ *
+ * The views stay valid until the set is reset, cleared or destroyed; moving the set keeps
+ * them valid. Not thread-safe.
+ *
+ * Example usage:
+ *
+ * SearchResultSet results;
+ * core->semantic_search(query, 20, results);
+ * for (const SearchHit& hit : results) {
+ *     show(hit.filename, hit.page_number, hit.content);
+ * }
+ */
+class LEAFRA_API SearchResultSet {
+public:
+    SearchResultSet();
+    ~SearchResultSet();
+    SearchResultSet(SearchResultSet&&) noexcept;
+    SearchResultSet& operator=(SearchResultSet&&) noexcept;
+    SearchResultSet(const SearchResultSet&) = delete;
+    SearchResultSet& operator=(const SearchResultSet&) = delete;
+    
+    /**
+     * @brief Drop all hits and text and size the set for the next results
+     * @param hits Expected number of hits
+     * @param text_bytes Expected bytes of chunk text and filenames (the first arena block)
+     */
+    void reset(size_t hits, size_t text_bytes);
+    
+    /**
+     * @brief Drop all hits and text, freeing the arena
+     */
+    void clear();
+    
+    /**
+     * @brief Append a hit (text fields empty until set with store_text / intern_filename)
+     * @return The new hit, valid until the next add
+     */
+    SearchHit& add(int64_t id, float distance);
+    
+    /**
+     * @brief Copy text into the set's arena
+     * @return View of the copy, valid as long as the set's hits
+     */
+    std::string_view store_text(std::string_view text);
+    
+    /**
+     * @brief Filename of a document, stored the first time the document is seen
+     * @param doc_id Document ID
+     * @param filename The document's filename (only copied for a document not seen yet)
+     * @return View of the stored filename
+     */
+    std::string_view intern_filename(int64_t doc_id, std::string_view filename);
+    
+    /**
+     * @brief Drop the hits pred returns true for, keeping the order of the rest
+     */
+    template <typename Pred>
+    void remove_hits_if(Pred pred) {
+        hits_.erase(std::remove_if(hits_.begin(), hits_.end(), pred), hits_.end());
+    }
+    
+    size_t size() const { return hits_.size(); }
+    bool empty() const { return hits_.empty(); }
+    SearchHit& operator[](size_t i) { return hits_[i]; }
+    const SearchHit& operator[](size_t i) const { return hits_[i]; }
+    std::vector<SearchHit>::const_iterator begin() const { return hits_.begin(); }
+    std::vector<SearchHit>::const_iterator end() const { return hits_.end(); }
+    const std::vector<SearchHit>& hits() const { return hits_; }
+    
+    size_t document_count() const { return filenames_.size(); }   // Distinct filenames stored
+    size_t text_bytes() const;                                    // Bytes of text stored
+    size_t memory_bytes() const;                                  // Heap bytes held (arena blocks, hits, filename index)
+    
+private:
+    std::unique_ptr<MonotonicArena> arena_;   // Heap-held, so the views survive a move of the set
+    size_t first_block_bytes_;
+    std::vector<SearchHit> hits_;
+    std::vector<std::pair<int64_t, std::string_view>> filenames_;   // By doc_id; a result set spans a few documents
+};
+
+} // namespace leafra
@@ -9,9 +9,13 @@
 #ifdef __cplusplus
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <utility>
 #include <memory>
 #include <cstdint>
+#include "types.h"
+#include "leafra_threadpool.h"
 
 namespace leafra {
 
@@ -36,12 +40,20 @@ public:
         bool add_bos;              ///< Add beginning-of-sentence token
         bool add_eos;              ///< Add end-of-sentence token
         bool reverse;              ///< Reverse the input sequence
+        bool splice_prefix;        ///< Batches: encode the prefix once and splice its IDs ahead of each text's
+                                   ///< instead of encoding prefix + text (same IDs when the prefix ends at a
+                                   ///< word boundary, e.g. "passage: ")
         
         // Default constructor
         TokenizeOptions() : enable_sampling(false), alpha(0.1f), nbest_size(-1), 
-                           add_bos(true), add_eos(true), reverse(false) {}
+                           add_bos(true), add_eos(true), reverse(false), splice_prefix(false) {}
     };
 
+    /**
+     * @brief Token IDs of many texts in one flat buffer (see TokenIdBatch)
+     */
+    using IdBatch = TokenIdBatch;
+
     /**
      * @brief Training options for creating new models
      */
@@ -90,6 +102,27 @@ public:
      */
     bool load_model(const TokenizerConfig& config);
 
+    /**
+     * @brief Load a SentencePiece model from its serialized bytes (LoadFromSerializedProto)
+     * 
+     * For models bundled into the app binary or mapped by the caller; the bytes are parsed
+     * into the tokenizer and needn't outlive the call.
+     * @param serialized_model Contents of a .model file
+     * @param config Tokenizer configuration (model_path is not read)
+     * @return true if successful, false otherwise
+     */
+    bool load_model_from_memory(std::string_view serialized_model, const TokenizerConfig& config);
+
+    /**
+     * @brief Loaded tokenizer for config, shared by everything in the process that uses the same model
+     * 
+     * Returns the tokenizer already loaded for config's model_path and model_name while anyone
+     * still holds it, otherwise loads a new one. The model is freed when the last holder
+     * releases it, so several LeafraCore instances keep one copy of the vocabulary.
+     * @param config Tokenizer configuration
+     * @return Loaded tokenizer, or nullptr if the model couldn't be loaded
+     */
+    static std::shared_ptr<const SentencePieceTokenizer> acquire_shared(const TokenizerConfig& config);
 
     /**
      * @brief Check if a model is loaded
@@ -105,11 +138,11 @@ public:
 
     /**
      * @brief Tokenize text into pieces (strings)
-     * @param text Input text
+     * @param text Input text (std::string and string literals convert without a copy)
      * @param options Tokenization options
      * @return Vector of token strings
      */
-    std::vector<std::string> encode(const std::string& text, const TokenizeOptions& options = TokenizeOptions()) const;
+    std::vector<std::string> encode(std::string_view text, const TokenizeOptions& options = TokenizeOptions()) const;
 
     /**
      * @brief Tokenize text into IDs
@@ -117,7 +150,54 @@ public:
      * @param options Tokenization options
      * @return Vector of token IDs
      */
-    std::vector<int> encode_as_ids(const std::string& text, const TokenizeOptions& options = TokenizeOptions()) const;
+    std::vector<int> encode_as_ids(std::string_view text, const TokenizeOptions& options = TokenizeOptions()) const;
+
+    /**
+     * @brief Tokenize text into a caller-owned ID buffer
+     * 
+     * Same output as the returning overload, but the buffer's capacity is kept between
+     * calls - use it on hot paths such as query embedding.
+     * 
+     * @param text Input text
+     * @param ids Output token IDs (cleared first)
+     * @param options Tokenization options
+     * @return true on success, false on error (see get_last_error())
+     */
+    bool encode_as_ids(std::string_view text, std::vector<int>& ids, const TokenizeOptions& options = TokenizeOptions()) const;
+
+    /**
+     * @brief Tokenize many texts, each as prefix + text, into one flat ID buffer
+     * 
+     * Texts are split into contiguous blocks that are encoded on submit_task's workers
+     * and the calling thread (SentencePieceProcessor::Encode is const and thread-safe),
+     * then packed in order. Produces the same IDs as encode_as_ids(prefix + text).
+     * With options.splice_prefix the prefix is encoded once and each text is encoded
+     * straight from its view, so reused IdBatch buffers make no per-text allocations.
+     * 
+     * @param texts Texts to encode
+     * @param prefix Prepended to every text (e.g. "passage: "), may be empty
+     * @param out Output sequences, one per text
+     * @param submit_task Worker threads to use (empty = encode on the calling thread)
+     * @param options Tokenization options
+     * @return true on success, false if any text failed (see get_last_error())
+     */
+    bool encode_batch_as_ids(const std::vector<std::string_view>& texts, const std::string& prefix, IdBatch& out,
+                             const TaskSubmitFunction& submit_task = TaskSubmitFunction(),
+                             const TokenizeOptions& options = TokenizeOptions()) const;
+
+    /**
+     * @brief Tokenize text into IDs plus the byte range each piece covers
+     * 
+     * No BOS/EOS is added - used to tokenize a whole document once and cut it into
+     * chunks at exact token counts (see ChunkSizeUnit::EXACT_TOKENS).
+     * 
+     * @param text Input text
+     * @param ids Output token IDs (cleared first)
+     * @param offsets Output [begin, end) byte offsets into text, one per ID
+     * @return true on success, false on error (see get_last_error())
+     */
+    bool encode_with_offsets(std::string_view text, std::vector<int>& ids,
+                             std::vector<std::pair<size_t, size_t>>& offsets) const;
 
     /**
      * @brief Detokenize pieces back to text
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief Vector kernels for embeddings: dot products, norms, distances, conversions and top-k
+ *
+ * Every kernel is compiled for each instruction set the target can have (NEON on ARM,
+ * AVX2+FMA+F16C and AVX-512 F/BW on x86) next to a scalar fallback; the best one the CPU
+ * supports is picked once at first use. Lanes are accumulated separately, so results can
+ * differ from a sequential loop (and between instruction sets) in the last bits.
+ *
+ * Example usage:
+ *
+ * std::vector<float> scores(count);
+ * simd::dot_batch(query.data(), rows.data(), count, dimension, scores.data());
+ * std::vector<uint32_t> best;
+ * simd::top_k(scores.data(), count, 10, true, best);
+ */
+namespace simd {
+
+enum class Isa : int32_t {
+    SCALAR = 0,
+    NEON = 1,
+    AVX2 = 2,                               // AVX2 + FMA + F16C
+    AVX512 = 3                              // AVX-512 F + BW
+};
+
+/**
+ * @brief Best instruction set this CPU (and OS) supports
+ */
+LEAFRA_API Isa detected_isa();
+
+/**
+ * @brief Instruction set the kernels currently dispatch to
+ */
+LEAFRA_API Isa active_isa();
+
+/**
+ * @brief Dispatch to a given instruction set (benchmarks and tests compare them this way)
+ * @return false if the CPU doesn't support it (the active one is left unchanged)
+ */
+LEAFRA_API bool set_active_isa(Isa isa);
+
+LEAFRA_API const char* isa_name(Isa isa);
+
+// ------------------------------------------------------------------------------
+// fp32
+// ------------------------------------------------------------------------------
+
+/**
+ * @brief Dot product of two float vectors (inner product similarity)
+ * @return Sum of a[i] * b[i]
+ */
+LEAFRA_API float dot(const float* a, const float* b, size_t count);
+
+/**
+ * @brief Squared L2 norm of a float vector
+ * @return Sum of squares
+ */
+LEAFRA_API float squared_norm(const float* values, size_t count);
+
+/**
+ * @brief Squared Euclidean distance between two float vectors (what FAISS reports for L2)
+ * @return Sum of (a[i] - b[i])^2
+ */
+LEAFRA_API float squared_l2(const float* a, const float* b, size_t count);
+
+/**
+ * @brief out[i] = values[i] * factor (out may equal values)
+ */
+LEAFRA_API void scale(const float* values, float* out, size_t count, float factor);
+
+/**
+ * @brief Scale a float vector to unit L2 length in place
+ * @return false if the vector is all zeros or not finite (left unchanged)
+ */
+LEAFRA_API bool l2_normalize(float* values, size_t count);
+
+/**
+ * @brief Write the unit-length version of a vector to another buffer (one pass, no staging copy)
+ * @param out Output buffer of count floats (may equal values)
+ * @return false if the vector is all zeros or not finite (copied unchanged)
+ */
+LEAFRA_API bool l2_normalize(const float* values, float* out, size_t count);
+
+/**
+ * @brief Normalize every row of a row-major matrix in place
+ */
+LEAFRA_API void l2_normalize_rows(float* values, size_t rows, size_t dimension);
+
+/**
+ * @brief How token-level model outputs are reduced to one embedding
+ */
+enum class Pooling {
+    MEAN,       // Average of the real (unmasked) tokens
+    CLS,        // First real token (the [CLS] position)
+    MAX         // Element-wise maximum over the real tokens
+};
+
+/**
+ * @brief Pool a last hidden state [tokens, dimension] into one embedding, optionally normalized in the same pass
+ *
+ * Reads the model output in place: masked positions are skipped, not copied out first.
+ *
+ * @param token_states tokens * dimension floats, row-major
+ * @param mask tokens entries, 0 = padding (nullptr = every token is real)
+ * @param normalize Scale the pooled vector to unit L2 length
+ * @param out Output buffer of dimension floats
+ * @return false if no token is real (out zeroed) or the normalized vector is zero / not finite
+ */
+LEAFRA_API bool pool_tokens(const float* token_states, const int32_t* mask, size_t tokens, size_t dimension,
+                            Pooling pooling, bool normalize, float* out);
+
+/**
+ * @brief Dot products of one query against count contiguous rows (row-major, dimension floats each)
+ * @param out count scores
+ */
+LEAFRA_API void dot_batch(const float* query, const float* rows, size_t count, size_t dimension, float* out);
+
+/**
+ * @brief Dot products of one query against count scattered rows
+ * @param rows count pointers to dimension floats each
+ * @param out count scores
+ */
+LEAFRA_API void dot_batch(const float* query, const float* const* rows, size_t count, size_t dimension, float* out);
+
+/**
+ * @brief Squared L2 distances of one query to count contiguous rows
+ */
+LEAFRA_API void squared_l2_batch(const float* query, const float* rows, size_t count, size_t dimension, float* out);
+
+/**
+ * @brief Squared L2 distances of one query to count scattered rows
+ */
+LEAFRA_API void squared_l2_batch(const float* query, const float* const* rows, size_t count, size_t dimension, float* out);
+
+// ------------------------------------------------------------------------------
+// fp16 (IEEE 754 binary16 bit patterns)
+// ------------------------------------------------------------------------------
+
+// Single-value conversion (round to nearest even, subnormals, inf and NaN preserved)
+LEAFRA_API uint16_t float_to_half(float value);
+LEAFRA_API float half_to_float(uint16_t value);
+
+/**
+ * @brief Convert count halves to floats
+ */
+LEAFRA_API void half_to_float(const uint16_t* in, float* out, size_t count);
+
+/**
+ * @brief Convert count floats to halves (round to nearest even)
+ */
+LEAFRA_API void float_to_half(const float* in, uint16_t* out, size_t count);
+
+/**
+ * @brief Dot product of a float vector and a half vector, accumulated in fp32
+ */
+LEAFRA_API float dot_f16(const float* a, const uint16_t* b, size_t count);
+
+/**
+ * @brief Squared L2 norm of a half vector, accumulated in fp32
+ */
+LEAFRA_API float squared_norm_f16(const uint16_t* values, size_t count);
+
+/**
+ * @brief Dot products of one float query against count contiguous half rows
+ */
+LEAFRA_API void dot_batch_f16(const float* query, const uint16_t* rows, size_t count, size_t dimension, float* out);
+
+// ------------------------------------------------------------------------------
+// int8 (symmetric quantization, value = q * scale)
+// ------------------------------------------------------------------------------
+
+/**
+ * @brief Dot product of two int8 vectors, exact in int32 (count up to 2^17)
+ */
+LEAFRA_API int32_t dot_i8(const int8_t* a, const int8_t* b, size_t count);
+
+/**
+ * @brief Dot product of a float vector and an int8 vector (multiply by the row scale afterwards)
+ */
+LEAFRA_API float dot_f32_i8(const float* a, const int8_t* b, size_t count);
+
+/**
+ * @brief Dot products of one float query against count contiguous int8 rows
+ * @param scales Per-row dequantization scale (count floats)
+ */
+LEAFRA_API void dot_batch_i8(const float* query, const int8_t* rows, const float* scales, size_t count, size_t dimension,
+                             float* out);
+
+/**
+ * @brief out[i] = in[i] * scale
+ */
+LEAFRA_API void dequantize_i8(const int8_t* in, float scale, float* out, size_t count);
+
+/**
+ * @brief Largest |values[i]| (0 for an empty vector)
+ */
+LEAFRA_API float max_abs(const float* values, size_t count);
+
+// ------------------------------------------------------------------------------
+// Binary codes
+// ------------------------------------------------------------------------------
+
+/**
+ * @brief Number of bits that differ between two codes of size bytes
+ */
+LEAFRA_API uint32_t hamming(const uint8_t* a, const uint8_t* b, size_t size);
+
+/**
+ * @brief Hamming distances of one code against count contiguous codes of code_size bytes
+ */
+LEAFRA_API void hamming_batch(const uint8_t* query, const uint8_t* codes, size_t count, size_t code_size, uint32_t* out);
+
+// ------------------------------------------------------------------------------
+// Selection
+// ------------------------------------------------------------------------------
+
+/**
+ * @brief Indices of the k best scores, best first; ties go to the lower index (as a stable sort would)
+ * @param largest true keeps the highest scores (similarities), false the lowest (distances)
+ * @param indices Output, min(k, count) indices (reuses its capacity)
+ */
+LEAFRA_API void top_k(const float* scores, size_t count, size_t k, bool largest, std::vector<uint32_t>& indices);
+
+/**
+ * @brief Index of the first highest value (count for an empty vector)
+ */
+LEAFRA_API size_t argmax(const float* values, size_t count);
+
+} // namespace simd
+
+} // namespace leafra
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief 64-bit SimHash fingerprints of chunk text, for near-duplicate detection
+ *
+ * Text is split into words (ASCII letters and digits, case folded; any non-ASCII byte counts as
+ * a letter), consecutive words form shingles, and every shingle votes on each of the 64 bits.
+ * Chunks that share most of their shingles end up a few bits apart.
+ */
+class LEAFRA_API SimHash {
+public:
+    /**
+     * @brief Fingerprint of text
+     * @param shingle_words Words per shingle (texts with fewer words form a single shingle)
+     * @return The fingerprint, 0 if the text has no words
+     */
+    static uint64_t fingerprint(std::string_view text, size_t shingle_words = 3);
+
+    /**
+     * @brief Number of differing bits
+     */
+    static int32_t distance(uint64_t a, uint64_t b);
+};
+
+/**
+ * @brief In-memory LSH table of SimHash fingerprints
+ *
+ * The 64 bits are cut into max_distance + 1 bands; two fingerprints at most max_distance bits
+ * apart agree on at least one whole band, so a lookup only compares the entries that share a
+ * band with the query. Entries take 16 bytes plus one bucket slot per band.
+ *
+ * Example usage:
+ *
+ * NearDuplicateIndex index(3);
+ * index.add(SimHash::fingerprint(stored_text), stored_id);
+ * std::vector<NearDuplicateIndex::Match> matches;
+ * index.find(SimHash::fingerprint(new_text), matches);
+ */
+class LEAFRA_API NearDuplicateIndex {
+public:
+    struct Match {
+        int64_t id;
+        int32_t distance;
+    };
+
+    explicit NearDuplicateIndex(int32_t max_distance = 3);
+
+    /**
+     * @brief Record a fingerprint (0 is ignored)
+     */
+    void add(uint64_t fingerprint, int64_t id);
+
+    /**
+     * @brief Entries within max_distance bits of fingerprint, nearest first (ties: earliest added)
+     * @param matches Output (reuses its capacity)
+     * @param max_results Most matches returned
+     */
+    void find(uint64_t fingerprint, std::vector<Match>& matches, size_t max_results = 4) const;
+
+    size_t size() const { return entries_.size(); }
+    int32_t max_distance() const { return max_distance_; }
+    size_t memory_bytes() const;
+    void clear();
+
+private:
+    struct Entry {
+        uint64_t fingerprint;
+        int64_t id;
+    };
+    struct Band {
+        uint32_t shift;
+        uint64_t mask;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> buckets;  // band value -> entry indices
+    };
+
+    int32_t max_distance_;
+    std::vector<Entry> entries_;
+    std::vector<Band> bands_;
+    mutable std::vector<uint32_t> candidates_;  // find() scratch
+};
+
+} // namespace leafra
@@ -14,6 +14,15 @@
 #include <memory>
 #include <functional>
 #include <cstdint>
+#include <string_view>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <thread>
+#include "types.h"
+#include "leafra_trace.h"
 
 // Include SQLite headers based on configuration
 #ifdef LEAFRA_USE_SYSTEM_SQLITE_HEADERS
@@ -31,10 +40,12 @@ namespace leafra {
     // Use system SQLite types directly
     using sqlite3 = ::sqlite3;
     using sqlite3_stmt = ::sqlite3_stmt;
+    using sqlite3_blob = ::sqlite3_blob;
 #else
     // Forward declarations for custom SQLite (Android/Windows)
     struct sqlite3;
     struct sqlite3_stmt;
+    struct sqlite3_blob;
 #endif
 
 /**
@@ -42,6 +53,12 @@ namespace leafra {
  * 
  * Provides a C++ interface for SQLite database operations with
  * automatic resource management and error handling.
+ * 
+ * Every connection registers leafra_chunk_text() (see createDocTextTable) and the vector
+ * functions vec_dot, vec_l2 (squared) and vec_cosine. Each takes two native fp32 BLOBs, or a
+ * chunk_embeddings row and a native fp32 query (embedding, format, byte_order, scale, query),
+ * and is NULL when the dimensions differ, e.g.
+ * SELECT chunk_faiss_id FROM chunk_embeddings ORDER BY vec_dot(embedding, format, byte_order, scale, ?) DESC LIMIT 10
  */
 class SQLiteDatabase {
 public:
@@ -146,6 +163,16 @@ public:
         Null = 5
     };
 
+    /**
+     * @brief Non-owning view of a BLOB column (valid until the statement is stepped, reset or finalized)
+     */
+    struct BlobView {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        
+        bool empty() const { return size == 0; }
+    };
+
     /**
      * @brief Query result row
      */
@@ -162,6 +189,11 @@ public:
         bool isNull(int columnIndex) const;
         ColumnType getColumnType(int columnIndex) const;
         
+        // Zero-copy column access - the memory belongs to SQLite and is only valid until the
+        // next step()/reset() of the statement. Copy what must outlive the row.
+        std::string_view getTextView(int columnIndex) const;
+        BlobView getBlobView(int columnIndex) const;
+        
         // Column access by name
         int getInt(const std::string& columnName) const;
         long long getInt64(const std::string& columnName) const;
@@ -202,6 +234,15 @@ public:
         bool bindBlob(int paramIndex, const std::vector<uint8_t>& value);
         bool bindNull(int paramIndex);
         
+        // Zero-copy binding (SQLITE_STATIC): the memory must stay valid until the statement
+        // is stepped and reset, or the parameter is rebound
+        bool bindTextView(int paramIndex, std::string_view value);
+        bool bindBlobView(int paramIndex, const void* data, size_t size);
+        bool clearBindings();
+        
+        // A BLOB of size zero bytes, reserved to be filled in place through openBlob()
+        bool bindZeroBlob(int paramIndex, size_t size);
+        
         // Named parameter binding
         bool bindInt(const std::string& paramName, int value);
         bool bindInt64(const std::string& paramName, long long value);
@@ -216,6 +257,16 @@ public:
         bool reset();
         Row getCurrentRow() const;
         
+        /**
+         * @brief Step through all remaining rows, calling visitor for each one
+         * 
+         * A single Row is reused for every step, so views taken from it are only valid
+         * inside the visitor call. Return false from the visitor to stop early.
+         * 
+         * @return false if stepping failed with an SQLite error
+         */
+        bool forEachRow(const std::function<bool(const Row&)>& visitor);
+        
         // Metadata
         int getParameterCount() const;
         int getParameterIndex(const std::string& paramName) const;
@@ -226,6 +277,173 @@ public:
         bool valid_;
     };
 
+    /**
+     * @brief Incremental I/O on one BLOB value (sqlite3_blob)
+     * 
+     * Reads and writes go straight to the database pages, so a large value can be streamed
+     * without ever being held in memory whole. The size is fixed when the row is written
+     * (reserve it with bindZeroBlob). If the row is changed by another statement the handle
+     * expires and every later read or write fails.
+     */
+    class BlobHandle {
+    public:
+        explicit BlobHandle(sqlite3_blob* blob);
+        ~BlobHandle();
+        
+        // Non-copyable but movable
+        BlobHandle(const BlobHandle&) = delete;
+        BlobHandle& operator=(const BlobHandle&) = delete;
+        BlobHandle(BlobHandle&& other) noexcept;
+        BlobHandle& operator=(BlobHandle&& other) noexcept;
+        
+        size_t size() const;
+        
+        // Copy size bytes at offset; false on an SQLite error or a range past the end
+        bool read(void* data, size_t size, size_t offset);
+        bool write(const void* data, size_t size, size_t offset);
+        
+        bool isValid() const { return blob_ != nullptr; }
+        
+    private:
+        sqlite3_blob* blob_;
+    };
+
+private:
+    struct StatementCache;
+
+public:
+    /**
+     * @brief Scoped lease on a prepared statement from the database's statement cache
+     * 
+     * Obtained from prepareCached(). When the lease goes away the statement is reset, its
+     * bindings cleared and it goes back to the cache for the next caller with the same SQL.
+     * Leases are safe to outlive close() (the statement is then simply finalized), but
+     * should not be held across threads.
+     */
+    class CachedStatement {
+    public:
+        CachedStatement() = default;
+        ~CachedStatement();
+        
+        // Non-copyable but movable
+        CachedStatement(const CachedStatement&) = delete;
+        CachedStatement& operator=(const CachedStatement&) = delete;
+        CachedStatement(CachedStatement&& other) noexcept;
+        CachedStatement& operator=(CachedStatement&& other) noexcept;
+        
+        Statement* operator->() const { return stmt_.get(); }
+        Statement& operator*() const { return *stmt_; }
+        Statement* get() const { return stmt_.get(); }
+        explicit operator bool() const { return stmt_ != nullptr; }
+        bool isValid() const { return stmt_ && stmt_->isValid(); }
+        
+    private:
+        friend class SQLiteDatabase;
+        CachedStatement(std::shared_ptr<StatementCache> cache, std::string sql, std::unique_ptr<Statement> stmt,
+                        uint64_t connection);
+        void release();
+        
+        std::weak_ptr<StatementCache> cache_;
+        std::string sql_;
+        std::unique_ptr<Statement> stmt_;
+        uint64_t connection_ = 0;      // Connection the statement was prepared on (stale after close/reopen)
+    };
+
+    /**
+     * @brief Statement cache counters (for profiling)
+     */
+    struct StatementCacheStats {
+        uint64_t hits = 0;             // prepareCached() calls served from the cache
+        uint64_t misses = 0;           // prepareCached() calls that had to prepare
+        uint64_t evictions = 0;        // Idle statements finalized to stay within capacity
+        size_t entries = 0;            // Idle statements currently cached
+        size_t capacity = 0;           // Maximum idle statements
+    };
+    
+    /**
+     * @brief How much of the database file is unused (see getSpaceStats)
+     */
+    struct SpaceStats {
+        int64_t page_size = 0;         // Bytes per page
+        int64_t page_count = 0;        // Pages in the file
+        int64_t freelist_count = 0;    // Unused pages, reclaimable by incrementalVacuum() in INCREMENTAL mode
+        int32_t auto_vacuum = 0;       // 0 = NONE, 1 = FULL, 2 = INCREMENTAL
+    };
+
+    /**
+     * @brief Multi-row INSERT batching with zero-copy parameter binding
+     * 
+     * Rows are bound into a prepared "INSERT ... VALUES (...), (...), ..." statement and
+     * executed once the statement is full; flush() writes the remainder. Text and blob
+     * views are bound with SQLITE_STATIC, so the caller's data must stay valid until
+     * flush() returns. No transaction is opened - run it inside an SQLiteTransaction.
+     * 
+     * Example usage:
+     * 
+     * SQLiteDatabase::BulkInsert insert(db, "chunks", {"doc_id", "chunk_no", "chunk_text"});
+     * for (const auto& chunk : chunks) {
+     *     insert.bindInt64(0, doc_id);
+     *     insert.bindInt64(1, chunk_no++);
+     *     insert.bindTextView(2, chunk.content);
+     *     if (!insert.endRow()) { ... }
+     * }
+     * if (!insert.flush()) { ... }
+     */
+    class BulkInsert {
+    public:
+        /**
+         * @param db Open database
+         * @param table Target table
+         * @param columns Columns bound for every row (binding indices refer to this order)
+         * @param max_rows_per_statement Upper bound on rows per INSERT (also capped by the SQLite variable limit)
+         */
+        BulkInsert(SQLiteDatabase& db, const std::string& table, const std::vector<std::string>& columns,
+                   size_t max_rows_per_statement = 64);
+        
+        // Bind a column of the current row
+        bool bindInt64(size_t column, long long value);
+        bool bindDouble(size_t column, double value);
+        bool bindTextView(size_t column, std::string_view value);
+        bool bindBlobView(size_t column, const void* data, size_t size);
+        bool bindNull(size_t column);
+        
+        /**
+         * @brief Finish the current row, executing the batch when the statement is full
+         * @return false if the batch insert failed
+         */
+        bool endRow();
+        
+        /**
+         * @brief Execute any rows not yet written
+         * @return false if the insert failed
+         */
+        bool flush();
+        
+        size_t getRowsInserted() const { return rows_inserted_; }
+        
+    private:
+        // One bound value; text and blob values point at caller memory
+        struct Value {
+            ColumnType type = ColumnType::Null;
+            long long int_value = 0;
+            double double_value = 0.0;
+            const void* data = nullptr;
+            size_t size = 0;
+        };
+        
+        Value* currentValue(size_t column);
+        bool executeBatch(size_t rows);
+        
+        SQLiteDatabase& db_;
+        std::string table_;
+        std::vector<std::string> columns_;
+        size_t rows_per_statement_;
+        CachedStatement full_statement_;               // rows_per_statement_ rows, leased on first use
+        std::vector<Value> values_;                    // Row-major values of the rows not yet written
+        size_t pending_rows_ = 0;
+        size_t rows_inserted_ = 0;
+    };
+
 public:
     SQLiteDatabase();
     ~SQLiteDatabase();
@@ -299,10 +517,28 @@ public:
      * @see createdb() for creating new databases with RAG schema
      */
     bool open(const std::string& relative_path, int flags = static_cast<int>(OpenFlags::ReadWrite) | static_cast<int>(OpenFlags::Create));
+    
+    /**
+     * @brief Open a database file the host app picked (bundles, backups) at an absolute path
+     * 
+     * Same as open() without the AppStorage resolution and relative-path checks.
+     * 
+     * @param absolute_path Database file path
+     * @param flags SQLite open flags (default: ReadOnly)
+     * @return true if the database was opened
+     */
+    bool openFile(const std::string& absolute_path, int flags = static_cast<int>(OpenFlags::ReadOnly));
     bool openMemory();
     void close();
     bool isOpen() const;
     
+    /**
+     * @brief Set the connection profile applied by the next open() (journal mode, synchronous,
+     *        cache/mmap sizes, temp store, page size, busy timeout)
+     */
+    void setConfig(const DatabaseConfig& config);
+    const DatabaseConfig& getConfig() const;
+    
     // SQL execution
     bool execute(const std::string& sql);
     bool execute(const std::string& sql, const std::function<bool(const Row&)>& rowCallback);
@@ -310,6 +546,30 @@ public:
     // Prepared statements
     std::unique_ptr<Statement> prepare(const std::string& sql);
     
+    /**
+     * @brief Lease a prepared statement for sql from the LRU statement cache
+     * 
+     * Reuses an idle statement with identical SQL text when one is cached (already reset,
+     * bindings cleared), otherwise prepares a new one. Use for SQL that runs repeatedly;
+     * one-off statements should keep using prepare().
+     * 
+     * @param sql SQL text (the cache key)
+     * @return Lease; check isValid() before use
+     */
+    CachedStatement prepareCached(const std::string& sql);
+    
+    /**
+     * @brief Open one BLOB value of the main database for incremental I/O
+     * @param table Table name
+     * @param column BLOB column
+     * @param rowid Row of the value
+     * @param writable Open for writing (the connection must be writable)
+     * @return Handle, or nullptr if the row doesn't exist or the value isn't a BLOB
+     */
+    std::unique_ptr<BlobHandle> openBlob(const std::string& table, const std::string& column, int64_t rowid, bool writable);
+    StatementCacheStats getStatementCacheStats() const;
+    void clearStatementCache();
+    
     // Transaction management
     bool beginTransaction();
     bool commitTransaction();
@@ -321,6 +581,7 @@ public:
     int getChanges() const;
     int getTotalChanges() const;
     std::string getVersion() const;
+    std::string getPath() const;    // File of the main database ("" if closed or in memory)
     
     // Error handling
     int getLastErrorCode() const;
@@ -330,6 +591,78 @@ public:
     static std::string escapeString(const std::string& str);
     static bool fileExists(const std::string& path);
     
+    /**
+     * @brief Page counts of the main database (PRAGMA page_count, freelist_count, auto_vacuum)
+     * @return false if a pragma fails
+     */
+    bool getSpaceStats(SpaceStats& stats);
+    
+    /**
+     * @brief Return up to pages free pages to the file system (PRAGMA incremental_vacuum)
+     * 
+     * Only shrinks databases in auto_vacuum = INCREMENTAL mode; each call is one short write
+     * transaction, so large freelists are best released in slices.
+     * 
+     * @param pages Pages to release (<= 0 = the whole freelist)
+     * @return Pages released, or -1 on error
+     */
+    int64_t incrementalVacuum(int64_t pages);
+    
+    // Process-wide SQLite heap usage (all connections) and its high-water mark, optionally restarted from now
+    static void getMemoryUsage(int64_t& used_bytes, int64_t& highwater_bytes, bool reset_highwater = false);
+    
+    // Heap held by this connection's page cache (SQLITE_DBSTATUS_CACHE_USED), 0 if closed
+    int64_t getCacheMemoryUsage() const;
+    
+    /**
+     * @brief Free the page cache memory this connection isn't using (sqlite3_db_release_memory)
+     * @return Page cache bytes freed
+     * 
+     * Pages are read back from the file on demand, so this costs the next queries some I/O only.
+     */
+    int64_t releaseCacheMemory();
+    
+    /**
+     * @brief Write a compacted, transactionally consistent copy of the database (VACUUM INTO)
+     * 
+     * Runs in a read transaction, so in WAL mode writers on other connections carry on meanwhile.
+     * Can't be called inside a transaction.
+     * 
+     * @param absolute_path Destination file (must not exist yet)
+     * @return true if the copy was written
+     */
+    bool vacuumInto(const std::string& absolute_path);
+    
+    /**
+     * @brief Replace this database's contents with another database file's (online backup API)
+     * 
+     * All pages are copied in one backup step, so other users of this connection wait for the
+     * copy and never see a half-restored database. The source is only read. In WAL mode both
+     * databases need the same page size.
+     * 
+     * @param absolute_path Source database file
+     * @return true if the contents were replaced (false leaves them unchanged)
+     */
+    bool restoreFrom(const std::string& absolute_path);
+    
+    /**
+     * @brief Copy the database to a file while it stays in use (online backup API, in page batches)
+     * 
+     * Copies pages_per_step pages per backup step and sleeps pause_ms between steps, so the
+     * connection is only held for short stretches and other users carry on meanwhile. Steps wait
+     * until no transaction is open, and changes committed through this connection are carried
+     * into the copy as it runs, so the result is the database as of the last step. A write from
+     * another connection restarts the copy. Pages go to "<path>.tmp", renamed into place at the end.
+     * 
+     * @param absolute_path Destination file (replaced once the copy is complete)
+     * @param pages_per_step Pages per step (<= 0 copies everything in one step)
+     * @param pause_ms Sleep between steps (0 = just yield the connection)
+     * @param progress Called after every step with (remaining, total) pages; return false to cancel
+     * @return true if the copy was completed
+     */
+    bool backupTo(const std::string& absolute_path, int pages_per_step, int pause_ms,
+                  const std::function<bool(int remaining, int total)>& progress = nullptr);
+    
          /**
       * @brief Creates a new SQLite database with RAG (Retrieval-Augmented Generation) schema
       * 
@@ -351,8 +684,10 @@ public:
       * 
       * @details
       * **Created Tables:**
-      * - `docs`: Document metadata (id, filename, url, creation_date, size)
-      * - `chunks`: Text chunks with embeddings (id, doc_id, chunk_no, chunk_size, chunk_text, chunk_embedding)
+      * - `docs`: Document metadata (id, filename, url, creation_date, size, file_size, file_mtime, content_hash)
+      * - `chunks`: Text chunks (id, doc_id, chunk_no, chunk_size, chunk_text, chunk_hash)
+      * - `chunk_embeddings`: Encoded chunk embeddings keyed by chunk_faiss_id (format, byte_order, dimension, scale, embedding)
+      * - `id_sequences`: Monotonic id counters (name, next_id), seeded with the `chunk_faiss_id` sequence
       * - Includes foreign key constraints and performance indexes
       * 
       * **Security Features:**
@@ -387,18 +722,282 @@ public:
       * @see LeafraFileManager::getFullPath() for path conversion details
       * @see StorageType::AppStorage for storage location information
       */
-     static bool createdb(const std::string& relative_path);
+     static bool createdb(const std::string& relative_path, const DatabaseConfig& config = DatabaseConfig());
+    
+    /**
+     * @brief Add a column to an existing table unless it's already there
+     * 
+     * Used to upgrade databases created by older schema versions in place.
+     * 
+     * @param table Table name
+     * @param column Column name
+     * @param definition Column type and constraints (e.g. "TEXT", "INTEGER NOT NULL DEFAULT 0")
+     * @return true if the column exists afterwards
+     */
+    bool addColumnIfMissing(const std::string& table, const std::string& column, const std::string& definition);
+    
+    /**
+     * @brief Create the FTS5 keyword index over chunks.chunk_text if it doesn't exist yet
+     * 
+     * chunks_fts is an external-content FTS5 table (no second copy of the text) kept in
+     * sync by insert/update/delete triggers on chunks. When it's added to a database that
+     * already holds chunks, it's rebuilt from them. createdb() calls this; call it after
+     * open() to upgrade databases created before the keyword index existed.
+     * 
+     * @return true if the index is available, false if SQLite was built without FTS5
+     */
+    bool createChunkKeywordIndex();
+    
+    /**
+     * @brief Create the doc_texts table and the chunks.chunk_start / chunk_end columns if missing
+     * 
+     * Documents ingested with database.chunk_text_storage = "offsets" keep their text once,
+     * split into doc_texts pages (TEXT, or TextCodec blobs), and their chunks store an empty
+     * chunk_text plus the [chunk_start, chunk_end) byte range. leafra_chunk_text(chunk_text,
+     * doc_id, chunk_start, chunk_end) resolves either kind of row to its text. Pages are
+     * removed by a trigger when their document is deleted. createdb() calls this; call it
+     * after open() and before createChunkKeywordIndex() to upgrade older databases.
+     * 
+     * @return true if the table is available
+     */
+    bool createDocTextTable();
+    
+    /**
+     * @brief Create the doc_centroids table if it doesn't exist yet
+     * 
+     * One row per document: the mean of its chunk embeddings (VectorCodec encoding, same
+     * columns as chunk_embeddings) and how many chunks went into it, for the document-level
+     * index of hierarchical search. Rows are removed by a trigger when their document is
+     * deleted. createdb() calls this; call it after open() to upgrade older databases.
+     * 
+     * @return true if the table is available
+     */
+    bool createDocCentroidsTable();
+    
+    /**
+     * @brief Create the chunk_embeddings table if it doesn't exist yet
+     * 
+     * Embeddings live apart from chunk text so text-only queries never page vector bytes
+     * in. Rows are keyed by chunk_faiss_id and removed by a trigger when their chunk is
+     * deleted. On databases that still carry inline fp32 chunks.chunk_embedding blobs,
+     * those are moved into the new table once (tagged with the host byte order they
+     * were written in). createdb() calls this; call it after open() to upgrade older databases.
+     * 
+     * @return true if the table is available
+     */
+    bool createChunkEmbeddingsTable();
+    
+    /**
+     * @brief Create the chunk_llm_tokens table if it doesn't exist yet
+     * 
+     * Rows hold a chunk's text as the LLM tokenizes it (TextCodec::encode_tokens), so RAG
+     * prompts can be assembled without tokenizing retrieved chunks again. The vocab column
+     * names the tokenizer the ids belong to; rows of another vocabulary are ignored. Rows are
+     * keyed by chunk_faiss_id and removed by a trigger when their chunk is deleted.
+     * createdb() calls this; call it after open() to upgrade older databases.
+     * 
+     * @return true if the table is available
+     */
+    bool createChunkLLMTokensTable();
+    
+    /**
+     * @brief Create the chunk_retrievals table if it doesn't exist yet
+     * 
+     * Rows count how often each chunk came back from a search, so the startup warm-up can
+     * read the most retrieved chunks before the first query asks for them. Rows are keyed
+     * by chunk_faiss_id and removed by a trigger when their chunk is deleted.
+     * createdb() calls this; call it after open() to upgrade older databases.
+     * 
+     * @return true if the table is available
+     */
+    bool createChunkRetrievalsTable();
+    
+    /**
+     * @brief Create the ingestion_queue table if it doesn't exist yet
+     * 
+     * Rows are the files of ingestion runs that haven't finished, keyed by (file_path,
+     * collection): 'pending' from the start of the run, 'done' once the file's document
+     * commits (in the same transaction) and 'failed' with the stage it failed in and an
+     * attempt count. A run removes its finished rows when it ends, so rows left 'pending'
+     * are work an interrupted run didn't get to. createdb() calls this; call it after
+     * open() to upgrade older databases.
+     * 
+     * @return true if the table is available
+     */
+    bool createIngestionQueueTable();
+    
+    /**
+     * @brief Create the embedding_cache table if it doesn't exist yet
+     * 
+     * Rows map a key (model, prefix and chunk text digest) to an encoded embedding and the
+     * time it was last used, which orders eviction. The cache is independent of documents,
+     * so deleting or re-ingesting a document keeps its embeddings available.
+     * 
+     * @return true if the table is available
+     */
+    bool createEmbeddingCacheTable();
+    
+    /**
+     * @brief Create the index_models table if it doesn't exist yet
+     * 
+     * One row per FAISS index definition: the embedding model its vectors came from, their
+     * dimension and a version bumped whenever the index is re-embedded with another model, so
+     * an index is never searched with query embeddings of a different model. createdb() calls
+     * this; call it after open() to upgrade older databases.
+     * 
+     * @return true if the table is available
+     */
+    bool createIndexModelsTable();
+    
+    /**
+     * @brief Create the chunk_embeddings_shadow table if it doesn't exist yet
+     * 
+     * Same columns as chunk_embeddings: the embeddings of a re-index with another model, written
+     * while the live embeddings keep serving searches and moved over when the new index is
+     * swapped in. Rows are removed by a trigger when their chunk is deleted.
+     * 
+     * @return true if the table is available
+     */
+    bool createShadowEmbeddingsTable();
+    
+    /**
+     * @brief Drop chunk_embeddings_shadow and its delete trigger (no-op if there is none)
+     */
+    bool dropShadowEmbeddingsTable();
+    
+    /**
+     * @brief Create the id_sequences table and its chunk_faiss_id sequence if missing
+     * 
+     * chunk_faiss_id values are allocated densely from this sequence and used directly as
+     * FAISS labels. On databases with chunks already stored, the sequence starts after the
+     * largest existing id. createdb() calls this; call it after open() to upgrade older databases.
+     * 
+     * @return true if the sequence is available
+     */
+    bool createChunkIdSequence();
+    
+    /**
+     * @brief Reserve a block of consecutive ids from a named sequence
+     * 
+     * Ids are never handed out twice. When called inside an open transaction, rolling it
+     * back also returns the block.
+     * 
+     * @param sequence Sequence name (e.g. "chunk_faiss_id")
+     * @param count Number of ids to reserve (must be positive)
+     * @param first_id Receives the first id of the block [first_id, first_id + count)
+     * @return true if the ids were reserved
+     */
+    bool allocateIds(const std::string& sequence, int64_t count, int64_t& first_id);
+    
+    /**
+     * @brief Create the sync_log table and its triggers on docs if missing
+     * 
+     * Every document inserted or deleted appends a row (doc_id, url, collection, removed), so
+     * seq is a generation number for the corpus: LeafraCore::export_delta collects what was
+     * added and removed after a given seq. On databases with documents already stored, those
+     * are logged as added once when the table is created. createdb() calls this; call it
+     * after open() to upgrade older databases.
+     * 
+     * @return true if the log is available
+     */
+    bool createSyncLogTable();
     
 private:
     sqlite3* db_;
     bool isOpen_;
+    DatabaseConfig config_;
+    std::shared_ptr<StatementCache> statement_cache_;
     
     void cleanup();
     bool createRAGTables();
+    void applyConnectionProfile();
+};
+
+/**
+ * @brief Read-only connections to one database, borrowed by concurrent readers
+ * 
+ * Every connection has its own prepared-statement cache. In WAL mode they read the last
+ * committed state without waiting for the writer's transactions, so readers on different
+ * threads run in parallel instead of queueing on the writer connection.
+ * 
+ * Example usage:
+ * 
+ * pool.open(database.getPath(), config, 2);
+ * SQLiteReadPool::Lease reader = pool.acquire(&database);   // Falls back to database when the pool is empty
+ * auto stmt = reader->prepareCached("SELECT ...");
+ */
+class SQLiteReadPool {
+public:
+    /**
+     * @brief A borrowed connection, returned to the pool when the lease goes away
+     */
+    class Lease {
+    public:
+        Lease() = default;
+        ~Lease();
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        
+        SQLiteDatabase* operator->() const { return db_; }
+        SQLiteDatabase& operator*() const { return *db_; }
+        explicit operator bool() const { return db_ != nullptr; }
+        bool isPooled() const { return pool_ != nullptr; }
+        
+    private:
+        friend class SQLiteReadPool;
+        Lease(SQLiteReadPool* pool, SQLiteDatabase* db);
+        void release();
+        
+        SQLiteReadPool* pool_ = nullptr;   // nullptr for the fallback connection, which isn't returned
+        SQLiteDatabase* db_ = nullptr;
+    };
+    
+    SQLiteReadPool() = default;
+    ~SQLiteReadPool();
+    SQLiteReadPool(const SQLiteReadPool&) = delete;
+    SQLiteReadPool& operator=(const SQLiteReadPool&) = delete;
+    
+    /**
+     * @brief Open read-only connections to a database file (closes any open ones first)
+     * @param config Connection profile (settings that only the writer can apply are skipped)
+     * @return false if one failed to open (the pool is then left empty)
+     */
+    bool open(const std::string& absolute_path, const DatabaseConfig& config, size_t connections);
+    
+    /**
+     * @brief Wait for every lease to come back, then close the connections
+     */
+    void close();
+    
+    size_t size() const;
+    
+    // Page cache memory of the idle connections, and releasing it (see SQLiteDatabase::releaseCacheMemory)
+    int64_t getCacheMemoryUsage() const;
+    int64_t releaseCacheMemory();
+    
+    /**
+     * @brief Borrow an idle connection, waiting for one if all are leased
+     * @param fallback Connection to hand out when the pool has none open
+     */
+    Lease acquire(SQLiteDatabase* fallback);
+    
+private:
+    void release(SQLiteDatabase* db);
+    
+    std::vector<std::unique_ptr<SQLiteDatabase>> connections_;
+    std::vector<SQLiteDatabase*> idle_;
+    mutable std::mutex mutex_;
+    std::condition_variable returned_;
 };
 
 /**
  * @brief RAII transaction helper
+ * 
+ * Opened while the connection is already in a transaction, it becomes a savepoint of
+ * that transaction: commit() releases it into the outer transaction and rollback() undoes
+ * only what was done since it was opened.
  */
 class SQLiteTransaction {
 public:
@@ -419,6 +1018,101 @@ private:
     SQLiteDatabase& db_;
     bool committed_;
     bool active_;
+    std::string savepoint_;  // Savepoint name when nested in an outer transaction, else empty
+    trace::Span span_;  // BEGIN to COMMIT / ROLLBACK
+};
+
+/**
+ * @brief Dedicated writer thread that commits queued writes in groups
+ * 
+ * Every submitted job runs on the writer thread in its own savepoint of a shared
+ * transaction, so a failing job only rolls back itself. The transaction commits once
+ * max_jobs have run, max_delay_ms after its first job, or when flush() asks; one commit
+ * (one fsync) then covers the whole group. A job's future and its committed callback report
+ * whether it is durable: the job succeeded and its group committed.
+ * 
+ * The writer holds connection_mutex() while it runs jobs and commits. Other threads that
+ * use the same connection while the writer exists must hold it too.
+ * 
+ * Example usage:
+ * 
+ * SQLiteWriter writer(database, 16, 250, 32);
+ * std::future<bool> durable = writer.submit([&](SQLiteDatabase& db) { return insertDocument(db); });
+ * ...
+ * writer.flush();   // Everything submitted so far is committed
+ */
+class SQLiteWriter {
+public:
+    using Job = std::function<bool(SQLiteDatabase& db)>;
+    using Committed = std::function<void(bool durable)>;   // Runs on the writer thread once the job's outcome is known
+    
+    /**
+     * @param db Connection the writer owns for writing
+     * @param max_jobs Jobs per transaction (at least 1)
+     * @param max_delay_ms Longest a job waits for its group's commit
+     * @param max_queued Jobs that may wait to run before submit blocks (0 = unbounded)
+     */
+    SQLiteWriter(SQLiteDatabase& db, size_t max_jobs, int32_t max_delay_ms, size_t max_queued = 0);
+    
+    /**
+     * @brief Run and commit everything still queued, then stop the thread
+     */
+    ~SQLiteWriter();
+    
+    SQLiteWriter(const SQLiteWriter&) = delete;
+    SQLiteWriter& operator=(const SQLiteWriter&) = delete;
+    
+    /**
+     * @brief Queue a write, waiting while max_queued jobs are already queued
+     * @param job The write; returns false to roll back its savepoint
+     * @param committed Called with the job's outcome after its group commits (optional)
+     * @return Resolves to true once the job's writes are committed
+     */
+    std::future<bool> submit(Job job, Committed committed = nullptr);
+    
+    /**
+     * @brief Run and commit everything submitted so far, waiting until it is durable
+     */
+    void flush();
+    
+    std::mutex& connection_mutex() { return connection_mutex_; }
+    size_t commit_count() const;   // Group commits so far
+    size_t job_count() const;      // Jobs whose outcome is known
+    
+private:
+    struct QueuedJob {
+        Job job;
+        Committed committed;
+        std::promise<bool> done;
+    };
+    struct RunJob {
+        bool succeeded = false;
+        Committed committed;
+        std::promise<bool> done;
+    };
+    
+    void run();
+    void commitGroup();   // Caller holds connection_mutex_
+    
+    SQLiteDatabase& db_;
+    const size_t max_jobs_;
+    const std::chrono::milliseconds max_delay_;
+    const size_t max_queued_;
+    
+    std::mutex connection_mutex_;
+    std::unique_ptr<SQLiteTransaction> group_;   // Open transaction of the current group (writer thread only)
+    std::vector<RunJob> group_jobs_;             // Jobs run in it, waiting for its commit
+    std::chrono::steady_clock::time_point group_deadline_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<QueuedJob> queue_;
+    size_t submitted_ = 0;
+    size_t completed_ = 0;
+    size_t commits_ = 0;
+    size_t flush_waiters_ = 0;
+    bool stopping_ = false;
+    std::thread thread_;
 };
 
 } // namespace leafra
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief Compression applied to chunk text before it is stored
+ */
+enum class TextCompression : int32_t {
+    NONE = 0,                               // Stored as TEXT
+    LZ4 = 1                                 // LZ4 block format (fast to decode, roughly halves prose)
+};
+
+/**
+ * @brief Compresses chunk text into self-describing blobs and back
+ *
+ * A compressed value is one codec tag byte, the original size as a varint, then the
+ * payload. Text that doesn't get smaller is left alone, so readers treat TEXT values as
+ * plain text and BLOB values as compressed.
+ *
+ * Example usage:
+ *
+ * std::vector<uint8_t> blob;
+ * if (TextCodec::compress(chunk.content, TextCompression::LZ4, blob)) {
+ *     // store blob as a BLOB, else store the text as TEXT
+ * }
+ * std::string text;
+ * TextCodec::decompress(blob.data(), blob.size(), text);
+ */
+class LEAFRA_API TextCodec {
+public:
+    /**
+     * @brief Parse a config name ("none", "lz4")
+     * @return true if the name is known
+     */
+    static bool parse_compression(const std::string& name, TextCompression& compression);
+
+    /**
+     * @brief Compress text (reuses out's capacity)
+     * @return false for NONE, or if the result wouldn't be smaller than the text
+     */
+    static bool compress(std::string_view text, TextCompression compression, std::vector<uint8_t>& out);
+
+    /**
+     * @brief Decompress a value written by compress()
+     * @param out Output text (replaced)
+     * @return false if the value is malformed or uses an unknown codec
+     */
+    static bool decompress(const uint8_t* data, size_t size, std::string& out);
+
+    /**
+     * @brief Pack token ids as varints (ids below 16384 take two bytes, reuses out's capacity)
+     */
+    static void encode_tokens(const std::vector<int32_t>& tokens, std::vector<uint8_t>& out);
+
+    /**
+     * @brief Unpack token ids written by encode_tokens()
+     * @param out Output token ids (replaced)
+     * @return false if the value is truncated or holds an id outside int32_t
+     */
+    static bool decode_tokens(const uint8_t* data, size_t size, std::vector<int32_t>& out);
+
+    // Raw LZ4 block format (no header); decompression needs the exact original size
+    static void lz4_compress(const uint8_t* input, size_t size, std::vector<uint8_t>& out);
+    static bool lz4_decompress(const uint8_t* input, size_t size, char* out, size_t original_size);
+};
+
+} // namespace leafra
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace leafra {
+
+/**
+ * @brief Which clean-ups normalize_text applies (ParsingConfig::normalize_* select them for ingestion)
+ */
+struct TextNormalizationOptions {
+    bool nfkc = true;                       // Unicode NFKC: ligatures, full-width forms, NBSP and other compatibility characters (needs ICU)
+    bool collapse_whitespace = true;        // Runs of spaces/tabs become one space, spaces around line breaks go, at most one blank line is kept
+    bool dehyphenate = true;                // "exam-\nple" (or a soft hyphen at a line break) becomes "example" when the next line starts lowercase
+    bool strip_control = true;              // Drop C0/C1 control characters, zero-width spaces and BOMs; CR, CRLF, FF, VT and U+2028/9 become '\n'
+};
+
+/**
+ * @brief Normalize page text in place ahead of chunking
+ *
+ * The clean-up is a single compaction pass over the buffer (output never outruns input, so
+ * nothing is allocated); runs of plain printable ASCII are found with SIMD and moved, or
+ * skipped if nothing has been removed yet. NFKC only looks at the non-ASCII stretches of the
+ * text, and only rebuilds the string if one of them is not already normalized.
+ *
+ * @param text Page text (UTF-8), rewritten in place
+ * @param options Clean-ups to apply
+ */
+void normalize_text(std::string& text, const TextNormalizationOptions& options);
+
+/**
+ * @brief Whether normalize_text can apply NFKC in this build (ICU is available)
+ */
+bool text_normalization_has_nfkc();
+
+/**
+ * @brief Length of the prefix of data that normalize_text copies verbatim: printable ASCII,
+ * stopping at '-' when check_hyphens and at a second consecutive space when check_spaces
+ */
+size_t plain_ascii_run_length(const char* data, size_t size, bool check_spaces, bool check_hyphens);
+
+} // namespace leafra
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "types.h"
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace leafra {
+
+/**
+ * @brief TensorFlow Lite model wrapper for embedding inference
+ *
+ * RAII wrapper around the TensorFlow Lite C API (model, interpreter options,
+ * delegates and interpreter). Inputs are written straight into the interpreter's
+ * input tensors and outputs are read straight from its output tensors, so batched
+ * inference needs no intermediate per-sample vectors.
+ *
+ * Quantized models are supported: int8/uint8 inputs are quantized with the tensor's
+ * scale and zero point when written, and int8/uint8/int16/float16 outputs are
+ * dequantized to float32 when a row is read.
+ *
+ * Example usage:
+ *
+ * try {
+ *     TFLiteModel model("model.tflite");
+ *     model.resizeBatch(chunks.size());                       // [batch, sequence_length]
+ *     for (size_t row = 0; row < chunks.size(); ++row) {
+ *         model.setTokenRow(0, row, ids.data(), ids.size(), pad_id);
+ *         model.setMaskRow(1, row, ids.size());
+ *     }
+ *     model.invoke();
+ *     const float* embedding = model.getOutputRow(0, 0);     // getOutputSize(0) floats
+ * } catch (const std::exception& e) {
+ *     // Handle error: e.what()
+ * }
+ *
+ * Not thread-safe: callers must serialize access to a single instance.
+ */
+class LEAFRA_API TFLiteModel {
+public:
+    /**
+     * @brief Interpreter and delegate options
+     */
+    struct Options {
+        int32_t num_threads = -1;           // Interpreter/XNNPACK threads (-1 = runtime default)
+        bool enable_xnnpack = true;         // XNNPACK CPU delegate (cross-platform)
+        bool enable_coreml = false;         // CoreML delegate (iOS/macOS only)
+        bool enable_metal = false;          // Metal GPU delegate (iOS/macOS only)
+        bool enable_gpu = false;            // OpenCL/OpenGL GPU delegate (Android only)
+        bool enable_nnapi = false;          // NNAPI delegate (Android only)
+        std::string cache_dir;              // GPU delegate kernel and XNNPACK weight caches, keyed by model file (empty = none)
+    };
+
+    /**
+     * @brief Construct TensorFlow Lite model from file
+     * @param model_path Path to .tflite file
+     * @param options Interpreter and delegate options
+     * @throws std::runtime_error if model loading or tensor allocation fails
+     */
+    TFLiteModel(const std::string& model_path, const Options& options);
+
+    /**
+     * @brief Destructor - deletes interpreter before delegates, then options and model
+     */
+    ~TFLiteModel();
+
+    // Non-copyable but movable
+    TFLiteModel(const TFLiteModel&) = delete;
+    TFLiteModel& operator=(const TFLiteModel&) = delete;
+    TFLiteModel(TFLiteModel&&) noexcept;
+    TFLiteModel& operator=(TFLiteModel&&) noexcept;
+
+    /**
+     * @brief Check if model is valid and ready for inference
+     */
+    bool isValid() const;
+
+    // Model introspection (refreshed whenever tensors are reallocated)
+    size_t getInputCount() const;
+    size_t getOutputCount() const;
+    std::string getInputName(size_t index) const;
+    std::string getOutputName(size_t index) const;
+    size_t getInputSequenceLength(size_t index) const;   // Elements per sample of an input tensor
+    size_t getOutputSize(size_t index) const;            // Elements per sample of an output tensor
+    std::vector<int32_t> getOutputDims(size_t index) const;
+    size_t getBatchSize() const;                         // Current leading dimension of the inputs
+    size_t getSequenceLength() const;                    // Current second dimension of the inputs
+    size_t getDelegateCount() const;
+    std::vector<std::string> getDelegateNames() const;
+    bool isOutputQuantized(size_t index) const;          // Output is not float32 and is dequantized by getOutputRow
+
+    /**
+     * @brief Resize the batch dimension of every input tensor and reallocate tensors
+     *
+     * No-op when the batch size is unchanged. Fails for models whose graph (or whose
+     * delegates) only support the exported static batch size.
+     *
+     * @param batch_size New leading dimension
+     * @throws std::runtime_error if resizing or reallocation fails
+     */
+    void resizeBatch(size_t batch_size);
+
+    /**
+     * @brief Resize every input tensor to [batch_size, sequence_length] and reallocate tensors
+     *
+     * Used for sequence-length bucketing on models exported with flexible shapes.
+     * No-op when both dimensions are unchanged; inputs of rank 1 only get their batch resized.
+     * On failure the previous shape is restored, so the model stays usable.
+     *
+     * @param batch_size New leading dimension
+     * @param sequence_length New second dimension
+     * @throws std::runtime_error if resizing or reallocation fails
+     */
+    void resizeInputs(size_t batch_size, size_t sequence_length);
+
+    /**
+     * @brief Write one row of token IDs into an input tensor, padding the remainder
+     * @param input_index Input tensor index
+     * @param row Row within the current batch
+     * @param token_ids Token IDs (trimmed to the sequence length)
+     * @param count Number of token IDs
+     * @param pad_value Value used for positions after count
+     * @throws std::runtime_error on out-of-range indices or unsupported tensor type
+     */
+    void setTokenRow(size_t input_index, size_t row, const int* token_ids, size_t count, int pad_value);
+
+    /**
+     * @brief Write one row of an attention mask (1 for the first real_count positions, 0 after)
+     * @throws std::runtime_error on out-of-range indices or unsupported tensor type
+     */
+    void setMaskRow(size_t input_index, size_t row, size_t real_count);
+
+    /**
+     * @brief Fill one row of an input tensor with a constant (e.g. token_type_ids)
+     * @throws std::runtime_error on out-of-range indices or unsupported tensor type
+     */
+    void fillRow(size_t input_index, size_t row, int value);
+
+    /**
+     * @brief Run inference on the current input tensors
+     * @throws std::runtime_error if the interpreter fails
+     */
+    void invoke();
+
+    /**
+     * @brief Pointer to one row of an output tensor as float32 (valid until the next resize/invoke)
+     *
+     * Quantized outputs are dequantized into a buffer reused per output, so the pointer is
+     * also only valid until the next getOutputRow call for the same output.
+     *
+     * @throws std::runtime_error on out-of-range indices or unsupported output types
+     */
+    const float* getOutputRow(size_t output_index, size_t row) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+} // namespace leafra
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "types.h"
+#include "platform_utils.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief Hands a task to a worker thread (usually ThreadPool::submit)
+ * Returns false if the task was not accepted; callers then do that work themselves.
+ */
+using TaskSubmitFunction = std::function<bool(std::function<void()> task)>;
+
+/**
+ * @brief Run body(0) ... body(count - 1) on submit_task's workers and the calling thread
+ *
+ * Threads claim indices from a shared counter, so the caller always makes progress (no deadlock
+ * when it is itself a pool worker) and tasks the pool starts late find nothing left to do.
+ * An empty submit_task runs everything on the calling thread.
+ */
+inline void parallel_for_each(const TaskSubmitFunction& submit_task, size_t count, const std::function<void(size_t)>& body) {
+    struct SharedState {
+        std::atomic<size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable done_cv;
+        size_t done = 0;
+    };
+    auto state = std::make_shared<SharedState>();
+    auto run = [state, count, &body]() {
+        size_t index;
+        while ((index = state->next.fetch_add(1)) < count) {
+            body(index);
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (++state->done == count) {
+                state->done_cv.notify_all();
+            }
+        }
+    };
+    for (size_t helper = 1; helper < count && submit_task; ++helper) {
+        if (!submit_task(run)) {
+            break;
+        }
+    }
+    run();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done_cv.wait(lock, [&state, count]() { return state->done == count; });
+}
+
+/**
+ * @brief Fixed-size worker pool used by the ingestion pipeline
+ *
+ * Tasks are executed in FIFO order by a fixed number of worker threads, all running at the
+ * pool's QoS. LeafraCore creates one utility pool for ingestion (sized from Config::max_threads)
+ * and one user-initiated pool for query fan-out, so searches never queue behind indexing work.
+ */
+class LEAFRA_API ThreadPool {
+public:
+    using task_t = std::function<void()>;
+
+    /**
+     * @brief Create a pool with the given number of workers
+     * @param thread_count Number of worker threads (clamped to at least 1)
+     * @param qos Scheduling class every worker runs at
+     * @param name Worker thread name prefix (shown in traces)
+     */
+    explicit ThreadPool(size_t thread_count, ThreadQoS qos = ThreadQoS::UTILITY, const std::string& name = "LeafraWorker");
+
+    /**
+     * @brief Stops accepting tasks, drains the queue and joins all workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queue a task for execution on a worker thread
+     * @param task Task to run
+     * @return false if the pool is shutting down and the task was rejected
+     */
+    bool submit(task_t task);
+
+    /**
+     * @brief Block until every queued and running task has finished
+     */
+    void wait_idle();
+
+    /**
+     * @brief Number of worker threads owned by the pool
+     */
+    size_t size() const { return workers_.size(); }
+
+    /**
+     * @brief Resolve a worker count from a configured thread budget
+     * @param configured Configured thread count (<= 0 means "use hardware concurrency")
+     * @return Worker count in [1, hardware_concurrency]
+     */
+    static size_t resolve_thread_count(int32_t configured);
+
+private:
+    void worker_loop();
+
+    std::vector<std::thread> workers_;
+    std::deque<task_t> tasks_;
+    std::mutex mutex_;
+    std::condition_variable task_cv_;
+    std::condition_variable idle_cv_;
+    size_t active_tasks_ = 0;
+    bool stopping_ = false;
+};
+
+/**
+ * @brief Threads handed to each engine, derived from the CPU topology
+ *
+ * Engines used to size themselves independently (llama.cpp and XNNPACK from all hardware
+ * threads, the pool from max_threads), oversubscribing efficiency cores that then hold back
+ * every synchronized step. The budget keeps latency-bound engines on the performance cores:
+ * - llama.cpp and TFLite get one thread per performance core (TFLite at most 4), FAISS's
+ *   OpenMP teams too (they run between ingestion batches, not alongside the LLM)
+ * - the query pool gets the performance cores minus the calling thread
+ * - the ingestion pool stays at max_threads and runs at utility QoS, where the OS prefers
+ *   efficiency cores
+ * Explicitly configured thread counts always win.
+ */
+struct LEAFRA_API ThreadBudget {
+    size_t ingest_workers = 1;          // Ingestion pool (utility QoS)
+    size_t query_workers = 1;           // Query fan-out pool (user-initiated QoS)
+    int32_t llm_threads = 1;            // llama.cpp n_threads (generation)
+    int32_t llm_batch_threads = 1;      // llama.cpp n_threads_batch (prompt processing)
+    int32_t embedding_threads = 1;      // TFLite interpreter threads
+    int32_t faiss_threads = 1;          // FAISS OpenMP threads (bulk adds, training, batched searches)
+
+    /**
+     * @brief Configured thread counts (<= 0 = let the budget decide, except max_threads: all cores)
+     */
+    struct Settings {
+        int32_t max_threads = 4;            // Config::max_threads
+        int32_t query_threads = 0;          // Config::query_threads
+        int32_t llm_threads = -1;           // LLMConfig::n_threads
+        int32_t llm_batch_threads = -1;     // LLMConfig::n_threads_batch
+        int32_t embedding_threads = -1;     // EmbeddingModelConfig::tflite_num_threads
+        int32_t faiss_threads = -1;         // VectorSearchConfig::faiss_threads
+
+        static Settings from(const Config& config) {
+            Settings settings;
+            settings.max_threads = config.max_threads;
+            settings.query_threads = config.query_threads;
+            settings.llm_threads = config.llm.n_threads;
+            settings.llm_batch_threads = config.llm.n_threads_batch;
+            settings.embedding_threads = config.embedding_inference.tflite_num_threads;
+            settings.faiss_threads = config.vector_search.faiss_threads;
+            return settings;
+        }
+    };
+
+    /**
+     * @brief Resolve every engine's share from the topology and the configured thread counts
+     * @param topology CPU core counts (PlatformUtils::get_cpu_topology)
+     * @param settings Configured thread counts
+     */
+    static ThreadBudget resolve(const CpuTopology& topology, const Settings& settings);
+
+    static ThreadBudget resolve(const CpuTopology& topology, const Config& config) {
+        return resolve(topology, Settings::from(config));
+    }
+};
+
+/**
+ * @brief Blocking bounded multi-producer / multi-consumer queue
+ *
+ * Used between pipeline stages so that fast producers (parsing, tokenization)
+ * cannot run arbitrarily far ahead of slow consumers (embedding, DB writes)
+ * and hold every parsed document of a large import in memory at once.
+ */
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity > 0 ? capacity : 1) {}
+
+    /**
+     * @brief Push an item, blocking while the queue is full
+     * @return false if the queue was closed before the item could be pushed
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Pop an item, blocking while the queue is empty
+     * @return false if the queue is closed and fully drained
+     */
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Close the queue; blocked producers fail and consumers drain what is left
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    const size_t capacity_;
+    std::deque<T> items_;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    bool closed_ = false;
+};
+
+} // namespace leafra
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace leafra {
+
+/**
+ * @brief Delivers generated tokens to a token callback in whole UTF-8 characters
+ *
+ * Pieces are pushed as they are sampled. Bytes of a character split across tokens are held
+ * back until it is complete, so the consumer never sees an invalid fragment. With a flush
+ * interval, text is coalesced and delivered from a dedicated thread at most every flush_ms
+ * (or as soon as flush_tokens pieces are waiting), so decoding never waits on the consumer.
+ * Without one, each push is delivered inline as before.
+ *
+ * The final ("", true) call is made exactly once, by close() or the destructor, after
+ * everything pushed has been delivered.
+ *
+ * Example usage:
+ *
+ * TokenStream stream(callback, 16, 16);
+ * for (...) {
+ *     if (!stream.push(piece)) break;     // consumer asked to stop
+ * }
+ * stream.close();
+ */
+class LEAFRA_API TokenStream {
+public:
+    /**
+     * @param consumer Callback receiving the text; returning false stops the stream
+     * @param flush_ms Coalescing window in milliseconds (0 = deliver each push inline)
+     * @param flush_tokens Deliver early once this many pieces are waiting (<= 0 = time only)
+     */
+    TokenStream(token_callback_t consumer, int32_t flush_ms, int32_t flush_tokens);
+    ~TokenStream();
+
+    TokenStream(const TokenStream&) = delete;
+    TokenStream& operator=(const TokenStream&) = delete;
+
+    /**
+     * @brief Queue a generated piece
+     * @return false once the consumer has returned false (the piece is dropped)
+     */
+    bool push(const std::string& piece);
+
+    /**
+     * @brief Deliver whatever is left, then the final call, and stop the delivery thread (idempotent)
+     */
+    void close();
+
+    /**
+     * @brief Whether the consumer has asked to stop
+     */
+    bool stopped() const;
+
+    /**
+     * @brief Length of the longest prefix of text that doesn't end inside a UTF-8 character
+     */
+    static size_t complete_utf8_prefix(const std::string& text);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+} // namespace leafra
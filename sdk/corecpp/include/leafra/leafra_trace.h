@@ -0,0 +1,112 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace leafra {
+namespace trace {
+
+/**
+ * @brief Timeline tracing of spans across threads, exported as Chrome Trace Event JSON
+ *
+ * Spans are timed with debug::timer and appended to a buffer owned by the recording thread,
+ * so threads never contend while tracing; buffers are only locked together on export. The
+ * JSON loads in chrome://tracing and https://ui.perfetto.dev. While tracing is stopped a span
+ * costs one relaxed atomic load.
+ *
+ * Example usage:
+ *
+ * trace::start();
+ * {
+ *     LEAFRA_TRACE_SCOPE("faiss", "search");
+ *     index->search(query, k);
+ * }
+ * trace::stop();
+ * trace::write_chrome_trace(path);
+ */
+
+/**
+ * @brief Clear recorded events and start recording
+ * @param max_events_per_thread Events a thread keeps before further spans are dropped
+ */
+LEAFRA_API void start(size_t max_events_per_thread = 262144);
+
+/**
+ * @brief Stop recording; recorded events are kept for export
+ */
+LEAFRA_API void stop();
+
+LEAFRA_API bool is_enabled();
+
+/**
+ * @brief Discard recorded events (and buffers of threads that have exited)
+ */
+LEAFRA_API void clear();
+
+/**
+ * @brief Name the calling thread in exported traces (e.g. "LeafraWorker")
+ */
+LEAFRA_API void set_thread_name(const std::string& name);
+
+/**
+ * @brief Number of events recorded / dropped for exceeding the per-thread limit
+ */
+LEAFRA_API size_t event_count();
+LEAFRA_API uint64_t dropped_count();
+
+/**
+ * @brief Serialize recorded events as a Chrome Trace Event JSON object
+ */
+LEAFRA_API std::string to_chrome_json();
+
+/**
+ * @brief Write to_chrome_json() to a file
+ * @return true on success
+ */
+LEAFRA_API bool write_chrome_trace(const std::string& path);
+
+/**
+ * @brief A timed region, recorded as a complete ("X") event when it ends
+ *
+ * category and name must outlive the trace (string literals); argument values are copied.
+ */
+class LEAFRA_API Span {
+public:
+    Span(const char* category, const char* name);
+    ~Span() { end(); }
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    // Attach an argument shown in the trace viewer's details pane (ignored when not recording)
+    void arg(const char* key, const std::string& value);
+    void arg(const char* key, double value);
+    template<typename T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
+    void arg(const char* key, T value) { arg_integer(key, static_cast<int64_t>(value)); }
+
+    // Record the span now rather than at destruction
+    void end();
+
+    bool active() const { return active_; }
+
+private:
+    void arg_integer(const char* key, int64_t value);
+
+    const char* category_;
+    const char* name_;
+    double start_us_ = 0.0;
+    std::string args_;
+    bool active_ = false;
+};
+
+} // namespace trace
+} // namespace leafra
+
+#define LEAFRA_TRACE_CONCAT_INNER(a, b) a##b
+#define LEAFRA_TRACE_CONCAT(a, b) LEAFRA_TRACE_CONCAT_INNER(a, b)
+
+// Trace the rest of the enclosing scope as one span
+#define LEAFRA_TRACE_SCOPE(category, name) \
+    leafra::trace::Span LEAFRA_TRACE_CONCAT(_leafra_trace_span_, __LINE__)(category, name)
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <mutex>
+#include <functional>
 
 #ifdef LEAFRA_HAS_ICU
 #include <unicode/uchar.h>
@@ -26,39 +29,80 @@ typedef int32_t UChar32;
 
 namespace leafra {
 
+/**
+ * Runs body(0) ... body(count - 1), possibly concurrently, and returns once all have finished
+ */
+using ParallelFor = std::function<void(size_t count, const std::function<void(size_t)>& body)>;
+
 /**
  * Unicode caching class for performance optimization
- * Caches Unicode character data for a single string to avoid repeated UTF-8 parsing
+ * Indexes a UTF-8 string once so character <-> byte lookups don't rescan it from the start.
+ * Only a view of the text is held (the caller keeps it alive and unchanged until the next
+ * reinitialize), plus the byte offset of every kCheckpointInterval-th code point - about
+ * 8 bytes per 128 characters; code points are decoded on the fly.
+ * The same pass records which bytes belong to whitespace and to word characters (2 bits per
+ * byte), so word boundary searches are bit scans instead of decoding loops.
  */
 class UnicodeCacher {
+public:
+    // Byte classes recorded while indexing; every byte of a matching code point is marked
+    enum class ByteClass { WHITESPACE, WORD };
+
 private:
-    std::string cached_text;
-    UChar32* codepoints_by_byte;      // maps byte_pos -> codepoint (C-style array)
-    size_t* next_byte_pos_by_byte;    // maps byte_pos -> next_byte_pos (C-style array)
-    size_t array_size;                // size of the allocated arrays
+    static constexpr size_t kCheckpointInterval = 128;
+    std::string_view cached_text;
+    std::vector<size_t> char_checkpoints;  // [k] = byte offset just past the (k * kCheckpointInterval)-th code point
     size_t unicode_length_cached;     // cached length of the string
-    void initialize_cache(const std::string& text);
-    void cleanup_arrays();            // helper to free memory
+    std::vector<uint64_t> space_bits;  // bit b set: byte b is part of a whitespace code point
+    std::vector<uint64_t> word_bits;   // bit b set: byte b is part of a word code point (is_word_char_optimized)
+    void initialize_cache(std::string_view text);
+    
+    // Where index_range writes byte classes; words below private_from are shared with the previous
+    // segment and collect into head_* for the caller to merge
+    struct ClassBits {
+        uint64_t* space = nullptr;
+        uint64_t* word = nullptr;
+        size_t private_from = 0;
+        uint64_t head_space = 0;
+        uint64_t head_word = 0;
+    };
+    
+    // Decode [begin, end) whose first code point has index first_char_index; returns the code point
+    // count, appends the range's checkpoints when checkpoints is set and marks byte classes when bits is set
+    static size_t index_range(std::string_view text, size_t begin, size_t end,
+                              size_t first_char_index, std::vector<size_t>* checkpoints, ClassBits* bits);
+    const std::vector<uint64_t>& class_bits(ByteClass cls) const { return cls == ByteClass::WHITESPACE ? space_bits : word_bits; }
 
 public:
     UnicodeCacher();
-    UnicodeCacher(const std::string& text);
-    ~UnicodeCacher();                 // destructor to free memory
-    
-    // Copy constructor and assignment operator for proper memory management
-    UnicodeCacher(const UnicodeCacher& other);
-    UnicodeCacher& operator=(const UnicodeCacher& other);
+    UnicodeCacher(std::string_view text);
+    UnicodeCacher(std::string&&) = delete;   // would dangle - the cacher only views the text
 
     /*regenerate the cache for a new text*/
-    void reinitialize(const std::string& text);
+    void reinitialize(std::string_view text);
+    void reinitialize(std::string&&) = delete;
+    
+    /*regenerate the cache, indexing segments of about segment_bytes concurrently (same index as reinitialize)*/
+    void reinitialize(std::string_view text, size_t segment_bytes, const ParallelFor& parallel_for);
+    void reinitialize(std::string&&, size_t, const ParallelFor&) = delete;
 
     UChar32 get_unicode_char_at_cached(size_t byte_pos, size_t& next_byte_pos) const;
     
     // Additional cached Unicode utility functions
     size_t get_byte_pos_for_char_index_cached(size_t char_index) const;
+    size_t get_char_index_for_byte_pos_cached(size_t byte_pos) const;   // code points starting before byte_pos
+    size_t get_previous_char_pos_cached(size_t byte_pos) const;          // start of the character before (or containing) byte_pos - 1
     std::string get_utf8_substring_cached(size_t start_char_pos, size_t char_count) const;
     size_t get_unicode_length_cached() const;
     size_t find_word_boundary_helper_for_unicode_cached(size_t start_byte_pos, bool search_forward) const;
+    
+    // Byte class queries (bit scans over the bitmaps built while indexing)
+    bool byte_in_class(ByteClass cls, size_t byte_pos) const;
+    size_t find_next_byte(ByteClass cls, bool in_class, size_t from, size_t limit) const;   // first byte in [from, limit) that is (or isn't) in cls, else limit
+    size_t find_prev_byte(ByteClass cls, bool in_class, size_t floor, size_t before) const; // last byte in [floor, before) that is (or isn't) in cls, else npos
+    
+    // Heap bytes held by the index (capacity, so memory kept for reuse counts too)
+    size_t memory_bytes() const;
 };
 
 inline bool is_word_char_optimized(UChar32 c) {
@@ -71,6 +115,81 @@ inline bool is_word_char_optimized(UChar32 c) {
 }
 
 
+/**
+ * Length of the run of ASCII bytes (< 0x80) at the start of a buffer
+ * Scans 16-32 bytes per step with NEON/AVX2/SSE2 where available
+ * @param data Buffer to scan
+ * @param size Buffer size in bytes
+ * @return Number of leading ASCII bytes
+ */
+size_t ascii_run_length(const char* data, size_t size);
+
+/**
+ * Length of the run of ASCII word bytes ([A-Za-z0-9_]) at the start of a buffer
+ * Stops at the first non-word or non-ASCII byte, which callers then decode
+ * @param data Buffer to scan
+ * @param size Buffer size in bytes
+ * @return Number of leading ASCII word bytes
+ */
+size_t ascii_word_run_length(const char* data, size_t size);
+
+/**
+ * Classify a block of ASCII bytes as whitespace and word bytes
+ * Uses NEON/AVX2/SSE2 where available
+ * @param data Buffer of ASCII bytes
+ * @param size Number of bytes, at most 64
+ * @param space_mask Output: bit i set if byte i is whitespace (space, \t \n \v \f \r)
+ * @param word_mask Output: bit i set if byte i is a word byte ([A-Za-z0-9_])
+ */
+void ascii_class_masks(const char* data, size_t size, uint64_t& space_mask, uint64_t& word_mask);
+
+/**
+ * Transcode UTF-16 (native byte order) to UTF-8
+ * Runs of ASCII code units are narrowed 8 at a time with NEON/AVX2/SSE2 where available;
+ * unpaired surrogates become U+FFFD
+ * @param data UTF-16 code units
+ * @param count Number of code units
+ * @param out Output buffer of at least count * 3 bytes
+ * @return Number of bytes written
+ */
+size_t utf16_to_utf8(const uint16_t* data, size_t count, char* out);
+
+/**
+ * Transcode UTF-16 to UTF-8 into a string, reusing its capacity
+ * @param data UTF-16 code units
+ * @param count Number of code units
+ * @param out Output: replaced with the UTF-8 text
+ */
+void utf16_to_utf8(const uint16_t* data, size_t count, std::string& out);
+
+/**
+ * Find where sentences end in UTF-8 text
+ * Uses ICU's sentence BreakIterator; without ICU (or if it fails) breaks after . ! ? and
+ * 。！？ followed by whitespace, and after line breaks. Trailing whitespace stays with the
+ * sentence it follows.
+ * @param text UTF-8 encoded text
+ * @param boundaries Output: ascending byte offsets just past each sentence (the last is text.size())
+ */
+void find_sentence_boundaries(std::string_view text, std::vector<size_t>& boundaries);
+
+/**
+ * Serve ICU from a trimmed data bundle instead of the ICU data linked into the app
+ * The bundle (an icudt*.dat built with ICU's data filter down to normalization and break
+ * rules) is only mapped by the first ensure_icu_data, so naming it costs nothing. Ignored
+ * once ICU data is in use, and with system ICU (Apple, Android), which maps its own data.
+ * @param path Data bundle file (empty = the linked data)
+ */
+void set_icu_data_file(const std::string& path);
+
+/**
+ * Map the ICU data bundle before the first data-backed ICU call
+ * NFKC calls it on its first non-ASCII text and the sentence splitter before opening its
+ * break iterator, so ASCII-only ingestion never loads ICU data; character properties
+ * (u_isalnum, u_isspace) are compiled into the ICU library and need none.
+ * @return false without ICU, or if the bundle could not be used (the linked data serves then)
+ */
+bool ensure_icu_data();
+
 //NONCACHED/SLOW C API FOR UNICODE HANDLING 
 //Use the unicode_cacher.cpp file for the cached version of these functions where possible!!
 /**
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief Native encoder for SentencePiece unigram models
+ *
+ * Loads the same serialized .model as SentencePieceProcessor and follows its Encode
+ * (normalization with the model's precompiled character map, then the optimized Viterbi
+ * search), without protobuf objects or per-call allocations:
+ *
+ * - The vocabulary lives in a double-array trie walked once per lattice position.
+ * - Runs of printable ASCII the character map leaves alone are found with SIMD and
+ *   copied through the normalizer in bulk.
+ * - The normalized text and the best-path lattice are per-thread buffers reused by
+ *   every call, so encoding from several threads at once is safe.
+ *
+ * Only unigram models are accepted; load() reports anything else (BPE, word, char,
+ * whitespace-as-suffix models) so the caller can keep using SentencePiece. Sampling and
+ * byte offsets are not provided.
+ *
+ * SentencePieceTokenizer does not route encoding through this class yet: the IDs are
+ * checked against hand-built models, and the comparison with SentencePieceProcessor
+ * (test_matches_sentencepiece) still has to pass on a real unigram model such as
+ * multilingual-e5-small's.
+ *
+ * Example usage:
+ *
+ * UnigramTokenizer tokenizer;
+ * std::string error;
+ * if (tokenizer.load(serialized_model, &error)) {
+ *     std::vector<int> ids;
+ *     tokenizer.encode("Hello world", ids);
+ * }
+ */
+class LEAFRA_API UnigramTokenizer {
+public:
+    UnigramTokenizer();
+    ~UnigramTokenizer();
+
+    // Non-copyable but movable
+    UnigramTokenizer(const UnigramTokenizer&) = delete;
+    UnigramTokenizer& operator=(const UnigramTokenizer&) = delete;
+    UnigramTokenizer(UnigramTokenizer&&) noexcept;
+    UnigramTokenizer& operator=(UnigramTokenizer&&) noexcept;
+
+    /**
+     * @brief Load a model from the contents of a .model file (the bytes needn't outlive the call)
+     * @param serialized_model Serialized ModelProto
+     * @param error Set to the reason when the model is malformed or not supported (may be nullptr)
+     * @return true if the model is loaded; on false the previous model stays loaded
+     */
+    bool load(std::string_view serialized_model, std::string* error = nullptr);
+
+    /**
+     * @brief Check if a model is loaded
+     */
+    bool is_loaded() const;
+
+    /**
+     * @brief Number of pieces in the vocabulary (0 if no model loaded)
+     */
+    size_t piece_count() const;
+
+    /**
+     * @brief Encode text into piece IDs (no BOS/EOS)
+     * @param text Input text (UTF-8; malformed bytes become U+FFFD as in SentencePiece)
+     * @param ids Output piece IDs (cleared first, capacity kept)
+     */
+    void encode(std::string_view text, std::vector<int>& ids) const;
+
+    /**
+     * @brief Normalize text the way the model does before encoding (spaces escaped as U+2581)
+     * @param text Input text
+     * @param normalized Output text (replaced, capacity kept)
+     */
+    void normalize(std::string_view text, std::string& normalized) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+} // namespace leafra
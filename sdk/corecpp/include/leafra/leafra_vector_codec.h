@@ -0,0 +1,88 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief On-disk encoding of embeddings kept in the chunk_embeddings table
+ */
+enum class EmbeddingStorageFormat : int32_t {
+    NONE = 0,                               // Not stored (FAISS holds the only copy)
+    FP32 = 1,                               // Lossless, 4 bytes per dimension
+    FP16 = 2,                               // IEEE 754 half precision, 2 bytes per dimension
+    INT8 = 3                                // Symmetric per-vector int8 (value = q * scale), 1 byte per dimension
+};
+
+/**
+ * @brief Byte order of multi-byte elements in an encoded embedding
+ */
+enum class ByteOrder : int32_t {
+    LITTLE = 1,
+    BIG = 2
+};
+
+/**
+ * @brief Encodes float embeddings into compact blobs and back
+ *
+ * Elements are written in the host byte order and tagged with it, so writes never
+ * swap; decode() swaps only when a database is read on a host of the other order.
+ *
+ * Example usage:
+ *
+ * VectorCodec::Encoded encoded;
+ * VectorCodec::encode(embedding.data(), embedding.size(), EmbeddingStorageFormat::FP16, encoded);
+ * // store encoded.format, encoded.byte_order, encoded.scale, encoded.data
+ * std::vector<float> restored(embedding.size());
+ * VectorCodec::decode(encoded.format, encoded.byte_order, encoded.scale,
+ *                     encoded.data.data(), encoded.data.size(), restored.data(), restored.size());
+ */
+class LEAFRA_API VectorCodec {
+public:
+    struct Encoded {
+        EmbeddingStorageFormat format = EmbeddingStorageFormat::NONE;
+        ByteOrder byte_order = ByteOrder::LITTLE;
+        float scale = 0.0f;                 // INT8 dequantization scale (0 for other formats)
+        std::vector<uint8_t> data;
+    };
+
+    /**
+     * @brief Parse a config name ("none", "fp32", "fp16", "int8")
+     * @return true if the name is known
+     */
+    static bool parse_format(const std::string& name, EmbeddingStorageFormat& format);
+
+    /**
+     * @brief Byte order of the running host
+     */
+    static ByteOrder native_byte_order();
+
+    /**
+     * @brief Bytes needed to store one vector of the given dimension
+     */
+    static size_t encoded_size(EmbeddingStorageFormat format, size_t dimension);
+
+    /**
+     * @brief Encode a vector (reuses out.data's capacity)
+     * @return false for NONE or empty input
+     */
+    static bool encode(const float* values, size_t dimension, EmbeddingStorageFormat format, Encoded& out);
+
+    /**
+     * @brief Decode a stored vector into a caller-provided buffer
+     * @param out Output buffer of dimension floats
+     * @return false if the format is unknown or size doesn't match dimension
+     */
+    static bool decode(EmbeddingStorageFormat format, ByteOrder byte_order, float scale,
+                       const uint8_t* data, size_t size, float* out, size_t dimension);
+
+    // IEEE 754 binary16 conversion (round to nearest even, subnormals, inf and NaN preserved)
+    static uint16_t float_to_half(float value);
+    static float half_to_float(uint16_t value);
+};
+
+} // namespace leafra
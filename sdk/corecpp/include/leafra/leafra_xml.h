@@ -0,0 +1,86 @@
+#pragma once
+
+#include "types.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief Incremental SAX-style XML scanner
+ *
+ * Input is pushed in blocks of any size (e.g. straight from ZipReader) and only the
+ * markup or entity reference straddling a block boundary is buffered, so memory does
+ * not grow with the document. Handles elements, attributes, character and predefined
+ * entity references, CDATA sections, comments, processing instructions and DOCTYPE
+ * declarations (skipped). Names are reported as written - "w:t" stays "w:t".
+ */
+class LEAFRA_API XmlScanner {
+public:
+    struct Attribute {
+        std::string_view name;
+        std::string_view value;             // Entity references already decoded
+    };
+
+    /**
+     * @brief Receives parse events; any callback can return false to stop the scan
+     *
+     * Views are only valid during the callback. A run of text may arrive in several
+     * on_text calls; a self-closing element produces on_start_element then on_end_element.
+     */
+    class Handler {
+    public:
+        virtual ~Handler() = default;
+        virtual bool on_start_element(std::string_view name, const std::vector<Attribute>& attributes) {
+            (void)name; (void)attributes; return true;
+        }
+        virtual bool on_end_element(std::string_view name) { (void)name; return true; }
+        virtual bool on_text(std::string_view text) { (void)text; return true; }
+    };
+
+    explicit XmlScanner(Handler& handler) : handler_(handler) {}
+
+    /**
+     * @brief Scan the next block of the document
+     * @return false once the handler stopped the scan or the markup is malformed
+     */
+    bool feed(const char* data, size_t size);
+
+    /**
+     * @brief Flush trailing text at end of input
+     * @return false if the document ended inside markup
+     */
+    bool finish();
+
+    bool stopped() const { return stopped_; }
+    const std::string& last_error() const { return error_; }
+
+    /**
+     * @brief Value of the named attribute, or an empty view
+     */
+    static std::string_view attribute(const std::vector<Attribute>& attributes, std::string_view name);
+
+    /**
+     * @brief Append text with entity references (&amp; &#233; &#x1F600; ...) decoded to UTF-8
+     */
+    static void decode_entities(std::string_view text, std::string& out);
+
+private:
+    // Consume complete tokens from data; returns bytes consumed, or npos on stop/error
+    size_t scan(std::string_view data, bool at_end);
+    bool emit_text(std::string_view raw);
+    bool handle_tag(std::string_view tag);
+    bool stop();
+    bool fail(const char* message);
+
+    Handler& handler_;
+    std::string pending_;                   // Unconsumed tail of the previous block
+    std::string text_;                      // Decoded text scratch
+    std::vector<std::string> values_;       // Decoded attribute value scratch
+    std::vector<Attribute> attributes_;
+    bool stopped_ = false;
+    std::string error_;
+};
+
+} // namespace leafra
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "types.h"
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace leafra {
+
+/**
+ * @brief Read-only ZIP archive reader with streaming entry extraction
+ *
+ * Only the central directory is kept in memory. Entries are read and inflated in
+ * fixed-size blocks that go straight to a sink, so an entry of any size is extracted
+ * in bounded memory. Supports stored and deflated entries without encryption or ZIP64,
+ * which covers Office Open XML packages (.docx, .xlsx).
+ *
+ * Example usage:
+ *
+ * ZipReader zip;
+ * if (zip.open(path)) {
+ *     zip.read("word/document.xml", [&](const char* data, size_t size) { scanner.feed(data, size); return true; });
+ * }
+ */
+class LEAFRA_API ZipReader {
+public:
+    struct Entry {
+        std::string name;
+        uint16_t method = 0;                // 0 = stored, 8 = deflated
+        uint16_t flags = 0;
+        uint32_t crc32 = 0;
+        uint32_t compressed_size = 0;
+        uint32_t uncompressed_size = 0;
+        uint32_t local_header_offset = 0;
+    };
+
+    // Receives an entry's bytes in order; return false to stop reading
+    using DataSink = std::function<bool(const char* data, size_t size)>;
+
+    /**
+     * @brief Open an archive and read its central directory
+     * @return false if the file can't be read or isn't a supported ZIP archive
+     */
+    bool open(const std::string& path);
+
+    const std::vector<Entry>& entries() const { return entries_; }
+
+    /**
+     * @brief Entry with exactly this name, or nullptr
+     */
+    const Entry* find(const std::string& name) const;
+
+    /**
+     * @brief Stream an entry's uncompressed bytes into sink
+     * @return true if the entry was read completely (its CRC-32 checked) or the sink stopped it,
+     *         false on a missing entry, unsupported method or corrupt data (see last_error)
+     */
+    bool read(const Entry& entry, const DataSink& sink);
+    bool read(const std::string& name, const DataSink& sink);
+
+    const std::string& last_error() const { return error_; }
+
+private:
+    bool fail(const std::string& message);
+
+    std::ifstream file_;
+    std::vector<Entry> entries_;
+    std::string error_;
+};
+
+} // namespace leafra
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types.h"
+#include <atomic>
 #include <string>
 #include <sstream>
 #include <mutex>
@@ -16,6 +17,12 @@ enum class LogLevel : int32_t {
     LEAFRA_NONE = 4  // Disable all logging
 };
 
+// What a logging thread does when the async queue is full
+enum class LogOverflowPolicy : int32_t {
+    DROP = 0,   // Discard the message; the drain thread reports how many were dropped
+    BLOCK = 1   // Wait for the drain thread to free a slot
+};
+
 // Logger class
 class LEAFRA_API Logger {
 public:
@@ -25,9 +32,33 @@ public:
     void setLogLevel(LogLevel level);
     LogLevel getLogLevel() const;
     
+    // Cheap check done before a stream line formats anything
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int32_t>(level) >= m_logLevel.load(std::memory_order_relaxed);
+    }
+    
     // Enable/disable file and line info
     void setShowFileInfo(bool show);
     
+    /**
+     * @brief Switch between inline output and a background drain thread
+     * @param enabled true to queue messages for the drain thread, false to write them inline again
+     * @param capacity Queue slots, rounded up to a power of two (only the first enable sizes the queue)
+     * @param policy What a logging thread does when the queue is full
+     *
+     * Messages are formatted on the logging thread and handed over through a lock-free
+     * multi-producer queue, so workers never wait on each other or on the platform log.
+     * Disabling flushes whatever is still queued.
+     */
+    void setAsync(bool enabled, size_t capacity = 4096, LogOverflowPolicy policy = LogOverflowPolicy::DROP);
+    bool isAsync() const;
+    
+    // Block until every message queued so far has been written
+    void flush();
+    
+    // Messages discarded by LogOverflowPolicy::DROP since startup
+    uint64_t getDroppedCount() const;
+    
     // Main logging function
     void log(LogLevel level, const std::string& message, 
              const char* file = nullptr, int line = 0);
@@ -39,37 +70,56 @@ public:
     void error(const std::string& message, const char* file = nullptr, int line = 0);
     
 private:
+    class AsyncQueue;
+    
     Logger() = default;
-    ~Logger() = default;
+    ~Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
     
-    void platformLog(LogLevel level, const std::string& message);
-    std::string formatMessage(LogLevel level, const std::string& message, 
-                             const char* file, int line);
-    const char* levelToString(LogLevel level);
+    void platformLog(LogLevel level, const std::string& message, bool flush_console = true);
+    void formatMessage(LogLevel level, const std::string& message,
+                       const char* file, int line, std::string& out) const;
+    static const char* levelToString(LogLevel level);
+    void drainLoop();
+    
+    std::atomic<int32_t> m_logLevel{static_cast<int32_t>(LogLevel::LEAFRA_INFO)};
+    std::atomic<bool> m_showFileInfo{true};
+    std::mutex m_mutex;                        // Serializes inline (synchronous) platform output
     
-    LogLevel m_logLevel = LogLevel::LEAFRA_INFO;
-    bool m_showFileInfo = true;
-    std::mutex m_mutex;
+    std::atomic<bool> m_asyncEnabled{false};
+    std::atomic<AsyncQueue*> m_async{nullptr};  // Created on first setAsync(true), lives until ~Logger
+    std::mutex m_asyncMutex;                    // Serializes setAsync
 };
 
+// Compile-time floor: lines below this level compile to nothing (0 = debug, 1 = info, ... 4 = none).
+// The build defines it as 1 for Release/MinSizeRel unless LEAFRA_STRIP_DEBUG_LOGS is off.
+#ifndef LEAFRA_MIN_LOG_LEVEL
+#define LEAFRA_MIN_LOG_LEVEL 0
+#endif
+
+// True if a message at level would be logged (compile-time floor and runtime level)
+#define LEAFRA_LOG_ENABLED(level) \
+    (static_cast<int32_t>(level) >= LEAFRA_MIN_LOG_LEVEL && leafra::Logger::getInstance().isEnabled(level))
+
 // Convenience macros
 #define LEAFRA_LOG_DEBUG(msg) \
-    leafra::Logger::getInstance().debug(msg, __FILE__, __LINE__)
+    do { if (LEAFRA_LOG_ENABLED(leafra::LogLevel::LEAFRA_DEBUG)) leafra::Logger::getInstance().debug(msg, __FILE__, __LINE__); } while (0)
 
 #define LEAFRA_LOG_INFO(msg) \
-    leafra::Logger::getInstance().info(msg, __FILE__, __LINE__)
+    do { if (LEAFRA_LOG_ENABLED(leafra::LogLevel::LEAFRA_INFO)) leafra::Logger::getInstance().info(msg, __FILE__, __LINE__); } while (0)
 
 #define LEAFRA_LOG_WARNING(msg) \
-    leafra::Logger::getInstance().warning(msg, __FILE__, __LINE__)
+    do { if (LEAFRA_LOG_ENABLED(leafra::LogLevel::LEAFRA_WARNING)) leafra::Logger::getInstance().warning(msg, __FILE__, __LINE__); } while (0)
 
 #define LEAFRA_LOG_ERROR(msg) \
-    leafra::Logger::getInstance().error(msg, __FILE__, __LINE__)
+    do { if (LEAFRA_LOG_ENABLED(leafra::LogLevel::LEAFRA_ERROR)) leafra::Logger::getInstance().error(msg, __FILE__, __LINE__); } while (0)
 
-// Stream-style logging macros
+// Stream-style logging macros. When the level is disabled the LogStream is never built and
+// none of the << operands are evaluated, so disabled lines cost one comparison.
 #define LEAFRA_LOG_STREAM(level) \
-    leafra::LogStream(leafra::Logger::getInstance(), level, __FILE__, __LINE__)
+    !LEAFRA_LOG_ENABLED(level) ? (void)0 : \
+    leafra::LogStreamVoidify() & leafra::LogStream(leafra::Logger::getInstance(), level, __FILE__, __LINE__)
 
 #define LEAFRA_DEBUG() LEAFRA_LOG_STREAM(leafra::LogLevel::LEAFRA_DEBUG)
 #define LEAFRA_INFO() LEAFRA_LOG_STREAM(leafra::LogLevel::LEAFRA_INFO)
@@ -100,4 +150,10 @@ private:
     std::ostringstream m_stream;
 };
 
+// Turns a finished stream line into void so both arms of LEAFRA_LOG_STREAM's ?: match;
+// & binds looser than << and tighter than ?:
+struct LogStreamVoidify {
+    void operator&(const LogStream&) const {}
+};
+
 } // namespace leafra 
\ No newline at end of file
@@ -4,6 +4,53 @@
 
 namespace leafra {
 
+/**
+ * @brief Logical CPU counts by core kind
+ *
+ * The performance / efficiency split is only reported for heterogeneous CPUs (Apple P/E cores,
+ * ARM big.LITTLE); elsewhere every core is counted as a performance core.
+ */
+struct LEAFRA_API CpuTopology {
+    int32_t logical_cores = 1;          // All logical CPUs
+    int32_t performance_cores = 1;      // Cores fast enough for latency-bound work (P / big / prime)
+    int32_t efficiency_cores = 0;       // Low-power cores (E / LITTLE)
+    
+    bool is_heterogeneous() const { return performance_cores > 0 && efficiency_cores > 0; }
+};
+
+/**
+ * @brief Scheduling class of a thread
+ *
+ * Apple platforms map these to QoS classes (user-initiated work stays on performance cores,
+ * utility / background work is steered to efficiency cores); Linux and Android lower the
+ * thread's nice value instead.
+ */
+enum class ThreadQoS {
+    USER_INITIATED,     // Interactive work the user is waiting on (search, generation)
+    UTILITY,            // Long-running work with visible progress (ingestion)
+    BACKGROUND          // Deferrable maintenance
+};
+
+/**
+ * @brief Device thermal pressure (NSProcessInfoThermalState levels; Android thermal statuses map onto them)
+ */
+enum class ThermalState {
+    NOMINAL,            // No thermal pressure
+    FAIR,               // Slightly elevated - the OS may start reducing background work
+    SERIOUS,            // The OS is throttling; sustained load makes everything slower
+    CRITICAL            // Heavy throttling - shed all non-essential work
+};
+
+/**
+ * @brief Thermal, battery and power-saving state of the device
+ */
+struct LEAFRA_API PowerState {
+    ThermalState thermal = ThermalState::NOMINAL;
+    int32_t battery_percent = -1;       // Charge level 0-100 (-1 = unknown or no battery)
+    bool charging = false;              // On external power
+    bool low_power_mode = false;        // iOS Low Power Mode / Android battery saver
+};
+
 /**
  * @brief Platform-specific utility functions
  */
@@ -63,6 +110,30 @@ public:
      */
     static int32_t get_cpu_cores();
     
+    /**
+     * @brief Get the performance / efficiency core split
+     * @return Core counts (queried once and cached)
+     */
+    static CpuTopology get_cpu_topology();
+    
+    /**
+     * @brief Set the scheduling class of the calling thread
+     * @param qos Scheduling class
+     * @return true if the platform applied it
+     */
+    static bool set_current_thread_qos(ThreadQoS qos);
+    
+    /**
+     * @brief Sample the thermal state, battery level and low-power mode
+     * 
+     * Apple: NSProcessInfo thermal state and Low Power Mode (battery level unknown).
+     * Android: AThermal status (API 30+) and the sysfs battery (battery saver unknown - report
+     * PowerManager state through LeafraCore::report_power_state). Linux: sysfs battery only.
+     * 
+     * @return Current power state; fields the platform can't provide keep their defaults
+     */
+    static PowerState get_power_state();
+    
     // Path utilities
     
     /**
@@ -5,6 +5,7 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <utility>
 
 // Platform-specific macros
 #ifdef _WIN32
@@ -37,15 +38,48 @@ class MathUtils;
 // Forward declaration for chunking types
 enum class ChunkSizeUnit : int32_t;
 enum class TokenApproximationMethod : int32_t;
+enum class ChunkingStrategy : int32_t;
 
 // Basic types
 using byte_t = uint8_t;
 using data_buffer_t = std::vector<byte_t>;
 using callback_t = std::function<void(const std::string&)>;
 
+struct Event;
+using event_callback_t = std::function<void(const Event& event)>;
+
 // LLM-related callback types
 using token_callback_t = std::function<bool(const std::string& token, bool is_final)>;
 
+/**
+ * @brief Token ID sequences packed back to back in one buffer
+ * 
+ * Sequence i is ids[offsets[i], offsets[i + 1]). Reusing a batch keeps both
+ * buffers' capacity, so steady-state encoding doesn't allocate per sequence.
+ */
+struct LEAFRA_API TokenIdBatch {
+    std::vector<int> ids;                  // All sequences back to back
+    std::vector<size_t> offsets;           // size() + 1 entries, offsets[0] == 0
+    
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    size_t length(size_t i) const { return offsets[i + 1] - offsets[i]; }
+    const int* begin(size_t i) const { return ids.data() + offsets[i]; }
+    const int* end(size_t i) const { return ids.data() + offsets[i + 1]; }
+    
+    void clear() {
+        ids.clear();
+        offsets.assign(1, 0);
+    }
+    
+    // Close the sequence made of the IDs appended since the previous one
+    void end_sequence() {
+        if (offsets.empty()) {
+            offsets.push_back(0);
+        }
+        offsets.push_back(ids.size());
+    }
+};
+
 /**
  * @brief Helper structure for accessing chunk token information
  * 
@@ -85,7 +119,117 @@ enum class ResultCode : int32_t {
     ERROR_PROCESSING_FAILED = -3,
     ERROR_NOT_IMPLEMENTED = -4,
     ERROR_OUT_OF_MEMORY = -5,
-    ERROR_NOT_FOUND = -6
+    ERROR_NOT_FOUND = -6,
+    ERROR_CANCELLED = -7,
+    ERROR_BUSY = -8                    // Too many requests already waiting for the resource (see AdmissionConfig)
+};
+
+/**
+ * @brief Pipeline stage a file is in during ingestion
+ */
+enum class IngestionStage : int32_t {
+    QUEUED = 0,       // Waiting for a worker
+    PARSING = 1,      // Extracting text from the file
+    CHUNKING = 2,     // Splitting text into chunks
+    TOKENIZING = 3,   // SentencePiece tokenization
+    EMBEDDING = 4,    // Embedding model inference
+    STORING = 5,      // SQLite / vector index insertion
+    COMPLETED = 6,    // File fully ingested
+    FAILED = 7,       // File could not be ingested
+    CANCELLED = 8     // Job was cancelled before the file finished
+};
+
+/**
+ * @brief Scheduling class of an ingestion job
+ * A waiting job of a higher class preempts the running one between documents.
+ */
+enum class IngestionPriority : int32_t {
+    BACKGROUND = 0,   // Bulk imports, resumed runs - yields to everything else
+    NORMAL = 1,       // Default
+    INTERACTIVE = 2   // Files the user is waiting on (see LeafraCore::bump_priority)
+};
+
+/**
+ * @brief Per-document limit an ingested file ran into (ParsingConfig::max_* / *_timeout_ms, ChunkingConfig::max_chunks)
+ * The file is then indexed up to the limit, or skipped with ParsingConfig::skip_over_limit.
+ */
+enum class DocumentLimit : int32_t {
+    NONE = 0,           // Within every limit
+    MAX_PAGES = 1,      // More pages than ParsingConfig::max_pages
+    MAX_TEXT = 2,       // More extracted text than ParsingConfig::max_text_mb
+    PAGE_TIME = 3,      // A page took longer than ParsingConfig::page_timeout_ms to extract
+    DOCUMENT_TIME = 4,  // Extraction ran past ParsingConfig::document_timeout_ms
+    MAX_CHUNKS = 5      // More chunks than ChunkingConfig::max_chunks
+};
+
+/**
+ * @brief Structured per-file progress report for ingestion jobs
+ */
+struct LEAFRA_API IngestionProgress {
+    std::string file_path;                 // File this report refers to
+    size_t file_index = 0;                 // Index of the file in the submitted list
+    size_t total_files = 0;                // Number of files in the job
+    IngestionStage stage = IngestionStage::QUEUED;
+    uint64_t bytes = 0;                    // File size on disk
+    size_t chunks = 0;                     // Chunks produced so far for this file
+    double elapsed_ms = 0.0;               // Time spent on this file so far
+    DocumentLimit limit = DocumentLimit::NONE; // Limit the file ran into: partially indexed, or FAILED if skipped
+};
+
+using ingestion_progress_callback_t = std::function<void(const IngestionProgress& progress)>;
+using ingestion_completion_callback_t = std::function<void(ResultCode result)>;
+
+/**
+ * @brief Options for asynchronous ingestion jobs
+ * Callbacks are invoked from SDK worker threads, never from the caller's thread.
+ */
+struct LEAFRA_API IngestionOptions {
+    ingestion_progress_callback_t on_progress;     // Optional per-file progress callback
+    ingestion_completion_callback_t on_complete;   // Optional job completion callback
+    std::string collection;                        // Collection to index the files in ("" = default)
+    IngestionPriority priority = IngestionPriority::NORMAL;  // Scheduling class against other jobs
+};
+
+/**
+ * @brief Phase of a background re-index with another embedding model
+ */
+enum class ReindexPhase : int32_t {
+    IDLE = 0,           // No re-index ran this session
+    EMBEDDING = 1,      // Stored chunks are embedded again; searches and ingestion use the current model
+    SWAPPING = 2,       // Catching up with new chunks and building the new indexes (ingestion waits)
+    DONE = 3,           // The new model and indexes are in use
+    FAILED = 4,         // Stopped on an error; the current model and indexes stay in use
+    CANCELLED = 5       // Cancelled before the swap
+};
+
+/**
+ * @brief Progress of a re-index (LeafraCore::reindex_embeddings_async)
+ */
+struct LEAFRA_API ReindexProgress {
+    ReindexPhase phase = ReindexPhase::IDLE;
+    std::string model_id;                  // Model the corpus is embedded with (see LeafraCore::get_embedding_model_id)
+    int64_t version = 0;                   // index_models version of the new indexes (set once swapped in)
+    size_t total_chunks = 0;               // Chunks stored when the re-index started
+    size_t embedded_chunks = 0;            // Chunks embedded with the new model so far
+    double elapsed_ms = 0.0;
+};
+
+/**
+ * @brief Restricts semantic search to a subset of chunks (every set field must match)
+ * Resolved against the database before searching, then applied inside the FAISS scan.
+ */
+struct LEAFRA_API SearchFilter {
+    std::vector<int64_t> doc_ids;          // Only chunks of these documents (empty = any document)
+    std::string filename_glob;             // SQLite GLOB on the document filename, e.g. "*.pdf" (case sensitive, empty = any)
+    std::string created_after;             // Documents created at or after this "YYYY-MM-DD[ HH:MM:SS]" UTC timestamp (empty = no bound)
+    std::string created_before;            // Documents created before this timestamp (empty = no bound)
+    int32_t page_min = -1;                 // First page, inclusive (-1 = no bound)
+    int32_t page_max = -1;                 // Last page, inclusive (-1 = no bound)
+    
+    bool empty() const {
+        return doc_ids.empty() && filename_glob.empty() && created_after.empty() && created_before.empty() &&
+               page_min < 0 && page_max < 0;
+    }
 };
 
 /**
@@ -120,8 +264,11 @@ struct LEAFRA_API ChunkingConfig {
     double overlap_percentage = 0.15;       // Overlap percentage (0.0 to 1.0)
     bool preserve_word_boundaries = true;   // Whether to avoid breaking words
     bool include_metadata = true;           // Whether to include chunk metadata
-    ChunkSizeUnit size_unit;                // Unit for chunk_size (CHARACTERS = UTF-8 chars, TOKENS = approximate)
+    ChunkSizeUnit size_unit;                // Unit for chunk_size (CHARACTERS = UTF-8 chars, TOKENS = approximate, EXACT_TOKENS = SentencePiece)
     TokenApproximationMethod token_method;  // Token approximation method
+    ChunkingStrategy strategy;              // FIXED = size windows, SENTENCE = whole sentences, headings start chunks
+    size_t parallel_segment_bytes = 256 * 1024; // Documents of at least two segments are indexed on the worker pool (0 = sequential)
+    size_t max_chunks = 0;                  // Chunks indexed per document; later chunks are left out (0 = no limit)
     
     // Debug/Development options for chunk content printing
     bool print_chunks_full = false;         // Print full content of all chunks
@@ -140,20 +287,39 @@ struct LEAFRA_API ChunkingConfig {
  */
 struct LEAFRA_API EmbeddingModelConfig {
     bool enabled = false;                   // Whether to enable embedding model inference
-    std::string framework = "";             // Inference framework ("coreml", "tensorflow_lite", or "tensorflow")
-    std::string model_path = "";            // Path to the model file (.mlmodel/.mlpackage for CoreML, .tflite for TensorFlow Lite)
+    std::string framework = "";             // Inference framework ("coreml", "tensorflow_lite", "tensorflow", "executorch" or "llamacpp")
+    std::string model_path = "";            // Path to the model file (.mlmodel/.mlpackage for CoreML, .tflite for TensorFlow Lite, .pte for ExecuTorch, .gguf for llama.cpp)
+    int32_t batch_size = 32;                // Chunks submitted per inference call (1 = one prediction per chunk)
+    bool normalize_embeddings = true;       // L2-normalize embeddings before they are stored or searched
+    std::string pooling = "mean";           // Reduction of token-level (last hidden state) outputs: "mean", "cls" or "max"; pooled-output models ignore it
+    int32_t pipeline_depth = 2;             // Batches in flight during ingestion: the next batch is prepared while the accelerator runs the current one (1 = no overlap)
+    std::vector<int32_t> sequence_buckets = {64, 128, 256};  // Padded lengths tried on flexible-shape models (the model length is always the last bucket; empty = no bucketing)
+    bool cache_enabled = false;             // Keep chunk embeddings in the embedding_cache table, keyed by model, prefix and chunk text, so identical text is never embedded twice
+    int32_t cache_max_entries = 100000;     // Cache rows kept after each ingestion run, least recently used evicted first (0 = unbounded)
     
     // CoreML specific settings (only used when framework = "coreml")
     std::string coreml_compute_units = "all";      // CoreML compute units: "all", "cpuOnly", "cpuAndGPU", "cpuAndNeuralEngine"
+    bool coreml_cache_compiled = true;             // Compile a .mlmodel/.mlpackage once into Application Support, reused while the model and OS version are unchanged
+    bool coreml_prewarm = false;                   // Run one query-sized prediction on a background thread after loading, so the first query doesn't pay for Neural Engine specialization
+    
+    // Query isolation: a second model instance serves search queries, so they never queue behind ingestion
+    bool query_instance = false;                   // Load the query instance (costs a second copy of the model in memory)
+    std::string query_coreml_compute_units = "cpuAndGPU";  // Compute units of the query instance (leaves the Neural Engine to ingestion)
     
-    // TensorFlow Lite delegate configurations (only used when framework = "tflite")
+    // TensorFlow Lite delegate configurations (only used when framework = "tensorflow_lite")
     bool tflite_enable_coreml_delegate = true;     // Enable CoreML delegate (iOS/macOS only)
     bool tflite_enable_metal_delegate = true;      // Enable Metal GPU delegate (iOS/macOS only)
+    bool tflite_enable_gpu_delegate = false;       // Enable OpenCL/OpenGL GPU delegate (Android only)
     bool tflite_enable_xnnpack_delegate = true;    // Enable XNNPACK CPU delegate (cross-platform)
     
-    // TensorFlow Lite performance settings (only used when framework = "tflite")
+    // TensorFlow Lite performance settings (only used when framework = "tensorflow_lite")
     int32_t tflite_num_threads = -1;               // Number of threads (-1 = auto)
     bool tflite_use_nnapi = false;                 // Use Android NNAPI (Android only)
+    std::string tflite_delegate_cache_dir;         // Writable directory for the GPU delegate's compiled kernels and XNNPACK's packed weights (empty = rebuilt on every load)
+    
+    // ExecuTorch settings (only used when framework = "executorch"; XNNPACK/CoreML/Vulkan delegates are chosen when the .pte is exported)
+    std::string executorch_method = "forward";     // Program method to run
+    int32_t executorch_num_threads = -1;           // CPU threadpool size for XNNPACK and the kernels (-1 = max_threads, or the runtime default)
     
     // Default constructor
     EmbeddingModelConfig() = default;
@@ -161,7 +327,8 @@ struct LEAFRA_API EmbeddingModelConfig {
     // Check if configuration is valid
     bool is_valid() const {
         return enabled && !framework.empty() && !model_path.empty() &&
-               (framework == "coreml" || framework == "tensorflow_lite" || framework == "tensorflow");
+               (framework == "coreml" || framework == "tensorflow_lite" || framework == "tensorflow" ||
+                framework == "executorch" || framework == "llamacpp");
     }
 };
 
@@ -176,21 +343,44 @@ struct LEAFRA_API EmbeddingModelConfig {
 struct LEAFRA_API VectorSearchConfig {
     bool enabled = false;                   // Whether to enable vector search functionality
     int32_t dimension = 384;                // Vector dimension (default for many embedding models)
-    std::string index_type = "HNSW";        // FAISS index type: "FLAT", "IVF_FLAT", "IVF_PQ", "HNSW", "LSH"
+    std::string index_type = "HNSW";        // FAISS index type: "FLAT", "IVF_FLAT", "IVF_PQ", "HNSW", "LSH", "SQ8", "SQ_FP16", "HNSW_SQ", "BINARY" (sign bits, re-scored), "AUTO" (FLAT, migrated to IVF as the corpus grows)
     std::string metric = "COSINE";          // Distance metric: "L2", "INNER_PRODUCT", "COSINE"
+    int32_t index_dimension = 0;            // Leading dimensions kept in the index, re-normalized (Matryoshka truncation, e.g. 128 of 384; 0 = all). Stored embeddings stay full for re-scoring with rerank_factor
     
     // Advanced FAISS configuration
-    int32_t nlist = 100;                    // Number of clusters for IVF indexes (auto-calculated if 0)
+    int32_t nlist = 0;                      // Number of clusters for IVF indexes (auto-calculated from the vector count if 0)
     int32_t nprobe = 10;                    // Number of clusters to search in IVF indexes
     int32_t m = 8;                          // Number of subquantizers for PQ indexes
     int32_t nbits = 8;                      // Bits per subquantizer for PQ indexes
     int32_t hnsw_m = 16;                    // Number of bi-directional links for HNSW
+    int32_t ef_search = 64;                 // HNSW candidate list size at search time (higher = better recall, slower; overridable per query)
     int32_t lsh_nbits = 64;                 // Number of hash bits for LSH
+    int32_t ivf_train_min_vectors = 10000;  // IVF_FLAT/IVF_PQ/SQ8/HNSW_SQ: vectors are kept in a FLAT index until this many exist, then the trained index is swapped in
+    int32_t auto_ivf_threshold = 100000;    // AUTO: vector count at which the FLAT index is trained into auto_ivf_type (flat search gets slow past ~100k on mobile CPUs)
+    std::string auto_ivf_type = "IVF_FLAT"; // Index type AUTO migrates to: "IVF_FLAT", "IVF_PQ", "SQ8" or "HNSW_SQ"
+    int32_t rerank_factor = 0;              // Lossy or reduced indexes (IVF_PQ, SQ8, SQ_FP16, HNSW_SQ, BINARY, index_dimension): fetch k * rerank_factor candidates and re-score them exactly against the stored embeddings (0/1 = off; needs embedding_storage)
+    int32_t binary_rerank_candidates = 256; // BINARY: Hamming candidates re-scored exactly against the stored embeddings, at least (needs embedding_storage)
+    bool gpu_flat_search = false;           // FLAT (and AUTO until it migrates): exact search on the GPU via Metal, on Apple devices (ignored elsewhere)
+    int32_t gpu_min_vectors = 20000;        // Vectors an index needs before its searches go to the GPU (smaller scans are faster on the CPU)
+    int32_t faiss_threads = -1;             // OpenMP threads per FAISS build / batched search (-1 = one per performance core; scaled down by the throughput governor)
+    int32_t bulk_add_vectors = 4096;        // HNSW/HNSW_SQ/IVF: ingested vectors gathered into one parallel index add (flushed after each ingestion run; 0 = add per document)
+    bool hot_index = false;                 // HNSW/HNSW_SQ/IVF: rows queued for the bulk add sit in an in-memory FLAT index, searchable at once, and a background task merges them into the main index
+    int32_t hot_merge_interval_ms = 2000;   // hot_index: how often the background merge runs (it also starts as soon as bulk_add_vectors rows are queued)
+    int32_t document_prefilter = 0;         // Hierarchical search: pick this many documents by centroid (mean chunk embedding) first, then search only their chunks (0 = flat search over all chunks)
+    int32_t exact_scan_max_chunks = 2000;   // Filtered searches (SearchFilter, document_prefilter) admitting at most this many chunks score them exactly in SQLite with vec_dot/vec_l2/vec_cosine instead of searching the index (0 = always the index; needs embedding_storage)
+    int32_t query_batch_size = 8;           // Concurrent searches coalesced into one query embedding inference and one index search (<= 1 = every search alone)
+    int32_t query_batch_window_us = 2000;   // Longest a search waits for others to join its batch, only while another batch is running
     
     // Database storage configuration
     std::string index_definition = "default"; // Definition string for database storage
     bool auto_save = true;                  // Automatically save index to database after building
     bool auto_load = true;                  // Automatically load index from database on initialization
+    int32_t delta_compaction_threshold = 4096; // Delta-logged vectors/removals before the index blob is rewritten (0 = rewrite after every document)
+    std::string index_storage = "database"; // Where the index lives: "database" (blob in the SQLite database) or "file" (standalone .faiss file next to it)
+    bool mmap_index_file = true;            // Memory-map the index file read-only on load ("file" storage; IVF indexes)
+    bool ivf_on_disk_lists = false;         // IVF_FLAT/IVF_PQ ("file" storage): posting lists live in a mapped file next to the database, only the coarse quantizer stays in memory
+    std::string embedding_storage = "fp16"; // Copy of each chunk embedding kept in SQLite for rebuilding the index: "none", "fp32", "fp16", "int8"
+    float tombstone_rebuild_ratio = 0.2f;   // Share of removed-but-stored vectors (IVF/HNSW deletions) that triggers an index rebuild after ingestion (0 = never)
     
     // Default constructor
     VectorSearchConfig() = default;
@@ -203,14 +393,178 @@ struct LEAFRA_API VectorSearchConfig {
     bool is_valid() const {
         return dimension > 0 && 
                (index_type == "FLAT" || index_type == "IVF_FLAT" || index_type == "IVF_PQ" || 
-                index_type == "HNSW" || index_type == "LSH") &&
-               (metric == "L2" || metric == "INNER_PRODUCT" || metric == "COSINE");
+                index_type == "HNSW" || index_type == "LSH" || index_type == "SQ8" || index_type == "SQ_FP16" ||
+                index_type == "HNSW_SQ" || index_type == "BINARY" || index_type == "AUTO") &&
+               (auto_ivf_type == "IVF_FLAT" || auto_ivf_type == "IVF_PQ" || auto_ivf_type == "SQ8" || auto_ivf_type == "HNSW_SQ") &&
+               rerank_factor >= 0 && binary_rerank_candidates >= 0 && gpu_min_vectors >= 0 && bulk_add_vectors >= 0 &&
+               document_prefilter >= 0 && exact_scan_max_chunks >= 0 && query_batch_size >= 0 && query_batch_window_us >= 0 && hot_merge_interval_ms > 0 &&
+               index_dimension >= 0 && index_dimension <= dimension &&
+               ivf_train_min_vectors > 0 && auto_ivf_threshold > 0 &&
+               (metric == "L2" || metric == "INNER_PRODUCT" || metric == "COSINE") &&
+               (index_storage == "database" || index_storage == "file") &&
+               (embedding_storage == "none" || embedding_storage == "fp32" ||
+                embedding_storage == "fp16" || embedding_storage == "int8") &&
+               tombstone_rebuild_ratio >= 0.0f && tombstone_rebuild_ratio <= 1.0f;
     }
     
     // Note: FAISS enum conversion methods are implemented in leafra_core.cpp
     // when LEAFRA_HAS_FAISS is defined and leafra_faiss.h is included
 };
 
+/**
+ * @brief Document parsing configuration
+ */
+struct LEAFRA_API ParsingConfig {
+    int32_t pdf_parallel_min_pages = 0;     // PDFs with at least this many pages are extracted on several document handles at once (0 = always sequential)
+    int32_t pdf_max_document_handles = 4;   // Max document handles (page ranges) open for one PDF in parallel mode
+    bool pdf_strip_boilerplate = true;      // Remove headers, footers and page numbers repeated across PDF pages before chunking
+    float pdf_boilerplate_min_ratio = 0.6f; // Share of pages a header/footer line must appear on to be removed
+    int32_t pdf_boilerplate_min_pages = 4;  // PDFs with fewer pages are left alone
+    int32_t pdf_boilerplate_edge_lines = 3; // Lines checked at the top and at the bottom of each page
+    int32_t text_page_bytes = 256 * 1024;   // Synthetic page size for text files, cut at a heading or line break (0 = one page per file)
+    int32_t sheet_page_bytes = 256 * 1024;  // Page size for spreadsheet sheets and CSV files, cut at a row boundary (0 = one page per sheet/file)
+    bool cache_enabled = false;             // Keep parsed page text on disk keyed by file content hash, so re-indexing skips parsing unchanged files
+    int32_t cache_max_mb = 512;             // Parse cache size limit; least recently used entries are evicted after each ingestion run (0 = unlimited)
+    bool normalize_text = false;            // Clean up page text before chunking (the normalize_* switches below pick the steps)
+    bool normalize_nfkc = true;             // Unicode NFKC: ligatures, full-width forms, NBSP and other compatibility characters (needs ICU)
+    bool normalize_whitespace = true;       // Collapse runs of spaces/tabs, drop spaces around line breaks, keep at most one blank line
+    bool normalize_dehyphenate = true;      // Join words hyphenated at a line break ("exam-\nple" -> "example") when the next line starts lowercase
+    bool normalize_strip_control = true;    // Drop control characters, zero-width spaces and BOMs; CR/CRLF/FF/VT become line breaks
+    int32_t max_pages = 0;                  // Pages extracted per document; later pages are left out (0 = no limit)
+    int32_t max_text_mb = 0;                // Extracted text per document; pages past the limit are left out (0 = no limit)
+    int32_t page_timeout_ms = 0;            // A page taking longer to extract ends the document's extraction after it (0 = no limit)
+    int32_t document_timeout_ms = 0;        // Extraction time per document; no page is started once it has passed (0 = no limit)
+    bool skip_over_limit = false;           // A document hitting a limit (including ChunkingConfig::max_chunks) is skipped instead of partially indexed
+    
+    // Default constructor
+    ParsingConfig() = default;
+};
+
+/**
+ * @brief Query caching configuration for semantic search
+ */
+struct LEAFRA_API SearchCacheConfig {
+    bool enabled = true;                    // Cache query embeddings (keyed by normalized query text, model and prefix)
+    int32_t embedding_capacity = 256;       // Max cached query embeddings (least recently used are evicted)
+    bool cache_results = false;             // Also cache top-k search results until the FAISS index changes
+    int32_t result_capacity = 64;           // Max cached result lists (least recently used are evicted)
+    bool cache_answers = false;             // Reuse generated RAG answers when a question retrieves the same chunks and its embedding is this close to a cached one
+    float answer_similarity = 0.95f;        // Minimum cosine similarity between query embeddings for a cached answer to be reused
+    int32_t answer_capacity = 32;           // Max cached chunk sets with answers (least recently used are evicted)
+    
+    // Default constructor
+    SearchCacheConfig() = default;
+};
+
+/**
+ * @brief Hybrid (BM25 keyword + vector) retrieval configuration
+ */
+struct LEAFRA_API HybridSearchConfig {
+    int32_t rrf_k = 60;                     // Reciprocal rank fusion constant (higher flattens the weight of top ranks)
+    int32_t candidate_multiplier = 4;       // Candidates taken from each retriever per requested result
+    
+    // Default constructor
+    HybridSearchConfig() = default;
+};
+
+/**
+ * @brief Re-rank stage between retrieval and generation in semantic_search_with_llm
+ */
+struct LEAFRA_API RerankConfig {
+    bool enabled = false;                   // Score retrieved chunks with the LLM and keep only the best for the prompt
+    int32_t candidate_multiplier = 3;       // Candidates retrieved per requested result before re-ranking
+    int32_t max_passage_tokens = 256;       // Tokens of each chunk the scorer reads (longer chunks are truncated)
+    
+    // Default constructor
+    RerankConfig() = default;
+};
+
+/**
+ * @brief De-duplication of the chunks semantic_search_with_llm puts into the prompt
+ */
+struct LEAFRA_API DiversityConfig {
+    bool mmr_enabled = false;               // Pick chunks by maximal marginal relevance so near-duplicates don't crowd the context
+    float mmr_lambda = 0.7f;                // Relevance vs. novelty trade-off (1 = pure relevance, 0 = pure novelty)
+    int32_t candidate_multiplier = 3;       // Candidates MMR chooses from per chunk it keeps
+    bool merge_adjacent = false;            // Merge consecutive chunks of the same document into one span (overlap included once)
+    int32_t max_span_chunks = 4;            // Most chunks merged into one span
+    
+    // Default constructor
+    DiversityConfig() = default;
+};
+
+/**
+ * @brief Extractive compression of the context semantic_search_with_llm puts into the prompt
+ */
+struct LEAFRA_API PromptCompressionConfig {
+    bool enabled = false;                   // Keep only the sentences of the retrieved chunks closest to the question (needs the embedding model)
+    int32_t max_context_tokens = 512;       // LLM tokens the kept sentences of all chunks may take (context under this is left alone)
+    int32_t min_sentences_per_chunk = 1;    // Best sentences every chunk keeps regardless of the budget, so each cited source stays in the prompt
+    
+    // Default constructor
+    PromptCompressionConfig() = default;
+};
+
+/**
+ * @brief Near-duplicate chunk detection at ingestion (SimHash fingerprints in an LSH table)
+ */
+struct LEAFRA_API NearDuplicateConfig {
+    bool enabled = false;                   // Fingerprint new chunks and look for near-identical chunks already stored
+    std::string policy = "reuse";           // "reuse": take the match's stored embedding instead of running the model; "skip": don't store the chunk
+    int32_t max_distance = 3;               // Max differing fingerprint bits (of 64) for two chunks to count as near-duplicates
+    int32_t shingle_words = 3;              // Consecutive words per shingle
+    int32_t min_chars = 200;                // Shorter chunks are never matched (too little text for a reliable fingerprint)
+    
+    // Default constructor
+    NearDuplicateConfig() = default;
+    
+    bool isValid() const {
+        return (policy == "reuse" || policy == "skip") && max_distance >= 0 && max_distance <= 15 && shingle_words > 0;
+    }
+};
+
+/**
+ * @brief Pre-embedding chunk quality filter (chunks failing a threshold are neither embedded nor stored)
+ */
+struct LEAFRA_API ChunkQualityConfig {
+    bool enabled = false;                   // Score chunks after tokenization and leave out the ones that fail
+    int32_t min_chars = 32;                 // Fewer non-whitespace characters than this fails (page numbers, stray headings)
+    float min_alpha_ratio = 0.5f;           // Smaller share of letters among non-whitespace characters fails (dot leaders, number tables, OCR noise)
+    float max_tokens_per_byte = 0.45f;      // More tokens per UTF-8 byte fails (base64, hashes, OCR garbage; prose is ~0.25; 0 = no limit)
+    float min_entropy = 2.5f;               // Lower bits of entropy over the ASCII characters fails (rulers, repeated symbols)
+    float max_entropy = 5.5f;               // Higher entropy fails (base64 and random strings approach 6 bits; prose is ~4.5; 0 = no limit)
+    
+    // Default constructor
+    ChunkQualityConfig() = default;
+};
+
+/**
+ * @brief Thermal / battery-aware throttling of ingestion, embedding and LLM throughput
+ */
+struct LEAFRA_API GovernorConfig {
+    bool enabled = true;                    // Scale throughput down when the device is hot, in low-power mode or on a low battery
+    int32_t poll_interval_ms = 5000;        // Minimum time between power state samples
+    int32_t low_battery_percent = 20;       // At or below this charge (not charging) throughput is halved
+    int32_t interactive_ingest_workers = 1; // Documents prepared concurrently while a search or generation runs (0 = pause ingestion)
+    
+    // Default constructor
+    GovernorConfig() = default;
+};
+
+/**
+ * @brief Bounded concurrency per resource, with interactive requests admitted ahead of ingestion
+ */
+struct LEAFRA_API AdmissionConfig {
+    bool enabled = true;                    // Queue calls beyond each resource's slots (false = every call runs at once)
+    int32_t max_concurrent_embeddings = 1;  // Embedding model calls in flight: query embeds and ingestion batches (0 = unbounded)
+    int32_t max_concurrent_searches = 4;    // Vector index searches in flight (0 = unbounded)
+    int32_t max_concurrent_generations = 1; // LLM answers in flight (0 = unbounded)
+    int32_t max_queued_requests = 32;       // Searches / generations waiting per resource before new ones fail with ERROR_BUSY (0 = no limit)
+    
+    // Default constructor
+    AdmissionConfig() = default;
+};
+
 /**
  * @brief General LLM (Large Language Model) configuration for the SDK
  */
@@ -218,14 +572,19 @@ struct LEAFRA_API LLMConfig {
     bool enabled = false;                   // Whether to enable LLM functionality
     std::string model_path = "";            // Path to the LLM model file
     std::string framework = "llamacpp";     // LLM framework: "llamacpp", "ollama", etc.
+    std::string draft_model_path = "";      // Small model with the same vocabulary for speculative decoding (empty = off)
+    int32_t n_draft = 5;                    // Tokens the draft model (or prompt lookup) proposes per verification step
+    int32_t lookup_ngram = 0;               // Without a draft model: draft the tokens that followed the last match of the context's final n-gram, up to this long (0 = off)
     
     // Context and processing parameters
     int32_t n_ctx = 4096;                  // Maximum context length in tokens
     int32_t n_predict = 128;               // Maximum tokens to generate per request
+    int32_t max_context_tokens = 0;        // Token budget for retrieved chunks in RAG prompts (0 = whatever n_ctx leaves after the prompt and n_predict)
     int32_t n_batch = 512;                 // Batch size for processing
     int32_t n_ubatch = 512;                // Physical batch size for prompt processing
     int32_t n_threads = -1;                // Number of threads (-1 = auto-detect)
     int32_t n_threads_batch = -1;          // Number of threads for batch processing (-1 = auto)
+    int32_t n_seq_max = 1;                 // Parallel sequences in the context (re-ranking scores this many passages per decode; they share n_ctx)
     
     // Generation parameters
     float temperature = 0.8f;              // Sampling temperature (0.0 = deterministic, higher = more random)
@@ -240,16 +599,33 @@ struct LEAFRA_API LLMConfig {
     float typical_p = 1.0f;                // Typical sampling (1.0 = disabled)
     
     // Performance and hardware parameters
-    int32_t n_gpu_layers = 32;             // TODO AD: How to set this automatically? Number of layers to offload to GPU (-1 = auto, 0 = CPU only)
+    int32_t n_gpu_layers = -1;             // Number of layers to offload to GPU (-1 = auto: as many as fit in GPU memory, 0 = CPU only)
+    int32_t gpu_memory_margin_mb = 512;    // With n_gpu_layers = -1, GPU memory left free for the rest of the app
     bool use_mmap = true;                  // Use memory mapping for model loading (faster startup)
     bool use_mlock = false;                // Lock model in RAM (prevents swapping)
     bool numa = false;                     // Enable NUMA optimization
+    std::string type_k = "f16";            // KV cache type for keys: "f16", "q8_0" (half the memory) or "q4_0" (a quarter)
+    std::string type_v = "f16";            // KV cache type for values: "f16", "q8_0" or "q4_0" (quantized values need flash_attn)
+    bool flash_attn = false;               // Use flash attention (faster on long prompts; required for a quantized V cache)
     
     // System configuration
     std::string system_prompt = "";        // System prompt to use for conversations
     int32_t seed = -1;                     // Random seed for reproducible outputs (-1 = random)
     bool debug_mode = false;               // Enable debug output
     bool verbose_prompt = false;           // Print prompt before generation
+    bool embeddings = false;               // Create the context with embedding output (embedding backends only)
+    bool reuse_prompt_cache = true;        // Keep the evaluated prompt in the KV cache and only evaluate where the next prompt diverges
+    bool prefill_during_retrieval = true;  // semantic_search_with_llm evaluates the prompt's fixed prefix (system prompt, template) while retrieval runs (needs reuse_prompt_cache)
+    bool cache_chunk_tokens = false;       // Store each chunk's LLM tokenization at ingest so RAG prompts reuse it instead of tokenizing retrieved chunks (needs the LLM loaded while ingesting)
+    int32_t hot_chunk_cache_size = 0;      // KV states kept for RAG prompts led by a frequently retrieved chunk, restored instead of evaluating head and chunk again (0 = off; needs reuse_prompt_cache)
+    int32_t hot_chunk_min_retrievals = 3;  // Times a chunk must lead a RAG prompt before its KV state is kept
+    bool context_shift = true;             // When n_ctx fills, discard the oldest tokens after n_keep instead of failing
+    int32_t n_keep = 0;                    // Tokens at the start never discarded by context shifting (0 = the system prompt)
+    bool warmup = false;                   // Run a one-token decode after loading (pages in weights, compiles GPU kernels)
+    int32_t idle_unload_seconds = 0;       // Unload the model after this long without a request (0 = stay resident); the next request reloads it
+    std::string low_memory_model_path = ""; // Smaller model swapped in on memory pressure (empty = unload instead)
+    int32_t stream_flush_ms = 0;           // Coalesce streamed tokens and deliver them from a separate thread at most this often (0 = each token, on the decode thread)
+    int32_t stream_flush_tokens = 16;      // With stream_flush_ms, also deliver once this many tokens are waiting (0 = time only)
     
     // Default constructor
     LLMConfig() = default;
@@ -261,11 +637,18 @@ struct LEAFRA_API LLMConfig {
     // Check if configuration is valid
     bool is_valid() const {
         return enabled && !model_path.empty() && !framework.empty() &&
-               n_ctx > 0 && n_predict > 0 && n_batch > 0 && n_ubatch > 0 &&
+               n_ctx > 0 && n_predict > 0 && n_batch > 0 && n_ubatch > 0 && n_seq_max > 0 && n_draft >= 0 && lookup_ngram >= 0 && n_keep >= 0 && max_context_tokens >= 0 && idle_unload_seconds >= 0 &&
+               hot_chunk_cache_size >= 0 && hot_chunk_min_retrievals > 0 && stream_flush_ms >= 0 && stream_flush_tokens >= 0 && gpu_memory_margin_mb >= 0 &&
+               is_kv_cache_type(type_k) && is_kv_cache_type(type_v) && (type_v == "f16" || flash_attn) &&
                temperature >= 0.0f && top_p > 0.0f && top_p <= 1.0f &&
                repeat_penalty > 0.0f && min_p >= 0.0f && min_p <= 1.0f;
     }
     
+    // KV cache types understood by type_k and type_v
+    static bool is_kv_cache_type(const std::string& type) {
+        return type == "f16" || type == "q8_0" || type == "q4_0";
+    }
+    
     // Helper method to get model filename from path
     std::string get_model_filename() const {
         size_t pos = model_path.find_last_of("/\\");
@@ -273,18 +656,104 @@ struct LEAFRA_API LLMConfig {
     }
 };
 
+/**
+ * @brief SQLite connection profile applied whenever the document database is opened
+ *
+ * Defaults favour mobile: WAL lets searches read while an import writes, NORMAL sync
+ * skips the per-commit fsync that WAL makes unnecessary for durability of the database.
+ */
+struct LEAFRA_API DatabaseConfig {
+    std::string journal_mode = "WAL";       // "WAL", "DELETE", "TRUNCATE", "PERSIST", "MEMORY", "OFF" (empty = SQLite default)
+    std::string synchronous = "NORMAL";     // "OFF", "NORMAL", "FULL", "EXTRA" (empty = SQLite default)
+    int32_t cache_size_kib = 8192;          // Page cache per connection in KiB (0 = SQLite default)
+    int64_t mmap_size = 64 * 1024 * 1024;   // Bytes of the database file read through mmap (0 = disabled)
+    std::string temp_store = "MEMORY";      // "DEFAULT", "FILE", "MEMORY"
+    int32_t page_size = 4096;               // Page size in bytes - only takes effect for new databases (0 = SQLite default)
+    int32_t busy_timeout_ms = 5000;         // How long to wait on a locked database before failing (0 = fail immediately)
+    int32_t statement_cache_size = 32;      // Idle prepared statements kept per connection, keyed by SQL (0 = no caching)
+    int32_t read_connections = 2;           // Read-only connections searches borrow, WAL mode only (0 = searches share the writer)
+    int32_t backup_pages_per_step = 256;    // Pages an online backup copies per step (0 = all in one step)
+    int32_t backup_step_pause_ms = 5;       // Pause between online backup steps, so ingestion and searches get the database
+    std::string auto_vacuum = "INCREMENTAL"; // New databases only: "NONE", "FULL", "INCREMENTAL" (empty = SQLite default)
+    int32_t vacuum_pages_per_slice = 256;   // Free pages one idle-time incremental_vacuum slice returns to the OS (0 = no background vacuum)
+    int32_t vacuum_idle_ms = 5000;          // Quiet time after ingestion or a search before vacuum slices run
+    double vacuum_min_free_ratio = 0.1;     // Share of the file on the freelist that starts idle-time vacuuming
+    std::string chunk_text_compression = "none"; // Per-row compression of new chunk text (chunks.chunk_text or doc_texts pages): "none", "lz4" (rows that don't shrink stay TEXT)
+    std::string chunk_text_storage = "copy"; // "copy": each chunk row holds its text; "offsets": each document's text is stored once in doc_texts pages and chunks keep byte ranges into it
+    int32_t doc_text_page_bytes = 16384;    // Size of the doc_texts pages "offsets" storage splits a document's text into
+    int32_t group_commit_documents = 16;    // Documents an ingestion run stores per transaction, on a dedicated writer thread (0 or 1 = commit each inline)
+    int32_t group_commit_delay_ms = 250;    // Longest a stored document waits for its group to commit
+    
+    // Default constructor
+    DatabaseConfig() = default;
+    
+    // Check if configuration is valid
+    bool is_valid() const {
+        auto one_of = [](const std::string& value, std::initializer_list<const char*> options) {
+            if (value.empty()) return true;
+            for (const char* option : options) {
+                if (value == option) return true;
+            }
+            return false;
+        };
+        return one_of(journal_mode, {"WAL", "DELETE", "TRUNCATE", "PERSIST", "MEMORY", "OFF"}) &&
+               one_of(synchronous, {"OFF", "NORMAL", "FULL", "EXTRA"}) &&
+               one_of(temp_store, {"DEFAULT", "FILE", "MEMORY"}) &&
+               one_of(auto_vacuum, {"NONE", "FULL", "INCREMENTAL"}) &&
+               one_of(chunk_text_compression, {"none", "lz4"}) &&
+               one_of(chunk_text_storage, {"copy", "offsets"}) && doc_text_page_bytes > 0 &&
+               group_commit_documents >= 0 && group_commit_delay_ms >= 0 &&
+               cache_size_kib >= 0 && mmap_size >= 0 && busy_timeout_ms >= 0 && statement_cache_size >= 0 && read_connections >= 0 &&
+               backup_pages_per_step >= 0 && backup_step_pause_ms >= 0 &&
+               vacuum_pages_per_slice >= 0 && vacuum_idle_ms >= 0 && vacuum_min_free_ratio >= 0.0 && vacuum_min_free_ratio <= 1.0 &&
+               (page_size == 0 || (page_size >= 512 && page_size <= 65536 && (page_size & (page_size - 1)) == 0));
+    }
+};
+
 // Configuration structure
 struct LEAFRA_API Config {
     std::string name;
     std::string version;
     bool debug_mode = false;
-    int32_t max_threads = 4;
+    bool async_logging = false;            // Write log messages from a background thread so logging workers never wait on each other
+    int32_t log_queue_capacity = 4096;     // Async log queue slots
+    bool log_drop_when_full = true;        // Full async log queue: drop messages (true) or make the logging thread wait (false)
+    bool async_events = false;             // Deliver event callbacks from a dispatcher thread so a slow consumer can't stall ingestion
+    int32_t event_queue_capacity = 1024;   // Undelivered events buffered in async mode (full: progress events are dropped, others wait)
+    bool coalesce_progress_events = true;  // Async mode: a queued INGESTION_PROGRESS event is replaced by the next one
+    bool trace_enabled = false;            // Record a span timeline from initialize() on (export with LeafraCore::stop_trace)
+    int32_t trace_max_events_per_thread = 262144; // Spans kept per thread before further ones are dropped
+    int32_t memory_budget_mb = 0;          // Soft cap on tracked memory (get_metrics().memory): the excess is reclaimed, caches first (0 = no budget)
+    int32_t max_threads = 4;               // Worker pool size (<= 0 uses all hardware threads)
+    int32_t query_threads = 0;             // Query fan-out pool size (<= 0 uses the performance cores minus the calling thread)
+    int32_t ingestion_queue_depth = 4;     // Max prepared documents buffered ahead of the embedding stage
+    int32_t watch_debounce_ms = 500;       // watch_directory: quiet period before changed files are queued for indexing
+    bool background_load = false;          // Load the embedding model and LLM on background threads (initialize returns before they are ready)
+    bool prefetch_after_initialize = false; // Warm the page cache (model files, mmapped indexes) and the most retrieved chunks in the background after initialize
+    int32_t prefetch_hot_chunks = 256;     // Most retrieved chunks loaded and searched by the warm-up (0 = page cache only)
+    std::string icu_data_path;             // Trimmed ICU data bundle (.dat), mapped on the first text that needs ICU data (empty = the linked data)
+    std::string large_pages = "off";       // Huge page backing for FAISS storage, rebuild matrices and mmapped models: "off", "transparent" (madvise) or "explicit" (reserved pages, Linux/Android)
     size_t buffer_size = 1024;
     std::string leafra_document_database_name = "leafra.db"; // Document database filename
+    std::string storage_directory;         // Absolute directory the database and index files live in, e.g. an iOS app group container extensions also open (empty = app storage)
+    bool attach_read_only = false;         // Search a store another process writes: nothing is ingested or saved, the writer's commits are picked up between searches
+    int32_t attach_refresh_interval_ms = 1000; // attach_read_only: least time between checks for the writer's commits
+    std::string device_profile_name = "leafra_device_profile.txt"; // LeafraCore::autotune() result in app storage, applied by initialize (empty = not saved or applied)
+    DatabaseConfig database;               // SQLite connection profile for the document database
+    ParsingConfig parsing;                 // Document parsing configuration
     ChunkingConfig chunking;               // Chunking configuration
     TokenizerConfig tokenizer;             // Tokenization configuration
     EmbeddingModelConfig embedding_inference; // Embedding model inference configuration
     VectorSearchConfig vector_search;       // Vector search configuration
+    SearchCacheConfig search_cache;         // Query embedding / search result caching
+    HybridSearchConfig hybrid_search;       // Keyword + vector result fusion
+    RerankConfig rerank;                    // LLM re-ranking of retrieved context
+    DiversityConfig diversity;              // MMR / adjacent-chunk merging of retrieved context
+    PromptCompressionConfig compression;    // Sentence-level pruning of retrieved context before prefill
+    NearDuplicateConfig near_duplicates;    // Near-duplicate chunk detection at ingestion
+    ChunkQualityConfig chunk_quality;       // Pre-embedding filter for chunks without retrievable text
+    GovernorConfig governor;                // Thermal / battery-aware throughput throttling
+    AdmissionConfig admission;              // Per-resource concurrency limits and priority lanes
     LLMConfig llm;                         // Large Language Model configuration
 };
 
@@ -335,17 +804,29 @@ enum class EventType : int32_t {
     INITIALIZATION_COMPLETE = 0,
     DATA_PROCESSED = 1,
     ERROR_OCCURRED = 2,
+    WARNING = 3,                // Recoverable problem (unsupported file, empty document, ...)
+    INGESTION_STARTED = 4,      // Files submitted for processing
+    INGESTION_PROGRESS = 5,     // Per-file pipeline step; may be coalesced (Config::coalesce_progress_events)
+    DOCUMENT_STORED = 6,        // A document and its chunks were written
+    INGESTION_COMPLETE = 7,     // Summary of an ingestion run
+    INDEX_UPDATED = 8,          // FAISS index created, restored, extended, migrated or rebuilt
+    DATABASE_STATUS = 9,        // Document database created / opened
+    LLM_STATUS = 10,            // LLM generation finished, model unloaded / reloaded / swapped
+    SHUTDOWN_COMPLETE = 11,
     CUSTOM_EVENT = 100
 };
 
 struct Event {
     EventType type;
     std::string message;
-    int64_t timestamp;
+    int64_t timestamp;          // Milliseconds since the Unix epoch, set when the event is raised
     data_buffer_t data;
+    std::string file_path;      // File the event is about (empty if none)
     
     Event(EventType t, const std::string& msg) 
         : type(t), message(msg), timestamp(0) {}
+    Event(EventType t, std::string msg, std::string path, int64_t time)
+        : type(t), message(std::move(msg)), timestamp(time), file_path(std::move(path)) {}
 };
 
 // Smart pointer aliases
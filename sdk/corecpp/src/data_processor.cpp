@@ -1,9 +1,257 @@
 #include "leafra/data_processor.h"
+#include "leafra/leafra_simd.h"
 #include <algorithm>
-#include <numeric>
+#include <array>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LEAFRA_BYTES_NEON 1
+#elif defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define LEAFRA_BYTES_SSE2 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#define LEAFRA_TARGET_SSSE3
+#else
+// pshufb is SSSE3; only the compress kernel is built for it, behind a CPU check
+#define LEAFRA_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#endif
 
 namespace leafra {
 
+namespace {
+
+// The kernels below write out[i] only after reading in[i] and never write ahead of the
+// input position, so out == in is fine for every one of them
+
+void transform_scalar(const byte_t* in, size_t size, byte_t* out) {
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = static_cast<byte_t>(in[i] + 1);
+    }
+}
+
+byte_t accumulate_scalar(const byte_t* in, size_t size, byte_t* out, byte_t sum) {
+    for (size_t i = 0; i < size; ++i) {
+        sum = static_cast<byte_t>(sum + in[i]);
+        out[i] = sum;
+    }
+    return sum;
+}
+
+// Branchless: every byte is stored, the output position only advances past kept ones
+size_t filter_scalar(const byte_t* in, size_t size, byte_t* out, byte_t threshold) {
+    size_t kept = 0;
+    for (size_t i = 0; i < size; ++i) {
+        const byte_t value = in[i];
+        out[kept] = value;
+        kept += value >= threshold;
+    }
+    return kept;
+}
+
+#if defined(LEAFRA_BYTES_SSE2) || defined(LEAFRA_BYTES_NEON)
+// Shuffle indices moving the bytes an 8-bit keep mask selects to the front of 8 bytes
+struct CompressTable {
+    std::array<std::array<byte_t, 8>, 256> shuffles;
+    std::array<byte_t, 256> counts;
+    
+    CompressTable() {
+        for (size_t mask = 0; mask < 256; ++mask) {
+            size_t kept = 0;
+            for (size_t bit = 0; bit < 8; ++bit) {
+                if (mask & (size_t(1) << bit)) {
+                    shuffles[mask][kept++] = static_cast<byte_t>(bit);
+                }
+            }
+            counts[mask] = static_cast<byte_t>(kept);
+            for (size_t rest = kept; rest < 8; ++rest) {
+                shuffles[mask][rest] = 0x80;    // Zero fill; those bytes are overwritten next or dropped
+            }
+        }
+    }
+};
+
+const CompressTable& compress_table() {
+    static const CompressTable table;
+    return table;
+}
+#endif
+
+#ifdef LEAFRA_BYTES_SSE2
+size_t transform(const byte_t* in, size_t size, byte_t* out) {
+    const __m128i one = _mm_set1_epi8(1);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi8(values, one));
+    }
+    transform_scalar(in + i, size - i, out + i);
+    return size;
+}
+
+byte_t accumulate(const byte_t* in, size_t size, byte_t* out, byte_t sum) {
+    __m128i carry = _mm_set1_epi8(static_cast<char>(sum));
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        // Log-step prefix sum inside the register, then the previous block's total on top
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        values = _mm_add_epi8(values, _mm_slli_si128(values, 1));
+        values = _mm_add_epi8(values, _mm_slli_si128(values, 2));
+        values = _mm_add_epi8(values, _mm_slli_si128(values, 4));
+        values = _mm_add_epi8(values, _mm_slli_si128(values, 8));
+        values = _mm_add_epi8(values, carry);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), values);
+        // Broadcast byte 15 for the next block
+        carry = _mm_unpackhi_epi8(values, values);
+        carry = _mm_shufflehi_epi16(carry, _MM_SHUFFLE(3, 3, 3, 3));
+        carry = _mm_unpackhi_epi64(carry, carry);
+    }
+    if (i > 0) {
+        sum = out[i - 1];
+    }
+    return accumulate_scalar(in + i, size - i, out + i, sum);
+}
+
+LEAFRA_TARGET_SSSE3 size_t filter_ssse3(const byte_t* in, size_t size, byte_t* out, byte_t threshold) {
+    const CompressTable& table = compress_table();
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(threshold));
+    size_t kept = 0;
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Unsigned values >= threshold: max(values, threshold) == values
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(values, limit), values));
+        if (mask == 0xFFFF) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + kept), values);
+            kept += 16;
+            continue;
+        }
+        if (mask == 0) {
+            continue;
+        }
+        // Each half is compressed with its own shuffle and stored as 8 bytes; kept <= i, so the
+        // stores stay inside the bytes already read
+        const __m128i low = _mm_shuffle_epi8(values, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(table.shuffles[mask & 0xFF].data())));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + kept), low);
+        kept += table.counts[mask & 0xFF];
+        const __m128i high = _mm_shuffle_epi8(_mm_srli_si128(values, 8), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(table.shuffles[mask >> 8].data())));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + kept), high);
+        kept += table.counts[mask >> 8];
+    }
+    return kept + filter_scalar(in + i, size - i, out + kept, threshold);
+}
+
+size_t filter(const byte_t* in, size_t size, byte_t* out, byte_t threshold) {
+    // Every CPU with AVX2 has SSSE3; older ones keep the branchless loop
+    static const bool has_ssse3 = simd::detected_isa() != simd::Isa::SCALAR;
+    return has_ssse3 ? filter_ssse3(in, size, out, threshold) : filter_scalar(in, size, out, threshold);
+}
+#elif defined(LEAFRA_BYTES_NEON)
+size_t transform(const byte_t* in, size_t size, byte_t* out) {
+    const uint8x16_t one = vdupq_n_u8(1);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        vst1q_u8(out + i, vaddq_u8(vld1q_u8(in + i), one));
+    }
+    transform_scalar(in + i, size - i, out + i);
+    return size;
+}
+
+byte_t accumulate(const byte_t* in, size_t size, byte_t* out, byte_t sum) {
+    const uint8x16_t zero = vdupq_n_u8(0);
+    uint8x16_t carry = vdupq_n_u8(sum);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        // vextq_u8(zero, values, 16 - k) shifts the lanes up by k, zero filled
+        uint8x16_t values = vld1q_u8(in + i);
+        values = vaddq_u8(values, vextq_u8(zero, values, 15));
+        values = vaddq_u8(values, vextq_u8(zero, values, 14));
+        values = vaddq_u8(values, vextq_u8(zero, values, 12));
+        values = vaddq_u8(values, vextq_u8(zero, values, 8));
+        values = vaddq_u8(values, carry);
+        vst1q_u8(out + i, values);
+        carry = vdupq_n_u8(vgetq_lane_u8(values, 15));
+    }
+    if (i > 0) {
+        sum = out[i - 1];
+    }
+    return accumulate_scalar(in + i, size - i, out + i, sum);
+}
+
+size_t filter(const byte_t* in, size_t size, byte_t* out, byte_t threshold) {
+    static const uint8_t kBits[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+    const CompressTable& table = compress_table();
+    const uint8x8_t limit = vdup_n_u8(threshold);
+    const uint8x8_t bits = vld1_u8(kBits);
+    size_t kept = 0;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        const uint8x8_t values = vld1_u8(in + i);
+        // Keep mask as one bit per lane
+        const uint8x8_t selected = vand_u8(vcge_u8(values, limit), bits);
+        uint8x8_t folded = vpadd_u8(selected, selected);
+        folded = vpadd_u8(folded, folded);
+        folded = vpadd_u8(folded, folded);
+        const uint8_t mask = vget_lane_u8(folded, 0);
+        // kept <= i, so the 8-byte store stays inside the bytes already read
+        vst1_u8(out + kept, vtbl1_u8(values, vld1_u8(table.shuffles[mask].data())));
+        kept += table.counts[mask];
+    }
+    return kept + filter_scalar(in + i, size - i, out + kept, threshold);
+}
+#else
+size_t transform(const byte_t* in, size_t size, byte_t* out) {
+    transform_scalar(in, size, out);
+    return size;
+}
+
+byte_t accumulate(const byte_t* in, size_t size, byte_t* out, byte_t sum) {
+    return accumulate_scalar(in, size, out, sum);
+}
+
+size_t filter(const byte_t* in, size_t size, byte_t* out, byte_t threshold) {
+    return filter_scalar(in, size, out, threshold);
+}
+#endif
+
+// One block (or a whole buffer) through the chosen kernel; sum carries ACCUMULATE between blocks
+ResultCode run(const byte_t* in, size_t size, byte_t* out, size_t& output_size,
+               const ProcessingOptions& options, byte_t& sum) {
+    switch (options.algorithm) {
+        case ProcessingAlgorithm::SIMPLE_TRANSFORM:
+            output_size = transform(in, size, out);
+            return ResultCode::SUCCESS;
+        
+        case ProcessingAlgorithm::REVERSE:
+            if (in == out) {
+                std::reverse(out, out + size);
+            } else {
+                std::reverse_copy(in, in + size, out);
+            }
+            output_size = size;
+            return ResultCode::SUCCESS;
+        
+        case ProcessingAlgorithm::ACCUMULATE:
+            sum = accumulate(in, size, out, sum);
+            output_size = size;
+            return ResultCode::SUCCESS;
+        
+        case ProcessingAlgorithm::FILTER:
+            output_size = filter(in, size, out, options.threshold);
+            return ResultCode::SUCCESS;
+        
+        default:
+            return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+}
+
+// Output must be the input itself or apart from it: REVERSE and the wide stores assume one or the other
+bool overlaps(const byte_t* input, const byte_t* output, size_t size) {
+    return input != output && output < input + size && input < output + size;
+}
+
+} // namespace
+
 DataProcessor::DataProcessor() = default;
 
 DataProcessor::~DataProcessor() = default;
@@ -14,75 +262,90 @@ ResultCode DataProcessor::initialize() {
 }
 
 ResultCode DataProcessor::process(const data_buffer_t& input, data_buffer_t& output) {
+    ProcessingOptions options;
+    options.algorithm = ProcessingAlgorithm::SIMPLE_TRANSFORM;
+    return process_advanced(input, output, options);
+}
+
+ResultCode DataProcessor::process_advanced(const data_buffer_t& input,
+                                         data_buffer_t& output,
+                                         const ProcessingOptions& options) {
     if (input.empty()) {
         return ResultCode::ERROR_INVALID_PARAMETER;
     }
     
     try {
-        // Simple data processing example: apply a transformation to each byte
-        output.clear();
-        output.reserve(input.size());
-        
-        // Example transformation: apply a simple filter/transformation
-        for (size_t i = 0; i < input.size(); ++i) {
-            byte_t processed_byte = static_cast<byte_t>((input[i] + 1) % 256);
-            output.push_back(processed_byte);
+        if (&input == &output) {
+            return process_in_place(output, options);
         }
-        
-        return ResultCode::SUCCESS;
-        
+        // resize() keeps the capacity of a reused output buffer
+        output.resize(input.size());
+        size_t output_size = 0;
+        ResultCode result = process(input.data(), input.size(), output.data(), output_size, options);
+        output.resize(result == ResultCode::SUCCESS ? output_size : 0);
+        return result;
+    
     } catch (const std::exception&) {
         return ResultCode::ERROR_PROCESSING_FAILED;
     }
 }
 
-ResultCode DataProcessor::process_advanced(const data_buffer_t& input, 
-                                         data_buffer_t& output,
-                                         const ProcessingOptions& options) {
-    if (input.empty()) {
+ResultCode DataProcessor::process(const byte_t* input, size_t size, byte_t* output, size_t& output_size,
+                                  const ProcessingOptions& options) {
+    output_size = 0;
+    if (!input || !output || size == 0 || overlaps(input, output, size)) {
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    byte_t sum = 0;
+    ResultCode result = run(input, size, output, output_size, options, sum);
+    if (result == ResultCode::SUCCESS) {
+        processed_count_ += size;
+    }
+    return result;
+}
+
+ResultCode DataProcessor::process_in_place(data_buffer_t& data, const ProcessingOptions& options) {
+    if (data.empty()) {
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    size_t output_size = 0;
+    ResultCode result = process(data.data(), data.size(), data.data(), output_size, options);
+    if (result == ResultCode::SUCCESS) {
+        data.resize(output_size);
+    }
+    return result;
+}
+
+ResultCode DataProcessor::process_stream(const ReadFn& read, const WriteFn& write, const ProcessingOptions& options) {
+    if (!read || !write || options.algorithm == ProcessingAlgorithm::REVERSE) {
         return ResultCode::ERROR_INVALID_PARAMETER;
     }
     
     try {
-        output.clear();
-        
-        switch (options.algorithm) {
-            case ProcessingAlgorithm::SIMPLE_TRANSFORM:
-                return process(input, output);
-                
-            case ProcessingAlgorithm::REVERSE:
-                output = input;
-                std::reverse(output.begin(), output.end());
-                break;
-                
-            case ProcessingAlgorithm::ACCUMULATE:
-                {
-                    byte_t accumulator = 0;
-                    for (byte_t byte : input) {
-                        accumulator = static_cast<byte_t>((accumulator + byte) % 256);
-                        output.push_back(accumulator);
-                    }
-                }
-                break;
-                
-            case ProcessingAlgorithm::FILTER:
-                {
-                    // Filter out bytes below threshold
-                    byte_t threshold = options.threshold;
-                    for (byte_t byte : input) {
-                        if (byte >= threshold) {
-                            output.push_back(byte);
-                        }
-                    }
-                }
-                break;
-                
-            default:
-                return ResultCode::ERROR_NOT_IMPLEMENTED;
+        const size_t block_size = options.buffer_size > 0 ? options.buffer_size : buffer_size_;
+        if (stream_buffer_.size() < block_size) {
+            stream_buffer_.resize(block_size);
         }
-        
-        return ResultCode::SUCCESS;
-        
+        byte_t sum = 0;
+        while (true) {
+            const size_t size = std::min(read(stream_buffer_.data(), block_size), block_size);
+            if (size == 0) {
+                return ResultCode::SUCCESS;
+            }
+            // Blocks are transformed in place in the reused buffer
+            size_t output_size = 0;
+            ResultCode result = run(stream_buffer_.data(), size, stream_buffer_.data(), output_size, options, sum);
+            if (result != ResultCode::SUCCESS) {
+                return result;
+            }
+            processed_count_ += size;
+            if (output_size > 0 && !write(stream_buffer_.data(), output_size)) {
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+        }
+    
     } catch (const std::exception&) {
         return ResultCode::ERROR_PROCESSING_FAILED;
     }
@@ -96,4 +359,16 @@ void DataProcessor::reset_statistics() {
     processed_count_ = 0;
 }
 
-} // namespace leafra 
\ No newline at end of file
+ResultCode DataProcessor::set_buffer_size(size_t buffer_size) {
+    if (buffer_size == 0) {
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    buffer_size_ = buffer_size;
+    return ResultCode::SUCCESS;
+}
+
+size_t DataProcessor::get_buffer_size() const {
+    return buffer_size_;
+}
+
+} // namespace leafra
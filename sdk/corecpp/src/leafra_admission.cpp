@@ -0,0 +1,110 @@
+#include "leafra/leafra_admission.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace leafra {
+
+const char* admission_resource_name(AdmissionResource resource) {
+    switch (resource) {
+        case AdmissionResource::EMBEDDER: return "embedder";
+        case AdmissionResource::INDEX:    return "index";
+        case AdmissionResource::LLM:      return "llm";
+        default:                          return "unknown";
+    }
+}
+
+void AdmissionController::configure(const Options& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = options;
+    released_cv_.notify_all();
+}
+
+AdmissionController::Options AdmissionController::options() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_;
+}
+
+std::vector<AdmissionMetrics> AdmissionController::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<AdmissionMetrics> metrics(resources_.size());
+    for (size_t i = 0; i < resources_.size(); ++i) {
+        const ResourceState& state = resources_[i];
+        metrics[i].name = admission_resource_name(static_cast<AdmissionResource>(i));
+        metrics[i].slots = options_.enabled ? options_.slots[i] : 0;
+        metrics[i].in_flight = state.in_flight;
+        metrics[i].queued_interactive = state.queued[static_cast<size_t>(AdmissionLane::INTERACTIVE)].size();
+        metrics[i].queued_bulk = state.queued[static_cast<size_t>(AdmissionLane::BULK)].size();
+        metrics[i].peak_queued = state.peak_queued;
+        metrics[i].admitted = state.admitted;
+        metrics[i].rejected = state.rejected;
+        metrics[i].total_wait_ms = state.total_wait_ms;
+        metrics[i].max_wait_ms = state.max_wait_ms;
+    }
+    return metrics;
+}
+
+void AdmissionController::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (ResourceState& state : resources_) {
+        state.peak_queued = state.queued[0].size() + state.queued[1].size();
+        state.admitted = 0;
+        state.rejected = 0;
+        state.total_wait_ms = 0.0;
+        state.max_wait_ms = 0.0;
+    }
+}
+
+bool AdmissionController::has_slot_locked(size_t resource) const {
+    const size_t slots = options_.slots[resource];
+    return !options_.enabled || slots == 0 || resources_[resource].in_flight < slots;
+}
+
+AdmissionController::Permit::Permit(AdmissionController& controller, AdmissionResource resource, AdmissionLane lane)
+    : controller_(controller), resource_(static_cast<size_t>(resource)) {
+    std::unique_lock<std::mutex> lock(controller_.mutex_);
+    ResourceState& state = controller_.resources_[resource_];
+    std::deque<uint64_t>& interactive = state.queued[static_cast<size_t>(AdmissionLane::INTERACTIVE)];
+    std::deque<uint64_t>& own = state.queued[static_cast<size_t>(lane)];
+
+    const bool immediate = controller_.has_slot_locked(resource_) && interactive.empty() &&
+                           (lane == AdmissionLane::INTERACTIVE || own.empty());
+    if (!immediate) {
+        if (lane == AdmissionLane::INTERACTIVE && controller_.options_.enabled && controller_.options_.max_queued > 0 &&
+            interactive.size() >= controller_.options_.max_queued) {
+            state.rejected++;
+            return;
+        }
+
+        const uint64_t ticket = controller_.next_ticket_++;
+        own.push_back(ticket);
+        state.peak_queued = std::max(state.peak_queued, state.queued[0].size() + state.queued[1].size());
+        const auto start = std::chrono::steady_clock::now();
+
+        // Interactive: first in its lane. Bulk: first in its lane and no interactive caller waiting.
+        controller_.released_cv_.wait(lock, [&]() {
+            return controller_.has_slot_locked(resource_) && own.front() == ticket &&
+                   (lane == AdmissionLane::INTERACTIVE || interactive.empty());
+        });
+        own.pop_front();
+        wait_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        state.total_wait_ms += wait_ms_;
+        state.max_wait_ms = std::max(state.max_wait_ms, wait_ms_);
+        // The next in line may fit too (more than one slot free, or a bulk caller behind the last interactive one)
+        controller_.released_cv_.notify_all();
+    }
+    state.in_flight++;
+    state.admitted++;
+    admitted_ = true;
+}
+
+AdmissionController::Permit::~Permit() {
+    if (!admitted_) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(controller_.mutex_);
+    controller_.resources_[resource_].in_flight--;
+    controller_.released_cv_.notify_all();
+}
+
+} // namespace leafra
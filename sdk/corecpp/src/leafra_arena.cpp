@@ -0,0 +1,59 @@
+#include "leafra/leafra_arena.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace leafra {
+
+static constexpr size_t kMaxBlockBytes = 1 << 20;   // Growth stops here; larger requests get a block of their own size
+
+MonotonicArena::MonotonicArena(size_t first_block_bytes)
+    : first_block_bytes_(std::max<size_t>(first_block_bytes, 256)), next_block_bytes_(first_block_bytes_) {
+}
+
+MonotonicArena::~MonotonicArena() {
+    release();
+}
+
+void MonotonicArena::release() {
+    while (blocks_) {
+        Block* next = blocks_->next;
+        std::free(blocks_);
+        blocks_ = next;
+    }
+    cursor_ = nullptr;
+    end_ = nullptr;
+    next_block_bytes_ = first_block_bytes_;
+    bytes_used_ = 0;
+    reserved_bytes_ = 0;
+    block_count_ = 0;
+}
+
+void* MonotonicArena::allocate_block(size_t bytes, size_t alignment) {
+    // Header, then room for the request at any alignment
+    const size_t header = sizeof(Block);
+    if (bytes > static_cast<size_t>(-1) - header - alignment) {
+        throw std::bad_alloc();
+    }
+    const size_t needed = header + alignment + bytes;
+    const size_t block_bytes = std::max(next_block_bytes_, needed);
+    Block* block = static_cast<Block*>(std::malloc(block_bytes));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    block->next = blocks_;
+    blocks_ = block;
+    reserved_bytes_ += block_bytes;
+    block_count_++;
+    if (next_block_bytes_ < kMaxBlockBytes) {
+        next_block_bytes_ = std::min(next_block_bytes_ * 2, kMaxBlockBytes);
+    }
+    
+    char* start = reinterpret_cast<char*>(block) + header;
+    const uintptr_t aligned = (reinterpret_cast<uintptr_t>(start) + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    cursor_ = reinterpret_cast<char*>(aligned + bytes);
+    end_ = reinterpret_cast<char*>(block) + block_bytes;
+    bytes_used_ += bytes;
+    return reinterpret_cast<void*>(aligned);
+}
+
+} // namespace leafra
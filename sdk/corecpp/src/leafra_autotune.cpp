@@ -0,0 +1,126 @@
+#include "leafra/leafra_autotune.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace leafra {
+
+namespace {
+
+const char kProfileHeader[] = "leafra-device-profile 1";
+
+bool parse_int(const std::string& text, int32_t& value) {
+    char* end = nullptr;
+    const long parsed = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0') {
+        return false;
+    }
+    value = static_cast<int32_t>(parsed);
+    return true;
+}
+
+} // namespace
+
+bool DeviceProfile::apply(EmbeddingModelConfig& embedding, LLMConfig& llm) const {
+    bool applied = false;
+    if (embedding_batch_size > 0 && !embedding_model.empty() &&
+        model_name(embedding.model_path) == embedding_model) {
+        embedding.batch_size = embedding_batch_size;
+        applied = true;
+    }
+    if (!llm_model.empty() && model_name(llm.model_path) == llm_model) {
+        if (llm_threads > 0 && llm.n_threads <= 0) {
+            llm.n_threads = llm_threads;
+            applied = true;
+        }
+        if (llm_batch_threads > 0 && llm.n_threads_batch <= 0) {
+            llm.n_threads_batch = llm_batch_threads;
+            applied = true;
+        }
+    }
+    return applied;
+}
+
+bool DeviceProfile::save(const std::string& path) const {
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out << kProfileHeader << "\n"
+            << "device=" << device << "\n"
+            << "target=" << (target == AutotuneTarget::THROUGHPUT ? "throughput" : "latency") << "\n"
+            << "embedding_model=" << embedding_model << "\n"
+            << "embedding_batch_size=" << embedding_batch_size << "\n"
+            << "llm_model=" << llm_model << "\n"
+            << "llm_threads=" << llm_threads << "\n"
+            << "llm_batch_threads=" << llm_batch_threads << "\n";
+        if (!out.flush()) {
+            out.close();
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        // Windows won't rename over an existing file
+        std::remove(path.c_str());
+        if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DeviceProfile::load(const std::string& path, DeviceProfile& profile) {
+    std::ifstream in(path);
+    std::string line;
+    if (!in || !std::getline(in, line) || line != kProfileHeader) {
+        return false;
+    }
+    DeviceProfile loaded;
+    while (std::getline(in, line)) {
+        const size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            continue;
+        }
+        const std::string key = line.substr(0, equals);
+        const std::string value = line.substr(equals + 1);
+        if (key == "device") loaded.device = value;
+        else if (key == "target") loaded.target = (value == "throughput") ? AutotuneTarget::THROUGHPUT : AutotuneTarget::LATENCY;
+        else if (key == "embedding_model") loaded.embedding_model = value;
+        else if (key == "embedding_batch_size") parse_int(value, loaded.embedding_batch_size);
+        else if (key == "llm_model") loaded.llm_model = value;
+        else if (key == "llm_threads") parse_int(value, loaded.llm_threads);
+        else if (key == "llm_batch_threads") parse_int(value, loaded.llm_batch_threads);
+    }
+    profile = loaded;
+    return true;
+}
+
+std::string DeviceProfile::model_name(const std::string& model_path) {
+    const size_t pos = model_path.find_last_of("/\\");
+    return pos == std::string::npos ? model_path : model_path.substr(pos + 1);
+}
+
+int32_t DeviceProfile::pick(const std::vector<AutotuneTrial>& trials, double tolerance) {
+    const AutotuneTrial* best = nullptr;
+    for (const AutotuneTrial& trial : trials) {
+        if (trial.cost > 0.0 && (!best || trial.cost < best->cost)) {
+            best = &trial;
+        }
+    }
+    if (!best) {
+        return 0;
+    }
+    int32_t chosen = best->value;
+    for (const AutotuneTrial& trial : trials) {
+        if (trial.cost > 0.0 && trial.value < chosen && trial.cost <= best->cost * (1.0 + tolerance)) {
+            chosen = trial.value;
+        }
+    }
+    return chosen;
+}
+
+} // namespace leafra
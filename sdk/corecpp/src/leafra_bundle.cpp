@@ -0,0 +1,231 @@
+#include "leafra/leafra_bundle.h"
+#include "leafra/leafra_hash.h"
+#include "leafra/logger.h"
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace leafra {
+
+namespace {
+
+// One column value with its type, so e.g. the integer 1 and the text "1" hash differently
+void hash_value(ContentHasher& hasher, const SQLiteDatabase::Row& row, int column) {
+    const auto type = row.getColumnType(column);
+    const uint8_t tag = static_cast<uint8_t>(type);
+    hasher.update(&tag, 1);
+    switch (type) {
+        case SQLiteDatabase::ColumnType::Integer: {
+            int64_t value = row.getInt64(column);
+            hasher.update(&value, sizeof(value));
+            break;
+        }
+        case SQLiteDatabase::ColumnType::Float: {
+            double value = row.getDouble(column);
+            hasher.update(&value, sizeof(value));
+            break;
+        }
+        case SQLiteDatabase::ColumnType::Text: {
+            std::string_view text = row.getTextView(column);
+            uint64_t size = text.size();
+            hasher.update(&size, sizeof(size));
+            hasher.update(text);
+            break;
+        }
+        case SQLiteDatabase::ColumnType::Blob: {
+            SQLiteDatabase::BlobView blob = row.getBlobView(column);
+            uint64_t size = blob.size;
+            hasher.update(&size, sizeof(size));
+            hasher.update(blob.data, blob.size);
+            break;
+        }
+        case SQLiteDatabase::ColumnType::Null:
+            break;
+    }
+}
+
+std::string quote_identifier(const std::string& name) {
+    std::string quoted = "\"";
+    for (char c : name) {
+        quoted += c;
+        if (c == '"') {
+            quoted += '"';
+        }
+    }
+    return quoted + "\"";
+}
+
+bool count_rows(SQLiteDatabase& db, const std::string& table, int64_t& count) {
+    auto stmt = db.prepare("SELECT COUNT(*) FROM " + table);
+    if (!stmt || !stmt->isValid() || !stmt->step()) {
+        return false;
+    }
+    count = stmt->getCurrentRow().getInt64(0);
+    return true;
+}
+
+// AUTOINCREMENT keeps the highest delta id ever issued in sqlite_sequence, even after the log is trimmed
+int64_t last_faiss_delta_id(SQLiteDatabase& db) {
+    int64_t tables = 0;
+    if (!count_rows(db, "sqlite_schema WHERE name = 'sqlite_sequence'", tables) || tables == 0) {
+        return 0;
+    }
+    auto stmt = db.prepare("SELECT seq FROM sqlite_sequence WHERE name = 'faissdeltatable'");
+    if (stmt && stmt->isValid() && stmt->step()) {
+        return stmt->getCurrentRow().getInt64(0);
+    }
+    return 0;
+}
+
+} // anonymous namespace
+
+bool RagBundle::checksum(SQLiteDatabase& db, std::string& hex_digest) {
+    // Virtual tables are skipped: FTS5 reads through to chunks, and its shadow tables are hashed like any other
+    std::vector<std::string> tables;
+    auto list = db.prepare("SELECT name FROM sqlite_schema WHERE type = 'table' AND name <> 'bundle_manifest' "
+                           "AND name NOT LIKE 'sqlite_%' AND sql NOT LIKE 'CREATE VIRTUAL%' ORDER BY name");
+    if (!list || !list->isValid()) {
+        return false;
+    }
+    list->forEachRow([&tables](const SQLiteDatabase::Row& row) {
+        tables.push_back(row.getText(0));
+        return true;
+    });
+
+    ContentHasher hasher;
+    for (const std::string& table : tables) {
+        auto stmt = db.prepare("SELECT * FROM " + quote_identifier(table));
+        if (!stmt || !stmt->isValid()) {
+            LEAFRA_ERROR() << "Failed to read bundle table " << table;
+            return false;
+        }
+        hasher.update(table);
+        hasher.update("\n", 1);
+        bool read = stmt->forEachRow([&hasher](const SQLiteDatabase::Row& row) {
+            const int columns = row.getColumnCount();
+            for (int column = 0; column < columns; ++column) {
+                hash_value(hasher, row, column);
+            }
+            return true;
+        });
+        if (!read) {
+            LEAFRA_ERROR() << "Failed to read bundle table " << table << ": " << db.getLastErrorMessage();
+            return false;
+        }
+    }
+    hex_digest = hasher.hex_digest();
+    return true;
+}
+
+bool RagBundle::write_manifest(SQLiteDatabase& db, BundleManifest& manifest) {
+    manifest.format_version = manifest.delta ? kDeltaFormatVersion : kFormatVersion;
+    if (!count_rows(db, "docs", manifest.documents) || !count_rows(db, "chunks", manifest.chunks) ||
+        !checksum(db, manifest.checksum)) {
+        LEAFRA_ERROR() << "Failed to summarize bundle contents";
+        return false;
+    }
+    manifest.faiss_delta_id = last_faiss_delta_id(db);
+
+    const std::map<std::string, std::string> entries = {
+        {"format_version", std::to_string(manifest.format_version)},
+        {"sdk_version", manifest.sdk_version},
+        {"created_at", std::to_string(manifest.created_at)},
+        {"embedding_model", manifest.embedding_model},
+        {"dimension", std::to_string(manifest.dimension)},
+        {"index_type", manifest.index_type},
+        {"metric", manifest.metric},
+        {"index_dimension", std::to_string(manifest.index_dimension)},
+        {"chunk_size", std::to_string(manifest.chunk_size)},
+        {"chunk_overlap", std::to_string(manifest.chunk_overlap)},
+        {"chunk_unit", manifest.chunk_unit},
+        {"documents", std::to_string(manifest.documents)},
+        {"chunks", std::to_string(manifest.chunks)},
+        {"faiss_delta_id", std::to_string(manifest.faiss_delta_id)},
+        {"delta", manifest.delta ? "1" : "0"},
+        {"delta_since", std::to_string(manifest.delta_since)},
+        {"delta_through", std::to_string(manifest.delta_through)},
+        {"checksum", manifest.checksum},
+    };
+    SQLiteTransaction transaction(db);
+    if (!transaction.isActive() ||
+        !db.execute("CREATE TABLE IF NOT EXISTS bundle_manifest (key TEXT PRIMARY KEY, value TEXT NOT NULL)") ||
+        !db.execute("DELETE FROM bundle_manifest")) {
+        LEAFRA_ERROR() << "Failed to create bundle manifest: " << db.getLastErrorMessage();
+        return false;
+    }
+    auto insert = db.prepare("INSERT INTO bundle_manifest (key, value) VALUES (?, ?)");
+    if (!insert || !insert->isValid()) {
+        return false;
+    }
+    for (const auto& entry : entries) {
+        if (!insert->bindText(1, entry.first) || !insert->bindText(2, entry.second) || !insert->execute() || !insert->reset()) {
+            LEAFRA_ERROR() << "Failed to write bundle manifest: " << db.getLastErrorMessage();
+            return false;
+        }
+    }
+    return transaction.commit();
+} //write_manifest
+
+bool RagBundle::read_manifest(SQLiteDatabase& db, BundleManifest& manifest) {
+    std::map<std::string, std::string> entries;
+    auto stmt = db.prepare("SELECT key, value FROM bundle_manifest");
+    if (!stmt || !stmt->isValid()) {
+        LEAFRA_ERROR() << "Not a Leafra bundle (no manifest)";
+        return false;
+    }
+    stmt->forEachRow([&entries](const SQLiteDatabase::Row& row) {
+        entries[row.getText(0)] = row.getText(1);
+        return true;
+    });
+    if (!entries.count("format_version") || !entries.count("checksum")) {
+        LEAFRA_ERROR() << "Incomplete bundle manifest";
+        return false;
+    }
+
+    auto text = [&entries](const char* key) {
+        auto it = entries.find(key);
+        return it != entries.end() ? it->second : std::string();
+    };
+    try {
+        auto number = [&text](const char* key) {
+            std::string value = text(key);
+            return value.empty() ? 0LL : std::stoll(value);
+        };
+        manifest.format_version = static_cast<int32_t>(number("format_version"));
+        manifest.sdk_version = text("sdk_version");
+        manifest.created_at = number("created_at");
+        manifest.embedding_model = text("embedding_model");
+        manifest.dimension = static_cast<int32_t>(number("dimension"));
+        manifest.index_type = text("index_type");
+        manifest.metric = text("metric");
+        manifest.index_dimension = static_cast<int32_t>(number("index_dimension"));
+        manifest.chunk_size = number("chunk_size");
+        manifest.chunk_overlap = text("chunk_overlap").empty() ? 0.0 : std::stod(text("chunk_overlap"));
+        manifest.chunk_unit = text("chunk_unit");
+        manifest.documents = number("documents");
+        manifest.chunks = number("chunks");
+        manifest.faiss_delta_id = number("faiss_delta_id");
+        manifest.delta = number("delta") != 0;
+        manifest.delta_since = number("delta_since");
+        manifest.delta_through = number("delta_through");
+        manifest.checksum = text("checksum");
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "Malformed bundle manifest: " << e.what();
+        return false;
+    }
+    return true;
+} //read_manifest
+
+bool RagBundle::verify(SQLiteDatabase& db, const BundleManifest& manifest) {
+    std::string digest;
+    if (!checksum(db, digest)) {
+        return false;
+    }
+    if (digest != manifest.checksum) {
+        LEAFRA_ERROR() << "Bundle checksum mismatch (manifest " << manifest.checksum << ", contents " << digest << ")";
+        return false;
+    }
+    return true;
+}
+
+} // namespace leafra
@@ -0,0 +1,77 @@
+#include "leafra/leafra_chunk_quality.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace leafra {
+
+ChunkQualityScore ChunkQuality::score(std::string_view text, size_t token_count) {
+    ChunkQualityScore result;
+    result.bytes = text.size();
+
+    std::array<uint32_t, 128> counts{};
+    size_t letters = 0;
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(text.data());
+    for (size_t i = 0; i < text.size(); ++i) {
+        const unsigned char c = s[i];
+        if (c >= 0x80) {
+            // Count each code point once, at its lead byte
+            if ((c & 0xC0) != 0x80) {
+                result.characters++;
+                letters++;
+            }
+            continue;
+        }
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v') {
+            continue;
+        }
+        result.characters++;
+        counts[c]++;
+        const unsigned char lower = c | 0x20;
+        if (lower >= 'a' && lower <= 'z') {
+            letters++;
+        }
+    }
+    result.ascii_characters = 0;
+    for (uint32_t count : counts) {
+        result.ascii_characters += count;
+    }
+
+    if (result.characters > 0) {
+        result.alpha_ratio = static_cast<double>(letters) / static_cast<double>(result.characters);
+    }
+    if (result.bytes > 0 && token_count > 0) {
+        result.tokens_per_byte = static_cast<double>(token_count) / static_cast<double>(result.bytes);
+    }
+    if (result.ascii_characters > 0) {
+        const double total = static_cast<double>(result.ascii_characters);
+        for (uint32_t count : counts) {
+            if (count > 0) {
+                const double p = count / total;
+                result.entropy -= p * std::log2(p);
+            }
+        }
+    }
+    return result;
+}
+
+const char* ChunkQuality::rejection_reason(const ChunkQualityScore& score, const ChunkQualityConfig& config) {
+    if (score.characters < static_cast<size_t>(std::max<int32_t>(0, config.min_chars))) {
+        return "length";
+    }
+    if (score.alpha_ratio < config.min_alpha_ratio) {
+        return "alpha_ratio";
+    }
+    if (config.max_tokens_per_byte > 0.0f && score.tokens_per_byte > config.max_tokens_per_byte) {
+        return "tokens_per_byte";
+    }
+    // Mostly non-ASCII text has too few ASCII characters for the entropy to say anything
+    if (score.ascii_characters * 2 >= score.characters &&
+        score.ascii_characters >= static_cast<size_t>(std::max<int32_t>(0, config.min_chars)) &&
+        (score.entropy < config.min_entropy || (config.max_entropy > 0.0f && score.entropy > config.max_entropy))) {
+        return "entropy";
+    }
+    return nullptr;
+}
+
+} // namespace leafra
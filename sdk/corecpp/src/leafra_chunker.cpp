@@ -10,6 +10,9 @@ namespace leafra {
 // Token-to-character conversion constant
 // Based on empirical analysis: ~4 characters per token works well across different content types
 constexpr double SIMPLE_CHARS_PER_TOKEN = 4.0;
+constexpr size_t STREAM_LOOKAHEAD_BYTES = 256;      // Text a streamed chunk needs past its end (word boundary search + margin)
+constexpr size_t STREAM_BACKTRACK_BYTES = 256;      // Text kept before the stream cursor for backward boundary searches
+constexpr size_t STREAM_DENSITY_SAMPLE_BYTES = 8192; // Text buffered before the stream samples its density
 
 /**
  * Ensure a byte position is aligned to a valid UTF-8 character boundary
@@ -30,6 +33,60 @@ static size_t ensure_utf8_boundary(const std::string& text, size_t pos) {
     return pos;
 }
 
+/**
+ * Create a chunk over ASCII text, where every byte is a character
+ * Same result as LeafraChunker::create_chunk, with trimming done as bit scans over the
+ * cacher's whitespace classes instead of decoding characters
+ * @param text The ASCII text
+ * @param cacher Index of text
+ * @param start Starting byte position
+ * @param end Ending byte position
+ * @param trim_whitespace Whether to trim leading and trailing whitespace
+ * @return TextChunk viewing the trimmed range
+ */
+static TextChunk create_ascii_chunk(const std::string& text, const UnicodeCacher& cacher,
+                                    size_t start, size_t end, bool trim_whitespace) {
+    if (start >= text.length() || end > text.length() || start >= end) {
+        return TextChunk(std::string_view(), start, end, 0);
+    }
+    
+    size_t content_start = start;
+    size_t content_end = end;
+    if (trim_whitespace) {
+        using ByteClass = UnicodeCacher::ByteClass;
+        content_start = cacher.find_next_byte(ByteClass::WHITESPACE, false, start, end);
+        size_t last = cacher.find_prev_byte(ByteClass::WHITESPACE, false, content_start, end);
+        content_end = (last == std::string::npos) ? content_start : last + 1;
+    }
+    
+    std::string_view chunk_view;
+    if (content_start < content_end) {
+        chunk_view = std::string_view(text.data() + content_start, content_end - content_start);
+    }
+    return TextChunk(chunk_view, start, end, 0);
+}
+
+size_t ChunkingScratch::memory_bytes() const {
+    return cacher.memory_bytes() +
+           page_starts.capacity() * sizeof(size_t) +
+           token_ids.capacity() * sizeof(int) +
+           token_offsets.capacity() * sizeof(TokenOffsets::value_type);
+}
+
+size_t ChunkedDocument::memory_bytes() const {
+    size_t bytes = chunks.capacity() * sizeof(TextChunk);
+    for (const TextChunk& chunk : chunks) {
+        bytes += chunk.token_ids.capacity() * sizeof(int) + chunk.embedding.capacity() * sizeof(float);
+    }
+    bytes += batch.tokens.ids.capacity() * sizeof(int) + batch.tokens.offsets.capacity() * sizeof(size_t);
+    bytes += batch.embeddings.capacity() * sizeof(float) + batch.embedded.capacity();
+    if (owns_text()) {
+        bytes += storage_->capacity();
+    }
+    bytes += page_starts_.capacity() * sizeof(size_t);
+    return bytes;
+}
+
 LeafraChunker::LeafraChunker() = default;
 
 LeafraChunker::~LeafraChunker() = default;
@@ -55,6 +112,19 @@ ResultCode LeafraChunker::chunk_text(const std::string& text,
     return result;
 }
 
+ResultCode LeafraChunker::chunk_text(const std::string& text,
+                                    ChunkingOptions options,
+                                    ChunkedDocument& result,
+                                    ChunkingScratch& scratch) const {
+    // Borrow the caller's text - nothing to join for a single page
+    result.storage_.reset();
+    result.text_ = &text;
+    result.page_starts_.assign(1, 0);
+    scratch.page_starts.assign(1, 0);
+    result.batch.clear();
+    return chunk_prepared_text(text, std::move(options), result.chunks, scratch);
+}
+
 
 
 
@@ -63,13 +133,81 @@ ResultCode LeafraChunker::chunk_text(const std::string& text,
 ResultCode LeafraChunker::chunk_document(const std::vector<std::string>& pages,
                                                  const ChunkingOptions& options,
                                                  std::vector<TextChunk>& chunks) {
-    LEAFRA_DEBUG_TIMER("chunk_document");
+    // Chunks view last_document_, so they stay valid until the next call on this chunker
+    chunks.clear();
+    ResultCode result = chunk_document(pages, options, last_document_, scratch_);
+    if (result != ResultCode::SUCCESS) {
+        return result;
+    }
     
+    chunks = std::move(last_document_.chunks);
+    last_document_.chunks.clear();
+    last_chunk_count_ = chunks.size();
+    last_total_characters_ = 0;
+    for (const auto& page : pages) {
+        last_total_characters_ += page.length();
+    }
+    return ResultCode::SUCCESS;
+}
+
+ResultCode LeafraChunker::chunk_document(const std::vector<std::string>& pages,
+                                        ChunkingOptions options,
+                                        ChunkedDocument& result,
+                                        ChunkingScratch& scratch) const {
+    std::vector<std::string_view> page_views(pages.begin(), pages.end());
+    return chunk_document(page_views, std::move(options), result, scratch);
+}
+
+ResultCode LeafraChunker::chunk_document(const std::vector<std::string_view>& pages,
+                                        ChunkingOptions options,
+                                        ChunkedDocument& result,
+                                        ChunkingScratch& scratch) const {
     if (pages.empty()) {
         LEAFRA_DEBUG_LOG("ERROR", "chunk_document called with empty pages");
         return ResultCode::ERROR_INVALID_PARAMETER;
     }
     
+    try {
+        // Combine all pages into the result's text with page separators (the buffer is reused between calls)
+        auto combine_start = debug::timer::now();
+        if (!result.storage_) {
+            result.storage_ = std::make_unique<std::string>();
+        }
+        std::string& combined_text = *result.storage_;
+        combined_text.clear();
+        result.batch.clear();
+        scratch.page_starts.assign(1, 0);
+        
+        size_t total_length = 0;
+        for (const auto& page : pages) {
+            total_length += page.length() + 2;
+        }
+        combined_text.reserve(total_length);
+        
+        for (size_t i = 0; i < pages.size(); ++i) {
+            combined_text.append(pages[i].data(), pages[i].size());
+            if (i < pages.size() - 1) {
+                combined_text += "\n\n"; // Page separator
+                scratch.page_starts.push_back(combined_text.length());
+            }
+        }
+        result.text_ = result.storage_.get();
+        result.page_starts_ = scratch.page_starts;
+        
+        auto combine_end = debug::timer::now();
+        double combine_ms = debug::timer::elapsed_milliseconds(combine_start, combine_end);
+        LEAFRA_DEBUG_LOG("TIMING", "Text combination took " + std::to_string(combine_ms) + "ms");
+        
+        LEAFRA_DEBUG_LOG("CHUNKING", "Processing document with " + std::to_string(pages.size()) + " pages");
+        return chunk_prepared_text(combined_text, std::move(options), result.chunks, scratch);
+        
+    } catch (const std::exception& e) {
+        LEAFRA_DEBUG_LOG("ERROR", "Exception in chunk_document: " + std::string(e.what()));
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+}
+
+ResultCode LeafraChunker::normalize_options(ChunkingOptions& options) {
     if (options.chunk_size == 0) {
         LEAFRA_DEBUG_LOG("ERROR", "chunk_document called with zero chunk size");
         return ResultCode::ERROR_INVALID_PARAMETER;
@@ -80,110 +218,112 @@ ResultCode LeafraChunker::chunk_document(const std::vector<std::string>& pages,
         return ResultCode::ERROR_INVALID_PARAMETER;
     }
     
+    if (options.size_unit == ChunkSizeUnit::EXACT_TOKENS && !options.tokenizer) {
+        LEAFRA_DEBUG_LOG("ERROR", "EXACT_TOKENS chunking requires a tokenizer");
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    if (options.size_unit == ChunkSizeUnit::CHARACTERS) {
+        // Convert character size to approximate token size for the unified method
+        size_t approx_tokens = static_cast<size_t>(options.chunk_size / SIMPLE_CHARS_PER_TOKEN); // ~4 chars per token
+        if (approx_tokens < 1) approx_tokens = 1;
+        LEAFRA_DEBUG_LOG("CONVERSION", "Converted " + std::to_string(options.chunk_size) + 
+                       " characters to " + std::to_string(approx_tokens) + " tokens");
+        options.chunk_size = approx_tokens;
+        options.size_unit = ChunkSizeUnit::TOKENS;
+    }
+    return ResultCode::SUCCESS;
+}
+
+void LeafraChunker::assign_page_range(const std::vector<size_t>& page_starts,
+                                      const std::string& text,
+                                      size_t text_offset,
+                                      TextChunk& chunk) {
+    // page_starts is sorted, so each lookup is a binary search rather than a scan over every page
+    auto page_of = [&page_starts](size_t byte_pos) -> size_t {
+        auto next_page = std::upper_bound(page_starts.begin(), page_starts.end(), byte_pos);
+        return next_page == page_starts.begin() ? 0 : static_cast<size_t>(next_page - page_starts.begin()) - 1;
+    };
+    chunk.page_number = page_of(chunk.start_index);
+    
+    // The end page comes from the trimmed content, so a trailing page separator doesn't count
+    size_t content_end = chunk.content.empty()
+        ? chunk.end_index
+        : text_offset + static_cast<size_t>(chunk.content.data() - text.data()) + chunk.content.size();
+    chunk.end_page_number = content_end > chunk.start_index
+        ? std::max(chunk.page_number, page_of(content_end - 1))
+        : chunk.page_number;
+}
+
+ResultCode LeafraChunker::chunk_prepared_text(const std::string& text,
+                                              ChunkingOptions options,
+                                              std::vector<TextChunk>& chunks,
+                                              ChunkingScratch& scratch) const {
+    LEAFRA_DEBUG_TIMER("chunk_document");
+    chunks.clear();
+    
+    // Options are our own copy, so they can be converted in place
+    ResultCode options_result = normalize_options(options);
+    if (options_result != ResultCode::SUCCESS) {
+        return options_result;
+    }
+    
     auto start_time = debug::timer::now();
     
     try {
-        chunks.clear();
-        
-        // Calculate total document length
-        size_t total_length = 0;
-        for (const auto& page : pages) {
-            total_length += page.length();
-        }
-        last_total_characters_ = total_length;
-        
-        LEAFRA_DEBUG_LOG("CHUNKING", "Processing document with " + std::to_string(pages.size()) + 
-                        " pages, " + std::to_string(total_length) + " total characters");
+        LEAFRA_DEBUG_LOG("CHUNKING", "Chunking " + std::to_string(text.length()) + " total characters");
         LEAFRA_DEBUG_LOG("OPTIONS", "Chunk size: " + std::to_string(options.chunk_size) + 
                         ", Overlap: " + std::to_string(options.overlap_percentage * 100.0) + "%");
         
-        // Store current default options and set new ones temporarily
-        ChunkingOptions old_options = default_options_;
-        default_options_ = options;
-        
-        // Determine effective options for chunking
-        ChunkingOptions effective_options = options;
-        if (options.size_unit == ChunkSizeUnit::CHARACTERS) {
-            // Convert character size to approximate token size for the unified method
-            size_t approx_tokens = static_cast<size_t>(options.chunk_size / SIMPLE_CHARS_PER_TOKEN); // ~4 chars per token
-            if (approx_tokens < 1) approx_tokens = 1;
-            effective_options.chunk_size = approx_tokens;
-            effective_options.size_unit = ChunkSizeUnit::TOKENS;
-            LEAFRA_DEBUG_LOG("CONVERSION", "Converted " + std::to_string(options.chunk_size) + 
-                           " characters to " + std::to_string(approx_tokens) + " tokens");
-        }
-        
-        // Combine all pages into a single text with page separators
-        auto combine_start = debug::timer::now();
-        combined_text_.clear(); // Clear previous document content
-        std::vector<size_t> page_starts;
-        page_starts.push_back(0);
-        
-        for (size_t i = 0; i < pages.size(); ++i) {
-            combined_text_ += pages[i];
-            if (i < pages.size() - 1) {
-                combined_text_ += "\n\n"; // Page separator
-                page_starts.push_back(combined_text_.length());
-            }
-        }
-        
-        auto combine_end = debug::timer::now();
-        double combine_ms = debug::timer::elapsed_milliseconds(combine_start, combine_end);
-        LEAFRA_DEBUG_LOG("TIMING", "Text combination took " + std::to_string(combine_ms) + "ms");
-        
         // Use core chunking method
         auto chunk_start = debug::timer::now();
-        std::vector<TextChunk> temp_chunks;
-        documentCacher.reinitialize(combined_text_);
-        ResultCode result = actual_chunker(combined_text_, effective_options, temp_chunks);
+        if (options.submit_task && options.parallel_segment_bytes > 0 &&
+            text.length() >= 2 * options.parallel_segment_bytes) {
+            // Indexing is the O(n) part of chunking; the chunk cursor itself stays sequential
+            const TaskSubmitFunction& submit_task = options.submit_task;
+            scratch.cacher.reinitialize(text, options.parallel_segment_bytes,
+                [&submit_task](size_t count, const std::function<void(size_t)>& body) {
+                    parallel_for_each(submit_task, count, body);
+                });
+        } else {
+            scratch.cacher.reinitialize(text);
+        }
+        ResultCode result = options.size_unit == ChunkSizeUnit::EXACT_TOKENS
+            ? token_chunker(text, scratch.cacher, options, chunks, scratch)
+            : options.strategy == ChunkingStrategy::SENTENCE
+                ? sentence_chunker(text, scratch.cacher, options, chunks)
+                : actual_chunker(text, scratch.cacher, options, chunks);
         
         auto chunk_end = debug::timer::now();
         double chunk_ms = debug::timer::elapsed_milliseconds(chunk_start, chunk_end);
         LEAFRA_DEBUG_LOG("TIMING", "Core chunking took " + std::to_string(chunk_ms) + "ms");
         
         if (result != ResultCode::SUCCESS) {
-            LEAFRA_DEBUG_LOG("ERROR", "actual_chunker failed with result code: " + std::to_string(static_cast<int>(result)));
-            // Restore old options before returning
-            default_options_ = old_options;
+            LEAFRA_DEBUG_LOG("ERROR", "Core chunker failed with result code: " + std::to_string(static_cast<int>(result)));
+            chunks.clear();
             return result;
         }
         
         // Update chunk metadata with correct page numbers
         auto metadata_start = debug::timer::now();
-        for (auto& chunk : temp_chunks) {
-            size_t page_number = 0;
-            for (size_t i = 0; i < page_starts.size(); ++i) {
-                if (chunk.start_index >= page_starts[i]) {
-                    page_number = i;
-                } else {
-                    break;
-                }
-            }
-            chunk.page_number = page_number;
+        for (auto& chunk : chunks) {
+            assign_page_range(scratch.page_starts, text, 0, chunk);
         }
         
         auto metadata_end = debug::timer::now();
         double metadata_ms = debug::timer::elapsed_milliseconds(metadata_start, metadata_end);
         LEAFRA_DEBUG_LOG("TIMING", "Metadata update took " + std::to_string(metadata_ms) + "ms");
         
-        chunks = std::move(temp_chunks);
-        
-        // Restore old options
-        default_options_ = old_options;
-        
-        // Update statistics
-        last_chunk_count_ = chunks.size();
-        
         // Log final performance metrics
         if (debug::is_debug_enabled()) {
             auto end_time = debug::timer::now();
             double total_duration_ms = debug::timer::elapsed_milliseconds(start_time, end_time);
-            debug::debug_log_performance("chunk_document", total_length, chunks.size(), total_duration_ms);
+            debug::debug_log_performance("chunk_document", text.length(), chunks.size(), total_duration_ms);
             
             // Log individual chunk details
             for (size_t i = 0; i < chunks.size() && i < 5; ++i) { // Log first 5 chunks only           
                 debug::debug_log_chunking_details("CREATED", i, chunks[i].start_index, chunks[i].end_index, 
-                                                 chunks[i].estimated_tokens, effective_options.chunk_size);
+                                                 chunks[i].estimated_tokens, options.chunk_size);
             }
             if (chunks.size() > 5) {
                 LEAFRA_DEBUG_LOG("CHUNKING", "... and " + std::to_string(chunks.size() - 5) + " more chunks");
@@ -194,6 +334,7 @@ ResultCode LeafraChunker::chunk_document(const std::vector<std::string>& pages,
         
     } catch (const std::exception& e) {
         LEAFRA_DEBUG_LOG("ERROR", "Exception in chunk_document: " + std::string(e.what()));
+        chunks.clear();
         return ResultCode::ERROR_PROCESSING_FAILED;
     }
 }
@@ -201,32 +342,70 @@ ResultCode LeafraChunker::chunk_document(const std::vector<std::string>& pages,
 
 //Actual Chunker - Core chunking method
 ResultCode LeafraChunker::actual_chunker(const std::string& text,
+                                         const UnicodeCacher& cacher,
                                          const ChunkingOptions& options,
-                                         std::vector<TextChunk>& chunks) {
+                                         std::vector<TextChunk>& chunks) const {
+    chunks.clear();
     if (text.empty()) {
-        chunks.clear();
         return ResultCode::SUCCESS;
     }
+    
+    // DENSITY SAMPLING: Learn actual text density once at the beginning
+    double chars_per_token = sample_text_density(text, cacher, options);
+    
+    size_t resume_pos = 0;
+    return chunk_window(text, cacher, options, chars_per_token, 0, true, false, chunks, resume_pos);
+}
+
+ResultCode LeafraChunker::chunk_window(const std::string& text,
+                                       const UnicodeCacher& cacher,
+                                       const ChunkingOptions& options,
+                                       double chars_per_token,
+                                       size_t start_pos,
+                                       bool final_window,
+                                       bool has_previous_chunks,
+                                       std::vector<TextChunk>& chunks,
+                                       size_t& resume_pos) const {
+    // Pick the kernel once per window: the hot loop then carries no option branches, and ASCII
+    // text (one byte per character) skips the character index lookups and UTF-8 realignment
+    const bool ascii = ascii_run_length(text.data(), text.size()) == text.size();
+    if (options.preserve_word_boundaries) {
+        return ascii ? chunk_window_kernel<true, true>(text, cacher, options, chars_per_token, start_pos, final_window, has_previous_chunks, chunks, resume_pos)
+                     : chunk_window_kernel<true, false>(text, cacher, options, chars_per_token, start_pos, final_window, has_previous_chunks, chunks, resume_pos);
+    }
+    return ascii ? chunk_window_kernel<false, true>(text, cacher, options, chars_per_token, start_pos, final_window, has_previous_chunks, chunks, resume_pos)
+                 : chunk_window_kernel<false, false>(text, cacher, options, chars_per_token, start_pos, final_window, has_previous_chunks, chunks, resume_pos);
+}
 
+template <bool PreserveWordBoundaries, bool Ascii>
+ResultCode LeafraChunker::chunk_window_kernel(const std::string& text,
+                                              const UnicodeCacher& cacher,
+                                              const ChunkingOptions& options,
+                                              double chars_per_token,
+                                              size_t start_pos,
+                                              bool final_window,
+                                              bool has_previous_chunks,
+                                              std::vector<TextChunk>& chunks,
+                                              size_t& resume_pos) const {
     try {
-        chunks.clear();
-        size_t current_pos = 0;
+        size_t current_pos = start_pos;
         size_t target_tokens = options.chunk_size;
+        resume_pos = start_pos;
         
         // PERFORMANCE OPTIMIZATION: Calculate Unicode length once at the beginning
         // since the text doesn't change throughout the chunking process
-        size_t text_unicode_length = documentCacher.get_unicode_length_cached();
-        
-        // DENSITY SAMPLING: Learn actual text density once at the beginning
-        double chars_per_token = sample_text_density(text, options);
+        size_t text_unicode_length = cacher.get_unicode_length_cached();
         
         while (current_pos < text.length()) {
+            resume_pos = current_pos;
+            
             // Ensure we start at a word boundary
-            if (options.preserve_word_boundaries && current_pos > 0) {
-                size_t original_pos = current_pos;
-                current_pos = find_next_word_start(text, current_pos);
+            if (PreserveWordBoundaries && current_pos > 0) {
+                current_pos = find_next_word_start<Ascii>(text, cacher, current_pos);
                 // CRITICAL: Ensure the word boundary is also UTF-8 aligned
-                current_pos = ensure_utf8_boundary(text, current_pos);
+                if (!Ascii) {
+                    current_pos = ensure_utf8_boundary(text, current_pos);
+                }
                 
                 if (current_pos >= text.length()) {
                     break;
@@ -234,22 +413,31 @@ ResultCode LeafraChunker::actual_chunker(const std::string& text,
             }
             
             // Find the best chunk end that respects word boundaries and target token count
-            size_t chunk_end = find_optimal_chunk_end(text, current_pos, target_tokens, options, text_unicode_length, chars_per_token);
+            size_t chunk_end = find_optimal_chunk_end<Ascii>(text, cacher, current_pos, target_tokens, options, text_unicode_length, chars_per_token);
+            
+            // Until the text is complete, a chunk this close to the end could still grow, so leave it for the next window
+            if (!final_window && chunk_end + STREAM_LOOKAHEAD_BYTES >= text.length()) {
+                break;
+            }
             
             // Make sure chunk end is at a word boundary
-            if (options.preserve_word_boundaries && chunk_end < text.length()) {
+            if (PreserveWordBoundaries && chunk_end < text.length()) {
                 // Ensure we end at a word boundary (this will move to end of current word)
-                chunk_end = find_word_boundary(text, chunk_end, 100);
+                size_t word_end = find_word_boundary(text, cacher, chunk_end, 100);
+                // A boundary at or before the start would produce an empty chunk and stall the loop
+                if (word_end > current_pos) {
+                    chunk_end = word_end;
+                }
             }
             
             // Create chunk - but only if it would be non-empty
-            TextChunk chunk = create_chunk(text, current_pos, chunk_end, 0, current_pos);
+            TextChunk chunk = Ascii ? create_ascii_chunk(text, cacher, current_pos, chunk_end, PreserveWordBoundaries)
+                                    : create_chunk(text, cacher, current_pos, chunk_end, 0, current_pos, PreserveWordBoundaries);
             
             // Skip empty chunks - don't add them to the result
             if (!chunk.content.empty()) {
                 // Calculate actual token count
                 chunk.estimated_tokens = estimate_token_count(chunk.content, options.token_method);
-                chunks.push_back(chunk);
                 
                 // Calculate next position with proper overlap based on ACTUAL chunk size
                 size_t actual_chunk_tokens = chunk.estimated_tokens;
@@ -258,13 +446,28 @@ ResultCode LeafraChunker::actual_chunker(const std::string& text,
                 
                 // Convert back to characters to find next start position
                 size_t advance_chars = static_cast<size_t>(std::round(effective_content_tokens * chars_per_token));
-                current_pos += advance_chars;
-                // CRITICAL: Ensure current_pos is on a UTF-8 character boundary
-                current_pos = ensure_utf8_boundary(text, current_pos);
-            } else if (chunks.empty() && current_pos < text.length()) {
+                size_t next_char_index = (Ascii ? current_pos : cacher.get_char_index_for_byte_pos_cached(current_pos)) + advance_chars;
+                if (!final_window && next_char_index >= text_unicode_length) {
+                    break;
+                }
+                chunks.push_back(chunk);
+                
+                if (Ascii) {
+                    current_pos = std::min(next_char_index, text.length());
+                } else {
+                    current_pos = cacher.get_byte_pos_for_char_index_cached(next_char_index);
+                    // CRITICAL: Ensure current_pos is on a UTF-8 character boundary
+                    current_pos = ensure_utf8_boundary(text, current_pos);
+                }
+                resume_pos = current_pos;
+            } else if (chunks.empty() && !has_previous_chunks && current_pos < text.length()) {
                 // Special case: if we have no chunks yet and there's still text,
                 // create a chunk from current position to end of text to avoid empty result
-                chunk = create_chunk(text, current_pos, text.length(), 0, current_pos);
+                if (!final_window) {
+                    break;
+                }
+                chunk = Ascii ? create_ascii_chunk(text, cacher, current_pos, text.length(), PreserveWordBoundaries)
+                              : create_chunk(text, cacher, current_pos, text.length(), 0, current_pos, PreserveWordBoundaries);
                 if (!chunk.content.empty()) {
                     chunk.estimated_tokens = estimate_token_count(chunk.content, options.token_method);
                     chunks.push_back(chunk);
@@ -319,6 +522,7 @@ const ChunkingOptions& LeafraChunker::get_default_options() const {
  * @return Byte position of word boundary, or target_position if none found
  */
 size_t LeafraChunker::find_word_boundary(const std::string& text, 
+                                        const UnicodeCacher& cacher,
                                         size_t target_position, 
                                         size_t search_window) const {
     if (target_position >= text.length()) {
@@ -329,90 +533,54 @@ size_t LeafraChunker::find_word_boundary(const std::string& text,
     if (target_position == 0) {
         return 0;
     }
-    if (target_position == text.length()) {
-        return text.length();
-    }
     
-    // Check if we're already at a word boundary using Unicode-aware detection
-    size_t next_pos;
-    UChar32 c = documentCacher.get_unicode_char_at_cached(target_position, next_pos);
-    if (c != U_SENTINEL && is_unicode_whitespace(c)) {
+    // Whitespace and word bytes were classified while the cacher indexed the text, so the
+    // searches below are bit scans rather than decoding loops
+    using ByteClass = UnicodeCacher::ByteClass;
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(text.data());
+    auto is_char_start = [s](size_t pos) { return (s[pos] & 0xC0) != 0x80; };
+    
+    // Check if we're already at a word boundary
+    if (is_char_start(target_position) && cacher.byte_in_class(ByteClass::WHITESPACE, target_position)) {
         return target_position;
     }
     
-    // Try searching backwards for a word boundary
+    // Try searching backwards: the nearest whitespace within the window, then back to the start of its run
     size_t search_start = (target_position > search_window) ? 
                           target_position - search_window : 0;
-    
-    size_t byte_pos = target_position;
-    while (byte_pos > search_start) {
-        // Find previous character position
-        size_t prev_pos = 0;
-        size_t temp_pos = 0;
-        
-        while (temp_pos < byte_pos && temp_pos < text.length()) {
-            prev_pos = temp_pos;
-            size_t next_temp_pos;
-            UChar32 temp_c = documentCacher.get_unicode_char_at_cached(temp_pos, next_temp_pos);
-            if (temp_c == U_SENTINEL || temp_pos >= byte_pos) break;
-            temp_pos = next_temp_pos;
-        }
-        
-        if (prev_pos == 0) break;
-        
-        UChar32 prev_c = documentCacher.get_unicode_char_at_cached(prev_pos, next_pos);
-        if (prev_c != U_SENTINEL && is_unicode_whitespace(prev_c)) {
-            // Skip all consecutive whitespace
-            do {
-                byte_pos = prev_pos;
-                if (byte_pos == 0) break;
-                size_t before_prev = 0;
-                size_t temp = 0;
-                while (temp < byte_pos && temp < text.length()) {
-                    before_prev = temp;
-                    size_t next_temp;
-                    UChar32 temp_c = documentCacher.get_unicode_char_at_cached(temp, next_temp);
-                    if (temp_c == U_SENTINEL || temp >= byte_pos)
-                        break;
-                    temp = next_temp;
-                }
-                prev_c = documentCacher.get_unicode_char_at_cached(before_prev, next_pos);
-                prev_pos = before_prev;
-            } while (prev_c != U_SENTINEL && is_unicode_whitespace(prev_c));
-
-            return next_pos;
+    size_t space_end = cacher.find_prev_byte(ByteClass::WHITESPACE, true, search_start, target_position);
+    if (space_end != std::string::npos) {
+        size_t before_space = cacher.find_prev_byte(ByteClass::WHITESPACE, false, 0, space_end);
+        if (before_space != std::string::npos) {
+            return before_space + 1;
+        }
+        // The run reaches the start of the text: keep its first character, unless that is the only one found
+        size_t first_char_end;
+        cacher.get_unicode_char_at_cached(0, first_char_end);
+        if (space_end >= first_char_end) {
+            return first_char_end;
         }
-        
-        byte_pos = prev_pos;
     }
     
     // If backward search failed, try forward search within window
     size_t search_end = std::min(target_position + search_window, text.length());
-    byte_pos = target_position;
-    
-    while (byte_pos < search_end) {
-        UChar32 c = documentCacher.get_unicode_char_at_cached(byte_pos, next_pos);
-        if (c == U_SENTINEL) {
-            byte_pos = next_pos;
-            continue;
-        }
-        
-        if (is_unicode_whitespace(c)) {
+    size_t byte_pos = target_position;
+    while ((byte_pos = cacher.find_next_byte(ByteClass::WHITESPACE, true, byte_pos, search_end)) < search_end) {
+        if (is_char_start(byte_pos)) {
             // Move to end of current word (before the whitespace)
             return byte_pos;
         }
-        
-        byte_pos = next_pos;
+        byte_pos++;
     }
     
     // If limited search failed, use the Unicode word boundary function with backward search
-    size_t word_boundary = documentCacher.find_word_boundary_helper_for_unicode_cached(target_position, false);
+    size_t word_boundary = cacher.find_word_boundary_helper_for_unicode_cached(target_position, false);
     if (word_boundary != target_position) {
         return word_boundary;
     }
     
     // Last resort: search forward without limit using Unicode word boundary
-    return documentCacher.find_word_boundary_helper_for_unicode_cached(target_position, true);
+    return cacher.find_word_boundary_helper_for_unicode_cached(target_position, true);
 }
 
 /**
@@ -425,10 +593,12 @@ size_t LeafraChunker::find_word_boundary(const std::string& text,
  * @return TextChunk object with content view and metadata
  */
 TextChunk LeafraChunker::create_chunk(const std::string& text,
+                                     const UnicodeCacher& cacher,
                                      size_t start,
                                      size_t end,
                                      size_t page_number,
-                                     size_t global_start) {
+                                     size_t global_start,
+                                     bool trim_whitespace) const {
     if (start >= text.length() || end > text.length() || start >= end) {
         
         return TextChunk(std::string_view(), start, end, page_number);
@@ -451,12 +621,12 @@ TextChunk LeafraChunker::create_chunk(const std::string& text,
     }
     
     // SECOND: Trim leading and trailing whitespace if preserve_word_boundaries is enabled
-    if (default_options_.preserve_word_boundaries && content_start < content_end) {
+    if (trim_whitespace && content_start < content_end) {
         // Find content start by skipping leading Unicode whitespace
         size_t trimmed_start = content_start;
         while (trimmed_start < content_end) {
             size_t next_pos;
-            UChar32 c = documentCacher.get_unicode_char_at_cached(trimmed_start, next_pos);
+            UChar32 c = cacher.get_unicode_char_at_cached(trimmed_start, next_pos);
             if (c == U_SENTINEL || !is_unicode_whitespace(c)) {
                 break;
             }
@@ -467,18 +637,10 @@ TextChunk LeafraChunker::create_chunk(const std::string& text,
         size_t trimmed_end = content_end;
         while (trimmed_end > trimmed_start) {
             // Find the start of the last character before trimmed_end
-            size_t last_char_start = trimmed_start;
-            size_t temp_pos = trimmed_start;
-            
-            while (temp_pos < trimmed_end) {
-                last_char_start = temp_pos;
-                size_t next_temp_pos;
-                UChar32 temp_c = documentCacher.get_unicode_char_at_cached(temp_pos, next_temp_pos);
-                if (temp_c == U_SENTINEL || temp_pos >= trimmed_end) break;
-                temp_pos = next_temp_pos;
-            }
+            size_t last_char_start = std::max(trimmed_start, cacher.get_previous_char_pos_cached(trimmed_end));
+            size_t temp_pos;
             
-            UChar32 c = documentCacher.get_unicode_char_at_cached(last_char_start, temp_pos);
+            UChar32 c = cacher.get_unicode_char_at_cached(last_char_start, temp_pos);
             if (c == U_SENTINEL || !is_unicode_whitespace(c)) {
                 break;
             }
@@ -512,8 +674,8 @@ TextChunk LeafraChunker::create_chunk(const std::string& text,
             }
         }
         
-        // Create zero-copy string_view pointing directly to member variable text
-        // This is safe because text parameter references combined_text_ member variable
+        // Create zero-copy string_view pointing directly into the document text
+        // (owned or borrowed by the ChunkedDocument the chunk ends up in)
         std::string_view chunk_view(text.data() + content_start, content_end - content_start);
         return TextChunk(chunk_view, global_start, global_start + (end - start), page_number);
     } else {
@@ -547,7 +709,9 @@ size_t LeafraChunker::estimate_token_count(std::string_view text, TokenApproxima
  * @param options Chunking configuration options
  * @return End byte position that produces target token count
  */
+template <bool Ascii>
 size_t LeafraChunker::find_optimal_chunk_end(const std::string& text,
+                                            const UnicodeCacher& cacher,
                                             size_t start_pos,
                                             size_t target_tokens,
                                             const ChunkingOptions& options,
@@ -558,20 +722,7 @@ size_t LeafraChunker::find_optimal_chunk_end(const std::string& text,
     }
     
     // Convert start byte position to character position for Unicode-aware processing
-    size_t start_char_pos = 0;  // UTF-8 character position (not bytes)
-    size_t byte_pos = 0;        // Byte position for conversion
-    
-    // Find character position corresponding to start_pos byte position
-    while (byte_pos < start_pos && byte_pos < text.length()) {
-        size_t next_pos;
-        UChar32 c = documentCacher.get_unicode_char_at_cached(byte_pos, next_pos);
-        if (c != U_SENTINEL) {
-            start_char_pos++;  // Count UTF-8 characters
-        }
-        byte_pos = next_pos;
-        
-        if (next_pos <= byte_pos) byte_pos++; // Safety check
-    }
+    size_t start_char_pos = Ascii ? start_pos : cacher.get_char_index_for_byte_pos_cached(start_pos);
     
     // Start with a conservative character estimate
     size_t estimated_chars = static_cast<size_t>(target_tokens * chars_per_token);
@@ -584,11 +735,368 @@ size_t LeafraChunker::find_optimal_chunk_end(const std::string& text,
     size_t final_end_char_pos = std::min(start_char_pos + precise_chars, text_unicode_length);
     
     // Convert final character position back to byte position
-    size_t final_byte_pos = documentCacher.get_byte_pos_for_char_index_cached(final_end_char_pos);
+    size_t final_byte_pos = Ascii ? final_end_char_pos : cacher.get_byte_pos_for_char_index_cached(final_end_char_pos);
     
     return std::min(final_byte_pos, text.length());
 }
 
+//Token Chunker - exact token counts from a real tokenizer
+ResultCode LeafraChunker::token_chunker(const std::string& text,
+                                        const UnicodeCacher& cacher,
+                                        const ChunkingOptions& options,
+                                        std::vector<TextChunk>& chunks,
+                                        ChunkingScratch& scratch) const {
+    chunks.clear();
+    if (text.empty()) {
+        return ResultCode::SUCCESS;
+    }
+    
+    // Tokenize the whole document once; chunks take slices of these IDs
+    std::vector<int>& ids = scratch.token_ids;
+    TokenOffsets& offsets = scratch.token_offsets;
+    if (!options.tokenizer(text, ids, offsets) || ids.size() != offsets.size()) {
+        LEAFRA_DEBUG_LOG("ERROR", "Tokenizer failed for EXACT_TOKENS chunking");
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    
+    const size_t token_count = ids.size();
+    size_t start = 0;
+    while (start < token_count) {
+        size_t end = std::min(start + options.chunk_size, token_count);
+        if (end < token_count) {
+            end = find_token_boundary(cacher, offsets, start, end, options.preserve_word_boundaries);
+        }
+        
+        size_t start_byte = std::min(offsets[start].first, text.length());
+        size_t end_byte = std::min(std::max(offsets[end - 1].second, start_byte), text.length());
+        TextChunk chunk = create_chunk(text, cacher, start_byte, end_byte, 0, start_byte, options.preserve_word_boundaries);
+        if (!chunk.content.empty()) {
+            chunk.token_ids.assign(ids.begin() + static_cast<std::ptrdiff_t>(start),
+                                   ids.begin() + static_cast<std::ptrdiff_t>(end));
+            chunk.estimated_tokens = chunk.token_ids.size();
+            chunks.push_back(std::move(chunk));
+        }
+        
+        if (end >= token_count) {
+            break;
+        }
+        
+        // Overlap in whole tokens, always advancing by at least one
+        size_t length = end - start;
+        size_t overlap = std::min(static_cast<size_t>(std::round(length * options.overlap_percentage)), length - 1);
+        size_t next = end - overlap;
+        if (options.preserve_word_boundaries) {
+            while (next < end && !token_starts_word(cacher, offsets, next)) {
+                next++;
+            }
+        }
+        start = next;
+    }
+    
+    return ResultCode::SUCCESS;
+} //token_chunker
+
+size_t LeafraChunker::find_token_boundary(const UnicodeCacher& cacher,
+                                          const TokenOffsets& offsets,
+                                          size_t start,
+                                          size_t end,
+                                          bool preserve_word_boundaries) const {
+    // Look back over the last quarter of the chunk at most
+    size_t window = std::max<size_t>(1, (end - start) / 4);
+    size_t lowest = end - std::min(window, end - start - 1);
+    
+    for (size_t token = end; token >= lowest; --token) {
+        if (token_starts_sentence(cacher, offsets, token)) {
+            return token;
+        }
+    }
+    if (preserve_word_boundaries) {
+        for (size_t token = end; token >= lowest; --token) {
+            if (token_starts_word(cacher, offsets, token)) {
+                return token;
+            }
+        }
+    }
+    return end;
+} //find_token_boundary
+
+bool LeafraChunker::token_starts_word(const UnicodeCacher& cacher, const TokenOffsets& offsets, size_t token) const {
+    if (token == 0) {
+        return true;
+    }
+    size_t byte_pos = offsets[token].first;
+    size_t next_pos;
+    UChar32 c = cacher.get_unicode_char_at_cached(byte_pos, next_pos);
+    if (c != U_SENTINEL && is_unicode_whitespace(c)) {
+        return true;                        // SentencePiece-style piece that carries its leading space
+    }
+    if (byte_pos == 0) {
+        return true;
+    }
+    c = cacher.get_unicode_char_at_cached(cacher.get_previous_char_pos_cached(byte_pos), next_pos);
+    return c != U_SENTINEL && is_unicode_whitespace(c);
+} //token_starts_word
+
+bool LeafraChunker::token_starts_sentence(const UnicodeCacher& cacher, const TokenOffsets& offsets, size_t token) const {
+    if (token == 0) {
+        return true;
+    }
+    // Skip whitespace backwards from the token, then look for terminal punctuation
+    size_t byte_pos = offsets[token].first;
+    size_t next_pos;
+    UChar32 c = cacher.get_unicode_char_at_cached(byte_pos, next_pos);
+    bool saw_space = c != U_SENTINEL && is_unicode_whitespace(c);
+    if (c == '\n') {
+        return true;
+    }
+    while (byte_pos > 0) {
+        size_t prev_pos = cacher.get_previous_char_pos_cached(byte_pos);
+        c = cacher.get_unicode_char_at_cached(prev_pos, next_pos);
+        if (c == U_SENTINEL || !is_unicode_whitespace(c)) {
+            break;
+        }
+        if (c == '\n') {
+            return true;                    // Line and paragraph breaks count as sentence ends
+        }
+        saw_space = true;
+        byte_pos = prev_pos;
+    }
+    if (byte_pos == 0) {
+        return true;
+    }
+    bool full_width = c == 0x3002 || c == 0xFF01 || c == 0xFF1F;   // 。！？ need no trailing space
+    return (saw_space && (c == '.' || c == '!' || c == '?')) || full_width;
+} //token_starts_sentence
+
+//Sentence Chunker - whole sentences packed up to the token budget
+
+namespace {
+
+enum class LineKind { BLANK, PROSE, HEADING, TABLE_ROW };
+
+/**
+ * Classify one line of text for sentence chunking
+ * @param line The line (its line break included)
+ * @param at_block_start Whether the line follows a blank line, heading, table or the start of the text
+ */
+LineKind classify_line(std::string_view line, bool at_block_start) {
+    size_t first = line.find_first_not_of(" \t\r\n\f\v");
+    if (first == std::string_view::npos) {
+        return LineKind::BLANK;
+    }
+    size_t last = line.find_last_not_of(" \t\r\n\f\v");
+    std::string_view content = line.substr(first, last - first + 1);
+    
+    // Pipe- or tab-separated cells
+    if (std::count(content.begin(), content.end(), '|') >= 2 || std::count(content.begin(), content.end(), '\t') >= 2) {
+        return LineKind::TABLE_ROW;
+    }
+    if (content[0] == '#') {
+        return LineKind::HEADING;                   // Markdown heading
+    }
+    
+    // A short line on its own that doesn't end like a sentence: "3.2 Results", "Introduction"
+    if (!at_block_start || content.size() > 80) {
+        return LineKind::PROSE;
+    }
+    unsigned char lead = static_cast<unsigned char>(content[0]);
+    if (lead >= 'a' && lead <= 'z') {
+        return LineKind::PROSE;
+    }
+    if (std::string_view(".!?:;,").find(content.back()) != std::string_view::npos) {
+        return LineKind::PROSE;
+    }
+    std::string_view tail3 = content.size() >= 3 ? content.substr(content.size() - 3) : std::string_view();
+    if (tail3 == "\xE3\x80\x82" || tail3 == "\xEF\xBC\x81" || tail3 == "\xEF\xBC\x9F") {
+        return LineKind::PROSE;                     // 。！？
+    }
+    size_t words = 1 + static_cast<size_t>(std::count(content.begin(), content.end(), ' '));
+    bool has_letter = std::any_of(content.begin(), content.end(), [](char c) {
+        unsigned char b = static_cast<unsigned char>(c);
+        return b >= 0x80 || std::isalpha(b);
+    });
+    return words <= 10 && has_letter ? LineKind::HEADING : LineKind::PROSE;
+}
+
+} // namespace
+
+void LeafraChunker::find_sentence_units(const std::string& text,
+                                        const ChunkingOptions& options,
+                                        std::vector<SentenceUnit>& units) const {
+    units.clear();
+    std::vector<size_t> boundaries;
+    std::string paragraph;                          // Copy with line breaks blanked, so wrapped lines don't end sentences
+    size_t paragraph_begin = std::string::npos;
+    size_t paragraph_end = 0;
+    bool in_table = false;
+    
+    auto add_unit = [&](size_t begin, size_t end, bool block_start, bool heading) {
+        std::string_view unit_text(text.data() + begin, end - begin);
+        if (unit_text.find_first_not_of(" \t\r\n\f\v") == std::string_view::npos) {
+            return;
+        }
+        SentenceUnit unit;
+        unit.begin = begin;
+        unit.end = end;
+        unit.tokens = std::max<size_t>(1, estimate_token_count(unit_text, options.token_method));
+        unit.block_start = block_start;
+        unit.heading = heading;
+        units.push_back(unit);
+    };
+    
+    auto flush_paragraph = [&]() {
+        if (paragraph_begin == std::string::npos) {
+            return;
+        }
+        paragraph.assign(text, paragraph_begin, paragraph_end - paragraph_begin);
+        std::replace(paragraph.begin(), paragraph.end(), '\n', ' ');
+        std::replace(paragraph.begin(), paragraph.end(), '\r', ' ');
+        find_sentence_boundaries(paragraph, boundaries);
+        size_t previous = 0;
+        size_t first_unit = units.size();
+        for (size_t boundary : boundaries) {
+            if (boundary > previous) {
+                add_unit(paragraph_begin + previous, paragraph_begin + boundary, units.size() == first_unit, false);
+            }
+            previous = boundary;
+        }
+        paragraph_begin = std::string::npos;
+    };
+    
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t newline = text.find('\n', pos);
+        size_t line_end = newline == std::string::npos ? text.size() : newline + 1;
+        LineKind kind = classify_line(std::string_view(text.data() + pos, line_end - pos),
+                                      paragraph_begin == std::string::npos);
+        switch (kind) {
+            case LineKind::BLANK:
+                flush_paragraph();
+                in_table = false;
+                break;
+            case LineKind::TABLE_ROW:
+                flush_paragraph();
+                if (in_table && !units.empty()) {
+                    units.back().joined_to_next = true;
+                }
+                add_unit(pos, line_end, !in_table, false);
+                in_table = true;
+                break;
+            case LineKind::HEADING:
+                flush_paragraph();
+                add_unit(pos, line_end, true, true);
+                in_table = false;
+                break;
+            case LineKind::PROSE:
+                if (paragraph_begin == std::string::npos) {
+                    paragraph_begin = pos;
+                }
+                paragraph_end = line_end;
+                in_table = false;
+                break;
+        }
+        pos = line_end;
+    }
+    flush_paragraph();
+} //find_sentence_units
+
+ResultCode LeafraChunker::sentence_chunker(const std::string& text,
+                                           const UnicodeCacher& cacher,
+                                           const ChunkingOptions& options,
+                                           std::vector<TextChunk>& chunks) const {
+    chunks.clear();
+    try {
+        std::vector<SentenceUnit> units;
+        find_sentence_units(text, options, units);
+        const size_t unit_count = units.size();
+        if (unit_count == 0) {
+            return ResultCode::SUCCESS;
+        }
+        
+        const size_t budget = options.chunk_size;
+        const size_t overlap_budget = static_cast<size_t>(budget * options.overlap_percentage);
+        std::vector<size_t> prefix(unit_count + 1, 0);
+        for (size_t i = 0; i < unit_count; ++i) {
+            prefix[i + 1] = prefix[i] + units[i].tokens;
+        }
+        auto tokens_in = [&prefix](size_t first, size_t last) { return prefix[last] - prefix[first]; };
+        auto emit = [&](size_t begin, size_t end) {
+            TextChunk chunk = create_chunk(text, cacher, begin, end, 0, begin, true);
+            if (!chunk.content.empty()) {
+                chunk.estimated_tokens = estimate_token_count(chunk.content, options.token_method);
+                chunks.push_back(chunk);
+            }
+        };
+        
+        size_t start = 0;                           // First unit of the current chunk
+        size_t fresh = 0;                           // First unit not carried over as overlap
+        for (size_t i = 0; i < unit_count; ++i) {
+            if (units[i].tokens > budget) {
+                // A sentence longer than the budget: close the chunk, then cut the sentence at word boundaries
+                if (i > fresh) {
+                    emit(units[start].begin, units[i - 1].end);
+                }
+                const size_t max_bytes = std::max<size_t>(1, static_cast<size_t>(budget * SIMPLE_CHARS_PER_TOKEN));
+                size_t piece = units[i].begin;
+                while (piece < units[i].end) {
+                    size_t piece_end = units[i].end;
+                    if (piece_end - piece > max_bytes) {
+                        size_t target = ensure_utf8_boundary(text, piece + max_bytes);
+                        piece_end = find_word_boundary(text, cacher, target, 100);
+                        if (piece_end <= piece || piece_end > units[i].end) {
+                            piece_end = target;
+                        }
+                    }
+                    emit(piece, piece_end);
+                    piece = piece_end;
+                }
+                start = fresh = i + 1;
+                continue;
+            }
+            
+            while (i > start && (units[i].heading || tokens_in(start, i + 1) > budget)) {
+                size_t split = i;
+                if (!units[i].heading) {
+                    // Prefer ending where a paragraph or table starts, if the chunk stays at least half full
+                    for (size_t j = i; j > fresh && tokens_in(start, j) >= budget / 2; --j) {
+                        if (units[j].block_start && !units[j - 1].joined_to_next) {
+                            split = j;
+                            break;
+                        }
+                    }
+                }
+                if (split <= fresh) {
+                    start = fresh = i;                  // Only carried overlap left - drop it
+                    break;
+                }
+                emit(units[start].begin, units[split - 1].end);
+                
+                // Carry trailing whole sentences as overlap, as long as they still fit with unit i
+                size_t next = split;
+                if (!units[split].heading) {
+                    while (next - 1 > start && !units[next - 1].heading &&
+                           tokens_in(next - 1, split) <= overlap_budget && tokens_in(next - 1, i + 1) <= budget) {
+                        next--;
+                    }
+                }
+                start = next;
+                fresh = split;
+            }
+        }
+        if (fresh < unit_count) {
+            emit(units[start].begin, units[unit_count - 1].end);
+        }
+        
+        LEAFRA_DEBUG_LOG("CHUNKING", "Sentence chunking packed " + std::to_string(unit_count) + " units into " +
+                         std::to_string(chunks.size()) + " chunks");
+        return ResultCode::SUCCESS;
+        
+    } catch (const std::exception&) {
+        chunks.clear();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+} //sentence_chunker
+
 /**
  * Estimate how many characters needed to produce target token count
  * @param text UTF-8 text to sample from
@@ -616,8 +1124,7 @@ size_t LeafraChunker::estimate_characters_for_tokens(const std::string& text,
         if (c != U_SENTINEL) {
             start_char_pos++;
         }
-        byte_pos = next_pos;
-        if (next_pos <= byte_pos) byte_pos++; // Safety check
+        byte_pos = next_pos > byte_pos ? next_pos : byte_pos + 1; // Always make progress
     }
     
     // Use local token density if we have enough context
@@ -645,7 +1152,8 @@ size_t LeafraChunker::estimate_characters_for_tokens(const std::string& text,
  * @param pos Starting byte position
  * @return Byte position of next word start, or text length if none found
  */
-size_t LeafraChunker::find_next_word_start(const std::string& text, size_t pos) const {
+template <bool Ascii>
+size_t LeafraChunker::find_next_word_start(const std::string& text, const UnicodeCacher& cacher, size_t pos) const {
     if (pos >= text.length()) {
         return text.length();
     }
@@ -655,69 +1163,39 @@ size_t LeafraChunker::find_next_word_start(const std::string& text, size_t pos)
         return 0;
     }
     
-    // Check if we're already at the start of a word using Unicode-aware detection
+    using ByteClass = UnicodeCacher::ByteClass;
     size_t next_pos;
-    UChar32 current_c = documentCacher.get_unicode_char_at_cached(pos, next_pos);
-    
-    if (current_c != U_SENTINEL && !is_unicode_whitespace(current_c)) {
-        // Check if previous character is whitespace
-        if (pos > 0) {
-            // Find previous character position
-            size_t prev_pos = 0;
-            size_t temp_pos = 0;
-            
-            while (temp_pos < pos && temp_pos < text.length()) {
-                prev_pos = temp_pos;
-                size_t next_temp_pos;
-                UChar32 temp_c = documentCacher.get_unicode_char_at_cached(temp_pos, next_temp_pos);
-                if (temp_c == U_SENTINEL || temp_pos >= pos) break;
-                temp_pos = next_temp_pos;
-            }
-            
-            UChar32 prev_c = documentCacher.get_unicode_char_at_cached(prev_pos, temp_pos);
-            if (prev_c != U_SENTINEL && is_unicode_whitespace(prev_c)) {
-                // We're at the start of a word
-                return pos;
-            }
-        }
+    bool in_word;
+    if (Ascii) {
+        // Every byte is a valid character, classified when the cacher indexed the text
+        in_word = !cacher.byte_in_class(ByteClass::WHITESPACE, pos);
+    } else {
+        UChar32 current_c = cacher.get_unicode_char_at_cached(pos, next_pos);
+        in_word = (current_c != U_SENTINEL && !is_unicode_whitespace(current_c));
     }
     
-    // Advance to the next word boundary
-    size_t byte_pos = pos;
-    bool in_word = (current_c != U_SENTINEL && !is_unicode_whitespace(current_c));
-    
-    while (byte_pos < text.length()) {
-        UChar32 c = documentCacher.get_unicode_char_at_cached(byte_pos, next_pos);
-        if (c == U_SENTINEL) {
-            byte_pos = next_pos;
-            continue;
+    if (in_word) {
+        // A word character after whitespace is already a word start
+        if (cacher.byte_in_class(ByteClass::WHITESPACE, pos - 1)) {
+            return pos;
         }
-        
-        bool is_whitespace = is_unicode_whitespace(c);
-        
-        if (in_word && is_whitespace) {
-            // We've reached the end of current word, now skip whitespace
-            byte_pos = next_pos;
-            break;
-        } else if (!in_word && !is_whitespace) {
-            // We've found the start of the next word
-            return byte_pos;
-        }
-        
-        in_word = !is_whitespace;
-        byte_pos = next_pos;
+        // Otherwise skip the rest of this word and the whitespace after it
+        size_t space_start = cacher.find_next_byte(ByteClass::WHITESPACE, true, pos, text.length());
+        return cacher.find_next_byte(ByteClass::WHITESPACE, false, space_start, text.length());
     }
     
-    // Skip remaining whitespace to find the start of the next word
-    while (byte_pos < text.length()) {
-        UChar32 c = documentCacher.get_unicode_char_at_cached(byte_pos, next_pos);
-        if (c == U_SENTINEL || !is_unicode_whitespace(c)) {
-            break;
+    // On whitespace (or an invalid byte): the next valid non-whitespace character
+    if (Ascii) {
+        return cacher.find_next_byte(ByteClass::WHITESPACE, false, pos, text.length());
+    }
+    size_t byte_pos = pos;
+    while ((byte_pos = cacher.find_next_byte(ByteClass::WHITESPACE, false, byte_pos, text.length())) < text.length()) {
+        if (cacher.get_unicode_char_at_cached(byte_pos, next_pos) != U_SENTINEL) {
+            return byte_pos;
         }
         byte_pos = next_pos;
     }
-    
-    return byte_pos;
+    return text.length();
 }
 
 /**
@@ -741,7 +1219,7 @@ size_t LeafraChunker::tokens_to_characters(size_t token_count, TokenApproximatio
  * @param options Chunking options
  * @return Actual characters per token ratio for this text
  */
-double LeafraChunker::sample_text_density(const std::string& text, const ChunkingOptions& options) const {
+double LeafraChunker::sample_text_density(const std::string& text, const UnicodeCacher& cacher, const ChunkingOptions& options) const {
     if (text.empty()) {
         return SIMPLE_CHARS_PER_TOKEN; // Fall back to default
     }
@@ -750,7 +1228,7 @@ double LeafraChunker::sample_text_density(const std::string& text, const Chunkin
     const size_t sample_size_chars = 200;  // Sample 200 characters at a time
     const size_t max_samples = 5;          // Take up to 5 samples
     
-    size_t text_unicode_length = documentCacher.get_unicode_length_cached();
+    size_t text_unicode_length = cacher.get_unicode_length_cached();
     size_t available_samples = std::min(max_samples, text_unicode_length / sample_size_chars);
     
     if (available_samples == 0) {
@@ -769,7 +1247,7 @@ double LeafraChunker::sample_text_density(const std::string& text, const Chunkin
         size_t sample_char_count = sample_end_char - sample_start_char;
         
         if (sample_char_count > 0) {
-            std::string sample = documentCacher.get_utf8_substring_cached(sample_start_char, sample_char_count);
+            std::string sample = cacher.get_utf8_substring_cached(sample_start_char, sample_char_count);
             size_t sample_tokens = estimate_token_count(sample, options.token_method);
             
             if (sample_tokens > 0) {
@@ -792,4 +1270,98 @@ double LeafraChunker::sample_text_density(const std::string& text, const Chunkin
     return SIMPLE_CHARS_PER_TOKEN; // Fall back to default
 }
 
+// STREAMING CHUNKER
+
+StreamingChunker::StreamingChunker(const LeafraChunker& chunker, ChunkingOptions options, ChunkSink sink)
+    : chunker_(chunker), options_(std::move(options)), sink_(std::move(sink)) {
+    if (options_.size_unit == ChunkSizeUnit::EXACT_TOKENS) {
+        LEAFRA_DEBUG_LOG("ERROR", "EXACT_TOKENS chunking is not supported by StreamingChunker");
+        status_ = ResultCode::ERROR_INVALID_PARAMETER;
+    } else if (!sink_) {
+        LEAFRA_DEBUG_LOG("ERROR", "StreamingChunker needs a chunk sink");
+        status_ = ResultCode::ERROR_INVALID_PARAMETER;
+    } else {
+        status_ = LeafraChunker::normalize_options(options_);
+    }
+}
+
+ResultCode StreamingChunker::add_page(std::string_view page) {
+    if (status_ != ResultCode::SUCCESS) {
+        return status_;
+    }
+    if (finished_) {
+        LEAFRA_DEBUG_LOG("ERROR", "add_page called on a finished stream");
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    // Same layout as chunk_document: pages joined by a blank line
+    if (!page_starts_.empty()) {
+        buffer_ += "\n\n";
+    }
+    page_starts_.push_back(buffer_offset_ + buffer_.size());
+    buffer_.append(page.data(), page.size());
+    
+    // The density is sampled once, so wait until there is enough text to sample from
+    if (chars_per_token_ == 0.0 && buffer_.size() < STREAM_DENSITY_SAMPLE_BYTES) {
+        return ResultCode::SUCCESS;
+    }
+    return process(false);
+}
+
+ResultCode StreamingChunker::finish() {
+    if (status_ != ResultCode::SUCCESS || finished_) {
+        return status_;
+    }
+    finished_ = true;
+    if (buffer_.empty()) {
+        return ResultCode::SUCCESS;
+    }
+    status_ = process(true);
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    return status_;
+}
+
+ResultCode StreamingChunker::process(bool final_window) {
+    cacher_.reinitialize(buffer_);
+    if (chars_per_token_ == 0.0) {
+        chars_per_token_ = chunker_.sample_text_density(buffer_, cacher_, options_);
+    }
+    
+    pending_.clear();
+    size_t resume_pos = cursor_;
+    ResultCode result = chunker_.chunk_window(buffer_, cacher_, options_, chars_per_token_, cursor_,
+                                              final_window, chunk_count_ > 0, pending_, resume_pos);
+    if (result != ResultCode::SUCCESS) {
+        status_ = result;
+        return status_;
+    }
+    
+    for (auto& chunk : pending_) {
+        chunk.start_index += buffer_offset_;
+        chunk.end_index += buffer_offset_;
+        LeafraChunker::assign_page_range(page_starts_, buffer_, buffer_offset_, chunk);
+        chunk_count_++;
+        if (!sink_(chunk)) {
+            LEAFRA_DEBUG_LOG("CHUNKING", "Chunk sink stopped the stream after " + std::to_string(chunk_count_) + " chunks");
+            status_ = ResultCode::ERROR_CANCELLED;
+            return status_;
+        }
+    }
+    pending_.clear();
+    
+    // Drop consumed text, keeping some context before the cursor for backward boundary searches
+    if (!final_window && resume_pos > STREAM_BACKTRACK_BYTES) {
+        size_t keep_from = resume_pos - STREAM_BACKTRACK_BYTES;
+        while (keep_from < resume_pos && (static_cast<unsigned char>(buffer_[keep_from]) & 0xC0) == 0x80) {
+            keep_from++;
+        }
+        buffer_.erase(0, keep_from);
+        buffer_offset_ += keep_from;
+        resume_pos -= keep_from;
+    }
+    cursor_ = resume_pos;
+    return ResultCode::SUCCESS;
+}
+
 } // namespace leafra
@@ -7,9 +7,49 @@
 #include "leafra/leafra_chunker.h"
 #include "leafra/leafra_sentencepiece.h"
 #include "leafra/leafra_debug.h"
+#include "leafra/leafra_trace.h"
+#include "leafra/leafra_events.h"
 #include "leafra/leafra_filemanager.h"
 #include "leafra/leafra_sqlite.h"
+#include "leafra/leafra_threadpool.h"
+#include "leafra/leafra_governor.h"
+#include "leafra/leafra_ingestion_scheduler.h"
+#include "leafra/leafra_admission.h"
+#include "leafra/leafra_batcher.h"
+#include "leafra/leafra_autotune.h"
+#include "leafra/leafra_arena.h"
+#include "leafra/leafra_embedding.h"
+#include "leafra/leafra_cache.h"
+#include "leafra/leafra_vector_codec.h"
+#include "leafra/leafra_text_codec.h"
+#include "leafra/leafra_simd.h"
+#include "leafra/leafra_simhash.h"
+#include "leafra/leafra_chunk_quality.h"
+#include "leafra/leafra_text_normalizer.h"
+#include "leafra/leafra_hash.h"
+#include "leafra/leafra_parse_cache.h"
+#include "leafra/leafra_metrics.h"
+#include "leafra/leafra_large_pages.h"
+#include "leafra/leafra_bundle.h"
+#include "leafra/leafra_unicode.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <condition_variable>
 #include <filesystem>
+#include <future>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <queue>
+#include <shared_mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -21,21 +61,6 @@
 #include "fpdf_doc.h"
 #endif
 
-#ifdef LEAFRA_HAS_COREML
-// CoreML interface header
-#include "leafra/leafra_coreml.h"
-#endif
-
-#ifdef LEAFRA_HAS_TENSORFLOWLITE
-// TensorFlow Lite C API headers - start with core functionality only
-#include "c_api.h"
-#include "c_api_types.h"
-#include "builtin_ops.h"
-
-// Note: Starting with core TensorFlow Lite functionality only
-// Delegates will be added in a future update
-#endif
-
 #ifdef LEAFRA_HAS_FAISS
 // FAISS interface header for enum conversion methods
 #include "leafra/leafra_faiss.h"
@@ -53,12 +78,14 @@ ChunkingConfig::ChunkingConfig() {
     // Default values are already set in the header with sensible defaults for LLM processing
     size_unit = ChunkSizeUnit::TOKENS;
     token_method = TokenApproximationMethod::SIMPLE;
+    strategy = ChunkingStrategy::FIXED;
 }
 
 ChunkingConfig::ChunkingConfig(size_t size, double overlap, bool use_tokens) 
     : chunk_size(size), overlap_percentage(overlap) {
     size_unit = use_tokens ? ChunkSizeUnit::TOKENS : ChunkSizeUnit::CHARACTERS;
     token_method = TokenApproximationMethod::SIMPLE;
+    strategy = ChunkingStrategy::FIXED;
 }
 
 //TODO AD: Move these to leafra_faiss.cpp 
@@ -70,7 +97,11 @@ static FaissIndex::IndexType get_faiss_index_type_from_string(const std::string&
     if (index_type == "IVF_PQ") return FaissIndex::IndexType::IVF_PQ;
     if (index_type == "HNSW") return FaissIndex::IndexType::HNSW;
     if (index_type == "LSH") return FaissIndex::IndexType::LSH;
-    return FaissIndex::IndexType::FLAT; // Default fallback
+    if (index_type == "SQ8") return FaissIndex::IndexType::SQ8;
+    if (index_type == "SQ_FP16") return FaissIndex::IndexType::SQ_FP16;
+    if (index_type == "HNSW_SQ") return FaissIndex::IndexType::HNSW_SQ;
+    if (index_type == "BINARY") return FaissIndex::IndexType::BINARY;
+    return FaissIndex::IndexType::FLAT; // Default fallback (also the starting type of "AUTO")
 }
 
 static FaissIndex::MetricType get_faiss_metric_type_from_string(const std::string& metric) {
@@ -79,6 +110,116 @@ static FaissIndex::MetricType get_faiss_metric_type_from_string(const std::strin
     if (metric == "COSINE") return FaissIndex::MetricType::COSINE;
     return FaissIndex::MetricType::COSINE; // Default fallback
 }
+
+#ifdef LEAFRA_HAS_SQLITE
+// Turn free-form user text into an FTS5 MATCH expression: every whitespace-separated
+// word becomes a quoted phrase (so "AB-1234" stays an exact adjacent match and FTS5
+// operators in the input are never interpreted), and phrases are OR'ed for BM25 ranking.
+static std::string build_keyword_match_expression(const std::string& query) {
+    std::string expression;
+    size_t pos = 0;
+    while (pos < query.size()) {
+        while (pos < query.size() && std::isspace(static_cast<unsigned char>(query[pos]))) {
+            pos++;
+        }
+        size_t end = pos;
+        bool has_word_char = false;
+        while (end < query.size() && !std::isspace(static_cast<unsigned char>(query[end]))) {
+            unsigned char c = static_cast<unsigned char>(query[end]);
+            has_word_char = has_word_char || std::isalnum(c) || c >= 0x80;
+            end++;
+        }
+        if (has_word_char) {
+            if (!expression.empty()) {
+                expression += " OR ";
+            }
+            expression += '"';
+            for (size_t i = pos; i < end; ++i) {
+                if (query[i] == '"') {
+                    expression += '"';
+                }
+                expression += query[i];
+            }
+            expression += '"';
+        }
+        pos = end;
+    }
+    return expression;
+}
+#endif
+#endif
+
+/**
+ * @brief Size and modification time of a file, taken while enumerating a directory
+ */
+struct EnumeratedFile {
+    int64_t file_size = -1;                    // Bytes on disk
+    int64_t file_mtime = 0;                    // Last write time in file clock ticks
+};
+
+/**
+ * @brief Shared state between an IngestionJob handle and the thread running it
+ */
+struct IngestionJob::State {
+    std::vector<std::string> file_paths;
+    std::vector<EnumeratedFile> file_stats;    // Parallel to file_paths for directory jobs (paths are canonical), else empty
+    std::vector<std::string> removed_paths;    // Deleted files whose documents are removed before ingesting (watch jobs)
+    std::vector<std::string> collections;      // Collection per file, parallel to file_paths (resumed jobs), else empty = options.collection
+    std::shared_future<ResultCode> previous;   // Job that must finish first (watch jobs apply changes in order)
+    IngestionOptions options;
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> done{false};
+    std::atomic<size_t> finished_files{0};
+    std::atomic<size_t> failed_files{0};
+    std::mutex callback_mutex;                 // Serializes progress callbacks from pool workers
+    std::promise<ResultCode> promise;
+    std::shared_future<ResultCode> future;
+    
+    State() : future(promise.get_future().share()) {}
+};
+
+#ifdef LEAFRA_HAS_FAISS
+/**
+ * @brief Shared state between a SearchSession handle and the searches running for it
+ */
+struct SearchSession::State {
+    using RunFunction = std::function<ResultCode(State& session, uint64_t ticket, const std::string& query, int max_results,
+                                                 std::vector<FaissIndex::SearchResult>& results)>;
+    
+    Options options;
+    RunFunction run;                                        // LeafraCore::Impl::searchSessionQuery
+    mutable std::mutex mutex;
+    std::condition_variable input_cv;                       // Newer input arrived
+    std::atomic<uint64_t> generation{0};                    // Ticket of the newest search; any other is stale
+    std::vector<FaissIndex::SearchResult> previous;         // Ranking of the last completed search (ids only), seeds the next
+    std::unordered_map<int64_t, FaissIndex::SearchResult> rows;  // Hydrated hits by FAISS id
+    uint64_t rows_generation = 0;                           // Index generation the rows were read at
+    Stats stats;
+    
+    bool stale(uint64_t ticket) const { return generation.load() != ticket; }
+};
+
+/**
+ * @brief What a SearchCursor carries from one page to the next
+ */
+struct SearchCursor::State {
+    const void* owner = nullptr;                            // LeafraCore::Impl the cursor belongs to
+    std::vector<float> query_embedding;
+    std::vector<std::shared_ptr<FaissIndex>> shards;        // Snapshot searched by every page
+    FaissIndex::SearchParams params;                        // Resolved probe settings
+    int page_size = 0;
+    int fetched_k = 0;                                      // k of the last index search
+    std::vector<FaissIndex::SearchResult> candidates;       // Its ranking (ids and scores), best first
+    std::unordered_set<int64_t> returned;                   // Ids already hydrated into a page
+    bool exhausted = false;                                 // The last search found fewer than k: nothing more to fetch
+    mutable std::mutex mutex;
+    
+    size_t unreturned() const {
+        return static_cast<size_t>(std::count_if(candidates.begin(), candidates.end(), [this](const FaissIndex::SearchResult& hit) {
+            return returned.count(hit.id) == 0;
+        }));
+    }
+};
 #endif
 
 // Private implementation class (PIMPL pattern)
@@ -87,41 +228,243 @@ public:
     Config config_;
     bool initialized_;
     callback_t event_callback_;
+    event_callback_t typed_event_callback_;
     std::unique_ptr<DataProcessor> data_processor_;
     std::unique_ptr<MathUtils> math_utils_;
     std::unique_ptr<FileParsingWrapper> file_parser_;
+    std::unique_ptr<ParseCache> parse_cache_;  // Parsed page text by content hash (null unless parsing.cache_enabled)
     std::unique_ptr<LeafraChunker> chunker_;
-    std::unique_ptr<SentencePieceTokenizer> tokenizer_;
+    std::shared_ptr<const SentencePieceTokenizer> tokenizer_;  // Shared with other instances using the same model (acquire_shared)
+    std::unique_ptr<ThreadPool> worker_pool_;   // Ingestion pool sized from Config::max_threads (utility QoS)
+    std::unique_ptr<ThreadPool> query_pool_;    // Query fan-out pool (user-initiated QoS), so searches never queue behind ingestion
+    std::unique_ptr<ThreadPool> request_pool_;  // Runs semantic_search_async / semantic_search_with_llm_async requests
+    std::atomic<bool> requests_cancelled_{false}; // Set by shutdown: queued async requests complete as cancelled
+    ThreadBudget thread_budget_;                // Threads handed to each engine (resolved in initialize)
+    ThroughputGovernor governor_;               // Scales the budget down when hot / on battery, holds ingestion back during queries
+    AdmissionController admission_;             // Bounds concurrent embedder / index / LLM use, interactive calls first
+    
+    // Concurrent searches share one query embedding inference (vector_search.query_batch_size; null = each search alone)
+    struct QueryEmbedRequest {
+        std::string text;                       // Prefixed query
+        std::vector<int> token_ids;             // Empty for text-based backends
+    };
+    struct QueryEmbedResult {
+        ResultCode code = ResultCode::ERROR_PROCESSING_FAILED;
+        std::vector<float> embedding;
+    };
+    std::unique_ptr<MicroBatcher<QueryEmbedRequest, QueryEmbedResult>> query_embed_batcher_;
+    std::atomic<int32_t> llm_applied_threads_{0};        // LLM thread counts last handed to the model
+    std::atomic<int32_t> llm_applied_batch_threads_{0};
+    DeviceProfile device_profile_;              // autotune() results for this device (device empty = none)
+    int32_t configured_llm_threads_ = -1;       // LLM thread counts as configured, before the device profile (> 0 = explicit, not tuned)
+    int32_t configured_llm_batch_threads_ = -1;
+    PipelineMetricsRecorder metrics_;           // Per-stage latency histograms (get_metrics)
+    mutable std::mutex ingest_report_mutex_;
+    std::vector<IngestDocumentReport> ingest_report_;   // Counters of the last ingestion run (get_last_ingest_report)
+    EventDispatcher events_;                    // Delivers events to the callbacks, inline or from a dispatcher thread
+    MemoryAccountant::Reservation faiss_memory_{MemorySubsystem::FAISS_INDEX};    // This instance's share, refreshed by pollMemoryUsage
+    MemoryAccountant::Reservation llm_kv_memory_{MemorySubsystem::LLM_KV_CACHE};
+    MemoryAccountant::Reservation llm_weight_memory_{MemorySubsystem::LLM_WEIGHTS};
+    MemoryAccountant::Reservation query_cache_memory_{MemorySubsystem::QUERY_CACHES};
+    std::vector<std::unique_ptr<MemoryAccountant::Reclaimer> > reclaimers_;   // Registered while initialized (registerReclaimers)
+    static inline std::atomic<uint64_t> chunking_scratch_epoch_{0};          // Bumped to make every worker drop its ChunkingScratch
+    std::atomic<bool> memory_over_budget_{false};    // Pressure was handled for the current excursion over budget
+    std::mutex ingestion_mutex_;                // One ingestion run at a time (store stage is single-threaded)
+    IngestionScheduler ingestion_scheduler_;    // Which run goes next, and the order of files within runs (bump_priority)
+    
+    // Background ingestion jobs started by process_user_files_async
+    struct AsyncIngestion {
+        std::shared_ptr<IngestionJob::State> state;
+        std::thread thread;
+    };
+    std::vector<AsyncIngestion> async_jobs_;
+    std::mutex async_jobs_mutex_;
+    
+    // Directory kept indexed by watch_directory
+    std::unique_ptr<FileWatcher> file_watcher_;
+    IngestionOptions watch_options_;
+    std::shared_future<ResultCode> last_watch_job_;  // Written by the watcher thread only
+    
+    // Online backups (backup_database / backup_database_async), one at a time
+    std::mutex backup_mutex_;                   // Held by the running backup
+    std::atomic<bool> backup_cancelled_{false}; // Set by shutdown: the running backup stops after its current step
+    std::thread backup_thread_;                 // Driver of the last backup_database_async
+    std::shared_future<ResultCode> backup_job_;
+    std::mutex backup_job_mutex_;               // Guards backup_thread_ and backup_job_
+    mutable std::shared_mutex model_swap_mutex_; // Shared while a call embeds queries or searches shards (ModelUse), exclusive while the model is replaced
+    
+    // Idle-time space reclamation (runs while database.vacuum_pages_per_slice > 0)
+    std::atomic<std::chrono::steady_clock::rep> database_last_used_{0};  // Last ingestion run or search hydration
+    std::atomic<uint64_t> vacuumed_pages_{0};   // Pages returned to the file system since initialize
+    std::thread vacuum_thread_;
+    std::mutex vacuum_mutex_;
+    std::condition_variable vacuum_cv_;
+    bool stop_vacuum_ = false;
+    
+    std::atomic<bool> warmup_cancelled_{false}; // Set by shutdown: the startup warm-up (prefetch_after_initialize) stops after its current step
+    
+    // Read-only attach to a store another process writes (attach_read_only)
+    bool attached_ = false;
+    std::mutex attach_refresh_mutex_;           // Held by the search checking for the writer's commits
+    int64_t attached_data_version_ = -1;        // PRAGMA data_version the open shards were restored at
+    std::chrono::steady_clock::time_point attach_checked_at_;
+    
+    /**
+     * @brief What a document version is recognised by (docs.url, file_size, file_mtime, content_hash, collection)
+     */
+    struct DocumentFingerprint {
+        std::string collection;                    // Collection the document is indexed in ("" = default)
+        std::string absolute_path;                 // Canonical path, stored as docs.url
+        int64_t file_size = -1;                    // Bytes on disk (-1 if unknown)
+        int64_t file_mtime = 0;                    // Last write time in file clock ticks
+        std::string content_hash;                  // ContentHasher digest of the file bytes (empty if unknown)
+        int64_t doc_id = -1;                       // docs row stored for this path (-1 if none)
+    };
+    using StoredDocumentMap = std::unordered_map<std::string, DocumentFingerprint>;  // Keyed by absolute_path
+    
+    /**
+     * @brief Collection names end up in index file names, so only [A-Za-z0-9_-] (at most 64 chars, "" = default collection) is accepted
+     */
+    static bool isValidCollectionName(const std::string& collection_name) {
+        return collection_name.size() <= 64 &&
+               std::all_of(collection_name.begin(), collection_name.end(), [](unsigned char c) {
+                   return std::isalnum(c) || c == '_' || c == '-';
+               });
+    }
     
 #ifdef LEAFRA_HAS_SQLITE
     // SQLite database for document storage
     std::unique_ptr<SQLiteDatabase> database_;
+    SQLiteReadPool read_pool_;                  // Read-only connections for search lookups (database.read_connections)
+    bool keyword_index_available_ = false;      // chunks_fts exists (SQLite built with FTS5)
+    EmbeddingStorageFormat embedding_storage_format_ = EmbeddingStorageFormat::FP16; // Encoding of chunk_embeddings rows written by ingestion
+    TextCompression chunk_text_compression_ = TextCompression::NONE; // Compression of chunk text written by ingestion
+    bool chunk_text_offsets_ = false;           // database.chunk_text_storage = "offsets": document text stored once, chunks as ranges
+    // Fingerprints of stored chunks by chunk_faiss_id (near_duplicates.enabled), loaded from chunks.chunk_simhash on first use.
+    // Only the store stage touches it; entries of deleted chunks stay until restart and are weeded out when matched.
+    std::unique_ptr<NearDuplicateIndex> near_duplicate_index_;
+    bool embedding_cache_available_ = false;   // embedding_cache table is ready (embedding_inference.cache_enabled)
+    bool chunk_retrievals_available_ = false;  // chunk_retrievals table is ready (prefetch_after_initialize)
+    bool ingestion_queue_available_ = false;   // ingestion_queue table is ready (resume_pending_jobs)
+    bool index_models_available_ = false;      // index_models table is ready (indexes of another embedding model are detected)
+    bool sync_log_available_ = false;          // sync_log table is ready (export_delta)
+    std::unordered_map<int64_t, int64_t> pending_retrievals_;  // Search hits by chunk_faiss_id not yet added to chunk_retrievals
+    std::mutex retrieval_counts_mutex_;        // Guards pending_retrievals_
+    std::atomic<bool> retrieval_flush_queued_{false};  // A flushRetrievalCounts task is waiting on the worker pool
 #endif
 
 #ifdef LEAFRA_HAS_FAISS
-    // FAISS index for vector search
-    std::unique_ptr<FaissIndex> faiss_index_;
+    /**
+     * @brief One collection's FAISS index and where it is persisted
+     */
+    struct FaissCollection {
+        std::string name;                          // "" for the default collection
+        std::string definition;                    // faissindextable / faissdeltatable definition
+        std::shared_ptr<FaissIndex> index;         // Shared so searches keep a shard alive across rebuild_collection
+        bool migration_failed = false;             // Adaptive FLAT -> IVF migration failed this session (not retried)
+        uint64_t generation_base = 0;              // Carried over when rebuild_collection swaps in a fresh index
+        std::vector<float> pending_vectors;        // Ingested rows waiting for the next bulk add (already in the delta log)
+        std::vector<int64_t> pending_ids;          // Their chunk_faiss_ids
+        std::shared_ptr<FaissIndex> hot;           // vector_search.hot_index: the pending rows, searchable until merged (FLAT)
+        std::shared_ptr<FaissIndex> merging;       // Hot index whose rows are being added to index (searched meanwhile)
+        uint64_t hot_generation = 0;               // Bumped whenever the hot tier changes (result cache invalidation)
+        bool stale = false;                        // Vectors of another embedding model than the loaded one (index_models): not searched
+    };
+    
+    // FAISS shards for vector search, by collection name; the default collection ("") exists while vector search is enabled.
+    // The mutex guards the map, the index pointers and the pending rows; ingestion (serialized) is the only writer of index
+    // contents, except for bulk adds of pending rows, which the merge mutex serializes with removals and with replacing shards.
+    std::map<std::string, FaissCollection> faiss_collections_;
+    mutable std::mutex faiss_collections_mutex_;
+    
+    // Concurrent unfiltered searches share one batch_search per shard (vector_search.query_batch_size; null = each search alone)
+    struct IndexSearchRequest {
+        std::vector<std::shared_ptr<FaissIndex>> shards;
+        const float* query = nullptr;           // The caller's embedding (it blocks until the batch ran)
+        int k = 0;
+        FaissIndex::SearchParams params;
+    };
+    struct IndexSearchResult {
+        ResultCode code = ResultCode::ERROR_PROCESSING_FAILED;
+        std::vector<FaissIndex::SearchResult> hits;
+    };
+    std::unique_ptr<MicroBatcher<IndexSearchRequest, IndexSearchResult>> index_search_batcher_;
+    std::mutex faiss_merge_mutex_;
+    
+    // Background merge of hot tiers into their main indexes (vector_search.hot_index)
+    std::thread hot_merge_thread_;
+    std::mutex hot_merge_mutex_;
+    std::condition_variable hot_merge_cv_;
+    bool stop_hot_merge_ = false;
+    bool hot_merge_requested_ = false;          // bulk_add_vectors rows are queued - merge without waiting for the interval
+    std::recursive_mutex faiss_files_mutex_;    // "file" storage: writing index files vs. a backup copying them (compaction defers instead of waiting)
+    
+    // Document-level FLAT index over doc_centroids, labelled by doc_id (vector_search.document_prefilter > 0).
+    // Loaded with the collections; ingestion adds and removes documents under the mutex, searches hold it briefly.
+    std::unique_ptr<FaissIndex> document_index_;
+    std::mutex document_index_mutex_;
+    
+    // Background re-index with another embedding model (reindex_embeddings_async)
+    std::thread reindex_thread_;
+    std::shared_future<ResultCode> reindex_job_;
+    std::mutex reindex_job_mutex_;              // Guards reindex_thread_ and reindex_job_
+    mutable std::mutex reindex_progress_mutex_; // Guards reindex_progress_
+    ReindexProgress reindex_progress_;
+    std::atomic<bool> reindex_cancelled_{false};
 #endif
     
-#ifdef LEAFRA_HAS_COREML
-    // CoreML inference components
-    std::unique_ptr<leafra::CoreMLModel> coreml_model_;
-    bool coreml_initialized_;
+    // Embedding inference (CoreML / TensorFlow Lite / llama.cpp backend behind a shared batching scheduler)
+    std::unique_ptr<EmbeddingScheduler> embedding_scheduler_;
+    std::unique_ptr<EmbeddingScheduler> query_scheduler_;           // Search queries only (embedding_inference.query_instance)
+    
+    // Engine readiness (background loads publish embedding_scheduler_ / llamacpp_model_ before resolving)
+    std::shared_future<bool> embedding_ready_;
+    std::shared_future<bool> llm_ready_;
+    
+    // Query caches shared by concurrent searches (guarded by query_mutex_, held for lookups only - never across inference)
+    std::mutex query_mutex_;
+    LRUCache<std::string, std::vector<float> > query_embedding_cache_;
+#ifdef LEAFRA_HAS_FAISS
+    struct CachedSearch {
+        uint64_t index_generation;             // faissGeneration() the results were computed against
+        std::vector<FaissIndex::SearchResult> results;
+    };
+    LRUCache<std::string, CachedSearch> search_result_cache_;
+    uint64_t stale_search_results_ = 0;        // Cache hits dropped because the index changed (reported as misses)
 #endif
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+    // Generated RAG answers, keyed by the retrieved chunk ids they were grounded on (search_cache.cache_answers)
+    struct CachedAnswer {
+        std::vector<float> query_embedding;
+        std::vector<int64_t> doc_ids;          // Documents the chunks came from (removing or re-indexing one drops the entry)
+        std::string answer;
+    };
+    static constexpr size_t kMaxAnswersPerChunkSet = 4;
+    LRUCache<std::string, std::vector<CachedAnswer> > answer_cache_;
+    uint64_t answer_hits_ = 0;
+    uint64_t answer_misses_ = 0;
     
-#ifdef LEAFRA_HAS_TENSORFLOWLITE
-    // TensorFlow Lite inference components
-    TfLiteModel* tf_model_;
-    TfLiteInterpreter* tf_interpreter_;
-    TfLiteInterpreterOptions* tf_options_;
-    std::vector<TfLiteDelegate*> tf_delegates_;
-    bool tf_initialized_;
+    // KV state of RAG prompts up to the end of their first chunk, by that chunk's id (llm.hot_chunk_cache_size)
+    static constexpr size_t kTrackedChunkRetrievals = 1024;
+    std::mutex hot_chunk_mutex_;
+    LRUCache<int64_t, int32_t> chunk_retrievals_{kTrackedChunkRetrievals};  // Times each chunk led a RAG prompt
+    LRUCache<int64_t, std::shared_ptr<const leafra::llamacpp::SessionSnapshot> > hot_chunk_states_;
+    MemoryAccountant::Reservation hot_chunk_memory_{MemorySubsystem::LLM_KV_CACHE};
 #endif
 
 #ifdef LEAFRA_HAS_LLAMACPP
     // LlamaCpp inference components
     std::unique_ptr<leafra::llamacpp::LlamaCppModel> llamacpp_model_;
     bool llamacpp_initialized_;
+    bool llm_unloaded_ = false;                // Unloaded by unload_llm, the idle timeout or memory pressure (reloaded on next use)
+    mutable std::shared_mutex llm_mutex_;      // Shared while a call uses llamacpp_model_, exclusive while it is loaded or unloaded
+    std::atomic<std::chrono::steady_clock::rep> llm_last_used_{0};
+    
+    // Idle unload monitor (runs while llm.idle_unload_seconds > 0)
+    std::thread llm_idle_thread_;
+    std::mutex llm_idle_mutex_;
+    std::condition_variable llm_idle_cv_;
+    bool stop_llm_idle_ = false;
 #endif
     
     Impl() : initialized_(false), event_callback_(nullptr) {
@@ -129,26 +472,12 @@ public:
         math_utils_ = std::make_unique<MathUtils>();
         file_parser_ = std::make_unique<FileParsingWrapper>();
         chunker_ = std::make_unique<LeafraChunker>();
-        tokenizer_ = std::make_unique<SentencePieceTokenizer>();
+        tokenizer_ = std::make_shared<SentencePieceTokenizer>();
         
 #ifdef LEAFRA_HAS_SQLITE
         database_ = std::make_unique<SQLiteDatabase>();
 #endif
         
-#ifdef LEAFRA_HAS_COREML
-        // Initialize CoreML variables
-        coreml_model_ = nullptr;
-        coreml_initialized_ = false;
-#endif
-        
-#ifdef LEAFRA_HAS_TENSORFLOWLITE
-        // Initialize TensorFlow Lite variables
-        tf_model_ = nullptr;
-        tf_interpreter_ = nullptr;
-        tf_options_ = nullptr;
-        tf_initialized_ = false;
-#endif
-
 #ifdef LEAFRA_HAS_LLAMACPP
         // Initialize LlamaCpp variables
         llamacpp_model_ = nullptr;
@@ -156,23 +485,523 @@ public:
 #endif
     }
     
-    void send_event(const std::string& message) {
-        if (event_callback_) {
-            event_callback_(message.c_str());
+    ~Impl() {
+        reclaimers_.clear();
+        waitForEngines();
+#ifdef LEAFRA_HAS_LLAMACPP
+        stopLLMIdleMonitor();
+#endif
+        stopWatching();
+        cancelAsyncIngestionJobs();
+    }
+    
+    void send_event(EventType type, std::string message, std::string file_path = std::string()) {
+        events_.post(type, std::move(message), std::move(file_path));
+    }
+    
+    /**
+     * @brief Point the dispatcher at the current callbacks (copies, so delivery never reads Impl state)
+     */
+    void updateEventHandler() {
+        callback_t message_callback = event_callback_;
+        event_callback_t typed_callback = typed_event_callback_;
+        if (!message_callback && !typed_callback) {
+            events_.set_handler(nullptr);
+            return;
+        }
+        events_.set_handler([message_callback, typed_callback](const Event& event) {
+            if (typed_callback) {
+                typed_callback(event);
+            }
+            if (message_callback) {
+                message_callback(event.message);
+            }
+        });
+    }
+    
+    /**
+     * @brief Refresh the subsystems the accountant learns by asking the component (FAISS, SQLite, LLM)
+     * @param reset_sqlite_highwater Restart SQLite's own high-water mark (for reset_metrics)
+     */
+    void pollMemoryUsage(bool reset_sqlite_highwater = false) {
+#ifdef LEAFRA_HAS_FAISS
+        std::vector<std::shared_ptr<FaissIndex>> indexes;
+        {
+            std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+            for (const auto& entry : faiss_collections_) {
+                indexes.push_back(entry.second.index);
+            }
+        }
+        uint64_t faiss_bytes = 0;
+        for (const auto& index : indexes) {
+            faiss_bytes += index ? index->get_memory_bytes() : 0;
+        }
+        faiss_memory_.resize(faiss_bytes);
+#endif
+#ifdef LEAFRA_HAS_SQLITE
+        int64_t sqlite_used = 0;
+        int64_t sqlite_highwater = 0;
+        SQLiteDatabase::getMemoryUsage(sqlite_used, sqlite_highwater, reset_sqlite_highwater);
+        MemoryAccountant& memory = MemoryAccountant::instance();
+        memory.set(MemorySubsystem::SQLITE, static_cast<uint64_t>(std::max<int64_t>(sqlite_used, 0)));
+        memory.note_peak(MemorySubsystem::SQLITE, static_cast<uint64_t>(std::max<int64_t>(sqlite_highwater, 0)));
+#endif
+#ifdef LEAFRA_HAS_LLAMACPP
+        // Never wait behind a model load; the previous figures stand until the next poll
+        std::shared_lock<std::shared_mutex> llm_lock(llm_mutex_, std::try_to_lock);
+        if (llm_lock.owns_lock()) {
+            uint64_t kv_bytes = 0;
+            uint64_t weight_bytes = 0;
+            if (llamacpp_initialized_ && llamacpp_model_) {
+                llamacpp_model_->get_memory_usage(kv_bytes, weight_bytes);
+            }
+            llm_kv_memory_.resize(kv_bytes);
+            llm_weight_memory_.resize(weight_bytes);
+        }
+#endif
+        {
+            std::lock_guard<std::mutex> lock(query_mutex_);
+            query_cache_memory_.resize(queryCacheBytes());
+        }
+        (void)reset_sqlite_highwater;
+    } //pollMemoryUsage
+    
+    /**
+     * @brief Handle memory pressure once each time tracked memory goes over a budget
+     */
+    void enforceMemoryBudget() {
+        pollMemoryUsage();
+        MemoryAccountant& memory = MemoryAccountant::instance();
+        if (!memory.over_budget()) {
+            memory_over_budget_ = false;
+            return;
+        }
+        if (memory_over_budget_.exchange(true)) {
+            return;
+        }
+        std::string message = "Memory budget exceeded: " + std::to_string(memory.total() / (1024 * 1024)) + " MB tracked";
+        LEAFRA_WARNING() << "⚠️  " << message;
+        send_event(EventType::WARNING, "⚠️ " + message);
+        
+        // Give back just the excess, cheapest memory first: a subsystem over its own budget
+        // only from its own reclaimers, the total from anyone's
+        uint64_t freed = 0;
+        for (size_t i = 0; i < static_cast<size_t>(MemorySubsystem::COUNT); ++i) {
+            const MemorySubsystem subsystem = static_cast<MemorySubsystem>(i);
+            if (const uint64_t excess = memory.excess(subsystem)) {
+                freed += memory.reclaim(excess, ReclaimPriority::MODEL, subsystem);
+            }
+        }
+        if (const uint64_t excess = memory.excess()) {
+            freed += memory.reclaim(excess);
+        }
+        pollMemoryUsage();
+        LEAFRA_INFO() << "♻️ Reclaimed " << (freed / 1024) << " KB" << (memory.over_budget() ? " - still over budget" : "");
+    } //enforceMemoryBudget
+    
+    /**
+     * @brief Bytes held by the query embedding, search result and answer caches (caller holds query_mutex_)
+     * 
+     * Estimated from the keys and values plus a fixed per-entry overhead for the list and index nodes.
+     */
+    uint64_t queryCacheBytes() const {
+        constexpr uint64_t kEntryOverhead = 64;
+        uint64_t bytes = 0;
+        query_embedding_cache_.for_each([&bytes](const std::string& key, const std::vector<float>& embedding) {
+            bytes += kEntryOverhead + key.capacity() + embedding.capacity() * sizeof(float);
+        });
+#ifdef LEAFRA_HAS_FAISS
+        search_result_cache_.for_each([&bytes](const std::string& key, const CachedSearch& cached) {
+            bytes += kEntryOverhead + key.capacity() + cached.results.capacity() * sizeof(FaissIndex::SearchResult);
+        });
+#endif
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+        answer_cache_.for_each([&bytes](const std::string& key, const std::vector<CachedAnswer>& answers) {
+            bytes += kEntryOverhead + key.capacity();
+            for (const CachedAnswer& answer : answers) {
+                bytes += answer.query_embedding.capacity() * sizeof(float) + answer.doc_ids.capacity() * sizeof(int64_t) +
+                         answer.answer.capacity();
+            }
+        });
+#endif
+        return bytes;
+    }
+    
+    /**
+     * @brief Evict the least recently used query cache entries until about bytes are freed
+     * @return Bytes freed
+     * 
+     * Every cache loses the same share of its entries; capacities are kept, so the caches
+     * refill as queries come in.
+     */
+    uint64_t shrinkQueryCaches(uint64_t bytes) {
+        std::lock_guard<std::mutex> lock(query_mutex_);
+        const uint64_t before = queryCacheBytes();
+        if (before == 0) {
+            return 0;
+        }
+        auto share = [bytes, before](size_t entries) {
+            return bytes >= before ? entries : static_cast<size_t>((static_cast<double>(entries) * bytes + before - 1) / before);
+        };
+        query_embedding_cache_.evict(share(query_embedding_cache_.size()));
+#ifdef LEAFRA_HAS_FAISS
+        search_result_cache_.evict(share(search_result_cache_.size()));
+#endif
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+        answer_cache_.evict(share(answer_cache_.size()));
+#endif
+        const uint64_t after = queryCacheBytes();
+        query_cache_memory_.resize(after);
+        return before - std::min(before, after);
+    } //shrinkQueryCaches
+    
+    /**
+     * @brief Register what this instance can give back under memory pressure, cheapest first
+     * 
+     * Query caches, then the chunking scratch of every worker and SQLite's page cache, then
+     * saved hot chunk KV states, and last the LLM (swapped to LLMConfig::low_memory_model_path
+     * when set, otherwise unloaded). Embedding models and FAISS indexes are not reclaimed: they
+     * can't shrink without unloading, and search needs them.
+     */
+    void registerReclaimers(LeafraCore& core) {
+        using Reclaimer = MemoryAccountant::Reclaimer;
+        reclaimers_.clear();
+        
+        reclaimers_.push_back(std::make_unique<Reclaimer>("query_caches", MemorySubsystem::QUERY_CACHES, ReclaimPriority::CACHE,
+            [this]() { return query_cache_memory_.bytes(); },
+            [this](uint64_t bytes) { return shrinkQueryCaches(bytes); }));
+        
+        // Scratch lives in thread_locals: workers drop theirs before their next document
+        reclaimers_.push_back(std::make_unique<Reclaimer>("chunking_scratch", MemorySubsystem::CHUNKING_SCRATCH, ReclaimPriority::SCRATCH,
+            []() { return MemoryAccountant::instance().current(MemorySubsystem::CHUNKING_SCRATCH); },
+            [](uint64_t) {
+                chunking_scratch_epoch_++;
+                return uint64_t(0);
+            }));
+        
+#ifdef LEAFRA_HAS_SQLITE
+        reclaimers_.push_back(std::make_unique<Reclaimer>("sqlite_page_cache", MemorySubsystem::SQLITE, ReclaimPriority::SCRATCH,
+            [this]() {
+                const int64_t bytes = (database_ ? database_->getCacheMemoryUsage() : 0) + read_pool_.getCacheMemoryUsage();
+                return static_cast<uint64_t>(std::max<int64_t>(bytes, 0));
+            },
+            [this](uint64_t) {
+                const int64_t freed = (database_ ? database_->releaseCacheMemory() : 0) + read_pool_.releaseCacheMemory();
+                return static_cast<uint64_t>(std::max<int64_t>(freed, 0));
+            }));
+#endif
+        
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+        reclaimers_.push_back(std::make_unique<Reclaimer>("hot_chunk_states", MemorySubsystem::LLM_KV_CACHE, ReclaimPriority::WARM_STATE,
+            [this]() { return hot_chunk_memory_.bytes(); },
+            [this](uint64_t) {
+                std::lock_guard<std::mutex> lock(hot_chunk_mutex_);
+                const uint64_t freed = hot_chunk_memory_.bytes();
+                hot_chunk_states_.clear();
+                hot_chunk_memory_.resize(0);
+                return freed;
+            }));
+#endif
+        
+#ifdef LEAFRA_HAS_LLAMACPP
+        reclaimers_.push_back(std::make_unique<Reclaimer>("llm", MemorySubsystem::LLM_WEIGHTS, ReclaimPriority::MODEL,
+            [this]() { return llm_weight_memory_.bytes() + llm_kv_memory_.bytes(); },
+            [this, &core](uint64_t) {
+                LLMConfig llm_config;
+                {
+                    std::shared_lock<std::shared_mutex> lock(llm_mutex_);
+                    if (!llamacpp_initialized_) {
+                        return uint64_t(0);
+                    }
+                    llm_config = config_.llm;
+                }
+                const uint64_t before = llm_weight_memory_.bytes() + llm_kv_memory_.bytes();
+                const bool swappable = !llm_config.low_memory_model_path.empty() && llm_config.low_memory_model_path != llm_config.model_path;
+                LEAFRA_WARNING() << "⚠️  Memory pressure - " << (swappable ? "swapping to the low-memory LLM" : "unloading the LLM");
+                llm_config.model_path = llm_config.low_memory_model_path;
+                if (!swappable || core.swap_llm(llm_config) != ResultCode::SUCCESS) {
+                    core.unload_llm();
+                }
+                pollMemoryUsage();
+                const uint64_t after = llm_weight_memory_.bytes() + llm_kv_memory_.bytes();
+                return before - std::min(before, after);
+            }));
+#else
+        (void)core;
+#endif
+    } //registerReclaimers
+    
+    /**
+     * @brief Sample the power state (rate-limited by the governor) and apply changed limits
+     * 
+     * The embedding batch size changes from the next batch on; LLM threads are applied by
+     * acquireLLM at the start of the next LLM call; ingestion workers through IngestPermit;
+     * FAISS threads from each index's next call.
+     */
+    void pollThroughputGovernor() {
+        if (governor_.update()) {
+            applyThroughputLimits();
+        }
+    }
+    
+    void applyThroughputLimits() {
+        // A background embedding load picks the limits up itself when it finishes
+        bool embedding_loading = embedding_ready_.valid() &&
+                                 embedding_ready_.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+        if (!embedding_loading && embedding_scheduler_) {
+            embedding_scheduler_->set_batch_size(governor_.limits().embedding_batch_size);
+        }
+#ifdef LEAFRA_HAS_FAISS
+        std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+        for (auto& entry : faiss_collections_) {
+            entry.second.index->set_thread_count(governor_.limits().faiss_threads);
+        }
+#endif
+    } //applyThroughputLimits
+    
+    /**
+     * @brief Fingerprint device profiles are matched against (platform, architecture and core counts)
+     */
+    static std::string deviceFingerprint() {
+        CpuTopology topology = PlatformUtils::get_cpu_topology();
+        return PlatformUtils::get_platform_name() + "/" + PlatformUtils::get_architecture() + "/" +
+               std::to_string(topology.performance_cores) + "P+" + std::to_string(topology.efficiency_cores) + "E/" +
+               std::to_string(topology.logical_cores);
+    }
+    
+    /**
+     * @brief Load the device profile from app storage, ignoring one measured on another device
+     */
+    void loadDeviceProfile() {
+        device_profile_ = DeviceProfile();
+        if (config_.device_profile_name.empty()) {
+            return;
+        }
+        DeviceProfile profile;
+        if (!DeviceProfile::load(FileManager::getAbsolutePath(StorageType::AppStorage, config_.device_profile_name), profile)) {
+            return;
+        }
+        if (profile.device != deviceFingerprint()) {
+            LEAFRA_INFO() << "📐 Device profile was measured on " << profile.device << " - ignored (run autotune again)";
+            return;
+        }
+        device_profile_ = profile;
+    } //loadDeviceProfile
+    
+    /**
+     * @brief Overlay the device profile onto config, remembering the configured LLM thread counts
+     */
+    void applyDeviceProfile(Config& config) {
+        configured_llm_threads_ = config.llm.n_threads;
+        configured_llm_batch_threads_ = config.llm.n_threads_batch;
+        if (!device_profile_.device.empty() && device_profile_.apply(config.embedding_inference, config.llm)) {
+            LEAFRA_INFO() << "📐 Device profile applied (embedding batch: " << config.embedding_inference.batch_size
+                          << ", LLM threads: " << config.llm.n_threads << ", batch threads: " << config.llm.n_threads_batch << ")";
         }
     }
     
+    /**
+     * @brief Time embedding calls at each batch size up to the backend maximum
+     * @param deadline_ms Timestamp (PlatformUtils::get_timestamp_ms) after which no further size is tried
+     * @return Milliseconds per row for each batch size tried (empty without an embedding model)
+     */
+    std::vector<AutotuneTrial> benchmarkEmbeddingBatchSizes(int64_t deadline_ms) {
+        std::vector<AutotuneTrial> trials;
+        ModelUse model_use(model_swap_mutex_);
+        if (!hasEmbeddingModel()) {
+            return trials;
+        }
+        EmbeddingScheduler& scheduler = *embedding_scheduler_;
+        
+        // Rows as long as real chunks: the text is longer than any sequence length and trimmed by the scheduler
+        std::string text;
+        while (text.size() < 4096) {
+            text += "Retrieval quality depends on how each document is split into chunks, how the chunks are embedded "
+                    "and how the nearest neighbours are ranked before the answer is generated. ";
+        }
+        std::vector<int> token_ids;
+        if (scheduler.backend().requiresTokenIds()) {
+            if (!tokenizer_ || !tokenizer_->is_loaded() ||
+                !tokenizer_->encode_as_ids(text, token_ids, SentencePieceTokenizer::TokenizeOptions()) || token_ids.empty()) {
+                LEAFRA_WARNING() << "⚠️  Autotune: no tokenizer for the embedding benchmark";
+                return trials;
+            }
+        }
+        
+        std::vector<int32_t> batch_sizes;
+        const int32_t max_batch = static_cast<int32_t>(std::max<size_t>(1, scheduler.backend().getMaxBatchSize()));
+        for (int32_t batch_size = 1; batch_size < max_batch && batch_size <= 64; batch_size *= 2) {
+            batch_sizes.push_back(batch_size);
+        }
+        batch_sizes.push_back(std::min(max_batch, 64));
+        
+        auto run = [&](size_t batch_size, size_t rows) {
+            std::vector<TextChunk> chunks(rows, TextChunk(text, 0, text.size()));
+            for (TextChunk& chunk : chunks) {
+                chunk.token_ids = token_ids;
+            }
+            scheduler.set_batch_size(batch_size);
+            auto start = std::chrono::steady_clock::now();
+            size_t embedded = scheduler.embed_chunks(chunks);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            return embedded == rows ? std::max(ms, 0.001) / static_cast<double>(rows) : 0.0;
+        };
+        run(1, 1);                              // The first call pays for lazy allocations
+        for (int32_t batch_size : batch_sizes) {
+            if (PlatformUtils::get_timestamp_ms() >= deadline_ms) {
+                break;
+            }
+            AutotuneTrial trial;
+            trial.value = batch_size;
+            trial.cost = run(static_cast<size_t>(batch_size), static_cast<size_t>(std::max(batch_size * 2, 8)));
+            trials.push_back(trial);
+            LEAFRA_DEBUG() << "Autotune: embedding batch " << batch_size << " - " << trial.cost << " ms per row";
+        }
+        scheduler.set_batch_size(governor_.limits().embedding_batch_size);
+        return trials;
+    } //benchmarkEmbeddingBatchSizes
+    
+#ifdef LEAFRA_HAS_LLAMACPP
+    /**
+     * @brief Time prompt evaluation and decoding at each candidate thread count
+     * 
+     * The conversation state is saved first and restored afterwards, so the system prompt and
+     * any session carry on as before.
+     * @param deadline_ms Timestamp after which no further thread count is tried
+     * @param prompt_trials Receives milliseconds per prompt token for each thread count
+     * @param generation_trials Receives milliseconds per generated token for each thread count
+     */
+    void benchmarkLLMThreads(int64_t deadline_ms, std::vector<AutotuneTrial>& prompt_trials, std::vector<AutotuneTrial>& generation_trials) {
+        std::shared_lock<std::shared_mutex> lock;
+        if (!acquireLLM(lock)) {
+            return;
+        }
+        leafra::llamacpp::LlamaCppModel& model = *llamacpp_model_;
+        
+        // Candidates: the performance cores and a few counts around them, then every core
+        CpuTopology topology = PlatformUtils::get_cpu_topology();
+        const int32_t performance = std::max(1, topology.performance_cores);
+        const int32_t logical = std::max(performance, topology.logical_cores);
+        std::vector<int32_t> candidates = {1, 2, performance / 2, performance - 1, performance, performance + 2, logical};
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](int32_t n) { return n < 1 || n > logical; }), candidates.end());
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        
+        std::string text;
+        while (text.size() < 1024) {
+            text += "The quarterly report lists revenue, operating costs and the outlook for the next two quarters. ";
+        }
+        std::vector<int32_t> prompt = model.tokenize(text, true);
+        prompt.resize(std::min<size_t>(prompt.size(), static_cast<size_t>(std::max(16, std::min(128, config_.llm.n_ctx / 4)))));
+        const int32_t generated = 8;
+        
+        leafra::llamacpp::SessionSnapshot saved;
+        const bool have_saved = model.save_snapshot(saved);
+        auto run = [&](int32_t threads, AutotuneTrial& prompt_trial, AutotuneTrial& generation_trial) {
+            model.set_threads(threads, threads);
+            model.reset_context();
+            prompt_trial.value = generation_trial.value = threads;
+            if (!model.generate_from_tokens(prompt, [](const std::string&, bool) { return true; }, generated)) {
+                return;
+            }
+            leafra::llamacpp::GenerationStats stats = model.get_last_stats();
+            if (stats.prompt_tokens > 0) {
+                prompt_trial.cost = std::max(stats.prompt_eval_time, 0.001) / stats.prompt_tokens;
+            }
+            if (stats.generated_tokens > 0) {
+                generation_trial.cost = std::max(stats.generation_time, 0.001) / stats.generated_tokens;
+            }
+        };
+        AutotuneTrial warm_prompt, warm_generation;
+        run(performance, warm_prompt, warm_generation);    // Pages the weights in
+        for (int32_t threads : candidates) {
+            if (PlatformUtils::get_timestamp_ms() >= deadline_ms) {
+                break;
+            }
+            AutotuneTrial prompt_trial, generation_trial;
+            run(threads, prompt_trial, generation_trial);
+            prompt_trials.push_back(prompt_trial);
+            generation_trials.push_back(generation_trial);
+            LEAFRA_DEBUG() << "Autotune: LLM " << threads << " threads - prompt " << prompt_trial.cost
+                           << " ms per token, decode " << generation_trial.cost << " ms per token";
+        }
+        
+        if (!have_saved || !model.restore_snapshot(saved)) {
+            model.reset_context();
+        }
+        llm_applied_threads_ = 0;               // acquireLLM hands the governor's limits back to the model
+        llm_applied_batch_threads_ = 0;
+    } //benchmarkLLMThreads
+#endif
+    
 #ifdef LEAFRA_HAS_SQLITE
+    /**
+     * @brief How a document's chunk text goes into the database, prepared on the worker pool
+     */
+    struct StoredChunkText {
+        std::vector<std::vector<uint8_t>> chunks;   // TextCodec blob of each chunk's text (copy storage; empty = TEXT)
+        std::string_view document;                  // Chunked text stored once in doc_texts pages (offsets storage; empty = copy storage)
+        size_t page_bytes = 0;                      // doc_texts page size document is split into
+        std::vector<std::vector<uint8_t>> pages;    // TextCodec blob of each page (empty = TEXT)
+        std::string llm_vocab;                      // Tokenizer llm_tokens belong to (llm.cache_chunk_tokens)
+        std::vector<std::vector<uint8_t>> llm_tokens;  // TextCodec::encode_tokens of each chunk as the RAG prompt holds it (empty = not stored)
+        
+        // Where a chunk's text starts: in the chunked text (pages joined by a blank line) and in its page (-1 = unknown)
+        struct ChunkOffsets {
+            int64_t text = -1;
+            int64_t page = -1;
+        };
+        std::vector<ChunkOffsets> offsets;          // Parallel to the chunks
+        
+        // Byte range of a chunk inside document (false if the chunk doesn't view it)
+        bool range_of(std::string_view content, size_t& start) const {
+            const uintptr_t begin = reinterpret_cast<uintptr_t>(document.data());
+            const uintptr_t at = reinterpret_cast<uintptr_t>(content.data());
+            if (document.empty() || at < begin || at - begin + content.size() > document.size()) {
+                return false;
+            }
+            start = static_cast<size_t>(at - begin);
+            return true;
+        }
+        
+        uint64_t memory_bytes() const {
+            uint64_t bytes = 0;
+            for (const std::vector<uint8_t>& blob : chunks) {
+                bytes += sizeof(blob) + blob.capacity();
+            }
+            for (const std::vector<uint8_t>& blob : pages) {
+                bytes += sizeof(blob) + blob.capacity();
+            }
+            for (const std::vector<uint8_t>& blob : llm_tokens) {
+                bytes += sizeof(blob) + blob.capacity();
+            }
+            bytes += offsets.capacity() * sizeof(ChunkOffsets);
+            return bytes;
+        }
+    };
+    
     /**
      * @brief Insert document and its chunks into the database
      * @param result Parsed document data
-     * @param chunks Vector of text chunks with embeddings
+     * @param chunks Vector of text chunks
+     * @param batch The chunks' embeddings (rows without one are not inserted; compacted by the FAISS insert)
      * @param file_path Original file path
+     * @param fingerprint Path, size, mtime and content hash recorded for change detection
+     * @param chunk_hashes ContentHasher digest of each chunk's text (parallel to chunks)
+     * @param chunk_simhashes SimHash of each chunk's text (parallel to chunks, 0 = none; may be empty)
+     * @param chunk_text How the chunks' text is stored (compressed copies, or the document text once plus ranges, and LLM tokens)
+     * @param arena The document's arena (encoded embedding blobs are built in it)
      * @return true if successful, false otherwise
      */
     bool insertDocumentAndChunksIntoDatabase(const ParsedDocument& result, 
                                             const std::vector<TextChunk>& chunks, 
-                                            const std::string& file_path) {
+                                            ChunkBatch& batch,
+                                            const std::string& file_path,
+                                            const DocumentFingerprint& fingerprint,
+                                            const ArenaVector<ArenaString>& chunk_hashes,
+                                            const ArenaVector<uint64_t>& chunk_simhashes,
+                                            const StoredChunkText& chunk_text,
+                                            MonotonicArena& arena) {
         if (!database_ || !database_->isOpen()) {
             LEAFRA_ERROR() << "Database not available for document insertion";
             return false;
@@ -180,11 +1009,14 @@ public:
         
         try {
             // Start transaction for atomic operation
+            PipelineMetricsRecorder::ScopedStage insert_timing(metrics_, PipelineStage::DB_INSERT);
+            insert_timing.set_items(chunks.size());
             SQLiteTransaction transaction(*database_);
             
             // Insert document into docs table
-            auto insertDocStmt = database_->prepare(
-                "INSERT INTO docs (filename, url, creation_date, size) VALUES (?, ?, CURRENT_TIMESTAMP, ?)"
+            auto insertDocStmt = database_->prepareCached(
+                "INSERT INTO docs (filename, url, creation_date, size, file_size, file_mtime, content_hash, collection) "
+                "VALUES (?, ?, CURRENT_TIMESTAMP, ?, ?, ?, ?, ?)"
             );
             
             if (!insertDocStmt || !insertDocStmt->isValid()) {
@@ -194,13 +1026,15 @@ public:
             
             // Get canonical path (resolves .., ., symlinks) and extract filename
             std::filesystem::path path(file_path);
-            std::string absolute_path;
-            try {
-                // First try canonical (requires file to exist and resolves all components)
-                absolute_path = std::filesystem::canonical(path).string();
-            } catch (const std::filesystem::filesystem_error& e) {
-                LEAFRA_DEBUG() << "Failed to get canonical path for: " << file_path << " - " << e.what();
-                return false;
+            std::string absolute_path = fingerprint.absolute_path;
+            if (absolute_path.empty()) {
+                try {
+                    // First try canonical (requires file to exist and resolves all components)
+                    absolute_path = std::filesystem::canonical(path).string();
+                } catch (const std::filesystem::filesystem_error& e) {
+                    LEAFRA_DEBUG() << "Failed to get canonical path for: " << file_path << " - " << e.what();
+                    return false;
+                }
             }
             std::string filename = path.filename().string();
             LEAFRA_DEBUG() << "Filename: " << filename;
@@ -222,6 +1056,19 @@ public:
             insertDocStmt->bindText(1, filename);
             insertDocStmt->bindText(2, absolute_path);  // Use absolute path as URL
             insertDocStmt->bindInt64(3, static_cast<long long>(total_size));
+            if (fingerprint.file_size >= 0) {
+                insertDocStmt->bindInt64(4, fingerprint.file_size);
+                insertDocStmt->bindInt64(5, fingerprint.file_mtime);
+            } else {
+                insertDocStmt->bindNull(4);
+                insertDocStmt->bindNull(5);
+            }
+            if (!fingerprint.content_hash.empty()) {
+                insertDocStmt->bindText(6, fingerprint.content_hash);
+            } else {
+                insertDocStmt->bindNull(6);
+            }
+            insertDocStmt->bindText(7, fingerprint.collection);
             
             // Execute document insert
             if (!insertDocStmt->execute()) {
@@ -236,86 +1083,242 @@ public:
             long long doc_id = database_->getLastInsertRowId();
             LEAFRA_DEBUG() << "Inserted document with ID: " << doc_id;
             
-            // Prepare chunk insert statement
-            auto insertChunkStmt = database_->prepare(
-                "INSERT INTO chunks (doc_id, chunk_page_number, chunk_faiss_id, chunk_no, chunk_token_size, chunk_size, chunk_text, chunk_embedding) VALUES (?, ?, ?, ?, ?, ?, ?, ?)"
-            );
+            // Offsets storage keeps the document text once, in pages the chunk ranges point into (before the chunks,
+            // whose keyword index trigger reads them)
+            const std::string_view document_text = chunk_text.document;
+            if (!document_text.empty()) {
+                SQLiteDatabase::BulkInsert insertPages(*database_, "doc_texts", {"doc_id", "text_start", "text_end", "page_text"});
+                const size_t page_bytes = std::max<size_t>(1, chunk_text.page_bytes);
+                for (size_t page = 0, start = 0; start < document_text.size(); ++page, start += page_bytes) {
+                    const size_t end = std::min(document_text.size(), start + page_bytes);
+                    insertPages.bindInt64(0, doc_id);
+                    insertPages.bindInt64(1, static_cast<long long>(start));
+                    insertPages.bindInt64(2, static_cast<long long>(end));
+                    if (page < chunk_text.pages.size() && !chunk_text.pages[page].empty()) {
+                        insertPages.bindBlobView(3, chunk_text.pages[page].data(), chunk_text.pages[page].size());
+                    } else {
+                        insertPages.bindTextView(3, document_text.substr(start, end - start));
+                    }
+                    if (!insertPages.endRow()) {
+                        LEAFRA_ERROR() << "Failed to store document text for: " << filename;
+                        return false;
+                    }
+                }
+                if (!insertPages.flush()) {
+                    LEAFRA_ERROR() << "Failed to store document text for: " << filename;
+                    return false;
+                }
+            }
+            
+            // Chunks go in as multi-row INSERTs; text and embeddings are bound straight from the chunks
+            SQLiteDatabase::BulkInsert insertChunks(*database_, "chunks",
+                {"doc_id", "chunk_page_number", "chunk_faiss_id", "chunk_no", "chunk_token_size", "chunk_size", "chunk_text", "chunk_hash",
+                 "chunk_simhash", "chunk_start", "chunk_end", "chunk_doc_offset", "chunk_page_offset"});
+            
+            // Embeddings go to their own table in the configured compact encoding, one arena block for all rows
+            // (views must outlive the flush)
+            const bool store_embeddings = embedding_storage_format_ != EmbeddingStorageFormat::NONE;
+            const size_t encoded_size = store_embeddings ? VectorCodec::encoded_size(embedding_storage_format_, batch.dimension) : 0;
+            ArenaVector<uint8_t> encoded_embeddings{ArenaAllocator<uint8_t>(arena)};
+            encoded_embeddings.resize(encoded_size * chunks.size());
+            VectorCodec::Encoded encoded;    // Reused by every row
+            SQLiteDatabase::BulkInsert insertEmbeddings(*database_, "chunk_embeddings",
+                {"chunk_faiss_id", "format", "byte_order", "dimension", "scale", "embedding"});
+            SQLiteDatabase::BulkInsert insertLLMTokens(*database_, "chunk_llm_tokens", {"chunk_faiss_id", "vocab", "tokens"});
             
-            if (!insertChunkStmt || !insertChunkStmt->isValid()) {
-                LEAFRA_ERROR() << "Failed to prepare chunk insert statement";
+            // Reserve one dense block of FAISS labels for the chunks that go in (rolled back with the transaction)
+            int64_t embedded_chunks = static_cast<int64_t>(batch.embedding_count());
+            int64_t next_chunk_faiss_id = 0;
+            if (embedded_chunks > 0 && !database_->allocateIds("chunk_faiss_id", embedded_chunks, next_chunk_faiss_id)) {
+                LEAFRA_ERROR() << "Failed to allocate chunk ids for document: " << filename;
                 return false;
             }
+            std::vector<int64_t> chunk_faiss_ids(chunks.size(), -1);
+            
+    #ifdef LEAFRA_HAS_FAISS
+            // Hierarchical search: the document's centroid is the mean of the chunk embeddings that go in
+            const bool store_centroid = config_.vector_search.enabled && config_.vector_search.document_prefilter > 0;
+            std::vector<float> centroid;
+    #endif
             
             // Insert each chunk (only chunks with embeddings)
-            size_t chunks_inserted = 0;
             size_t chunks_skipped = 0;
+            size_t chunks_left_out = 0;
             for (size_t i = 0; i < chunks.size(); ++i) {
                 const auto& chunk = chunks[i];
                 
+                // Near-duplicates of stored chunks and low-quality chunks are left out on purpose
+                if (batch.is_skipped(i)) {
+                    chunks_left_out++;
+                    continue;
+                }
+                
                 // Skip chunks without embeddings - don't insert them into database
-                if (!chunk.has_embedding() || chunk.embedding.empty()) {
+                if (!batch.has_embedding(i)) {
                     chunks_skipped++;
                     LEAFRA_WARNING() << "Skipping database insertion for chunk " << (i + 1) << " - no embedding";
                     continue;
                 }
                 
-                // Reset statement for reuse
-                insertChunkStmt->reset();
-                
-                // Convert embedding to blob
-                std::vector<uint8_t> embedding_blob;
-                    // Convert float vector to byte vector
-                    const float* float_data = chunk.embedding.data();
-                //TODO AD: We need to handle different endianness'es here per architecture to be portable 
-                    const uint8_t* byte_data = reinterpret_cast<const uint8_t*>(float_data);
-                    size_t byte_size = chunk.embedding.size() * sizeof(float);
-                    embedding_blob.assign(byte_data, byte_data + byte_size);
-                
-                // Calculate FAISS ID for this chunk (same as used in FAISS insertion)
-                
-                // TODO AD: There can be overflow here if doc_id is too large
-                int64_t chunk_faiss_id = doc_id * 1000000 + static_cast<int64_t>(i);
+                // FAISS label for this chunk (handed to FAISS insertion below)
+                int64_t chunk_faiss_id = next_chunk_faiss_id++;
+                chunk_faiss_ids[i] = chunk_faiss_id;
                 
                 // Bind parameters for chunk
-                insertChunkStmt->bindInt64(1, doc_id);
-                insertChunkStmt->bindInt64(2, static_cast<long long>(chunk.page_number+1)); //1-based page number
-                insertChunkStmt->bindInt64(3, chunk_faiss_id); // chunk_faiss_id - always present for inserted chunks
-                insertChunkStmt->bindInt64(4, static_cast<long long>(i+1)); // chunk_no (1-based)
-                insertChunkStmt->bindInt64(5, static_cast<long long>(chunk.estimated_tokens)); // chunk_token_size
-                insertChunkStmt->bindInt64(6, static_cast<long long>(chunk.content.length())); // chunk_size
-                insertChunkStmt->bindText(7, std::string(chunk.content)); // Convert string_view to string
-                insertChunkStmt->bindBlob(8, embedding_blob); // embedding - always present for inserted chunks
+                insertChunks.bindInt64(0, doc_id);
+                insertChunks.bindInt64(1, static_cast<long long>(chunk.page_number+1)); //1-based page number
+                insertChunks.bindInt64(2, chunk_faiss_id); // chunk_faiss_id - always present for inserted chunks
+                insertChunks.bindInt64(3, static_cast<long long>(i+1)); // chunk_no (1-based)
+                insertChunks.bindInt64(4, static_cast<long long>(chunk.estimated_tokens)); // chunk_token_size
+                insertChunks.bindInt64(5, static_cast<long long>(chunk.content.length())); // chunk_size
+                size_t chunk_start = 0;
+                if (chunk_text.range_of(chunk.content, chunk_start)) {
+                    insertChunks.bindTextView(6, std::string_view("", 0));   // Text comes from doc_texts
+                    insertChunks.bindInt64(9, static_cast<long long>(chunk_start));
+                    insertChunks.bindInt64(10, static_cast<long long>(chunk_start + chunk.content.size()));
+                } else {
+                    if (i < chunk_text.chunks.size() && !chunk_text.chunks[i].empty()) {
+                        insertChunks.bindBlobView(6, chunk_text.chunks[i].data(), chunk_text.chunks[i].size());
+                    } else {
+                        insertChunks.bindTextView(6, chunk.content);
+                    }
+                    insertChunks.bindNull(9);
+                    insertChunks.bindNull(10);
+                }
+                if (i < chunk_hashes.size()) {
+                    insertChunks.bindTextView(7, chunk_hashes[i]);
+                } else {
+                    insertChunks.bindNull(7);
+                }
+                if (i < chunk_simhashes.size() && chunk_simhashes[i] != 0) {
+                    insertChunks.bindInt64(8, static_cast<long long>(chunk_simhashes[i]));
+                } else {
+                    insertChunks.bindNull(8);
+                }
+                const StoredChunkText::ChunkOffsets offsets = i < chunk_text.offsets.size() ? chunk_text.offsets[i] : StoredChunkText::ChunkOffsets();
+                if (offsets.text >= 0) {
+                    insertChunks.bindInt64(11, static_cast<long long>(offsets.text));
+                } else {
+                    insertChunks.bindNull(11);
+                }
+                if (offsets.page >= 0) {
+                    insertChunks.bindInt64(12, static_cast<long long>(offsets.page));
+                } else {
+                    insertChunks.bindNull(12);
+                }
                 
-                // Execute chunk insert
-                if (!insertChunkStmt->execute()) {
-                    LEAFRA_ERROR() << "Failed to insert chunk " << (i + 1) << " for document: " << filename;
+                if (!insertChunks.endRow()) {
+                    LEAFRA_ERROR() << "Failed to insert chunks up to " << (i + 1) << " for document: " << filename;
                     return false;
                 }
-                chunks_inserted++;
+    #ifdef LEAFRA_HAS_FAISS
+                if (store_centroid) {
+                    accumulateCentroid(batch.embedding(i), batch.dimension, centroid);
+                }
+    #endif
+                
+                if (store_embeddings && VectorCodec::encode(batch.embedding(i), batch.dimension, embedding_storage_format_, encoded)) {
+                    uint8_t* blob = encoded_embeddings.data() + i * encoded_size;
+                    std::copy(encoded.data.begin(), encoded.data.end(), blob);
+                    insertEmbeddings.bindInt64(0, chunk_faiss_id);
+                    insertEmbeddings.bindInt64(1, static_cast<long long>(encoded.format));
+                    insertEmbeddings.bindInt64(2, static_cast<long long>(encoded.byte_order));
+                    insertEmbeddings.bindInt64(3, static_cast<long long>(batch.dimension));
+                    insertEmbeddings.bindDouble(4, encoded.scale);
+                    insertEmbeddings.bindBlobView(5, blob, encoded.data.size());
+                    if (!insertEmbeddings.endRow()) {
+                        LEAFRA_ERROR() << "Failed to insert chunk embeddings up to " << (i + 1) << " for document: " << filename;
+                        return false;
+                    }
+                }
+                
+                if (i < chunk_text.llm_tokens.size() && !chunk_text.llm_tokens[i].empty()) {
+                    insertLLMTokens.bindInt64(0, chunk_faiss_id);
+                    insertLLMTokens.bindTextView(1, chunk_text.llm_vocab);
+                    insertLLMTokens.bindBlobView(2, chunk_text.llm_tokens[i].data(), chunk_text.llm_tokens[i].size());
+                    if (!insertLLMTokens.endRow()) {
+                        LEAFRA_ERROR() << "Failed to insert chunk LLM tokens up to " << (i + 1) << " for document: " << filename;
+                        return false;
+                    }
+                }
             }
-            
-            // Log insertion summary
-            if (chunks_skipped > 0) {
-                LEAFRA_INFO() << "Database insertion: " << chunks_inserted << "/" << chunks.size() << " chunks inserted (" << chunks_skipped << " skipped - no embeddings)";
+            if (!insertChunks.flush() || !insertEmbeddings.flush() || !insertLLMTokens.flush()) {
+                LEAFRA_ERROR() << "Failed to insert chunks for document: " << filename;
+                return false;
+            }
+            size_t chunks_inserted = insertChunks.getRowsInserted();
+    #ifdef LEAFRA_HAS_FAISS
+            if (store_centroid && !storeDocumentCentroid(doc_id, centroid, chunks_inserted)) {
+                LEAFRA_ERROR() << "Failed to store document centroid for: " << filename;
+                return false;
+            }
+    #endif
+            
+            // Log insertion summary
+            if (chunks_left_out > 0) {
+                LEAFRA_INFO() << "Database insertion: " << chunks_left_out << " near-duplicate or low-quality chunks left out";
+            }
+            if (chunks_skipped > 0) {
+                LEAFRA_INFO() << "Database insertion: " << chunks_inserted << "/" << chunks.size() << " chunks inserted (" << chunks_skipped << " skipped - no embeddings)";
             } else {
                 LEAFRA_INFO() << "Database insertion: " << chunks_inserted << "/" << chunks.size() << " chunks inserted";
             }
             
+            // The file's ingestion_queue row turns done with the document, so a resumed run never stores it twice
+            if (ingestion_queue_available_) {
+                auto queueDoneStmt = database_->prepareCached(
+                    "UPDATE ingestion_queue SET status = 'done', stage = 'stored', content_hash = ?, "
+                    "updated_at = strftime('%s', 'now') WHERE file_path = ? AND collection = ?");
+                if (!queueDoneStmt || !queueDoneStmt->isValid()) {
+                    LEAFRA_ERROR() << "Failed to prepare ingestion queue update for document: " << filename;
+                    return false;
+                }
+                queueDoneStmt->bindText(1, fingerprint.content_hash);
+                queueDoneStmt->bindText(2, file_path);
+                queueDoneStmt->bindText(3, fingerprint.collection);
+                if (!queueDoneStmt->execute()) {
+                    LEAFRA_ERROR() << "Failed to update ingestion queue for document: " << filename;
+                    return false;
+                }
+            }
+            
             // Commit transaction
             if (!transaction.commit()) {
                 LEAFRA_ERROR() << "Failed to commit document and chunks transaction";
+                insert_timing.cancel();
                 return false;
             }
+            insert_timing.finish();
+            
+            // Later documents can now match these chunks
+            if (near_duplicate_index_) {
+                for (size_t i = 0; i < chunks.size() && i < chunk_simhashes.size(); ++i) {
+                    if (chunk_faiss_ids[i] >= 0) {
+                        near_duplicate_index_->add(chunk_simhashes[i], chunk_faiss_ids[i]);
+                    }
+                }
+            }
     #ifdef LEAFRA_HAS_FAISS
             // Insert chunk embeddings into FAISS index
-            if (!insertChunkEmbeddingsIntoFaiss(chunks, doc_id)) {
+            PipelineMetricsRecorder::ScopedStage faiss_timing(metrics_, PipelineStage::FAISS_ADD);
+            faiss_timing.set_items(chunks_inserted);
+            if (!insertChunkEmbeddingsIntoFaiss(batch, chunk_faiss_ids, fingerprint.collection)) {
+                faiss_timing.cancel();
                 LEAFRA_ERROR() << "Failed to insert embeddings into FAISS index for document: " << filename;
                 // TODO AD: Consider rolling back the database transaction here
                 return false;
             }
+            if (!centroid.empty()) {
+                std::lock_guard<std::mutex> lock(document_index_mutex_);
+                const int64_t document_label = doc_id;
+                if (document_index_ &&
+                    document_index_->add_vectors_with_ids(centroid.data(), &document_label, 1) != ResultCode::SUCCESS) {
+                    LEAFRA_WARNING() << "Failed to add document to the document index: " << filename;
+                }
+            }
     #endif // LEAFRA_HAS_FAISS
             LEAFRA_INFO() << "✅ Successfully inserted document '" << filename << "' with " << chunks.size() << " chunks";
-            send_event("💾 Stored document: " + filename + " (" + std::to_string(chunks.size()) + " chunks)");
+            send_event(EventType::DOCUMENT_STORED, "💾 Stored document: " + filename + " (" + std::to_string(chunks.size()) + " chunks)", file_path);
             
             return true;
             
@@ -329,10 +1332,12 @@ public:
     /**
      * @brief Print detailed chunk content analysis for debugging/development
      * @param chunks Vector of text chunks to analyze
+     * @param batch The chunks' token IDs and embeddings
      * @param file_path Original file path for context
      * @param using_sentencepiece Whether SentencePiece tokenization was used
      */
     void printChunkContentAnalysis(const std::vector<TextChunk>& chunks, 
+                                  const ChunkBatch& batch,
                                   const std::string& file_path, 
                                   bool using_sentencepiece) {
         if (!config_.chunking.print_chunks_full && !config_.chunking.print_chunks_brief) {
@@ -354,13 +1359,17 @@ public:
             LEAFRA_INFO() << "Chunk " << (i + 1) << " of " << chunks.size() << ":";
             LEAFRA_INFO() << "  📐 Length: " << chunk.content.length() << " characters";
             LEAFRA_INFO() << "  🔤 Tokens: " << chunk.estimated_tokens << " (" << (using_sentencepiece ? "actual" : "estimated") << ")";
-            if (chunk.has_token_ids()) {
-                LEAFRA_INFO() << "  🔢 Token IDs: " << chunk.token_ids.size() << " stored";
+            if (batch.has_tokens(i)) {
+                LEAFRA_INFO() << "  🔢 Token IDs: " << batch.tokens.length(i) << " stored";
+            }
+            if (batch.has_embedding(i)) {
+                LEAFRA_INFO() << "  🧠 Embedding: " << batch.dimension << " dimensions";
             }
-            if (chunk.has_embedding()) {
-                LEAFRA_INFO() << "  🧠 Embedding: " << chunk.embedding.size() << " dimensions";
+            if (chunk.end_page_number > chunk.page_number) {
+                LEAFRA_INFO() << "  📄 Pages: " << (chunk.page_number + 1) << "-" << (chunk.end_page_number + 1);
+            } else {
+                LEAFRA_INFO() << "  📄 Page: " << (chunk.page_number + 1);
             }
-            LEAFRA_INFO() << "  📄 Page: " << (chunk.page_number + 1);
             LEAFRA_INFO() << "  📍 Position: " << chunk.start_index << "-" << chunk.end_index;
             if (using_sentencepiece && chunk.estimated_tokens > 0) {
                 LEAFRA_INFO() << "  📊 Chars/token ratio: " << static_cast<double>(chunk.content.length()) / chunk.estimated_tokens;
@@ -369,9 +1378,9 @@ public:
             
             // Print content based on print mode
             if (config_.chunking.print_chunks_full) {
-                printFullChunkContent(chunk);
+                printFullChunkContent(chunk, batch, i);
             } else if (config_.chunking.print_chunks_brief) {
-                printBriefChunkContent(chunk);
+                printBriefChunkContent(chunk, batch, i);
             }
             
             if (i < chunks.size() - 1) {
@@ -385,31 +1394,36 @@ public:
     /**
      * @brief Print full chunk content with all details
      * @param chunk Text chunk to print
+     * @param batch Columnar batch holding the chunk's token IDs and embedding
+     * @param row The chunk's row in batch
      */
-    void printFullChunkContent(const TextChunk& chunk) {
+    void printFullChunkContent(const TextChunk& chunk, const ChunkBatch& batch, size_t row) {
         // Print full content - convert string_view to string to prevent UTF-8 streaming issues
         LEAFRA_INFO() << std::string(chunk.content);
         
         // Print full token IDs if available
-        if (chunk.has_token_ids() && !chunk.token_ids.empty()) {
-            LEAFRA_INFO() << "🔢 Token IDs (" << chunk.token_ids.size() << " tokens):";
+        if (batch.has_tokens(row)) {
+            const int* token_ids = batch.tokens.begin(row);
+            const size_t token_count = batch.tokens.length(row);
+            LEAFRA_INFO() << "🔢 Token IDs (" << token_count << " tokens):";
             std::ostringstream token_stream;
-            for (size_t k = 0; k < chunk.token_ids.size(); ++k) {
-                token_stream << chunk.token_ids[k];
-                if (k < chunk.token_ids.size() - 1) token_stream << " ";
+            for (size_t k = 0; k < token_count; ++k) {
+                token_stream << token_ids[k];
+                if (k < token_count - 1) token_stream << " ";
             }
             LEAFRA_INFO() << token_stream.str();
         }
         
         // Print full sentence embedding if available
-        if (chunk.has_embedding() && !chunk.embedding.empty()) {
-            LEAFRA_INFO() << "🧠 Sentence Embedding (" << chunk.embedding.size() << " dimensions):";
+        if (batch.has_embedding(row)) {
+            const float* embedding = batch.embedding(row);
+            LEAFRA_INFO() << "🧠 Sentence Embedding (" << batch.dimension << " dimensions):";
             std::ostringstream embedding_stream;
             embedding_stream << std::fixed << std::setprecision(8);
             embedding_stream << "[";
-            for (size_t k = 0; k < chunk.embedding.size(); ++k) {
-                embedding_stream << chunk.embedding[k];
-                if (k < chunk.embedding.size() - 1) embedding_stream << " ";
+            for (size_t k = 0; k < batch.dimension; ++k) {
+                embedding_stream << embedding[k];
+                if (k < batch.dimension - 1) embedding_stream << " ";
             }
             embedding_stream << "]";
             LEAFRA_INFO() << embedding_stream.str();
@@ -419,8 +1433,10 @@ public:
     /**
      * @brief Print brief chunk content with truncation
      * @param chunk Text chunk to print
+     * @param batch Columnar batch holding the chunk's token IDs and embedding
+     * @param row The chunk's row in batch
      */
-    void printBriefChunkContent(const TextChunk& chunk) {
+    void printBriefChunkContent(const TextChunk& chunk, const ChunkBatch& batch, size_t row) {
         // Print first N lines
         std::istringstream stream(std::string(chunk.content));
         std::string line;
@@ -438,40 +1454,43 @@ public:
         }
         
         // Print brief token IDs if available
-        if (chunk.has_token_ids() && !chunk.token_ids.empty()) {
+        if (batch.has_tokens(row)) {
             const size_t max_tokens_to_show = 20; // Show first 20 token IDs
-            LEAFRA_INFO() << "🔢 Token IDs (" << chunk.token_ids.size() << " tokens):";
+            const int* token_ids = batch.tokens.begin(row);
+            const size_t token_count = batch.tokens.length(row);
+            LEAFRA_INFO() << "🔢 Token IDs (" << token_count << " tokens):";
             std::ostringstream token_stream;
             
-            size_t tokens_to_display = std::min(max_tokens_to_show, chunk.token_ids.size());
+            size_t tokens_to_display = std::min(max_tokens_to_show, token_count);
             for (size_t k = 0; k < tokens_to_display; ++k) {
-                token_stream << chunk.token_ids[k];
+                token_stream << token_ids[k];
                 if (k < tokens_to_display - 1) token_stream << " ";
             }
             
-            if (chunk.token_ids.size() > max_tokens_to_show) {
-                token_stream << " ... (showing first " << max_tokens_to_show << " of " << chunk.token_ids.size() << " tokens)";
+            if (token_count > max_tokens_to_show) {
+                token_stream << " ... (showing first " << max_tokens_to_show << " of " << token_count << " tokens)";
             }
             
             LEAFRA_INFO() << token_stream.str();
         }
         
         // Print brief sentence embedding if available
-        if (chunk.has_embedding() && !chunk.embedding.empty()) {
+        if (batch.has_embedding(row)) {
             const size_t max_dims_to_show = 10; // Show first 10 dimensions
-            LEAFRA_INFO() << "🧠 Sentence Embedding (" << chunk.embedding.size() << " dimensions):";
+            const float* embedding = batch.embedding(row);
+            LEAFRA_INFO() << "🧠 Sentence Embedding (" << batch.dimension << " dimensions):";
             std::ostringstream embedding_stream;
             embedding_stream << std::fixed << std::setprecision(8);
             embedding_stream << "[";
             
-            size_t dims_to_display = std::min(max_dims_to_show, chunk.embedding.size());
+            size_t dims_to_display = std::min(max_dims_to_show, batch.dimension);
             for (size_t k = 0; k < dims_to_display; ++k) {
-                embedding_stream << chunk.embedding[k];
+                embedding_stream << embedding[k];
                 if (k < dims_to_display - 1) embedding_stream << " ";
             }
             
-            if (chunk.embedding.size() > max_dims_to_show) {
-                embedding_stream << " ... (showing first " << max_dims_to_show << " of " << chunk.embedding.size() << " dimensions)";
+            if (batch.dimension > max_dims_to_show) {
+                embedding_stream << " ... (showing first " << max_dims_to_show << " of " << batch.dimension << " dimensions)";
             }
             embedding_stream << "]";
             
@@ -504,1373 +1523,10393 @@ public:
         }
         } //printDebugChunkSummary
 
-#ifdef LEAFRA_HAS_COREML
     /**
-     * @brief Process chunks through CoreML embedding model
-     * @param chunks Vector of text chunks to process (modified in-place with embeddings)
-     * @param file_path Original file path for logging context
-     * @return Number of successful embeddings generated
+     * @brief Check whether an embedding backend is ready, waiting for a background load to finish
+     */
+    bool hasEmbeddingModel() const {
+        if (embedding_ready_.valid()) {
+            embedding_ready_.wait();
+        }
+        return embedding_scheduler_ && embedding_scheduler_->is_ready();
+    }
+
+    /**
+     * @brief Scheduler search queries go through: the dedicated query instance if one is loaded
+     */
+    EmbeddingScheduler& queryScheduler() const {
+        return query_scheduler_ ? *query_scheduler_ : *embedding_scheduler_;
+    }
+    
+    /**
+     * @brief Shared hold of model_swap_mutex_ for the duration of a call
+     * 
+     * Taken once per thread: nested calls (a RAG answer searches, then embeds again) don't lock
+     * again, so a re-index waiting for the exclusive lock can't wedge between them.
      */
-    size_t processChunksWithCoreMLEmbeddings(std::vector<TextChunk>& chunks, 
-                                           const std::string& file_path) {
-        if (!coreml_initialized_ || !coreml_model_) {
-            if (config_.embedding_inference.enabled && config_.embedding_inference.framework == "coreml") {
-                LEAFRA_WARNING() << "CoreML embedding model requested but not initialized";
+    class ModelUse {
+    public:
+        explicit ModelUse(std::shared_mutex& mutex) : mutex_(mutex) {
+            std::vector<const std::shared_mutex*>& held = heldModels();
+            if (std::find(held.begin(), held.end(), &mutex_) == held.end()) {
+                mutex_.lock_shared();
+                held.push_back(&mutex_);
+                owner_ = true;
             }
-            return 0;
         }
+        ~ModelUse() {
+            if (owner_) {
+                std::vector<const std::shared_mutex*>& held = heldModels();
+                held.erase(std::find(held.begin(), held.end(), &mutex_));
+                mutex_.unlock_shared();
+            }
+        }
+        ModelUse(const ModelUse&) = delete;
+        ModelUse& operator=(const ModelUse&) = delete;
         
-        LEAFRA_DEBUG_TIMER("coreml_embedding_inference");
-        auto start_time = debug::timer::now();
-        
-        LEAFRA_INFO() << "Starting CoreML embedding inference for " << chunks.size() << " chunks";
-        send_event("🧠 Starting embedding inference for " + std::to_string(chunks.size()) + " chunks");
-        
-        size_t successful_embeddings = 0;
+    private:
+        static std::vector<const std::shared_mutex*>& heldModels() {
+            thread_local std::vector<const std::shared_mutex*> held;
+            return held;
+        }
         
-        try {
-            // Get model input requirements once (cache for performance)
-            size_t model_input_count = coreml_model_->getInputCount();
-            if (model_input_count != 2) {
-                LEAFRA_ERROR() << "Unexpected model input count: " << model_input_count << " (expected 2 for embedding model)";
-                return 0; // Skip embedding processing
-            }
+        std::shared_mutex& mutex_;
+        bool owner_ = false;
+    };
+    
+    /**
+     * @brief Identifier of a configuration's embedding model, recorded per index in index_models
+     * 
+     * File names rather than paths: app containers move between installs and updates.
+     */
+    static std::string embeddingModelId(const Config& config) {
+        const EmbeddingModelConfig& model = config.embedding_inference;
+        const TokenizerConfig& tokenizer = config.tokenizer;
+        std::string id = model.framework + ":" + std::filesystem::path(model.model_path).filename().string();
+        if (tokenizer.enabled) {
+            id += "+" + (tokenizer.model_name.empty() ? std::filesystem::path(tokenizer.model_path).filename().string() : tokenizer.model_name);
+        }
+        id += "/" + std::to_string(config.vector_search.dimension);
+        if (!model.normalize_embeddings) {
+            id += "/raw";
+        }
+        if (model.pooling != "mean") {
+            id += "/" + model.pooling;
+        }
+        return id;
+    }
+
+    /**
+     * @brief Create the embedding backend selected by embedding_inference.framework
+     * @return ERROR_INITIALIZATION_FAILED if a valid configuration fails to load, SUCCESS otherwise
+     */
+    ResultCode loadEmbeddingModel() {
+        return createEmbeddingSchedulers(config_, *tokenizer_, embedding_scheduler_, query_scheduler_);
+    }
+    
+    /**
+     * @brief Load a configuration's embedding model (and query instance) into the given schedulers
+     * @param config Configuration naming the model (config_, or the target of a re-index)
+     * @param tokenizer Tokenizer of the model (pad id)
+     * @param scheduler Receives the ingestion scheduler (left empty without a valid model)
+     * @param query_scheduler Receives the query instance if embedding_inference.query_instance (else reset)
+     * @return ERROR_INITIALIZATION_FAILED if a valid configuration fails to load, SUCCESS otherwise
+     */
+    ResultCode createEmbeddingSchedulers(const Config& config, const SentencePieceTokenizer& tokenizer,
+                                         std::unique_ptr<EmbeddingScheduler>& scheduler,
+                                         std::unique_ptr<EmbeddingScheduler>& query_scheduler) {
+        if (config.embedding_inference.is_valid() && !is_embedding_framework_available(config.embedding_inference.framework)) {
+            LEAFRA_WARNING() << "⚠️  " << config.embedding_inference.framework << " embedding model requested but not available (framework not linked)";
+        } else if (config.embedding_inference.is_valid()) {
+            LEAFRA_INFO() << "Initializing embedding model";
+            LEAFRA_INFO() << "  - Framework: " << config.embedding_inference.framework;
+            LEAFRA_INFO() << "  - Model path: " << config.embedding_inference.model_path;
             
-            size_t required_input_size = coreml_model_->getInputSize(0);
-            int pad_token = tokenizer_->pad_id();
-            if (pad_token < 0) {
-                pad_token = 0; // Default to 0 if pad_id is disabled (-1)
+            // The backend takes the embedding share of the thread budget
+            Config backend_config = config;
+            backend_config.embedding_inference.tflite_num_threads = thread_budget_.embedding_threads;
+            std::unique_ptr<IEmbeddingBackend> backend = create_embedding_backend(backend_config);
+            if (!backend || !backend->isReady()) {
+                LEAFRA_ERROR() << "❌ Failed to initialize " << config.embedding_inference.framework << " embedding model";
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+            const size_t dimension = backend->getEmbeddingDimension();
+            if (config.vector_search.enabled && config.vector_search.dimension > 0 &&
+                dimension != static_cast<size_t>(config.vector_search.dimension)) {
+                LEAFRA_ERROR() << "❌ " << config.embedding_inference.model_path << " embeds " << dimension
+                               << " dimensions, vector_search.dimension is " << config.vector_search.dimension;
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+            // Dequantized outputs carry a small per-model scale error that raw inner products keep
+            if (backend->isQuantized() && !config.embedding_inference.normalize_embeddings &&
+                config.vector_search.metric == "INNER_PRODUCT") {
+                LEAFRA_WARNING() << "⚠️  Quantized embedding model with unnormalized INNER_PRODUCT search - "
+                                 << "use COSINE or normalize_embeddings for stable scores";
             }
             
-            LEAFRA_DEBUG() << "CoreML model expects " << required_input_size << " tokens per input";
-            LEAFRA_DEBUG() << "Using pad_token: " << pad_token;
+            EmbeddingScheduler::Options scheduler_options;
+            scheduler_options.batch_size = static_cast<size_t>(std::max(1, config.embedding_inference.batch_size));
+            scheduler_options.pad_token = std::max(0, tokenizer.pad_id()); // Default to 0 if pad_id is disabled (-1)
+            scheduler_options.normalize = config.embedding_inference.normalize_embeddings;
+            scheduler_options.pipeline_depth = static_cast<size_t>(std::max(1, config.embedding_inference.pipeline_depth));
+            scheduler = std::make_unique<EmbeddingScheduler>(std::move(backend), scheduler_options);
+            scheduler->set_batch_size(governor_.limits().embedding_batch_size);
             
-            // Pre-allocate vectors for reuse (performance optimization)
-            std::vector<int> processed_token_ids;
-            std::vector<float> input_tokens, attention_mask;
-            processed_token_ids.reserve(required_input_size);
-            input_tokens.reserve(required_input_size);
-            attention_mask.reserve(required_input_size);
+            LEAFRA_INFO() << "✅ " << scheduler->backend().getName() << " embedding model initialized successfully";
+            LEAFRA_INFO() << "  - Sequence length: " << scheduler->backend().getSequenceLength();
+            LEAFRA_INFO() << "  - Embedding dimension: " << scheduler->backend().getEmbeddingDimension();
+            LEAFRA_INFO() << "  - Batch size: " << scheduler->get_effective_batch_size();
             
-            // Process each chunk individually
-            for (size_t chunk_idx = 0; chunk_idx < chunks.size(); ++chunk_idx) {
-                auto& chunk = chunks[chunk_idx];
-                
-                if (chunk.has_token_ids() && !chunk.token_ids.empty()) {
-                    try {
-                        successful_embeddings += processChunkEmbedding(chunk, chunk_idx, 
-                                                                     required_input_size, pad_token,
-                                                                     processed_token_ids, input_tokens, attention_mask);
-                    } catch (const std::exception& e) {
-                        LEAFRA_ERROR() << "CoreML embedding inference failed for chunk " << (chunk_idx + 1) << ": " << e.what();
-                    }
+            query_scheduler.reset();
+            if (config.embedding_inference.query_instance) {
+                Config query_config = backend_config;
+                query_config.embedding_inference.coreml_compute_units = config.embedding_inference.query_coreml_compute_units;
+                std::unique_ptr<IEmbeddingBackend> query_backend = create_embedding_backend(query_config);
+                if (query_backend && query_backend->isReady()) {
+                    EmbeddingScheduler::Options query_options = scheduler_options;
+                    query_options.pipeline_depth = 1;   // Queries are a row or a few, nothing to overlap
+                    query_scheduler = std::make_unique<EmbeddingScheduler>(std::move(query_backend), query_options);
+                    LEAFRA_INFO() << "  - Query instance: loaded"
+                                  << (config.embedding_inference.framework == "coreml" ? " (" + config.embedding_inference.query_coreml_compute_units + ")" : std::string());
                 } else {
-                    LEAFRA_DEBUG() << "Skipping chunk " << (chunk_idx + 1) << " - no token IDs available";
+                    LEAFRA_WARNING() << "⚠️  Failed to load the query embedding instance - queries share the ingestion model";
                 }
             }
-            
-            LEAFRA_INFO() << "✅ CoreML embedding inference completed for file: " << file_path;
-            LEAFRA_INFO() << "  - Total chunks processed: " << chunks.size();
-            LEAFRA_INFO() << "  - Successful embeddings: " << successful_embeddings;
-            LEAFRA_INFO() << "  - Failed embeddings: " << (chunks.size() - successful_embeddings);
-            
-            // Log performance metrics
-            auto end_time = debug::timer::now();
-            double total_duration_ms = debug::timer::elapsed_milliseconds(start_time, end_time);
-            LEAFRA_DEBUG_LOG("PERFORMANCE", "CoreML embedding inference completed in " + std::to_string(total_duration_ms) + "ms");
-            if (successful_embeddings > 0) {
-                double avg_ms_per_chunk = total_duration_ms / successful_embeddings;
-                LEAFRA_DEBUG_LOG("PERFORMANCE", "Average inference time per chunk: " + std::to_string(avg_ms_per_chunk) + "ms");
-                debug::debug_log_performance("coreml_embedding", chunks.size(), successful_embeddings, total_duration_ms);
-            }
-            
-        } catch (const std::exception& e) {
-            LEAFRA_ERROR() << "CoreML embedding inference failed for file " << file_path << ": " << e.what();
+            // Backends that map the model (TFLite) get the mapping of both instances advised
+            large_pages::advise_file(config.embedding_inference.model_path);
+        } else if (config.embedding_inference.enabled) {
+            LEAFRA_WARNING() << "⚠️  Embedding model inference enabled but configuration is invalid";
+            LEAFRA_WARNING() << "    Framework: '" << config.embedding_inference.framework << "'";
+            LEAFRA_WARNING() << "    Model path: '" << config.embedding_inference.model_path << "'";
         }
-        
-        return successful_embeddings;
+        return ResultCode::SUCCESS;
+    } //createEmbeddingSchedulers
+    
+    /**
+     * @brief Take the SentencePiece model config_.tokenizer names from the shared registry
+     */
+    void reloadTokenizer() {
+        // Let go of the previous model first (freed once no other instance uses it)
+        tokenizer_ = std::make_shared<SentencePieceTokenizer>();
+        if (!config_.tokenizer.enabled) {
+            return;
+        }
+        LEAFRA_INFO() << "Initializing SentencePiece tokenizer";
+        if (config_.tokenizer.model_path.empty()) {
+            LEAFRA_WARNING() << "⚠️  SentencePiece enabled but no model path specified";
+            return;
+        }
+        std::shared_ptr<const SentencePieceTokenizer> shared = SentencePieceTokenizer::acquire_shared(config_.tokenizer);
+        if (!shared) {
+            LEAFRA_WARNING() << "⚠️  Failed to load SentencePiece model from: " << config_.tokenizer.model_path;
+            return;
+        }
+        tokenizer_ = shared;
+        LEAFRA_INFO() << "✅ SentencePiece model loaded from: " << config_.tokenizer.model_path;
+        LEAFRA_INFO() << "  - Vocabulary size: " << tokenizer_->get_vocab_size();
+    } //reloadTokenizer
+    
+    /**
+     * @brief Release the embedding backends (and the query instance)
+     */
+    void unloadEmbeddingModel() {
+        query_scheduler_.reset();
+        embedding_scheduler_.reset();
     }
     
     /**
-     * @brief Process a single chunk for embedding generation
-     * @param chunk Text chunk to process (modified in-place with embedding)
-     * @param chunk_number 1-based chunk number for logging
-     * @param required_input_size Required input size for the model
-     * @param pad_token Padding token ID
-     * @param processed_token_ids Reusable vector for token processing
-     * @param input_tokens Reusable vector for model input tokens
-     * @param attention_mask Reusable vector for attention mask
-     * @return 1 if embedding was successfully generated, 0 otherwise
-     */
-    size_t processChunkEmbedding(TextChunk& chunk, 
-                               size_t chunk_number,
-                               size_t required_input_size, 
-                               int pad_token,
-                               std::vector<int>& processed_token_ids,
-                               std::vector<float>& input_tokens,
-                               std::vector<float>& attention_mask) {
-        // Reuse pre-allocated vectors (clear and prepare)
-        processed_token_ids.clear();
-        input_tokens.clear();
-        attention_mask.clear();
-        
-        // Prepare padded/trimmed token sequence
-        size_t original_size = chunk.token_ids.size();
-        size_t real_token_count = std::min(original_size, required_input_size);
-        
-        // Copy and resize in one operation
-        processed_token_ids.assign(chunk.token_ids.begin(), 
-                                  chunk.token_ids.begin() + real_token_count);
-        if (processed_token_ids.size() < required_input_size) {
-            processed_token_ids.resize(required_input_size, pad_token);
-        }
-        
-        // Convert int tokens to float and create attention mask in single pass
-        input_tokens.resize(required_input_size);
-        attention_mask.resize(required_input_size);
-        
-        for (size_t i = 0; i < required_input_size; ++i) {
-            input_tokens[i] = static_cast<float>(processed_token_ids[i]);
-            attention_mask[i] = (i < real_token_count) ? 1.0f : 0.0f;
-        }
-        
-        // Debug print input tokens and attention mask as vectors
-        if (config_.debug_mode) {
-            LEAFRA_DEBUG() << "Chunk " << chunk_number << " input_tokens vector (" << input_tokens.size() << " elements):";
-            std::ostringstream tokens_stream;
-            tokens_stream << "[";
-            for (size_t i = 0; i < input_tokens.size(); ++i) {
-                tokens_stream << static_cast<int>(input_tokens[i]);
-                if (i < input_tokens.size() - 1) tokens_stream << ", ";
-            }
-            tokens_stream << "]";
-            LEAFRA_DEBUG() << tokens_stream.str();
-            
-            LEAFRA_DEBUG() << "Chunk " << chunk_number << " attention_mask vector (" << attention_mask.size() << " elements):";
-            std::ostringstream mask_stream;
-            mask_stream << "[";
-            for (size_t i = 0; i < attention_mask.size(); ++i) {
-                mask_stream << static_cast<int>(attention_mask[i]);
-                if (i < attention_mask.size() - 1) mask_stream << ", ";
-            }
-            mask_stream << "]";
-            LEAFRA_DEBUG() << mask_stream.str();
-        }
-        
-        //Our coreml implementation expects inputs in alphabetical order of their names
-        //I've added an explicit check by passing input names to the predict function to make
-        //sure that the user is not confused when using the model. This of course requires naming
-        //the inputs and outputs in the model; which should be our best practice regardless of inference framework
-        std::vector<std::vector<float>> model_inputs = {attention_mask, input_tokens};
-        
-        // Run embedding inference
-        LEAFRA_DEBUG() << "Running CoreML embedding inference for chunk " << chunk_number;
-        auto inference_start = debug::timer::now();
-        
-        // Use explicit input names as best practice (works fore5_embedding_model_i512a512_FP32.mlmodelc)
-        std::vector<std::vector<float>> embeddings;
-        
-        if (config_.tokenizer.model_name == "multilingual-e5-small") {
-            std::vector<std::string> input_names = {"attention_mask", "input_ids"};
-            embeddings = coreml_model_->predict(model_inputs, input_names);
+     * @brief Apply the logging and event delivery settings of a configuration
+     */
+    void configureLogging(const Config& config) {
+        Logger& logger = Logger::getInstance();
+        if (config.debug_mode) {
+            logger.setLogLevel(LogLevel::LEAFRA_DEBUG);
+            LEAFRA_WARNING() << "LeafraCore: Debug logging enabled - LogLevel set to DEBUG";
+            fprintf(stderr, "[LeafraSDK] Debug mode enabled\n");
         } else {
-            embeddings = coreml_model_->predict(model_inputs);
+            logger.setLogLevel(LogLevel::LEAFRA_INFO);
+            LEAFRA_WARNING() << "LeafraCore: Debug logging disabled - LogLevel set to INFO";
+            fprintf(stderr, "[LeafraSDK] Debug mode disabled\n");
         }
-        
-        auto inference_end = debug::timer::now();
-        double inference_ms = debug::timer::elapsed_milliseconds(inference_start, inference_end);
-        LEAFRA_DEBUG_LOG("TIMING", "Chunk " + std::to_string(chunk_number) + " inference: " + std::to_string(inference_ms) + "ms");
-        
-        if (!embeddings.empty() && !embeddings[0].empty()) {
-            // Store the embedding vector in the chunk
-            chunk.embedding = std::move(embeddings[0]);
-            LEAFRA_DEBUG() << "Generated embedding with " << chunk.embedding.size() << " dimensions for chunk " << chunk_number;
-            
-            // Debug print the embedding vector
-            if (config_.debug_mode) {
-                LEAFRA_DEBUG() << "Chunk " << chunk_number << " embedding vector (" << chunk.embedding.size() << " dimensions):";
-                std::ostringstream embedding_stream;
-                embedding_stream << std::fixed << std::setprecision(6);
-                embedding_stream << "[";
-                for (size_t i = 0; i < chunk.embedding.size(); ++i) {
-                    embedding_stream << chunk.embedding[i];
-                    if (i < chunk.embedding.size() - 1) embedding_stream << ", ";
-                }
-                embedding_stream << "]";
-                LEAFRA_DEBUG() << embedding_stream.str();
-            }
-            
-            return 1; // Success
-        } else {
-            LEAFRA_WARNING() << "CoreML model produced empty embedding for chunk " << chunk_number;
-            return 0; // Failure
+        if (config.async_logging) {
+            logger.setAsync(true, static_cast<size_t>(std::max<int32_t>(config.log_queue_capacity, 2)),
+                            config.log_drop_when_full ? LogOverflowPolicy::DROP : LogOverflowPolicy::BLOCK);
+        } else if (logger.isAsync()) {
+            logger.setAsync(false);
         }
-    } //processChunkEmbedding
-#endif
-
+        events_.configure(config.async_events, static_cast<size_t>(std::max<int32_t>(config.event_queue_capacity, 1)),
+                          config.coalesce_progress_events);
+    } //configureLogging
+    
     /**
-     * @brief Process chunks with SentencePiece tokenization for accurate token counting
-     * @param chunks Vector of text chunks to process (modified in-place with token IDs)
-     * @return Pair of (total_actual_tokens, using_sentencepiece_flag)
+     * @brief Chunker defaults for a chunking configuration
      */
-    std::pair<size_t, bool> processChunksWithSentencePieceTokenization(std::vector<TextChunk>& chunks, const std::string& prefix) {
-        size_t total_actual_tokens = 0;
-        bool using_sentencepiece = false;
+    static ChunkingOptions chunkingOptions(const ChunkingConfig& chunking) {
+        ChunkingOptions options(chunking.chunk_size, chunking.overlap_percentage, chunking.size_unit, chunking.token_method);
+        options.preserve_word_boundaries = chunking.preserve_word_boundaries;
+        options.include_metadata = chunking.include_metadata;
+        options.parallel_segment_bytes = chunking.parallel_segment_bytes;
+        options.strategy = chunking.strategy;
+        return options;
+    }
+    
+    /**
+     * @brief Admission controller options for an admission configuration
+     */
+    static AdmissionController::Options admissionOptions(const AdmissionConfig& admission) {
+        AdmissionController::Options options;
+        options.enabled = admission.enabled;
+        options.slots[static_cast<size_t>(AdmissionResource::EMBEDDER)] = static_cast<size_t>(std::max<int32_t>(0, admission.max_concurrent_embeddings));
+        options.slots[static_cast<size_t>(AdmissionResource::INDEX)] = static_cast<size_t>(std::max<int32_t>(0, admission.max_concurrent_searches));
+        options.slots[static_cast<size_t>(AdmissionResource::LLM)] = static_cast<size_t>(std::max<int32_t>(0, admission.max_concurrent_generations));
+        options.max_queued = static_cast<size_t>(std::max<int32_t>(0, admission.max_queued_requests));
+        return options;
+    }
+    
+    /**
+     * @brief Whether two configurations differ in settings fixed until the next shutdown / initialize
+     *
+     * The document database and its connection profile, the FAISS index layout and the
+     * thread pool sizes; reconfigure() restarts the SDK when one of them changes.
+     */
+    static bool needsRestart(const Config& a, const Config& b) {
+        auto fixed = [](const Config& c) {
+            const DatabaseConfig& d = c.database;
+            const VectorSearchConfig& v = c.vector_search;
+            return std::tie(c.leafra_document_database_name, c.storage_directory, c.attach_read_only, c.max_threads, c.query_threads,
+                            d.journal_mode, d.synchronous, d.cache_size_kib, d.mmap_size, d.temp_store, d.page_size,
+                            d.busy_timeout_ms, d.statement_cache_size, d.read_connections, d.auto_vacuum, d.vacuum_pages_per_slice,
+                            d.chunk_text_compression, d.chunk_text_storage, d.doc_text_page_bytes,
+                            v.enabled, v.dimension, v.index_type, v.metric, v.index_dimension, v.nlist, v.m, v.nbits, v.hnsw_m,
+                            v.lsh_nbits, v.ivf_train_min_vectors, v.auto_ivf_threshold, v.auto_ivf_type, v.gpu_flat_search,
+                            v.index_definition, v.auto_load, v.index_storage, v.mmap_index_file, v.ivf_on_disk_lists,
+                            v.embedding_storage, v.hot_index, v.hot_merge_interval_ms);
+        };
+        return fixed(a) != fixed(b);
+    }
+    
+    /**
+     * @brief Log and refuse an operation that writes the store while attached read-only
+     * @return true if the caller must return ERROR_NOT_IMPLEMENTED
+     */
+    bool rejectWhenAttached(const char* operation) const {
+        if (!attached_) {
+            return false;
+        }
+        LEAFRA_ERROR() << operation << " is not available with attach_read_only - the writing process owns the store";
+        return true;
+    }
+    
+    /**
+     * @brief Whether the embedding backend (or the tokenizer feeding it) must be loaded again
+     */
+    static bool embeddingModelChanged(const Config& a, const Config& b) {
+        auto loaded = [](const Config& c) {
+            const TokenizerConfig& t = c.tokenizer;
+            const EmbeddingModelConfig& e = c.embedding_inference;
+            return std::tie(t.enabled, t.model_name, t.model_path, t.model_json_path,
+                            e.enabled, e.framework, e.model_path, e.normalize_embeddings, e.pooling, e.pipeline_depth, e.sequence_buckets,
+                            e.coreml_compute_units, e.coreml_cache_compiled, e.coreml_prewarm, e.query_instance,
+                            e.query_coreml_compute_units, e.tflite_enable_coreml_delegate, e.tflite_enable_metal_delegate,
+                            e.tflite_enable_gpu_delegate, e.tflite_enable_xnnpack_delegate, e.tflite_num_threads, e.tflite_use_nnapi,
+                            e.tflite_delegate_cache_dir, e.executorch_method, e.executorch_num_threads);
+        };
+        return loaded(a) != loaded(b);
+    }
+    
+    /**
+     * @brief Whether an LLM configuration differs in settings fixed when the model is loaded
+     *
+     * Sampling and n_predict go through LlamaCppModel::update_generation_config, the system
+     * prompt through set_system_prompt and thread counts through the governor; everything
+     * else in LLMConfig is read by the SDK per call.
+     */
+    static bool llmModelChanged(const LLMConfig& a, const LLMConfig& b) {
+        auto loaded = [](const LLMConfig& l) {
+            return std::tie(l.enabled, l.framework, l.model_path, l.draft_model_path, l.n_draft, l.n_ctx, l.n_batch, l.n_ubatch,
+                            l.n_seq_max, l.n_gpu_layers, l.gpu_memory_margin_mb, l.use_mmap, l.use_mlock, l.numa, l.type_k, l.type_v,
+                            l.flash_attn, l.embeddings, l.reuse_prompt_cache, l.context_shift, l.n_keep,
+                            l.stream_flush_ms, l.stream_flush_tokens);
+        };
+        return loaded(a) != loaded(b);
+    }
+    #ifdef LEAFRA_HAS_LLAMACPP
+    /**
+     * @brief Load the llama.cpp model, optionally warm it up, and evaluate the system prompt
+     * @return ERROR_INITIALIZATION_FAILED if the backend or model fails to load
+     */
+    ResultCode loadLLM() {
+        LEAFRA_INFO() << "Initializing LLM inference";
+        LEAFRA_INFO() << "  - Framework: " << config_.llm.framework;
+        LEAFRA_INFO() << "  - Model path: " << config_.llm.model_path;
+        LEAFRA_INFO() << "  - Context size: " << config_.llm.n_ctx;
+        LEAFRA_INFO() << "  - Max tokens: " << config_.llm.n_predict;
+        LEAFRA_INFO() << "  - Temperature: " << config_.llm.temperature;
         
-        if (!config_.tokenizer.enabled || !tokenizer_ || !tokenizer_->is_loaded()) {
-            LEAFRA_WARNING() << "SentencePiece requested but not available, using estimates";
-            return {total_actual_tokens, using_sentencepiece};
+        // Initialize LlamaCpp backend
+        if (!leafra::llamacpp::global::initialize(false)) {
+            LEAFRA_ERROR() << "Failed to initialize LlamaCpp backend";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
         }
         
-        using_sentencepiece = true;
-        LEAFRA_DEBUG() << "Using SentencePiece for accurate token counting";
+        // Create LlamaCpp model instance
+        llamacpp_model_ = std::make_unique<leafra::llamacpp::LlamaCppModel>();
         
-        // Get accurate token counts for each chunk
-        for (size_t chunk_idx = 0; chunk_idx < chunks.size(); ++chunk_idx) {
-            auto& chunk = chunks[chunk_idx];
-            
-            // Note: chunk.content is a string_view, so we need to convert it to a string
-            // This can be prevented for other models which don't require changing the text by overloading the encode_as_ids with string_view
-             
-            std::string chunk_text = std::string(chunk.content);
-            
-            // Add "passage: or queary" prefix for multilingual-e5-small model per 
-            // https://huggingface.co/intfloat/multilingual-e5-small 
-            chunk_text = prefix + chunk_text;
-            
-            std::vector<int> token_ids = tokenizer_->encode_as_ids(chunk_text, SentencePieceTokenizer::TokenizeOptions());
-            
-            chunk.estimated_tokens = token_ids.size(); // Replace estimate with actual count
-            chunk.token_ids = std::move(token_ids);    // Store the actual token IDs
-            total_actual_tokens += chunk.estimated_tokens;
-            
-            // Debug log for first few chunks
-            if (config_.debug_mode && chunk_idx < 3) {
-                LEAFRA_DEBUG() << "Chunk " << (chunk_idx + 1) 
-                             << " - Characters: " << chunk_text.length() 
-                             << ", Actual tokens: " << chunk.estimated_tokens
-                             << ", Token IDs stored: " << chunk.token_ids.size()
-                             << ", Chars/token ratio: " << (chunk.estimated_tokens > 0 ? static_cast<double>(chunk_text.length()) / chunk.estimated_tokens : 0.0);
-            }
+        // Load with the LLM's share of the thread budget (resolved again: swap_llm may have replaced config_.llm)
+        LLMConfig llm_config = config_.llm;
+        ThreadBudget budget = ThreadBudget::resolve(PlatformUtils::get_cpu_topology(), config_);
+        llm_config.n_threads = budget.llm_threads;
+        llm_config.n_threads_batch = budget.llm_batch_threads;
+        ThroughputLimits ceiling = governor_.ceiling();
+        ceiling.llm_threads = budget.llm_threads;
+        ceiling.llm_batch_threads = budget.llm_batch_threads;
+        governor_.set_ceiling(ceiling);
+        ThroughputLimits limits = governor_.limits();
+        llm_config.n_threads = limits.llm_threads;
+        llm_config.n_threads_batch = limits.llm_batch_threads;
+        llm_applied_threads_ = llm_config.n_threads;
+        llm_applied_batch_threads_ = llm_config.n_threads_batch;
+        LEAFRA_INFO() << "  - Threads: " << llm_config.n_threads << " (batch: " << llm_config.n_threads_batch << ")";
+        if (!llamacpp_model_->load_model(llm_config)) {
+            LEAFRA_ERROR() << "Failed to load LlamaCpp model: " << llamacpp_model_->get_last_error();
+            llamacpp_model_.reset();
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
         }
         
-        LEAFRA_INFO() << "✅ SentencePiece tokenization completed";
-        LEAFRA_INFO() << "  - Total actual tokens: " << total_actual_tokens;
-        LEAFRA_INFO() << "  - Chunks with token IDs: " << chunks.size();
-        LEAFRA_DEBUG() << "✅ Token IDs stored for all " << chunks.size() << " chunks";
-        
-        return {total_actual_tokens, using_sentencepiece};
-    } //processChunksWithSentencePieceTokenization
-
-    /**
-     * @brief Calculate and log chunk statistics with event notifications
-     * @param chunks Vector of text chunks to analyze
-     * @param using_sentencepiece Whether actual or estimated tokens are being used
-     */
-    void calculateAndLogChunkStatistics(const std::vector<TextChunk>& chunks, bool using_sentencepiece) {
-        // Calculate statistics (using actual tokens if available, estimates otherwise)
-        size_t total_chunk_chars = 0;
-        size_t total_tokens = 0;
-        for (const auto& chunk : chunks) {
-            total_chunk_chars += chunk.content.length();
-            total_tokens += chunk.estimated_tokens;
+        // Page in the weights and compile kernels now rather than on the first request
+        if (config_.llm.warmup && !llamacpp_model_->warm_up()) {
+            LEAFRA_WARNING() << "LLM warm-up failed: " << llamacpp_model_->get_last_error();
         }
         
-        // Log detailed statistics
-        LEAFRA_INFO() << "Chunk statistics:";
-        LEAFRA_INFO() << "  - Total chunks: " << chunks.size();
-        LEAFRA_INFO() << "  - Total characters in chunks: " << total_chunk_chars;
-        LEAFRA_INFO() << "  - " << (using_sentencepiece ? "Actual" : "Estimated") << " tokens: " << total_tokens;
-        LEAFRA_INFO() << "  - Avg chunk size: " << (chunks.size() > 0 ? total_chunk_chars / chunks.size() : 0) << " chars";
-        LEAFRA_INFO() << "  - Avg tokens per chunk: " << (chunks.size() > 0 ? total_tokens / chunks.size() : 0);
+        // Set system prompt if provided
+        if (!config_.llm.system_prompt.empty()) {
+            if (!llamacpp_model_->set_system_prompt(config_.llm.system_prompt)) {
+                LEAFRA_WARNING() << "Failed to set system prompt: " << llamacpp_model_->get_last_error();
+            }
+        }
         
-        if (using_sentencepiece && total_tokens > 0) {
-            LEAFRA_INFO() << "  - Actual chars/token ratio: " << static_cast<double>(total_chunk_chars) / total_tokens;
+        // Attention reads the mapped weights at random; huge pages keep that off the TLB
+        if (config_.llm.use_mmap) {
+            const size_t advised = large_pages::advise_file(config_.llm.model_path);
+            if (advised > 0) {
+                LEAFRA_DEBUG() << "Large pages advised for " << (advised >> 20) << " MB of LLM weights";
+            }
         }
         
-        // Send summary event with key metrics
-        std::string token_type = using_sentencepiece ? "actual" : "estimated";
-        send_event("📊 Chunks: " + std::to_string(chunks.size()) + 
-                  ", Avg size: " + std::to_string(chunks.size() > 0 ? total_chunk_chars / chunks.size() : 0) + " chars, " +
-                  std::to_string(chunks.size() > 0 ? total_tokens / chunks.size() : 0) + " " + token_type + " tokens");
-    } //calculateAndLogChunkStatistics
- 
-#ifdef LEAFRA_HAS_SQLITE
+        llamacpp_initialized_ = true;
+        llm_unloaded_ = false;
+        touchLLM();
+        LEAFRA_INFO() << "✅ LlamaCpp model loaded successfully";
+        LEAFRA_INFO() << "  - Model info: " << llamacpp_model_->get_model_info();
+        return ResultCode::SUCCESS;
+    } //loadLLM
+    
     /**
-     * @brief Check if document exists and delete it if found
-     * @param filename Document filename
-     * @param absolute_path Absolute path to the document
-     * @return true if successful (document didn't exist or was successfully deleted), false on error
+     * @brief Release the model and its context (caller holds llm_mutex_ exclusively)
+     * 
+     * The RAG index and embedding model stay up; the conversation context is lost; the
+     * next call that needs the LLM reloads it from config_.llm.
      */
-    bool handleExistingDocument(const std::string& filename, const std::string& absolute_path) {
-        if (!database_ || !database_->isOpen()) {
-            return false;
+    void unloadLLM() {
+        if (!llamacpp_model_) {
+            return;
         }
-        
-        auto checkStmt = database_->prepare("SELECT id FROM docs WHERE filename = ? AND url = ?");
-        if (!checkStmt || !checkStmt->isValid()) {
-            LEAFRA_ERROR() << "Failed to prepare document existence check statement";
+        llamacpp_model_->unload();
+        llamacpp_model_.reset();
+        llamacpp_initialized_ = false;
+        llm_unloaded_ = true;
+#ifdef LEAFRA_HAS_FAISS
+        clearHotChunkStates();
+#endif
+    } //unloadLLM
+    
+    void touchLLM() {
+        llm_last_used_ = std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+    
+    /**
+     * @brief Record a finished generation's prompt-eval and decode times
+     */
+    void recordGenerationMetrics(const leafra::llamacpp::GenerationStats& stats) {
+        auto to_duration = [](double ms) {
+            return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(ms));
+        };
+        metrics_.record(PipelineStage::LLM_PROMPT_EVAL, to_duration(stats.prompt_eval_time), static_cast<uint64_t>(std::max(0, stats.prompt_tokens - stats.reused_prompt_tokens)));
+        metrics_.record(PipelineStage::LLM_DECODE, to_duration(stats.generation_time), static_cast<uint64_t>(std::max(0, stats.generated_tokens)));
+    } //recordGenerationMetrics
+    
+    /**
+     * @brief Hold the LLM for a call, waiting for a background load and reloading it if it was unloaded
+     * @param lock Receives the shared lock that keeps the model loaded until it is released
+     * @return true if the model is loaded
+     */
+    bool acquireLLM(std::shared_lock<std::shared_mutex>& lock) {
+        if (llm_ready_.valid()) {
+            llm_ready_.wait();
+        }
+        lock = std::shared_lock<std::shared_mutex>(llm_mutex_);
+        if (!llamacpp_initialized_ && llm_unloaded_) {
+            lock.unlock();
+            {
+                std::unique_lock<std::shared_mutex> exclusive(llm_mutex_);
+                if (!llamacpp_initialized_ && llm_unloaded_) {
+                    LEAFRA_INFO() << "🔄 Reloading unloaded LLM";
+                    loadLLM();
+                }
+            }
+            lock.lock();
+        }
+        touchLLM();
+        if (!llamacpp_initialized_ || !llamacpp_model_) {
             return false;
         }
         
-        checkStmt->bindText(1, filename);
-        checkStmt->bindText(2, absolute_path);
-        
-        if (checkStmt->step()) {
-            long long existing_doc_id = checkStmt->getCurrentRow().getInt64(0);
-            LEAFRA_INFO() << "Document already exists in database: " << filename << " (ID: " << existing_doc_id << ")";
-            
-#ifdef LEAFRA_HAS_FAISS
-            // TODO AD: index types other than flat does not support vector removal, simply return for now for duplicate documents
-            // for these other index types we need to reindex or insert document hashes and mark older doc & its chunks invalid in the chunk table
-            // need to think this a bit more later, for now we'll simply return if index type is not flat
-            // Check if index type is not flat (only flat index supports vector removal)
-            if (faiss_index_ && config_.vector_search.index_type != "FLAT") {
-                LEAFRA_INFO() << "Skipping document deletion - vector removal only supported for FLAT index type, current: " << config_.vector_search.index_type;
-                return true; // Allow document re-insertion without deletion
-            }
-            // First, collect FAISS IDs of chunks that will be deleted (for FAISS cleanup)
-            std::vector<int64_t> faiss_ids_to_remove;
-            if (faiss_index_) {
-                auto collectFaissIdsStmt = database_->prepare("SELECT chunk_faiss_id FROM chunks WHERE doc_id = ? AND chunk_faiss_id IS NOT NULL");
-                if (collectFaissIdsStmt && collectFaissIdsStmt->isValid()) {
-                    collectFaissIdsStmt->bindInt64(1, existing_doc_id);
-                    while (collectFaissIdsStmt->step()) {
-                        int64_t faiss_id = collectFaissIdsStmt->getCurrentRow().getInt64(0);
-                        faiss_ids_to_remove.push_back(faiss_id);
+        // Follow the governor's LLM thread limits (only changes between calls)
+        ThroughputLimits limits = governor_.limits();
+        if (limits.llm_threads != llm_applied_threads_ || limits.llm_batch_threads != llm_applied_batch_threads_) {
+            llamacpp_model_->set_threads(limits.llm_threads, limits.llm_batch_threads);
+            llm_applied_threads_ = limits.llm_threads;
+            llm_applied_batch_threads_ = limits.llm_batch_threads;
+            LEAFRA_DEBUG() << "LLM threads set to " << limits.llm_threads << " (batch: " << limits.llm_batch_threads << ")";
+        }
+        return true;
+    } //acquireLLM
+    
+    void startLLMIdleMonitor() {
+        stop_llm_idle_ = false;
+        llm_idle_thread_ = std::thread([this]() { runLLMIdleMonitor(); });
+    }
+    
+    void stopLLMIdleMonitor() {
+        {
+            std::lock_guard<std::mutex> lock(llm_idle_mutex_);
+            stop_llm_idle_ = true;
+        }
+        llm_idle_cv_.notify_all();
+        if (llm_idle_thread_.joinable()) {
+            llm_idle_thread_.join();
+        }
+    }
+    
+    // Unload the model once it has gone idle_unload_seconds without a call
+    void runLLMIdleMonitor() {
+        using clock = std::chrono::steady_clock;
+        const auto timeout = std::chrono::seconds(config_.llm.idle_unload_seconds);
+        std::unique_lock<std::mutex> lock(llm_idle_mutex_);
+        while (!stop_llm_idle_) {
+            auto deadline = clock::time_point(clock::duration(llm_last_used_.load())) + timeout;
+            if (clock::now() >= deadline) {
+                lock.unlock();
+                {
+                    std::unique_lock<std::shared_mutex> exclusive(llm_mutex_);
+                    // Re-check under the lock - a call may have used the model while we waited for it
+                    if (llamacpp_initialized_ &&
+                        clock::now() >= clock::time_point(clock::duration(llm_last_used_.load())) + timeout) {
+                        unloadLLM();
+                        LEAFRA_INFO() << "💤 LLM unloaded after " << config_.llm.idle_unload_seconds << "s idle";
                     }
-                    LEAFRA_INFO() << "Found " << faiss_ids_to_remove.size() << " FAISS vectors to remove for document: " << filename;
                 }
+                lock.lock();
+                deadline = clock::now() + timeout;
             }
+            llm_idle_cv_.wait_until(lock, deadline, [this]() { return stop_llm_idle_; });
+        }
+    } //runLLMIdleMonitor
 #endif
-            
-            // Delete existing chunks first (due to foreign key constraint)
-            auto deleteChunksStmt = database_->prepare("DELETE FROM chunks WHERE doc_id = ?");
-            if (!deleteChunksStmt || !deleteChunksStmt->isValid()) {
-                LEAFRA_ERROR() << "Failed to prepare chunk deletion statement";
-                return false;
-            }
-            
-            deleteChunksStmt->bindInt64(1, existing_doc_id);
-            if (deleteChunksStmt->execute()) {
-                int deleted_chunks = database_->getChanges();
-                LEAFRA_INFO() << "Deleted " << deleted_chunks << " existing chunks for document: " << filename;
-                
-#ifdef LEAFRA_HAS_FAISS
-                // Remove vectors from FAISS index
-                if (faiss_index_ && !faiss_ids_to_remove.empty()) {
-                    ResultCode result = faiss_index_->remove_vectors(faiss_ids_to_remove.data(), faiss_ids_to_remove.size());
-                    if (result == ResultCode::SUCCESS) {
-                        LEAFRA_INFO() << "Removed " << faiss_ids_to_remove.size() << " vectors from FAISS index for document: " << filename;
-                    } else {
-                        LEAFRA_ERROR() << "Failed to remove vectors from FAISS index for document: " << filename;
-                        // Don't return false here - database cleanup succeeded, FAISS cleanup failed but we can continue
-                    }
-                }
+    
+    void markDatabaseUsed() {
+        database_last_used_ = std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+    
+    void startVacuumScheduler() {
+        stop_vacuum_ = false;
+        vacuum_thread_ = std::thread([this]() { runVacuumScheduler(); });
+    }
+    
+    void stopVacuumScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(vacuum_mutex_);
+            stop_vacuum_ = true;
+        }
+        vacuum_cv_.notify_all();
+        if (vacuum_thread_.joinable()) {
+            vacuum_thread_.join();
+        }
+    }
+    
+    /**
+     * @brief Return one slice of free pages to the file system (caller holds ingestion_mutex_)
+     * @param pages Slice size
+     * @return Pages released (0 if there is nothing to release or the database isn't INCREMENTAL, -1 on error)
+     */
+    int64_t vacuumSlice(int64_t pages) {
+#ifdef LEAFRA_HAS_SQLITE
+        SQLiteDatabase::SpaceStats stats;
+        if (!database_ || !database_->isOpen() || !database_->getSpaceStats(stats)) {
+            return -1;
+        }
+        if (stats.auto_vacuum != 2 || stats.freelist_count == 0) {
+            return 0;
+        }
+        int64_t released = database_->incrementalVacuum(pages);
+        if (released > 0) {
+            vacuumed_pages_ += static_cast<uint64_t>(released);
+        }
+        return released;
+#else
+        (void)pages;
+        return -1;
 #endif
-            } else {
-                LEAFRA_ERROR() << "Failed to delete existing chunks for document: " << filename;
-                return false;
-            }
-            
-            // Delete the document record
-            auto deleteDocStmt = database_->prepare("DELETE FROM docs WHERE id = ?");
-            if (!deleteDocStmt || !deleteDocStmt->isValid()) {
-                LEAFRA_ERROR() << "Failed to prepare document deletion statement";
-                return false;
-            }
-            
-            deleteDocStmt->bindInt64(1, existing_doc_id);
-            if (deleteDocStmt->execute()) {
-                LEAFRA_INFO() << "Deleted existing document: " << filename << " (ID: " << existing_doc_id << ")";
-                send_event("🗑️ Replaced existing document: " + filename);
-            } else {
-                LEAFRA_ERROR() << "Failed to delete existing document: " << filename;
-                return false;
+    }
+    
+    // Vacuum in slices once the database has gone vacuum_idle_ms without ingestion or searches
+    void runVacuumScheduler() {
+#ifdef LEAFRA_HAS_SQLITE
+        using clock = std::chrono::steady_clock;
+        const auto idle = std::chrono::milliseconds(config_.database.vacuum_idle_ms);
+        const auto slice_pause = std::chrono::milliseconds(50);
+        const int64_t slice = config_.database.vacuum_pages_per_slice;
+        std::unique_lock<std::mutex> lock(vacuum_mutex_);
+        while (!stop_vacuum_) {
+            auto deadline = clock::time_point(clock::duration(database_last_used_.load())) + idle;
+            if (clock::now() >= deadline) {
+                lock.unlock();
+                bool more = false;
+                {
+                    // Ingestion owns the connection's transactions - skip the slice while a run is going
+                    std::unique_lock<std::mutex> ingestion_lock(ingestion_mutex_, std::try_to_lock);
+                    SQLiteDatabase::SpaceStats stats;
+                    if (ingestion_lock.owns_lock() && database_ && database_->isOpen() && database_->getSpaceStats(stats) &&
+                        stats.page_count > 0 && stats.auto_vacuum == 2 &&
+                        static_cast<double>(stats.freelist_count) / stats.page_count >= config_.database.vacuum_min_free_ratio &&
+                        stats.freelist_count > 0) {
+                        int64_t released = vacuumSlice(slice);
+                        more = released > 0 && released < stats.freelist_count;
+                        LEAFRA_DEBUG() << "Incremental vacuum released " << released << " of " << stats.freelist_count << " free pages";
+                    }
+                }
+                lock.lock();
+                // Keep slicing while the database stays idle, then go back to waiting for the next quiet period
+                deadline = clock::now() + (more ? slice_pause : idle);
             }
+            vacuum_cv_.wait_until(lock, deadline, [this]() { return stop_vacuum_; });
         }
-        
-        return true; // Success: either document didn't exist or was successfully deleted
-    } //handleExistingDocument
-#endif // LEAFRA_HAS_SQLITE
+#endif
+    } //runVacuumScheduler
+    
+    /**
+     * @brief A readiness future that has already resolved
+     */
+    static std::shared_future<bool> readyFuture(bool ready) {
+        std::promise<bool> promise;
+        promise.set_value(ready);
+        return promise.get_future().share();
+    }
+    
+    /**
+     * @brief Block until background engine loads have finished
+     */
+    void waitForEngines() const {
+        if (embedding_ready_.valid()) {
+            embedding_ready_.wait();
+        }
+        if (llm_ready_.valid()) {
+            llm_ready_.wait();
+        }
+    }
 
-#ifdef LEAFRA_HAS_FAISS
     /**
-     * @brief Insert chunk embeddings into FAISS index
-     * @param chunks Vector of text chunks with embeddings
-     * @param doc_id Document ID for generating unique FAISS IDs
+     * @brief Run the chunk embedding stage through the configured embedding backend
+     * @param chunks Vector of text chunks to process
+     * @param batch The chunks' columnar batch (token IDs in, embeddings out)
+     * @param file_path Original file path for logging context
+     * @return Number of successful embeddings generated
      */
-    bool insertChunkEmbeddingsIntoFaiss(const std::vector<TextChunk>& chunks, int64_t doc_id) {
-        if (!faiss_index_ || !config_.vector_search.enabled) {
-            return true; // Not an error if FAISS is disabled
+    size_t processChunksWithEmbeddings(const std::vector<TextChunk>& chunks, ChunkBatch& batch, const std::string& file_path) {
+        if (!hasEmbeddingModel()) {
+            if (config_.embedding_inference.enabled) {
+                LEAFRA_WARNING() << "Embedding inference requested but no embedding model is initialized";
+            }
+            return 0;
         }
         
-        // Reserve space to avoid reallocations
-        std::vector<float> embeddings_to_add;
-        std::vector<int64_t> chunk_ids;
+        LEAFRA_DEBUG_TIMER("embedding_inference");
+        auto start_time = debug::timer::now();
+        const std::string backend_name = embedding_scheduler_->backend().getName();
         
-        // Count embeddings and validate - chunks should have embeddings at this point
-        size_t embedding_count = 0;
-        size_t chunks_without_embeddings = 0;
-        size_t embedding_dim = 0;
+        LEAFRA_INFO() << "Starting " << backend_name << " embedding inference for " << chunks.size() << " chunks"
+                      << " (batch size: " << embedding_scheduler_->get_effective_batch_size() << ")";
+        send_event(EventType::INGESTION_PROGRESS, "🧠 Starting embedding inference for " + std::to_string(chunks.size()) + " chunks");
         
-        for (size_t i = 0; i < chunks.size(); ++i) {
-            const auto& chunk = chunks[i];
-            if (chunk.has_embedding() && !chunk.embedding.empty()) {
-                embedding_count++;
-                if (embedding_dim == 0) {
-                    embedding_dim = chunk.embedding.size();
-                } else if (chunk.embedding.size() != embedding_dim) {
-                    LEAFRA_ERROR() << "Inconsistent embedding dimension: expected " << embedding_dim << ", got " << chunk.embedding.size();
-                    return false; // Return error for inconsistent embeddings
-                }
-            } else {
-                // Chunks are expected to have embeddings at this point
-                chunks_without_embeddings++;
-                LEAFRA_WARNING() << "Chunk " << i << " missing embedding - skipping FAISS insertion";
-            }
-        }
+        size_t successful_embeddings = embedding_scheduler_->embed_chunk_batch(chunks, batch);
         
-        // Log warning if some chunks don't have embeddings
-        if (chunks_without_embeddings > 0) {
-            LEAFRA_WARNING() << "Skipped " << chunks_without_embeddings << " chunks without embeddings out of " << chunks.size() << " total chunks";
-        }
+        LEAFRA_INFO() << "✅ Embedding inference completed for file: " << file_path;
+        LEAFRA_INFO() << "  - Total chunks processed: " << chunks.size();
+        LEAFRA_INFO() << "  - Successful embeddings: " << successful_embeddings;
+        LEAFRA_INFO() << "  - Failed embeddings: " << (chunks.size() - successful_embeddings);
         
-        if (embedding_count == 0) {
-            return true; // No embeddings to add, not an error
+        // Log performance metrics
+        double total_duration_ms = debug::timer::elapsed_milliseconds(start_time, debug::timer::now());
+        LEAFRA_DEBUG_LOG("PERFORMANCE", backend_name + " embedding inference completed in " + std::to_string(total_duration_ms) + "ms");
+        if (successful_embeddings > 0) {
+            double avg_ms_per_chunk = total_duration_ms / successful_embeddings;
+            LEAFRA_DEBUG_LOG("PERFORMANCE", "Average inference time per chunk: " + std::to_string(avg_ms_per_chunk) + "ms");
+            debug::debug_log_performance(backend_name + "_embedding", chunks.size(), successful_embeddings, total_duration_ms);
         }
         
-        // Reserve space for efficiency
-        embeddings_to_add.reserve(embedding_count * embedding_dim);
-        chunk_ids.reserve(embedding_count);
-        
-        // Collect embeddings and IDs
-        for (size_t i = 0; i < chunks.size(); ++i) {
-            const auto& chunk = chunks[i];
-            if (chunk.has_embedding() && !chunk.embedding.empty()) {
-                // Add embedding data (avoid copy by using insert with iterators)
-                embeddings_to_add.insert(embeddings_to_add.end(), 
-                                        chunk.embedding.begin(), 
-                                        chunk.embedding.end());
-                // Use a composite ID: doc_id * 1000000 + chunk_index for uniqueness
-                chunk_ids.push_back(doc_id * 1000000 + static_cast<int64_t>(i));
+        // Debug print the embedding vectors
+        if (config_.debug_mode && LEAFRA_LOG_ENABLED(LogLevel::LEAFRA_DEBUG)) {
+            for (size_t chunk_idx = 0; chunk_idx < chunks.size(); ++chunk_idx) {
+                if (!batch.has_embedding(chunk_idx)) {
+                    continue;
+                }
+                const float* embedding = batch.embedding(chunk_idx);
+                std::ostringstream embedding_stream;
+                embedding_stream << std::fixed << std::setprecision(6);
+                embedding_stream << "Chunk " << chunk_idx << " embedding vector (" << batch.dimension << " dimensions): [";
+                for (size_t i = 0; i < batch.dimension; ++i) {
+                    embedding_stream << embedding[i];
+                    if (i < batch.dimension - 1) embedding_stream << ", ";
+                }
+                embedding_stream << "]";
+                LEAFRA_DEBUG() << embedding_stream.str();
             }
         }
         
-        // Add vectors to FAISS index
-        auto faiss_result = faiss_index_->add_vectors_with_ids(
-            embeddings_to_add.data(), 
-            chunk_ids.data(), 
-            static_cast<int>(embedding_count)
-        );
+        return successful_embeddings;
+    } //processChunksWithEmbeddings
+
+    /**
+     * @brief Prefix prepended to search queries before embedding
+     * @return "query: " for multilingual-e5-small per https://huggingface.co/intfloat/multilingual-e5-small, empty otherwise
+     */
+    std::string queryPrefix() const {
+        return config_.tokenizer.model_name == "multilingual-e5-small" ? "query: " : "";
+    }
+    
+    /**
+     * @brief Prefix prepended to document text before embedding ("passage: " for multilingual-e5-small)
+     */
+    std::string passagePrefix() const {
+        return passagePrefix(config_.tokenizer);
+    }
+    
+    static std::string passagePrefix(const TokenizerConfig& tokenizer) {
+        return tokenizer.model_name == "multilingual-e5-small" ? "passage: " : "";
+    }
+
+#ifdef LEAFRA_HAS_FAISS
+    /**
+     * @brief Resolve per-query FAISS settings, filling unset fields from the vector search config
+     * @param overrides Caller supplied settings (0 = use the configured value)
+     * @return Settings to pass to FaissIndex::search
+     */
+    FaissIndex::SearchParams searchParams(const FaissIndex::SearchParams& overrides) const {
+        FaissIndex::SearchParams params = overrides;
+        if (params.nprobe <= 0) {
+            params.nprobe = config_.vector_search.nprobe;
+        }
+        if (params.ef_search <= 0) {
+            params.ef_search = config_.vector_search.ef_search;
+        }
+        return params;
+    }
+#endif
+
+    /**
+     * @brief Build the query cache key: model identity, prefix and whitespace-normalized query text
+     * @param query Raw query text
+     * @param prefix Query prefix (see queryPrefix)
+     * @return Cache key
+     */
+    std::string makeQueryCacheKey(const std::string& query, const std::string& prefix) const {
+        const auto& embedding_config = config_.embedding_inference;
+        std::string key;
+        key.reserve(embedding_config.framework.size() + embedding_config.model_path.size() + prefix.size() + query.size() + 3);
+        key += embedding_config.framework;
+        key += '\n';
+        key += embedding_config.model_path;
+        key += '\n';
+        key += prefix;
+        key += '\n';
         
-        if (faiss_result == ResultCode::SUCCESS) {
-            LEAFRA_INFO() << "✅ Added " << embedding_count << " embeddings to FAISS index (" << embedding_count << "/" << chunks.size() << " chunks)";
-            send_event("🔍 Added " + std::to_string(embedding_count) + "/" + std::to_string(chunks.size()) + " embeddings to search index");
-            
-            // Save updated FAISS index to database
-            if (database_ && database_->isOpen()) {
-                auto save_result = faiss_index_->save_to_db(*database_, "PrimaryDocEmbeddings");
-                if (save_result == ResultCode::SUCCESS) {
-                    LEAFRA_DEBUG() << "FAISS index saved to database";
-                } else {
-                    LEAFRA_WARNING() << "Failed to save FAISS index to database";
-                }
+        // Trim and collapse whitespace runs so "foo  bar " and "foo bar" share an entry
+        bool pending_space = false;
+        for (char c : query) {
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                pending_space = true;
+                continue;
             }
-            return true;
-        } else {
-            LEAFRA_ERROR() << "Failed to add embeddings to FAISS index";
-            send_event("❌ Failed to add embeddings to search index");
-            return false;
+            if (pending_space && key.back() != '\n') {
+                key += ' ';
+            }
+            pending_space = false;
+            key += c;
         }
-    } //insertChunkEmbeddingsIntoFaiss
-#endif // LEAFRA_HAS_FAISS
- 
-}; // LeafraCore::Impl
+        return key;
+    } //makeQueryCacheKey
 
-LeafraCore::LeafraCore() : pImpl(std::make_unique<Impl>()) {
-}
-
-LeafraCore::~LeafraCore() = default;
-
-ResultCode LeafraCore::initialize(const Config& config) {
-    if (pImpl->initialized_) {
-        return ResultCode::SUCCESS; // Already initialized
+    /**
+     * @brief Key of a chunk in the embedding cache: model identity, normalization, prefix and chunk text
+     * @param prefix Passage prefix the chunk is embedded with
+     * @param text Chunk text
+     * @param allocator Arena of the document the key belongs to
+     * @return Digest of the inputs followed by the text length
+     */
+    ArenaString makeEmbeddingCacheKey(const std::string& prefix, std::string_view text, const ArenaAllocator<char>& allocator) const {
+        const auto& embedding_config = config_.embedding_inference;
+        ContentHasher hasher;
+        hasher.update(embedding_config.framework);
+        hasher.update("\n");
+        hasher.update(embedding_config.model_path);
+        hasher.update(embedding_config.normalize_embeddings ? "\n1\n" : "\n0\n");
+        if (embedding_config.pooling != "mean") {
+            // Mean-pooled keys keep their original form so existing cache rows stay valid
+            hasher.update(embedding_config.pooling);
+            hasher.update("\n");
+        }
+        hasher.update(prefix);
+        hasher.update("\n");
+        hasher.update(text);
+        char digest[ContentHasher::kHexDigestSize];
+        hasher.hex_digest(digest);
+        const std::string size = std::to_string(text.size());
+        ArenaString key(allocator);
+        key.reserve(sizeof(digest) + 1 + size.size());
+        key.append(digest, sizeof(digest)).append(1, ':').append(size);
+        return key;
     }
     
-    try {
-        pImpl->config_ = config;
-        
-        // Initialize logging system
-        Logger& logger = Logger::getInstance();
-        if (config.debug_mode) {
-            logger.setLogLevel(LogLevel::LEAFRA_DEBUG);
-            LEAFRA_WARNING() << "LeafraCore: Debug logging enabled - LogLevel set to DEBUG";
-            fprintf(stderr, "[LeafraSDK] Debug mode enabled\n");
-        } else {
-            logger.setLogLevel(LogLevel::LEAFRA_INFO);
-            LEAFRA_WARNING() << "LeafraCore: Debug logging disabled - LogLevel set to INFO";
-            fprintf(stderr, "[LeafraSDK] Debug mode disabled\n");
+#ifdef LEAFRA_HAS_LLAMACPP
+    /**
+     * @brief Name of the loaded LLM's tokenizer for chunk_llm_tokens rows (model file name and vocabulary size)
+     */
+    std::string llmVocabKey() const {
+        return config_.llm.get_model_filename() + ":" + std::to_string(llamacpp_model_->get_vocab_size());
+    }
+#endif
+    
+    /**
+     * @brief Manifest describing how this SDK builds its corpus (bundles are only imported where it matches)
+     * 
+     * The model is identified by framework and file name: the same model sits at a different path on every device.
+     */
+    BundleManifest currentBundleManifest() const {
+        BundleManifest manifest;
+        manifest.sdk_version = LeafraCore::get_version();
+        manifest.created_at = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        manifest.embedding_model = config_.embedding_inference.framework + ":" +
+                                   std::filesystem::path(config_.embedding_inference.model_path).filename().string();
+        manifest.dimension = config_.vector_search.dimension;
+        manifest.index_type = config_.vector_search.index_type;
+        manifest.metric = config_.vector_search.metric;
+        manifest.index_dimension = config_.vector_search.index_dimension;
+        manifest.chunk_size = static_cast<int64_t>(config_.chunking.chunk_size);
+        manifest.chunk_overlap = config_.chunking.overlap_percentage;
+        switch (config_.chunking.size_unit) {
+            case ChunkSizeUnit::CHARACTERS:   manifest.chunk_unit = "characters"; break;
+            case ChunkSizeUnit::TOKENS:       manifest.chunk_unit = "tokens"; break;
+            case ChunkSizeUnit::EXACT_TOKENS: manifest.chunk_unit = "exact_tokens"; break;
         }
-        
-        LEAFRA_INFO() << "Initializing LeafraSDK v" << get_version();
-        LEAFRA_DEBUG() << "Config - Name: " << config.name << ", Threads: " << config.max_threads << ", Buffer: " << config.buffer_size;
-        
-        // Initialize data processor
-        if (pImpl->data_processor_) {
-            ResultCode result = pImpl->data_processor_->initialize();
-            if (result != ResultCode::SUCCESS) {
-                LEAFRA_ERROR() << "Failed to initialize data processor";
-                return result;
+        return manifest;
+    }
+    
+    /**
+     * @brief Read and verify a bundle's or backup's manifest, and check it fits this SDK's embeddings
+     * @param kind "Bundle", "Backup" or "Delta", for log messages
+     * @param delta Whether a delta (export_delta) is expected rather than a whole corpus
+     * @return ERROR_NOT_FOUND for a missing file, ERROR_INVALID_PARAMETER for a corrupt or incompatible one
+     */
+    ResultCode checkSnapshot(const std::string& path, const char* kind, BundleManifest& manifest, bool delta = false) const {
+#ifdef LEAFRA_HAS_SQLITE
+        {
+            SQLiteDatabase snapshot;
+            DatabaseConfig snapshot_config;
+            snapshot_config.journal_mode.clear();
+            snapshot.setConfig(snapshot_config);
+            if (!SQLiteDatabase::fileExists(path) || !snapshot.openFile(path)) {
+                LEAFRA_ERROR() << kind << " not found: " << path;
+                return ResultCode::ERROR_NOT_FOUND;
+            }
+            if (!RagBundle::read_manifest(snapshot, manifest) || !RagBundle::verify(snapshot, manifest)) {
+                return ResultCode::ERROR_INVALID_PARAMETER;
             }
-            LEAFRA_DEBUG() << "Data processor initialized successfully";
         }
-        
-        // Initialize file parser
-        if (pImpl->file_parser_) {
-            bool result = pImpl->file_parser_->initialize();
-            if (!result) {
-                LEAFRA_ERROR() << "Failed to initialize file parser";
-                return ResultCode::ERROR_INITIALIZATION_FAILED;
+        const BundleManifest current = currentBundleManifest();
+        if (manifest.delta != delta) {
+            LEAFRA_ERROR() << path << (manifest.delta ? " is a delta - apply it with import_delta" : " holds a whole corpus, not a delta");
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+        const int32_t format_version = delta ? RagBundle::kDeltaFormatVersion : RagBundle::kFormatVersion;
+        if (manifest.format_version > format_version) {
+            LEAFRA_ERROR() << kind << " format " << manifest.format_version << " is newer than this SDK's (" << format_version << ")";
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+        if (manifest.dimension != current.dimension || manifest.embedding_model != current.embedding_model) {
+            LEAFRA_ERROR() << kind << " embeddings (" << manifest.embedding_model << ", " << manifest.dimension
+                           << " dimensions) don't match this SDK's (" << current.embedding_model << ", " << current.dimension << ")";
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+        if (manifest.chunk_size != current.chunk_size || manifest.chunk_unit != current.chunk_unit ||
+            std::abs(manifest.chunk_overlap - current.chunk_overlap) > 1e-9) {
+            LEAFRA_WARNING() << "⚠️ " << kind << " was chunked with " << manifest.chunk_size << " " << manifest.chunk_unit
+                             << " - documents ingested from now on are chunked with " << current.chunk_size << " " << current.chunk_unit;
+        }
+        return ResultCode::SUCCESS;
+#else
+        (void)path;
+        (void)kind;
+        (void)manifest;
+        (void)delta;
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+    } //checkSnapshot
+    
+    /**
+     * @brief Replace the database with a checked bundle or backup and reload everything derived from it
+     * @param manifest The snapshot's manifest (see checkSnapshot)
+     * @param index_directory Index files of a "file" storage backup ("" = indexes are blobs in the database)
+     */
+    ResultCode replaceDatabase(const std::string& path, const BundleManifest& manifest, const std::string& index_directory) {
+#ifdef LEAFRA_HAS_SQLITE
+        // One backup pass replaces the whole database; searches on this connection wait for it
+        std::lock_guard<std::mutex> ingestion_lock(ingestion_mutex_);
+#ifdef LEAFRA_HAS_FAISS
+        const bool file_storage = config_.vector_search.index_storage == "file";
+        if (!index_directory.empty() && !file_storage) {
+            LEAFRA_ERROR() << "Backup keeps its FAISS indexes as files - restore it with vector_search.index_storage = \"file\"";
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+        std::vector<std::string> previous_collections;
+        {
+            std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+            for (const auto& entry : faiss_collections_) {
+                previous_collections.push_back(entry.first);
             }
-            LEAFRA_DEBUG() << "File parser initialized successfully";
+        }
+#else
+        (void)manifest;
+        (void)index_directory;
+#endif
+        if (!database_->restoreFrom(path)) {
+            return ResultCode::ERROR_PROCESSING_FAILED;
         }
         
-        // Initialize chunker
-        if (pImpl->chunker_) {
-            ResultCode result = pImpl->chunker_->initialize();
-            if (result != ResultCode::SUCCESS) {
-                LEAFRA_ERROR() << "Failed to initialize chunker";
-                return result;
-            }
-            LEAFRA_DEBUG() << "Chunker initialized successfully";
-            
-            // Configure chunker with config settings
-            ChunkingOptions chunking_options(
-                config.chunking.chunk_size,
-                config.chunking.overlap_percentage,
-                config.chunking.size_unit,
-                config.chunking.token_method
-            );
-            chunking_options.preserve_word_boundaries = config.chunking.preserve_word_boundaries;
-            chunking_options.include_metadata = config.chunking.include_metadata;
-            
-            pImpl->chunker_->set_default_options(chunking_options);
-            
-            // Log chunking configuration
-            LEAFRA_INFO() << "Chunking configuration:";
-            LEAFRA_INFO() << "  - Enabled: " << (config.chunking.enabled ? "Yes" : "No");
-            LEAFRA_INFO() << "  - Chunk size: " << config.chunking.chunk_size 
-                          << (config.chunking.size_unit == ChunkSizeUnit::TOKENS ? " tokens" : " characters");
-            LEAFRA_INFO() << "  - Overlap: " << (config.chunking.overlap_percentage * 100.0) << "%";
-            LEAFRA_INFO() << "  - Token method: Simple";
+        // Snapshots from older SDKs may lack newer tables
+        if (!database_->createDocTextTable() || !database_->createDocCentroidsTable() || !database_->createChunkLLMTokensTable()) {
+            LEAFRA_ERROR() << "❌ Failed to upgrade the restored database schema";
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        keyword_index_available_ = database_->createChunkKeywordIndex();
+        if (!database_->createChunkEmbeddingsTable() || !database_->createChunkIdSequence()) {
+            LEAFRA_ERROR() << "❌ Failed to upgrade the restored database schema";
+            return ResultCode::ERROR_PROCESSING_FAILED;
         }
+        if (embedding_cache_available_) {
+            embedding_cache_available_ = database_->createEmbeddingCacheTable();
+        }
+        index_models_available_ = database_->createIndexModelsTable();
+        sync_log_available_ = database_->createSyncLogTable();
+        near_duplicate_index_.reset();
         
-        // Initialize SentencePiece tokenizer if enabled
-        if (pImpl->tokenizer_ && config.tokenizer.enabled) {
-            LEAFRA_INFO() << "Initializing SentencePiece tokenizer";
-            
-            if (!config.tokenizer.model_path.empty()) {
-                bool loaded = pImpl->tokenizer_->load_model(config.tokenizer);
-                if (loaded) {
-                    LEAFRA_INFO() << "✅ SentencePiece model loaded from: " << config.tokenizer.model_path;
-                    LEAFRA_INFO() << "  - Vocabulary size: " << pImpl->tokenizer_->get_vocab_size();
-                } else {
-                    LEAFRA_WARNING() << "⚠️  Failed to load SentencePiece model from: " << config.tokenizer.model_path;                    
+#ifdef LEAFRA_HAS_FAISS
+        if (config_.vector_search.enabled) {
+            // Index files written for the replaced database point into a delta log that no longer exists
+            if (file_storage) {
+                std::lock_guard<std::recursive_mutex> files_lock(faiss_files_mutex_);
+                std::vector<std::string> names = storedCollectionNames();
+                std::vector<std::string> stale = names;
+                stale.insert(stale.end(), previous_collections.begin(), previous_collections.end());
+                for (const std::string& name : stale) {
+                    FaissIndex::remove_index_files(faissIndexFileBase(name));
                 }
-            } else {
-                LEAFRA_WARNING() << "⚠️  SentencePiece enabled but no model path specified";
-            }
-        } else if (config.tokenizer.enabled) {
-            LEAFRA_WARNING() << "⚠️  SentencePiece requested but tokenizer not available";
-        }
-
-#ifdef LEAFRA_HAS_COREML
-        // Initialize CoreML embedding model if enabled
-        if (config.embedding_inference.is_valid() && config.embedding_inference.framework == "coreml") {
-            LEAFRA_INFO() << "Initializing CoreML embedding model";
-            LEAFRA_INFO() << "  - Framework: " << config.embedding_inference.framework;
-            LEAFRA_INFO() << "  - Model path: " << config.embedding_inference.model_path;
-            LEAFRA_INFO() << "  - Compute units: " << config.embedding_inference.coreml_compute_units;
-            
-            // Load the CoreML model using the C++ class
-            try {
-                // Convert compute units string to enum
-                leafra::CoreMLModel::ComputeUnits compute_units = leafra::CoreMLModel::ComputeUnits::All;
-                if (config.embedding_inference.coreml_compute_units == "cpu") {
-                    compute_units = leafra::CoreMLModel::ComputeUnits::CPUOnly;
-                } else if (config.embedding_inference.coreml_compute_units == "cpu_and_gpu") {
-                    compute_units = leafra::CoreMLModel::ComputeUnits::CPUAndGPU;
-                } else if (config.embedding_inference.coreml_compute_units == "cpu_and_neural_engine") {
-                    compute_units = leafra::CoreMLModel::ComputeUnits::CPUAndNeuralEngine;
+                for (const std::string& name : index_directory.empty() ? std::vector<std::string>() : names) {
+                    const std::string base = faissIndexFileBase(name);
+                    const std::string backup_base = (std::filesystem::path(index_directory) / std::filesystem::path(base).filename()).string();
+                    int64_t watermark = -1;
+                    if (FaissIndex::copy_index_files(backup_base, std::filesystem::path(base).parent_path().string(), watermark) != ResultCode::SUCCESS) {
+                        return ResultCode::ERROR_PROCESSING_FAILED;
+                    }
+                    // The generation marker: an index file folding in deltas the backup never saw can't be replayed consistently
+                    if (watermark > manifest.faiss_delta_id) {
+                        LEAFRA_ERROR() << "❌ Index file of collection '" << name << "' is newer than the backup (delta "
+                                       << watermark << " > " << manifest.faiss_delta_id << ")";
+                        FaissIndex::remove_index_files(base);
+                        return ResultCode::ERROR_INVALID_PARAMETER;
+                    }
                 }
-                
-                pImpl->coreml_model_ = std::make_unique<leafra::CoreMLModel>(
-                    config.embedding_inference.model_path,
-                    compute_units
-                );
-                
-                if (pImpl->coreml_model_->isValid()) {
-                    // Get model description
-                    std::string description = pImpl->coreml_model_->getDescription();
-                    if (!description.empty()) {
-                        LEAFRA_INFO() << "  - Model description: " << description;
+            }
+            if (loadFaissCollections() != ResultCode::SUCCESS) {
+                LEAFRA_ERROR() << "❌ Failed to load the restored FAISS index";
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            if (file_storage && index_directory.empty()) {
+                std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+                for (auto& entry : faiss_collections_) {
+                    if (saveFaissCollection(entry.second) != ResultCode::SUCCESS) {
+                        LEAFRA_WARNING() << "Failed to write index file for collection '" << entry.first << "' - it loads from the database";
                     }
-                    
-                    LEAFRA_INFO() << "  - Input count: " << pImpl->coreml_model_->getInputCount();
-                    LEAFRA_INFO() << "  - Output count: " << pImpl->coreml_model_->getOutputCount();
-                    
-                    pImpl->coreml_initialized_ = true;
-                    LEAFRA_INFO() << "✅ CoreML model initialized successfully";
-                } else {
-                    LEAFRA_ERROR() << "❌ CoreML model is not valid";
-                    return ResultCode::ERROR_INITIALIZATION_FAILED;
                 }
-            } catch (const std::exception& e) {
-                LEAFRA_ERROR() << "❌ Failed to initialize CoreML model: " << e.what();
-                return ResultCode::ERROR_INITIALIZATION_FAILED;
             }
-        } else if (config.embedding_inference.enabled && config.embedding_inference.framework == "coreml") {
-            LEAFRA_WARNING() << "⚠️  CoreML embedding model enabled but configuration is invalid";
-            LEAFRA_WARNING() << "    Framework: '" << config.embedding_inference.framework << "'";
-            LEAFRA_WARNING() << "    Model path: '" << config.embedding_inference.model_path << "'";
         }
-#else
-        if (config.embedding_inference.enabled && config.embedding_inference.framework == "coreml") {
-            LEAFRA_WARNING() << "⚠️  CoreML embedding model requested but not available (framework not linked)";
+        {
+            std::lock_guard<std::mutex> lock(query_mutex_);
+            search_result_cache_.clear();
+#ifdef LEAFRA_HAS_LLAMACPP
+            answer_cache_.clear();
+#endif
         }
 #endif
-
-#ifdef LEAFRA_HAS_TENSORFLOWLITE
-        // Initialize TensorFlow Lite embedding model if enabled
-        if (config.embedding_inference.is_valid()) {
-            LEAFRA_INFO() << "Initializing TensorFlow Lite embedding model";
-            LEAFRA_INFO() << "  - Framework: " << config.embedding_inference.framework;
-            LEAFRA_INFO() << "  - Model path: " << config.embedding_inference.model_path;
-            
-            // Check if model file exists
-            std::ifstream model_file(config.embedding_inference.model_path, std::ios::binary);
-            if (!model_file.good()) {
-                LEAFRA_ERROR() << "❌ TensorFlow Lite model file not found: " << config.embedding_inference.model_path;
-                return ResultCode::ERROR_INITIALIZATION_FAILED;
+        return ResultCode::SUCCESS;
+#else
+        (void)path;
+        (void)manifest;
+        (void)index_directory;
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+    } //replaceDatabase
+    
+#ifdef LEAFRA_HAS_SQLITE
+    /**
+     * @brief Apply a checked delta (see import_delta); the caller holds ingestion_mutex_
+     * @param added Output: documents added
+     * @param removed Output: documents removed (including earlier copies of the added ones)
+     */
+    ResultCode applyDelta(const std::string& path, size_t& added, size_t& removed) {
+        auto attach = database_->prepare("ATTACH DATABASE ? AS sync_delta");
+        if (!attach || !attach->isValid() || !attach->bindText(1, path) || !attach->execute()) {
+            LEAFRA_ERROR() << "Failed to attach delta " << path << ": " << database_->getLastErrorMessage();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        attach.reset();
+        ResultCode result = applyAttachedDelta(added, removed);
+        if (!database_->execute("DETACH DATABASE sync_delta")) {
+            LEAFRA_WARNING() << "Failed to detach delta " << path << ": " << database_->getLastErrorMessage();
+        }
+        return result;
+    } //applyDelta
+    
+    /**
+     * @brief applyDelta with the delta attached as sync_delta
+     * 
+     * Removals go first, in their own transaction. The added documents then take ids after
+     * this database's largest and their chunks a block of the chunk_faiss_id sequence, mapped
+     * through temp tables, so every table is copied with one INSERT ... SELECT (doc_texts
+     * before chunks: the keyword index triggers read it). The stored embeddings are decoded
+     * in batches and added to each collection's index like ingested ones, before the commit.
+     */
+    ResultCode applyAttachedDelta(size_t& added, size_t& removed) {
+        added = 0;
+        removed = 0;
+        
+        std::vector<int64_t> stale_ids;
+        bool listed = database_->execute(
+            "SELECT d.id FROM docs d JOIN (SELECT url, collection FROM sync_delta.sync_removals "
+            "UNION SELECT url, collection FROM sync_delta.docs) r ON r.url = d.url AND r.collection = d.collection",
+            [&stale_ids](const SQLiteDatabase::Row& row) {
+                stale_ids.push_back(row.getInt64(0));
+                return true;
+            });
+        if (!listed) {
+            LEAFRA_ERROR() << "Failed to read the delta's removals: " << database_->getLastErrorMessage();
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+        ResultCode removal = removeStoredDocuments(stale_ids, &removed);
+        if (removal != ResultCode::SUCCESS) {
+            return removal;
+        }
+        
+        try {
+            SQLiteTransaction transaction(*database_);
+            if (!database_->execute("CREATE TEMP TABLE IF NOT EXISTS delta_doc_ids (old_id INTEGER PRIMARY KEY, new_id INTEGER NOT NULL)") ||
+                !database_->execute("CREATE TEMP TABLE IF NOT EXISTS delta_faiss_ids (old_id INTEGER PRIMARY KEY, new_id INTEGER NOT NULL)") ||
+                !database_->execute("DELETE FROM delta_doc_ids") || !database_->execute("DELETE FROM delta_faiss_ids")) {
+                LEAFRA_ERROR() << "Failed to prepare the delta id tables";
+                return ResultCode::ERROR_PROCESSING_FAILED;
             }
-            model_file.close();
-            
-            // Load the model
-            pImpl->tf_model_ = TfLiteModelCreateFromFile(config.embedding_inference.model_path.c_str());
-            if (!pImpl->tf_model_) {
-                LEAFRA_ERROR() << "❌ Failed to load TensorFlow Lite model from: " << config.embedding_inference.model_path;
-                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            // AUTOINCREMENT never hands out an id below sqlite_sequence, so the new ones start past it
+            if (!database_->execute(
+                    "INSERT INTO delta_doc_ids (old_id, new_id) SELECT id, "
+                    "MAX(COALESCE((SELECT seq FROM sqlite_sequence WHERE name = 'docs'), 0), COALESCE((SELECT MAX(id) FROM main.docs), 0)) "
+                    "+ ROW_NUMBER() OVER (ORDER BY id) FROM sync_delta.docs")) {
+                LEAFRA_ERROR() << "Failed to number the delta's documents: " << database_->getLastErrorMessage();
+                return ResultCode::ERROR_PROCESSING_FAILED;
             }
-            
-            // Create interpreter options
-            pImpl->tf_options_ = TfLiteInterpreterOptionsCreate();
-            
-            // Set number of threads
-            if (config.embedding_inference.tflite_num_threads > 0) {
-                TfLiteInterpreterOptionsSetNumThreads(pImpl->tf_options_, config.embedding_inference.tflite_num_threads);
-                LEAFRA_DEBUG() << "  - Threads: " << config.embedding_inference.tflite_num_threads;
-            } else {
-                // Use SDK-level thread configuration or default
-                int threads = config.max_threads > 0 ? config.max_threads : 4;
-                TfLiteInterpreterOptionsSetNumThreads(pImpl->tf_options_, threads);
-                LEAFRA_DEBUG() << "  - Threads: " << threads << " (auto)";
+            int64_t chunk_ids = 0;
+            database_->execute("SELECT COUNT(*) FROM sync_delta.chunks WHERE chunk_faiss_id IS NOT NULL", [&chunk_ids](const SQLiteDatabase::Row& row) {
+                chunk_ids = row.getInt64(0);
+                return false;
+            });
+            int64_t first_id = 0;
+            if (chunk_ids > 0) {
+                auto number_stmt = database_->prepare(
+                    "INSERT INTO delta_faiss_ids (old_id, new_id) SELECT chunk_faiss_id, ? + ROW_NUMBER() OVER (ORDER BY chunk_faiss_id) - 1 "
+                    "FROM sync_delta.chunks WHERE chunk_faiss_id IS NOT NULL");
+                if (!database_->allocateIds("chunk_faiss_id", chunk_ids, first_id) || !number_stmt || !number_stmt->isValid() ||
+                    !number_stmt->bindInt64(1, first_id) || !number_stmt->execute()) {
+                    LEAFRA_ERROR() << "Failed to assign ids to the delta's " << chunk_ids << " chunks: " << database_->getLastErrorMessage();
+                    return ResultCode::ERROR_PROCESSING_FAILED;
+                }
             }
             
-            // Note: Delegates are disabled for now to simplify initial integration
-            // They will be added in a future update once basic functionality is working
-            LEAFRA_INFO() << "  - Delegates: DISABLED (will be added in future update)";
-            
-            // Create interpreter
-            pImpl->tf_interpreter_ = TfLiteInterpreterCreate(pImpl->tf_model_, pImpl->tf_options_);
-            if (!pImpl->tf_interpreter_) {
-                LEAFRA_ERROR() << "❌ Failed to create TensorFlow Lite interpreter";
-                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            static const char* const kCopies[] = {
+                "INSERT INTO docs (id, filename, url, creation_date, size, file_size, file_mtime, content_hash, collection) "
+                "SELECT m.new_id, d.filename, d.url, d.creation_date, d.size, d.file_size, d.file_mtime, d.content_hash, d.collection "
+                "FROM sync_delta.docs d JOIN delta_doc_ids m ON m.old_id = d.id ORDER BY d.id",
+                "INSERT INTO doc_texts (doc_id, text_start, text_end, page_text) "
+                "SELECT m.new_id, t.text_start, t.text_end, t.page_text FROM sync_delta.doc_texts t JOIN delta_doc_ids m ON m.old_id = t.doc_id",
+                "INSERT INTO doc_centroids (doc_id, chunk_count, format, byte_order, dimension, scale, embedding) "
+                "SELECT m.new_id, g.chunk_count, g.format, g.byte_order, g.dimension, g.scale, g.embedding "
+                "FROM sync_delta.doc_centroids g JOIN delta_doc_ids m ON m.old_id = g.doc_id",
+                "INSERT INTO chunks (doc_id, chunk_page_number, chunk_faiss_id, chunk_no, chunk_token_size, chunk_size, chunk_text, "
+                "chunk_hash, chunk_simhash, chunk_start, chunk_end, chunk_doc_offset, chunk_page_offset) "
+                "SELECT m.new_id, c.chunk_page_number, f.new_id, c.chunk_no, c.chunk_token_size, c.chunk_size, c.chunk_text, "
+                "c.chunk_hash, c.chunk_simhash, c.chunk_start, c.chunk_end, c.chunk_doc_offset, c.chunk_page_offset "
+                "FROM sync_delta.chunks c JOIN delta_doc_ids m ON m.old_id = c.doc_id "
+                "LEFT JOIN delta_faiss_ids f ON f.old_id = c.chunk_faiss_id ORDER BY c.id",
+                "INSERT INTO chunk_embeddings (chunk_faiss_id, format, byte_order, dimension, scale, embedding) "
+                "SELECT f.new_id, e.format, e.byte_order, e.dimension, e.scale, e.embedding "
+                "FROM sync_delta.chunk_embeddings e JOIN delta_faiss_ids f ON f.old_id = e.chunk_faiss_id",
+            };
+            for (const char* copy : kCopies) {
+                if (!database_->execute(copy)) {
+                    LEAFRA_ERROR() << "Failed to copy the delta's rows: " << database_->getLastErrorMessage();
+                    return ResultCode::ERROR_PROCESSING_FAILED;
+                }
             }
             
-            // Allocate tensors
-            TfLiteStatus allocate_status = TfLiteInterpreterAllocateTensors(pImpl->tf_interpreter_);
-            if (allocate_status != kTfLiteOk) {
-                LEAFRA_ERROR() << "❌ Failed to allocate tensors for TensorFlow Lite interpreter";
-                return ResultCode::ERROR_INITIALIZATION_FAILED;
+#ifdef LEAFRA_HAS_FAISS
+            // Rows of one collection at a time, in new chunk_faiss_id order; rows of another dimension are skipped
+            static constexpr size_t kBatchRows = 1024;
+            const size_t dimension = static_cast<size_t>(config_.vector_search.dimension);
+            ChunkBatch batch;
+            batch.reset_embeddings(0, dimension);
+            std::vector<int64_t> faiss_ids;
+            std::string batch_collection;
+            bool indexed = true;
+            size_t skipped = 0;
+            auto add_batch = [&]() {
+                if (!faiss_ids.empty()) {
+                    indexed = insertChunkEmbeddingsIntoFaiss(batch, faiss_ids, batch_collection) && indexed;
+                }
+                faiss_ids.clear();
+                batch.reset_embeddings(0, dimension);
+            };
+            auto scan_stmt = database_->prepare(
+                "SELECT d.collection, f.new_id, e.format, e.byte_order, e.dimension, e.scale, e.embedding "
+                "FROM sync_delta.chunk_embeddings e JOIN delta_faiss_ids f ON f.old_id = e.chunk_faiss_id "
+                "JOIN sync_delta.chunks c ON c.chunk_faiss_id = e.chunk_faiss_id JOIN sync_delta.docs d ON d.id = c.doc_id "
+                "ORDER BY d.collection, f.new_id");
+            if (!scan_stmt || !scan_stmt->isValid()) {
+                LEAFRA_ERROR() << "Failed to read the delta's embeddings";
+                return ResultCode::ERROR_PROCESSING_FAILED;
             }
+            scan_stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+                std::string_view collection = row.getTextView(0);
+                if (collection != batch_collection || faiss_ids.size() == kBatchRows) {
+                    add_batch();
+                    batch_collection = std::string(collection);
+                }
+                const size_t row_index = faiss_ids.size();
+                batch.embeddings.resize((row_index + 1) * dimension);
+                SQLiteDatabase::BlobView blob = row.getBlobView(6);
+                if (static_cast<size_t>(row.getInt(4)) != dimension ||
+                    !VectorCodec::decode(static_cast<EmbeddingStorageFormat>(row.getInt(2)), static_cast<ByteOrder>(row.getInt(3)),
+                                         static_cast<float>(row.getDouble(5)), blob.data, blob.size, batch.embedding(row_index), dimension)) {
+                    batch.embeddings.resize(row_index * dimension);
+                    skipped++;
+                    return true;
+                }
+                batch.embedded.push_back(1);
+                faiss_ids.push_back(row.getInt64(1));
+                return true;
+            });
+            add_batch();
+            scan_stmt.reset();
+            if (!indexed) {
+                LEAFRA_ERROR() << "Failed to add the delta's embeddings to the FAISS index";
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            if (skipped > 0) {
+                LEAFRA_WARNING() << "Skipped " << skipped << " delta embeddings with a different dimension or unknown encoding";
+            }
+#endif
             
-            // Log model information
-            int32_t input_count = TfLiteInterpreterGetInputTensorCount(pImpl->tf_interpreter_);
-            int32_t output_count = TfLiteInterpreterGetOutputTensorCount(pImpl->tf_interpreter_);
-            
-            LEAFRA_INFO() << "✅ TensorFlow Lite model initialized successfully";
-            LEAFRA_INFO() << "  - Input tensors: " << input_count;
-            LEAFRA_INFO() << "  - Output tensors: " << output_count;
-            LEAFRA_INFO() << "  - Delegates: " << pImpl->tf_delegates_.size();
-            
-            pImpl->tf_initialized_ = true;
-        } else if (config.embedding_inference.enabled) {
-            LEAFRA_WARNING() << "⚠️  Embedding model inference enabled but configuration is invalid";
-            LEAFRA_WARNING() << "    Framework: '" << config.embedding_inference.framework << "'";
-            LEAFRA_WARNING() << "    Model path: '" << config.embedding_inference.model_path << "'";
-        }
-#else
-        if (config.embedding_inference.enabled) {
-            LEAFRA_WARNING() << "⚠️  TensorFlow Lite embedding model requested but not available (library not linked)";
+            database_->execute("SELECT COUNT(*) FROM delta_doc_ids", [&added](const SQLiteDatabase::Row& row) {
+                added = static_cast<size_t>(row.getInt64(0));
+                return false;
+            });
+            database_->execute("DELETE FROM delta_doc_ids");
+            database_->execute("DELETE FROM delta_faiss_ids");
+            if (!transaction.commit()) {
+                LEAFRA_ERROR() << "Failed to commit the delta's " << added << " documents";
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "Exception while applying delta: " << e.what();
+            return ResultCode::ERROR_PROCESSING_FAILED;
         }
-#endif
         
-        // Initialize SQLite database - create if necessary 
+        // Later documents can match the new chunks once the fingerprints are reloaded
+        near_duplicate_index_.reset();
+#ifdef LEAFRA_HAS_FAISS
+        loadDocumentIndex();
+#endif
+        return ResultCode::SUCCESS;
+    } //applyAttachedDelta
+#endif
+    
+    /**
+     * @brief Online backup: copy the database in page batches while ingestion and searches carry on
+     * 
+     * The copy is the database as of its last backup step; FAISS indexes stored in the database
+     * (base blob plus delta log) are consistent with it by construction. With "file" storage,
+     * compaction is deferred for the duration so the index files stay in step with the copied
+     * delta log, and the newest file of each collection is copied to "<path>.indexes". The
+     * manifest's faiss_delta_id marks the last delta the copy knows of.
+     * 
+     * @param path Backup file (replaced if it exists)
+     */
+    ResultCode runBackup(const std::string& path) {
 #ifdef LEAFRA_HAS_SQLITE
-        LEAFRA_INFO() << "Initializing SQLite database";
-        
-        // Get absolute path to the database using FileManager
-        std::string db_absolute_path = FileManager::getAbsolutePath(
-            StorageType::AppStorage, 
-            config.leafra_document_database_name
-        );
-        
-        LEAFRA_DEBUG() << "Database path: " << db_absolute_path;
-        
-        // Check if database exists
-        if (!SQLiteDatabase::fileExists(db_absolute_path)) {
-            LEAFRA_INFO() << "Database does not exist, creating new database: " << config.leafra_document_database_name;
-            
-            // Create the database with RAG schema
-            if (SQLiteDatabase::createdb(config.leafra_document_database_name)) {
-                LEAFRA_INFO() << "✅ Database created successfully: " << config.leafra_document_database_name;
-                pImpl->send_event("Database created: " + config.leafra_document_database_name);
-            } else {
-                LEAFRA_ERROR() << "❌ Failed to create database: " << config.leafra_document_database_name;
-                pImpl->send_event("Failed to create database: " + config.leafra_document_database_name);
-                return ResultCode::ERROR_INITIALIZATION_FAILED;
-            }
-        } else {
-            LEAFRA_INFO() << "✅ Database already exists: " << config.leafra_document_database_name;
-            pImpl->send_event("Database found: " + config.leafra_document_database_name);
+        std::unique_lock<std::mutex> backup_lock(backup_mutex_, std::try_to_lock);
+        if (!backup_lock.owns_lock()) {
+            LEAFRA_ERROR() << "A backup is already running";
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        if (!database_ || !database_->isOpen()) {
+            LEAFRA_ERROR() << "Database not available for backup";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
         }
+        auto start_time = debug::timer::now();
+        const std::string index_directory = path + ".indexes";
+        std::error_code ec;
+        std::filesystem::remove_all(index_directory, ec);
         
-        // Open the database using our member object
-        if (pImpl->database_) {
-            if (pImpl->database_->open(config.leafra_document_database_name)) {
-                LEAFRA_INFO() << "✅ Database opened successfully: " << config.leafra_document_database_name;
-                pImpl->send_event("Database opened: " + config.leafra_document_database_name);
-            } else {
-                LEAFRA_ERROR() << "❌ Failed to open database: " << config.leafra_document_database_name;
-                pImpl->send_event("Failed to open database: " + config.leafra_document_database_name);
-                return ResultCode::ERROR_INITIALIZATION_FAILED;
-            }
+#ifdef LEAFRA_HAS_FAISS
+        const bool file_storage = config_.vector_search.enabled && config_.vector_search.index_storage == "file";
+        std::unique_lock<std::recursive_mutex> files_lock(faiss_files_mutex_, std::defer_lock);
+        if (file_storage) {
+            files_lock.lock();
         }
-
-        // Initialize FAISS index using the sdk config settings
-    #ifdef LEAFRA_HAS_FAISS
-        if (config.vector_search.enabled) {
-            try {
-                // Create FAISS index with config settings
-                pImpl->faiss_index_ = std::make_unique<FaissIndex>(
-                    config.vector_search.dimension,
-                    get_faiss_index_type_from_string(config.vector_search.index_type),
-                    get_faiss_metric_type_from_string(config.vector_search.metric)
-                );
-                
-                // Restore from database if available
-                if (pImpl->database_ && pImpl->database_->isOpen()) {
-                    auto restore_result = pImpl->faiss_index_->restore_from_db(*pImpl->database_, "PrimaryDocEmbeddings");
-                    if (restore_result == ResultCode::SUCCESS) {
-                        LEAFRA_INFO() << "✅ FAISS index restored from database";
-                        pImpl->send_event("FAISS index restored from database");
-                    } else if (restore_result == ResultCode::ERROR_NOT_FOUND) {
-                        LEAFRA_INFO() << "No existing FAISS index found in database - starting fresh";
-                        pImpl->send_event("Starting with fresh FAISS index");
-                    } else {
-                        LEAFRA_ERROR() << "Failed to restore FAISS index from database";
-                        pImpl->send_event("Failed to restore FAISS index from database");
-                        return ResultCode::ERROR_INITIALIZATION_FAILED;
-                    }
-                }
-            
-                LEAFRA_INFO() << "✅ FAISS index initialized successfully";
-                pImpl->send_event("FAISS index initialized");
-            } catch (const std::exception& e) {
-                LEAFRA_ERROR() << "Failed to initialize FAISS index: " << e.what();
-                pImpl->send_event("Failed to initialize FAISS index: " + std::string(e.what()));
-                return ResultCode::ERROR_INITIALIZATION_FAILED;
-            }
-        } else {
-            LEAFRA_INFO() << "Vector search disabled in configuration";
+#endif
+        const int pages_per_step = config_.database.backup_pages_per_step;
+        const int pause_ms = config_.database.backup_step_pause_ms;
+        if (!database_->backupTo(path, pages_per_step, pause_ms, [this](int, int) { return !backup_cancelled_.load(); })) {
+            return backup_cancelled_ ? ResultCode::ERROR_CANCELLED : ResultCode::ERROR_PROCESSING_FAILED;
         }
-    #else // LEAFRA_HAS_FAISS
-        LEAFRA_WARNING() << "⚠️  FAISS integration: DISABLED (library not found)";
-    #endif // LEAFRA_HAS_FAISS
         
-#else // LEAFRA_HAS_SQLITE
-        LEAFRA_WARNING() << "⚠️  SQLite integration disabled - database initialization skipped";
-#endif // LEAFRA_HAS_SQLITE
-    
-#ifdef LEAFRA_HAS_LLAMACPP
-        if (config.llm.enabled) {
-            LEAFRA_INFO() << "Initializing LLM inference";
-            LEAFRA_INFO() << "  - Framework: " << config.llm.framework;
-            LEAFRA_INFO() << "  - Model path: " << config.llm.model_path;
-            LEAFRA_INFO() << "  - Context size: " << config.llm.n_ctx;
-            LEAFRA_INFO() << "  - Max tokens: " << config.llm.n_predict;
-            LEAFRA_INFO() << "  - Temperature: " << config.llm.temperature;
-            
-            // Initialize LlamaCpp backend
-            if (!leafra::llamacpp::global::initialize(false)) {
-                LEAFRA_ERROR() << "Failed to initialize LlamaCpp backend";
-                return ResultCode::ERROR_INITIALIZATION_FAILED;
-            }
-            
-            // Create LlamaCpp model instance
-            pImpl->llamacpp_model_ = std::make_unique<leafra::llamacpp::LlamaCppModel>();
-            
-            // Load model directly with LLMConfig
-            if (!pImpl->llamacpp_model_->load_model(config.llm)) {
-                LEAFRA_ERROR() << "Failed to load LlamaCpp model: " << pImpl->llamacpp_model_->get_last_error();
-                pImpl->llamacpp_model_.reset();
-                leafra::llamacpp::global::cleanup();
-                return ResultCode::ERROR_INITIALIZATION_FAILED;
-            }
-            
-            // Set system prompt if provided
-            if (!config.llm.system_prompt.empty()) {
-                if (!pImpl->llamacpp_model_->set_system_prompt(config.llm.system_prompt)) {
-                    LEAFRA_WARNING() << "Failed to set system prompt: " << pImpl->llamacpp_model_->get_last_error();
+        bool written = true;
+#ifdef LEAFRA_HAS_FAISS
+        if (file_storage) {
+            std::vector<std::string> names;
+            {
+                std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+                for (const auto& entry : faiss_collections_) {
+                    names.push_back(entry.first);
                 }
             }
-            
-            pImpl->llamacpp_initialized_ = true;
-            LEAFRA_INFO() << "✅ LlamaCpp model loaded successfully";
-            LEAFRA_INFO() << "  - Model info: " << pImpl->llamacpp_model_->get_model_info();
+            written = std::filesystem::create_directories(index_directory, ec) && !ec;
+            for (size_t i = 0; written && i < names.size(); ++i) {
+                int64_t watermark = -1;
+                written = FaissIndex::copy_index_files(faissIndexFileBase(names[i]), index_directory, watermark) == ResultCode::SUCCESS;
+            }
+            files_lock.unlock();
         }
 #endif
-
-        pImpl->initialized_ = true;
-        LEAFRA_INFO() << "LeafraSDK initialized successfully";
         
-#ifdef LEAFRA_HAS_PDFIUM
-        LEAFRA_INFO() << "✅ PDFium integration: ENABLED";
+        SQLiteDatabase backup;
+        DatabaseConfig backup_config;
+        backup_config.journal_mode.clear();
+        backup.setConfig(backup_config);
+        BundleManifest manifest = currentBundleManifest();
+        written = written && backup.openFile(path, static_cast<int>(SQLiteDatabase::OpenFlags::ReadWrite)) &&
+                  RagBundle::write_manifest(backup, manifest);
+        backup.close();
+        if (!written) {
+            LEAFRA_ERROR() << "❌ Failed to write backup " << path;
+            std::filesystem::remove(path, ec);
+            std::filesystem::remove_all(index_directory, ec);
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        
+        LEAFRA_INFO() << "💾 Backed up " << manifest.documents << " documents to " << path << " (FAISS delta "
+                      << manifest.faiss_delta_id << ") in " << debug::timer::elapsed_milliseconds(start_time, debug::timer::now()) << " ms";
+        send_event(EventType::DATABASE_STATUS, "Backup written: " + std::to_string(manifest.documents) + " documents");
+        return ResultCode::SUCCESS;
 #else
-        LEAFRA_WARNING() << "⚠️  PDFium integration: DISABLED (library not found)";
+        (void)path;
+        LEAFRA_ERROR() << "SQLite support not compiled, the database can't be backed up";
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
 #endif
+    } //runBackup
 
-#ifdef LEAFRA_HAS_COREML
-        LEAFRA_INFO() << "✅ CoreML integration: ENABLED";
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+    // Answer cache key: the sorted chunk ids an answer was grounded on
+    static std::string makeAnswerCacheKey(const std::vector<FaissIndex::SearchResult>& results) {
+        std::vector<int64_t> ids;
+        ids.reserve(results.size());
+        for (const auto& result : results) {
+            ids.push_back(result.id);
+        }
+        std::sort(ids.begin(), ids.end());
+        std::string key;
+        for (int64_t id : ids) {
+            key += std::to_string(id);
+            key += ',';
+        }
+        return key;
+    }
+    
+    /**
+     * @brief Find a cached answer for the same chunk set whose question embedding is close enough
+     * @return true on a hit (answer is filled in)
+     */
+    bool lookupCachedAnswer(const std::string& key, const std::vector<float>& query_embedding, std::string& answer) {
+        std::lock_guard<std::mutex> lock(query_mutex_);
+        const std::vector<CachedAnswer>* cached = answer_cache_.get(key);
+        if (cached) {
+            const float query_norm = simd::squared_norm(query_embedding.data(), query_embedding.size());
+            for (const CachedAnswer& entry : *cached) {
+                if (entry.query_embedding.size() != query_embedding.size()) {
+                    continue;
+                }
+                const float entry_norm = simd::squared_norm(entry.query_embedding.data(), entry.query_embedding.size());
+                const float dot = simd::dot(entry.query_embedding.data(), query_embedding.data(), query_embedding.size());
+                if (query_norm > 0.0f && entry_norm > 0.0f &&
+                    dot / std::sqrt(query_norm * entry_norm) >= config_.search_cache.answer_similarity) {
+                    answer = entry.answer;
+                    answer_hits_++;
+                    return true;
+                }
+            }
+        }
+        answer_misses_++;
+        return false;
+    } //lookupCachedAnswer
+    
+    void storeCachedAnswer(const std::string& key, const std::vector<FaissIndex::SearchResult>& results,
+                           std::vector<float> query_embedding, std::string answer) {
+        CachedAnswer entry;
+        entry.query_embedding = std::move(query_embedding);
+        entry.answer = std::move(answer);
+        for (const auto& result : results) {
+            entry.doc_ids.push_back(result.doc_id);
+        }
+        std::lock_guard<std::mutex> lock(query_mutex_);
+        std::vector<CachedAnswer> answers;
+        if (const std::vector<CachedAnswer>* cached = answer_cache_.get(key)) {
+            answers = *cached;
+        }
+        if (answers.size() >= kMaxAnswersPerChunkSet) {
+            answers.erase(answers.begin());
+        }
+        answers.push_back(std::move(entry));
+        answer_cache_.put(key, std::move(answers));
+    } //storeCachedAnswer
+#endif
+    
+    // Drop cached answers grounded on a document whose chunks were just removed
+    void invalidateCachedAnswers(int64_t doc_id) {
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+        std::lock_guard<std::mutex> lock(query_mutex_);
+        answer_cache_.erase_if([doc_id](const std::string&, std::vector<CachedAnswer>& answers) {
+            answers.erase(std::remove_if(answers.begin(), answers.end(), [doc_id](const CachedAnswer& entry) {
+                return std::find(entry.doc_ids.begin(), entry.doc_ids.end(), doc_id) != entry.doc_ids.end();
+            }), answers.end());
+            return answers.empty();
+        });
 #else
-        LEAFRA_WARNING() << "⚠️  CoreML integration: DISABLED (framework not found)";
+        (void)doc_id;
 #endif
-
-#ifdef LEAFRA_HAS_TENSORFLOWLITE
-        LEAFRA_INFO() << "✅ TensorFlow Lite integration: ENABLED";
+    }
+    
+    // Same for a set of documents, in one pass over the cache
+    void invalidateCachedAnswers(const std::unordered_set<int64_t>& doc_ids) {
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+        std::lock_guard<std::mutex> lock(query_mutex_);
+        answer_cache_.erase_if([&doc_ids](const std::string&, std::vector<CachedAnswer>& answers) {
+            answers.erase(std::remove_if(answers.begin(), answers.end(), [&doc_ids](const CachedAnswer& entry) {
+                return std::any_of(entry.doc_ids.begin(), entry.doc_ids.end(), [&doc_ids](int64_t doc_id) {
+                    return doc_ids.count(doc_id) > 0;
+                });
+            }), answers.end());
+            return answers.empty();
+        });
 #else
-        LEAFRA_WARNING() << "⚠️  TensorFlow Lite integration: DISABLED (library not found)";
+        (void)doc_ids;
 #endif
-        
-        pImpl->send_event("LeafraSDK initialized successfully");
-        
-        return ResultCode::SUCCESS;
-    } catch (const std::exception& e) {
-        LEAFRA_ERROR() << "Initialization failed: " << e.what();
-        pImpl->send_event("Initialization failed: " + std::string(e.what()));
-        return ResultCode::ERROR_INITIALIZATION_FAILED;
     }
-}
+    
+#ifdef LEAFRA_HAS_FAISS
+    /**
+     * @brief Look up cached top-k results, dropping the entry if the FAISS index changed since
+     * @param key Result cache key (query cache key + k)
+     * @param results Output results on a hit
+     * @return true on a hit with a current index generation
+     */
+    bool lookupCachedSearch(const std::string& key, std::vector<FaissIndex::SearchResult>& results) {
+        std::lock_guard<std::mutex> lock(query_mutex_);
+        const CachedSearch* cached = search_result_cache_.get(key);
+        if (!cached) {
+            return false;
+        }
+        if (cached->index_generation != faissGeneration()) {
+            stale_search_results_++;
+            search_result_cache_.erase(key);
+            return false;
+        }
+        results = cached->results;
+        return true;
+    } //lookupCachedSearch
 
-ResultCode LeafraCore::shutdown() {
-    if (!pImpl->initialized_) {
-        return ResultCode::SUCCESS; // Already shutdown
+    void storeCachedSearch(const std::string& key, uint64_t index_generation, const std::vector<FaissIndex::SearchResult>& results) {
+        std::lock_guard<std::mutex> lock(query_mutex_);
+        search_result_cache_.put(key, CachedSearch{index_generation, results});
+    } //storeCachedSearch
+
+#ifdef LEAFRA_HAS_SQLITE
+    /**
+     * @brief Copy a chunks.chunk_text column, decompressing it if it was stored as a TextCodec blob
+     */
+    static void readChunkText(const SQLiteDatabase::Row& row, int column, std::string& text) {
+        if (row.getColumnType(column) != SQLiteDatabase::ColumnType::Blob) {
+            text.assign(row.getTextView(column));
+            return;
+        }
+        SQLiteDatabase::BlobView blob = row.getBlobView(column);
+        if (!TextCodec::decompress(blob.data, blob.size, text)) {
+            LEAFRA_WARNING() << "Malformed compressed chunk text (" << blob.size << " bytes)";
+        }
     }
     
-    try {
-#ifdef LEAFRA_HAS_COREML
-        // Cleanup CoreML resources
-        if (pImpl->coreml_initialized_) {
-            LEAFRA_DEBUG() << "Shutting down CoreML";
+    /**
+     * @brief readChunkText into a result set's arena (plain text is copied straight from the column)
+     */
+    static std::string_view readChunkText(const SQLiteDatabase::Row& row, int column, SearchResultSet& set, std::string& scratch) {
+        if (row.getColumnType(column) != SQLiteDatabase::ColumnType::Blob) {
+            return set.store_text(row.getTextView(column));
+        }
+        readChunkText(row, column, scratch);
+        return set.store_text(scratch);
+    }
+    
+    // Highlight offsets of a chunk row c, read back by readChunkOffsets (offset rows predating chunk_doc_offset have chunk_start)
+    static constexpr const char* kChunkOffsetColumns = "COALESCE(c.chunk_doc_offset, c.chunk_start), c.chunk_page_offset, c.chunk_size";
+    
+    /**
+     * @brief Fill a hit's text_start / text_end / page_text_start from kChunkOffsetColumns selected at column
+     */
+    static void readChunkOffsets(const SQLiteDatabase::Row& row, int column, FaissIndex::SearchResult& hit) {
+        if (!row.isNull(column)) {
+            hit.text_start = row.getInt64(column);
+            hit.text_end = hit.text_start + row.getInt64(column + 2);
+        }
+        hit.page_text_start = row.isNull(column + 1) ? -1 : row.getInt64(column + 1);
+    }
+    
+    /**
+     * @brief Fill chunk text and document metadata for FAISS hits with batched IN (...) lookups
+     * 
+     * Uses the idx_chunks_faiss_id index; hits missing from the database are dropped and
+     * the rest keep their FAISS rank order. Text fields that aren't asked for are neither
+     * read nor copied.
+     * 
+     * @param results FAISS hits in rank order, replaced with the hydrated hits
+     * @param fields SearchResultFields to fill in (doc_id, chunk_index and page_number always are)
+     * @param text_out If set, receives the hydrated hits with their text, which then isn't
+     *                 copied into results (content and filename stay empty there)
+     * @return true if every lookup query ran
+     */
+    bool hydrateSearchResults(std::vector<FaissIndex::SearchResult>& results,
+                              uint32_t fields = static_cast<uint32_t>(SearchResultFields::ALL),
+                              SearchResultSet* text_out = nullptr) {
+        static constexpr size_t kMaxIdsPerQuery = 500;   // Stay below SQLITE_MAX_VARIABLE_NUMBER on older builds
+        PipelineMetricsRecorder::ScopedStage timing(metrics_, PipelineStage::DB_HYDRATE);
+        timing.set_items(results.size());
+        markDatabaseUsed();
+        SQLiteReadPool::Lease reader = read_pool_.acquire(database_.get());
+        
+        std::unordered_map<int64_t, size_t> rank_by_id;
+        rank_by_id.reserve(results.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            rank_by_id.emplace(results[i].id, i);
+        }
+        
+        const bool want_content = (fields & static_cast<uint32_t>(SearchResultFields::CONTENT)) != 0;
+        const bool want_filename = (fields & static_cast<uint32_t>(SearchResultFields::FILENAME)) != 0;
+        std::vector<bool> found(results.size(), false);
+        // Text views into text_out, by rank; sized for chunks of the configured size up front
+        std::vector<std::pair<std::string_view, std::string_view>> texts(text_out ? results.size() : 0);
+        std::string scratch;
+        if (text_out) {
+            const size_t chunk_bytes = want_content ? config_.chunking.chunk_size * 4 : 0;
+            text_out->reset(results.size(), results.size() * (chunk_bytes + 64));
+        }
+        bool ok = true;
+        for (size_t begin = 0; begin < results.size(); begin += kMaxIdsPerQuery) {
+            size_t end = std::min(results.size(), begin + kMaxIdsPerQuery);
             
-            // Destroy the CoreML model
-            if (pImpl->coreml_model_) {
-                pImpl->coreml_model_.reset();
+            std::string sql = "SELECT c.chunk_faiss_id, c.doc_id, c.chunk_no, ";
+            sql += want_content ? "CASE WHEN c.chunk_start IS NULL THEN c.chunk_text "
+                                  "ELSE leafra_chunk_text(c.chunk_text, c.doc_id, c.chunk_start, c.chunk_end) END, "
+                                : "NULL, ";
+            sql += want_filename ? "c.chunk_page_number, d.filename, " : "c.chunk_page_number, NULL, ";
+            sql += kChunkOffsetColumns;
+            sql += " ";
+            sql +=
+                "FROM chunks c "
+                "JOIN docs d ON c.doc_id = d.id "
+                "WHERE c.chunk_faiss_id IN (?";
+            for (size_t i = begin + 1; i < end; ++i) {
+                sql += ",?";
             }
+            sql += ")";
             
-            pImpl->coreml_initialized_ = false;
-            
-            LEAFRA_DEBUG() << "CoreML shutdown completed";
-        }
-#endif
-
-#ifdef LEAFRA_HAS_TENSORFLOWLITE
-        // Cleanup TensorFlow Lite resources
-        if (pImpl->tf_initialized_) {
-            LEAFRA_DEBUG() << "Shutting down TensorFlow Lite";
-            
-            // Clean up interpreter
-            if (pImpl->tf_interpreter_) {
-                TfLiteInterpreterDelete(pImpl->tf_interpreter_);
-                pImpl->tf_interpreter_ = nullptr;
+            auto stmt = reader->prepareCached(sql);
+            if (!stmt || !stmt->isValid()) {
+                LEAFRA_ERROR() << "Failed to prepare chunk lookup query";
+                ok = false;
+                continue;
+            }
+            for (size_t i = begin; i < end; ++i) {
+                stmt->bindInt64(static_cast<int>(i - begin + 1), results[i].id);
             }
             
-            // Clean up delegates
-            for (TfLiteDelegate* delegate : pImpl->tf_delegates_) {
-                if (delegate) {
-                    // Note: Delegates are automatically cleaned up when interpreter is deleted,
-                    // but we can explicitly delete them if needed for specific delegate types
-#if defined(__APPLE__)
-                    // For CoreML and Metal delegates, they are automatically cleaned up
-#endif
+            // Text is copied once, straight from the column memory into the result
+            bool stepped = stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+                auto rank = rank_by_id.find(row.getInt64(0));
+                if (rank == rank_by_id.end()) {
+                    return true;
+                }
+                FaissIndex::SearchResult& hit = results[rank->second];
+                hit.doc_id = row.getInt64(1);
+                hit.chunk_index = row.getInt(2);
+                hit.page_number = row.getInt(4);
+                readChunkOffsets(row, 6, hit);
+                if (text_out) {
+                    if (want_content) {
+                        texts[rank->second].first = readChunkText(row, 3, *text_out, scratch);
+                    }
+                    if (want_filename) {
+                        texts[rank->second].second = text_out->intern_filename(hit.doc_id, row.getTextView(5));
+                    }
+                } else {
+                    if (want_content) {
+                        readChunkText(row, 3, hit.content);
+                    }
+                    if (want_filename) {
+                        hit.filename.assign(row.getTextView(5));
+                    }
                 }
+                found[rank->second] = true;
+                return true;
+            });
+            if (!stepped) {
+                LEAFRA_ERROR() << "Chunk lookup query failed: " << reader->getLastErrorMessage();
+                ok = false;
             }
-            pImpl->tf_delegates_.clear();
-            
-            // Clean up options
-            if (pImpl->tf_options_) {
-                TfLiteInterpreterOptionsDelete(pImpl->tf_options_);
-                pImpl->tf_options_ = nullptr;
+        }
+        
+        size_t kept = 0;
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (!found[i]) {
+                LEAFRA_WARNING() << "FAISS ID " << results[i].id << " not found in database";
+                continue;
             }
-            
-            // Clean up model
-            if (pImpl->tf_model_) {
-                TfLiteModelDelete(pImpl->tf_model_);
-                pImpl->tf_model_ = nullptr;
+            LEAFRA_DEBUG() << "Found chunk - Doc: " << (text_out ? texts[i].second : std::string_view(results[i].filename))
+                          << ", Page: " << results[i].page_number
+                          << ", Chunk: " << results[i].chunk_index
+                          << ", Distance: " << results[i].distance;
+            if (text_out) {
+                SearchHit& hit = text_out->add(results[i].id, results[i].distance);
+                hit.doc_id = results[i].doc_id;
+                hit.chunk_index = results[i].chunk_index;
+                hit.page_number = results[i].page_number;
+                hit.text_start = results[i].text_start;
+                hit.text_end = results[i].text_end;
+                hit.page_text_start = results[i].page_text_start;
+                hit.content = texts[i].first;
+                hit.filename = texts[i].second;
             }
-            
-            pImpl->tf_initialized_ = false;
-            LEAFRA_DEBUG() << "TensorFlow Lite shutdown completed";
+            if (kept != i) {
+                results[kept] = std::move(results[i]);
+            }
+            kept++;
+        }
+        results.resize(kept);
+        return ok;
+    } //hydrateSearchResults
+#endif
+    
+    /**
+     * @brief Copy hits into a result set (results served from the cache, hits that weren't hydrated)
+     */
+    static void fillResultSet(const std::vector<FaissIndex::SearchResult>& results, SearchResultSet& set) {
+        size_t text_bytes = 0;
+        for (const FaissIndex::SearchResult& result : results) {
+            text_bytes += result.content.size() + result.filename.size();
+        }
+        set.reset(results.size(), text_bytes);
+        for (const FaissIndex::SearchResult& result : results) {
+            SearchHit& hit = set.add(result.id, result.distance);
+            hit.doc_id = result.doc_id;
+            hit.chunk_index = result.chunk_index;
+            hit.page_number = result.page_number;
+            hit.text_start = result.text_start;
+            hit.text_end = result.text_end;
+            hit.page_text_start = result.page_text_start;
+            hit.content = set.store_text(result.content);
+            hit.filename = set.intern_filename(result.doc_id, result.filename);
+        }
+    }
+    
+#ifdef LEAFRA_HAS_SQLITE
+    /**
+     * @brief Count search hits towards the hot chunks the startup warm-up loads (written in batches by flushRetrievalCounts)
+     */
+    void recordRetrievals(const std::vector<FaissIndex::SearchResult>& results) {
+        static constexpr size_t kFlushThreshold = 256;   // Distinct chunks pending before a flush is queued
+        if (!chunk_retrievals_available_ || !config_.prefetch_after_initialize || config_.prefetch_hot_chunks <= 0 ||
+            results.empty()) {
+            return;
+        }
+        size_t pending = 0;
+        {
+            std::lock_guard<std::mutex> lock(retrieval_counts_mutex_);
+            for (const FaissIndex::SearchResult& hit : results) {
+                pending_retrievals_[hit.id]++;
+            }
+            pending = pending_retrievals_.size();
+        }
+        if (pending >= kFlushThreshold && worker_pool_ && !retrieval_flush_queued_.exchange(true)) {
+            if (!worker_pool_->submit([this]() { flushRetrievalCounts(false); })) {
+                retrieval_flush_queued_ = false;
+            }
+        }
+    }
+    
+    /**
+     * @brief Add the pending search hit counts to chunk_retrievals
+     * @param wait Wait for a running ingestion (false: skip this flush and keep the counts pending)
+     */
+    void flushRetrievalCounts(bool wait) {
+        retrieval_flush_queued_ = false;
+        // Ingestion owns the connection's transactions
+        std::unique_lock<std::mutex> ingestion_lock(ingestion_mutex_, std::defer_lock);
+        if (wait) {
+            ingestion_lock.lock();
+        } else if (!ingestion_lock.try_lock()) {
+            return;
+        }
+        std::unordered_map<int64_t, int64_t> counts;
+        {
+            std::lock_guard<std::mutex> lock(retrieval_counts_mutex_);
+            counts.swap(pending_retrievals_);
+        }
+        if (counts.empty() || !database_ || !database_->isOpen()) {
+            return;
+        }
+        auto upsert = database_->prepareCached(
+            "INSERT INTO chunk_retrievals (chunk_faiss_id, retrievals) VALUES (?, ?) "
+            "ON CONFLICT(chunk_faiss_id) DO UPDATE SET retrievals = retrievals + excluded.retrievals");
+        if (!upsert.isValid()) {
+            return;
+        }
+        // Counts only rank chunks for the warm-up, so a failed flush drops them rather than retrying
+        SQLiteTransaction transaction(*database_);
+        for (const auto& count : counts) {
+            upsert->reset();
+            upsert->bindInt64(1, count.first);
+            upsert->bindInt64(2, count.second);
+            if (!upsert->execute()) {
+                LEAFRA_WARNING() << "Failed to record chunk retrievals: " << database_->getLastErrorMessage();
+                return;
+            }
+        }
+        if (!transaction.commit()) {
+            LEAFRA_WARNING() << "Failed to commit chunk retrievals: " << database_->getLastErrorMessage();
+            return;
+        }
+        LEAFRA_DEBUG() << "Recorded retrievals of " << counts.size() << " chunks";
+    }
+    
+    /**
+     * @brief Filenames of the documents that search hits come from, one query per batch of ids
+     * @param results Hits with doc_id set
+     * @param documents Output filename by doc_id (replaced)
+     * @return true if every lookup query ran
+     */
+    bool lookupDocumentNames(const std::vector<FaissIndex::SearchResult>& results,
+                             std::unordered_map<int64_t, std::string>& documents) {
+        static constexpr size_t kMaxIdsPerQuery = 500;
+        documents.clear();
+        std::vector<int64_t> doc_ids;
+        for (const auto& hit : results) {
+            if (documents.emplace(hit.doc_id, std::string()).second) {
+                doc_ids.push_back(hit.doc_id);
+            }
+        }
+        if (doc_ids.empty()) {
+            return true;
+        }
+        markDatabaseUsed();
+        SQLiteReadPool::Lease reader = read_pool_.acquire(database_.get());
+        
+        bool ok = true;
+        for (size_t begin = 0; begin < doc_ids.size(); begin += kMaxIdsPerQuery) {
+            size_t end = std::min(doc_ids.size(), begin + kMaxIdsPerQuery);
+            std::string sql = "SELECT id, filename FROM docs WHERE id IN (?";
+            for (size_t i = begin + 1; i < end; ++i) {
+                sql += ",?";
+            }
+            sql += ")";
+            
+            auto stmt = reader->prepareCached(sql);
+            if (!stmt || !stmt->isValid()) {
+                LEAFRA_ERROR() << "Failed to prepare document lookup query";
+                ok = false;
+                continue;
+            }
+            for (size_t i = begin; i < end; ++i) {
+                stmt->bindInt64(static_cast<int>(i - begin + 1), doc_ids[i]);
+            }
+            bool stepped = stmt->forEachRow([&documents](const SQLiteDatabase::Row& row) {
+                documents[row.getInt64(0)].assign(row.getTextView(1));
+                return true;
+            });
+            if (!stepped) {
+                LEAFRA_ERROR() << "Document lookup query failed: " << reader->getLastErrorMessage();
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Grow hydrated hits into passages of their neighbouring chunks
+     * 
+     * The neighbours of every hit are read with one batched query per block of windows over
+     * idx_chunks_chunk_no. Each hit grows outward from its chunk, nearest neighbours first,
+     * while the estimated tokens stay within max_tokens; windows of one document that touch
+     * or overlap merge into one passage, which keeps the rank, id and score of its best hit.
+     * Text shared through chunk overlap appears once; missing chunks leave a blank line.
+     * 
+     * @param results Hydrated hits in rank order, replaced with the passages in rank order
+     * @param before Chunks to add before each hit
+     * @param after Chunks to add after each hit
+     * @param max_tokens Most estimated tokens per hit's window (0 = no limit)
+     * @return true if every neighbour query ran
+     */
+    bool expandContext(std::vector<FaissIndex::SearchResult>& results, int before, int after, int max_tokens) {
+        static constexpr size_t kMaxWindowsPerQuery = 300;   // Three variables each, below SQLITE_MAX_VARIABLE_NUMBER
+        struct Neighbour {
+            int64_t tokens = 0;
+            int page_number = -1;
+            std::string content;
+        };
+        struct Window {
+            int64_t doc_id;
+            int first;
+            int last;
+        };
+        
+        // Windows per document, overlapping ones merged so each chunk is read once
+        std::vector<Window> windows;
+        for (const auto& hit : results) {
+            if (hit.doc_id >= 0 && hit.chunk_index >= 0) {
+                windows.push_back({hit.doc_id, std::max(0, hit.chunk_index - before), hit.chunk_index + after});
+            }
+        }
+        std::sort(windows.begin(), windows.end(), [](const Window& a, const Window& b) {
+            return a.doc_id != b.doc_id ? a.doc_id < b.doc_id : a.first < b.first;
+        });
+        std::vector<Window> reads;
+        for (const Window& window : windows) {
+            if (!reads.empty() && reads.back().doc_id == window.doc_id && window.first <= reads.back().last + 1) {
+                reads.back().last = std::max(reads.back().last, window.last);
+            } else {
+                reads.push_back(window);
+            }
+        }
+        
+        SQLiteReadPool::Lease reader = read_pool_.acquire(database_.get());
+        std::map<std::pair<int64_t, int>, Neighbour> neighbours;
+        bool ok = true;
+        for (size_t begin = 0; begin < reads.size(); begin += kMaxWindowsPerQuery) {
+            const size_t end = std::min(reads.size(), begin + kMaxWindowsPerQuery);
+            std::string sql =
+                "SELECT doc_id, chunk_no, chunk_token_size, chunk_page_number, "
+                "CASE WHEN chunk_start IS NULL THEN chunk_text ELSE leafra_chunk_text(chunk_text, doc_id, chunk_start, chunk_end) END "
+                "FROM chunks WHERE (doc_id = ? AND chunk_no BETWEEN ? AND ?)";
+            for (size_t i = begin + 1; i < end; ++i) {
+                sql += " OR (doc_id = ? AND chunk_no BETWEEN ? AND ?)";
+            }
+            auto stmt = reader->prepareCached(sql);
+            if (!stmt || !stmt->isValid()) {
+                LEAFRA_ERROR() << "Failed to prepare neighbour chunk query";
+                ok = false;
+                continue;
+            }
+            int param = 1;
+            for (size_t i = begin; i < end; ++i) {
+                stmt->bindInt64(param++, reads[i].doc_id);
+                stmt->bindInt(param++, reads[i].first);
+                stmt->bindInt(param++, reads[i].last);
+            }
+            bool stepped = stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+                Neighbour& neighbour = neighbours[{row.getInt64(0), row.getInt(1)}];
+                neighbour.tokens = row.getInt64(2);
+                neighbour.page_number = row.getInt(3);
+                readChunkText(row, 4, neighbour.content);
+                return true;
+            });
+            if (!stepped) {
+                LEAFRA_ERROR() << "Neighbour chunk query failed: " << reader->getLastErrorMessage();
+                ok = false;
+            }
+        }
+        
+        // Grow each hit's window outward over the chunks that exist, nearest first, within the token budget
+        std::vector<Window> grown(results.size(), Window{-1, -1, -1});
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& hit = results[i];
+            auto self = neighbours.find({hit.doc_id, hit.chunk_index});
+            if (hit.doc_id < 0 || self == neighbours.end()) {
+                continue;
+            }
+            int64_t tokens = self->second.tokens;
+            auto low = self;
+            auto high = self;
+            int added_before = 0;
+            int added_after = 0;
+            bool grow_before = before > 0;
+            bool grow_after = after > 0;
+            while (grow_before || grow_after) {
+                if (grow_before) {
+                    auto next = low;
+                    grow_before = next != neighbours.begin() && (--next)->first.first == hit.doc_id &&
+                                  next->first.second >= hit.chunk_index - before &&
+                                  (max_tokens <= 0 || tokens + next->second.tokens <= max_tokens);
+                    if (grow_before) {
+                        tokens += next->second.tokens;
+                        low = next;
+                        grow_before = ++added_before < before;
+                    }
+                }
+                if (grow_after) {
+                    auto next = std::next(high);
+                    grow_after = next != neighbours.end() && next->first.first == hit.doc_id &&
+                                 next->first.second <= hit.chunk_index + after &&
+                                 (max_tokens <= 0 || tokens + next->second.tokens <= max_tokens);
+                    if (grow_after) {
+                        tokens += next->second.tokens;
+                        high = next;
+                        grow_after = ++added_after < after;
+                    }
+                }
+            }
+            grown[i] = Window{hit.doc_id, low->first.second, high->first.second};
+        }
+        
+        // Merge touching windows of a document; the best-ranked hit in a group carries the passage
+        std::vector<size_t> order;
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (grown[i].doc_id >= 0) {
+                order.push_back(i);
+            }
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return grown[a].doc_id != grown[b].doc_id ? grown[a].doc_id < grown[b].doc_id : grown[a].first < grown[b].first;
+        });
+        std::vector<char> absorbed(results.size(), 0);
+        for (size_t begin = 0; begin < order.size();) {
+            size_t head = order[begin];
+            int first = grown[head].first;
+            int last = grown[head].last;
+            size_t end = begin + 1;
+            while (end < order.size() && grown[order[end]].doc_id == grown[head].doc_id && grown[order[end]].first <= last + 1) {
+                last = std::max(last, grown[order[end]].last);
+                head = std::min(head, order[end]);
+                end++;
+            }
+            for (size_t i = begin; i < end; ++i) {
+                absorbed[order[i]] = order[i] != head;
+            }
+            
+            FaissIndex::SearchResult& passage = results[head];
+            auto chunk = neighbours.find({passage.doc_id, first});
+            std::string content = chunk->second.content;
+            int previous = first;
+            passage.page_number = chunk->second.page_number;
+            passage.chunk_index = first;
+            for (++chunk; chunk != neighbours.end() && chunk->first.first == passage.doc_id && chunk->first.second <= last; ++chunk) {
+                const std::string& next = chunk->second.content;
+                if (chunk->first.second == previous + 1) {
+                    content += next.substr(sharedOverlapLength(content, next));
+                } else {
+                    content += "\n\n";
+                    content += next;
+                }
+                previous = chunk->first.second;
+            }
+            passage.content = std::move(content);
+            begin = end;
+        }
+        
+        size_t kept = 0;
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (!absorbed[i]) {
+                if (kept != i) {
+                    results[kept] = std::move(results[i]);
+                }
+                kept++;
+            }
+        }
+        results.resize(kept);
+        return ok;
+    } //expandContext
+
+    /**
+     * @brief Resolve a search filter to the FAISS ids of the chunks it admits
+     * 
+     * One indexed query per block of doc ids (a single query without a doc id list); the ids
+     * come back ascending, so a single document's chunks stay a contiguous range for FAISS.
+     * 
+     * @param filter Filter to resolve
+     * @param faiss_ids Output FAISS ids, ascending and unique
+     * @return true if every query ran
+     */
+    bool resolveSearchFilter(const SearchFilter& filter, std::vector<int64_t>& faiss_ids) {
+        static constexpr size_t kMaxIdsPerQuery = 500;
+        
+        faiss_ids.clear();
+        SQLiteReadPool::Lease reader = read_pool_.acquire(database_.get());
+        std::string sql =
+            "SELECT c.chunk_faiss_id FROM chunks c JOIN docs d ON c.doc_id = d.id "
+            "WHERE c.chunk_faiss_id IS NOT NULL";
+        if (!filter.filename_glob.empty()) {
+            sql += " AND d.filename GLOB ?";
+        }
+        if (!filter.created_after.empty()) {
+            sql += " AND d.creation_date >= ?";
+        }
+        if (!filter.created_before.empty()) {
+            sql += " AND d.creation_date < ?";
+        }
+        if (filter.page_min >= 0) {
+            sql += " AND c.chunk_page_number >= ?";
+        }
+        if (filter.page_max >= 0) {
+            sql += " AND c.chunk_page_number <= ?";
+        }
+        
+        const size_t doc_count = filter.doc_ids.size();
+        for (size_t begin = 0; begin == 0 || begin < doc_count; begin += kMaxIdsPerQuery) {
+            size_t end = std::min(doc_count, begin + kMaxIdsPerQuery);
+            std::string block_sql = sql;
+            if (end > begin) {
+                block_sql += " AND c.doc_id IN (?";
+                for (size_t i = begin + 1; i < end; ++i) {
+                    block_sql += ",?";
+                }
+                block_sql += ")";
+            }
+            
+            auto stmt = reader->prepareCached(block_sql);
+            if (!stmt || !stmt->isValid()) {
+                LEAFRA_ERROR() << "Failed to prepare search filter query";
+                return false;
+            }
+            int index = 1;
+            if (!filter.filename_glob.empty()) {
+                stmt->bindText(index++, filter.filename_glob);
+            }
+            if (!filter.created_after.empty()) {
+                stmt->bindText(index++, filter.created_after);
+            }
+            if (!filter.created_before.empty()) {
+                stmt->bindText(index++, filter.created_before);
+            }
+            if (filter.page_min >= 0) {
+                stmt->bindInt(index++, filter.page_min);
+            }
+            if (filter.page_max >= 0) {
+                stmt->bindInt(index++, filter.page_max);
+            }
+            for (size_t i = begin; i < end; ++i) {
+                stmt->bindInt64(index++, filter.doc_ids[i]);
+            }
+            
+            bool stepped = stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+                faiss_ids.push_back(row.getInt64(0));
+                return true;
+            });
+            if (!stepped) {
+                LEAFRA_ERROR() << "Search filter query failed: " << reader->getLastErrorMessage();
+                return false;
+            }
+            if (end >= doc_count) {
+                break;
+            }
+        }
+        
+        std::sort(faiss_ids.begin(), faiss_ids.end());
+        faiss_ids.erase(std::unique(faiss_ids.begin(), faiss_ids.end()), faiss_ids.end());
+        return true;
+    } //resolveSearchFilter
+
+    /**
+     * @brief Re-score candidates exactly against their stored embeddings and keep the best k per query
+     * 
+     * Lossy indexes (IVF_PQ, SQ8, SQ_FP16, HNSW_SQ, BINARY) are searched for more than k candidates (see rerankCandidates);
+     * this restores the exact metric order among them. A query with a candidate missing from
+     * chunk_embeddings keeps its FAISS order.
+     * 
+     * @param queries Query vectors as searched (query_count = hits.size(), dimension floats each)
+     * @param k Results to keep per query
+     * @param hits Candidate lists per query, re-ordered and truncated in place
+     */
+    void rerankSearchResults(const float* queries, int k, std::vector<std::vector<FaissIndex::SearchResult>>& hits) {
+        static constexpr size_t kMaxIdsPerQuery = 500;
+        const size_t dimension = static_cast<size_t>(config_.vector_search.dimension);
+        const std::string& metric = config_.vector_search.metric;
+        
+        std::vector<int64_t> ids;
+        for (const auto& query_hits : hits) {
+            for (const auto& hit : query_hits) {
+                ids.push_back(hit.id);
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        
+        // Decoded candidates, row per id (unit length for COSINE so the dot product is the similarity)
+        std::unordered_map<int64_t, size_t> row_by_id;
+        std::vector<float> rows;
+        rows.reserve(ids.size() * dimension);
+        SQLiteReadPool::Lease reader = read_pool_.acquire(database_.get());
+        for (size_t begin = 0; begin < ids.size(); begin += kMaxIdsPerQuery) {
+            size_t end = std::min(ids.size(), begin + kMaxIdsPerQuery);
+            std::string sql = "SELECT chunk_faiss_id, format, byte_order, dimension, scale, embedding FROM chunk_embeddings "
+                              "WHERE chunk_faiss_id IN (?";
+            for (size_t i = begin + 1; i < end; ++i) {
+                sql += ",?";
+            }
+            sql += ")";
+            auto stmt = reader->prepareCached(sql);
+            if (!stmt || !stmt->isValid()) {
+                LEAFRA_WARNING() << "Failed to prepare embedding lookup, keeping FAISS ranking";
+                break;
+            }
+            for (size_t i = begin; i < end; ++i) {
+                stmt->bindInt64(static_cast<int>(i - begin + 1), ids[i]);
+            }
+            stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+                SQLiteDatabase::BlobView blob = row.getBlobView(5);
+                size_t offset = rows.size();
+                rows.resize(offset + dimension);
+                if (static_cast<size_t>(row.getInt(3)) != dimension ||
+                    !VectorCodec::decode(static_cast<EmbeddingStorageFormat>(row.getInt(1)), static_cast<ByteOrder>(row.getInt(2)),
+                                         static_cast<float>(row.getDouble(4)), blob.data, blob.size, rows.data() + offset, dimension)) {
+                    rows.resize(offset);
+                    return true;
+                }
+                if (metric == "COSINE") {
+                    simd::l2_normalize(rows.data() + offset, dimension);
+                }
+                row_by_id.emplace(row.getInt64(0), offset);
+                return true;
+            });
+        }
+        
+        std::vector<float> unit_query(dimension);
+        std::vector<const float*> candidates;
+        std::vector<float> scores;
+        std::vector<uint32_t> order;
+        size_t reranked = 0;
+        for (size_t q = 0; q < hits.size(); ++q) {
+            auto& query_hits = hits[q];
+            const float* query = queries + q * dimension;
+            bool complete = std::all_of(query_hits.begin(), query_hits.end(), [&](const FaissIndex::SearchResult& hit) {
+                return row_by_id.count(hit.id) > 0;
+            });
+            if (complete && !query_hits.empty()) {
+                if (metric == "COSINE") {
+                    simd::l2_normalize(query, unit_query.data(), dimension);
+                    query = unit_query.data();
+                }
+                candidates.clear();
+                for (const auto& hit : query_hits) {
+                    candidates.push_back(rows.data() + row_by_id[hit.id]);
+                }
+                scores.resize(candidates.size());
+                if (metric == "L2") {
+                    simd::squared_l2_batch(query, candidates.data(), candidates.size(), dimension, scores.data());
+                } else {
+                    simd::dot_batch(query, candidates.data(), candidates.size(), dimension, scores.data());
+                }
+                // L2 distances ascend, similarities descend - same orientation FAISS reports them in
+                simd::top_k(scores.data(), scores.size(), static_cast<size_t>(k), metric != "L2", order);
+                std::vector<FaissIndex::SearchResult> best;
+                best.reserve(order.size());
+                for (uint32_t index : order) {
+                    best.push_back(std::move(query_hits[index]));
+                    best.back().distance = scores[index];
+                }
+                query_hits = std::move(best);
+                reranked++;
+            }
+            if (query_hits.size() > static_cast<size_t>(k)) {
+                query_hits.resize(static_cast<size_t>(k));
+            }
+        }
+        LEAFRA_DEBUG() << "Re-ranked " << reranked << "/" << hits.size() << " queries against " << row_by_id.size()
+                       << " stored embeddings";
+    } //rerankSearchResults
+    
+    /**
+     * @brief Whether a filtered search over this many chunks is scored in SQL (vector_search.exact_scan_max_chunks)
+     * 
+     * Needs stored embeddings, and no collection of another embedding model: the scan reads
+     * chunk_embeddings directly, which doesn't know which indexes are stale.
+     */
+    bool exactScanFits(size_t chunk_count) const {
+        const int32_t limit = config_.vector_search.exact_scan_max_chunks;
+        if (limit <= 0 || chunk_count > static_cast<size_t>(limit) || embedding_storage_format_ == EmbeddingStorageFormat::NONE ||
+            !database_ || !database_->isOpen()) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+        return std::none_of(faiss_collections_.begin(), faiss_collections_.end(), [](const auto& entry) {
+            return entry.second.stale;
+        });
+    }
+    
+    /**
+     * @brief Exact k-NN over the chunks a filter admits, scored by vec_dot/vec_l2/vec_cosine inside SQLite
+     * 
+     * One ORDER BY ... LIMIT k query per block of ids; the blocks' best are merged. Scores are
+     * oriented like FAISS reports them for the metric (COSINE = cosine similarity), so later
+     * stages can't tell the hits apart from index hits.
+     * 
+     * @param query Query embedding (vector_search.dimension floats)
+     * @param k Results to return
+     * @param faiss_ids Admitted chunk ids
+     * @param hits Output hits, best first
+     * @return false if a query failed (the caller searches the index instead)
+     */
+    bool exactFilteredSearch(const float* query, int k, const std::vector<int64_t>& faiss_ids,
+                             std::vector<FaissIndex::SearchResult>& hits) {
+        static constexpr size_t kMaxIdsPerQuery = 500;
+        const std::string& metric = config_.vector_search.metric;
+        const bool higher_is_better = metric != "L2";
+        const char* function = metric == "L2" ? "vec_l2" : metric == "COSINE" ? "vec_cosine" : "vec_dot";
+        const size_t query_bytes = static_cast<size_t>(config_.vector_search.dimension) * sizeof(float);
+        
+        hits.clear();
+        SQLiteReadPool::Lease reader = read_pool_.acquire(database_.get());
+        for (size_t begin = 0; begin < faiss_ids.size(); begin += kMaxIdsPerQuery) {
+            size_t end = std::min(faiss_ids.size(), begin + kMaxIdsPerQuery);
+            std::string sql = std::string("SELECT chunk_faiss_id, ") + function + "(embedding, format, byte_order, scale, ?) AS score "
+                              "FROM chunk_embeddings WHERE chunk_faiss_id IN (?";
+            for (size_t i = begin + 1; i < end; ++i) {
+                sql += ",?";
+            }
+            sql += higher_is_better ? ") AND score IS NOT NULL ORDER BY score DESC LIMIT ?" : ") AND score IS NOT NULL ORDER BY score LIMIT ?";
+            auto stmt = reader->prepareCached(sql);
+            if (!stmt || !stmt->isValid() || !stmt->bindBlobView(1, query, query_bytes)) {
+                LEAFRA_WARNING() << "Failed to prepare exact filtered search, searching the index";
+                return false;
+            }
+            int index = 2;
+            for (size_t i = begin; i < end; ++i) {
+                stmt->bindInt64(index++, faiss_ids[i]);
+            }
+            stmt->bindInt(index, k);
+            bool stepped = stmt->forEachRow([&hits](const SQLiteDatabase::Row& row) {
+                FaissIndex::SearchResult hit;
+                hit.id = row.getInt64(0);
+                hit.distance = static_cast<float>(row.getDouble(1));
+                hits.push_back(std::move(hit));
+                return true;
+            });
+            if (!stepped) {
+                LEAFRA_WARNING() << "Exact filtered search failed: " << reader->getLastErrorMessage() << " - searching the index";
+                return false;
+            }
+        }
+        
+        std::stable_sort(hits.begin(), hits.end(), [higher_is_better](const FaissIndex::SearchResult& a, const FaissIndex::SearchResult& b) {
+            return higher_is_better ? a.distance > b.distance : a.distance < b.distance;
+        });
+        if (hits.size() > static_cast<size_t>(k)) {
+            hits.resize(static_cast<size_t>(k));
+        }
+        LEAFRA_DEBUG() << "Exact filtered search scored " << faiss_ids.size() << " chunks in SQLite";
+        return true;
+    } //exactFilteredSearch
+
+    /**
+     * @brief Rank chunks against the FTS5 keyword index by BM25
+     * @param query Free-form query text
+     * @param max_results Maximum number of hits
+     * @param results Output hits in rank order with chunk metadata; distance holds the BM25 score (lower is better)
+     * @return true if the query ran (a query with no searchable words returns no hits)
+     */
+    bool keywordSearch(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results) {
+        results.clear();
+        const std::string expression = build_keyword_match_expression(query);
+        if (expression.empty()) {
+            return true;
+        }
+        SQLiteReadPool::Lease reader = read_pool_.acquire(database_.get());
+        
+        auto stmt = reader->prepareCached(std::string(
+            "SELECT c.chunk_faiss_id, c.doc_id, c.chunk_no, "
+            "CASE WHEN c.chunk_start IS NULL THEN c.chunk_text ELSE leafra_chunk_text(c.chunk_text, c.doc_id, c.chunk_start, c.chunk_end) END, "
+            "c.chunk_page_number, d.filename, bm25(chunks_fts), ") + kChunkOffsetColumns + " "
+            "FROM chunks_fts "
+            "JOIN chunks c ON c.id = chunks_fts.rowid "
+            "JOIN docs d ON c.doc_id = d.id "
+            "WHERE chunks_fts MATCH ? "
+            "ORDER BY bm25(chunks_fts) "
+            "LIMIT ?"
+        );
+        if (!stmt || !stmt->isValid()) {
+            LEAFRA_ERROR() << "Failed to prepare keyword search query";
+            return false;
+        }
+        stmt->bindText(1, expression);
+        stmt->bindInt(2, max_results);
+        
+        bool stepped = stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+            FaissIndex::SearchResult hit(row.isNull(0) ? -1 : row.getInt64(0), static_cast<float>(row.getDouble(6)));
+            hit.doc_id = row.getInt64(1);
+            hit.chunk_index = row.getInt(2);
+            readChunkText(row, 3, hit.content);
+            hit.page_number = row.getInt(4);
+            hit.filename.assign(row.getTextView(5));
+            readChunkOffsets(row, 7, hit);
+            results.push_back(std::move(hit));
+            return true;
+        });
+        if (!stepped) {
+            LEAFRA_ERROR() << "Keyword search query failed: " << reader->getLastErrorMessage();
+            return false;
+        }
+        return true;
+    } //keywordSearch
+#endif
+#endif
+
+    /**
+     * @brief Embed a search query without going through the document chunker
+     * 
+     * Tokenizes the (prefixed) query straight into a reused buffer and runs one
+     * single-row inference in the smallest sequence bucket that fits it.
+     * 
+     * @param query Query text
+     * @param embedding Output embedding
+     * @param stats If set, the tokenize / embed time and cache hit are added to it
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode embedQuery(const std::string& query, std::vector<float>& embedding, QueryStats* stats = nullptr) {
+        ModelUse model_use(model_swap_mutex_);
+        if (!hasEmbeddingModel()) {
+            LEAFRA_ERROR() << "Embedding model not available";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        
+        auto start_time = debug::timer::now();
+        
+        const std::string prefix = queryPrefix();
+        std::string cache_key;
+        if (config_.search_cache.enabled) {
+            cache_key = makeQueryCacheKey(query, prefix);
+            std::lock_guard<std::mutex> lock(query_mutex_);
+            if (const auto* cached = query_embedding_cache_.get(cache_key)) {
+                embedding = *cached;
+                if (stats) {
+                    stats->embedding_cache_hit = true;
+                }
+                LEAFRA_DEBUG() << "Query embedding served from cache";
+                return ResultCode::SUCCESS;
+            }
+        }
+        
+        if (query_embed_batcher_) {
+            double tokenize_ms = 0.0;
+            ResultCode batched = embedQueryBatched(prefix + query, embedding, tokenize_ms);
+            if (batched != ResultCode::SUCCESS) {
+                return batched;
+            }
+            if (config_.search_cache.enabled) {
+                std::lock_guard<std::mutex> lock(query_mutex_);
+                query_embedding_cache_.put(cache_key, embedding);
+            }
+            if (stats) {
+                double duration_ms = debug::timer::elapsed_milliseconds(start_time, debug::timer::now());
+                stats->tokenize_ms += tokenize_ms;
+                stats->embed_ms += duration_ms - tokenize_ms;   // Includes the wait for the batch
+            }
+            return ResultCode::SUCCESS;
+        }
+        
+        AdmissionController::Permit permit(admission_, AdmissionResource::EMBEDDER, AdmissionLane::INTERACTIVE);
+        if (!permit.admitted()) {
+            LEAFRA_WARNING() << "Too many queries waiting for the embedding model";
+            return ResultCode::ERROR_BUSY;
+        }
+        PipelineMetricsRecorder::ScopedStage timing(metrics_, PipelineStage::QUERY_EMBED);
+        
+        // Per-thread buffers, so concurrent searches tokenize in parallel without allocating
+        thread_local std::string query_text;
+        thread_local std::vector<int> query_token_ids;
+        query_text.assign(prefix);
+        query_text += query;
+        query_token_ids.clear();
+        
+        bool embedded = false;
+        double tokenize_ms = 0.0;
+        EmbeddingScheduler& scheduler = queryScheduler();
+        if (scheduler.backend().requiresTokenIds()) {
+            if (!tokenizer_ || !tokenizer_->is_loaded()) {
+                LEAFRA_ERROR() << "SentencePiece tokenizer not available";
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+            const auto tokenize_start = debug::timer::now();
+            if (!tokenizer_->encode_as_ids(query_text, query_token_ids, SentencePieceTokenizer::TokenizeOptions()) || query_token_ids.empty()) {
+                LEAFRA_ERROR() << "SentencePiece tokenization failed for query: " << tokenizer_->get_last_error();
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            tokenize_ms = debug::timer::elapsed_milliseconds(tokenize_start, debug::timer::now());
+            embedded = scheduler.embed_tokens(query_token_ids, embedding);
+        } else {
+            embedded = scheduler.embed_text(query_text, embedding);
+        }
+        
+        if (!embedded) {
+            LEAFRA_ERROR() << "No embedding generated for query";
+            timing.cancel();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        timing.finish();
+        
+        if (config_.search_cache.enabled) {
+            std::lock_guard<std::mutex> lock(query_mutex_);
+            query_embedding_cache_.put(cache_key, embedding);
+        }
+        
+        double duration_ms = debug::timer::elapsed_milliseconds(start_time, debug::timer::now());
+        if (stats) {
+            stats->tokenize_ms += tokenize_ms;
+            stats->embed_ms += duration_ms - tokenize_ms;   // Includes any wait for an embedder slot
+        }
+        LEAFRA_DEBUG_LOG("TIMING", "Query embedding (" + std::to_string(query_token_ids.size()) + " tokens): " + std::to_string(duration_ms) + "ms");
+        return ResultCode::SUCCESS;
+    } //embedQuery
+    
+    /**
+     * @brief Embed one query in a batch with the queries of concurrent searches (query_embed_batcher_)
+     * 
+     * The calling thread tokenizes; the batch as a whole takes one embedder permit and runs
+     * one Interactive inference.
+     * 
+     * @param query_text Prefixed query
+     * @param embedding Output embedding
+     * @param tokenize_ms Output time spent tokenizing
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode embedQueryBatched(const std::string& query_text, std::vector<float>& embedding, double& tokenize_ms) {
+        QueryEmbedRequest request;
+        request.text = query_text;
+        if (queryScheduler().backend().requiresTokenIds()) {
+            if (!tokenizer_ || !tokenizer_->is_loaded()) {
+                LEAFRA_ERROR() << "SentencePiece tokenizer not available";
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+            const auto tokenize_start = debug::timer::now();
+            if (!tokenizer_->encode_as_ids(request.text, request.token_ids, SentencePieceTokenizer::TokenizeOptions()) ||
+                request.token_ids.empty()) {
+                LEAFRA_ERROR() << "SentencePiece tokenization failed for query: " << tokenizer_->get_last_error();
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            tokenize_ms = debug::timer::elapsed_milliseconds(tokenize_start, debug::timer::now());
+        }
+        
+        QueryEmbedResult result = query_embed_batcher_->submit(std::move(request));
+        if (result.code != ResultCode::SUCCESS) {
+            return result.code;
+        }
+        embedding = std::move(result.embedding);
+        return ResultCode::SUCCESS;
+    }
+    
+    /**
+     * @brief Run one batch of query_embed_batcher_: one inference for every query that joined it
+     */
+    void runQueryEmbedBatch(std::vector<QueryEmbedRequest>& requests, std::vector<QueryEmbedResult>& results) {
+        AdmissionController::Permit permit(admission_, AdmissionResource::EMBEDDER, AdmissionLane::INTERACTIVE);
+        if (!permit.admitted()) {
+            LEAFRA_WARNING() << "Too many queries waiting for the embedding model";
+            for (QueryEmbedResult& result : results) {
+                result.code = ResultCode::ERROR_BUSY;
+            }
+            return;
+        }
+        PipelineMetricsRecorder::ScopedStage timing(metrics_, PipelineStage::QUERY_EMBED);
+        timing.set_items(requests.size());
+        
+        // Chunks only hold views into the request texts, which outlive them
+        std::vector<TextChunk> chunks(requests.size());
+        for (size_t i = 0; i < requests.size(); ++i) {
+            chunks[i].content = requests[i].text;
+            chunks[i].token_ids = std::move(requests[i].token_ids);
+        }
+        queryScheduler().embed_chunks(chunks, EmbeddingScheduler::Priority::Interactive);
+        
+        size_t embedded = 0;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            if (!chunks[i].has_embedding()) {
+                LEAFRA_ERROR() << "No embedding generated for query";
+                continue;
+            }
+            results[i].code = ResultCode::SUCCESS;
+            results[i].embedding = std::move(chunks[i].embedding);
+            embedded++;
+        }
+        if (embedded == 0) {
+            timing.cancel();
+            return;
+        }
+        timing.finish();
+        if (requests.size() > 1) {
+            LEAFRA_DEBUG() << "Embedded " << requests.size() << " concurrent queries in one batch";
+        }
+    } //runQueryEmbedBatch
+
+    /**
+     * @brief Embed several search queries with one batched inference
+     * 
+     * Cached queries are served from the query embedding cache; the rest are tokenized
+     * and go through the scheduler together, batched per sequence bucket.
+     * 
+     * @param queries Query texts
+     * @param embeddings Output embedding per query (empty for a query that failed to embed)
+     * @param passages Embed the texts as document passages instead (passage prefix, never cached)
+     * @return ResultCode indicating success, or failure if no query could be embedded
+     */
+    ResultCode embedQueries(const std::vector<std::string>& queries, std::vector<std::vector<float>>& embeddings,
+                            bool passages = false) {
+        ModelUse model_use(model_swap_mutex_);
+        if (!hasEmbeddingModel()) {
+            LEAFRA_ERROR() << "Embedding model not available";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        
+        auto start_time = debug::timer::now();
+        
+        embeddings.assign(queries.size(), std::vector<float>());
+        const std::string prefix = passages ? passagePrefix() : queryPrefix();
+        const bool use_cache = config_.search_cache.enabled && !passages;
+        EmbeddingScheduler& scheduler = queryScheduler();
+        const bool needs_tokens = scheduler.backend().requiresTokenIds();
+        if (needs_tokens && (!tokenizer_ || !tokenizer_->is_loaded())) {
+            LEAFRA_ERROR() << "SentencePiece tokenizer not available";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        
+        // Query texts must outlive the chunks, which only hold views into them
+        std::vector<std::string> cache_keys(queries.size());
+        std::vector<std::string> texts;
+        std::vector<size_t> query_indices;
+        texts.reserve(queries.size());
+        query_indices.reserve(queries.size());
+        {
+            std::lock_guard<std::mutex> lock(query_mutex_);
+            for (size_t i = 0; i < queries.size(); ++i) {
+                if (use_cache) {
+                    cache_keys[i] = makeQueryCacheKey(queries[i], prefix);
+                    if (const auto* cached = query_embedding_cache_.get(cache_keys[i])) {
+                        embeddings[i] = *cached;
+                        continue;
+                    }
+                }
+                texts.push_back(prefix + queries[i]);
+                query_indices.push_back(i);
+            }
+        }
+        
+        PipelineMetricsRecorder::ScopedStage timing(metrics_, PipelineStage::QUERY_EMBED);
+        timing.set_items(texts.size());
+        if (texts.empty()) {
+            timing.cancel();   // All served from the cache
+        }
+        std::vector<TextChunk> chunks(texts.size());
+        for (size_t row = 0; row < texts.size(); ++row) {
+            chunks[row].content = texts[row];
+            if (needs_tokens && !tokenizer_->encode_as_ids(texts[row], chunks[row].token_ids, SentencePieceTokenizer::TokenizeOptions())) {
+                LEAFRA_WARNING() << "SentencePiece tokenization failed for query " << (query_indices[row] + 1) << ": " << tokenizer_->get_last_error();
+            }
+        }
+        if (!chunks.empty()) {
+            scheduler.embed_chunks(chunks, EmbeddingScheduler::Priority::Interactive);
+        }
+        timing.finish();
+        
+        size_t embedded = queries.size() - chunks.size();
+        for (size_t row = 0; row < chunks.size(); ++row) {
+            if (!chunks[row].has_embedding()) {
+                LEAFRA_WARNING() << "No embedding generated for query " << (query_indices[row] + 1);
+                continue;
+            }
+            size_t index = query_indices[row];
+            embeddings[index] = std::move(chunks[row].embedding);
+            if (use_cache) {
+                std::lock_guard<std::mutex> lock(query_mutex_);
+                query_embedding_cache_.put(cache_keys[index], embeddings[index]);
+            }
+            embedded++;
+        }
+        
+        double duration_ms = debug::timer::elapsed_milliseconds(start_time, debug::timer::now());
+        LEAFRA_DEBUG_LOG("TIMING", "Batched query embedding (" + std::to_string(chunks.size()) + " of " + std::to_string(queries.size()) +
+                         " queries inferred): " + std::to_string(duration_ms) + "ms");
+        if (embedded == 0) {
+            LEAFRA_ERROR() << "No embeddings generated for " << queries.size() << " queries";
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        return ResultCode::SUCCESS;
+    } //embedQueries
+
+    /**
+     * @brief Process chunks with SentencePiece tokenization for accurate token counting
+     * @param chunks Vector of text chunks to process (estimated_tokens replaced with actual counts)
+     * @param tokens Receives one token ID row per chunk
+     * @return Pair of (total_actual_tokens, using_sentencepiece_flag)
+     */
+    std::pair<size_t, bool> processChunksWithSentencePieceTokenization(std::vector<TextChunk>& chunks, TokenIdBatch& tokens,
+                                                                       const std::string& prefix) {
+        size_t total_actual_tokens = 0;
+        bool using_sentencepiece = false;
+        tokens.clear();
+        
+        if (!config_.tokenizer.enabled || !tokenizer_ || !tokenizer_->is_loaded()) {
+            LEAFRA_WARNING() << "SentencePiece requested but not available, using estimates";
+            return {total_actual_tokens, using_sentencepiece};
+        }
+        
+        using_sentencepiece = true;
+        LEAFRA_DEBUG() << "Using SentencePiece for accurate token counting";
+        
+        // EXACT_TOKENS chunks already hold their slice of the document's tokens; they only
+        // need the [BOS] prefix ... [EOS] wrapper a full encode would have produced
+        std::vector<int> wrapper_ids;
+        
+        // The rest are encoded as one batch across the worker pool
+        std::vector<size_t> batch_chunks;
+        std::vector<std::string_view> batch_texts;
+        
+        for (size_t chunk_idx = 0; chunk_idx < chunks.size(); ++chunk_idx) {
+            auto& chunk = chunks[chunk_idx];
+            
+            if (chunk.has_token_ids()) {
+                if (wrapper_ids.empty()) {
+                    wrapper_ids = tokenizer_->encode_as_ids(prefix, SentencePieceTokenizer::TokenizeOptions());
+                }
+                if (!wrapper_ids.empty()) {
+                    continue;
+                }
+            }
+            batch_chunks.push_back(chunk_idx);
+            batch_texts.push_back(chunk.content);
+        }
+        
+        // "passage: " or "query: " prefix for multilingual-e5-small model per 
+        // https://huggingface.co/intfloat/multilingual-e5-small 
+        thread_local SentencePieceTokenizer::IdBatch id_batch;
+        id_batch.clear();
+        if (!batch_texts.empty()) {
+            TaskSubmitFunction submit_task;
+            if (worker_pool_) {
+                submit_task = [this](std::function<void()> task) {
+                    return worker_pool_->submit(std::move(task));
+                };
+            }
+            // The prefix ends at a word boundary, so its IDs are encoded once and spliced ahead of each chunk's
+            SentencePieceTokenizer::TokenizeOptions batch_options;
+            batch_options.splice_prefix = true;
+            if (!tokenizer_->encode_batch_as_ids(batch_texts, prefix, id_batch, submit_task, batch_options)) {
+                LEAFRA_WARNING() << "SentencePiece batch encoding failed: " << tokenizer_->get_last_error();
+            }
+        }
+        
+        // Lay the rows out in chunk order in the document's flat token buffer
+        if (batch_chunks.size() == chunks.size() && id_batch.size() == chunks.size()) {
+            std::swap(tokens, id_batch);
+        } else {
+            size_t next_batch_row = 0;
+            for (size_t chunk_idx = 0; chunk_idx < chunks.size(); ++chunk_idx) {
+                const auto& chunk = chunks[chunk_idx];
+                if (next_batch_row < batch_chunks.size() && batch_chunks[next_batch_row] == chunk_idx) {
+                    if (next_batch_row < id_batch.size()) {
+                        tokens.ids.insert(tokens.ids.end(), id_batch.begin(next_batch_row), id_batch.end(next_batch_row));
+                    }
+                    next_batch_row++;
+                } else {
+                    tokens.ids.insert(tokens.ids.end(), wrapper_ids.begin(), wrapper_ids.end() - 1);
+                    tokens.ids.insert(tokens.ids.end(), chunk.token_ids.begin(), chunk.token_ids.end());
+                    tokens.ids.push_back(wrapper_ids.back());
+                }
+                tokens.end_sequence();
+            }
+        }
+        
+        for (size_t chunk_idx = 0; chunk_idx < chunks.size(); ++chunk_idx) {
+            auto& chunk = chunks[chunk_idx];
+            chunk.estimated_tokens = tokens.length(chunk_idx);      // Replace estimate with actual count
+            total_actual_tokens += chunk.estimated_tokens;
+            
+            // Debug log for first few chunks
+            if (config_.debug_mode && chunk_idx < 3) {
+                size_t chunk_chars = prefix.size() + chunk.content.size();
+                LEAFRA_DEBUG() << "Chunk " << (chunk_idx + 1) 
+                             << " - Characters: " << chunk_chars 
+                             << ", Actual tokens: " << chunk.estimated_tokens
+                             << ", Chars/token ratio: " << (chunk.estimated_tokens > 0 ? static_cast<double>(chunk_chars) / chunk.estimated_tokens : 0.0);
+            }
+        }
+        
+        LEAFRA_INFO() << "✅ SentencePiece tokenization completed";
+        LEAFRA_INFO() << "  - Total actual tokens: " << total_actual_tokens;
+        LEAFRA_INFO() << "  - Chunks with token IDs: " << tokens.size();
+        LEAFRA_DEBUG() << "✅ Token IDs stored for all " << tokens.size() << " chunks";
+        
+        return {total_actual_tokens, using_sentencepiece};
+    } //processChunksWithSentencePieceTokenization
+ 
+#ifdef LEAFRA_HAS_SQLITE
+    /**
+     * @brief Check if document exists and delete it if found
+     * @param filename Document filename
+     * @param absolute_path Absolute path to the document
+     * @param replacing The document is about to be stored again (false: its file was deleted)
+     * @return true if successful (document didn't exist or was successfully deleted), false on error
+     */
+    bool handleExistingDocument(const std::string& filename, const std::string& absolute_path, bool replacing = true) {
+        if (!database_ || !database_->isOpen()) {
+            return false;
+        }
+        
+        auto checkStmt = database_->prepareCached("SELECT id, collection FROM docs WHERE filename = ? AND url = ?");
+        if (!checkStmt || !checkStmt->isValid()) {
+            LEAFRA_ERROR() << "Failed to prepare document existence check statement";
+            return false;
+        }
+        
+        checkStmt->bindText(1, filename);
+        checkStmt->bindText(2, absolute_path);
+        
+        if (checkStmt->step()) {
+            long long existing_doc_id = checkStmt->getCurrentRow().getInt64(0);
+            std::string existing_collection(checkStmt->getCurrentRow().getTextView(1));
+            LEAFRA_INFO() << "Document already exists in database: " << filename << " (ID: " << existing_doc_id << ")";
+            
+#ifdef LEAFRA_HAS_FAISS
+            // First, collect FAISS IDs of chunks that will be deleted (for FAISS cleanup)
+            // IVF/HNSW indexes only tombstone them; compactFaissIndex purges once enough have piled up
+            std::vector<int64_t> faiss_ids_to_remove;
+            FaissCollection* faiss_collection = nullptr;
+            if (!faiss_collections_.empty() && openFaissCollection(existing_collection, faiss_collection) == ResultCode::SUCCESS) {
+                auto collectFaissIdsStmt = database_->prepareCached("SELECT chunk_faiss_id FROM chunks WHERE doc_id = ? AND chunk_faiss_id IS NOT NULL");
+                if (collectFaissIdsStmt && collectFaissIdsStmt->isValid()) {
+                    collectFaissIdsStmt->bindInt64(1, existing_doc_id);
+                    while (collectFaissIdsStmt->step()) {
+                        int64_t faiss_id = collectFaissIdsStmt->getCurrentRow().getInt64(0);
+                        faiss_ids_to_remove.push_back(faiss_id);
+                    }
+                    LEAFRA_INFO() << "Found " << faiss_ids_to_remove.size() << " FAISS vectors to remove for document: " << filename;
+                }
+            }
+#endif
+            
+            // Delete existing chunks first (due to foreign key constraint)
+            auto deleteChunksStmt = database_->prepareCached("DELETE FROM chunks WHERE doc_id = ?");
+            if (!deleteChunksStmt || !deleteChunksStmt->isValid()) {
+                LEAFRA_ERROR() << "Failed to prepare chunk deletion statement";
+                return false;
+            }
+            
+            deleteChunksStmt->bindInt64(1, existing_doc_id);
+            if (deleteChunksStmt->execute()) {
+                int deleted_chunks = database_->getChanges();
+                invalidateCachedAnswers(existing_doc_id);
+                LEAFRA_INFO() << "Deleted " << deleted_chunks << " existing chunks for document: " << filename;
+                
+#ifdef LEAFRA_HAS_FAISS
+                // Remove vectors from FAISS index
+                if (faiss_collection && !faiss_ids_to_remove.empty()) {
+                    // With a hot tier, removed rows are dropped from it instead; a merge in flight finishes first
+                    std::unique_lock<std::mutex> merge_lock(faiss_merge_mutex_, std::defer_lock);
+                    if (config_.vector_search.hot_index) {
+                        merge_lock.lock();
+                        removeHotVectors(*faiss_collection, faiss_ids_to_remove);
+                    } else {
+                        flushPendingFaissVectors(*faiss_collection);
+                    }
+                    ResultCode result = faiss_collection->index->remove_vectors(faiss_ids_to_remove.data(), faiss_ids_to_remove.size());
+                    if (result == ResultCode::SUCCESS) {
+                        LEAFRA_INFO() << "Removed " << faiss_ids_to_remove.size() << " vectors from FAISS index for document: " << filename;
+                        // Tombstones join the document transaction, so removal and re-insert persist together
+                        if (faiss_collection->index->append_removals_to_db(*database_, faiss_collection->definition, faiss_ids_to_remove.data(),
+                                                                           static_cast<int>(faiss_ids_to_remove.size())) != ResultCode::SUCCESS) {
+                            LEAFRA_WARNING() << "Failed to persist FAISS removals for document: " << filename;
+                        }
+                    } else {
+                        LEAFRA_ERROR() << "Failed to remove vectors from FAISS index for document: " << filename;
+                        // Don't return false here - database cleanup succeeded, FAISS cleanup failed but we can continue
+                    }
+                }
+#endif
+            } else {
+                LEAFRA_ERROR() << "Failed to delete existing chunks for document: " << filename;
+                return false;
+            }
+            
+            // Delete the document record
+            auto deleteDocStmt = database_->prepareCached("DELETE FROM docs WHERE id = ?");
+            if (!deleteDocStmt || !deleteDocStmt->isValid()) {
+                LEAFRA_ERROR() << "Failed to prepare document deletion statement";
+                return false;
+            }
+            
+            deleteDocStmt->bindInt64(1, existing_doc_id);
+            if (deleteDocStmt->execute()) {
+                LEAFRA_INFO() << "Deleted existing document: " << filename << " (ID: " << existing_doc_id << ")";
+#ifdef LEAFRA_HAS_FAISS
+                {
+                    std::lock_guard<std::mutex> lock(document_index_mutex_);
+                    const int64_t document_label = existing_doc_id;
+                    if (document_index_) {
+                        document_index_->remove_vectors(&document_label, 1);
+                    }
+                }
+#endif
+                send_event(EventType::INGESTION_PROGRESS, (replacing ? "🗑️ Replaced existing document: " : "🗑️ Removed deleted document: ") + filename,
+                           absolute_path);
+            } else {
+                LEAFRA_ERROR() << "Failed to delete existing document: " << filename;
+                return false;
+            }
+        }
+        
+        return true; // Success: either document didn't exist or was successfully deleted
+    } //handleExistingDocument
+
+    /**
+     * @brief Snapshot the change-detection fingerprint of every stored document
+     * 
+     * Taken once per ingestion run so the parallel prepare workers can skip unchanged
+     * files without touching the (single-threaded) database connection.
+     */
+    StoredDocumentMap loadStoredDocuments() {
+        StoredDocumentMap stored;
+        if (!database_ || !database_->isOpen()) {
+            return stored;
+        }
+        auto stmt = database_->prepareCached("SELECT id, url, file_size, file_mtime, content_hash, collection FROM docs");
+        if (!stmt || !stmt->isValid()) {
+            LEAFRA_WARNING() << "Failed to load stored document fingerprints - every file will be re-indexed";
+            return stored;
+        }
+        stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+            DocumentFingerprint fingerprint;
+            fingerprint.doc_id = row.getInt64(0);
+            fingerprint.absolute_path.assign(row.getTextView(1));
+            fingerprint.file_size = row.isNull(2) ? -1 : row.getInt64(2);
+            fingerprint.file_mtime = row.getInt64(3);
+            fingerprint.content_hash.assign(row.getTextView(4));
+            fingerprint.collection.assign(row.getTextView(5));
+            stored[fingerprint.absolute_path] = std::move(fingerprint);
+            return true;
+        });
+        return stored;
+    } //loadStoredDocuments
+
+    /**
+     * @brief Record a new size/mtime for a stored document whose bytes didn't change
+     */
+    void touchStoredDocument(const DocumentFingerprint& fingerprint) {
+        auto stmt = database_->prepareCached("UPDATE docs SET file_size = ?, file_mtime = ?, content_hash = ? WHERE id = ?");
+        if (!stmt || !stmt->isValid()) {
+            return;
+        }
+        stmt->bindInt64(1, fingerprint.file_size);
+        stmt->bindInt64(2, fingerprint.file_mtime);
+        stmt->bindText(3, fingerprint.content_hash);
+        stmt->bindInt64(4, fingerprint.doc_id);
+        if (!stmt->execute()) {
+            LEAFRA_WARNING() << "Failed to refresh stored fingerprint for: " << fingerprint.absolute_path;
+        }
+    } //touchStoredDocument
+
+#ifdef LEAFRA_HAS_SQLITE
+    // resume_pending_jobs retries a failed file this many times in all before leaving it for good
+    static constexpr int32_t kMaxIngestionAttempts = 3;
+    
+    /**
+     * @brief How a file of an ingestion run ended, recorded in ingestion_queue when the run finishes
+     */
+    struct QueuedFileOutcome {
+        std::string file_path;
+        std::string collection;
+        std::string failed_stage;                  // Stage the file failed in ("" = finished without a document to store)
+        std::string content_hash;
+    };
+    
+    /**
+     * @brief Record the files of a run as pending in ingestion_queue (caller holds ingestion_mutex_)
+     * @param collection_of Collection of the file at an index of file_paths
+     *
+     * Files queued before keep their attempt count, so a file that keeps failing stops being resumed.
+     */
+    template <typename CollectionOf>
+    void queueIngestionFiles(const std::vector<std::string>& file_paths, const CollectionOf& collection_of) {
+        if (!ingestion_queue_available_ || !database_ || !database_->isOpen() || file_paths.empty()) {
+            return;
+        }
+        auto stmt = database_->prepareCached(
+            "INSERT INTO ingestion_queue (file_path, collection, stage, status, updated_at) "
+            "VALUES (?, ?, 'queued', 'pending', strftime('%s', 'now')) "
+            "ON CONFLICT(file_path, collection) DO UPDATE SET stage = 'queued', status = 'pending', "
+            "updated_at = excluded.updated_at");
+        if (!stmt || !stmt->isValid()) {
+            LEAFRA_WARNING() << "Failed to prepare ingestion queue insert - this run can't be resumed";
+            return;
+        }
+        SQLiteTransaction transaction(*database_);
+        for (size_t i = 0; i < file_paths.size(); ++i) {
+            stmt->reset();
+            stmt->bindText(1, file_paths[i]);
+            stmt->bindText(2, collection_of(i));
+            if (!stmt->execute()) {
+                LEAFRA_WARNING() << "Failed to queue " << file_paths[i] << ": " << database_->getLastErrorMessage();
+                return;
+            }
+        }
+        if (!transaction.commit()) {
+            LEAFRA_WARNING() << "Failed to commit ingestion queue: " << database_->getLastErrorMessage();
+        }
+    } //queueIngestionFiles
+    
+    /**
+     * @brief Settle the ingestion_queue rows of a finished run (caller holds ingestion_mutex_)
+     * @param outcomes Files that weren't cancelled; stored documents already turned their row done
+     *
+     * Finished rows are removed. A failed file counts an attempt (a row still pending after its
+     * document was handed to the database means the insert didn't commit); a file that no longer
+     * exists is dropped. Rows of cancelled files stay pending for resume_pending_jobs.
+     */
+    void settleIngestionQueue(const std::vector<QueuedFileOutcome>& outcomes) {
+        if (!ingestion_queue_available_ || !database_ || !database_->isOpen()) {
+            return;
+        }
+        auto remove = database_->prepareCached("DELETE FROM ingestion_queue WHERE file_path = ? AND collection = ?");
+        auto fail = database_->prepareCached(
+            "UPDATE ingestion_queue SET status = 'failed', stage = ?, content_hash = ?, attempts = attempts + 1, "
+            "updated_at = strftime('%s', 'now') WHERE file_path = ? AND collection = ? AND status = 'pending'");
+        if (!remove || !remove->isValid() || !fail || !fail->isValid()) {
+            LEAFRA_WARNING() << "Failed to prepare ingestion queue updates";
+            return;
+        }
+        SQLiteTransaction transaction(*database_);
+        for (const QueuedFileOutcome& outcome : outcomes) {
+            std::error_code error;
+            const bool gone = !outcome.failed_stage.empty() && !std::filesystem::exists(outcome.file_path, error) && !error;
+            bool updated = false;
+            if (outcome.failed_stage.empty() || gone) {
+                remove->reset();
+                remove->bindText(1, outcome.file_path);
+                remove->bindText(2, outcome.collection);
+                updated = remove->execute();
+            } else {
+                fail->reset();
+                fail->bindText(1, outcome.failed_stage);
+                fail->bindText(2, outcome.content_hash);
+                fail->bindText(3, outcome.file_path);
+                fail->bindText(4, outcome.collection);
+                updated = fail->execute();
+            }
+            if (!updated) {
+                LEAFRA_WARNING() << "Failed to update ingestion queue: " << database_->getLastErrorMessage();
+                return;
+            }
+        }
+        if (!database_->execute("DELETE FROM ingestion_queue WHERE status = 'done'") || !transaction.commit()) {
+            LEAFRA_WARNING() << "Failed to commit ingestion queue: " << database_->getLastErrorMessage();
+        }
+    } //settleIngestionQueue
+    
+    /**
+     * @brief Files left pending by interrupted runs, plus failed ones with attempts left, oldest first
+     * @param max_files Most files to return (0 = all)
+     * @param file_paths Output paths as they were queued
+     * @param collections Output collection of each file (parallel to file_paths)
+     */
+    void loadPendingIngestion(size_t max_files, std::vector<std::string>& file_paths, std::vector<std::string>& collections) {
+        file_paths.clear();
+        collections.clear();
+        if (!ingestion_queue_available_ || !database_ || !database_->isOpen()) {
+            return;
+        }
+        SQLiteReadPool::Lease reader = read_pool_.acquire(database_.get());
+        auto stmt = reader->prepareCached(
+            "SELECT file_path, collection FROM ingestion_queue "
+            "WHERE status = 'pending' OR (status = 'failed' AND attempts < ?) ORDER BY updated_at, rowid LIMIT ?");
+        if (!stmt || !stmt->isValid()) {
+            LEAFRA_WARNING() << "Failed to read the ingestion queue";
+            return;
+        }
+        stmt->bindInt(1, kMaxIngestionAttempts);
+        stmt->bindInt64(2, max_files > 0 ? static_cast<int64_t>(max_files) : -1);
+        stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+            file_paths.emplace_back(row.getTextView(0));
+            collections.emplace_back(row.getTextView(1));
+            return true;
+        });
+    } //loadPendingIngestion
+    
+    size_t countPendingIngestion() {
+        if (!ingestion_queue_available_ || !database_ || !database_->isOpen()) {
+            return 0;
+        }
+        SQLiteReadPool::Lease reader = read_pool_.acquire(database_.get());
+        auto stmt = reader->prepareCached(
+            "SELECT COUNT(*) FROM ingestion_queue WHERE status = 'pending' OR (status = 'failed' AND attempts < ?)");
+        size_t count = 0;
+        if (stmt && stmt->isValid()) {
+            stmt->bindInt(1, kMaxIngestionAttempts);
+            stmt->forEachRow([&count](const SQLiteDatabase::Row& row) {
+                count = static_cast<size_t>(row.getInt64(0));
+                return false;
+            });
+        }
+        return count;
+    }
+#endif
+
+    /**
+     * @brief Give chunks whose text is unchanged the embedding stored for the previous document version
+     * @param doc_id Stored document being replaced
+     * @param chunk_hashes ContentHasher digest of each new chunk (parallel to chunks)
+     * @param chunks New chunks
+     * @param batch The chunks' columnar batch; matching rows get their embedding filled in
+     * @return Number of chunks that reuse a stored embedding
+     */
+    size_t reuseStoredChunkEmbeddings(int64_t doc_id, const ArenaVector<ArenaString>& chunk_hashes,
+                                      const std::vector<TextChunk>& chunks, ChunkBatch& batch) {
+        std::unordered_map<std::string_view, std::vector<size_t>> pending_by_hash;   // Views into chunk_hashes
+        for (size_t i = 0; i < chunks.size() && i < chunk_hashes.size(); ++i) {
+            if (!batch.has_embedding(i)) {
+                pending_by_hash[chunk_hashes[i]].push_back(i);
+            }
+        }
+        if (pending_by_hash.empty()) {
+            return 0;
+        }
+        
+        auto stmt = database_->prepareCached(
+            "SELECT c.chunk_hash, e.format, e.byte_order, e.dimension, e.scale, e.embedding "
+            "FROM chunks c "
+            "JOIN chunk_embeddings e ON e.chunk_faiss_id = c.chunk_faiss_id "
+            "WHERE c.doc_id = ? AND c.chunk_hash IS NOT NULL");
+        if (!stmt || !stmt->isValid()) {
+            return 0;
+        }
+        stmt->bindInt64(1, doc_id);
+        
+        size_t reused = 0;
+        stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+            auto pending = pending_by_hash.find(row.getTextView(0));
+            if (pending == pending_by_hash.end() || row.getInt(3) <= 0) {
+                return true;
+            }
+            // The matrix takes the stored dimension on first use; rows of another dimension can't share it
+            const size_t dimension = static_cast<size_t>(row.getInt(3));
+            if (batch.rows() != chunks.size() || batch.dimension != dimension) {
+                if (reused > 0) {
+                    return true;
+                }
+                batch.reset_embeddings(chunks.size(), dimension);
+            }
+            const size_t first = pending->second.front();
+            SQLiteDatabase::BlobView blob = row.getBlobView(5);
+            if (!VectorCodec::decode(static_cast<EmbeddingStorageFormat>(row.getInt(1)), static_cast<ByteOrder>(row.getInt(2)),
+                                     static_cast<float>(row.getDouble(4)), blob.data, blob.size, batch.embedding(first), dimension)) {
+                return true;
+            }
+            for (size_t index : pending->second) {
+                if (index != first) {
+                    std::copy(batch.embedding(first), batch.embedding(first) + dimension, batch.embedding(index));
+                }
+                batch.embedded[index] = 1;
+                reused++;
+            }
+            pending_by_hash.erase(pending);
+            return true;
+        });
+        return reused;
+    } //reuseStoredChunkEmbeddings
+
+    /**
+     * @brief Fill in chunk embeddings found in the embedding cache and mark those entries as used
+     * @param cache_keys makeEmbeddingCacheKey of each chunk (parallel to chunks)
+     * @param chunks Chunks being stored
+     * @param batch The chunks' columnar batch; rows found in the cache get their embedding filled in
+     * @return Number of chunks served from the cache
+     */
+    size_t loadCachedEmbeddings(const ArenaVector<ArenaString>& cache_keys, const std::vector<TextChunk>& chunks, ChunkBatch& batch) {
+        if (!embedding_cache_available_ || cache_keys.size() != chunks.size()) {
+            return 0;
+        }
+        auto select = database_->prepareCached(
+            "SELECT format, byte_order, dimension, scale, embedding FROM embedding_cache WHERE cache_key = ?");
+        auto touch = database_->prepareCached("UPDATE embedding_cache SET last_used = ? WHERE cache_key = ?");
+        if (!select.isValid() || !touch.isValid()) {
+            return 0;
+        }
+        const long long now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        
+        SQLiteTransaction transaction(*database_);
+        size_t loaded = 0;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            if (batch.has_embedding(i) || batch.is_skipped(i)) {
+                continue;
+            }
+            select->reset();
+            select->bindTextView(1, cache_keys[i]);
+            if (!select->step()) {
+                continue;
+            }
+            SQLiteDatabase::Row row = select->getCurrentRow();
+            if (row.getInt(2) <= 0) {
+                continue;
+            }
+            // The matrix takes the cached dimension on first use; rows of another dimension can't share it
+            const size_t dimension = static_cast<size_t>(row.getInt(2));
+            if (batch.rows() != chunks.size() || batch.dimension != dimension) {
+                if (batch.embedding_count() > 0) {
+                    continue;
+                }
+                batch.reset_embeddings(chunks.size(), dimension);
+            }
+            SQLiteDatabase::BlobView blob = row.getBlobView(4);
+            if (!VectorCodec::decode(static_cast<EmbeddingStorageFormat>(row.getInt(0)), static_cast<ByteOrder>(row.getInt(1)),
+                                     static_cast<float>(row.getDouble(3)), blob.data, blob.size, batch.embedding(i), dimension)) {
+                continue;
+            }
+            batch.embedded[i] = 1;
+            loaded++;
+            
+            touch->reset();
+            touch->bindInt64(1, now);
+            touch->bindTextView(2, cache_keys[i]);
+            touch->execute();
+        }
+        select->reset();
+        if (!transaction.commit()) {
+            LEAFRA_WARNING() << "Failed to update embedding cache usage";
+        }
+        return loaded;
+    } //loadCachedEmbeddings
+
+    /**
+     * @brief Write embeddings the model just produced to the embedding cache
+     * @param cache_keys makeEmbeddingCacheKey of each chunk (parallel to batch rows)
+     * @param batch Embedded batch
+     * @param embedded_before Batch embedded flags from before the model ran (those rows are not written)
+     */
+    void storeCachedEmbeddings(const ArenaVector<ArenaString>& cache_keys, const ChunkBatch& batch,
+                               const std::vector<uint8_t>& embedded_before) {
+        if (!embedding_cache_available_ || batch.dimension == 0 || cache_keys.size() != batch.rows()) {
+            return;
+        }
+        auto insert = database_->prepareCached(
+            "INSERT OR REPLACE INTO embedding_cache (cache_key, format, byte_order, dimension, scale, embedding, last_used) "
+            "VALUES (?, ?, ?, ?, ?, ?, ?)");
+        if (!insert.isValid()) {
+            return;
+        }
+        // Cache rows use the chunk_embeddings encoding, fp16 when those aren't stored
+        const EmbeddingStorageFormat format = embedding_storage_format_ == EmbeddingStorageFormat::NONE
+                                                  ? EmbeddingStorageFormat::FP16 : embedding_storage_format_;
+        const long long now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        
+        SQLiteTransaction transaction(*database_);
+        VectorCodec::Encoded encoded;
+        size_t written = 0;
+        for (size_t i = 0; i < batch.rows(); ++i) {
+            if (!batch.has_embedding(i) || (i < embedded_before.size() && embedded_before[i])) {
+                continue;
+            }
+            if (!VectorCodec::encode(batch.embedding(i), batch.dimension, format, encoded)) {
+                continue;
+            }
+            insert->reset();
+            insert->bindTextView(1, cache_keys[i]);
+            insert->bindInt(2, static_cast<int>(encoded.format));
+            insert->bindInt(3, static_cast<int>(encoded.byte_order));
+            insert->bindInt64(4, static_cast<long long>(batch.dimension));
+            insert->bindDouble(5, encoded.scale);
+            insert->bindBlobView(6, encoded.data.data(), encoded.data.size());
+            insert->bindInt64(7, now);
+            if (!insert->execute()) {
+                LEAFRA_WARNING() << "Failed to write embedding cache entry: " << database_->getLastErrorMessage();
+                return;
+            }
+            written++;
+        }
+        if (written > 0 && !transaction.commit()) {
+            LEAFRA_WARNING() << "Failed to commit embedding cache entries";
+            return;
+        }
+        LEAFRA_DEBUG() << "Cached " << written << " chunk embeddings";
+    } //storeCachedEmbeddings
+
+    /**
+     * @brief Evict the least recently used embedding cache rows beyond embedding_inference.cache_max_entries
+     */
+    void trimEmbeddingCache() {
+        const int64_t max_entries = config_.embedding_inference.cache_max_entries;
+        if (!embedding_cache_available_ || max_entries <= 0 || !database_ || !database_->isOpen()) {
+            return;
+        }
+        int64_t entries = 0;
+        {
+            auto count = database_->prepareCached("SELECT COUNT(*) FROM embedding_cache");
+            if (!count.isValid() || !count->step()) {
+                return;
+            }
+            entries = count->getCurrentRow().getInt64(0);
+        }
+        if (entries <= max_entries) {
+            return;
+        }
+        auto evict = database_->prepareCached(
+            "DELETE FROM embedding_cache WHERE cache_key IN "
+            "(SELECT cache_key FROM embedding_cache ORDER BY last_used, rowid LIMIT ?)");
+        if (!evict.isValid()) {
+            return;
+        }
+        evict->bindInt64(1, entries - max_entries);
+        if (!evict->execute()) {
+            LEAFRA_WARNING() << "Failed to trim embedding cache: " << database_->getLastErrorMessage();
+            return;
+        }
+        LEAFRA_DEBUG() << "Evicted " << (entries - max_entries) << " embedding cache entries";
+    } //trimEmbeddingCache
+
+    /**
+     * @brief Load the fingerprints of stored chunks into near_duplicate_index_ (once)
+     * @return false if near-duplicate detection can't run (bad settings or no database)
+     */
+    bool ensureNearDuplicateIndex() {
+        if (near_duplicate_index_) {
+            return true;
+        }
+        if (!config_.near_duplicates.isValid()) {
+            LEAFRA_WARNING() << "Invalid near_duplicates settings (policy '" << config_.near_duplicates.policy
+                             << "'), near-duplicate detection disabled";
+            return false;
+        }
+        auto stmt = database_->prepareCached(
+            "SELECT chunk_faiss_id, chunk_simhash FROM chunks WHERE chunk_simhash IS NOT NULL AND chunk_faiss_id IS NOT NULL");
+        if (!stmt || !stmt->isValid()) {
+            return false;
+        }
+        auto index = std::make_unique<NearDuplicateIndex>(config_.near_duplicates.max_distance);
+        stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+            index->add(static_cast<uint64_t>(row.getInt64(1)), row.getInt64(0));
+            return true;
+        });
+        LEAFRA_DEBUG() << "Near-duplicate index loaded with " << index->size() << " chunk fingerprints";
+        near_duplicate_index_ = std::move(index);
+        return true;
+    } //ensureNearDuplicateIndex
+
+    /**
+     * @brief Find chunks that nearly duplicate a stored chunk or an earlier chunk of the same document
+     * @param chunk_simhashes SimHash of each chunk (parallel to chunks, 0 = not matched)
+     * @param stored_doc_id docs row of the version being replaced (-1 if new)
+     * @param collection Collection the document goes into
+     * @param chunks The document's chunks
+     * @param batch The chunks' batch: "reuse" fills in the stored embedding, "skip" marks the row skipped
+     * @param copies Output: (row, earlier row) pairs of the same document; the row is marked skipped until the
+     *               earlier one is embedded and then takes its embedding ("reuse" only)
+     * @return Number of near-duplicate chunks
+     *
+     * A stored match only counts while it still exists and isn't part of the version being replaced;
+     * "skip" also needs it in the same collection, so searches of that collection still find the text.
+     */
+    size_t resolveNearDuplicateChunks(const ArenaVector<uint64_t>& chunk_simhashes, int64_t stored_doc_id, const std::string& collection,
+                                      const std::vector<TextChunk>& chunks, ChunkBatch& batch,
+                                      std::vector<std::pair<size_t, size_t>>& copies) {
+        if (chunk_simhashes.size() != chunks.size() || !ensureNearDuplicateIndex()) {
+            return 0;
+        }
+        const bool skip = config_.near_duplicates.policy == "skip";
+        NearDuplicateIndex document_index(config_.near_duplicates.max_distance);
+        std::vector<NearDuplicateIndex::Match> matches;
+        size_t duplicates = 0;
+        auto mark_skipped = [&](size_t row) {
+            if (batch.skipped.size() != chunks.size()) {
+                batch.skipped.assign(chunks.size(), 0);
+            }
+            batch.skipped[row] = 1;
+        };
+        
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            const uint64_t fingerprint = chunk_simhashes[i];
+            if (fingerprint == 0 || batch.has_embedding(i) || batch.is_skipped(i)) {
+                continue;
+            }
+            document_index.find(fingerprint, matches, 1);
+            if (!matches.empty()) {
+                mark_skipped(i);
+                if (!skip) {
+                    copies.emplace_back(i, static_cast<size_t>(matches.front().id));
+                }
+                duplicates++;
+                continue;
+            }
+            
+            near_duplicate_index_->find(fingerprint, matches);
+            bool resolved = false;
+            for (const auto& match : matches) {
+                auto stmt = database_->prepareCached(
+                    "SELECT c.doc_id, d.collection, e.format, e.byte_order, e.dimension, e.scale, e.embedding "
+                    "FROM chunks c JOIN docs d ON d.id = c.doc_id "
+                    "LEFT JOIN chunk_embeddings e ON e.chunk_faiss_id = c.chunk_faiss_id "
+                    "WHERE c.chunk_faiss_id = ?");
+                if (!stmt || !stmt->isValid()) {
+                    break;
+                }
+                stmt->bindInt64(1, match.id);
+                stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+                    if (row.getInt64(0) == stored_doc_id) {
+                        return false;
+                    }
+                    if (skip) {
+                        resolved = row.getTextView(1) == collection;
+                        return false;
+                    }
+                    if (row.isNull(4) || row.getInt(4) <= 0) {
+                        return false;
+                    }
+                    const size_t dimension = static_cast<size_t>(row.getInt(4));
+                    if (batch.rows() != chunks.size() || batch.dimension != dimension) {
+                        if (batch.embedding_count() > 0) {
+                            return false;
+                        }
+                        batch.reset_embeddings(chunks.size(), dimension);
+                    }
+                    SQLiteDatabase::BlobView blob = row.getBlobView(6);
+                    resolved = VectorCodec::decode(static_cast<EmbeddingStorageFormat>(row.getInt(2)), static_cast<ByteOrder>(row.getInt(3)),
+                                                   static_cast<float>(row.getDouble(5)), blob.data, blob.size, batch.embedding(i), dimension);
+                    if (resolved) {
+                        batch.embedded[i] = 1;
+                    }
+                    return false;
+                });
+                if (resolved) {
+                    break;
+                }
+            }
+            if (resolved) {
+                if (skip) {
+                    mark_skipped(i);
+                }
+                duplicates++;
+            } else {
+                document_index.add(fingerprint, static_cast<int64_t>(i));
+            }
+        }
+        return duplicates;
+    } //resolveNearDuplicateChunks
+#endif // LEAFRA_HAS_SQLITE
+
+#ifdef LEAFRA_HAS_FAISS
+    /**
+     * @brief Insert chunk embeddings into FAISS index
+     * @param batch Chunk embeddings; rows without one are squeezed out of the matrix in place,
+     *              leaving a batch of only the stored rows
+     * @param chunk_faiss_ids FAISS label of each chunk, as stored in chunks.chunk_faiss_id (-1 = not stored)
+     * @param collection_name Collection whose shard receives the vectors (created on first use)
+     */
+    bool insertChunkEmbeddingsIntoFaiss(ChunkBatch& batch, const std::vector<int64_t>& chunk_faiss_ids,
+                                        const std::string& collection_name) {
+        if (!config_.vector_search.enabled || faiss_collections_.empty()) {
+            return true; // Not an error if FAISS is disabled
+        }
+        FaissCollection* collection = nullptr;
+        if (openFaissCollection(collection_name, collection) != ResultCode::SUCCESS) {
+            LEAFRA_ERROR() << "FAISS index for collection '" << collection_name << "' not available";
+            return false;
+        }
+        FaissIndex& faiss_index = *collection->index;
+        
+        const size_t total_chunks = batch.rows();
+        const size_t embedding_dim = batch.dimension;
+        std::vector<int64_t> chunk_ids;
+        chunk_ids.reserve(total_chunks);
+        
+        // Rows go in ascending chunk_faiss_id order straight from the batch matrix; rows that
+        // weren't stored are squeezed out first, moving later rows down in place
+        size_t embedding_count = 0;
+        size_t chunks_without_embeddings = 0;
+        for (size_t i = 0; i < total_chunks; ++i) {
+            if (batch.has_embedding(i) && i < chunk_faiss_ids.size() && chunk_faiss_ids[i] >= 0) {
+                if (embedding_count != i) {
+                    std::copy(batch.embedding(i), batch.embedding(i) + embedding_dim, batch.embedding(embedding_count));
+                }
+                // Dense ids from the chunk_faiss_id sequence, ascending in insertion order
+                chunk_ids.push_back(chunk_faiss_ids[i]);
+                embedding_count++;
+            } else {
+                // Chunks are expected to have embeddings at this point
+                chunks_without_embeddings++;
+                LEAFRA_WARNING() << "Chunk " << i << " missing embedding - skipping FAISS insertion";
+            }
+        }
+        
+        // Log warning if some chunks don't have embeddings
+        if (chunks_without_embeddings > 0) {
+            batch.embeddings.resize(embedding_count * embedding_dim);
+            batch.embedded.assign(embedding_count, 1);
+            LEAFRA_WARNING() << "Skipped " << chunks_without_embeddings << " chunks without embeddings out of " << total_chunks << " total chunks";
+        }
+        
+        if (embedding_count == 0) {
+            return true; // No embeddings to add, not an error
+        }
+        const float* embeddings_to_add = batch.embeddings.data();
+        
+        // Graph and IVF indexes add in parallel across the rows of one call, so their rows are gathered
+        // over several documents; the delta log below still gets them now, so a crash replays them on load
+        const bool bulk = defersFaissAdds(faiss_index);
+        ResultCode faiss_result = ResultCode::SUCCESS;
+        size_t queued = 0;
+        if (bulk) {
+            std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+            collection->pending_vectors.insert(collection->pending_vectors.end(), embeddings_to_add,
+                                               embeddings_to_add + embedding_count * embedding_dim);
+            collection->pending_ids.insert(collection->pending_ids.end(), chunk_ids.begin(), chunk_ids.end());
+            queued = collection->pending_ids.size();
+            
+            // Hot tier: a FLAT add is cheap at any corpus size, and the rows are searchable right away
+            if (config_.vector_search.hot_index) {
+                if (!collection->hot) {
+                    collection->hot = createHotIndex(faiss_index);
+                }
+                if (collection->hot->add_vectors_with_ids(embeddings_to_add, chunk_ids.data(), static_cast<int>(embedding_count)) !=
+                    ResultCode::SUCCESS) {
+                    LEAFRA_WARNING() << "Failed to add embeddings to the hot index - searchable after the next merge";
+                }
+                collection->hot_generation++;
+            }
+        } else {
+            faiss_result = faiss_index.add_vectors_with_ids(
+                embeddings_to_add, 
+                chunk_ids.data(), 
+                static_cast<int>(embedding_count)
+            );
+        }
+        
+        if (faiss_result == ResultCode::SUCCESS) {
+            LEAFRA_INFO() << "✅ " << (bulk ? "Queued " : "Added ") << embedding_count << " embeddings for FAISS index (" << embedding_count << "/" << total_chunks << " chunks)";
+            send_event(EventType::INDEX_UPDATED, "🔍 Added " + std::to_string(embedding_count) + "/" + std::to_string(total_chunks) + " embeddings to search index");
+            
+#ifdef LEAFRA_HAS_SQLITE
+            // Persist only the new vectors; the full index blob is rewritten by compactFaissIndex
+            if (database_ && database_->isOpen()) {
+                auto append_result = faiss_index.append_vectors_to_db(*database_, collection->definition, embeddings_to_add,
+                                                                      chunk_ids.data(), static_cast<int>(embedding_count));
+                if (append_result == ResultCode::SUCCESS) {
+                    LEAFRA_DEBUG() << "FAISS delta saved to database";
+                } else {
+                    LEAFRA_WARNING() << "Failed to save FAISS delta to database";
+                }
+            }
+#endif
+            if (queued >= static_cast<size_t>(config_.vector_search.bulk_add_vectors)) {
+                if (config_.vector_search.hot_index) {
+                    requestHotMerge();
+                } else {
+                    flushPendingFaissVectors(*collection);
+                }
+            }
+#ifdef LEAFRA_HAS_SQLITE
+            if (database_ && database_->isOpen() && config_.vector_search.delta_compaction_threshold <= 0) {
+                compactFaissCollection(*collection, true);
+            }
+#endif
+            return true;
+        } else {
+            LEAFRA_ERROR() << "Failed to add embeddings to FAISS index";
+            send_event(EventType::ERROR_OCCURRED, "❌ Failed to add embeddings to search index");
+            return false;
+        }
+    } //insertChunkEmbeddingsIntoFaiss
+    
+    /**
+     * @brief Whether ingestion queues an index's new vectors for a bulk add (vector_search.bulk_add_vectors)
+     */
+    bool defersFaissAdds(const FaissIndex& index) const {
+        if (config_.vector_search.bulk_add_vectors <= 0) {
+            return false;
+        }
+        switch (index.get_index_type()) {
+            case FaissIndex::IndexType::HNSW:
+            case FaissIndex::IndexType::HNSW_SQ:
+            case FaissIndex::IndexType::IVF_FLAT:
+            case FaissIndex::IndexType::IVF_PQ:
+                return true;
+            default:
+                return false;
+        }
+    }
+    
+    /**
+     * @brief Add a collection's queued ingestion vectors to its index in one (parallel) call
+     * 
+     * Runs before anything reads the index contents as a whole: compaction, document removals
+     * (without a hot tier), and the threshold check after each document. Queued vectors become
+     * searchable here unless the hot tier already made them so.
+     */
+    void flushPendingFaissVectors(FaissCollection& collection) {
+        std::lock_guard<std::mutex> merge_lock(faiss_merge_mutex_);
+        mergePendingFaissVectors(collection);
+    } //flushPendingFaissVectors
+    
+    /**
+     * @brief flushPendingFaissVectors with faiss_merge_mutex_ held
+     * 
+     * The queued rows are taken out under the collections mutex and added without it, so
+     * ingestion keeps queueing (into a fresh hot index) and searches keep seeing the old hot
+     * index until the main index has the rows.
+     */
+    void mergePendingFaissVectors(FaissCollection& collection) {
+        std::vector<float> vectors;
+        std::vector<int64_t> ids;
+        std::shared_ptr<FaissIndex> target;
+        {
+            std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+            if (collection.pending_ids.empty()) {
+                return;
+            }
+            vectors.swap(collection.pending_vectors);
+            ids.swap(collection.pending_ids);
+            target = collection.index;
+            collection.merging = std::move(collection.hot);
+        }
+        const int count = static_cast<int>(ids.size());
+        auto start_time = debug::timer::now();
+        if (target->add_vectors_with_ids(vectors.data(), ids.data(), count) == ResultCode::SUCCESS) {
+            LEAFRA_INFO() << "📦 Bulk-added " << count << " vectors to FAISS index " << collection.definition << " in "
+                          << debug::timer::elapsed_milliseconds(start_time, debug::timer::now()) << " ms (" << governor_.limits().faiss_threads << " threads)";
+        } else {
+            LEAFRA_ERROR() << "Failed to bulk-add " << count << " vectors to FAISS index " << collection.definition;
+        }
+        std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+        collection.merging.reset();
+        collection.hot_generation++;
+    } //mergePendingFaissVectors
+    
+    /**
+     * @brief Empty hot-tier index matching a collection's main index (metric and stored dimensions),
+     *        so distances from both tiers merge into one ranking
+     */
+    std::shared_ptr<FaissIndex> createHotIndex(const FaissIndex& main_index) const {
+        return std::make_shared<FaissIndex>(main_index.get_dimension(), FaissIndex::IndexType::FLAT,
+                                            get_faiss_metric_type_from_string(config_.vector_search.metric),
+                                            main_index.get_index_dimension());
+    }
+    
+    /**
+     * @brief Drop removed rows from a collection's hot tier (caller holds faiss_merge_mutex_, so no merge is adding them meanwhile)
+     */
+    void removeHotVectors(FaissCollection& collection, const std::vector<int64_t>& ids) {
+        std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+        if (collection.pending_ids.empty()) {
+            return;
+        }
+        const std::unordered_set<int64_t> removed(ids.begin(), ids.end());
+        const size_t dimension = collection.pending_vectors.size() / collection.pending_ids.size();
+        size_t kept = 0;
+        for (size_t i = 0; i < collection.pending_ids.size(); ++i) {
+            if (removed.count(collection.pending_ids[i]) > 0) {
+                continue;
+            }
+            if (kept != i) {
+                collection.pending_ids[kept] = collection.pending_ids[i];
+                std::copy(collection.pending_vectors.begin() + i * dimension, collection.pending_vectors.begin() + (i + 1) * dimension,
+                          collection.pending_vectors.begin() + kept * dimension);
+            }
+            kept++;
+        }
+        collection.pending_ids.resize(kept);
+        collection.pending_vectors.resize(kept * dimension);
+        if (collection.hot) {
+            collection.hot->remove_vectors(ids.data(), static_cast<int>(ids.size()));
+        }
+        collection.hot_generation++;
+    }
+    
+    void startHotMergeScheduler() {
+        stop_hot_merge_ = false;
+        hot_merge_requested_ = false;
+        hot_merge_thread_ = std::thread([this]() { runHotMergeScheduler(); });
+    }
+    
+    void stopHotMergeScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(hot_merge_mutex_);
+            stop_hot_merge_ = true;
+        }
+        hot_merge_cv_.notify_all();
+        if (hot_merge_thread_.joinable()) {
+            hot_merge_thread_.join();
+        }
+    }
+    
+    void requestHotMerge() {
+        {
+            std::lock_guard<std::mutex> lock(hot_merge_mutex_);
+            hot_merge_requested_ = true;
+        }
+        hot_merge_cv_.notify_all();
+    }
+    
+    // Merge every collection's hot tier each hot_merge_interval_ms, or as soon as one holds bulk_add_vectors rows
+    void runHotMergeScheduler() {
+        const auto interval = std::chrono::milliseconds(std::max<int32_t>(config_.vector_search.hot_merge_interval_ms, 1));
+        std::unique_lock<std::mutex> lock(hot_merge_mutex_);
+        while (!stop_hot_merge_) {
+            hot_merge_cv_.wait_for(lock, interval, [this]() { return stop_hot_merge_ || hot_merge_requested_; });
+            if (stop_hot_merge_) {
+                break;
+            }
+            hot_merge_requested_ = false;
+            lock.unlock();
+            {
+                // Held across the walk, so the shards can't be replaced under it
+                std::lock_guard<std::mutex> merge_lock(faiss_merge_mutex_);
+                std::vector<FaissCollection*> collections;
+                {
+                    std::lock_guard<std::mutex> collections_lock(faiss_collections_mutex_);
+                    for (auto& entry : faiss_collections_) {
+                        collections.push_back(&entry.second);
+                    }
+                }
+                for (FaissCollection* collection : collections) {
+                    mergePendingFaissVectors(*collection);
+                }
+            }
+            lock.lock();
+        }
+    } //runHotMergeScheduler
+
+    /**
+     * @brief Path prefix of a collection's standalone index file ("file" storage), next to the document database
+     */
+    std::string faissIndexFileBase(const std::string& collection_name) const {
+        return FileManager::getAbsolutePath(StorageType::AppStorage,
+                                            config_.leafra_document_database_name + "." + faissDefinition(collection_name));
+    }
+    
+    /**
+     * @brief Storage definition of a collection's index ("PrimaryDocEmbeddings" for the default collection)
+     */
+    static std::string faissDefinition(const std::string& collection_name) {
+        return collection_name.empty() ? "PrimaryDocEmbeddings" : "PrimaryDocEmbeddings." + collection_name;
+    }
+    
+    /**
+     * @brief Create an empty FAISS index from the vector search config (adaptive types start out FLAT)
+     * @param dimension Vector dimension (0 = vector_search.dimension; a re-index builds for its new model)
+     */
+    std::shared_ptr<FaissIndex> createFaissIndex(int32_t dimension = 0) const {
+        FaissIndex::IndexType migration_target;
+        int64_t migration_threshold = 0;
+        bool adaptive = faissMigrationTarget(migration_target, migration_threshold);
+        auto index = std::make_shared<FaissIndex>(
+            dimension > 0 ? dimension : config_.vector_search.dimension,
+            adaptive ? FaissIndex::IndexType::FLAT : get_faiss_index_type_from_string(config_.vector_search.index_type),
+            get_faiss_metric_type_from_string(config_.vector_search.metric),
+            config_.vector_search.index_dimension
+        );
+        if (adaptive) {
+            index->set_migration_target(migration_target);
+        }
+        if (config_.vector_search.gpu_flat_search && !index->enable_gpu_search(config_.vector_search.gpu_min_vectors)) {
+            LEAFRA_DEBUG() << "GPU flat search requested but unavailable - searching on the CPU";
+        }
+        index->set_thread_count(governor_.limits().faiss_threads);
+        return index;
+    }
+    
+#ifdef LEAFRA_HAS_SQLITE
+    /**
+     * @brief Compare the embedding model a collection's index was built with (index_models) to the loaded one
+     * 
+     * An index holding vectors of another model is marked stale and left out of searches until a
+     * re-index; an empty or unrecorded one is recorded under the loaded model.
+     */
+    void checkIndexModel(FaissCollection& collection) {
+        collection.stale = false;
+        if (!index_models_available_ || !database_ || !database_->isOpen()) {
+            return;
+        }
+        const std::string model_id = embeddingModelId(config_);
+        auto stmt = database_->prepareCached("SELECT model_id, version FROM index_models WHERE definition = ?");
+        if (!stmt.isValid() || !stmt->bindText(1, collection.definition)) {
+            return;
+        }
+        std::string recorded;
+        int64_t version = 0;
+        if (stmt->step()) {
+            const SQLiteDatabase::Row row = stmt->getCurrentRow();
+            recorded = row.getText(0);
+            version = row.getInt64(1);
+        }
+        stmt->reset();
+        if (version > 0 && recorded == model_id) {
+            return;
+        }
+        if (version > 0 && collection.index->get_count() > 0) {
+            collection.stale = true;
+            const std::string label = collection.name.empty() ? "Default collection" : "Collection '" + collection.name + "'";
+            LEAFRA_WARNING() << "⚠️  " << label << " was indexed with embedding model " << (recorded.empty() ? "(unknown)" : recorded)
+                             << ", not " << model_id << " - it is not searched until re-indexed";
+            send_event(EventType::WARNING, "⚠️ " + label + " was indexed with another embedding model - re-index it to search it");
+            return;
+        }
+        if (!attached_) {
+            recordIndexModel(collection.definition, model_id, config_.vector_search.dimension, std::max<int64_t>(version, 1));
+        }
+    } //checkIndexModel
+    
+    /**
+     * @brief checkIndexModel for every open collection, e.g. after the embedding model changed
+     */
+    void checkIndexModels() {
+        std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+        for (auto& entry : faiss_collections_) {
+            checkIndexModel(entry.second);
+        }
+    }
+    
+    /**
+     * @brief Record the model an index definition's vectors came from
+     * @param model_id embeddingModelId of the model ("" while an index is being replaced: stale until recorded again)
+     */
+    bool recordIndexModel(const std::string& definition, const std::string& model_id, int32_t dimension, int64_t version) {
+        auto stmt = database_->prepareCached(
+            "INSERT OR REPLACE INTO index_models (definition, model_id, dimension, version, updated_at) VALUES (?, ?, ?, ?, ?)");
+        const long long now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        return stmt.isValid() && stmt->bindText(1, definition) && stmt->bindText(2, model_id) && stmt->bindInt(3, dimension) &&
+               stmt->bindInt64(4, version) && stmt->bindInt64(5, now) && stmt->execute();
+    }
+#endif
+    
+    /**
+     * @brief Find a collection's shard, creating it (restored from storage, else rebuilt from stored embeddings) on first use
+     * 
+     * Called from initialize and the serialized store stage only, so two callers never create the same shard.
+     * 
+     * @param collection_name Collection name ("" = default collection)
+     * @param collection Output shard (owned by faiss_collections_, stable until shutdown)
+     * @return ResultCode indicating success or failure (ERROR_INVALID_PARAMETER for a bad name)
+     */
+    ResultCode openFaissCollection(const std::string& collection_name, FaissCollection*& collection) {
+        {
+            std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+            auto it = faiss_collections_.find(collection_name);
+            if (it != faiss_collections_.end()) {
+                collection = &it->second;
+                return ResultCode::SUCCESS;
+            }
+        }
+        if (!isValidCollectionName(collection_name)) {
+            LEAFRA_ERROR() << "Invalid collection name: '" << collection_name << "'";
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+        
+        FaissCollection opened;
+        ResultCode restore_result = restoreFaissCollection(collection_name, opened);
+        if (restore_result != ResultCode::SUCCESS) {
+            return restore_result;
+        }
+        
+        std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+        collection = &faiss_collections_.emplace(collection_name, std::move(opened)).first->second;
+        return ResultCode::SUCCESS;
+    } //openFaissCollection
+    
+    /**
+     * @brief Create a collection's shard: restored from storage, else rebuilt from stored embeddings (not registered)
+     * @param collection_name Collection name ("" = default collection)
+     * @param opened Output shard
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode restoreFaissCollection(const std::string& collection_name, FaissCollection& opened) {
+        opened.name = collection_name;
+        opened.definition = faissDefinition(collection_name);
+        try {
+            opened.index = createFaissIndex();
+            if (config_.vector_search.ivf_on_disk_lists && config_.vector_search.index_storage == "file") {
+                opened.index->set_on_disk_lists(faissIndexFileBase(collection_name) + ".live.ivfdata");
+            }
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "Failed to create FAISS index for collection '" << collection_name << "': " << e.what();
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        const std::string label = collection_name.empty() ? "FAISS index" : "FAISS index for collection '" + collection_name + "'";
+#ifdef LEAFRA_HAS_SQLITE
+        if (database_ && database_->isOpen()) {
+            auto restore_result = config_.vector_search.index_storage == "file"
+                ? opened.index->restore_from_file(*database_, opened.definition, faissIndexFileBase(collection_name),
+                                                  config_.vector_search.mmap_index_file)
+                : opened.index->restore_from_db(*database_, opened.definition);
+            if (restore_result == ResultCode::SUCCESS) {
+                LEAFRA_INFO() << "✅ " << label << " restored from database";
+                send_event(EventType::INDEX_UPDATED, label + " restored from database");
+            } else if (restore_result == ResultCode::ERROR_NOT_FOUND) {
+                if (rebuildFaissIndexFromEmbeddings(opened, "chunk_embeddings", !attached_) > 0) {
+                    send_event(EventType::INDEX_UPDATED, label + " rebuilt from stored embeddings");
+                } else {
+                    LEAFRA_INFO() << "No existing " << label << " found in database - starting fresh";
+                    send_event(EventType::INDEX_UPDATED, "Starting with fresh " + label);
+                }
+            } else {
+                LEAFRA_ERROR() << "Failed to restore " << label << " from database";
+                send_event(EventType::ERROR_OCCURRED, "Failed to restore " + label + " from database");
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+            checkIndexModel(opened);
+        }
+#endif
+        return ResultCode::SUCCESS;
+    } //restoreFaissCollection
+    
+    /**
+     * @brief Names of the collections that hold documents, plus the default collection ("") first
+     */
+    std::vector<std::string> storedCollectionNames() const {
+        std::vector<std::string> names{std::string()};
+#ifdef LEAFRA_HAS_SQLITE
+        if (database_ && database_->isOpen()) {
+            auto stmt = database_->prepare("SELECT DISTINCT collection FROM docs WHERE collection <> ''");
+            if (stmt && stmt->isValid()) {
+                stmt->forEachRow([&names](const SQLiteDatabase::Row& row) {
+                    names.emplace_back(row.getTextView(0));
+                    return true;
+                });
+            }
+        }
+#endif
+        return names;
+    }
+    
+    /**
+     * @brief Open one shard per collection from storage (dropping any open ones): the default one always,
+     *        plus every collection that holds documents
+     * @return ERROR_INITIALIZATION_FAILED if the default collection's shard can't be opened
+     */
+    ResultCode loadFaissCollections() {
+        {
+            std::lock_guard<std::mutex> merge_lock(faiss_merge_mutex_);
+            std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+            faiss_collections_.clear();
+        }
+        std::vector<std::string> collection_names = storedCollectionNames();
+        for (const std::string& name : collection_names) {
+            FaissCollection* collection = nullptr;
+            ResultCode open_result = openFaissCollection(name, collection);
+            if (open_result != ResultCode::SUCCESS && name.empty()) {
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+        }
+        if (collection_names.size() > 1) {
+            LEAFRA_INFO() << "📚 FAISS collections: " << collection_names.size();
+        }
+#ifdef LEAFRA_HAS_SQLITE
+        loadDocumentIndex();
+#endif
+        return ResultCode::SUCCESS;
+    } //loadFaissCollections
+    
+    /**
+     * @brief attach_read_only: re-open the shards once the writing process has committed since they were restored
+     * 
+     * Checked at most every attach_refresh_interval_ms, by PRAGMA data_version (which changes
+     * only when another connection commits). The shards are restored from the writer's newest
+     * index file and delta log inside one read transaction, so a compaction committed meanwhile
+     * can't drop deltas the chosen file lacks, and replace the open ones in one step; searches
+     * already running keep the shards they took. A search that finds another one refreshing
+     * doesn't wait for it.
+     */
+    void refreshAttachedStore() {
+#ifdef LEAFRA_HAS_SQLITE
+        if (!attached_ || !config_.vector_search.enabled || !database_ || !database_->isOpen()) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(attach_refresh_mutex_, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (now - attach_checked_at_ < std::chrono::milliseconds(std::max<int32_t>(0, config_.attach_refresh_interval_ms))) {
+            return;
+        }
+        attach_checked_at_ = now;
+        
+        SQLiteTransaction snapshot(*database_);
+        int64_t data_version = -1;
+        database_->execute("PRAGMA data_version", [&data_version](const SQLiteDatabase::Row& row) {
+            data_version = row.getInt64(0);
+            return false;
+        });
+        if (data_version < 0 || data_version == attached_data_version_) {
+            return;
+        }
+        
+        auto start_time = debug::timer::now();
+        std::map<std::string, FaissCollection> reopened;
+        for (const std::string& name : storedCollectionNames()) {
+            FaissCollection collection;
+            if (restoreFaissCollection(name, collection) != ResultCode::SUCCESS) {
+                LEAFRA_WARNING() << "Failed to re-open the writer's FAISS index " << faissDefinition(name) << " - searching the open one";
+                return;
+            }
+            reopened.emplace(name, std::move(collection));
+        }
+        snapshot.commit();
+        {
+            std::lock_guard<std::mutex> merge_lock(faiss_merge_mutex_);
+            std::lock_guard<std::mutex> collections_lock(faiss_collections_mutex_);
+            faiss_collections_.swap(reopened);
+        }
+        loadDocumentIndex();
+        {
+            // Cached results may hold chunks the writer has since removed
+            std::lock_guard<std::mutex> cache_lock(query_mutex_);
+            search_result_cache_.clear();
+#ifdef LEAFRA_HAS_LLAMACPP
+            answer_cache_.clear();
+#endif
+        }
+        attached_data_version_ = data_version;
+        LEAFRA_INFO() << "🔄 Picked up the writer's index changes (" << std::fixed << std::setprecision(1)
+                      << debug::timer::elapsed_milliseconds(start_time, debug::timer::now()) << " ms)";
+#endif
+    } //refreshAttachedStore
+    
+    /**
+     * @brief Write a full snapshot of a collection's index to its configured storage
+     */
+    ResultCode saveFaissCollection(FaissCollection& collection) {
+        PipelineMetricsRecorder::ScopedStage save_timing(metrics_, PipelineStage::FAISS_SAVE);
+        save_timing.set_items(static_cast<uint64_t>(std::max<int64_t>(collection.index->get_count(), 0)));
+#ifdef LEAFRA_HAS_SQLITE
+        ResultCode result;
+        if (config_.vector_search.index_storage == "file") {
+            std::lock_guard<std::recursive_mutex> files_lock(faiss_files_mutex_);
+            result = collection.index->save_to_file(*database_, collection.definition, faissIndexFileBase(collection.name));
+        } else {
+            result = collection.index->save_to_db(*database_, collection.definition);
+        }
+#else
+        // Both storages keep the index's delta watermark in the database
+        ResultCode result = ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+        if (result != ResultCode::SUCCESS) {
+            save_timing.cancel();
+        }
+        return result;
+    }
+    
+    /**
+     * @brief Indexes of the named collections, or of every collection when names is empty
+     * @param names Collection names (unknown and stale collections are skipped)
+     * @return Shards to search; they stay alive for the caller even if a collection is rebuilt meanwhile
+     */
+    std::vector<std::shared_ptr<FaissIndex>> faissShards(const std::vector<std::string>& names = {}) const {
+        std::vector<std::shared_ptr<FaissIndex>> shards;
+        std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+        // Hot tiers are searched as shards of their own; vectors of another embedding model are never compared with the query
+        auto add_collection = [&shards](const FaissCollection& collection) {
+            if (collection.stale) {
+                return;
+            }
+            shards.push_back(collection.index);
+            if (collection.hot) {
+                shards.push_back(collection.hot);
+            }
+            if (collection.merging) {
+                shards.push_back(collection.merging);
+            }
+        };
+        if (names.empty()) {
+            for (const auto& entry : faiss_collections_) {
+                add_collection(entry.second);
+            }
+            return shards;
+        }
+        for (const std::string& name : names) {
+            auto it = faiss_collections_.find(name);
+            if (it != faiss_collections_.end() &&
+                std::find(shards.begin(), shards.end(), it->second.index) == shards.end()) {
+                add_collection(it->second);
+            }
+        }
+        return shards;
+    }
+    
+    /**
+     * @brief Candidates to fetch for k results over these shards (k = no re-rank)
+     * 
+     * Only indexes that store lossy codes or reduced dimensions are re-ranked, and only when chunk
+     * embeddings are kept in SQLite to re-score against: k * rerank_factor candidates, and for
+     * BINARY at least binary_rerank_candidates (Hamming order alone is too coarse to keep).
+     */
+    int rerankCandidates(const std::vector<std::shared_ptr<FaissIndex>>& shards, int k) const {
+#ifdef LEAFRA_HAS_SQLITE
+        if (embedding_storage_format_ == EmbeddingStorageFormat::NONE || !database_ || !database_->isOpen()) {
+            return k;
+        }
+        int candidates = k;
+        for (const auto& shard : shards) {
+            FaissIndex::IndexType type = shard->get_index_type();
+            if (config_.vector_search.rerank_factor > 1 &&
+                (type == FaissIndex::IndexType::IVF_PQ || type == FaissIndex::IndexType::SQ8 ||
+                 type == FaissIndex::IndexType::SQ_FP16 || type == FaissIndex::IndexType::HNSW_SQ ||
+                 type == FaissIndex::IndexType::BINARY || shard->get_index_dimension() < shard->get_dimension())) {
+                candidates = std::max(candidates, k * config_.vector_search.rerank_factor);
+            }
+            if (type == FaissIndex::IndexType::BINARY) {
+                candidates = std::max(candidates, config_.vector_search.binary_rerank_candidates);
+            }
+        }
+        return candidates;
+#else
+        (void)shards;
+        return k;
+#endif
+    }
+    
+    /**
+     * @brief Keep the keep most relevant yet mutually dissimilar results (maximal marginal relevance)
+     * 
+     * Each pick maximizes lambda * sim(query, d) - (1 - lambda) * max sim(d, picked), with cosine
+     * similarity over the vectors the shards already store. Falls back to the first keep results
+     * when some candidate's vector can't be read (e.g. LSH).
+     * 
+     * @param query_embedding Query vector
+     * @param keep Results to keep
+     * @param results Candidates in retrieval order, replaced by the selection in pick order
+     */
+    void selectDiverseResults(const std::vector<float>& query_embedding, size_t keep,
+                              std::vector<FaissIndex::SearchResult>& results) const {
+        if (results.size() <= keep) {
+            return;
+        }
+        const size_t count = results.size();
+        std::vector<int64_t> ids(count);
+        for (size_t i = 0; i < count; ++i) {
+            ids[i] = results[i].id;
+        }
+        
+        // Reduced indexes store the leading dimensions only; the query is cut to match
+        const auto shards = faissShards();
+        size_t dimension = query_embedding.size();
+        for (const auto& shard : shards) {
+            if (shard->get_dimension() == static_cast<int>(query_embedding.size())) {
+                dimension = static_cast<size_t>(shard->get_index_dimension());
+                break;
+            }
+        }
+        
+        std::vector<float> vectors(count * dimension);
+        std::vector<char> have(count, 0);
+        std::vector<char> found;
+        for (const auto& shard : shards) {
+            if (shard->get_dimension() != static_cast<int>(query_embedding.size()) ||
+                shard->get_index_dimension() != static_cast<int>(dimension) ||
+                shard->get_vectors(ids.data(), static_cast<int>(count), vectors.data(), found) != ResultCode::SUCCESS) {
+                continue;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                have[i] |= found[i];
+            }
+        }
+        if (std::find(have.begin(), have.end(), 0) != have.end()) {
+            LEAFRA_DEBUG() << "Stored vectors unavailable for some candidates, skipping MMR";
+            results.resize(keep);
+            return;
+        }
+        
+        std::vector<float> query(dimension);
+        simd::l2_normalize(query_embedding.data(), query.data(), dimension);
+        simd::l2_normalize_rows(vectors.data(), count, dimension);
+        std::vector<float> relevance(count);
+        simd::dot_batch(query.data(), vectors.data(), count, dimension, relevance.data());
+        
+        const float lambda = config_.diversity.mmr_lambda;
+        std::vector<float> redundancy(count, -1.0f);   // Highest similarity to anything picked so far
+        std::vector<float> similarity(count);
+        std::vector<float> scores(count);
+        std::vector<char> picked(count, 0);
+        std::vector<FaissIndex::SearchResult> selected;
+        selected.reserve(keep);
+        while (selected.size() < keep) {
+            for (size_t i = 0; i < count; ++i) {
+                scores[i] = picked[i] ? -std::numeric_limits<float>::infinity()
+                                      : lambda * relevance[i] - (1.0f - lambda) * std::max(redundancy[i], 0.0f);
+            }
+            const size_t best = simd::argmax(scores.data(), count);
+            picked[best] = 1;
+            selected.push_back(std::move(results[best]));
+            // One batched pass against the new pick (already picked rows are scored too, then ignored)
+            simd::dot_batch(vectors.data() + best * dimension, vectors.data(), count, dimension, similarity.data());
+            for (size_t i = 0; i < count; ++i) {
+                redundancy[i] = std::max(redundancy[i], similarity[i]);
+            }
+        }
+        results = std::move(selected);
+    }
+    
+    /**
+     * @brief Merge results that are consecutive chunks of the same document into one span
+     * 
+     * Spans keep the rank (and id, score) of their best chunk; the text neighbouring chunks
+     * share through chunk overlap appears once.
+     * 
+     * @param max_span_chunks Most chunks merged into one span
+     * @param results Results in rank order, merged in place
+     */
+    static void mergeAdjacentResults(int max_span_chunks, std::vector<FaissIndex::SearchResult>& results) {
+        if (results.size() < 2 || max_span_chunks < 2) {
+            return;
+        }
+        // Group by document in chunk order, remembering each chunk's rank
+        std::vector<size_t> order(results.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return results[a].doc_id != results[b].doc_id ? results[a].doc_id < results[b].doc_id
+                                                          : results[a].chunk_index < results[b].chunk_index;
+        });
+        
+        std::vector<char> absorbed(results.size(), 0);
+        for (size_t begin = 0; begin < order.size();) {
+            size_t end = begin + 1;
+            while (end < order.size() && end - begin < static_cast<size_t>(max_span_chunks) &&
+                   results[order[end]].doc_id >= 0 && results[order[end]].doc_id == results[order[begin]].doc_id &&
+                   results[order[end]].chunk_index == results[order[end - 1]].chunk_index + 1) {
+                end++;
+            }
+            if (end - begin > 1) {
+                size_t head = *std::min_element(order.begin() + begin, order.begin() + end);
+                std::string content = results[order[begin]].content;
+                int page_number = results[order[begin]].page_number;
+                const FaissIndex::SearchResult& first = results[order[begin]];
+                const FaissIndex::SearchResult& last = results[order[end - 1]];
+                const bool has_range = first.text_start >= 0 && last.text_end >= 0;
+                const int64_t text_start = has_range ? first.text_start : -1;
+                const int64_t text_end = has_range ? last.text_end : -1;
+                const int64_t page_text_start = first.page_text_start;
+                for (size_t i = begin + 1; i < end; ++i) {
+                    const std::string& next = results[order[i]].content;
+                    content += next.substr(sharedOverlapLength(content, next));
+                    absorbed[order[i]] = order[i] != head;
+                }
+                absorbed[order[begin]] = order[begin] != head;
+                results[head].content = std::move(content);
+                results[head].page_number = page_number;
+                results[head].chunk_index = results[order[begin]].chunk_index;
+                results[head].text_start = text_start;
+                results[head].text_end = text_end;
+                results[head].page_text_start = page_text_start;
+            }
+            begin = end;
+        }
+        
+        size_t kept = 0;
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (!absorbed[i]) {
+                if (kept != i) {
+                    results[kept] = std::move(results[i]);
+                }
+                kept++;
+            }
+        }
+        results.resize(kept);
+    }
+    
+    /**
+     * @brief Length of the longest suffix of a that is also a prefix of b (the chunk overlap)
+     */
+    static size_t sharedOverlapLength(const std::string& a, const std::string& b) {
+        const size_t longest = std::min(a.size(), b.size());
+        for (size_t length = longest; length > 0; --length) {
+            if (a.compare(a.size() - length, length, b, 0, length) == 0) {
+                return length;
+            }
+        }
+        return 0;
+    }
+    
+    /**
+     * @brief Sum of all shard generations - changes whenever any collection's vectors change
+     */
+    uint64_t faissGeneration() const {
+        uint64_t generation = 0;
+        std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+        for (const auto& entry : faiss_collections_) {
+            generation += entry.second.generation_base + entry.second.index->get_generation() + entry.second.hot_generation;
+        }
+        return generation;
+    }
+    
+    /**
+     * @brief k-NN search over several shards, fanned out on the worker pool and merged per query
+     * 
+     * The first shard is searched on the calling thread while the others run on query_pool_
+     * (inline if the pool rejects the task); each query's per-shard lists are then merged
+     * into one top-k list with a heap. Empty shards are skipped.
+     * 
+     * @param shards Indexes to search
+     * @param queries Query vectors (query_count * dimension floats)
+     * @param query_count Number of queries
+     * @param k Results per query
+     * @param params FAISS search settings (allowed_ids are global chunk ids, valid for every shard)
+     * @param results Output top-k list per query, best first
+     * @return ResultCode indicating success, or the first shard failure
+     */
+    ResultCode searchFaissShards(const std::vector<std::shared_ptr<FaissIndex>>& shards, const float* queries, int query_count,
+                                 int k, const FaissIndex::SearchParams& params,
+                                 std::vector<std::vector<FaissIndex::SearchResult>>& results) {
+        std::vector<FaissIndex*> active;
+        for (const auto& shard : shards) {
+            if (shard->get_count() > 0) {
+                active.push_back(shard.get());
+            }
+        }
+        results.assign(static_cast<size_t>(query_count), std::vector<FaissIndex::SearchResult>());
+        if (active.empty()) {
+            return ResultCode::SUCCESS;
+        }
+        AdmissionController::Permit permit(admission_, AdmissionResource::INDEX, AdmissionLane::INTERACTIVE);
+        if (!permit.admitted()) {
+            LEAFRA_WARNING() << "Too many queries waiting for the vector index";
+            return ResultCode::ERROR_BUSY;
+        }
+        PipelineMetricsRecorder::ScopedStage timing(metrics_, PipelineStage::FAISS_SEARCH);
+        timing.set_items(static_cast<uint64_t>(query_count));
+        if (active.size() == 1) {
+            return active[0]->batch_search(queries, query_count, k, results, params);
+        }
+        
+        std::vector<std::vector<std::vector<FaissIndex::SearchResult>>> shard_results(active.size());
+        std::vector<ResultCode> shard_codes(active.size(), ResultCode::ERROR_PROCESSING_FAILED);
+        std::vector<std::future<void>> pending;
+        pending.reserve(active.size() - 1);
+        for (size_t s = 1; s < active.size(); ++s) {
+            auto done = std::make_shared<std::promise<void>>();
+            pending.push_back(done->get_future());
+            auto task = [&, s, done]() {
+                shard_codes[s] = active[s]->batch_search(queries, query_count, k, shard_results[s], params);
+                done->set_value();
+            };
+            if (!query_pool_ || !query_pool_->submit(task)) {
+                task();
+            }
+        }
+        shard_codes[0] = active[0]->batch_search(queries, query_count, k, shard_results[0], params);
+        for (auto& done : pending) {
+            done.wait();
+        }
+        for (ResultCode code : shard_codes) {
+            if (code != ResultCode::SUCCESS) {
+                return code;
+            }
+        }
+        
+        // Each shard list is already sorted best first, so a k-way merge only ever looks at list heads
+        const bool higher_is_better = config_.vector_search.metric != "L2";
+        struct Head {
+            float distance;
+            size_t shard;
+            size_t position;
+        };
+        auto worse = [higher_is_better](const Head& a, const Head& b) {
+            return higher_is_better ? a.distance < b.distance : a.distance > b.distance;
+        };
+        for (int q = 0; q < query_count; ++q) {
+            std::priority_queue<Head, std::vector<Head>, decltype(worse)> heads(worse);
+            for (size_t s = 0; s < active.size(); ++s) {
+                if (!shard_results[s][q].empty()) {
+                    heads.push(Head{shard_results[s][q][0].distance, s, 0});
+                }
+            }
+            std::vector<FaissIndex::SearchResult>& merged = results[q];
+            merged.reserve(static_cast<size_t>(k));
+            // A hot tier being merged and its main index can both hold a row for a moment
+            std::unordered_set<int64_t> seen;
+            while (!heads.empty() && merged.size() < static_cast<size_t>(k)) {
+                Head head = heads.top();
+                heads.pop();
+                const auto& list = shard_results[head.shard][q];
+                if (seen.insert(list[head.position].id).second) {
+                    merged.push_back(list[head.position]);
+                }
+                if (head.position + 1 < list.size()) {
+                    heads.push(Head{list[head.position + 1].distance, head.shard, head.position + 1});
+                }
+            }
+        }
+        return ResultCode::SUCCESS;
+    } //searchFaissShards
+    
+    /**
+     * @brief Search one query, in a batch with the queries of concurrent searches when possible (index_search_batcher_)
+     * 
+     * Filtered searches (params.allowed_ids) always run alone: their id lists differ per caller.
+     * Arguments and result as searchFaissShards with query_count = 1.
+     */
+    ResultCode searchFaissShardsBatched(const std::vector<std::shared_ptr<FaissIndex>>& shards, const float* query, int k,
+                                        const FaissIndex::SearchParams& params,
+                                        std::vector<std::vector<FaissIndex::SearchResult>>& results) {
+        if (!index_search_batcher_ || params.allowed_ids) {
+            return searchFaissShards(shards, query, 1, k, params, results);
+        }
+        IndexSearchRequest request;
+        request.shards = shards;
+        request.query = query;
+        request.k = k;
+        request.params = params;
+        IndexSearchResult result = index_search_batcher_->submit(std::move(request));
+        results.assign(1, std::move(result.hits));
+        return result.code;
+    }
+    
+    /**
+     * @brief Run one batch of index_search_batcher_
+     * 
+     * Searches over the same shards with the same probe settings share one batch_search per
+     * shard, at the largest k among them; each caller keeps its own top k.
+     */
+    void runIndexSearchBatch(std::vector<IndexSearchRequest>& requests, std::vector<IndexSearchResult>& results) {
+        const size_t dimension = static_cast<size_t>(config_.vector_search.dimension);
+        std::vector<bool> grouped(requests.size(), false);
+        for (size_t first = 0; first < requests.size(); ++first) {
+            if (grouped[first]) {
+                continue;
+            }
+            const IndexSearchRequest& lead = requests[first];
+            std::vector<size_t> group;
+            int k = 0;
+            for (size_t i = first; i < requests.size(); ++i) {
+                const IndexSearchRequest& request = requests[i];
+                if (!grouped[i] && request.shards == lead.shards && request.params.nprobe == lead.params.nprobe &&
+                    request.params.ef_search == lead.params.ef_search && request.params.max_codes == lead.params.max_codes) {
+                    grouped[i] = true;
+                    group.push_back(i);
+                    k = std::max(k, request.k);
+                }
+            }
+            
+            std::vector<float> stacked;
+            const float* queries = lead.query;
+            if (group.size() > 1) {
+                stacked.resize(group.size() * dimension);
+                for (size_t g = 0; g < group.size(); ++g) {
+                    std::memcpy(stacked.data() + g * dimension, requests[group[g]].query, dimension * sizeof(float));
+                }
+                queries = stacked.data();
+            }
+            std::vector<std::vector<FaissIndex::SearchResult>> hits;
+            ResultCode code = searchFaissShards(lead.shards, queries, static_cast<int>(group.size()), k, lead.params, hits);
+            for (size_t g = 0; g < group.size(); ++g) {
+                IndexSearchResult& result = results[group[g]];
+                result.code = code;
+                if (code == ResultCode::SUCCESS) {
+                    hits[g].resize(std::min(hits[g].size(), static_cast<size_t>(requests[group[g]].k)));
+                    result.hits = std::move(hits[g]);
+                }
+            }
+        }
+        if (requests.size() > 1) {
+            LEAFRA_DEBUG() << "Searched " << requests.size() << " concurrent queries in one batch";
+        }
+    } //runIndexSearchBatch
+    
+    /**
+     * @brief Trained type an adaptive FAISS index migrates to, and the vector count that triggers it
+     * 
+     * IVF_FLAT/IVF_PQ/SQ8/HNSW_SQ can't hold vectors before training, so they start out as FLAT and
+     * migrate once ivf_train_min_vectors exist; AUTO stays FLAT until auto_ivf_threshold.
+     * 
+     * @param target Output trained type
+     * @param threshold Output live vector count at which to migrate
+     * @return false if the configured index type never migrates (FLAT, HNSW, LSH, SQ_FP16, BINARY)
+     */
+    bool faissMigrationTarget(FaissIndex::IndexType& target, int64_t& threshold) const {
+        const VectorSearchConfig& vector_config = config_.vector_search;
+        if (vector_config.index_type == "AUTO") {
+            target = get_faiss_index_type_from_string(vector_config.auto_ivf_type);
+            threshold = vector_config.auto_ivf_threshold;
+            return true;
+        }
+        if (vector_config.index_type == "IVF_FLAT" || vector_config.index_type == "IVF_PQ" ||
+            vector_config.index_type == "SQ8" || vector_config.index_type == "HNSW_SQ") {
+            target = get_faiss_index_type_from_string(vector_config.index_type);
+            threshold = vector_config.ivf_train_min_vectors;
+            return true;
+        }
+        return false;
+    }
+    
+    /**
+     * @brief Train and swap in the IVF index once a FLAT-backed adaptive shard passes its threshold
+     * 
+     * Runs on the ingestion driver thread; searches keep using the FLAT index while the IVF one
+     * trains. A failed migration isn't retried until the next initialize.
+     * 
+     * @param collection Shard to check
+     * @return true if the index was migrated (it then needs a full save)
+     */
+    bool migrateFaissIndexIfNeeded(FaissCollection& collection) {
+        FaissIndex::IndexType target;
+        int64_t threshold = 0;
+        FaissIndex& faiss_index = *collection.index;
+        if (collection.migration_failed || !faissMigrationTarget(target, threshold) ||
+            faiss_index.get_index_type() != FaissIndex::IndexType::FLAT || faiss_index.get_count() < threshold) {
+            return false;
+        }
+        
+        auto start_time = debug::timer::now();
+        const VectorSearchConfig& vector_config = config_.vector_search;
+        if (faiss_index.migrate(target, vector_config.nlist, vector_config.m, vector_config.nbits) != ResultCode::SUCCESS) {
+            LEAFRA_WARNING() << "Failed to migrate FAISS index " << collection.definition << " to "
+                             << (vector_config.index_type == "AUTO" ? vector_config.auto_ivf_type : vector_config.index_type)
+                             << " - staying on flat search";
+            collection.migration_failed = true;
+            return false;
+        }
+        double elapsed_ms = debug::timer::elapsed_milliseconds(start_time, debug::timer::now());
+        LEAFRA_INFO() << "🚀 Migrated FAISS index " << collection.definition << " to " << faiss_index.get_index_type_string() << " ("
+                      << faiss_index.get_count() << " vectors, " << std::fixed << std::setprecision(1) << elapsed_ms << " ms)";
+        send_event(EventType::INDEX_UPDATED, "FAISS index migrated to " + faiss_index.get_index_type_string());
+        return true;
+    } //migrateFaissIndexIfNeeded
+    
+    /**
+     * @brief Fold the FAISS delta log into a fresh index blob
+     * 
+     * Also purges tombstoned IVF/HNSW vectors once they exceed tombstone_rebuild_ratio of the
+     * index, so deleted documents stop costing memory and search time, and migrates adaptive
+     * indexes to IVF once they grow past their threshold (see migrateFaissIndexIfNeeded).
+     * 
+     * @param force Compact even if fewer than delta_compaction_threshold entries are pending
+     */
+    void compactFaissIndex(bool force) {
+        std::vector<FaissCollection*> collections;
+        {
+            std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+            for (auto& entry : faiss_collections_) {
+                collections.push_back(&entry.second);
+            }
+        }
+        for (FaissCollection* collection : collections) {
+            compactFaissCollection(*collection, force);
+        }
+    } //compactFaissIndex
+    
+    /**
+     * @brief compactFaissIndex for a single collection
+     * @param collection Shard to compact
+     * @param force Compact even if fewer than delta_compaction_threshold entries are pending
+     */
+    void compactFaissCollection(FaissCollection& collection, bool force) {
+        // A hot tier is left to the background merge unless the index is about to be saved
+        const bool hot_tier = config_.vector_search.hot_index;
+        if (!hot_tier) {
+            flushPendingFaissVectors(collection);
+        }
+#ifdef LEAFRA_HAS_SQLITE
+        if (!database_ || !database_->isOpen()) {
+            return;
+        }
+        // A backup is copying the index files - they and the delta log stay as they are until it's done
+        std::unique_lock<std::recursive_mutex> files_lock(faiss_files_mutex_, std::defer_lock);
+        if (config_.vector_search.index_storage == "file" && !files_lock.try_lock()) {
+            LEAFRA_DEBUG() << "Backup running - FAISS compaction of " << collection.definition << " deferred";
+            return;
+        }
+        FaissIndex& faiss_index = *collection.index;
+        int64_t pending = faiss_index.get_pending_delta_count();
+        int64_t threshold = config_.vector_search.delta_compaction_threshold;
+        float rebuild_ratio = config_.vector_search.tombstone_rebuild_ratio;
+        auto start_time = debug::timer::now();
+        
+        // Migration copies only live vectors, so it also leaves no tombstones behind
+        bool migrated = migrateFaissIndexIfNeeded(collection);
+        bool purge = !migrated && faiss_index.get_tombstone_count() > 0 && rebuild_ratio > 0.0f &&
+                     faiss_index.get_tombstone_ratio() >= rebuild_ratio;
+        if (!migrated && !purge && (pending == 0 || (!force && pending < threshold))) {
+            return;
+        }
+        if (hot_tier) {
+            flushPendingFaissVectors(collection);
+        }
+        
+        if (purge) {
+            int64_t tombstones = faiss_index.get_tombstone_count();
+            if (faiss_index.purge_tombstones() == ResultCode::SUCCESS) {
+                LEAFRA_INFO() << "🧹 Rebuilt FAISS index " << collection.definition << " without " << tombstones << " removed vectors ("
+                              << faiss_index.get_count() << " live)";
+            } else {
+                LEAFRA_WARNING() << "Failed to purge FAISS tombstones - removed vectors stay hidden from search";
+            }
+        }
+        ResultCode save_result = saveFaissCollection(collection);
+        if (save_result == ResultCode::SUCCESS) {
+            double elapsed_ms = debug::timer::elapsed_milliseconds(start_time, debug::timer::now());
+            LEAFRA_INFO() << "🗜️ Compacted " << pending << " FAISS delta entries into " << collection.definition << " ("
+                          << std::fixed << std::setprecision(1) << elapsed_ms << " ms)";
+        } else {
+            LEAFRA_WARNING() << "Failed to compact FAISS delta log - deltas stay in place and are replayed on load";
+        }
+#else
+        (void)force;
+#endif
+    } //compactFaissCollection
+
+#ifdef LEAFRA_HAS_SQLITE
+    /**
+     * @brief Rebuild the FAISS index from chunk_embeddings when no saved index exists
+     * 
+     * Rows are decoded from their stored encoding straight into a reused batch buffer;
+     * rows of another dimension than the index (a different embedding model) are skipped.
+     * The rebuilt index is saved right away so the next start restores it instead.
+     * 
+     * @param table Table to read (chunk_embeddings, or chunk_embeddings_shadow for a re-index)
+     * @param save Save the index once rebuilt (a re-index saves it when it swaps it in)
+     * @return Number of vectors added to the index
+     */
+    size_t rebuildFaissIndexFromEmbeddings(FaissCollection& collection, const std::string& table = "chunk_embeddings",
+                                           bool save = true) {
+        static constexpr size_t kBatchRows = 1024;
+        FaissIndex& faiss_index = *collection.index;
+        const size_t dimension = static_cast<size_t>(faiss_index.get_dimension());
+        
+        auto stmt = database_->prepare(
+            "SELECT e.chunk_faiss_id, e.format, e.byte_order, e.dimension, e.scale, e.embedding FROM " + table + " e "
+            "JOIN chunks c ON c.chunk_faiss_id = e.chunk_faiss_id JOIN docs d ON d.id = c.doc_id "
+            "WHERE d.collection = ? ORDER BY e.chunk_faiss_id");
+        if (!stmt || !stmt->isValid() || !stmt->bindText(1, collection.name)) {
+            LEAFRA_WARNING() << "Failed to prepare chunk embedding scan, FAISS index stays empty";
+            return 0;
+        }
+        
+        auto start_time = debug::timer::now();
+        std::vector<int64_t> ids;
+        std::vector<float> vectors;
+        ids.reserve(kBatchRows);
+        vectors.reserve(kBatchRows * dimension);
+        size_t added = 0;
+        size_t skipped = 0;
+        bool ok = true;
+        auto add_batch = [&]() {
+            if (ids.empty()) {
+                return;
+            }
+            if (faiss_index.add_vectors_with_ids(vectors.data(), ids.data(), static_cast<int>(ids.size())) == ResultCode::SUCCESS) {
+                added += ids.size();
+            } else {
+                ok = false;
+            }
+            ids.clear();
+            vectors.clear();
+        };
+        
+        bool stepped = stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+            SQLiteDatabase::BlobView blob = row.getBlobView(5);
+            size_t offset = vectors.size();
+            vectors.resize(offset + dimension);
+            if (static_cast<size_t>(row.getInt(3)) != dimension ||
+                !VectorCodec::decode(static_cast<EmbeddingStorageFormat>(row.getInt(1)), static_cast<ByteOrder>(row.getInt(2)),
+                                     static_cast<float>(row.getDouble(4)), blob.data, blob.size, vectors.data() + offset, dimension)) {
+                vectors.resize(offset);
+                skipped++;
+                return true;
+            }
+            ids.push_back(row.getInt64(0));
+            if (ids.size() == kBatchRows) {
+                add_batch();
+            }
+            return ok;
+        });
+        add_batch();
+        
+        if (!stepped || !ok) {
+            LEAFRA_WARNING() << "FAISS rebuild from chunk embeddings stopped after " << added << " vectors";
+        }
+        if (skipped > 0) {
+            LEAFRA_WARNING() << "Skipped " << skipped << " chunk embeddings with a different dimension or unknown encoding";
+        }
+        if (added == 0) {
+            return 0;
+        }
+        
+        if (save && saveFaissCollection(collection) != ResultCode::SUCCESS) {
+            LEAFRA_WARNING() << "Failed to save rebuilt FAISS index - it will be rebuilt again on the next start";
+        }
+        double elapsed_ms = debug::timer::elapsed_milliseconds(start_time, debug::timer::now());
+        LEAFRA_INFO() << "🔁 Rebuilt FAISS index " << collection.definition << " from " << added << " stored chunk embeddings ("
+                      << std::fixed << std::setprecision(1) << elapsed_ms << " ms)";
+        return added;
+    } //rebuildFaissIndexFromEmbeddings
+    
+    /**
+     * @brief Body of reindex_embeddings_async: embed every stored chunk with target's model, then switch to it
+     * 
+     * 1. Loads the target tokenizer and model next to the current ones.
+     * 2. Pages through the chunks by chunk_faiss_id on a read connection and embeds each page
+     *    behind searches and ingestion (bulk lane, governor permit) into chunk_embeddings_shadow;
+     *    only the writes take the ingestion lock.
+     * 3. Holding the ingestion lock: embeds the chunks stored since, builds and saves every
+     *    collection's index from the shadow rows, and moves those into chunk_embeddings with the
+     *    model recorded in index_models. While the indexes are saved index_models names no model,
+     *    so an interrupted swap leaves them stale on the next start rather than mismatched.
+     * 4. Swaps model, tokenizer and indexes under model_swap_mutex_ and drops the old model's caches.
+     * 
+     * @param target Configuration with the new embedding_inference, tokenizer and vector_search.dimension
+     * @return ResultCode of the re-index (ERROR_CANCELLED if cancel_reindex or shutdown stopped it)
+     */
+    ResultCode runReindex(const Config& target) {
+        static constexpr int kPageRows = 256;
+        auto start_time = debug::timer::now();
+        const std::string model_id = embeddingModelId(target);
+        const int32_t dimension = target.vector_search.dimension;
+        
+        std::shared_ptr<const SentencePieceTokenizer> tokenizer = std::make_shared<SentencePieceTokenizer>();
+        if (target.tokenizer.enabled && !target.tokenizer.model_path.empty()) {
+            tokenizer = SentencePieceTokenizer::acquire_shared(target.tokenizer);
+            if (!tokenizer) {
+                LEAFRA_ERROR() << "❌ Re-index: failed to load SentencePiece model from " << target.tokenizer.model_path;
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+        }
+        std::unique_ptr<EmbeddingScheduler> scheduler;
+        std::unique_ptr<EmbeddingScheduler> query_scheduler;
+        if (createEmbeddingSchedulers(target, *tokenizer, scheduler, query_scheduler) != ResultCode::SUCCESS ||
+            !scheduler || !scheduler->is_ready()) {
+            LEAFRA_ERROR() << "❌ Re-index: embedding model " << target.embedding_inference.model_path << " could not be loaded";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        if (scheduler->backend().getEmbeddingDimension() != static_cast<size_t>(dimension)) {
+            LEAFRA_ERROR() << "❌ Re-index: " << target.embedding_inference.model_path << " embeds "
+                           << scheduler->backend().getEmbeddingDimension() << " dimensions, not " << dimension;
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+        const bool needs_tokens = scheduler->backend().requiresTokenIds();
+        if (needs_tokens && !tokenizer->is_loaded()) {
+            LEAFRA_ERROR() << "❌ Re-index: " << target.embedding_inference.model_path << " needs a SentencePiece tokenizer";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        
+        size_t total_chunks = 0;
+        {
+            std::lock_guard<std::mutex> ingestion_lock(ingestion_mutex_);
+            if (!database_->dropShadowEmbeddingsTable() || !database_->createShadowEmbeddingsTable()) {
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            auto count = database_->prepare("SELECT COUNT(*) FROM chunks WHERE chunk_faiss_id IS NOT NULL");
+            if (count && count->isValid() && count->step()) {
+                total_chunks = static_cast<size_t>(count->getCurrentRow().getInt64(0));
+            }
+        }
+        size_t embedded = 0;
+        auto report = [&](ReindexPhase phase) {
+            std::lock_guard<std::mutex> lock(reindex_progress_mutex_);
+            reindex_progress_.phase = phase;
+            reindex_progress_.total_chunks = total_chunks;
+            reindex_progress_.embedded_chunks = embedded;
+            reindex_progress_.elapsed_ms = debug::timer::elapsed_milliseconds(start_time, debug::timer::now());
+        };
+        report(ReindexPhase::EMBEDDING);
+        LEAFRA_INFO() << "🔁 Re-indexing " << total_chunks << " chunks with embedding model " << model_id;
+        
+        // Shadow rows keep full precision when chunk_embeddings aren't stored: the new indexes are built from them
+        const std::string prefix = passagePrefix(target.tokenizer);
+        const EmbeddingStorageFormat format = embedding_storage_format_ == EmbeddingStorageFormat::NONE
+                                                  ? EmbeddingStorageFormat::FP32 : embedding_storage_format_;
+        std::vector<int64_t> ids;
+        std::vector<std::string> texts;
+        std::vector<TextChunk> chunks;
+        size_t failed_chunks = 0;
+        
+        // Chunk texts must outlive the chunks, which only hold views into them
+        auto embed = [&]() {
+            chunks.assign(texts.size(), TextChunk());
+            for (size_t i = 0; i < texts.size(); ++i) {
+                texts[i].insert(0, prefix);
+                chunks[i].content = texts[i];
+                if (needs_tokens && !tokenizer->encode_as_ids(texts[i], chunks[i].token_ids, SentencePieceTokenizer::TokenizeOptions())) {
+                    LEAFRA_WARNING() << "Re-index: SentencePiece tokenization failed for chunk " << ids[i] << ": " << tokenizer->get_last_error();
+                }
+            }
+            AdmissionController::Permit permit(admission_, AdmissionResource::EMBEDDER, AdmissionLane::BULK);
+            scheduler->embed_chunks(chunks);
+        };
+        // Caller holds ingestion_mutex_ (the writer connection)
+        auto store = [&]() {
+            auto insert = database_->prepareCached(
+                "INSERT OR REPLACE INTO chunk_embeddings_shadow (chunk_faiss_id, format, byte_order, dimension, scale, embedding) "
+                "VALUES (?, ?, ?, ?, ?, ?)");
+            if (!insert.isValid()) {
+                return false;
+            }
+            SQLiteTransaction transaction(*database_);
+            VectorCodec::Encoded encoded;
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                if (!chunks[i].has_embedding() ||
+                    !VectorCodec::encode(chunks[i].embedding.data(), chunks[i].embedding.size(), format, encoded)) {
+                    failed_chunks++;
+                    continue;
+                }
+                insert->reset();
+                if (!insert->bindInt64(1, ids[i]) || !insert->bindInt(2, static_cast<int>(encoded.format)) ||
+                    !insert->bindInt(3, static_cast<int>(encoded.byte_order)) || !insert->bindInt(4, dimension) ||
+                    !insert->bindDouble(5, encoded.scale) || !insert->bindBlobView(6, encoded.data.data(), encoded.data.size()) ||
+                    !insert->execute()) {
+                    LEAFRA_ERROR() << "Re-index: failed to write shadow embeddings: " << database_->getLastErrorMessage();
+                    return false;
+                }
+            }
+            return transaction.commit();
+        };
+        auto read_page = [&](SQLiteDatabase::Statement& page, int64_t after) {
+            ids.clear();
+            texts.clear();
+            if (!page.bindInt64(1, after) || !page.bindInt(2, kPageRows)) {
+                return false;
+            }
+            return page.forEachRow([&](const SQLiteDatabase::Row& row) {
+                ids.push_back(row.getInt64(0));
+                texts.emplace_back();
+                readChunkText(row, 1, texts.back());
+                return true;
+            });
+        };
+        
+        int64_t last_id = std::numeric_limits<int64_t>::min();
+        while (true) {
+            if (reindex_cancelled_) {
+                return ResultCode::ERROR_CANCELLED;
+            }
+            {
+                SQLiteReadPool::Lease reader = read_pool_.acquire(database_.get());
+                auto page = reader->prepareCached(
+                    "SELECT c.chunk_faiss_id, "
+                    "CASE WHEN c.chunk_start IS NULL THEN c.chunk_text ELSE leafra_chunk_text(c.chunk_text, c.doc_id, c.chunk_start, c.chunk_end) END "
+                    "FROM chunks c WHERE c.chunk_faiss_id > ? ORDER BY c.chunk_faiss_id LIMIT ?");
+                if (!page.isValid() || !read_page(*page, last_id)) {
+                    LEAFRA_ERROR() << "Re-index: failed to read chunks: " << reader->getLastErrorMessage();
+                    return ResultCode::ERROR_PROCESSING_FAILED;
+                }
+            }
+            if (ids.empty()) {
+                break;
+            }
+            last_id = ids.back();
+            {
+                ThroughputGovernor::IngestPermit permit(governor_);   // Steps back while searches run
+                embed();
+            }
+            std::lock_guard<std::mutex> ingestion_lock(ingestion_mutex_);
+            if (!store()) {
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            embedded += ids.size();
+            report(ReindexPhase::EMBEDDING);
+        }
+        
+        report(ReindexPhase::SWAPPING);
+        std::lock_guard<std::mutex> ingestion_lock(ingestion_mutex_);
+        if (reindex_cancelled_) {
+            return ResultCode::ERROR_CANCELLED;
+        }
+        
+        // Chunks stored since their page was read (and any that failed to embed before)
+        failed_chunks = 0;
+        int64_t caught_up_id = std::numeric_limits<int64_t>::min();
+        while (true) {
+            auto page = database_->prepareCached(
+                "SELECT c.chunk_faiss_id, "
+                "CASE WHEN c.chunk_start IS NULL THEN c.chunk_text ELSE leafra_chunk_text(c.chunk_text, c.doc_id, c.chunk_start, c.chunk_end) END "
+                "FROM chunks c LEFT JOIN chunk_embeddings_shadow s ON s.chunk_faiss_id = c.chunk_faiss_id "
+                "WHERE c.chunk_faiss_id > ? AND s.chunk_faiss_id IS NULL ORDER BY c.chunk_faiss_id LIMIT ?");
+            if (!page.isValid() || !read_page(*page, caught_up_id)) {
+                LEAFRA_ERROR() << "Re-index: failed to read new chunks: " << database_->getLastErrorMessage();
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            if (ids.empty()) {
+                break;
+            }
+            caught_up_id = ids.back();
+            embed();
+            if (!store()) {
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            embedded += ids.size();
+        }
+        report(ReindexPhase::SWAPPING);
+        if (failed_chunks > 0) {
+            LEAFRA_WARNING() << "⚠️  Re-index: " << failed_chunks << " chunks could not be embedded and are left out of the new indexes";
+        }
+        
+        // Every open collection is rebuilt, plus the stored ones not opened yet
+        std::vector<std::string> names = storedCollectionNames();
+        {
+            std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+            for (const auto& entry : faiss_collections_) {
+                if (std::find(names.begin(), names.end(), entry.first) == names.end()) {
+                    names.push_back(entry.first);
+                }
+            }
+        }
+        std::vector<FaissCollection> rebuilt;
+        for (const std::string& name : names) {
+            FaissCollection collection;
+            collection.name = name;
+            collection.definition = faissDefinition(name);
+            try {
+                collection.index = createFaissIndex(dimension);
+            } catch (const std::exception& e) {
+                LEAFRA_ERROR() << "Re-index: failed to create FAISS index: " << e.what();
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            rebuildFaissIndexFromEmbeddings(collection, "chunk_embeddings_shadow", false);
+            migrateFaissIndexIfNeeded(collection);
+            rebuilt.push_back(std::move(collection));
+        }
+        
+        int64_t version = 1;
+        auto latest = database_->prepare("SELECT MAX(version) FROM index_models");
+        if (latest && latest->isValid() && latest->step()) {
+            version = latest->getCurrentRow().getInt64(0) + 1;
+        }
+        latest.reset();
+        for (const FaissCollection& collection : rebuilt) {
+            recordIndexModel(collection.definition, "", dimension, version);
+        }
+        for (FaissCollection& collection : rebuilt) {
+            if (saveFaissCollection(collection) != ResultCode::SUCCESS) {
+                LEAFRA_ERROR() << "❌ Re-index: failed to save the new FAISS index " << collection.definition
+                               << " - the current indexes serve until shutdown, re-index again";
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+        }
+        {
+            SQLiteTransaction transaction(*database_);
+            bool moved = database_->execute("DELETE FROM chunk_embeddings") && database_->execute("DELETE FROM doc_centroids");
+            if (moved && embedding_storage_format_ != EmbeddingStorageFormat::NONE) {
+                moved = database_->execute(
+                    "INSERT INTO chunk_embeddings (chunk_faiss_id, format, byte_order, dimension, scale, embedding) "
+                    "SELECT s.chunk_faiss_id, s.format, s.byte_order, s.dimension, s.scale, s.embedding FROM chunk_embeddings_shadow s "
+                    "JOIN chunks c ON c.chunk_faiss_id = s.chunk_faiss_id");
+            }
+            for (const FaissCollection& collection : rebuilt) {
+                moved = moved && recordIndexModel(collection.definition, model_id, dimension, version);
+            }
+            if (!moved || !transaction.commit()) {
+                LEAFRA_ERROR() << "❌ Re-index: failed to move the new embeddings: " << database_->getLastErrorMessage();
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+        }
+        database_->dropShadowEmbeddingsTable();
+        
+        // Old engines are released once no search holds them any more
+        std::unique_ptr<EmbeddingScheduler> previous_scheduler;
+        std::unique_ptr<EmbeddingScheduler> previous_query_scheduler;
+        {
+            std::unique_lock<std::shared_mutex> swap_lock(model_swap_mutex_);
+            config_.embedding_inference = target.embedding_inference;
+            config_.tokenizer = target.tokenizer;
+            config_.vector_search.dimension = dimension;
+            previous_scheduler = std::move(embedding_scheduler_);
+            previous_query_scheduler = std::move(query_scheduler_);
+            embedding_scheduler_ = std::move(scheduler);
+            query_scheduler_ = std::move(query_scheduler);
+            std::swap(tokenizer_, tokenizer);
+            {
+                std::lock_guard<std::mutex> merge_lock(faiss_merge_mutex_);
+                std::lock_guard<std::mutex> lock(faiss_collections_mutex_);
+                for (FaissCollection& collection : rebuilt) {
+                    auto it = faiss_collections_.find(collection.name);
+                    if (it == faiss_collections_.end()) {
+                        faiss_collections_.emplace(collection.name, std::move(collection));
+                        continue;
+                    }
+                    FaissCollection& existing = it->second;
+                    existing.generation_base += existing.index->get_generation() + 1;
+                    existing.index = std::move(collection.index);
+                    existing.migration_failed = collection.migration_failed;
+                    // Queued rows are of the old model; the shadow rows covered their chunks
+                    existing.pending_vectors.clear();
+                    existing.pending_ids.clear();
+                    existing.hot.reset();
+                    existing.hot_generation++;
+                    existing.stale = false;
+                }
+            }
+            std::lock_guard<std::mutex> lock(query_mutex_);
+            query_embedding_cache_.clear();
+            search_result_cache_.clear();
+#ifdef LEAFRA_HAS_LLAMACPP
+            answer_cache_.clear();
+#endif
+        }
+        loadDocumentIndex();    // Centroids of the new embeddings, backfilled from chunk_embeddings
+        
+        {
+            std::lock_guard<std::mutex> lock(reindex_progress_mutex_);
+            reindex_progress_.version = version;
+        }
+        report(ReindexPhase::SWAPPING);
+        LEAFRA_INFO() << "🔁 Re-indexed " << embedded << " chunks with " << model_id << " (index version " << version << ", "
+                      << std::fixed << std::setprecision(1) << debug::timer::elapsed_milliseconds(start_time, debug::timer::now()) << " ms)";
+        send_event(EventType::INDEX_UPDATED, "🔁 Re-indexed with embedding model " + model_id);
+        return ResultCode::SUCCESS;
+    } //runReindex
+    
+    /**
+     * @brief Record how a re-index ended, dropping its shadow embeddings unless it swapped them in
+     */
+    void finishReindex(ResultCode result) {
+        if (result != ResultCode::SUCCESS) {
+            std::lock_guard<std::mutex> ingestion_lock(ingestion_mutex_);
+            if (database_ && database_->isOpen()) {
+                database_->dropShadowEmbeddingsTable();
+            }
+        }
+        ReindexPhase phase = result == ResultCode::SUCCESS ? ReindexPhase::DONE
+                           : result == ResultCode::ERROR_CANCELLED ? ReindexPhase::CANCELLED : ReindexPhase::FAILED;
+        {
+            std::lock_guard<std::mutex> lock(reindex_progress_mutex_);
+            reindex_progress_.phase = phase;
+        }
+        if (phase == ReindexPhase::CANCELLED) {
+            LEAFRA_INFO() << "Re-index cancelled - the current embedding model stays in use";
+        } else if (phase == ReindexPhase::FAILED) {
+            send_event(EventType::ERROR_OCCURRED, "❌ Re-index with another embedding model failed");
+        }
+    }
+#endif
+    
+    /**
+     * @brief Embed the same texts with the loaded model and a candidate and compare their neighbour rankings
+     * @param texts Texts to compare on; empty samples sample_size stored chunks
+     */
+    ResultCode validateEmbeddingModel(const EmbeddingModelConfig& candidate, std::vector<std::string> texts, int32_t k,
+                                      int32_t sample_size, EmbeddingModelValidation& validation) {
+        ModelUse model_use(model_swap_mutex_);
+        if (!hasEmbeddingModel()) {
+            LEAFRA_ERROR() << "No embedding model loaded to validate against";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        if (texts.empty()) {
+#ifdef LEAFRA_HAS_SQLITE
+            if (database_ && database_->isOpen()) {
+                SQLiteReadPool::Lease reader = read_pool_.acquire(database_.get());
+                auto sample = reader->prepare(
+                    "SELECT CASE WHEN c.chunk_start IS NULL THEN c.chunk_text ELSE leafra_chunk_text(c.chunk_text, c.doc_id, c.chunk_start, c.chunk_end) END "
+                    "FROM chunks c ORDER BY random() LIMIT ?");
+                if (sample && sample->isValid() && sample->bindInt(1, std::max(1, sample_size))) {
+                    sample->forEachRow([&](const SQLiteDatabase::Row& row) {
+                        texts.emplace_back();
+                        readChunkText(row, 0, texts.back());
+                        return true;
+                    });
+                }
+            }
+#else
+            (void)sample_size;
+#endif
+        }
+        if (k <= 0 || texts.size() <= static_cast<size_t>(k)) {
+            LEAFRA_ERROR() << "Validating an embedding model needs more than k = " << k << " texts, got " << texts.size();
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+        
+        Config target = config_;
+        target.embedding_inference = candidate;
+        target.embedding_inference.query_instance = false;
+        target.vector_search.dimension = 0;     // Checked against the loaded model below
+        std::unique_ptr<EmbeddingScheduler> scheduler;
+        std::unique_ptr<EmbeddingScheduler> query_scheduler;
+        if (createEmbeddingSchedulers(target, *tokenizer_, scheduler, query_scheduler) != ResultCode::SUCCESS ||
+            !scheduler || !scheduler->is_ready()) {
+            LEAFRA_ERROR() << "❌ Candidate embedding model " << candidate.model_path << " could not be loaded";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        const size_t dimension = embedding_scheduler_->backend().getEmbeddingDimension();
+        if (scheduler->backend().getEmbeddingDimension() != dimension) {
+            LEAFRA_ERROR() << "❌ Candidate " << candidate.model_path << " embeds " << scheduler->backend().getEmbeddingDimension()
+                           << " dimensions, the loaded model " << dimension;
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+        
+        const std::string prefix = passagePrefix();
+        for (std::string& text : texts) {
+            text.insert(0, prefix);
+        }
+        const size_t count = texts.size();
+        // Chunk texts must outlive the chunks, which only hold views into them
+        auto embed = [&](EmbeddingScheduler& model, std::vector<float>& rows, double& elapsed_ms) {
+            std::vector<TextChunk> chunks(count);
+            const bool needs_tokens = model.backend().requiresTokenIds();
+            for (size_t i = 0; i < count; ++i) {
+                chunks[i].content = texts[i];
+                if (needs_tokens) {
+                    tokenizer_->encode_as_ids(texts[i], chunks[i].token_ids, SentencePieceTokenizer::TokenizeOptions());
+                }
+            }
+            auto start = debug::timer::now();
+            {
+                ThroughputGovernor::IngestPermit ingest_permit(governor_);
+                AdmissionController::Permit permit(admission_, AdmissionResource::EMBEDDER, AdmissionLane::BULK);
+                model.embed_chunks(chunks);
+            }
+            elapsed_ms = debug::timer::elapsed_milliseconds(start, debug::timer::now());
+            rows.assign(count * dimension, 0.0f);
+            for (size_t i = 0; i < count; ++i) {
+                if (!chunks[i].has_embedding() || chunks[i].embedding.size() != dimension) {
+                    return false;
+                }
+                std::copy(chunks[i].embedding.begin(), chunks[i].embedding.end(), rows.begin() + i * dimension);
+            }
+            return true;
+        };
+        std::vector<float> reference;
+        std::vector<float> candidate_rows;
+        validation = EmbeddingModelValidation();
+        if (!embed(*embedding_scheduler_, reference, validation.reference_ms) ||
+            !embed(*scheduler, candidate_rows, validation.candidate_ms)) {
+            LEAFRA_ERROR() << "❌ Embedding model validation: not every sample could be embedded";
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        
+        // Paired agreement first, then rank with the search metric (unit vectors for COSINE)
+        double cosine_sum = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            const float* a = reference.data() + i * dimension;
+            const float* b = candidate_rows.data() + i * dimension;
+            const double norms = std::sqrt(static_cast<double>(simd::dot(a, a, dimension)) * simd::dot(b, b, dimension));
+            cosine_sum += norms > 0.0 ? simd::dot(a, b, dimension) / norms : 0.0;
+        }
+        const std::string& metric = config_.vector_search.metric;
+        if (metric == "COSINE") {
+            simd::l2_normalize_rows(reference.data(), count, dimension);
+            simd::l2_normalize_rows(candidate_rows.data(), count, dimension);
+        }
+        const size_t top_k = static_cast<size_t>(k);
+        std::vector<float> scores(count);
+        auto neighbours = [&](const std::vector<float>& rows, size_t query, std::vector<size_t>& top) {
+            if (metric == "L2") {
+                simd::squared_l2_batch(rows.data() + query * dimension, rows.data(), count, dimension, scores.data());
+                for (float& score : scores) {
+                    score = -score;
+                }
+            } else {
+                simd::dot_batch(rows.data() + query * dimension, rows.data(), count, dimension, scores.data());
+            }
+            scores[query] = -std::numeric_limits<float>::infinity();   // A text is not its own neighbour
+            top.resize(count);
+            std::iota(top.begin(), top.end(), size_t(0));
+            std::partial_sort(top.begin(), top.begin() + top_k, top.end(),
+                              [&](size_t a, size_t b) { return scores[a] > scores[b]; });
+            top.resize(top_k);
+            std::sort(top.begin(), top.end());
+        };
+        std::vector<size_t> expected;
+        std::vector<size_t> found;
+        double recall_sum = 0.0;
+        double min_recall = 1.0;
+        for (size_t query = 0; query < count; ++query) {
+            neighbours(reference, query, expected);
+            neighbours(candidate_rows, query, found);
+            size_t overlap = 0;
+            for (size_t i = 0, j = 0; i < top_k && j < top_k;) {
+                if (expected[i] == found[j]) {
+                    overlap++;
+                    i++;
+                    j++;
+                } else if (expected[i] < found[j]) {
+                    i++;
+                } else {
+                    j++;
+                }
+            }
+            const double recall = static_cast<double>(overlap) / top_k;
+            recall_sum += recall;
+            min_recall = std::min(min_recall, recall);
+        }
+        
+        validation.k = k;
+        validation.samples = count;
+        validation.dimension = dimension;
+        validation.recall_at_k = recall_sum / count;
+        validation.min_recall_at_k = min_recall;
+        validation.mean_cosine = cosine_sum / count;
+        validation.candidate_quantized = scheduler->backend().isQuantized();
+        LEAFRA_INFO() << "📏 Validated " << candidate.model_path << " on " << count << " texts: recall@" << k << " "
+                      << std::fixed << std::setprecision(3) << validation.recall_at_k << " (min " << min_recall
+                      << "), mean cosine " << validation.mean_cosine << std::setprecision(1) << ", "
+                      << validation.reference_ms << " ms vs " << validation.candidate_ms << " ms";
+        return ResultCode::SUCCESS;
+    } //validateEmbeddingModel
+    
+#ifdef LEAFRA_HAS_SQLITE
+    /**
+     * @brief Add one chunk embedding to a document's running centroid sum (unit-length chunks for COSINE)
+     */
+    void accumulateCentroid(const float* embedding, size_t dimension, std::vector<float>& sum) const {
+        sum.resize(dimension, 0.0f);
+        float norm = 0.0f;
+        for (size_t i = 0; i < dimension; ++i) {
+            norm += embedding[i] * embedding[i];
+        }
+        const float scale = config_.vector_search.metric == "COSINE" && norm > 0.0f ? 1.0f / std::sqrt(norm) : 1.0f;
+        for (size_t i = 0; i < dimension; ++i) {
+            sum[i] += embedding[i] * scale;
+        }
+    }
+    
+    /**
+     * @brief Turn a centroid sum into the mean and store it as the document's doc_centroids row
+     * @param sum Sum of chunk_count chunk embeddings, replaced with their mean
+     */
+    bool storeDocumentCentroid(int64_t doc_id, std::vector<float>& sum, size_t chunk_count) {
+        if (sum.empty() || chunk_count == 0) {
+            return true;
+        }
+        for (float& value : sum) {
+            value /= static_cast<float>(chunk_count);
+        }
+        VectorCodec::Encoded encoded;
+        VectorCodec::encode(sum.data(), sum.size(), EmbeddingStorageFormat::FP32, encoded);
+        auto stmt = database_->prepareCached(
+            "INSERT OR REPLACE INTO doc_centroids (doc_id, chunk_count, format, byte_order, dimension, scale, embedding) "
+            "VALUES (?, ?, ?, ?, ?, ?, ?)");
+        return stmt && stmt->isValid() &&
+               stmt->bindInt64(1, doc_id) && stmt->bindInt64(2, static_cast<long long>(chunk_count)) &&
+               stmt->bindInt(3, static_cast<int>(encoded.format)) && stmt->bindInt(4, static_cast<int>(encoded.byte_order)) &&
+               stmt->bindInt(5, static_cast<int>(sum.size())) && stmt->bindDouble(6, encoded.scale) &&
+               stmt->bindBlobView(7, encoded.data.data(), encoded.data.size()) && stmt->execute();
+    }
+    
+    /**
+     * @brief Build the document-level index from doc_centroids (vector_search.document_prefilter > 0)
+     * 
+     * Documents stored before hierarchical search was turned on get their centroid computed
+     * from chunk_embeddings first; without stored embeddings they can't be selected, so the
+     * index is dropped and searches stay flat.
+     */
+    void loadDocumentIndex() {
+        std::lock_guard<std::mutex> lock(document_index_mutex_);
+        document_index_.reset();
+        if (config_.vector_search.document_prefilter <= 0 || !database_ || !database_->isOpen()) {
+            return;
+        }
+        auto start_time = debug::timer::now();
+        const size_t dimension = static_cast<size_t>(config_.vector_search.dimension);
+        
+        // Backfill, one document at a time (rows come ordered by doc_id)
+        size_t backfilled = 0;
+        size_t missing = 0;
+        auto scan = database_->prepare(
+            "SELECT c.doc_id, e.format, e.byte_order, e.dimension, e.scale, e.embedding FROM chunks c "
+            "JOIN chunk_embeddings e ON e.chunk_faiss_id = c.chunk_faiss_id "
+            "WHERE c.doc_id NOT IN (SELECT doc_id FROM doc_centroids) ORDER BY c.doc_id");
+        if (scan && scan->isValid()) {
+            SQLiteTransaction transaction(*database_);
+            std::vector<float> embedding(dimension);
+            std::vector<float> sum;
+            int64_t current_doc = -1;
+            size_t chunk_count = 0;
+            auto finish_document = [&]() {
+                if (chunk_count > 0 && storeDocumentCentroid(current_doc, sum, chunk_count)) {
+                    backfilled++;
+                }
+                sum.clear();
+                chunk_count = 0;
+            };
+            scan->forEachRow([&](const SQLiteDatabase::Row& row) {
+                const int64_t doc_id = row.getInt64(0);
+                if (doc_id != current_doc) {
+                    finish_document();
+                    current_doc = doc_id;
+                }
+                SQLiteDatabase::BlobView blob = row.getBlobView(5);
+                if (static_cast<size_t>(row.getInt(3)) == dimension &&
+                    VectorCodec::decode(static_cast<EmbeddingStorageFormat>(row.getInt(1)), static_cast<ByteOrder>(row.getInt(2)),
+                                        static_cast<float>(row.getDouble(4)), blob.data, blob.size, embedding.data(), dimension)) {
+                    accumulateCentroid(embedding.data(), dimension, sum);
+                    chunk_count++;
+                }
+                return true;
+            });
+            finish_document();
+            transaction.commit();
+        }
+        auto uncovered = database_->prepare(
+            "SELECT COUNT(*) FROM docs WHERE id NOT IN (SELECT doc_id FROM doc_centroids) "
+            "AND id IN (SELECT doc_id FROM chunks)");
+        if (uncovered && uncovered->isValid() && uncovered->step()) {
+            missing = static_cast<size_t>(uncovered->getCurrentRow().getInt64(0));
+        }
+        if (missing > 0) {
+            LEAFRA_WARNING() << missing << " documents have no stored chunk embeddings for a centroid - hierarchical search disabled";
+            return;
+        }
+        
+        auto index = std::make_unique<FaissIndex>(config_.vector_search.dimension, FaissIndex::IndexType::FLAT,
+                                                  get_faiss_metric_type_from_string(config_.vector_search.metric));
+        std::vector<int64_t> ids;
+        std::vector<float> vectors;
+        auto rows = database_->prepare("SELECT doc_id, format, byte_order, dimension, scale, embedding FROM doc_centroids");
+        if (!rows || !rows->isValid()) {
+            LEAFRA_WARNING() << "Failed to read document centroids - hierarchical search disabled";
+            return;
+        }
+        rows->forEachRow([&](const SQLiteDatabase::Row& row) {
+            SQLiteDatabase::BlobView blob = row.getBlobView(5);
+            size_t offset = vectors.size();
+            vectors.resize(offset + dimension);
+            if (static_cast<size_t>(row.getInt(3)) != dimension ||
+                !VectorCodec::decode(static_cast<EmbeddingStorageFormat>(row.getInt(1)), static_cast<ByteOrder>(row.getInt(2)),
+                                     static_cast<float>(row.getDouble(4)), blob.data, blob.size, vectors.data() + offset, dimension)) {
+                vectors.resize(offset);
+                return true;
+            }
+            ids.push_back(row.getInt64(0));
+            return true;
+        });
+        if (!ids.empty() &&
+            index->add_vectors_with_ids(vectors.data(), ids.data(), static_cast<int>(ids.size())) != ResultCode::SUCCESS) {
+            LEAFRA_WARNING() << "Failed to build the document index - hierarchical search disabled";
+            return;
+        }
+        document_index_ = std::move(index);
+        double elapsed_ms = debug::timer::elapsed_milliseconds(start_time, debug::timer::now());
+        LEAFRA_INFO() << "🗂️ Document index ready: " << ids.size() << " documents (" << backfilled << " centroids computed, "
+                      << std::fixed << std::setprecision(1) << elapsed_ms << " ms)";
+    } //loadDocumentIndex
+    
+    /**
+     * @brief First level of hierarchical search: the chunks of the documents nearest the query
+     * @param query_embedding Full query embedding
+     * @param chunk_ids Output chunk_faiss_ids of the vector_search.document_prefilter nearest documents
+     * @return false if the search should stay flat (feature off, no index, or no more documents than that)
+     */
+    bool selectDocumentChunks(const float* query_embedding, std::vector<int64_t>& chunk_ids) {
+        const int max_documents = config_.vector_search.document_prefilter;
+        SearchFilter filter;
+        {
+            std::lock_guard<std::mutex> lock(document_index_mutex_);
+            if (max_documents <= 0 || !document_index_ || document_index_->get_count() <= max_documents) {
+                return false;
+            }
+            std::vector<FaissIndex::SearchResult> documents;
+            if (document_index_->search(query_embedding, max_documents, documents) != ResultCode::SUCCESS) {
+                return false;
+            }
+            for (const auto& document : documents) {
+                filter.doc_ids.push_back(document.id);
+            }
+        }
+        if (filter.doc_ids.empty() || !resolveSearchFilter(filter, chunk_ids) || chunk_ids.empty()) {
+            return false;
+        }
+        LEAFRA_DEBUG() << "Hierarchical search: " << filter.doc_ids.size() << " documents, " << chunk_ids.size() << " chunks";
+        return true;
+    }
+#endif // LEAFRA_HAS_SQLITE
+#endif // LEAFRA_HAS_FAISS
+
+#ifdef LEAFRA_HAS_LLAMACPP
+#ifdef LEAFRA_HAS_FAISS
+    /**
+     * @brief Start the KV cache from the saved state of a frequently retrieved first chunk, or save that state
+     * 
+     * KV entries depend on their positions, so a chunk's state is kept together with the prompt
+     * head before it and only applies when the chunk leads the context again. Once a chunk has
+     * led llm.hot_chunk_min_retrievals prompts, the prompt up to its end is evaluated and saved;
+     * later prompts it leads restore that state, so only the remaining context and question are
+     * evaluated. A saved state whose tokens no longer begin the prompt (another system prompt,
+     * re-ingested text) is simply not used.
+     * 
+     * @param results Chunks packed into the prompt
+     * @param prompt_tokens Assembled prompt
+     * @param first_chunk_end Prompt tokens up to the end of the first chunk (see assembleRagPrompt)
+     */
+    void useHotChunkState(const std::vector<FaissIndex::SearchResult>& results, const std::vector<int32_t>& prompt_tokens,
+                          size_t first_chunk_end) {
+        if (results.empty() || first_chunk_end == 0 || first_chunk_end >= prompt_tokens.size()) {
+            return;
+        }
+        const int64_t chunk_id = results.front().id;
+        std::shared_ptr<const leafra::llamacpp::SessionSnapshot> state;
+        bool hot = false;
+        {
+            std::lock_guard<std::mutex> lock(hot_chunk_mutex_);
+            hot_chunk_states_.set_capacity(static_cast<size_t>(std::max(0, config_.llm.hot_chunk_cache_size)));
+            if (const auto* saved = hot_chunk_states_.get(chunk_id)) {
+                state = *saved;
+            } else {
+                const int32_t* counted = chunk_retrievals_.get(chunk_id);
+                const int32_t retrievals = (counted ? *counted : 0) + 1;
+                chunk_retrievals_.put(chunk_id, retrievals);
+                hot = retrievals >= config_.llm.hot_chunk_min_retrievals;
+            }
+        }
+        if (state) {
+            if (llamacpp_model_->restore_prefix_snapshot(*state, prompt_tokens)) {
+                LEAFRA_DEBUG() << "Hot chunk " << chunk_id << ": " << state->tokens.size() << " prompt tokens from its saved KV state";
+            }
+            return;
+        }
+        if (!hot) {
+            return;
+        }
+        
+        // Evaluated now rather than by the generation, so the saved state ends exactly at the chunk
+        std::vector<int32_t> prefix(prompt_tokens.begin(), prompt_tokens.begin() + static_cast<std::ptrdiff_t>(first_chunk_end));
+        auto snapshot = std::make_shared<leafra::llamacpp::SessionSnapshot>();
+        if (!llamacpp_model_->prefill_tokens(prefix) || !llamacpp_model_->save_snapshot(*snapshot) || snapshot->tokens != prefix) {
+            LEAFRA_DEBUG() << "Couldn't save the KV state of hot chunk " << chunk_id << ": " << llamacpp_model_->get_last_error();
+            return;
+        }
+        const size_t state_bytes = snapshot->state.size();
+        uint64_t total_bytes = 0;
+        {
+            std::lock_guard<std::mutex> lock(hot_chunk_mutex_);
+            hot_chunk_states_.put(chunk_id, std::move(snapshot));
+            chunk_retrievals_.erase(chunk_id);
+            hot_chunk_states_.erase_if([&total_bytes](const int64_t&, std::shared_ptr<const leafra::llamacpp::SessionSnapshot>& saved) {
+                total_bytes += saved->state.size();
+                return false;
+            });
+        }
+        hot_chunk_memory_.resize(total_bytes);
+        LEAFRA_INFO() << "🔥 Saved the KV state of hot chunk " << chunk_id << " (" << first_chunk_end << " tokens, "
+                      << (state_bytes / 1024) << " KB)";
+    } //useHotChunkState
+    
+    /**
+     * @brief Cut retrieved chunks down to the sentences closest to the question (compression.*)
+     * 
+     * Sentences of all chunks are embedded in one batch and ranked by cosine similarity to the
+     * query. Every chunk first keeps its compression.min_sentences_per_chunk best sentences, so
+     * each source still appears; the rest are taken best first while they fit
+     * compression.max_context_tokens. Kept sentences stay in their original order; chunks left
+     * without any (only with min_sentences_per_chunk 0) are dropped.
+     * 
+     * @param query User question
+     * @param results Ranked chunks; content is replaced with the kept sentences
+     * @return true if any chunk was shortened
+     */
+    bool compressRetrievedContext(const std::string& query, std::vector<FaissIndex::SearchResult>& results) {
+        const PromptCompressionConfig& compression = config_.compression;
+        const size_t budget = static_cast<size_t>(std::max(0, compression.max_context_tokens));
+        if (results.empty() || !hasEmbeddingModel()) {
+            return false;
+        }
+        
+        struct Sentence {
+            size_t result = 0;
+            size_t begin = 0;               // Byte range in the chunk's content
+            size_t end = 0;
+            size_t tokens = 0;
+            float score = -std::numeric_limits<float>::infinity();
+        };
+        std::vector<Sentence> sentences;
+        std::vector<std::string> texts;
+        std::vector<size_t> boundaries;
+        size_t total_tokens = 0;
+        for (size_t r = 0; r < results.size(); ++r) {
+            const std::string& content = results[r].content;
+            find_sentence_boundaries(content, boundaries);
+            size_t previous = 0;
+            for (size_t boundary : boundaries) {
+                std::string_view text(content.data() + previous, boundary - previous);
+                const size_t first = text.find_first_not_of(" \t\r\n");
+                if (first != std::string_view::npos) {
+                    const size_t last = text.find_last_not_of(" \t\r\n");
+                    Sentence sentence;
+                    sentence.result = r;
+                    sentence.begin = previous + first;
+                    sentence.end = previous + last + 1;
+                    texts.emplace_back(content, sentence.begin, sentence.end - sentence.begin);
+                    sentence.tokens = llamacpp_model_->tokenize(texts.back(), false).size();
+                    total_tokens += sentence.tokens;
+                    sentences.push_back(sentence);
+                }
+                previous = boundary;
+            }
+        }
+        if (total_tokens <= budget) {
+            return false;
+        }
+        
+        std::vector<float> query_embedding;
+        std::vector<std::vector<float>> embeddings;
+        if (embedQuery(query, query_embedding) != ResultCode::SUCCESS ||
+            embedQueries(texts, embeddings, true) != ResultCode::SUCCESS) {
+            LEAFRA_WARNING() << "Failed to embed retrieved sentences, the context is not compressed";
+            return false;
+        }
+        const float query_norm = std::sqrt(simd::squared_norm(query_embedding.data(), query_embedding.size()));
+        for (size_t i = 0; i < sentences.size(); ++i) {
+            const std::vector<float>& embedding = embeddings[i];
+            if (embedding.size() != query_embedding.size() || query_norm <= 0.0f) {
+                continue;
+            }
+            const float norm = std::sqrt(simd::squared_norm(embedding.data(), embedding.size()));
+            if (norm > 0.0f) {
+                sentences[i].score = simd::dot(embedding.data(), query_embedding.data(), embedding.size()) / (norm * query_norm);
+            }
+        }
+        
+        // Best first; each chunk's first picks are kept unconditionally, the rest as long as they fit
+        std::vector<size_t> order(sentences.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&sentences](size_t a, size_t b) {
+            return sentences[a].score > sentences[b].score;
+        });
+        std::vector<char> kept(sentences.size(), 0);
+        std::vector<int32_t> kept_per_result(results.size(), 0);
+        size_t used = 0;
+        for (size_t index : order) {
+            int32_t& count = kept_per_result[sentences[index].result];
+            if (count < compression.min_sentences_per_chunk) {
+                kept[index] = 1;
+                count++;
+                used += sentences[index].tokens;
+            }
+        }
+        for (size_t index : order) {
+            if (!kept[index] && used + sentences[index].tokens <= budget) {
+                kept[index] = 1;
+                used += sentences[index].tokens;
+            }
+        }
+        
+        bool shortened = false;
+        std::string content;
+        for (size_t i = 0; i < sentences.size();) {
+            const size_t r = sentences[i].result;
+            content.clear();
+            bool dropped = false;
+            for (; i < sentences.size() && sentences[i].result == r; ++i) {
+                if (!kept[i]) {
+                    dropped = true;
+                    continue;
+                }
+                if (!content.empty()) {
+                    content += ' ';
+                }
+                content.append(results[r].content, sentences[i].begin, sentences[i].end - sentences[i].begin);
+            }
+            if (dropped) {
+                results[r].content.swap(content);   // Emptied only when min_sentences_per_chunk is 0
+                shortened = true;
+            }
+        }
+        results.erase(std::remove_if(results.begin(), results.end(), [](const FaissIndex::SearchResult& result) {
+            return result.content.empty();
+        }), results.end());
+        LEAFRA_INFO() << "✂️ Compressed the retrieved context from " << total_tokens << " to " << used << " tokens ("
+                      << sentences.size() << " sentences ranked)";
+        return shortened;
+    } //compressRetrievedContext
+    
+    /**
+     * @brief Drop the saved hot chunk states (they belong to the model that computed them)
+     */
+    void clearHotChunkStates() {
+        std::lock_guard<std::mutex> lock(hot_chunk_mutex_);
+        hot_chunk_states_.clear();
+        chunk_retrievals_.clear();
+        hot_chunk_memory_.resize(0);
+    }
+#endif
+    
+#if defined(LEAFRA_HAS_SQLITE) && defined(LEAFRA_HAS_FAISS)
+    /**
+     * @brief Read the tokens stored at ingest for retrieved chunks, with one batched IN (...) lookup per 500 ids
+     * @param results Retrieved chunks
+     * @param tokens Output token ids by chunk id (replaced); chunks stored for another tokenizer are left out
+     */
+    void loadChunkLLMTokens(const std::vector<FaissIndex::SearchResult>& results,
+                            std::unordered_map<int64_t, std::vector<int32_t>>& tokens) {
+        static constexpr size_t kMaxIdsPerQuery = 500;
+        tokens.clear();
+        if (results.empty() || !database_ || !database_->isOpen()) {
+            return;
+        }
+        const std::string vocab = llmVocabKey();
+        SQLiteReadPool::Lease reader = read_pool_.acquire(database_.get());
+        for (size_t begin = 0; begin < results.size(); begin += kMaxIdsPerQuery) {
+            size_t end = std::min(results.size(), begin + kMaxIdsPerQuery);
+            std::string sql = "SELECT chunk_faiss_id, tokens FROM chunk_llm_tokens WHERE vocab = ? AND chunk_faiss_id IN (?";
+            for (size_t i = begin + 1; i < end; ++i) {
+                sql += ",?";
+            }
+            sql += ")";
+            auto stmt = reader->prepareCached(sql);
+            if (!stmt || !stmt->isValid()) {
+                LEAFRA_WARNING() << "Failed to prepare chunk token lookup, tokenizing retrieved chunks";
+                return;
+            }
+            stmt->bindTextView(1, vocab);
+            for (size_t i = begin; i < end; ++i) {
+                stmt->bindInt64(static_cast<int>(i - begin + 2), results[i].id);
+            }
+            stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+                SQLiteDatabase::BlobView blob = row.getBlobView(1);
+                std::vector<int32_t> decoded;
+                if (TextCodec::decode_tokens(blob.data, blob.size, decoded) && !decoded.empty()) {
+                    tokens.emplace(row.getInt64(0), std::move(decoded));
+                }
+                return true;
+            });
+        }
+        LEAFRA_DEBUG() << "Stored tokens for " << tokens.size() << " of " << results.size() << " retrieved chunks";
+    } //loadChunkLLMTokens
+#endif
+    
+    /**
+     * @brief Render the RAG chat prompt around where the retrieved context goes
+     * @param head Everything before the context (system prompt and template) - the same for every query
+     * @param tail Everything after it: the question and the generation prompt
+     */
+    bool formatRagPrompt(const std::string& query, std::string& head, std::string& tail) {
+        static const std::string kContextPlaceholder = "\x1fLEAFRA_CONTEXT\x1f";
+        
+        std::vector<leafra::llamacpp::ChatMessage> messages;
+        if (!config_.llm.system_prompt.empty()) {
+            messages.emplace_back("system", config_.llm.system_prompt);
+        }
+        messages.emplace_back("user", "Based on the following relevant information:\n\n" + kContextPlaceholder +
+                                      "Please answer the following question: " + query);
+        
+        const std::string formatted = llamacpp_model_->format_chat_prompt(messages, true);
+        const size_t split = formatted.find(kContextPlaceholder);
+        if (split == std::string::npos) {
+            return false;
+        }
+        head = formatted.substr(0, split);
+        tail = formatted.substr(split + kContextPlaceholder.size());
+        return true;
+    }
+    
+    /**
+     * @brief Evaluate the fixed head of the RAG prompt into the KV cache, for the prompt built after retrieval to reuse
+     */
+    bool prefillRagPrompt(const std::string& query) {
+        std::string head_text;
+        std::string tail_text;
+        if (!formatRagPrompt(query, head_text, tail_text)) {
+            return false;
+        }
+        std::vector<int32_t> head = llamacpp_model_->tokenize(head_text, true);
+        return !head.empty() && llamacpp_model_->prefill_tokens(head);
+    }
+    
+    /**
+     * @brief Tokenize the RAG prompt, packing as many retrieved chunks as the context budget allows
+     * 
+     * The chat template is rendered once around a placeholder, so the fixed head and tail are
+     * measured exactly and each chunk is tokenized once, or not at all when its tokens were
+     * stored at ingest (llm.cache_chunk_tokens). Chunks are packed greedily in rank
+     * order, skipping any that no longer fit; a first chunk that alone exceeds the budget is
+     * truncated rather than dropped.
+     * 
+     * @param query User question
+     * @param results Ranked chunks, reduced to the ones packed into the prompt
+     * @param prompt_tokens Receives the complete prompt, ready for generate_from_tokens
+     * @param first_chunk_end Receives the number of prompt tokens up to the end of the first chunk (0 = none packed), or nullptr
+     * @param use_stored_tokens Use tokens stored at ingest (false once the chunk text was rewritten, e.g. compressed)
+     * @return false if the model can't render or tokenize the prompt
+     */
+    bool assembleRagPrompt(const std::string& query, std::vector<FaissIndex::SearchResult>& results,
+                           std::vector<int32_t>& prompt_tokens, size_t* first_chunk_end = nullptr,
+                           bool use_stored_tokens = true) {
+        std::string head_text;
+        std::string tail_text;
+        if (!formatRagPrompt(query, head_text, tail_text)) {
+            return false;
+        }
+        std::vector<int32_t> head = llamacpp_model_->tokenize(head_text, true);
+        std::vector<int32_t> tail = llamacpp_model_->tokenize(tail_text, false);
+        if (head.empty()) {
+            return false;
+        }
+        
+        int64_t budget = static_cast<int64_t>(llamacpp_model_->get_context_size()) - config_.llm.n_predict -
+                         static_cast<int64_t>(head.size() + tail.size());
+        if (config_.llm.max_context_tokens > 0) {
+            budget = std::min<int64_t>(budget, config_.llm.max_context_tokens);
+        }
+        
+#if defined(LEAFRA_HAS_SQLITE) && defined(LEAFRA_HAS_FAISS)
+        std::unordered_map<int64_t, std::vector<int32_t>> stored_tokens;
+        if (config_.llm.cache_chunk_tokens && use_stored_tokens) {
+            loadChunkLLMTokens(results, stored_tokens);
+        }
+#else
+        (void)use_stored_tokens;
+#endif
+        
+        prompt_tokens = std::move(head);
+        if (first_chunk_end) {
+            *first_chunk_end = 0;
+        }
+        size_t packed = 0;
+        size_t used = 0;
+        const size_t candidates = results.size();
+        for (size_t i = 0; i < candidates && budget > 0; ++i) {
+            const auto& result = results[i];
+            std::vector<int32_t> label = llamacpp_model_->tokenize(
+                "Context " + std::to_string(packed + 1) + " (from " + result.filename + ", page " +
+                std::to_string(result.page_number) + "):\n", false);
+            std::vector<int32_t> content;
+#if defined(LEAFRA_HAS_SQLITE) && defined(LEAFRA_HAS_FAISS)
+            auto stored = stored_tokens.find(result.id);
+            if (stored != stored_tokens.end()) {
+                content = std::move(stored->second);
+            }
+#endif
+            if (content.empty()) {
+                content = llamacpp_model_->tokenize(result.content + "\n\n", false);
+            }
+            const size_t remaining = static_cast<size_t>(budget) - used;
+            const size_t needed = label.size() + content.size();
+            if (needed > remaining) {
+                if (packed > 0 || label.size() >= remaining) {
+                    continue;
+                }
+                content.resize(remaining - label.size());
+            }
+            prompt_tokens.insert(prompt_tokens.end(), label.begin(), label.end());
+            prompt_tokens.insert(prompt_tokens.end(), content.begin(), content.end());
+            used += label.size() + content.size();
+            if (packed == 0 && first_chunk_end) {
+                *first_chunk_end = prompt_tokens.size();
+            }
+            if (packed != i) {
+                results[packed] = std::move(results[i]);
+            }
+            packed++;
+        }
+        results.resize(packed);
+        prompt_tokens.insert(prompt_tokens.end(), tail.begin(), tail.end());
+        
+        LEAFRA_DEBUG() << "Packed " << packed << " of " << candidates << " chunks into the prompt (" << used
+                       << " context tokens, budget " << std::max<int64_t>(budget, 0) << ", " << prompt_tokens.size() << " total)";
+        return true;
+    } //assembleRagPrompt
+#endif
+    /**
+     * @brief Per-document state handed from the parallel prepare stage to the serialized store stage
+     */
+    struct IngestionWorkItem {
+        static constexpr size_t kArenaBlockBytes = 64 * 1024;
+        // The document's small per-chunk objects (hashes, cache keys, embedding blobs) come from here and are
+        // freed in one go with the item once the document is stored; declared first so it outlives them
+        MonotonicArena arena{kArenaBlockBytes};
+        size_t index = 0;                          // Position in the caller's file list
+        std::string file_path;
+        ParsedDocument document;
+        ChunkedDocument chunked_document;          // Chunks plus the joined page text they view
+        bool supported = false;
+        bool parsed = false;
+        bool chunked = false;
+        bool using_sentencepiece = false;
+        bool cancelled = false;
+        size_t text_chars = 0;                     // Parsed text of all pages
+        size_t token_count = 0;                    // Chunk tokens from the tokenizer (0 without it)
+        bool unchanged = false;                    // Same bytes as the stored version - nothing to re-index
+        bool refresh_fingerprint = false;          // Unchanged bytes under a new size/mtime - update the docs row
+        int64_t stored_doc_id = -1;                // docs row already holding this path (-1 if new)
+        DocumentLimit limit = DocumentLimit::NONE; // Per-document limit hit: indexed up to it, or skipped (parsing.skip_over_limit)
+        const EnumeratedFile* stat = nullptr;      // Pre-stat from directory enumeration (file_path is canonical), or nullptr
+        DocumentFingerprint fingerprint;           // Recorded with the document for the next run's change detection
+        ArenaVector<ArenaString> chunk_hashes{ArenaAllocator<ArenaString>(arena)};    // ContentHasher digest of each chunk's text
+        ArenaVector<uint64_t> chunk_simhashes{ArenaAllocator<uint64_t>(arena)};       // SimHash of each chunk's text (near_duplicates.enabled; 0 = too short)
+#ifdef LEAFRA_HAS_SQLITE
+        StoredChunkText stored_text;               // Compressed chunk text or document pages (database.chunk_text_compression / chunk_text_storage)
+#endif
+        ArenaVector<ArenaString> embedding_cache_keys{ArenaAllocator<ArenaString>(arena)};  // makeEmbeddingCacheKey of each chunk (embedding_inference.cache_enabled)
+        size_t total_files = 0;
+        uint64_t bytes = 0;                        // File size on disk (for progress reporting)
+        debug::timer::TimePoint start_time{};
+        IngestionJob::State* job = nullptr;        // Owning async job, nullptr for synchronous calls
+        MemoryAccountant::Reservation memory{MemorySubsystem::DOCUMENTS};  // Released with the item
+        
+        // Heap bytes of the page text, chunks, tokens, embeddings and hashes the item holds
+        uint64_t memory_bytes() const {
+            uint64_t bytes = chunked_document.memory_bytes();
+            for (const std::string& page : document.pages) {
+                bytes += page.capacity();
+            }
+            bytes += arena.memory_bytes();
+#ifdef LEAFRA_HAS_SQLITE
+            bytes += stored_text.memory_bytes();
+#endif
+            return bytes;
+        }
+    };
+
+    /**
+     * @brief Report a stage transition for a work item to its job's progress callback
+     * @param item Work item whose stage changed
+     * @param stage New stage
+     */
+    void reportProgress(const IngestionWorkItem& item, IngestionStage stage) {
+        if (!item.job) {
+            return;
+        }
+        
+        bool is_final = stage == IngestionStage::COMPLETED || 
+                        stage == IngestionStage::FAILED || 
+                        stage == IngestionStage::CANCELLED;
+        if (is_final) {
+            item.job->finished_files++;
+            if (stage == IngestionStage::FAILED) {
+                item.job->failed_files++;
+            }
+        }
+        
+        if (!item.job->options.on_progress) {
+            return;
+        }
+        
+        IngestionProgress progress;
+        progress.file_path = item.file_path;
+        progress.file_index = item.index;
+        progress.total_files = item.total_files;
+        progress.stage = stage;
+        progress.bytes = item.bytes;
+        progress.chunks = item.chunked_document.chunks.size();
+        progress.limit = item.limit;
+        progress.elapsed_ms = debug::timer::elapsed_milliseconds(item.start_time, debug::timer::now());
+        
+        std::lock_guard<std::mutex> lock(item.job->callback_mutex);
+        item.job->options.on_progress(progress);
+    } //reportProgress
+
+    /**
+     * @brief Check whether the job owning a work item was cancelled
+     */
+    bool isIngestionCancelled(const IngestionWorkItem& item) const {
+        return item.job && item.job->cancelled.load();
+    }
+
+    /**
+     * @brief Complete EXACT_TOKENS options: SentencePiece hook and a chunk size the embedding model can take
+     * @param options Options to complete (size_unit EXACT_TOKENS)
+     * @param prefix Text prepended to every chunk before embedding
+     * @return false if the tokenizer isn't loaded (options fall back to approximate TOKENS)
+     */
+    bool configureExactTokenChunking(ChunkingOptions& options, const std::string& prefix) {
+        if (!config_.tokenizer.enabled || !tokenizer_ || !tokenizer_->is_loaded()) {
+            LEAFRA_WARNING() << "EXACT_TOKENS chunking needs the SentencePiece tokenizer, using approximate tokens";
+            options.size_unit = ChunkSizeUnit::TOKENS;
+            return false;
+        }
+        
+        const SentencePieceTokenizer* tokenizer = tokenizer_.get();
+        options.tokenizer = [tokenizer](const std::string& text, std::vector<int>& ids, TokenOffsets& offsets) {
+            return tokenizer->encode_with_offsets(text, ids, offsets);
+        };
+        
+        // Leave room for [BOS] prefix ... [EOS] so no chunk is trimmed by the embedding model
+        if (hasEmbeddingModel() && embedding_scheduler_->backend().requiresTokenIds()) {
+            size_t sequence_length = embedding_scheduler_->backend().getSequenceLength();
+            size_t reserved = tokenizer_->encode_as_ids(prefix, SentencePieceTokenizer::TokenizeOptions()).size();
+            if (sequence_length > reserved && options.chunk_size > sequence_length - reserved) {
+                LEAFRA_DEBUG() << "Capping EXACT_TOKENS chunk size " << options.chunk_size << " to "
+                               << (sequence_length - reserved) << " (model sequence length " << sequence_length << ")";
+                options.chunk_size = sequence_length - reserved;
+            }
+        }
+        return true;
+    } //configureExactTokenChunking
+
+    /**
+     * @brief Report a document that hit a per-document limit and decide whether to index the part within it
+     * @param item Work item (its limit is recorded for the progress reports)
+     * @param limit Limit that was hit
+     * @return true to index the document up to the limit, false to skip it (parsing.skip_over_limit)
+     */
+    bool acceptOverLimitDocument(IngestionWorkItem& item, DocumentLimit limit) {
+        item.limit = limit;
+        const std::string reason = documentLimitName(limit);
+        if (config_.parsing.skip_over_limit) {
+            LEAFRA_WARNING() << "Skipping " << item.file_path << ": over the " << reason << " limit";
+            send_event(EventType::WARNING, "⛔ Skipped (over the " + reason + " limit): " + item.file_path, item.file_path);
+            return false;
+        }
+        LEAFRA_WARNING() << "Indexing " << item.file_path << " only up to the " << reason << " limit";
+        send_event(EventType::WARNING, "✂️ Partially indexed (" + reason + " limit): " + item.file_path, item.file_path);
+        return true;
+    }
+    
+    /**
+     * @brief Prepare stage: parse, chunk and tokenize a single document
+     * @param item Work item to fill in (file_path must be set)
+     * @param chunking_options Chunking options snapshot shared by all workers
+     * @param stored_documents Fingerprints of stored documents; files whose bytes match are not parsed again
+     *
+     * Safe to run concurrently on pool workers: the chunker's reentrant overload is
+     * used with per-thread scratch (chunks are string_views into item.chunked_document)
+     * and the parser/tokenizer calls used here are const.
+     */
+    void prepareDocumentForIngestion(IngestionWorkItem& item, const ChunkingOptions& chunking_options,
+                                     const StoredDocumentMap& stored_documents) {
+        const std::string& file_path = item.file_path;
+        item.start_time = debug::timer::now();
+        trace::Span span("ingest", "prepare_document");
+        span.arg("file", file_path);
+        
+        if (isIngestionCancelled(item)) {
+            item.cancelled = true;
+            return;
+        }
+        
+        LEAFRA_INFO() << "Processing file: " << file_path;
+        send_event(EventType::INGESTION_PROGRESS, "Processing file: " + file_path, file_path);
+        
+        // Directory enumeration already stat'ed the file and resolved its canonical path
+        std::error_code size_error;
+        std::error_code path_error;
+        std::error_code time_error;
+        uintmax_t file_size = 0;
+        DocumentFingerprint& fingerprint = item.fingerprint;
+        if (item.stat) {
+            file_size = static_cast<uintmax_t>(item.stat->file_size);
+            fingerprint.absolute_path = file_path;
+            fingerprint.file_mtime = item.stat->file_mtime;
+        } else {
+            file_size = std::filesystem::file_size(file_path, size_error);
+        }
+        item.bytes = size_error ? 0 : static_cast<uint64_t>(file_size);
+        
+        // Check if file type is supported
+        if (!file_parser_->isFileTypeSupported(file_path)) {
+            LEAFRA_WARNING() << "Unsupported file type: " << file_path;
+            send_event(EventType::WARNING, "Unsupported file type: " + file_path, file_path);
+            return;
+        }
+        item.supported = true;
+        
+        // Change detection: same size and mtime means unchanged; otherwise the content hash decides
+        if (!size_error) {
+            fingerprint.file_size = static_cast<int64_t>(file_size);
+        }
+        if (!item.stat) {
+            fingerprint.absolute_path = std::filesystem::canonical(file_path, path_error).string();
+            auto mtime = std::filesystem::last_write_time(file_path, time_error);
+            fingerprint.file_mtime = time_error ? 0 : static_cast<int64_t>(mtime.time_since_epoch().count());
+        }
+        
+        auto stored = path_error ? stored_documents.end() : stored_documents.find(fingerprint.absolute_path);
+        if (stored != stored_documents.end()) {
+            item.stored_doc_id = stored->second.doc_id;
+            fingerprint.doc_id = stored->second.doc_id;
+            if (stored->second.collection != fingerprint.collection) {
+                stored = stored_documents.end();       // Moving to another collection re-indexes it there
+            }
+        }
+        if (stored != stored_documents.end()) {
+            if (!time_error && !stored->second.content_hash.empty() &&
+                stored->second.file_size == fingerprint.file_size && stored->second.file_mtime == fingerprint.file_mtime) {
+                fingerprint.content_hash = stored->second.content_hash;
+                item.unchanged = true;
+                return;
+            }
+        }
+        if (!ContentHasher::hash_file(file_path, fingerprint.content_hash)) {
+            fingerprint.content_hash.clear();
+        }
+        if (stored != stored_documents.end() && !fingerprint.content_hash.empty() &&
+            fingerprint.content_hash == stored->second.content_hash) {
+            item.unchanged = true;
+            item.refresh_fingerprint = true;
+            return;
+        }
+        
+        // Parse the file using the appropriate adapter, unless this content was parsed before
+        reportProgress(item, IngestionStage::PARSING);
+        PipelineMetricsRecorder::ScopedStage parse_timing(metrics_, PipelineStage::PARSE);
+        std::string parser_key = parse_cache_ ? file_parser_->getCacheKey(file_path) : std::string();
+        if (parse_cache_ && parse_cache_->load(fingerprint.content_hash, parser_key, item.document)) {
+            item.document.filePath = file_path;
+            // Cached parses are complete; the page and text limits apply to them as well
+            ExtractionBudget(config_.parsing).apply(item.document);
+            LEAFRA_DEBUG() << "Using cached parse for: " << file_path;
+            send_event(EventType::INGESTION_PROGRESS, "♻️ Using cached parse: " + file_path, file_path);
+        } else {
+            item.document = file_parser_->parseFile(file_path);
+            // A parse cut short by a limit isn't the file's text, so it isn't cached
+            if (parse_cache_ && item.document.limit == DocumentLimit::NONE) {
+                parse_cache_->store(fingerprint.content_hash, parser_key, item.document);
+            }
+        }
+        // Normalize after caching, so cached parses stay valid when the normalization settings change
+        if (config_.parsing.normalize_text && item.document.isValid) {
+            TextNormalizationOptions normalization;
+            normalization.nfkc = config_.parsing.normalize_nfkc;
+            normalization.collapse_whitespace = config_.parsing.normalize_whitespace;
+            normalization.dehyphenate = config_.parsing.normalize_dehyphenate;
+            normalization.strip_control = config_.parsing.normalize_strip_control;
+            for (auto& page : item.document.pages) {
+                normalize_text(page, normalization);
+            }
+        }
+        const ParsedDocument& result = item.document;
+        parse_timing.set_items(result.getPageCount());
+        parse_timing.finish();
+        
+        if (!result.isValid) {
+            LEAFRA_ERROR() << "Failed to parse file: " << file_path << " - " << result.errorMessage;
+            send_event(EventType::ERROR_OCCURRED, "❌ Failed to parse: " + file_path + " - " + result.errorMessage, file_path);
+            return;
+        }
+        if (result.limit != DocumentLimit::NONE && !acceptOverLimitDocument(item, result.limit)) {
+            return;
+        }
+        item.parsed = true;
+        
+        // Log parsing results
+        size_t total_text_length = 0;
+        for (const auto& page : result.pages) {
+            total_text_length += page.length();
+        }
+        item.text_chars = total_text_length;
+        LEAFRA_INFO() << "Successfully parsed " << result.fileType << " file: " << file_path;
+        LEAFRA_INFO() << "  - Title: " << result.title;
+        LEAFRA_INFO() << "  - Author: " << result.author;
+        LEAFRA_INFO() << "  - Pages: " << result.getPageCount();
+        LEAFRA_INFO() << "  - Total text length: " << total_text_length << " characters";
+        
+        // Send detailed events
+        send_event(EventType::INGESTION_PROGRESS, "✅ Parsed " + result.fileType + ": " + file_path, file_path);
+        send_event(EventType::INGESTION_PROGRESS, "📄 Pages: " + std::to_string(result.getPageCount()), file_path);
+        send_event(EventType::INGESTION_PROGRESS, "📝 Text length: " + std::to_string(total_text_length) + " chars", file_path);
+        
+        if (!result.title.empty()) {
+            send_event(EventType::INGESTION_PROGRESS, "📖 Title: " + result.title, file_path);
+        }
+        if (!result.author.empty()) {
+            send_event(EventType::INGESTION_PROGRESS, "👤 Author: " + result.author, file_path);
+        }
+        
+        // Log metadata if available
+        for (const auto& [key, value] : result.metadata) {
+            if (!value.empty()) {
+                LEAFRA_DEBUG() << "  - " << key << ": " << value;
+            }
+        }
+        
+        // Perform chunking if enabled
+        if (!config_.chunking.enabled || !chunker_) {
+            if (!config_.chunking.enabled) {
+                LEAFRA_DEBUG() << "Chunking disabled in configuration, skipping chunk creation";
+            }
+            return;
+        }
+        
+        if (isIngestionCancelled(item)) {
+            item.cancelled = true;
+            return;
+        }
+        
+        LEAFRA_INFO() << "Starting chunking process for: " << file_path;
+        send_event(EventType::INGESTION_PROGRESS, "🔗 Starting chunking process", file_path);
+        reportProgress(item, IngestionStage::CHUNKING);
+        
+        // Prepare pages for chunking - views into item.document, which the chunker joins in one pass
+        std::vector<std::string_view> pages;
+        std::vector<size_t> page_numbers;    // Document page of each joined page (empty pages are left out)
+        for (size_t i = 0; i < result.getPageCount(); ++i) {
+            if (i < result.pages.size() && !result.pages[i].empty()) {
+                pages.emplace_back(result.pages[i]);
+                page_numbers.push_back(i);
+            }
+        }
+        
+        if (pages.empty()) {
+            LEAFRA_WARNING() << "No text content found for chunking in: " << file_path;
+            send_event(EventType::WARNING, "⚠️ No text content for chunking", file_path);
+            return;
+        }
+        
+        const std::string prefix = passagePrefix();
+        
+        ChunkingOptions document_options = chunking_options;
+        if (document_options.size_unit == ChunkSizeUnit::EXACT_TOKENS) {
+            configureExactTokenChunking(document_options, prefix);
+        }
+        
+        // Large documents are indexed in segments on the pool; the calling worker takes part too
+        if (worker_pool_) {
+            document_options.submit_task = [this](std::function<void()> task) {
+                return worker_pool_->submit(std::move(task));
+            };
+        }
+        
+        // The shared chunker is reentrant; each worker thread brings its own scratch memory
+        thread_local ChunkingScratch chunking_scratch;
+        thread_local MemoryAccountant::Reservation scratch_memory(MemorySubsystem::CHUNKING_SCRATCH);
+        thread_local uint64_t scratch_epoch = 0;
+        if (scratch_epoch != chunking_scratch_epoch_.load(std::memory_order_relaxed)) {
+            scratch_epoch = chunking_scratch_epoch_.load(std::memory_order_relaxed);
+            chunking_scratch = ChunkingScratch();     // Released under memory pressure
+            scratch_memory.resize(0);
+        }
+        PipelineMetricsRecorder::ScopedStage chunk_timing(metrics_, PipelineStage::CHUNK);
+        ResultCode chunk_result = chunker_->chunk_document(pages, std::move(document_options), item.chunked_document, chunking_scratch);
+        chunk_timing.set_items(item.chunked_document.chunks.size());
+        chunk_timing.finish();
+        scratch_memory.resize(chunking_scratch.memory_bytes());
+        
+        if (chunk_result != ResultCode::SUCCESS) {
+            LEAFRA_ERROR() << "Failed to chunk document: " << file_path;
+            send_event(EventType::ERROR_OCCURRED, "❌ Chunking failed for: " + file_path, file_path);
+            return;
+        }
+        if (page_numbers.size() != result.getPageCount()) {
+            for (TextChunk& chunk : item.chunked_document.chunks) {
+                chunk.page_number = page_numbers[std::min(chunk.page_number, page_numbers.size() - 1)];
+                chunk.end_page_number = page_numbers[std::min(chunk.end_page_number, page_numbers.size() - 1)];
+            }
+        }
+        if (config_.chunking.max_chunks > 0 && item.chunked_document.chunks.size() > config_.chunking.max_chunks) {
+            if (!acceptOverLimitDocument(item, DocumentLimit::MAX_CHUNKS)) {
+                item.parsed = false;
+                item.chunked_document.chunks.clear();
+                return;
+            }
+            std::vector<TextChunk>& chunks = item.chunked_document.chunks;
+            chunks.erase(chunks.begin() + static_cast<std::ptrdiff_t>(config_.chunking.max_chunks), chunks.end());
+        }
+        item.chunked = true;
+        
+        LEAFRA_INFO() << "✅ Successfully created " << item.chunked_document.chunks.size() << " chunks";
+        send_event(EventType::INGESTION_PROGRESS, "🧩 Created " + std::to_string(item.chunked_document.chunks.size()) + " chunks", file_path);
+        // Use SentencePiece for accurate token counting if available
+        reportProgress(item, IngestionStage::TOKENIZING);
+        PipelineMetricsRecorder::ScopedStage tokenize_timing(metrics_, PipelineStage::TOKENIZE);
+        tokenize_timing.set_items(item.chunked_document.chunks.size());
+        auto tokenization = processChunksWithSentencePieceTokenization(item.chunked_document.chunks,
+                                                                      item.chunked_document.batch.tokens, prefix);
+        tokenize_timing.finish();
+        item.using_sentencepiece = tokenization.second;
+        item.token_count = tokenization.first;
+        
+        // Chunks without retrievable text are left out before they cost an embedding or index space
+        if (config_.chunk_quality.enabled) {
+            const std::vector<TextChunk>& chunks = item.chunked_document.chunks;
+            ChunkBatch& batch = item.chunked_document.batch;
+            size_t rejected = 0;
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                const size_t token_count = item.using_sentencepiece && batch.has_tokens(i) ? batch.tokens.length(i) : 0;
+                const char* reason = ChunkQuality::rejection_reason(ChunkQuality::score(chunks[i].content, token_count),
+                                                                    config_.chunk_quality);
+                if (!reason) {
+                    continue;
+                }
+                if (batch.skipped.size() != chunks.size()) {
+                    batch.skipped.assign(chunks.size(), 0);
+                }
+                batch.skipped[i] = 1;
+                rejected++;
+                LEAFRA_DEBUG() << "Chunk " << (i + 1) << " fails the quality filter (" << reason << ")";
+            }
+            if (rejected > 0) {
+                LEAFRA_INFO() << "🧹 " << rejected << "/" << chunks.size() << " low-quality chunks left out for: " << file_path;
+                send_event(EventType::INGESTION_PROGRESS, "🧹 " + std::to_string(rejected) + " low-quality chunks left out", file_path);
+            }
+        }
+        
+        item.chunk_hashes.reserve(item.chunked_document.chunks.size());
+        for (const auto& chunk : item.chunked_document.chunks) {
+            ContentHasher hasher;
+            hasher.update(chunk.content);
+            char digest[ContentHasher::kHexDigestSize];
+            hasher.hex_digest(digest);
+            item.chunk_hashes.emplace_back(digest, sizeof(digest), item.chunk_hashes.get_allocator());
+        }
+        if (config_.near_duplicates.enabled) {
+            const size_t min_chars = static_cast<size_t>(std::max<int32_t>(0, config_.near_duplicates.min_chars));
+            const size_t shingle_words = static_cast<size_t>(std::max<int32_t>(1, config_.near_duplicates.shingle_words));
+            item.chunk_simhashes.reserve(item.chunked_document.chunks.size());
+            for (const auto& chunk : item.chunked_document.chunks) {
+                item.chunk_simhashes.push_back(chunk.content.size() >= min_chars ? SimHash::fingerprint(chunk.content, shingle_words) : 0);
+            }
+        }
+#ifdef LEAFRA_HAS_SQLITE
+        // Compressed here on the worker pool so the store stage only binds the blobs
+        StoredChunkText& stored_text = item.stored_text;
+        const std::string_view chunked_text = item.chunked_document.text();
+        const std::vector<size_t>& page_starts = item.chunked_document.page_starts();
+        stored_text.offsets.resize(item.chunked_document.chunks.size());
+        for (size_t i = 0; i < item.chunked_document.chunks.size(); ++i) {
+            const std::string_view content = item.chunked_document.chunks[i].content;
+            const uintptr_t begin = reinterpret_cast<uintptr_t>(chunked_text.data());
+            const uintptr_t at = reinterpret_cast<uintptr_t>(content.data());
+            if (chunked_text.empty() || at < begin || at - begin + content.size() > chunked_text.size()) {
+                continue;
+            }
+            const size_t start = static_cast<size_t>(at - begin);
+            auto page = std::upper_bound(page_starts.begin(), page_starts.end(), start);
+            stored_text.offsets[i].text = static_cast<int64_t>(start);
+            stored_text.offsets[i].page = page == page_starts.begin() ? -1 : static_cast<int64_t>(start - *(page - 1));
+        }
+        if (chunk_text_offsets_ && !item.chunked_document.text().empty()) {
+            stored_text.document = item.chunked_document.text();
+            stored_text.page_bytes = static_cast<size_t>(std::max<int32_t>(1, config_.database.doc_text_page_bytes));
+            if (chunk_text_compression_ != TextCompression::NONE) {
+                stored_text.pages.resize((stored_text.document.size() + stored_text.page_bytes - 1) / stored_text.page_bytes);
+                for (size_t page = 0; page < stored_text.pages.size(); ++page) {
+                    TextCodec::compress(stored_text.document.substr(page * stored_text.page_bytes, stored_text.page_bytes),
+                                        chunk_text_compression_, stored_text.pages[page]);
+                }
+            }
+        } else if (chunk_text_compression_ != TextCompression::NONE) {
+            stored_text.chunks.resize(item.chunked_document.chunks.size());
+            for (size_t i = 0; i < item.chunked_document.chunks.size(); ++i) {
+                TextCodec::compress(item.chunked_document.chunks[i].content, chunk_text_compression_, stored_text.chunks[i]);
+            }
+        }
+#ifdef LEAFRA_HAS_LLAMACPP
+        // ... and tokenized for the LLM the way assembleRagPrompt places them (skipped while the LLM isn't loaded)
+        if (config_.llm.cache_chunk_tokens) {
+            std::shared_lock<std::shared_mutex> llm_lock(llm_mutex_, std::try_to_lock);
+            if (llm_lock.owns_lock() && llamacpp_initialized_ && llamacpp_model_) {
+                const std::vector<TextChunk>& chunks = item.chunked_document.chunks;
+                stored_text.llm_vocab = llmVocabKey();
+                stored_text.llm_tokens.resize(chunks.size());
+                std::string chunk_text;    // Reused for every chunk
+                for (size_t i = 0; i < chunks.size(); ++i) {
+                    chunk_text.assign(chunks[i].content).append("\n\n");
+                    TextCodec::encode_tokens(llamacpp_model_->tokenize(chunk_text, false), stored_text.llm_tokens[i]);
+                }
+            } else {
+                LEAFRA_DEBUG() << "LLM not loaded, chunk tokens not cached for: " << item.file_path;
+            }
+        }
+#endif
+#endif
+        if (config_.embedding_inference.cache_enabled) {
+            item.embedding_cache_keys.reserve(item.chunked_document.chunks.size());
+            for (const auto& chunk : item.chunked_document.chunks) {
+                item.embedding_cache_keys.push_back(makeEmbeddingCacheKey(prefix, chunk.content, item.embedding_cache_keys.get_allocator()));
+            }
+        }
+        item.memory.resize(item.memory_bytes());
+    } //prepareDocumentForIngestion
+
+    /**
+     * @brief Lock a group-commit writer's connection for database work outside its jobs (no-op without one)
+     */
+    static std::unique_lock<std::mutex> lockWriterConnection(SQLiteWriter* writer) {
+        return writer ? std::unique_lock<std::mutex>(writer->connection_mutex()) : std::unique_lock<std::mutex>();
+    }
+    
+    /**
+     * @brief Record a stored document's counters for get_last_ingest_report() and report its chunk summary
+     * @param item Document that finished the prepare stage
+     */
+    void recordIngestReport(const IngestionWorkItem& item) {
+        IngestDocumentReport report;
+        report.file_path = item.file_path;
+        report.pages = item.document.getPageCount();
+        report.text_chars = item.text_chars;
+        report.chunks = item.chunked_document.chunks.size();
+        report.tokens = item.token_count;
+        report.elapsed_ms = debug::timer::elapsed_milliseconds(item.start_time, debug::timer::now());
+        
+        LEAFRA_INFO() << "📊 " << report.chunks << " chunks, " << report.tokens << " tokens from " << report.text_chars
+                      << " characters: " << item.file_path;
+        send_event(EventType::INGESTION_PROGRESS, "📊 Chunks: " + std::to_string(report.chunks) + ", " +
+                   std::to_string(report.tokens) + " tokens", item.file_path);
+        
+        std::lock_guard<std::mutex> lock(ingest_report_mutex_);
+        ingest_report_.push_back(std::move(report));
+    } //recordIngestReport
+    
+    /**
+     * @brief Store stage: embed a prepared document and write it to the database / index
+     * @param owner Work item produced by prepareDocumentForIngestion
+     * @param writer Group-commit writer of the run, or nullptr to insert and commit inline
+     *
+     * Runs on a single thread only - the embedding model and FAISS index are not shared
+     * between threads. With a writer, the insert is queued to its thread (which keeps the
+     * item alive until the document's group commits) and the connection is only used under
+     * the writer's connection lock.
+     */
+    void storePreparedDocument(const std::shared_ptr<IngestionWorkItem>& owner, SQLiteWriter* writer) {
+        IngestionWorkItem& item = *owner;
+        trace::Span span("ingest", "store_document");
+        span.arg("file", item.file_path);
+        if (item.cancelled || isIngestionCancelled(item)) {
+            item.cancelled = true;
+            reportProgress(item, IngestionStage::CANCELLED);
+            return;
+        }
+        if (item.unchanged) {
+            LEAFRA_INFO() << "Document unchanged since last ingestion, skipping: " << item.file_path;
+            send_event(EventType::INGESTION_PROGRESS, "⏭️ Unchanged: " + item.file_path, item.file_path);
+#ifdef LEAFRA_HAS_SQLITE
+            if (item.refresh_fingerprint && database_ && database_->isOpen()) {
+                std::unique_lock<std::mutex> connection = lockWriterConnection(writer);
+                touchStoredDocument(item.fingerprint);
+            }
+#endif
+            reportProgress(item, IngestionStage::COMPLETED);
+            return;
+        }
+        if (!item.parsed) {
+            reportProgress(item, IngestionStage::FAILED);
+            return;
+        }
+        if (!item.chunked) {
+            reportProgress(item, IngestionStage::COMPLETED);
+            return;
+        }
+        
+        const std::string& file_path = item.file_path;
+        std::vector<TextChunk>& chunks = item.chunked_document.chunks;
+        ChunkBatch& batch = item.chunked_document.batch;
+        bool stored = true;
+#ifndef LEAFRA_HAS_SQLITE
+        (void)writer;
+#endif
+
+#ifdef LEAFRA_HAS_SQLITE
+        // Lookups below share the connection with the writer's inserts (released before embedding)
+        std::unique_lock<std::mutex> connection = lockWriterConnection(writer);
+        // Changed document: chunks whose text survived keep their stored embedding and skip the model
+        if (item.stored_doc_id >= 0 && database_ && database_->isOpen()) {
+            size_t reused = reuseStoredChunkEmbeddings(item.stored_doc_id, item.chunk_hashes, chunks, batch);
+            if (reused > 0) {
+                LEAFRA_INFO() << "♻️ Reusing " << reused << "/" << chunks.size() << " chunk embeddings for: " << file_path;
+                send_event(EventType::INGESTION_PROGRESS, "♻️ Reused " + std::to_string(reused) + " unchanged chunk embeddings", file_path);
+            }
+        }
+        
+        // Near-duplicates of chunks already stored (or earlier in this document) reuse an embedding or are left out
+        std::vector<std::pair<size_t, size_t>> duplicate_copies;
+        if (config_.near_duplicates.enabled && database_ && database_->isOpen()) {
+            size_t duplicates = resolveNearDuplicateChunks(item.chunk_simhashes, item.stored_doc_id, item.fingerprint.collection,
+                                                           chunks, batch, duplicate_copies);
+            if (duplicates > 0) {
+                const bool skipping = config_.near_duplicates.policy == "skip";
+                LEAFRA_INFO() << "🪞 " << duplicates << "/" << chunks.size() << " near-duplicate chunks "
+                              << (skipping ? "skipped" : "reuse an embedding") << " for: " << file_path;
+                send_event(EventType::INGESTION_PROGRESS, "🪞 " + std::to_string(duplicates) + " near-duplicate chunks " +
+                           (skipping ? "skipped" : "reuse an embedding"), file_path);
+            }
+        }
+        
+        // Chunk text embedded before by the same model (in any document) comes from the embedding cache
+        std::vector<uint8_t> embedded_before;
+        if (embedding_cache_available_ && database_ && database_->isOpen()) {
+            size_t cached = loadCachedEmbeddings(item.embedding_cache_keys, chunks, batch);
+            if (cached > 0) {
+                LEAFRA_INFO() << "♻️ " << cached << "/" << chunks.size() << " chunk embeddings from cache for: " << file_path;
+                send_event(EventType::INGESTION_PROGRESS, "♻️ " + std::to_string(cached) + " chunk embeddings from cache", file_path);
+            }
+            embedded_before = batch.embedded;
+        }
+        if (connection.owns_lock()) {
+            connection.unlock();
+        }
+#endif
+        
+        // Process chunks through the embedding model if available (only if SentencePiece was successful)
+        if (item.using_sentencepiece && hasEmbeddingModel()) {
+            reportProgress(item, IngestionStage::EMBEDDING);
+            AdmissionController::Permit permit(admission_, AdmissionResource::EMBEDDER, AdmissionLane::BULK);
+            PipelineMetricsRecorder::ScopedStage embed_timing(metrics_, PipelineStage::EMBED);
+            embed_timing.set_items(processChunksWithEmbeddings(chunks, batch, file_path));
+        }
+#ifdef LEAFRA_HAS_SQLITE
+        if (embedding_cache_available_ && database_ && database_->isOpen()) {
+            connection = lockWriterConnection(writer);
+            storeCachedEmbeddings(item.embedding_cache_keys, batch, embedded_before);
+            connection = std::unique_lock<std::mutex>();
+        }
+        for (const auto& [row, source] : duplicate_copies) {
+            batch.skipped[row] = 0;
+            if (batch.has_embedding(source)) {
+                std::copy(batch.embedding(source), batch.embedding(source) + batch.dimension, batch.embedding(row));
+                batch.embedded[row] = 1;
+            }
+        }
+#endif
+        item.memory.resize(item.memory_bytes());
+        // Counters only; totals and averages are derived in get_last_ingest_report()
+        recordIngestReport(item);
+        // Print detailed chunk content if requested (development/debug feature)
+        if (config_.chunking.print_chunks_full || config_.chunking.print_chunks_brief) {
+            printChunkContentAnalysis(chunks, batch, file_path, item.using_sentencepiece);
+        }
+        // Optional: Log first few chunks for debugging (only in debug mode)
+        if (config_.debug_mode && LEAFRA_LOG_ENABLED(LogLevel::LEAFRA_DEBUG)) {
+            printDebugChunkSummary(chunks);
+        }
+                          
+        // Insert document and chunks into database
+#ifdef LEAFRA_HAS_SQLITE
+        if (database_ && database_->isOpen()) {
+            LEAFRA_DEBUG() << "Inserting document and chunks into database";
+            reportProgress(item, IngestionStage::STORING);
+            if (writer) {
+                // The writer thread inserts it in the open group; the document completes once that commits
+                writer->submit([this, owner](SQLiteDatabase&) {
+                    IngestionWorkItem& queued = *owner;
+                    return insertDocumentAndChunksIntoDatabase(queued.document, queued.chunked_document.chunks,
+                                                               queued.chunked_document.batch, queued.file_path, queued.fingerprint,
+                                                               queued.chunk_hashes, queued.chunk_simhashes, queued.stored_text,
+                                                               queued.arena);
+                }, [this, owner](bool durable) {
+                    if (!durable) {
+                        LEAFRA_WARNING() << "Failed to insert document into database: " << owner->file_path;
+                        send_event(EventType::ERROR_OCCURRED, "⚠️ Database insertion failed for: " + owner->file_path, owner->file_path);
+                    }
+                    reportProgress(*owner, durable ? IngestionStage::COMPLETED : IngestionStage::FAILED);
+                });
+                return;
+            }
+            if (!insertDocumentAndChunksIntoDatabase(item.document, chunks, batch, file_path, item.fingerprint, item.chunk_hashes,
+                                                     item.chunk_simhashes, item.stored_text, item.arena)) {
+                LEAFRA_WARNING() << "Failed to insert document into database: " << file_path;
+                send_event(EventType::ERROR_OCCURRED, "⚠️ Database insertion failed for: " + file_path, file_path);
+                stored = false;
+            }
+        } else {
+            LEAFRA_DEBUG() << "Database not available, skipping document insertion";
+        }
+#endif
+        reportProgress(item, stored ? IngestionStage::COMPLETED : IngestionStage::FAILED);
+    } //storePreparedDocument
+
+    /**
+     * @brief Run the ingestion pipeline over a list of files
+     * @param file_paths Files to ingest
+     * @param job Owning async job (progress/cancellation), nullptr for synchronous calls
+     * @param collection Collection the documents are indexed in ("" = default)
+     * @param file_stats Sizes / mtimes per file from directory enumeration (empty = stat each file)
+     * @return ResultCode for the whole batch (ERROR_CANCELLED if the job was cancelled)
+     *
+     * Ingestion runs are serialized: the store stage owns the embedding model and database.
+     * They take turns on ingestion_scheduler_ by priority; a run that a higher priority one
+     * is waiting on stops starting files, stores the ones in flight and waits its next turn.
+     */
+    ResultCode runIngestion(const std::vector<std::string>& file_paths, IngestionJob::State* job, const std::string& collection,
+                            const std::vector<EnumeratedFile>& file_stats = {}) {
+        IngestionScheduler::Run run(ingestion_scheduler_, file_paths, job ? job->options.priority : IngestionPriority::NORMAL);
+        run.acquire();
+        std::unique_lock<std::mutex> ingestion_lock(ingestion_mutex_);
+        markDatabaseUsed();
+        {
+            std::lock_guard<std::mutex> report_lock(ingest_report_mutex_);
+            ingest_report_.clear();
+        }
+        
+        using WorkItemPtr = std::unique_ptr<IngestionWorkItem>;
+    
+        size_t processed_count = 0;
+        size_t error_count = 0;
+        size_t cancelled_count = 0;
+        auto start_time = debug::timer::now();
+    
+        // Snapshot chunking options once so workers never touch the shared chunker
+        const ChunkingOptions chunking_options = chunker_ ? chunker_->get_default_options() : ChunkingOptions();
+        
+        // Same for stored document fingerprints, so workers never touch the database
+#ifdef LEAFRA_HAS_SQLITE
+        StoredDocumentMap stored_documents = loadStoredDocuments();
+#else
+        StoredDocumentMap stored_documents;
+#endif
+        
+        // Resumed jobs carry a collection per file
+        auto collection_of = [&](size_t index) -> const std::string& {
+            return job && index < job->collections.size() ? job->collections[index] : collection;
+        };
+        
+        // Every file is pending in ingestion_queue until its document commits, so an interrupted run can resume
+#ifdef LEAFRA_HAS_SQLITE
+        queueIngestionFiles(file_paths, collection_of);
+        std::vector<QueuedFileOutcome> queue_outcomes;
+#endif
+        
+        auto account = [&](const IngestionWorkItem& item) {
+            if (item.cancelled) {
+                cancelled_count++;
+            } else if (item.parsed || item.unchanged) {
+                processed_count++;
+            } else {
+                error_count++;
+            }
+#ifdef LEAFRA_HAS_SQLITE
+            if (ingestion_queue_available_ && !item.cancelled) {
+                const bool stored = item.parsed && item.chunked && !item.unchanged;
+                const char* failed_stage = item.unchanged ? "" : (!item.parsed ? "parse" : (stored ? "store" : ""));
+                queue_outcomes.push_back({item.file_path, item.fingerprint.collection, failed_stage, item.fingerprint.content_hash});
+            }
+#endif
+        };
+    
+        size_t worker_count = worker_pool_ ? std::min(worker_pool_->size(), file_paths.size()) : 0;
+        
+        // One pass per turn on the scheduler; a preempted pass ends between documents
+        while (true) {
+            // Inserts go to a writer thread that commits a group of documents per transaction (one fsync each)
+            // instead of one per document; the store stage embeds the next document meanwhile
+            std::unique_ptr<SQLiteWriter> writer;
+#ifdef LEAFRA_HAS_SQLITE
+            const size_t group_documents = static_cast<size_t>(std::max<int32_t>(config_.database.group_commit_documents, 0));
+            if (group_documents > 1 && run.remaining() > 1 && database_ && database_->isOpen()) {
+                writer = std::make_unique<SQLiteWriter>(*database_, group_documents, config_.database.group_commit_delay_ms,
+                                                        group_documents);
+            }
+#endif
+            
+            if (worker_count <= 1 || file_paths.size() <= 1) {
+                // Sequential path: nothing to overlap, avoid the queue/thread handoff
+                size_t i = 0;
+                while (run.next(i)) {
+                    auto item = std::make_shared<IngestionWorkItem>();
+                    item->index = i;
+                    item->file_path = file_paths[i];
+                    item->total_files = file_paths.size();
+                    item->job = job;
+                    item->stat = i < file_stats.size() ? &file_stats[i] : nullptr;
+                    item->fingerprint.collection = collection_of(i);
+                    {
+                        ThroughputGovernor::IngestPermit permit(governor_);
+                        prepareDocumentForIngestion(*item, chunking_options, stored_documents);
+                    }
+                    storePreparedDocument(item, writer.get());
+                    account(*item);
+                    item.reset();
+                    enforceMemoryBudget();
+                    pollThroughputGovernor();
+                }
+            } else {
+                // Staged pipeline:
+                //   [pool workers] parse -> chunk -> tokenize  ==bounded queue==>  [this thread] embed -> DB/FAISS insert
+                // The bounded queue provides back-pressure so parsed documents don't pile up in memory
+                // while the (serialized) embedding stage catches up.
+                size_t queue_depth = config_.ingestion_queue_depth > 0
+                    ? static_cast<size_t>(config_.ingestion_queue_depth)
+                    : worker_count;
+                BoundedQueue<WorkItemPtr> prepared_queue(queue_depth);
+                std::atomic<size_t> producers_remaining{worker_count};
+                std::vector<std::future<void>> producers_done;
+                producers_done.reserve(worker_count);
+            
+                LEAFRA_INFO() << "Ingestion pipeline: " << worker_count << " prepare workers, queue depth " << queue_depth;
+            
+                auto producer_finished = [&]() {
+                    if (producers_remaining.fetch_sub(1) == 1) {
+                        prepared_queue.close(); // Last producer out - let the consumer drain and stop
+                    }
+                };
+            
+                for (size_t w = 0; w < worker_count; ++w) {
+                    auto done = std::make_shared<std::promise<void>>();
+                    producers_done.push_back(done->get_future());
+                    bool submitted = worker_pool_->submit([&, done]() {
+                        size_t index = 0;
+                        while (run.next(index)) {
+                            auto item = std::make_unique<IngestionWorkItem>();
+                            item->index = index;
+                            item->file_path = file_paths[index];
+                            item->total_files = file_paths.size();
+                            item->job = job;
+                            item->stat = index < file_stats.size() ? &file_stats[index] : nullptr;
+                            item->fingerprint.collection = collection_of(index);
+                            try {
+                                // Admission by the governor: fewer documents in flight when throttled or while a query runs
+                                ThroughputGovernor::IngestPermit permit(governor_);
+                                prepareDocumentForIngestion(*item, chunking_options, stored_documents);
+                            } catch (const std::exception& e) {
+                                LEAFRA_ERROR() << "Exception while preparing " << item->file_path << ": " << e.what();
+                                item->parsed = false;
+                                item->chunked = false;
+                            }
+                            if (!prepared_queue.push(std::move(item))) {
+                                break;
+                            }
+                        }
+                        producer_finished();
+                        done->set_value();
+                    });
+                    if (!submitted) {
+                        LEAFRA_WARNING() << "Worker pool rejected ingestion task";
+                        producer_finished();
+                        done->set_value();
+                    }
+                }
+            
+                WorkItemPtr item;
+                while (prepared_queue.pop(item)) {
+                    std::shared_ptr<IngestionWorkItem> stored(std::move(item));
+                    try {
+                        storePreparedDocument(stored, writer.get());
+                    } catch (const std::exception& e) {
+                        LEAFRA_ERROR() << "Exception while storing " << stored->file_path << ": " << e.what();
+                    }
+                    account(*stored);
+                    stored.reset();
+                    enforceMemoryBudget();
+                    pollThroughputGovernor();
+                }
+            
+                // Producers reference this stack frame - make sure they're all gone before returning
+                for (auto& done : producers_done) {
+                    done.wait();
+                }
+            }
+            
+            if (writer) {
+                writer->flush();
+                LEAFRA_INFO() << "💾 Documents committed in " << writer->commit_count() << " group commits";
+                writer.reset();
+            }
+            
+            if (!run.preempted()) {
+                break;
+            }
+            // A higher priority run is waiting: let it ingest, then continue with the files not started
+            LEAFRA_INFO() << "⏸️ Ingestion paused for a higher priority job (" << run.remaining() << " files left)";
+            ingestion_lock.unlock();
+            run.release();
+            run.acquire();
+            ingestion_lock.lock();
+            markDatabaseUsed();
+#ifdef LEAFRA_HAS_SQLITE
+            stored_documents = loadStoredDocuments();   // The other run may have stored some of them
+#endif
+            LEAFRA_INFO() << "▶️ Ingestion resumed (" << run.remaining() << " files left)";
+        }
+        
+        // Files that were never picked up (pool rejected tasks) count as failures
+        size_t accounted = processed_count + error_count + cancelled_count;
+        if (accounted < file_paths.size()) {
+            error_count += file_paths.size() - accounted;
+        }
+#ifdef LEAFRA_HAS_SQLITE
+        settleIngestionQueue(queue_outcomes);
+#endif
+    
+#ifdef LEAFRA_HAS_FAISS
+        // Runs on the job's driver thread for async ingestion, so callers never wait on the rewrite
+        compactFaissIndex(false);
+#endif
+        
+        if (parse_cache_) {
+            parse_cache_->trim();
+        }
+#ifdef LEAFRA_HAS_SQLITE
+        trimEmbeddingCache();
+#endif
+        markDatabaseUsed();
+        
+        double total_ms = debug::timer::elapsed_milliseconds(start_time, debug::timer::now());
+    
+        // Summary
+        LEAFRA_INFO() << "File processing completed - Processed: " << processed_count 
+                      << ", Errors: " << error_count << ", Cancelled: " << cancelled_count << ", Total: " << file_paths.size()
+                      << " (" << std::fixed << std::setprecision(1) << total_ms << " ms)";
+    
+        send_event(EventType::INGESTION_COMPLETE, "📊 Processing summary: " + std::to_string(processed_count) + 
+                   " successful, " + std::to_string(error_count) + " failed");
+    
+        if (cancelled_count > 0) {
+            LEAFRA_INFO() << "Ingestion cancelled - " << cancelled_count << " files skipped";
+            send_event(EventType::INGESTION_COMPLETE, "🛑 File processing cancelled (" + std::to_string(cancelled_count) + " files skipped)");
+            return ResultCode::ERROR_CANCELLED;
+        } else if (processed_count > 0) {
+            send_event(EventType::INGESTION_COMPLETE, "✅ File processing completed successfully");
+            return ResultCode::SUCCESS;
+        } else if (error_count == file_paths.size()) {
+            send_event(EventType::INGESTION_COMPLETE, "❌ All files failed to process");
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        } else {
+            send_event(EventType::INGESTION_COMPLETE, "⚠️ File processing completed with some errors");
+            return ResultCode::SUCCESS; // Partial success
+        }
+    } //runIngestion
+
+    static std::string normalizeExtension(std::string extension) {
+        if (!extension.empty() && extension[0] == '.') {
+            extension.erase(0, 1);
+        }
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension;
+    }
+    
+    /**
+     * @brief Extensions a parser supports, narrowed to the requested ones
+     * @param requested Extensions asked for, with or without the dot, any case (empty = all supported)
+     * @return Lower-case extensions without the dot
+     */
+    std::vector<std::string> ingestibleExtensions(const std::vector<std::string>& requested) const {
+        std::vector<std::string> allowed;
+        for (const std::string& extension : file_parser_->getSupportedExtensions()) {
+            std::string normalized = normalizeExtension(extension);
+            bool wanted = requested.empty();
+            for (const std::string& filter : requested) {
+                wanted = wanted || normalizeExtension(filter) == normalized;
+            }
+            if (wanted) {
+                allowed.push_back(std::move(normalized));
+            }
+        }
+        return allowed;
+    } //ingestibleExtensions
+    
+    /**
+     * @brief List the supported documents under a directory for ingestion
+     * @param root Directory to enumerate
+     * @param extensions Extensions to include (empty = all supported by file_parser_)
+     * @param recursive Descend into subdirectories
+     * @param file_paths Output canonical paths, largest file first
+     * @param file_stats Output sizes / mtimes parallel to file_paths
+     * @return ERROR_NOT_FOUND if root is not a directory, SUCCESS otherwise (even if nothing matched)
+     *
+     * Largest-first order lets the prepare workers start the long parses early, so one big
+     * file picked up last doesn't keep the whole pipeline waiting at the end of the run.
+     */
+    ResultCode enumerateDirectory(const std::string& root, const std::vector<std::string>& extensions, bool recursive,
+                                  std::vector<std::string>& file_paths, std::vector<EnumeratedFile>& file_stats) const {
+        namespace fs = std::filesystem;
+        trace::Span span("ingest", "enumerate_directory");
+        span.arg("root", root);
+        
+        std::error_code error;
+        fs::path canonical_root = fs::canonical(root, error);
+        if (error || !fs::is_directory(canonical_root, error)) {
+            LEAFRA_ERROR() << "Not a directory: " << root;
+            return ResultCode::ERROR_NOT_FOUND;
+        }
+        
+        std::vector<std::string> allowed = ingestibleExtensions(extensions);
+        
+        struct Candidate {
+            std::string path;
+            EnumeratedFile stat;
+        };
+        std::vector<Candidate> candidates;
+        size_t skipped = 0;
+        
+        // Entries come back as canonical_root / relative path; symlinks aren't followed, so they stay canonical
+        auto visit = [&](const fs::directory_entry& entry) {
+            std::error_code entry_error;
+            if (entry.is_symlink(entry_error) || !entry.is_regular_file(entry_error)) {
+                return;
+            }
+            std::string extension = normalizeExtension(entry.path().extension().string());
+            if (std::find(allowed.begin(), allowed.end(), extension) == allowed.end()) {
+                skipped++;
+                return;
+            }
+            Candidate candidate;
+            uintmax_t size = entry.file_size(entry_error);
+            if (entry_error) {
+                skipped++;
+                return;
+            }
+            auto mtime = entry.last_write_time(entry_error);
+            candidate.stat.file_size = static_cast<int64_t>(size);
+            candidate.stat.file_mtime = entry_error ? 0 : static_cast<int64_t>(mtime.time_since_epoch().count());
+            candidate.path = entry.path().string();
+            candidates.push_back(std::move(candidate));
+        };
+        auto hidden = [](const fs::directory_entry& entry) {
+            std::string name = entry.path().filename().string();
+            return !name.empty() && name[0] == '.';
+        };
+        
+        auto options = fs::directory_options::skip_permission_denied;
+        if (recursive) {
+            for (fs::recursive_directory_iterator it(canonical_root, options, error), end; !error && it != end; it.increment(error)) {
+                if (hidden(*it)) {
+                    std::error_code type_error;
+                    if (it->is_directory(type_error)) {
+                        it.disable_recursion_pending();
+                    }
+                    continue;
+                }
+                visit(*it);
+            }
+        } else {
+            for (fs::directory_iterator it(canonical_root, options, error), end; !error && it != end; it.increment(error)) {
+                if (!hidden(*it)) {
+                    visit(*it);
+                }
+            }
+        }
+        if (error) {
+            LEAFRA_WARNING() << "Directory enumeration of " << root << " stopped early: " << error.message();
+        }
+        
+        std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+            return a.stat.file_size > b.stat.file_size;
+        });
+        file_paths.clear();
+        file_stats.clear();
+        file_paths.reserve(candidates.size());
+        file_stats.reserve(candidates.size());
+        for (Candidate& candidate : candidates) {
+            file_paths.push_back(std::move(candidate.path));
+            file_stats.push_back(candidate.stat);
+        }
+        
+        LEAFRA_INFO() << "📁 Found " << file_paths.size() << " documents under " << canonical_root.string()
+                      << " (" << skipped << " other files skipped)";
+        return ResultCode::SUCCESS;
+    } //enumerateDirectory
+
+    /**
+     * @brief Remove the documents stored for deleted files from the database and vector index
+     * @param file_paths Canonical paths of the deleted files (paths without a stored document are ignored)
+     */
+    void removeDocuments(const std::vector<std::string>& file_paths) {
+#ifdef LEAFRA_HAS_SQLITE
+        std::lock_guard<std::mutex> ingestion_lock(ingestion_mutex_);
+        if (removeStoredDocuments(lookupDocumentIds(file_paths), nullptr) != ResultCode::SUCCESS) {
+            LEAFRA_ERROR() << "Failed to remove " << file_paths.size() << " deleted documents";
+        }
+#else
+        (void)file_paths;
+#endif
+    } //removeDocuments
+    
+#ifdef LEAFRA_HAS_SQLITE
+    /**
+     * @brief Ids of the documents stored for files
+     * @param file_paths File paths (canonicalized when the file still exists; unknown paths are skipped)
+     * @return Document ids in file_paths order
+     */
+    std::vector<int64_t> lookupDocumentIds(const std::vector<std::string>& file_paths) {
+        std::vector<int64_t> doc_ids;
+        if (!database_ || !database_->isOpen()) {
+            return doc_ids;
+        }
+        auto lookupStmt = database_->prepareCached("SELECT id FROM docs WHERE url = ?");
+        if (!lookupStmt || !lookupStmt->isValid()) {
+            LEAFRA_ERROR() << "Failed to prepare document lookup statement";
+            return doc_ids;
+        }
+        doc_ids.reserve(file_paths.size());
+        for (const std::string& file_path : file_paths) {
+            // Documents are stored under their canonical path; a deleted file is looked up as given
+            std::error_code path_error;
+            std::string absolute_path = std::filesystem::canonical(file_path, path_error).string();
+            lookupStmt->reset();
+            lookupStmt->bindText(1, path_error ? file_path : absolute_path);
+            while (lookupStmt->step()) {
+                doc_ids.push_back(lookupStmt->getCurrentRow().getInt64(0));
+            }
+        }
+        return doc_ids;
+    } //lookupDocumentIds
+    
+    /**
+     * @brief Delete documents with their chunks, vectors and centroids in one pass
+     * @param doc_ids Document ids (unknown and repeated ids are ignored)
+     * @param removed Optional output: number of documents removed
+     * @return ResultCode indicating success or failure
+     *
+     * Unlike handleExistingDocument, which takes a document at a time, every step covers
+     * the whole set: the ids go into a temp table, so collecting the FAISS ids and deleting
+     * chunks and docs are one statement each; each affected collection's index then removes
+     * all its vectors in a single remove_ids pass and logs them as one tombstone delta. The
+     * caller holds ingestion_mutex_.
+     */
+    ResultCode removeStoredDocuments(const std::vector<int64_t>& doc_ids, size_t* removed) {
+        if (removed) {
+            *removed = 0;
+        }
+        if (!database_ || !database_->isOpen()) {
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        if (doc_ids.empty()) {
+            return ResultCode::SUCCESS;
+        }
+        
+        std::vector<int64_t> removed_ids;
+#ifdef LEAFRA_HAS_FAISS
+        std::map<std::string, std::vector<int64_t>> faiss_ids_by_collection;
+#endif
+        size_t removed_chunks = 0;
+        try {
+            SQLiteTransaction transaction(*database_);
+            if (!database_->execute("CREATE TEMP TABLE IF NOT EXISTS removed_docs (id INTEGER PRIMARY KEY)") ||
+                !database_->execute("DELETE FROM removed_docs")) {
+                LEAFRA_ERROR() << "Failed to prepare the document removal table";
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            auto selectStmt = database_->prepareCached("INSERT OR IGNORE INTO removed_docs (id) SELECT id FROM docs WHERE id = ?");
+            if (!selectStmt || !selectStmt->isValid()) {
+                LEAFRA_ERROR() << "Failed to prepare document selection statement";
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            for (int64_t doc_id : doc_ids) {
+                selectStmt->reset();
+                selectStmt->bindInt64(1, doc_id);
+                if (!selectStmt->execute()) {
+                    LEAFRA_ERROR() << "Failed to select document " << doc_id << " for removal";
+                    return ResultCode::ERROR_PROCESSING_FAILED;
+                }
+            }
+            database_->execute("SELECT id FROM removed_docs", [&removed_ids](const SQLiteDatabase::Row& row) {
+                removed_ids.push_back(row.getInt64(0));
+                return true;
+            });
+            if (removed_ids.empty()) {
+                return ResultCode::SUCCESS;
+            }
+            
+#ifdef LEAFRA_HAS_FAISS
+            // IVF/HNSW indexes only tombstone them; compactFaissIndex purges once enough have piled up
+            if (!faiss_collections_.empty()) {
+                database_->execute("SELECT d.collection, c.chunk_faiss_id FROM chunks c JOIN docs d ON d.id = c.doc_id "
+                                   "WHERE c.doc_id IN (SELECT id FROM removed_docs) AND c.chunk_faiss_id IS NOT NULL",
+                                   [&faiss_ids_by_collection](const SQLiteDatabase::Row& row) {
+                    faiss_ids_by_collection[std::string(row.getTextView(0))].push_back(row.getInt64(1));
+                    return true;
+                });
+            }
+#endif
+            
+            if (!database_->execute("DELETE FROM chunks WHERE doc_id IN (SELECT id FROM removed_docs)")) {
+                LEAFRA_ERROR() << "Failed to delete the chunks of " << removed_ids.size() << " documents";
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            removed_chunks = static_cast<size_t>(database_->getChanges());
+            // Rows first: the in-memory index changes below can't be rolled back
+            if (!database_->execute("DELETE FROM docs WHERE id IN (SELECT id FROM removed_docs)")) {
+                LEAFRA_ERROR() << "Failed to delete " << removed_ids.size() << " documents";
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            
+#ifdef LEAFRA_HAS_FAISS
+            for (auto& [name, faiss_ids] : faiss_ids_by_collection) {
+                FaissCollection* faiss_collection = nullptr;
+                if (openFaissCollection(name, faiss_collection) != ResultCode::SUCCESS || !faiss_collection) {
+                    continue;
+                }
+                // With a hot tier, removed rows are dropped from it instead; a merge in flight finishes first
+                std::unique_lock<std::mutex> merge_lock(faiss_merge_mutex_, std::defer_lock);
+                if (config_.vector_search.hot_index) {
+                    merge_lock.lock();
+                    removeHotVectors(*faiss_collection, faiss_ids);
+                } else {
+                    flushPendingFaissVectors(*faiss_collection);
+                }
+                const int count = static_cast<int>(faiss_ids.size());
+                if (faiss_collection->index->remove_vectors(faiss_ids.data(), count) != ResultCode::SUCCESS) {
+                    // The rows are gone either way; searches drop hits without a chunk row
+                    LEAFRA_ERROR() << "Failed to remove " << count << " vectors from FAISS collection '" << name << "'";
+                    continue;
+                }
+                if (faiss_collection->index->append_removals_to_db(*database_, faiss_collection->definition, faiss_ids.data(), count) !=
+                    ResultCode::SUCCESS) {
+                    LEAFRA_WARNING() << "Failed to persist " << count << " FAISS removals for collection '" << name << "'";
+                }
+            }
+#endif
+            
+            database_->execute("DELETE FROM removed_docs");
+            if (!transaction.commit()) {
+                LEAFRA_ERROR() << "Failed to commit removal of " << removed_ids.size() << " documents";
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "Exception while removing documents: " << e.what();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        
+        invalidateCachedAnswers(std::unordered_set<int64_t>(removed_ids.begin(), removed_ids.end()));
+#ifdef LEAFRA_HAS_FAISS
+        {
+            std::lock_guard<std::mutex> lock(document_index_mutex_);
+            if (document_index_) {
+                document_index_->remove_vectors(removed_ids.data(), static_cast<int>(removed_ids.size()));
+            }
+        }
+        compactFaissIndex(false);
+#endif
+        if (removed) {
+            *removed = removed_ids.size();
+        }
+        LEAFRA_INFO() << "🗑️ Removed " << removed_ids.size() << " documents (" << removed_chunks << " chunks)";
+        send_event(EventType::INGESTION_PROGRESS, "🗑️ Removed " + std::to_string(removed_ids.size()) + " documents");
+        return ResultCode::SUCCESS;
+    } //removeStoredDocuments
+    
+#ifdef LEAFRA_HAS_FAISS
+    /**
+     * @brief Body of append_to_document (caller holds ingestion_mutex_)
+     * 
+     * Chunks the tail of the last stored chunk (its overlap) followed by the new text, so the
+     * first new chunk overlaps the last stored one the way consecutive chunks of one ingestion
+     * do; only that window is indexed, tokenized and embedded. The new chunks get chunk_no
+     * after the last one and fresh FAISS ids, their text is stored as a copy (compressed as
+     * configured) and the document's centroid takes them in.
+     */
+    ResultCode appendToDocument(int64_t doc_id, const std::string& text, size_t* chunks_added) {
+        if (!database_ || !database_->isOpen()) {
+            LEAFRA_ERROR() << "Database not available for appending";
+            return ResultCode::ERROR_NOT_IMPLEMENTED;
+        }
+        
+        std::string filename;
+        std::string absolute_path;
+        std::string collection;
+        int64_t last_chunk_no = 0;
+        bool found = false;
+        auto doc_stmt = database_->prepareCached(
+            "SELECT d.filename, d.url, d.collection, (SELECT MAX(chunk_no) FROM chunks WHERE doc_id = d.id) FROM docs d WHERE d.id = ?");
+        if (!doc_stmt || !doc_stmt->isValid() || !doc_stmt->bindInt64(1, doc_id)) {
+            LEAFRA_ERROR() << "Failed to prepare document lookup";
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        doc_stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+            filename = row.getText(0);
+            absolute_path = row.getText(1);
+            collection = row.getText(2);
+            last_chunk_no = row.isNull(3) ? 0 : row.getInt64(3);
+            found = true;
+            return false;
+        });
+        if (!found) {
+            LEAFRA_ERROR() << "No document with id " << doc_id;
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+        
+        // The last chunk's overlap window, cut at a word start so the new first chunk doesn't begin mid-word
+        FaissIndex::SearchResult last;
+        if (last_chunk_no > 0) {
+            auto last_stmt = database_->prepareCached("SELECT chunk_faiss_id FROM chunks WHERE doc_id = ? AND chunk_no = ?");
+            if (last_stmt && last_stmt->isValid() && last_stmt->bindInt64(1, doc_id) && last_stmt->bindInt64(2, last_chunk_no) &&
+                last_stmt->step()) {
+                last.id = last_stmt->getCurrentRow().getInt64(0);
+            }
+            std::vector<FaissIndex::SearchResult> hits(1, last);
+            if (last.id >= 0 && hydrateSearchResults(hits, static_cast<uint32_t>(SearchResultFields::CONTENT)) && !hits.empty()) {
+                last = std::move(hits[0]);
+            }
+        }
+        size_t tail_start = last.content.size();
+        if (!last.content.empty()) {
+            const double overlap = std::min(1.0, std::max(0.0, config_.chunking.overlap_percentage));
+            tail_start = last.content.size() - static_cast<size_t>(static_cast<double>(last.content.size()) * overlap);
+            while (tail_start < last.content.size() && !std::isspace(static_cast<unsigned char>(last.content[tail_start]))) {
+                tail_start++;
+            }
+            while (tail_start < last.content.size() && std::isspace(static_cast<unsigned char>(last.content[tail_start]))) {
+                tail_start++;
+            }
+        }
+        const size_t tail_size = last.content.size() - tail_start;
+        const std::string window = last.content.substr(tail_start) + text;
+        
+        ModelUse model_use(model_swap_mutex_);
+        if (!hasEmbeddingModel()) {
+            LEAFRA_ERROR() << "Embedding model not available";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        const std::string prefix = passagePrefix();
+        ChunkingOptions options = chunker_->get_default_options();
+        if (options.size_unit == ChunkSizeUnit::EXACT_TOKENS) {
+            configureExactTokenChunking(options, prefix);
+        }
+        ChunkedDocument chunked;
+        ChunkingScratch scratch;
+        if (chunker_->chunk_text(window, std::move(options), chunked, scratch) != ResultCode::SUCCESS) {
+            LEAFRA_ERROR() << "Failed to chunk appended text for document: " << filename;
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        std::vector<TextChunk>& chunks = chunked.chunks;
+        if (chunks.empty()) {
+            return ResultCode::SUCCESS;
+        }
+        processChunksWithSentencePieceTokenization(chunks, chunked.batch.tokens, prefix);
+        ChunkBatch& batch = chunked.batch;
+        if (processChunksWithEmbeddings(chunks, batch, absolute_path) == 0) {
+            LEAFRA_ERROR() << "No embeddings generated for appended text of document: " << filename;
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        
+        try {
+            PipelineMetricsRecorder::ScopedStage insert_timing(metrics_, PipelineStage::DB_INSERT);
+            insert_timing.set_items(chunks.size());
+            SQLiteTransaction transaction(*database_);
+            
+            int64_t next_chunk_faiss_id = 0;
+            if (!database_->allocateIds("chunk_faiss_id", static_cast<int64_t>(batch.embedding_count()), next_chunk_faiss_id)) {
+                LEAFRA_ERROR() << "Failed to allocate chunk ids for document: " << filename;
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            SQLiteDatabase::BulkInsert insertChunks(*database_, "chunks",
+                {"doc_id", "chunk_page_number", "chunk_faiss_id", "chunk_no", "chunk_token_size", "chunk_size", "chunk_text", "chunk_hash",
+                 "chunk_doc_offset"});
+            SQLiteDatabase::BulkInsert insertEmbeddings(*database_, "chunk_embeddings",
+                {"chunk_faiss_id", "format", "byte_order", "dimension", "scale", "embedding"});
+            const bool store_embeddings = embedding_storage_format_ != EmbeddingStorageFormat::NONE;
+            const long long page_number = last.page_number > 0 ? last.page_number : 1;
+            std::vector<int64_t> chunk_faiss_ids(chunks.size(), -1);
+            // Bound as views, so they live until the flush
+            std::vector<std::vector<uint8_t>> compressed(chunks.size());
+            std::vector<std::string> digests(chunks.size());
+            std::vector<VectorCodec::Encoded> encoded(chunks.size());
+            std::vector<float> centroid;
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                const TextChunk& chunk = chunks[i];
+                if (!batch.has_embedding(i)) {
+                    LEAFRA_WARNING() << "Skipping database insertion for appended chunk " << (i + 1) << " - no embedding";
+                    continue;
+                }
+                const int64_t chunk_faiss_id = next_chunk_faiss_id++;
+                chunk_faiss_ids[i] = chunk_faiss_id;
+                insertChunks.bindInt64(0, doc_id);
+                insertChunks.bindInt64(1, page_number);
+                insertChunks.bindInt64(2, chunk_faiss_id);
+                insertChunks.bindInt64(3, static_cast<long long>(last_chunk_no + static_cast<int64_t>(i) + 1));
+                insertChunks.bindInt64(4, static_cast<long long>(chunk.estimated_tokens));
+                insertChunks.bindInt64(5, static_cast<long long>(chunk.content.length()));
+                if (chunk_text_compression_ != TextCompression::NONE) {
+                    TextCodec::compress(chunk.content, chunk_text_compression_, compressed[i]);
+                    insertChunks.bindBlobView(6, compressed[i].data(), compressed[i].size());
+                } else {
+                    insertChunks.bindTextView(6, chunk.content);
+                }
+                ContentHasher hasher;
+                hasher.update(chunk.content);
+                char digest[ContentHasher::kHexDigestSize];
+                hasher.hex_digest(digest);
+                digests[i].assign(digest, sizeof(digest));
+                insertChunks.bindTextView(7, digests[i]);
+                // Offsets continue from where the last chunk's text ended in the document
+                const size_t window_start = static_cast<size_t>(chunk.content.data() - window.data());
+                if (last.text_end >= 0) {
+                    insertChunks.bindInt64(8, static_cast<long long>(last.text_end - static_cast<int64_t>(tail_size) +
+                                                                     static_cast<int64_t>(window_start)));
+                } else {
+                    insertChunks.bindNull(8);
+                }
+                if (!insertChunks.endRow()) {
+                    LEAFRA_ERROR() << "Failed to insert appended chunks for document: " << filename;
+                    return ResultCode::ERROR_PROCESSING_FAILED;
+                }
+                if (store_embeddings && VectorCodec::encode(batch.embedding(i), batch.dimension, embedding_storage_format_, encoded[i])) {
+                    insertEmbeddings.bindInt64(0, chunk_faiss_id);
+                    insertEmbeddings.bindInt64(1, static_cast<long long>(encoded[i].format));
+                    insertEmbeddings.bindInt64(2, static_cast<long long>(encoded[i].byte_order));
+                    insertEmbeddings.bindInt64(3, static_cast<long long>(batch.dimension));
+                    insertEmbeddings.bindDouble(4, encoded[i].scale);
+                    insertEmbeddings.bindBlobView(5, encoded[i].data.data(), encoded[i].data.size());
+                    if (!insertEmbeddings.endRow()) {
+                        LEAFRA_ERROR() << "Failed to insert appended chunk embeddings for document: " << filename;
+                        return ResultCode::ERROR_PROCESSING_FAILED;
+                    }
+                }
+                if (config_.vector_search.enabled && config_.vector_search.document_prefilter > 0) {
+                    accumulateCentroid(batch.embedding(i), batch.dimension, centroid);
+                }
+            }
+            if (!insertChunks.flush() || !insertEmbeddings.flush()) {
+                LEAFRA_ERROR() << "Failed to insert appended chunks for document: " << filename;
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            const size_t inserted = insertChunks.getRowsInserted();
+            
+            auto size_stmt = database_->prepareCached("UPDATE docs SET size = size + ? WHERE id = ?");
+            if (!size_stmt || !size_stmt->isValid() || !size_stmt->bindInt64(1, static_cast<long long>(text.size())) ||
+                !size_stmt->bindInt64(2, doc_id) || !size_stmt->execute()) {
+                LEAFRA_ERROR() << "Failed to update document size: " << filename;
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            // The sync log only sees inserted and deleted documents; a grown one goes out with the next delta too
+            if (sync_log_available_) {
+                auto sync_stmt = database_->prepareCached("INSERT INTO sync_log (doc_id, url, collection, removed) VALUES (?, ?, ?, 0)");
+                if (!sync_stmt || !sync_stmt->isValid() || !sync_stmt->bindInt64(1, doc_id) || !sync_stmt->bindText(2, absolute_path) ||
+                    !sync_stmt->bindText(3, collection) || !sync_stmt->execute()) {
+                    LEAFRA_ERROR() << "Failed to log appended document for sync: " << filename;
+                    return ResultCode::ERROR_PROCESSING_FAILED;
+                }
+            }
+            // Running centroid: the stored mean times its chunk count, plus the new chunks
+            size_t centroid_chunks = inserted;
+            if (!centroid.empty()) {
+                auto centroid_stmt = database_->prepareCached(
+                    "SELECT chunk_count, format, byte_order, dimension, scale, embedding FROM doc_centroids WHERE doc_id = ?");
+                if (centroid_stmt && centroid_stmt->isValid() && centroid_stmt->bindInt64(1, doc_id)) {
+                    std::vector<float> mean(batch.dimension);
+                    centroid_stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+                        SQLiteDatabase::BlobView blob = row.getBlobView(5);
+                        if (static_cast<size_t>(row.getInt(3)) == batch.dimension &&
+                            VectorCodec::decode(static_cast<EmbeddingStorageFormat>(row.getInt(1)), static_cast<ByteOrder>(row.getInt(2)),
+                                                static_cast<float>(row.getDouble(4)), blob.data, blob.size, mean.data(), batch.dimension)) {
+                            const size_t count = static_cast<size_t>(row.getInt64(0));
+                            for (size_t d = 0; d < batch.dimension; ++d) {
+                                centroid[d] += mean[d] * static_cast<float>(count);
+                            }
+                            centroid_chunks += count;
+                        }
+                        return false;
+                    });
+                }
+                if (!storeDocumentCentroid(doc_id, centroid, centroid_chunks)) {
+                    LEAFRA_ERROR() << "Failed to store document centroid for: " << filename;
+                    return ResultCode::ERROR_PROCESSING_FAILED;
+                }
+            }
+            if (!transaction.commit()) {
+                LEAFRA_ERROR() << "Failed to commit appended chunks for document: " << filename;
+                insert_timing.cancel();
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            insert_timing.finish();
+            invalidateCachedAnswers(doc_id);
+            
+            PipelineMetricsRecorder::ScopedStage faiss_timing(metrics_, PipelineStage::FAISS_ADD);
+            faiss_timing.set_items(inserted);
+            if (!insertChunkEmbeddingsIntoFaiss(batch, chunk_faiss_ids, collection)) {
+                faiss_timing.cancel();
+                LEAFRA_ERROR() << "Failed to insert appended embeddings into FAISS index for document: " << filename;
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            if (!centroid.empty()) {
+                std::lock_guard<std::mutex> lock(document_index_mutex_);
+                const int64_t document_label = doc_id;
+                if (document_index_) {
+                    document_index_->remove_vectors(&document_label, 1);
+                    if (document_index_->add_vectors_with_ids(centroid.data(), &document_label, 1) != ResultCode::SUCCESS) {
+                        LEAFRA_WARNING() << "Failed to update document in the document index: " << filename;
+                    }
+                }
+            }
+            if (chunks_added) {
+                *chunks_added = inserted;
+            }
+            LEAFRA_INFO() << "✅ Appended " << text.size() << " bytes to '" << filename << "' as " << inserted << " chunks";
+            send_event(EventType::DOCUMENT_STORED, "💾 Appended to document: " + filename + " (" + std::to_string(inserted) + " chunks)",
+                       absolute_path);
+            return ResultCode::SUCCESS;
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "Exception while appending to document: " << e.what();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+    } //appendToDocument
+#endif
+#endif
+    
+    /**
+     * @brief Queue a watcher batch as an async job, ordered after the previous batch
+     */
+    void ingestWatchedChanges(const FileWatcher::Changes& changes) {
+        auto state = std::make_shared<IngestionJob::State>();
+        state->file_paths = changes.modified;
+        state->removed_paths = changes.removed;
+        state->options = watch_options_;
+        state->previous = last_watch_job_;
+        last_watch_job_ = state->future;
+        
+        LEAFRA_INFO() << "👀 Directory changed: " << changes.modified.size() << " files to index, "
+                      << changes.removed.size() << " removed";
+        send_event(EventType::INGESTION_STARTED, "Queued " + std::to_string(changes.modified.size()) + " changed files, " +
+                   std::to_string(changes.removed.size()) + " removed");
+        startAsyncIngestion(state);
+    } //ingestWatchedChanges
+    
+    void stopWatching() {
+        if (file_watcher_) {
+            file_watcher_->stop();
+            file_watcher_.reset();
+        }
+        last_watch_job_ = std::shared_future<ResultCode>();
+    }
+    
+    /**
+     * @brief Start an ingestion job on a dedicated driver thread
+     * @param state Job state shared with the returned IngestionJob handle
+     *
+     * The driver thread runs the serialized store stage; the prepare stage fans out on
+     * worker_pool_. Using a separate driver keeps a small pool from deadlocking on itself.
+     */
+    void startAsyncIngestion(const std::shared_ptr<IngestionJob::State>& state) {
+        std::lock_guard<std::mutex> lock(async_jobs_mutex_);
+        reapFinishedAsyncJobs();
+        
+        AsyncIngestion job;
+        job.state = state;
+        job.thread = std::thread([this, state]() {
+            ResultCode result = ResultCode::ERROR_PROCESSING_FAILED;
+            try {
+                if (state->previous.valid()) {
+                    state->previous.wait();
+                }
+                result = ResultCode::SUCCESS;
+                if (!state->removed_paths.empty() && !state->cancelled) {
+                    removeDocuments(state->removed_paths);
+                }
+                if (!state->file_paths.empty()) {
+                    result = runIngestion(state->file_paths, state.get(), state->options.collection, state->file_stats);
+                }
+            } catch (const std::exception& e) {
+                LEAFRA_ERROR() << "Async ingestion failed: " << e.what();
+            }
+            
+            if (state->options.on_complete) {
+                std::lock_guard<std::mutex> callback_lock(state->callback_mutex);
+                state->options.on_complete(result);
+            }
+            state->done = true;
+            state->promise.set_value(result);
+        });
+        async_jobs_.push_back(std::move(job));
+    } //startAsyncIngestion
+
+    /**
+     * @brief Join driver threads of jobs that already finished (caller holds async_jobs_mutex_)
+     */
+    void reapFinishedAsyncJobs() {
+        for (auto it = async_jobs_.begin(); it != async_jobs_.end();) {
+            if (it->state->done.load()) {
+                if (it->thread.joinable()) {
+                    it->thread.join();
+                }
+                it = async_jobs_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    } //reapFinishedAsyncJobs
+
+    /**
+     * @brief Cancel every running async job and wait for their driver threads
+     */
+    void cancelAsyncIngestionJobs() {
+        std::vector<AsyncIngestion> jobs;
+        {
+            std::lock_guard<std::mutex> lock(async_jobs_mutex_);
+            jobs.swap(async_jobs_);
+        }
+        for (auto& job : jobs) {
+            job.state->cancelled = true;
+        }
+        for (auto& job : jobs) {
+            if (job.thread.joinable()) {
+                job.thread.join();
+            }
+        }
+    } //cancelAsyncIngestionJobs
+    
+    /**
+     * @brief SearchDeadline of a running call: the clock, and the degradations reported back when it ends
+     */
+    struct QueryDeadline {
+        static constexpr double kMinProbeFraction = 0.25;   // Fewest probes, as a fraction of the configured ones
+        
+        SearchDeadline& report;
+        QueryStats* stats = nullptr;    // Also receives the total time and degradations, if set
+        debug::timer::TimePoint start = debug::timer::now();
+        uint32_t degradations = 0;
+        bool allow_unhydrated = true;   // RAG needs the text, so it never returns bare ids
+        
+        QueryDeadline(SearchDeadline& deadline, QueryStats* query_stats) : report(deadline), stats(query_stats) {
+            if (stats) {
+                *stats = QueryStats();
+            }
+        }
+        ~QueryDeadline() {
+            report.degradations = degradations;
+            report.elapsed_ms = debug::timer::elapsed_milliseconds(start, debug::timer::now());
+            if (stats) {
+                stats->degradations = degradations;
+                stats->total_ms = report.elapsed_ms;
+                logQueryStats(*stats);
+            }
+        }
+        
+        bool active() const { return report.budget_ms > 0.0; }
+        double remaining_ms() const { return report.budget_ms - debug::timer::elapsed_milliseconds(start, debug::timer::now()); }
+        bool fits(double expected_ms) const { return !active() || expected_ms <= remaining_ms(); }
+        void degrade(SearchDegradation degradation) { degradations |= static_cast<uint32_t>(degradation); }
+    };
+    
+    /**
+     * @brief One log line per call that asked for QueryStats, so slow queries can be attributed without debug logging
+     */
+    static void logQueryStats(const QueryStats& stats) {
+        LEAFRA_INFO() << "📊 Query " << stats.total_ms << "ms: tokenize " << stats.tokenize_ms << ", embed " << stats.embed_ms
+                      << (stats.embedding_cache_hit ? " (cached)" : "") << ", ann " << stats.ann_ms << " (" << stats.candidates
+                      << " candidates), rerank " << stats.rerank_ms << ", hydrate " << stats.hydrate_ms
+                      << (stats.result_cache_hit ? ", results cached" : "") << ", prompt " << stats.prompt_build_ms
+                      << ", prefill " << stats.prefill_ms << ", ttft " << stats.ttft_ms << ", decode " << stats.decode_ms
+                      << (stats.answer_cache_hit ? ", answer cached" : "") << ", " << stats.results << " results";
+    }
+    
+    /**
+     * @brief Check if the query's embedding is in the query cache (a search then skips QUERY_EMBED)
+     */
+    bool queryEmbeddingCached(const std::string& query) {
+        if (!config_.search_cache.enabled) {
+            return false;
+        }
+        const std::string cache_key = makeQueryCacheKey(query, queryPrefix());
+        std::lock_guard<std::mutex> lock(query_mutex_);
+        return query_embedding_cache_.get(cache_key) != nullptr;
+    }
+ 
+    /**
+     * @brief Body of semantic_search_collections / semantic_search_ids
+     * @param fields SearchResultFields hydrated into the hits (anything but ALL bypasses the result cache)
+     * @param text_out If set, receives the hits with their text (see hydrateSearchResults)
+     * @param deadline If set, degrades the search to finish within its budget (see SearchDeadline)
+     * @param stats If set, the time of each stage, the candidate count and cache hits are added to it
+     */
+    ResultCode searchCollections(const std::string& query, const std::vector<std::string>& collections, int max_results,
+                                 std::vector<FaissIndex::SearchResult>& results, const FaissIndex::SearchParams& search_params,
+                                 uint32_t fields, SearchResultSet* text_out = nullptr, QueryDeadline* deadline = nullptr,
+                                 QueryStats* stats = nullptr) {
+        ThroughputGovernor::InteractiveScope interactive(governor_); // Ingestion steps back while this runs
+        pollThroughputGovernor();
+        trace::Span span("query", "semantic_search");
+        span.arg("max_results", max_results);
+    
+        if (query.empty() || max_results <= 0) {
+            LEAFRA_ERROR() << "Invalid query or max_results";
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+    
+#ifdef LEAFRA_HAS_FAISS
+        refreshAttachedStore();
+        // Shards are snapshotted up front, so a concurrent rebuild_collection can't pull one out from under the search;
+        // a re-index waits for the query to be embedded with the model they were built with
+        ModelUse model_use(model_swap_mutex_);
+        const std::vector<std::shared_ptr<FaissIndex>> shards = faissShards(collections);
+        if (shards.empty()) {
+            if (collections.empty()) {
+                LEAFRA_ERROR() << "FAISS index not available";
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+            results.clear();
+            LEAFRA_INFO() << "None of the requested collections hold documents";
+            return ResultCode::SUCCESS;
+        }
+#else
+        (void)collections;
+        (void)results;
+        (void)search_params;
+        (void)fields;
+        (void)text_out;
+        (void)deadline;
+        LEAFRA_ERROR() << "FAISS support not compiled";
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+
+        try {
+#ifdef LEAFRA_HAS_FAISS
+            // Repeated queries (e.g. semantic_search followed by semantic_search_with_llm) skip embedding and FAISS entirely
+            const FaissIndex::SearchParams params = searchParams(search_params);
+            std::string result_cache_key;
+            if (config_.search_cache.cache_results && !params.allowed_ids && fields == static_cast<uint32_t>(SearchResultFields::ALL)) {
+                result_cache_key = makeQueryCacheKey(query, queryPrefix()) + "\n" + std::to_string(max_results) +
+                                   "\n" + std::to_string(params.nprobe) + "/" + std::to_string(params.ef_search) + "/" +
+                                   std::to_string(params.max_codes);
+                for (const std::string& collection : collections) {
+                    result_cache_key += "\n#" + collection;
+                }
+                if (lookupCachedSearch(result_cache_key, results)) {
+#ifdef LEAFRA_HAS_SQLITE
+                    recordRetrievals(results);
+#endif
+                    if (text_out) {
+                        fillResultSet(results, *text_out);
+                    }
+                    if (stats) {
+                        stats->result_cache_hit = true;
+                    }
+                    LEAFRA_INFO() << "Semantic search served " << results.size() << " cached results";
+                    return ResultCode::SUCCESS;
+                }
+            }
+            
+            // Typical stage costs from the metrics; a stage that never ran yet counts as free
+            const double faiss_ms = deadline ? metrics_.typical_ms(PipelineStage::FAISS_SEARCH) : 0.0;
+            const double hydrate_ms = deadline ? metrics_.typical_ms(PipelineStage::DB_HYDRATE) : 0.0;
+#ifdef LEAFRA_HAS_SQLITE
+            if (deadline && deadline->active() && collections.empty() && !params.allowed_ids && keyword_index_available_ &&
+                database_ && database_->isOpen()) {
+                const double embed_ms = queryEmbeddingCached(query) ? 0.0 : metrics_.typical_ms(PipelineStage::QUERY_EMBED);
+                const auto keyword_start = debug::timer::now();
+                if (!deadline->fits(embed_ms + faiss_ms * QueryDeadline::kMinProbeFraction) &&
+                    keywordSearch(query, max_results, results)) {
+                    if (stats) {
+                        stats->ann_ms += debug::timer::elapsed_milliseconds(keyword_start, debug::timer::now());
+                    }
+                    deadline->degrade(SearchDegradation::KEYWORD_FALLBACK);
+                    recordRetrievals(results);
+                    if (text_out) {
+                        fillResultSet(results, *text_out);
+                    }
+                    LEAFRA_INFO() << "⏱️ Search deadline too short for a vector search, served " << results.size() << " keyword results";
+                    return ResultCode::SUCCESS;
+                }
+            }
+#endif
+#endif
+        
+            // Query fast path: tokenize straight into a reused buffer, no chunker / bulk pipeline
+            std::vector<float> query_embedding;
+            ResultCode embed_result = embedQuery(query, query_embedding, stats);
+            if (embed_result != ResultCode::SUCCESS) {
+                return embed_result;
+            }
+        
+            if (config_.debug_mode && LEAFRA_LOG_ENABLED(LogLevel::LEAFRA_DEBUG)) {
+                std::ostringstream embedding_stream;
+                embedding_stream << "Generated embedding for query (dim: " << query_embedding.size() << "): [";
+                for (size_t i = 0; i < query_embedding.size(); ++i) {
+                    embedding_stream << query_embedding[i];
+                    if (i < query_embedding.size() - 1) {
+                        embedding_stream << ", ";
+                    }
+                }
+                embedding_stream << "]";
+                LEAFRA_DEBUG() << embedding_stream.str();
+            }
+        
+        
+#ifdef LEAFRA_HAS_FAISS
+            // Generation is read before searching so results racing with an index update are never cached as current
+            uint64_t index_generation = faissGeneration();
+        
+            // Perform FAISS search (fanned out over the collection shards)
+            std::vector<std::vector<FaissIndex::SearchResult>> shard_hits;
+            int candidates = rerankCandidates(shards, max_results);
+            FaissIndex::SearchParams chunk_params = params;
+            if (deadline && deadline->active()) {
+                // Re-scoring reads the candidates' embeddings, about what hydrating them costs
+                if (candidates > max_results && !deadline->fits(faiss_ms + 2.0 * hydrate_ms)) {
+                    candidates = max_results;
+                    deadline->degrade(SearchDegradation::SKIPPED_RERANK);
+                }
+                const bool approximate = std::any_of(shards.begin(), shards.end(), [](const std::shared_ptr<FaissIndex>& shard) {
+                    const FaissIndex::IndexType type = shard->get_index_type();
+                    return type == FaissIndex::IndexType::IVF_FLAT || type == FaissIndex::IndexType::IVF_PQ ||
+                           type == FaissIndex::IndexType::HNSW || type == FaissIndex::IndexType::HNSW_SQ;
+                });
+                if (approximate && faiss_ms > 0.0 && !deadline->fits(faiss_ms + hydrate_ms)) {
+                    // Search cost scales about linearly with the lists / candidates visited
+                    const double fraction = std::min(1.0, std::max(QueryDeadline::kMinProbeFraction,
+                                                                   (deadline->remaining_ms() - hydrate_ms) / faiss_ms));
+                    chunk_params.nprobe = std::max(1, static_cast<int>(chunk_params.nprobe * fraction));
+                    chunk_params.ef_search = std::max(1, static_cast<int>(chunk_params.ef_search * fraction));
+                    deadline->degrade(SearchDegradation::REDUCED_PROBES);
+                }
+            }
+            const auto ann_start = debug::timer::now();
+#ifdef LEAFRA_HAS_SQLITE
+            // Hierarchical search: only the chunks of the nearest documents (the document index spans every collection)
+            std::vector<int64_t> document_chunk_ids;
+            if (collections.empty() && !params.allowed_ids && selectDocumentChunks(query_embedding.data(), document_chunk_ids)) {
+                chunk_params.allowed_ids = &document_chunk_ids;
+            }
+            // A filter down to a few chunks is scored exactly in SQL: exact, and cheaper than an index pass discarding nearly everything
+            bool exact = false;
+            if (chunk_params.allowed_ids && exactScanFits(chunk_params.allowed_ids->size())) {
+                shard_hits.assign(1, std::vector<FaissIndex::SearchResult>());
+                exact = exactFilteredSearch(query_embedding.data(), max_results, *chunk_params.allowed_ids, shard_hits[0]);
+                if (exact) {
+                    candidates = max_results;
+                }
+            }
+            ResultCode search_result = exact ? ResultCode::SUCCESS
+                                             : searchFaissShardsBatched(shards, query_embedding.data(), candidates, chunk_params, shard_hits);
+#else
+            ResultCode search_result = searchFaissShardsBatched(shards, query_embedding.data(), candidates, chunk_params, shard_hits);
+#endif
+        
+            if (search_result != ResultCode::SUCCESS) {
+                LEAFRA_ERROR() << "FAISS search failed";
+                return search_result;
+            }
+            if (stats) {
+                stats->ann_ms += debug::timer::elapsed_milliseconds(ann_start, debug::timer::now());
+                stats->candidates = static_cast<int32_t>(shard_hits[0].size());
+            }
+#ifdef LEAFRA_HAS_SQLITE
+            if (candidates > max_results && deadline && !deadline->fits(2.0 * hydrate_ms)) {
+                shard_hits[0].resize(std::min(shard_hits[0].size(), static_cast<size_t>(max_results)));
+                deadline->degrade(SearchDegradation::SKIPPED_RERANK);
+            } else if (candidates > max_results) {
+                const auto rerank_start = debug::timer::now();
+                rerankSearchResults(query_embedding.data(), max_results, shard_hits);
+                if (stats) {
+                    stats->rerank_ms += debug::timer::elapsed_milliseconds(rerank_start, debug::timer::now());
+                }
+            }
+#endif
+            results = std::move(shard_hits[0]);
+
+            // Get the chunks from the database using FAISS IDs
+#ifdef LEAFRA_HAS_SQLITE
+            if (deadline && deadline->allow_unhydrated && fields != static_cast<uint32_t>(SearchResultFields::IDS) &&
+                !deadline->fits(hydrate_ms)) {
+                deadline->degrade(SearchDegradation::UNHYDRATED);
+                if (text_out) {
+                    fillResultSet(results, *text_out);
+                }
+                LEAFRA_INFO() << "⏱️ Search deadline reached, returning " << results.size() << " hits without text";
+            } else if (database_ && database_->isOpen()) {
+                const auto hydrate_start = debug::timer::now();
+                hydrateSearchResults(results, fields, text_out);
+                if (stats) {
+                    stats->hydrate_ms += debug::timer::elapsed_milliseconds(hydrate_start, debug::timer::now());
+                }
+                recordRetrievals(results);
+                LEAFRA_INFO() << "Semantic search found " << results.size() << " valid results for query";
+            } else {
+                LEAFRA_WARNING() << "Database not available for chunk lookup";
+                if (text_out) {
+                    fillResultSet(results, *text_out);
+                }
+            }
+#else
+            LEAFRA_WARNING() << "SQLite support not compiled, returning FAISS IDs only";
+            if (text_out) {
+                fillResultSet(results, *text_out);
+            }
+#endif
+        
+
+
+            if (deadline && deadline->degradations != 0) {
+                // A degraded answer must not be served to a later search that has the time for a full one
+                result_cache_key.clear();
+                LEAFRA_INFO() << "⏱️ Search degraded to meet its deadline (flags " << deadline->degradations << ")";
+            }
+            if (!result_cache_key.empty()) {
+                if (text_out) {
+                    // The cache keeps its own copy of the text, which the hits left in text_out
+                    for (size_t i = 0; i < results.size() && i < text_out->size(); ++i) {
+                        results[i].content.assign((*text_out)[i].content);
+                        results[i].filename.assign((*text_out)[i].filename);
+                    }
+                }
+                storeCachedSearch(result_cache_key, index_generation, results);
+            }
+
+            LEAFRA_INFO() << "Semantic search completed with " << results.size() << " results";
+            return ResultCode::SUCCESS;
+#endif
+        
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "Exception in semantic_search: " << e.what();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+    } //searchCollections
+    
+#ifdef LEAFRA_HAS_FAISS
+    /**
+     * @brief Body of SearchSession::search, after the debounce
+     * 
+     * searchCollections without the caches and deadlines, checking between stages whether
+     * newer input made the search stale. The previous ranking is appended to the index
+     * candidates and re-scored exactly with them; hits found in the session's rows are not
+     * hydrated again.
+     * 
+     * @param session Session the search runs for
+     * @param ticket Generation of this search (stale once session.generation moves on)
+     * @return ResultCode indicating success or failure (ERROR_CANCELLED once stale)
+     */
+    ResultCode searchSessionQuery(SearchSession::State& session, uint64_t ticket, const std::string& query, int max_results,
+                                  std::vector<FaissIndex::SearchResult>& results) {
+        ThroughputGovernor::InteractiveScope interactive(governor_);
+        pollThroughputGovernor();
+        trace::Span span("query", "search_session");
+        span.arg("max_results", max_results);
+        
+        refreshAttachedStore();
+        ModelUse model_use(model_swap_mutex_);
+        const std::vector<std::shared_ptr<FaissIndex>> shards = faissShards();
+        if (shards.empty()) {
+            LEAFRA_ERROR() << "FAISS index not available";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        
+        std::vector<FaissIndex::SearchResult> seeds;
+        const uint64_t index_generation = faissGeneration();
+        {
+            std::lock_guard<std::mutex> lock(session.mutex);
+            if (session.rows_generation != index_generation) {
+                // Chunks may have been deleted or re-ingested since the rows were read
+                session.rows.clear();
+                session.previous.clear();
+                session.rows_generation = index_generation;
+            }
+            seeds = session.previous;
+        }
+        
+        try {
+            std::vector<float> query_embedding;
+            ResultCode embed_result = embedQuery(query, query_embedding);
+            if (embed_result != ResultCode::SUCCESS) {
+                return embed_result;
+            }
+            if (session.stale(ticket)) {
+                return ResultCode::ERROR_CANCELLED;
+            }
+            
+            const FaissIndex::SearchParams params = searchParams(session.options.search_params);
+            int candidates = rerankCandidates(shards, max_results);
+            std::vector<std::vector<FaissIndex::SearchResult>> shard_hits;
+            ResultCode search_result = searchFaissShardsBatched(shards, query_embedding.data(), candidates, params, shard_hits);
+            if (search_result != ResultCode::SUCCESS) {
+                LEAFRA_ERROR() << "FAISS search failed";
+                return search_result;
+            }
+            if (session.stale(ticket)) {
+                return ResultCode::ERROR_CANCELLED;
+            }
+            
+#ifdef LEAFRA_HAS_SQLITE
+            // Seeds are only comparable with the new candidates once re-scored from their stored embeddings
+            if (embedding_storage_format_ != EmbeddingStorageFormat::NONE && database_ && database_->isOpen()) {
+                std::unordered_set<int64_t> found;
+                for (const FaissIndex::SearchResult& hit : shard_hits[0]) {
+                    found.insert(hit.id);
+                }
+                bool seeded = false;
+                for (const FaissIndex::SearchResult& seed : seeds) {
+                    if (found.insert(seed.id).second) {
+                        shard_hits[0].emplace_back(seed.id, seed.distance);
+                        seeded = true;
+                    }
+                }
+                if (candidates > max_results || seeded) {
+                    rerankSearchResults(query_embedding.data(), max_results, shard_hits);
+                }
+            }
+#endif
+            if (shard_hits[0].size() > static_cast<size_t>(max_results)) {
+                shard_hits[0].resize(static_cast<size_t>(max_results));
+            }
+            if (session.stale(ticket)) {
+                return ResultCode::ERROR_CANCELLED;
+            }
+            
+            // Hits hydrated for an earlier keystroke are copied from the session, only the rest are read
+            std::vector<FaissIndex::SearchResult> ranked = std::move(shard_hits[0]);
+            std::vector<FaissIndex::SearchResult> missing;
+            std::vector<char> cached(ranked.size(), 0);
+            {
+                std::lock_guard<std::mutex> lock(session.mutex);
+                for (size_t i = 0; i < ranked.size(); ++i) {
+                    auto row = session.rows.find(ranked[i].id);
+                    if (row != session.rows.end()) {
+                        const float distance = ranked[i].distance;
+                        ranked[i] = row->second;
+                        ranked[i].distance = distance;
+                        cached[i] = 1;
+                    } else {
+                        missing.push_back(ranked[i]);
+                    }
+                }
+            }
+#ifdef LEAFRA_HAS_SQLITE
+            if (!missing.empty() && database_ && database_->isOpen() && !hydrateSearchResults(missing)) {
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+#endif
+            std::unordered_map<int64_t, size_t> hydrated;
+            for (size_t i = 0; i < missing.size(); ++i) {
+                hydrated.emplace(missing[i].id, i);
+            }
+            results.clear();
+            size_t reused = 0;
+            for (size_t i = 0; i < ranked.size(); ++i) {
+                if (cached[i]) {
+                    results.push_back(std::move(ranked[i]));
+                    reused++;
+                    continue;
+                }
+                auto row = hydrated.find(ranked[i].id);
+                if (row != hydrated.end()) {
+                    // Hits missing from the database were dropped by the lookup
+                    results.push_back(std::move(missing[row->second]));
+                    results.back().distance = ranked[i].distance;
+                }
+            }
+            
+            std::lock_guard<std::mutex> lock(session.mutex);
+            if (session.stale(ticket)) {
+                return ResultCode::ERROR_CANCELLED;
+            }
+            if (session.rows.size() + missing.size() > session.options.max_cached_rows) {
+                session.rows.clear();
+            }
+            session.previous.clear();
+            for (const FaissIndex::SearchResult& hit : results) {
+                session.rows.emplace(hit.id, hit);
+                session.previous.emplace_back(hit.id, hit.distance);
+            }
+            session.stats.searches++;
+            session.stats.reused_rows += reused;
+            session.stats.hydrated_rows += results.size() - reused;
+            LEAFRA_DEBUG() << "Session search found " << results.size() << " results (" << reused << " rows reused)";
+            return ResultCode::SUCCESS;
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "Exception in session search: " << e.what();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+    } //searchSessionQuery
+    
+    /**
+     * @brief Page of a SearchCursor: extend its candidates by k-doubling if they run short, hydrate the next page_size
+     * @param cursor Cursor to advance (caller holds its mutex)
+     * @param results Output page, best first
+     * @return ResultCode indicating success or failure
+     */
+    ResultCode fetchCursorPage(SearchCursor::State& cursor, std::vector<FaissIndex::SearchResult>& results) {
+        ThroughputGovernor::InteractiveScope interactive(governor_);
+        trace::Span span("query", "next_page");
+        span.arg("page_size", cursor.page_size);
+        results.clear();
+        
+        try {
+            int64_t total = 0;
+            for (const std::shared_ptr<FaissIndex>& shard : cursor.shards) {
+                total += shard->get_count();
+            }
+            if (total <= 0) {
+                cursor.exhausted = true;
+            }
+            const size_t wanted = cursor.returned.size() + static_cast<size_t>(cursor.page_size);
+            while (!cursor.exhausted && cursor.unreturned() < static_cast<size_t>(cursor.page_size)) {
+                // Extending is a fresh search at the larger k; the pages already returned are skipped, not re-hydrated
+                const int k = static_cast<int>(std::min<int64_t>(total, std::max<int64_t>(2LL * cursor.fetched_k,
+                                                                                        static_cast<int64_t>(wanted))));
+                std::vector<std::vector<FaissIndex::SearchResult>> shard_hits;
+                const int candidates = rerankCandidates(cursor.shards, k);
+                ResultCode search_result = searchFaissShards(cursor.shards, cursor.query_embedding.data(), 1, candidates,
+                                                             cursor.params, shard_hits);
+                if (search_result != ResultCode::SUCCESS) {
+                    LEAFRA_ERROR() << "FAISS search failed";
+                    return search_result;
+                }
+#ifdef LEAFRA_HAS_SQLITE
+                if (candidates > k) {
+                    rerankSearchResults(cursor.query_embedding.data(), k, shard_hits);
+                }
+#endif
+                if (shard_hits[0].size() > static_cast<size_t>(k)) {
+                    shard_hits[0].resize(static_cast<size_t>(k));
+                }
+                cursor.exhausted = k >= total || shard_hits[0].size() < static_cast<size_t>(k) || k <= cursor.fetched_k;
+                cursor.fetched_k = k;
+                cursor.candidates = std::move(shard_hits[0]);
+            }
+            
+            for (const FaissIndex::SearchResult& hit : cursor.candidates) {
+                if (results.size() >= static_cast<size_t>(cursor.page_size)) {
+                    break;
+                }
+                if (cursor.returned.insert(hit.id).second) {
+                    results.emplace_back(hit.id, hit.distance);
+                }
+            }
+#ifdef LEAFRA_HAS_SQLITE
+            if (!results.empty() && database_ && database_->isOpen()) {
+                if (!hydrateSearchResults(results)) {
+                    return ResultCode::ERROR_PROCESSING_FAILED;
+                }
+                recordRetrievals(results);
+            }
+#endif
+            LEAFRA_DEBUG() << "Search page of " << results.size() << " results (" << cursor.returned.size() << " returned, k "
+                           << cursor.fetched_k << ")";
+            return ResultCode::SUCCESS;
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "Exception in next_page: " << e.what();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+    } //fetchCursorPage
+#endif
+    
+    /**
+     * @brief Pull what the first queries touch into memory (prefetch_after_initialize, runs on the worker pool)
+     *
+     * Asks the OS to read the model files and the memory-mapped FAISS files ahead, loads the
+     * rows of the most retrieved chunks and searches each collection with those chunks' own
+     * vectors, so the index pages real queries visit are resident and the SQLite cache is warm.
+     */
+    void warmUp() {
+        auto start_time = std::chrono::steady_clock::now();
+        waitForEngines();
+        
+        uint64_t prefetched = 0;
+        if (config_.embedding_inference.enabled && !config_.embedding_inference.model_path.empty()) {
+            prefetched += FileManager::prefetchFile(config_.embedding_inference.model_path);
+        }
+#ifdef LEAFRA_HAS_LLAMACPP
+        // Without mmap the weights were read into memory by the load
+        if (config_.llm.enabled && config_.llm.use_mmap && !config_.llm.model_path.empty()) {
+            prefetched += FileManager::prefetchFile(config_.llm.model_path);
+        }
+#endif
+        size_t warmed_chunks = 0;
+#ifdef LEAFRA_HAS_FAISS
+        const std::vector<std::shared_ptr<FaissIndex>> shards = faissShards();
+        for (const std::shared_ptr<FaissIndex>& shard : shards) {
+            if (warmup_cancelled_) {
+                return;
+            }
+            prefetched += shard->prefetch();
+        }
+#ifdef LEAFRA_HAS_SQLITE
+        static constexpr int kMaxWarmupQueries = 32;    // Hot chunks searched per collection
+        static constexpr int kWarmupNeighbors = 10;
+        if (chunk_retrievals_available_ && config_.prefetch_hot_chunks > 0 && database_ && database_->isOpen() &&
+            !warmup_cancelled_) {
+            flushRetrievalCounts(false);
+            std::vector<FaissIndex::SearchResult> hot;
+            {
+                SQLiteReadPool::Lease reader = read_pool_.acquire(database_.get());
+                auto stmt = reader->prepareCached("SELECT chunk_faiss_id FROM chunk_retrievals ORDER BY retrievals DESC LIMIT ?");
+                if (stmt && stmt->isValid()) {
+                    stmt->bindInt(1, config_.prefetch_hot_chunks);
+                    stmt->forEachRow([&hot](const SQLiteDatabase::Row& row) {
+                        hot.emplace_back(row.getInt64(0));
+                        return true;
+                    });
+                }
+            }
+            if (!hot.empty() && !warmup_cancelled_) {
+                hydrateSearchResults(hot);
+                warmed_chunks = hot.size();
+            }
+            
+            std::vector<int64_t> query_ids;
+            for (size_t i = 0; i < hot.size() && query_ids.size() < static_cast<size_t>(kMaxWarmupQueries); ++i) {
+                query_ids.push_back(hot[i].id);
+            }
+            for (const std::shared_ptr<FaissIndex>& shard : shards) {
+                // A reduced index stores fewer dimensions than it searches with, so its vectors can't be queries
+                if (warmup_cancelled_ || query_ids.empty() || shard->get_dimension() != shard->get_index_dimension()) {
+                    continue;
+                }
+                const size_t dimension = static_cast<size_t>(shard->get_dimension());
+                std::vector<float> vectors(query_ids.size() * dimension);
+                std::vector<char> found;
+                if (shard->get_vectors(query_ids.data(), static_cast<int>(query_ids.size()), vectors.data(), found) != ResultCode::SUCCESS) {
+                    continue;
+                }
+                size_t queries = 0;
+                for (size_t i = 0; i < query_ids.size(); ++i) {
+                    if (found[i]) {
+                        std::copy_n(vectors.begin() + i * dimension, dimension, vectors.begin() + queries * dimension);
+                        queries++;
+                    }
+                }
+                std::vector<std::vector<FaissIndex::SearchResult>> neighbors;
+                if (queries > 0) {
+                    shard->batch_search(vectors.data(), static_cast<int>(queries), kWarmupNeighbors, neighbors, searchParams(FaissIndex::SearchParams()));
+                }
+            }
+        }
+#endif
+#endif
+        if (warmup_cancelled_) {
+            return;
+        }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+        LEAFRA_INFO() << "🔥 Warm-up finished in " << elapsed.count() << " ms: " << (prefetched >> 20) << " MB prefetched, "
+                      << warmed_chunks << " hot chunks loaded";
+    } //warmUp
+ 
+}; // LeafraCore::Impl
+
+// ==============================================================================
+// IngestionJob Implementation
+// ==============================================================================
+
+IngestionJob::IngestionJob(std::shared_ptr<State> state) : state_(std::move(state)) {
+}
+
+IngestionJob::~IngestionJob() = default;
+
+void IngestionJob::cancel() {
+    if (state_ && !state_->cancelled.exchange(true)) {
+        LEAFRA_INFO() << "Cancellation requested for ingestion job (" << state_->file_paths.size() << " files)";
+    }
+}
+
+bool IngestionJob::is_cancelled() const {
+    return state_ && state_->cancelled.load();
+}
+
+bool IngestionJob::is_done() const {
+    return !state_ || state_->done.load();
+}
+
+ResultCode IngestionJob::wait() const {
+    if (!state_) {
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    return state_->future.get();
+}
+
+std::shared_future<ResultCode> IngestionJob::get_future() const {
+    return state_ ? state_->future : std::shared_future<ResultCode>();
+}
+
+size_t IngestionJob::get_total_files() const {
+    return state_ ? state_->file_paths.size() : 0;
+}
+
+size_t IngestionJob::get_finished_files() const {
+    return state_ ? state_->finished_files.load() : 0;
+}
+
+size_t IngestionJob::get_failed_files() const {
+    return state_ ? state_->failed_files.load() : 0;
+}
+
+#ifdef LEAFRA_HAS_FAISS
+// ==============================================================================
+// SearchSession Implementation
+// ==============================================================================
+
+SearchSession::SearchSession(std::shared_ptr<State> state) : state_(std::move(state)) {
+}
+
+SearchSession::~SearchSession() {
+    cancel();
+}
+
+ResultCode SearchSession::search(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results) {
+    if (!state_ || max_results <= 0) {
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    uint64_t ticket = 0;
+    {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        ticket = ++state_->generation;
+        state_->input_cv.notify_all();
+        if (query.empty()) {
+            results.clear();
+            state_->previous.clear();
+            return ResultCode::SUCCESS;
+        }
+        if (state_->options.debounce_ms > 0) {
+            state_->input_cv.wait_for(lock, std::chrono::milliseconds(state_->options.debounce_ms),
+                                      [this, ticket] { return state_->stale(ticket); });
+        }
+        if (state_->stale(ticket)) {
+            state_->stats.superseded++;
+            return ResultCode::ERROR_CANCELLED;
+        }
+    }
+    
+    ResultCode result = state_->run(*state_, ticket, query, max_results, results);
+    if (result == ResultCode::ERROR_CANCELLED) {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stats.superseded++;
+        results.clear();
+    }
+    return result;
+} //search
+
+void SearchSession::cancel() {
+    if (!state_) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->generation++;
+    state_->input_cv.notify_all();
+}
+
+void SearchSession::reset() {
+    if (!state_) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->generation++;
+    state_->input_cv.notify_all();
+    state_->previous.clear();
+    state_->rows.clear();
+}
+
+SearchCursor::SearchCursor(std::shared_ptr<State> state) : state_(std::move(state)) {
+}
+
+SearchCursor::~SearchCursor() = default;
+
+bool SearchCursor::has_more() const {
+    if (!state_) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return !state_->exhausted || state_->unreturned() > 0;
+}
+
+size_t SearchCursor::get_returned() const {
+    if (!state_) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->returned.size();
+}
+
+SearchSession::Stats SearchSession::get_stats() const {
+    if (!state_) {
+        return Stats();
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->stats;
+}
+#endif
+
+// ==============================================================================
+// LeafraCore Implementation
+// ==============================================================================
+
+LeafraCore::LeafraCore() : pImpl(std::make_unique<Impl>()) {
+}
+
+LeafraCore::~LeafraCore() = default;
+
+ResultCode LeafraCore::initialize(const Config& requested_config) {
+    if (pImpl->initialized_) {
+        return ResultCode::SUCCESS; // Already initialized
+    }
+    
+    try {
+        Config config = requested_config;
+        pImpl->config_ = config;
+        
+        // Initialize logging system
+        pImpl->configureLogging(config);
+        if (config.trace_enabled) {
+            trace::start(static_cast<size_t>(std::max<int32_t>(config.trace_max_events_per_thread, 1)));
+            LEAFRA_INFO() << "⏱️ Tracing enabled";
+        }
+        MemoryAccountant::instance().set_total_budget(static_cast<uint64_t>(std::max<int32_t>(config.memory_budget_mb, 0)) * 1024 * 1024);
+        if (config.memory_budget_mb > 0) {
+            LEAFRA_INFO() << "📏 Memory budget: " << config.memory_budget_mb << " MB";
+        }
+        
+        LEAFRA_INFO() << "Initializing LeafraSDK v" << get_version();
+        LEAFRA_DEBUG() << "Config - Name: " << config.name << ", Threads: " << config.max_threads << ", Buffer: " << config.buffer_size;
+        LEAFRA_DEBUG() << "Vector kernels: " << simd::isa_name(simd::active_isa());
+        // Only named here; mapped once some text needs ICU data
+        set_icu_data_file(config.icu_data_path);
+        LargePagePolicy large_page_policy = LargePagePolicy::OFF;
+        if (!large_pages::parse_policy(config.large_pages, large_page_policy)) {
+            LEAFRA_WARNING() << "⚠️ Unknown large_pages policy '" << config.large_pages << "', using \"off\"";
+        } else if (large_page_policy != LargePagePolicy::OFF && !large_pages::supported()) {
+            LEAFRA_WARNING() << "⚠️ large_pages \"" << config.large_pages << "\" requested but transparent huge pages are unavailable";
+        }
+        large_pages::set_policy(large_page_policy);
+        // A shared container (app group) holds the store instead of app storage, for every process that opens it
+        FileManager::setStorageBasePath(StorageType::AppStorage, config.storage_directory);
+        pImpl->attached_ = config.attach_read_only;
+        
+        // Settings autotune() measured on this device, before anything is sized from them
+        pImpl->loadDeviceProfile();
+        pImpl->applyDeviceProfile(config);
+        pImpl->config_ = config;
+        
+        // Hand threads out by core kind: latency-bound engines on the performance cores,
+        // ingestion at utility QoS so it yields them to queries
+        CpuTopology topology = PlatformUtils::get_cpu_topology();
+        pImpl->thread_budget_ = ThreadBudget::resolve(topology, config);
+        LEAFRA_INFO() << "🧵 CPU: " << topology.logical_cores << " cores (" << topology.performance_cores << " performance, "
+                      << topology.efficiency_cores << " efficiency)";
+        
+        // Create the ingestion pool (used by the parallel ingestion pipeline) and the query fan-out pool
+        size_t worker_threads = pImpl->thread_budget_.ingest_workers;
+        pImpl->worker_pool_ = std::make_unique<ThreadPool>(worker_threads, ThreadQoS::UTILITY, "LeafraWorker");
+        pImpl->query_pool_ = std::make_unique<ThreadPool>(pImpl->thread_budget_.query_workers, ThreadQoS::USER_INITIATED, "LeafraQuery");
+        // More request threads than embedder + LLM slots would only wait in the admission queue
+        const size_t request_threads = static_cast<size_t>(std::max(1, config.admission.max_concurrent_embeddings) +
+                                                           std::max(1, config.admission.max_concurrent_generations));
+        pImpl->request_pool_ = std::make_unique<ThreadPool>(request_threads, ThreadQoS::USER_INITIATED, "LeafraRequest");
+        if (config.vector_search.query_batch_size > 1) {
+            Impl* impl = pImpl.get();
+            MicroBatcher<Impl::QueryEmbedRequest, Impl::QueryEmbedResult>::Options batch_options;
+            batch_options.max_batch = static_cast<size_t>(config.vector_search.query_batch_size);
+            batch_options.window = std::chrono::microseconds(config.vector_search.query_batch_window_us);
+            pImpl->query_embed_batcher_ = std::make_unique<MicroBatcher<Impl::QueryEmbedRequest, Impl::QueryEmbedResult>>(
+                batch_options, [impl](std::vector<Impl::QueryEmbedRequest>& requests, std::vector<Impl::QueryEmbedResult>& results) {
+                    impl->runQueryEmbedBatch(requests, results);
+                });
+#ifdef LEAFRA_HAS_FAISS
+            MicroBatcher<Impl::IndexSearchRequest, Impl::IndexSearchResult>::Options search_options;
+            search_options.max_batch = batch_options.max_batch;
+            search_options.window = batch_options.window;
+            pImpl->index_search_batcher_ = std::make_unique<MicroBatcher<Impl::IndexSearchRequest, Impl::IndexSearchResult>>(
+                search_options, [impl](std::vector<Impl::IndexSearchRequest>& requests, std::vector<Impl::IndexSearchResult>& results) {
+                    impl->runIndexSearchBatch(requests, results);
+                });
+#endif
+        }
+        pImpl->requests_cancelled_ = false;
+        LEAFRA_INFO() << "Worker pool initialized with " << worker_threads << " threads (query pool: "
+                      << pImpl->thread_budget_.query_workers << ", LLM: " << pImpl->thread_budget_.llm_threads
+                      << ", embedding: " << pImpl->thread_budget_.embedding_threads << ")";
+        
+        // Throughput governor: starts at the budget, scaled by the current thermal / power state
+        ThroughputGovernor::Options governor_options;
+        governor_options.enabled = config.governor.enabled;
+        governor_options.poll_interval_ms = std::max<int32_t>(0, config.governor.poll_interval_ms);
+        governor_options.low_battery_percent = config.governor.low_battery_percent;
+        governor_options.interactive_ingest_workers = static_cast<size_t>(std::max<int32_t>(0, config.governor.interactive_ingest_workers));
+        ThroughputLimits ceiling;
+        ceiling.ingest_workers = worker_threads;
+        ceiling.embedding_batch_size = static_cast<size_t>(std::max(1, config.embedding_inference.batch_size));
+        ceiling.llm_threads = pImpl->thread_budget_.llm_threads;
+        ceiling.llm_batch_threads = pImpl->thread_budget_.llm_batch_threads;
+        ceiling.faiss_threads = pImpl->thread_budget_.faiss_threads;
+        pImpl->governor_.configure(governor_options, ceiling);
+        pImpl->admission_.configure(Impl::admissionOptions(config.admission));
+        
+        // Initialize data processor
+        if (pImpl->data_processor_) {
+            ResultCode result = pImpl->data_processor_->initialize();
+            if (result != ResultCode::SUCCESS) {
+                LEAFRA_ERROR() << "Failed to initialize data processor";
+                return result;
+            }
+            LEAFRA_DEBUG() << "Data processor initialized successfully";
+        }
+        
+        // Initialize file parser
+        if (pImpl->file_parser_) {
+            bool result = pImpl->file_parser_->initialize();
+            if (!result) {
+                LEAFRA_ERROR() << "Failed to initialize file parser";
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+            if (pImpl->worker_pool_) {
+                pImpl->file_parser_->configure([this](std::function<void()> task) {
+                    return pImpl->worker_pool_->submit(std::move(task));
+                }, pImpl->config_.parsing);
+            }
+            if (pImpl->config_.parsing.cache_enabled) {
+                uint64_t max_bytes = static_cast<uint64_t>(std::max<int32_t>(pImpl->config_.parsing.cache_max_mb, 0)) << 20;
+                pImpl->parse_cache_ = std::make_unique<ParseCache>(
+                    FileManager::getAbsolutePath(StorageType::AppStorage, "parse_cache"), max_bytes);
+                LEAFRA_INFO() << "🗂️ Parse cache enabled: " << pImpl->parse_cache_->directory();
+            }
+            LEAFRA_DEBUG() << "File parser initialized successfully";
+        }
+        
+        // Initialize chunker
+        if (pImpl->chunker_) {
+            ResultCode result = pImpl->chunker_->initialize();
+            if (result != ResultCode::SUCCESS) {
+                LEAFRA_ERROR() << "Failed to initialize chunker";
+                return result;
+            }
+            LEAFRA_DEBUG() << "Chunker initialized successfully";
+            
+            // Configure chunker with config settings
+            pImpl->chunker_->set_default_options(Impl::chunkingOptions(config.chunking));
+            
+            // Log chunking configuration
+            LEAFRA_INFO() << "Chunking configuration:";
+            LEAFRA_INFO() << "  - Enabled: " << (config.chunking.enabled ? "Yes" : "No");
+            LEAFRA_INFO() << "  - Chunk size: " << config.chunking.chunk_size 
+                          << (config.chunking.size_unit == ChunkSizeUnit::CHARACTERS ? " characters" :
+                              config.chunking.size_unit == ChunkSizeUnit::EXACT_TOKENS ? " tokens (exact)" : " tokens");
+            LEAFRA_INFO() << "  - Overlap: " << (config.chunking.overlap_percentage * 100.0) << "%";
+            LEAFRA_INFO() << "  - Token method: Simple";
+            LEAFRA_INFO() << "  - Strategy: " << (config.chunking.strategy == ChunkingStrategy::SENTENCE ? "Sentence" : "Fixed");
+        }
+        
+        // Initialize SentencePiece tokenizer if enabled
+        pImpl->reloadTokenizer();
+
+        // Initialize the embedding backend selected by embedding_inference.framework
+        Impl* impl = pImpl.get();
+        if (config.background_load) {
+#ifdef LEAFRA_HAS_LLAMACPP
+            // Both loads may use llama.cpp, so its backend is brought up before either starts
+            if (config.llm.enabled && !leafra::llamacpp::global::initialize(false)) {
+                LEAFRA_ERROR() << "Failed to initialize LlamaCpp backend";
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+#endif
+            pImpl->embedding_ready_ = std::async(std::launch::async, [impl]() {
+                try {
+                    impl->loadEmbeddingModel();
+                } catch (const std::exception& e) {
+                    LEAFRA_ERROR() << "Background embedding model load failed: " << e.what();
+                }
+                return impl->embedding_scheduler_ != nullptr;
+            }).share();
+            LEAFRA_INFO() << "⏳ Loading embedding model in the background";
+        } else {
+            ResultCode embedding_result = pImpl->loadEmbeddingModel();
+            if (embedding_result != ResultCode::SUCCESS) {
+                return embedding_result;
+            }
+            pImpl->embedding_ready_ = Impl::readyFuture(pImpl->embedding_scheduler_ != nullptr);
+        }
+        
+        // Query caches start empty for every configuration (model or prefix may have changed)
+        {
+            const auto& cache_config = config.search_cache;
+            std::lock_guard<std::mutex> lock(pImpl->query_mutex_);
+            pImpl->query_embedding_cache_.clear();
+            pImpl->query_embedding_cache_.reset_stats();
+            pImpl->query_embedding_cache_.set_capacity(cache_config.enabled ? static_cast<size_t>(std::max(0, cache_config.embedding_capacity)) : 0);
+#ifdef LEAFRA_HAS_FAISS
+            pImpl->search_result_cache_.clear();
+            pImpl->search_result_cache_.reset_stats();
+            pImpl->stale_search_results_ = 0;
+            pImpl->search_result_cache_.set_capacity(cache_config.cache_results ? static_cast<size_t>(std::max(0, cache_config.result_capacity)) : 0);
+#endif
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+            pImpl->answer_cache_.clear();
+            pImpl->answer_hits_ = 0;
+            pImpl->answer_misses_ = 0;
+            pImpl->answer_cache_.set_capacity(cache_config.cache_answers ? static_cast<size_t>(std::max(0, cache_config.answer_capacity)) : 0);
+#endif
+            LEAFRA_DEBUG() << "Search cache: " << pImpl->query_embedding_cache_.capacity() << " embeddings"
+                           << (cache_config.cache_results ? ", results enabled" : "")
+                           << (cache_config.cache_answers ? ", answers enabled" : "");
+        }
+        
+        // Initialize SQLite database - create if necessary 
+#ifdef LEAFRA_HAS_SQLITE
+        LEAFRA_INFO() << "Initializing SQLite database";
+        if (!config.database.is_valid()) {
+            LEAFRA_WARNING() << "⚠️  Invalid database configuration - SQLite will ignore unsupported settings";
+        }
+        
+        // Get absolute path to the database using FileManager
+        std::string db_absolute_path = FileManager::getAbsolutePath(
+            StorageType::AppStorage, 
+            config.leafra_document_database_name
+        );
+        
+        LEAFRA_DEBUG() << "Database path: " << db_absolute_path;
+        
+        // Check if database exists
+        if (config.attach_read_only && !SQLiteDatabase::fileExists(db_absolute_path)) {
+            LEAFRA_ERROR() << "❌ No database to attach to: " << db_absolute_path;
+            pImpl->send_event(EventType::ERROR_OCCURRED, "No database to attach to: " + config.leafra_document_database_name);
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        if (!SQLiteDatabase::fileExists(db_absolute_path)) {
+            LEAFRA_INFO() << "Database does not exist, creating new database: " << config.leafra_document_database_name;
+            
+            // Create the database with RAG schema
+            if (SQLiteDatabase::createdb(config.leafra_document_database_name, config.database)) {
+                LEAFRA_INFO() << "✅ Database created successfully: " << config.leafra_document_database_name;
+                pImpl->send_event(EventType::DATABASE_STATUS, "Database created: " + config.leafra_document_database_name);
+            } else {
+                LEAFRA_ERROR() << "❌ Failed to create database: " << config.leafra_document_database_name;
+                pImpl->send_event(EventType::ERROR_OCCURRED, "Failed to create database: " + config.leafra_document_database_name);
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+        } else {
+            LEAFRA_INFO() << "✅ Database already exists: " << config.leafra_document_database_name;
+            pImpl->send_event(EventType::DATABASE_STATUS, "Database found: " + config.leafra_document_database_name);
+        }
+        
+        // Open the database using our member object
+        if (pImpl->database_) {
+            pImpl->database_->setConfig(config.database);
+            if (pImpl->database_->open(config.leafra_document_database_name)) {
+                LEAFRA_INFO() << "✅ Database opened successfully: " << config.leafra_document_database_name;
+                pImpl->send_event(EventType::DATABASE_STATUS, "Database opened: " + config.leafra_document_database_name);
+            } else {
+                LEAFRA_ERROR() << "❌ Failed to open database: " << config.leafra_document_database_name;
+                pImpl->send_event(EventType::ERROR_OCCURRED, "Failed to open database: " + config.leafra_document_database_name);
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+        }
+
+        // Databases created before the FAISS id index existed hydrate search hits with full table scans
+        if (pImpl->database_ && pImpl->database_->isOpen() &&
+            !pImpl->database_->execute("CREATE UNIQUE INDEX IF NOT EXISTS idx_chunks_faiss_id ON chunks(chunk_faiss_id)")) {
+            LEAFRA_WARNING() << "Failed to create chunk FAISS id index: " << pImpl->database_->getLastErrorMessage();
+        }
+
+        // Databases created before change detection existed get its columns here (their docs re-index once)
+        if (pImpl->database_ && pImpl->database_->isOpen()) {
+            bool upgraded = pImpl->database_->addColumnIfMissing("docs", "file_size", "INTEGER") &&
+                            pImpl->database_->addColumnIfMissing("docs", "file_mtime", "INTEGER") &&
+                            pImpl->database_->addColumnIfMissing("docs", "content_hash", "TEXT") &&
+                            pImpl->database_->addColumnIfMissing("chunks", "chunk_hash", "TEXT") &&
+                            pImpl->database_->addColumnIfMissing("chunks", "chunk_simhash", "INTEGER");
+            if (!upgraded) {
+                LEAFRA_ERROR() << "❌ Failed to upgrade document schema for change detection";
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+            // Documents stored before collections existed belong to the default collection
+            if (!pImpl->database_->addColumnIfMissing("docs", "collection", "TEXT NOT NULL DEFAULT ''") ||
+                !pImpl->database_->execute("CREATE INDEX IF NOT EXISTS idx_docs_collection ON docs(collection)")) {
+                LEAFRA_ERROR() << "❌ Failed to upgrade document schema for collections";
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+            // Chunks stored before highlight offsets existed return none (-1) until re-ingested
+            if (!pImpl->database_->addColumnIfMissing("chunks", "chunk_doc_offset", "INTEGER") ||
+                !pImpl->database_->addColumnIfMissing("chunks", "chunk_page_offset", "INTEGER")) {
+                LEAFRA_ERROR() << "❌ Failed to upgrade chunk schema for highlight offsets";
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+        }
+
+        // Databases created before chunk_embeddings existed get it here (inline fp32 blobs are moved over once)
+        if (!VectorCodec::parse_format(config.vector_search.embedding_storage, pImpl->embedding_storage_format_)) {
+            LEAFRA_WARNING() << "Unknown embedding storage format '" << config.vector_search.embedding_storage << "', using fp16";
+            pImpl->embedding_storage_format_ = EmbeddingStorageFormat::FP16;
+        }
+        if (!TextCodec::parse_compression(config.database.chunk_text_compression, pImpl->chunk_text_compression_)) {
+            LEAFRA_WARNING() << "Unknown chunk text compression '" << config.database.chunk_text_compression << "', storing plain text";
+            pImpl->chunk_text_compression_ = TextCompression::NONE;
+        }
+        pImpl->chunk_text_offsets_ = config.database.chunk_text_storage == "offsets";
+        if (config.vector_search.ivf_on_disk_lists && config.vector_search.index_storage != "file") {
+            LEAFRA_WARNING() << "vector_search.ivf_on_disk_lists needs index_storage \"file\" - inverted lists stay in memory";
+        }
+        if (config.vector_search.index_type == "BINARY" && pImpl->embedding_storage_format_ == EmbeddingStorageFormat::NONE) {
+            LEAFRA_WARNING() << "⚠️ BINARY index without embedding_storage: results keep the coarse Hamming order";
+        }
+        if (pImpl->database_ && pImpl->database_->isOpen() && !pImpl->database_->createChunkEmbeddingsTable()) {
+            LEAFRA_ERROR() << "❌ Failed to prepare chunk embeddings table";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        pImpl->embedding_cache_available_ = false;
+        if (config.embedding_inference.cache_enabled && pImpl->database_ && pImpl->database_->isOpen()) {
+            pImpl->embedding_cache_available_ = pImpl->database_->createEmbeddingCacheTable();
+            if (!pImpl->embedding_cache_available_) {
+                LEAFRA_WARNING() << "⚠️ Failed to prepare embedding cache table, chunk embeddings won't be cached";
+            }
+        }
+
+        // Databases created before the chunk id sequence existed continue after their largest doc_id * 1000000 + i id
+        if (pImpl->database_ && pImpl->database_->isOpen() && !pImpl->database_->createChunkIdSequence()) {
+            LEAFRA_ERROR() << "❌ Failed to prepare chunk id sequence";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+
+        // Databases created before offsets storage existed get doc_texts here (the keyword index triggers read it)
+        if (pImpl->database_ && pImpl->database_->isOpen() && !pImpl->database_->createDocTextTable()) {
+            LEAFRA_ERROR() << "❌ Failed to prepare document text table";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        
+        // ... and doc_centroids (hierarchical search)
+        if (pImpl->database_ && pImpl->database_->isOpen() && !pImpl->database_->createDocCentroidsTable()) {
+            LEAFRA_ERROR() << "❌ Failed to prepare document centroid table";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        
+        // ... and chunk_llm_tokens (llm.cache_chunk_tokens)
+        if (pImpl->database_ && pImpl->database_->isOpen() && !pImpl->database_->createChunkLLMTokensTable()) {
+            LEAFRA_ERROR() << "❌ Failed to prepare chunk LLM token table";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        
+        // ... and chunk_retrievals (prefetch_after_initialize; the warm-up skips hot chunks without it)
+        pImpl->chunk_retrievals_available_ = pImpl->database_ && pImpl->database_->isOpen() &&
+                                             pImpl->database_->createChunkRetrievalsTable();
+        
+        // ... and ingestion_queue (resume_pending_jobs; runs can't be resumed without it)
+        pImpl->ingestion_queue_available_ = pImpl->database_ && pImpl->database_->isOpen() &&
+                                            pImpl->database_->createIngestionQueueTable();
+        
+        // ... and index_models (without it an index built with another embedding model goes undetected)
+        pImpl->index_models_available_ = pImpl->database_ && pImpl->database_->isOpen() &&
+                                         pImpl->database_->createIndexModelsTable();
+        
+        // ... and sync_log (export_delta; documents already stored are logged as added)
+        pImpl->sync_log_available_ = pImpl->database_ && pImpl->database_->isOpen() &&
+                                     pImpl->database_->createSyncLogTable();
+
+        // Databases created before the keyword index existed get it (and a one-off rebuild) here
+        if (pImpl->database_ && pImpl->database_->isOpen()) {
+            pImpl->keyword_index_available_ = pImpl->database_->createChunkKeywordIndex();
+            if (pImpl->keyword_index_available_) {
+                LEAFRA_INFO() << "✅ Keyword index ready";
+            } else {
+                LEAFRA_WARNING() << "FTS5 keyword index not available, hybrid search will use vectors only";
+            }
+        }
+
+        // Attached: the schema is the writer's (the upgrades above found nothing to do), and from here on this
+        // connection only reads; data_version starts at the snapshot the shards are restored from
+        if (config.attach_read_only && pImpl->database_ && pImpl->database_->isOpen()) {
+            if (!pImpl->database_->execute("PRAGMA query_only = ON")) {
+                LEAFRA_ERROR() << "❌ Failed to make the attached database connection read-only";
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+            pImpl->database_->execute("PRAGMA data_version", [impl](const SQLiteDatabase::Row& row) {
+                impl->attached_data_version_ = row.getInt64(0);
+                return false;
+            });
+            pImpl->attach_checked_at_ = std::chrono::steady_clock::now();
+            pImpl->chunk_retrievals_available_ = false;
+            pImpl->ingestion_queue_available_ = false;
+            if (config.vector_search.index_storage != "file" || !config.vector_search.mmap_index_file) {
+                LEAFRA_WARNING() << "⚠️ attach_read_only without vector_search.index_storage \"file\" and mmap_index_file: "
+                                 << "this process keeps its own copy of the index in memory";
+            }
+            LEAFRA_INFO() << "🔗 Attached read-only to " << db_absolute_path;
+        }
+
+        // Initialize FAISS index using the sdk config settings
+    #ifdef LEAFRA_HAS_FAISS
+        if (config.vector_search.enabled) {
+            try {
+                if (pImpl->loadFaissCollections() != ResultCode::SUCCESS) {
+                    return ResultCode::ERROR_INITIALIZATION_FAILED;
+                }
+            
+                LEAFRA_INFO() << "✅ FAISS index initialized successfully";
+                pImpl->send_event(EventType::INDEX_UPDATED, "FAISS index initialized");
+            } catch (const std::exception& e) {
+                LEAFRA_ERROR() << "Failed to initialize FAISS index: " << e.what();
+                pImpl->send_event(EventType::ERROR_OCCURRED, "Failed to initialize FAISS index: " + std::string(e.what()));
+                return ResultCode::ERROR_INITIALIZATION_FAILED;
+            }
+        } else {
+            LEAFRA_INFO() << "Vector search disabled in configuration";
+        }
+    #else // LEAFRA_HAS_FAISS
+        LEAFRA_WARNING() << "⚠️  FAISS integration: DISABLED (library not found)";
+    #endif // LEAFRA_HAS_FAISS
+        
+#else // LEAFRA_HAS_SQLITE
+        LEAFRA_WARNING() << "⚠️  SQLite integration disabled - database initialization skipped";
+#endif // LEAFRA_HAS_SQLITE
+    
+#ifdef LEAFRA_HAS_LLAMACPP
+        if (config.llm.enabled && config.background_load) {
+            pImpl->llm_ready_ = std::async(std::launch::async, [impl]() {
+                try {
+                    std::unique_lock<std::shared_mutex> exclusive(impl->llm_mutex_);
+                    impl->loadLLM();
+                } catch (const std::exception& e) {
+                    LEAFRA_ERROR() << "Background LLM load failed: " << e.what();
+                }
+                return impl->llamacpp_initialized_;
+            }).share();
+            LEAFRA_INFO() << "⏳ Loading LLM in the background";
+        } else if (config.llm.enabled) {
+            ResultCode llm_result = pImpl->loadLLM();
+            if (llm_result != ResultCode::SUCCESS) {
+                return llm_result;
+            }
+            pImpl->llm_ready_ = Impl::readyFuture(true);
+        } else {
+            pImpl->llm_ready_ = Impl::readyFuture(false);
+        }
+        if (config.llm.enabled && config.llm.idle_unload_seconds > 0) {
+            pImpl->startLLMIdleMonitor();
+        }
+#else
+        pImpl->llm_ready_ = Impl::readyFuture(false);
+#endif
+
+#ifdef LEAFRA_HAS_SQLITE
+        // Outside WAL mode readers would wait on the writer's locks anyway, so searches keep sharing its connection
+        std::string journal_mode = config.database.journal_mode;
+        std::transform(journal_mode.begin(), journal_mode.end(), journal_mode.begin(), ::toupper);
+        if (pImpl->database_ && pImpl->database_->isOpen() && config.database.read_connections > 0 && journal_mode == "WAL") {
+            const size_t readers = static_cast<size_t>(config.database.read_connections);
+            if (pImpl->read_pool_.open(pImpl->database_->getPath(), config.database, readers)) {
+                LEAFRA_INFO() << "📖 Search reads use " << readers << " read-only database connections";
+            } else {
+                LEAFRA_WARNING() << "Failed to open read-only database connections - searches share the writer connection";
+            }
+        }
+        if (pImpl->database_ && pImpl->database_->isOpen() && config.database.vacuum_pages_per_slice > 0 && !config.attach_read_only) {
+            pImpl->markDatabaseUsed();
+            pImpl->startVacuumScheduler();
+        }
+#endif
+#ifdef LEAFRA_HAS_FAISS
+        if (config.vector_search.enabled && config.vector_search.hot_index && !config.attach_read_only) {
+            pImpl->startHotMergeScheduler();
+        }
+#endif
+
+        pImpl->registerReclaimers(*this);
+        pImpl->initialized_ = true;
+        LEAFRA_INFO() << "LeafraSDK initialized successfully";
+        
+        pImpl->warmup_cancelled_ = false;
+        if (config.prefetch_after_initialize && pImpl->worker_pool_ && pImpl->worker_pool_->submit([impl]() { impl->warmUp(); })) {
+            LEAFRA_INFO() << "🔥 Warming caches in the background";
+        }
+        
+#ifdef LEAFRA_HAS_PDFIUM
+        LEAFRA_INFO() << "✅ PDFium integration: ENABLED";
+#else
+        LEAFRA_WARNING() << "⚠️  PDFium integration: DISABLED (library not found)";
+#endif
+
+#ifdef LEAFRA_HAS_COREML
+        LEAFRA_INFO() << "✅ CoreML integration: ENABLED";
+#else
+        LEAFRA_WARNING() << "⚠️  CoreML integration: DISABLED (framework not found)";
+#endif
+
+#ifdef LEAFRA_HAS_TENSORFLOWLITE
+        LEAFRA_INFO() << "✅ TensorFlow Lite integration: ENABLED";
+#else
+        LEAFRA_WARNING() << "⚠️  TensorFlow Lite integration: DISABLED (library not found)";
+#endif
+        
+        pImpl->send_event(EventType::INITIALIZATION_COMPLETE, "LeafraSDK initialized successfully");
+        
+        return ResultCode::SUCCESS;
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "Initialization failed: " << e.what();
+        pImpl->send_event(EventType::ERROR_OCCURRED, "Initialization failed: " + std::string(e.what()));
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+}
+
+ResultCode LeafraCore::shutdown() {
+    if (!pImpl->initialized_) {
+        return ResultCode::SUCCESS; // Already shutdown
+    }
+    
+    try {
+        // Memory pressure mustn't reach components while they are torn down
+        pImpl->reclaimers_.clear();
+        
+        // Let background engine loads finish before tearing anything down
+        pImpl->waitForEngines();
+        
+        // Queued async requests complete as cancelled, running ones finish against intact components
+        pImpl->requests_cancelled_ = true;
+        pImpl->request_pool_.reset();
+        
+        // Cancel background ingestion and stop worker threads first so nothing
+        // touches the components torn down below
+        pImpl->stopWatching();
+        pImpl->cancelAsyncIngestionJobs();
+        pImpl->stopVacuumScheduler();
+#ifdef LEAFRA_HAS_FAISS
+        pImpl->stopHotMergeScheduler();
+        pImpl->reindex_cancelled_ = true;
+        {
+            std::lock_guard<std::mutex> lock(pImpl->reindex_job_mutex_);
+            if (pImpl->reindex_thread_.joinable()) {
+                pImpl->reindex_thread_.join();
+            }
+        }
+#endif
+        pImpl->backup_cancelled_ = true;
+        {
+            std::lock_guard<std::mutex> lock(pImpl->backup_job_mutex_);
+            if (pImpl->backup_thread_.joinable()) {
+                pImpl->backup_thread_.join();
+            }
+        }
+        // A synchronous backup on another thread stops after its current step
+        std::lock_guard<std::mutex> backup_lock(pImpl->backup_mutex_);
+        pImpl->backup_cancelled_ = false;
+        pImpl->warmup_cancelled_ = true;
+        if (pImpl->worker_pool_) {
+            pImpl->worker_pool_.reset();
+            LEAFRA_DEBUG() << "Worker pool shutdown completed";
+        }
+        pImpl->query_pool_.reset();
+        pImpl->query_embed_batcher_.reset();
+#ifdef LEAFRA_HAS_FAISS
+        pImpl->index_search_batcher_.reset();
+#endif
+        
+        // Cleanup embedding backend (CoreML / TensorFlow Lite / llama.cpp)
+        if (pImpl->embedding_scheduler_) {
+            LEAFRA_DEBUG() << "Shutting down embedding backend";
+            pImpl->unloadEmbeddingModel();
+            LEAFRA_DEBUG() << "Embedding backend shutdown completed";
+        }
+        
+        // Let go of the shared tokenizer (freed once no other instance uses the model)
+        pImpl->tokenizer_ = std::make_shared<SentencePieceTokenizer>();
+
+#ifdef LEAFRA_HAS_LLAMACPP
+        // Cleanup LlamaCpp resources
+        pImpl->stopLLMIdleMonitor();
+        if (pImpl->llamacpp_initialized_ || leafra::llamacpp::global::is_initialized()) {
+            LEAFRA_DEBUG() << "Shutting down LlamaCpp";
+            
+            // Unload model and cleanup
+            {
+                std::unique_lock<std::shared_mutex> exclusive(pImpl->llm_mutex_);
+                pImpl->unloadLLM();
+                pImpl->llm_unloaded_ = false;
+            }
+            
+            // Cleanup global LlamaCpp resources
+            leafra::llamacpp::global::cleanup();
+            
+            LEAFRA_DEBUG() << "LlamaCpp shutdown completed";
+        }
+#endif
+        
+        // Shutdown chunker
+        if (pImpl->chunker_) {
+            // Note: If LeafraChunker doesn't have a shutdown method, the destructor will handle cleanup
+            // But we reset statistics and clear any cached data
+            pImpl->chunker_->reset_statistics();
+            LEAFRA_DEBUG() << "Chunker shutdown completed";
+        }
+        
+        // Shutdown file parser
+        if (pImpl->file_parser_) {
+            pImpl->file_parser_->shutdown();
+            pImpl->parse_cache_.reset();
+            LEAFRA_DEBUG() << "File parser shutdown completed";
+        }
+        
+#ifdef LEAFRA_HAS_FAISS
+        // Fold any remaining deltas so the next startup loads a single blob
+        pImpl->compactFaissIndex(true);
+#endif
+        
+#ifdef LEAFRA_HAS_SQLITE
+        // Shutdown database
+#ifdef LEAFRA_HAS_FAISS
+        pImpl->flushRetrievalCounts(true);
+#endif
+        pImpl->read_pool_.close();
+        if (pImpl->database_ && pImpl->database_->isOpen()) {
+            pImpl->database_->close();
+            LEAFRA_DEBUG() << "Database shutdown completed";
+        }
+#endif
+        
+        pImpl->embedding_ready_ = std::shared_future<bool>();
+        pImpl->llm_ready_ = std::shared_future<bool>();
+        pImpl->initialized_ = false;
+        Logger::getInstance().flush();  // Queued async log lines reach the console before shutdown returns
+        pImpl->send_event(EventType::SHUTDOWN_COMPLETE, "LeafraSDK shutdown completed");
+        pImpl->events_.flush();
+        return ResultCode::SUCCESS;
+    } catch (const std::exception& e) {
+        pImpl->send_event(EventType::ERROR_OCCURRED, "Shutdown failed: " + std::string(e.what()));
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+}
+
+ResultCode LeafraCore::reconfigure(const Config& requested_config) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+    pImpl->waitForEngines();
+    const Config previous = pImpl->config_;
+    if (Impl::needsRestart(previous, requested_config)) {
+        LEAFRA_INFO() << "🔁 Reconfigure: database, index or thread pool settings changed - restarting";
+        ResultCode result = shutdown();
+        return result == ResultCode::SUCCESS ? initialize(requested_config) : result;
+    }
+    
+    // LLM thread counts are compared as configured, before the device profile fills them in
+    const bool reload_embedding = Impl::embeddingModelChanged(previous, requested_config);
+    const bool llm_threads_changed = requested_config.llm.n_threads != pImpl->configured_llm_threads_ ||
+                                     requested_config.llm.n_threads_batch != pImpl->configured_llm_batch_threads_;
+    Config config = requested_config;
+    pImpl->applyDeviceProfile(config);
+    pImpl->config_ = config;
+    std::vector<std::string> reloaded;
+    
+    pImpl->configureLogging(config);
+    MemoryAccountant::instance().set_total_budget(static_cast<uint64_t>(std::max<int32_t>(config.memory_budget_mb, 0)) * 1024 * 1024);
+    // Buffers already backed keep their pages; the new policy applies from the next index change
+    LargePagePolicy large_page_policy = LargePagePolicy::OFF;
+    large_pages::parse_policy(config.large_pages, large_page_policy);
+    large_pages::set_policy(large_page_policy);
+    
+    // Thread counts and batch size go through the governor, which hands them to the engines on their next call
+    pImpl->thread_budget_ = ThreadBudget::resolve(PlatformUtils::get_cpu_topology(), config);
+    ThroughputGovernor::Options governor_options;
+    governor_options.enabled = config.governor.enabled;
+    governor_options.poll_interval_ms = std::max<int32_t>(0, config.governor.poll_interval_ms);
+    governor_options.low_battery_percent = config.governor.low_battery_percent;
+    governor_options.interactive_ingest_workers = static_cast<size_t>(std::max<int32_t>(0, config.governor.interactive_ingest_workers));
+    ThroughputLimits ceiling = pImpl->governor_.ceiling();
+    ceiling.embedding_batch_size = static_cast<size_t>(std::max(1, config.embedding_inference.batch_size));
+    ceiling.llm_threads = pImpl->thread_budget_.llm_threads;
+    ceiling.llm_batch_threads = pImpl->thread_budget_.llm_batch_threads;
+    ceiling.faiss_threads = pImpl->thread_budget_.faiss_threads;
+    pImpl->governor_.configure(governor_options, ceiling);
+    pImpl->admission_.configure(Impl::admissionOptions(config.admission));
+    
+    if (pImpl->chunker_) {
+        pImpl->chunker_->set_default_options(Impl::chunkingOptions(config.chunking));
+    }
+    if (pImpl->file_parser_ && pImpl->worker_pool_) {
+        pImpl->file_parser_->configure([this](std::function<void()> task) {
+            return pImpl->worker_pool_->submit(std::move(task));
+        }, config.parsing);
+    }
+    if (config.parsing.cache_enabled != previous.parsing.cache_enabled || config.parsing.cache_max_mb != previous.parsing.cache_max_mb) {
+        pImpl->parse_cache_.reset();
+        if (config.parsing.cache_enabled) {
+            uint64_t max_bytes = static_cast<uint64_t>(std::max<int32_t>(config.parsing.cache_max_mb, 0)) << 20;
+            pImpl->parse_cache_ = std::make_unique<ParseCache>(FileManager::getAbsolutePath(StorageType::AppStorage, "parse_cache"), max_bytes);
+        }
+    }
+    
+    // Embedding model: loaded again only if the model, its backend options or the tokenizer changed
+    ResultCode result = ResultCode::SUCCESS;
+    if (reload_embedding) {
+        std::unique_lock<std::shared_mutex> swap_lock(pImpl->model_swap_mutex_);
+        pImpl->unloadEmbeddingModel();
+        pImpl->reloadTokenizer();
+        result = pImpl->loadEmbeddingModel();
+        if (result == ResultCode::SUCCESS) {
+            reloaded.push_back("embedding model");
+        } else {
+            LEAFRA_WARNING() << "⚠️  Failed to load " << config.embedding_inference.model_path << ", restoring "
+                             << previous.embedding_inference.model_path;
+            pImpl->config_.tokenizer = previous.tokenizer;
+            pImpl->config_.embedding_inference = previous.embedding_inference;
+            pImpl->unloadEmbeddingModel();
+            pImpl->reloadTokenizer();
+            pImpl->loadEmbeddingModel();
+        }
+        pImpl->embedding_ready_ = Impl::readyFuture(pImpl->embedding_scheduler_ != nullptr);
+#if defined(LEAFRA_HAS_FAISS) && defined(LEAFRA_HAS_SQLITE)
+        // Indexes of the previous model must not be searched with the new one's queries
+        pImpl->checkIndexModels();
+#endif
+    }
+    pImpl->applyThroughputLimits();
+#ifdef LEAFRA_HAS_SQLITE
+    if (config.embedding_inference.cache_enabled != previous.embedding_inference.cache_enabled) {
+        pImpl->embedding_cache_available_ = config.embedding_inference.cache_enabled && pImpl->database_ &&
+                                            pImpl->database_->isOpen() && pImpl->database_->createEmbeddingCacheTable();
+    }
+#endif
+    
+    // Cached results and answers may have come from the previous retrieval or sampling settings
+    {
+        const auto& cache_config = config.search_cache;
+        std::lock_guard<std::mutex> lock(pImpl->query_mutex_);
+        if (reload_embedding) {
+            pImpl->query_embedding_cache_.clear();
+        }
+        pImpl->query_embedding_cache_.set_capacity(cache_config.enabled ? static_cast<size_t>(std::max(0, cache_config.embedding_capacity)) : 0);
+#ifdef LEAFRA_HAS_FAISS
+        pImpl->search_result_cache_.clear();
+        pImpl->stale_search_results_ = 0;
+        pImpl->search_result_cache_.set_capacity(cache_config.cache_results ? static_cast<size_t>(std::max(0, cache_config.result_capacity)) : 0);
+#endif
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+        pImpl->answer_cache_.clear();
+        pImpl->answer_cache_.set_capacity(cache_config.cache_answers ? static_cast<size_t>(std::max(0, cache_config.answer_capacity)) : 0);
+#endif
+    }
+    
+#ifdef LEAFRA_HAS_LLAMACPP
+    // The idle monitor reads its timeout when it starts
+    const bool restart_idle_monitor = config.llm.idle_unload_seconds != previous.llm.idle_unload_seconds ||
+                                      config.llm.enabled != previous.llm.enabled;
+    if (restart_idle_monitor) {
+        pImpl->stopLLMIdleMonitor();
+    }
+    {
+        std::unique_lock<std::shared_mutex> exclusive(pImpl->llm_mutex_);
+        if (Impl::llmModelChanged(previous.llm, config.llm)) {
+            // Like swap_llm: one model resident at a time, the previous one restored if the new one fails
+            const bool was_resident = pImpl->llamacpp_initialized_;
+            pImpl->unloadLLM();
+            pImpl->llm_unloaded_ = false;
+            ResultCode llm_result = config.llm.enabled ? pImpl->loadLLM() : ResultCode::SUCCESS;
+            if (llm_result != ResultCode::SUCCESS) {
+                LEAFRA_WARNING() << "⚠️  Failed to load " << config.llm.model_path << ", restoring " << previous.llm.model_path;
+                pImpl->config_.llm = previous.llm;
+                pImpl->applyDeviceProfile(pImpl->config_);
+                if (!previous.llm.enabled || pImpl->loadLLM() != ResultCode::SUCCESS) {
+                    pImpl->llm_unloaded_ = previous.llm.enabled;
+                }
+                result = llm_result;
+            } else if (config.llm.enabled) {
+                reloaded.push_back("LLM");
+            } else if (was_resident) {
+                LEAFRA_INFO() << "💤 LLM disabled";
+            }
+            pImpl->llm_ready_ = Impl::readyFuture(pImpl->llamacpp_initialized_);
+            pImpl->send_event(EventType::LLM_STATUS, pImpl->llamacpp_initialized_ ? "LLM reloaded" : "LLM unloaded");
+        } else if (pImpl->llamacpp_model_) {
+            pImpl->llamacpp_model_->update_generation_config(config.llm);
+            if (config.llm.system_prompt != previous.llm.system_prompt &&
+                !pImpl->llamacpp_model_->set_system_prompt(config.llm.system_prompt)) {
+                LEAFRA_WARNING() << "Failed to set system prompt: " << pImpl->llamacpp_model_->get_last_error();
+            }
+            if (llm_threads_changed) {
+                pImpl->llm_applied_threads_ = 0;    // acquireLLM hands the new thread counts to the model
+            }
+        }
+    }
+    const LLMConfig& llm = pImpl->config_.llm;
+    if (restart_idle_monitor && llm.enabled && llm.idle_unload_seconds > 0) {
+        pImpl->startLLMIdleMonitor();
+    }
+#else
+    (void)llm_threads_changed;
+#endif
+    
+    std::string summary;
+    for (const std::string& component : reloaded) {
+        summary += (summary.empty() ? "" : ", ") + component;
+    }
+    LEAFRA_INFO() << "🔧 Reconfigured in place" << (summary.empty() ? std::string(" (nothing reloaded)") : " (reloaded: " + summary + ")");
+    return result;
+} //reconfigure
+
+bool LeafraCore::is_initialized() const {
+    return pImpl->initialized_;
+}
+
+std::shared_future<bool> LeafraCore::embedding_model_ready() const {
+    return pImpl->embedding_ready_.valid() ? pImpl->embedding_ready_ : Impl::readyFuture(false);
+}
+
+std::shared_future<bool> LeafraCore::llm_ready() const {
+    return pImpl->llm_ready_.valid() ? pImpl->llm_ready_ : Impl::readyFuture(false);
+}
+
+const Config& LeafraCore::get_config() const {
+    return pImpl->config_;
+}
+
+ResultCode LeafraCore::process_data(const data_buffer_t& input, data_buffer_t& output) {
+    if (!pImpl->initialized_) {
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+    if (!pImpl->data_processor_) {
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+    
+    try {
+        return pImpl->data_processor_->process(input, output);
+    } catch (const std::exception& e) {
+        pImpl->send_event(EventType::ERROR_OCCURRED, "Data processing failed: " + std::string(e.what()));
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+}
+
+ResultCode LeafraCore::process_user_files(const std::vector<std::string>& file_paths, const std::string& collection) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (pImpl->rejectWhenAttached("Ingestion")) {
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+    
+    if (!Impl::isValidCollectionName(collection)) {
+        LEAFRA_ERROR() << "Invalid collection name: '" << collection << "'";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    if (!pImpl->file_parser_) {
+        LEAFRA_ERROR() << "File parser not available";
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+    
+    LEAFRA_INFO() << "Processing " << file_paths.size() << " user files";
+    pImpl->send_event(EventType::INGESTION_STARTED, "Processing " + std::to_string(file_paths.size()) + " user files");
+    
+    return pImpl->runIngestion(file_paths, nullptr, collection);
+} //process_user_files
+
+shared_ptr<IngestionJob> LeafraCore::process_user_files_async(const std::vector<std::string>& file_paths,
+                                                              const IngestionOptions& options) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return nullptr;
+    }
+    if (pImpl->rejectWhenAttached("Ingestion")) {
+        return nullptr;
+    }
+    
+    if (!pImpl->file_parser_) {
+        LEAFRA_ERROR() << "File parser not available";
+        return nullptr;
+    }
+    
+    if (!Impl::isValidCollectionName(options.collection)) {
+        LEAFRA_ERROR() << "Invalid collection name: '" << options.collection << "'";
+        return nullptr;
+    }
+    
+    LEAFRA_INFO() << "Queueing async ingestion of " << file_paths.size() << " user files";
+    pImpl->send_event(EventType::INGESTION_STARTED, "Queued " + std::to_string(file_paths.size()) + " user files for processing");
+    
+    auto state = std::make_shared<IngestionJob::State>();
+    state->file_paths = file_paths;
+    state->options = options;
+    pImpl->startAsyncIngestion(state);
+    
+    return std::make_shared<IngestionJob>(state);
+} //process_user_files_async
+
+ResultCode LeafraCore::process_directory(const std::string& root, const std::vector<std::string>& extensions,
+                                         bool recursive, const std::string& collection) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (pImpl->rejectWhenAttached("Ingestion")) {
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+    
+    if (!Impl::isValidCollectionName(collection)) {
+        LEAFRA_ERROR() << "Invalid collection name: '" << collection << "'";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    if (!pImpl->file_parser_) {
+        LEAFRA_ERROR() << "File parser not available";
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+    
+    std::vector<std::string> file_paths;
+    std::vector<EnumeratedFile> file_stats;
+    ResultCode result = pImpl->enumerateDirectory(root, extensions, recursive, file_paths, file_stats);
+    if (result != ResultCode::SUCCESS) {
+        return result;
+    }
+    
+    pImpl->send_event(EventType::INGESTION_STARTED, "Processing " + std::to_string(file_paths.size()) + " files from " + root);
+    return pImpl->runIngestion(file_paths, nullptr, collection, file_stats);
+} //process_directory
+
+shared_ptr<IngestionJob> LeafraCore::process_directory_async(const std::string& root, const std::vector<std::string>& extensions,
+                                                             bool recursive, const IngestionOptions& options) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return nullptr;
+    }
+    
+    if (!pImpl->file_parser_) {
+        LEAFRA_ERROR() << "File parser not available";
+        return nullptr;
+    }
+    
+    if (!Impl::isValidCollectionName(options.collection)) {
+        LEAFRA_ERROR() << "Invalid collection name: '" << options.collection << "'";
+        return nullptr;
+    }
+    
+    auto state = std::make_shared<IngestionJob::State>();
+    if (pImpl->enumerateDirectory(root, extensions, recursive, state->file_paths, state->file_stats) != ResultCode::SUCCESS) {
+        return nullptr;
+    }
+    state->options = options;
+    
+    pImpl->send_event(EventType::INGESTION_STARTED, "Queued " + std::to_string(state->file_paths.size()) + " files from " + root);
+    pImpl->startAsyncIngestion(state);
+    
+    return std::make_shared<IngestionJob>(state);
+} //process_directory_async
+
+ResultCode LeafraCore::watch_directory(const std::string& root, const std::vector<std::string>& extensions,
+                                       bool recursive, const IngestionOptions& options) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (pImpl->rejectWhenAttached("Watching a directory")) {
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+    
+    if (!pImpl->file_parser_) {
+        LEAFRA_ERROR() << "File parser not available";
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+    
+    if (!Impl::isValidCollectionName(options.collection)) {
+        LEAFRA_ERROR() << "Invalid collection name: '" << options.collection << "'";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    pImpl->stopWatching();
+    pImpl->watch_options_ = options;
+    
+    FileWatcher::Options watch_options;
+    watch_options.recursive = recursive;
+    watch_options.debounce_ms = pImpl->config_.watch_debounce_ms;
+    watch_options.extensions = pImpl->ingestibleExtensions(extensions);
+    if (watch_options.extensions.empty()) {
+        LEAFRA_ERROR() << "None of the requested extensions can be parsed";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    auto watcher = std::make_unique<FileWatcher>();
+    Impl* impl = pImpl.get();
+    ResultCode result = watcher->start(root, watch_options, [impl](const FileWatcher::Changes& changes) {
+        impl->ingestWatchedChanges(changes);
+    });
+    if (result != ResultCode::SUCCESS) {
+        return result;
+    }
+    pImpl->file_watcher_ = std::move(watcher);
+    return ResultCode::SUCCESS;
+} //watch_directory
+
+void LeafraCore::stop_watching() {
+    pImpl->stopWatching();
+}
+
+bool LeafraCore::bump_priority(const std::string& file_path) {
+    if (pImpl->ingestion_scheduler_.bump(file_path)) {
+        LEAFRA_INFO() << "⏫ Ingesting next: " << file_path;
+        return true;
+    }
+    // Directory jobs queue canonical paths
+    std::error_code error;
+    const std::string canonical = std::filesystem::weakly_canonical(file_path, error).string();
+    if (!error && canonical != file_path && pImpl->ingestion_scheduler_.bump(canonical)) {
+        LEAFRA_INFO() << "⏫ Ingesting next: " << canonical;
+        return true;
+    }
+    return false;
+}
+
+shared_ptr<IngestionJob> LeafraCore::resume_pending_jobs(size_t max_files, const IngestionOptions& options) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return nullptr;
+    }
+    
+    if (!pImpl->file_parser_) {
+        LEAFRA_ERROR() << "File parser not available";
+        return nullptr;
+    }
+    
+    auto state = std::make_shared<IngestionJob::State>();
+    state->options = options;
+#ifdef LEAFRA_HAS_SQLITE
+    pImpl->loadPendingIngestion(max_files, state->file_paths, state->collections);
+#else
+    (void)max_files;
+#endif
+    if (state->file_paths.empty()) {
+        LEAFRA_INFO() << "No interrupted ingestion to resume";
+        return nullptr;
+    }
+    
+    LEAFRA_INFO() << "⏯️ Resuming ingestion of " << state->file_paths.size() << " files";
+    pImpl->send_event(EventType::INGESTION_STARTED, "Resuming " + std::to_string(state->file_paths.size()) + " interrupted files");
+    pImpl->startAsyncIngestion(state);
+    
+    return std::make_shared<IngestionJob>(state);
+} //resume_pending_jobs
+
+size_t LeafraCore::get_pending_ingestion_count() {
+    if (!pImpl->initialized_) {
+        return 0;
+    }
+#ifdef LEAFRA_HAS_SQLITE
+    return pImpl->countPendingIngestion();
+#else
+    return 0;
+#endif
+}
+
+ResultCode LeafraCore::remove_documents(const std::vector<int64_t>& doc_ids, size_t* removed) {
+    if (removed) {
+        *removed = 0;
+    }
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (pImpl->rejectWhenAttached("Removing documents")) {
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+#ifdef LEAFRA_HAS_SQLITE
+    // Holding the ingestion lock keeps the store stage from writing while rows and vectors go
+    std::lock_guard<std::mutex> ingestion_lock(pImpl->ingestion_mutex_);
+    return pImpl->removeStoredDocuments(doc_ids, removed);
+#else
+    (void)doc_ids;
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+} //remove_documents
+
+ResultCode LeafraCore::remove_documents(const std::vector<std::string>& file_paths, size_t* removed) {
+    if (removed) {
+        *removed = 0;
+    }
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (pImpl->rejectWhenAttached("Removing documents")) {
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+#ifdef LEAFRA_HAS_SQLITE
+    std::lock_guard<std::mutex> ingestion_lock(pImpl->ingestion_mutex_);
+    return pImpl->removeStoredDocuments(pImpl->lookupDocumentIds(file_paths), removed);
+#else
+    (void)file_paths;
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+} //remove_documents
+
+ResultCode LeafraCore::append_to_document(int64_t doc_id, const std::string& text, size_t* chunks_added) {
+    if (chunks_added) {
+        *chunks_added = 0;
+    }
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (pImpl->rejectWhenAttached("Appending to documents")) {
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+    if (text.empty()) {
+        return ResultCode::SUCCESS;
+    }
+#if defined(LEAFRA_HAS_SQLITE) && defined(LEAFRA_HAS_FAISS)
+    std::lock_guard<std::mutex> ingestion_lock(pImpl->ingestion_mutex_);
+    return pImpl->appendToDocument(doc_id, text, chunks_added);
+#else
+    (void)doc_id;
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+} //append_to_document
+
+void LeafraCore::set_event_callback(callback_t callback) {
+    pImpl->event_callback_ = std::move(callback);
+    pImpl->updateEventHandler();
+}
+
+void LeafraCore::set_typed_event_callback(event_callback_t callback) {
+    pImpl->typed_event_callback_ = std::move(callback);
+    pImpl->updateEventHandler();
+} //set_typed_event_callback
+
+void LeafraCore::flush_events() {
+    pImpl->events_.flush();
+} //flush_events
+
+std::string LeafraCore::get_version() {
+    std::ostringstream oss;
+    oss << LEAFRA_VERSION_MAJOR << "." << LEAFRA_VERSION_MINOR << "." << LEAFRA_VERSION_PATCH;
+    return oss.str();
+}
+
+std::string LeafraCore::get_platform() {
+    return PlatformUtils::get_platform_name();
+}
+
+std::vector<ChunkTokenInfo> LeafraCore::extract_chunk_token_info(const std::vector<TextChunk>& chunks) {
+    std::vector<ChunkTokenInfo> token_info;
+    token_info.reserve(chunks.size());
+    
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        const auto& chunk = chunks[i];
+        token_info.emplace_back(
+            i,                              // chunk_index
+            chunk.content,                  // content (string_view)
+            chunk.token_ids,                // token_ids (copy the vector)
+            chunk.content.length(),         // character_count
+            chunk.estimated_tokens,         // token_count (actual token count when SentencePiece is used)
+            chunk.page_number               // page_number
+        );
+    }
+    
+    return token_info;
+}
+
+shared_ptr<LeafraCore> LeafraCore::create() {
+    return std::make_shared<LeafraCore>();
+}
+
+
+
+// Simple Semantic search 
+ResultCode LeafraCore::semantic_search(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results,
+                                       const FaissIndex::SearchParams& search_params) {
+    return semantic_search_collections(query, {}, max_results, results, search_params);
+} //semantic_search
+
+ResultCode LeafraCore::semantic_search(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results,
+                                       SearchDeadline& deadline, const FaissIndex::SearchParams& search_params, QueryStats* stats) {
+    Impl::QueryDeadline budget(deadline, stats);
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    ResultCode result = pImpl->searchCollections(query, {}, max_results, results, search_params,
+                                                 static_cast<uint32_t>(SearchResultFields::ALL), nullptr, &budget, stats);
+    if (stats) {
+        stats->results = static_cast<int32_t>(results.size());
+    }
+    return result;
+} //semantic_search
+
+ResultCode LeafraCore::semantic_search(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results,
+                                       QueryStats& stats, const FaissIndex::SearchParams& search_params) {
+    SearchDeadline no_deadline;
+    return semantic_search(query, max_results, results, no_deadline, search_params, &stats);
+}
+
+ResultCode LeafraCore::semantic_search(const std::string& query, int max_results, SearchResultSet& results,
+                                       const FaissIndex::SearchParams& search_params) {
+    results.clear();
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    std::vector<FaissIndex::SearchResult> ranked;
+    return pImpl->searchCollections(query, {}, max_results, ranked, search_params,
+                                    static_cast<uint32_t>(SearchResultFields::ALL), &results);
+} //semantic_search
+
+#ifdef LEAFRA_HAS_FAISS
+bool LeafraCore::semantic_search_async(const std::string& query, int max_results, search_completion_t completion) {
+    if (!pImpl->initialized_ || !pImpl->request_pool_ || !completion) {
+        LEAFRA_ERROR() << "LeafraCore not initialized or no completion given";
+        return false;
+    }
+    Impl* impl = pImpl.get();
+    return pImpl->request_pool_->submit([this, impl, query, max_results, completion]() {
+        std::vector<FaissIndex::SearchResult> results;
+        ResultCode result = impl->requests_cancelled_ ? ResultCode::ERROR_CANCELLED : semantic_search(query, max_results, results);
+        completion(result, std::move(results));
+    });
+} //semantic_search_async
+#endif
+
+ResultCode LeafraCore::semantic_search_collections(const std::string& query, const std::vector<std::string>& collections,
+                                                   int max_results, std::vector<FaissIndex::SearchResult>& results,
+                                                   const FaissIndex::SearchParams& search_params) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    return pImpl->searchCollections(query, collections, max_results, results, search_params,
+                                    static_cast<uint32_t>(SearchResultFields::ALL));
+} //semantic_search_collections
+
+ResultCode LeafraCore::semantic_search_ids(const std::string& query, int max_results,
+                                           std::vector<FaissIndex::SearchResult>& results,
+                                           std::unordered_map<int64_t, std::string>& documents,
+                                           const FaissIndex::SearchParams& search_params) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    documents.clear();
+    ResultCode result = pImpl->searchCollections(query, {}, max_results, results, search_params,
+                                                 static_cast<uint32_t>(SearchResultFields::IDS));
+    if (result != ResultCode::SUCCESS) {
+        return result;
+    }
+#ifdef LEAFRA_HAS_SQLITE
+    if (pImpl->database_ && pImpl->database_->isOpen() && !pImpl->lookupDocumentNames(results, documents)) {
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+#endif
+    return ResultCode::SUCCESS;
+} //semantic_search_ids
+
+ResultCode LeafraCore::hydrate(std::vector<FaissIndex::SearchResult>& results, uint32_t fields) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+#ifdef LEAFRA_HAS_SQLITE
+    if (!pImpl->database_ || !pImpl->database_->isOpen()) {
+        LEAFRA_ERROR() << "Database not available for hydration";
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+    if (results.empty()) {
+        return ResultCode::SUCCESS;
+    }
+    return pImpl->hydrateSearchResults(results, fields) ? ResultCode::SUCCESS : ResultCode::ERROR_PROCESSING_FAILED;
+#else
+    (void)results;
+    (void)fields;
+    LEAFRA_ERROR() << "Hydration requires SQLite support";
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+} //hydrate
+
+#ifdef LEAFRA_HAS_FAISS
+shared_ptr<SearchSession> LeafraCore::create_search_session(const SearchSession::Options& options) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return nullptr;
+    }
+    auto state = std::make_shared<SearchSession::State>();
+    state->options = options;
+    Impl* impl = pImpl.get();
+    state->run = [impl](SearchSession::State& session, uint64_t ticket, const std::string& query, int max_results,
+                        std::vector<FaissIndex::SearchResult>& results) {
+        return impl->searchSessionQuery(session, ticket, query, max_results, results);
+    };
+    return std::make_shared<SearchSession>(state);
+} //create_search_session
+
+ResultCode LeafraCore::semantic_search_page(const std::string& query, int page_size, std::vector<FaissIndex::SearchResult>& results,
+                                            shared_ptr<SearchCursor>& cursor, const FaissIndex::SearchParams& search_params) {
+    results.clear();
+    cursor.reset();
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (query.empty() || page_size <= 0) {
+        LEAFRA_ERROR() << "Invalid query or page_size";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    pImpl->refreshAttachedStore();
+    
+    auto state = std::make_shared<SearchCursor::State>();
+    state->owner = pImpl.get();
+    state->page_size = page_size;
+    state->params = pImpl->searchParams(search_params);
+    {
+        // The embedding and the shards are kept together: both stay valid for the cursor's pages
+        Impl::ModelUse model_use(pImpl->model_swap_mutex_);
+        state->shards = pImpl->faissShards();
+        if (state->shards.empty()) {
+            LEAFRA_ERROR() << "FAISS index not available";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        ResultCode embed_result = pImpl->embedQuery(query, state->query_embedding);
+        if (embed_result != ResultCode::SUCCESS) {
+            return embed_result;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(state->mutex);
+    ResultCode result = pImpl->fetchCursorPage(*state, results);
+    if (result == ResultCode::SUCCESS) {
+        cursor = std::make_shared<SearchCursor>(state);
+    }
+    return result;
+} //semantic_search_page
+
+ResultCode LeafraCore::next_page(SearchCursor& cursor, std::vector<FaissIndex::SearchResult>& results) {
+    results.clear();
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (!cursor.state_ || cursor.state_->owner != pImpl.get()) {
+        LEAFRA_ERROR() << "Search cursor does not belong to this instance";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    std::lock_guard<std::mutex> lock(cursor.state_->mutex);
+    return pImpl->fetchCursorPage(*cursor.state_, results);
+} //next_page
+#endif
+
+#ifdef LEAFRA_HAS_FAISS
+std::vector<std::string> LeafraCore::list_collections() const {
+    std::vector<std::string> names;
+    std::lock_guard<std::mutex> lock(pImpl->faiss_collections_mutex_);
+    for (const auto& entry : pImpl->faiss_collections_) {
+        names.push_back(entry.first);
+    }
+    return names;
+} //list_collections
+
+ResultCode LeafraCore::rebuild_collection(const std::string& collection) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (pImpl->rejectWhenAttached("Rebuilding a collection")) {
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+    
+#ifdef LEAFRA_HAS_SQLITE
+    if (!pImpl->database_ || !pImpl->database_->isOpen()) {
+        LEAFRA_ERROR() << "Database not available for collection rebuild";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+    // Holding the ingestion lock keeps the store stage from writing to the shard while it is replaced
+    std::lock_guard<std::mutex> ingestion_lock(pImpl->ingestion_mutex_);
+    Impl::FaissCollection* existing = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->faiss_collections_mutex_);
+        auto it = pImpl->faiss_collections_.find(collection);
+        if (it == pImpl->faiss_collections_.end()) {
+            LEAFRA_ERROR() << "Unknown collection: '" << collection << "'";
+            return ResultCode::ERROR_NOT_FOUND;
+        }
+        existing = &it->second;
+    }
+    
+    Impl::FaissCollection rebuilt;
+    rebuilt.name = existing->name;
+    rebuilt.definition = existing->definition;
+    try {
+        rebuilt.index = pImpl->createFaissIndex();
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "Failed to create FAISS index for collection rebuild: " << e.what();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    if (pImpl->rebuildFaissIndexFromEmbeddings(rebuilt) == 0 && existing->index->get_count() > 0) {
+        LEAFRA_ERROR() << "No stored embeddings to rebuild collection '" << collection << "' from - keeping its index";
+        return ResultCode::ERROR_NOT_FOUND;
+    }
+    if (pImpl->migrateFaissIndexIfNeeded(rebuilt) && pImpl->saveFaissCollection(rebuilt) != ResultCode::SUCCESS) {
+        LEAFRA_WARNING() << "Failed to save migrated FAISS index for collection '" << collection << "'";
+    }
+    
+    {
+        std::lock_guard<std::mutex> merge_lock(pImpl->faiss_merge_mutex_);
+        std::lock_guard<std::mutex> lock(pImpl->faiss_collections_mutex_);
+        existing->generation_base += existing->index->get_generation() + 1;
+        existing->index = std::move(rebuilt.index);
+        existing->migration_failed = rebuilt.migration_failed;
+        // Anything still queued was read back from chunk_embeddings by the rebuild
+        existing->pending_vectors.clear();
+        existing->pending_ids.clear();
+        existing->hot.reset();
+        existing->hot_generation++;
+    }
+    LEAFRA_INFO() << "🔁 Rebuilt collection '" << collection << "' (" << existing->index->get_count() << " vectors)";
+    pImpl->send_event(EventType::INDEX_UPDATED, "Rebuilt collection " + (collection.empty() ? std::string("(default)") : collection));
+    return ResultCode::SUCCESS;
+#else
+    (void)collection;
+    LEAFRA_ERROR() << "SQLite support not compiled, collections can't be rebuilt";
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+} //rebuild_collection
+
+std::shared_future<ResultCode> LeafraCore::reindex_embeddings_async(const EmbeddingModelConfig& model, const TokenizerConfig& tokenizer,
+                                                                    int32_t dimension) {
+    auto finished = [](ResultCode result) {
+        std::promise<ResultCode> done;
+        done.set_value(result);
+        return done.get_future().share();
+    };
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return finished(ResultCode::ERROR_INITIALIZATION_FAILED);
+    }
+    if (pImpl->rejectWhenAttached("Re-indexing")) {
+        return finished(ResultCode::ERROR_NOT_IMPLEMENTED);
+    }
+#ifdef LEAFRA_HAS_SQLITE
+    if (!model.is_valid() || dimension <= 0) {
+        LEAFRA_ERROR() << "Invalid embedding model or dimension for re-index";
+        return finished(ResultCode::ERROR_INVALID_PARAMETER);
+    }
+    if (!pImpl->config_.vector_search.enabled || !pImpl->database_ || !pImpl->database_->isOpen()) {
+        LEAFRA_ERROR() << "Vector search and the database are needed to re-index";
+        return finished(ResultCode::ERROR_INITIALIZATION_FAILED);
+    }
+    
+    std::lock_guard<std::mutex> lock(pImpl->reindex_job_mutex_);
+    if (pImpl->reindex_job_.valid() && pImpl->reindex_job_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        LEAFRA_ERROR() << "A re-index is already running";
+        return finished(ResultCode::ERROR_BUSY);
+    }
+    if (pImpl->reindex_thread_.joinable()) {
+        pImpl->reindex_thread_.join();
+    }
+    
+    Config target = pImpl->config_;
+    target.embedding_inference = model;
+    target.tokenizer = tokenizer;
+    target.vector_search.dimension = dimension;
+    {
+        std::lock_guard<std::mutex> progress_lock(pImpl->reindex_progress_mutex_);
+        pImpl->reindex_progress_ = ReindexProgress();
+        pImpl->reindex_progress_.phase = ReindexPhase::EMBEDDING;
+        pImpl->reindex_progress_.model_id = Impl::embeddingModelId(target);
+    }
+    pImpl->reindex_cancelled_ = false;
+    
+    auto promise = std::make_shared<std::promise<ResultCode>>();
+    pImpl->reindex_job_ = promise->get_future().share();
+    Impl* impl = pImpl.get();
+    pImpl->reindex_thread_ = std::thread([impl, target, promise]() {
+        ResultCode result = ResultCode::ERROR_PROCESSING_FAILED;
+        try {
+            result = impl->runReindex(target);
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "Re-index failed: " << e.what();
+        }
+        impl->finishReindex(result);
+        promise->set_value(result);
+    });
+    return pImpl->reindex_job_;
+#else
+    (void)model;
+    (void)tokenizer;
+    (void)dimension;
+    LEAFRA_ERROR() << "SQLite support not compiled, the corpus can't be re-indexed";
+    return finished(ResultCode::ERROR_NOT_IMPLEMENTED);
+#endif
+} //reindex_embeddings_async
+
+ReindexProgress LeafraCore::get_reindex_progress() const {
+    std::lock_guard<std::mutex> lock(pImpl->reindex_progress_mutex_);
+    return pImpl->reindex_progress_;
+}
+
+void LeafraCore::cancel_reindex() {
+    pImpl->reindex_cancelled_ = true;
+}
+
+ResultCode LeafraCore::validate_embedding_model(const EmbeddingModelConfig& candidate, const std::vector<std::string>& sample_texts,
+                                                int32_t k, EmbeddingModelValidation& validation, int32_t sample_size) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (!candidate.is_valid()) {
+        LEAFRA_ERROR() << "Invalid candidate embedding model";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    try {
+        return pImpl->validateEmbeddingModel(candidate, sample_texts, k, sample_size, validation);
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "Embedding model validation failed: " << e.what();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+}
+
+std::string LeafraCore::get_embedding_model_id() const {
+    return Impl::embeddingModelId(pImpl->config_);
+}
+#endif // LEAFRA_HAS_FAISS
+
+#ifdef LEAFRA_HAS_FAISS
+ResultCode LeafraCore::semantic_search(const std::string& query, const SearchFilter& filter, int max_results,
+                                       std::vector<FaissIndex::SearchResult>& results,
+                                       const FaissIndex::SearchParams& search_params) {
+    if (filter.empty()) {
+        return semantic_search(query, max_results, results, search_params);
+    }
+    results.clear();
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+#ifdef LEAFRA_HAS_SQLITE
+    if (!pImpl->database_ || !pImpl->database_->isOpen()) {
+        LEAFRA_ERROR() << "Database not available for search filter";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+    std::vector<int64_t> allowed_ids;
+    if (!pImpl->resolveSearchFilter(filter, allowed_ids)) {
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    if (allowed_ids.empty()) {
+        LEAFRA_INFO() << "Search filter matches no chunks";
+        return ResultCode::SUCCESS;
+    }
+    LEAFRA_DEBUG() << "Search filter admits " << allowed_ids.size() << " chunks";
+    
+    FaissIndex::SearchParams params = search_params;
+    params.allowed_ids = &allowed_ids;
+    return semantic_search(query, max_results, results, params);
+#else
+    LEAFRA_ERROR() << "SQLite support not compiled, search filters unavailable";
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+} //semantic_search
+
+ResultCode LeafraCore::semantic_search_batch(const std::vector<std::string>& queries, int max_results,
+                                             std::vector<std::vector<FaissIndex::SearchResult>>& results,
+                                             const FaissIndex::SearchParams& search_params) {
+    results.assign(queries.size(), std::vector<FaissIndex::SearchResult>());
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    ThroughputGovernor::InteractiveScope interactive(pImpl->governor_);
+    pImpl->pollThroughputGovernor();
+    
+    if (queries.empty() || max_results <= 0 ||
+        std::any_of(queries.begin(), queries.end(), [](const std::string& query) { return query.empty(); })) {
+        LEAFRA_ERROR() << "Invalid queries or max_results";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    pImpl->refreshAttachedStore();
+    Impl::ModelUse model_use(pImpl->model_swap_mutex_);
+    const std::vector<std::shared_ptr<FaissIndex>> shards = pImpl->faissShards();
+    if (shards.empty()) {
+        LEAFRA_ERROR() << "FAISS index not available";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+    try {
+        auto start_time = debug::timer::now();
+        std::vector<std::vector<float>> embeddings;
+        ResultCode embed_result = pImpl->embedQueries(queries, embeddings);
+        if (embed_result != ResultCode::SUCCESS) {
+            return embed_result;
+        }
+        
+        // Pack the queries that embedded into one matrix for a single FAISS call
+        std::vector<size_t> query_indices;
+        std::vector<float> matrix;
+        const size_t dimension = static_cast<size_t>(shards.front()->get_dimension());
+        matrix.reserve(queries.size() * dimension);
+        for (size_t i = 0; i < embeddings.size(); ++i) {
+            if (embeddings[i].size() != dimension) {
+                continue;
+            }
+            matrix.insert(matrix.end(), embeddings[i].begin(), embeddings[i].end());
+            query_indices.push_back(i);
+        }
+        if (query_indices.empty()) {
+            LEAFRA_ERROR() << "Query embeddings don't match the FAISS index dimension (" << dimension << ")";
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        
+        std::vector<std::vector<FaissIndex::SearchResult>> hits;
+        const int candidates = pImpl->rerankCandidates(shards, max_results);
+        ResultCode search_result = pImpl->searchFaissShards(shards, matrix.data(), static_cast<int>(query_indices.size()),
+                                                            candidates, pImpl->searchParams(search_params), hits);
+        if (search_result != ResultCode::SUCCESS) {
+            LEAFRA_ERROR() << "FAISS batch search failed";
+            return search_result;
+        }
+#ifdef LEAFRA_HAS_SQLITE
+        if (candidates > max_results) {
+            pImpl->rerankSearchResults(matrix.data(), max_results, hits);
+        }
+#endif
+        
+        // Rewrites of one question mostly hit the same chunks - hydrate the union once
+        std::vector<FaissIndex::SearchResult> unique_hits;
+        std::unordered_map<int64_t, size_t> slot_by_id;
+        for (const auto& query_hits : hits) {
+            for (const auto& hit : query_hits) {
+                if (slot_by_id.emplace(hit.id, unique_hits.size()).second) {
+                    unique_hits.push_back(hit);
+                }
+            }
+        }
+#ifdef LEAFRA_HAS_SQLITE
+        if (pImpl->database_ && pImpl->database_->isOpen()) {
+            pImpl->hydrateSearchResults(unique_hits);
+        } else {
+            LEAFRA_WARNING() << "Database not available for chunk lookup";
+        }
+#else
+        LEAFRA_WARNING() << "SQLite support not compiled, returning FAISS IDs only";
+#endif
+        slot_by_id.clear();
+        for (size_t i = 0; i < unique_hits.size(); ++i) {
+            slot_by_id.emplace(unique_hits[i].id, i);
+        }
+        
+        // Each query keeps its own ranking and distances; hits dropped by hydration are dropped everywhere
+        for (size_t q = 0; q < hits.size(); ++q) {
+            std::vector<FaissIndex::SearchResult>& query_results = results[query_indices[q]];
+            query_results.reserve(hits[q].size());
+            for (const auto& hit : hits[q]) {
+                auto slot = slot_by_id.find(hit.id);
+                if (slot == slot_by_id.end()) {
+                    continue;
+                }
+                query_results.push_back(unique_hits[slot->second]);
+                query_results.back().distance = hit.distance;
+            }
+        }
+        
+        double elapsed_ms = debug::timer::elapsed_milliseconds(start_time, debug::timer::now());
+        LEAFRA_INFO() << "Batched semantic search completed for " << query_indices.size() << "/" << queries.size()
+                      << " queries (" << unique_hits.size() << " unique chunks, " << std::fixed << std::setprecision(1)
+                      << elapsed_ms << " ms)";
+        return ResultCode::SUCCESS;
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "Exception in semantic_search_batch: " << e.what();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+} //semantic_search_batch
+
+ResultCode LeafraCore::semantic_search_fused(const std::vector<std::string>& queries, int max_results,
+                                             std::vector<FaissIndex::SearchResult>& results,
+                                             const FaissIndex::SearchParams& search_params) {
+    results.clear();
+    std::vector<std::vector<FaissIndex::SearchResult>> per_query;
+    ResultCode search_result = semantic_search_batch(queries, max_results, per_query, search_params);
+    if (search_result != ResultCode::SUCCESS) {
+        return search_result;
+    }
+    
+    // Reciprocal rank fusion with equal weights, same rrf_k as hybrid_search
+    const double rrf_k = static_cast<double>(std::max(1, pImpl->config_.hybrid_search.rrf_k));
+    std::unordered_map<int64_t, size_t> slot_by_id;
+    std::vector<double> scores;
+    for (auto& ranked : per_query) {
+        for (size_t rank = 0; rank < ranked.size(); ++rank) {
+            auto inserted = slot_by_id.emplace(ranked[rank].id, results.size());
+            if (inserted.second) {
+                results.push_back(std::move(ranked[rank]));
+                scores.push_back(0.0);
+            }
+            scores[inserted.first->second] += 1.0 / (rrf_k + static_cast<double>(rank + 1));
+        }
+    }
+    
+    std::vector<size_t> order(results.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return scores[a] > scores[b]; });
+    order.resize(std::min(order.size(), static_cast<size_t>(max_results)));
+    
+    std::vector<FaissIndex::SearchResult> fused;
+    fused.reserve(order.size());
+    for (size_t index : order) {
+        fused.push_back(std::move(results[index]));
+        fused.back().distance = static_cast<float>(scores[index]);
+    }
+    results = std::move(fused);
+    return ResultCode::SUCCESS;
+} //semantic_search_fused
+
+ResultCode LeafraCore::hybrid_search(const std::string& query, int max_results, float alpha, std::vector<FaissIndex::SearchResult>& results) {
+    results.clear();
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    ThroughputGovernor::InteractiveScope interactive(pImpl->governor_);
+    pImpl->pollThroughputGovernor();
+    
+    if (query.empty() || max_results <= 0 || !(alpha >= 0.0f && alpha <= 1.0f)) {
+        LEAFRA_ERROR() << "Invalid query, max_results or alpha";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    try {
+        const HybridSearchConfig& hybrid_config = pImpl->config_.hybrid_search;
+        const int candidates = max_results * std::max(1, hybrid_config.candidate_multiplier);
+        
+        // Keyword ranking needs no model, so it's also the fallback while the embedding model isn't ready
+        std::vector<FaissIndex::SearchResult> keyword_results;
+        bool have_keyword = false;
+#ifdef LEAFRA_HAS_SQLITE
+        if (alpha < 1.0f && pImpl->keyword_index_available_ && pImpl->database_ && pImpl->database_->isOpen()) {
+            have_keyword = pImpl->keywordSearch(query, candidates, keyword_results);
         }
 #endif
-
-#ifdef LEAFRA_HAS_LLAMACPP
-        // Cleanup LlamaCpp resources
-        if (pImpl->llamacpp_initialized_) {
-            LEAFRA_DEBUG() << "Shutting down LlamaCpp";
-            
-            // Unload model and cleanup
-            if (pImpl->llamacpp_model_) {
-                pImpl->llamacpp_model_->unload();
-                pImpl->llamacpp_model_.reset();
+        
+        std::vector<FaissIndex::SearchResult> vector_results;
+        bool have_vector = false;
+        if (alpha > 0.0f && !pImpl->faissShards().empty() && pImpl->hasEmbeddingModel()) {
+            have_vector = semantic_search(query, candidates, vector_results) == ResultCode::SUCCESS;
+            if (!have_vector) {
+                LEAFRA_WARNING() << "Vector retrieval failed, hybrid search using keyword results only";
             }
-            
-            // Cleanup global LlamaCpp resources
-            leafra::llamacpp::global::cleanup();
-            
-            pImpl->llamacpp_initialized_ = false;
-            LEAFRA_DEBUG() << "LlamaCpp shutdown completed";
         }
-#endif
         
-        // Shutdown chunker
-        if (pImpl->chunker_) {
-            // Note: If LeafraChunker doesn't have a shutdown method, the destructor will handle cleanup
-            // But we reset statistics and clear any cached data
-            pImpl->chunker_->reset_statistics();
-            LEAFRA_DEBUG() << "Chunker shutdown completed";
+        if (!have_keyword && !have_vector) {
+            LEAFRA_ERROR() << "Neither keyword nor vector retrieval is available for hybrid search";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
         }
         
-        // Shutdown file parser
-        if (pImpl->file_parser_) {
-            pImpl->file_parser_->shutdown();
-            LEAFRA_DEBUG() << "File parser shutdown completed";
+        // Reciprocal rank fusion: score = sum(weight / (rrf_k + rank)), so neither BM25 nor
+        // distance scales need calibrating against each other. Chunks are keyed by (doc, chunk_no).
+        const double rrf_k = static_cast<double>(std::max(1, hybrid_config.rrf_k));
+        std::unordered_map<std::string, size_t> slot_by_chunk;
+        std::vector<double> scores;
+        auto fuse = [&](std::vector<FaissIndex::SearchResult>& ranked, double weight) {
+            for (size_t rank = 0; rank < ranked.size(); ++rank) {
+                std::string key = std::to_string(ranked[rank].doc_id) + ":" + std::to_string(ranked[rank].chunk_index);
+                auto inserted = slot_by_chunk.emplace(std::move(key), results.size());
+                if (inserted.second) {
+                    results.push_back(std::move(ranked[rank]));
+                    scores.push_back(0.0);
+                } else if (results[inserted.first->second].id < 0) {
+                    results[inserted.first->second].id = ranked[rank].id;
+                }
+                scores[inserted.first->second] += weight / (rrf_k + static_cast<double>(rank + 1));
+            }
+        };
+        fuse(vector_results, have_keyword ? alpha : 1.0);
+        fuse(keyword_results, have_vector ? 1.0 - alpha : 1.0);
+        
+        std::vector<size_t> order(results.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
         }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return scores[a] > scores[b]; });
+        order.resize(std::min(order.size(), static_cast<size_t>(max_results)));
         
-#ifdef LEAFRA_HAS_SQLITE
-        // Shutdown database
-        if (pImpl->database_ && pImpl->database_->isOpen()) {
-            pImpl->database_->close();
-            LEAFRA_DEBUG() << "Database shutdown completed";
+        std::vector<FaissIndex::SearchResult> fused;
+        fused.reserve(order.size());
+        for (size_t index : order) {
+            fused.push_back(std::move(results[index]));
+            fused.back().distance = static_cast<float>(scores[index]);
         }
-#endif
+        results = std::move(fused);
         
-        pImpl->initialized_ = false;
-        pImpl->send_event("LeafraSDK shutdown completed");
+        LEAFRA_INFO() << "Hybrid search completed with " << results.size() << " results ("
+                      << keyword_results.size() << " keyword, " << vector_results.size() << " vector candidates)";
         return ResultCode::SUCCESS;
     } catch (const std::exception& e) {
-        pImpl->send_event("Shutdown failed: " + std::string(e.what()));
+        LEAFRA_ERROR() << "Exception in hybrid_search: " << e.what();
         return ResultCode::ERROR_PROCESSING_FAILED;
     }
-}
-
-bool LeafraCore::is_initialized() const {
-    return pImpl->initialized_;
-}
+} //hybrid_search
 
-const Config& LeafraCore::get_config() const {
-    return pImpl->config_;
-}
+ResultCode LeafraCore::expand_context(std::vector<FaissIndex::SearchResult>& results, int before, int after, int max_tokens) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (before < 0 || after < 0 || max_tokens < 0) {
+        LEAFRA_ERROR() << "Invalid before, after or max_tokens";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    if (results.empty() || (before == 0 && after == 0)) {
+        return ResultCode::SUCCESS;
+    }
+    
+#ifdef LEAFRA_HAS_SQLITE
+    if (!pImpl->database_ || !pImpl->database_->isOpen()) {
+        LEAFRA_ERROR() << "Database not available for context expansion";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    try {
+        const size_t hits = results.size();
+        if (!pImpl->expandContext(results, before, after, max_tokens)) {
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        LEAFRA_DEBUG() << "Expanded " << hits << " hits into " << results.size() << " passages";
+        return ResultCode::SUCCESS;
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "Exception during context expansion: " << e.what();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+#else
+    LEAFRA_ERROR() << "Context expansion needs SQLite";
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+} //expand_context
+#endif
 
-ResultCode LeafraCore::process_data(const data_buffer_t& input, data_buffer_t& output) {
+ResultCode LeafraCore::embed_query(const std::string& query, std::vector<float>& embedding) {
     if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
         return ResultCode::ERROR_INITIALIZATION_FAILED;
     }
     
-    if (!pImpl->data_processor_) {
-        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    if (query.empty()) {
+        LEAFRA_ERROR() << "Invalid query";
+        return ResultCode::ERROR_INVALID_PARAMETER;
     }
     
     try {
-        return pImpl->data_processor_->process(input, output);
+        return pImpl->embedQuery(query, embedding);
     } catch (const std::exception& e) {
-        pImpl->send_event("Data processing failed: " + std::string(e.what()));
+        LEAFRA_ERROR() << "Exception in embed_query: " << e.what();
         return ResultCode::ERROR_PROCESSING_FAILED;
     }
-}
+} //embed_query
+
+SearchCacheStats LeafraCore::get_search_cache_stats() const {
+    std::lock_guard<std::mutex> lock(pImpl->query_mutex_);
+    SearchCacheStats stats;
+    stats.embedding_hits = pImpl->query_embedding_cache_.hits();
+    stats.embedding_misses = pImpl->query_embedding_cache_.misses();
+    stats.embedding_evictions = pImpl->query_embedding_cache_.evictions();
+    stats.embedding_entries = pImpl->query_embedding_cache_.size();
+#ifdef LEAFRA_HAS_FAISS
+    stats.result_hits = pImpl->search_result_cache_.hits() - pImpl->stale_search_results_;
+    stats.result_misses = pImpl->search_result_cache_.misses() + pImpl->stale_search_results_;
+    stats.result_evictions = pImpl->search_result_cache_.evictions();
+    stats.result_entries = pImpl->search_result_cache_.size();
+#endif
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+    stats.answer_hits = pImpl->answer_hits_;
+    stats.answer_misses = pImpl->answer_misses_;
+    stats.answer_entries = pImpl->answer_cache_.size();
+#endif
+    return stats;
+} //get_search_cache_stats
+
+DatabaseSpaceStats LeafraCore::get_database_space_stats() const {
+    DatabaseSpaceStats stats;
+#ifdef LEAFRA_HAS_SQLITE
+    SQLiteDatabase::SpaceStats space;
+    if (pImpl->database_ && pImpl->database_->isOpen() && pImpl->database_->getSpaceStats(space)) {
+        stats.file_bytes = static_cast<uint64_t>(space.page_count * space.page_size);
+        stats.free_bytes = static_cast<uint64_t>(space.freelist_count * space.page_size);
+        stats.free_ratio = space.page_count > 0 ? static_cast<double>(space.freelist_count) / space.page_count : 0.0;
+        stats.incremental_vacuum = space.auto_vacuum == 2;
+        stats.vacuumed_bytes = pImpl->vacuumed_pages_.load() * static_cast<uint64_t>(space.page_size);
+    }
+#endif
+    return stats;
+} //get_database_space_stats
 
-ResultCode LeafraCore::process_user_files(const std::vector<std::string>& file_paths) {
+ResultCode LeafraCore::reclaim_database_space(int64_t max_pages) {
     if (!pImpl->initialized_) {
         LEAFRA_ERROR() << "LeafraCore not initialized";
         return ResultCode::ERROR_INITIALIZATION_FAILED;
     }
-    
-    if (!pImpl->file_parser_) {
-        LEAFRA_ERROR() << "File parser not available";
+    if (pImpl->rejectWhenAttached("Reclaiming database space")) {
         return ResultCode::ERROR_NOT_IMPLEMENTED;
     }
     
-    LEAFRA_INFO() << "Processing " << file_paths.size() << " user files";
-    pImpl->send_event("Processing " + std::to_string(file_paths.size()) + " user files");
-    
-    size_t processed_count = 0;
-    size_t error_count = 0;
-    
-    
-    for (const auto& file_path : file_paths) {
-        LEAFRA_INFO() << "Processing file: " << file_path;
-        pImpl->send_event("Processing file: " + file_path);
-        
-        // Check if file type is supported
-        if (!pImpl->file_parser_->isFileTypeSupported(file_path)) {
-            LEAFRA_WARNING() << "Unsupported file type: " << file_path;
-            pImpl->send_event("Unsupported file type: " + file_path);
-            error_count++;
-            continue;
+#ifdef LEAFRA_HAS_SQLITE
+    const int64_t slice = pImpl->config_.database.vacuum_pages_per_slice > 0 ? pImpl->config_.database.vacuum_pages_per_slice : 256;
+    const DatabaseSpaceStats before = get_database_space_stats();
+    if (!before.incremental_vacuum) {
+        LEAFRA_WARNING() << "Database was not created with auto_vacuum = INCREMENTAL - free pages stay in the file";
+        return ResultCode::SUCCESS;
+    }
+    auto start_time = debug::timer::now();
+    int64_t released = 0;
+    while (max_pages <= 0 || released < max_pages) {
+        int64_t pages = max_pages > 0 ? std::min(slice, max_pages - released) : slice;
+        int64_t slice_released = 0;
+        {
+            // One slice per lock, so ingestion waits for at most one slice
+            std::lock_guard<std::mutex> ingestion_lock(pImpl->ingestion_mutex_);
+            slice_released = pImpl->vacuumSlice(pages);
         }
-        
-        // Parse the file using the appropriate adapter
-        ParsedDocument result = pImpl->file_parser_->parseFile(file_path);
-        
-        if (result.isValid) {
-            processed_count++;
-            
-            // Log parsing results
-            LEAFRA_INFO() << "Successfully parsed " << result.fileType << " file: " << file_path;
-            LEAFRA_INFO() << "  - Title: " << result.title;
-            LEAFRA_INFO() << "  - Author: " << result.author;
-            LEAFRA_INFO() << "  - Pages: " << result.getPageCount();
-            LEAFRA_INFO() << "  - Total text length: " << result.getAllText().length() << " characters";
-            
-            // Send detailed events
-            pImpl->send_event("✅ Parsed " + result.fileType + ": " + file_path);
-            pImpl->send_event("📄 Pages: " + std::to_string(result.getPageCount()));
-            pImpl->send_event("📝 Text length: " + std::to_string(result.getAllText().length()) + " chars");
-            
-            if (!result.title.empty()) {
-                pImpl->send_event("📖 Title: " + result.title);
-            }
-            if (!result.author.empty()) {
-                pImpl->send_event("👤 Author: " + result.author);
-            }
-            
-            // Log metadata if available
-            for (const auto& [key, value] : result.metadata) {
-                if (!value.empty()) {
-                    LEAFRA_DEBUG() << "  - " << key << ": " << value;
-                }
-            }
-            
-            // Perform chunking if enabled
-            if (pImpl->config_.chunking.enabled && pImpl->chunker_) {
-                LEAFRA_INFO() << "Starting chunking process for: " << file_path;
-                pImpl->send_event("🔗 Starting chunking process");
-                
-                // Prepare pages for chunking
-                std::vector<std::string> pages;
-                for (size_t i = 0; i < result.getPageCount(); ++i) {
-                    if (i < result.pages.size() && !result.pages[i].empty()) {
-                        pages.push_back(result.pages[i]);
-                    }
-                }
-                
-                if (!pages.empty()) {
-                    std::vector<TextChunk> chunks;
-                    ResultCode chunk_result = pImpl->chunker_->chunk_document(pages, pImpl->chunker_->get_default_options(), chunks);
-                    
-                    if (chunk_result == ResultCode::SUCCESS) {
-                        LEAFRA_INFO() << "✅ Successfully created " << chunks.size() << " chunks";
-                        pImpl->send_event("🧩 Created " + std::to_string(chunks.size()) + " chunks");
-                        std::string prefix;
-                        if (pImpl->config_.tokenizer.model_name == "multilingual-e5-small") {
-                            prefix = "passage: ";
-                        }
-                        // Use SentencePiece for accurate token counting if available
-                        auto [total_actual_tokens, using_sentencepiece] = pImpl->processChunksWithSentencePieceTokenization(chunks, prefix);
+        if (slice_released < 0) {
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        if (slice_released == 0) {
+            break;
+        }
+        released += slice_released;
+    }
+    const DatabaseSpaceStats after = get_database_space_stats();
+    LEAFRA_INFO() << "🧹 Reclaimed " << (before.file_bytes - std::min(before.file_bytes, after.file_bytes)) / 1024 << " KiB of database space ("
+                  << released << " pages) in " << debug::timer::elapsed_milliseconds(start_time, debug::timer::now()) << " ms";
+    return ResultCode::SUCCESS;
+#else
+    (void)max_pages;
+    LEAFRA_ERROR() << "SQLite support not compiled, there is no database to vacuum";
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+} //reclaim_database_space
 
-#ifdef LEAFRA_HAS_COREML
-                        // Process chunks through CoreML embedding model if available (only if SentencePiece was successful)
-                        if (using_sentencepiece) {
-                            pImpl->processChunksWithCoreMLEmbeddings(chunks, file_path);
-                        }
+void LeafraCore::clear_search_cache() {
+    std::lock_guard<std::mutex> lock(pImpl->query_mutex_);
+    pImpl->query_embedding_cache_.clear();
+    pImpl->query_embedding_cache_.reset_stats();
+#ifdef LEAFRA_HAS_FAISS
+    pImpl->search_result_cache_.clear();
+    pImpl->search_result_cache_.reset_stats();
+    pImpl->stale_search_results_ = 0;
 #endif
-                        // Calculate and log chunk statistics
-                        pImpl->calculateAndLogChunkStatistics(chunks, using_sentencepiece);
-                        // Print detailed chunk content if requested (development/debug feature)
-                        pImpl->printChunkContentAnalysis(chunks, file_path, using_sentencepiece);
-                        // Optional: Log first few chunks for debugging (only in debug mode)
-                        pImpl->printDebugChunkSummary(chunks);
-                                          
-                        // Insert document and chunks into database
-#ifdef LEAFRA_HAS_SQLITE
-                        if (pImpl->database_ && pImpl->database_->isOpen()) {
-                            LEAFRA_DEBUG() << "Inserting document and chunks into database";
-                            if (!pImpl->insertDocumentAndChunksIntoDatabase(result, chunks, file_path)) {
-                                LEAFRA_WARNING() << "Failed to insert document into database: " << file_path;
-                                pImpl->send_event("⚠️ Database insertion failed for: " + file_path);
-                            }
-                        } else {
-                            LEAFRA_DEBUG() << "Database not available, skipping document insertion";
-                        }
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+    pImpl->answer_cache_.clear();
+    pImpl->answer_hits_ = 0;
+    pImpl->answer_misses_ = 0;
 #endif
-                        //here - insert document into FAISS index 
-                        
-                    } else {
-                        LEAFRA_ERROR() << "Failed to chunk document: " << file_path;
-                        pImpl->send_event("❌ Chunking failed for: " + file_path);
-                    }
-                } else {
-                    LEAFRA_WARNING() << "No text content found for chunking in: " << file_path;
-                    pImpl->send_event("⚠️ No text content for chunking");
-                }
-            } else if (!pImpl->config_.chunking.enabled) {
-                LEAFRA_DEBUG() << "Chunking disabled in configuration, skipping chunk creation";
-            }
-            
-        } else {
-            error_count++;
-            LEAFRA_ERROR() << "Failed to parse file: " << file_path << " - " << result.errorMessage;
-            pImpl->send_event("❌ Failed to parse: " + file_path + " - " + result.errorMessage);
-        }
+    LEAFRA_DEBUG() << "Search caches cleared";
+} //clear_search_cache
+
+PipelineMetrics LeafraCore::get_metrics() const {
+    PipelineMetrics metrics = pImpl->metrics_.snapshot();
+    pImpl->pollMemoryUsage();
+    const MemoryAccountant& memory = MemoryAccountant::instance();
+    metrics.memory = memory.snapshot();
+    metrics.tracked_bytes = memory.total();
+    metrics.tracked_peak_bytes = std::max(memory.total_peak(), metrics.tracked_bytes);
+    metrics.tracked_budget_bytes = memory.total_budget();
+    process_resident_memory(metrics.resident_bytes, metrics.peak_resident_bytes);
+    metrics.admission = pImpl->admission_.snapshot();
+    metrics.large_pages = large_pages::metrics();
+    return metrics;
+} //get_metrics
+
+IngestReport LeafraCore::get_last_ingest_report() const {
+    IngestReport report;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->ingest_report_mutex_);
+        report.documents = pImpl->ingest_report_;
+    }
+    for (const IngestDocumentReport& document : report.documents) {
+        report.total_pages += document.pages;
+        report.total_text_chars += document.text_chars;
+        report.total_chunks += document.chunks;
+        report.total_tokens += document.tokens;
+    }
+    if (!report.documents.empty()) {
+        report.avg_chunks_per_document = static_cast<double>(report.total_chunks) / report.documents.size();
+    }
+    if (report.total_chunks > 0) {
+        report.avg_tokens_per_chunk = static_cast<double>(report.total_tokens) / report.total_chunks;
+    }
+    if (report.total_tokens > 0) {
+        report.chars_per_token = static_cast<double>(report.total_text_chars) / report.total_tokens;
+    }
+    return report;
+} //get_last_ingest_report
+
+void LeafraCore::reset_metrics() {
+    pImpl->metrics_.reset();
+    pImpl->pollMemoryUsage(true);
+    MemoryAccountant::instance().reset_peaks();
+    pImpl->admission_.reset();
+} //reset_metrics
+
+void LeafraCore::set_memory_budget(MemorySubsystem subsystem, uint64_t bytes) {
+    MemoryAccountant::instance().set_budget(subsystem, bytes);
+    pImpl->enforceMemoryBudget();
+} //set_memory_budget
+
+ResultCode LeafraCore::report_power_state(const PowerState& state) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
     }
+    if (pImpl->governor_.report_power_state(state)) {
+        pImpl->applyThroughputLimits();
+    }
+    return ResultCode::SUCCESS;
+} //report_power_state
+
+GovernorState LeafraCore::get_governor_state() const {
+    return pImpl->governor_.state();
+} //get_governor_state
 
-    // Summary
-    LEAFRA_INFO() << "File processing completed - Processed: " << processed_count 
-                  << ", Errors: " << error_count << ", Total: " << file_paths.size();
+ResultCode LeafraCore::autotune(int32_t budget_ms, AutotuneTarget target, DeviceProfile* profile) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
     
-    pImpl->send_event("📊 Processing summary: " + std::to_string(processed_count) + 
-                     " successful, " + std::to_string(error_count) + " failed");
+    pImpl->waitForEngines();
+    const int64_t start_ms = PlatformUtils::get_timestamp_ms();
+    const int64_t budget = std::max<int32_t>(budget_ms, 1);
+    const bool tune_embedding = pImpl->hasEmbeddingModel();
+    bool tune_llm = false;
+#ifdef LEAFRA_HAS_LLAMACPP
+    tune_llm = (pImpl->llamacpp_initialized_ || pImpl->llm_unloaded_) &&
+               (pImpl->configured_llm_threads_ <= 0 || pImpl->configured_llm_batch_threads_ <= 0);
+#endif
+    if (!tune_embedding && !tune_llm) {
+        LEAFRA_WARNING() << "⚠️  Autotune: no engine with settings to measure";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    LEAFRA_INFO() << "📐 Autotuning for " << (target == AutotuneTarget::THROUGHPUT ? "throughput" : "latency")
+                  << " (budget: " << budget << " ms)";
     
-    if (processed_count > 0) {
-        pImpl->send_event("✅ File processing completed successfully");
-        return ResultCode::SUCCESS;
-    } else if (error_count == file_paths.size()) {
-        pImpl->send_event("❌ All files failed to process");
-        return ResultCode::ERROR_PROCESSING_FAILED;
-    } else {
-        pImpl->send_event("⚠️ File processing completed with some errors");
-        return ResultCode::SUCCESS; // Partial success
+    // Values not measured this time carry over from the profile in effect
+    DeviceProfile tuned = pImpl->device_profile_;
+    tuned.device = Impl::deviceFingerprint();
+    tuned.target = target;
+    
+    if (tune_embedding) {
+        // The embedding model is the cheaper one to measure: a third of the budget when the LLM runs too
+        std::vector<AutotuneTrial> trials = pImpl->benchmarkEmbeddingBatchSizes(start_ms + (tune_llm ? budget / 3 : budget));
+        // For latency a smaller batch within 10% lets queries in between ingestion batches sooner
+        int32_t batch_size = DeviceProfile::pick(trials, target == AutotuneTarget::LATENCY ? 0.1 : 0.0);
+        if (batch_size > 0) {
+            tuned.embedding_model = DeviceProfile::model_name(pImpl->config_.embedding_inference.model_path);
+            tuned.embedding_batch_size = batch_size;
+            LEAFRA_INFO() << "  - Embedding batch size: " << batch_size;
+        }
     }
-} //process_user_files
+#ifdef LEAFRA_HAS_LLAMACPP
+    if (tune_llm) {
+        std::vector<AutotuneTrial> prompt_trials;
+        std::vector<AutotuneTrial> generation_trials;
+        pImpl->benchmarkLLMThreads(start_ms + budget, prompt_trials, generation_trials);
+        // For throughput fewer threads within 10% leave cores to ingestion running alongside
+        const double tolerance = target == AutotuneTarget::THROUGHPUT ? 0.1 : 0.0;
+        int32_t threads = pImpl->configured_llm_threads_ > 0 ? 0 : DeviceProfile::pick(generation_trials, tolerance);
+        int32_t batch_threads = pImpl->configured_llm_batch_threads_ > 0 ? 0 : DeviceProfile::pick(prompt_trials, tolerance);
+        if (threads > 0 || batch_threads > 0) {
+            tuned.llm_model = DeviceProfile::model_name(pImpl->config_.llm.model_path);
+            tuned.llm_threads = threads;
+            tuned.llm_batch_threads = batch_threads;
+            LEAFRA_INFO() << "  - LLM threads: " << threads << " (batch: " << batch_threads << ", 0 = as configured)";
+        }
+    }
+#endif
+    
+    // Take effect right away: back to the configured values, then the new profile on top
+    pImpl->device_profile_ = tuned;
+    pImpl->config_.llm.n_threads = pImpl->configured_llm_threads_;
+    pImpl->config_.llm.n_threads_batch = pImpl->configured_llm_batch_threads_;
+    pImpl->applyDeviceProfile(pImpl->config_);
+    ThreadBudget thread_budget = ThreadBudget::resolve(PlatformUtils::get_cpu_topology(), pImpl->config_);
+    pImpl->thread_budget_.llm_threads = thread_budget.llm_threads;
+    pImpl->thread_budget_.llm_batch_threads = thread_budget.llm_batch_threads;
+    ThroughputLimits ceiling = pImpl->governor_.ceiling();
+    ceiling.embedding_batch_size = static_cast<size_t>(std::max(1, pImpl->config_.embedding_inference.batch_size));
+    ceiling.llm_threads = thread_budget.llm_threads;
+    ceiling.llm_batch_threads = thread_budget.llm_batch_threads;
+    pImpl->governor_.set_ceiling(ceiling);
+    pImpl->applyThroughputLimits();
+    
+    if (profile) {
+        *profile = tuned;
+    }
+    LEAFRA_INFO() << "✅ Autotune finished in " << (PlatformUtils::get_timestamp_ms() - start_ms) << " ms";
+    if (!pImpl->config_.device_profile_name.empty()) {
+        const std::string path = FileManager::getAbsolutePath(StorageType::AppStorage, pImpl->config_.device_profile_name);
+        if (!tuned.save(path)) {
+            LEAFRA_ERROR() << "❌ Failed to write the device profile: " << path;
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+    }
+    return ResultCode::SUCCESS;
+} //autotune
 
-void LeafraCore::set_event_callback(callback_t callback) {
-    pImpl->event_callback_ = callback;
-}
+void LeafraCore::start_trace() {
+    trace::start(static_cast<size_t>(std::max<int32_t>(pImpl->config_.trace_max_events_per_thread, 1)));
+    LEAFRA_INFO() << "⏱️ Tracing started";
+} //start_trace
 
-std::string LeafraCore::get_version() {
-    std::ostringstream oss;
-    oss << LEAFRA_VERSION_MAJOR << "." << LEAFRA_VERSION_MINOR << "." << LEAFRA_VERSION_PATCH;
-    return oss.str();
-}
+ResultCode LeafraCore::stop_trace(const std::string& output_path) {
+    trace::stop();
+    if (output_path.empty()) {
+        return ResultCode::SUCCESS;
+    }
+    if (!trace::write_chrome_trace(output_path)) {
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    LEAFRA_INFO() << "⏱️ Trace written to " << output_path << " (" << trace::event_count() << " events, "
+                  << trace::dropped_count() << " dropped)";
+    return ResultCode::SUCCESS;
+} //stop_trace
 
-std::string LeafraCore::get_platform() {
-    return PlatformUtils::get_platform_name();
-}
+ResultCode LeafraCore::export_bundle(const std::string& path) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+#ifdef LEAFRA_HAS_SQLITE
+    if (!pImpl->database_ || !pImpl->database_->isOpen()) {
+        LEAFRA_ERROR() << "Database not available for bundle export";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (path.empty() || SQLiteDatabase::fileExists(path)) {
+        LEAFRA_ERROR() << "Bundle path is empty or already exists: '" << path << "'";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    auto start_time = debug::timer::now();
+    
+    // Holding the ingestion lock keeps documents and indexes still while they are copied
+    std::lock_guard<std::mutex> ingestion_lock(pImpl->ingestion_mutex_);
+#ifdef LEAFRA_HAS_FAISS
+    // Full snapshots first, so importing devices load one blob per index instead of replaying deltas
+    pImpl->compactFaissIndex(true);
+#endif
+    if (!pImpl->database_->vacuumInto(path)) {
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    
+    // The bundle is shipped as a single file, so it stays in rollback-journal mode
+    SQLiteDatabase bundle;
+    DatabaseConfig bundle_config;
+    bundle_config.journal_mode.clear();
+    bundle.setConfig(bundle_config);
+    bool written = bundle.openFile(path, static_cast<int>(SQLiteDatabase::OpenFlags::ReadWrite));
+#ifdef LEAFRA_HAS_FAISS
+    // "file" storage keeps snapshots next to the database - the bundle carries them as blobs instead
+    if (written && pImpl->config_.vector_search.index_storage == "file") {
+        std::vector<std::pair<std::string, std::shared_ptr<FaissIndex>>> indexes;
+        {
+            std::lock_guard<std::mutex> lock(pImpl->faiss_collections_mutex_);
+            for (const auto& entry : pImpl->faiss_collections_) {
+                indexes.emplace_back(entry.second.definition, entry.second.index);
+            }
+        }
+        for (const auto& index : indexes) {
+            written = written && index.second->save_to_db(bundle, index.first) == ResultCode::SUCCESS;
+        }
+    }
+#endif
+    BundleManifest manifest = pImpl->currentBundleManifest();
+    written = written && RagBundle::write_manifest(bundle, manifest);
+    bundle.close();
+    if (!written) {
+        LEAFRA_ERROR() << "❌ Failed to write bundle " << path;
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    
+    LEAFRA_INFO() << "📦 Exported bundle " << path << " (" << manifest.documents << " documents, " << manifest.chunks
+                  << " chunks) in " << debug::timer::elapsed_milliseconds(start_time, debug::timer::now()) << " ms";
+    pImpl->send_event(EventType::DATABASE_STATUS, "Bundle exported: " + std::to_string(manifest.documents) + " documents");
+    return ResultCode::SUCCESS;
+#else
+    (void)path;
+    LEAFRA_ERROR() << "SQLite support not compiled, bundles can't be exported";
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+} //export_bundle
 
-std::vector<ChunkTokenInfo> LeafraCore::extract_chunk_token_info(const std::vector<TextChunk>& chunks) {
-    std::vector<ChunkTokenInfo> token_info;
-    token_info.reserve(chunks.size());
+ResultCode LeafraCore::import_bundle(const std::string& path) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (pImpl->rejectWhenAttached("Bundle import")) {
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
     
-    for (size_t i = 0; i < chunks.size(); ++i) {
-        const auto& chunk = chunks[i];
-        token_info.emplace_back(
-            i,                              // chunk_index
-            chunk.content,                  // content (string_view)
-            chunk.token_ids,                // token_ids (copy the vector)
-            chunk.content.length(),         // character_count
-            chunk.estimated_tokens,         // token_count (actual token count when SentencePiece is used)
-            chunk.page_number               // page_number
-        );
+#ifdef LEAFRA_HAS_SQLITE
+    if (!pImpl->database_ || !pImpl->database_->isOpen()) {
+        LEAFRA_ERROR() << "Database not available for bundle import";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
     }
+    auto start_time = debug::timer::now();
     
-    return token_info;
-}
+    // Everything about the bundle is checked before the corpus is touched
+    BundleManifest manifest;
+    ResultCode checked = pImpl->checkSnapshot(path, "Bundle", manifest);
+    if (checked != ResultCode::SUCCESS) {
+        return checked;
+    }
+    ResultCode replaced = pImpl->replaceDatabase(path, manifest, "");
+    if (replaced != ResultCode::SUCCESS) {
+        return replaced;
+    }
+    
+    LEAFRA_INFO() << "📦 Imported bundle " << path << " (" << manifest.documents << " documents, " << manifest.chunks
+                  << " chunks) in " << debug::timer::elapsed_milliseconds(start_time, debug::timer::now()) << " ms";
+    pImpl->send_event(EventType::DATABASE_STATUS, "Bundle imported: " + std::to_string(manifest.documents) + " documents");
+    return ResultCode::SUCCESS;
+#else
+    (void)path;
+    LEAFRA_ERROR() << "SQLite support not compiled, bundles can't be imported";
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+} //import_bundle
 
-shared_ptr<LeafraCore> LeafraCore::create() {
-    return std::make_shared<LeafraCore>();
+ResultCode LeafraCore::backup_database(const std::string& path) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (path.empty()) {
+        LEAFRA_ERROR() << "Backup path is empty";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    return pImpl->runBackup(path);
 }
 
+std::shared_future<ResultCode> LeafraCore::backup_database_async(const std::string& path) {
+    std::lock_guard<std::mutex> lock(pImpl->backup_job_mutex_);
+    if (pImpl->backup_job_.valid() && pImpl->backup_job_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        LEAFRA_ERROR() << "A backup is already running";
+        std::promise<ResultCode> busy;
+        busy.set_value(ResultCode::ERROR_PROCESSING_FAILED);
+        return busy.get_future().share();
+    }
+    if (pImpl->backup_thread_.joinable()) {
+        pImpl->backup_thread_.join();
+    }
+    auto promise = std::make_shared<std::promise<ResultCode>>();
+    pImpl->backup_job_ = promise->get_future().share();
+    pImpl->backup_thread_ = std::thread([this, path, promise]() {
+        ResultCode result = ResultCode::ERROR_PROCESSING_FAILED;
+        try {
+            result = backup_database(path);
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "Backup failed: " << e.what();
+        }
+        promise->set_value(result);
+    });
+    return pImpl->backup_job_;
+} //backup_database_async
 
-
-// Simple Semantic search 
-ResultCode LeafraCore::semantic_search(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results) {
+ResultCode LeafraCore::restore_database(const std::string& path) {
     if (!pImpl->initialized_) {
         LEAFRA_ERROR() << "LeafraCore not initialized";
         return ResultCode::ERROR_INITIALIZATION_FAILED;
     }
-    
-    if (query.empty() || max_results <= 0) {
-        LEAFRA_ERROR() << "Invalid query or max_results";
-        return ResultCode::ERROR_INVALID_PARAMETER;
+    if (pImpl->rejectWhenAttached("Database restore")) {
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
     }
     
-#ifdef LEAFRA_HAS_FAISS
-    if (!pImpl->faiss_index_) {
-        LEAFRA_ERROR() << "FAISS index not available";
+#ifdef LEAFRA_HAS_SQLITE
+    if (!pImpl->database_ || !pImpl->database_->isOpen()) {
+        LEAFRA_ERROR() << "Database not available for restore";
         return ResultCode::ERROR_INITIALIZATION_FAILED;
     }
+    auto start_time = debug::timer::now();
+    
+    BundleManifest manifest;
+    ResultCode checked = pImpl->checkSnapshot(path, "Backup", manifest);
+    if (checked != ResultCode::SUCCESS) {
+        return checked;
+    }
+    std::error_code ec;
+    const std::string index_directory = std::filesystem::is_directory(path + ".indexes", ec) ? path + ".indexes" : std::string();
+    ResultCode replaced = pImpl->replaceDatabase(path, manifest, index_directory);
+    if (replaced != ResultCode::SUCCESS) {
+        return replaced;
+    }
+    
+    LEAFRA_INFO() << "💾 Restored " << manifest.documents << " documents from backup " << path << " (FAISS delta "
+                  << manifest.faiss_delta_id << ") in " << debug::timer::elapsed_milliseconds(start_time, debug::timer::now()) << " ms";
+    pImpl->send_event(EventType::DATABASE_STATUS, "Backup restored: " + std::to_string(manifest.documents) + " documents");
+    return ResultCode::SUCCESS;
 #else
-    LEAFRA_ERROR() << "FAISS support not compiled";
+    (void)path;
+    LEAFRA_ERROR() << "SQLite support not compiled, backups can't be restored";
     return ResultCode::ERROR_NOT_IMPLEMENTED;
 #endif
+} //restore_database
 
-#ifdef LEAFRA_HAS_COREML
-    if (!pImpl->coreml_initialized_ || !pImpl->coreml_model_) {
-        LEAFRA_ERROR() << "CoreML model not available";
+ResultCode LeafraCore::export_delta(const std::string& path, int64_t since_generation, int64_t* generation) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
         return ResultCode::ERROR_INITIALIZATION_FAILED;
     }
-#else
-    LEAFRA_ERROR() << "CoreML support not compiled";
-    return ResultCode::ERROR_NOT_IMPLEMENTED;
-#endif
-
-    if (!pImpl->tokenizer_) {
-        LEAFRA_ERROR() << "SentencePiece tokenizer not available";
+    // The delta is written through this connection, which an attached process keeps read-only
+    if (pImpl->rejectWhenAttached("Delta export")) {
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+    
+#ifdef LEAFRA_HAS_SQLITE
+    if (!pImpl->database_ || !pImpl->database_->isOpen() || !pImpl->sync_log_available_) {
+        LEAFRA_ERROR() << "Database or sync log not available for delta export";
         return ResultCode::ERROR_INITIALIZATION_FAILED;
     }
+    if (path.empty() || SQLiteDatabase::fileExists(path) || since_generation < 0) {
+        LEAFRA_ERROR() << "Delta path is empty or already exists, or the generation is negative: '" << path << "'";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    if (pImpl->embedding_storage_format_ == EmbeddingStorageFormat::NONE) {
+        LEAFRA_ERROR() << "Delta export needs the chunk embeddings - set vector_search.embedding_storage";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    auto start_time = debug::timer::now();
     
-    try {
-        
-        // Create a single page with the query (using same format as existing code)
-        std::vector<std::string> pages;
-        pages.push_back(query);
-        
-        // Create chunks using the existing chunker
-        std::vector<TextChunk> chunks;
-        ResultCode chunk_result = pImpl->chunker_->chunk_document(pages, pImpl->chunker_->get_default_options(), chunks);
-        
-        if (chunk_result != ResultCode::SUCCESS || chunks.empty()) {
-            LEAFRA_ERROR() << "Failed to create chunks from query";
+    // Holding the ingestion lock keeps the log and the rows it points to still while they are copied
+    std::lock_guard<std::mutex> ingestion_lock(pImpl->ingestion_mutex_);
+    SQLiteDatabase& db = *pImpl->database_;
+    int64_t through = 0;
+    db.execute("SELECT COALESCE(MAX(seq), 0) FROM sync_log", [&through](const SQLiteDatabase::Row& row) {
+        through = row.getInt64(0);
+        return false;
+    });
+    
+    bool written = false;
+    {
+        auto attach = db.prepare("ATTACH DATABASE ? AS sync_delta");
+        if (!attach || !attach->isValid() || !attach->bindText(1, path) || !attach->execute()) {
+            LEAFRA_ERROR() << "Failed to create delta " << path << ": " << db.getLastErrorMessage();
             return ResultCode::ERROR_PROCESSING_FAILED;
         }
-        std::string prefix; 
-        if (pImpl->config_.tokenizer.model_name == "multilingual-e5-small") {
-            prefix = "query: ";
-        }
-        // Use SentencePiece for tokenization (reusing existing pipeline)
-        auto [total_actual_tokens, using_sentencepiece] = pImpl->processChunksWithSentencePieceTokenization(chunks, prefix);
-        
-        if (!using_sentencepiece) {
-            LEAFRA_ERROR() << "SentencePiece tokenization failed for query";
-            return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    {
+        // Documents added in (since, through] and not removed since; removals keep their order
+        SQLiteTransaction snapshot(db);
+        auto added_stmt = db.prepare("INSERT INTO delta_docs (id) SELECT DISTINCT l.doc_id FROM sync_log l JOIN docs d ON d.id = l.doc_id "
+                                     "WHERE l.seq > ? AND l.seq <= ? AND l.removed = 0");
+        auto removed_stmt = db.prepare("INSERT INTO sync_delta.sync_removals (url, collection) SELECT url, collection FROM sync_log "
+                                       "WHERE seq > ? AND seq <= ? AND removed = 1 ORDER BY seq");
+        written = db.execute("CREATE TEMP TABLE IF NOT EXISTS delta_docs (id INTEGER PRIMARY KEY)") && db.execute("DELETE FROM delta_docs") &&
+                  added_stmt && added_stmt->isValid() && added_stmt->bindInt64(1, since_generation) && added_stmt->bindInt64(2, through) &&
+                  added_stmt->execute() &&
+                  db.execute("CREATE TABLE sync_delta.docs AS SELECT * FROM main.docs WHERE id IN (SELECT id FROM delta_docs) ORDER BY id") &&
+                  db.execute("CREATE TABLE sync_delta.chunks AS SELECT * FROM main.chunks WHERE doc_id IN (SELECT id FROM delta_docs) ORDER BY id") &&
+                  db.execute("CREATE TABLE sync_delta.chunk_embeddings AS SELECT e.* FROM main.chunk_embeddings e "
+                             "JOIN main.chunks c ON c.chunk_faiss_id = e.chunk_faiss_id WHERE c.doc_id IN (SELECT id FROM delta_docs) "
+                             "ORDER BY e.chunk_faiss_id") &&
+                  db.execute("CREATE TABLE sync_delta.doc_texts AS SELECT * FROM main.doc_texts WHERE doc_id IN (SELECT id FROM delta_docs) "
+                             "ORDER BY doc_id, text_start") &&
+                  db.execute("CREATE TABLE sync_delta.doc_centroids AS SELECT * FROM main.doc_centroids WHERE doc_id IN (SELECT id FROM delta_docs) "
+                             "ORDER BY doc_id") &&
+                  db.execute("CREATE TABLE sync_delta.sync_removals (url TEXT, collection TEXT NOT NULL)") &&
+                  removed_stmt && removed_stmt->isValid() && removed_stmt->bindInt64(1, since_generation) &&
+                  removed_stmt->bindInt64(2, through) && removed_stmt->execute() &&
+                  db.execute("DELETE FROM delta_docs") && snapshot.commit();
+        if (!written) {
+            LEAFRA_ERROR() << "Failed to write delta rows: " << db.getLastErrorMessage();
         }
-        
-#ifdef LEAFRA_HAS_COREML
-        // Process through CoreML embedding model (reusing existing pipeline)
-        pImpl->processChunksWithCoreMLEmbeddings(chunks, "semantic_search_query");
+    }
+    if (!db.execute("DETACH DATABASE sync_delta")) {
+        LEAFRA_WARNING() << "Failed to detach delta " << path << ": " << db.getLastErrorMessage();
+    }
+    
+    BundleManifest manifest = pImpl->currentBundleManifest();
+    manifest.delta = true;
+    manifest.delta_since = since_generation;
+    manifest.delta_through = through;
+    if (written) {
+        // Shipped as a single file, like a bundle
+        SQLiteDatabase delta;
+        DatabaseConfig delta_config;
+        delta_config.journal_mode.clear();
+        delta.setConfig(delta_config);
+        written = delta.openFile(path, static_cast<int>(SQLiteDatabase::OpenFlags::ReadWrite)) && RagBundle::write_manifest(delta, manifest);
+        delta.close();
+    }
+    if (!written) {
+        LEAFRA_ERROR() << "❌ Failed to write delta " << path;
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    if (generation) {
+        *generation = through;
+    }
+    
+    LEAFRA_INFO() << "📦 Exported delta " << path << " (generations " << since_generation << "-" << through << ": " << manifest.documents
+                  << " documents, " << manifest.chunks << " chunks) in " << debug::timer::elapsed_milliseconds(start_time, debug::timer::now()) << " ms";
+    pImpl->send_event(EventType::DATABASE_STATUS, "Delta exported: " + std::to_string(manifest.documents) + " documents");
+    return ResultCode::SUCCESS;
+#else
+    (void)path;
+    (void)since_generation;
+    (void)generation;
+    LEAFRA_ERROR() << "SQLite support not compiled, deltas can't be exported";
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
 #endif
-        
-        // Use only the first chunk for search
-        if (chunks.empty() || !chunks[0].has_embedding()) {
-            LEAFRA_ERROR() << "No embedding generated for query";
-            return ResultCode::ERROR_PROCESSING_FAILED;
-        }
-        
-        const auto& query_embedding = chunks[0].embedding;
-        std::ostringstream embedding_stream;
-        embedding_stream << "Generated embedding for query (dim: " << query_embedding.size() << "): [";
-        for (size_t i = 0; i < query_embedding.size(); ++i) {
-            embedding_stream << query_embedding[i];
-            if (i < query_embedding.size() - 1) {
-                embedding_stream << ", ";
-            }
-        }
-        embedding_stream << "]";
-        LEAFRA_DEBUG() << embedding_stream.str();
-        
-        
-#ifdef LEAFRA_HAS_FAISS
-        // Perform FAISS search
-        ResultCode search_result = pImpl->faiss_index_->search(
-            query_embedding.data(), 
-            max_results, 
-            results
-        );
-        
-        if (search_result != ResultCode::SUCCESS) {
-            LEAFRA_ERROR() << "FAISS search failed";
-            return search_result;
-        }
+} //export_delta
 
-        // Get the chunks from the database using FAISS IDs
+ResultCode LeafraCore::import_delta(const std::string& path, int64_t applied_generation, int64_t* generation) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    if (pImpl->rejectWhenAttached("Delta import")) {
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+    
 #ifdef LEAFRA_HAS_SQLITE
-        if (pImpl->database_ && pImpl->database_->isOpen()) {
-            std::vector<FaissIndex::SearchResult> final_results;
-            final_results.reserve(results.size());
-            
-            // Prepare the statement once outside the loop for better performance
-            auto stmt = pImpl->database_->prepare(
-                "SELECT c.doc_id, c.chunk_no, c.chunk_text, c.chunk_page_number, d.filename "
-                "FROM chunks c "
-                "JOIN docs d ON c.doc_id = d.id "
-                "WHERE c.chunk_faiss_id = ?"
-            );
-            
-            if (stmt && stmt->isValid()) {
-                for (const auto& faiss_result : results) {
-                    // Bind the FAISS ID parameter for this iteration
-                    stmt->bindInt64(1, faiss_result.id);
-                    
-                    if (stmt->step()) {
-                        auto row = stmt->getCurrentRow();
-                        
-                        // Create a SearchResult with enriched information
-                        FaissIndex::SearchResult enriched_result(faiss_result.id, faiss_result.distance);
-                        enriched_result.doc_id = row.getInt64(0);
-                        enriched_result.chunk_index = row.getInt(1);
-                        enriched_result.content = row.getText(2);
-                        enriched_result.page_number = row.getInt(3);
-                        enriched_result.filename = row.getText(4);
-                        
-                        final_results.push_back(std::move(enriched_result));
-                        
-                        // Log the retrieved chunk information for debugging
-                        LEAFRA_DEBUG() << "Found chunk - Doc: " << enriched_result.filename 
-                                      << ", Page: " << enriched_result.page_number
-                                      << ", Chunk: " << enriched_result.chunk_index
-                                      << ", Distance: " << enriched_result.distance;
-                    } else {
-                        LEAFRA_WARNING() << "FAISS ID " << faiss_result.id << " not found in database";
-                    }
-                    
-                    // Reset the statement for the next iteration
-                    stmt->reset();
-                }
-            } else {
-                LEAFRA_ERROR() << "Failed to prepare chunk lookup query";
-            }
-            
-            results = std::move(final_results);
-            LEAFRA_INFO() << "Semantic search found " << results.size() << " valid results for query";
-        } else {
-            LEAFRA_WARNING() << "Database not available for chunk lookup";
-        }
+    if (!pImpl->database_ || !pImpl->database_->isOpen()) {
+        LEAFRA_ERROR() << "Database not available for delta import";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    auto start_time = debug::timer::now();
+    
+    BundleManifest manifest;
+    ResultCode checked = pImpl->checkSnapshot(path, "Delta", manifest, true);
+    if (checked != ResultCode::SUCCESS) {
+        return checked;
+    }
+    // A later start would skip what was added in between; an earlier one only repeats documents
+    if (manifest.delta_since > applied_generation) {
+        LEAFRA_ERROR() << "Delta starts after generation " << manifest.delta_since << " but this device applied up to "
+                       << applied_generation << " - export one since " << applied_generation;
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    size_t added = 0;
+    size_t removed = 0;
+    ResultCode applied = ResultCode::SUCCESS;
+    {
+        std::lock_guard<std::mutex> ingestion_lock(pImpl->ingestion_mutex_);
+        applied = pImpl->applyDelta(path, added, removed);
+    }
+    if (applied != ResultCode::SUCCESS) {
+        return applied;
+    }
+    if (generation) {
+        *generation = std::max(applied_generation, manifest.delta_through);
+    }
+    
+    LEAFRA_INFO() << "📦 Applied delta " << path << " (generations " << manifest.delta_since << "-" << manifest.delta_through << ": "
+                  << added << " documents added, " << removed << " removed) in "
+                  << debug::timer::elapsed_milliseconds(start_time, debug::timer::now()) << " ms";
+    pImpl->send_event(EventType::DATABASE_STATUS, "Delta imported: " + std::to_string(added) + " documents");
+    return ResultCode::SUCCESS;
 #else
-        LEAFRA_WARNING() << "SQLite support not compiled, returning FAISS IDs only";
+    (void)path;
+    (void)applied_generation;
+    (void)generation;
+    LEAFRA_ERROR() << "SQLite support not compiled, deltas can't be imported";
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
 #endif
-        
-
+} //import_delta
 
-        LEAFRA_INFO() << "Semantic search completed with " << results.size() << " results";
-        return ResultCode::SUCCESS;
-#endif
-        
-    } catch (const std::exception& e) {
-        LEAFRA_ERROR() << "Exception in semantic_search: " << e.what();
-        return ResultCode::ERROR_PROCESSING_FAILED;
+int64_t LeafraCore::get_sync_generation() {
+    if (!pImpl->initialized_) {
+        return 0;
     }
-} //semantic_search
+#ifdef LEAFRA_HAS_SQLITE
+    int64_t generation = 0;
+    if (pImpl->sync_log_available_ && pImpl->database_ && pImpl->database_->isOpen()) {
+        pImpl->database_->execute("SELECT COALESCE(MAX(seq), 0) FROM sync_log", [&generation](const SQLiteDatabase::Row& row) {
+            generation = row.getInt64(0);
+            return false;
+        });
+    }
+    return generation;
+#else
+    return 0;
+#endif
+} //get_sync_generation
 
 //Semantic Search with LLM 
 //This is a simple semantic search that uses the LLM to generate a response to the query - and it streams the results to the user via a callback.
@@ -1883,10 +11922,28 @@ ResultCode LeafraCore::semantic_search(const std::string& query, int max_results
 //the callback is used to stream the response to the user
 //internally it uses the semantic_search and generate_chat_response_stream(const std::vector<ChatMessage>& messages, TokenCallback callback, int32_t max_tokens) {
 ResultCode LeafraCore::semantic_search_with_llm(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results, token_callback_t callback) {
+    SearchDeadline no_deadline;
+    return semantic_search_with_llm(query, max_results, results, callback, no_deadline);
+}
+
+ResultCode LeafraCore::semantic_search_with_llm(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results,
+                                                token_callback_t callback, QueryStats& stats) {
+    SearchDeadline no_deadline;
+    return semantic_search_with_llm(query, max_results, results, callback, no_deadline, &stats);
+}
+
+ResultCode LeafraCore::semantic_search_with_llm(const std::string& query, int max_results, std::vector<FaissIndex::SearchResult>& results,
+                                                token_callback_t callback, SearchDeadline& deadline, QueryStats* query_stats) {
+    Impl::QueryDeadline budget(deadline, query_stats);
+    budget.allow_unhydrated = false;
     if (!pImpl->initialized_) {
         LEAFRA_ERROR() << "LeafraCore not initialized";
         return ResultCode::ERROR_INITIALIZATION_FAILED;
     }
+    ThroughputGovernor::InteractiveScope interactive(pImpl->governor_);
+    pImpl->pollThroughputGovernor();
+    trace::Span span("query", "semantic_search_with_llm");
+    span.arg("max_results", max_results);
     
     if (query.empty() || max_results <= 0) {
         LEAFRA_ERROR() << "Invalid query or max_results";
@@ -1899,7 +11956,14 @@ ResultCode LeafraCore::semantic_search_with_llm(const std::string& query, int ma
     }
 
 #ifdef LEAFRA_HAS_LLAMACPP
-    if (!pImpl->llamacpp_initialized_ || !pImpl->llamacpp_model_) {
+    // The slot is taken before the model lock, so a queued answer doesn't hold up an LLM swap
+    AdmissionController::Permit permit(pImpl->admission_, AdmissionResource::LLM, AdmissionLane::INTERACTIVE);
+    if (!permit.admitted()) {
+        LEAFRA_WARNING() << "Too many requests waiting for the LLM";
+        return ResultCode::ERROR_BUSY;
+    }
+    std::shared_lock<std::shared_mutex> llm_lock;
+    if (!pImpl->acquireLLM(llm_lock)) {
         LEAFRA_ERROR() << "LlamaCpp not initialized or model not loaded";
         return ResultCode::ERROR_INITIALIZATION_FAILED;
     }
@@ -1909,15 +11973,94 @@ ResultCode LeafraCore::semantic_search_with_llm(const std::string& query, int ma
 #endif
 
     try {
+#ifdef LEAFRA_HAS_LLAMACPP
+        // Step 0: The prompt head doesn't depend on what is retrieved, so the model evaluates it meanwhile
+        // (the prompt built in step 2 then only evaluates from the retrieved context on)
+        std::future<bool> prefill;
+        if (pImpl->config_.llm.prefill_during_retrieval && pImpl->config_.llm.reuse_prompt_cache) {
+            Impl* impl = pImpl.get();
+            prefill = std::async(std::launch::async, [impl, query]() {
+                trace::Span prefill_span("llm", "prefill_rag_prompt");
+                return impl->prefillRagPrompt(query);
+            });
+        }
+#endif
+        
         // Step 1: Perform semantic search to get the most relevant chunks
         LEAFRA_DEBUG() << "Performing semantic search for query: " << query.substr(0, 100) << (query.length() > 100 ? "..." : "");
         
-        ResultCode search_result = semantic_search(query, max_results, results);
+        const RerankConfig& rerank_config = pImpl->config_.rerank;
+        const DiversityConfig& diversity_config = pImpl->config_.diversity;
+        const bool rerank = rerank_config.enabled && rerank_config.candidate_multiplier > 1;
+        const bool mmr = diversity_config.mmr_enabled && diversity_config.candidate_multiplier > 1;
+        // MMR narrows the pool to what the re-ranker reads, which narrows it to max_results
+        const int rerank_pool = rerank ? max_results * rerank_config.candidate_multiplier : max_results;
+        ResultCode search_result = pImpl->searchCollections(query, {}, mmr ? rerank_pool * diversity_config.candidate_multiplier : rerank_pool,
+                                                            results, FaissIndex::SearchParams(),
+                                                            static_cast<uint32_t>(SearchResultFields::ALL), nullptr, &budget, query_stats);
         if (search_result != ResultCode::SUCCESS) {
             LEAFRA_ERROR() << "Semantic search failed";
             return search_result;
         }
         
+#ifdef LEAFRA_HAS_FAISS
+        if (mmr && results.size() > static_cast<size_t>(rerank_pool)) {
+            std::vector<float> query_embedding;
+            if (pImpl->embedQuery(query, query_embedding) == ResultCode::SUCCESS) {
+                pImpl->selectDiverseResults(query_embedding, static_cast<size_t>(rerank_pool), results);
+            } else {
+                results.resize(static_cast<size_t>(rerank_pool));
+            }
+        }
+#endif
+        
+#ifdef LEAFRA_HAS_LLAMACPP
+        // Step 1b: Re-rank the over-fetched candidates so only the best max_results reach the prompt
+        // (a deadline keeps the re-ranker only if it and the prompt evaluation, each about one prompt eval, fit)
+        if (rerank && results.size() > static_cast<size_t>(max_results) &&
+            !budget.fits(2.0 * pImpl->metrics_.typical_ms(PipelineStage::LLM_PROMPT_EVAL))) {
+            budget.degrade(SearchDegradation::SKIPPED_RERANK);
+            results.resize(static_cast<size_t>(max_results));
+            LEAFRA_INFO() << "⏱️ Search deadline too short for re-ranking, using retrieval order";
+        } else if (rerank && results.size() > static_cast<size_t>(max_results)) {
+            auto rerank_start = std::chrono::steady_clock::now();
+            std::vector<std::string> passages;
+            passages.reserve(results.size());
+            for (const auto& result : results) {
+                passages.push_back(result.content);
+            }
+            std::vector<float> scores = pImpl->llamacpp_model_->score_relevance(query, passages, rerank_config.max_passage_tokens);
+            if (scores.size() == results.size()) {
+                std::vector<uint32_t> order;
+                simd::top_k(scores.data(), scores.size(), static_cast<size_t>(max_results), true, order);
+                std::vector<FaissIndex::SearchResult> reranked;
+                reranked.reserve(order.size());
+                for (uint32_t index : order) {
+                    reranked.push_back(std::move(results[index]));
+                }
+                auto rerank_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - rerank_start).count();
+                LEAFRA_DEBUG() << "Re-ranked " << results.size() << " candidates to " << reranked.size() << " in " << rerank_ms << "ms";
+                if (query_stats) {
+                    query_stats->rerank_ms += rerank_ms;
+                }
+                results = std::move(reranked);
+            } else {
+                LEAFRA_WARNING() << "Re-ranking failed, using retrieval order: " << pImpl->llamacpp_model_->get_last_error();
+                results.resize(static_cast<size_t>(max_results));
+            }
+        }
+#endif
+        
+#ifdef LEAFRA_HAS_FAISS
+        if (diversity_config.merge_adjacent) {
+            size_t chunk_count = results.size();
+            Impl::mergeAdjacentResults(diversity_config.max_span_chunks, results);
+            if (results.size() < chunk_count) {
+                LEAFRA_DEBUG() << "Merged " << chunk_count << " chunks into " << results.size() << " spans";
+            }
+        }
+#endif
+        
         if (results.empty()) {
             LEAFRA_WARNING() << "No search results found for query";
             // Still proceed with LLM generation but without context
@@ -1925,40 +12068,90 @@ ResultCode LeafraCore::semantic_search_with_llm(const std::string& query, int ma
         
         LEAFRA_INFO() << "Found " << results.size() << " relevant chunks for LLM context";
         
-        // Step 2: Build context from search results
-        std::ostringstream context_stream;
-        context_stream << "Based on the following relevant information:\n\n";
-        
-        for (size_t i = 0; i < results.size(); ++i) {
-            const auto& result = results[i];
-            context_stream << "Context " << (i + 1) << " (from " << result.filename 
-                          << ", page " << result.page_number << "):\n";
-            context_stream << result.content << "\n\n";
+#ifdef LEAFRA_HAS_LLAMACPP
+        std::string answer_key;
+        std::vector<float> answer_embedding;
+        bool compressed = false;
+#endif
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+        // Step 1c: A near-identical question grounded on the same chunks is answered from the cache
+        if (pImpl->config_.search_cache.cache_answers && !results.empty() &&
+            pImpl->embedQuery(query, answer_embedding) == ResultCode::SUCCESS) {
+            answer_key = Impl::makeAnswerCacheKey(results);
+            std::string cached_answer;
+            if (pImpl->lookupCachedAnswer(answer_key, answer_embedding, cached_answer)) {
+                LEAFRA_INFO() << "💬 Answered from the answer cache (" << results.size() << " chunks)";
+                if (query_stats) {
+                    query_stats->answer_cache_hit = true;
+                    query_stats->results = static_cast<int32_t>(results.size());
+                    query_stats->ttft_ms = debug::timer::elapsed_milliseconds(budget.start, debug::timer::now());
+                }
+                callback(cached_answer, false);
+                callback("", true);
+                return ResultCode::SUCCESS;
+            }
         }
+#endif
         
-        context_stream << "Please answer the following question: " << query;
-        
-        std::string context = context_stream.str();
-        LEAFRA_DEBUG() << "Built context for LLM (length: " << context.length() << " chars)";
-        
-        // Step 3: Create chat messages for the LLM
-        std::vector<leafra::llamacpp::ChatMessage> messages;
-        
-        // Add system prompt if configured
-        if (!pImpl->config_.llm.system_prompt.empty()) {
-            messages.emplace_back("system", pImpl->config_.llm.system_prompt);
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+        // Step 1d: Keep only the sentences closest to the question, so less context has to be evaluated
+        if (pImpl->config_.compression.enabled) {
+            compressed = pImpl->compressRetrievedContext(query, results);
         }
+#endif
         
-        // Add the user query with context
-        messages.emplace_back("user", context);
+        // Step 2: Build the prompt, keeping only the chunks that fit the context budget
+#ifdef LEAFRA_HAS_LLAMACPP
+        if (prefill.valid() && !prefill.get()) {
+            LEAFRA_DEBUG() << "Prompt prefill failed, the whole prompt is evaluated: " << pImpl->llamacpp_model_->get_last_error();
+        }
+        std::vector<int32_t> prompt_tokens;
+        size_t first_chunk_end = 0;
+        const auto prompt_start = debug::timer::now();
+        if (!pImpl->assembleRagPrompt(query, results, prompt_tokens, &first_chunk_end, !compressed)) {
+            LEAFRA_ERROR() << "Failed to build the LLM prompt: " << pImpl->llamacpp_model_->get_last_error();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+#ifdef LEAFRA_HAS_FAISS
+        if (pImpl->config_.llm.hot_chunk_cache_size > 0 && pImpl->config_.llm.reuse_prompt_cache) {
+            pImpl->useHotChunkState(results, prompt_tokens, first_chunk_end);
+        }
+#endif
+        if (query_stats) {
+            query_stats->prompt_build_ms = debug::timer::elapsed_milliseconds(prompt_start, debug::timer::now());
+            query_stats->context_chunks = static_cast<int32_t>(results.size());
+        }
         
-        // Step 4: Generate response using LLM with streaming
+        // Step 3: Generate response using LLM with streaming
         LEAFRA_DEBUG() << "Starting LLM generation with streaming callback";
         
-#ifdef LEAFRA_HAS_LLAMACPP
-        bool generation_success = pImpl->llamacpp_model_->generate_chat_response_stream(
-            messages, 
-            callback, 
+        // Answers the caller stopped early aren't cached
+        std::string answer;
+        bool stopped = false;
+        token_callback_t generation_callback = callback;
+        if (!answer_key.empty()) {
+            generation_callback = [&callback, &answer, &stopped](const std::string& token, bool is_final) {
+                const bool keep_going = callback(token, is_final);
+                if (!is_final) {
+                    answer += token;
+                    stopped = stopped || !keep_going;
+                }
+                return keep_going;
+            };
+        }
+        if (query_stats) {
+            token_callback_t timed_callback = generation_callback;
+            generation_callback = [timed_callback, query_stats, &budget](const std::string& token, bool is_final) {
+                if (!is_final && query_stats->ttft_ms == 0.0) {
+                    query_stats->ttft_ms = debug::timer::elapsed_milliseconds(budget.start, debug::timer::now());
+                }
+                return timed_callback(token, is_final);
+            };
+        }
+        
+        bool generation_success = pImpl->llamacpp_model_->generate_from_tokens(
+            prompt_tokens, 
+            generation_callback, 
             pImpl->config_.llm.n_predict
         );
         
@@ -1966,9 +12159,23 @@ ResultCode LeafraCore::semantic_search_with_llm(const std::string& query, int ma
             LEAFRA_ERROR() << "LLM generation failed: " << pImpl->llamacpp_model_->get_last_error();
             return ResultCode::ERROR_PROCESSING_FAILED;
         }
+#ifdef LEAFRA_HAS_FAISS
+        if (!answer_key.empty() && !stopped && !answer.empty()) {
+            pImpl->storeCachedAnswer(answer_key, results, std::move(answer_embedding), std::move(answer));
+        }
+#endif
         
         // Log generation statistics
         auto stats = pImpl->llamacpp_model_->get_last_stats();
+        pImpl->recordGenerationMetrics(stats);
+        if (query_stats) {
+            query_stats->prefill_ms = stats.prompt_eval_time;
+            query_stats->decode_ms = stats.generation_time;
+            query_stats->prompt_tokens = stats.prompt_tokens;
+            query_stats->reused_prompt_tokens = stats.reused_prompt_tokens;
+            query_stats->generated_tokens = stats.generated_tokens;
+            query_stats->results = static_cast<int32_t>(results.size());
+        }
         LEAFRA_INFO() << "\n Semantic search with LLM completed successfully";
         LEAFRA_INFO() << "  - Search results: " << results.size();
         LEAFRA_INFO() << "  - Prompt tokens: " << stats.prompt_tokens;
@@ -1976,7 +12183,7 @@ ResultCode LeafraCore::semantic_search_with_llm(const std::string& query, int ma
         LEAFRA_INFO() << "  - Generation time: " << stats.generation_time << "ms";
         LEAFRA_INFO() << "  - Tokens/second: " << stats.tokens_per_second;
         
-        pImpl->send_event("Semantic search with LLM completed - Generated " + std::to_string(stats.generated_tokens) + " tokens");
+        pImpl->send_event(EventType::LLM_STATUS, "Semantic search with LLM completed - Generated " + std::to_string(stats.generated_tokens) + " tokens");
         
         return ResultCode::SUCCESS;
 #endif
@@ -1987,6 +12194,23 @@ ResultCode LeafraCore::semantic_search_with_llm(const std::string& query, int ma
     }
 } //semantic_search_with_llm
 
+#if defined(LEAFRA_HAS_LLAMACPP) && defined(LEAFRA_HAS_FAISS)
+bool LeafraCore::semantic_search_with_llm_async(const std::string& query, int max_results, token_callback_t callback,
+                                                search_completion_t completion) {
+    if (!pImpl->initialized_ || !pImpl->request_pool_ || !callback || !completion) {
+        LEAFRA_ERROR() << "LeafraCore not initialized or no callback given";
+        return false;
+    }
+    Impl* impl = pImpl.get();
+    return pImpl->request_pool_->submit([this, impl, query, max_results, callback, completion]() {
+        std::vector<FaissIndex::SearchResult> results;
+        ResultCode result = impl->requests_cancelled_ ? ResultCode::ERROR_CANCELLED
+                                                      : semantic_search_with_llm(query, max_results, results, callback);
+        completion(result, std::move(results));
+    });
+} //semantic_search_with_llm_async
+#endif
+
 
 
 
@@ -1999,6 +12223,8 @@ ResultCode LeafraCore::llm_inference(const std::string& prompt, std::string& res
         LEAFRA_ERROR() << "LeafraCore not initialized";
         return ResultCode::ERROR_INITIALIZATION_FAILED;
     }
+    ThroughputGovernor::InteractiveScope interactive(pImpl->governor_);
+    pImpl->pollThroughputGovernor();
     
     if (prompt.empty()) {
         LEAFRA_ERROR() << "Empty prompt provided";
@@ -2006,7 +12232,13 @@ ResultCode LeafraCore::llm_inference(const std::string& prompt, std::string& res
     }
 
 #ifdef LEAFRA_HAS_LLAMACPP
-    if (!pImpl->llamacpp_initialized_ || !pImpl->llamacpp_model_) {
+    AdmissionController::Permit permit(pImpl->admission_, AdmissionResource::LLM, AdmissionLane::INTERACTIVE);
+    if (!permit.admitted()) {
+        LEAFRA_WARNING() << "Too many requests waiting for the LLM";
+        return ResultCode::ERROR_BUSY;
+    }
+    std::shared_lock<std::shared_mutex> llm_lock;
+    if (!pImpl->acquireLLM(llm_lock)) {
         LEAFRA_ERROR() << "LlamaCpp not initialized or model not loaded";
         return ResultCode::ERROR_INITIALIZATION_FAILED;
     }
@@ -2023,6 +12255,7 @@ ResultCode LeafraCore::llm_inference(const std::string& prompt, std::string& res
         
         // Log generation statistics
         auto stats = pImpl->llamacpp_model_->get_last_stats();
+        pImpl->recordGenerationMetrics(stats);
         LEAFRA_INFO() << "LLM inference completed successfully";
         LEAFRA_INFO() << "  - Prompt tokens: " << stats.prompt_tokens;
         LEAFRA_INFO() << "  - Generated tokens: " << stats.generated_tokens;
@@ -2030,7 +12263,7 @@ ResultCode LeafraCore::llm_inference(const std::string& prompt, std::string& res
         LEAFRA_INFO() << "  - Generation time: " << stats.generation_time << "ms";
         LEAFRA_INFO() << "  - Tokens/second: " << stats.tokens_per_second;
         
-        pImpl->send_event("LLM inference completed - Generated " + std::to_string(stats.generated_tokens) + " tokens");
+        pImpl->send_event(EventType::LLM_STATUS, "LLM inference completed - Generated " + std::to_string(stats.generated_tokens) + " tokens");
         
         return ResultCode::SUCCESS;
         
@@ -2044,4 +12277,153 @@ ResultCode LeafraCore::llm_inference(const std::string& prompt, std::string& res
 #endif
 } //llm_inference
 
+ResultCode LeafraCore::save_llm_session(const std::string& path) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+    if (path.empty()) {
+        LEAFRA_ERROR() << "Empty session path provided";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+
+#ifdef LEAFRA_HAS_LLAMACPP
+    std::shared_lock<std::shared_mutex> llm_lock;
+    if (!pImpl->acquireLLM(llm_lock)) {
+        LEAFRA_ERROR() << "LlamaCpp not initialized or model not loaded";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+    if (!pImpl->llamacpp_model_->save_session(path)) {
+        LEAFRA_ERROR() << "Failed to save LLM session: " << pImpl->llamacpp_model_->get_last_error();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    
+    LEAFRA_INFO() << "💾 LLM session saved: " << path;
+    return ResultCode::SUCCESS;
+#else
+    LEAFRA_ERROR() << "LlamaCpp support not compiled";
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+} //save_llm_session
+
+ResultCode LeafraCore::load_llm_session(const std::string& path) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+    if (path.empty()) {
+        LEAFRA_ERROR() << "Empty session path provided";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+
+#ifdef LEAFRA_HAS_LLAMACPP
+    std::shared_lock<std::shared_mutex> llm_lock;
+    if (!pImpl->acquireLLM(llm_lock)) {
+        LEAFRA_ERROR() << "LlamaCpp not initialized or model not loaded";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+    if (!pImpl->llamacpp_model_->load_session(path)) {
+        LEAFRA_ERROR() << "Failed to load LLM session: " << pImpl->llamacpp_model_->get_last_error();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    
+    LEAFRA_INFO() << "✅ LLM session restored: " << path << " (" << pImpl->llamacpp_model_->get_context_used() << " tokens)";
+    return ResultCode::SUCCESS;
+#else
+    LEAFRA_ERROR() << "LlamaCpp support not compiled";
+    return ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+} //load_llm_session
+
+ResultCode LeafraCore::unload_llm() {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+    pImpl->waitForEngines();
+    std::unique_lock<std::shared_mutex> exclusive(pImpl->llm_mutex_);
+    if (!pImpl->llamacpp_initialized_) {
+        return ResultCode::SUCCESS;
+    }
+    pImpl->unloadLLM();
+    LEAFRA_INFO() << "💤 LLM unloaded";
+    pImpl->send_event(EventType::LLM_STATUS, "LLM unloaded");
+    return ResultCode::SUCCESS;
+} //unload_llm
+
+ResultCode LeafraCore::reload_llm() {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+    if (!pImpl->config_.llm.enabled) {
+        LEAFRA_ERROR() << "LLM not enabled in configuration";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    pImpl->waitForEngines();
+    std::unique_lock<std::shared_mutex> exclusive(pImpl->llm_mutex_);
+    pImpl->unloadLLM();
+    ResultCode result = pImpl->loadLLM();
+    pImpl->send_event(EventType::LLM_STATUS, result == ResultCode::SUCCESS ? "LLM reloaded" : "Failed to reload LLM");
+    return result;
+} //reload_llm
+
+ResultCode LeafraCore::swap_llm(const LLMConfig& llm_config) {
+    if (!pImpl->initialized_) {
+        LEAFRA_ERROR() << "LeafraCore not initialized";
+        return ResultCode::ERROR_INITIALIZATION_FAILED;
+    }
+    
+    if (!llm_config.is_valid()) {
+        LEAFRA_ERROR() << "Invalid LLM configuration for swap";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    pImpl->waitForEngines();
+    std::unique_lock<std::shared_mutex> exclusive(pImpl->llm_mutex_);
+    const LLMConfig previous = pImpl->config_.llm;
+    const int32_t previous_threads = pImpl->configured_llm_threads_;
+    const int32_t previous_batch_threads = pImpl->configured_llm_batch_threads_;
+    
+    // Only one model is resident at a time - the point is to free memory, not to double it
+    pImpl->unloadLLM();
+    pImpl->config_.llm = llm_config;
+    pImpl->applyDeviceProfile(pImpl->config_);
+    ResultCode result = pImpl->loadLLM();
+    if (result != ResultCode::SUCCESS) {
+        LEAFRA_WARNING() << "⚠️  Failed to swap to " << llm_config.model_path << ", restoring " << previous.model_path;
+        pImpl->config_.llm = previous;
+        pImpl->configured_llm_threads_ = previous_threads;
+        pImpl->configured_llm_batch_threads_ = previous_batch_threads;
+        if (pImpl->loadLLM() != ResultCode::SUCCESS) {
+            pImpl->llm_unloaded_ = true;
+        }
+        return result;
+    }
+    
+    LEAFRA_INFO() << "🔀 LLM swapped to " << llm_config.get_model_filename();
+    pImpl->send_event(EventType::LLM_STATUS, "LLM swapped to " + llm_config.get_model_filename());
+    return ResultCode::SUCCESS;
+} //swap_llm
+
+void LeafraCore::handle_memory_pressure(MemoryPressure pressure) {
+    if (!pImpl->initialized_) {
+        return;
+    }
+    
+    // Moderate pressure leaves the models in place
+    const ReclaimPriority max_priority = pressure == MemoryPressure::CRITICAL ? ReclaimPriority::MODEL : ReclaimPriority::WARM_STATE;
+    const uint64_t freed = MemoryAccountant::instance().reclaim(UINT64_MAX, max_priority);
+    pImpl->pollMemoryUsage();
+    LEAFRA_WARNING() << "⚠️  " << (pressure == MemoryPressure::CRITICAL ? "Critical" : "Moderate") << " memory pressure - reclaimed "
+                     << (freed / 1024) << " KB";
+} //handle_memory_pressure
+
 } // namespace leafra 
\ No newline at end of file
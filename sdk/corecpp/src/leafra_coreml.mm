@@ -2,19 +2,197 @@
 #import <CoreML/CoreML.h>
 #include "leafra/leafra_coreml.h"
 #include "leafra/logger.h"
+#include "leafra/leafra_trace.h"
+#include "leafra/leafra_vector_codec.h"
+#include "leafra/leafra_simd.h"
+#include "leafra/leafra_hash.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 
 namespace leafra {
 
+// MLMultiArrays wrapping one set of caller buffers, kept for the next predict_into with the same buffers
+struct CoreMLBinding {
+    std::vector<const void*> inputs;
+    std::vector<size_t> input_sizes;
+    std::vector<void*> outputs;
+    MLDictionaryFeatureProvider* provider = nil;   // Wraps the input buffers (retained)
+    MLPredictionOptions* options = nil;            // outputBackings over the output buffers, if supported (retained)
+    bool output_backings = false;
+};
+
 // Internal implementation struct
 struct CoreMLModelImpl {
     MLModel* model;
     MLPredictionOptions* predictionOptions;
     NSString* modelPath;
     NSString* computeUnits;
+    std::vector<std::vector<NSInteger> > outputShapes;  // Declared shape per output (alphabetical order)
+    std::vector<CoreMLBinding> bindings;                // Most recently created last
+    
+    // Reused by predict_into (buffers bound this call, and conversions for buffers not in the model's type)
+    std::vector<const void*> boundInputs;
+    std::vector<size_t> boundInputSizes;
+    std::vector<void*> boundOutputs;
+    std::vector<std::vector<uint8_t> > inputScratch;
+    std::vector<std::vector<uint8_t> > outputScratch;
 };
 
+namespace {
+
+constexpr size_t kMaxCachedBindings = 8;  // One per sequence bucket is typical
+
+void releaseBinding(CoreMLBinding& binding) {
+    [binding.provider release];
+    [binding.options release];
+    binding.provider = nil;
+    binding.options = nil;
+}
+
+void releaseImpl(CoreMLModelImpl* impl) {
+    // Release the retained MLModel object
+    [impl->model release];
+    
+    // Release other Objective-C objects (no ARC in this codebase)
+    [impl->predictionOptions release];
+    for (CoreMLBinding& binding : impl->bindings) {
+        releaseBinding(binding);
+    }
+    impl->bindings.clear();
+    impl->model = nil;
+    impl->predictionOptions = nil;
+    delete impl;
+}
+
+// Row-major strides of a shape
+NSArray<NSNumber*>* stridesForShape(const std::vector<NSInteger>& shape) {
+    NSMutableArray<NSNumber*>* strides = [NSMutableArray arrayWithCapacity:shape.size()];
+    NSInteger stride = 1;
+    for (size_t i = shape.size(); i-- > 0;) {
+        [strides insertObject:@(stride) atIndex:0];
+        stride *= shape[i];
+    }
+    return strides;
+}
+
+using DataType = CoreMLModel::DataType;
+
+DataType fromMLDataType(MLMultiArrayDataType type) {
+    switch (type) {
+        case MLMultiArrayDataTypeDouble: return DataType::Float64;
+        case MLMultiArrayDataTypeInt32: return DataType::Int32;
+        case MLMultiArrayDataTypeFloat32: return DataType::Float32;
+        default: break;
+    }
+    if (@available(macOS 12.0, iOS 15.0, *)) {
+        if (type == MLMultiArrayDataTypeFloat16) {
+            return DataType::Float16;
+        }
+    }
+    return DataType::Float32;
+}
+
+MLMultiArrayDataType toMLDataType(DataType type) {
+    switch (type) {
+        case DataType::Float64: return MLMultiArrayDataTypeDouble;
+        case DataType::Int32: return MLMultiArrayDataTypeInt32;
+        case DataType::Float16:
+            if (@available(macOS 12.0, iOS 15.0, *)) {
+                return MLMultiArrayDataTypeFloat16;
+            }
+            break;
+        case DataType::Float32: break;
+    }
+    return MLMultiArrayDataTypeFloat32;
+}
+
+double loadElement(const void* data, DataType type, size_t index) {
+    switch (type) {
+        case DataType::Float32: return static_cast<const float*>(data)[index];
+        case DataType::Float16: return VectorCodec::half_to_float(static_cast<const uint16_t*>(data)[index]);
+        case DataType::Int32: return static_cast<const int32_t*>(data)[index];
+        case DataType::Float64: return static_cast<const double*>(data)[index];
+    }
+    return 0.0;
+}
+
+void storeElement(void* data, DataType type, size_t index, double value) {
+    switch (type) {
+        case DataType::Float32: static_cast<float*>(data)[index] = static_cast<float>(value); break;
+        case DataType::Float16: static_cast<uint16_t*>(data)[index] = VectorCodec::float_to_half(static_cast<float>(value)); break;
+        case DataType::Int32: static_cast<int32_t*>(data)[index] = static_cast<int32_t>(std::lround(value)); break;
+        case DataType::Float64: static_cast<double*>(data)[index] = value; break;
+    }
+}
+
+// Copy count elements, converting between element types (Float16 <-> Float32 is the common case)
+void convertElements(const void* src, DataType src_type, void* dst, DataType dst_type, size_t count) {
+    if (src_type == dst_type) {
+        memcpy(dst, src, count * CoreMLModel::getDataTypeSize(src_type));
+        return;
+    }
+    if (src_type == DataType::Float16 && dst_type == DataType::Float32) {
+        simd::half_to_float(static_cast<const uint16_t*>(src), static_cast<float*>(dst), count);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        storeElement(dst, dst_type, i, loadElement(src, src_type, i));
+    }
+}
+
+NSArray<NSNumber*>* shapeArray(const std::vector<NSInteger>& shape) {
+    NSMutableArray<NSNumber*>* array = [NSMutableArray arrayWithCapacity:shape.size()];
+    for (NSInteger dim : shape) {
+        [array addObject:@(dim)];
+    }
+    return array;
+}
+
+// Content hash of a model file or package (relative path and bytes of every file, in sorted order)
+bool hashModelSource(NSString* path, std::string& digest) {
+    NSFileManager* fileManager = [NSFileManager defaultManager];
+    BOOL isDirectory = NO;
+    if (![fileManager fileExistsAtPath:path isDirectory:&isDirectory]) {
+        return false;
+    }
+    if (!isDirectory) {
+        return ContentHasher::hash_file([path fileSystemRepresentation], digest);
+    }
+    NSArray<NSString*>* subpaths = [[fileManager subpathsOfDirectoryAtPath:path error:nil] sortedArrayUsingSelector:@selector(compare:)];
+    ContentHasher hasher;
+    for (NSString* subpath in subpaths) {
+        NSString* filePath = [path stringByAppendingPathComponent:subpath];
+        BOOL isSubdirectory = NO;
+        if (![fileManager fileExistsAtPath:filePath isDirectory:&isSubdirectory] || isSubdirectory) {
+            continue;
+        }
+        std::string fileDigest;
+        if (!ContentHasher::hash_file([filePath fileSystemRepresentation], fileDigest)) {
+            return false;
+        }
+        hasher.update([subpath UTF8String]);
+        hasher.update(fileDigest);
+    }
+    digest = hasher.hex_digest();
+    return true;
+}
+
+// Remove compiled copies of the same model other than keepName (older model versions or OS versions)
+void pruneCompiledModels(NSString* cacheDirectory, NSString* prefix, NSString* keepName) {
+    NSFileManager* fileManager = [NSFileManager defaultManager];
+    for (NSString* name in [fileManager contentsOfDirectoryAtPath:cacheDirectory error:nil]) {
+        if ([name hasPrefix:prefix] && ![name isEqualToString:keepName]) {
+            [fileManager removeItemAtPath:[cacheDirectory stringByAppendingPathComponent:name] error:nil];
+        }
+    }
+}
+
+} // namespace
+
 } // namespace leafra
 
 // C++ Class Implementation
@@ -31,6 +209,89 @@ const char* CoreMLModel::computeUnitsToString(ComputeUnits units) {
     }
 }
 
+size_t CoreMLModel::getDataTypeSize(DataType type) {
+    switch (type) {
+        case DataType::Float16: return 2;
+        case DataType::Int32: return 4;
+        case DataType::Float64: return 8;
+        case DataType::Float32: return 4;
+    }
+    return 4;
+}
+
+std::string CoreMLModel::compileModel(const std::string& model_path, const std::string& cache_dir) {
+    @autoreleasepool {
+        NSString* sourcePath = [NSString stringWithUTF8String:model_path.c_str()];
+        if ([[[sourcePath pathExtension] lowercaseString] isEqualToString:@"mlmodelc"]) {
+            return model_path;
+        }
+        NSFileManager* fileManager = [NSFileManager defaultManager];
+        
+        // Compiled models depend on the CoreML compiler, which ships with the OS
+        NSString* cacheDirectory = nil;
+        NSString* cachedName = nil;
+        NSString* prefix = [[[sourcePath lastPathComponent] stringByDeletingPathExtension] stringByAppendingString:@"-"];
+        if (!cache_dir.empty()) {
+            std::string digest;
+            if (hashModelSource(sourcePath, digest)) {
+                NSOperatingSystemVersion os = [[NSProcessInfo processInfo] operatingSystemVersion];
+                cacheDirectory = [NSString stringWithUTF8String:cache_dir.c_str()];
+                cachedName = [NSString stringWithFormat:@"%@%s-os%ld.%ld.%ld.mlmodelc", prefix, digest.c_str(),
+                              (long)os.majorVersion, (long)os.minorVersion, (long)os.patchVersion];
+                NSString* cachedPath = [cacheDirectory stringByAppendingPathComponent:cachedName];
+                if ([fileManager fileExistsAtPath:cachedPath]) {
+                    LEAFRA_INFO() << "CoreML compiled model reused: " << [cachedPath UTF8String];
+                    return [cachedPath UTF8String];
+                }
+            } else {
+                LEAFRA_WARNING() << "Failed to hash CoreML model " << model_path << " - compiling without the cache";
+            }
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        NSError* error = nil;
+        NSURL* compiledURL = [MLModel compileModelAtURL:[NSURL fileURLWithPath:sourcePath] error:&error];
+        if (!compiledURL) {
+            LEAFRA_ERROR() << "Failed to compile CoreML model " << model_path << ": "
+                           << (error ? [[error localizedDescription] UTF8String] : "Unknown error");
+            return "";
+        }
+        LEAFRA_INFO() << "CoreML model compiled in "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms";
+        if (!cachedName) {
+            return [[compiledURL path] UTF8String];
+        }
+        
+        // compileModelAtURL writes to a temporary directory the system may purge: move the result into the cache
+        NSString* cachedPath = [cacheDirectory stringByAppendingPathComponent:cachedName];
+        [fileManager createDirectoryAtPath:cacheDirectory withIntermediateDirectories:YES attributes:nil error:nil];
+        if (![fileManager moveItemAtPath:[compiledURL path] toPath:cachedPath error:&error]) {
+            if (![fileManager fileExistsAtPath:cachedPath]) {
+                LEAFRA_WARNING() << "Failed to cache compiled CoreML model: " << [[error localizedDescription] UTF8String];
+                return [[compiledURL path] UTF8String];
+            }
+            // Another instance (e.g. the query instance) moved its copy in first
+            [fileManager removeItemAtPath:[compiledURL path] error:nil];
+        }
+        [[NSURL fileURLWithPath:cacheDirectory] setResourceValue:@YES forKey:NSURLIsExcludedFromBackupKey error:nil];
+        pruneCompiledModels(cacheDirectory, prefix, cachedName);
+        LEAFRA_INFO() << "CoreML compiled model cached: " << [cachedPath UTF8String];
+        return [cachedPath UTF8String];
+    }
+}
+
+std::string CoreMLModel::defaultCompiledModelCacheDirectory() {
+    @autoreleasepool {
+        NSArray<NSURL*>* urls = [[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask];
+        if ([urls count] == 0) {
+            return "";
+        }
+        NSURL* directory = [[[urls firstObject] URLByAppendingPathComponent:@"LeafraSDK" isDirectory:YES]
+                            URLByAppendingPathComponent:@"CoreMLCache" isDirectory:YES];
+        return [[directory path] UTF8String];
+    }
+}
+
 // Constructor
 CoreMLModel::CoreMLModel(const std::string& model_path, ComputeUnits compute_units)
     : model_ptr_(nullptr), cached_input_nsnames_(nullptr), cached_output_nsnames_(nullptr) {
@@ -122,6 +383,9 @@ void CoreMLModel::cacheModelMetadata() {
         
         input_names_.clear();
         input_sizes_.clear();
+        input_types_.clear();
+        input_enumerated_sizes_.clear();
+        input_size_ranges_.clear();
         input_names_.reserve([inputNames count]);
         input_sizes_.reserve([inputNames count]);
         
@@ -132,17 +396,48 @@ void CoreMLModel::cacheModelMetadata() {
             // Cache input size
             MLFeatureDescription* inputDescription = inputDescriptions[inputName];
             size_t input_size = 0;
+            std::vector<size_t> enumerated_sizes;
+            std::pair<size_t, size_t> size_range(0, 0);
+            DataType input_type = DataType::Float32;
             
             if (inputDescription.type == MLFeatureTypeMultiArray) {
                 MLMultiArrayConstraint* constraint = inputDescription.multiArrayConstraint;
+                input_type = fromMLDataType(constraint.dataType);
                 NSInteger size = 1;
                 for (NSNumber* dim in constraint.shape) {
                     size *= [dim integerValue];
                 }
                 input_size = size;
+                
+                // Flexible shapes (e.g. sequence length buckets 64/128/256/512) - element counts per sample
+                MLMultiArrayShapeConstraint* shapeConstraint = constraint.shapeConstraint;
+                if (shapeConstraint.type == MLMultiArrayShapeConstraintTypeEnumerated) {
+                    for (NSArray<NSNumber*>* shape in shapeConstraint.enumeratedShapes) {
+                        NSInteger elements = 1;
+                        for (NSNumber* dim in shape) {
+                            elements *= [dim integerValue];
+                        }
+                        enumerated_sizes.push_back(static_cast<size_t>(elements));
+                    }
+                    std::sort(enumerated_sizes.begin(), enumerated_sizes.end());
+                    enumerated_sizes.erase(std::unique(enumerated_sizes.begin(), enumerated_sizes.end()), enumerated_sizes.end());
+                } else if (shapeConstraint.type == MLMultiArrayShapeConstraintTypeRange && [constraint.shape count] > 0) {
+                    // Only the last (sequence) dimension is treated as flexible; leading dims keep their default
+                    NSUInteger last_dim = [constraint.shape count] - 1;
+                    NSRange range = [shapeConstraint.sizeRangeForDimension[last_dim] rangeValue];
+                    size_t default_length = static_cast<size_t>(std::max<NSInteger>(1, [constraint.shape[last_dim] integerValue]));
+                    size_t leading = input_size / default_length;
+                    size_t min_length = std::max<size_t>(1, range.location);
+                    // Unbounded ranges report a huge length - cap them at the default shape
+                    size_t max_length = range.length > static_cast<NSUInteger>(INT32_MAX) ? default_length : range.location + range.length;
+                    size_range = std::make_pair(leading * min_length, leading * std::max(min_length, max_length));
+                }
             }
             
             input_sizes_.push_back(input_size);
+            input_types_.push_back(input_type);
+            input_enumerated_sizes_.push_back(std::move(enumerated_sizes));
+            input_size_ranges_.push_back(size_range);
         }
         
         // Cache output metadata
@@ -154,6 +449,8 @@ void CoreMLModel::cacheModelMetadata() {
         
         output_names_.clear();
         output_sizes_.clear();
+        output_types_.clear();
+        impl->outputShapes.clear();
         output_names_.reserve([outputNames count]);
         output_sizes_.reserve([outputNames count]);
         
@@ -165,16 +462,23 @@ void CoreMLModel::cacheModelMetadata() {
             MLFeatureDescription* outputDescription = outputDescriptions[outputName];
             size_t output_size = 0;
             
+            std::vector<NSInteger> output_shape;
+            DataType output_type = DataType::Float32;
+            
             if (outputDescription.type == MLFeatureTypeMultiArray) {
                 MLMultiArrayConstraint* constraint = outputDescription.multiArrayConstraint;
+                output_type = fromMLDataType(constraint.dataType);
                 NSInteger size = 1;
                 for (NSNumber* dim in constraint.shape) {
                     size *= [dim integerValue];
+                    output_shape.push_back([dim integerValue]);
                 }
                 output_size = size;
             }
             
             output_sizes_.push_back(output_size);
+            output_types_.push_back(output_type);
+            impl->outputShapes.push_back(std::move(output_shape));
         }
         
         // Cache model description
@@ -189,17 +493,7 @@ void CoreMLModel::cacheModelMetadata() {
 CoreMLModel::~CoreMLModel() {
     if (model_ptr_) {
         @autoreleasepool {
-            CoreMLModelImpl* impl = static_cast<CoreMLModelImpl*>(model_ptr_);
-            
-            // Release the retained MLModel object
-            [impl->model release];
-            
-            // Release other Objective-C objects (no ARC in this codebase)
-            [impl->predictionOptions release];
-            impl->model = nil;
-            impl->predictionOptions = nil;
-            
-            delete impl;
+            releaseImpl(static_cast<CoreMLModelImpl*>(model_ptr_));
             model_ptr_ = nullptr;
         }
     }
@@ -220,6 +514,8 @@ CoreMLModel::CoreMLModel(CoreMLModel&& other) noexcept
     : model_ptr_(other.model_ptr_), cached_input_nsnames_(other.cached_input_nsnames_), cached_output_nsnames_(other.cached_output_nsnames_),
       input_names_(std::move(other.input_names_)), input_sizes_(std::move(other.input_sizes_)),
       output_names_(std::move(other.output_names_)), output_sizes_(std::move(other.output_sizes_)),
+      input_types_(std::move(other.input_types_)), output_types_(std::move(other.output_types_)),
+      input_enumerated_sizes_(std::move(other.input_enumerated_sizes_)), input_size_ranges_(std::move(other.input_size_ranges_)),
       model_description_(std::move(other.model_description_)) {
     other.model_ptr_ = nullptr;
     other.cached_input_nsnames_ = nullptr;
@@ -231,16 +527,7 @@ CoreMLModel& CoreMLModel::operator=(CoreMLModel&& other) noexcept {
     if (this != &other) {
         if (model_ptr_) {
             @autoreleasepool {
-                CoreMLModelImpl* impl = static_cast<CoreMLModelImpl*>(model_ptr_);
-                
-                // Release the retained MLModel object
-                [impl->model release];
-                
-                // Release other Objective-C objects (no ARC in this codebase) 
-                [impl->predictionOptions release];
-                impl->model = nil;
-                impl->predictionOptions = nil;
-                delete impl;
+                releaseImpl(static_cast<CoreMLModelImpl*>(model_ptr_));
             }
         }
         
@@ -259,6 +546,10 @@ CoreMLModel& CoreMLModel::operator=(CoreMLModel&& other) noexcept {
         input_sizes_ = std::move(other.input_sizes_);
         output_names_ = std::move(other.output_names_);
         output_sizes_ = std::move(other.output_sizes_);
+        input_types_ = std::move(other.input_types_);
+        output_types_ = std::move(other.output_types_);
+        input_enumerated_sizes_ = std::move(other.input_enumerated_sizes_);
+        input_size_ranges_ = std::move(other.input_size_ranges_);
         model_description_ = std::move(other.model_description_);
         other.model_ptr_ = nullptr;
         other.cached_input_nsnames_ = nullptr;
@@ -279,6 +570,33 @@ std::string CoreMLModel::getDescription() const {
 
 // All introspection methods now use cached data (implemented as inline functions in header)
 
+std::vector<size_t> CoreMLModel::getSupportedInputSizes(size_t index) const {
+    if (index >= input_sizes_.size()) {
+        return {};
+    }
+    if (!input_enumerated_sizes_[index].empty()) {
+        return input_enumerated_sizes_[index];
+    }
+    if (isInputSizeRange(index)) {
+        return {input_size_ranges_[index].first, input_size_ranges_[index].second};
+    }
+    return {input_sizes_[index]};
+}
+
+bool CoreMLModel::isInputSizeSupported(size_t index, size_t size) const {
+    if (index >= input_sizes_.size()) {
+        return false;
+    }
+    if (size == input_sizes_[index]) {
+        return true;
+    }
+    const auto& enumerated = input_enumerated_sizes_[index];
+    if (!enumerated.empty()) {
+        return std::binary_search(enumerated.begin(), enumerated.end(), size);
+    }
+    return isInputSizeRange(index) && size >= input_size_ranges_[index].first && size <= input_size_ranges_[index].second;
+}
+
 // Optimized prediction using cached metadata
 // !! Expects inputs and outpus in alphabetical order of their names !!
 std::vector<std::vector<float> > CoreMLModel::predict(const std::vector<std::vector<float> >& inputs,
@@ -390,41 +708,49 @@ bool CoreMLModel::predict(const std::vector<std::vector<float> >& inputs,
         for (size_t i = 0; i < num_inputs; i++) {
             NSString* inputName = cachedInputNames[i];
             
-            // Verify input size matches cached expected size
-            if (inputs[i].size() != input_sizes_[i]) {
+            // Verify input size matches cached expected size (or one of the flexible sizes)
+            if (!isInputSizeSupported(i, inputs[i].size())) {
                 LEAFRA_ERROR() << "Input[" << i << "] size mismatch: expected " << input_sizes_[i] << ", got " << inputs[i].size();
+                [inputFeatures release];
                 return false;
             }
             
-            // Create MLMultiArray directly using cached size (no model queries needed!)
-            NSArray<NSNumber*>* shape = @[@1, @(input_sizes_[i])];  // 2D tensor: [batch_size=1, sequence_length]
+            // Create MLMultiArray directly using the sample size (no model queries needed!)
+            NSArray<NSNumber*>* shape = @[@1, @(inputs[i].size())];  // 2D tensor: [batch_size=1, sequence_length]
             MLMultiArray* inputArray = [[MLMultiArray alloc] initWithShape:shape
-                                                                  dataType:MLMultiArrayDataTypeFloat32
+                                                                  dataType:toMLDataType(input_types_[i])
                                                                      error:&error];
             if (error) {
                 LEAFRA_ERROR() << "Failed to create input array[" << i << "]: " << [[error localizedDescription] UTF8String];
+                [inputArray release];
+                [inputFeatures release];
                 return false;
             }
             
-            // Copy input data
-            float* arrayData = (float*)[inputArray dataPointer];
-            memcpy(arrayData, inputs[i].data(), inputs[i].size() * sizeof(float));
+            // Copy input data (converted to the model's element type)
+            convertElements(inputs[i].data(), DataType::Float32, [inputArray dataPointer], input_types_[i], inputs[i].size());
             
             inputFeatures[inputName] = [MLFeatureValue featureValueWithMultiArray:inputArray];
+            [inputArray release];
         }
         
         // Create feature provider
         MLDictionaryFeatureProvider* featureProvider = [[MLDictionaryFeatureProvider alloc] 
             initWithDictionary:inputFeatures error:&error];
+        [inputFeatures release];
         if (error) {
             LEAFRA_ERROR() << "Failed to create feature provider: " << [[error localizedDescription] UTF8String];
+            [featureProvider release];
             return false;
         }
         
         // Perform prediction
+        trace::Span predict_span("coreml", "predict");
         id<MLFeatureProvider> prediction = [model predictionFromFeatures:featureProvider
                                                                  options:impl->predictionOptions
                                                                    error:&error];
+        predict_span.end();
+        [featureProvider release];
         if (error) {
             LEAFRA_ERROR() << "Prediction failed: " << [[error localizedDescription] UTF8String];
             return false;
@@ -473,9 +799,8 @@ bool CoreMLModel::predict(const std::vector<std::vector<float> >& inputs,
                 // Direct memory copy works for both [1, N] and [N] tensor shapes
                 // since memory layout is identical (contiguous elements)
                 
-                // Copy output data
-                float* arrayData = (float*)[outputArray dataPointer];
-                memcpy(outputs[i].data(), arrayData, outputs[i].size() * sizeof(float));
+                // Copy output data (Float16 / Int32 / Double outputs converted to float)
+                convertElements([outputArray dataPointer], fromMLDataType(outputArray.dataType), outputs[i].data(), DataType::Float32, outputs[i].size());
                 
             } else {
                 LEAFRA_ERROR() << "Unsupported output type for output[" << i << "]: " << (int)outputFeature.type;
@@ -491,4 +816,344 @@ bool CoreMLModel::predict(const std::vector<std::vector<float> >& inputs,
     }
 }
 
-} // namespace leafra 
\ No newline at end of file
+// Zero-copy prediction over caller-owned Float32 buffers
+// !! Expects inputs and outpus in alphabetical order of their names !!
+bool CoreMLModel::predict_into(const std::vector<const float*>& inputs, const std::vector<size_t>& input_sizes,
+                               const std::vector<float*>& outputs) {
+    if (inputs.size() != input_sizes.size()) {
+        LEAFRA_ERROR() << "Input sizes count (" << input_sizes.size() << ") doesn't match inputs count (" << inputs.size() << ")";
+        return false;
+    }
+    std::vector<InputBuffer> input_buffers(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        input_buffers[i].data = inputs[i];
+        input_buffers[i].size = input_sizes[i];
+    }
+    std::vector<OutputBuffer> output_buffers(outputs.size());
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        output_buffers[i].data = outputs[i];
+    }
+    return predict_into(input_buffers, output_buffers);
+} //predict_into
+
+// Zero-copy prediction over caller-owned buffers of any supported element type
+// !! Expects inputs and outpus in alphabetical order of their names !!
+bool CoreMLModel::predict_into(const std::vector<InputBuffer>& inputs, const std::vector<OutputBuffer>& outputs) {
+    if (!model_ptr_) return false;
+    
+    CoreMLModelImpl* impl = static_cast<CoreMLModelImpl*>(model_ptr_);
+    if (!impl->model) return false;
+    
+    size_t num_inputs = input_names_.size();
+    size_t num_outputs = output_names_.size();
+    if (inputs.size() != num_inputs) {
+        LEAFRA_ERROR() << "Input count mismatch: model expects " << num_inputs << ", got " << inputs.size();
+        return false;
+    }
+    if (outputs.size() != num_outputs) {
+        LEAFRA_ERROR() << "Output count mismatch: model produces " << num_outputs << ", got " << outputs.size() << " buffers";
+        return false;
+    }
+    for (size_t i = 0; i < num_inputs; ++i) {
+        if (!inputs[i].data || !isInputSizeSupported(i, inputs[i].size)) {
+            LEAFRA_ERROR() << "Input[" << i << "] size mismatch: expected " << input_sizes_[i] << ", got " << inputs[i].size;
+            return false;
+        }
+    }
+    for (size_t i = 0; i < num_outputs; ++i) {
+        if (!outputs[i].data) {
+            LEAFRA_ERROR() << "Output[" << i << "] buffer is null";
+            return false;
+        }
+    }
+    
+    // Buffers already in the model's element type are bound directly; others go through scratch buffers
+    impl->boundInputs.resize(num_inputs);
+    impl->boundInputSizes.resize(num_inputs);
+    impl->boundOutputs.resize(num_outputs);
+    impl->inputScratch.resize(num_inputs);
+    impl->outputScratch.resize(num_outputs);
+    for (size_t i = 0; i < num_inputs; ++i) {
+        impl->boundInputSizes[i] = inputs[i].size;
+        if (inputs[i].type == input_types_[i]) {
+            impl->boundInputs[i] = inputs[i].data;
+            continue;
+        }
+        std::vector<uint8_t>& scratch = impl->inputScratch[i];
+        scratch.resize(std::max(scratch.size(), inputs[i].size * getDataTypeSize(input_types_[i])));
+        convertElements(inputs[i].data, inputs[i].type, scratch.data(), input_types_[i], inputs[i].size);
+        impl->boundInputs[i] = scratch.data();
+    }
+    for (size_t i = 0; i < num_outputs; ++i) {
+        if (outputs[i].type == output_types_[i]) {
+            impl->boundOutputs[i] = outputs[i].data;
+            continue;
+        }
+        std::vector<uint8_t>& scratch = impl->outputScratch[i];
+        scratch.resize(output_sizes_[i] * getDataTypeSize(output_types_[i]));
+        impl->boundOutputs[i] = scratch.data();
+    }
+    
+    @autoreleasepool {
+        NSError* error = nil;
+        
+        // Reuse the wrappers built for these buffers last time
+        CoreMLBinding* binding = nullptr;
+        for (CoreMLBinding& candidate : impl->bindings) {
+            if (candidate.inputs == impl->boundInputs && candidate.input_sizes == impl->boundInputSizes && candidate.outputs == impl->boundOutputs) {
+                binding = &candidate;
+                break;
+            }
+        }
+        
+        if (!binding) {
+            NSArray<NSString*>* cachedInputNames = (__bridge NSArray<NSString*>*)cached_input_nsnames_;
+            NSArray<NSString*>* cachedOutputNames = (__bridge NSArray<NSString*>*)cached_output_nsnames_;
+            
+            // Inputs: [1, size] views of the bound buffers (CoreML only reads them)
+            NSMutableDictionary<NSString*, MLFeatureValue*>* features = [NSMutableDictionary dictionaryWithCapacity:num_inputs];
+            for (size_t i = 0; i < num_inputs; ++i) {
+                std::vector<NSInteger> shape = {1, static_cast<NSInteger>(impl->boundInputSizes[i])};
+                MLMultiArray* inputArray = [[MLMultiArray alloc] initWithDataPointer:const_cast<void*>(impl->boundInputs[i])
+                                                                               shape:shapeArray(shape)
+                                                                            dataType:toMLDataType(input_types_[i])
+                                                                             strides:stridesForShape(shape)
+                                                                         deallocator:nil
+                                                                               error:&error];
+                if (error || !inputArray) {
+                    LEAFRA_ERROR() << "Failed to wrap input buffer[" << i << "]: " << (error ? [[error localizedDescription] UTF8String] : "unknown error");
+                    [inputArray release];
+                    return false;
+                }
+                features[cachedInputNames[i]] = [MLFeatureValue featureValueWithMultiArray:inputArray];
+                [inputArray release];
+            }
+            
+            CoreMLBinding created;
+            created.inputs = impl->boundInputs;
+            created.input_sizes = impl->boundInputSizes;
+            created.outputs = impl->boundOutputs;
+            created.provider = [[MLDictionaryFeatureProvider alloc] initWithDictionary:features error:&error];
+            if (error || !created.provider) {
+                LEAFRA_ERROR() << "Failed to create feature provider: " << (error ? [[error localizedDescription] UTF8String] : "unknown error");
+                releaseBinding(created);
+                return false;
+            }
+            
+            // Outputs: CoreML writes straight into the bound buffers
+            if (@available(macOS 13.0, iOS 16.0, *)) {
+                NSMutableDictionary<NSString*, id>* backings = [NSMutableDictionary dictionaryWithCapacity:num_outputs];
+                for (size_t i = 0; i < num_outputs && error == nil; ++i) {
+                    const std::vector<NSInteger>& shape = impl->outputShapes[i];
+                    if (shape.empty() || output_sizes_[i] == 0) {
+                        break;
+                    }
+                    MLMultiArray* outputArray = [[MLMultiArray alloc] initWithDataPointer:impl->boundOutputs[i]
+                                                                                    shape:shapeArray(shape)
+                                                                                 dataType:toMLDataType(output_types_[i])
+                                                                                  strides:stridesForShape(shape)
+                                                                              deallocator:nil
+                                                                                    error:&error];
+                    if (outputArray) {
+                        backings[cachedOutputNames[i]] = outputArray;
+                        [outputArray release];
+                    }
+                }
+                if (error == nil && [backings count] == num_outputs) {
+                    created.options = [[MLPredictionOptions alloc] init];
+                    created.options.outputBackings = backings;
+                    created.output_backings = true;
+                }
+                error = nil;
+            }
+            if (!created.options) {
+                created.options = [impl->predictionOptions retain];
+            }
+            
+            if (impl->bindings.size() >= kMaxCachedBindings) {
+                releaseBinding(impl->bindings.front());
+                impl->bindings.erase(impl->bindings.begin());
+            }
+            impl->bindings.push_back(created);
+            binding = &impl->bindings.back();
+        }
+        
+        trace::Span predict_span("coreml", "predict");
+        id<MLFeatureProvider> prediction = [impl->model predictionFromFeatures:binding->provider
+                                                                       options:binding->options
+                                                                         error:&error];
+        if ((error || !prediction) && binding->output_backings) {
+            // Models whose outputs don't have the declared shape reject the backings - copy instead
+            LEAFRA_DEBUG() << "CoreML rejected output backings, copying outputs: " << (error ? [[error localizedDescription] UTF8String] : "unknown error");
+            [binding->options release];
+            binding->options = [impl->predictionOptions retain];
+            binding->output_backings = false;
+            error = nil;
+            prediction = [impl->model predictionFromFeatures:binding->provider options:binding->options error:&error];
+        }
+        predict_span.end();
+        if (error || !prediction) {
+            LEAFRA_ERROR() << "Prediction failed: " << (error ? [[error localizedDescription] UTF8String] : "unknown error");
+            return false;
+        }
+        
+        NSArray<NSString*>* cachedOutputNames = (__bridge NSArray<NSString*>*)cached_output_nsnames_;
+        for (size_t i = 0; i < num_outputs; ++i) {
+            MLFeatureValue* outputFeature = [prediction featureValueForName:cachedOutputNames[i]];
+            if (!outputFeature || outputFeature.type != MLFeatureTypeMultiArray) {
+                LEAFRA_ERROR() << "Missing or unsupported output[" << i << "]";
+                return false;
+            }
+            MLMultiArray* outputArray = outputFeature.multiArrayValue;
+            if ([outputArray dataPointer] != impl->boundOutputs[i]) {
+                if (static_cast<size_t>(outputArray.count) != output_sizes_[i]) {
+                    LEAFRA_ERROR() << "Output[" << i << "] tensor element count mismatch: expected " << output_sizes_[i] << ", got " << outputArray.count;
+                    return false;
+                }
+                convertElements([outputArray dataPointer], fromMLDataType(outputArray.dataType), impl->boundOutputs[i], output_types_[i], output_sizes_[i]);
+            }
+            if (impl->boundOutputs[i] != outputs[i].data) {
+                convertElements(impl->boundOutputs[i], output_types_[i], outputs[i].data, outputs[i].type, output_sizes_[i]);
+            }
+        }
+    }
+    return true;
+} //predict_into
+
+// Batched prediction via MLArrayBatchProvider
+// !! Expects inputs and outpus in alphabetical order of their names !!
+std::vector<std::vector<std::vector<float> > > CoreMLModel::predict_batch(
+    const std::vector<std::vector<std::vector<float> > >& batch_inputs,
+    const std::vector<std::string>& input_names) {
+    if (!model_ptr_) {
+        throw std::runtime_error("Invalid CoreML model");
+    }
+    
+    std::vector<std::vector<std::vector<float> > > batch_outputs;
+    if (batch_inputs.empty()) {
+        return batch_outputs;
+    }
+    
+    size_t num_inputs = input_names_.size();
+    size_t num_outputs = output_names_.size();
+    
+    // Validate input names if provided
+    if (!input_names.empty()) {
+        if (input_names.size() != num_inputs) {
+            throw std::runtime_error("Input names count (" + std::to_string(input_names.size()) + ") doesn't match model input count (" + std::to_string(num_inputs) + ")");
+        }
+        for (size_t i = 0; i < input_names.size(); ++i) {
+            if (input_names[i] != input_names_[i]) {
+                throw std::runtime_error("Input name mismatch at index " + std::to_string(i) + 
+                                         ": expected '" + input_names_[i] + "', got '" + input_names[i] + "'");
+            }
+        }
+    }
+    
+    // Validate every sample up front so we never dispatch a partially valid batch
+    for (size_t b = 0; b < batch_inputs.size(); ++b) {
+        if (batch_inputs[b].size() != num_inputs) {
+            throw std::runtime_error("Sample " + std::to_string(b) + " input count mismatch: expected " + 
+                                     std::to_string(num_inputs) + ", got " + std::to_string(batch_inputs[b].size()));
+        }
+        for (size_t i = 0; i < num_inputs; ++i) {
+            if (batch_inputs[b][i].size() != batch_inputs[0][i].size() || !isInputSizeSupported(i, batch_inputs[b][i].size())) {
+                throw std::runtime_error("Sample " + std::to_string(b) + " input[" + std::to_string(i) + "] size mismatch: expected " + 
+                                         std::to_string(batch_inputs[0][i].size()) + " (a size the model accepts), got " + std::to_string(batch_inputs[b][i].size()));
+            }
+        }
+    }
+    
+    @autoreleasepool {
+        CoreMLModelImpl* impl = static_cast<CoreMLModelImpl*>(model_ptr_);
+        MLModel* model = impl->model;
+        if (!model) {
+            throw std::runtime_error("Invalid CoreML model");
+        }
+        
+        NSError* error = nil;
+        NSArray<NSString*>* cachedInputNames = (__bridge NSArray<NSString*>*)cached_input_nsnames_;
+        NSArray<NSString*>* cachedOutputNames = (__bridge NSArray<NSString*>*)cached_output_nsnames_;
+        
+        // Shapes are identical for every sample (validated above) - build them once
+        NSMutableArray<NSArray<NSNumber*>*>* inputShapes = [NSMutableArray arrayWithCapacity:num_inputs];
+        for (size_t i = 0; i < num_inputs; ++i) {
+            [inputShapes addObject:@[@1, @(batch_inputs[0][i].size())]];  // 2D tensor: [batch_size=1, sequence_length]
+        }
+        
+        NSMutableArray<id<MLFeatureProvider>>* providers = [NSMutableArray arrayWithCapacity:batch_inputs.size()];
+        for (size_t b = 0; b < batch_inputs.size(); ++b) {
+            NSMutableDictionary<NSString*, MLFeatureValue*>* features = [NSMutableDictionary dictionaryWithCapacity:num_inputs];
+            for (size_t i = 0; i < num_inputs; ++i) {
+                MLMultiArray* inputArray = [[MLMultiArray alloc] initWithShape:inputShapes[i]
+                                                                      dataType:toMLDataType(input_types_[i])
+                                                                         error:&error];
+                if (error || !inputArray) {
+                    std::string msg = error ? [[error localizedDescription] UTF8String] : "unknown error";
+                    throw std::runtime_error("Failed to create input array for sample " + std::to_string(b) + ": " + msg);
+                }
+                convertElements(batch_inputs[b][i].data(), DataType::Float32, [inputArray dataPointer], input_types_[i], batch_inputs[b][i].size());
+                features[cachedInputNames[i]] = [MLFeatureValue featureValueWithMultiArray:inputArray];
+                [inputArray release];
+            }
+            
+            MLDictionaryFeatureProvider* provider = [[MLDictionaryFeatureProvider alloc] initWithDictionary:features error:&error];
+            if (error || !provider) {
+                std::string msg = error ? [[error localizedDescription] UTF8String] : "unknown error";
+                throw std::runtime_error("Failed to create feature provider for sample " + std::to_string(b) + ": " + msg);
+            }
+            [providers addObject:provider];
+            [provider release];
+        }
+        
+        MLArrayBatchProvider* batchProvider = [[MLArrayBatchProvider alloc] initWithFeatureProviderArray:providers];
+        trace::Span batch_span("coreml", "predict_batch");
+        batch_span.arg("batch", static_cast<int64_t>([providers count]));
+        id<MLBatchProvider> predictions = [model predictionsFromBatch:batchProvider
+                                                              options:impl->predictionOptions
+                                                                error:&error];
+        batch_span.end();
+        [batchProvider release];
+        
+        if (error || !predictions) {
+            std::string msg = error ? [[error localizedDescription] UTF8String] : "unknown error";
+            throw std::runtime_error("CoreML batch prediction failed: " + msg);
+        }
+        
+        if (static_cast<size_t>(predictions.count) != batch_inputs.size()) {
+            throw std::runtime_error("CoreML batch prediction returned " + std::to_string(predictions.count) + 
+                                     " results for " + std::to_string(batch_inputs.size()) + " samples");
+        }
+        
+        batch_outputs.resize(batch_inputs.size());
+        for (size_t b = 0; b < batch_inputs.size(); ++b) {
+            id<MLFeatureProvider> prediction = [predictions featuresAtIndex:static_cast<NSInteger>(b)];
+            auto& outputs = batch_outputs[b];
+            outputs.resize(num_outputs);
+            
+            for (size_t i = 0; i < num_outputs; ++i) {
+                MLFeatureValue* outputFeature = [prediction featureValueForName:cachedOutputNames[i]];
+                if (!outputFeature || outputFeature.type != MLFeatureTypeMultiArray) {
+                    throw std::runtime_error("Missing or unsupported output[" + std::to_string(i) + "] for sample " + std::to_string(b));
+                }
+                
+                MLMultiArray* outputArray = outputFeature.multiArrayValue;
+                size_t expected_elements = output_sizes_[i];
+                if (static_cast<size_t>(outputArray.count) != expected_elements) {
+                    throw std::runtime_error("Output[" + std::to_string(i) + "] tensor element count mismatch: expected " + 
+                                             std::to_string(expected_elements) + ", got " + std::to_string(outputArray.count));
+                }
+                
+                // Direct memory copy works for both [1, N] and [N] tensor shapes (contiguous elements)
+                outputs[i].resize(expected_elements);
+                convertElements([outputArray dataPointer], fromMLDataType(outputArray.dataType), outputs[i].data(), DataType::Float32, expected_elements);
+            }
+        }
+        
+        LEAFRA_DEBUG() << "CoreML batch prediction completed for " << batch_inputs.size() << " samples";
+    }
+    
+    return batch_outputs;
+}
+
+} // namespace leafra
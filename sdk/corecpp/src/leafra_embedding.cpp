@@ -0,0 +1,1014 @@
+#include "leafra/leafra_embedding.h"
+#include "leafra/leafra_debug.h"
+#include "leafra/logger.h"
+#include "leafra/leafra_threadpool.h"
+#include "leafra/leafra_simd.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <optional>
+#include <stdexcept>
+
+#ifdef LEAFRA_HAS_COREML
+#include "leafra/leafra_coreml.h"
+#endif
+
+#ifdef LEAFRA_HAS_TENSORFLOWLITE
+#include "leafra/leafra_tflite.h"
+#endif
+
+#ifdef LEAFRA_HAS_EXECUTORCH
+#include "leafra/leafra_executorch.h"
+#endif
+
+#ifdef LEAFRA_HAS_LLAMACPP
+#include "leafra/leafra_llamacpp.h"
+#endif
+
+namespace leafra {
+
+// ==============================================================================
+// Backends
+// ==============================================================================
+
+namespace {
+
+#if defined(LEAFRA_HAS_TENSORFLOWLITE) || defined(LEAFRA_HAS_EXECUTORCH)
+// Pooling selected by embedding_inference.pooling for models that output the last hidden state
+simd::Pooling poolingFor(const std::string& name) {
+    if (name == "cls") {
+        return simd::Pooling::CLS;
+    }
+    if (name == "max") {
+        return simd::Pooling::MAX;
+    }
+    if (name != "mean") {
+        LEAFRA_WARNING() << "Unknown embedding pooling '" << name << "', using mean";
+    }
+    return simd::Pooling::MEAN;
+}
+
+const char* poolingName(simd::Pooling pooling) {
+    switch (pooling) {
+        case simd::Pooling::CLS: return "CLS";
+        case simd::Pooling::MAX: return "max";
+        default: return "mean";
+    }
+}
+#endif
+
+#ifdef LEAFRA_HAS_COREML
+class CoreMLEmbeddingBackend : public IEmbeddingBackend {
+public:
+    explicit CoreMLEmbeddingBackend(const Config& config)
+        : max_batch_size_(static_cast<size_t>(std::max(1, config.embedding_inference.batch_size))) {
+        const auto& embedding_config = config.embedding_inference;
+
+        // Convert compute units string to enum
+        CoreMLModel::ComputeUnits compute_units = CoreMLModel::ComputeUnits::All;
+        if (embedding_config.coreml_compute_units == "cpu") {
+            compute_units = CoreMLModel::ComputeUnits::CPUOnly;
+        } else if (embedding_config.coreml_compute_units == "cpu_and_gpu") {
+            compute_units = CoreMLModel::ComputeUnits::CPUAndGPU;
+        } else if (embedding_config.coreml_compute_units == "cpu_and_neural_engine") {
+            compute_units = CoreMLModel::ComputeUnits::CPUAndNeuralEngine;
+        }
+        LEAFRA_INFO() << "  - Compute units: " << embedding_config.coreml_compute_units;
+
+        // .mlmodel / .mlpackage sources are compiled first (once, with the compiled-model cache)
+        std::string compiled_path = CoreMLModel::compileModel(
+            embedding_config.model_path,
+            embedding_config.coreml_cache_compiled ? CoreMLModel::defaultCompiledModelCacheDirectory() : std::string());
+        if (compiled_path.empty()) {
+            throw std::runtime_error("Failed to compile CoreML model: " + embedding_config.model_path);
+        }
+        model_ = std::make_unique<CoreMLModel>(compiled_path, compute_units);
+        if (!model_->isValid()) {
+            throw std::runtime_error("CoreML model is not valid");
+        }
+        if (model_->getInputCount() != 2) {
+            throw std::runtime_error("Unexpected model input count: " + std::to_string(model_->getInputCount()) +
+                                     " (expected 2 for embedding model)");
+        }
+
+        //Our coreml implementation expects inputs in alphabetical order of their names
+        //Passing the names explicitly makes predict validate them against the model
+        if (config.tokenizer.model_name == "multilingual-e5-small") {
+            input_names_ = {"attention_mask", "input_ids"};
+            if (model_->getInputNames() != input_names_) {
+                throw std::runtime_error("Unexpected model input names (expected attention_mask, input_ids)");
+            }
+        }
+
+        // Flexible-shape exports: enumerated shapes give the buckets directly, range shapes take the configured ones
+        sequence_length_ = model_->getInputSize(0);
+        if (!embedding_config.sequence_buckets.empty()) {
+            std::vector<size_t> supported = model_->getSupportedInputSizes(0);
+            sequence_length_ = supported.back();
+            std::vector<size_t> candidates = supported;
+            if (model_->isInputSizeRange(0)) {
+                candidates.clear();
+                for (int32_t bucket : embedding_config.sequence_buckets) {
+                    if (bucket > 0 && static_cast<size_t>(bucket) >= supported.front()) {
+                        candidates.push_back(static_cast<size_t>(bucket));
+                    }
+                }
+            }
+            for (size_t bucket : candidates) {
+                if (bucket < sequence_length_ && model_->isInputSizeSupported(0, bucket) && model_->isInputSizeSupported(1, bucket)) {
+                    sequence_buckets_.push_back(bucket);
+                }
+            }
+        }
+
+        std::string description = model_->getDescription();
+        if (!description.empty()) {
+            LEAFRA_INFO() << "  - Model description: " << description;
+        }
+        LEAFRA_INFO() << "  - Input count: " << model_->getInputCount();
+        LEAFRA_INFO() << "  - Output count: " << model_->getOutputCount();
+
+        if (embedding_config.coreml_prewarm) {
+            warm_up_ = std::async(std::launch::async, [this]() { warmUp(); }).share();
+        }
+    }
+
+    ~CoreMLEmbeddingBackend() override {
+        if (warm_up_.valid()) {
+            warm_up_.wait();
+        }
+    }
+
+    std::string getName() const override { return "coreml"; }
+    bool isReady() const override { return model_ && model_->isValid(); }
+    size_t getSequenceLength() const override { return sequence_length_; }
+    std::vector<size_t> getSequenceBuckets() const override { return sequence_buckets_; }
+    size_t getEmbeddingDimension() const override { return model_->getOutputSize(0); }
+    size_t getMaxBatchSize() const override { return max_batch_size_; }
+
+    bool embedBatch(const EmbeddingBatch& batch, float* output) override {
+        if (warm_up_.valid()) {
+            warm_up_.wait();                // The model isn't thread-safe: let the pre-warm prediction finish
+        }
+        try {
+            // CoreMLModel takes float tensors: {attention_mask, input_ids} per sample
+            size_t sequence_length = batch.sequence_length;
+            size_t dimension = getEmbeddingDimension();
+            if (batch.rows == 1) {
+                // Queries and short documents: the int32 mask and ids are bound as they are (an
+                // Int32 export needs no conversion at all) and the embedding is written in place
+                row_inputs_.resize(2);
+                row_inputs_[0] = {batch.row_mask(0), sequence_length, CoreMLModel::DataType::Int32};
+                row_inputs_[1] = {batch.row_tokens(0), sequence_length, CoreMLModel::DataType::Int32};
+                row_outputs_.resize(1);
+                row_outputs_[0] = {output, CoreMLModel::DataType::Float32};
+                return model_->predict_into(row_inputs_, row_outputs_);
+            }
+
+            sample_inputs_.resize(batch.rows);
+            for (size_t row = 0; row < batch.rows; ++row) {
+                auto& sample = sample_inputs_[row];
+                sample.resize(2);
+                sample[0].assign(batch.row_mask(row), batch.row_mask(row) + sequence_length);
+                sample[1].assign(batch.row_tokens(row), batch.row_tokens(row) + sequence_length);
+            }
+
+            auto batch_outputs = model_->predict_batch(sample_inputs_, input_names_);
+            for (size_t row = 0; row < batch.rows; ++row) {
+                if (batch_outputs[row].empty() || batch_outputs[row][0].size() != dimension) {
+                    LEAFRA_WARNING() << "CoreML model produced unexpected embedding size for row " << row;
+                    return false;
+                }
+                std::copy(batch_outputs[row][0].begin(), batch_outputs[row][0].end(), output + row * dimension);
+            }
+            return true;
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "CoreML embedding inference failed: " << e.what();
+            return false;
+        }
+    }
+
+private:
+    /**
+     * @brief One query-sized prediction, so CoreML specializes the model for the device before the first real query
+     */
+    void warmUp() {
+        const size_t length = sequence_buckets_.empty() ? sequence_length_ : sequence_buckets_.front();
+        std::vector<int32_t> mask(length, 0);
+        std::vector<int32_t> ids(length, 0);
+        std::vector<float> embedding(getEmbeddingDimension());
+        mask[0] = 1;
+        auto start = std::chrono::steady_clock::now();
+        try {
+            std::vector<CoreMLModel::InputBuffer> inputs = {{mask.data(), length, CoreMLModel::DataType::Int32},
+                                                            {ids.data(), length, CoreMLModel::DataType::Int32}};
+            std::vector<CoreMLModel::OutputBuffer> outputs = {{embedding.data(), CoreMLModel::DataType::Float32}};
+            if (model_->predict_into(inputs, outputs)) {
+                LEAFRA_INFO() << "🔥 CoreML embedding model pre-warmed in "
+                              << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms";
+                return;
+            }
+        } catch (const std::exception& e) {
+            LEAFRA_WARNING() << "CoreML pre-warm prediction failed: " << e.what();
+            return;
+        }
+        LEAFRA_WARNING() << "CoreML pre-warm prediction failed";
+    }
+
+    std::unique_ptr<CoreMLModel> model_;
+    std::shared_future<void> warm_up_;      // Background pre-warm prediction (coreml_prewarm)
+    std::vector<std::string> input_names_;
+    std::vector<std::vector<std::vector<float> > > sample_inputs_;  // Reused between batches
+    std::vector<CoreMLModel::InputBuffer> row_inputs_;               // Single-row predict_into bindings, reused
+    std::vector<CoreMLModel::OutputBuffer> row_outputs_;
+    size_t max_batch_size_;
+    size_t sequence_length_ = 0;
+    std::vector<size_t> sequence_buckets_;
+};
+#endif // LEAFRA_HAS_COREML
+
+#ifdef LEAFRA_HAS_TENSORFLOWLITE
+class TFLiteEmbeddingBackend : public IEmbeddingBackend {
+public:
+    explicit TFLiteEmbeddingBackend(const Config& config) {
+        const auto& embedding_config = config.embedding_inference;
+
+        TFLiteModel::Options options;
+        if (embedding_config.tflite_num_threads > 0) {
+            options.num_threads = embedding_config.tflite_num_threads;
+        } else {
+            // Use SDK-level thread configuration or default
+            options.num_threads = config.max_threads > 0 ? config.max_threads : 4;
+        }
+        options.enable_xnnpack = embedding_config.tflite_enable_xnnpack_delegate;
+        options.enable_coreml = embedding_config.tflite_enable_coreml_delegate;
+        options.enable_metal = embedding_config.tflite_enable_metal_delegate;
+        options.enable_gpu = embedding_config.tflite_enable_gpu_delegate;
+        options.enable_nnapi = embedding_config.tflite_use_nnapi;
+        options.cache_dir = embedding_config.tflite_delegate_cache_dir;
+        LEAFRA_DEBUG() << "  - Threads: " << options.num_threads;
+
+        model_ = std::make_unique<TFLiteModel>(embedding_config.model_path, options);
+
+        // Identify inputs by name: input_ids / attention_mask / token_type_ids
+        for (size_t i = 0; i < model_->getInputCount(); ++i) {
+            std::string name = model_->getInputName(i);
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+            if (name.find("mask") != std::string::npos) {
+                mask_input_ = i;
+            } else if (name.find("type") != std::string::npos || ids_input_ != kNoInput) {
+                constant_inputs_.push_back(i);
+            } else {
+                ids_input_ = i;
+            }
+        }
+        if (ids_input_ == kNoInput) {
+            throw std::runtime_error("TensorFlow Lite model has no token ID input");
+        }
+
+        // Prefer the configured batch size; fall back to the exported batch for static-shape models
+        size_t preferred_batch = static_cast<size_t>(std::max(1, embedding_config.batch_size));
+        try {
+            model_->resizeBatch(preferred_batch);
+            resizable_ = true;
+        } catch (const std::exception& e) {
+            LEAFRA_WARNING() << "TensorFlow Lite model does not support batch " << preferred_batch
+                             << ", using its exported batch size: " << e.what();
+            resizable_ = false;
+        }
+        max_batch_size_ = resizable_ ? preferred_batch : std::max<size_t>(1, model_->getBatchSize());
+        sequence_length_ = model_->getInputSequenceLength(ids_input_);
+
+        // Output is either pooled [batch, dim] or last hidden state [batch, seq, dim]
+        std::vector<int32_t> output_dims = model_->getOutputDims(0);
+        needs_pooling_ = output_dims.size() == 3;
+        embedding_dim_ = needs_pooling_ ? static_cast<size_t>(output_dims[2]) : model_->getOutputSize(0);
+        pooling_ = poolingFor(embedding_config.pooling);
+        normalize_ = needs_pooling_ && embedding_config.normalize_embeddings;
+
+        // Sequence bucketing needs a graph that accepts a shorter second dimension - probe once with the smallest bucket
+        std::vector<size_t> candidates;
+        for (int32_t bucket : embedding_config.sequence_buckets) {
+            if (bucket > 0 && static_cast<size_t>(bucket) < sequence_length_) {
+                candidates.push_back(static_cast<size_t>(bucket));
+            }
+        }
+        if (!candidates.empty() && model_->getSequenceLength() == sequence_length_) {
+            size_t batch = model_->getBatchSize();
+            try {
+                model_->resizeInputs(batch, *std::min_element(candidates.begin(), candidates.end()));
+                model_->resizeInputs(batch, sequence_length_);
+                sequence_buckets_ = candidates;
+            } catch (const std::exception& e) {
+                // resizeInputs restores the previous shape on failure
+                LEAFRA_DEBUG() << "TensorFlow Lite model has a fixed sequence length, bucketing disabled: " << e.what();
+            }
+        }
+
+        std::string delegate_names;
+        for (const auto& name : model_->getDelegateNames()) {
+            delegate_names += (delegate_names.empty() ? "" : ", ") + name;
+        }
+        LEAFRA_INFO() << "  - Input tensors: " << model_->getInputCount();
+        LEAFRA_INFO() << "  - Output tensors: " << model_->getOutputCount();
+        LEAFRA_INFO() << "  - Delegates: " << model_->getDelegateCount()
+                      << (delegate_names.empty() ? "" : " (" + delegate_names + ")");
+        LEAFRA_INFO() << "  - Max batch: " << max_batch_size_ << (needs_pooling_ ? std::string(", ") + poolingName(pooling_) + " pooled output" : "")
+                      << (model_->isOutputQuantized(0) ? ", quantized output (dequantized)" : "");
+    }
+
+    std::string getName() const override { return "tensorflow_lite"; }
+    bool isReady() const override { return model_ && model_->isValid(); }
+    size_t getSequenceLength() const override { return sequence_length_; }
+    std::vector<size_t> getSequenceBuckets() const override { return sequence_buckets_; }
+    size_t getEmbeddingDimension() const override { return embedding_dim_; }
+    size_t getMaxBatchSize() const override { return max_batch_size_; }
+    bool isQuantized() const override { return model_ && model_->isOutputQuantized(0); }
+    bool normalizesOutput() const override { return normalize_; }
+
+    bool embedBatch(const EmbeddingBatch& batch, float* output) override {
+        try {
+            // No-op when unchanged; the sequence dimension only moves when bucketing was probed successfully
+            size_t tensor_sequence = sequence_buckets_.empty() ? sequence_length_ : batch.sequence_length;
+            model_->resizeInputs(resizable_ ? batch.rows : model_->getBatchSize(), tensor_sequence);
+            size_t tensor_rows = model_->getBatchSize();
+            if (batch.rows > tensor_rows) {
+                LEAFRA_ERROR() << "TensorFlow Lite batch of " << batch.rows << " exceeds tensor batch " << tensor_rows;
+                return false;
+            }
+            size_t output_sequence = 0;
+            if (needs_pooling_) {
+                std::vector<int32_t> output_dims = model_->getOutputDims(0);
+                output_sequence = output_dims.size() == 3 ? static_cast<size_t>(output_dims[1]) : 0;
+            }
+
+            // Fill the input tensors in place; unused tail rows (static batch) are fully masked padding
+            for (size_t row = 0; row < tensor_rows; ++row) {
+                bool real_row = row < batch.rows;
+                if (real_row) {
+                    model_->setTokenRow(ids_input_, row, batch.row_tokens(row), batch.sequence_length, 0);
+                } else {
+                    model_->fillRow(ids_input_, row, 0);
+                }
+                if (mask_input_ != kNoInput) {
+                    model_->setMaskRow(mask_input_, row, real_row ? batch.lengths[row] : 0);
+                }
+                for (size_t constant_input : constant_inputs_) {
+                    model_->fillRow(constant_input, row, 0);
+                }
+            }
+
+            model_->invoke();
+
+            for (size_t row = 0; row < batch.rows; ++row) {
+                const float* row_output = model_->getOutputRow(0, row);
+                float* embedding = output + row * embedding_dim_;
+                if (!needs_pooling_) {
+                    std::copy(row_output, row_output + embedding_dim_, embedding);
+                    continue;
+                }
+
+                // Pooled straight from the output tensor; positions past the batch's padded length are padding
+                simd::pool_tokens(row_output, batch.row_mask(row), std::min(batch.sequence_length, output_sequence),
+                                  embedding_dim_, pooling_, normalize_, embedding);
+            }
+            return true;
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "TensorFlow Lite embedding inference failed: " << e.what();
+            return false;
+        }
+    }
+
+private:
+    static constexpr size_t kNoInput = static_cast<size_t>(-1);
+
+    std::unique_ptr<TFLiteModel> model_;
+    size_t ids_input_ = kNoInput;
+    size_t mask_input_ = kNoInput;
+    std::vector<size_t> constant_inputs_;
+    bool resizable_ = false;
+    size_t max_batch_size_ = 1;
+    bool needs_pooling_ = false;
+    simd::Pooling pooling_ = simd::Pooling::MEAN;
+    bool normalize_ = false;                // Normalization fused into pooling
+    size_t embedding_dim_ = 0;
+    size_t sequence_length_ = 0;
+    std::vector<size_t> sequence_buckets_;
+};
+#endif // LEAFRA_HAS_TENSORFLOWLITE
+
+#ifdef LEAFRA_HAS_EXECUTORCH
+class ExecuTorchEmbeddingBackend : public IEmbeddingBackend {
+public:
+    explicit ExecuTorchEmbeddingBackend(const Config& config) {
+        const auto& embedding_config = config.embedding_inference;
+
+        ExecuTorchModel::Options options;
+        options.method_name = embedding_config.executorch_method;
+        if (embedding_config.executorch_num_threads > 0) {
+            options.num_threads = embedding_config.executorch_num_threads;
+        } else if (config.max_threads > 0) {
+            options.num_threads = config.max_threads;
+        }
+        LEAFRA_DEBUG() << "  - Method: " << options.method_name << ", threads: " << options.num_threads;
+
+        model_ = std::make_unique<ExecuTorchModel>(embedding_config.model_path, options);
+
+        // Programs carry no input names: exported as (input_ids[, attention_mask[, token_type_ids...]])
+        if (model_->getInputCount() == 0) {
+            throw std::runtime_error("ExecuTorch method has no token ID input");
+        }
+        mask_input_ = model_->getInputCount() > 1 ? 1 : kNoInput;
+        for (size_t i = 2; i < model_->getInputCount(); ++i) {
+            constant_inputs_.push_back(i);
+        }
+
+        // The exported batch is the batch: shorter batches run with fully masked padding rows
+        max_batch_size_ = std::max<size_t>(1, model_->getBatchSize());
+        sequence_length_ = model_->getInputSequenceLength(0);
+
+        // Output is either pooled [batch, dim] or last hidden state [batch, seq, dim]
+        std::vector<int32_t> output_dims = model_->getOutputDims(0);
+        needs_pooling_ = output_dims.size() == 3;
+        output_sequence_ = needs_pooling_ ? static_cast<size_t>(output_dims[1]) : 0;
+        embedding_dim_ = needs_pooling_ ? static_cast<size_t>(output_dims[2]) : model_->getOutputSize(0);
+        pooling_ = poolingFor(embedding_config.pooling);
+        normalize_ = needs_pooling_ && embedding_config.normalize_embeddings;
+
+        std::string backend_names;
+        for (const auto& name : model_->getBackendNames()) {
+            backend_names += (backend_names.empty() ? "" : ", ") + name;
+        }
+        LEAFRA_INFO() << "  - Input tensors: " << model_->getInputCount();
+        LEAFRA_INFO() << "  - Output tensors: " << model_->getOutputCount();
+        LEAFRA_INFO() << "  - Delegates: " << (backend_names.empty() ? "none (portable kernels)" : backend_names);
+        LEAFRA_INFO() << "  - Batch: " << max_batch_size_ << " x " << sequence_length_
+                      << (needs_pooling_ ? std::string(", ") + poolingName(pooling_) + " pooled output" : "");
+        if (static_cast<size_t>(std::max(1, embedding_config.batch_size)) != max_batch_size_) {
+            LEAFRA_INFO() << "  - Configured batch_size " << embedding_config.batch_size
+                          << " replaced by the exported batch " << max_batch_size_;
+        }
+    }
+
+    std::string getName() const override { return "executorch"; }
+    bool isReady() const override { return model_ && model_->isValid(); }
+    size_t getSequenceLength() const override { return sequence_length_; }
+    size_t getEmbeddingDimension() const override { return embedding_dim_; }
+    size_t getMaxBatchSize() const override { return max_batch_size_; }
+    bool normalizesOutput() const override { return normalize_; }
+
+    bool embedBatch(const EmbeddingBatch& batch, float* output) override {
+        try {
+            if (batch.rows > max_batch_size_) {
+                LEAFRA_ERROR() << "ExecuTorch batch of " << batch.rows << " exceeds exported batch " << max_batch_size_;
+                return false;
+            }
+
+            // Fill the method's input tensors in place; unused tail rows are fully masked padding
+            for (size_t row = 0; row < max_batch_size_; ++row) {
+                bool real_row = row < batch.rows;
+                if (real_row) {
+                    model_->setTokenRow(0, row, batch.row_tokens(row), batch.sequence_length, 0);
+                } else {
+                    model_->fillRow(0, row, 0);
+                }
+                if (mask_input_ != kNoInput) {
+                    model_->setMaskRow(mask_input_, row, real_row ? batch.lengths[row] : 0);
+                }
+                for (size_t constant_input : constant_inputs_) {
+                    model_->fillRow(constant_input, row, 0);
+                }
+            }
+
+            model_->execute();
+
+            for (size_t row = 0; row < batch.rows; ++row) {
+                const float* row_output = model_->getOutputRow(0, row);
+                float* embedding = output + row * embedding_dim_;
+                if (!needs_pooling_) {
+                    std::copy(row_output, row_output + embedding_dim_, embedding);
+                } else {
+                    simd::pool_tokens(row_output, batch.row_mask(row), std::min(batch.sequence_length, output_sequence_),
+                                      embedding_dim_, pooling_, normalize_, embedding);
+                }
+            }
+            return true;
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "ExecuTorch embedding inference failed: " << e.what();
+            return false;
+        }
+    }
+
+private:
+    static constexpr size_t kNoInput = static_cast<size_t>(-1);
+
+    std::unique_ptr<ExecuTorchModel> model_;
+    size_t mask_input_ = kNoInput;
+    std::vector<size_t> constant_inputs_;
+    size_t max_batch_size_ = 1;
+    bool needs_pooling_ = false;
+    simd::Pooling pooling_ = simd::Pooling::MEAN;
+    bool normalize_ = false;                // Normalization fused into pooling
+    size_t output_sequence_ = 0;
+    size_t embedding_dim_ = 0;
+    size_t sequence_length_ = 0;
+};
+#endif // LEAFRA_HAS_EXECUTORCH
+
+#ifdef LEAFRA_HAS_LLAMACPP
+class LlamaCppEmbeddingBackend : public IEmbeddingBackend {
+public:
+    explicit LlamaCppEmbeddingBackend(const Config& config) {
+        // Dedicated embedding context - generation settings come from the LLM config
+        LLMConfig llm_config = config.llm;
+        llm_config.enabled = true;
+        llm_config.model_path = config.embedding_inference.model_path;
+        llm_config.embeddings = true;
+        // One sequence per chunk of a batch, so a batch is embedded in as few decodes as it fits
+        llm_config.n_seq_max = std::max(llm_config.n_seq_max, config.embedding_inference.batch_size);
+
+        if (!model_.load_model(llm_config)) {
+            throw std::runtime_error("Failed to load llama.cpp embedding model: " + model_.get_last_error());
+        }
+        if (!model_.supports_embeddings()) {
+            throw std::runtime_error("llama.cpp model does not support embeddings");
+        }
+        LEAFRA_INFO() << "  - Embedding dimension: " << model_.get_embedding_dimension();
+        max_batch_size_ = static_cast<size_t>(std::max(1, llm_config.n_seq_max));
+    }
+
+    std::string getName() const override { return "llamacpp"; }
+    bool isReady() const override { return model_.is_loaded(); }
+    bool requiresTokenIds() const override { return false; }
+    size_t getSequenceLength() const override { return 0; }
+    size_t getEmbeddingDimension() const override { return static_cast<size_t>(model_.get_embedding_dimension()); }
+    size_t getMaxBatchSize() const override { return max_batch_size_; }
+
+    bool embedBatch(const EmbeddingBatch& batch, float* output) override {
+        size_t dimension = getEmbeddingDimension();
+        std::vector<float> embeddings = model_.get_embeddings_batch(batch.texts);
+        if (embeddings.size() != batch.rows * dimension) {
+            LEAFRA_ERROR() << "llama.cpp embedding failed: " << model_.get_last_error();
+            return false;
+        }
+        std::copy(embeddings.begin(), embeddings.end(), output);
+        return true;
+    }
+
+private:
+    llamacpp::LlamaCppModel model_;
+    size_t max_batch_size_ = 1;
+};
+#endif // LEAFRA_HAS_LLAMACPP
+
+} // namespace
+
+bool is_embedding_framework_available(const std::string& framework) {
+#ifdef LEAFRA_HAS_COREML
+    if (framework == "coreml") return true;
+#endif
+#ifdef LEAFRA_HAS_TENSORFLOWLITE
+    if (framework == "tensorflow_lite" || framework == "tensorflow") return true;
+#endif
+#ifdef LEAFRA_HAS_EXECUTORCH
+    if (framework == "executorch") return true;
+#endif
+#ifdef LEAFRA_HAS_LLAMACPP
+    if (framework == "llamacpp") return true;
+#endif
+    (void)framework;
+    return false;
+}
+
+std::unique_ptr<IEmbeddingBackend> create_embedding_backend(const Config& config) {
+    const auto& framework = config.embedding_inference.framework;
+
+    try {
+#ifdef LEAFRA_HAS_COREML
+        if (framework == "coreml") {
+            return std::make_unique<CoreMLEmbeddingBackend>(config);
+        }
+#endif
+#ifdef LEAFRA_HAS_TENSORFLOWLITE
+        if (framework == "tensorflow_lite" || framework == "tensorflow") {
+            return std::make_unique<TFLiteEmbeddingBackend>(config);
+        }
+#endif
+#ifdef LEAFRA_HAS_EXECUTORCH
+        if (framework == "executorch") {
+            return std::make_unique<ExecuTorchEmbeddingBackend>(config);
+        }
+#endif
+#ifdef LEAFRA_HAS_LLAMACPP
+        if (framework == "llamacpp") {
+            return std::make_unique<LlamaCppEmbeddingBackend>(config);
+        }
+#endif
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "❌ Failed to initialize " << framework << " embedding backend: " << e.what();
+        return nullptr;
+    }
+
+    LEAFRA_WARNING() << "⚠️  Embedding framework '" << framework << "' is not available (not compiled in)";
+    return nullptr;
+} //create_embedding_backend
+
+// ==============================================================================
+// EmbeddingScheduler
+// ==============================================================================
+
+EmbeddingScheduler::EmbeddingScheduler(std::unique_ptr<IEmbeddingBackend> backend, const Options& options)
+    : backend_(std::move(backend)), options_(options) {
+    if (options_.batch_size == 0) {
+        options_.batch_size = 1;
+    }
+    batch_size_ = options_.batch_size;
+
+    // Buckets shorter than the full length, then the full length itself as the catch-all
+    size_t full_length = backend_ && backend_->requiresTokenIds() ? backend_->getSequenceLength() : 0;
+    if (full_length > 0) {
+        for (size_t bucket : backend_->getSequenceBuckets()) {
+            if (bucket > 0 && bucket < full_length) {
+                sequence_buckets_.push_back(bucket);
+            }
+        }
+        std::sort(sequence_buckets_.begin(), sequence_buckets_.end());
+        sequence_buckets_.erase(std::unique(sequence_buckets_.begin(), sequence_buckets_.end()), sequence_buckets_.end());
+        sequence_buckets_.push_back(full_length);
+        if (sequence_buckets_.size() > 1) {
+            std::string bucket_list;
+            for (size_t bucket : sequence_buckets_) {
+                bucket_list += (bucket_list.empty() ? "" : "/") + std::to_string(bucket);
+            }
+            LEAFRA_INFO() << "  - Sequence buckets: " << bucket_list;
+        }
+    }
+
+    if (backend_ && options_.pipeline_depth > 1) {
+        inference_thread_ = std::make_unique<ThreadPool>(1, ThreadQoS::UTILITY, "LeafraEmbedding");
+    }
+}
+
+EmbeddingScheduler::~EmbeddingScheduler() = default;
+
+size_t EmbeddingScheduler::get_effective_batch_size() const {
+    return std::max<size_t>(1, std::min(batch_size_.load(), backend_->getMaxBatchSize()));
+}
+
+void EmbeddingScheduler::set_batch_size(size_t batch_size) {
+    batch_size_ = std::max<size_t>(1, batch_size);
+}
+
+size_t EmbeddingScheduler::select_sequence_length(size_t token_count) const {
+    if (sequence_buckets_.empty()) {
+        return 0;
+    }
+    auto it = std::lower_bound(sequence_buckets_.begin(), sequence_buckets_.end(), token_count);
+    return it != sequence_buckets_.end() ? *it : sequence_buckets_.back();
+}
+
+size_t EmbeddingScheduler::embed_chunks(std::vector<TextChunk>& chunks, Priority priority) {
+    if (!is_ready()) {
+        return 0;
+    }
+    // Collect rows the backend can actually consume
+    bool needs_tokens = backend_->requiresTokenIds();
+    std::vector<PendingRow> rows;
+    std::vector<size_t> chunk_indices;
+    rows.reserve(chunks.size());
+    chunk_indices.reserve(chunks.size());
+    for (size_t chunk_idx = 0; chunk_idx < chunks.size(); ++chunk_idx) {
+        const auto& chunk = chunks[chunk_idx];
+        if (chunk.has_embedding()) {
+            continue;                       // Already embedded (e.g. reused from an earlier version of the document)
+        }
+        if (needs_tokens ? chunk.has_token_ids() : !chunk.content.empty()) {
+            rows.push_back({chunk.token_ids.data(), chunk.token_ids.size(), chunk.content});
+            chunk_indices.push_back(chunk_idx);
+        } else {
+            LEAFRA_DEBUG() << "Skipping chunk " << (chunk_idx + 1) << " - no " << (needs_tokens ? "token IDs" : "text") << " available";
+        }
+    }
+
+    std::optional<InteractiveCall> interactive;
+    if (priority == Priority::Interactive) {
+        interactive.emplace(*this);
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t dimension = backend_->getEmbeddingDimension();
+    return embed_rows(rows, chunk_indices, [&](size_t chunk_idx, const float* embedding) {
+        chunks[chunk_idx].embedding.assign(embedding, embedding + dimension);
+    }, interactive ? nullptr : &lock);
+} //embed_chunks
+
+size_t EmbeddingScheduler::embed_chunk_batch(const std::vector<TextChunk>& chunks, ChunkBatch& batch) {
+    if (!is_ready()) {
+        return 0;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    size_t dimension = backend_->getEmbeddingDimension();
+    if (batch.rows() != chunks.size() || batch.dimension != dimension) {
+        if (batch.embedding_count() > 0) {
+            LEAFRA_WARNING() << "Discarding " << batch.embedding_count() << " stored embeddings of dimension " << batch.dimension
+                             << " - the model produces " << dimension;
+        }
+        batch.reset_embeddings(chunks.size(), dimension);
+    }
+
+    bool needs_tokens = backend_->requiresTokenIds();
+    std::vector<PendingRow> rows;
+    std::vector<size_t> row_indices;
+    rows.reserve(chunks.size());
+    row_indices.reserve(chunks.size());
+    for (size_t row = 0; row < chunks.size(); ++row) {
+        if (batch.has_embedding(row) || batch.is_skipped(row)) {
+            continue;                       // Already embedded (e.g. reused from an earlier version of the document) or left out
+        }
+        if (needs_tokens ? batch.has_tokens(row) : !chunks[row].content.empty()) {
+            if (needs_tokens) {
+                rows.push_back({batch.tokens.begin(row), batch.tokens.length(row), chunks[row].content});
+            } else {
+                rows.push_back({nullptr, 0, chunks[row].content});
+            }
+            row_indices.push_back(row);
+        } else {
+            LEAFRA_DEBUG() << "Skipping chunk " << (row + 1) << " - no " << (needs_tokens ? "token IDs" : "text") << " available";
+        }
+    }
+
+    return embed_rows(rows, row_indices, [&](size_t row, const float* embedding) {
+        std::copy(embedding, embedding + dimension, batch.embedding(row));
+        batch.embedded[row] = 1;
+    }, &lock);
+} //embed_chunk_batch
+
+size_t EmbeddingScheduler::embed_rows(std::vector<PendingRow>& rows, std::vector<size_t>& indices, const StoreEmbedding& store,
+                                      std::unique_lock<std::mutex>* bulk_lock) {
+    // Group rows by padded length so every batch shares one bucket (stable - keeps document order within a bucket)
+    bool needs_tokens = backend_->requiresTokenIds();
+    std::vector<size_t> row_lengths(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        row_lengths[i] = needs_tokens ? select_sequence_length(rows[i].token_count) : 0;
+    }
+    if (sequence_buckets_.size() > 1) {
+        std::vector<size_t> order(rows.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return row_lengths[a] < row_lengths[b]; });
+
+        std::vector<PendingRow> sorted_rows;
+        std::vector<size_t> sorted_indices;
+        std::vector<size_t> sorted_lengths;
+        sorted_rows.reserve(rows.size());
+        sorted_indices.reserve(rows.size());
+        sorted_lengths.reserve(rows.size());
+        for (size_t i : order) {
+            sorted_rows.push_back(rows[i]);
+            sorted_indices.push_back(indices[i]);
+            sorted_lengths.push_back(row_lengths[i]);
+        }
+        rows.swap(sorted_rows);
+        indices.swap(sorted_indices);
+        row_lengths.swap(sorted_lengths);
+    }
+
+    size_t batch_size = get_effective_batch_size();
+    size_t dimension = backend_->getEmbeddingDimension();
+    size_t successful = 0;
+
+    std::vector<BatchJob> jobs;
+    for (size_t group_begin = 0; group_begin < rows.size();) {
+        size_t sequence_length = row_lengths[group_begin];
+        size_t group_end = group_begin;
+        while (group_end < rows.size() && row_lengths[group_end] == sequence_length) {
+            group_end++;
+        }
+        if (sequence_buckets_.size() > 1) {
+            LEAFRA_DEBUG() << "Embedding " << (group_end - group_begin) << " chunks padded to " << sequence_length << " tokens";
+        }
+        for (size_t begin = group_begin; begin < group_end; begin += batch_size) {
+            jobs.push_back({begin, std::min(begin + batch_size, group_end), sequence_length});
+        }
+        group_begin = group_end;
+    }
+
+    auto store_job = [&](const BatchJob& job, const float* output) {
+        for (size_t i = job.begin; i < job.end; ++i) {
+            store(indices[i], output + (i - job.begin) * dimension);
+            successful++;
+        }
+    };
+    auto retry_individually = [&](const BatchJob& job) {
+        if (job.end - job.begin == 1) {
+            LEAFRA_ERROR() << "Embedding inference failed for chunk " << (indices[job.begin] + 1);
+            return;
+        }
+        // Fall back to one row at a time so one bad sample doesn't drop the whole batch
+        LEAFRA_WARNING() << backend_->getName() << " batch inference failed for " << (job.end - job.begin) << " chunks, retrying individually";
+        for (size_t i = job.begin; i < job.end; ++i) {
+            if (run_batch(rows, i, i + 1, job.sequence_length)) {
+                store(indices[i], output_.data());
+                successful++;
+            } else {
+                LEAFRA_ERROR() << "Embedding inference failed for chunk " << (indices[i] + 1);
+            }
+        }
+    };
+
+    if (inference_thread_ && jobs.size() > 1) {
+        // Failed batches are retried once the pipeline has drained, so the backend never runs two calls at once
+        for (size_t failed : run_pipelined(rows, jobs, store_job, bulk_lock)) {
+            retry_individually(jobs[failed]);
+        }
+        return successful;
+    }
+
+    for (const BatchJob& job : jobs) {
+        yield_to_interactive(bulk_lock);
+        if (run_batch(rows, job.begin, job.end, job.sequence_length)) {
+            store_job(job, output_.data());
+        } else {
+            retry_individually(job);
+        }
+    }
+    return successful;
+} //embed_rows
+
+bool EmbeddingScheduler::embed_tokens(const std::vector<int>& token_ids, std::vector<float>& embedding) {
+    if (!is_ready() || token_ids.empty() || !backend_->requiresTokenIds()) {
+        return false;
+    }
+    InteractiveCall interactive(*this);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return run_single({token_ids.data(), token_ids.size(), std::string_view()}, select_sequence_length(token_ids.size()), embedding);
+} //embed_tokens
+
+bool EmbeddingScheduler::embed_text(std::string_view text, std::vector<float>& embedding) {
+    if (!is_ready() || text.empty() || backend_->requiresTokenIds()) {
+        return false;
+    }
+    InteractiveCall interactive(*this);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return run_single({nullptr, 0, text}, 0, embedding);
+} //embed_text
+
+bool EmbeddingScheduler::run_single(const PendingRow& pending, size_t sequence_length, std::vector<float>& embedding) {
+    // One-row batch through the preallocated buffers: no per-call allocation once warmed up
+    single_row_.resize(1);
+    single_row_[0] = pending;
+    if (!run_batch(single_row_, 0, 1, sequence_length)) {
+        return false;
+    }
+    embedding.assign(output_.begin(), output_.begin() + backend_->getEmbeddingDimension());
+    return true;
+} //run_single
+
+std::vector<size_t> EmbeddingScheduler::run_pipelined(const std::vector<PendingRow>& rows, const std::vector<BatchJob>& jobs,
+                                                      const std::function<void(const BatchJob& job, const float* output)>& store_job,
+                                                      std::unique_lock<std::mutex>* bulk_lock) {
+    // Batch N runs on the inference thread while this thread pads batch N + 1 and stores batch N - 1;
+    // results are consumed in submission order
+    size_t depth = std::min(options_.pipeline_depth, jobs.size());
+    if (slots_.size() < depth) {
+        slots_.resize(depth);
+    }
+    size_t dimension = backend_->getEmbeddingDimension();
+    std::vector<size_t> failed;
+    size_t next_submit = 0;
+
+    for (size_t next_complete = 0; next_complete < jobs.size(); ++next_complete) {
+        // A waiting query stops the pipeline from being topped up; once it has drained, step aside
+        if (next_submit == next_complete) {
+            yield_to_interactive(bulk_lock);
+        }
+        while (next_submit < jobs.size() && next_submit - next_complete < depth &&
+               (next_submit == next_complete || !bulk_lock || interactive_waiting_.load() == 0)) {
+            const BatchJob& job = jobs[next_submit];
+            BatchSlot* slot = &slots_[next_submit % depth];
+            prepare_batch(slot->batch, rows, job.begin, job.end, job.sequence_length);
+            slot->output.resize((job.end - job.begin) * dimension);
+            {
+                std::lock_guard<std::mutex> lock(pipeline_mutex_);
+                slot->done = false;
+            }
+            bool submitted = inference_thread_->submit([this, slot]() {
+                bool ok = infer(slot->batch, slot->output.data());
+                {
+                    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+                    slot->ok = ok;
+                    slot->done = true;
+                }
+                pipeline_cv_.notify_all();
+            });
+            if (!submitted) {
+                inference_thread_->wait_idle();     // Keep backend calls serialized
+                slot->ok = infer(slot->batch, slot->output.data());
+                std::lock_guard<std::mutex> lock(pipeline_mutex_);
+                slot->done = true;
+            }
+            next_submit++;
+        }
+
+        BatchSlot& slot = slots_[next_complete % depth];
+        {
+            std::unique_lock<std::mutex> lock(pipeline_mutex_);
+            pipeline_cv_.wait(lock, [&slot]() { return slot.done; });
+        }
+        const BatchJob& job = jobs[next_complete];
+        if (!slot.ok) {
+            failed.push_back(next_complete);
+            continue;
+        }
+        if (options_.normalize && !backend_->normalizesOutput()) {
+            simd::l2_normalize_rows(slot.output.data(), job.end - job.begin, dimension);
+        }
+        store_job(job, slot.output.data());
+    }
+    return failed;
+} //run_pipelined
+
+void EmbeddingScheduler::yield_to_interactive(std::unique_lock<std::mutex>* bulk_lock) {
+    if (!bulk_lock || interactive_waiting_.load() == 0) {
+        return;
+    }
+    bulk_lock->unlock();
+    {
+        std::unique_lock<std::mutex> lock(interactive_mutex_);
+        interactive_cv_.wait(lock, [this]() { return interactive_waiting_.load() == 0; });
+    }
+    bulk_lock->lock();
+} //yield_to_interactive
+
+EmbeddingScheduler::InteractiveCall::InteractiveCall(EmbeddingScheduler& scheduler) : scheduler_(scheduler) {
+    scheduler_.interactive_waiting_++;
+}
+
+EmbeddingScheduler::InteractiveCall::~InteractiveCall() {
+    {
+        std::lock_guard<std::mutex> lock(scheduler_.interactive_mutex_);
+        scheduler_.interactive_waiting_--;
+    }
+    scheduler_.interactive_cv_.notify_all();
+}
+
+bool EmbeddingScheduler::run_batch(const std::vector<PendingRow>& rows, size_t begin, size_t end, size_t sequence_length) {
+    size_t count = end - begin;
+    prepare_batch(batch_, rows, begin, end, sequence_length);
+    output_.resize(count * backend_->getEmbeddingDimension());
+
+    bool ok = infer(batch_, output_.data());
+    if (ok && options_.normalize && !backend_->normalizesOutput()) {
+        simd::l2_normalize_rows(output_.data(), count, backend_->getEmbeddingDimension());
+    }
+    return ok;
+} //run_batch
+
+bool EmbeddingScheduler::infer(const EmbeddingBatch& batch, float* output) {
+    auto inference_start = debug::timer::now();
+    bool ok = backend_->embedBatch(batch, output);
+    double inference_ms = debug::timer::elapsed_milliseconds(inference_start, debug::timer::now());
+    LEAFRA_DEBUG_LOG("TIMING", backend_->getName() + " batch of " + std::to_string(batch.rows) + " inference: " + std::to_string(inference_ms) + "ms");
+    return ok;
+} //infer
+
+void EmbeddingScheduler::prepare_batch(EmbeddingBatch& batch, const std::vector<PendingRow>& rows, size_t begin, size_t end, size_t sequence_length) {
+    size_t count = end - begin;
+    if (!backend_->requiresTokenIds()) {
+        sequence_length = 0;
+    }
+
+    // Size the reusable buffers (no reallocation once they've reached the largest batch)
+    batch.rows = count;
+    batch.sequence_length = sequence_length;
+    batch.token_ids.resize(count * sequence_length);
+    batch.attention_mask.resize(count * sequence_length);
+    batch.lengths.resize(count);
+    batch.texts.resize(backend_->requiresTokenIds() ? 0 : count);
+    for (size_t i = begin; i < end; ++i) {
+        fill_row(batch, i - begin, rows[i]);
+    }
+} //prepare_batch
+
+void EmbeddingScheduler::fill_row(EmbeddingBatch& batch, size_t row, const PendingRow& pending) {
+    if (!backend_->requiresTokenIds()) {
+        batch.texts[row].assign(pending.text.data(), pending.text.size());
+        batch.lengths[row] = pending.text.size();
+        return;
+    }
+
+    // Pad/trim to the batch's bucket length and build the attention mask
+    size_t sequence_length = batch.sequence_length;
+    size_t real_count = std::min(pending.token_count, sequence_length);
+
+    int32_t* tokens = batch.token_ids.data() + row * sequence_length;
+    int32_t* mask = batch.attention_mask.data() + row * sequence_length;
+    std::copy(pending.token_ids, pending.token_ids + real_count, tokens);
+    std::fill(tokens + real_count, tokens + sequence_length, options_.pad_token);
+    std::fill(mask, mask + real_count, 1);
+    std::fill(mask + real_count, mask + sequence_length, 0);
+    batch.lengths[row] = real_count;
+} //fill_row
+
+} // namespace leafra
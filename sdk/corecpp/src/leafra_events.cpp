@@ -0,0 +1,128 @@
+#include "leafra/leafra_events.h"
+#include "leafra/logger.h"
+
+#include <chrono>
+
+namespace leafra {
+
+EventDispatcher::~EventDispatcher() {
+    stop_thread();
+}
+
+void EventDispatcher::set_handler(event_callback_t handler) {
+    std::lock_guard<std::recursive_mutex> lock(handler_mutex_);
+    handler_ = std::move(handler);
+}
+
+void EventDispatcher::configure(bool async, size_t capacity, bool coalesce_progress) {
+    if (!async) {
+        stop_thread();
+        return;
+    }
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    capacity_ = capacity > 0 ? capacity : 1;
+    coalesce_progress_ = coalesce_progress;
+    if (!thread_.joinable()) {
+        stopping_ = false;
+        thread_ = std::thread([this] { dispatch_loop(); });
+        async_.store(true, std::memory_order_relaxed);
+    }
+    not_full_.notify_all();
+}
+
+void EventDispatcher::post(EventType type, std::string message, std::string file_path) {
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    Event event(type, std::move(message), std::move(file_path), static_cast<int64_t>(now));
+
+    if (async_.load(std::memory_order_relaxed)) {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        if (thread_.joinable() && !stopping_) {
+            bool progress = type == EventType::INGESTION_PROGRESS;
+            if (progress && coalesce_progress_ && !queue_.empty() && queue_.back().type == EventType::INGESTION_PROGRESS) {
+                queue_.back() = std::move(event);
+                coalesced_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            // The dispatcher thread itself (a handler calling back into the SDK) must never wait for itself
+            bool on_dispatcher = std::this_thread::get_id() == thread_.get_id();
+            if (queue_.size() >= capacity_ && !on_dispatcher) {
+                if (progress) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                not_full_.wait(lock, [this] { return stopping_ || queue_.size() < capacity_; });
+            }
+            if (!stopping_) {
+                queue_.push_back(std::move(event));
+                not_empty_.notify_one();
+                return;
+            }
+        }
+    }
+    deliver(event);
+} //post
+
+void EventDispatcher::flush() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    if (!thread_.joinable() || std::this_thread::get_id() == thread_.get_id()) {
+        return;
+    }
+    idle_.wait(lock, [this] { return queue_.empty() && !delivering_; });
+}
+
+void EventDispatcher::deliver(const Event& event) {
+    std::lock_guard<std::recursive_mutex> lock(handler_mutex_);
+    if (!handler_) {
+        return;
+    }
+    try {
+        handler_(event);
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "Event callback threw: " << e.what();
+    } catch (...) {
+        LEAFRA_ERROR() << "Event callback threw an unknown exception";
+    }
+}
+
+void EventDispatcher::dispatch_loop() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    while (true) {
+        not_empty_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            break;  // Stopping and fully drained
+        }
+        Event event = std::move(queue_.front());
+        queue_.pop_front();
+        delivering_ = true;
+        not_full_.notify_one();
+        lock.unlock();
+        deliver(event);
+        lock.lock();
+        delivering_ = false;
+        if (queue_.empty()) {
+            idle_.notify_all();
+        }
+    }
+    idle_.notify_all();
+} //dispatch_loop
+
+void EventDispatcher::stop_thread() {
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!thread_.joinable()) {
+            return;
+        }
+        if (std::this_thread::get_id() == thread_.get_id()) {
+            return;  // Can't join from a handler; the owner stops the thread later
+        }
+        stopping_ = true;
+        async_.store(false, std::memory_order_relaxed);
+        thread = std::move(thread_);
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+    thread.join();
+}
+
+} // namespace leafra
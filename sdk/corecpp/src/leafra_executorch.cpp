@@ -0,0 +1,349 @@
+#include "leafra/leafra_executorch.h"
+#include "leafra/logger.h"
+#include "leafra/leafra_trace.h"
+#include "leafra/leafra_model_registry.h"
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+// ExecuTorch runtime headers
+#include <executorch/extension/data_loader/mmap_data_loader.h>
+#include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
+#include <executorch/extension/tensor/tensor.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/platform/runtime.h>
+
+// The shared CPU threadpool (XNNPACK, optimized kernels) is only there when the prebuilt ships it
+#if __has_include(<executorch/extension/threadpool/threadpool.h>)
+#include <executorch/extension/threadpool/threadpool.h>
+#define LEAFRA_EXECUTORCH_HAS_THREADPOOL 1
+#endif
+
+namespace leafra {
+
+namespace {
+
+using executorch::aten::ScalarType;
+using executorch::extension::MallocMemoryAllocator;
+using executorch::extension::MmapDataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::HierarchicalAllocator;
+using executorch::runtime::MemoryManager;
+using executorch::runtime::Method;
+using executorch::runtime::MethodMeta;
+using executorch::runtime::Program;
+using executorch::runtime::Span;
+using executorch::runtime::TensorInfo;
+
+template<typename T>
+void writeRow(T* row_data, size_t length, const int* values, size_t count, int pad_value) {
+    size_t real = std::min(count, length);
+    for (size_t i = 0; i < real; ++i) {
+        row_data[i] = static_cast<T>(values[i]);
+    }
+    std::fill(row_data + real, row_data + length, static_cast<T>(pad_value));
+}
+
+template<typename T>
+void writeMask(T* row_data, size_t length, size_t real_count) {
+    size_t real = std::min(real_count, length);
+    std::fill(row_data, row_data + real, static_cast<T>(1));
+    std::fill(row_data + real, row_data + length, static_cast<T>(0));
+}
+
+std::string errorName(Error error) {
+    return "error " + std::to_string(static_cast<int>(error));
+}
+
+} // namespace
+
+/**
+ * @brief Memory-mapped .pte file and the program parsed from it (read-only, shared between methods)
+ */
+struct ExecuTorchProgram {
+    std::unique_ptr<MmapDataLoader> loader;     // Program keeps a pointer to it
+    std::optional<Program> program;
+};
+
+struct ExecuTorchModel::Impl {
+    // Exported static shape of one input or output
+    struct TensorShape {
+        std::vector<int32_t> dims;
+        ScalarType type = ScalarType::Float;
+        size_t row_elements = 1;                // Elements per sample (product of dims[1..])
+        size_t element_size = 0;
+    };
+
+    std::shared_ptr<ExecuTorchProgram> program;
+    MallocMemoryAllocator method_allocator;
+    MallocMemoryAllocator temp_allocator;       // Scratch for delegates and kernels, reset by the runtime per execute
+    std::vector<std::vector<uint8_t>> planned_buffers;
+    std::vector<Span<uint8_t>> planned_spans;
+    std::unique_ptr<HierarchicalAllocator> planned_memory;
+    std::unique_ptr<MemoryManager> memory_manager;
+    std::vector<std::vector<uint8_t>> io_buffers;   // Inputs / outputs the memory plan leaves to the caller
+    std::vector<executorch::extension::TensorPtr> bound_inputs;
+    std::vector<TensorShape> inputs;
+    std::vector<TensorShape> outputs;
+    std::vector<std::string> backends;
+    std::optional<Method> method;               // Released first (~Impl)
+    size_t batch_size = 0;
+    size_t sequence_length = 0;
+
+    ~Impl() {
+        method.reset();
+    }
+
+    static TensorShape shapeOf(const TensorInfo& info) {
+        TensorShape shape;
+        shape.dims.assign(info.sizes().begin(), info.sizes().end());
+        shape.type = info.scalar_type();
+        size_t numel = 1;
+        for (size_t d = 0; d < shape.dims.size(); ++d) {
+            numel *= static_cast<size_t>(std::max(0, shape.dims[d]));
+            if (d > 0) {
+                shape.row_elements *= static_cast<size_t>(std::max(0, shape.dims[d]));
+            }
+        }
+        shape.element_size = numel > 0 ? info.nbytes() / numel : 0;
+        return shape;
+    }
+
+    void loadMethod(const Options& options) {
+        const Program& loaded = *program->program;
+        auto meta_result = loaded.method_meta(options.method_name.c_str());
+        if (!meta_result.ok()) {
+            throw std::runtime_error("ExecuTorch program has no method '" + options.method_name + "'");
+        }
+        const MethodMeta meta = meta_result.get();
+
+        // Memory-planned activations: one buffer per planned arena, allocated once for the method's lifetime
+        for (size_t i = 0; i < meta.num_memory_planned_buffers(); ++i) {
+            auto size = meta.memory_planned_buffer_size(i);
+            if (!size.ok()) {
+                throw std::runtime_error("Failed to read ExecuTorch planned buffer size " + std::to_string(i));
+            }
+            planned_buffers.emplace_back(static_cast<size_t>(size.get()));
+        }
+        for (auto& buffer : planned_buffers) {
+            planned_spans.emplace_back(buffer.data(), buffer.size());
+        }
+        planned_memory = std::make_unique<HierarchicalAllocator>(Span<Span<uint8_t>>(planned_spans.data(), planned_spans.size()));
+        memory_manager = std::make_unique<MemoryManager>(&method_allocator, planned_memory.get(), &temp_allocator);
+
+        for (size_t i = 0; i < meta.num_backends(); ++i) {
+            auto name = meta.get_backend_name(i);
+            if (name.ok()) {
+                backends.emplace_back(name.get());
+            }
+        }
+
+        auto method_result = loaded.load_method(options.method_name.c_str(), memory_manager.get());
+        if (!method_result.ok()) {
+            std::string delegates;
+            for (const auto& backend : backends) {
+                delegates += (delegates.empty() ? "" : ", ") + backend;
+            }
+            throw std::runtime_error("Failed to load ExecuTorch method '" + options.method_name + "' (" +
+                                     errorName(method_result.error()) + ")" +
+                                     (delegates.empty() ? "" : "; is every delegate it uses linked in? (" + delegates + ")"));
+        }
+        method.emplace(std::move(method_result.get()));
+
+        // Inputs the memory plan does not cover are bound once to buffers owned here and filled in place afterwards
+        for (size_t i = 0; i < meta.num_inputs(); ++i) {
+            auto info = meta.input_tensor_meta(i);
+            if (!info.ok()) {
+                throw std::runtime_error("ExecuTorch input " + std::to_string(i) + " is not a tensor");
+            }
+            inputs.push_back(shapeOf(info.get()));
+            if (info->is_memory_planned()) {
+                continue;
+            }
+            io_buffers.emplace_back(info->nbytes());
+            std::vector<executorch::aten::SizesType> sizes(inputs.back().dims.begin(), inputs.back().dims.end());
+            bound_inputs.push_back(executorch::extension::from_blob(io_buffers.back().data(), sizes, inputs.back().type));
+            Error status = method->set_input(executorch::runtime::EValue(*bound_inputs.back()), i);
+            if (status != Error::Ok) {
+                throw std::runtime_error("Failed to bind ExecuTorch input " + std::to_string(i) + " (" + errorName(status) + ")");
+            }
+        }
+        for (size_t i = 0; i < meta.num_outputs(); ++i) {
+            auto info = meta.output_tensor_meta(i);
+            if (!info.ok()) {
+                throw std::runtime_error("ExecuTorch output " + std::to_string(i) + " is not a tensor");
+            }
+            outputs.push_back(shapeOf(info.get()));
+            if (info->is_memory_planned()) {
+                continue;
+            }
+            io_buffers.emplace_back(info->nbytes());
+            Error status = method->set_output_data_ptr(io_buffers.back().data(), io_buffers.back().size(), i);
+            if (status != Error::Ok) {
+                throw std::runtime_error("Failed to bind ExecuTorch output " + std::to_string(i) + " (" + errorName(status) + ")");
+            }
+        }
+
+        if (!inputs.empty()) {
+            batch_size = !inputs[0].dims.empty() ? static_cast<size_t>(inputs[0].dims[0]) : 1;
+            sequence_length = inputs[0].dims.size() > 1 ? static_cast<size_t>(inputs[0].dims[1]) : 1;
+        }
+    }
+
+    void* rowPointer(size_t input_index, size_t row, size_t& length) {
+        if (!method || input_index >= inputs.size()) {
+            throw std::runtime_error("ExecuTorch input index out of range: " + std::to_string(input_index));
+        }
+        if (row >= batch_size) {
+            throw std::runtime_error("ExecuTorch row " + std::to_string(row) + " out of range for batch of " + std::to_string(batch_size));
+        }
+        executorch::aten::Tensor tensor = method->mutable_input(input_index).toTensor();
+        char* data = static_cast<char*>(tensor.mutable_data_ptr());
+        if (!data) {
+            throw std::runtime_error("ExecuTorch input tensor is not allocated");
+        }
+        const TensorShape& shape = inputs[input_index];
+        length = shape.row_elements;
+        return data + row * length * shape.element_size;
+    }
+};
+
+ExecuTorchModel::ExecuTorchModel(const std::string& model_path, const Options& options)
+    : pImpl(std::make_unique<Impl>()) {
+    static std::once_flag runtime_once;
+    std::call_once(runtime_once, []() { executorch::runtime::runtime_init(); });
+
+#ifdef LEAFRA_EXECUTORCH_HAS_THREADPOOL
+    // Process-wide pool shared by every ExecuTorch method
+    if (options.num_threads > 0) {
+        executorch::extension::threadpool::get_threadpool()->_unsafe_reset_threadpool(static_cast<uint32_t>(options.num_threads));
+    }
+#endif
+
+    pImpl->program = ModelRegistry<ExecuTorchProgram>::instance().acquire(model_path, [&]() -> std::shared_ptr<ExecuTorchProgram> {
+        auto loader = MmapDataLoader::from(model_path.c_str(), MmapDataLoader::MlockConfig::NoMlock);
+        if (!loader.ok()) {
+            return nullptr;
+        }
+        auto holder = std::make_shared<ExecuTorchProgram>();
+        holder->loader = std::make_unique<MmapDataLoader>(std::move(loader.get()));
+        auto loaded = Program::load(holder->loader.get());
+        if (!loaded.ok()) {
+            LEAFRA_ERROR() << "ExecuTorch program load failed (" << errorName(loaded.error()) << "): " << model_path;
+            return nullptr;
+        }
+        holder->program.emplace(std::move(loaded.get()));
+        return holder;
+    });
+    if (!pImpl->program) {
+        throw std::runtime_error("Failed to load ExecuTorch program from: " + model_path);
+    }
+
+    pImpl->loadMethod(options);
+
+    LEAFRA_DEBUG() << "ExecuTorch model loaded: " << model_path << " (method: " << options.method_name
+                   << ", inputs: " << getInputCount() << ", outputs: " << getOutputCount()
+                   << ", batch: " << pImpl->batch_size << ")";
+}
+
+ExecuTorchModel::~ExecuTorchModel() = default;
+ExecuTorchModel::ExecuTorchModel(ExecuTorchModel&&) noexcept = default;
+ExecuTorchModel& ExecuTorchModel::operator=(ExecuTorchModel&&) noexcept = default;
+
+bool ExecuTorchModel::isValid() const {
+    return pImpl && pImpl->method.has_value();
+}
+
+size_t ExecuTorchModel::getInputCount() const {
+    return isValid() ? pImpl->inputs.size() : 0;
+}
+
+size_t ExecuTorchModel::getOutputCount() const {
+    return isValid() ? pImpl->outputs.size() : 0;
+}
+
+size_t ExecuTorchModel::getInputSequenceLength(size_t index) const {
+    return index < getInputCount() ? pImpl->inputs[index].row_elements : 0;
+}
+
+size_t ExecuTorchModel::getOutputSize(size_t index) const {
+    return index < getOutputCount() ? pImpl->outputs[index].row_elements : 0;
+}
+
+std::vector<int32_t> ExecuTorchModel::getOutputDims(size_t index) const {
+    return index < getOutputCount() ? pImpl->outputs[index].dims : std::vector<int32_t>();
+}
+
+size_t ExecuTorchModel::getBatchSize() const {
+    return pImpl ? pImpl->batch_size : 0;
+}
+
+size_t ExecuTorchModel::getSequenceLength() const {
+    return pImpl ? pImpl->sequence_length : 0;
+}
+
+std::vector<std::string> ExecuTorchModel::getBackendNames() const {
+    return pImpl ? pImpl->backends : std::vector<std::string>();
+}
+
+void ExecuTorchModel::setTokenRow(size_t input_index, size_t row, const int* token_ids, size_t count, int pad_value) {
+    size_t length = 0;
+    void* row_data = pImpl->rowPointer(input_index, row, length);
+    switch (pImpl->inputs[input_index].type) {
+        case ScalarType::Int: writeRow(static_cast<int32_t*>(row_data), length, token_ids, count, pad_value); break;
+        case ScalarType::Long: writeRow(static_cast<int64_t*>(row_data), length, token_ids, count, pad_value); break;
+        case ScalarType::Float: writeRow(static_cast<float*>(row_data), length, token_ids, count, pad_value); break;
+        default:
+            throw std::runtime_error("Unsupported ExecuTorch input type for input " + std::to_string(input_index));
+    }
+}
+
+void ExecuTorchModel::setMaskRow(size_t input_index, size_t row, size_t real_count) {
+    size_t length = 0;
+    void* row_data = pImpl->rowPointer(input_index, row, length);
+    switch (pImpl->inputs[input_index].type) {
+        case ScalarType::Int: writeMask(static_cast<int32_t*>(row_data), length, real_count); break;
+        case ScalarType::Long: writeMask(static_cast<int64_t*>(row_data), length, real_count); break;
+        case ScalarType::Float: writeMask(static_cast<float*>(row_data), length, real_count); break;
+        default:
+            throw std::runtime_error("Unsupported ExecuTorch input type for input " + std::to_string(input_index));
+    }
+}
+
+void ExecuTorchModel::fillRow(size_t input_index, size_t row, int value) {
+    setTokenRow(input_index, row, nullptr, 0, value);
+}
+
+void ExecuTorchModel::execute() {
+    if (!isValid()) {
+        throw std::runtime_error("Invalid ExecuTorch model");
+    }
+    LEAFRA_TRACE_SCOPE("executorch", "execute");
+    Error status = pImpl->method->execute();
+    if (status != Error::Ok) {
+        throw std::runtime_error("ExecuTorch execution failed (" + errorName(status) + ")");
+    }
+}
+
+const float* ExecuTorchModel::getOutputRow(size_t output_index, size_t row) const {
+    if (output_index >= getOutputCount()) {
+        throw std::runtime_error("ExecuTorch output index out of range: " + std::to_string(output_index));
+    }
+    const Impl::TensorShape& shape = pImpl->outputs[output_index];
+    if (shape.type != ScalarType::Float) {
+        throw std::runtime_error("ExecuTorch output " + std::to_string(output_index) + " is not float32");
+    }
+    if (row >= pImpl->batch_size) {
+        throw std::runtime_error("ExecuTorch output row " + std::to_string(row) + " out of range");
+    }
+    const float* data = pImpl->method->get_output(output_index).toTensor().const_data_ptr<float>();
+    if (!data) {
+        throw std::runtime_error("ExecuTorch output tensor is not allocated");
+    }
+    return data + row * shape.row_elements;
+}
+
+} // namespace leafra
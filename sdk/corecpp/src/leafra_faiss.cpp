@@ -3,22 +3,60 @@
 #ifdef LEAFRA_HAS_FAISS
 
 #include "leafra/logger.h"
+#include "leafra/leafra_trace.h"
 #include "leafra/leafra_sqlite.h"
+#include "leafra/leafra_filemanager.h"
+#include "leafra/leafra_simd.h"
+#include "leafra/leafra_large_pages.h"
+#ifdef LEAFRA_HAS_METAL
+#include "leafra/leafra_metal_search.h"
+#endif
 #include <faiss/IndexFlat.h>
+#include <faiss/IndexIVF.h>
 #include <faiss/IndexIVFFlat.h>
 #include <faiss/IndexIVFPQ.h>
 #include <faiss/IndexHNSW.h>  // Now supported with OpenMP xcframework
 #include <faiss/IndexLSH.h>
+#include <faiss/IndexScalarQuantizer.h>
 #include <faiss/IndexIDMap.h>
+#include <faiss/invlists/OnDiskInvertedLists.h>
 #include <faiss/index_io.h>
 #include <faiss/impl/io.h>
+#include <faiss/impl/IDSelector.h>
 #include <faiss/MetricType.h>
 #include <faiss/utils/utils.h>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
 #include <stdexcept>
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <sys/mman.h>
+#ifdef __APPLE__
+#include <sys/clonefile.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace leafra {
 
+// Team size of this thread's next FAISS parallel regions (OpenMP keeps it per calling thread)
+static void use_omp_threads(int threads) {
+#ifdef _OPENMP
+    if (threads > 0 && omp_get_max_threads() != threads) {
+        omp_set_num_threads(threads);
+    }
+#else
+    (void)threads;
+#endif
+}
+
 // Helper function to detect index type from a loaded FAISS index
 static std::pair<FaissIndex::IndexType, bool> detect_index_type_safe(const faiss::Index* index) {
     if (!index) {
@@ -44,8 +82,21 @@ static std::pair<FaissIndex::IndexType, bool> detect_index_type_safe(const faiss
         return {FaissIndex::IndexType::IVF_PQ, true};
     } else if (dynamic_cast<const faiss::IndexHNSWFlat*>(actual_index)) {
         return {FaissIndex::IndexType::HNSW, true};
-    } else if (dynamic_cast<const faiss::IndexLSH*>(actual_index)) {
+    } else if (const auto* lsh = dynamic_cast<const faiss::IndexLSH*>(actual_index)) {
+        // BINARY is an LSH index of one unrotated sign bit per dimension
+        if (!lsh->rotate_data && !lsh->train_thresholds && lsh->nbits == lsh->d) {
+            return {FaissIndex::IndexType::BINARY, true};
+        }
         return {FaissIndex::IndexType::LSH, true};
+    } else if (dynamic_cast<const faiss::IndexHNSWSQ*>(actual_index)) {
+        return {FaissIndex::IndexType::HNSW_SQ, true};
+    } else if (const auto* sq = dynamic_cast<const faiss::IndexScalarQuantizer*>(actual_index)) {
+        if (sq->sq.qtype == faiss::ScalarQuantizer::QT_8bit) {
+            return {FaissIndex::IndexType::SQ8, true};
+        }
+        if (sq->sq.qtype == faiss::ScalarQuantizer::QT_fp16) {
+            return {FaissIndex::IndexType::SQ_FP16, true};
+        }
     }
     
     // Unknown type - return error flag
@@ -60,76 +111,355 @@ static std::string index_type_to_string(FaissIndex::IndexType type) {
         case FaissIndex::IndexType::IVF_PQ: return "IndexIVFPQ";
         case FaissIndex::IndexType::HNSW: return "IndexHNSWFlat";
         case FaissIndex::IndexType::LSH: return "IndexLSH";
+        case FaissIndex::IndexType::SQ8: return "IndexSQ8";
+        case FaissIndex::IndexType::SQ_FP16: return "IndexSQfp16";
+        case FaissIndex::IndexType::HNSW_SQ: return "IndexHNSWSQ";
+        case FaissIndex::IndexType::BINARY: return "IndexBinarySign";
         default: return "Unknown";
     }
 }
 
+// Serialized indexes move between FAISS and faissindextable.faissdata in pieces of this size
+static constexpr size_t kBlobStreamChunkBytes = 1 << 20;
+
+// Counts the bytes write_index produces, so the BLOB can be reserved before the real pass
+struct CountingIOWriter : faiss::IOWriter {
+    size_t size = 0;
+    
+    size_t operator()(const void* ptr, size_t item_size, size_t nitems) override {
+        size += item_size * nitems;
+        return nitems;
+    }
+};
+
+// Streams a serialized index into a reserved BLOB through a fixed-size buffer
+struct BlobIOWriter : faiss::IOWriter {
+    SQLiteDatabase::BlobHandle* blob = nullptr;
+    std::vector<uint8_t> buffer;
+    size_t offset = 0;              // BLOB bytes written so far
+    
+    size_t operator()(const void* ptr, size_t item_size, size_t nitems) override {
+        const uint8_t* bytes = static_cast<const uint8_t*>(ptr);
+        size_t remaining = item_size * nitems;
+        if (remaining >= kBlobStreamChunkBytes) {
+            // Large arrays (vectors, codes) go straight to the pages
+            if (!flush() || !blob->write(bytes, remaining, offset)) {
+                return 0;
+            }
+            offset += remaining;
+            return nitems;
+        }
+        if (buffer.size() + remaining > kBlobStreamChunkBytes && !flush()) {
+            return 0;
+        }
+        buffer.insert(buffer.end(), bytes, bytes + remaining);
+        return nitems;
+    }
+    
+    bool flush() {
+        if (buffer.empty()) {
+            return true;
+        }
+        if (!blob->write(buffer.data(), buffer.size(), offset)) {
+            return false;
+        }
+        offset += buffer.size();
+        buffer.clear();
+        return true;
+    }
+};
+
+// Reads a serialized index out of a BLOB in fixed-size pieces
+struct BlobIOReader : faiss::IOReader {
+    SQLiteDatabase::BlobHandle* blob = nullptr;
+    size_t size = 0;
+    size_t offset = 0;              // BLOB bytes consumed, including the buffered ones
+    std::vector<uint8_t> buffer;
+    size_t buffer_position = 0;
+    
+    size_t operator()(void* ptr, size_t item_size, size_t nitems) override {
+        if (item_size == 0) {
+            return 0;
+        }
+        size_t buffered = buffer.size() - buffer_position;
+        size_t count = std::min(nitems, (buffered + (size - offset)) / item_size);
+        uint8_t* out = static_cast<uint8_t*>(ptr);
+        size_t wanted = count * item_size;
+        
+        size_t from_buffer = std::min(wanted, buffered);
+        std::memcpy(out, buffer.data() + buffer_position, from_buffer);
+        buffer_position += from_buffer;
+        out += from_buffer;
+        wanted -= from_buffer;
+        if (wanted >= kBlobStreamChunkBytes) {
+            if (!blob->read(out, wanted, offset)) {
+                return 0;
+            }
+            offset += wanted;
+        } else if (wanted > 0) {
+            buffer.resize(std::min(kBlobStreamChunkBytes, size - offset));
+            if (!blob->read(buffer.data(), buffer.size(), offset)) {
+                return 0;
+            }
+            offset += buffer.size();
+            std::memcpy(out, buffer.data(), wanted);
+            buffer_position = wanted;
+        }
+        return count;
+    }
+};
+
+// Delta log operations (faissdeltatable.op)
+enum DeltaOp {
+    DELTA_OP_ADD = 0,       // ids + vectors added to the index
+    DELTA_OP_REMOVE = 1     // ids removed from the index (tombstones)
+};
+
+// Databases created before the delta log existed don't have the table yet
+static bool ensure_delta_table(SQLiteDatabase& db) {
+    return db.execute(
+        "CREATE TABLE IF NOT EXISTS faissdeltatable ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+        "definition TEXT NOT NULL, "
+        "op INTEGER NOT NULL, "
+        "count INTEGER NOT NULL, "
+        "ids BLOB NOT NULL, "
+        "vectors BLOB)") &&
+        db.execute("CREATE INDEX IF NOT EXISTS idx_faiss_delta_definition ON faissdeltatable(definition, id)");
+}
+
+// Append one batch to the delta log - a single INSERT, so it joins the caller's transaction if one is open
+static ResultCode append_delta(SQLiteDatabase& db, const std::string& definition, DeltaOp op,
+                               const int64_t* ids, int count, const float* vectors, int dimension) {
+    if (!ensure_delta_table(db)) {
+        LEAFRA_ERROR() << "Failed to create FAISS delta table: " << db.getLastErrorMessage();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    
+    auto stmt = db.prepareCached("INSERT INTO faissdeltatable (definition, op, count, ids, vectors) VALUES (?, ?, ?, ?, ?)");
+    if (!stmt || !stmt->isValid()) {
+        LEAFRA_ERROR() << "Failed to prepare FAISS delta insert statement";
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    
+    //TODO AD: Native endianness, same as the index blob (only chunk_embeddings rows carry a byte-order tag)
+    const uint8_t* id_bytes = reinterpret_cast<const uint8_t*>(ids);
+    std::vector<uint8_t> id_blob(id_bytes, id_bytes + static_cast<size_t>(count) * sizeof(int64_t));
+    
+    bool bound = stmt->bindText(1, definition) && stmt->bindInt(2, static_cast<int>(op)) &&
+                 stmt->bindInt(3, count) && stmt->bindBlob(4, id_blob);
+    if (vectors) {
+        const uint8_t* vector_bytes = reinterpret_cast<const uint8_t*>(vectors);
+        std::vector<uint8_t> vector_blob(vector_bytes, vector_bytes + static_cast<size_t>(count) * dimension * sizeof(float));
+        bound = bound && stmt->bindBlob(5, vector_blob);
+    } else {
+        bound = bound && stmt->bindNull(5);
+    }
+    if (!bound) {
+        LEAFRA_ERROR() << "Failed to bind parameters for FAISS delta insert";
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    
+    if (!stmt->execute()) {
+        LEAFRA_ERROR() << "Failed to append FAISS delta: " << db.getLastErrorMessage();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    return ResultCode::SUCCESS;
+}
+
+// Highest delta id ever issued (AUTOINCREMENT keeps it monotonic across compactions)
+static int64_t last_delta_id(SQLiteDatabase& db) {
+    auto stmt = db.prepare("SELECT seq FROM sqlite_sequence WHERE name = 'faissdeltatable'");
+    if (stmt && stmt->isValid() && stmt->step()) {
+        return stmt->getCurrentRow().getInt64(0);
+    }
+    return 0;
+}
+
+// Index files are named "<base_path>.<watermark>.faiss": deltas with id <= watermark are already folded in,
+// so the file and the delta log agree even if we crash between writing one and trimming the other
+static std::string index_file_path(const std::string& base_path, int64_t watermark) {
+    return base_path + "." + std::to_string(watermark) + ".faiss";
+}
+
+// On-disk inverted lists of an index file live next to it as "<index file>.ivfdata"
+static std::string lists_file_path(const std::string& index_path) {
+    return index_path + ".ivfdata";
+}
+
+// Copy an index or inverted lists file (an instant copy-on-write clone on APFS)
+static bool clone_faiss_file(const std::string& from, const std::string& to) {
+    std::error_code ec;
+    std::filesystem::remove(to, ec);
+#ifdef __APPLE__
+    if (clonefile(from.c_str(), to.c_str(), 0) == 0) {
+        return true;
+    }
+#endif
+    std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec) {
+        LEAFRA_ERROR() << "Failed to copy FAISS file " << from << " to " << to << ": " << ec.message();
+        return false;
+    }
+    return true;
+}
+
+// IVF index under an optional IndexIDMap, nullptr for other types
+static faiss::IndexIVF* ivf_of(const faiss::Index* index) {
+    const auto* id_map = dynamic_cast<const faiss::IndexIDMap*>(index);
+    return dynamic_cast<faiss::IndexIVF*>(const_cast<faiss::Index*>(id_map ? id_map->index : index));
+}
+
+// Inverted lists of an IVF index when they are kept in a file, else nullptr
+static faiss::OnDiskInvertedLists* on_disk_lists(const faiss::Index* index) {
+    faiss::IndexIVF* ivf = ivf_of(index);
+    return ivf ? dynamic_cast<faiss::OnDiskInvertedLists*>(ivf->invlists) : nullptr;
+}
+
+static std::vector<std::pair<int64_t, std::string>> list_index_files(const std::string& base_path) {
+    std::vector<std::pair<int64_t, std::string>> files;
+    std::filesystem::path base(base_path);
+    std::string prefix = base.filename().string() + ".";
+    const std::string suffix = ".faiss";
+    
+    std::error_code ec;
+    std::filesystem::directory_iterator it(base.has_parent_path() ? base.parent_path() : std::filesystem::path("."), ec);
+    for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+        std::string watermark = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+        if (watermark.find_first_not_of("0123456789") != std::string::npos) {
+            continue;
+        }
+        files.emplace_back(std::stoll(watermark), it->path().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// k-means wants at least this many training vectors per IVF list (FAISS warns below it) and gains little past the cap
+static constexpr int64_t kMinTrainingVectorsPerList = 39;
+static constexpr int64_t kMaxTrainingVectorsPerList = 256;
+
+// Scalar quantizers only learn per-dimension value ranges - a sample this size pins them down
+static constexpr int64_t kMaxScalarQuantizerTrainingVectors = 65536;
+
+// Bi-directional links per node for HNSW and HNSW_SQ graphs
+static constexpr int kHnswM = 16;
+
+// Squared norms within this of 1 count as already unit length (covers fp16/int8 round trips of normalized embeddings)
+static constexpr float kUnitNormTolerance = 1e-3f;
+
+// Per-thread staging for vectors that arrive un-normalized on a COSINE index (reused, so steady state never allocates)
+static std::vector<float>& cosine_scratch() {
+    thread_local std::vector<float> scratch;
+    return scratch;
+}
+
+// Per-thread staging for vectors cut down to a reduced index's dimensions
+static std::vector<float>& reduction_scratch() {
+    thread_local std::vector<float> scratch;
+    return scratch;
+}
+
+// Searches and getters share index_mutex_; writers take it exclusively only to mutate or swap the live index
+using ReadLock = std::shared_lock<std::shared_mutex>;
+using ExclusiveLock = std::unique_lock<std::shared_mutex>;
+
 class FaissIndex::Impl {
 public:
     std::unique_ptr<faiss::Index> index_;
     std::unique_ptr<faiss::IndexIDMap> id_map_index_;
-    int dimension_;
+    int dimension_;                          // Dimensions the FAISS index stores (the leading ones of input_dimension_)
+    int input_dimension_;                    // Dimensions of the vectors callers pass in and search with
     IndexType index_type_;
     MetricType metric_type_;
+    IndexType migration_target_;             // Type a FLAT index may have been migrated to (restores accept it), FLAT if none
     bool use_id_map_;
+    std::atomic<uint64_t> generation_{0};   // Bumped on every content change (add/remove/train/load)
+    std::atomic<int64_t> pending_delta_entries_{0};  // Vectors + tombstones in the delta log since the last full save
+    std::string mapped_file_;                // Index file backing read-only mmapped inverted lists (empty = fully in memory)
+    std::vector<uint8_t> tombstones_;        // Bit per internal offset of a removed vector still stored in the index (IVF/HNSW)
+    int64_t tombstone_count_ = 0;            // Bits set in tombstones_
+    bool ids_ascending_ = true;              // id_map strictly ascending (dense sequence ids) - id lookups binary search it
+    mutable std::shared_mutex index_mutex_;  // Shared by searches, exclusive while the index above is mutated or swapped
+    std::mutex write_mutex_;                 // Serializes writers, so a writer can read the index without index_mutex_
+    std::string on_disk_path_;               // Live file for IVF inverted lists kept on disk ("" = lists on the heap)
+    std::atomic<int> omp_threads_{0};        // OpenMP team per build / batched search call (0 = OpenMP default)
+#ifdef LEAFRA_HAS_METAL
+    std::unique_ptr<MetalFlatSearch> gpu_;   // GPU mirror of a FLAT index (nullptr = CPU search)
+    std::atomic<bool> gpu_active_{false};    // gpu_ is set (checked before taking gpu_mutex_)
+    int64_t gpu_min_vectors_ = 0;
+    std::atomic<uint64_t> appends_{0};       // Content changes that only appended rows (a subset of generation_)
+    uint64_t gpu_generation_ = 0;            // generation_ / appends_ the mirror was last synced at
+    uint64_t gpu_appends_ = 0;
+    mutable std::mutex gpu_mutex_;           // Serializes GPU searches and mirror syncs (searches run under a shared lock)
+#endif
     
-    Impl(int dimension, IndexType index_type, MetricType metric_type)
-        : dimension_(dimension), index_type_(index_type), metric_type_(metric_type), use_id_map_(false) {
+    Impl(int dimension, int index_dimension, IndexType index_type, MetricType metric_type)
+        : dimension_(index_dimension), input_dimension_(dimension), index_type_(index_type), metric_type_(metric_type), migration_target_(index_type),
+          use_id_map_(false) {
         
-        // Convert metric type
-        faiss::MetricType faiss_metric;
-        switch (metric_type) {
-            case MetricType::L2:
-                faiss_metric = faiss::METRIC_L2;
-                break;
-            case MetricType::INNER_PRODUCT:
-                faiss_metric = faiss::METRIC_INNER_PRODUCT;
-                break;
-            case MetricType::COSINE:
-                // FAISS doesn't have native cosine, use inner product with normalized vectors
-                faiss_metric = faiss::METRIC_INNER_PRODUCT;
-                break;
-            default:
-                throw std::invalid_argument("Unsupported metric type");
-        }
+        faiss::MetricType faiss_metric = to_faiss_metric(metric_type);
         
         // Create index based on type
         switch (index_type) {
             case IndexType::FLAT:
-                index_ = std::make_unique<faiss::IndexFlat>(dimension, faiss_metric);
+                index_ = std::make_unique<faiss::IndexFlat>(index_dimension, faiss_metric);
                 break;
                 
             case IndexType::IVF_FLAT: {
                 // Create quantizer and IVF index
-                auto quantizer = std::make_unique<faiss::IndexFlat>(dimension, faiss_metric);
+                auto quantizer = std::make_unique<faiss::IndexFlat>(index_dimension, faiss_metric);
                 int nlist = std::max(1, static_cast<int>(std::sqrt(10000))); // Default nlist
-                index_ = std::make_unique<faiss::IndexIVFFlat>(quantizer.release(), dimension, nlist, faiss_metric);
+                index_ = std::make_unique<faiss::IndexIVFFlat>(quantizer.release(), index_dimension, nlist, faiss_metric);
                 break;
             }
             
             case IndexType::IVF_PQ: {
                 // Create quantizer and IVF-PQ index
-                auto quantizer = std::make_unique<faiss::IndexFlat>(dimension, faiss_metric);
+                auto quantizer = std::make_unique<faiss::IndexFlat>(index_dimension, faiss_metric);
                 int nlist = std::max(1, static_cast<int>(std::sqrt(10000))); // Default nlist
-                int m = std::max(1, dimension / 8); // Number of subquantizers
+                int m = std::max(1, index_dimension / 8); // Number of subquantizers
                 int nbits = 8; // Bits per subquantizer
-                index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer.release(), dimension, nlist, m, nbits, faiss_metric);
+                index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer.release(), index_dimension, nlist, m, nbits, faiss_metric);
                 break;
             }
             
             case IndexType::HNSW: {
                 // Create HNSW index with default parameters
-                int M = 16; // Number of bi-directional links for each node
-                index_ = std::make_unique<faiss::IndexHNSWFlat>(dimension, M, faiss_metric);
+                index_ = std::make_unique<faiss::IndexHNSWFlat>(index_dimension, kHnswM, faiss_metric);
                 break;
             }
             
+            // Scalar quantizers keep 1 (SQ8) or 2 (fp16) bytes per index_dimension instead of 4;
+            // SQ8 ranges are trained, so LeafraCore fills a FLAT index first and migrates to it
+            case IndexType::SQ8:
+                index_ = std::make_unique<faiss::IndexScalarQuantizer>(index_dimension, faiss::ScalarQuantizer::QT_8bit, faiss_metric);
+                break;
+                
+            case IndexType::SQ_FP16:
+                index_ = std::make_unique<faiss::IndexScalarQuantizer>(index_dimension, faiss::ScalarQuantizer::QT_fp16, faiss_metric);
+                break;
+                
+            case IndexType::HNSW_SQ:
+                index_ = std::make_unique<faiss::IndexHNSWSQ>(index_dimension, faiss::ScalarQuantizer::QT_8bit, kHnswM, faiss_metric);
+                break;
+            
             case IndexType::LSH: {
-                int nbits = std::max(8, dimension / 2); // Number of hash bits
-                index_ = std::make_unique<faiss::IndexLSH>(dimension, nbits);
+                int nbits = std::max(8, index_dimension / 2); // Number of hash bits
+                index_ = std::make_unique<faiss::IndexLSH>(index_dimension, nbits);
                 break;
             }
             
+            // Sign bit of every index_dimension, no rotation or trained thresholds: d / 8 bytes per vector, no training
+            case IndexType::BINARY:
+                index_ = std::make_unique<faiss::IndexLSH>(index_dimension, index_dimension, false, false);
+                break;
+            
             default:
                 throw std::invalid_argument("Unsupported index type");
         }
@@ -142,31 +472,754 @@ public:
         enable_id_map();
     }
     
-    void enable_id_map() {
-        if (!use_id_map_) {
-            id_map_index_ = std::make_unique<faiss::IndexIDMap>(index_.release());
-            use_id_map_ = true;
+    static faiss::MetricType to_faiss_metric(MetricType metric_type) {
+        switch (metric_type) {
+            case MetricType::L2:
+                return faiss::METRIC_L2;
+            case MetricType::INNER_PRODUCT:
+                return faiss::METRIC_INNER_PRODUCT;
+            case MetricType::COSINE:
+                // FAISS doesn't have native cosine, use inner product - unit_rows normalizes vectors and queries
+                return faiss::METRIC_INNER_PRODUCT;
+            default:
+                throw std::invalid_argument("Unsupported metric type");
+        }
+    }
+    
+    // A restored index must be of the type we were created with, or the one a migration produced
+    bool accepts_type(IndexType loaded_type) const {
+        return loaded_type == index_type_ || (index_type_ == IndexType::FLAT && loaded_type == migration_target_);
+    }
+    
+    void enable_id_map() {
+        if (!use_id_map_) {
+            id_map_index_ = std::make_unique<faiss::IndexIDMap>(index_.release());
+            use_id_map_ = true;
+        }
+    }
+    
+    faiss::Index* get_index() {
+        return use_id_map_ ? static_cast<faiss::Index*>(id_map_index_.get()) : index_.get();
+    }
+    
+    const faiss::Index* get_index() const {
+        return use_id_map_ ? static_cast<const faiss::Index*>(id_map_index_.get()) : index_.get();
+    }
+    
+    // Heap bytes of one index: stored codes, inverted lists, the HNSW graph (estimated from ntotal for other types)
+    static uint64_t index_memory_bytes(const faiss::Index* index) {
+        if (!index) {
+            return 0;
+        }
+        if (auto id_map = dynamic_cast<const faiss::IndexIDMap*>(index)) {
+            return id_map->id_map.capacity() * sizeof(faiss::idx_t) + index_memory_bytes(id_map->index);
+        }
+        if (auto flat = dynamic_cast<const faiss::IndexFlatCodes*>(index)) {  // FLAT, LSH, scalar quantizer
+            return flat->codes.capacity();
+        }
+        if (auto ivf = dynamic_cast<const faiss::IndexIVF*>(index)) {
+            uint64_t bytes = index_memory_bytes(ivf->quantizer);
+            if (auto lists = dynamic_cast<const faiss::OnDiskInvertedLists*>(ivf->invlists)) {
+                // Pages of the lists file come and go with the OS page cache; only the list table is resident
+                return bytes + lists->lists.capacity() * sizeof(faiss::OnDiskOneList);
+            }
+            if (ivf->invlists) {
+                for (size_t list = 0; list < ivf->invlists->nlist; ++list) {
+                    bytes += ivf->invlists->list_size(list) * (ivf->invlists->code_size + sizeof(faiss::idx_t));
+                }
+            }
+            return bytes;
+        }
+        if (auto hnsw = dynamic_cast<const faiss::IndexHNSW*>(index)) {
+            const faiss::HNSW& graph = hnsw->hnsw;
+            return graph.neighbors.capacity() * sizeof(faiss::HNSW::storage_idx_t) +
+                   graph.offsets.capacity() * sizeof(size_t) +
+                   graph.levels.capacity() * sizeof(int) +
+                   index_memory_bytes(hnsw->storage);
+        }
+        return static_cast<uint64_t>(index->ntotal) * index->d * sizeof(float);
+    }
+    
+    // Advise the buffers index_memory_bytes counts for huge pages (large_pages policy); FAISS owns them, so they are advised in place
+    static void advise_large_pages(const faiss::Index* index) {
+        if (!index) {
+            return;
+        }
+        if (auto id_map = dynamic_cast<const faiss::IndexIDMap*>(index)) {
+            large_pages::advise(id_map->id_map.data(), id_map->id_map.size() * sizeof(faiss::idx_t));
+            advise_large_pages(id_map->index);
+        } else if (auto flat = dynamic_cast<const faiss::IndexFlatCodes*>(index)) {
+            large_pages::advise(flat->codes.data(), flat->codes.size());
+        } else if (auto ivf = dynamic_cast<const faiss::IndexIVF*>(index)) {
+            // Inverted lists are one buffer per list, rarely a huge page each; the centroids are searched for every query
+            advise_large_pages(ivf->quantizer);
+        } else if (auto hnsw = dynamic_cast<const faiss::IndexHNSW*>(index)) {
+            const faiss::HNSW& graph = hnsw->hnsw;
+            large_pages::advise(graph.neighbors.data(), graph.neighbors.size() * sizeof(faiss::HNSW::storage_idx_t));
+            large_pages::advise(graph.offsets.data(), graph.offsets.size() * sizeof(size_t));
+            large_pages::advise(graph.levels.data(), graph.levels.size() * sizeof(int));
+            advise_large_pages(hnsw->storage);
+        }
+    }
+    
+    // After the index grew or was replaced: its buffers may have been reallocated
+    void advise_large_pages() const {
+        if (large_pages::policy() != LargePagePolicy::OFF) {
+            advise_large_pages(get_index());
+        }
+    }
+    
+    // A stored index keeps the dimensions it was built with (any leading subset of the input's)
+    bool accepts_dimension(int dimension) const {
+        return dimension == dimension_ || (dimension > 0 && dimension <= input_dimension_);
+    }
+    
+    // Switch to the stored dimensions of an index being swapped in (caller holds index_mutex_ exclusively)
+    void adopt_dimension(int dimension) {
+        if (dimension == dimension_) {
+            return;
+        }
+        LEAFRA_INFO() << "FAISS index keeps its stored " << dimension << " of " << input_dimension_
+                      << " dimensions (configured " << dimension_ << ") until it is rebuilt";
+        dimension_ = dimension;
+#ifdef LEAFRA_HAS_METAL
+        std::lock_guard<std::mutex> gpu_lock(gpu_mutex_);
+        if (gpu_) {
+            gpu_ = MetalFlatSearch::create(dimension_, metric_type_ != MetricType::L2);
+            gpu_active_ = gpu_ != nullptr;
+            gpu_generation_ = generation_.load() - 1;
+        }
+#endif
+    }
+    
+    void adopt(std::unique_ptr<faiss::Index> loaded_index) {
+        adopt_dimension(loaded_index->d);
+        auto [loaded_type, type_detected] = detect_index_type_safe(loaded_index.get());
+        if (type_detected) {
+            index_type_ = loaded_type;
+        }
+        if (dynamic_cast<faiss::IndexIDMap*>(loaded_index.get())) {
+            id_map_index_ = std::unique_ptr<faiss::IndexIDMap>(static_cast<faiss::IndexIDMap*>(loaded_index.release()));
+            index_.reset();
+            use_id_map_ = true;
+        } else {
+            index_ = std::move(loaded_index);
+            id_map_index_.reset();
+            use_id_map_ = false;
+            enable_id_map();
+        }
+    }
+    
+    // IVF lists don't renumber on remove_ids (IndexIDMap's id map would go out of sync) and HNSW can't remove at all
+    bool uses_tombstones() const {
+        return index_type_ == IndexType::IVF_FLAT || index_type_ == IndexType::IVF_PQ || index_type_ == IndexType::HNSW ||
+               index_type_ == IndexType::HNSW_SQ;
+    }
+    
+    bool is_tombstoned(size_t offset) const {
+        return (offset >> 3) < tombstones_.size() && (tombstones_[offset >> 3] & (1u << (offset & 7))) != 0;
+    }
+    
+    // Recheck the id order after the whole id map was replaced (load, restore)
+    void refresh_id_order() {
+        const auto& id_map = id_map_index_->id_map;
+        ids_ascending_ = std::adjacent_find(id_map.begin(), id_map.end(),
+                                            [](faiss::idx_t a, faiss::idx_t b) { return a >= b; }) == id_map.end();
+    }
+    
+    // Track the id order across an append of count ids starting at first_offset
+    void track_id_order(const faiss::idx_t* ids, int count, size_t first_offset) {
+        if (!ids_ascending_ || count <= 0) {
+            return;
+        }
+        const auto& id_map = id_map_index_->id_map;
+        bool ascending = first_offset == 0 || id_map[first_offset - 1] < ids[0];
+        for (int i = 1; ascending && i < count; ++i) {
+            ascending = ids[i - 1] < ids[i];
+        }
+        ids_ascending_ = ascending;
+    }
+    
+    bool set_tombstone(size_t offset) {
+        if (is_tombstoned(offset)) {
+            return false;
+        }
+        if ((offset >> 3) >= tombstones_.size()) {
+            tombstones_.resize((id_map_index_->id_map.size() + 7) >> 3, 0);
+        }
+        tombstones_[offset >> 3] |= static_cast<uint8_t>(1u << (offset & 7));
+        return true;
+    }
+    
+    // Tombstone every stored vector carrying one of the ids - offsets, not ids, so a re-added id stays live
+    int64_t mark_tombstones(const int64_t* ids, int count) {
+        const auto& id_map = id_map_index_->id_map;
+        int64_t marked = 0;
+        if (ids_ascending_) {
+            // Sequence-allocated ids: each id is stored at most once, found by binary search
+            for (int i = 0; i < count; ++i) {
+                auto it = std::lower_bound(id_map.begin(), id_map.end(), ids[i]);
+                if (it != id_map.end() && *it == ids[i] && set_tombstone(static_cast<size_t>(it - id_map.begin()))) {
+                    marked++;
+                }
+            }
+        } else {
+            std::unordered_set<int64_t> targets(ids, ids + count);
+            for (size_t offset = 0; offset < id_map.size(); ++offset) {
+                if (targets.count(id_map[offset]) > 0 && set_tombstone(offset)) {
+                    marked++;
+                }
+            }
+        }
+        tombstone_count_ += marked;
+        return marked;
+    }
+    
+    void clear_tombstones() {
+        tombstones_.clear();
+        tombstone_count_ = 0;
+    }
+    
+    /**
+     * @brief IDs of tombstoned vectors, to carry over into the delta log when a snapshot is written
+     * @return false if a tombstoned id was re-added and is live too (replaying it by id would drop the live copy)
+     */
+    bool collect_tombstoned_ids(std::vector<int64_t>& ids) const {
+        ids.clear();
+        if (tombstone_count_ == 0) {
+            return true;
+        }
+        const auto& id_map = id_map_index_->id_map;
+        std::unordered_set<int64_t> live;
+        for (size_t offset = 0; offset < id_map.size(); ++offset) {
+            if (is_tombstoned(offset)) {
+                ids.push_back(id_map[offset]);
+            } else if (!ids_ascending_) {
+                live.insert(id_map[offset]);
+            }
+        }
+        // Ascending ids are unique, so no live vector can share an id with a tombstoned one
+        return ids_ascending_ || std::none_of(ids.begin(), ids.end(), [&](int64_t id) { return live.count(id) > 0; });
+    }
+    
+    // Rebuild matrices hold every vector of the index at once; they go in huge pages when large_pages allows
+    using LiveVectors = std::vector<float, LargePageAllocator<float> >;
+    
+    // Copy every live (non-tombstoned) vector and its id out of the index, leaving the index unchanged
+    void copy_live_vectors(std::vector<faiss::idx_t>& live_ids, LiveVectors& live_vectors) {
+        faiss::IndexIDMap* id_map = id_map_index_.get();
+        faiss::Index* index = id_map->index;
+        
+        // IVF reconstruct() looks offsets up through the direct map - only needed while we copy the vectors out
+        auto* ivf = dynamic_cast<faiss::IndexIVF*>(index);
+        if (ivf) {
+            ivf->make_direct_map(true);
+        }
+        
+        const size_t dimension = static_cast<size_t>(dimension_);
+        const size_t stored = static_cast<size_t>(id_map->ntotal);
+        live_ids.clear();
+        live_vectors.clear();
+        live_ids.reserve(stored - static_cast<size_t>(tombstone_count_));
+        live_vectors.reserve(live_ids.capacity() * dimension);
+        for (size_t offset = 0; offset < stored; ++offset) {
+            if (is_tombstoned(offset)) {
+                continue;
+            }
+            live_ids.push_back(id_map->id_map[offset]);
+            live_vectors.resize(live_vectors.size() + dimension);
+            index->reconstruct(static_cast<faiss::idx_t>(offset), live_vectors.data() + live_vectors.size() - dimension);
+        }
+        if (ivf) {
+            ivf->make_direct_map(false);
+        }
+    }
+    
+    // Reconstruct the live vectors stored under ids into rows of vectors (found[i] set per hit); caller holds a lock
+    void reconstruct_ids(const int64_t* ids, int count, float* vectors, std::vector<char>& found) const {
+        const faiss::IndexIDMap* id_map_index = id_map_index_.get();
+        const auto& id_map = id_map_index->id_map;
+        const size_t dimension = static_cast<size_t>(dimension_);
+        found.assign(static_cast<size_t>(count), 0);
+        
+        // Offset -> output row of every requested id that is stored and live
+        std::unordered_map<faiss::idx_t, int> rows;
+        if (ids_ascending_) {
+            for (int i = 0; i < count; ++i) {
+                auto it = std::lower_bound(id_map.begin(), id_map.end(), ids[i]);
+                if (it != id_map.end() && *it == ids[i] && !is_tombstoned(static_cast<size_t>(it - id_map.begin()))) {
+                    rows.emplace(static_cast<faiss::idx_t>(it - id_map.begin()), i);
+                }
+            }
+        } else {
+            std::unordered_map<int64_t, int> targets;
+            for (int i = 0; i < count; ++i) {
+                targets.emplace(ids[i], i);
+            }
+            for (size_t offset = 0; offset < id_map.size(); ++offset) {
+                auto it = targets.find(id_map[offset]);
+                if (it != targets.end() && !is_tombstoned(offset)) {
+                    rows.emplace(static_cast<faiss::idx_t>(offset), it->second);
+                }
+            }
+        }
+        if (rows.empty()) {
+            return;
+        }
+        
+        // IVF reconstruct() needs the direct map, which would mutate the index - walk the inverted lists instead
+        const auto* ivf = dynamic_cast<const faiss::IndexIVF*>(id_map_index->index);
+        if (ivf) {
+            for (size_t list = 0; list < ivf->nlist && !rows.empty(); ++list) {
+                faiss::InvertedLists::ScopedIds list_ids(ivf->invlists, list);
+                const size_t list_size = ivf->invlists->list_size(list);
+                for (size_t j = 0; j < list_size; ++j) {
+                    auto it = rows.find(list_ids[j]);
+                    if (it != rows.end()) {
+                        ivf->reconstruct_from_offset(static_cast<int64_t>(list), static_cast<int64_t>(j),
+                                                     vectors + static_cast<size_t>(it->second) * dimension);
+                        found[static_cast<size_t>(it->second)] = 1;
+                        rows.erase(it);
+                    }
+                }
+            }
+            return;
+        }
+        for (const auto& entry : rows) {
+            id_map_index->index->reconstruct(entry.first, vectors + static_cast<size_t>(entry.second) * dimension);
+            found[static_cast<size_t>(entry.second)] = 1;
+        }
+    }
+    
+    // COSINE is inner product over unit vectors, so everything entering the index or a query is normalized
+    bool normalizes() const {
+        return metric_type_ == MetricType::COSINE;
+    }
+    
+    /**
+     * @brief Unit-length view of rows * dimension_ floats for a COSINE index
+     * 
+     * Embeddings normalized upstream (the default) are used as-is after one norm check per row;
+     * only when some row isn't unit length are the rows written, normalized, into the scratch buffer.
+     * 
+     * @return vectors itself, or scratch.data()
+     */
+    const float* unit_rows(const float* vectors, size_t rows, std::vector<float>& scratch) const {
+        if (!normalizes()) {
+            return vectors;
+        }
+        const size_t dimension = static_cast<size_t>(dimension_);
+        size_t row = 0;
+        while (row < rows && std::fabs(simd::squared_norm(vectors + row * dimension, dimension) - 1.0f) <= kUnitNormTolerance) {
+            row++;
+        }
+        if (row == rows) {
+            return vectors;
+        }
+        scratch.resize(rows * dimension);
+        std::memcpy(scratch.data(), vectors, row * dimension * sizeof(float));
+        for (; row < rows; ++row) {
+            simd::l2_normalize(vectors + row * dimension, scratch.data() + row * dimension, dimension);
+        }
+        return scratch.data();
+    }
+    
+    /**
+     * @brief Caller vectors (input_dimension_ floats per row) as the index stores them
+     * 
+     * A reduced index keeps the leading dimension_ values of each row, re-normalized to unit
+     * length (Matryoshka truncation); otherwise the rows are passed through untouched.
+     * 
+     * @return vectors itself, or scratch.data()
+     */
+    const float* reduce_rows(const float* vectors, size_t rows, std::vector<float>& scratch) const {
+        if (dimension_ == input_dimension_) {
+            return vectors;
+        }
+        const size_t kept = static_cast<size_t>(dimension_);
+        scratch.resize(rows * kept);
+        for (size_t row = 0; row < rows; ++row) {
+            simd::l2_normalize(vectors + row * static_cast<size_t>(input_dimension_), scratch.data() + row * kept, kept);
+        }
+        return scratch.data();
+    }
+    
+    // Search parameters of the right subtype, carrying the index's own probe settings unless overridden
+    // (a bare SearchParameters is rejected by IVF and HNSW, and their subtypes default to nprobe=1/efSearch=16)
+    static std::unique_ptr<faiss::SearchParameters> make_search_params(const faiss::Index* index,
+                                                                       const FaissIndex::SearchParams& overrides) {
+        if (const auto* ivf = dynamic_cast<const faiss::IndexIVF*>(index)) {
+            auto params = std::make_unique<faiss::SearchParametersIVF>();
+            params->nprobe = overrides.nprobe > 0 ? std::min(static_cast<size_t>(overrides.nprobe), ivf->nlist) : ivf->nprobe;
+            params->max_codes = overrides.max_codes > 0 ? overrides.max_codes : ivf->max_codes;
+            return params;
+        }
+        if (const auto* hnsw = dynamic_cast<const faiss::IndexHNSW*>(index)) {
+            auto params = std::make_unique<faiss::SearchParametersHNSW>();
+            params->efSearch = overrides.ef_search > 0 ? overrides.ef_search : hnsw->hnsw.efSearch;
+            return params;
+        }
+        return std::make_unique<faiss::SearchParameters>();
+    }
+    
+    /**
+     * @brief Offsets [first, last) holding exactly the allowed ids, when those are one run of sequence ids
+     * 
+     * A document's chunks get one contiguous block of ids, so a single-document filter becomes a
+     * range check instead of a bitmap over the whole index.
+     * 
+     * @return false if the ids aren't strictly ascending and contiguous (or the id map isn't ascending)
+     */
+    bool allowed_offset_range(const std::vector<int64_t>& ids, size_t& first, size_t& last) const {
+        if (!ids_ascending_ || ids.empty() || ids.back() - ids.front() + 1 != static_cast<int64_t>(ids.size()) ||
+            std::adjacent_find(ids.begin(), ids.end(), [](int64_t a, int64_t b) { return a >= b; }) != ids.end()) {
+            return false;
+        }
+        const auto& id_map = id_map_index_->id_map;
+        first = static_cast<size_t>(std::lower_bound(id_map.begin(), id_map.end(), ids.front()) - id_map.begin());
+        last = static_cast<size_t>(std::upper_bound(id_map.begin(), id_map.end(), ids.back()) - id_map.begin());
+        return true;
+    }
+    
+    // Bitmap over internal offsets of the live vectors carrying one of the allowed ids
+    void allowed_offsets(const std::vector<int64_t>& ids, std::vector<uint8_t>& bitmap) const {
+        const auto& id_map = id_map_index_->id_map;
+        bitmap.assign((id_map.size() + 7) >> 3, 0);
+        auto allow = [&](size_t offset) {
+            if (!is_tombstoned(offset)) {
+                bitmap[offset >> 3] |= static_cast<uint8_t>(1u << (offset & 7));
+            }
+        };
+        if (ids_ascending_) {
+            for (int64_t id : ids) {
+                auto it = std::lower_bound(id_map.begin(), id_map.end(), id);
+                if (it != id_map.end() && *it == id) {
+                    allow(static_cast<size_t>(it - id_map.begin()));
+                }
+            }
+        } else {
+            std::unordered_set<int64_t> targets(ids.begin(), ids.end());
+            for (size_t offset = 0; offset < id_map.size(); ++offset) {
+                if (targets.count(id_map[offset]) > 0) {
+                    allow(offset);
+                }
+            }
+        }
+    }
+    
+    /**
+     * @brief Hamming k-NN over the codes of the allowed ids only (BINARY)
+     * 
+     * IndexLSH takes no search parameters, so an id filter can't be handed to FAISS; the
+     * allowed codes are scanned here instead. Distances are Hamming distances, like FAISS reports.
+     */
+    void search_binary_subset(faiss::idx_t n, const float* queries, faiss::idx_t k, float* distances, faiss::idx_t* labels,
+                              const std::vector<int64_t>& allowed_ids) const {
+        const auto* lsh = static_cast<const faiss::IndexLSH*>(id_map_index_->index);
+        const auto& id_map = id_map_index_->id_map;
+        const size_t code_size = lsh->code_size;
+        
+        std::vector<uint32_t> offsets;
+        size_t first = 0;
+        size_t last = 0;
+        if (allowed_offset_range(allowed_ids, first, last)) {
+            for (size_t offset = first; offset < last; ++offset) {
+                offsets.push_back(static_cast<uint32_t>(offset));
+            }
+        } else {
+            std::vector<uint8_t> bitmap;
+            allowed_offsets(allowed_ids, bitmap);
+            for (size_t offset = 0; offset < id_map.size(); ++offset) {
+                if (bitmap[offset >> 3] & (1u << (offset & 7))) {
+                    offsets.push_back(static_cast<uint32_t>(offset));
+                }
+            }
+        }
+        
+        std::vector<uint8_t> query_codes(static_cast<size_t>(n) * code_size);
+        lsh->sa_encode(n, queries, query_codes.data());
+        std::vector<float> scores(offsets.size());
+        std::vector<uint32_t> best;
+        for (faiss::idx_t q = 0; q < n; ++q) {
+            const uint8_t* query_code = query_codes.data() + static_cast<size_t>(q) * code_size;
+            for (size_t i = 0; i < offsets.size(); ++i) {
+                scores[i] = static_cast<float>(simd::hamming(query_code, lsh->codes.data() + offsets[i] * code_size, code_size));
+            }
+            simd::top_k(scores.data(), scores.size(), static_cast<size_t>(k), false, best);
+            for (faiss::idx_t i = 0; i < k; ++i) {
+                const size_t slot = static_cast<size_t>(q * k + i);
+                if (static_cast<size_t>(i) < best.size()) {
+                    distances[slot] = scores[best[i]];
+                    labels[slot] = id_map[offsets[best[i]]];
+                } else {
+                    distances[slot] = std::numeric_limits<float>::max();
+                    labels[slot] = -1;
+                }
+            }
+        }
+    }
+    
+    // BINARY reports Hamming distances; under a similarity metric they become 1 - 2 * h / d (SimHash's
+    // cosine estimate, higher is better) so they merge and threshold like every other index's scores
+    void orient_binary_scores(faiss::idx_t count, float* distances, const faiss::idx_t* labels) const {
+        if (index_type_ != IndexType::BINARY || metric_type_ == MetricType::L2) {
+            return;
+        }
+        const float scale = 2.0f / static_cast<float>(dimension_);
+        for (faiss::idx_t i = 0; i < count; ++i) {
+            if (labels[i] >= 0) {
+                distances[i] = 1.0f - distances[i] * scale;
+            }
+        }
+    }
+    
+    // k-NN search that never returns tombstoned vectors (labels are external ids, -1 for empty slots)
+    void search(faiss::idx_t n, const float* queries, faiss::idx_t k, float* distances, faiss::idx_t* labels,
+                const FaissIndex::SearchParams& overrides) const {
+        trace::Span span("faiss", "search");
+        span.arg("queries", n);
+        span.arg("k", k);
+        queries = reduce_rows(queries, static_cast<size_t>(n), reduction_scratch());
+        queries = unit_rows(queries, static_cast<size_t>(n), cosine_scratch());
+        const faiss::Index* index = id_map_index_->index;
+        if (index_type_ == IndexType::BINARY) {
+            // Flat codes are removed in place, so there are never tombstones to skip
+            if (overrides.allowed_ids) {
+                search_binary_subset(n, queries, k, distances, labels, *overrides.allowed_ids);
+            } else {
+                get_index()->search(n, queries, k, distances, labels);
+            }
+            orient_binary_scores(n * k, distances, labels);
+            return;
+        }
+        if (tombstone_count_ == 0 && !overrides.allowed_ids) {
+#ifdef LEAFRA_HAS_METAL
+            if (search_gpu(n, queries, k, distances, labels)) {
+                return;
+            }
+#endif
+            if (overrides.is_default()) {
+                get_index()->search(n, queries, k, distances, labels);
+            } else {
+                // IndexIDMap hands the parameters down to the wrapped index
+                auto params = make_search_params(index, overrides);
+                get_index()->search(n, queries, k, distances, labels, params.get());
+            }
+            return;
+        }
+        
+        // Selectors are indexed by internal offset, so search the wrapped index directly and translate labels ourselves
+        faiss::IDSelectorBitmap dead(tombstones_.size(), tombstones_.data());
+        faiss::IDSelectorNot live(&dead);
+        faiss::IDSelector* selector = &live;
+        std::vector<uint8_t> allowed_bitmap;
+        std::unique_ptr<faiss::IDSelector> allowed;
+        std::unique_ptr<faiss::IDSelectorAnd> allowed_live;
+        if (overrides.allowed_ids) {
+            size_t first = 0;
+            size_t last = 0;
+            if (allowed_offset_range(*overrides.allowed_ids, first, last)) {
+                allowed = std::make_unique<faiss::IDSelectorRange>(static_cast<faiss::idx_t>(first), static_cast<faiss::idx_t>(last));
+                if (tombstone_count_ > 0) {
+                    allowed_live = std::make_unique<faiss::IDSelectorAnd>(allowed.get(), &live);
+                    selector = allowed_live.get();
+                } else {
+                    selector = allowed.get();
+                }
+            } else {
+                allowed_offsets(*overrides.allowed_ids, allowed_bitmap);
+                allowed = std::make_unique<faiss::IDSelectorBitmap>(allowed_bitmap.size(), allowed_bitmap.data());
+                selector = allowed.get();
+            }
+        }
+        auto params = make_search_params(index, overrides);
+        params->sel = selector;
+        index->search(n, queries, k, distances, labels, params.get());
+        
+        const auto& id_map = id_map_index_->id_map;
+        for (faiss::idx_t i = 0; i < n * k; ++i) {
+            if (labels[i] >= 0) {
+                labels[i] = id_map[labels[i]];
+            }
+        }
+    }
+    
+#ifdef LEAFRA_HAS_METAL
+    /**
+     * @brief Search a FLAT index on the GPU, first bringing the mirror up to date (caller holds index_mutex_ shared)
+     * 
+     * When every change since the last sync was an append, only the new rows are copied;
+     * any other change (removal, load, restore) re-uploads the whole index.
+     * 
+     * @return false to search on the CPU (no GPU, not FLAT, too small, or the GPU work failed)
+     */
+    bool search_gpu(faiss::idx_t n, const float* queries, faiss::idx_t k, float* distances, faiss::idx_t* labels) const {
+        if (!gpu_active_.load()) {
+            return false;
+        }
+        std::lock_guard<std::mutex> gpu_lock(gpu_mutex_);
+        Impl& self = const_cast<Impl&>(*this);
+        const auto* flat = dynamic_cast<const faiss::IndexFlat*>(id_map_index_->index);
+        if (!gpu_ || index_type_ != IndexType::FLAT || !flat) {
+            // Migrated away from FLAT: the mirror is of no further use
+            self.gpu_.reset();
+            self.gpu_active_ = false;
+            return false;
+        }
+        if (flat->ntotal < gpu_min_vectors_) {
+            return false;
+        }
+        const size_t stored = static_cast<size_t>(flat->ntotal);
+        const uint64_t generation = generation_.load();
+        const uint64_t appends = appends_.load();
+        if (generation != gpu_generation_) {
+            bool appended_only = generation - gpu_generation_ == appends - gpu_appends_ && gpu_->size() <= stored;
+            if (!appended_only) {
+                gpu_->clear();
+            }
+            const size_t mirrored = gpu_->size();
+            if (!gpu_->append(flat->get_xb() + mirrored * static_cast<size_t>(dimension_), stored - mirrored)) {
+                self.gpu_generation_ = generation - 1;  // Retry the full upload next time
+                return false;
+            }
+            self.gpu_generation_ = generation;
+            self.gpu_appends_ = appends;
+        }
+        
+        static_assert(sizeof(faiss::idx_t) == sizeof(int64_t), "FAISS labels are 64-bit");
+        if (!gpu_->search(queries, static_cast<size_t>(n), static_cast<size_t>(k), distances,
+                          reinterpret_cast<int64_t*>(labels))) {
+            LEAFRA_WARNING() << "GPU flat search failed, searching on the CPU from now on";
+            self.gpu_.reset();
+            self.gpu_active_ = false;
+            return false;
+        }
+        const auto& id_map = id_map_index_->id_map;
+        for (faiss::idx_t i = 0; i < n * k; ++i) {
+            if (labels[i] >= 0) {
+                labels[i] = id_map[labels[i]];
+            }
+        }
+        return true;
+    }
+#endif
+    
+    // Rebuild the lists without tombstoned vectors (caller holds write_mutex_)
+    ResultCode purge_tombstones() {
+        if (tombstone_count_ == 0) {
+            return ResultCode::SUCCESS;
+        }
+        
+        try {
+            ExclusiveLock index_lock(index_mutex_);
+            ensure_writable();
+            faiss::IndexIDMap* id_map = id_map_index_.get();
+            
+            // Copy everything out before touching the index, so a failure leaves it intact
+            std::vector<faiss::idx_t> live_ids;
+            LiveVectors live_vectors;
+            copy_live_vectors(live_ids, live_vectors);
+            
+            // reset() empties the lists/graph but keeps IVF centroids and PQ codebooks trained
+            id_map->reset();
+            if (!live_ids.empty()) {
+                id_map->add_with_ids(static_cast<faiss::idx_t>(live_ids.size()), live_vectors.data(), live_ids.data());
+            }
+            
+            int64_t purged = tombstone_count_;
+            clear_tombstones();
+            refresh_id_order();
+            generation_++;
+            advise_large_pages();
+            LEAFRA_INFO() << "Purged " << purged << " tombstoned vectors from FAISS index (" << live_ids.size() << " live vectors rebuilt)";
+            return ResultCode::SUCCESS;
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "Failed to purge FAISS tombstones: " << e.what();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+    }
+    
+    /**
+     * @brief Move an IVF index's heap lists into a fresh on_disk_path_ file (caller holds write_mutex_)
+     * 
+     * Used for indexes not yet on disk: after a migration to IVF, or a restore of an older
+     * snapshot whose lists were saved inline.
+     */
+    void store_lists_on_disk(faiss::Index* index) const {
+        faiss::IndexIVF* ivf = ivf_of(index);
+        if (on_disk_path_.empty() || !ivf || dynamic_cast<faiss::OnDiskInvertedLists*>(ivf->invlists)) {
+            return;
         }
+        std::error_code ec;
+        std::filesystem::remove(on_disk_path_, ec);
+        auto lists = std::make_unique<faiss::OnDiskInvertedLists>(ivf->nlist, ivf->code_size, on_disk_path_.c_str());
+        lists->merge_from_1(ivf->invlists);
+        ivf->replace_invlists(lists.release(), true);
+        LEAFRA_INFO() << "Moved FAISS inverted lists to disk: " << on_disk_path_ << " (" << ivf->ntotal << " vectors)";
     }
     
-    faiss::Index* get_index() {
-        return use_id_map_ ? static_cast<faiss::Index*>(id_map_index_.get()) : index_.get();
+    // Copy file-backed lists onto the heap (on-disk lists were turned off for this index)
+    static void load_lists_into_memory(faiss::IndexIVF* ivf) {
+        auto lists = std::make_unique<faiss::ArrayInvertedLists>(ivf->nlist, ivf->code_size);
+        for (size_t list = 0; list < ivf->nlist; ++list) {
+            faiss::InvertedLists::ScopedCodes codes(ivf->invlists, list);
+            faiss::InvertedLists::ScopedIds ids(ivf->invlists, list);
+            lists->add_entries(list, ivf->invlists->list_size(list), ids.get(), codes.get());
+        }
+        ivf->replace_invlists(lists.release(), true);
     }
     
-    const faiss::Index* get_index() const {
-        return use_id_map_ ? static_cast<const faiss::Index*>(id_map_index_.get()) : index_.get();
+    // Mmapped inverted lists are read-only - reload them into memory (or copy a lists file to on_disk_path_) before the first mutation
+    void ensure_writable() {
+        if (mapped_file_.empty()) {
+            return;
+        }
+        if (faiss::OnDiskInvertedLists* lists = on_disk_lists(get_index())) {
+            if (on_disk_path_.empty()) {
+                load_lists_into_memory(ivf_of(get_index()));
+                LEAFRA_DEBUG() << "Loaded on-disk FAISS inverted lists into memory for update: " << lists->filename;
+            } else {
+                // Copy-on-write: the snapshot's lists stay as saved, the live copy takes the changes
+                std::string snapshot = lists->filename;
+                if (!clone_faiss_file(snapshot, on_disk_path_)) {
+                    throw std::runtime_error("Failed to copy FAISS inverted lists to: " + on_disk_path_);
+                }
+                if (lists->ptr) {
+                    munmap(lists->ptr, lists->totsize);
+                    lists->ptr = nullptr;
+                }
+                lists->filename = on_disk_path_;
+                lists->read_only = false;
+                if (lists->totsize > 0) {
+                    lists->do_mmap();
+                }
+                LEAFRA_DEBUG() << "Copied FAISS inverted lists for update: " << snapshot << " -> " << on_disk_path_;
+            }
+            mapped_file_.clear();
+            return;
+        }
+        auto loaded_index = std::unique_ptr<faiss::Index>(faiss::read_index(mapped_file_.c_str()));
+        if (!loaded_index) {
+            throw std::runtime_error("Failed to reload FAISS index from: " + mapped_file_);
+        }
+        adopt(std::move(loaded_index));
+        LEAFRA_DEBUG() << "Loaded mmapped FAISS index into memory for update: " << mapped_file_;
+        mapped_file_.clear();
     }
 };
 
-FaissIndex::FaissIndex(int dimension, IndexType index_type, MetricType metric)
-    : pImpl(std::make_unique<Impl>(dimension, index_type, metric)) {
+FaissIndex::FaissIndex(int dimension, IndexType index_type, MetricType metric, int index_dimension)
+    : pImpl(std::make_unique<Impl>(dimension, index_dimension > 0 && index_dimension < dimension ? index_dimension : dimension,
+                                   index_type, metric)) {
     
     if (dimension <= 0) {
         throw std::invalid_argument("Dimension must be positive");
     }
     
     LEAFRA_INFO() << "Created FAISS index: " << get_index_type_string() 
-                  << " (dim=" << dimension << ", metric=" << get_metric_type_string() << ", id_map=enabled)";
+                  << " (dim=" << dimension
+                  << (pImpl->dimension_ != dimension ? ", indexed=" + std::to_string(pImpl->dimension_) : std::string())
+                  << ", metric=" << get_metric_type_string() << ", id_map=enabled)";
 }
 
 FaissIndex::~FaissIndex() = default;
@@ -181,7 +1234,20 @@ ResultCode FaissIndex::add_vectors(const float* vectors, int count) {
     }
     
     try {
+        trace::Span span("faiss", "add");
+        span.arg("vectors", count);
+        std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+        use_omp_threads(pImpl->omp_threads_);
+        vectors = pImpl->reduce_rows(vectors, static_cast<size_t>(count), reduction_scratch());
+        vectors = pImpl->unit_rows(vectors, static_cast<size_t>(count), cosine_scratch());
+        ExclusiveLock index_lock(pImpl->index_mutex_);
+        pImpl->ensure_writable();
         pImpl->get_index()->add(count, vectors);
+#ifdef LEAFRA_HAS_METAL
+        pImpl->appends_++;
+#endif
+        pImpl->generation_++;
+        pImpl->advise_large_pages();
         LEAFRA_DEBUG() << "Added " << count << " vectors to FAISS index";
         return ResultCode::SUCCESS;
     } catch (const std::exception& e) {
@@ -197,8 +1263,23 @@ ResultCode FaissIndex::add_vectors_with_ids(const float* vectors, const int64_t*
     }
     
     try {
+        trace::Span span("faiss", "add");
+        span.arg("vectors", count);
+        std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+        use_omp_threads(pImpl->omp_threads_);
+        vectors = pImpl->reduce_rows(vectors, static_cast<size_t>(count), reduction_scratch());
+        vectors = pImpl->unit_rows(vectors, static_cast<size_t>(count), cosine_scratch());
+        ExclusiveLock index_lock(pImpl->index_mutex_);
+        pImpl->ensure_writable();
         // ID mapping is enabled by default in constructor
+        size_t first_offset = pImpl->id_map_index_->id_map.size();
         pImpl->id_map_index_->add_with_ids(count, vectors, ids);
+        pImpl->track_id_order(ids, count, first_offset);
+#ifdef LEAFRA_HAS_METAL
+        pImpl->appends_++;
+#endif
+        pImpl->generation_++;
+        pImpl->advise_large_pages();
         LEAFRA_DEBUG() << "Added " << count << " vectors with IDs to FAISS index";
         return ResultCode::SUCCESS;
     } catch (const std::exception& e) {
@@ -207,7 +1288,8 @@ ResultCode FaissIndex::add_vectors_with_ids(const float* vectors, const int64_t*
     }
 }
 
-ResultCode FaissIndex::search(const float* query_vector, int k, std::vector<SearchResult>& results) {
+ResultCode FaissIndex::search(const float* query_vector, int k, std::vector<SearchResult>& results,
+                              const SearchParams& params) {
     if (!query_vector || k <= 0) {
         LEAFRA_ERROR() << "Invalid query vector or k";
         return ResultCode::ERROR_INVALID_PARAMETER;
@@ -217,7 +1299,11 @@ ResultCode FaissIndex::search(const float* query_vector, int k, std::vector<Sear
         std::vector<float> distances(k);
         std::vector<faiss::idx_t> labels(k);
         
-        pImpl->get_index()->search(1, query_vector, k, distances.data(), labels.data());
+        {
+            ReadLock read_lock(pImpl->index_mutex_);
+            use_omp_threads(1);
+            pImpl->search(1, query_vector, k, distances.data(), labels.data(), params);
+        }
         
         results.clear();
         results.reserve(k);
@@ -237,7 +1323,7 @@ ResultCode FaissIndex::search(const float* query_vector, int k, std::vector<Sear
 }
 
 ResultCode FaissIndex::batch_search(const float* query_vectors, int query_count, int k, 
-                                   std::vector<std::vector<SearchResult>>& results) {
+                                   std::vector<std::vector<SearchResult>>& results, const SearchParams& params) {
     if (!query_vectors || query_count <= 0 || k <= 0) {
         LEAFRA_ERROR() << "Invalid query vectors, query_count, or k";
         return ResultCode::ERROR_INVALID_PARAMETER;
@@ -247,7 +1333,11 @@ ResultCode FaissIndex::batch_search(const float* query_vectors, int query_count,
         std::vector<float> distances(query_count * k);
         std::vector<faiss::idx_t> labels(query_count * k);
         
-        pImpl->get_index()->search(query_count, query_vectors, k, distances.data(), labels.data());
+        {
+            ReadLock read_lock(pImpl->index_mutex_);
+            use_omp_threads(query_count > 1 ? pImpl->omp_threads_.load() : 1);
+            pImpl->search(query_count, query_vectors, k, distances.data(), labels.data(), params);
+        }
         
         results.clear();
         results.resize(query_count);
@@ -272,6 +1362,30 @@ ResultCode FaissIndex::batch_search(const float* query_vectors, int query_count,
     }
 }
 
+ResultCode FaissIndex::get_vectors(const int64_t* ids, int count, float* vectors, std::vector<char>& found) const {
+    if (!ids || !vectors || count <= 0) {
+        LEAFRA_ERROR() << "Invalid ids or vector buffer";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    if (pImpl->index_type_ == IndexType::LSH || pImpl->index_type_ == IndexType::BINARY) {
+        LEAFRA_ERROR() << "LSH and BINARY indexes don't store vectors";
+        return ResultCode::ERROR_NOT_IMPLEMENTED;
+    }
+    
+    try {
+        ReadLock read_lock(pImpl->index_mutex_);
+        if (!pImpl->id_map_index_) {
+            LEAFRA_ERROR() << "Index has no ID map";
+            return ResultCode::ERROR_INITIALIZATION_FAILED;
+        }
+        pImpl->reconstruct_ids(ids, count, vectors, found);
+        return ResultCode::SUCCESS;
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "FAISS vector lookup failed: " << e.what();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+}
+
 ResultCode FaissIndex::train(const float* training_vectors, int training_count) {
     if (!training_vectors || training_count <= 0) {
         LEAFRA_ERROR() << "Invalid training vectors or count";
@@ -279,8 +1393,16 @@ ResultCode FaissIndex::train(const float* training_vectors, int training_count)
     }
     
     try {
+        std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+        use_omp_threads(pImpl->omp_threads_);
+        ExclusiveLock index_lock(pImpl->index_mutex_);
+        pImpl->ensure_writable();
         if (!pImpl->get_index()->is_trained) {
+            training_vectors = pImpl->reduce_rows(training_vectors, static_cast<size_t>(training_count), reduction_scratch());
+            training_vectors = pImpl->unit_rows(training_vectors, static_cast<size_t>(training_count), cosine_scratch());
             pImpl->get_index()->train(training_count, training_vectors);
+            pImpl->generation_++;
+            pImpl->advise_large_pages();
             LEAFRA_INFO() << "FAISS index trained with " << training_count << " vectors";
         } else {
             LEAFRA_DEBUG() << "FAISS index already trained";
@@ -299,6 +1421,7 @@ ResultCode FaissIndex::save_index(const std::string& filename) {
     }
     
     try {
+        ReadLock read_lock(pImpl->index_mutex_);
         faiss::write_index(pImpl->get_index(), filename.c_str());
         LEAFRA_INFO() << "FAISS index saved to: " << filename;
         return ResultCode::SUCCESS;
@@ -315,6 +1438,7 @@ ResultCode FaissIndex::load_index(const std::string& filename) {
     }
     
     try {
+        std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
         auto loaded_index = std::unique_ptr<faiss::Index>(faiss::read_index(filename.c_str()));
         
         if (!loaded_index) {
@@ -323,28 +1447,19 @@ ResultCode FaissIndex::load_index(const std::string& filename) {
         }
         
         // Check dimension compatibility
-        if (loaded_index->d != pImpl->dimension_) {
+        if (!pImpl->accepts_dimension(loaded_index->d)) {
             LEAFRA_ERROR() << "Dimension mismatch: expected " << pImpl->dimension_ 
                           << ", got " << loaded_index->d;
             return ResultCode::ERROR_INVALID_PARAMETER;
         }
         
-        auto* id_map_ptr = dynamic_cast<faiss::IndexIDMap*>(loaded_index.get());
-        if (id_map_ptr) {
-            // Index is already an IndexIDMap
-            pImpl->id_map_index_ = std::unique_ptr<faiss::IndexIDMap>(
-                static_cast<faiss::IndexIDMap*>(loaded_index.release()));
-            pImpl->index_.reset();  // Clear the regular index pointer
-            pImpl->use_id_map_ = true;
-        } else {
-            // Index is not an IndexIDMap, wrap it
-            pImpl->index_ = std::move(loaded_index);
-            pImpl->id_map_index_.reset();
-            pImpl->use_id_map_ = false;
-            // Re-enable ID mapping
-            pImpl->enable_id_map();
-        }
-        
+        ExclusiveLock index_lock(pImpl->index_mutex_);
+        pImpl->mapped_file_.clear();
+        pImpl->clear_tombstones();
+        pImpl->adopt(std::move(loaded_index));
+        pImpl->refresh_id_order();
+        pImpl->generation_++;
+        pImpl->advise_large_pages();
         LEAFRA_INFO() << "FAISS index loaded from: " << filename;
         return ResultCode::SUCCESS;
     } catch (const std::exception& e) {
@@ -354,24 +1469,114 @@ ResultCode FaissIndex::load_index(const std::string& filename) {
 }
 
 int64_t FaissIndex::get_count() const {
-    return pImpl->get_index()->ntotal;
+    ReadLock read_lock(pImpl->index_mutex_);
+    return pImpl->get_index()->ntotal - pImpl->tombstone_count_;
+}
+
+int64_t FaissIndex::get_tombstone_count() const {
+    ReadLock read_lock(pImpl->index_mutex_);
+    return pImpl->tombstone_count_;
+}
+
+double FaissIndex::get_tombstone_ratio() const {
+    ReadLock read_lock(pImpl->index_mutex_);
+    int64_t stored = pImpl->get_index()->ntotal;
+    return stored > 0 ? static_cast<double>(pImpl->tombstone_count_) / static_cast<double>(stored) : 0.0;
+}
+
+uint64_t FaissIndex::get_generation() const {
+    return pImpl->generation_.load();
 }
 
 int FaissIndex::get_dimension() const {
+    return pImpl->input_dimension_;
+}
+
+int FaissIndex::get_index_dimension() const {
+    ReadLock read_lock(pImpl->index_mutex_);
     return pImpl->dimension_;
 }
 
+uint64_t FaissIndex::get_memory_bytes() const {
+    ReadLock read_lock(pImpl->index_mutex_);
+    uint64_t bytes = Impl::index_memory_bytes(pImpl->get_index()) + pImpl->tombstones_.capacity();
+#ifdef LEAFRA_HAS_METAL
+    std::lock_guard<std::mutex> gpu_lock(pImpl->gpu_mutex_);
+    if (pImpl->gpu_) {
+        bytes += pImpl->gpu_->memory_bytes();
+    }
+#endif
+    return bytes;
+}
+
 bool FaissIndex::is_trained() const {
+    ReadLock read_lock(pImpl->index_mutex_);
     return pImpl->get_index()->is_trained;
 }
 
+FaissIndex::IndexType FaissIndex::get_index_type() const {
+    ReadLock read_lock(pImpl->index_mutex_);
+    return pImpl->index_type_;
+}
+
+void FaissIndex::set_migration_target(IndexType target_type) {
+    std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+    pImpl->migration_target_ = target_type;
+}
+
+ResultCode FaissIndex::set_on_disk_lists(const std::string& path) {
+    try {
+        std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+        ExclusiveLock index_lock(pImpl->index_mutex_);
+        pImpl->on_disk_path_ = path;
+        if (pImpl->mapped_file_.empty()) {
+            pImpl->store_lists_on_disk(pImpl->get_index());
+        }
+        return ResultCode::SUCCESS;
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "Failed to move FAISS inverted lists to disk: " << e.what();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+}
+
+bool FaissIndex::enable_gpu_search(int64_t min_vectors) {
+#ifdef LEAFRA_HAS_METAL
+    std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+    std::lock_guard<std::mutex> gpu_lock(pImpl->gpu_mutex_);
+    if (!pImpl->gpu_) {
+        pImpl->gpu_ = MetalFlatSearch::create(pImpl->dimension_, pImpl->metric_type_ != MetricType::L2);
+        if (!pImpl->gpu_) {
+            return false;
+        }
+        // Nothing mirrored yet, so the first search uploads everything
+        pImpl->gpu_generation_ = pImpl->generation_.load() - 1;
+        pImpl->gpu_appends_ = pImpl->appends_.load();
+        pImpl->gpu_active_ = true;
+    }
+    pImpl->gpu_min_vectors_ = std::max<int64_t>(0, min_vectors);
+    return true;
+#else
+    (void)min_vectors;
+    return false;
+#endif
+}
+
+void FaissIndex::set_thread_count(int threads) {
+    pImpl->omp_threads_ = std::max(0, threads);
+}
+
 std::string FaissIndex::get_index_type_string() const {
+    ReadLock read_lock(pImpl->index_mutex_);
     switch (pImpl->index_type_) {
         case IndexType::FLAT: return "IndexFlat";
         case IndexType::IVF_FLAT: return "IndexIVFFlat";
         case IndexType::IVF_PQ: return "IndexIVFPQ";
         case IndexType::HNSW: return "IndexHNSWFlat";
         case IndexType::LSH: return "IndexLSH";
+        case IndexType::SQ8: return "IndexSQ8";
+        case IndexType::SQ_FP16: return "IndexSQfp16";
+        case IndexType::HNSW_SQ: return "IndexHNSWSQ";
+        case IndexType::BINARY: return "IndexBinarySign";
         default: return "Unknown";
     }
 }
@@ -398,6 +1603,18 @@ ResultCode FaissIndex::save_to_db(SQLiteDatabase& db, const std::string& definit
     }
     
     try {
+        // Holding only the writer lock, serialization runs alongside searches
+        std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+        
+        // Tombstoned vectors are part of the snapshot, so their removals are carried into the fresh delta log
+        std::vector<int64_t> carried_tombstones;
+        if (!pImpl->collect_tombstoned_ids(carried_tombstones)) {
+            ResultCode purge_result = pImpl->purge_tombstones();
+            if (purge_result != ResultCode::SUCCESS) {
+                return purge_result;
+            }
+        }
+        
         // Validate index before serialization
         auto* index = pImpl->get_index();
         if (!index) {
@@ -405,13 +1622,10 @@ ResultCode FaissIndex::save_to_db(SQLiteDatabase& db, const std::string& definit
             return ResultCode::ERROR_PROCESSING_FAILED;
         }
         
-        // Serialize FAISS index to memory buffer first to validate data
-        faiss::VectorIOWriter writer;
-        faiss::write_index(index, &writer);
-        
-        // Convert to blob for SQLite storage and validate it's not empty
-        std::vector<uint8_t> blob_data = std::move(writer.data);
-        if (blob_data.empty()) {
+        // Size the serialized index without materializing it: the BLOB is reserved up front and streamed into
+        CountingIOWriter counter;
+        faiss::write_index(index, &counter);
+        if (counter.size == 0) {
             LEAFRA_ERROR() << "FAISS index serialization resulted in empty blob data";
             return ResultCode::ERROR_PROCESSING_FAILED;
         }
@@ -494,7 +1708,7 @@ ResultCode FaissIndex::save_to_db(SQLiteDatabase& db, const std::string& definit
         }
         
         // Bind parameters
-        if (!stmt->bindText(1, definition) || !stmt->bindBlob(2, blob_data)) {
+        if (!stmt->bindText(1, definition) || !stmt->bindZeroBlob(2, counter.size)) {
             LEAFRA_ERROR() << "Failed to bind parameters for FAISS index save";
             return ResultCode::ERROR_PROCESSING_FAILED;
         }
@@ -505,14 +1719,48 @@ ResultCode FaissIndex::save_to_db(SQLiteDatabase& db, const std::string& definit
             return ResultCode::ERROR_PROCESSING_FAILED;
         }
         
+        // Serialize into the reserved BLOB in place (one buffer of kBlobStreamChunkBytes, no full copy)
+        auto blob = db.openBlob("faissindextable", "faissdata", db.getLastInsertRowId(), true);
+        if (!blob) {
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        BlobIOWriter writer;
+        writer.blob = blob.get();
+        faiss::write_index(index, &writer);
+        if (!writer.flush() || writer.offset != counter.size) {
+            LEAFRA_ERROR() << "Failed to stream FAISS index into the database (" << writer.offset << " of "
+                           << counter.size << " bytes written)";
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        blob.reset();
+        
+        // The new base blob contains every delta applied so far - compact them away in the same transaction
+        if (!ensure_delta_table(db)) {
+            LEAFRA_ERROR() << "Failed to create FAISS delta table: " << db.getLastErrorMessage();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        auto delete_deltas_stmt = db.prepare("DELETE FROM faissdeltatable WHERE definition = ?");
+        if (!delete_deltas_stmt || !delete_deltas_stmt->isValid() ||
+            !delete_deltas_stmt->bindText(1, definition) || !delete_deltas_stmt->execute()) {
+            LEAFRA_ERROR() << "Failed to compact FAISS delta log: " << db.getLastErrorMessage();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        int compacted_deltas = db.getChanges();
+        if (!carried_tombstones.empty() &&
+            append_delta(db, definition, DELTA_OP_REMOVE, carried_tombstones.data(),
+                         static_cast<int>(carried_tombstones.size()), nullptr, 0) != ResultCode::SUCCESS) {
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        
         // Commit transaction
         if (!transaction.commit()) {
             LEAFRA_ERROR() << "Failed to commit FAISS index save transaction";
             return ResultCode::ERROR_PROCESSING_FAILED;
         }
+        pImpl->pending_delta_entries_ = 0;
         
         LEAFRA_INFO() << "FAISS index saved to database with definition: " << definition 
-                      << " (size: " << blob_data.size() << " bytes)";
+                      << " (size: " << counter.size << " bytes, compacted " << compacted_deltas << " deltas)";
         return ResultCode::SUCCESS;
         
     } catch (const std::exception& e) {
@@ -527,6 +1775,30 @@ ResultCode FaissIndex::restore_from_db(SQLiteDatabase& db, const std::string& de
         return ResultCode::ERROR_INVALID_PARAMETER;
     }
     
+    // Base blob first (may be missing if only deltas were ever persisted), then the delta log on top
+    ResultCode base_result = restore_base_from_db(db, definition);
+    if (base_result != ResultCode::SUCCESS && base_result != ResultCode::ERROR_NOT_FOUND) {
+        return base_result;
+    }
+    
+    int64_t replayed = 0;
+    ResultCode delta_result = replay_deltas_from_db(db, definition, replayed, 0);
+    if (delta_result != ResultCode::SUCCESS) {
+        return delta_result;
+    }
+    
+    if (base_result == ResultCode::ERROR_NOT_FOUND && replayed == 0) {
+        return ResultCode::ERROR_NOT_FOUND;
+    }
+    return ResultCode::SUCCESS;
+}
+
+ResultCode FaissIndex::restore_base_from_db(SQLiteDatabase& db, const std::string& definition) {
+    if (definition.empty()) {
+        LEAFRA_ERROR() << "Invalid definition string";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
     // Validate pImpl before use
     if (!pImpl) {
         LEAFRA_ERROR() << "Invalid FaissIndex state - pImpl is null";
@@ -534,8 +1806,10 @@ ResultCode FaissIndex::restore_from_db(SQLiteDatabase& db, const std::string& de
     }
     
     try {
-        // Prepare SQL statement to retrieve the blob
-        std::string sql = "SELECT faissdata FROM faissindextable WHERE definition = ?";
+        std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+        
+        // Prepare SQL statement to locate the blob
+        std::string sql = "SELECT id, length(faissdata) FROM faissindextable WHERE definition = ?";
         auto stmt = db.prepare(sql);
         
         if (!stmt || !stmt->isValid()) {
@@ -551,24 +1825,31 @@ ResultCode FaissIndex::restore_from_db(SQLiteDatabase& db, const std::string& de
         
         // Execute and get result
         if (!stmt->step()) {
-            LEAFRA_ERROR() << "FAISS index not found in database with definition: " << definition;
+            LEAFRA_DEBUG() << "FAISS base index not found in database with definition: " << definition;
             return ResultCode::ERROR_NOT_FOUND;
         }
         
-        // Get the blob data
+        // Deserialize by streaming from the database pages (the BLOB is never loaded whole)
         auto row = stmt->getCurrentRow();
-        std::vector<uint8_t> blob_data = row.getBlob(0);
+        int64_t rowid = row.getInt64(0);
+        size_t blob_size = row.isNull(1) ? 0 : static_cast<size_t>(row.getInt64(1));
+        stmt.reset();
         
-        if (blob_data.empty()) {
+        if (blob_size == 0) {
             LEAFRA_ERROR() << "Empty FAISS index data in database";
             return ResultCode::ERROR_PROCESSING_FAILED;
         }
         
-        // Deserialize FAISS index from memory buffer
-        faiss::VectorIOReader reader;
-        reader.data = std::move(blob_data);
+        auto blob = db.openBlob("faissindextable", "faissdata", rowid, false);
+        if (!blob) {
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        BlobIOReader reader;
+        reader.blob = blob.get();
+        reader.size = blob->size();
         
         auto loaded_index = std::unique_ptr<faiss::Index>(faiss::read_index(&reader));
+        blob.reset();
         
         if (!loaded_index) {
             LEAFRA_ERROR() << "Failed to deserialize FAISS index from database";
@@ -576,7 +1857,7 @@ ResultCode FaissIndex::restore_from_db(SQLiteDatabase& db, const std::string& de
         }
         
         // Check dimension compatibility
-        if (loaded_index->d != pImpl->dimension_) {
+        if (!pImpl->accepts_dimension(loaded_index->d)) {
             LEAFRA_ERROR() << "Dimension mismatch: expected " << pImpl->dimension_ 
                           << ", got " << loaded_index->d;
             return ResultCode::ERROR_INVALID_PARAMETER;
@@ -589,7 +1870,7 @@ ResultCode FaissIndex::restore_from_db(SQLiteDatabase& db, const std::string& de
             return ResultCode::ERROR_PROCESSING_FAILED;
         }
         
-        if (loaded_index_type != pImpl->index_type_) {
+        if (!pImpl->accepts_type(loaded_index_type)) {
             LEAFRA_ERROR() << "Index type mismatch: expected " << index_type_to_string(pImpl->index_type_)
                           << ", got " << index_type_to_string(loaded_index_type);
             return ResultCode::ERROR_INVALID_PARAMETER;
@@ -602,6 +1883,11 @@ ResultCode FaissIndex::restore_from_db(SQLiteDatabase& db, const std::string& de
         }
         
         // Safely handle index assignment with proper state management
+        ExclusiveLock index_lock(pImpl->index_mutex_);
+        pImpl->mapped_file_.clear();
+        pImpl->clear_tombstones();
+        pImpl->adopt_dimension(loaded_index->d);
+        pImpl->index_type_ = loaded_index_type;
         auto* id_map_ptr = dynamic_cast<faiss::IndexIDMap*>(loaded_index.get());
         if (id_map_ptr) {
             // Index is already an IndexIDMap - validate it first
@@ -637,6 +1923,9 @@ ResultCode FaissIndex::restore_from_db(SQLiteDatabase& db, const std::string& de
             return ResultCode::ERROR_PROCESSING_FAILED;
         }
         
+        pImpl->refresh_id_order();
+        pImpl->generation_++;
+        pImpl->advise_large_pages();
         LEAFRA_INFO() << "FAISS index restored from database with definition: " << definition
                       << " (vectors: " << final_index->ntotal << ")";
         return ResultCode::SUCCESS;
@@ -647,6 +1936,353 @@ ResultCode FaissIndex::restore_from_db(SQLiteDatabase& db, const std::string& de
     }
 }
 
+ResultCode FaissIndex::replay_deltas_from_db(SQLiteDatabase& db, const std::string& definition, int64_t& replayed,
+                                             int64_t after_delta_id) {
+    replayed = 0;
+    try {
+        // Replay interleaves reads of the log with index mutations - keep searches out until it's done
+        std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+        use_omp_threads(pImpl->omp_threads_);
+        ExclusiveLock index_lock(pImpl->index_mutex_);
+        if (!ensure_delta_table(db)) {
+            LEAFRA_ERROR() << "Failed to create FAISS delta table: " << db.getLastErrorMessage();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        
+        auto stmt = db.prepareCached("SELECT op, count, ids, vectors FROM faissdeltatable WHERE definition = ? AND id > ? ORDER BY id");
+        if (!stmt || !stmt->isValid() || !stmt->bindText(1, definition) || !stmt->bindInt64(2, after_delta_id)) {
+            LEAFRA_ERROR() << "Failed to prepare FAISS delta replay statement";
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        
+        // Column memory isn't guaranteed to be aligned for int64/float - stage it in reused buffers
+        std::vector<int64_t> ids;
+        std::vector<float> vectors;
+        size_t delta_rows = 0;
+        ResultCode replay_result = ResultCode::SUCCESS;
+        bool stepped = stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+            auto* id_map = pImpl->id_map_index_.get();
+            if (!id_map) {
+                LEAFRA_ERROR() << "ID mapping not available for FAISS delta replay";
+                replay_result = ResultCode::ERROR_PROCESSING_FAILED;
+                return false;
+            }
+            
+            int op = row.getInt(0);
+            int count = row.getInt(1);
+            SQLiteDatabase::BlobView id_blob = row.getBlobView(2);
+            if (count <= 0 || id_blob.size != static_cast<size_t>(count) * sizeof(int64_t)) {
+                LEAFRA_ERROR() << "Corrupt FAISS delta entry (ids) for definition: " << definition;
+                replay_result = ResultCode::ERROR_PROCESSING_FAILED;
+                return false;
+            }
+            ids.resize(count);
+            std::memcpy(ids.data(), id_blob.data, id_blob.size);
+            
+            if (op == DELTA_OP_ADD) {
+                SQLiteDatabase::BlobView vector_blob = row.getBlobView(3);
+                if (vector_blob.size != static_cast<size_t>(count) * pImpl->dimension_ * sizeof(float)) {
+                    LEAFRA_ERROR() << "Corrupt FAISS delta entry (vectors) for definition: " << definition;
+                    replay_result = ResultCode::ERROR_PROCESSING_FAILED;
+                    return false;
+                }
+                vectors.resize(static_cast<size_t>(count) * pImpl->dimension_);
+                std::memcpy(vectors.data(), vector_blob.data, vector_blob.size);
+                if (pImpl->normalizes()) {
+                    // Deltas hold vectors as passed in - the staging buffer is ours, so normalize it in place
+                    simd::l2_normalize_rows(vectors.data(), static_cast<size_t>(count), static_cast<size_t>(pImpl->dimension_));
+                }
+                pImpl->ensure_writable();
+                id_map = pImpl->id_map_index_.get();
+                size_t first_offset = id_map->id_map.size();
+                id_map->add_with_ids(count, vectors.data(), ids.data());
+                pImpl->track_id_order(ids.data(), count, first_offset);
+            } else if (op == DELTA_OP_REMOVE) {
+                if (pImpl->uses_tombstones()) {
+                    pImpl->mark_tombstones(ids.data(), count);
+                } else {
+                    pImpl->ensure_writable();
+                    faiss::IDSelectorArray selector(count, ids.data());
+                    pImpl->id_map_index_->remove_ids(selector);
+                }
+            } else {
+                LEAFRA_ERROR() << "Unknown FAISS delta operation " << op << " for definition: " << definition;
+                replay_result = ResultCode::ERROR_PROCESSING_FAILED;
+                return false;
+            }
+            replayed += count;
+            delta_rows++;
+            return true;
+        });
+        if (replay_result != ResultCode::SUCCESS) {
+            return replay_result;
+        }
+        if (!stepped) {
+            LEAFRA_ERROR() << "Failed to read FAISS delta log: " << db.getLastErrorMessage();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        
+        pImpl->pending_delta_entries_ = replayed;
+        if (delta_rows > 0) {
+            pImpl->generation_++;
+            pImpl->advise_large_pages();
+            LEAFRA_INFO() << "Replayed " << delta_rows << " FAISS deltas (" << replayed << " entries), index now has "
+                          << (pImpl->get_index()->ntotal - pImpl->tombstone_count_) << " vectors ("
+                          << pImpl->tombstone_count_ << " tombstoned)";
+        }
+        return ResultCode::SUCCESS;
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "Failed to replay FAISS delta log: " << e.what();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+}
+
+ResultCode FaissIndex::save_to_file(SQLiteDatabase& db, const std::string& definition, const std::string& base_path) {
+    if (definition.empty() || base_path.empty()) {
+        LEAFRA_ERROR() << "Invalid definition or index file path";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    try {
+        std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+        if (!ensure_delta_table(db)) {
+            LEAFRA_ERROR() << "Failed to create FAISS delta table: " << db.getLastErrorMessage();
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        
+        // Every delta issued so far is already applied in memory
+        int64_t watermark = last_delta_id(db);
+        std::string path = index_file_path(base_path, watermark);
+        
+        // Tombstoned vectors are part of the file - log their removals past the watermark before writing it,
+        // so they are replayed on top of this file (and harmlessly re-applied on top of an older one)
+        std::vector<int64_t> carried_tombstones;
+        if (!pImpl->collect_tombstoned_ids(carried_tombstones)) {
+            ResultCode purge_result = pImpl->purge_tombstones();
+            if (purge_result != ResultCode::SUCCESS) {
+                return purge_result;
+            }
+        }
+        if (!carried_tombstones.empty() &&
+            append_delta(db, definition, DELTA_OP_REMOVE, carried_tombstones.data(),
+                         static_cast<int>(carried_tombstones.size()), nullptr, 0) != ResultCode::SUCCESS) {
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        std::string temp_path = path + ".tmp";
+        
+        // On-disk lists get a snapshot copy the index file points at, so later changes to the live lists can't reach it
+        faiss::OnDiskInvertedLists* lists = on_disk_lists(pImpl->get_index());
+        std::string live_lists;
+        if (lists) {
+            if (!clone_faiss_file(lists->filename, lists_file_path(path))) {
+                return ResultCode::ERROR_PROCESSING_FAILED;
+            }
+            live_lists = lists->filename;
+            lists->filename = lists_file_path(path);
+        }
+        try {
+            faiss::write_index(pImpl->get_index(), temp_path.c_str());
+        } catch (...) {
+            if (lists) {
+                lists->filename = live_lists;
+            }
+            throw;
+        }
+        if (lists) {
+            lists->filename = live_lists;
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp_path, path, ec);
+        if (ec) {
+            LEAFRA_ERROR() << "Failed to move FAISS index file into place: " << ec.message();
+            std::filesystem::remove(temp_path, ec);
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        
+        // The file now covers these deltas; leftovers after a crash here are skipped on load via the watermark
+        auto delete_deltas_stmt = db.prepare("DELETE FROM faissdeltatable WHERE definition = ? AND id <= ?");
+        if (!delete_deltas_stmt || !delete_deltas_stmt->isValid() || !delete_deltas_stmt->bindText(1, definition) ||
+            !delete_deltas_stmt->bindInt64(2, watermark) || !delete_deltas_stmt->execute()) {
+            LEAFRA_WARNING() << "Failed to trim FAISS delta log: " << db.getLastErrorMessage();
+        }
+        pImpl->pending_delta_entries_ = 0;
+        
+        for (const auto& file : list_index_files(base_path)) {
+            if (file.second != path && file.second != pImpl->mapped_file_) {
+                std::filesystem::remove(file.second, ec);
+                std::filesystem::remove(lists_file_path(file.second), ec);
+            }
+        }
+        
+        LEAFRA_INFO() << "FAISS index saved to file: " << path << " (" << (pImpl->get_index()->ntotal - pImpl->tombstone_count_) << " vectors, "
+                      << carried_tombstones.size() << " tombstones carried over)";
+        return ResultCode::SUCCESS;
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "Failed to save FAISS index to file: " << e.what();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+}
+
+void FaissIndex::remove_index_files(const std::string& base_path) {
+    for (const auto& file : list_index_files(base_path)) {
+        std::error_code ec;
+        std::filesystem::remove(file.second, ec);
+        std::filesystem::remove(lists_file_path(file.second), ec);
+        LEAFRA_DEBUG() << "Removed FAISS index file " << file.second;
+    }
+}
+
+ResultCode FaissIndex::copy_index_files(const std::string& base_path, const std::string& directory, int64_t& watermark) {
+    watermark = -1;
+    auto files = list_index_files(base_path);
+    if (files.empty()) {
+        return ResultCode::SUCCESS;
+    }
+    const std::string& path = files.back().second;
+    const std::filesystem::path target = std::filesystem::path(directory) / std::filesystem::path(path).filename();
+    if (!clone_faiss_file(path, target.string())) {
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    std::error_code ec;
+    if (std::filesystem::exists(lists_file_path(path), ec) &&
+        !clone_faiss_file(lists_file_path(path), lists_file_path(target.string()))) {
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    watermark = files.back().first;
+    LEAFRA_DEBUG() << "Copied FAISS index file " << path << " to " << directory;
+    return ResultCode::SUCCESS;
+}
+
+ResultCode FaissIndex::restore_from_file(SQLiteDatabase& db, const std::string& definition, const std::string& base_path,
+                                         bool use_mmap) {
+    if (definition.empty() || base_path.empty()) {
+        LEAFRA_ERROR() << "Invalid definition or index file path";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    auto files = list_index_files(base_path);
+    if (files.empty()) {
+        // Nothing on disk yet - pick up an index previously stored in the database (if any)
+        LEAFRA_DEBUG() << "No FAISS index file at " << base_path << " - falling back to database storage";
+        ResultCode result = restore_from_db(db, definition);
+        if (result == ResultCode::SUCCESS) {
+            LEAFRA_INFO() << "Migrating FAISS index from database to file storage";
+            save_to_file(db, definition, base_path);
+        }
+        return result;
+    }
+    const int64_t watermark = files.back().first;
+    const std::string& path = files.back().second;
+    
+    try {
+        std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+        // IO_FLAG_MMAP maps IVF inverted lists read-only straight from the file; other index types are read into memory.
+        // Lists saved to their own file are mapped read-only from next to the index file, wherever the app container is now
+        const bool inline_mmap = use_mmap && pImpl->on_disk_path_.empty();
+        auto loaded_index = std::unique_ptr<faiss::Index>(faiss::read_index(
+            path.c_str(), (inline_mmap ? faiss::IO_FLAG_MMAP : 0) | faiss::IO_FLAG_READ_ONLY | faiss::IO_FLAG_ONDISK_SAME_DIR));
+        if (!loaded_index) {
+            LEAFRA_ERROR() << "Failed to load FAISS index from: " << path;
+            return ResultCode::ERROR_PROCESSING_FAILED;
+        }
+        faiss::OnDiskInvertedLists* saved_lists = on_disk_lists(loaded_index.get());
+        if (saved_lists && !saved_lists->ptr && saved_lists->totsize > 0) {
+            saved_lists->read_only = true;
+            saved_lists->do_mmap();
+        }
+        
+        if (!pImpl->accepts_dimension(loaded_index->d)) {
+            LEAFRA_ERROR() << "Dimension mismatch: expected " << pImpl->dimension_ << ", got " << loaded_index->d;
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+        
+        auto [loaded_index_type, type_detected] = detect_index_type_safe(loaded_index.get());
+        if (!type_detected || !pImpl->accepts_type(loaded_index_type)) {
+            LEAFRA_ERROR() << "Index type mismatch: expected " << index_type_to_string(pImpl->index_type_)
+                          << ", got " << (type_detected ? index_type_to_string(loaded_index_type) : "Unknown");
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+        
+        const auto* id_map = dynamic_cast<const faiss::IndexIDMap*>(loaded_index.get());
+        bool mapped = saved_lists || (inline_mmap && dynamic_cast<const faiss::IndexIVF*>(id_map ? id_map->index : loaded_index.get()) != nullptr);
+        if (!mapped) {
+            pImpl->store_lists_on_disk(loaded_index.get());
+        }
+        
+        ExclusiveLock index_lock(pImpl->index_mutex_);
+        pImpl->adopt(std::move(loaded_index));
+        pImpl->mapped_file_ = mapped ? path : std::string();
+        pImpl->clear_tombstones();
+        pImpl->refresh_id_order();
+        pImpl->generation_++;
+        pImpl->advise_large_pages();
+        
+        LEAFRA_INFO() << "FAISS index loaded from file: " << path << " (" << pImpl->get_index()->ntotal << " vectors"
+                      << (mapped ? ", mmapped" : "") << ")";
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "Failed to load FAISS index from file: " << e.what();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+    
+    int64_t replayed = 0;
+    return replay_deltas_from_db(db, definition, replayed, watermark);
+}
+
+bool FaissIndex::is_memory_mapped() const {
+    ReadLock read_lock(pImpl->index_mutex_);
+    return !pImpl->mapped_file_.empty();
+}
+
+uint64_t FaissIndex::prefetch() const {
+    ReadLock read_lock(pImpl->index_mutex_);
+    uint64_t requested = 0;
+    if (!pImpl->mapped_file_.empty()) {
+        requested += FileManager::prefetchFile(pImpl->mapped_file_);
+    }
+    if (const faiss::OnDiskInvertedLists* lists = on_disk_lists(pImpl->get_index())) {
+        if (lists->filename != pImpl->mapped_file_) {
+            requested += FileManager::prefetchFile(lists->filename);
+        }
+    }
+    return requested;
+}
+
+ResultCode FaissIndex::append_vectors_to_db(SQLiteDatabase& db, const std::string& definition,
+                                            const float* vectors, const int64_t* ids, int count) {
+    if (definition.empty() || !vectors || !ids || count <= 0) {
+        LEAFRA_ERROR() << "Invalid parameters for FAISS delta append";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+    vectors = pImpl->reduce_rows(vectors, static_cast<size_t>(count), reduction_scratch());
+    ResultCode result = append_delta(db, definition, DELTA_OP_ADD, ids, count, vectors, pImpl->dimension_);
+    if (result == ResultCode::SUCCESS) {
+        pImpl->pending_delta_entries_ += count;
+        LEAFRA_DEBUG() << "Appended " << count << " vectors to FAISS delta log (" << pImpl->pending_delta_entries_ << " pending)";
+    }
+    return result;
+}
+
+ResultCode FaissIndex::append_removals_to_db(SQLiteDatabase& db, const std::string& definition, const int64_t* ids, int count) {
+    if (definition.empty() || !ids || count <= 0) {
+        LEAFRA_ERROR() << "Invalid parameters for FAISS tombstone append";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    
+    std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+    ResultCode result = append_delta(db, definition, DELTA_OP_REMOVE, ids, count, nullptr, 0);
+    if (result == ResultCode::SUCCESS) {
+        pImpl->pending_delta_entries_ += count;
+        LEAFRA_DEBUG() << "Appended " << count << " tombstones to FAISS delta log (" << pImpl->pending_delta_entries_ << " pending)";
+    }
+    return result;
+}
+
+int64_t FaissIndex::get_pending_delta_count() const {
+    return pImpl->pending_delta_entries_;
+}
+
 ResultCode FaissIndex::remove_vectors(const int64_t* ids, int count) {
     if (!ids || count <= 0) {
         LEAFRA_ERROR() << "Invalid IDs or count";
@@ -654,15 +2290,29 @@ ResultCode FaissIndex::remove_vectors(const int64_t* ids, int count) {
     }
     
     try {
+        std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+        ExclusiveLock index_lock(pImpl->index_mutex_);
         // ID mapping is enabled by default in constructor
         if (!pImpl->id_map_index_) {
             LEAFRA_ERROR() << "ID mapping not available for vector removal";
             return ResultCode::ERROR_PROCESSING_FAILED;
         }
         
-        // FAISS IndexIDMap supports remove_ids with IDSelector
-        faiss::IDSelectorArray selector(count, ids);
+        // Tombstones leave the stored vectors untouched, so an mmapped index stays mapped
+        if (pImpl->uses_tombstones()) {
+            int64_t marked = pImpl->mark_tombstones(ids, count);
+            pImpl->generation_++;
+            LEAFRA_DEBUG() << "Tombstoned " << marked << " vectors in FAISS index (" << pImpl->tombstone_count_
+                           << " tombstones of " << pImpl->get_index()->ntotal << " stored)";
+            return ResultCode::SUCCESS;
+        }
+        
+        // remove_ids tests every stored id against the selector: IDSelectorBatch's hash set keeps
+        // that one O(ntotal) pass however many ids go at once (IDSelectorArray scans the list per id)
+        pImpl->ensure_writable();
+        faiss::IDSelectorBatch selector(count, ids);
         pImpl->id_map_index_->remove_ids(selector);
+        pImpl->generation_++;
         
         LEAFRA_DEBUG() << "Removed " << count << " vectors from FAISS index";
         return ResultCode::SUCCESS;
@@ -672,6 +2322,128 @@ ResultCode FaissIndex::remove_vectors(const int64_t* ids, int count) {
     }
 }
 
+ResultCode FaissIndex::purge_tombstones() {
+    std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+    use_omp_threads(pImpl->omp_threads_);
+    return pImpl->purge_tombstones();
+}
+
+ResultCode FaissIndex::migrate(IndexType target_type, int nlist, int pq_m, int pq_nbits) {
+    const bool to_ivf = target_type == IndexType::IVF_FLAT || target_type == IndexType::IVF_PQ;
+    if (!to_ivf && target_type != IndexType::SQ8 && target_type != IndexType::HNSW_SQ) {
+        LEAFRA_ERROR() << "FAISS index can only be migrated to IVF_FLAT, IVF_PQ, SQ8 or HNSW_SQ";
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    std::lock_guard<std::mutex> write_lock(pImpl->write_mutex_);
+    if (target_type == pImpl->index_type_) {
+        return ResultCode::SUCCESS;
+    }
+    use_omp_threads(pImpl->omp_threads_);
+    
+    try {
+        // The replacement is built entirely next to the current index, which stays untouched (and searchable) until the swap
+        std::vector<faiss::idx_t> live_ids;
+        Impl::LiveVectors live_vectors;
+        pImpl->copy_live_vectors(live_ids, live_vectors);
+        
+        const int dimension = pImpl->dimension_;
+        const int64_t count = static_cast<int64_t>(live_ids.size());
+        faiss::MetricType metric = Impl::to_faiss_metric(pImpl->metric_type_);
+        std::unique_ptr<faiss::Index> replacement;
+        int64_t min_training = 1;
+        int64_t max_training = kMaxScalarQuantizerTrainingVectors;
+        if (to_ivf) {
+            if (nlist <= 0) {
+                nlist = static_cast<int>(4.0 * std::sqrt(static_cast<double>(count)));
+            }
+            nlist = static_cast<int>(std::min<int64_t>(nlist, count / kMinTrainingVectorsPerList));
+            if (nlist < 1) {
+                LEAFRA_ERROR() << "Too few vectors to train an IVF index: " << count;
+                return ResultCode::ERROR_INVALID_PARAMETER;
+            }
+            
+            auto quantizer = std::make_unique<faiss::IndexFlat>(dimension, metric);
+            std::unique_ptr<faiss::IndexIVF> ivf;
+            min_training = static_cast<int64_t>(nlist);
+            if (target_type == IndexType::IVF_PQ) {
+                if (pq_m <= 0 || dimension % pq_m != 0) {
+                    pq_m = std::max(1, dimension / 8);
+                    while (dimension % pq_m != 0) {
+                        pq_m--;
+                    }
+                }
+                pq_nbits = std::max(1, std::min(pq_nbits, 16));
+                min_training = std::max<int64_t>(min_training, int64_t(1) << pq_nbits);
+                if (count < min_training) {
+                    LEAFRA_ERROR() << "Too few vectors to train IVF_PQ codebooks: " << count << " (need " << min_training << ")";
+                    return ResultCode::ERROR_INVALID_PARAMETER;
+                }
+                ivf = std::make_unique<faiss::IndexIVFPQ>(quantizer.get(), dimension, nlist, pq_m, pq_nbits, metric);
+            } else {
+                ivf = std::make_unique<faiss::IndexIVFFlat>(quantizer.get(), dimension, nlist, metric);
+            }
+            quantizer.release();
+            ivf->own_fields = true;
+            ivf->nprobe = std::min<size_t>(ivf->nlist, 10);
+            max_training = kMaxTrainingVectorsPerList * nlist;
+            replacement = std::move(ivf);
+        } else {
+            if (count < min_training) {
+                LEAFRA_ERROR() << "No vectors to train the scalar quantizer on";
+                return ResultCode::ERROR_INVALID_PARAMETER;
+            }
+            // Only per-dimension value ranges are learned, so a modest sample is plenty
+            if (target_type == IndexType::SQ8) {
+                replacement = std::make_unique<faiss::IndexScalarQuantizer>(dimension, faiss::ScalarQuantizer::QT_8bit, metric);
+            } else {
+                replacement = std::make_unique<faiss::IndexHNSWSQ>(dimension, faiss::ScalarQuantizer::QT_8bit, kHnswM, metric);
+            }
+        }
+        
+        // Train on an evenly strided sample of the corpus (stored vectors are already unit length for COSINE)
+        const size_t row_size = static_cast<size_t>(dimension);
+        int64_t train_count = std::max(min_training, std::min<int64_t>(count, max_training));
+        std::vector<float> training;
+        const float* training_vectors = live_vectors.data();
+        if (train_count < count) {
+            training.resize(static_cast<size_t>(train_count) * row_size);
+            for (int64_t i = 0; i < train_count; ++i) {
+                const float* row = live_vectors.data() + static_cast<size_t>(i * count / train_count) * row_size;
+                std::memcpy(training.data() + static_cast<size_t>(i) * row_size, row, row_size * sizeof(float));
+            }
+            training_vectors = training.data();
+        }
+        replacement->train(train_count, training_vectors);
+        
+        auto id_map = std::make_unique<faiss::IndexIDMap>(replacement.release());
+        id_map->own_fields = true;
+        id_map->add_with_ids(count, live_vectors.data(), live_ids.data());
+        if (!on_disk_lists(pImpl->get_index())) {
+            pImpl->store_lists_on_disk(id_map.get());
+        }
+        
+        IndexType previous_type = pImpl->index_type_;
+        ExclusiveLock index_lock(pImpl->index_mutex_);
+        pImpl->id_map_index_ = std::move(id_map);
+        pImpl->index_.reset();
+        pImpl->use_id_map_ = true;
+        pImpl->index_type_ = target_type;
+        pImpl->mapped_file_.clear();
+        pImpl->clear_tombstones();
+        pImpl->refresh_id_order();
+        pImpl->generation_++;
+        pImpl->advise_large_pages();
+        LEAFRA_INFO() << "Migrated FAISS index from " << index_type_to_string(previous_type) << " to "
+                      << index_type_to_string(target_type) << " (" << count << " vectors"
+                      << (to_ivf ? ", nlist=" + std::to_string(nlist) : std::string())
+                      << ", trained on " << train_count << ")";
+        return ResultCode::SUCCESS;
+    } catch (const std::exception& e) {
+        LEAFRA_ERROR() << "Failed to migrate FAISS index: " << e.what();
+        return ResultCode::ERROR_PROCESSING_FAILED;
+    }
+}
+
 } // namespace leafra
 
 #endif // LEAFRA_HAS_FAISS 
\ No newline at end of file
@@ -3,19 +3,76 @@
 #include <fstream>
 #include <filesystem>
 #include <cstring>
+#include <iterator>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #ifdef __APPLE__
     #include <Foundation/Foundation.h>
     #include <TargetConditionals.h>
 #endif
 
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// File watcher backend
+#if defined(__linux__)
+    #define LEAFRA_WATCHER_INOTIFY 1
+    #include <sys/inotify.h>
+    #include <poll.h>
+    #include <unistd.h>
+#elif defined(__APPLE__) && TARGET_OS_OSX
+    #define LEAFRA_WATCHER_FSEVENTS 1
+    #include <CoreServices/CoreServices.h>
+#elif defined(__APPLE__)
+    #define LEAFRA_WATCHER_KQUEUE 1
+    #include <sys/event.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
 namespace leafra {
 
 // ==============================================================================
 // Platform-specific storage path resolution
 // ==============================================================================
 
+namespace {
+
+// Directories set by FileManager::setStorageBasePath, by StorageType (empty = platform location)
+std::mutex storage_override_mutex;
+std::string storage_overrides[2];
+
+} // namespace
+
+void FileManager::setStorageBasePath(StorageType storage_type, const std::string& absolute_path) {
+    std::lock_guard<std::mutex> lock(storage_override_mutex);
+    storage_overrides[static_cast<size_t>(storage_type)] = absolute_path;
+}
+
 std::string FileManager::getStorageBasePath(StorageType storage_type) {
+    {
+        std::lock_guard<std::mutex> lock(storage_override_mutex);
+        const std::string& override_path = storage_overrides[static_cast<size_t>(storage_type)];
+        if (!override_path.empty()) {
+            return override_path;
+        }
+    }
+    
 #ifdef __APPLE__
     NSArray *paths = nil;
     NSString *basePath = nil;
@@ -259,6 +316,162 @@ ResultCode FileManager::getFileInfo(StorageType storage_type, const std::string&
     return ResultCode::SUCCESS;
 }
 
+// ==============================================================================
+// Memory-mapped reads
+// ==============================================================================
+
+FileManager::MappedFile::~MappedFile() {
+    close();
+}
+
+FileManager::MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mapping_(other.mapping_), size_(other.size_), buffer_(std::move(other.buffer_)), open_(other.open_) {
+    other.mapping_ = nullptr;
+    other.size_ = 0;
+    other.open_ = false;
+}
+
+FileManager::MappedFile& FileManager::MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        mapping_ = other.mapping_;
+        size_ = other.size_;
+        buffer_ = std::move(other.buffer_);
+        open_ = other.open_;
+        other.mapping_ = nullptr;
+        other.size_ = 0;
+        other.open_ = false;
+    }
+    return *this;
+}
+
+void FileManager::MappedFile::close() {
+    if (mapping_) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping_);
+#else
+        munmap(mapping_, size_);
+#endif
+        mapping_ = nullptr;
+    }
+    size_ = 0;
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    open_ = false;
+}
+
+bool FileManager::MappedFile::open(const std::string& full_path, AccessHint hint) {
+    close();
+    
+#ifdef _WIN32
+    HANDLE file = CreateFileA(full_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, hint == AccessHint::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER file_size{};
+        bool sized = GetFileSizeEx(file, &file_size) != 0;
+        if (sized && file_size.QuadPart == 0) {
+            CloseHandle(file);
+            open_ = true;   // Empty files can't be mapped; an empty view is the right answer anyway
+            return true;
+        }
+        HANDLE mapping = sized ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        if (mapping) {
+            mapping_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);   // The view keeps the mapping alive
+        }
+        CloseHandle(file);
+        if (mapping_) {
+            size_ = static_cast<size_t>(file_size.QuadPart);
+            open_ = true;
+            return true;
+        }
+    }
+#else
+    int fd = ::open(full_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        struct stat info;
+        if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+            if (info.st_size == 0) {
+                ::close(fd);
+                open_ = true;   // mmap rejects empty ranges
+                return true;
+            }
+            void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                ::close(fd);   // The mapping keeps the file referenced
+                mapping_ = mapping;
+                size_ = static_cast<size_t>(info.st_size);
+                if (hint != AccessHint::Normal) {
+                    madvise(mapping_, size_, hint == AccessHint::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+                }
+                open_ = true;
+                return true;
+            }
+        }
+        ::close(fd);
+    }
+#endif
+    
+    // Not mappable (special file, exhausted address space, ...): read it instead
+    std::ifstream file(full_path, std::ios::binary);
+    if (!file.is_open()) {
+        LEAFRA_DEBUG() << "Failed to open file for reading: " << full_path;
+        return false;
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (file.bad()) {
+        buffer_.clear();
+        return false;
+    }
+    open_ = true;
+    return true;
+} //open
+
+FileManager::MappedFile FileManager::mapFile(StorageType storage_type, const std::string& relative_path, AccessHint hint) {
+    MappedFile mapped;
+    std::string full_path = getAbsolutePath(storage_type, relative_path);
+    if (full_path.empty()) {
+        return mapped;
+    }
+    if (!mapped.open(full_path, hint)) {
+        LEAFRA_ERROR() << "Failed to map file: " << full_path;
+    }
+    return mapped;
+}
+
+FileManager::MappedFile FileManager::mapFile(const std::string& full_path, AccessHint hint) {
+    MappedFile mapped;
+    mapped.open(full_path, hint);
+    return mapped;
+}
+
+uint64_t FileManager::prefetchFile(const std::string& full_path) {
+#ifdef _WIN32
+    (void)full_path;
+    return 0;
+#else
+    int fd = ::open(full_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return 0;
+    }
+    uint64_t requested = 0;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        const size_t size = static_cast<size_t>(info.st_size);
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            // Readahead is started by the hint and outlives the mapping
+            if (madvise(mapping, size, MADV_WILLNEED) == 0) {
+                requested = size;
+            }
+            munmap(mapping, size);
+        }
+    }
+    ::close(fd);
+    return requested;
+#endif
+}
+
 // ==============================================================================
 // Directory operations
 // ==============================================================================
@@ -377,4 +590,607 @@ bool FileManager::ensureParentDirectoriesExist(const std::string& full_path) {
     return true;
 }
 
+// ==============================================================================
+// File watcher
+// ==============================================================================
+
+namespace {
+
+struct FileStamp {
+    uintmax_t size = 0;
+    std::filesystem::file_time_type mtime{};
+    
+    bool operator==(const FileStamp& other) const { return size == other.size && mtime == other.mtime; }
+    bool operator!=(const FileStamp& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Last seen contents of one watched directory
+ */
+struct DirectorySnapshot {
+    std::unordered_map<std::string, FileStamp> files;     // File name -> size / mtime
+    std::unordered_set<std::string> subdirectories;       // Watched subdirectory names
+};
+
+std::string normalizeWatchedExtension(std::string extension) {
+    if (!extension.empty() && extension[0] == '.') {
+        extension.erase(0, 1);
+    }
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension;
+}
+
+} // namespace
+
+class FileWatcher::Impl {
+public:
+    ~Impl() { stop(); }
+    
+    ResultCode start(const std::string& root, const Options& options, ChangeCallback callback) {
+        if (running_) {
+            LEAFRA_ERROR() << "File watcher already running on " << root_;
+            return ResultCode::ERROR_INVALID_PARAMETER;
+        }
+        
+        std::error_code error;
+        std::filesystem::path canonical_root = std::filesystem::canonical(root, error);
+        if (error || !std::filesystem::is_directory(canonical_root, error)) {
+            LEAFRA_ERROR() << "Cannot watch " << root << ": not a directory";
+            return ResultCode::ERROR_NOT_FOUND;
+        }
+        
+        root_ = canonical_root.string();
+        options_ = options;
+        callback_ = std::move(callback);
+        extensions_.clear();
+        for (const std::string& extension : options.extensions) {
+            extensions_.push_back(normalizeWatchedExtension(extension));
+        }
+        snapshot_.clear();
+        dirty_.clear();
+        rescan_all_ = false;
+        stopping_ = false;
+        
+        if (!startBackend()) {
+            return ResultCode::ERROR_NOT_IMPLEMENTED;
+        }
+        
+        // Baseline: the current contents are known, only what changes afterwards is reported
+        Changes ignored;
+        addTree(root_, ignored);
+        
+        running_ = true;
+        debounce_thread_ = std::thread([this]() { debounceLoop(); });
+        LEAFRA_INFO() << "👀 Watching " << root_ << " (" << snapshot_.size() << " directories)";
+        return ResultCode::SUCCESS;
+    } //start
+    
+    void stop() {
+        if (!running_) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        stopBackend();
+        if (debounce_thread_.joinable()) {
+            debounce_thread_.join();
+        }
+        snapshot_.clear();
+        running_ = false;
+        LEAFRA_INFO() << "Stopped watching " << root_;
+    } //stop
+    
+    bool isRunning() const {
+        return running_;
+    }
+    
+private:
+    std::string root_;
+    Options options_;
+    ChangeCallback callback_;
+    std::vector<std::string> extensions_;                              // Normalized Options::extensions
+    std::unordered_map<std::string, DirectorySnapshot> snapshot_;      // Keyed by directory path (debounce thread only)
+    
+    std::mutex mutex_;                                                 // Guards dirty_, rescan_all_, last_event_, stopping_
+    std::condition_variable cv_;
+    std::set<std::string> dirty_;                                      // Sorted, so parents are rescanned before children
+    bool rescan_all_ = false;                                          // Events were lost - rescan every watched directory
+    std::chrono::steady_clock::time_point last_event_;
+    bool stopping_ = false;
+    std::atomic<bool> running_{false};
+    std::thread debounce_thread_;
+    
+    /**
+     * @brief Called by the backend for every notification
+     */
+    void markDirty(const std::string& directory) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            dirty_.insert(directory);
+            last_event_ = std::chrono::steady_clock::now();
+        }
+        cv_.notify_one();
+    }
+    
+    void markAllDirty() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rescan_all_ = true;
+            last_event_ = std::chrono::steady_clock::now();
+        }
+        cv_.notify_one();
+    }
+    
+    void debounceLoop() {
+        const auto quiet_period = std::chrono::milliseconds(std::max(0, options_.debounce_ms));
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            if (dirty_.empty() && !rescan_all_) {
+                cv_.wait(lock, [this]() { return stopping_ || !dirty_.empty() || rescan_all_; });
+                continue;
+            }
+            auto deadline = last_event_ + quiet_period;
+            if (std::chrono::steady_clock::now() < deadline) {
+                cv_.wait_until(lock, deadline);
+                continue;
+            }
+            
+            std::set<std::string> dirty;
+            dirty.swap(dirty_);
+            bool rescan_all = rescan_all_;
+            rescan_all_ = false;
+            lock.unlock();
+            
+            if (rescan_all) {
+                LEAFRA_WARNING() << "File watcher lost events, rescanning " << root_;
+                for (const auto& [directory, contents] : snapshot_) {
+                    dirty.insert(directory);
+                }
+            }
+            Changes changes;
+            for (const std::string& directory : dirty) {
+                rescanDirectory(directory, changes);
+            }
+            if ((!changes.modified.empty() || !changes.removed.empty()) && callback_) {
+                LEAFRA_DEBUG() << "File watcher: " << changes.modified.size() << " modified, " << changes.removed.size() << " removed";
+                callback_(changes);
+            }
+            
+            lock.lock();
+        }
+    } //debounceLoop
+    
+    bool isReported(const std::filesystem::path& path) const {
+        if (extensions_.empty()) {
+            return true;
+        }
+        std::string extension = normalizeWatchedExtension(path.extension().string());
+        return std::find(extensions_.begin(), extensions_.end(), extension) != extensions_.end();
+    }
+    
+    /**
+     * @brief Compare a watched directory with its snapshot and record the differences
+     */
+    void rescanDirectory(const std::string& directory, Changes& changes) {
+        auto previous = snapshot_.find(directory);
+        if (previous == snapshot_.end()) {
+            return;   // Not watched (non-recursive watch, or removed with its parent)
+        }
+        
+        DirectorySnapshot current;
+        std::error_code error;
+        std::filesystem::directory_iterator it(directory, std::filesystem::directory_options::skip_permission_denied, error);
+        if (error) {
+            removeTree(directory, changes);
+            return;
+        }
+        for (std::filesystem::directory_iterator end; !error && it != end; it.increment(error)) {
+            const std::filesystem::directory_entry& entry = *it;
+            std::string name = entry.path().filename().string();
+            std::error_code entry_error;
+            if (name.empty() || name[0] == '.' || entry.is_symlink(entry_error)) {
+                continue;
+            }
+            if (entry.is_directory(entry_error)) {
+                if (options_.recursive) {
+                    current.subdirectories.insert(name);
+                }
+            } else if (entry.is_regular_file(entry_error) && isReported(entry.path())) {
+                FileStamp stamp;
+                stamp.size = entry.file_size(entry_error);
+                stamp.mtime = entry.last_write_time(entry_error);
+                if (!entry_error) {
+                    current.files.emplace(std::move(name), stamp);
+                }
+            }
+        }
+        if (error) {
+            markDirty(directory);   // Listing failed midway - keep the snapshot and try again later
+            return;
+        }
+        
+        DirectorySnapshot& known = previous->second;
+        std::filesystem::path base(directory);
+        for (const auto& [name, stamp] : current.files) {
+            auto old = known.files.find(name);
+            if (old == known.files.end() || old->second != stamp) {
+                changes.modified.push_back((base / name).string());
+            }
+        }
+        for (const auto& [name, stamp] : known.files) {
+            if (current.files.find(name) == current.files.end()) {
+                changes.removed.push_back((base / name).string());
+            }
+        }
+        std::vector<std::string> added_directories;
+        std::vector<std::string> removed_directories;
+        for (const std::string& name : current.subdirectories) {
+            if (known.subdirectories.find(name) == known.subdirectories.end()) {
+                added_directories.push_back((base / name).string());
+            }
+        }
+        for (const std::string& name : known.subdirectories) {
+            if (current.subdirectories.find(name) == current.subdirectories.end()) {
+                removed_directories.push_back((base / name).string());
+            }
+        }
+        known = std::move(current);   // addTree / removeTree below may rehash snapshot_
+        
+        for (const std::string& path : removed_directories) {
+            removeTree(path, changes);
+        }
+        for (const std::string& path : added_directories) {
+            addTree(path, changes);
+        }
+    } //rescanDirectory
+    
+    /**
+     * @brief Start watching a directory that wasn't watched yet; its whole contents count as modified
+     */
+    void addTree(const std::string& directory, Changes& changes) {
+        if (snapshot_.count(directory)) {
+            return;
+        }
+        snapshot_.emplace(directory, DirectorySnapshot());
+        addWatch(directory);   // Before the scan, so files created meanwhile aren't missed
+        rescanDirectory(directory, changes);
+    }
+    
+    /**
+     * @brief Forget a directory that disappeared; its whole known contents count as removed
+     */
+    void removeTree(const std::string& directory, Changes& changes) {
+        auto known = snapshot_.find(directory);
+        if (known == snapshot_.end()) {
+            return;
+        }
+        DirectorySnapshot contents = std::move(known->second);
+        snapshot_.erase(known);
+        removeWatch(directory);
+        
+        std::filesystem::path base(directory);
+        for (const auto& [name, stamp] : contents.files) {
+            changes.removed.push_back((base / name).string());
+        }
+        for (const std::string& name : contents.subdirectories) {
+            removeTree((base / name).string(), changes);
+        }
+    }
+    
+#if defined(LEAFRA_WATCHER_INOTIFY)
+    int inotify_fd_ = -1;
+    int wake_pipe_[2] = {-1, -1};
+    std::mutex watch_mutex_;                                           // Guards the watch maps (debounce + reader thread)
+    std::unordered_map<int, std::string> watch_paths_;                 // Watch descriptor -> directory
+    std::unordered_map<std::string, int> watch_descriptors_;
+    std::thread reader_thread_;
+    
+    bool startBackend() {
+        inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_fd_ < 0 || pipe(wake_pipe_) != 0) {
+            LEAFRA_ERROR() << "Failed to initialize inotify: " << std::strerror(errno);
+            closeBackend();
+            return false;
+        }
+        reader_thread_ = std::thread([this]() { readEvents(); });
+        return true;
+    }
+    
+    void stopBackend() {
+        if (wake_pipe_[1] >= 0) {
+            char byte = 0;
+            if (write(wake_pipe_[1], &byte, 1) < 0) {
+                LEAFRA_WARNING() << "Failed to wake the file watcher reader: " << std::strerror(errno);
+            }
+        }
+        if (reader_thread_.joinable()) {
+            reader_thread_.join();
+        }
+        closeBackend();
+    }
+    
+    void closeBackend() {
+        for (int* fd : {&inotify_fd_, &wake_pipe_[0], &wake_pipe_[1]}) {
+            if (*fd >= 0) {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+        std::lock_guard<std::mutex> lock(watch_mutex_);
+        watch_paths_.clear();
+        watch_descriptors_.clear();
+    }
+    
+    void addWatch(const std::string& directory) {
+        int wd = inotify_add_watch(inotify_fd_, directory.c_str(),
+                                   IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB |
+                                   IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+        if (wd < 0) {
+            LEAFRA_WARNING() << "Cannot watch " << directory << ": " << std::strerror(errno);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(watch_mutex_);
+        watch_paths_[wd] = directory;
+        watch_descriptors_[directory] = wd;
+    }
+    
+    void removeWatch(const std::string& directory) {
+        std::lock_guard<std::mutex> lock(watch_mutex_);
+        auto it = watch_descriptors_.find(directory);
+        if (it != watch_descriptors_.end()) {
+            inotify_rm_watch(inotify_fd_, it->second);
+            watch_paths_.erase(it->second);
+            watch_descriptors_.erase(it);
+        }
+    }
+    
+    void readEvents() {
+        alignas(struct inotify_event) char buffer[16 * 1024];
+        pollfd fds[2] = {{inotify_fd_, POLLIN, 0}, {wake_pipe_[0], POLLIN, 0}};
+        while (true) {
+            if (poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            if (fds[1].revents) {
+                break;
+            }
+            ssize_t length = read(inotify_fd_, buffer, sizeof(buffer));
+            for (ssize_t offset = 0; offset < length;) {
+                const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+                if (event->mask & IN_Q_OVERFLOW) {
+                    markAllDirty();
+                    continue;
+                }
+                std::string directory;
+                {
+                    std::lock_guard<std::mutex> lock(watch_mutex_);
+                    auto it = watch_paths_.find(event->wd);
+                    if (it == watch_paths_.end()) {
+                        continue;
+                    }
+                    directory = it->second;
+                    if (event->mask & IN_IGNORED) {
+                        watch_descriptors_.erase(directory);
+                        watch_paths_.erase(it);
+                    }
+                }
+                markDirty(directory);
+            }
+        }
+    } //readEvents
+    
+#elif defined(LEAFRA_WATCHER_FSEVENTS)
+    FSEventStreamRef stream_ = nullptr;
+    dispatch_queue_t queue_ = nullptr;
+    
+    static void onEvents(ConstFSEventStreamRef, void* info, size_t count, void* paths, const FSEventStreamEventFlags flags[],
+                         const FSEventStreamEventId[]) {
+        Impl* self = static_cast<Impl*>(info);
+        char** event_paths = static_cast<char**>(paths);
+        for (size_t i = 0; i < count; ++i) {
+            if (flags[i] & (kFSEventStreamEventFlagMustScanSubDirs | kFSEventStreamEventFlagKernelDropped | kFSEventStreamEventFlagUserDropped)) {
+                self->markAllDirty();
+                continue;
+            }
+            std::filesystem::path path(event_paths[i]);
+            if (flags[i] & kFSEventStreamEventFlagItemIsDir) {
+                self->markDirty(path.string());
+            }
+            self->markDirty(path.parent_path().string());
+        }
+    }
+    
+    // FSEvents watches the whole tree itself; rescans skip directories that aren't in the snapshot
+    bool startBackend() {
+        CFStringRef root = CFStringCreateWithCString(kCFAllocatorDefault, root_.c_str(), kCFStringEncodingUTF8);
+        CFArrayRef paths = CFArrayCreate(kCFAllocatorDefault, reinterpret_cast<const void**>(&root), 1, &kCFTypeArrayCallBacks);
+        FSEventStreamContext context = {0, this, nullptr, nullptr, nullptr};
+        stream_ = FSEventStreamCreate(kCFAllocatorDefault, &Impl::onEvents, &context, paths, kFSEventStreamEventIdSinceNow, 0.05,
+                                      kFSEventStreamCreateFlagFileEvents | kFSEventStreamCreateFlagNoDefer);
+        CFRelease(paths);
+        CFRelease(root);
+        if (!stream_) {
+            LEAFRA_ERROR() << "Failed to create FSEvents stream for " << root_;
+            return false;
+        }
+        queue_ = dispatch_queue_create("com.leafra.filewatcher", DISPATCH_QUEUE_SERIAL);
+        FSEventStreamSetDispatchQueue(stream_, queue_);
+        if (!FSEventStreamStart(stream_)) {
+            LEAFRA_ERROR() << "Failed to start FSEvents stream for " << root_;
+            stopBackend();
+            return false;
+        }
+        return true;
+    }
+    
+    void stopBackend() {
+        if (stream_) {
+            FSEventStreamStop(stream_);
+            FSEventStreamInvalidate(stream_);
+            FSEventStreamRelease(stream_);
+            stream_ = nullptr;
+        }
+        if (queue_) {
+            dispatch_sync(queue_, ^{});   // Let a callback that is still running finish
+            queue_ = nullptr;
+        }
+    }
+    
+    void addWatch(const std::string&) {}
+    void removeWatch(const std::string&) {}
+    
+#elif defined(LEAFRA_WATCHER_KQUEUE)
+    int kqueue_fd_ = -1;
+    std::mutex watch_mutex_;                                           // Guards the watch maps (debounce + reader thread)
+    std::unordered_map<int, std::string> watch_paths_;                 // Directory fd -> directory
+    std::unordered_map<std::string, int> watch_descriptors_;
+    std::thread reader_thread_;
+    static constexpr uintptr_t kWakeIdent = 0;
+    
+    bool startBackend() {
+        kqueue_fd_ = kqueue();
+        if (kqueue_fd_ < 0) {
+            LEAFRA_ERROR() << "Failed to initialize kqueue: " << std::strerror(errno);
+            return false;
+        }
+        struct kevent wake;
+        EV_SET(&wake, kWakeIdent, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, nullptr);
+        kevent(kqueue_fd_, &wake, 1, nullptr, 0, nullptr);
+        reader_thread_ = std::thread([this]() { readEvents(); });
+        return true;
+    }
+    
+    void stopBackend() {
+        if (kqueue_fd_ >= 0) {
+            struct kevent wake;
+            EV_SET(&wake, kWakeIdent, EVFILT_USER, 0, NOTE_TRIGGER, 0, nullptr);
+            kevent(kqueue_fd_, &wake, 1, nullptr, 0, nullptr);
+        }
+        if (reader_thread_.joinable()) {
+            reader_thread_.join();
+        }
+        std::lock_guard<std::mutex> lock(watch_mutex_);
+        for (const auto& [fd, directory] : watch_paths_) {
+            close(fd);
+        }
+        watch_paths_.clear();
+        watch_descriptors_.clear();
+        if (kqueue_fd_ >= 0) {
+            close(kqueue_fd_);
+            kqueue_fd_ = -1;
+        }
+    }
+    
+    void addWatch(const std::string& directory) {
+        int fd = open(directory.c_str(), O_EVTONLY);
+        if (fd < 0) {
+            LEAFRA_WARNING() << "Cannot watch " << directory << ": " << std::strerror(errno);
+            return;
+        }
+        struct kevent change;
+        EV_SET(&change, static_cast<uintptr_t>(fd), EVFILT_VNODE, EV_ADD | EV_CLEAR,
+               NOTE_WRITE | NOTE_EXTEND | NOTE_ATTRIB | NOTE_DELETE | NOTE_RENAME, 0, nullptr);
+        std::lock_guard<std::mutex> lock(watch_mutex_);
+        if (kevent(kqueue_fd_, &change, 1, nullptr, 0, nullptr) < 0) {
+            close(fd);
+            return;
+        }
+        watch_paths_[fd] = directory;
+        watch_descriptors_[directory] = fd;
+    }
+    
+    void removeWatch(const std::string& directory) {
+        std::lock_guard<std::mutex> lock(watch_mutex_);
+        auto it = watch_descriptors_.find(directory);
+        if (it != watch_descriptors_.end()) {
+            close(it->second);   // Closing the descriptor removes its kevent
+            watch_paths_.erase(it->second);
+            watch_descriptors_.erase(it);
+        }
+    }
+    
+    void readEvents() {
+        struct kevent events[64];
+        while (true) {
+            int count = kevent(kqueue_fd_, nullptr, 0, events, 64, nullptr);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            for (int i = 0; i < count; ++i) {
+                if (events[i].filter == EVFILT_USER) {
+                    return;
+                }
+                std::string directory;
+                {
+                    std::lock_guard<std::mutex> lock(watch_mutex_);
+                    auto it = watch_paths_.find(static_cast<int>(events[i].ident));
+                    if (it == watch_paths_.end()) {
+                        continue;
+                    }
+                    directory = it->second;
+                }
+                markDirty(directory);
+                if (events[i].fflags & (NOTE_DELETE | NOTE_RENAME)) {
+                    markDirty(std::filesystem::path(directory).parent_path().string());
+                }
+            }
+        }
+    } //readEvents
+    
+#else
+    bool startBackend() {
+        LEAFRA_ERROR() << "File watching is not supported on this platform";
+        return false;
+    }
+    void stopBackend() {}
+    void addWatch(const std::string&) {}
+    void removeWatch(const std::string&) {}
+#endif
+};
+
+FileWatcher::FileWatcher() : pImpl(std::make_unique<Impl>()) {}
+
+FileWatcher::~FileWatcher() = default;
+
+ResultCode FileWatcher::start(const std::string& root, const Options& options, ChangeCallback callback) {
+    return pImpl->start(root, options, std::move(callback));
+}
+
+ResultCode FileWatcher::start(StorageType storage_type, const std::string& relative_path, const Options& options,
+                              ChangeCallback callback) {
+    std::string root = relative_path.empty() ? FileManager::getStorageBasePath(storage_type)
+                                             : FileManager::getAbsolutePath(storage_type, relative_path);
+    if (root.empty()) {
+        return ResultCode::ERROR_INVALID_PARAMETER;
+    }
+    return pImpl->start(root, options, std::move(callback));
+}
+
+void FileWatcher::stop() {
+    pImpl->stop();
+}
+
+bool FileWatcher::isRunning() const {
+    return pImpl->isRunning();
+}
+
+bool FileWatcher::isSupported() {
+#if defined(LEAFRA_WATCHER_INOTIFY) || defined(LEAFRA_WATCHER_FSEVENTS) || defined(LEAFRA_WATCHER_KQUEUE)
+    return true;
+#else
+    return false;
+#endif
+}
+
 } // namespace leafra 
\ No newline at end of file
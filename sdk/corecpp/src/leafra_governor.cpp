@@ -0,0 +1,201 @@
+#include "leafra/leafra_governor.h"
+#include "leafra/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace leafra {
+
+namespace {
+
+int64_t steady_now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* thermal_state_name(ThermalState thermal) {
+    switch (thermal) {
+        case ThermalState::NOMINAL:  return "nominal";
+        case ThermalState::FAIR:     return "fair";
+        case ThermalState::SERIOUS:  return "serious";
+        case ThermalState::CRITICAL: return "critical";
+    }
+    return "unknown";
+}
+
+template<typename T>
+T scaled(T value, double scale) {
+    return std::max<T>(1, static_cast<T>(std::lround(static_cast<double>(value) * scale)));
+}
+
+bool same_limits(const ThroughputLimits& a, const ThroughputLimits& b) {
+    return a.ingest_workers == b.ingest_workers && a.embedding_batch_size == b.embedding_batch_size &&
+           a.llm_threads == b.llm_threads && a.llm_batch_threads == b.llm_batch_threads &&
+           a.faiss_threads == b.faiss_threads;
+}
+
+} // namespace
+
+double ThroughputGovernor::throttle_scale(const PowerState& power, int32_t low_battery_percent) {
+    double scale = 1.0;
+    switch (power.thermal) {
+        case ThermalState::NOMINAL:  scale = 1.0; break;
+        case ThermalState::FAIR:     scale = 0.75; break;
+        case ThermalState::SERIOUS:  scale = 0.5; break;
+        case ThermalState::CRITICAL: scale = 0.25; break;
+    }
+    if (power.low_power_mode) {
+        scale *= 0.5;
+    }
+    if (power.battery_percent >= 0 && power.battery_percent <= low_battery_percent && !power.charging) {
+        scale *= 0.5;
+    }
+    return scale;
+}
+
+ThroughputLimits ThroughputGovernor::scale_limits(const ThroughputLimits& ceiling, double scale) {
+    ThroughputLimits limits;
+    limits.ingest_workers = scaled(ceiling.ingest_workers, scale);
+    limits.embedding_batch_size = scaled(ceiling.embedding_batch_size, scale);
+    limits.llm_threads = scaled(ceiling.llm_threads, scale);
+    limits.llm_batch_threads = scaled(ceiling.llm_batch_threads, scale);
+    limits.faiss_threads = scaled(ceiling.faiss_threads, scale);
+    return limits;
+}
+
+void ThroughputGovernor::configure(const Options& options, const ThroughputLimits& ceiling) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        options_ = options;
+        ceiling_ = ceiling;
+        limits_ = ceiling;
+        scale_ = 1.0;
+        host_reported_ = false;
+        last_poll_ms_ = -1;
+    }
+    permits_cv_.notify_all();
+    update(true);
+}
+
+void ThroughputGovernor::set_ceiling(const ThroughputLimits& ceiling) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ceiling_ = ceiling;
+        limits_ = options_.enabled ? scale_limits(ceiling, scale_) : ceiling;
+    }
+    permits_cv_.notify_all();
+}
+
+ThroughputLimits ThroughputGovernor::ceiling() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ceiling_;
+}
+
+bool ThroughputGovernor::update(bool force) {
+    int64_t now = steady_now_ms();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!options_.enabled || host_reported_) {
+            return false;
+        }
+        if (!force && last_poll_ms_ >= 0 && now - last_poll_ms_ < options_.poll_interval_ms) {
+            return false;
+        }
+        last_poll_ms_ = now;
+    }
+    PowerState power = PlatformUtils::get_power_state();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !host_reported_ && apply_locked(power);
+}
+
+bool ThroughputGovernor::report_power_state(const PowerState& state) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    host_reported_ = true;
+    if (!options_.enabled) {
+        power_ = state;
+        return false;
+    }
+    return apply_locked(state);
+}
+
+bool ThroughputGovernor::apply_locked(const PowerState& power) {
+    power_ = power;
+    double scale = throttle_scale(power, options_.low_battery_percent);
+    ThroughputLimits limits = scale_limits(ceiling_, scale);
+    if (scale != scale_) {
+        if (scale < 1.0) {
+            LEAFRA_INFO() << "🌡️ Throughput scaled to " << static_cast<int>(scale * 100.0) << "% (thermal " << thermal_state_name(power.thermal)
+                          << (power.low_power_mode ? ", low power mode" : "")
+                          << (power.battery_percent >= 0 ? ", battery " + std::to_string(power.battery_percent) + "%" : std::string())
+                          << (power.charging ? " charging" : "") << "): ingest " << limits.ingest_workers
+                          << ", embedding batch " << limits.embedding_batch_size << ", LLM " << limits.llm_threads << " threads";
+        } else {
+            LEAFRA_INFO() << "🌡️ Throughput restored to full speed";
+        }
+    }
+    scale_ = scale;
+    bool changed = !same_limits(limits, limits_);
+    limits_ = limits;
+    permits_cv_.notify_all();
+    return changed;
+} //apply_locked
+
+ThroughputLimits ThroughputGovernor::limits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return limits_;
+}
+
+GovernorState ThroughputGovernor::state() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    GovernorState state;
+    state.power = power_;
+    state.scale = options_.enabled ? scale_ : 1.0;
+    state.limits = limits_;
+    state.interactive_calls = interactive_calls_;
+    state.ingest_allowance = options_.enabled ? ingest_allowance_locked() : limits_.ingest_workers;
+    return state;
+}
+
+size_t ThroughputGovernor::ingest_allowance_locked() const {
+    if (!options_.enabled) {
+        return std::numeric_limits<size_t>::max();
+    }
+    if (interactive_calls_ > 0) {
+        return std::min(limits_.ingest_workers, options_.interactive_ingest_workers);
+    }
+    return limits_.ingest_workers;
+}
+
+// ==============================================================================
+// InteractiveScope / IngestPermit
+// ==============================================================================
+
+ThroughputGovernor::InteractiveScope::InteractiveScope(ThroughputGovernor& governor) : governor_(governor) {
+    std::lock_guard<std::mutex> lock(governor_.mutex_);
+    governor_.interactive_calls_++;
+}
+
+ThroughputGovernor::InteractiveScope::~InteractiveScope() {
+    {
+        std::lock_guard<std::mutex> lock(governor_.mutex_);
+        governor_.interactive_calls_--;
+    }
+    governor_.permits_cv_.notify_all();
+}
+
+ThroughputGovernor::IngestPermit::IngestPermit(ThroughputGovernor& governor) : governor_(governor) {
+    std::unique_lock<std::mutex> lock(governor_.mutex_);
+    governor_.permits_cv_.wait(lock, [this] { return governor_.active_ingest_ < governor_.ingest_allowance_locked(); });
+    governor_.active_ingest_++;
+}
+
+ThroughputGovernor::IngestPermit::~IngestPermit() {
+    {
+        std::lock_guard<std::mutex> lock(governor_.mutex_);
+        governor_.active_ingest_--;
+    }
+    governor_.permits_cv_.notify_all();
+}
+
+} // namespace leafra
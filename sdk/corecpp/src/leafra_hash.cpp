@@ -0,0 +1,62 @@
+#include "leafra/leafra_hash.h"
+#include <fstream>
+#include <vector>
+
+namespace leafra {
+
+static constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+void ContentHasher::update(const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t state = state_;
+    for (size_t i = 0; i < size; ++i) {
+        state ^= bytes[i];
+        state *= kFnvPrime;
+    }
+    state_ = state;
+}
+
+std::string ContentHasher::hex_digest() const {
+    std::string hex(kHexDigestSize, '0');
+    hex_digest(&hex[0]);
+    return hex;
+}
+
+void ContentHasher::hex_digest(char* out) const {
+    static const char kHexDigits[] = "0123456789abcdef";
+    uint64_t value = state_;
+    for (int i = static_cast<int>(kHexDigestSize) - 1; i >= 0; --i) {
+        out[i] = kHexDigits[value & 0xfu];
+        value >>= 4;
+    }
+}
+
+std::string ContentHasher::hash_text(std::string_view text) {
+    ContentHasher hasher;
+    hasher.update(text);
+    return hasher.hex_digest();
+}
+
+bool ContentHasher::hash_file(const std::string& path, std::string& hex_digest) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    ContentHasher hasher;
+    std::vector<char> buffer(64 * 1024);
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::streamsize count = file.gcount();
+        if (count > 0) {
+            hasher.update(buffer.data(), static_cast<size_t>(count));
+        }
+    }
+    if (file.bad()) {
+        return false;
+    }
+    hex_digest = hasher.hex_digest();
+    return true;
+}
+
+} // namespace leafra
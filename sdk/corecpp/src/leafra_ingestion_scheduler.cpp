@@ -0,0 +1,135 @@
+#include "leafra/leafra_ingestion_scheduler.h"
+
+#include <algorithm>
+
+namespace leafra {
+
+IngestionScheduler::Run::Run(IngestionScheduler& scheduler, const std::vector<std::string>& file_paths,
+                             IngestionPriority priority)
+    : scheduler_(scheduler), file_paths_(file_paths), priority_(priority),
+      taken_(file_paths.size(), 0), remaining_(file_paths.size()) {
+    std::lock_guard<std::mutex> lock(scheduler_.mutex_);
+    ticket_ = scheduler_.next_ticket_++;
+    scheduler_.runs_.push_back(this);
+}
+
+IngestionScheduler::Run::~Run() {
+    std::lock_guard<std::mutex> lock(scheduler_.mutex_);
+    if (scheduler_.holder_ == this) {
+        scheduler_.holder_ = nullptr;
+    }
+    scheduler_.runs_.erase(std::remove(scheduler_.runs_.begin(), scheduler_.runs_.end(), this), scheduler_.runs_.end());
+    scheduler_.turn_cv_.notify_all();
+}
+
+void IngestionScheduler::Run::acquire() {
+    std::unique_lock<std::mutex> lock(scheduler_.mutex_);
+    if (scheduler_.holder_ == this) {
+        return;
+    }
+    waiting_ = true;   // The holder sees this in next() and stops at the next document if outranked
+    scheduler_.turn_cv_.wait(lock, [this]() {
+        return scheduler_.holder_ == nullptr && scheduler_.next_holder_locked() == this;
+    });
+    waiting_ = false;
+    scheduler_.holder_ = this;
+}
+
+void IngestionScheduler::Run::release() {
+    std::lock_guard<std::mutex> lock(scheduler_.mutex_);
+    if (scheduler_.holder_ == this) {
+        scheduler_.holder_ = nullptr;
+        scheduler_.turn_cv_.notify_all();
+    }
+}
+
+bool IngestionScheduler::Run::next(size_t& index) {
+    std::lock_guard<std::mutex> lock(scheduler_.mutex_);
+    if (remaining_ == 0 || scheduler_.outranked_locked(*this)) {
+        return false;
+    }
+    while (!bumped_.empty()) {
+        const size_t bumped = bumped_.front();
+        bumped_.pop_front();
+        if (!taken_[bumped]) {
+            index = bumped;
+            taken_[index] = 1;
+            remaining_--;
+            return true;
+        }
+    }
+    while (cursor_ < taken_.size() && taken_[cursor_]) {
+        cursor_++;
+    }
+    index = cursor_;
+    taken_[index] = 1;
+    remaining_--;
+    return true;
+}
+
+bool IngestionScheduler::Run::preempted() const {
+    std::lock_guard<std::mutex> lock(scheduler_.mutex_);
+    return remaining_ > 0 && scheduler_.outranked_locked(*this);
+}
+
+size_t IngestionScheduler::Run::remaining() const {
+    std::lock_guard<std::mutex> lock(scheduler_.mutex_);
+    return remaining_;
+}
+
+bool IngestionScheduler::bump(const std::string& file_path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool found = false;
+    for (Run* run : runs_) {
+        for (size_t i = 0; i < run->file_paths_.size(); ++i) {
+            if (!run->taken_[i] && run->file_paths_[i] == file_path) {
+                run->bumped_.push_back(i);
+                found = true;
+            }
+        }
+    }
+    if (found) {
+        turn_cv_.notify_all();
+    }
+    return found;
+}
+
+size_t IngestionScheduler::run_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return runs_.size();
+}
+
+IngestionPriority IngestionScheduler::effective_priority(const Run& run) {
+    for (size_t index : run.bumped_) {
+        if (!run.taken_[index]) {
+            return IngestionPriority::INTERACTIVE;
+        }
+    }
+    return run.priority_;
+}
+
+const IngestionScheduler::Run* IngestionScheduler::next_holder_locked() const {
+    const Run* best = nullptr;
+    for (const Run* run : runs_) {
+        if (!run->waiting_) {
+            continue;
+        }
+        if (!best || effective_priority(*run) > effective_priority(*best) ||
+            (effective_priority(*run) == effective_priority(*best) && run->ticket_ < best->ticket_)) {
+            best = run;
+        }
+    }
+    return best;
+}
+
+bool IngestionScheduler::outranked_locked(const Run& run) const {
+    const IngestionPriority priority = effective_priority(run);
+    for (const Run* other : runs_) {
+        if (other != &run && other->waiting_ && effective_priority(*other) > priority) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace leafra
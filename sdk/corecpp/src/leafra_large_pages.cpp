@@ -0,0 +1,222 @@
+#include "leafra/leafra_large_pages.h"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <cstdio>
+#include <cstring>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#define LEAFRA_LARGE_PAGES_LINUX 1
+#endif
+
+namespace leafra {
+namespace large_pages {
+
+namespace {
+
+std::atomic<int32_t> g_policy{static_cast<int32_t>(LargePagePolicy::OFF)};
+std::atomic<uint64_t> g_explicit_bytes{0};
+std::atomic<uint64_t> g_explicit_fallbacks{0};
+std::atomic<uint64_t> g_advised_regions{0};
+
+#ifdef LEAFRA_LARGE_PAGES_LINUX
+// Size rounded up the way the kernel sizes MAP_HUGETLB mappings
+size_t round_up_huge(size_t bytes) {
+    return (bytes + kHugePageBytes - 1) & ~(kHugePageBytes - 1);
+}
+
+// Mapped buffers carry a header in front recording how they were mapped, so deallocate()
+// unmaps exactly what allocate() mapped
+struct MappingHeader {
+    size_t mapped_bytes;
+    bool huge_tlb;
+};
+constexpr size_t kHeaderBytes = 64;         // Keeps the payload 64-byte aligned for SIMD loads
+#endif
+
+} // namespace
+
+bool parse_policy(const std::string& name, LargePagePolicy& policy) {
+    if (name == "off" || name.empty()) {
+        policy = LargePagePolicy::OFF;
+    } else if (name == "transparent") {
+        policy = LargePagePolicy::TRANSPARENT;
+    } else if (name == "explicit") {
+        policy = LargePagePolicy::EXPLICIT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* policy_name(LargePagePolicy policy) {
+    switch (policy) {
+        case LargePagePolicy::TRANSPARENT: return "transparent";
+        case LargePagePolicy::EXPLICIT: return "explicit";
+        default: return "off";
+    }
+}
+
+void set_policy(LargePagePolicy policy) {
+    g_policy.store(static_cast<int32_t>(policy), std::memory_order_relaxed);
+}
+
+LargePagePolicy policy() {
+    return static_cast<LargePagePolicy>(g_policy.load(std::memory_order_relaxed));
+}
+
+bool supported() {
+#ifdef LEAFRA_LARGE_PAGES_LINUX
+    // e.g. "always [madvise] never"; the bracketed entry is the active mode
+    std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string modes;
+    if (!std::getline(file, modes)) {
+        return false;
+    }
+    return modes.find("[never]") == std::string::npos;
+#else
+    return false;
+#endif
+}
+
+size_t advise(const void* data, size_t bytes) {
+#ifdef LEAFRA_LARGE_PAGES_LINUX
+    if (policy() == LargePagePolicy::OFF || data == nullptr || bytes < kHugePageBytes) {
+        return 0;
+    }
+    // madvise takes whole pages; only huge pages entirely inside the buffer can be promoted
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + kHugePageBytes - 1) & ~(uintptr_t(kHugePageBytes) - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(data) + bytes) & ~(uintptr_t(kHugePageBytes) - 1);
+    if (end <= begin) {
+        return 0;
+    }
+    if (madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE) != 0) {
+        return 0;
+    }
+    g_advised_regions.fetch_add(1, std::memory_order_relaxed);
+    return end - begin;
+#else
+    (void)data;
+    (void)bytes;
+    return 0;
+#endif
+}
+
+size_t advise_file(const std::string& path) {
+#ifdef LEAFRA_LARGE_PAGES_LINUX
+    if (policy() == LargePagePolicy::OFF || path.empty()) {
+        return 0;
+    }
+    // /proc/self/maps lists resolved paths
+    char resolved[PATH_MAX];
+    if (realpath(path.c_str(), resolved) == nullptr) {
+        return 0;
+    }
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    size_t advised = 0;
+    while (std::getline(maps, line)) {
+        // "start-end perms offset dev inode   pathname"
+        size_t name = line.find('/');
+        if (name == std::string::npos || line.compare(name, std::string::npos, resolved) != 0) {
+            continue;
+        }
+        unsigned long long start = 0;
+        unsigned long long end = 0;
+        if (std::sscanf(line.c_str(), "%llx-%llx", &start, &end) != 2 || end <= start) {
+            continue;
+        }
+        advised += advise(reinterpret_cast<const void*>(static_cast<uintptr_t>(start)),
+                          static_cast<size_t>(end - start));
+    }
+    return advised;
+#else
+    (void)path;
+    return 0;
+#endif
+}
+
+void* allocate(size_t bytes) {
+#ifdef LEAFRA_LARGE_PAGES_LINUX
+    // Whether a buffer is mapped depends on its size alone, so deallocate() never has to
+    // know the policy it was allocated under
+    if (bytes >= kHugePageBytes) {
+        size_t mapped_bytes = round_up_huge(bytes + kHeaderBytes);
+        void* mapping = MAP_FAILED;
+        bool huge_tlb = false;
+        if (policy() == LargePagePolicy::EXPLICIT) {
+            // Fails when the reserved pool (vm.nr_hugepages) is too small; advise instead
+            mapping = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            huge_tlb = mapping != MAP_FAILED;
+            if (!huge_tlb) {
+                g_explicit_fallbacks.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (mapping == MAP_FAILED) {
+            mapping = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mapping == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            advise(mapping, mapped_bytes);
+        } else {
+            g_explicit_bytes.fetch_add(mapped_bytes, std::memory_order_relaxed);
+        }
+        MappingHeader* header = static_cast<MappingHeader*>(mapping);
+        header->mapped_bytes = mapped_bytes;
+        header->huge_tlb = huge_tlb;
+        return static_cast<char*>(mapping) + kHeaderBytes;
+    }
+#endif
+    return ::operator new(bytes);
+}
+
+void deallocate(void* data, size_t bytes) noexcept {
+    if (data == nullptr) {
+        return;
+    }
+#ifdef LEAFRA_LARGE_PAGES_LINUX
+    if (bytes >= kHugePageBytes) {
+        void* mapping = static_cast<char*>(data) - kHeaderBytes;
+        const MappingHeader* header = static_cast<const MappingHeader*>(mapping);
+        size_t mapped_bytes = header->mapped_bytes;
+        if (header->huge_tlb) {
+            g_explicit_bytes.fetch_sub(mapped_bytes, std::memory_order_relaxed);
+        }
+        munmap(mapping, mapped_bytes);
+        return;
+    }
+#endif
+    (void)bytes;
+    ::operator delete(data);
+}
+
+LargePageMetrics metrics() {
+    LargePageMetrics result;
+    result.policy = policy_name(policy());
+    result.supported = supported();
+    result.explicit_bytes = g_explicit_bytes.load(std::memory_order_relaxed);
+    result.explicit_fallbacks = g_explicit_fallbacks.load(std::memory_order_relaxed);
+    result.advised_regions = g_advised_regions.load(std::memory_order_relaxed);
+#ifdef LEAFRA_LARGE_PAGES_LINUX
+    std::ifstream rollup("/proc/self/smaps_rollup");
+    std::string line;
+    while (std::getline(rollup, line)) {
+        static const char* const kFields[] = {"AnonHugePages:", "FilePmdMapped:", "ShmemPmdMapped:", "Private_Hugetlb:", "Shared_Hugetlb:"};
+        for (const char* field : kFields) {
+            size_t length = std::strlen(field);
+            if (line.compare(0, length, field) == 0) {
+                result.huge_resident_bytes += std::strtoull(line.c_str() + length, nullptr, 10) * 1024;
+            }
+        }
+    }
+#endif
+    return result;
+}
+
+} // namespace large_pages
+} // namespace leafra
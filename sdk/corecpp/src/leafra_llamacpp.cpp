@@ -4,10 +4,14 @@
 #ifdef LEAFRA_HAS_LLAMACPP
 
 #include "leafra/logger.h"
+#include "leafra/leafra_trace.h"
+#include "leafra/leafra_token_stream.h"
+#include "leafra/leafra_model_registry.h"
 
 // Include LlamaCpp headers
 #include <llama.h>
 #include <ggml.h>
+#include <gguf.h>
 
 #include <iostream>
 #include <thread>
@@ -15,8 +19,21 @@
 #include <chrono>
 #include <fstream>
 #include <random>
+#include <condition_variable>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(__APPLE__)
+#include <TargetConditionals.h>
+#if TARGET_OS_IPHONE
+#include <os/proc.h>
+#endif
+#endif
 
 namespace leafra {
 namespace llamacpp {
@@ -25,6 +42,30 @@ namespace llamacpp {
 static bool g_initialized = false;
 static std::mt19937 g_rng;
 
+// Held for every use of a model's llama_context (public calls, and each scheduler step)
+using ContextLock = std::lock_guard<std::mutex>;
+
+// llama_decode, recorded as an "llm" trace span
+static int32_t traced_decode(llama_context* context, llama_batch batch) {
+    trace::Span span("llm", "decode");
+    span.arg("tokens", batch.n_tokens);
+    return llama_decode(context, batch);
+}
+
+// ggml type for an LLMConfig KV cache type name (LLMConfig::is_kv_cache_type)
+static ggml_type kv_cache_type(const std::string& name) {
+    if (name == "q8_0") return GGML_TYPE_Q8_0;
+    if (name == "q4_0") return GGML_TYPE_Q4_0;
+    return GGML_TYPE_F16;
+}
+
+// Bytes per cached element for an LLMConfig KV cache type name (q8_0/q4_0 store 32 values in 34/18 bytes)
+static double kv_cache_element_bytes(const std::string& name) {
+    if (name == "q8_0") return 34.0 / 32.0;
+    if (name == "q4_0") return 18.0 / 32.0;
+    return 2.0;
+}
+
 
 
 // LlamaCppModel::Impl definition
@@ -35,6 +76,15 @@ public:
         cleanup();
     }
     
+    std::mutex context_mutex_;  // Serializes access to context_ between callers and the scheduler thread
+    
+    // A system prompt rendered alone through the chat template, and its tokens
+    struct PromptPrefix {
+        std::string text;
+        std::vector<int32_t> tokens;
+    };
+    static constexpr size_t kMaxCachedPromptPrefixes = 8;
+    
     bool load_model(const LLMConfig& config) {
         config_ = config;
         
@@ -52,17 +102,34 @@ public:
             return false;
         }
         
+        // llama.cpp only quantizes the V cache inside the flash attention kernel
+        if (!LLMConfig::is_kv_cache_type(config.type_k) || !LLMConfig::is_kv_cache_type(config.type_v)) {
+            last_error_ = "Unsupported KV cache type (type_k: " + config.type_k + ", type_v: " + config.type_v + ")";
+            LEAFRA_ERROR() << last_error_;
+            return false;
+        }
+        if (config.type_v != "f16" && !config.flash_attn) {
+            last_error_ = "A quantized V cache (type_v: " + config.type_v + ") requires flash_attn";
+            LEAFRA_ERROR() << last_error_;
+            return false;
+        }
+        
         // Clean up any existing model
         cleanup();
         
         // Initialize model parameters
         llama_model_params model_params = llama_model_default_params();
-        model_params.n_gpu_layers = config.n_gpu_layers;
+        if (config_.n_gpu_layers < 0) {
+            config_.n_gpu_layers = utils::recommend_gpu_layers(config.model_path, config);
+        }
+        model_params.n_gpu_layers = config_.n_gpu_layers;
         model_params.use_mmap = config.use_mmap;
         model_params.use_mlock = config.use_mlock;
         
-        // Load model
-        model_ = llama_model_load_from_file(config.model_path.c_str(), model_params);
+        // Load model (or share the weights another instance already loaded with the same options)
+        bool shared = false;
+        model_weights_ = acquire_weights(config.model_path, model_params, &shared);
+        model_ = model_weights_.get();
         if (!model_) {
             last_error_ = "Failed to load model from: " + config.model_path;
             LEAFRA_ERROR() << last_error_;
@@ -74,16 +141,20 @@ public:
         ctx_params.n_ctx = config.n_ctx;
         ctx_params.n_batch = config.n_batch;
         ctx_params.n_ubatch = config.n_ubatch;
+        ctx_params.n_seq_max = static_cast<uint32_t>(std::max(1, config.n_seq_max));
         ctx_params.n_threads = config.n_threads > 0 ? config.n_threads : static_cast<int32_t>(std::thread::hardware_concurrency());
         ctx_params.n_threads_batch = config.n_threads_batch > 0 ? config.n_threads_batch : ctx_params.n_threads;
-        ctx_params.embeddings = false; // TODO AD: disabling for now - what's the perf impact? Enable embeddings support
+        ctx_params.embeddings = config.embeddings; // Only enabled for dedicated embedding contexts
+        ctx_params.type_k = kv_cache_type(config.type_k);
+        ctx_params.type_v = kv_cache_type(config.type_v);
+        ctx_params.flash_attn = config.flash_attn;
         
         // Create context
         context_ = llama_init_from_model(model_, ctx_params);
         if (!context_) {
             last_error_ = "Failed to create context";
             LEAFRA_ERROR() << last_error_;
-            llama_model_free(model_);
+            model_weights_.reset();
             model_ = nullptr;
             return false;
         }
@@ -143,17 +214,30 @@ public:
         // Set up RNG
         this->seed_rng(config.seed);
         
+        if (!config.draft_model_path.empty() && config.n_draft > 0) {
+            load_draft_model(config, model_params, ctx_params);
+        }
+        
         LEAFRA_INFO() << "✅ LlamaCpp model loaded successfully";
-        LEAFRA_INFO() << "  - Model: " << config.model_path;
+        LEAFRA_INFO() << "  - Model: " << config.model_path << (shared ? " (weights shared with another instance)" : "");
         LEAFRA_INFO() << "  - Vocabulary size: " << vocab_size_;
         LEAFRA_INFO() << "  - Context size: " << context_size_;
         LEAFRA_INFO() << "  - Threads: " << ctx_params.n_threads;
-        LEAFRA_INFO() << "  - GPU layers: " << config.n_gpu_layers;
+        LEAFRA_INFO() << "  - GPU layers: " << config_.n_gpu_layers << (config.n_gpu_layers < 0 ? " (auto)" : "");
+        LEAFRA_INFO() << "  - KV cache: K " << config.type_k << ", V " << config.type_v << (config.flash_attn ? ", flash attention" : "");
         
         return true;
     }
     
     void cleanup() {
+        stop_scheduler();
+        if (draft_context_) {
+            llama_free(draft_context_);
+            draft_context_ = nullptr;
+        }
+        draft_weights_.reset();
+        draft_model_ = nullptr;
+        draft_cached_.clear();
         if (sampler_) {
             llama_sampler_free(sampler_);
             sampler_ = nullptr;
@@ -162,12 +246,12 @@ public:
             llama_free(context_);
             context_ = nullptr;
         }
-        if (model_) {
-            llama_model_free(model_);
-            model_ = nullptr;
-        }
+        model_weights_.reset();
+        model_ = nullptr;
         vocab_ = nullptr;
         context_used_ = 0;
+        cached_tokens_.clear();
+        prompt_prefix_cache_.clear();
         last_error_.clear();
         last_stats_ = GenerationStats{};
     }
@@ -202,6 +286,26 @@ public:
             return false;
         }
         
+        // Tokenize prompt (an empty prompt continues from what is already in context)
+        auto tokens = prompt.empty() ? cached_tokens_ : tokenize(prompt, true);
+        if (tokens.empty()) {
+            last_error_ = "Failed to tokenize prompt";
+            return false;
+        }
+        
+        return generate_from_tokens(std::move(tokens), callback, max_tokens);
+    }
+    
+    bool generate_from_tokens(std::vector<int32_t> tokens, TokenCallback callback, int32_t max_tokens) {
+        if (!is_loaded()) {
+            last_error_ = "Model not loaded";
+            return false;
+        }
+        if (tokens.empty()) {
+            last_error_ = "Empty prompt";
+            return false;
+        }
+        
         // Use config default if max_tokens is 0
         if (max_tokens <= 0) {
             max_tokens = config_.n_predict;
@@ -209,94 +313,108 @@ public:
         
         auto start_time = std::chrono::high_resolution_clock::now();
         
-        // Tokenize prompt
-        auto tokens = tokenize(prompt, true);
-        if (tokens.empty()) {
-            last_error_ = "Failed to tokenize prompt";
-            return false;
-        }
-        
         // Make sure we don't exceed context size
         if (static_cast<int32_t>(tokens.size()) + max_tokens > context_size_) {
-            max_tokens = context_size_ - static_cast<int32_t>(tokens.size());
-            if (max_tokens <= 0) {
-                last_error_ = "Prompt too long for context size";
-                return false;
+            if (can_shift_context()) {
+                // Generation shifts the context as it fills; an overlong prompt loses its oldest middle part
+                const int32_t reserve = std::min(max_tokens, context_size_ / 4);
+                if (static_cast<int32_t>(tokens.size()) > context_size_ - reserve) {
+                    const size_t keep = keep_token_count(tokens.size());
+                    const size_t discard = tokens.size() - static_cast<size_t>(context_size_ - reserve);
+                    tokens.erase(tokens.begin() + static_cast<std::ptrdiff_t>(keep),
+                                 tokens.begin() + static_cast<std::ptrdiff_t>(keep + discard));
+                    LEAFRA_DEBUG() << "Prompt exceeds the context, dropped " << discard << " tokens after the first " << keep;
+                }
+            } else {
+                max_tokens = context_size_ - static_cast<int32_t>(tokens.size());
+                if (max_tokens <= 0) {
+                    last_error_ = "Prompt too long for context size";
+                    return false;
+                }
             }
         }
         
-        // Clear context and evaluate prompt
-        llama_memory_clear(llama_get_memory(context_), true);
-        context_used_ = 0;
-        
         // Create batch for processing
         llama_batch batch = llama_batch_init(config_.n_batch, 0, 1);
         
         auto prompt_start = std::chrono::high_resolution_clock::now();
         
-        // Process prompt tokens in batches
-        for (size_t i = 0; i < tokens.size(); i += config_.n_batch) {
-            this->batch_clear(batch);
-            
-            size_t batch_size = std::min(static_cast<size_t>(config_.n_batch), tokens.size() - i);
-            for (size_t j = 0; j < batch_size; ++j) {
-                this->batch_add(batch, tokens[i + j], static_cast<llama_pos>(i + j), {0}, j == batch_size - 1);
-            }
-            
-            if (llama_decode(context_, batch) != 0) {
-                last_error_ = "Failed to evaluate prompt batch";
-                llama_batch_free(batch);
-                return false;
-            }
-            
-            context_used_ += static_cast<int32_t>(batch_size);
+        // Evaluate the prompt, reusing whatever prefix of it the KV cache already holds
+        int32_t reused_tokens = 0;
+        if (!evaluate_prompt(tokens, batch, reused_tokens)) {
+            llama_batch_free(batch);
+            return false;
         }
         
         auto prompt_end = std::chrono::high_resolution_clock::now();
         double prompt_eval_time = std::chrono::duration<double, std::milli>(prompt_end - prompt_start).count();
         
+        // Consumers get whole UTF-8 characters, coalesced off the decode thread when stream_flush_ms is set;
+        // closing on the first final call makes that call happen exactly once
+        TokenStream stream(callback, config_.stream_flush_ms, config_.stream_flush_tokens);
+        if (callback) {
+            callback = [&stream](const std::string& token, bool is_final) {
+                if (is_final) {
+                    stream.close();
+                    return true;
+                }
+                return stream.push(token);
+            };
+        }
+        
         // Generate tokens
         std::vector<int32_t> generated_tokens;
         generated_tokens.reserve(max_tokens);
         
         auto generation_start = std::chrono::high_resolution_clock::now();
         
-        for (int32_t i = 0; i < max_tokens; ++i) {
-            // Sample next token using modern sampling API
-            llama_token next_token = llama_sampler_sample(sampler_, context_, -1);
+        last_stats_.draft_tokens = 0;
+        last_stats_.accepted_draft_tokens = 0;
+        if (draft_context_ || (config_.lookup_ngram > 0 && config_.n_draft > 0)) {
+            generate_speculative(callback, max_tokens, batch, generated_tokens);
+        } else {
+            for (int32_t i = 0; i < max_tokens; ++i) {
+                // Sample next token using modern sampling API
+                llama_token next_token = llama_sampler_sample(sampler_, context_, -1);
             
-            // Accept the token (updates internal state of samplers)
-            llama_sampler_accept(sampler_, next_token);
+                // Accept the token (updates internal state of samplers)
+                llama_sampler_accept(sampler_, next_token);
             
-            // Check for EOS token
-            if (llama_vocab_is_eog(vocab_, next_token)) {
-                if (callback) {
-                    callback("", true); // Signal end of generation
+                // Check for EOS token
+                if (llama_vocab_is_eog(vocab_, next_token)) {
+                    if (callback) {
+                        callback("", true); // Signal end of generation
+                    }
+                    break;
                 }
-                break;
-            }
             
-            generated_tokens.push_back(next_token);
+                generated_tokens.push_back(next_token);
             
-            // Get token text and call callback
-            std::string token_text = get_token_text(next_token);
-            if (callback && !callback(token_text, false)) {
-                if (callback) {
-                    callback("", true); // Signal end of generation (user stopped)
+                // Get token text and call callback
+                std::string token_text = get_token_text(next_token);
+                if (callback && !callback(token_text, false)) {
+                    if (callback) {
+                        callback("", true); // Signal end of generation (user stopped)
+                    }
+                    break; // User requested stop
                 }
-                break; // User requested stop
-            }
             
-            // Add token to context for next iteration
-            this->batch_clear(batch);
-            this->batch_add(batch, next_token, context_used_, {0}, true);
+                // Add token to context for next iteration
+                if (context_used_ >= context_size_ && !shift_context(1)) {
+                    break;
+                }
+                this->batch_clear(batch);
+                this->batch_add(batch, next_token, context_used_, {0}, true);
             
-            if (llama_decode(context_, batch) != 0) {
-                last_error_ = "Failed to evaluate generated token";
-                break;
-            }
+                if (traced_decode(context_, batch) != 0) {
+                    last_error_ = "Failed to evaluate generated token";
+                    break;
+                }
             
-            context_used_++;
+                cached_tokens_.push_back(next_token);
+                context_used_++;
+            }
+        
         }
         
         // Call final callback if we completed the loop without EOS or user stop
@@ -311,6 +429,7 @@ public:
         
         // Update statistics
         last_stats_.prompt_tokens = static_cast<int32_t>(tokens.size());
+        last_stats_.reused_prompt_tokens = reused_tokens;
         last_stats_.generated_tokens = static_cast<int32_t>(generated_tokens.size());
         last_stats_.prompt_eval_time = prompt_eval_time;
         last_stats_.generation_time = generation_time;
@@ -318,11 +437,14 @@ public:
         
         if (config_.debug_mode) {
             LEAFRA_DEBUG() << "Generation stats:";
-            LEAFRA_DEBUG() << "  - Prompt tokens: " << last_stats_.prompt_tokens;
+            LEAFRA_DEBUG() << "  - Prompt tokens: " << last_stats_.prompt_tokens << " (" << last_stats_.reused_prompt_tokens << " reused)";
             LEAFRA_DEBUG() << "  - Generated tokens: " << last_stats_.generated_tokens;
             LEAFRA_DEBUG() << "  - Prompt eval time: " << last_stats_.prompt_eval_time << "ms";
             LEAFRA_DEBUG() << "  - Generation time: " << last_stats_.generation_time << "ms";
             LEAFRA_DEBUG() << "  - Speed: " << last_stats_.tokens_per_second << " tokens/sec";
+            if (last_stats_.draft_tokens > 0) {
+                LEAFRA_DEBUG() << "  - Draft tokens accepted: " << last_stats_.accepted_draft_tokens << "/" << last_stats_.draft_tokens;
+            }
         }
         
         return true;
@@ -339,7 +461,8 @@ public:
             auto tokens = tokenize(additional_prompt, false);
             
             // Check context space
-            if (context_used_ + static_cast<int32_t>(tokens.size()) >= context_size_) {
+            if (context_used_ + static_cast<int32_t>(tokens.size()) >= context_size_ &&
+                !(can_shift_context() && shift_context(static_cast<int32_t>(tokens.size()) + 1))) {
                 last_error_ = "Not enough context space for additional prompt";
                 return "";
             }
@@ -355,12 +478,13 @@ public:
                     this->batch_add(batch, tokens[i + j], context_used_ + static_cast<llama_pos>(i + j), {0}, j == batch_size - 1);
                 }
                 
-                if (llama_decode(context_, batch) != 0) {
+                if (traced_decode(context_, batch) != 0) {
                     last_error_ = "Failed to evaluate additional prompt";
                     llama_batch_free(batch);
                     return "";
                 }
                 
+                cached_tokens_.insert(cached_tokens_.end(), tokens.begin() + i, tokens.begin() + i + batch_size);
                 context_used_ += static_cast<int32_t>(batch_size);
             }
             
@@ -380,9 +504,351 @@ public:
     
     void reset_context() {
         if (context_) {
-            llama_memory_clear(llama_get_memory(context_), true);
+            // Only the conversation sequence - scheduled generations keep theirs
+            llama_memory_seq_rm(llama_get_memory(context_), 0, -1, -1);
             context_used_ = 0;
         }
+        cached_tokens_.clear();
+    }
+    
+    bool warm_up() {
+        if (!is_loaded()) {
+            last_error_ = "Model not loaded";
+            return false;
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        bool warmed = warm_up_context(context_, vocab_);
+        if (warmed && draft_context_) {
+            warmed = warm_up_context(draft_context_, llama_model_get_vocab(draft_model_));
+        }
+        reset_context();
+        draft_cached_.clear();
+        if (!warmed) {
+            last_error_ = "Warm-up decode failed";
+            return false;
+        }
+        
+        LEAFRA_DEBUG() << "LLM warm-up took " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << "ms";
+        return true;
+    }
+    
+    // Decode a single BOS in sequence 0 and drop it again
+    static bool warm_up_context(llama_context* context, const llama_vocab* vocab) {
+        llama_token token = llama_vocab_bos(vocab);
+        if (token == LLAMA_TOKEN_NULL) {
+            token = 0;
+        }
+        bool decoded = traced_decode(context, llama_batch_get_one(&token, 1)) == 0;
+        llama_memory_seq_rm(llama_get_memory(context), 0, -1, -1);
+        return decoded;
+    }
+    
+    /**
+     * @brief Decode loop with speculation
+     * 
+     * The draft model (or, without one, prompt lookup) proposes up to n_draft tokens, the target
+     * evaluates them in one batch and samples every position with its own sampler, keeping draft
+     * tokens only while they equal its samples. Every emitted token is a target sample, so the
+     * output is distributed exactly as without a draft; rejected draft tokens are dropped from
+     * the KV cache.
+     */
+    void generate_speculative(const TokenCallback& callback, int32_t max_tokens, llama_batch& batch,
+                              std::vector<int32_t>& generated_tokens) {
+        llama_memory_t memory = llama_get_memory(context_);
+        std::vector<llama_token> draft;
+        llama_token token = llama_sampler_sample(sampler_, context_, -1);
+        llama_sampler_accept(sampler_, token);
+        
+        for (;;) {
+            if (llama_vocab_is_eog(vocab_, token)) {
+                break;
+            }
+            generated_tokens.push_back(token);
+            if ((callback && !callback(get_token_text(token), false)) ||
+                static_cast<int32_t>(generated_tokens.size()) >= max_tokens) {
+                break;
+            }
+            
+            // Draft a continuation of what the target has seen plus the pending token
+            if (context_used_ + 1 + config_.n_draft > context_size_ && can_shift_context() && !shift_context(1 + config_.n_draft)) {
+                break;
+            }
+            const int32_t n_past = context_used_;
+            const int32_t room = std::min({max_tokens - static_cast<int32_t>(generated_tokens.size()),
+                                           context_size_ - n_past - 1, config_.n_batch - 1, config_.n_draft});
+            draft.clear();
+            if (room > 0 && draft_context_) {
+                draft_tokens(token, room, batch, draft);
+            } else if (room > 0) {
+                lookup_draft_tokens(token, room, draft);
+            }
+            
+            this->batch_clear(batch);
+            this->batch_add(batch, token, n_past, {0}, true);
+            for (size_t j = 0; j < draft.size(); ++j) {
+                this->batch_add(batch, draft[j], n_past + 1 + static_cast<llama_pos>(j), {0}, true);
+            }
+            if (traced_decode(context_, batch) != 0) {
+                last_error_ = "Failed to evaluate generated token";
+                break;
+            }
+            cached_tokens_.push_back(token);
+            cached_tokens_.insert(cached_tokens_.end(), draft.begin(), draft.end());
+            context_used_ = n_past + 1 + static_cast<int32_t>(draft.size());
+            last_stats_.draft_tokens += static_cast<int32_t>(draft.size());
+            
+            // Sample the target at each position for as long as it agrees with the draft
+            size_t accepted = 0;
+            bool stop = false;
+            token = llama_sampler_sample(sampler_, context_, 0);
+            llama_sampler_accept(sampler_, token);
+            while (accepted < draft.size() && token == draft[accepted]) {
+                if (llama_vocab_is_eog(vocab_, token)) {
+                    stop = true;
+                    break;
+                }
+                accepted++;
+                generated_tokens.push_back(token);
+                if ((callback && !callback(get_token_text(token), false)) ||
+                    static_cast<int32_t>(generated_tokens.size()) >= max_tokens) {
+                    stop = true;
+                    break;
+                }
+                token = llama_sampler_sample(sampler_, context_, static_cast<int32_t>(accepted));
+                llama_sampler_accept(sampler_, token);
+            }
+            last_stats_.accepted_draft_tokens += static_cast<int32_t>(accepted);
+            
+            const int32_t kept = n_past + 1 + static_cast<int32_t>(accepted);
+            if (kept < context_used_) {
+                llama_memory_seq_rm(memory, 0, kept, -1);
+                cached_tokens_.resize(static_cast<size_t>(kept));
+                context_used_ = kept;
+            }
+            if (stop) {
+                break;
+            }
+        }
+    }
+    
+    /**
+     * @brief Greedily draft up to count tokens continuing cached_tokens_ followed by last
+     * 
+     * The draft context follows the target with the same prefix reuse as evaluate_prompt, so
+     * usually only the tokens accepted since the previous step are evaluated.
+     */
+    void draft_tokens(llama_token last, int32_t count, llama_batch& batch, std::vector<llama_token>& draft) {
+        llama_memory_t memory = llama_get_memory(draft_context_);
+        const size_t total = cached_tokens_.size() + 1;
+        auto token_at = [&](size_t i) { return i < cached_tokens_.size() ? cached_tokens_[i] : last; };
+        
+        size_t keep = 0;
+        const size_t limit = std::min(draft_cached_.size(), total - 1);
+        while (keep < limit && draft_cached_[keep] == token_at(keep)) {
+            keep++;
+        }
+        if (keep == 0 || !llama_memory_seq_rm(memory, 0, static_cast<llama_pos>(keep), -1)) {
+            llama_memory_seq_rm(memory, 0, -1, -1);
+            keep = 0;
+        }
+        draft_cached_.resize(keep);
+        
+        for (size_t i = keep; i < total; i += config_.n_batch) {
+            this->batch_clear(batch);
+            size_t batch_size = std::min(static_cast<size_t>(config_.n_batch), total - i);
+            for (size_t j = 0; j < batch_size; ++j) {
+                this->batch_add(batch, token_at(i + j), static_cast<llama_pos>(i + j), {0}, i + j == total - 1);
+                draft_cached_.push_back(token_at(i + j));
+            }
+            if (traced_decode(draft_context_, batch) != 0) {
+                draft_cached_.clear();
+                llama_memory_seq_rm(memory, 0, -1, -1);
+                return;
+            }
+        }
+        
+        for (int32_t j = 0; j < count; ++j) {
+            const float* logits = llama_get_logits_ith(draft_context_, -1);
+            if (!logits) {
+                return;
+            }
+            llama_token proposed = static_cast<llama_token>(std::max_element(logits, logits + vocab_size_) - logits);
+            if (llama_vocab_is_eog(vocab_, proposed)) {
+                return;
+            }
+            draft.push_back(proposed);
+            if (j + 1 == count) {
+                break;
+            }
+            this->batch_clear(batch);
+            this->batch_add(batch, proposed, static_cast<llama_pos>(draft_cached_.size()), {0}, true);
+            if (traced_decode(draft_context_, batch) != 0) {
+                return;
+            }
+            draft_cached_.push_back(proposed);
+        }
+    }
+    
+    /**
+     * @brief Draft up to count tokens by prompt lookup: what followed the latest earlier match of the context's last n-gram
+     * 
+     * The n-gram ends with last and is tried from lookup_ngram tokens down to one. RAG answers
+     * copy spans of the retrieved passages, so the continuation of a match in the prompt is
+     * often what the target samples next, and drafting costs no model.
+     */
+    void lookup_draft_tokens(llama_token last, int32_t count, std::vector<llama_token>& draft) {
+        const size_t total = cached_tokens_.size() + 1;
+        auto token_at = [&](size_t i) { return i < cached_tokens_.size() ? cached_tokens_[i] : last; };
+        
+        for (size_t n = std::min(static_cast<size_t>(config_.lookup_ngram), total - 1); n > 0; --n) {
+            // Latest start whose n-gram isn't the suffix itself and has at least one token after it
+            for (size_t start = total - n; start-- > 0;) {
+                size_t matched = 0;
+                while (matched < n && token_at(start + matched) == token_at(total - n + matched)) {
+                    matched++;
+                }
+                if (matched < n) {
+                    continue;
+                }
+                for (size_t i = start + n; i < total && static_cast<int32_t>(draft.size()) < count; ++i) {
+                    draft.push_back(token_at(i));
+                }
+                return;
+            }
+        }
+    }
+    
+    // Weights are read-only once loaded, so every instance loading a file with the same options
+    // shares one copy through the process-wide registry; contexts and KV caches stay per instance
+    static std::shared_ptr<llama_model> acquire_weights(const std::string& path, const llama_model_params& model_params, bool* shared) {
+        const std::string key = path + "|gpu=" + std::to_string(model_params.n_gpu_layers) +
+                                "|mmap=" + std::to_string(model_params.use_mmap) +
+                                "|mlock=" + std::to_string(model_params.use_mlock);
+        return ModelRegistry<llama_model>::instance().acquire(key, [&]() {
+            llama_model* model = llama_model_load_from_file(path.c_str(), model_params);
+            return model ? std::shared_ptr<llama_model>(model, llama_model_free) : nullptr;
+        }, shared);
+    }
+    
+    // Load the speculative draft model next to the target; generation works without it if this fails
+    void load_draft_model(const LLMConfig& config, const llama_model_params& model_params, llama_context_params ctx_params) {
+        if (!utils::is_valid_model_file(config.draft_model_path)) {
+            LEAFRA_WARNING() << "Invalid or missing draft model file, speculative decoding disabled: " << config.draft_model_path;
+            return;
+        }
+        draft_weights_ = acquire_weights(config.draft_model_path, model_params, nullptr);
+        draft_model_ = draft_weights_.get();
+        if (!draft_model_) {
+            LEAFRA_WARNING() << "Failed to load draft model, speculative decoding disabled: " << config.draft_model_path;
+            return;
+        }
+        if (llama_vocab_n_tokens(llama_model_get_vocab(draft_model_)) != vocab_size_) {
+            LEAFRA_WARNING() << "Draft model vocabulary differs from the target model, speculative decoding disabled";
+            draft_weights_.reset();
+            draft_model_ = nullptr;
+            return;
+        }
+        ctx_params.n_seq_max = 1;
+        ctx_params.embeddings = false;
+        draft_context_ = llama_init_from_model(draft_model_, ctx_params);
+        if (!draft_context_) {
+            LEAFRA_WARNING() << "Failed to create draft context, speculative decoding disabled";
+            draft_weights_.reset();
+            draft_model_ = nullptr;
+            return;
+        }
+        LEAFRA_INFO() << "  - Draft model: " << config.draft_model_path << " (" << config.n_draft << " tokens per step)";
+    }
+    
+    bool can_shift_context() const {
+        return config_.context_shift && context_ && llama_memory_can_shift(llama_get_memory(context_));
+    }
+    
+    // Tokens at the start of a sequence of the given length that context shifting never discards
+    size_t keep_token_count(size_t length) const {
+        size_t keep = config_.n_keep > 0 ? static_cast<size_t>(config_.n_keep) : system_prompt_tokens_;
+        return std::min(keep, length / 2);
+    }
+    
+    /**
+     * @brief Make room for needed more tokens by discarding the oldest tokens after the kept prefix
+     * 
+     * Half of the shiftable part (at least needed tokens) is removed and the rest is moved down
+     * with llama_memory_seq_add, so the cache stays valid and nothing is re-evaluated.
+     * 
+     * @return false if shifting is disabled or unsupported, or can't free enough room
+     */
+    bool shift_context(int32_t needed) {
+        if (!can_shift_context()) {
+            last_error_ = "Context is full";
+            return false;
+        }
+        const int32_t keep = static_cast<int32_t>(keep_token_count(static_cast<size_t>(context_used_)));
+        const int32_t shiftable = context_used_ - keep;
+        const int32_t discard = std::max((shiftable + 1) / 2, needed - (context_size_ - context_used_));
+        if (discard <= 0 || discard > shiftable) {
+            last_error_ = "Context is full";
+            return false;
+        }
+        
+        llama_memory_t memory = llama_get_memory(context_);
+        llama_memory_seq_rm(memory, 0, keep, keep + discard);
+        llama_memory_seq_add(memory, 0, keep + discard, context_used_, -discard);
+        cached_tokens_.erase(cached_tokens_.begin() + keep, cached_tokens_.begin() + keep + discard);
+        context_used_ -= discard;
+        LEAFRA_DEBUG() << "Context shifted: discarded " << discard << " tokens after the first " << keep;
+        return true;
+    }
+    
+    /**
+     * @brief Bring the KV cache of sequence 0 to exactly tokens, leaving logits for the last one
+     * 
+     * Only the part after the longest common prefix with the tokens already cached is
+     * evaluated; the divergent tail of the cache is dropped first. At least the last token
+     * is always evaluated, since sampling needs its logits.
+     * 
+     * @param tokens Full prompt
+     * @param batch Scratch batch of config_.n_batch tokens
+     * @param reused Output number of prompt tokens served from the cache
+     * @return false if evaluation failed (the cache is then empty)
+     */
+    bool evaluate_prompt(const std::vector<int32_t>& tokens, llama_batch& batch, int32_t& reused) {
+        llama_memory_t memory = llama_get_memory(context_);
+        size_t keep = 0;
+        if (config_.reuse_prompt_cache) {
+            const size_t limit = std::min(cached_tokens_.size(), tokens.size() - 1);
+            while (keep < limit && cached_tokens_[keep] == tokens[keep]) {
+                keep++;
+            }
+        }
+        // Recurrent models can't drop a partial sequence - start over for them
+        if (keep == 0 || !llama_memory_seq_rm(memory, 0, static_cast<llama_pos>(keep), -1)) {
+            llama_memory_seq_rm(memory, 0, -1, -1);
+            keep = 0;
+        }
+        cached_tokens_.resize(keep);
+        context_used_ = static_cast<int32_t>(keep);
+        reused = static_cast<int32_t>(keep);
+        
+        for (size_t i = keep; i < tokens.size(); i += config_.n_batch) {
+            this->batch_clear(batch);
+            
+            size_t batch_size = std::min(static_cast<size_t>(config_.n_batch), tokens.size() - i);
+            for (size_t j = 0; j < batch_size; ++j) {
+                this->batch_add(batch, tokens[i + j], static_cast<llama_pos>(i + j), {0}, i + j == tokens.size() - 1);
+            }
+            
+            if (traced_decode(context_, batch) != 0) {
+                last_error_ = "Failed to evaluate prompt batch";
+                reset_context();
+                return false;
+            }
+            
+            cached_tokens_.insert(cached_tokens_.end(), tokens.begin() + i, tokens.begin() + i + batch_size);
+            context_used_ += static_cast<int32_t>(batch_size);
+        }
+        return true;
     }
     
     std::vector<int32_t> tokenize(const std::string& text, bool add_special) {
@@ -462,15 +928,26 @@ public:
     }
     
     double calculate_perplexity(const std::string& text) {
+        std::vector<double> perplexities = score_texts({text});
+        if (perplexities.empty() || perplexities[0] < 0.0) {
+            if (last_error_.empty()) {
+                last_error_ = "No valid tokens for perplexity calculation";
+            }
+            return -1.0;
+        }
+        return perplexities[0];
+    }
+    
+    std::vector<double> score_texts(const std::vector<std::string>& texts) {
         if (!is_loaded()) {
             last_error_ = "Model not loaded";
-            return -1.0;
+            return {};
         }
+        last_error_.clear();
         
-        auto tokens = tokenize(text, true);
-        if (tokens.empty()) {
-            last_error_ = "Failed to tokenize text for perplexity calculation";
-            return -1.0;
+        std::vector<std::vector<int32_t>> tokenized(texts.size());
+        for (size_t t = 0; t < texts.size(); ++t) {
+            tokenized[t] = tokenize(texts[t], true);
         }
         
         // Save current context state
@@ -478,43 +955,80 @@ public:
         std::vector<uint8_t> saved_state(state_size);
         llama_state_get_data(context_, saved_state.data(), state_size);
         
-        // Clear context for perplexity calculation
-        llama_memory_clear(llama_get_memory(context_), true);
-        
-        double total_log_prob = 0.0;
-        int32_t valid_tokens = 0;
+        llama_memory_t memory = llama_get_memory(context_);
+        llama_memory_clear(memory, true);
         
-        llama_batch batch = llama_batch_init(1, 0, 1);
+        const int32_t batch_capacity = std::max(config_.n_batch, 1);
+        llama_batch batch = llama_batch_init(batch_capacity, 0, 1);
+        std::vector<double> log_prob_sums(texts.size(), 0.0);
+        std::vector<int32_t> scored_counts(texts.size(), 0);
+        std::vector<std::pair<size_t, llama_token>> targets;    // Per batch row: text and the token its logits predict
+        targets.reserve(static_cast<size_t>(batch_capacity));
+        bool ok = true;
         
-        for (size_t i = 0; i < tokens.size(); ++i) {
+        auto add_row = [&](size_t text, llama_token token, llama_pos pos, llama_seq_id seq, llama_token target) {
+            this->batch_add(batch, token, pos, {seq}, target >= 0);
+            targets.emplace_back(text, target);
+        };
+        auto flush = [&]() {
+            if (batch.n_tokens > 0) {
+                if (traced_decode(context_, batch) != 0) {
+                    return false;
+                }
+                accumulate_log_probs(targets, log_prob_sums, scored_counts);
+            }
             this->batch_clear(batch);
-            this->batch_add(batch, tokens[i], static_cast<llama_pos>(i), {0}, true);
-            
-            if (llama_decode(context_, batch) != 0) {
-                last_error_ = "Failed to evaluate token for perplexity";
-                llama_batch_free(batch);
-                // Restore context state
-                llama_state_set_data(context_, saved_state.data(), state_size);
-                return -1.0;
+            targets.clear();
+            return true;
+        };
+        
+        // Texts that fit one batch share decodes, one sequence each
+        const size_t n_seq = std::max<size_t>(1, llama_n_seq_max(context_));
+        std::vector<size_t> long_texts;
+        size_t group_size = 0;
+        for (size_t t = 0; t < texts.size() && ok; ++t) {
+            const auto& tokens = tokenized[t];
+            if (tokens.size() < 2) {
+                continue;
             }
-            
-            if (i > 0) { // Skip the first token (no previous context)
-                const float* logits = llama_get_logits_ith(context_, 0);
-                if (logits) {
-                    float prob = logits[tokens[i]];
-                    
-                    // Apply softmax to get actual probability
-                    float max_logit = *std::max_element(logits, logits + vocab_size_);
-                    float sum_exp = 0.0f;
-                    for (int32_t j = 0; j < vocab_size_; ++j) {
-                        sum_exp += std::exp(logits[j] - max_logit);
-                    }
-                    prob = std::exp(prob - max_logit) / sum_exp;
-                    
-                    if (prob > 0.0f) {
-                        total_log_prob += std::log(prob);
-                        valid_tokens++;
+            if (tokens.size() > static_cast<size_t>(batch_capacity) || static_cast<int32_t>(tokens.size()) > context_size_ / static_cast<int32_t>(n_seq)) {
+                long_texts.push_back(t);
+                continue;
+            }
+            if (group_size == n_seq || batch.n_tokens + static_cast<int32_t>(tokens.size()) > batch_capacity) {
+                ok = flush();
+                llama_memory_clear(memory, true);
+                group_size = 0;
+            }
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                add_row(t, tokens[i], static_cast<llama_pos>(i), static_cast<llama_seq_id>(group_size),
+                        i + 1 < tokens.size() ? tokens[i + 1] : -1);
+            }
+            group_size++;
+        }
+        ok = ok && flush();
+        
+        // Longer texts: windows of n_ctx tokens advancing by half a window, each token scored once
+        // with at least half a window of preceding context (after the first window)
+        const size_t window = static_cast<size_t>(context_size_);
+        const size_t stride = std::max<size_t>(1, window / 2);
+        for (size_t t : long_texts) {
+            const auto& tokens = tokenized[t];
+            size_t scored_until = 1;
+            for (size_t begin = 0; ok; begin += stride) {
+                const size_t end = std::min(begin + window, tokens.size());
+                llama_memory_clear(memory, true);
+                for (size_t i = begin; i < end && ok; ++i) {
+                    if (batch.n_tokens == batch_capacity) {
+                        ok = flush();
                     }
+                    const bool scored = i + 1 < end && i + 1 >= scored_until;
+                    add_row(t, tokens[i], static_cast<llama_pos>(i - begin), 0, scored ? tokens[i + 1] : -1);
+                }
+                ok = ok && flush();
+                scored_until = end;
+                if (end == tokens.size()) {
+                    break;
                 }
             }
         }
@@ -524,13 +1038,38 @@ public:
         // Restore context state
         llama_state_set_data(context_, saved_state.data(), state_size);
         
-        if (valid_tokens == 0) {
-            last_error_ = "No valid tokens for perplexity calculation";
-            return -1.0;
+        if (!ok) {
+            last_error_ = "Failed to evaluate tokens for perplexity";
+            return {};
+        }
+        std::vector<double> perplexities(texts.size(), -1.0);
+        for (size_t t = 0; t < texts.size(); ++t) {
+            if (scored_counts[t] > 0) {
+                perplexities[t] = std::exp(-log_prob_sums[t] / scored_counts[t]);
+            }
+        }
+        return perplexities;
+    }
+    
+    // Add log p(target) under the softmax of each decoded row's logits to its text's sum
+    void accumulate_log_probs(const std::vector<std::pair<size_t, llama_token>>& targets,
+                              std::vector<double>& log_prob_sums, std::vector<int32_t>& scored_counts) {
+        for (size_t row = 0; row < targets.size(); ++row) {
+            if (targets[row].second < 0) {
+                continue;
+            }
+            const float* logits = llama_get_logits_ith(context_, static_cast<int32_t>(row));
+            if (!logits) {
+                continue;
+            }
+            const float max_logit = *std::max_element(logits, logits + vocab_size_);
+            double sum_exp = 0.0;
+            for (int32_t j = 0; j < vocab_size_; ++j) {
+                sum_exp += std::exp(static_cast<double>(logits[j] - max_logit));
+            }
+            log_prob_sums[targets[row].first] += static_cast<double>(logits[targets[row].second] - max_logit) - std::log(sum_exp);
+            scored_counts[targets[row].first]++;
         }
-        
-        double avg_log_prob = total_log_prob / valid_tokens;
-        return std::exp(-avg_log_prob);
     }
     
     std::vector<float> get_embeddings(const std::string& text) {
@@ -564,7 +1103,7 @@ public:
                 this->batch_add(batch, tokens[i + j], static_cast<llama_pos>(i + j), {0}, j == batch_size - 1);
             }
             
-            if (llama_decode(context_, batch) != 0) {
+            if (traced_decode(context_, batch) != 0) {
                 last_error_ = "Failed to evaluate tokens for embeddings";
                 llama_batch_free(batch);
                 // Restore context state
@@ -573,8 +1112,11 @@ public:
             }
         }
         
-        // Get embeddings
-        const float* embeddings = llama_get_embeddings(context_);
+        // Get embeddings (pooled sequence embedding when the model defines pooling, else token embeddings)
+        const float* embeddings = llama_get_embeddings_seq(context_, 0);
+        if (!embeddings) {
+            embeddings = llama_get_embeddings(context_);
+        }
         if (!embeddings) {
             last_error_ = "Model does not support embeddings";
             llama_batch_free(batch);
@@ -594,29 +1136,286 @@ public:
         return result;
     }
     
-    int32_t get_vocab_size() const {
-        return vocab_size_;
-    }
-    
-    int32_t get_context_size() const {
-        return context_size_;
-    }
-    
-    int32_t get_context_used() const {
-        return context_used_;
-    }
-    
-    const LLMConfig& get_config() const {
-        return config_;
-    }
-    
-    void update_generation_config(const LLMConfig& config) {
-        // Update only generation parameters
-        config_.n_predict = config.n_predict;
-        config_.temperature = config.temperature;
-        config_.top_p = config.top_p;
-        config_.top_k = config.top_k;
-        config_.min_p = config.min_p;
+    std::vector<float> get_embeddings_batch(const std::vector<std::string>& texts) {
+        if (!is_loaded()) {
+            last_error_ = "Model not loaded";
+            return {};
+        }
+        if (texts.empty()) {
+            return {};
+        }
+        const size_t n_embd = static_cast<size_t>(llama_model_n_embd(model_));
+        std::vector<float> result(texts.size() * n_embd);
+        
+        // Per-sequence outputs need pooling; without it each text is embedded on its own
+        if (llama_pooling_type(context_) == LLAMA_POOLING_TYPE_NONE) {
+            for (size_t t = 0; t < texts.size(); ++t) {
+                std::vector<float> embedding = get_embeddings(texts[t]);
+                if (embedding.size() != n_embd) {
+                    return {};
+                }
+                std::copy(embedding.begin(), embedding.end(), result.begin() + t * n_embd);
+            }
+            return result;
+        }
+        
+        std::vector<std::vector<int32_t>> tokenized(texts.size());
+        for (size_t t = 0; t < texts.size(); ++t) {
+            tokenized[t] = tokenize(texts[t], true);
+            if (tokenized[t].empty()) {
+                last_error_ = "Failed to tokenize text for embeddings";
+                return {};
+            }
+        }
+        
+        // Save current context state
+        const size_t state_size = llama_state_get_size(context_);
+        std::vector<uint8_t> saved_state(state_size);
+        llama_state_get_data(context_, saved_state.data(), state_size);
+        llama_memory_t memory = llama_get_memory(context_);
+        
+        // A pooled sequence has to be decoded in one ubatch, and a group shares the context
+        const int32_t batch_capacity = std::min(config_.n_batch, config_.n_ubatch);
+        const size_t n_seq = std::max<size_t>(1, llama_n_seq_max(context_));
+        llama_batch batch = llama_batch_init(batch_capacity, 0, 1);
+        std::vector<size_t> group;
+        std::vector<size_t> long_texts;
+        bool ok = true;
+        
+        auto flush = [&]() {
+            if (group.empty()) {
+                return true;
+            }
+            llama_memory_clear(memory, true);
+            if (traced_decode(context_, batch) != 0) {
+                last_error_ = "Failed to evaluate tokens for embeddings";
+                return false;
+            }
+            for (size_t seq = 0; seq < group.size(); ++seq) {
+                const float* embeddings = llama_get_embeddings_seq(context_, static_cast<llama_seq_id>(seq));
+                if (!embeddings) {
+                    last_error_ = "Model does not support embeddings";
+                    return false;
+                }
+                std::copy(embeddings, embeddings + n_embd, result.begin() + group[seq] * n_embd);
+            }
+            this->batch_clear(batch);
+            group.clear();
+            return true;
+        };
+        
+        // Texts are packed into one batch as distinct sequences, n_seq_max at a time
+        for (size_t t = 0; t < texts.size() && ok; ++t) {
+            const auto& tokens = tokenized[t];
+            if (static_cast<int32_t>(tokens.size()) > batch_capacity || static_cast<int32_t>(tokens.size()) > context_size_) {
+                long_texts.push_back(t);
+                continue;
+            }
+            if (group.size() == n_seq || batch.n_tokens + static_cast<int32_t>(tokens.size()) > batch_capacity ||
+                batch.n_tokens + static_cast<int32_t>(tokens.size()) > context_size_) {
+                ok = flush();
+            }
+            const llama_seq_id seq = static_cast<llama_seq_id>(group.size());
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                this->batch_add(batch, tokens[i], static_cast<llama_pos>(i), {seq}, true);
+            }
+            group.push_back(t);
+        }
+        ok = ok && flush();
+        
+        llama_batch_free(batch);
+        
+        // Restore context state
+        llama_state_set_data(context_, saved_state.data(), state_size);
+        if (!ok) {
+            return {};
+        }
+        
+        // Texts longer than a ubatch take the single-text path, which splits them across decodes
+        for (size_t t : long_texts) {
+            std::vector<float> embedding = get_embeddings(texts[t]);
+            if (embedding.size() != n_embd) {
+                return {};
+            }
+            std::copy(embedding.begin(), embedding.end(), result.begin() + t * n_embd);
+        }
+        return result;
+    }
+    
+    std::vector<float> score_relevance(const std::string& query, const std::vector<std::string>& passages,
+                                       int32_t max_passage_tokens) {
+        if (!is_loaded()) {
+            last_error_ = "Model not loaded";
+            return {};
+        }
+        if (passages.empty()) {
+            return {};
+        }
+        
+        // Query first so its KV entries are shared by every passage
+        auto prefix_tokens = tokenize("Decide whether the passage helps answer the question. Answer yes or no.\n"
+                                      "Question: " + query + "\nPassage: ", true);
+        auto suffix_tokens = tokenize("\nRelevant:", false);
+        auto yes_tokens = tokenize(" yes", false);
+        auto no_tokens = tokenize(" no", false);
+        if (prefix_tokens.empty() || suffix_tokens.empty() || yes_tokens.empty() || no_tokens.empty()) {
+            last_error_ = "Failed to tokenize relevance prompt";
+            return {};
+        }
+        
+        const int32_t passage_budget = std::max<int32_t>(1, max_passage_tokens) + static_cast<int32_t>(suffix_tokens.size());
+        const int32_t prefix_size = static_cast<int32_t>(prefix_tokens.size());
+        if (prefix_size + passage_budget > context_size_) {
+            last_error_ = "Relevance prompt does not fit in the context";
+            return {};
+        }
+        // All sequences share the KV cache, so bound how many passages are in flight at once
+        const size_t n_seq = static_cast<size_t>(std::max<int32_t>(1, std::min<int32_t>(
+            static_cast<int32_t>(llama_n_seq_max(context_)), (context_size_ - prefix_size) / passage_budget)));
+        
+        // Save current context state
+        const size_t state_size = llama_state_get_size(context_);
+        std::vector<uint8_t> saved_state(state_size);
+        llama_state_get_data(context_, saved_state.data(), state_size);
+        
+        llama_memory_t memory = llama_get_memory(context_);
+        llama_memory_clear(memory, true);
+        
+        const int32_t batch_capacity = std::max(config_.n_batch, 1);
+        llama_batch batch = llama_batch_init(batch_capacity, 0, 1);
+        auto fail = [&](const std::string& error) {
+            last_error_ = error;
+            llama_batch_free(batch);
+            llama_state_set_data(context_, saved_state.data(), state_size);
+            return std::vector<float>();
+        };
+        
+        for (size_t i = 0; i < prefix_tokens.size(); i += static_cast<size_t>(batch_capacity)) {
+            this->batch_clear(batch);
+            size_t batch_size = std::min(static_cast<size_t>(batch_capacity), prefix_tokens.size() - i);
+            for (size_t j = 0; j < batch_size; ++j) {
+                this->batch_add(batch, prefix_tokens[i + j], static_cast<llama_pos>(i + j), {0}, false);
+            }
+            if (traced_decode(context_, batch) != 0) {
+                return fail("Failed to evaluate relevance prompt");
+            }
+        }
+        
+        std::vector<float> scores(passages.size(), 0.0f);
+        std::vector<int32_t> pending;       // batch index -> passage scored by that token's logits (-1 = none)
+        pending.reserve(static_cast<size_t>(batch_capacity));
+        auto flush = [&]() {
+            if (batch.n_tokens == 0) {
+                return true;
+            }
+            if (traced_decode(context_, batch) != 0) {
+                return false;
+            }
+            for (int32_t i = 0; i < batch.n_tokens; ++i) {
+                if (pending[static_cast<size_t>(i)] >= 0) {
+                    const float* logits = llama_get_logits_ith(context_, i);
+                    scores[static_cast<size_t>(pending[static_cast<size_t>(i)])] =
+                        logits ? logits[yes_tokens.front()] - logits[no_tokens.front()] : 0.0f;
+                }
+            }
+            this->batch_clear(batch);
+            pending.clear();
+            return true;
+        };
+        
+        for (size_t group = 0; group < passages.size(); group += n_seq) {
+            const size_t group_size = std::min(n_seq, passages.size() - group);
+            
+            // Drop the previous group's passages and fork the shared prompt into every sequence
+            llama_memory_seq_rm(memory, 0, prefix_size, -1);
+            for (size_t s = 1; s < group_size; ++s) {
+                llama_memory_seq_rm(memory, static_cast<llama_seq_id>(s), -1, -1);
+                llama_memory_seq_cp(memory, 0, static_cast<llama_seq_id>(s), -1, -1);
+            }
+            
+            for (size_t s = 0; s < group_size; ++s) {
+                auto tokens = tokenize(passages[group + s], false);
+                if (tokens.size() > static_cast<size_t>(std::max<int32_t>(1, max_passage_tokens))) {
+                    tokens.resize(static_cast<size_t>(std::max<int32_t>(1, max_passage_tokens)));
+                }
+                tokens.insert(tokens.end(), suffix_tokens.begin(), suffix_tokens.end());
+                
+                for (size_t j = 0; j < tokens.size(); ++j) {
+                    if (batch.n_tokens == batch_capacity && !flush()) {
+                        return fail("Failed to evaluate passage for relevance");
+                    }
+                    const bool last = j + 1 == tokens.size();
+                    this->batch_add(batch, tokens[j], static_cast<llama_pos>(prefix_size + static_cast<int32_t>(j)),
+                                    {static_cast<llama_seq_id>(s)}, last);
+                    pending.push_back(last ? static_cast<int32_t>(group + s) : -1);
+                }
+            }
+            if (!flush()) {
+                return fail("Failed to evaluate passage for relevance");
+            }
+        }
+        
+        llama_batch_free(batch);
+        
+        // Restore context state
+        llama_state_set_data(context_, saved_state.data(), state_size);
+        
+        return scores;
+    }
+    
+    int32_t get_vocab_size() const {
+        return vocab_size_;
+    }
+    
+    int32_t get_context_size() const {
+        return context_size_;
+    }
+    
+    int32_t get_context_used() const {
+        return context_used_;
+    }
+    
+    // K and V rows of every layer for each context position, at llama's default F16 cache type
+    static uint64_t kv_cache_bytes(const llama_model* model, const llama_context* context) {
+        if (!model || !context) {
+            return 0;
+        }
+        int32_t n_head = llama_model_n_head(model);
+        if (n_head <= 0) {
+            return 0;
+        }
+        uint64_t head_dim = static_cast<uint64_t>(llama_model_n_embd(model) / n_head);
+        uint64_t kv_width = head_dim * static_cast<uint64_t>(llama_model_n_head_kv(model));
+        return 2 * static_cast<uint64_t>(llama_n_ctx(context)) * static_cast<uint64_t>(llama_model_n_layer(model)) * kv_width * sizeof(uint16_t);
+    }
+    
+    void get_memory_usage(uint64_t& kv_bytes, uint64_t& weight_bytes) const {
+        kv_bytes = kv_cache_bytes(model_, context_) + kv_cache_bytes(draft_model_, draft_context_);
+        weight_bytes = (model_ ? llama_model_size(model_) : 0) + (draft_model_ ? llama_model_size(draft_model_) : 0);
+    }
+    
+    void set_threads(int32_t n_threads, int32_t n_threads_batch) {
+        if (context_) {
+            llama_set_n_threads(context_, n_threads, n_threads_batch);
+        }
+        if (draft_context_) {
+            llama_set_n_threads(draft_context_, n_threads, n_threads_batch);
+        }
+        config_.n_threads = n_threads;
+        config_.n_threads_batch = n_threads_batch;
+    }
+    
+    const LLMConfig& get_config() const {
+        return config_;
+    }
+    
+    void update_generation_config(const LLMConfig& config) {
+        // Update only generation parameters
+        config_.n_predict = config.n_predict;
+        config_.temperature = config.temperature;
+        config_.top_p = config.top_p;
+        config_.top_k = config.top_k;
+        config_.min_p = config.min_p;
         config_.repeat_penalty = config.repeat_penalty;
         config_.repeat_last_n = config.repeat_last_n;
         config_.verbose_prompt = config.verbose_prompt;
@@ -624,6 +1423,7 @@ public:
         config_.seed = config.seed;
         config_.tfs_z = config.tfs_z;
         config_.typical_p = config.typical_p;
+        config_.lookup_ngram = config.lookup_ngram;
         
         // Re-seed RNG if seed changed
         this->seed_rng(config.seed);
@@ -709,6 +1509,10 @@ public:
         return is_loaded() && llama_model_n_embd(model_) > 0;
     }
     
+    int32_t get_embedding_dimension() const {
+        return is_loaded() ? llama_model_n_embd(model_) : 0;
+    }
+    
     bool set_system_prompt(const std::string& system_prompt) {
         if (!is_loaded()) {
             last_error_ = "Model not loaded";
@@ -717,60 +1521,250 @@ public:
         
         system_prompt_ = system_prompt;
         
-        // Clear context and set system prompt if provided
+        // Evaluate the system prompt into the context (prompts starting with it reuse it from the cache)
         if (!system_prompt.empty()) {
-            reset_context();
-            
             auto tokens = tokenize(system_prompt, true);
             if (tokens.empty()) {
                 last_error_ = "Failed to tokenize system prompt";
                 return false;
             }
             
-            // Add system prompt to context
             llama_batch batch = llama_batch_init(config_.n_batch, 0, 1);
-            
-            for (size_t i = 0; i < tokens.size(); i += config_.n_batch) {
-                this->batch_clear(batch);
-                
-                size_t batch_size = std::min(static_cast<size_t>(config_.n_batch), tokens.size() - i);
-                for (size_t j = 0; j < batch_size; ++j) {
-                    this->batch_add(batch, tokens[i + j], static_cast<llama_pos>(i + j), {0}, j == batch_size - 1);
-                }
-                
-                if (llama_decode(context_, batch) != 0) {
-                    last_error_ = "Failed to evaluate system prompt";
-                    llama_batch_free(batch);
-                    return false;
-                }
-                
-                context_used_ += static_cast<int32_t>(batch_size);
-            }
-            
+            int32_t reused_tokens = 0;
+            bool evaluated = evaluate_prompt(tokens, batch, reused_tokens);
+            system_prompt_tokens_ = evaluated ? tokens.size() : 0;
             llama_batch_free(batch);
+            if (!evaluated) {
+                last_error_ = "Failed to evaluate system prompt";
+                return false;
+            }
+        }
+        
+        return true;
+    }
+    
+    bool prefill_tokens(const std::vector<int32_t>& tokens) {
+        if (!is_loaded()) {
+            last_error_ = "Model not loaded";
+            return false;
+        }
+        if (tokens.empty()) {
+            return true;
+        }
+        if (static_cast<int32_t>(tokens.size()) >= context_size_) {
+            last_error_ = "Prefill too long for context size";
+            return false;
+        }
+        
+        llama_batch batch = llama_batch_init(config_.n_batch, 0, 1);
+        int32_t reused_tokens = 0;
+        bool evaluated = evaluate_prompt(tokens, batch, reused_tokens);
+        llama_batch_free(batch);
+        return evaluated;
+    }
+    
+    bool save_snapshot(SessionSnapshot& snapshot) {
+        if (!is_loaded()) {
+            last_error_ = "Model not loaded";
+            return false;
+        }
+        
+        snapshot.tokens = cached_tokens_;
+        snapshot.state.resize(llama_state_seq_get_size(context_, 0));
+        const size_t written = llama_state_seq_get_data(context_, snapshot.state.data(), snapshot.state.size(), 0);
+        if (written == 0 && !snapshot.tokens.empty()) {
+            last_error_ = "Failed to copy session state";
+            snapshot = SessionSnapshot{};
+            return false;
+        }
+        snapshot.state.resize(written);
+        return true;
+    }
+    
+    bool restore_snapshot(const SessionSnapshot& snapshot) {
+        if (!is_loaded()) {
+            last_error_ = "Model not loaded";
+            return false;
+        }
+        if (static_cast<int32_t>(snapshot.tokens.size()) > context_size_) {
+            last_error_ = "Session does not fit in the context";
+            return false;
+        }
+        
+        reset_context();
+        if (snapshot.empty()) {
+            return true;
+        }
+        if (llama_state_seq_set_data(context_, snapshot.state.data(), snapshot.state.size(), 0) == 0) {
+            last_error_ = "Failed to restore session state";
+            reset_context();
+            return false;
+        }
+        cached_tokens_ = snapshot.tokens;
+        context_used_ = static_cast<int32_t>(cached_tokens_.size());
+        return true;
+    }
+    
+    bool restore_prefix_snapshot(const SessionSnapshot& snapshot, const std::vector<int32_t>& prompt) {
+        if (snapshot.empty() || snapshot.tokens.size() >= prompt.size() ||
+            !std::equal(snapshot.tokens.begin(), snapshot.tokens.end(), prompt.begin())) {
+            return false;
+        }
+        size_t cached = 0;
+        const size_t limit = std::min(cached_tokens_.size(), snapshot.tokens.size());
+        while (cached < limit && cached_tokens_[cached] == prompt[cached]) {
+            cached++;
+        }
+        if (cached == snapshot.tokens.size()) {
+            return true;                    // The previous prompt already left this prefix in the cache
+        }
+        return restore_snapshot(snapshot);
+    }
+    
+    bool save_session(const std::string& path) {
+        if (!is_loaded()) {
+            last_error_ = "Model not loaded";
+            return false;
         }
         
+        if (llama_state_seq_save_file(context_, path.c_str(), 0, cached_tokens_.data(), cached_tokens_.size()) == 0) {
+            last_error_ = "Failed to write session file: " + path;
+            return false;
+        }
+        LEAFRA_DEBUG() << "Saved session with " << cached_tokens_.size() << " tokens to " << path;
+        return true;
+    }
+    
+    bool load_session(const std::string& path) {
+        if (!is_loaded()) {
+            last_error_ = "Model not loaded";
+            return false;
+        }
+        
+        reset_context();
+        std::vector<llama_token> tokens(static_cast<size_t>(context_size_));
+        size_t token_count = 0;
+        if (llama_state_seq_load_file(context_, path.c_str(), 0, tokens.data(), tokens.size(), &token_count) == 0) {
+            last_error_ = "Failed to read session file: " + path;
+            reset_context();
+            return false;
+        }
+        cached_tokens_.assign(tokens.begin(), tokens.begin() + static_cast<std::ptrdiff_t>(token_count));
+        context_used_ = static_cast<int32_t>(cached_tokens_.size());
+        LEAFRA_DEBUG() << "Loaded session with " << cached_tokens_.size() << " tokens from " << path;
         return true;
     }
     
+    std::future<bool> submit_generation(const std::string& prompt, TokenCallback callback, int32_t max_tokens) {
+        auto request = std::make_unique<GenerationRequest>();
+        request->prompt = prompt;
+        request->callback = std::move(callback);
+        request->max_tokens = max_tokens > 0 ? max_tokens : config_.n_predict;
+        std::future<bool> done = request->done.get_future();
+        
+        if (!is_loaded()) {
+            last_error_ = "Model not loaded";
+            request->done.set_value(false);
+            return done;
+        }
+        
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        pending_requests_.push_back(std::move(request));
+        if (!scheduler_thread_.joinable()) {
+            stop_scheduler_ = false;
+            scheduler_thread_ = std::thread(&Impl::run_scheduler, this);
+        }
+        scheduler_cv_.notify_one();
+        return done;
+    }
+    
+    // Fail queued and running scheduled generations and join the scheduler thread (no-op if not started)
+    void stop_scheduler() {
+        {
+            std::lock_guard<std::mutex> lock(scheduler_mutex_);
+            if (!scheduler_thread_.joinable()) {
+                return;
+            }
+            stop_scheduler_ = true;
+        }
+        scheduler_cv_.notify_one();
+        scheduler_thread_.join();
+    }
+    
     std::string generate_chat_response(const std::vector<ChatMessage>& messages, int32_t max_tokens) {
-        std::string formatted_prompt = format_chat_prompt(messages, true);
-        if (formatted_prompt.empty()) {
-            last_error_ = "Failed to format chat prompt";
+        std::vector<int32_t> tokens;
+        if (!tokenize_chat(messages, tokens)) {
             return "";
         }
         
-        return generate_text(formatted_prompt, max_tokens);
+        std::string result;
+        bool success = generate_from_tokens(std::move(tokens),
+            [&result](const std::string& token, bool is_final) {
+                if (!is_final) result += token;
+                return true; // Continue generation
+            }, max_tokens);
+            
+        return success ? result : "";
     }
     
     bool generate_chat_response_stream(const std::vector<ChatMessage>& messages, TokenCallback callback, int32_t max_tokens) {
+        std::vector<int32_t> tokens;
+        if (!tokenize_chat(messages, tokens)) {
+            return false;
+        }
+        
+        return generate_from_tokens(std::move(tokens), callback, max_tokens);
+    }
+    
+    // Render and tokenize a conversation, reusing the cached tokens of its system prompt prefix
+    bool tokenize_chat(const std::vector<ChatMessage>& messages, std::vector<int32_t>& tokens) {
         std::string formatted_prompt = format_chat_prompt(messages, true);
         if (formatted_prompt.empty()) {
             last_error_ = "Failed to format chat prompt";
             return false;
         }
         
-        return generate_text_stream(formatted_prompt, callback, max_tokens);
+        const PromptPrefix* prefix = nullptr;
+        if (messages.size() > 1 && messages.front().role == "system") {
+            prefix = system_prompt_prefix(messages.front());
+        }
+        
+        // Templates render the system turn the same whether or not more turns follow, but check anyway
+        if (prefix && formatted_prompt.compare(0, prefix->text.size(), prefix->text) == 0) {
+            tokens = prefix->tokens;
+            std::vector<int32_t> rest = tokenize(formatted_prompt.substr(prefix->text.size()), false);
+            tokens.insert(tokens.end(), rest.begin(), rest.end());
+        } else {
+            tokens = tokenize(formatted_prompt, true);
+        }
+        
+        if (tokens.empty()) {
+            last_error_ = "Failed to tokenize prompt";
+            return false;
+        }
+        return true;
+    }
+    
+    const PromptPrefix* system_prompt_prefix(const ChatMessage& system_message) {
+        auto it = prompt_prefix_cache_.find(system_message.content);
+        if (it != prompt_prefix_cache_.end()) {
+            return &it->second;
+        }
+        
+        PromptPrefix prefix;
+        prefix.text = format_chat_prompt({system_message}, false);
+        if (prefix.text.empty()) {
+            return nullptr;
+        }
+        prefix.tokens = tokenize(prefix.text, true);
+        if (prefix.tokens.empty()) {
+            return nullptr;
+        }
+        
+        if (prompt_prefix_cache_.size() >= kMaxCachedPromptPrefixes) {
+            prompt_prefix_cache_.clear();
+        }
+        return &prompt_prefix_cache_.emplace(system_message.content, std::move(prefix)).first->second;
     }
     
     std::string format_chat_prompt(const std::vector<ChatMessage>& messages, bool add_generation_prompt) {
@@ -800,38 +1794,42 @@ public:
         // Use custom template if set, otherwise use model's default (nullptr)
         const char* template_name = chat_template_name_.empty() ? nullptr : chat_template_name_.c_str();
         
-        // First pass to get required buffer size
-        int32_t required_size = llama_chat_apply_template(
+        // Render into the reused buffer, growing it only when a conversation outgrows it
+        if (template_buffer_.empty()) {
+            template_buffer_.resize(4096);
+        }
+        int32_t actual_size = llama_chat_apply_template(
             template_name,
             llama_messages.data(),
             llama_messages.size(),
             add_generation_prompt,
-            nullptr,
-            0
+            template_buffer_.data(),
+            static_cast<int32_t>(template_buffer_.size())
         );
         
-        if (required_size < 0) {
+        if (actual_size < 0) {
             last_error_ = "Chat template not supported or invalid";
             return "";
         }
         
-        // Allocate buffer and format
-        std::vector<char> buffer(required_size + 1);
-        int32_t actual_size = llama_chat_apply_template(
-            template_name,
-            llama_messages.data(),
-            llama_messages.size(),
-            add_generation_prompt,
-            buffer.data(),
-            buffer.size()
-        );
-        
-        if (actual_size < 0 || actual_size >= static_cast<int32_t>(buffer.size())) {
-            last_error_ = "Failed to format chat template";
-            return "";
+        if (actual_size >= static_cast<int32_t>(template_buffer_.size())) {
+            template_buffer_.resize(static_cast<size_t>(actual_size) + 1);
+            actual_size = llama_chat_apply_template(
+                template_name,
+                llama_messages.data(),
+                llama_messages.size(),
+                add_generation_prompt,
+                template_buffer_.data(),
+                static_cast<int32_t>(template_buffer_.size())
+            );
+            
+            if (actual_size < 0 || actual_size >= static_cast<int32_t>(template_buffer_.size())) {
+                last_error_ = "Failed to format chat template";
+                return "";
+            }
         }
         
-        return std::string(buffer.data(), actual_size);
+        return std::string(template_buffer_.data(), actual_size);
     }
     
     bool set_chat_template(const std::string& template_name) {
@@ -855,6 +1853,7 @@ public:
         }
         
         chat_template_name_ = template_name;
+        prompt_prefix_cache_.clear();
         return true;
     }
     
@@ -889,6 +1888,205 @@ private:
         g_rng.seed(static_cast<unsigned>(seed));
     }
     
+    struct GenerationRequest {
+        std::string prompt;
+        TokenCallback callback;
+        int32_t max_tokens = 0;
+        std::promise<bool> done;
+    };
+    
+    // A scheduled generation decoding in its own KV sequence
+    struct SequenceSlot {
+        std::unique_ptr<GenerationRequest> request;
+        llama_seq_id seq_id = 0;
+        llama_sampler* sampler = nullptr;       // Own copy of the sampling chain (penalties track this sequence only)
+        std::vector<int32_t> prompt;
+        size_t prompt_evaluated = 0;            // Prompt tokens decoded so far
+        llama_pos n_past = 0;                   // Tokens in the sequence
+        llama_token next_token = -1;            // Sampled and emitted, decoded in the next step
+        int32_t remaining = 0;                  // Tokens still allowed
+        int32_t logits_index = -1;              // Batch row carrying this slot's logits this step (-1 = none)
+        std::string piece;                      // Text produced this step
+        bool finished = false;
+        bool success = true;
+    };
+    
+    // Scheduler thread: continuous batching of queued generations over sequences 1..n_seq_max-1
+    void run_scheduler() {
+        const size_t max_slots = static_cast<size_t>(llama_n_seq_max(context_)) - 1;
+        std::vector<SequenceSlot> slots;
+        llama_batch batch = llama_batch_init(std::max(config_.n_batch, static_cast<int32_t>(max_slots)), 0, 1);
+        
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(scheduler_mutex_);
+                scheduler_cv_.wait(lock, [&]() { return stop_scheduler_ || !slots.empty() || !pending_requests_.empty(); });
+                if (stop_scheduler_) {
+                    break;
+                }
+            }
+            
+            // A single-sequence context runs queued requests one at a time on the conversation sequence
+            if (max_slots == 0) {
+                std::unique_ptr<GenerationRequest> request = pop_request();
+                if (request) {
+                    ContextLock context_lock(context_mutex_);
+                    request->done.set_value(generate_text_stream(request->prompt, request->callback, request->max_tokens));
+                }
+                continue;
+            }
+            
+            {
+                ContextLock context_lock(context_mutex_);
+                llama_memory_t memory = llama_get_memory(context_);
+                
+                // Retire finished sequences, then admit queued requests into the freed ones
+                for (auto it = slots.begin(); it != slots.end();) {
+                    if (it->finished) {
+                        llama_memory_seq_rm(memory, it->seq_id, -1, -1);
+                        llama_sampler_free(it->sampler);
+                        it = slots.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                admit_requests(slots, max_slots);
+                if (slots.empty()) {
+                    continue;
+                }
+                
+                // One token per generating sequence first, then prompt chunks in the remaining room
+                this->batch_clear(batch);
+                for (auto& slot : slots) {
+                    slot.logits_index = -1;
+                    slot.piece.clear();
+                    if (slot.next_token >= 0) {
+                        slot.logits_index = batch.n_tokens;
+                        this->batch_add(batch, slot.next_token, slot.n_past++, {slot.seq_id}, true);
+                        slot.next_token = -1;
+                    }
+                }
+                for (auto& slot : slots) {
+                    while (slot.prompt_evaluated < slot.prompt.size() && batch.n_tokens < config_.n_batch) {
+                        const bool last = ++slot.prompt_evaluated == slot.prompt.size();
+                        if (last) {
+                            slot.logits_index = batch.n_tokens;
+                        }
+                        this->batch_add(batch, slot.prompt[slot.prompt_evaluated - 1], slot.n_past++, {slot.seq_id}, last);
+                    }
+                }
+                
+                if (traced_decode(context_, batch) != 0) {
+                    last_error_ = "Failed to evaluate scheduled batch";
+                    LEAFRA_ERROR() << last_error_;
+                    for (auto& slot : slots) {
+                        slot.finished = true;
+                        slot.success = false;
+                    }
+                } else {
+                    for (auto& slot : slots) {
+                        if (slot.logits_index < 0) {
+                            continue;
+                        }
+                        llama_token token = llama_sampler_sample(slot.sampler, context_, slot.logits_index);
+                        llama_sampler_accept(slot.sampler, token);
+                        if (llama_vocab_is_eog(vocab_, token)) {
+                            slot.finished = true;
+                            continue;
+                        }
+                        slot.piece = get_token_text(token);
+                        slot.next_token = token;
+                        slot.finished = --slot.remaining <= 0;
+                    }
+                }
+            }
+            
+            // Callbacks run without the context lock so a slow consumer doesn't stall the model
+            for (auto& slot : slots) {
+                if (!slot.piece.empty() && slot.request->callback && !slot.request->callback(slot.piece, false)) {
+                    slot.finished = true;       // User requested stop
+                }
+                if (slot.finished) {
+                    complete_slot(slot);
+                }
+            }
+        }
+        
+        // Stopping: fail whatever is still queued or running
+        {
+            ContextLock context_lock(context_mutex_);
+            for (auto& slot : slots) {
+                llama_memory_seq_rm(llama_get_memory(context_), slot.seq_id, -1, -1);
+                llama_sampler_free(slot.sampler);
+                if (!slot.finished) {
+                    slot.success = false;
+                    complete_slot(slot);
+                }
+            }
+        }
+        while (std::unique_ptr<GenerationRequest> request = pop_request()) {
+            request->done.set_value(false);
+        }
+        llama_batch_free(batch);
+    }
+    
+    std::unique_ptr<GenerationRequest> pop_request() {
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        if (pending_requests_.empty()) {
+            return nullptr;
+        }
+        std::unique_ptr<GenerationRequest> request = std::move(pending_requests_.front());
+        pending_requests_.pop_front();
+        return request;
+    }
+    
+    // Move queued requests into free sequences while their prompt plus max_tokens fits the shared context
+    void admit_requests(std::vector<SequenceSlot>& slots, size_t max_slots) {
+        int32_t reserved = context_used_;
+        for (const auto& slot : slots) {
+            reserved += static_cast<int32_t>(slot.prompt.size()) + slot.request->max_tokens;
+        }
+        
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        while (!pending_requests_.empty() && slots.size() < max_slots) {
+            GenerationRequest& request = *pending_requests_.front();
+            auto prompt = tokenize(request.prompt, true);
+            const int32_t needed = static_cast<int32_t>(prompt.size()) + request.max_tokens;
+            if (prompt.empty() || needed > context_size_ || (slots.empty() && reserved + needed > context_size_)) {
+                // Can never fit (or nothing running will free room) - fail it rather than wait forever
+                LEAFRA_ERROR() << "Scheduled prompt does not fit in the context (" << needed << " tokens)";
+                request.done.set_value(false);
+                pending_requests_.pop_front();
+                continue;
+            }
+            if (reserved + needed > context_size_) {
+                break;                          // Wait for running sequences to finish
+            }
+            
+            SequenceSlot slot;
+            slot.seq_id = 1;
+            while (std::any_of(slots.begin(), slots.end(), [&](const SequenceSlot& other) { return other.seq_id == slot.seq_id; })) {
+                slot.seq_id++;
+            }
+            slot.sampler = llama_sampler_clone(sampler_);
+            llama_sampler_reset(slot.sampler);
+            slot.prompt = std::move(prompt);
+            slot.remaining = request.max_tokens;
+            slot.request = std::move(pending_requests_.front());
+            pending_requests_.pop_front();
+            reserved += needed;
+            slots.push_back(std::move(slot));
+        }
+    }
+    
+    void complete_slot(SequenceSlot& slot) {
+        if (slot.request->callback) {
+            slot.request->callback("", true);   // Signal end of generation
+        }
+        slot.request->done.set_value(slot.success);
+        slot.finished = true;
+    }
+    
     void batch_clear(llama_batch& batch) {
         batch.n_tokens = 0;
     }
@@ -909,17 +2107,33 @@ private:
 
     // Member variables
     llama_context* context_;
-    llama_model* model_;
+    llama_model* model_;                  // model_weights_.get()
+    std::shared_ptr<llama_model> model_weights_;   // Held through ModelRegistry, may be shared with other instances
     const llama_vocab* vocab_;
     llama_sampler* sampler_;  // Modern sampling chain
     LLMConfig config_;
     int32_t vocab_size_ = 0;
     int32_t context_size_ = 0;
     int32_t context_used_;
+    std::vector<int32_t> cached_tokens_;  // Tokens held in the KV cache for sequence 0, in position order
+    llama_model* draft_model_ = nullptr;  // Speculative decoding draft (same vocabulary as model_)
+    std::shared_ptr<llama_model> draft_weights_;
+    llama_context* draft_context_ = nullptr;
+    std::vector<int32_t> draft_cached_;   // Tokens held in the draft KV cache
     std::string system_prompt_;
+    size_t system_prompt_tokens_ = 0;     // Length of the evaluated system prompt (kept by context shifting)
     GenerationStats last_stats_;
     mutable std::string last_error_;
     std::string chat_template_name_;  // Custom template name if set
+    std::vector<char> template_buffer_;   // Reused chat template render buffer
+    std::unordered_map<std::string, PromptPrefix> prompt_prefix_cache_;  // System prompt -> rendered and tokenized prefix
+    
+    // Generation scheduler (started by the first submit_generation)
+    std::thread scheduler_thread_;
+    std::mutex scheduler_mutex_;          // Guards pending_requests_ and stop_scheduler_
+    std::condition_variable scheduler_cv_;
+    std::deque<std::unique_ptr<GenerationRequest>> pending_requests_;
+    bool stop_scheduler_ = false;
 };
 
 // LlamaCppModel implementation
@@ -932,6 +2146,8 @@ LlamaCppModel::LlamaCppModel(LlamaCppModel&&) noexcept = default;
 LlamaCppModel& LlamaCppModel::operator=(LlamaCppModel&&) noexcept = default;
 
 bool LlamaCppModel::load_model(const LLMConfig& config) {
+    pImpl->stop_scheduler();
+    ContextLock lock(pImpl->context_mutex_);
     return pImpl->load_model(config);
 }
 
@@ -940,22 +2156,38 @@ bool LlamaCppModel::is_loaded() const {
 }
 
 void LlamaCppModel::unload() {
+    pImpl->stop_scheduler();
+    ContextLock lock(pImpl->context_mutex_);
     pImpl->unload();
 }
 
 std::string LlamaCppModel::generate_text(const std::string& prompt, int32_t max_tokens) {
+    ContextLock lock(pImpl->context_mutex_);
     return pImpl->generate_text(prompt, max_tokens);
 }
 
 bool LlamaCppModel::generate_text_stream(const std::string& prompt, TokenCallback callback, int32_t max_tokens) {
+    ContextLock lock(pImpl->context_mutex_);
     return pImpl->generate_text_stream(prompt, callback, max_tokens);
 }
 
+bool LlamaCppModel::generate_from_tokens(const std::vector<int32_t>& tokens, TokenCallback callback, int32_t max_tokens) {
+    ContextLock lock(pImpl->context_mutex_);
+    return pImpl->generate_from_tokens(tokens, callback, max_tokens);
+}
+
+bool LlamaCppModel::generate_from_tokens(const int32_t* tokens, size_t count, TokenCallback callback, int32_t max_tokens) {
+    ContextLock lock(pImpl->context_mutex_);
+    return pImpl->generate_from_tokens(std::vector<int32_t>(tokens, tokens + (tokens ? count : 0)), callback, max_tokens);
+}
+
 std::string LlamaCppModel::continue_generation(const std::string& additional_prompt, int32_t max_tokens) {
+    ContextLock lock(pImpl->context_mutex_);
     return pImpl->continue_generation(additional_prompt, max_tokens);
 }
 
 void LlamaCppModel::reset_context() {
+    ContextLock lock(pImpl->context_mutex_);
     pImpl->reset_context();
 }
 
@@ -972,13 +2204,31 @@ std::string LlamaCppModel::get_token_text(int32_t token_id) {
 }
 
 double LlamaCppModel::calculate_perplexity(const std::string& text) {
+    ContextLock lock(pImpl->context_mutex_);
     return pImpl->calculate_perplexity(text);
 }
 
+std::vector<double> LlamaCppModel::score_texts(const std::vector<std::string>& texts) {
+    ContextLock lock(pImpl->context_mutex_);
+    return pImpl->score_texts(texts);
+}
+
 std::vector<float> LlamaCppModel::get_embeddings(const std::string& text) {
+    ContextLock lock(pImpl->context_mutex_);
     return pImpl->get_embeddings(text);
 }
 
+std::vector<float> LlamaCppModel::get_embeddings_batch(const std::vector<std::string>& texts) {
+    ContextLock lock(pImpl->context_mutex_);
+    return pImpl->get_embeddings_batch(texts);
+}
+
+std::vector<float> LlamaCppModel::score_relevance(const std::string& query, const std::vector<std::string>& passages,
+                                                  int32_t max_passage_tokens) {
+    ContextLock lock(pImpl->context_mutex_);
+    return pImpl->score_relevance(query, passages, max_passage_tokens);
+}
+
 int32_t LlamaCppModel::get_vocab_size() const {
     return pImpl->get_vocab_size();
 }
@@ -991,11 +2241,21 @@ int32_t LlamaCppModel::get_context_used() const {
     return pImpl->get_context_used();
 }
 
+void LlamaCppModel::get_memory_usage(uint64_t& kv_cache_bytes, uint64_t& weight_bytes) const {
+    pImpl->get_memory_usage(kv_cache_bytes, weight_bytes);
+}
+
+void LlamaCppModel::set_threads(int32_t n_threads, int32_t n_threads_batch) {
+    ContextLock lock(pImpl->context_mutex_);
+    pImpl->set_threads(n_threads, n_threads_batch);
+}
+
 const LLMConfig& LlamaCppModel::get_config() const {
     return pImpl->get_config();
 }
 
 void LlamaCppModel::update_generation_config(const LLMConfig& config) {
+    ContextLock lock(pImpl->context_mutex_);
     pImpl->update_generation_config(config);
 }
 
@@ -1015,15 +2275,61 @@ bool LlamaCppModel::supports_embeddings() const {
     return pImpl->supports_embeddings();
 }
 
+int32_t LlamaCppModel::get_embedding_dimension() const {
+    return pImpl->get_embedding_dimension();
+}
+
+bool LlamaCppModel::warm_up() {
+    ContextLock lock(pImpl->context_mutex_);
+    return pImpl->warm_up();
+}
+
 bool LlamaCppModel::set_system_prompt(const std::string& system_prompt) {
+    ContextLock lock(pImpl->context_mutex_);
     return pImpl->set_system_prompt(system_prompt);
 }
 
+bool LlamaCppModel::prefill_tokens(const std::vector<int32_t>& tokens) {
+    ContextLock lock(pImpl->context_mutex_);
+    return pImpl->prefill_tokens(tokens);
+}
+
+bool LlamaCppModel::save_snapshot(SessionSnapshot& snapshot) {
+    ContextLock lock(pImpl->context_mutex_);
+    return pImpl->save_snapshot(snapshot);
+}
+
+bool LlamaCppModel::restore_snapshot(const SessionSnapshot& snapshot) {
+    ContextLock lock(pImpl->context_mutex_);
+    return pImpl->restore_snapshot(snapshot);
+}
+
+bool LlamaCppModel::restore_prefix_snapshot(const SessionSnapshot& snapshot, const std::vector<int32_t>& prompt) {
+    ContextLock lock(pImpl->context_mutex_);
+    return pImpl->restore_prefix_snapshot(snapshot, prompt);
+}
+
+bool LlamaCppModel::save_session(const std::string& path) {
+    ContextLock lock(pImpl->context_mutex_);
+    return pImpl->save_session(path);
+}
+
+bool LlamaCppModel::load_session(const std::string& path) {
+    ContextLock lock(pImpl->context_mutex_);
+    return pImpl->load_session(path);
+}
+
 std::string LlamaCppModel::generate_chat_response(const std::vector<ChatMessage>& messages, int32_t max_tokens) {
+    ContextLock lock(pImpl->context_mutex_);
     return pImpl->generate_chat_response(messages, max_tokens);
 }
 
+std::future<bool> LlamaCppModel::submit_generation(const std::string& prompt, TokenCallback callback, int32_t max_tokens) {
+    return pImpl->submit_generation(prompt, std::move(callback), max_tokens);
+}
+
 bool LlamaCppModel::generate_chat_response_stream(const std::vector<ChatMessage>& messages, TokenCallback callback, int32_t max_tokens) {
+    ContextLock lock(pImpl->context_mutex_);
     return pImpl->generate_chat_response_stream(messages, callback, max_tokens);
 }
 
@@ -1121,6 +2427,9 @@ LLMConfig get_recommended_config(const std::string& model_path) {
         config.n_threads = static_cast<int32_t>(std::thread::hardware_concurrency());
         config.n_threads_batch = config.n_threads;
         
+        // Largest offload that fits next to the KV cache for n_ctx
+        config.n_gpu_layers = recommend_gpu_layers(model_path, config);
+        
         LEAFRA_INFO() << "Generated recommended config for: " << model_path;
     } else {
         LEAFRA_WARNING() << "Could not analyze model file, using defaults: " << model_path;
@@ -1132,6 +2441,118 @@ LLMConfig get_recommended_config(const std::string& model_path) {
 
 
 
+namespace {
+
+// Integer metadata value whatever width the converter wrote it with (-1 if missing or not an integer)
+int64_t gguf_int(const gguf_context* ctx, const std::string& key) {
+    const int64_t id = gguf_find_key(ctx, key.c_str());
+    if (id < 0) {
+        return -1;
+    }
+    switch (gguf_get_kv_type(ctx, id)) {
+        case GGUF_TYPE_UINT32: return gguf_get_val_u32(ctx, id);
+        case GGUF_TYPE_INT32:  return gguf_get_val_i32(ctx, id);
+        case GGUF_TYPE_UINT64: return static_cast<int64_t>(gguf_get_val_u64(ctx, id));
+        case GGUF_TYPE_INT64:  return gguf_get_val_i64(ctx, id);
+        case GGUF_TYPE_UINT16: return gguf_get_val_u16(ctx, id);
+        default:               return -1;
+    }
+}
+
+// Memory a GPU offload may use: what the GPU device reports free (Metal: the recommended working set),
+// and on iOS no more than the process may still allocate before it is killed
+bool gpu_memory_budget(uint64_t& budget) {
+    ggml_backend_dev_t device = ggml_backend_dev_by_type(GGML_BACKEND_DEVICE_TYPE_GPU);
+    if (!device) {
+        return false;
+    }
+    size_t free_bytes = 0;
+    size_t total_bytes = 0;
+    ggml_backend_dev_memory(device, &free_bytes, &total_bytes);
+    budget = free_bytes;
+#if defined(__APPLE__) && TARGET_OS_IPHONE
+    const uint64_t available = static_cast<uint64_t>(os_proc_available_memory());
+    if (available > 0) {
+        budget = std::min(budget, available);
+    }
+#endif
+    return budget > 0;
+}
+
+} // anonymous namespace
+
+int32_t recommend_gpu_layers(const std::string& model_path, const LLMConfig& config) {
+    uint64_t budget = 0;
+    if (!gpu_memory_budget(budget)) {
+        LEAFRA_DEBUG() << "No GPU device, keeping all layers on the CPU";
+        return 0;
+    }
+    
+    // Header and tensor table only, no weights are read
+    gguf_init_params params = {true, nullptr};
+    gguf_context* ctx = gguf_init_from_file(model_path.c_str(), params);
+    if (!ctx) {
+        LEAFRA_WARNING() << "Could not read GGUF header, keeping all layers on the CPU: " << model_path;
+        return 0;
+    }
+    const int64_t arch_id = gguf_find_key(ctx, "general.architecture");
+    const std::string arch = arch_id >= 0 && gguf_get_kv_type(ctx, arch_id) == GGUF_TYPE_STRING ? gguf_get_val_str(ctx, arch_id) : "";
+    const int64_t n_layer = gguf_int(ctx, arch + ".block_count");
+    const int64_t n_embd = gguf_int(ctx, arch + ".embedding_length");
+    const int64_t n_head = gguf_int(ctx, arch + ".attention.head_count");
+    const int64_t n_head_kv = gguf_int(ctx, arch + ".attention.head_count_kv");
+    if (n_layer <= 0 || n_embd <= 0) {
+        gguf_free(ctx);
+        LEAFRA_WARNING() << "GGUF header has no layer count, keeping all layers on the CPU: " << model_path;
+        return 0;
+    }
+    
+    // Weights per repeating layer ("blk.<i>."); everything else goes with the output layer
+    std::vector<uint64_t> layer_bytes(static_cast<size_t>(n_layer), 0);
+    uint64_t output_bytes = 0;
+    const int64_t n_tensors = gguf_get_n_tensors(ctx);
+    for (int64_t t = 0; t < n_tensors; ++t) {
+        const char* name = gguf_get_tensor_name(ctx, t);
+        const uint64_t size = gguf_get_tensor_size(ctx, t);
+        long layer = -1;
+        if (std::strncmp(name, "blk.", 4) == 0) {
+            layer = std::strtol(name + 4, nullptr, 10);
+        }
+        if (layer >= 0 && layer < n_layer) {
+            layer_bytes[static_cast<size_t>(layer)] += size;
+        } else if (std::strstr(name, "output") != nullptr) {
+            output_bytes += size;
+        }
+    }
+    gguf_free(ctx);
+    
+    // K and V for every context position, scaled down for grouped-query attention
+    const double kv_fraction = n_head > 0 && n_head_kv > 0 ? static_cast<double>(n_head_kv) / static_cast<double>(n_head) : 1.0;
+    const uint64_t kv_layer_bytes = static_cast<uint64_t>(
+        static_cast<double>(config.n_ctx) * static_cast<double>(n_embd) * kv_fraction *
+        (kv_cache_element_bytes(config.type_k) + kv_cache_element_bytes(config.type_v)));
+    
+    const uint64_t margin = static_cast<uint64_t>(std::max(0, config.gpu_memory_margin_mb)) * 1024 * 1024;
+    uint64_t remaining = budget > margin ? budget - margin : 0;
+    
+    // llama.cpp offloads the last n_gpu_layers repeating layers, then the output layer
+    int32_t layers = 0;
+    for (int64_t i = n_layer - 1; i >= 0; --i) {
+        const uint64_t cost = layer_bytes[static_cast<size_t>(i)] + kv_layer_bytes;
+        if (cost > remaining) {
+            break;
+        }
+        remaining -= cost;
+        layers++;
+    }
+    if (layers == n_layer && output_bytes <= remaining) {
+        layers++;
+    }
+    LEAFRA_DEBUG() << "GPU offload: " << layers << " of " << (n_layer + 1) << " layers fit in "
+                   << (budget >> 20) << " MB (margin " << config.gpu_memory_margin_mb << " MB)";
+    return layers;
+} //recommend_gpu_layers
+
 std::vector<std::string> get_available_chat_templates() {
     std::vector<std::string> templates;
     
@@ -0,0 +1,370 @@
+#import <Foundation/Foundation.h>
+#import <Metal/Metal.h>
+#include "leafra/leafra_metal_search.h"
+#include "leafra/logger.h"
+#include "leafra/leafra_simd.h"
+#include "leafra/leafra_trace.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <vector>
+
+namespace leafra {
+
+namespace {
+
+constexpr uint32_t kChunkRows = 512;   // Rows per top-k thread
+constexpr size_t kMaxGpuK = 64;        // Larger k selects on the CPU straight from the score rows
+constexpr size_t kQueryBlock = 16;     // Queries per dispatch (bounds the score buffer at 16 * rows floats)
+constexpr size_t kMinCapacityRows = 1024;
+
+// Mirrors the kernels' Params
+struct KernelParams {
+    uint32_t rows;
+    uint32_t stride;    // Floats per row (dimension rounded up to 4, zero padded)
+    uint32_t queries;
+    uint32_t k;
+    uint32_t chunk;
+    uint32_t l2;
+};
+
+const char* kKernelSource = R"METAL(
+#include <metal_stdlib>
+using namespace metal;
+
+#define MAX_K 64
+
+struct Params {
+    uint rows;
+    uint stride;
+    uint queries;
+    uint k;
+    uint chunk;
+    uint l2;
+};
+
+// scores[query * rows + row]: squared L2 distance or inner product
+kernel void score_rows(device const float4* vectors [[buffer(0)]],
+                       device const float4* queries [[buffer(1)]],
+                       device float* scores [[buffer(2)]],
+                       constant Params& p [[buffer(3)]],
+                       uint2 gid [[thread_position_in_grid]]) {
+    if (gid.x >= p.rows || gid.y >= p.queries) {
+        return;
+    }
+    const uint lanes = p.stride / 4;
+    device const float4* row = vectors + gid.x * lanes;
+    device const float4* query = queries + gid.y * lanes;
+    float4 acc = 0.0f;
+    if (p.l2 != 0) {
+        for (uint i = 0; i < lanes; ++i) {
+            float4 diff = row[i] - query[i];
+            acc = fma(diff, diff, acc);
+        }
+    } else {
+        for (uint i = 0; i < lanes; ++i) {
+            acc = fma(row[i], query[i], acc);
+        }
+    }
+    scores[gid.y * p.rows + gid.x] = acc.x + acc.y + acc.z + acc.w;
+}
+
+// Best k rows of one chunk for one query, best first (ties: lower row); unused slots get row 0xffffffff
+kernel void chunk_top_k(device const float* scores [[buffer(0)]],
+                        device float* best_scores [[buffer(1)]],
+                        device uint* best_rows [[buffer(2)]],
+                        constant Params& p [[buffer(3)]],
+                        uint2 gid [[thread_position_in_grid]]) {
+    const uint chunks = (p.rows + p.chunk - 1) / p.chunk;
+    if (gid.x >= chunks || gid.y >= p.queries) {
+        return;
+    }
+    float kept[MAX_K];
+    uint kept_rows[MAX_K];
+    uint filled = 0;
+    const uint begin = gid.x * p.chunk;
+    const uint end = min(begin + p.chunk, p.rows);
+    device const float* row_scores = scores + gid.y * p.rows;
+    for (uint row = begin; row < end; ++row) {
+        // Kept ascending, so similarities are negated
+        const float s = p.l2 != 0 ? row_scores[row] : -row_scores[row];
+        if (filled == p.k && s >= kept[filled - 1]) {
+            continue;
+        }
+        uint slot = filled < p.k ? filled++ : filled - 1;
+        while (slot > 0 && kept[slot - 1] > s) {
+            kept[slot] = kept[slot - 1];
+            kept_rows[slot] = kept_rows[slot - 1];
+            --slot;
+        }
+        kept[slot] = s;
+        kept_rows[slot] = row;
+    }
+    const uint base = (gid.y * chunks + gid.x) * p.k;
+    for (uint i = 0; i < p.k; ++i) {
+        best_scores[base + i] = i < filled ? (p.l2 != 0 ? kept[i] : -kept[i]) : 0.0f;
+        best_rows[base + i] = i < filled ? kept_rows[i] : 0xffffffffu;
+    }
+}
+)METAL";
+
+// Grow buffer to at least bytes (contents are not kept); false if the device can't allocate it
+bool ensureBuffer(id<MTLDevice> device, id<MTLBuffer>& buffer, size_t bytes) {
+    if (buffer && buffer.length >= bytes) {
+        return true;
+    }
+    [buffer release];
+    buffer = [device newBufferWithLength:std::max<size_t>(bytes, 16) options:MTLResourceStorageModeShared];
+    return buffer != nil;
+}
+
+id<MTLComputePipelineState> makePipeline(id<MTLDevice> device, id<MTLLibrary> library, NSString* name) {
+    id<MTLFunction> function = [library newFunctionWithName:name];
+    if (!function) {
+        LEAFRA_ERROR() << "Metal kernel not found: " << [name UTF8String];
+        return nil;
+    }
+    NSError* error = nil;
+    id<MTLComputePipelineState> pipeline = [device newComputePipelineStateWithFunction:function error:&error];
+    [function release];
+    if (!pipeline) {
+        LEAFRA_ERROR() << "Failed to create Metal pipeline " << [name UTF8String] << ": "
+                       << (error ? [[error localizedDescription] UTF8String] : "unknown error");
+    }
+    return pipeline;
+}
+
+void dispatch(id<MTLComputeCommandEncoder> encoder, id<MTLComputePipelineState> pipeline, size_t width, size_t height) {
+    const NSUInteger group = pipeline.threadExecutionWidth;
+    [encoder setComputePipelineState:pipeline];
+    [encoder dispatchThreadgroups:MTLSizeMake((width + group - 1) / group, height, 1)
+            threadsPerThreadgroup:MTLSizeMake(group, 1, 1)];
+}
+
+} // anonymous namespace
+
+struct MetalFlatSearch::Impl {
+    id<MTLDevice> device = nil;
+    id<MTLCommandQueue> queue = nil;
+    id<MTLComputePipelineState> score_pipeline = nil;
+    id<MTLComputePipelineState> top_k_pipeline = nil;
+    id<MTLBuffer> vectors = nil;        // capacity_rows * stride floats, the first rows in use
+    id<MTLBuffer> queries = nil;
+    id<MTLBuffer> scores = nil;
+    id<MTLBuffer> best_scores = nil;
+    id<MTLBuffer> best_rows = nil;
+    size_t dimension = 0;
+    size_t stride = 0;
+    size_t rows = 0;
+    size_t capacity_rows = 0;
+    bool l2 = true;
+
+    // CPU merge scratch
+    std::vector<float> merge_scores;
+    std::vector<uint32_t> merge_rows;
+    std::vector<uint32_t> best;
+
+    ~Impl() {
+        // No ARC in this codebase
+        [vectors release];
+        [queries release];
+        [scores release];
+        [best_scores release];
+        [best_rows release];
+        [score_pipeline release];
+        [top_k_pipeline release];
+        [queue release];
+        [device release];
+    }
+};
+
+std::unique_ptr<MetalFlatSearch> MetalFlatSearch::create(int dimension, bool inner_product) {
+    if (dimension <= 0) {
+        return nullptr;
+    }
+    @autoreleasepool {
+        auto impl = std::make_unique<Impl>();
+        impl->device = MTLCreateSystemDefaultDevice();
+        if (!impl->device) {
+            LEAFRA_INFO() << "No Metal device - GPU flat search unavailable";
+            return nullptr;
+        }
+        NSError* error = nil;
+        id<MTLLibrary> library = [impl->device newLibraryWithSource:@(kKernelSource) options:nil error:&error];
+        if (!library) {
+            LEAFRA_ERROR() << "Failed to compile Metal search kernels: "
+                           << (error ? [[error localizedDescription] UTF8String] : "unknown error");
+            return nullptr;
+        }
+        impl->score_pipeline = makePipeline(impl->device, library, @"score_rows");
+        impl->top_k_pipeline = makePipeline(impl->device, library, @"chunk_top_k");
+        [library release];
+        impl->queue = [impl->device newCommandQueue];
+        if (!impl->score_pipeline || !impl->top_k_pipeline || !impl->queue) {
+            return nullptr;
+        }
+        impl->dimension = static_cast<size_t>(dimension);
+        impl->stride = (impl->dimension + 3) & ~static_cast<size_t>(3);
+        impl->l2 = !inner_product;
+        LEAFRA_INFO() << "🎮 Metal flat search ready on " << [[impl->device name] UTF8String]
+                      << " (dim=" << dimension << ", " << (inner_product ? "inner product" : "L2") << ")";
+        return std::unique_ptr<MetalFlatSearch>(new MetalFlatSearch(std::move(impl)));
+    }
+}
+
+MetalFlatSearch::MetalFlatSearch(std::unique_ptr<Impl> impl) : pImpl(std::move(impl)) {}
+
+MetalFlatSearch::~MetalFlatSearch() = default;
+
+bool MetalFlatSearch::append(const float* vectors, size_t rows) {
+    if (!vectors || rows == 0) {
+        return rows == 0;
+    }
+    Impl& impl = *pImpl;
+    const size_t row_bytes = impl.stride * sizeof(float);
+    const size_t needed = impl.rows + rows;
+    if (needed > impl.capacity_rows) {
+        // Grow by half again, copying the rows already mirrored
+        const size_t capacity = std::max({needed, impl.capacity_rows + impl.capacity_rows / 2, kMinCapacityRows});
+        id<MTLBuffer> grown = nil;
+        if (capacity * row_bytes <= impl.device.maxBufferLength) {
+            grown = [impl.device newBufferWithLength:capacity * row_bytes options:MTLResourceStorageModeShared];
+        }
+        if (!grown) {
+            LEAFRA_WARNING() << "Metal flat search: cannot allocate " << capacity << " rows, GPU mirror dropped";
+            clear();
+            return false;
+        }
+        if (impl.rows > 0) {
+            std::memcpy(grown.contents, impl.vectors.contents, impl.rows * row_bytes);
+        }
+        [impl.vectors release];
+        impl.vectors = grown;
+        impl.capacity_rows = capacity;
+    }
+
+    float* out = static_cast<float*>(impl.vectors.contents) + impl.rows * impl.stride;
+    for (size_t row = 0; row < rows; ++row) {
+        std::memcpy(out, vectors + row * impl.dimension, impl.dimension * sizeof(float));
+        std::fill(out + impl.dimension, out + impl.stride, 0.0f);
+        out += impl.stride;
+    }
+    impl.rows = needed;
+    return true;
+}
+
+void MetalFlatSearch::clear() {
+    pImpl->rows = 0;
+}
+
+bool MetalFlatSearch::search(const float* queries, size_t n, size_t k, float* distances, int64_t* offsets) {
+    Impl& impl = *pImpl;
+    if (!queries || !distances || !offsets || n == 0 || k == 0) {
+        return false;
+    }
+    trace::Span span("metal", "flat_search");
+    span.arg("queries", static_cast<int64_t>(n));
+    span.arg("rows", static_cast<int64_t>(impl.rows));
+    const float empty_score = impl.l2 ? FLT_MAX : -FLT_MAX;
+    if (impl.rows == 0) {
+        std::fill(distances, distances + n * k, empty_score);
+        std::fill(offsets, offsets + n * k, -1);
+        return true;
+    }
+
+    const size_t rows = impl.rows;
+    const size_t kept = std::min(k, rows);
+    const bool select_on_gpu = kept <= kMaxGpuK;
+    const size_t chunks = (rows + kChunkRows - 1) / kChunkRows;
+    for (size_t block_start = 0; block_start < n; block_start += kQueryBlock) {
+        const size_t block = std::min(kQueryBlock, n - block_start);
+        if (!ensureBuffer(impl.device, impl.queries, block * impl.stride * sizeof(float)) ||
+            !ensureBuffer(impl.device, impl.scores, block * rows * sizeof(float)) ||
+            (select_on_gpu && (!ensureBuffer(impl.device, impl.best_scores, block * chunks * kept * sizeof(float)) ||
+                               !ensureBuffer(impl.device, impl.best_rows, block * chunks * kept * sizeof(uint32_t))))) {
+            LEAFRA_WARNING() << "Metal flat search: failed to allocate search buffers";
+            return false;
+        }
+        float* query_rows = static_cast<float*>(impl.queries.contents);
+        for (size_t q = 0; q < block; ++q) {
+            std::memcpy(query_rows + q * impl.stride, queries + (block_start + q) * impl.dimension, impl.dimension * sizeof(float));
+            std::fill(query_rows + q * impl.stride + impl.dimension, query_rows + (q + 1) * impl.stride, 0.0f);
+        }
+
+        @autoreleasepool {
+            KernelParams params{static_cast<uint32_t>(rows), static_cast<uint32_t>(impl.stride), static_cast<uint32_t>(block),
+                                static_cast<uint32_t>(kept), kChunkRows, impl.l2 ? 1u : 0u};
+            id<MTLCommandBuffer> command = [impl.queue commandBuffer];
+            id<MTLComputeCommandEncoder> encoder = [command computeCommandEncoder];
+            [encoder setBuffer:impl.vectors offset:0 atIndex:0];
+            [encoder setBuffer:impl.queries offset:0 atIndex:1];
+            [encoder setBuffer:impl.scores offset:0 atIndex:2];
+            [encoder setBytes:&params length:sizeof(params) atIndex:3];
+            dispatch(encoder, impl.score_pipeline, rows, block);
+            if (select_on_gpu) {
+                // Serial dispatches: the second sees every score the first wrote
+                [encoder setBuffer:impl.scores offset:0 atIndex:0];
+                [encoder setBuffer:impl.best_scores offset:0 atIndex:1];
+                [encoder setBuffer:impl.best_rows offset:0 atIndex:2];
+                dispatch(encoder, impl.top_k_pipeline, chunks, block);
+            }
+            [encoder endEncoding];
+            [command commit];
+            [command waitUntilCompleted];
+            if (command.status != MTLCommandBufferStatusCompleted) {
+                LEAFRA_WARNING() << "Metal flat search failed: "
+                                 << (command.error ? [[command.error localizedDescription] UTF8String] : "unknown error");
+                return false;
+            }
+        }
+
+        // Merge per-chunk candidates (or select from the whole score row when k is too large for the GPU pass)
+        const float* block_scores = static_cast<const float*>(impl.scores.contents);
+        for (size_t q = 0; q < block; ++q) {
+            float* out_distances = distances + (block_start + q) * k;
+            int64_t* out_offsets = offsets + (block_start + q) * k;
+            size_t found = 0;
+            if (select_on_gpu) {
+                const float* candidate_scores = static_cast<const float*>(impl.best_scores.contents) + q * chunks * kept;
+                const uint32_t* candidate_rows = static_cast<const uint32_t*>(impl.best_rows.contents) + q * chunks * kept;
+                impl.merge_scores.clear();
+                impl.merge_rows.clear();
+                for (size_t i = 0; i < chunks * kept; ++i) {
+                    if (candidate_rows[i] != 0xffffffffu) {
+                        impl.merge_scores.push_back(candidate_scores[i]);
+                        impl.merge_rows.push_back(candidate_rows[i]);
+                    }
+                }
+                simd::top_k(impl.merge_scores.data(), impl.merge_scores.size(), k, !impl.l2, impl.best);
+                for (; found < impl.best.size(); ++found) {
+                    out_distances[found] = impl.merge_scores[impl.best[found]];
+                    out_offsets[found] = impl.merge_rows[impl.best[found]];
+                }
+            } else {
+                const float* row_scores = block_scores + q * rows;
+                simd::top_k(row_scores, rows, k, !impl.l2, impl.best);
+                for (; found < impl.best.size(); ++found) {
+                    out_distances[found] = row_scores[impl.best[found]];
+                    out_offsets[found] = impl.best[found];
+                }
+            }
+            std::fill(out_distances + found, out_distances + k, empty_score);
+            std::fill(out_offsets + found, out_offsets + k, -1);
+        }
+    }
+    return true;
+} //search
+
+size_t MetalFlatSearch::size() const {
+    return pImpl->rows;
+}
+
+size_t MetalFlatSearch::memory_bytes() const {
+    size_t bytes = 0;
+    for (id<MTLBuffer> buffer : {pImpl->vectors, pImpl->queries, pImpl->scores, pImpl->best_scores, pImpl->best_rows}) {
+        bytes += buffer ? buffer.length : 0;
+    }
+    return bytes;
+}
+
+} // namespace leafra
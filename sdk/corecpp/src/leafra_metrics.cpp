@@ -0,0 +1,361 @@
+#include "leafra/leafra_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(__linux__) || defined(__ANDROID__)
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cstdio>
+#endif
+
+namespace leafra {
+
+const char* pipeline_stage_name(PipelineStage stage) {
+    switch (stage) {
+        case PipelineStage::PARSE:           return "parse";
+        case PipelineStage::CHUNK:           return "chunk";
+        case PipelineStage::TOKENIZE:        return "tokenize";
+        case PipelineStage::EMBED:           return "embed";
+        case PipelineStage::QUERY_EMBED:     return "query_embed";
+        case PipelineStage::FAISS_ADD:       return "faiss_add";
+        case PipelineStage::FAISS_SEARCH:    return "faiss_search";
+        case PipelineStage::DB_INSERT:       return "sqlite_insert";
+        case PipelineStage::DB_HYDRATE:      return "sqlite_hydrate";
+        case PipelineStage::LLM_PROMPT_EVAL: return "llm_prompt_eval";
+        case PipelineStage::LLM_DECODE:      return "llm_decode";
+        case PipelineStage::FAISS_SAVE:      return "faiss_save";
+        default:                             return "unknown";
+    }
+}
+
+const char* memory_subsystem_name(MemorySubsystem subsystem) {
+    switch (subsystem) {
+        case MemorySubsystem::CHUNKING_SCRATCH: return "chunking_scratch";
+        case MemorySubsystem::DOCUMENTS:        return "documents";
+        case MemorySubsystem::FAISS_INDEX:      return "faiss_index";
+        case MemorySubsystem::SQLITE:           return "sqlite";
+        case MemorySubsystem::LLM_KV_CACHE:     return "llm_kv_cache";
+        case MemorySubsystem::LLM_WEIGHTS:      return "llm_weights";
+        case MemorySubsystem::QUERY_CACHES:     return "query_caches";
+        default:                                return "unknown";
+    }
+}
+
+namespace {
+
+void raise_to(std::atomic<uint64_t>& peak, uint64_t value) {
+    uint64_t seen = peak.load(std::memory_order_relaxed);
+    while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+// ==============================================================================
+// LatencyHistogram
+// ==============================================================================
+
+size_t LatencyHistogram::bucket_index(uint64_t micros) {
+    if (micros < kSubBuckets) {
+        return static_cast<size_t>(micros);
+    }
+    size_t exponent = 63;
+    while ((micros >> exponent) == 0) {
+        exponent--;
+    }
+    size_t shift = exponent - kSubBucketBits;
+    size_t sub_bucket = static_cast<size_t>(micros >> shift) & (kSubBuckets - 1);
+    return (shift + 1) * kSubBuckets + sub_bucket;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    size_t shift = index / kSubBuckets - 1;
+    uint64_t lower = static_cast<uint64_t>(kSubBuckets + index % kSubBuckets) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t micros, uint64_t items) {
+    buckets_[bucket_index(micros)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    items_.fetch_add(items, std::memory_order_relaxed);
+    total_micros_.fetch_add(micros, std::memory_order_relaxed);
+    uint64_t max = max_micros_.load(std::memory_order_relaxed);
+    while (micros > max && !max_micros_.compare_exchange_weak(max, micros, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    items_.store(0, std::memory_order_relaxed);
+    total_micros_.store(0, std::memory_order_relaxed);
+    max_micros_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile_micros(double q) const {
+    // Buckets are read one by one while other threads record, so use their own total
+    // rather than count_ to keep the rank consistent with what was read
+    std::array<uint64_t, kBucketCount> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    q = std::min(1.0, std::max(0.0, q));
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            // The top bucket's bound can overshoot the largest value seen
+            return std::min(bucket_upper_bound(i), max_micros());
+        }
+    }
+    return max_micros();
+}
+
+// ==============================================================================
+// PipelineMetricsRecorder
+// ==============================================================================
+
+void PipelineMetricsRecorder::record(PipelineStage stage, std::chrono::steady_clock::duration elapsed, uint64_t items) {
+    size_t index = static_cast<size_t>(stage);
+    if (index >= stages_.size()) {
+        return;
+    }
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    stages_[index].record(micros > 0 ? static_cast<uint64_t>(micros) : 0, items);
+}
+
+PipelineMetrics PipelineMetricsRecorder::snapshot() const {
+    PipelineMetrics metrics;
+    metrics.stages.resize(stages_.size());
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        const LatencyHistogram& histogram = stages_[i];
+        StageMetrics& stage = metrics.stages[i];
+        stage.name = pipeline_stage_name(static_cast<PipelineStage>(i));
+        stage.count = histogram.count();
+        stage.items = histogram.items();
+        stage.total_ms = static_cast<double>(histogram.total_micros()) / 1000.0;
+        stage.p50_ms = static_cast<double>(histogram.percentile_micros(0.50)) / 1000.0;
+        stage.p95_ms = static_cast<double>(histogram.percentile_micros(0.95)) / 1000.0;
+        stage.p99_ms = static_cast<double>(histogram.percentile_micros(0.99)) / 1000.0;
+        stage.max_ms = static_cast<double>(histogram.max_micros()) / 1000.0;
+    }
+    return metrics;
+}
+
+void PipelineMetricsRecorder::reset() {
+    for (auto& histogram : stages_) {
+        histogram.reset();
+    }
+}
+
+double PipelineMetricsRecorder::typical_ms(PipelineStage stage) const {
+    size_t index = static_cast<size_t>(stage);
+    if (index >= stages_.size()) {
+        return 0.0;
+    }
+    return static_cast<double>(stages_[index].percentile_micros(0.50)) / 1000.0;
+}
+
+// ==============================================================================
+// MemoryAccountant
+// ==============================================================================
+
+MemoryAccountant& MemoryAccountant::instance() {
+    // Leaked so thread-local reservations released during static destruction still find it
+    static MemoryAccountant* accountant = new MemoryAccountant();
+    return *accountant;
+}
+
+void MemoryAccountant::add(MemorySubsystem subsystem, int64_t delta_bytes) {
+    size_t index = static_cast<size_t>(subsystem);
+    if (index >= kCount || delta_bytes == 0) {
+        return;
+    }
+    // Unsigned wrap-around makes a negative delta a subtraction
+    uint64_t delta = static_cast<uint64_t>(delta_bytes);
+    uint64_t value = current_[index].fetch_add(delta, std::memory_order_relaxed) + delta;
+    uint64_t total = total_.fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (delta_bytes > 0) {
+        raise_to(peak_[index], value);
+        raise_to(total_peak_, total);
+    }
+}
+
+void MemoryAccountant::set(MemorySubsystem subsystem, uint64_t bytes) {
+    size_t index = static_cast<size_t>(subsystem);
+    if (index >= kCount) {
+        return;
+    }
+    uint64_t previous = current_[index].exchange(bytes, std::memory_order_relaxed);
+    uint64_t total = total_.fetch_add(bytes - previous, std::memory_order_relaxed) + (bytes - previous);
+    raise_to(peak_[index], bytes);
+    raise_to(total_peak_, total);
+}
+
+void MemoryAccountant::note_peak(MemorySubsystem subsystem, uint64_t bytes) {
+    size_t index = static_cast<size_t>(subsystem);
+    if (index < kCount) {
+        raise_to(peak_[index], bytes);
+    }
+}
+
+uint64_t MemoryAccountant::current(MemorySubsystem subsystem) const {
+    size_t index = static_cast<size_t>(subsystem);
+    return index < kCount ? current_[index].load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t MemoryAccountant::peak(MemorySubsystem subsystem) const {
+    size_t index = static_cast<size_t>(subsystem);
+    return index < kCount ? peak_[index].load(std::memory_order_relaxed) : 0;
+}
+
+void MemoryAccountant::set_budget(MemorySubsystem subsystem, uint64_t bytes) {
+    size_t index = static_cast<size_t>(subsystem);
+    if (index < kCount) {
+        budget_[index].store(bytes, std::memory_order_relaxed);
+    }
+}
+
+bool MemoryAccountant::over_budget() const {
+    uint64_t total_limit = total_budget();
+    if (total_limit > 0 && total() > total_limit) {
+        return true;
+    }
+    for (size_t i = 0; i < kCount; ++i) {
+        uint64_t limit = budget_[i].load(std::memory_order_relaxed);
+        if (limit > 0 && current_[i].load(std::memory_order_relaxed) > limit) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t MemoryAccountant::excess(MemorySubsystem subsystem) const {
+    size_t index = static_cast<size_t>(subsystem);
+    if (index >= kCount) {
+        uint64_t limit = total_budget();
+        return limit > 0 && total() > limit ? total() - limit : 0;
+    }
+    uint64_t limit = budget_[index].load(std::memory_order_relaxed);
+    uint64_t value = current_[index].load(std::memory_order_relaxed);
+    return limit > 0 && value > limit ? value - limit : 0;
+}
+
+uint64_t MemoryAccountant::add_reclaimer(const std::string& name, MemorySubsystem subsystem, ReclaimPriority priority,
+                                         ReclaimableFn reclaimable, ReclaimFn reclaim) {
+    std::lock_guard<std::mutex> lock(reclaim_mutex_);
+    const uint64_t id = next_reclaimer_id_++;
+    auto position = std::upper_bound(reclaimers_.begin(), reclaimers_.end(), priority,
+                                     [](ReclaimPriority p, const ReclaimerEntry& entry) { return p < entry.priority; });
+    reclaimers_.insert(position, ReclaimerEntry{id, name, subsystem, priority, std::move(reclaimable), std::move(reclaim)});
+    return id;
+}
+
+void MemoryAccountant::remove_reclaimer(uint64_t id) {
+    std::lock_guard<std::mutex> lock(reclaim_mutex_);
+    reclaimers_.erase(std::remove_if(reclaimers_.begin(), reclaimers_.end(),
+                                     [id](const ReclaimerEntry& entry) { return entry.id == id; }),
+                      reclaimers_.end());
+}
+
+uint64_t MemoryAccountant::reclaimable(ReclaimPriority max_priority, MemorySubsystem subsystem) const {
+    std::lock_guard<std::mutex> lock(reclaim_mutex_);
+    uint64_t bytes = 0;
+    for (const ReclaimerEntry& entry : reclaimers_) {
+        if (entry.priority > max_priority) {
+            break;
+        }
+        if (subsystem == MemorySubsystem::COUNT || entry.subsystem == subsystem) {
+            bytes += entry.reclaimable ? entry.reclaimable() : 0;
+        }
+    }
+    return bytes;
+}
+
+uint64_t MemoryAccountant::reclaim(uint64_t bytes, ReclaimPriority max_priority, MemorySubsystem subsystem) {
+    std::lock_guard<std::mutex> lock(reclaim_mutex_);
+    uint64_t freed = 0;
+    for (const ReclaimerEntry& entry : reclaimers_) {
+        if (freed >= bytes || entry.priority > max_priority) {
+            break;
+        }
+        if (subsystem != MemorySubsystem::COUNT && entry.subsystem != subsystem) {
+            continue;
+        }
+        // A reclaimer with nothing to give is skipped rather than woken
+        if (entry.reclaimable && entry.reclaimable() == 0) {
+            continue;
+        }
+        const uint64_t wanted = bytes == UINT64_MAX ? UINT64_MAX : bytes - freed;
+        freed += entry.reclaim(wanted);
+    }
+    return freed;
+} //reclaim
+
+std::vector<MemoryMetrics> MemoryAccountant::snapshot() const {
+    std::vector<MemoryMetrics> usage(kCount);
+    for (size_t i = 0; i < kCount; ++i) {
+        usage[i].name = memory_subsystem_name(static_cast<MemorySubsystem>(i));
+        usage[i].current_bytes = current_[i].load(std::memory_order_relaxed);
+        usage[i].peak_bytes = std::max(peak_[i].load(std::memory_order_relaxed), usage[i].current_bytes);
+        usage[i].budget_bytes = budget_[i].load(std::memory_order_relaxed);
+    }
+    return usage;
+}
+
+void MemoryAccountant::reset_peaks() {
+    for (size_t i = 0; i < kCount; ++i) {
+        peak_[i].store(current_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    total_peak_.store(total(), std::memory_order_relaxed);
+}
+
+bool process_resident_memory(uint64_t& resident_bytes, uint64_t& peak_resident_bytes) {
+    resident_bytes = 0;
+    peak_resident_bytes = 0;
+#if defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return false;
+    }
+    resident_bytes = info.resident_size;
+    peak_resident_bytes = info.resident_size_max;
+    return true;
+#elif defined(__linux__) || defined(__ANDROID__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        peak_resident_bytes = static_cast<uint64_t>(usage.ru_maxrss) * 1024;  // Kilobytes on Linux
+    }
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return peak_resident_bytes > 0;
+    }
+    unsigned long long size_pages = 0;
+    unsigned long long resident_pages = 0;
+    if (std::fscanf(statm, "%llu %llu", &size_pages, &resident_pages) == 2) {
+        resident_bytes = resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+    std::fclose(statm);
+    peak_resident_bytes = std::max(peak_resident_bytes, resident_bytes);
+    return true;
+#else
+    return false;
+#endif
+} //process_resident_memory
+
+} // namespace leafra
@@ -0,0 +1,311 @@
+#include "leafra/leafra_parse_cache.h"
+#include "leafra/leafra_hash.h"
+#include "leafra/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace leafra {
+
+namespace {
+
+constexpr char kDocumentMagic[4] = {'L', 'P', 'D', '1'};
+constexpr const char* kEntrySuffix = ".lpd";
+constexpr const char* kTempMarker = ".tmp.";
+
+void put_u64(std::string& out, uint64_t value) {
+    char bytes[8];
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xffu);
+    }
+    out.append(bytes, sizeof(bytes));
+}
+
+void put_string(std::string& out, std::string_view value) {
+    put_u64(out, value.size());
+    out.append(value.data(), value.size());
+}
+
+/**
+ * @brief Bounds-checked reader over a serialized entry
+ */
+class Reader {
+public:
+    explicit Reader(std::string_view data) : data_(data) {}
+
+    bool get_u64(uint64_t& value) {
+        if (data_.size() - pos_ < 8) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(data_[pos_ + i])) << (8 * i);
+        }
+        pos_ += 8;
+        return true;
+    }
+
+    bool get_string(std::string_view& value) {
+        uint64_t size = 0;
+        if (!get_u64(size) || size > data_.size() - pos_) {
+            return false;
+        }
+        value = data_.substr(pos_, static_cast<size_t>(size));
+        pos_ += static_cast<size_t>(size);
+        return true;
+    }
+
+    bool get_string(std::string& value) {
+        std::string_view view;
+        if (!get_string(view)) {
+            return false;
+        }
+        value.assign(view.data(), view.size());
+        return true;
+    }
+
+    bool get_magic() {
+        if (data_.size() - pos_ < sizeof(kDocumentMagic) ||
+            std::memcmp(data_.data() + pos_, kDocumentMagic, sizeof(kDocumentMagic)) != 0) {
+            return false;
+        }
+        pos_ += sizeof(kDocumentMagic);
+        return true;
+    }
+
+    std::string_view rest() const { return data_.substr(pos_); }
+    bool at_end() const { return pos_ == data_.size(); }
+
+private:
+    std::string_view data_;
+    size_t pos_ = 0;
+};
+
+bool is_temp_file(const std::filesystem::path& path) {
+    return path.filename().string().find(kTempMarker) != std::string::npos;
+}
+
+} // namespace
+
+ParseCache::ParseCache(std::string directory, uint64_t max_bytes)
+    : directory_(std::move(directory)), max_bytes_(max_bytes) {}
+
+std::string ParseCache::entryPath(const std::string& content_hash, const std::string& parser_key) const {
+    // The key itself is stored inside the entry, so a hash collision on it is caught on load
+    return (std::filesystem::path(directory_) / (content_hash + "-" + ContentHasher::hash_text(parser_key) + kEntrySuffix)).string();
+}
+
+void ParseCache::serialize(const ParsedDocument& document, std::string& out) {
+    size_t size = sizeof(kDocumentMagic) + 64 + document.fileType.size() + document.title.size() + document.author.size();
+    for (const auto& entry : document.metadata) {
+        size += 16 + entry.first.size() + entry.second.size();
+    }
+    for (const auto& page : document.pages) {
+        size += 8 + page.size();
+    }
+    out.clear();
+    out.reserve(size);
+
+    out.append(kDocumentMagic, sizeof(kDocumentMagic));
+    put_string(out, document.fileType);
+    put_string(out, document.title);
+    put_string(out, document.author);
+    put_u64(out, document.metadata.size());
+    for (const auto& entry : document.metadata) {
+        put_string(out, entry.first);
+        put_string(out, entry.second);
+    }
+    put_u64(out, document.pages.size());
+    for (const auto& page : document.pages) {
+        put_string(out, page);
+    }
+} //serialize
+
+bool ParseCache::deserialize(std::string_view data, ParsedDocument& document) {
+    Reader reader(data);
+    ParsedDocument result;
+    uint64_t metadata_count = 0;
+    if (!reader.get_magic() || !reader.get_string(result.fileType) || !reader.get_string(result.title) ||
+        !reader.get_string(result.author) || !reader.get_u64(metadata_count)) {
+        return false;
+    }
+    for (uint64_t i = 0; i < metadata_count; ++i) {
+        std::string key;
+        std::string value;
+        if (!reader.get_string(key) || !reader.get_string(value)) {
+            return false;
+        }
+        result.metadata.emplace(std::move(key), std::move(value));
+    }
+    uint64_t page_count = 0;
+    // Every page costs at least its 8-byte length, which bounds the count before reserving
+    if (!reader.get_u64(page_count) || page_count > reader.rest().size() / 8) {
+        return false;
+    }
+    result.pages.reserve(static_cast<size_t>(page_count));
+    for (uint64_t i = 0; i < page_count; ++i) {
+        std::string_view page;
+        if (!reader.get_string(page)) {
+            return false;
+        }
+        result.pages.emplace_back(page);
+    }
+    if (!reader.at_end()) {
+        return false;
+    }
+    result.isValid = true;
+    document = std::move(result);
+    return true;
+} //deserialize
+
+bool ParseCache::load(const std::string& content_hash, const std::string& parser_key, ParsedDocument& document) const {
+    if (content_hash.empty() || parser_key.empty()) {
+        return false;
+    }
+    std::string path = entryPath(content_hash, parser_key);
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    std::streamoff size = file.tellg();
+    if (size <= 0) {
+        return false;
+    }
+    std::string data(static_cast<size_t>(size), '\0');
+    file.seekg(0);
+    if (!file.read(&data[0], size)) {
+        return false;
+    }
+    file.close();
+
+    Reader reader(data);
+    std::string_view stored_key;
+    std::string_view stored_hash;
+    if (!reader.get_string(stored_key) || !reader.get_string(stored_hash) ||
+        stored_key != parser_key || stored_hash != content_hash || !deserialize(reader.rest(), document)) {
+        LEAFRA_WARNING() << "Ignoring unreadable parse cache entry: " << path;
+        return false;
+    }
+
+    // Refresh the entry's age so trim() evicts least recently used entries first
+    std::error_code ec;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    return true;
+} //load
+
+bool ParseCache::store(const std::string& content_hash, const std::string& parser_key, const ParsedDocument& document) const {
+    if (content_hash.empty() || parser_key.empty() || !document.isValid || document.pages.empty()) {
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        LEAFRA_WARNING() << "Failed to create parse cache directory " << directory_ << ": " << ec.message();
+        return false;
+    }
+
+    std::string body;
+    serialize(document, body);
+    std::string header;
+    put_string(header, parser_key);
+    put_string(header, content_hash);
+
+    // Two workers may store the same content at once; each writes its own temp file and the
+    // rename makes whichever finishes last the entry
+    static std::atomic<uint64_t> temp_counter{0};
+    std::string path = entryPath(content_hash, parser_key);
+    std::string temp_path = path + kTempMarker +
+        std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + "." +
+        std::to_string(temp_counter.fetch_add(1, std::memory_order_relaxed));
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        file.write(body.data(), static_cast<std::streamsize>(body.size()));
+        if (!file.flush()) {
+            file.close();
+            std::filesystem::remove(temp_path, ec);
+            LEAFRA_WARNING() << "Failed to write parse cache entry: " << path;
+            return false;
+        }
+    }
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        LEAFRA_WARNING() << "Failed to commit parse cache entry: " << path;
+        return false;
+    }
+    return true;
+} //store
+
+size_t ParseCache::trim() const {
+    std::error_code ec;
+    if (max_bytes_ == 0 || !std::filesystem::is_directory(directory_, ec)) {
+        return 0;
+    }
+
+    struct CacheFile {
+        std::filesystem::path path;
+        std::filesystem::file_time_type last_used;
+        uint64_t size;
+    };
+    std::vector<CacheFile> files;
+    uint64_t total_bytes = 0;
+    const auto stale_temp_time = std::filesystem::file_time_type::clock::now() - std::chrono::hours(24);
+    size_t removed = 0;
+
+    for (std::filesystem::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code entry_ec;
+        if (!it->is_regular_file(entry_ec)) {
+            continue;
+        }
+        auto last_used = it->last_write_time(entry_ec);
+        if (entry_ec) {
+            continue;
+        }
+        if (is_temp_file(it->path())) {
+            // Left behind by a crash mid-store; recent ones may still be in flight
+            if (last_used < stale_temp_time && std::filesystem::remove(it->path(), entry_ec)) {
+                removed++;
+            }
+            continue;
+        }
+        uint64_t size = it->file_size(entry_ec);
+        if (entry_ec) {
+            continue;
+        }
+        files.push_back({it->path(), last_used, size});
+        total_bytes += size;
+    }
+
+    if (total_bytes > max_bytes_) {
+        std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) {
+            return a.last_used < b.last_used;
+        });
+        for (const auto& file : files) {
+            if (total_bytes <= max_bytes_) {
+                break;
+            }
+            std::error_code remove_ec;
+            if (std::filesystem::remove(file.path, remove_ec)) {
+                total_bytes -= file.size;
+                removed++;
+            }
+        }
+    }
+
+    if (removed > 0) {
+        LEAFRA_DEBUG() << "Parse cache trimmed " << removed << " entries, " << total_bytes << " bytes remain";
+    }
+    return removed;
+} //trim
+
+} // namespace leafra
@@ -1,12 +1,16 @@
 #include "leafra/leafra_parsing.h"
 #include "leafra/logger.h"
 #include "leafra/leafra_debug.h"
+#include "leafra/leafra_xml.h"
+#include "leafra/leafra_zip.h"
 
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <filesystem>
 #include <cctype>
+#include <cmath>
+#include <cstring>
 
 namespace leafra {
 
@@ -32,6 +36,294 @@ std::string ParsedDocument::getMetadata(const std::string& key, const std::strin
     return (it != metadata.end()) ? it->second : defaultValue;
 }
 
+// ==============================================================================
+// ExtractionBudget Implementation
+// ==============================================================================
+
+const char* documentLimitName(DocumentLimit limit) {
+    switch (limit) {
+        case DocumentLimit::NONE:          return "none";
+        case DocumentLimit::MAX_PAGES:     return "max_pages";
+        case DocumentLimit::MAX_TEXT:      return "max_text";
+        case DocumentLimit::PAGE_TIME:     return "page_time";
+        case DocumentLimit::DOCUMENT_TIME: return "document_time";
+        case DocumentLimit::MAX_CHUNKS:    return "max_chunks";
+        default:                           return "unknown";
+    }
+}
+
+ExtractionBudget::ExtractionBudget(const ParsingConfig& config)
+    : max_pages_(config.max_pages > 0 ? static_cast<size_t>(config.max_pages) : 0),
+      max_text_bytes_(config.max_text_mb > 0 ? static_cast<size_t>(config.max_text_mb) * 1024 * 1024 : 0),
+      page_timeout_ms_(static_cast<double>(std::max<int32_t>(0, config.page_timeout_ms))),
+      document_timeout_ms_(static_cast<double>(std::max<int32_t>(0, config.document_timeout_ms))),
+      start_(std::chrono::steady_clock::now()) {}
+
+void ExtractionBudget::hit(DocumentLimit limit) {
+    // The first limit hit is the one reported
+    int32_t none = static_cast<int32_t>(DocumentLimit::NONE);
+    limit_.compare_exchange_strong(none, static_cast<int32_t>(limit), std::memory_order_relaxed);
+}
+
+void ExtractionBudget::capPages(size_t& page_count) {
+    if (max_pages_ > 0 && page_count > max_pages_) {
+        page_count = max_pages_;
+        hit(DocumentLimit::MAX_PAGES);
+    }
+}
+
+bool ExtractionBudget::charge(size_t page_bytes, double page_ms) {
+    if (max_pages_ > 0 && pages_.fetch_add(1, std::memory_order_relaxed) >= max_pages_) {
+        hit(DocumentLimit::MAX_PAGES);
+        return false;
+    }
+    // Refused pages still count, so once over the limit every later page is refused too
+    if (max_text_bytes_ > 0 && text_bytes_.fetch_add(page_bytes, std::memory_order_relaxed) + page_bytes > max_text_bytes_) {
+        hit(DocumentLimit::MAX_TEXT);
+        return false;
+    }
+    if (page_timeout_ms_ > 0.0 && page_ms > page_timeout_ms_) {
+        hit(DocumentLimit::PAGE_TIME);
+    }
+    return true;
+}
+
+bool ExtractionBudget::exhausted() {
+    if (limit() != DocumentLimit::NONE) {
+        return true;
+    }
+    if (document_timeout_ms_ > 0.0 &&
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count() > document_timeout_ms_) {
+        hit(DocumentLimit::DOCUMENT_TIME);
+        return true;
+    }
+    return false;
+}
+
+void ExtractionBudget::apply(ParsedDocument& document) {
+    size_t kept = 0;
+    while (kept < document.pages.size() && charge(document.pages[kept].size(), 0.0)) {
+        kept++;
+    }
+    document.pages.resize(kept);
+    if (document.limit == DocumentLimit::NONE) {
+        document.limit = limit();
+    }
+}
+
+// ==============================================================================
+// IFileParsingAdapter Implementation
+// ==============================================================================
+
+ParsedDocument IFileParsingAdapter::parse(const std::string& filePath, const PageSink& sink) const {
+    ParsedDocument result = parse(filePath);
+    if (!result.isValid) {
+        return result;
+    }
+    std::vector<std::string> pages = std::move(result.pages);
+    result.pages.clear();
+    for (size_t i = 0; i < pages.size(); ++i) {
+        result.streamedPageCount++;
+        if (!sink(i, pages[i])) {
+            break;
+        }
+    }
+    return result;
+}
+
+// ==============================================================================
+// Office Open XML core properties
+// ==============================================================================
+
+namespace {
+
+// Collects the text of the Dublin Core elements in docProps/core.xml
+class CorePropertiesHandler : public XmlScanner::Handler {
+public:
+    explicit CorePropertiesHandler(ParsedDocument& result) : result_(result) {}
+
+    bool on_start_element(std::string_view name, const std::vector<XmlScanner::Attribute>&) override {
+        key_ = name == "dc:title" ? "Title" :
+               name == "dc:creator" ? "Author" :
+               name == "dc:subject" ? "Subject" :
+               name == "cp:keywords" ? "Keywords" :
+               name == "cp:lastModifiedBy" ? "LastModifiedBy" :
+               name == "dcterms:created" ? "CreationDate" :
+               name == "dcterms:modified" ? "ModDate" : nullptr;
+        return true;
+    }
+
+    bool on_end_element(std::string_view) override {
+        key_ = nullptr;
+        return true;
+    }
+
+    bool on_text(std::string_view text) override {
+        if (key_) {
+            result_.metadata[key_].append(text.data(), text.size());
+        }
+        return true;
+    }
+
+private:
+    ParsedDocument& result_;
+    const char* key_ = nullptr;
+};
+
+} // namespace
+
+void readOfficeCoreProperties(ZipReader& zip, ParsedDocument& result) {
+    if (!zip.find("docProps/core.xml")) {
+        return;
+    }
+    CorePropertiesHandler handler(result);
+    XmlScanner scanner(handler);
+    bool ok = zip.read("docProps/core.xml", [&scanner](const char* data, size_t size) {
+        return scanner.feed(data, size);
+    });
+    if (!ok || !scanner.finish()) {
+        LEAFRA_WARNING() << "Ignoring unreadable core properties in " << result.filePath;
+        return;
+    }
+    if (result.hasMetadata("Title") && !result.metadata["Title"].empty()) {
+        result.title = result.metadata["Title"];
+    }
+    if (result.hasMetadata("Author")) {
+        result.author = result.metadata["Author"];
+    }
+}
+
+namespace {
+
+// [begin, end) of one line of a page, without its '\n'
+struct LineSpan {
+    size_t begin;
+    size_t end;
+    uint64_t key;
+};
+
+// FNV-1a over the trimmed line with case folded and runs of whitespace or digits counted once (0 = blank line)
+uint64_t repeatedLineKey(const char* data, size_t size) {
+    auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+    size_t begin = 0;
+    while (begin < size && is_space(data[begin])) {
+        ++begin;
+    }
+    while (size > begin && is_space(data[size - 1])) {
+        --size;
+    }
+    if (begin == size) {
+        return 0;
+    }
+    uint64_t hash = 14695981039346656037ULL;
+    char previous = 0;
+    for (size_t i = begin; i < size; ++i) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        char folded = is_space(data[i]) ? ' ' : (c >= '0' && c <= '9') ? '#' : static_cast<char>(std::tolower(c));
+        if ((folded == ' ' || folded == '#') && folded == previous) {
+            continue;
+        }
+        previous = folded;
+        hash ^= static_cast<unsigned char>(folded);
+        hash *= 1099511628211ULL;
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+// Up to edge_lines non-blank lines from the top of text and from the bottom (each line once)
+void collectEdgeLines(const std::string& text, size_t edge_lines, std::vector<LineSpan>& lines,
+                      std::vector<LineSpan>& edges) {
+    lines.clear();
+    edges.clear();
+    size_t begin = 0;
+    while (begin <= text.size()) {
+        size_t end = text.find('\n', begin);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        uint64_t key = repeatedLineKey(text.data() + begin, end - begin);
+        if (key != 0) {
+            lines.push_back({begin, end, key});
+        }
+        begin = end + 1;
+    }
+    const size_t head = std::min(edge_lines, lines.size());
+    const size_t tail_begin = std::max(head, lines.size() > edge_lines ? lines.size() - edge_lines : 0);
+    edges.assign(lines.begin(), lines.begin() + static_cast<std::ptrdiff_t>(head));
+    edges.insert(edges.end(), lines.begin() + static_cast<std::ptrdiff_t>(tail_begin), lines.end());
+}
+
+} // namespace
+
+size_t removeRepeatedLines(std::vector<std::string>& pages, const RepeatedLineOptions& options) {
+    if (options.edge_lines == 0) {
+        return 0;
+    }
+    size_t non_empty_pages = 0;
+    for (const auto& page : pages) {
+        if (!page.empty()) {
+            non_empty_pages++;
+        }
+    }
+    if (non_empty_pages < std::max<size_t>(2, options.min_pages)) {
+        return 0;
+    }
+    const size_t threshold = std::max<size_t>(
+        2, static_cast<size_t>(std::ceil(std::max(0.0, options.min_ratio) * static_cast<double>(non_empty_pages))));
+    
+    // Count every edge line once per page it appears on
+    struct LineCount {
+        size_t pages = 0;
+        size_t last_page = 0;
+    };
+    std::unordered_map<uint64_t, LineCount> counts;
+    std::vector<LineSpan> lines;
+    std::vector<LineSpan> edges;
+    for (size_t p = 0; p < pages.size(); ++p) {
+        collectEdgeLines(pages[p], options.edge_lines, lines, edges);
+        for (const auto& line : edges) {
+            LineCount& count = counts[line.key];
+            if (count.pages == 0 || count.last_page != p) {
+                count.pages++;
+                count.last_page = p;
+            }
+        }
+    }
+    
+    // Drop the repeated lines (with their line break) by compacting each page in place
+    size_t removed = 0;
+    for (auto& page : pages) {
+        collectEdgeLines(page, options.edge_lines, lines, edges);
+        size_t write = 0;
+        size_t read = 0;
+        bool changed = false;
+        for (const auto& line : edges) {
+            if (counts[line.key].pages < threshold) {
+                continue;
+            }
+            size_t line_end = line.end < page.size() ? line.end + 1 : line.end;
+            if (line.begin > read) {
+                if (write != read) {
+                    std::memmove(&page[write], &page[read], line.begin - read);
+                }
+                write += line.begin - read;
+            }
+            read = line_end;
+            changed = true;
+        }
+        if (!changed) {
+            continue;
+        }
+        if (read < page.size()) {
+            std::memmove(&page[write], &page[read], page.size() - read);
+            write += page.size() - read;
+        }
+        removed += page.size() - write;
+        page.resize(write);
+    }
+    return removed;
+} //removeRepeatedLines
+
 // ==============================================================================
 // FileParsingWrapper Implementation
 // ==============================================================================
@@ -52,11 +344,12 @@ bool FileParsingWrapper::initialize() {
     
     LEAFRA_INFO() << "Initializing FileParsingWrapper";
     
-    // Register all available adapters
-    registerAdapter(std::make_unique<PDFParsingAdapter>());
-    registerAdapter(std::make_unique<TextParsingAdapter>());
-    registerAdapter(std::make_unique<DOCXParsingAdapter>());
-    registerAdapter(std::make_unique<ExcelParsingAdapter>());
+    // Adapters are built on first use of their extensions, so launches that only search
+    // never construct them (or load PDFium)
+    registerAdapter({"pdf"}, [] { return std::make_unique<PDFParsingAdapter>(); });
+    registerAdapter({"txt", "log", "md", "readme"}, [] { return std::make_unique<TextParsingAdapter>(); });
+    registerAdapter({"docx", "doc"}, [] { return std::make_unique<DOCXParsingAdapter>(); });
+    registerAdapter({"xlsx", "xls", "csv"}, [] { return std::make_unique<ExcelParsingAdapter>(); });
     
     initialized_ = true;
     
@@ -85,10 +378,71 @@ void FileParsingWrapper::shutdown() {
 void FileParsingWrapper::registerAdapter(std::unique_ptr<IFileParsingAdapter> adapter) {
     if (adapter) {
         LEAFRA_DEBUG() << "Registering adapter: " << adapter->getName();
-        adapters_.push_back(std::move(adapter));
+        auto slot = std::make_unique<AdapterSlot>();
+        slot->extensions = adapter->getSupportedExtensions();
+        {
+            std::lock_guard<std::mutex> lock(config_mutex_);
+            if (configured_) {
+                adapter->configure(submit_task_, config_);
+            }
+            slot->adapter = std::move(adapter);
+            slot->ready.store(slot->adapter.get(), std::memory_order_release);
+        }
+        adapters_.push_back(std::move(slot));
+    }
+}
+
+void FileParsingWrapper::registerAdapter(std::vector<std::string> extensions, AdapterFactory factory) {
+    if (factory) {
+        auto slot = std::make_unique<AdapterSlot>();
+        for (auto& extension : extensions) {
+            extension = normalizeExtension(extension);
+        }
+        slot->extensions = std::move(extensions);
+        slot->factory = std::move(factory);
+        adapters_.push_back(std::move(slot));
     }
 }
 
+const FileParsingWrapper::AdapterSlot* FileParsingWrapper::findSlot(const std::string& filePath) const {
+    std::string extension = normalizeExtension(extractFileExtension(filePath));
+    
+    for (const auto& slot : adapters_) {
+        IFileParsingAdapter* adapter = slot->ready.load(std::memory_order_acquire);
+        bool handles = adapter ? adapter->canHandle(extension)
+                               : std::find(slot->extensions.begin(), slot->extensions.end(), extension) != slot->extensions.end();
+        if (handles) {
+            return slot.get();
+        }
+    }
+    
+    return nullptr;
+}
+
+IFileParsingAdapter* FileParsingWrapper::ensureAdapter(const AdapterSlot& slot) const {
+    IFileParsingAdapter* adapter = slot.ready.load(std::memory_order_acquire);
+    if (adapter) {
+        return adapter;
+    }
+    // Concurrent first parses of the same type wait here for a single construction
+    AdapterSlot& mutable_slot = const_cast<AdapterSlot&>(slot);
+    std::call_once(mutable_slot.created, [this, &mutable_slot] {
+        auto created = mutable_slot.factory();
+        if (!created) {
+            return;
+        }
+        LEAFRA_DEBUG() << "Constructed adapter on first use: " << created->getName();
+        // Published under config_mutex_ so a concurrent configure() either sees it or is replayed onto it
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        if (configured_) {
+            created->configure(submit_task_, config_);
+        }
+        mutable_slot.adapter = std::move(created);
+        mutable_slot.ready.store(mutable_slot.adapter.get(), std::memory_order_release);
+    });
+    return slot.ready.load(std::memory_order_acquire);
+}
+
 ParsedDocument FileParsingWrapper::parseFile(const std::string& filePath) const {
     LEAFRA_DEBUG_TIMER("parseFile");
     
@@ -141,6 +495,12 @@ ParsedDocument FileParsingWrapper::parseFile(const std::string& filePath) const
     auto parse_start = debug::timer::now();
     ParsedDocument result = adapter->parse(filePath);
     auto parse_end = debug::timer::now();
+    
+    // Adapters that don't charge a budget while extracting still get the page and text limits
+    ExtractionBudget budget(limits());
+    if (result.isValid && result.limit == DocumentLimit::NONE && budget.active()) {
+        budget.apply(result);
+    }
     double parse_ms = debug::timer::elapsed_milliseconds(parse_start, parse_end);
     
     // Calculate total time
@@ -180,31 +540,89 @@ ParsedDocument FileParsingWrapper::parseFile(const std::string& filePath) const
     return result;
 }
 
+ParsedDocument FileParsingWrapper::parseFile(const std::string& filePath, const PageSink& sink) const {
+    LEAFRA_DEBUG_TIMER("parseFile");
+    
+    const IFileParsingAdapter* adapter = initialized_ ? getAdapterForFile(filePath) : nullptr;
+    if (!adapter) {
+        ParsedDocument result;
+        result.filePath = filePath;
+        result.errorMessage = initialized_ ? "No adapter found for file type: " + extractFileExtension(filePath)
+                                           : "FileParsingWrapper not initialized";
+        LEAFRA_WARNING() << result.errorMessage;
+        LEAFRA_DEBUG_LOG("ERROR", result.errorMessage);
+        return result;
+    }
+    
+    LEAFRA_INFO() << "Streaming file: " << filePath;
+    LEAFRA_DEBUG_LOG("ADAPTER", "Selected adapter: " + std::string(adapter->getName()) + " for file: " + filePath);
+    
+    auto parse_start = debug::timer::now();
+    size_t total_text_length = 0;
+    ExtractionBudget budget(limits());
+    auto page_start = parse_start;
+    ParsedDocument result = adapter->parse(filePath, [&](size_t pageIndex, std::string_view text) {
+        total_text_length += text.size();
+        if (budget.active() && !budget.charge(text.size(), debug::timer::elapsed_milliseconds(page_start, debug::timer::now()))) {
+            return false;
+        }
+        const bool more = sink(pageIndex, text) && !(budget.active() && budget.exhausted());
+        page_start = debug::timer::now();  // Time spent in sink isn't the page's
+        return more;
+    });
+    if (result.limit == DocumentLimit::NONE) {
+        result.limit = budget.limit();
+    }
+    double parse_ms = debug::timer::elapsed_milliseconds(parse_start, debug::timer::now());
+    
+    if (result.isValid) {
+        LEAFRA_DEBUG() << "Streaming parse completed - Pages: " << result.getPageCount() << ", Text length: " << total_text_length
+                       << " chars, Duration: " << parse_ms << "ms";
+    } else {
+        LEAFRA_DEBUG() << "File parsing failed: " << result.errorMessage << " (Duration: " << parse_ms << "ms)";
+    }
+    return result;
+}
+
 std::vector<std::string> FileParsingWrapper::getSupportedExtensions() const {
     std::vector<std::string> allExtensions;
     
-    for (const auto& adapter : adapters_) {
-        auto adapterExtensions = adapter->getSupportedExtensions();
-        allExtensions.insert(allExtensions.end(), adapterExtensions.begin(), adapterExtensions.end());
+    for (const auto& slot : adapters_) {
+        allExtensions.insert(allExtensions.end(), slot->extensions.begin(), slot->extensions.end());
     }
     
     return allExtensions;
 }
 
 const IFileParsingAdapter* FileParsingWrapper::getAdapterForFile(const std::string& filePath) const {
-    std::string extension = normalizeExtension(extractFileExtension(filePath));
-    
-    for (const auto& adapter : adapters_) {
-        if (adapter->canHandle(extension)) {
-            return adapter.get();
-        }
-    }
-    
-    return nullptr;
+    const AdapterSlot* slot = findSlot(filePath);
+    return slot ? ensureAdapter(*slot) : nullptr;
 }
 
 bool FileParsingWrapper::isFileTypeSupported(const std::string& filePath) const {
-    return getAdapterForFile(filePath) != nullptr;
+    return findSlot(filePath) != nullptr;
+}
+
+std::string FileParsingWrapper::getCacheKey(const std::string& filePath) const {
+    const IFileParsingAdapter* adapter = getAdapterForFile(filePath);
+    return adapter ? adapter->getCacheKey() : std::string();
+}
+
+ParsingConfig FileParsingWrapper::limits() const {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    return config_;
+}
+
+void FileParsingWrapper::configure(const TaskSubmitFunction& submit_task, const ParsingConfig& config) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    submit_task_ = submit_task;
+    config_ = config;
+    configured_ = true;
+    for (const auto& slot : adapters_) {
+        if (IFileParsingAdapter* adapter = slot->ready.load(std::memory_order_acquire)) {
+            adapter->configure(submit_task, config);
+        }
+    }
 }
 
 std::string FileParsingWrapper::extractFileExtension(const std::string& filePath) const {
@@ -1,13 +1,16 @@
 #include "leafra/leafra_parsing.h"
+#include "leafra/leafra_xml.h"
+#include "leafra/leafra_zip.h"
 #include "leafra/logger.h"
 
 #include <algorithm>
 #include <cctype>
+#include <filesystem>
 
 namespace leafra {
 
 // ==============================================================================
-// DOCXParsingAdapter Implementation (Placeholder)
+// DOCXParsingAdapter Implementation
 // ==============================================================================
 
 bool DOCXParsingAdapter::canHandle(const std::string& extension) const {
@@ -24,15 +27,207 @@ std::string DOCXParsingAdapter::getName() const {
     return "DOCXParsingAdapter";
 }
 
-ParsedDocument DOCXParsingAdapter::parse(const std::string& filePath) const {
-    ParsedDocument result;
+namespace {
+
+/**
+ * @brief Turns the WordprocessingML body into page text
+ *
+ * Only w:t runs are collected (deleted text and field codes are skipped). Paragraphs end
+ * with a newline, table cells with a tab and table rows with a newline. A page ends at
+ * <w:br w:type="page"/>, <w:lastRenderedPageBreak/> or a paragraph carrying a section break.
+ */
+class DocumentXmlHandler : public XmlScanner::Handler {
+public:
+    explicit DocumentXmlHandler(const PageSink& sink) : sink_(sink) {}
+
+    bool on_start_element(std::string_view name, const std::vector<XmlScanner::Attribute>& attributes) override {
+        if (name == "w:t") {
+            in_text_ = true;
+        } else if (name == "w:pPr") {
+            in_paragraph_properties_ = true;
+        } else if (in_paragraph_properties_) {
+            // Tab stops and the like live here; only a section break matters
+            if (name == "w:sectPr") {
+                section_break_ = true;
+            }
+        } else if (name == "w:tab") {
+            page_ += '\t';
+        } else if (name == "w:br") {
+            if (XmlScanner::attribute(attributes, "w:type") == "page") {
+                return end_page();
+            }
+            page_ += '\n';
+        } else if (name == "w:cr") {
+            page_ += '\n';
+        } else if (name == "w:lastRenderedPageBreak") {
+            return end_page();
+        } else if (name == "w:tbl") {
+            table_depth_++;
+        }
+        return true;
+    }
+
+    bool on_end_element(std::string_view name) override {
+        if (name == "w:t") {
+            in_text_ = false;
+        } else if (name == "w:pPr") {
+            in_paragraph_properties_ = false;
+        } else if (name == "w:p") {
+            page_ += table_depth_ > 0 ? ' ' : '\n';
+            if (section_break_) {
+                section_break_ = false;
+                return end_page();
+            }
+        } else if (name == "w:tc") {
+            trim_trailing_space();
+            page_ += '\t';
+        } else if (name == "w:tr") {
+            trim_trailing_space();
+            page_ += '\n';
+        } else if (name == "w:tbl" && table_depth_ > 0) {
+            table_depth_--;
+        }
+        return true;
+    }
+
+    bool on_text(std::string_view text) override {
+        if (in_text_) {
+            page_.append(text.data(), text.size());
+        }
+        return true;
+    }
+
+    /**
+     * @brief Hand over the last page; a document without text still yields one empty page
+     */
+    bool finish() {
+        if (!page_is_blank() || pages_ == 0) {
+            return flush();
+        }
+        return true;
+    }
+
+    size_t pages() const { return pages_; }
+    size_t characters() const { return characters_; }
+
+private:
+    bool page_is_blank() const {
+        return std::all_of(page_.begin(), page_.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); });
+    }
+
+    void trim_trailing_space() {
+        while (!page_.empty() && (page_.back() == ' ' || page_.back() == '\t')) {
+            page_.pop_back();
+        }
+    }
+
+    // Break markers often come in pairs (an explicit break then Word's rendered one), so a
+    // page holding only whitespace is dropped instead of emitted
+    bool end_page() {
+        if (page_is_blank()) {
+            page_.clear();
+            return true;
+        }
+        return flush();
+    }
+
+    bool flush() {
+        characters_ += page_.size();
+        bool keep_going = sink_(pages_++, page_);
+        page_.clear();
+        return keep_going;
+    }
+
+    const PageSink& sink_;
+    std::string page_;
+    size_t pages_ = 0;
+    size_t characters_ = 0;
+    int table_depth_ = 0;
+    bool in_text_ = false;
+    bool in_paragraph_properties_ = false;
+    bool section_break_ = false;
+};
+
+} // namespace
+
+/**
+ * @brief Stream word/document.xml page by page into sink, filling in result's metadata
+ */
+static bool parseDocxFile(const std::string& filePath, ParsedDocument& result, const PageSink& sink) {
     result.filePath = filePath;
     result.fileType = "DOCX";
-    result.errorMessage = "DOCX parsing not yet implemented";
-    
-    LEAFRA_WARNING() << "DOCX parsing not yet implemented for: " << filePath;
-    
+
+    std::filesystem::path path(filePath);
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    if (ext == ".doc") {
+        result.errorMessage = "Legacy binary .doc files are not supported, save as .docx: " + filePath;
+        LEAFRA_WARNING() << result.errorMessage;
+        return false;
+    }
+
+    LEAFRA_INFO() << "Parsing DOCX file: " << filePath;
+
+    ZipReader zip;
+    if (!zip.open(filePath)) {
+        result.errorMessage = "Failed to open DOCX file: " + zip.last_error();
+        LEAFRA_ERROR() << result.errorMessage;
+        return false;
+    }
+    if (!zip.find("word/document.xml")) {
+        result.errorMessage = "Not a Word document (no word/document.xml): " + filePath;
+        LEAFRA_ERROR() << result.errorMessage;
+        return false;
+    }
+
+    result.title = path.filename().string();
+    result.metadata["FileName"] = path.filename().string();
+    readOfficeCoreProperties(zip, result);
+
+    DocumentXmlHandler handler(sink);
+    XmlScanner scanner(handler);
+    bool read_ok = zip.read("word/document.xml", [&scanner](const char* data, size_t size) {
+        return scanner.feed(data, size);
+    });
+    if (!read_ok) {
+        result.errorMessage = "Failed to read DOCX content: " + zip.last_error();
+        LEAFRA_ERROR() << result.errorMessage;
+        return false;
+    }
+    if (!scanner.stopped()) {
+        if (!scanner.finish()) {
+            result.errorMessage = "Malformed DOCX XML: " + scanner.last_error();
+            LEAFRA_ERROR() << result.errorMessage;
+            return false;
+        }
+        handler.finish();
+    } else if (!scanner.last_error().empty()) {
+        result.errorMessage = "Malformed DOCX XML: " + scanner.last_error();
+        LEAFRA_ERROR() << result.errorMessage;
+        return false;
+    }
+
+    result.isValid = true;
+    LEAFRA_INFO() << "Successfully parsed DOCX file with " << handler.characters() << " characters in " << handler.pages() << " pages";
+    return true;
+}
+
+ParsedDocument DOCXParsingAdapter::parse(const std::string& filePath) const {
+    ParsedDocument result;
+    parseDocxFile(filePath, result, [&result](size_t, std::string_view text) {
+        result.pages.emplace_back(text);
+        return true;
+    });
+    return result;
+}
+
+ParsedDocument DOCXParsingAdapter::parse(const std::string& filePath, const PageSink& sink) const {
+    ParsedDocument result;
+    parseDocxFile(filePath, result, [&](size_t pageIndex, std::string_view text) {
+        result.streamedPageCount++;
+        return sink(pageIndex, text);
+    });
     return result;
 }
 
-} // namespace leafra 
\ No newline at end of file
+} // namespace leafra
@@ -1,8 +1,12 @@
 #include "leafra/leafra_parsing.h"
+#include "leafra/leafra_debug.h"
+#include "leafra/leafra_filemanager.h"
+#include "leafra/leafra_unicode.h"
 #include "leafra/logger.h"
 
 #include <algorithm>
 #include <cctype>
+#include <mutex>
 
 #ifdef LEAFRA_HAS_PDFIUM
 #include "fpdfview.h"
@@ -12,6 +16,21 @@
 
 namespace leafra {
 
+// PDFium is not thread-safe: all calls into the library from the parallel
+// ingestion workers are serialized through this mutex. Parallel page extraction
+// runs while the parsing thread holds it, each worker on a document handle of its own.
+static std::mutex g_pdfium_mutex;
+
+#ifdef LEAFRA_HAS_PDFIUM
+// Opens a document handle over the mapped file when there is one, from the path otherwise
+static FPDF_DOCUMENT openDocument(const std::string& filePath, const void* data, size_t size) {
+    if (data && size > 0) {
+        return FPDF_LoadMemDocument64(data, size, nullptr);
+    }
+    return FPDF_LoadDocument(filePath.c_str(), nullptr);
+}
+#endif
+
 // ==============================================================================
 // PDFParsingAdapter Implementation
 // ==============================================================================
@@ -41,6 +60,26 @@ std::string PDFParsingAdapter::getName() const {
     return "PDFParsingAdapter";
 }
 
+std::string PDFParsingAdapter::getCacheKey() const {
+    if (!strip_boilerplate_) {
+        return getName() + "/1";
+    }
+    return getName() + "/1/boilerplate/" + std::to_string(boilerplate_.min_pages) + "/" +
+           std::to_string(boilerplate_.min_ratio) + "/" + std::to_string(boilerplate_.edge_lines);
+}
+
+void PDFParsingAdapter::configure(const TaskSubmitFunction& submit_task, const ParsingConfig& config) {
+    std::lock_guard<std::mutex> pdfium_lock(g_pdfium_mutex);
+    submit_task_ = submit_task;
+    parallel_min_pages_ = config.pdf_parallel_min_pages > 0 ? static_cast<size_t>(config.pdf_parallel_min_pages) : 0;
+    max_document_handles_ = static_cast<size_t>(std::max<int32_t>(1, config.pdf_max_document_handles));
+    strip_boilerplate_ = config.pdf_strip_boilerplate && config.pdf_boilerplate_edge_lines > 0;
+    boilerplate_.min_pages = static_cast<size_t>(std::max<int32_t>(0, config.pdf_boilerplate_min_pages));
+    boilerplate_.min_ratio = config.pdf_boilerplate_min_ratio;
+    boilerplate_.edge_lines = static_cast<size_t>(std::max<int32_t>(0, config.pdf_boilerplate_edge_lines));
+    limits_ = config;
+}
+
 bool PDFParsingAdapter::initializePDFium() {
 #ifdef LEAFRA_HAS_PDFIUM
     if (pdfiumInitialized_) {
@@ -75,13 +114,22 @@ void PDFParsingAdapter::shutdownPDFium() {
 }
 
 ParsedDocument PDFParsingAdapter::parse(const std::string& filePath) const {
+    return parseDocument(filePath, nullptr);
+}
+
+ParsedDocument PDFParsingAdapter::parse(const std::string& filePath, const PageSink& sink) const {
+    return parseDocument(filePath, &sink);
+}
+
+ParsedDocument PDFParsingAdapter::parseDocument(const std::string& filePath, const PageSink* sink) const {
     ParsedDocument result;
     result.filePath = filePath;
     result.fileType = "PDF";
     
 #ifdef LEAFRA_HAS_PDFIUM
+    std::lock_guard<std::mutex> pdfium_lock(g_pdfium_mutex);
     if (!pdfiumInitialized_) {
-        // Try to initialize if not already done
+        // PDFium is loaded by the first PDF parse rather than at startup; this lock makes it a one-time init
         const_cast<PDFParsingAdapter*>(this)->initializePDFium();
         if (!pdfiumInitialized_) {
             result.errorMessage = "PDFium not available";
@@ -91,8 +139,12 @@ ParsedDocument PDFParsingAdapter::parse(const std::string& filePath) const {
     
     LEAFRA_INFO() << "Parsing PDF file: " << filePath;
     
-    // Load the PDF document
-    FPDF_DOCUMENT document = FPDF_LoadDocument(filePath.c_str(), nullptr);
+    // Load the PDF document straight from a read-only mapping (random access: PDFium seeks
+    // through the xref table and object streams); the mapping outlives every handle opened on it
+    FileManager::MappedFile mapped = FileManager::mapFile(filePath, FileManager::AccessHint::Random);
+    const void* data = mapped.isOpen() ? mapped.data() : nullptr;
+    const size_t size = mapped.isOpen() ? mapped.size() : 0;
+    FPDF_DOCUMENT document = openDocument(filePath, data, size);
     if (!document) {
         unsigned long error = FPDF_GetLastError();
         result.errorMessage = "Failed to load PDF document. Error: " + std::to_string(error);
@@ -104,29 +156,77 @@ ParsedDocument PDFParsingAdapter::parse(const std::string& filePath) const {
     extractMetadata(document, result);
     
     // Get page count
-    int pageCount = FPDF_GetPageCount(document);
-    LEAFRA_INFO() << "PDF has " << pageCount << " pages";
+    const int totalPageCount = FPDF_GetPageCount(document);
+    LEAFRA_INFO() << "PDF has " << totalPageCount << " pages";
     
-    // Extract text from each page
-    for (int i = 0; i < pageCount; ++i) {
-        FPDF_PAGE page = FPDF_LoadPage(document, i);
-        if (page) {
-            std::string pageText = extractTextFromPage(page);
-            result.pages.push_back(pageText);
-            FPDF_ClosePage(page);
-            LEAFRA_DEBUG() << "Extracted " << pageText.length() << " characters from page " << (i + 1);
+    // Pages past max_pages are never loaded
+    ExtractionBudget budget(limits_);
+    size_t pagesToExtract = static_cast<size_t>(std::max(totalPageCount, 0));
+    budget.capPages(pagesToExtract);
+    const int pageCount = static_cast<int>(pagesToExtract);
+    
+    // Extract text from each page (long documents split into page ranges across workers)
+    const bool parallel = submit_task_ && parallel_min_pages_ > 0 && max_document_handles_ > 1 &&
+                          static_cast<size_t>(std::max(pageCount, 0)) >= parallel_min_pages_;
+    if (sink && !parallel && !strip_boilerplate_) {
+        // Streaming: each page is handed over as soon as it's extracted and not kept
+        // (the sink runs under the PDFium lock)
+        std::string pageText;
+        for (int i = 0; i < pageCount && !budget.exhausted(); ++i) {
+            pageText.clear();
+            auto page_start = debug::timer::now();
+            extractPage(document, i, pageText);
+            if (!budget.charge(pageText.size(), debug::timer::elapsed_milliseconds(page_start, debug::timer::now()))) {
+                break;
+            }
+            result.streamedPageCount++;
+            if (!(*sink)(static_cast<size_t>(i), pageText)) {
+                break;
+            }
+        }
+    } else {
+        result.pages.assign(static_cast<size_t>(std::max(pageCount, 0)), std::string());
+        if (parallel) {
+            extractPagesInParallel(document, filePath, data, size, pageCount, result.pages, budget);
         } else {
-            result.pages.push_back("");
-            LEAFRA_WARNING() << "Failed to load page " << (i + 1);
+            extractPages(document, 0, pageCount, result.pages, budget);
+        }
+        if (budget.limit() != DocumentLimit::NONE) {
+            // Pages left out at the end aren't part of the document
+            while (!result.pages.empty() && result.pages.back().empty()) {
+                result.pages.pop_back();
+            }
+        }
+        if (strip_boilerplate_) {
+            size_t removed = removeRepeatedLines(result.pages, boilerplate_);
+            if (removed > 0) {
+                LEAFRA_DEBUG() << "Removed " << removed << " bytes of repeated headers/footers from " << filePath;
+            }
+        }
+        if (sink) {
+            // Parallel ranges finish out of order and boilerplate needs every page, so pages are replayed once they're all in
+            for (size_t i = 0; i < result.pages.size(); ++i) {
+                result.streamedPageCount++;
+                if (!(*sink)(i, result.pages[i])) {
+                    break;
+                }
+            }
+            result.pages.clear();
         }
     }
     
     FPDF_CloseDocument(document);
     result.isValid = true;
+    result.limit = budget.limit();
+    if (result.limit != DocumentLimit::NONE) {
+        LEAFRA_WARNING() << "PDF extraction of " << filePath << " stopped at limit " << documentLimitName(result.limit)
+                         << " after " << result.getPageCount() << " of " << totalPageCount << " pages";
+    }
     
-    LEAFRA_INFO() << "Successfully parsed PDF with " << result.pages.size() << " pages";
+    LEAFRA_INFO() << "Successfully parsed PDF with " << result.getPageCount() << " pages";
     
 #else
+    (void)sink;
     result.errorMessage = "PDFium not available - cannot parse PDF files";
     LEAFRA_WARNING() << result.errorMessage;
 #endif
@@ -134,91 +234,119 @@ ParsedDocument PDFParsingAdapter::parse(const std::string& filePath) const {
     return result;
 }
 
-std::string PDFParsingAdapter::extractTextFromPage(void* page) const {
+void PDFParsingAdapter::extractPage(void* document, int index, std::string& text) const {
+#ifdef LEAFRA_HAS_PDFIUM
+    FPDF_PAGE page = FPDF_LoadPage(static_cast<FPDF_DOCUMENT>(document), index);
+    if (page) {
+        extractTextFromPage(page, text);
+        FPDF_ClosePage(page);
+        LEAFRA_DEBUG() << "Extracted " << text.length() << " characters from page " << (index + 1);
+    } else {
+        LEAFRA_WARNING() << "Failed to load page " << (index + 1);
+    }
+#else
+    (void)document;
+    (void)index;
+    (void)text;
+#endif
+}
+
+void PDFParsingAdapter::extractPages(void* document, int first, int last, std::vector<std::string>& pages,
+                                     ExtractionBudget& budget) const {
+    for (int i = first; i < last && !budget.exhausted(); ++i) {
+        std::string& page = pages[static_cast<size_t>(i)];
+        auto page_start = debug::timer::now();
+        extractPage(document, i, page);
+        if (!budget.charge(page.size(), debug::timer::elapsed_milliseconds(page_start, debug::timer::now()))) {
+            std::string().swap(page);
+        }
+    }
+}
+
+void PDFParsingAdapter::extractPagesInParallel(void* document, const std::string& filePath, const void* data,
+                                               size_t size, int pageCount, std::vector<std::string>& pages,
+                                               ExtractionBudget& budget) const {
+#ifdef LEAFRA_HAS_PDFIUM
+    // Contiguous page ranges; the first reuses the already open handle, the others open their own
+    // (over the same mapped bytes when the file is mapped, so extra handles cost no extra reads)
+    const size_t range_count = std::min(max_document_handles_, static_cast<size_t>(pageCount));
+    std::vector<char> range_failed(range_count, 0);
+    auto range_begin = [pageCount, range_count](size_t range) {
+        return static_cast<int>(range * static_cast<size_t>(pageCount) / range_count);
+    };
+    
+    LEAFRA_DEBUG() << "Extracting " << pageCount << " pages in " << range_count << " parallel ranges";
+    parallel_for_each(submit_task_, range_count, [&](size_t range) {
+        const int first = range_begin(range);
+        const int last = range_begin(range + 1);
+        if (range == 0) {
+            extractPages(document, first, last, pages, budget);
+            return;
+        }
+        FPDF_DOCUMENT handle = openDocument(filePath, data, size);
+        if (!handle) {
+            range_failed[range] = 1;
+            return;
+        }
+        extractPages(handle, first, last, pages, budget);
+        FPDF_CloseDocument(handle);
+    });
+    
+    // Ranges whose handle didn't open fall back to the shared one
+    for (size_t range = 1; range < range_count; ++range) {
+        if (range_failed[range]) {
+            LEAFRA_WARNING() << "Failed to open a second handle for " << filePath << " - extracting pages "
+                             << (range_begin(range) + 1) << "-" << range_begin(range + 1) << " sequentially";
+            extractPages(document, range_begin(range), range_begin(range + 1), pages, budget);
+        }
+    }
+#else
+    (void)document;
+    (void)filePath;
+    (void)data;
+    (void)size;
+    (void)pageCount;
+    (void)pages;
+    (void)budget;
+#endif
+}
+
+void PDFParsingAdapter::extractTextFromPage(void* page, std::string& text) const {
 #ifdef LEAFRA_HAS_PDFIUM
     FPDF_PAGE fpdfPage = static_cast<FPDF_PAGE>(page);
+    text.clear();
     
     // Create text page
     FPDF_TEXTPAGE textPage = FPDFText_LoadPage(fpdfPage);
     if (!textPage) {
         LEAFRA_WARNING() << "Failed to create text page";
-        return "";
+        return;
     }
     
     // Get text length
     int textLength = FPDFText_CountChars(textPage);
     if (textLength <= 0) {
         FPDFText_ClosePage(textPage);
-        return "";
+        return;
     }
     
-    // Extract text
-    std::vector<unsigned short> buffer(textLength + 1);
-    int actualLength = FPDFText_GetText(textPage, 0, textLength, buffer.data());
+    // Per-thread buffers keep their capacity across pages, so the hot loop doesn't allocate
+    // once they've grown to the largest page (parallel extraction gives each worker its own)
+    thread_local std::vector<unsigned short> utf16;
+    thread_local std::string utf8;
+    utf16.resize(static_cast<size_t>(textLength) + 1);
+    int actualLength = FPDFText_GetText(textPage, 0, textLength, utf16.data());
     
     FPDFText_ClosePage(textPage);
     
-    // Convert UTF-16 to UTF-8 properly
-    std::string result;
-    result.reserve(actualLength * 2); // Reserve space to avoid reallocations
-    
-    for (int i = 0; i < actualLength - 1; ++i) {
-        uint16_t codeUnit = static_cast<uint16_t>(buffer[i]);
-        uint32_t codePoint;
-        
-        // Check for surrogate pairs (UTF-16 encoding for characters > U+FFFF)
-        if (codeUnit >= 0xD800 && codeUnit <= 0xDBFF) {
-            // High surrogate - need to read low surrogate
-            if (i + 1 < actualLength - 1) {
-                uint16_t lowSurrogate = static_cast<uint16_t>(buffer[i + 1]);
-                if (lowSurrogate >= 0xDC00 && lowSurrogate <= 0xDFFF) {
-                    // Valid surrogate pair - combine to get full code point
-                    codePoint = 0x10000 + ((codeUnit & 0x3FF) << 10) + (lowSurrogate & 0x3FF);
-                    ++i; // Skip the low surrogate in next iteration
-                } else {
-                    // Invalid surrogate pair
-                    codePoint = 0xFFFD; // Unicode replacement character
-                }
-            } else {
-                // Truncated surrogate pair
-                codePoint = 0xFFFD; // Unicode replacement character
-            }
-        } else if (codeUnit >= 0xDC00 && codeUnit <= 0xDFFF) {
-            // Lone low surrogate (invalid)
-            codePoint = 0xFFFD; // Unicode replacement character
-        } else {
-            // Regular BMP character
-            codePoint = codeUnit;
-        }
-        
-        // Encode code point as UTF-8
-        if (codePoint <= 0x7F) {
-            // 1-byte sequence (ASCII)
-            result += static_cast<char>(codePoint);
-        } else if (codePoint <= 0x7FF) {
-            // 2-byte sequence
-            result += static_cast<char>(0xC0 | (codePoint >> 6));
-            result += static_cast<char>(0x80 | (codePoint & 0x3F));
-        } else if (codePoint <= 0xFFFF) {
-            // 3-byte sequence
-            result += static_cast<char>(0xE0 | (codePoint >> 12));
-            result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
-            result += static_cast<char>(0x80 | (codePoint & 0x3F));
-        } else if (codePoint <= 0x10FFFF) {
-            // 4-byte sequence
-            result += static_cast<char>(0xF0 | (codePoint >> 18));
-            result += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
-            result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
-            result += static_cast<char>(0x80 | (codePoint & 0x3F));
-        } else {
-            // Invalid code point
-            result += "\xEF\xBF\xBD"; // UTF-8 encoded replacement character (U+FFFD)
-        }
+    // actualLength counts the terminating NUL
+    if (actualLength > 1) {
+        utf16_to_utf8(reinterpret_cast<const uint16_t*>(utf16.data()), static_cast<size_t>(actualLength - 1), utf8);
+        text.assign(utf8);
     }
-    
-    return result;
 #else
-    return "";
+    (void)page;
+    text.clear();
 #endif
 }
 
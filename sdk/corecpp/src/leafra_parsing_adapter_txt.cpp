@@ -1,11 +1,11 @@
 #include "leafra/leafra_parsing.h"
+#include "leafra/leafra_filemanager.h"
 #include "leafra/logger.h"
 
-#include <fstream>
-#include <sstream>
 #include <algorithm>
 #include <filesystem>
 #include <cctype>
+#include <cstring>
 
 namespace leafra {
 
@@ -27,41 +27,128 @@ std::string TextParsingAdapter::getName() const {
     return "TextParsingAdapter";
 }
 
-ParsedDocument TextParsingAdapter::parse(const std::string& filePath) const {
-    ParsedDocument result;
+std::string TextParsingAdapter::getCacheKey() const {
+    return getName() + "/1/" + std::to_string(page_bytes_);
+}
+
+void TextParsingAdapter::configure(const TaskSubmitFunction& submit_task, const ParsingConfig& config) {
+    (void)submit_task;
+    page_bytes_ = config.text_page_bytes > 0 ? static_cast<size_t>(config.text_page_bytes) : 0;
+}
+
+namespace {
+
+// Count '\n' with memchr, which libc vectorizes
+size_t count_lines(std::string_view text) {
+    size_t count = 0;
+    const char* pos = text.data();
+    const char* end = text.data() + text.size();
+    while (pos < end && (pos = static_cast<const char*>(std::memchr(pos, '\n', static_cast<size_t>(end - pos))))) {
+        count++;
+        pos++;
+    }
+    return count;
+}
+
+/**
+ * @brief Length of the next synthetic page of text
+ *
+ * Within the last quarter before target, prefers the start of a Markdown heading, then a
+ * blank line, then any line break; otherwise cuts at target, backed off to a UTF-8 boundary.
+ */
+size_t next_page_length(std::string_view text, size_t target) {
+    if (target == 0 || text.size() <= target) {
+        return text.size();
+    }
+    const size_t floor = target - target / 4;
+    size_t paragraph = 0;
+    size_t line = 0;
+    for (size_t pos = target; pos > floor; --pos) {
+        if (text[pos - 1] != '\n') {
+            continue;
+        }
+        if (text[pos] == '#') {
+            return pos;
+        }
+        if (paragraph == 0 && pos >= 2 && text[pos - 2] == '\n') {
+            paragraph = pos;
+        }
+        if (line == 0) {
+            line = pos;
+        }
+    }
+    if (paragraph > 0) {
+        return paragraph;
+    }
+    if (line > 0) {
+        return line;
+    }
+    size_t cut = target;
+    while (cut > 0 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80) {
+        cut--;
+    }
+    return cut > 0 ? cut : target;
+}
+
+} // namespace
+
+/**
+ * @brief Map the file and hand each synthetic page to sink, filling in result's metadata
+ */
+static bool parseTextFile(const std::string& filePath, size_t pageBytes, ParsedDocument& result, const PageSink& sink) {
     result.filePath = filePath;
     result.fileType = "Text";
     
     LEAFRA_INFO() << "Parsing text file: " << filePath;
     
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
+    FileManager::MappedFile file = FileManager::mapFile(filePath, FileManager::AccessHint::Sequential);
+    if (!file.isOpen()) {
         result.errorMessage = "Failed to open text file: " + filePath;
         LEAFRA_ERROR() << result.errorMessage;
-        return result;
+        return false;
     }
-    
-    // Read the entire file
-    std::ostringstream content;
-    content << file.rdbuf();
-    file.close();
-    
-    std::string fileContent = content.str();
-    
-    // For text files, treat the entire content as one "page"
-    result.pages.push_back(fileContent);
+    const std::string_view content = file.view();
     
     // Extract basic metadata
     std::filesystem::path path(filePath);
     result.title = path.filename().string();
     result.metadata["FileName"] = path.filename().string();
-    result.metadata["FileSize"] = std::to_string(fileContent.length());
-    result.metadata["LineCount"] = std::to_string(std::count(fileContent.begin(), fileContent.end(), '\n') + 1);
-    
+    result.metadata["FileSize"] = std::to_string(content.length());
     result.isValid = true;
     
-    LEAFRA_INFO() << "Successfully parsed text file with " << fileContent.length() << " characters";
+    // Lines are counted page by page, right before the sink reads the same bytes
+    size_t line_count = 1;
+    size_t page_index = 0;
+    for (size_t offset = 0; offset < content.size() || page_index == 0;) {
+        std::string_view page = content.substr(offset, next_page_length(content.substr(offset), pageBytes));
+        line_count += count_lines(page);
+        offset += page.size();
+        bool keep_going = sink(page_index++, page);
+        if (!keep_going || page.empty()) {
+            break;
+        }
+    }
+    result.metadata["LineCount"] = std::to_string(line_count);
     
+    LEAFRA_INFO() << "Successfully parsed text file with " << content.length() << " characters in " << page_index << " pages";
+    return true;
+}
+
+ParsedDocument TextParsingAdapter::parse(const std::string& filePath) const {
+    ParsedDocument result;
+    parseTextFile(filePath, page_bytes_, result, [&result](size_t, std::string_view text) {
+        result.pages.emplace_back(text);
+        return true;
+    });
+    return result;
+}
+
+ParsedDocument TextParsingAdapter::parse(const std::string& filePath, const PageSink& sink) const {
+    ParsedDocument result;
+    parseTextFile(filePath, page_bytes_, result, [&](size_t pageIndex, std::string_view text) {
+        result.streamedPageCount++;
+        return sink(pageIndex, text);
+    });
     return result;
 }
 
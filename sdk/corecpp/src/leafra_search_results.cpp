@@ -0,0 +1,73 @@
+#include "leafra/leafra_search_results.h"
+#include <cstring>
+
+namespace leafra {
+
+static constexpr size_t kDefaultTextBytes = 16 * 1024;   // First arena block when reset() was not told better
+
+SearchResultSet::SearchResultSet() : first_block_bytes_(kDefaultTextBytes) {
+}
+
+SearchResultSet::~SearchResultSet() = default;
+
+SearchResultSet::SearchResultSet(SearchResultSet&&) noexcept = default;
+
+SearchResultSet& SearchResultSet::operator=(SearchResultSet&&) noexcept = default;
+
+void SearchResultSet::reset(size_t hits, size_t text_bytes) {
+    hits_.clear();
+    hits_.reserve(hits);
+    filenames_.clear();
+    // A fresh arena, so the whole text fits in the first block
+    first_block_bytes_ = text_bytes > 0 ? text_bytes : kDefaultTextBytes;
+    arena_.reset();
+}
+
+void SearchResultSet::clear() {
+    hits_.clear();
+    filenames_.clear();
+    arena_.reset();
+}
+
+SearchHit& SearchResultSet::add(int64_t id, float distance) {
+    hits_.emplace_back();
+    SearchHit& hit = hits_.back();
+    hit.id = id;
+    hit.distance = distance;
+    return hit;
+}
+
+std::string_view SearchResultSet::store_text(std::string_view text) {
+    if (text.empty()) {
+        return std::string_view();
+    }
+    if (!arena_) {
+        arena_ = std::make_unique<MonotonicArena>(first_block_bytes_);
+    }
+    char* copy = static_cast<char*>(arena_->allocate(text.size(), 1));
+    std::memcpy(copy, text.data(), text.size());
+    return std::string_view(copy, text.size());
+}
+
+std::string_view SearchResultSet::intern_filename(int64_t doc_id, std::string_view filename) {
+    for (const auto& entry : filenames_) {
+        if (entry.first == doc_id) {
+            return entry.second;
+        }
+    }
+    std::string_view stored = store_text(filename);
+    filenames_.emplace_back(doc_id, stored);
+    return stored;
+}
+
+size_t SearchResultSet::text_bytes() const {
+    return arena_ ? arena_->bytes_used() : 0;
+}
+
+size_t SearchResultSet::memory_bytes() const {
+    return (arena_ ? arena_->memory_bytes() : 0) +
+           hits_.capacity() * sizeof(SearchHit) +
+           filenames_.capacity() * sizeof(filenames_[0]);
+}
+
+} // namespace leafra
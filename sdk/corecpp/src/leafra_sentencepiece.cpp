@@ -1,6 +1,8 @@
 #include "leafra/leafra_sentencepiece.h"
 #include "leafra/types.h"
 #include "leafra/logger.h"
+#include "leafra/leafra_filemanager.h"
+#include "leafra/leafra_model_registry.h"
 
 #ifdef LEAFRA_HAS_SENTENCEPIECE
     #include <sentencepiece_processor.h>
@@ -15,6 +17,12 @@ namespace leafra {
 
 #ifdef LEAFRA_HAS_SENTENCEPIECE
 
+// Builds whichever absl::string_view the SentencePiece headers provide (an alias of
+// std::string_view, or a class of its own in older releases)
+static absl::string_view to_absl(std::string_view text) {
+    return absl::string_view(text.data(), text.size());
+}
+
 // Implementation class using PIMPL pattern
 class SentencePieceTokenizer::Impl {
 public:
@@ -31,6 +39,45 @@ public:
     void clear_error() {
         last_error.clear();
     }
+    
+    // Encode without logging or touching last_error, so several threads can share the processor
+    bool encode_ids(absl::string_view text, std::vector<int>& ids,
+                    const SentencePieceTokenizer::TokenizeOptions& options, std::string& error) const {
+        const bool e5_vocabulary = config.model_name == "multilingual-e5-small";
+        if (options.enable_sampling) {
+            const auto status = processor.SampleEncode(text, options.nbest_size, options.alpha, &ids);
+            if (!status.ok()) {
+                error = "Failed to sample encode as IDs: " + status.ToString();
+                ids.clear();
+                return false;
+            }
+        } else {
+            const auto status = processor.Encode(text, &ids);
+            if (!status.ok()) {
+                error = "Failed to encode as IDs: " + status.ToString();
+                ids.clear();
+                return false;
+            }
+            if (e5_vocabulary) {
+                // HACK: Huggingface multilingual-e5-small ids are one greater than the SentencePiece model's
+                for (auto& id : ids) {
+                    id = id + 1;
+                }
+            }
+        }
+        
+        // Special tokens per the Huggingface tokenizer.json for multilingual-e5-small (BOS 0, EOS 2)
+        if (options.add_bos) {
+            ids.insert(ids.begin(), e5_vocabulary ? 0 : processor.bos_id());
+        }
+        if (options.add_eos) {
+            ids.push_back(e5_vocabulary ? 2 : processor.eos_id());
+        }
+        if (options.reverse) {
+            std::reverse(ids.begin(), ids.end());
+        }
+        return true;
+    }
 };
 
 #else
@@ -80,7 +127,30 @@ bool SentencePieceTokenizer::load_model(const TokenizerConfig& config) {
         return false;
     }
     
-    const auto status = pImpl->processor.Load(config.model_path);
+    // Parsed straight from a mapping of the file instead of being read into a string first
+    FileManager::MappedFile mapped = FileManager::mapFile(config.model_path);
+    if (!mapped.isOpen()) {
+        pImpl->set_error("Failed to open model file: " + config.model_path);
+        pImpl->loaded = false;
+        pImpl->config = TokenizerConfig();  // Clear config on failure
+        return false;
+    }
+    if (!load_model_from_memory(mapped.view(), config)) {
+        return false;
+    }
+    LEAFRA_INFO() << "Model path: " << config.model_path;
+    return true;
+#else
+    pImpl->set_error("SentencePiece not available");
+    return false;
+#endif
+}
+
+bool SentencePieceTokenizer::load_model_from_memory(std::string_view serialized_model, const TokenizerConfig& config) {
+#ifdef LEAFRA_HAS_SENTENCEPIECE
+    pImpl->clear_error();
+    
+    const auto status = pImpl->processor.LoadFromSerializedProto(to_absl(serialized_model));
     if (!status.ok()) {
         pImpl->set_error("Failed to load model: " + status.ToString());
         pImpl->loaded = false;
@@ -90,17 +160,35 @@ bool SentencePieceTokenizer::load_model(const TokenizerConfig& config) {
     
     pImpl->loaded = true;
     pImpl->config = config;  // Save the tokenizer config
-    LEAFRA_INFO() << "SentencePiece model loaded successfully";
-    LEAFRA_INFO() << "Model path: " << config.model_path;
+    LEAFRA_INFO() << "SentencePiece model loaded successfully (" << serialized_model.size() << " bytes)";
     LEAFRA_INFO() << "Vocabulary size: " << pImpl->processor.GetPieceSize();
     
     return true;
 #else
+    (void)serialized_model;
+    (void)config;
     pImpl->set_error("SentencePiece not available");
     return false;
 #endif
 }
 
+std::shared_ptr<const SentencePieceTokenizer> SentencePieceTokenizer::acquire_shared(const TokenizerConfig& config) {
+    if (config.model_path.empty()) {
+        return nullptr;
+    }
+    // model_name is part of the key: it changes the IDs encode produces
+    const std::string key = config.model_path + '\n' + config.model_name;
+    bool shared = false;
+    auto tokenizer = ModelRegistry<const SentencePieceTokenizer>::instance().acquire(key, [&]() {
+        auto loaded = std::make_shared<SentencePieceTokenizer>();
+        return loaded->load_model(config) ? std::shared_ptr<const SentencePieceTokenizer>(loaded) : nullptr;
+    }, &shared);
+    if (shared) {
+        LEAFRA_INFO() << "SentencePiece model shared with another instance: " << config.model_path;
+    }
+    return tokenizer;
+}
+
 bool SentencePieceTokenizer::is_loaded() const {
     return pImpl->loaded;
 }
@@ -116,7 +204,7 @@ int SentencePieceTokenizer::get_vocab_size() const {
 #endif
 }
 
-std::vector<std::string> SentencePieceTokenizer::encode(const std::string& text, const TokenizeOptions& options) const {
+std::vector<std::string> SentencePieceTokenizer::encode(std::string_view text, const TokenizeOptions& options) const {
 #ifdef LEAFRA_HAS_SENTENCEPIECE
     if (!pImpl->loaded) {
         pImpl->set_error("No model loaded");
@@ -126,13 +214,13 @@ std::vector<std::string> SentencePieceTokenizer::encode(const std::string& text,
     std::vector<std::string> pieces;
     
     if (options.enable_sampling) {
-        const auto status = pImpl->processor.SampleEncode(text, options.nbest_size, options.alpha, &pieces);
+        const auto status = pImpl->processor.SampleEncode(to_absl(text), options.nbest_size, options.alpha, &pieces);
         if (!status.ok()) {
             pImpl->set_error("Failed to sample encode: " + status.ToString());
             return {};
         }
     } else {
-        const auto status = pImpl->processor.Encode(text, &pieces);
+        const auto status = pImpl->processor.Encode(to_absl(text), &pieces);
         if (!status.ok()) {
             pImpl->set_error("Failed to encode: " + status.ToString());
             return {};
@@ -153,79 +241,187 @@ std::vector<std::string> SentencePieceTokenizer::encode(const std::string& text,
     //LEAFRA_DEBUG() << "Encoded text '" << text << "' into " << pieces.size() << " pieces";
     return pieces;
 #else
+    (void)text;
+    (void)options;
     pImpl->set_error("SentencePiece not available");
     return {};
 #endif
 }
 
-std::vector<int> SentencePieceTokenizer::encode_as_ids(const std::string& text, const TokenizeOptions& options) const {
+std::vector<int> SentencePieceTokenizer::encode_as_ids(std::string_view text, const TokenizeOptions& options) const {
+    std::vector<int> ids;
+    if (!encode_as_ids(text, ids, options)) {
+        return {};
+    }
+    return ids;
+}
+
+bool SentencePieceTokenizer::encode_as_ids(std::string_view text, std::vector<int>& ids, const TokenizeOptions& options) const {
+    ids.clear();
 #ifdef LEAFRA_HAS_SENTENCEPIECE
     if (!pImpl->loaded) {
         pImpl->set_error("No model loaded");
-        return {};
-    }
-    
-    std::vector<int> ids;
-    
-    if (options.enable_sampling) {
-        const auto status = pImpl->processor.SampleEncode(text, options.nbest_size, options.alpha, &ids);
-        if (!status.ok()) {
-            pImpl->set_error("Failed to sample encode as IDs: " + status.ToString());
-            return {};
-        }
-    } else {
-        const auto status = pImpl->processor.Encode(text, &ids);
-        if (pImpl->config.model_name == "multilingual-e5-small") {
-            LEAFRA_INFO() << "HACK for Huggingface multilingual-e5-small - TODO FIX THIS - incrementing ids by 1 to match huggingface model";
-            for (auto& id : ids) {
-                id = id + 1;
-            }
-        }
-        if (!status.ok()) {
-            pImpl->set_error("Failed to encode as IDs: " + status.ToString());
-            return {};
-        }
+        return false;
     }
     
     // TODO AD IMPORTANT: It turns out that the sentencepiece model is slightly different than the huggingface model (tokenizer.json)
     // The special words are different. And the token ids are one greater (likely due to an extra token in the special vocabulary at the beginning)
     // I am hardcoding the special words here based on this correctly for the multilingual_e5_small
     // The right way to fix this is likely using the json model directly - or at least for the special words use that file.    
-    // // Apply additional options
     if (pImpl->config.model_name == "multilingual-e5-small") {
-            LEAFRA_INFO() << "HACK for Huggingface multilingual-e5-small - TODO FIX THIS";
+            LEAFRA_INFO() << "HACK for Huggingface multilingual-e5-small - TODO FIX THIS - incrementing ids by 1 to match huggingface model";
             LEAFRA_INFO() << "Here's the special characters per sentencepiece model: BOS:\t" << pImpl->processor.bos_id() << " EOS:\t" << pImpl->processor.eos_id() << " UNK:\t" << pImpl->processor.unk_id() << " PAD:\t" << pImpl->processor.pad_id();
             LEAFRA_INFO() << "Here's the special characters per huggingface model: BOS:\t0 EOS:\t2 UNK:\t3 PAD:\t1";
     }
-    if (options.add_bos) {
-        if (pImpl->config.model_name == "multilingual-e5-small") {
-            LEAFRA_INFO() << "HACK: Adding BOS token hardcoded (0) for multilingual_e5_small - this is a hack to fix the token ids";
-            ids.insert(ids.begin(), 0);
-        }
-        else {
-            LEAFRA_INFO() << "Adding BOS token using the sentencepiece model - this is the default behavior";
-            ids.insert(ids.begin(), pImpl->processor.bos_id());
+    
+    std::string error;
+    if (!pImpl->encode_ids(to_absl(text), ids, options, error)) {
+        pImpl->set_error(error);
+        return false;
+    }
+    
+    //LEAFRA_DEBUG() << "Encoded text '" << text << "' into " << ids.size() << " token IDs";
+    return true;
+#else
+    (void)text;
+    (void)options;
+    pImpl->set_error("SentencePiece not available");
+    return false;
+#endif
+}
+
+bool SentencePieceTokenizer::encode_batch_as_ids(const std::vector<std::string_view>& texts, const std::string& prefix,
+                                                 IdBatch& out, const TaskSubmitFunction& submit_task,
+                                                 const TokenizeOptions& options) const {
+    out.ids.clear();
+    out.offsets.assign(1, 0);
+#ifdef LEAFRA_HAS_SENTENCEPIECE
+    if (!pImpl->loaded) {
+        pImpl->set_error("No model loaded");
+        return false;
+    }
+    if (texts.empty()) {
+        return true;
+    }
+    
+    // With splice_prefix the prefix carries BOS and each text EOS, and their IDs are joined per text
+    const bool splice = options.splice_prefix && !prefix.empty();
+    TokenizeOptions prefix_options = options;
+    TokenizeOptions text_options = options;
+    std::vector<int> prefix_ids;
+    if (splice) {
+        prefix_options.add_eos = false;
+        prefix_options.reverse = false;
+        text_options.add_bos = false;
+        text_options.reverse = false;
+        std::string error;
+        if (!pImpl->encode_ids(to_absl(prefix), prefix_ids, prefix_options, error)) {
+            pImpl->set_error(error);
+            return false;
         }
     }
-    if (options.add_eos) {
-        if (pImpl->config.model_name == "multilingual-e5-small") {
-            LEAFRA_INFO() << "HACK: Adding EOS token hardcoded (2) for multilingual_e5_small - this is a hack to fix the token ids";
-            ids.push_back(2); // per json model 
+    
+    // Consecutive texts form a block; each block collects its IDs in its own buffer, and the
+    // buffers are packed in order once every block is done
+    constexpr size_t kTextsPerBlock = 32;
+    struct Block {
+        std::vector<int> ids;
+        std::vector<size_t> lengths;
+        std::string error;
+    };
+    const size_t block_count = (texts.size() + kTextsPerBlock - 1) / kTextsPerBlock;
+    std::vector<Block> blocks(block_count);
+    const Impl& impl = *pImpl;
+    
+    parallel_for_each(submit_task, block_count, [&](size_t b) {
+        Block& block = blocks[b];
+        const size_t first = b * kTextsPerBlock;
+        const size_t last = std::min(texts.size(), first + kTextsPerBlock);
+        block.lengths.reserve(last - first);
+        std::string input = splice ? std::string() : prefix;   // Prefix stays, the text after it is replaced for each item
+        std::vector<int> ids;
+        for (size_t i = first; i < last; ++i) {
+            const size_t sequence_start = block.ids.size();
+            if (splice) {
+                if (!impl.encode_ids(to_absl(texts[i]), ids, text_options, block.error)) {
+                    return;
+                }
+                block.ids.insert(block.ids.end(), prefix_ids.begin(), prefix_ids.end());
+                block.ids.insert(block.ids.end(), ids.begin(), ids.end());
+                if (options.reverse) {
+                    std::reverse(block.ids.begin() + sequence_start, block.ids.end());
+                }
+            } else {
+                input.resize(prefix.size());
+                input.append(texts[i].data(), texts[i].size());
+                if (!impl.encode_ids(input, ids, options, block.error)) {
+                    return;
+                }
+                block.ids.insert(block.ids.end(), ids.begin(), ids.end());
+            }
+            block.lengths.push_back(block.ids.size() - sequence_start);
+        }
+    });
+    
+    size_t total_ids = 0;
+    for (const Block& block : blocks) {
+        if (!block.error.empty()) {
+            pImpl->set_error(block.error);
+            return false;
         }
-        else {
-            LEAFRA_INFO() << "Adding EOS token using the sentencepiece model - this is the default behavior";
-            ids.push_back(pImpl->processor.eos_id());
+        total_ids += block.ids.size();
+    }
+    out.ids.reserve(total_ids);
+    out.offsets.reserve(texts.size() + 1);
+    for (const Block& block : blocks) {
+        out.ids.insert(out.ids.end(), block.ids.begin(), block.ids.end());
+        for (size_t length : block.lengths) {
+            out.offsets.push_back(out.offsets.back() + length);
         }
     }
-    if (options.reverse) {
-        std::reverse(ids.begin(), ids.end());
+    return true;
+#else
+    (void)texts;
+    (void)prefix;
+    (void)submit_task;
+    (void)options;
+    pImpl->set_error("SentencePiece not available");
+    return false;
+#endif
+}
+
+bool SentencePieceTokenizer::encode_with_offsets(std::string_view text, std::vector<int>& ids,
+                                                 std::vector<std::pair<size_t, size_t>>& offsets) const {
+    ids.clear();
+    offsets.clear();
+#ifdef LEAFRA_HAS_SENTENCEPIECE
+    if (!pImpl->loaded) {
+        pImpl->set_error("No model loaded");
+        return false;
     }
     
-    //LEAFRA_DEBUG() << "Encoded text '" << text << "' into " << ids.size() << " token IDs";
-    return ids;
+    sentencepiece::ImmutableSentencePieceText spt;
+    const auto status = pImpl->processor.Encode(to_absl(text), &spt);
+    if (!status.ok()) {
+        pImpl->set_error("Failed to encode with offsets: " + status.ToString());
+        return false;
+    }
+    
+    // Same id shift as encode_as_ids for the Huggingface multilingual-e5-small vocabulary
+    const int id_shift = pImpl->config.model_name == "multilingual-e5-small" ? 1 : 0;
+    const size_t count = spt.pieces_size();
+    ids.reserve(count);
+    offsets.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto piece = spt.pieces(static_cast<int>(i));
+        ids.push_back(static_cast<int>(piece.id()) + id_shift);
+        offsets.emplace_back(piece.begin(), piece.end());
+    }
+    return true;
 #else
+    (void)text;
     pImpl->set_error("SentencePiece not available");
-    return {};
+    return false;
 #endif
 }
 
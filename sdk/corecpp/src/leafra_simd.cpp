@@ -0,0 +1,1555 @@
+#include "leafra/leafra_simd.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LEAFRA_SIMD_NEON 1
+#elif defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#define LEAFRA_SIMD_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC accepts every intrinsic in every function; the CPU check alone guards them
+#define LEAFRA_TARGET_AVX2
+#define LEAFRA_TARGET_AVX512
+#else
+// Only these functions are compiled for the wider instruction sets, so the rest of
+// the library stays runnable on any x86-64 CPU
+#define LEAFRA_TARGET_AVX2 __attribute__((target("avx2,fma,f16c")))
+#define LEAFRA_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx2,fma,f16c")))
+#endif
+#endif
+
+namespace leafra {
+namespace simd {
+
+namespace {
+
+// One entry per kernel the instruction sets implement; everything else is built on these
+struct Kernels {
+    float (*dot)(const float* a, const float* b, size_t count);
+    float (*squared_l2)(const float* a, const float* b, size_t count);
+    void (*scale)(const float* values, float* out, size_t count, float factor);
+    // Element-wise out += values and out = max(out, values), the token pooling steps
+    void (*accumulate)(const float* values, float* out, size_t count);
+    void (*maximum)(const float* values, float* out, size_t count);
+    // Query against four rows at once, each query load shared by the four
+    void (*dot4)(const float* query, const float* const* rows, size_t count, float* out);
+    void (*half_to_float)(const uint16_t* in, float* out, size_t count);
+    void (*float_to_half)(const float* in, uint16_t* out, size_t count);
+    float (*dot_f16)(const float* a, const uint16_t* b, size_t count);
+    float (*squared_norm_f16)(const uint16_t* values, size_t count);
+    int32_t (*dot_i8)(const int8_t* a, const int8_t* b, size_t count);
+    float (*dot_f32_i8)(const float* a, const int8_t* b, size_t count);
+    void (*dequantize_i8)(const int8_t* in, float scale, float* out, size_t count);
+    float (*max_abs)(const float* values, size_t count);
+    float (*max_value)(const float* values, size_t count);
+    float (*min_value)(const float* values, size_t count);
+    uint32_t (*hamming)(const uint8_t* a, const uint8_t* b, size_t size);
+};
+
+// ==============================================================================
+// Scalar
+// ==============================================================================
+
+uint16_t scalar_float_to_half(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xffu);
+    uint32_t mantissa = bits & 0x7fffffu;
+
+    if (exponent == 0xff) {
+        // Inf stays inf, NaN stays a (quiet) NaN
+        return static_cast<uint16_t>(sign | 0x7c00u | (mantissa ? 0x200u : 0u));
+    }
+
+    const int32_t half_exponent = exponent - 127 + 15;
+    if (half_exponent >= 0x1f) {
+        return static_cast<uint16_t>(sign | 0x7c00u);
+    }
+
+    if (half_exponent <= 0) {
+        // Subnormal half (or zero when even the leading bit shifts out)
+        if (half_exponent < -10) {
+            return sign;
+        }
+        mantissa |= 0x800000u;
+        const uint32_t shift = static_cast<uint32_t>(14 - half_exponent);
+        uint32_t half_mantissa = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        const uint32_t halfway = 1u << (shift - 1u);
+        if (remainder > halfway || (remainder == halfway && (half_mantissa & 1u))) {
+            half_mantissa++;
+        }
+        return static_cast<uint16_t>(sign | half_mantissa);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(half_exponent) << 10) | (mantissa >> 13);
+    const uint32_t remainder = mantissa & 0x1fffu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+        half++;                             // A carry into the exponent rounds up to the next binade (or inf)
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+float scalar_half_to_float(uint16_t value) {
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    int32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x3ffu;
+    uint32_t bits;
+
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // Normalize the subnormal half into a normal float
+            exponent = 1;
+            while (!(mantissa & 0x400u)) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            mantissa &= 0x3ffu;
+            bits = sign | (static_cast<uint32_t>(exponent + 112) << 23) | (mantissa << 13);
+        }
+    } else if (exponent == 0x1f) {
+        bits = sign | 0x7f800000u | (mantissa << 13);
+    } else {
+        bits = sign | (static_cast<uint32_t>(exponent + 112) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+float scalar_dot(const float* a, const float* b, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+float scalar_squared_l2(const float* a, const float* b, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        float diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+void scalar_scale(const float* values, float* out, size_t count, float factor) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = values[i] * factor;
+    }
+}
+
+void scalar_accumulate(const float* values, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] += values[i];
+    }
+}
+
+void scalar_maximum(const float* values, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = std::max(out[i], values[i]);
+    }
+}
+
+void scalar_dot4(const float* query, const float* const* rows, size_t count, float* out) {
+    for (size_t r = 0; r < 4; ++r) {
+        out[r] = scalar_dot(query, rows[r], count);
+    }
+}
+
+void scalar_half_to_float_n(const uint16_t* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = scalar_half_to_float(in[i]);
+    }
+}
+
+void scalar_float_to_half_n(const float* in, uint16_t* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = scalar_float_to_half(in[i]);
+    }
+}
+
+float scalar_dot_f16(const float* a, const uint16_t* b, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        sum += a[i] * scalar_half_to_float(b[i]);
+    }
+    return sum;
+}
+
+float scalar_squared_norm_f16(const uint16_t* values, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        float value = scalar_half_to_float(values[i]);
+        sum += value * value;
+    }
+    return sum;
+}
+
+int32_t scalar_dot_i8(const int8_t* a, const int8_t* b, size_t count) {
+    int32_t sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += static_cast<int32_t>(a[i]) * static_cast<int32_t>(b[i]);
+    }
+    return sum;
+}
+
+float scalar_dot_f32_i8(const float* a, const int8_t* b, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        sum += a[i] * static_cast<float>(b[i]);
+    }
+    return sum;
+}
+
+void scalar_dequantize_i8(const int8_t* in, float scale, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]) * scale;
+    }
+}
+
+float scalar_max_abs(const float* values, size_t count) {
+    float result = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        result = std::max(result, std::fabs(values[i]));
+    }
+    return result;
+}
+
+float scalar_max_value(const float* values, size_t count) {
+    float result = -std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i < count; ++i) {
+        result = std::max(result, values[i]);
+    }
+    return result;
+}
+
+float scalar_min_value(const float* values, size_t count) {
+    float result = std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i < count; ++i) {
+        result = std::min(result, values[i]);
+    }
+    return result;
+}
+
+inline uint32_t popcount64(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_popcountll(value));
+#else
+    value = value - ((value >> 1) & 0x5555555555555555ULL);
+    value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+    value = (value + (value >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<uint32_t>((value * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+uint32_t scalar_hamming(const uint8_t* a, const uint8_t* b, size_t size) {
+    uint32_t result = 0;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t x;
+        uint64_t y;
+        std::memcpy(&x, a + i, sizeof(x));
+        std::memcpy(&y, b + i, sizeof(y));
+        result += popcount64(x ^ y);
+    }
+    for (; i < size; ++i) {
+        result += popcount64(static_cast<uint64_t>(a[i] ^ b[i]));
+    }
+    return result;
+}
+
+const Kernels kScalarKernels = {
+    scalar_dot, scalar_squared_l2, scalar_scale, scalar_accumulate, scalar_maximum, scalar_dot4,
+    scalar_half_to_float_n, scalar_float_to_half_n, scalar_dot_f16, scalar_squared_norm_f16,
+    scalar_dot_i8, scalar_dot_f32_i8, scalar_dequantize_i8,
+    scalar_max_abs, scalar_max_value, scalar_min_value,
+    scalar_hamming
+};
+
+// ==============================================================================
+// NEON
+// ==============================================================================
+
+#if defined(LEAFRA_SIMD_NEON)
+
+inline float32x4_t neon_fma(float32x4_t acc, float32x4_t a, float32x4_t b) {
+#if defined(__aarch64__)
+    return vfmaq_f32(acc, a, b);
+#else
+    return vmlaq_f32(acc, a, b);
+#endif
+}
+
+inline float neon_sum(float32x4_t v) {
+#if defined(__aarch64__)
+    return vaddvq_f32(v);
+#else
+    float32x2_t pair = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(pair, pair), 0);
+#endif
+}
+
+inline int32_t neon_sum(int32x4_t v) {
+#if defined(__aarch64__)
+    return vaddvq_s32(v);
+#else
+    int32x2_t pair = vadd_s32(vget_low_s32(v), vget_high_s32(v));
+    return vget_lane_s32(vpadd_s32(pair, pair), 0);
+#endif
+}
+
+inline float neon_max(float32x4_t v) {
+#if defined(__aarch64__)
+    return vmaxvq_f32(v);
+#else
+    float32x2_t pair = vmax_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpmax_f32(pair, pair), 0);
+#endif
+}
+
+inline float neon_min(float32x4_t v) {
+#if defined(__aarch64__)
+    return vminvq_f32(v);
+#else
+    float32x2_t pair = vmin_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpmin_f32(pair, pair), 0);
+#endif
+}
+
+// Eight int8 lanes widened to two float vectors
+inline void neon_widen_i8(const int8_t* in, float32x4_t& low, float32x4_t& high) {
+    int16x8_t wide = vmovl_s8(vld1_s8(in));
+    low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(wide)));
+    high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(wide)));
+}
+
+float neon_dot(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    // Two accumulators hide the multiply-add latency
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= count; i += 8) {
+        acc0 = neon_fma(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = neon_fma(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    float sum = neon_sum(vaddq_f32(acc0, acc1));
+    for (; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+float neon_squared_l2(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t d0 = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        float32x4_t d1 = vsubq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        acc0 = neon_fma(acc0, d0, d0);
+        acc1 = neon_fma(acc1, d1, d1);
+    }
+    float sum = neon_sum(vaddq_f32(acc0, acc1));
+    for (; i < count; ++i) {
+        float diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+void neon_scale(const float* values, float* out, size_t count, float factor) {
+    size_t i = 0;
+    const float32x4_t f = vdupq_n_f32(factor);
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vmulq_f32(vld1q_f32(values + i), f));
+    }
+    for (; i < count; ++i) {
+        out[i] = values[i] * factor;
+    }
+}
+
+void neon_accumulate(const float* values, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vaddq_f32(vld1q_f32(out + i), vld1q_f32(values + i)));
+    }
+    for (; i < count; ++i) {
+        out[i] += values[i];
+    }
+}
+
+void neon_maximum(const float* values, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vmaxq_f32(vld1q_f32(out + i), vld1q_f32(values + i)));
+    }
+    for (; i < count; ++i) {
+        out[i] = std::max(out[i], values[i]);
+    }
+}
+
+void neon_dot4(const float* query, const float* const* rows, size_t count, float* out) {
+    size_t i = 0;
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    float32x4_t acc2 = vdupq_n_f32(0.0f);
+    float32x4_t acc3 = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t q = vld1q_f32(query + i);
+        acc0 = neon_fma(acc0, q, vld1q_f32(rows[0] + i));
+        acc1 = neon_fma(acc1, q, vld1q_f32(rows[1] + i));
+        acc2 = neon_fma(acc2, q, vld1q_f32(rows[2] + i));
+        acc3 = neon_fma(acc3, q, vld1q_f32(rows[3] + i));
+    }
+    out[0] = neon_sum(acc0);
+    out[1] = neon_sum(acc1);
+    out[2] = neon_sum(acc2);
+    out[3] = neon_sum(acc3);
+    for (; i < count; ++i) {
+        for (size_t r = 0; r < 4; ++r) {
+            out[r] += query[i] * rows[r][i];
+        }
+    }
+}
+
+#if defined(__aarch64__)
+// Half conversion instructions are part of the AArch64 base; 32-bit ARM keeps the scalar ones
+
+void neon_half_to_float(const uint16_t* in, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(in + i))));
+    }
+    for (; i < count; ++i) {
+        out[i] = scalar_half_to_float(in[i]);
+    }
+}
+
+void neon_float_to_half(const float* in, uint16_t* out, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1_u16(out + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(in + i))));
+    }
+    for (; i < count; ++i) {
+        out[i] = scalar_float_to_half(in[i]);
+    }
+}
+
+float neon_dot_f16(const float* a, const uint16_t* b, size_t count) {
+    size_t i = 0;
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= count; i += 8) {
+        acc0 = neon_fma(acc0, vld1q_f32(a + i), vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(b + i))));
+        acc1 = neon_fma(acc1, vld1q_f32(a + i + 4), vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(b + i + 4))));
+    }
+    float sum = neon_sum(vaddq_f32(acc0, acc1));
+    for (; i < count; ++i) {
+        sum += a[i] * scalar_half_to_float(b[i]);
+    }
+    return sum;
+}
+
+float neon_squared_norm_f16(const uint16_t* values, size_t count) {
+    size_t i = 0;
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(values + i)));
+        acc = neon_fma(acc, v, v);
+    }
+    float sum = neon_sum(acc);
+    for (; i < count; ++i) {
+        float value = scalar_half_to_float(values[i]);
+        sum += value * value;
+    }
+    return sum;
+}
+
+#endif
+
+int32_t neon_dot_i8(const int8_t* a, const int8_t* b, size_t count) {
+    size_t i = 0;
+    int32x4_t acc = vdupq_n_s32(0);
+    for (; i + 16 <= count; i += 16) {
+        int8x16_t va = vld1q_s8(a + i);
+        int8x16_t vb = vld1q_s8(b + i);
+#if defined(__ARM_FEATURE_DOTPROD)
+        acc = vdotq_s32(acc, va, vb);
+#else
+        // int8 * int8 fits int16; pairs are widened into the int32 accumulator
+        acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(va), vget_low_s8(vb)));
+        acc = vpadalq_s16(acc, vmull_s8(vget_high_s8(va), vget_high_s8(vb)));
+#endif
+    }
+    int32_t sum = neon_sum(acc);
+    for (; i < count; ++i) {
+        sum += static_cast<int32_t>(a[i]) * static_cast<int32_t>(b[i]);
+    }
+    return sum;
+}
+
+float neon_dot_f32_i8(const float* a, const int8_t* b, size_t count) {
+    size_t i = 0;
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t low, high;
+        neon_widen_i8(b + i, low, high);
+        acc0 = neon_fma(acc0, vld1q_f32(a + i), low);
+        acc1 = neon_fma(acc1, vld1q_f32(a + i + 4), high);
+    }
+    float sum = neon_sum(vaddq_f32(acc0, acc1));
+    for (; i < count; ++i) {
+        sum += a[i] * static_cast<float>(b[i]);
+    }
+    return sum;
+}
+
+void neon_dequantize_i8(const int8_t* in, float scale, float* out, size_t count) {
+    size_t i = 0;
+    const float32x4_t f = vdupq_n_f32(scale);
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t low, high;
+        neon_widen_i8(in + i, low, high);
+        vst1q_f32(out + i, vmulq_f32(low, f));
+        vst1q_f32(out + i + 4, vmulq_f32(high, f));
+    }
+    for (; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]) * scale;
+    }
+}
+
+float neon_max_abs(const float* values, size_t count) {
+    size_t i = 0;
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4) {
+        acc = vmaxq_f32(acc, vabsq_f32(vld1q_f32(values + i)));
+    }
+    float result = neon_max(acc);
+    for (; i < count; ++i) {
+        result = std::max(result, std::fabs(values[i]));
+    }
+    return result;
+}
+
+float neon_max_value(const float* values, size_t count) {
+    size_t i = 0;
+    float32x4_t acc = vdupq_n_f32(-std::numeric_limits<float>::infinity());
+    for (; i + 4 <= count; i += 4) {
+        acc = vmaxq_f32(acc, vld1q_f32(values + i));
+    }
+    float result = neon_max(acc);
+    for (; i < count; ++i) {
+        result = std::max(result, values[i]);
+    }
+    return result;
+}
+
+float neon_min_value(const float* values, size_t count) {
+    size_t i = 0;
+    float32x4_t acc = vdupq_n_f32(std::numeric_limits<float>::infinity());
+    for (; i + 4 <= count; i += 4) {
+        acc = vminq_f32(acc, vld1q_f32(values + i));
+    }
+    float result = neon_min(acc);
+    for (; i < count; ++i) {
+        result = std::min(result, values[i]);
+    }
+    return result;
+}
+
+uint32_t neon_hamming(const uint8_t* a, const uint8_t* b, size_t size) {
+    size_t i = 0;
+    uint32x4_t acc = vdupq_n_u32(0);
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t bits = vcntq_u8(veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+        acc = vpadalq_u16(acc, vpaddlq_u8(bits));
+    }
+    uint32_t result = static_cast<uint32_t>(neon_sum(vreinterpretq_s32_u32(acc)));
+    return result + scalar_hamming(a + i, b + i, size - i);
+}
+
+const Kernels kNeonKernels = {
+    neon_dot, neon_squared_l2, neon_scale, neon_accumulate, neon_maximum, neon_dot4,
+#if defined(__aarch64__)
+    neon_half_to_float, neon_float_to_half, neon_dot_f16, neon_squared_norm_f16,
+#else
+    scalar_half_to_float_n, scalar_float_to_half_n, scalar_dot_f16, scalar_squared_norm_f16,
+#endif
+    neon_dot_i8, neon_dot_f32_i8, neon_dequantize_i8,
+    neon_max_abs, neon_max_value, neon_min_value,
+    neon_hamming
+};
+
+#endif // LEAFRA_SIMD_NEON
+
+// ==============================================================================
+// AVX2 (+ FMA, F16C)
+// ==============================================================================
+
+#if defined(LEAFRA_SIMD_X86)
+
+LEAFRA_TARGET_AVX2 inline float avx2_sum(__m256 v) {
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_movehdup_ps(half));
+    return _mm_cvtss_f32(half);
+}
+
+LEAFRA_TARGET_AVX2 inline int32_t avx2_sum(__m256i v) {
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(half);
+}
+
+LEAFRA_TARGET_AVX2 inline float avx2_max(__m256 v) {
+    __m128 half = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    half = _mm_max_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_max_ss(half, _mm_movehdup_ps(half));
+    return _mm_cvtss_f32(half);
+}
+
+LEAFRA_TARGET_AVX2 inline float avx2_min(__m256 v) {
+    __m128 half = _mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    half = _mm_min_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_min_ss(half, _mm_movehdup_ps(half));
+    return _mm_cvtss_f32(half);
+}
+
+// Eight int8 lanes widened to floats
+LEAFRA_TARGET_AVX2 inline __m256 avx2_load_i8(const int8_t* in) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in))));
+}
+
+LEAFRA_TARGET_AVX2 inline __m256 avx2_load_f16(const uint16_t* in) {
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)));
+}
+
+LEAFRA_TARGET_AVX2 float avx2_dot(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= count; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    if (i + 8 <= count) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        i += 8;
+    }
+    float sum = avx2_sum(_mm256_add_ps(acc0, acc1));
+    for (; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+LEAFRA_TARGET_AVX2 float avx2_squared_l2(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= count; i += 16) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        acc0 = _mm256_fmadd_ps(d0, d0, acc0);
+        acc1 = _mm256_fmadd_ps(d1, d1, acc1);
+    }
+    if (i + 8 <= count) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        acc0 = _mm256_fmadd_ps(d0, d0, acc0);
+        i += 8;
+    }
+    float sum = avx2_sum(_mm256_add_ps(acc0, acc1));
+    for (; i < count; ++i) {
+        float diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+LEAFRA_TARGET_AVX2 void avx2_scale(const float* values, float* out, size_t count, float factor) {
+    size_t i = 0;
+    const __m256 f = _mm256_set1_ps(factor);
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(values + i), f));
+    }
+    for (; i < count; ++i) {
+        out[i] = values[i] * factor;
+    }
+}
+
+LEAFRA_TARGET_AVX2 void avx2_accumulate(const float* values, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_loadu_ps(values + i)));
+    }
+    for (; i < count; ++i) {
+        out[i] += values[i];
+    }
+}
+
+LEAFRA_TARGET_AVX2 void avx2_maximum(const float* values, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_max_ps(_mm256_loadu_ps(out + i), _mm256_loadu_ps(values + i)));
+    }
+    for (; i < count; ++i) {
+        out[i] = std::max(out[i], values[i]);
+    }
+}
+
+LEAFRA_TARGET_AVX2 void avx2_dot4(const float* query, const float* const* rows, size_t count, float* out) {
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps();
+    __m256 acc3 = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        __m256 q = _mm256_loadu_ps(query + i);
+        acc0 = _mm256_fmadd_ps(q, _mm256_loadu_ps(rows[0] + i), acc0);
+        acc1 = _mm256_fmadd_ps(q, _mm256_loadu_ps(rows[1] + i), acc1);
+        acc2 = _mm256_fmadd_ps(q, _mm256_loadu_ps(rows[2] + i), acc2);
+        acc3 = _mm256_fmadd_ps(q, _mm256_loadu_ps(rows[3] + i), acc3);
+    }
+    out[0] = avx2_sum(acc0);
+    out[1] = avx2_sum(acc1);
+    out[2] = avx2_sum(acc2);
+    out[3] = avx2_sum(acc3);
+    for (; i < count; ++i) {
+        for (size_t r = 0; r < 4; ++r) {
+            out[r] += query[i] * rows[r][i];
+        }
+    }
+}
+
+LEAFRA_TARGET_AVX2 void avx2_half_to_float(const uint16_t* in, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out + i, avx2_load_f16(in + i));
+    }
+    for (; i < count; ++i) {
+        out[i] = scalar_half_to_float(in[i]);
+    }
+}
+
+LEAFRA_TARGET_AVX2 void avx2_float_to_half(const float* in, uint16_t* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+    }
+    for (; i < count; ++i) {
+        out[i] = scalar_float_to_half(in[i]);
+    }
+}
+
+LEAFRA_TARGET_AVX2 float avx2_dot_f16(const float* a, const uint16_t* b, size_t count) {
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= count; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), avx2_load_f16(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), avx2_load_f16(b + i + 8), acc1);
+    }
+    if (i + 8 <= count) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), avx2_load_f16(b + i), acc0);
+        i += 8;
+    }
+    float sum = avx2_sum(_mm256_add_ps(acc0, acc1));
+    for (; i < count; ++i) {
+        sum += a[i] * scalar_half_to_float(b[i]);
+    }
+    return sum;
+}
+
+LEAFRA_TARGET_AVX2 float avx2_squared_norm_f16(const uint16_t* values, size_t count) {
+    size_t i = 0;
+    __m256 acc = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = avx2_load_f16(values + i);
+        acc = _mm256_fmadd_ps(v, v, acc);
+    }
+    float sum = avx2_sum(acc);
+    for (; i < count; ++i) {
+        float value = scalar_half_to_float(values[i]);
+        sum += value * value;
+    }
+    return sum;
+}
+
+LEAFRA_TARGET_AVX2 int32_t avx2_dot_i8(const int8_t* a, const int8_t* b, size_t count) {
+    size_t i = 0;
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 16 <= count; i += 16) {
+        // Widened to int16, multiplied and summed pairwise into int32 (int8 products can't overflow a pair)
+        __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+    int32_t sum = avx2_sum(acc);
+    for (; i < count; ++i) {
+        sum += static_cast<int32_t>(a[i]) * static_cast<int32_t>(b[i]);
+    }
+    return sum;
+}
+
+LEAFRA_TARGET_AVX2 float avx2_dot_f32_i8(const float* a, const int8_t* b, size_t count) {
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= count; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), avx2_load_i8(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), avx2_load_i8(b + i + 8), acc1);
+    }
+    if (i + 8 <= count) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), avx2_load_i8(b + i), acc0);
+        i += 8;
+    }
+    float sum = avx2_sum(_mm256_add_ps(acc0, acc1));
+    for (; i < count; ++i) {
+        sum += a[i] * static_cast<float>(b[i]);
+    }
+    return sum;
+}
+
+LEAFRA_TARGET_AVX2 void avx2_dequantize_i8(const int8_t* in, float scale, float* out, size_t count) {
+    size_t i = 0;
+    const __m256 f = _mm256_set1_ps(scale);
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(avx2_load_i8(in + i), f));
+    }
+    for (; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]) * scale;
+    }
+}
+
+LEAFRA_TARGET_AVX2 float avx2_max_abs(const float* values, size_t count) {
+    size_t i = 0;
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 acc = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        acc = _mm256_max_ps(acc, _mm256_andnot_ps(sign, _mm256_loadu_ps(values + i)));
+    }
+    float result = avx2_max(acc);
+    for (; i < count; ++i) {
+        result = std::max(result, std::fabs(values[i]));
+    }
+    return result;
+}
+
+LEAFRA_TARGET_AVX2 float avx2_max_value(const float* values, size_t count) {
+    size_t i = 0;
+    __m256 acc = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+    for (; i + 8 <= count; i += 8) {
+        acc = _mm256_max_ps(acc, _mm256_loadu_ps(values + i));
+    }
+    float result = avx2_max(acc);
+    for (; i < count; ++i) {
+        result = std::max(result, values[i]);
+    }
+    return result;
+}
+
+LEAFRA_TARGET_AVX2 float avx2_min_value(const float* values, size_t count) {
+    size_t i = 0;
+    __m256 acc = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    for (; i + 8 <= count; i += 8) {
+        acc = _mm256_min_ps(acc, _mm256_loadu_ps(values + i));
+    }
+    float result = avx2_min(acc);
+    for (; i < count; ++i) {
+        result = std::min(result, values[i]);
+    }
+    return result;
+}
+
+// Per-byte popcount by nibble lookup, summed per 64-bit lane with SAD
+LEAFRA_TARGET_AVX2 uint32_t avx2_hamming(const uint8_t* a, const uint8_t* b, size_t size) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i bits = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, _mm256_and_si256(bits, low_mask)),
+                                         _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(bits, 4), low_mask)));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum));
+    uint32_t result = static_cast<uint32_t>(_mm_cvtsi128_si32(sum));
+    return result + scalar_hamming(a + i, b + i, size - i);
+}
+
+const Kernels kAvx2Kernels = {
+    avx2_dot, avx2_squared_l2, avx2_scale, avx2_accumulate, avx2_maximum, avx2_dot4,
+    avx2_half_to_float, avx2_float_to_half, avx2_dot_f16, avx2_squared_norm_f16,
+    avx2_dot_i8, avx2_dot_f32_i8, avx2_dequantize_i8,
+    avx2_max_abs, avx2_max_value, avx2_min_value,
+    avx2_hamming
+};
+
+// ==============================================================================
+// AVX-512 (F + BW)
+// ==============================================================================
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC's own AVX-512 headers trip its uninitialized warnings (_mm512_undefined_ps)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+LEAFRA_TARGET_AVX512 inline __m512 avx512_load_i8(const int8_t* in) {
+    return _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))));
+}
+
+LEAFRA_TARGET_AVX512 inline __m512 avx512_load_f16(const uint16_t* in) {
+    return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in)));
+}
+
+LEAFRA_TARGET_AVX512 float avx512_dot(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    for (; i + 32 <= count; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    }
+    if (i + 16 <= count) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        i += 16;
+    }
+    float sum = _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    for (; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+LEAFRA_TARGET_AVX512 float avx512_squared_l2(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    for (; i + 32 <= count; i += 32) {
+        __m512 d0 = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        __m512 d1 = _mm512_sub_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16));
+        acc0 = _mm512_fmadd_ps(d0, d0, acc0);
+        acc1 = _mm512_fmadd_ps(d1, d1, acc1);
+    }
+    if (i + 16 <= count) {
+        __m512 d0 = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        acc0 = _mm512_fmadd_ps(d0, d0, acc0);
+        i += 16;
+    }
+    float sum = _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    for (; i < count; ++i) {
+        float diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+LEAFRA_TARGET_AVX512 void avx512_scale(const float* values, float* out, size_t count, float factor) {
+    size_t i = 0;
+    const __m512 f = _mm512_set1_ps(factor);
+    for (; i + 16 <= count; i += 16) {
+        _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_loadu_ps(values + i), f));
+    }
+    for (; i < count; ++i) {
+        out[i] = values[i] * factor;
+    }
+}
+
+LEAFRA_TARGET_AVX512 void avx512_accumulate(const float* values, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm512_storeu_ps(out + i, _mm512_add_ps(_mm512_loadu_ps(out + i), _mm512_loadu_ps(values + i)));
+    }
+    for (; i < count; ++i) {
+        out[i] += values[i];
+    }
+}
+
+LEAFRA_TARGET_AVX512 void avx512_maximum(const float* values, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm512_storeu_ps(out + i, _mm512_max_ps(_mm512_loadu_ps(out + i), _mm512_loadu_ps(values + i)));
+    }
+    for (; i < count; ++i) {
+        out[i] = std::max(out[i], values[i]);
+    }
+}
+
+LEAFRA_TARGET_AVX512 void avx512_dot4(const float* query, const float* const* rows, size_t count, float* out) {
+    size_t i = 0;
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    __m512 acc2 = _mm512_setzero_ps();
+    __m512 acc3 = _mm512_setzero_ps();
+    for (; i + 16 <= count; i += 16) {
+        __m512 q = _mm512_loadu_ps(query + i);
+        acc0 = _mm512_fmadd_ps(q, _mm512_loadu_ps(rows[0] + i), acc0);
+        acc1 = _mm512_fmadd_ps(q, _mm512_loadu_ps(rows[1] + i), acc1);
+        acc2 = _mm512_fmadd_ps(q, _mm512_loadu_ps(rows[2] + i), acc2);
+        acc3 = _mm512_fmadd_ps(q, _mm512_loadu_ps(rows[3] + i), acc3);
+    }
+    out[0] = _mm512_reduce_add_ps(acc0);
+    out[1] = _mm512_reduce_add_ps(acc1);
+    out[2] = _mm512_reduce_add_ps(acc2);
+    out[3] = _mm512_reduce_add_ps(acc3);
+    for (; i < count; ++i) {
+        for (size_t r = 0; r < 4; ++r) {
+            out[r] += query[i] * rows[r][i];
+        }
+    }
+}
+
+LEAFRA_TARGET_AVX512 void avx512_half_to_float(const uint16_t* in, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm512_storeu_ps(out + i, avx512_load_f16(in + i));
+    }
+    for (; i < count; ++i) {
+        out[i] = scalar_half_to_float(in[i]);
+    }
+}
+
+LEAFRA_TARGET_AVX512 void avx512_float_to_half(const float* in, uint16_t* out, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtps_ph(_mm512_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+    }
+    for (; i < count; ++i) {
+        out[i] = scalar_float_to_half(in[i]);
+    }
+}
+
+LEAFRA_TARGET_AVX512 float avx512_dot_f16(const float* a, const uint16_t* b, size_t count) {
+    size_t i = 0;
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    for (; i + 32 <= count; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), avx512_load_f16(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), avx512_load_f16(b + i + 16), acc1);
+    }
+    if (i + 16 <= count) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), avx512_load_f16(b + i), acc0);
+        i += 16;
+    }
+    float sum = _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    for (; i < count; ++i) {
+        sum += a[i] * scalar_half_to_float(b[i]);
+    }
+    return sum;
+}
+
+LEAFRA_TARGET_AVX512 float avx512_squared_norm_f16(const uint16_t* values, size_t count) {
+    size_t i = 0;
+    __m512 acc = _mm512_setzero_ps();
+    for (; i + 16 <= count; i += 16) {
+        __m512 v = avx512_load_f16(values + i);
+        acc = _mm512_fmadd_ps(v, v, acc);
+    }
+    float sum = _mm512_reduce_add_ps(acc);
+    for (; i < count; ++i) {
+        float value = scalar_half_to_float(values[i]);
+        sum += value * value;
+    }
+    return sum;
+}
+
+LEAFRA_TARGET_AVX512 int32_t avx512_dot_i8(const int8_t* a, const int8_t* b, size_t count) {
+    size_t i = 0;
+    __m512i acc = _mm512_setzero_si512();
+    for (; i + 32 <= count; i += 32) {
+        __m512i va = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+        __m512i vb = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        acc = _mm512_add_epi32(acc, _mm512_madd_epi16(va, vb));
+    }
+    int32_t sum = _mm512_reduce_add_epi32(acc);
+    for (; i < count; ++i) {
+        sum += static_cast<int32_t>(a[i]) * static_cast<int32_t>(b[i]);
+    }
+    return sum;
+}
+
+LEAFRA_TARGET_AVX512 float avx512_dot_f32_i8(const float* a, const int8_t* b, size_t count) {
+    size_t i = 0;
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    for (; i + 32 <= count; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), avx512_load_i8(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), avx512_load_i8(b + i + 16), acc1);
+    }
+    if (i + 16 <= count) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), avx512_load_i8(b + i), acc0);
+        i += 16;
+    }
+    float sum = _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    for (; i < count; ++i) {
+        sum += a[i] * static_cast<float>(b[i]);
+    }
+    return sum;
+}
+
+LEAFRA_TARGET_AVX512 void avx512_dequantize_i8(const int8_t* in, float scale, float* out, size_t count) {
+    size_t i = 0;
+    const __m512 f = _mm512_set1_ps(scale);
+    for (; i + 16 <= count; i += 16) {
+        _mm512_storeu_ps(out + i, _mm512_mul_ps(avx512_load_i8(in + i), f));
+    }
+    for (; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]) * scale;
+    }
+}
+
+LEAFRA_TARGET_AVX512 float avx512_max_abs(const float* values, size_t count) {
+    size_t i = 0;
+    const __m512i magnitude = _mm512_set1_epi32(0x7fffffff);
+    __m512 acc = _mm512_setzero_ps();
+    for (; i + 16 <= count; i += 16) {
+        __m512i bits = _mm512_and_si512(_mm512_castps_si512(_mm512_loadu_ps(values + i)), magnitude);
+        acc = _mm512_max_ps(acc, _mm512_castsi512_ps(bits));
+    }
+    float result = _mm512_reduce_max_ps(acc);
+    for (; i < count; ++i) {
+        result = std::max(result, std::fabs(values[i]));
+    }
+    return result;
+}
+
+LEAFRA_TARGET_AVX512 float avx512_max_value(const float* values, size_t count) {
+    size_t i = 0;
+    __m512 acc = _mm512_set1_ps(-std::numeric_limits<float>::infinity());
+    for (; i + 16 <= count; i += 16) {
+        acc = _mm512_max_ps(acc, _mm512_loadu_ps(values + i));
+    }
+    float result = _mm512_reduce_max_ps(acc);
+    for (; i < count; ++i) {
+        result = std::max(result, values[i]);
+    }
+    return result;
+}
+
+LEAFRA_TARGET_AVX512 float avx512_min_value(const float* values, size_t count) {
+    size_t i = 0;
+    __m512 acc = _mm512_set1_ps(std::numeric_limits<float>::infinity());
+    for (; i + 16 <= count; i += 16) {
+        acc = _mm512_min_ps(acc, _mm512_loadu_ps(values + i));
+    }
+    float result = _mm512_reduce_min_ps(acc);
+    for (; i < count; ++i) {
+        result = std::min(result, values[i]);
+    }
+    return result;
+}
+
+const Kernels kAvx512Kernels = {
+    avx512_dot, avx512_squared_l2, avx512_scale, avx512_accumulate, avx512_maximum, avx512_dot4,
+    avx512_half_to_float, avx512_float_to_half, avx512_dot_f16, avx512_squared_norm_f16,
+    avx512_dot_i8, avx512_dot_f32_i8, avx512_dequantize_i8,
+    avx512_max_abs, avx512_max_value, avx512_min_value,
+    avx2_hamming  // Short codes (48 bytes for 384 dimensions) gain nothing from 64-byte vectors
+};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// CPU (and OS register state) support, checked once
+struct X86Features {
+    bool avx2 = false;
+    bool avx512 = false;
+};
+
+X86Features detectX86Features() {
+    X86Features features;
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {0, 0, 0, 0};
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    __cpuid(info, 1);
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool f16c = (info[2] & (1 << 29)) != 0;
+    if (!osxsave || max_leaf < 7) {
+        return features;
+    }
+    const unsigned long long xcr0 = _xgetbv(0);
+    const bool ymm_state = (xcr0 & 0x6) == 0x6;
+    const bool zmm_state = (xcr0 & 0xe6) == 0xe6;
+    __cpuidex(info, 7, 0);
+    const bool avx2 = (info[1] & (1 << 5)) != 0;
+    const bool avx512f = (info[1] & (1 << 16)) != 0;
+    const bool avx512bw = (info[1] & (1 << 30)) != 0;
+    features.avx2 = ymm_state && avx2 && fma && f16c;
+    features.avx512 = features.avx2 && zmm_state && avx512f && avx512bw;
+#else
+    // libgcc / compiler-rt also check that the OS saves the wider registers
+    __builtin_cpu_init();
+    features.avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c");
+    features.avx512 = features.avx2 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+    return features;
+}
+
+const X86Features& x86Features() {
+    static const X86Features features = detectX86Features();
+    return features;
+}
+
+#endif // LEAFRA_SIMD_X86
+
+// ==============================================================================
+// Dispatch
+// ==============================================================================
+
+bool isSupported(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR:
+            return true;
+#if defined(LEAFRA_SIMD_NEON)
+        case Isa::NEON:
+            return true;
+#endif
+#if defined(LEAFRA_SIMD_X86)
+        case Isa::AVX2:
+            return x86Features().avx2;
+        case Isa::AVX512:
+            return x86Features().avx512;
+#endif
+        default:
+            return false;
+    }
+}
+
+const Kernels* kernelsFor(Isa isa) {
+    switch (isa) {
+#if defined(LEAFRA_SIMD_NEON)
+        case Isa::NEON:
+            return &kNeonKernels;
+#endif
+#if defined(LEAFRA_SIMD_X86)
+        case Isa::AVX2:
+            return &kAvx2Kernels;
+        case Isa::AVX512:
+            return &kAvx512Kernels;
+#endif
+        default:
+            return &kScalarKernels;
+    }
+}
+
+std::atomic<const Kernels*> g_kernels{nullptr};
+std::atomic<int32_t> g_active_isa{static_cast<int32_t>(Isa::SCALAR)};
+
+const Kernels& kernels() {
+    const Kernels* active = g_kernels.load(std::memory_order_acquire);
+    if (!active) {
+        // Racing first calls all pick the same table
+        Isa isa = detected_isa();
+        active = kernelsFor(isa);
+        g_active_isa.store(static_cast<int32_t>(isa), std::memory_order_relaxed);
+        g_kernels.store(active, std::memory_order_release);
+    }
+    return *active;
+}
+
+// Rows are handed to the four-row kernel in groups; the rest go one by one
+template <typename RowAt>
+void dotRows(const float* query, RowAt row_at, size_t count, size_t dimension, float* out) {
+    const Kernels& k = kernels();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const float* rows[4] = {row_at(i), row_at(i + 1), row_at(i + 2), row_at(i + 3)};
+        k.dot4(query, rows, dimension, out + i);
+    }
+    for (; i < count; ++i) {
+        out[i] = k.dot(query, row_at(i), dimension);
+    }
+}
+
+} // namespace
+
+Isa detected_isa() {
+#if defined(LEAFRA_SIMD_NEON)
+    return Isa::NEON;
+#elif defined(LEAFRA_SIMD_X86)
+    const X86Features& features = x86Features();
+    return features.avx512 ? Isa::AVX512 : features.avx2 ? Isa::AVX2 : Isa::SCALAR;
+#else
+    return Isa::SCALAR;
+#endif
+}
+
+Isa active_isa() {
+    kernels();
+    return static_cast<Isa>(g_active_isa.load(std::memory_order_relaxed));
+}
+
+bool set_active_isa(Isa isa) {
+    if (!isSupported(isa)) {
+        return false;
+    }
+    g_active_isa.store(static_cast<int32_t>(isa), std::memory_order_relaxed);
+    g_kernels.store(kernelsFor(isa), std::memory_order_release);
+    return true;
+}
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR: return "scalar";
+        case Isa::NEON: return "NEON";
+        case Isa::AVX2: return "AVX2";
+        case Isa::AVX512: return "AVX-512";
+        default: return "unknown";
+    }
+}
+
+float dot(const float* a, const float* b, size_t count) {
+    return kernels().dot(a, b, count);
+}
+
+float squared_norm(const float* values, size_t count) {
+    return kernels().dot(values, values, count);
+}
+
+float squared_l2(const float* a, const float* b, size_t count) {
+    return kernels().squared_l2(a, b, count);
+}
+
+void scale(const float* values, float* out, size_t count, float factor) {
+    kernels().scale(values, out, count, factor);
+}
+
+bool l2_normalize(float* values, size_t count) {
+    return l2_normalize(values, values, count);
+}
+
+bool l2_normalize(const float* values, float* out, size_t count) {
+    const Kernels& k = kernels();
+    float norm_sq = k.dot(values, values, count);
+    if (!(norm_sq > 0.0f) || !std::isfinite(norm_sq)) {
+        if (out != values) {
+            std::memcpy(out, values, count * sizeof(float));
+        }
+        return false;
+    }
+    k.scale(values, out, count, 1.0f / std::sqrt(norm_sq));
+    return true;
+}
+
+void l2_normalize_rows(float* values, size_t rows, size_t dimension) {
+    for (size_t row = 0; row < rows; ++row) {
+        l2_normalize(values + row * dimension, dimension);
+    }
+}
+
+bool pool_tokens(const float* token_states, const int32_t* mask, size_t tokens, size_t dimension,
+                 Pooling pooling, bool normalize, float* out) {
+    const Kernels& k = kernels();
+    size_t pooled = 0;
+    for (size_t t = 0; t < tokens; ++t) {
+        if (mask && mask[t] == 0) {
+            continue;
+        }
+        const float* token_state = token_states + t * dimension;
+        if (pooled == 0) {
+            std::memcpy(out, token_state, dimension * sizeof(float));
+        } else if (pooling == Pooling::MAX) {
+            k.maximum(token_state, out, dimension);
+        } else {
+            k.accumulate(token_state, out, dimension);
+        }
+        pooled++;
+        if (pooling == Pooling::CLS) {
+            break;
+        }
+    }
+    if (pooled == 0) {
+        std::fill(out, out + dimension, 0.0f);
+        return false;
+    }
+
+    // Normalizing a sum gives the normalized mean, so a fused mean never divides by the count
+    if (normalize) {
+        return l2_normalize(out, dimension);
+    }
+    if (pooling == Pooling::MEAN && pooled > 1) {
+        k.scale(out, out, dimension, 1.0f / static_cast<float>(pooled));
+    }
+    return true;
+} //pool_tokens
+
+void dot_batch(const float* query, const float* rows, size_t count, size_t dimension, float* out) {
+    dotRows(query, [rows, dimension](size_t i) { return rows + i * dimension; }, count, dimension, out);
+}
+
+void dot_batch(const float* query, const float* const* rows, size_t count, size_t dimension, float* out) {
+    dotRows(query, [rows](size_t i) { return rows[i]; }, count, dimension, out);
+}
+
+void squared_l2_batch(const float* query, const float* rows, size_t count, size_t dimension, float* out) {
+    const Kernels& k = kernels();
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = k.squared_l2(query, rows + i * dimension, dimension);
+    }
+}
+
+void squared_l2_batch(const float* query, const float* const* rows, size_t count, size_t dimension, float* out) {
+    const Kernels& k = kernels();
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = k.squared_l2(query, rows[i], dimension);
+    }
+}
+
+uint16_t float_to_half(float value) {
+    return scalar_float_to_half(value);
+}
+
+float half_to_float(uint16_t value) {
+    return scalar_half_to_float(value);
+}
+
+void half_to_float(const uint16_t* in, float* out, size_t count) {
+    kernels().half_to_float(in, out, count);
+}
+
+void float_to_half(const float* in, uint16_t* out, size_t count) {
+    kernels().float_to_half(in, out, count);
+}
+
+float dot_f16(const float* a, const uint16_t* b, size_t count) {
+    return kernels().dot_f16(a, b, count);
+}
+
+float squared_norm_f16(const uint16_t* values, size_t count) {
+    return kernels().squared_norm_f16(values, count);
+}
+
+void dot_batch_f16(const float* query, const uint16_t* rows, size_t count, size_t dimension, float* out) {
+    const Kernels& k = kernels();
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = k.dot_f16(query, rows + i * dimension, dimension);
+    }
+}
+
+int32_t dot_i8(const int8_t* a, const int8_t* b, size_t count) {
+    return kernels().dot_i8(a, b, count);
+}
+
+float dot_f32_i8(const float* a, const int8_t* b, size_t count) {
+    return kernels().dot_f32_i8(a, b, count);
+}
+
+void dot_batch_i8(const float* query, const int8_t* rows, const float* scales, size_t count, size_t dimension,
+                  float* out) {
+    const Kernels& k = kernels();
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = k.dot_f32_i8(query, rows + i * dimension, dimension) * scales[i];
+    }
+}
+
+void dequantize_i8(const int8_t* in, float scale, float* out, size_t count) {
+    kernels().dequantize_i8(in, scale, out, count);
+}
+
+float max_abs(const float* values, size_t count) {
+    return kernels().max_abs(values, count);
+}
+
+uint32_t hamming(const uint8_t* a, const uint8_t* b, size_t size) {
+    return kernels().hamming(a, b, size);
+}
+
+void hamming_batch(const uint8_t* query, const uint8_t* codes, size_t count, size_t code_size, uint32_t* out) {
+    const Kernels& k = kernels();
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = k.hamming(query, codes + i * code_size, code_size);
+    }
+}
+
+void top_k(const float* scores, size_t count, size_t k, bool largest, std::vector<uint32_t>& indices) {
+    // Blocks whose best score can't beat the current k-th are skipped after one vector pass
+    static constexpr size_t kBlockSize = 64;
+    indices.clear();
+    k = std::min(k, count);
+    if (k == 0) {
+        return;
+    }
+    const Kernels& kern = kernels();
+    auto better = [scores, largest](uint32_t a, uint32_t b) {
+        if (scores[a] != scores[b]) {
+            return largest ? scores[a] > scores[b] : scores[a] < scores[b];
+        }
+        return a < b;
+    };
+    auto beats = [largest](float score, float threshold) {
+        return largest ? score > threshold : score < threshold;
+    };
+
+    // Heap of the best k so far, worst on top (later indices lose ties, so they must beat it strictly)
+    indices.reserve(k);
+    for (size_t i = 0; i < k; ++i) {
+        indices.push_back(static_cast<uint32_t>(i));
+    }
+    std::make_heap(indices.begin(), indices.end(), better);
+    float threshold = scores[indices.front()];
+
+    size_t i = k;
+    while (i < count) {
+        const size_t end = std::min(count, i + kBlockSize);
+        float extreme = largest ? kern.max_value(scores + i, end - i) : kern.min_value(scores + i, end - i);
+        if (beats(extreme, threshold)) {
+            for (; i < end; ++i) {
+                if (beats(scores[i], threshold)) {
+                    std::pop_heap(indices.begin(), indices.end(), better);
+                    indices.back() = static_cast<uint32_t>(i);
+                    std::push_heap(indices.begin(), indices.end(), better);
+                    threshold = scores[indices.front()];
+                }
+            }
+        }
+        i = end;
+    }
+    std::sort_heap(indices.begin(), indices.end(), better);
+}
+
+size_t argmax(const float* values, size_t count) {
+    if (count == 0) {
+        return count;
+    }
+    const float best = kernels().max_value(values, count);
+    for (size_t i = 0; i < count; ++i) {
+        if (values[i] == best) {
+            return i;
+        }
+    }
+    // NaNs hide the maximum from the vector pass
+    size_t best_index = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (values[i] > values[best_index] || std::isnan(values[best_index])) {
+            best_index = i;
+        }
+    }
+    return best_index;
+}
+
+} // namespace simd
+} // namespace leafra
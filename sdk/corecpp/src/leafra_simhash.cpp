@@ -0,0 +1,174 @@
+#include "leafra/leafra_simhash.h"
+#include <algorithm>
+#include <array>
+
+namespace leafra {
+
+namespace {
+
+// splitmix64 finalizer: spreads shingle hashes over all 64 bits before they vote
+inline uint64_t mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+inline bool is_word_byte(unsigned char c) {
+    unsigned char lower = c | 0x20;
+    return c >= 0x80 || (c >= '0' && c <= '9') || (lower >= 'a' && lower <= 'z');
+}
+
+} // anonymous namespace
+
+uint64_t SimHash::fingerprint(std::string_view text, size_t shingle_words) {
+    shingle_words = std::max<size_t>(1, shingle_words);
+
+    // Word hashes (FNV-1a over the case-folded word), kept in a ring of the last shingle_words
+    std::array<int32_t, 64> votes{};
+    std::vector<uint64_t> window(shingle_words, 0);
+    size_t words = 0;
+    auto vote = [&votes](uint64_t shingle) {
+        uint64_t bits = mix(shingle);
+        for (size_t b = 0; b < 64; ++b) {
+            votes[b] += static_cast<int32_t>((bits >> b) & 1) * 2 - 1;
+        }
+    };
+    auto shingle_hash = [&]() {
+        uint64_t hash = 0;
+        for (size_t j = 0; j < shingle_words; ++j) {
+            hash = (hash ^ window[(words + j) % shingle_words]) * 1099511628211ULL;
+        }
+        return hash;
+    };
+
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(text.data());
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !is_word_byte(s[i])) {
+            ++i;
+        }
+        if (i >= text.size()) {
+            break;
+        }
+        uint64_t hash = 14695981039346656037ULL;
+        while (i < text.size() && is_word_byte(s[i])) {
+            unsigned char c = s[i] < 0x80 ? static_cast<unsigned char>(s[i] | 0x20) : s[i];
+            hash = (hash ^ c) * 1099511628211ULL;
+            ++i;
+        }
+        window[words % shingle_words] = hash;
+        ++words;
+        if (words >= shingle_words) {
+            vote(shingle_hash());
+        }
+    }
+    if (words == 0) {
+        return 0;
+    }
+    if (words < shingle_words) {
+        uint64_t hash = 0;
+        for (size_t j = 0; j < words; ++j) {
+            hash = (hash ^ window[j]) * 1099511628211ULL;
+        }
+        vote(hash);
+    }
+
+    uint64_t result = 0;
+    for (size_t b = 0; b < 64; ++b) {
+        if (votes[b] > 0) {
+            result |= 1ULL << b;
+        }
+    }
+    return result == 0 ? 1 : result;
+}
+
+int32_t SimHash::distance(uint64_t a, uint64_t b) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<int32_t>(__builtin_popcountll(a ^ b));
+#else
+    uint64_t x = a ^ b;
+    int32_t count = 0;
+    while (x) {
+        x &= x - 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+NearDuplicateIndex::NearDuplicateIndex(int32_t max_distance)
+    : max_distance_(std::max<int32_t>(0, std::min<int32_t>(max_distance, 15))) {
+    // max_distance + 1 bands of (nearly) equal width covering all 64 bits
+    const uint32_t band_count = static_cast<uint32_t>(max_distance_) + 1;
+    uint32_t shift = 0;
+    for (uint32_t band = 0; band < band_count; ++band) {
+        uint32_t width = 64 / band_count + (band < 64 % band_count ? 1 : 0);
+        Band entry;
+        entry.shift = shift;
+        entry.mask = width >= 64 ? ~0ULL : ((1ULL << width) - 1);
+        bands_.push_back(std::move(entry));
+        shift += width;
+    }
+}
+
+void NearDuplicateIndex::add(uint64_t fingerprint, int64_t id) {
+    if (fingerprint == 0) {
+        return;
+    }
+    const uint32_t index = static_cast<uint32_t>(entries_.size());
+    entries_.push_back({fingerprint, id});
+    for (Band& band : bands_) {
+        band.buckets[(fingerprint >> band.shift) & band.mask].push_back(index);
+    }
+}
+
+void NearDuplicateIndex::find(uint64_t fingerprint, std::vector<Match>& matches, size_t max_results) const {
+    matches.clear();
+    if (fingerprint == 0 || max_results == 0) {
+        return;
+    }
+    candidates_.clear();
+    for (const Band& band : bands_) {
+        auto bucket = band.buckets.find((fingerprint >> band.shift) & band.mask);
+        if (bucket != band.buckets.end()) {
+            candidates_.insert(candidates_.end(), bucket->second.begin(), bucket->second.end());
+        }
+    }
+    std::sort(candidates_.begin(), candidates_.end());
+    candidates_.erase(std::unique(candidates_.begin(), candidates_.end()), candidates_.end());
+
+    for (uint32_t index : candidates_) {
+        int32_t distance = SimHash::distance(fingerprint, entries_[index].fingerprint);
+        if (distance <= max_distance_) {
+            matches.push_back({entries_[index].id, distance});
+        }
+    }
+    // Candidates are in insertion order, so a stable sort keeps the earliest entry first among ties
+    std::stable_sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) { return a.distance < b.distance; });
+    if (matches.size() > max_results) {
+        matches.resize(max_results);
+    }
+}
+
+size_t NearDuplicateIndex::memory_bytes() const {
+    size_t bytes = entries_.capacity() * sizeof(Entry);
+    for (const Band& band : bands_) {
+        bytes += band.buckets.size() * (sizeof(uint64_t) + sizeof(std::vector<uint32_t>) + 2 * sizeof(void*));
+        for (const auto& bucket : band.buckets) {
+            bytes += bucket.second.capacity() * sizeof(uint32_t);
+        }
+    }
+    return bytes;
+}
+
+void NearDuplicateIndex::clear() {
+    entries_.clear();
+    for (Band& band : bands_) {
+        band.buckets.clear();
+    }
+}
+
+} // namespace leafra
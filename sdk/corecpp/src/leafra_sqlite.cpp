@@ -1,6 +1,10 @@
 #include "leafra/leafra_sqlite.h"
 #include "leafra/logger.h"
 #include "leafra/leafra_filemanager.h"
+#include "leafra/leafra_cache.h"
+#include "leafra/leafra_vector_codec.h"
+#include "leafra/leafra_text_codec.h"
+#include "leafra/leafra_simd.h"
 
 #ifdef LEAFRA_HAS_SQLITE
     #ifdef LEAFRA_USE_SYSTEM_SQLITE_HEADERS
@@ -15,11 +19,168 @@
 #include <filesystem>
 #include <sstream>
 #include <algorithm>
+#include <cctype>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <mutex>
 
 namespace leafra {
 
 #ifdef LEAFRA_HAS_SQLITE
 
+namespace {
+
+// Page text as stored: TEXT as is, TextCodec blobs decompressed into scratch
+bool storedText(sqlite3_stmt* stmt, int column, std::string& scratch, std::string_view& text) {
+    if (sqlite3_column_type(stmt, column) != SQLITE_BLOB) {
+        const char* data = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+        text = std::string_view(data ? data : "", static_cast<size_t>(sqlite3_column_bytes(stmt, column)));
+        return true;
+    }
+    const uint8_t* data = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, column));
+    if (!TextCodec::decompress(data, static_cast<size_t>(sqlite3_column_bytes(stmt, column)), scratch)) {
+        return false;
+    }
+    text = scratch;
+    return true;
+}
+
+// Bytes [start, end) of a document's text, put together from the doc_texts pages covering them
+bool readDocumentTextRange(sqlite3* db, int64_t doc_id, int64_t start, int64_t end, std::string& out) {
+    out.clear();
+    if (end <= start) {
+        return end == start;
+    }
+    sqlite3_stmt* stmt = nullptr;
+    const char* sql = "SELECT text_start, page_text FROM doc_texts WHERE doc_id = ?1 AND text_start < ?3 AND "
+                      "text_start >= (SELECT MAX(text_start) FROM doc_texts WHERE doc_id = ?1 AND text_start <= ?2) "
+                      "ORDER BY text_start";
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return false;
+    }
+    sqlite3_bind_int64(stmt, 1, doc_id);
+    sqlite3_bind_int64(stmt, 2, start);
+    sqlite3_bind_int64(stmt, 3, end);
+    
+    out.reserve(static_cast<size_t>(end - start));
+    std::string scratch;
+    int64_t covered = start;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        const int64_t page_start = sqlite3_column_int64(stmt, 0);
+        std::string_view page;
+        if (page_start > covered || !storedText(stmt, 1, scratch, page)) {
+            break;
+        }
+        const int64_t page_end = page_start + static_cast<int64_t>(page.size());
+        if (page_end <= covered) {
+            continue;
+        }
+        const int64_t take_end = std::min(end, page_end);
+        out.append(page.data() + (covered - page_start), static_cast<size_t>(take_end - covered));
+        covered = take_end;
+    }
+    sqlite3_finalize(stmt);
+    return covered == end;
+}
+
+// leafra_chunk_text(x[, doc_id, chunk_start, chunk_end]): the text of a chunk row. Offset rows (chunk_start set)
+// are cut out of their document's doc_texts pages, compressed text (BLOB) is decompressed, anything else passed through.
+void chunkTextFunction(sqlite3_context* context, int argc, sqlite3_value** argv) {
+    if (argc == 4 && sqlite3_value_type(argv[2]) != SQLITE_NULL) {
+        std::string text;
+        if (!readDocumentTextRange(sqlite3_context_db_handle(context), sqlite3_value_int64(argv[1]),
+                                   sqlite3_value_int64(argv[2]), sqlite3_value_int64(argv[3]), text)) {
+            sqlite3_result_error(context, "document text missing for chunk", -1);
+            return;
+        }
+        sqlite3_result_text64(context, text.data(), text.size(), SQLITE_TRANSIENT, SQLITE_UTF8);
+        return;
+    }
+    if (argc < 1 || sqlite3_value_type(argv[0]) != SQLITE_BLOB) {
+        sqlite3_result_value(context, argv[0]);
+        return;
+    }
+    std::string text;
+    const uint8_t* data = static_cast<const uint8_t*>(sqlite3_value_blob(argv[0]));
+    if (!TextCodec::decompress(data, static_cast<size_t>(sqlite3_value_bytes(argv[0])), text)) {
+        sqlite3_result_error(context, "malformed compressed chunk text", -1);
+        return;
+    }
+    sqlite3_result_text64(context, text.data(), text.size(), SQLITE_TRANSIENT, SQLITE_UTF8);
+}
+
+enum class VectorMetric { DOT, L2, COSINE };
+
+const VectorMetric kVectorMetrics[] = {VectorMetric::DOT, VectorMetric::L2, VectorMetric::COSINE};
+const char* const kVectorFunctionNames[] = {"vec_dot", "vec_l2", "vec_cosine"};
+
+// Decoded query argument, kept as auxdata while the statement binds the same value
+struct VectorQuery {
+    std::vector<float> values;
+    float norm = 0.0f;
+};
+
+// vec_dot / vec_l2 / vec_cosine(a, query) over two native fp32 BLOBs, or (embedding, format, byte_order, scale, query)
+// scoring a chunk_embeddings row against a native fp32 query; NULL when the dimensions differ or a row doesn't decode.
+// vec_l2 is the squared distance (what FAISS reports for L2)
+void vectorFunction(sqlite3_context* context, int argc, sqlite3_value** argv) {
+    const VectorMetric metric = *static_cast<const VectorMetric*>(sqlite3_user_data(context));
+    const int query_arg = argc - 1;
+    std::unique_ptr<VectorQuery> decoded;
+    const VectorQuery* query = static_cast<const VectorQuery*>(sqlite3_get_auxdata(context, query_arg));
+    if (!query) {
+        const int bytes = sqlite3_value_bytes(argv[query_arg]);
+        if (sqlite3_value_type(argv[query_arg]) != SQLITE_BLOB || bytes <= 0 || bytes % sizeof(float) != 0) {
+            sqlite3_result_null(context);
+            return;
+        }
+        decoded = std::make_unique<VectorQuery>();
+        decoded->values.resize(static_cast<size_t>(bytes) / sizeof(float));
+        std::memcpy(decoded->values.data(), sqlite3_value_blob(argv[query_arg]), static_cast<size_t>(bytes));
+        decoded->norm = std::sqrt(simd::squared_norm(decoded->values.data(), decoded->values.size()));
+        query = decoded.get();
+    }
+    
+    // Blobs carry no alignment guarantee, so rows are decoded into a per-thread buffer
+    const size_t dimension = query->values.size();
+    thread_local std::vector<float> row;
+    row.resize(dimension);
+    const uint8_t* data = static_cast<const uint8_t*>(sqlite3_value_blob(argv[0]));
+    const size_t size = static_cast<size_t>(sqlite3_value_bytes(argv[0]));
+    bool valid = sqlite3_value_type(argv[0]) == SQLITE_BLOB;
+    if (valid && argc == 2) {
+        valid = size == dimension * sizeof(float);
+        if (valid) {
+            std::memcpy(row.data(), data, size);
+        }
+    } else if (valid) {
+        valid = VectorCodec::decode(static_cast<EmbeddingStorageFormat>(sqlite3_value_int(argv[1])),
+                                    static_cast<ByteOrder>(sqlite3_value_int(argv[2])), static_cast<float>(sqlite3_value_double(argv[3])),
+                                    data, size, row.data(), dimension);
+    }
+    if (!valid) {
+        sqlite3_result_null(context);
+    } else if (metric == VectorMetric::L2) {
+        sqlite3_result_double(context, simd::squared_l2(row.data(), query->values.data(), dimension));
+    } else if (metric == VectorMetric::DOT) {
+        sqlite3_result_double(context, simd::dot(row.data(), query->values.data(), dimension));
+    } else {
+        const float norms = std::sqrt(simd::squared_norm(row.data(), dimension)) * query->norm;
+        sqlite3_result_double(context, norms > 0.0f ? simd::dot(row.data(), query->values.data(), dimension) / norms : 0.0);
+    }
+    
+    // Last: SQLite may free the auxdata right away, e.g. when the argument isn't a constant
+    if (decoded) {
+        sqlite3_set_auxdata(context, query_arg, decoded.release(), [](void* data) { delete static_cast<VectorQuery*>(data); });
+    }
+}
+
+} // anonymous namespace
+
 // ==============================================================================
 // SQLiteDatabase::Row Implementation
 // ==============================================================================
@@ -57,6 +218,22 @@ std::vector<uint8_t> SQLiteDatabase::Row::getBlob(int columnIndex) const {
     return std::vector<uint8_t>();
 }
 
+std::string_view SQLiteDatabase::Row::getTextView(int columnIndex) const {
+    // sqlite3_column_text must come before sqlite3_column_bytes so the size matches the UTF-8 text
+    const unsigned char* text = sqlite3_column_text(stmt_, columnIndex);
+    if (!text) {
+        return std::string_view();
+    }
+    return std::string_view(reinterpret_cast<const char*>(text), static_cast<size_t>(sqlite3_column_bytes(stmt_, columnIndex)));
+}
+
+SQLiteDatabase::BlobView SQLiteDatabase::Row::getBlobView(int columnIndex) const {
+    BlobView view;
+    view.data = static_cast<const uint8_t*>(sqlite3_column_blob(stmt_, columnIndex));
+    view.size = view.data ? static_cast<size_t>(sqlite3_column_bytes(stmt_, columnIndex)) : 0;
+    return view;
+}
+
 bool SQLiteDatabase::Row::isNull(int columnIndex) const {
     return sqlite3_column_type(stmt_, columnIndex) == SQLITE_NULL;
 }
@@ -192,6 +369,28 @@ bool SQLiteDatabase::Statement::bindNull(int paramIndex) {
     return sqlite3_bind_null(stmt_, paramIndex) == SQLITE_OK;
 }
 
+bool SQLiteDatabase::Statement::bindTextView(int paramIndex, std::string_view value) {
+    if (!valid_) return false;
+    // A null data pointer would bind SQL NULL rather than an empty string
+    const char* text = value.data() ? value.data() : "";
+    return sqlite3_bind_text(stmt_, paramIndex, text, static_cast<int>(value.size()), SQLITE_STATIC) == SQLITE_OK;
+}
+
+bool SQLiteDatabase::Statement::bindBlobView(int paramIndex, const void* data, size_t size) {
+    if (!valid_) return false;
+    return sqlite3_bind_blob(stmt_, paramIndex, data, static_cast<int>(size), SQLITE_STATIC) == SQLITE_OK;
+}
+
+bool SQLiteDatabase::Statement::clearBindings() {
+    if (!valid_) return false;
+    return sqlite3_clear_bindings(stmt_) == SQLITE_OK;
+}
+
+bool SQLiteDatabase::Statement::bindZeroBlob(int paramIndex, size_t size) {
+    if (!valid_) return false;
+    return sqlite3_bind_zeroblob64(stmt_, paramIndex, static_cast<sqlite3_uint64>(size)) == SQLITE_OK;
+}
+
 bool SQLiteDatabase::Statement::bindInt(const std::string& paramName, int value) {
     int index = getParameterIndex(paramName);
     return index > 0 ? bindInt(index, value) : false;
@@ -246,6 +445,18 @@ SQLiteDatabase::Row SQLiteDatabase::Statement::getCurrentRow() const {
     return Row(stmt_);
 }
 
+bool SQLiteDatabase::Statement::forEachRow(const std::function<bool(const Row&)>& visitor) {
+    if (!valid_) return false;
+    Row row(stmt_);
+    int result;
+    while ((result = sqlite3_step(stmt_)) == SQLITE_ROW) {
+        if (!visitor(row)) {
+            return true;
+        }
+    }
+    return result == SQLITE_DONE;
+}
+
 int SQLiteDatabase::Statement::getParameterCount() const {
     if (!valid_) return 0;
     return sqlite3_bind_parameter_count(stmt_);
@@ -260,11 +471,253 @@ bool SQLiteDatabase::Statement::isValid() const {
     return valid_;
 }
 
+// Idle prepared statements shared between a database and its outstanding leases
+struct SQLiteDatabase::StatementCache {
+    std::mutex mutex;
+    LRUCache<std::string, std::unique_ptr<Statement>> idle;
+    uint64_t connection = 0;       // Bumped on close so leases from an old connection aren't cached again
+};
+
+// ==============================================================================
+// SQLiteDatabase::CachedStatement Implementation
+// ==============================================================================
+
+SQLiteDatabase::CachedStatement::CachedStatement(std::shared_ptr<StatementCache> cache, std::string sql,
+                                                 std::unique_ptr<Statement> stmt, uint64_t connection)
+    : cache_(cache), sql_(std::move(sql)), stmt_(std::move(stmt)), connection_(connection) {}
+
+SQLiteDatabase::CachedStatement::~CachedStatement() {
+    release();
+}
+
+SQLiteDatabase::CachedStatement::CachedStatement(CachedStatement&& other) noexcept
+    : cache_(std::move(other.cache_)), sql_(std::move(other.sql_)), stmt_(std::move(other.stmt_)),
+      connection_(other.connection_) {}
+
+SQLiteDatabase::CachedStatement& SQLiteDatabase::CachedStatement::operator=(CachedStatement&& other) noexcept {
+    if (this != &other) {
+        release();
+        cache_ = std::move(other.cache_);
+        sql_ = std::move(other.sql_);
+        stmt_ = std::move(other.stmt_);
+        connection_ = other.connection_;
+    }
+    return *this;
+}
+
+void SQLiteDatabase::CachedStatement::release() {
+    if (!stmt_) {
+        return;
+    }
+    auto cache = cache_.lock();
+    if (cache && stmt_->isValid()) {
+        stmt_->reset();
+        stmt_->clearBindings();
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        if (cache->connection == connection_) {
+            cache->idle.put(sql_, std::move(stmt_));
+        }
+    }
+    stmt_.reset();
+}
+
+// ==============================================================================
+// SQLiteDatabase::BulkInsert Implementation
+// ==============================================================================
+
+// Lowest SQLITE_MAX_VARIABLE_NUMBER across the SQLite builds we ship against
+static constexpr size_t kMaxBoundParameters = 999;
+
+SQLiteDatabase::BulkInsert::BulkInsert(SQLiteDatabase& db, const std::string& table,
+                                       const std::vector<std::string>& columns, size_t max_rows_per_statement)
+    : db_(db), table_(table), columns_(columns), rows_per_statement_(1) {
+    if (!columns_.empty()) {
+        rows_per_statement_ = std::max<size_t>(1, std::min(max_rows_per_statement, kMaxBoundParameters / columns_.size()));
+    }
+    values_.reserve(rows_per_statement_ * columns_.size());
+    values_.resize(columns_.size());
+}
+
+SQLiteDatabase::BulkInsert::Value* SQLiteDatabase::BulkInsert::currentValue(size_t column) {
+    if (column >= columns_.size()) {
+        LEAFRA_ERROR() << "Bulk insert column " << column << " out of range for table " << table_;
+        return nullptr;
+    }
+    return &values_[pending_rows_ * columns_.size() + column];
+}
+
+bool SQLiteDatabase::BulkInsert::bindInt64(size_t column, long long value) {
+    Value* slot = currentValue(column);
+    if (!slot) return false;
+    slot->type = ColumnType::Integer;
+    slot->int_value = value;
+    return true;
+}
+
+bool SQLiteDatabase::BulkInsert::bindDouble(size_t column, double value) {
+    Value* slot = currentValue(column);
+    if (!slot) return false;
+    slot->type = ColumnType::Float;
+    slot->double_value = value;
+    return true;
+}
+
+bool SQLiteDatabase::BulkInsert::bindTextView(size_t column, std::string_view value) {
+    Value* slot = currentValue(column);
+    if (!slot) return false;
+    slot->type = ColumnType::Text;
+    slot->data = value.data();
+    slot->size = value.size();
+    return true;
+}
+
+bool SQLiteDatabase::BulkInsert::bindBlobView(size_t column, const void* data, size_t size) {
+    Value* slot = currentValue(column);
+    if (!slot) return false;
+    slot->type = ColumnType::Blob;
+    slot->data = data;
+    slot->size = size;
+    return true;
+}
+
+bool SQLiteDatabase::BulkInsert::bindNull(size_t column) {
+    Value* slot = currentValue(column);
+    if (!slot) return false;
+    *slot = Value();
+    return true;
+}
+
+bool SQLiteDatabase::BulkInsert::endRow() {
+    pending_rows_++;
+    if (pending_rows_ == rows_per_statement_) {
+        return executeBatch(pending_rows_);
+    }
+    values_.resize((pending_rows_ + 1) * columns_.size());
+    return true;
+}
+
+bool SQLiteDatabase::BulkInsert::flush() {
+    return pending_rows_ == 0 || executeBatch(pending_rows_);
+}
+
+bool SQLiteDatabase::BulkInsert::executeBatch(size_t rows) {
+    std::unique_ptr<Statement> tail_statement;
+    Statement* stmt = nullptr;
+    
+    if (rows == rows_per_statement_ && full_statement_.isValid()) {
+        stmt = full_statement_.get();
+    } else {
+        std::string placeholders = "(?";
+        for (size_t i = 1; i < columns_.size(); ++i) {
+            placeholders += ",?";
+        }
+        placeholders += ")";
+        
+        std::string sql = "INSERT INTO " + table_ + " (";
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            sql += (i ? ", " : "") + columns_[i];
+        }
+        sql += ") VALUES " + placeholders;
+        for (size_t i = 1; i < rows; ++i) {
+            sql += ", " + placeholders;
+        }
+        
+        // The full-size statement is leased from the statement cache so it survives across
+        // documents; the remainder statement is sized per call and prepared once
+        if (rows == rows_per_statement_) {
+            full_statement_ = db_.prepareCached(sql);
+            stmt = full_statement_.get();
+        } else {
+            tail_statement = db_.prepare(sql);
+            stmt = tail_statement.get();
+        }
+        if (!stmt || !stmt->isValid()) {
+            LEAFRA_ERROR() << "Failed to prepare bulk insert into " << table_;
+            return false;
+        }
+    }
+    
+    bool bound = true;
+    for (size_t i = 0; i < rows * columns_.size() && bound; ++i) {
+        const Value& value = values_[i];
+        int index = static_cast<int>(i + 1);
+        switch (value.type) {
+            case ColumnType::Integer: bound = stmt->bindInt64(index, value.int_value); break;
+            case ColumnType::Float:   bound = stmt->bindDouble(index, value.double_value); break;
+            case ColumnType::Text:    bound = stmt->bindTextView(index, std::string_view(static_cast<const char*>(value.data), value.size)); break;
+            case ColumnType::Blob:    bound = stmt->bindBlobView(index, value.data, value.size); break;
+            default:                  bound = stmt->bindNull(index); break;
+        }
+    }
+    
+    bool executed = bound && stmt->execute();
+    if (!executed) {
+        LEAFRA_ERROR() << "Bulk insert of " << rows << " rows into " << table_ << " failed: " << db_.getLastErrorMessage();
+    }
+    
+    // Drop the SQLITE_STATIC pointers before the caller's buffers can go away
+    stmt->reset();
+    stmt->clearBindings();
+    
+    pending_rows_ = 0;
+    values_.assign(columns_.size(), Value());
+    if (executed) {
+        rows_inserted_ += rows;
+    }
+    return executed;
+}
+
+// ==============================================================================
+// SQLiteDatabase::BlobHandle Implementation
+// ==============================================================================
+
+SQLiteDatabase::BlobHandle::BlobHandle(sqlite3_blob* blob) : blob_(blob) {}
+
+SQLiteDatabase::BlobHandle::~BlobHandle() {
+    if (blob_) {
+        sqlite3_blob_close(blob_);
+    }
+}
+
+SQLiteDatabase::BlobHandle::BlobHandle(BlobHandle&& other) noexcept : blob_(other.blob_) {
+    other.blob_ = nullptr;
+}
+
+SQLiteDatabase::BlobHandle& SQLiteDatabase::BlobHandle::operator=(BlobHandle&& other) noexcept {
+    if (this != &other) {
+        if (blob_) {
+            sqlite3_blob_close(blob_);
+        }
+        blob_ = other.blob_;
+        other.blob_ = nullptr;
+    }
+    return *this;
+}
+
+size_t SQLiteDatabase::BlobHandle::size() const {
+    return blob_ ? static_cast<size_t>(sqlite3_blob_bytes(blob_)) : 0;
+}
+
+bool SQLiteDatabase::BlobHandle::read(void* data, size_t size, size_t offset) {
+    // sqlite3_blob_* take int sizes; BLOBs are capped well below 2 GB (SQLITE_MAX_LENGTH) anyway
+    if (!blob_ || offset > this->size() || size > this->size() - offset) {
+        return false;
+    }
+    return sqlite3_blob_read(blob_, data, static_cast<int>(size), static_cast<int>(offset)) == SQLITE_OK;
+}
+
+bool SQLiteDatabase::BlobHandle::write(const void* data, size_t size, size_t offset) {
+    if (!blob_ || offset > this->size() || size > this->size() - offset) {
+        return false;
+    }
+    return sqlite3_blob_write(blob_, data, static_cast<int>(size), static_cast<int>(offset)) == SQLITE_OK;
+}
+
 // ==============================================================================
 // SQLiteDatabase Implementation
 // ==============================================================================
 
-SQLiteDatabase::SQLiteDatabase() : db_(nullptr), isOpen_(false) {
+SQLiteDatabase::SQLiteDatabase() : db_(nullptr), isOpen_(false), statement_cache_(std::make_shared<StatementCache>()) {
     LEAFRA_DEBUG() << "SQLiteDatabase created";
 }
 
@@ -274,7 +727,8 @@ SQLiteDatabase::~SQLiteDatabase() {
 }
 
 SQLiteDatabase::SQLiteDatabase(SQLiteDatabase&& other) noexcept 
-    : db_(other.db_), isOpen_(other.isOpen_) {
+    : db_(other.db_), isOpen_(other.isOpen_), config_(std::move(other.config_)),
+      statement_cache_(std::move(other.statement_cache_)) {
     other.db_ = nullptr;
     other.isOpen_ = false;
 }
@@ -284,6 +738,8 @@ SQLiteDatabase& SQLiteDatabase::operator=(SQLiteDatabase&& other) noexcept {
         close();
         db_ = other.db_;
         isOpen_ = other.isOpen_;
+        config_ = std::move(other.config_);
+        statement_cache_ = std::move(other.statement_cache_);
         other.db_ = nullptr;
         other.isOpen_ = false;
     }
@@ -325,11 +781,24 @@ bool SQLiteDatabase::open(const std::string& relative_path, int flags) {
     }
     
     LEAFRA_DEBUG() << "Converted relative path '" << relative_path << "' to absolute path: " << absolutePath;
+    return openFile(absolutePath, flags);
+}
+
+bool SQLiteDatabase::openFile(const std::string& absolutePath, int flags) {
+    if (isOpen_) {
+        LEAFRA_WARNING() << "Database already open";
+        return true;
+    }
     
     int result = sqlite3_open_v2(absolutePath.c_str(), &db_, flags, nullptr);
     
     if (result == SQLITE_OK) {
         isOpen_ = true;
+        applyConnectionProfile();
+        if (statement_cache_) {
+            std::lock_guard<std::mutex> lock(statement_cache_->mutex);
+            statement_cache_->idle.set_capacity(static_cast<size_t>(std::max(0, config_.statement_cache_size)));
+        }
         LEAFRA_INFO() << "SQLite database opened successfully: " << absolutePath;
         return true;
     } else {
@@ -340,6 +809,87 @@ bool SQLiteDatabase::open(const std::string& relative_path, int flags) {
     }
 }
 
+void SQLiteDatabase::setConfig(const DatabaseConfig& config) {
+    config_ = config;
+}
+
+const DatabaseConfig& SQLiteDatabase::getConfig() const {
+    return config_;
+}
+
+void SQLiteDatabase::applyConnectionProfile() {
+    // Failures are logged but not fatal - the connection still works with SQLite defaults
+    if (config_.busy_timeout_ms > 0) {
+        sqlite3_busy_timeout(db_, config_.busy_timeout_ms);
+    }
+    
+    // The keyword index triggers read chunk text through this, so every connection that writes chunks needs it
+    // (the four-argument form reads doc_texts, so it is neither deterministic nor innocuous)
+    if (sqlite3_create_function_v2(db_, "leafra_chunk_text", 1, SQLITE_UTF8 | SQLITE_DETERMINISTIC | SQLITE_INNOCUOUS,
+                                   nullptr, chunkTextFunction, nullptr, nullptr, nullptr) != SQLITE_OK ||
+        sqlite3_create_function_v2(db_, "leafra_chunk_text", 4, SQLITE_UTF8,
+                                   nullptr, chunkTextFunction, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        LEAFRA_WARNING() << "Failed to register leafra_chunk_text: " << sqlite3_errmsg(db_);
+    }
+    
+    // Exact scoring of stored embeddings in SQL (filtered searches over a few chunks skip the FAISS index)
+    for (size_t i = 0; i < sizeof(kVectorMetrics) / sizeof(kVectorMetrics[0]); ++i) {
+        for (int argc : {2, 5}) {
+            if (sqlite3_create_function_v2(db_, kVectorFunctionNames[i], argc, SQLITE_UTF8 | SQLITE_DETERMINISTIC | SQLITE_INNOCUOUS,
+                                           const_cast<VectorMetric*>(&kVectorMetrics[i]), vectorFunction, nullptr, nullptr,
+                                           nullptr) != SQLITE_OK) {
+                LEAFRA_WARNING() << "Failed to register " << kVectorFunctionNames[i] << ": " << sqlite3_errmsg(db_);
+            }
+        }
+    }
+    
+    // page_size has to come before journal_mode: it can't change once the database is in WAL mode
+    if (config_.page_size > 0) {
+        execute("PRAGMA page_size = " + std::to_string(config_.page_size));
+    }
+    // So does auto_vacuum, and only a file nothing was written to yet takes it (afterwards only a full VACUUM applies it)
+    if (!config_.auto_vacuum.empty()) {
+        int64_t pages = 0;
+        execute("PRAGMA page_count", [&pages](const Row& row) {
+            pages = row.getInt64(0);
+            return false;
+        });
+        if (pages == 0) {
+            execute("PRAGMA auto_vacuum = " + config_.auto_vacuum);
+        }
+    }
+    if (!config_.journal_mode.empty()) {
+        std::string mode;
+        execute("PRAGMA journal_mode = " + config_.journal_mode, [&mode](const Row& row) {
+            mode = row.getText(0);
+            return false;
+        });
+        // In-memory databases report "memory" regardless of the request
+        if (!mode.empty() && mode != "memory") {
+            std::string requested = config_.journal_mode;
+            std::transform(requested.begin(), requested.end(), requested.begin(), ::tolower);
+            if (mode != requested) {
+                LEAFRA_WARNING() << "SQLite journal_mode " << config_.journal_mode << " not applied (using " << mode << ")";
+            }
+        }
+    }
+    if (!config_.synchronous.empty()) {
+        execute("PRAGMA synchronous = " + config_.synchronous);
+    }
+    if (config_.cache_size_kib > 0) {
+        // Negative cache_size is in KiB rather than pages
+        execute("PRAGMA cache_size = -" + std::to_string(config_.cache_size_kib));
+    }
+    execute("PRAGMA mmap_size = " + std::to_string(config_.mmap_size));
+    if (!config_.temp_store.empty()) {
+        execute("PRAGMA temp_store = " + config_.temp_store);
+    }
+    
+    LEAFRA_DEBUG() << "SQLite connection profile: journal_mode=" << config_.journal_mode
+                   << ", synchronous=" << config_.synchronous << ", cache_size=" << config_.cache_size_kib << "KiB"
+                   << ", mmap_size=" << config_.mmap_size << ", busy_timeout=" << config_.busy_timeout_ms << "ms";
+}
+
 bool SQLiteDatabase::openMemory() {
     return open(":memory:", static_cast<int>(OpenFlags::ReadWrite) | static_cast<int>(OpenFlags::Create));
 }
@@ -347,6 +897,12 @@ bool SQLiteDatabase::openMemory() {
 void SQLiteDatabase::close() {
     if (isOpen_ && db_) {
         LEAFRA_INFO() << "Closing SQLite database";
+        // Finalize idle statements first; leases still out are finalized when they're returned
+        if (statement_cache_) {
+            std::lock_guard<std::mutex> lock(statement_cache_->mutex);
+            statement_cache_->idle.clear();
+            statement_cache_->connection++;
+        }
         sqlite3_close_v2(db_);
         cleanup();
     }
@@ -395,6 +951,64 @@ bool SQLiteDatabase::execute(const std::string& sql, const std::function<bool(co
     return true;
 }
 
+SQLiteDatabase::CachedStatement SQLiteDatabase::prepareCached(const std::string& sql) {
+    if (!isOpen_ || !statement_cache_) {
+        LEAFRA_ERROR() << "Database not open";
+        return CachedStatement();
+    }
+    
+    std::unique_ptr<Statement> stmt;
+    uint64_t connection = 0;
+    {
+        std::lock_guard<std::mutex> lock(statement_cache_->mutex);
+        connection = statement_cache_->connection;
+        statement_cache_->idle.take(sql, stmt);
+    }
+    if (!stmt) {
+        stmt = prepare(sql);
+    }
+    return CachedStatement(statement_cache_, sql, std::move(stmt), connection);
+}
+
+std::unique_ptr<SQLiteDatabase::BlobHandle> SQLiteDatabase::openBlob(const std::string& table, const std::string& column,
+                                                                      int64_t rowid, bool writable) {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return nullptr;
+    }
+    
+    sqlite3_blob* blob = nullptr;
+    int result = sqlite3_blob_open(db_, "main", table.c_str(), column.c_str(), static_cast<sqlite3_int64>(rowid),
+                                   writable ? 1 : 0, &blob);
+    if (result != SQLITE_OK) {
+        LEAFRA_ERROR() << "Failed to open BLOB " << table << "." << column << " of row " << rowid << ": " << sqlite3_errmsg(db_);
+        sqlite3_blob_close(blob);
+        return nullptr;
+    }
+    return std::make_unique<BlobHandle>(blob);
+}
+
+SQLiteDatabase::StatementCacheStats SQLiteDatabase::getStatementCacheStats() const {
+    StatementCacheStats stats;
+    if (statement_cache_) {
+        std::lock_guard<std::mutex> lock(statement_cache_->mutex);
+        stats.hits = statement_cache_->idle.hits();
+        stats.misses = statement_cache_->idle.misses();
+        stats.evictions = statement_cache_->idle.evictions();
+        stats.entries = statement_cache_->idle.size();
+        stats.capacity = statement_cache_->idle.capacity();
+    }
+    return stats;
+}
+
+void SQLiteDatabase::clearStatementCache() {
+    if (statement_cache_) {
+        std::lock_guard<std::mutex> lock(statement_cache_->mutex);
+        statement_cache_->idle.clear();
+        statement_cache_->idle.reset_stats();
+    }
+}
+
 std::unique_ptr<SQLiteDatabase::Statement> SQLiteDatabase::prepare(const std::string& sql) {
     if (!isOpen_) {
         LEAFRA_ERROR() << "Database not open";
@@ -441,6 +1055,11 @@ std::string SQLiteDatabase::getVersion() const {
     return sqlite3_libversion();
 }
 
+std::string SQLiteDatabase::getPath() const {
+    const char* path = isOpen_ ? sqlite3_db_filename(db_, "main") : nullptr;
+    return path ? path : "";
+}
+
 int SQLiteDatabase::getLastErrorCode() const {
     if (!isOpen_) return SQLITE_MISUSE;
     return sqlite3_errcode(db_);
@@ -470,35 +1089,190 @@ bool SQLiteDatabase::fileExists(const std::string& path) {
     return std::filesystem::exists(path);
 }
 
-bool SQLiteDatabase::createdb(const std::string& relative_path) {
-    LEAFRA_DEBUG() << "Creating database: " << relative_path;
-    
-    // Validate that the path is relative (not absolute)
-    if (relative_path.empty()) {
-        LEAFRA_ERROR() << "Database path cannot be empty";
+void SQLiteDatabase::getMemoryUsage(int64_t& used_bytes, int64_t& highwater_bytes, bool reset_highwater) {
+    used_bytes = sqlite3_memory_used();
+    highwater_bytes = sqlite3_memory_highwater(reset_highwater ? 1 : 0);
+}
+
+int64_t SQLiteDatabase::getCacheMemoryUsage() const {
+    if (!db_) {
+        return 0;
+    }
+    int current = 0;
+    int highwater = 0;
+    if (sqlite3_db_status(db_, SQLITE_DBSTATUS_CACHE_USED, &current, &highwater, 0) != SQLITE_OK) {
+        return 0;
+    }
+    return current;
+}
+
+int64_t SQLiteDatabase::releaseCacheMemory() {
+    if (!db_) {
+        return 0;
+    }
+    const int64_t before = getCacheMemoryUsage();
+    sqlite3_db_release_memory(db_);
+    return std::max<int64_t>(before - getCacheMemoryUsage(), 0);
+}
+
+bool SQLiteDatabase::getSpaceStats(SpaceStats& stats) {
+    auto pragma = [this](const char* name, int64_t& value) {
+        auto stmt = prepare(std::string("PRAGMA ") + name);
+        if (!stmt || !stmt->isValid() || !stmt->step()) {
+            return false;
+        }
+        value = stmt->getCurrentRow().getInt64(0);
+        return true;
+    };
+    int64_t auto_vacuum = 0;
+    if (!pragma("page_size", stats.page_size) || !pragma("page_count", stats.page_count) ||
+        !pragma("freelist_count", stats.freelist_count) || !pragma("auto_vacuum", auto_vacuum)) {
         return false;
     }
-    
-    // Check for absolute path indicators
-    if (relative_path[0] == '/' || relative_path[0] == '\\' || 
-        (relative_path.length() > 1 && relative_path[1] == ':')) { // Windows drive letter
-        LEAFRA_ERROR() << "Database path must be relative, not absolute: " << relative_path;
+    stats.auto_vacuum = static_cast<int32_t>(auto_vacuum);
+    return true;
+}
+
+int64_t SQLiteDatabase::incrementalVacuum(int64_t pages) {
+    SpaceStats before;
+    SpaceStats after;
+    if (!getSpaceStats(before) ||
+        !execute("PRAGMA incremental_vacuum(" + std::to_string(std::max<int64_t>(pages, 0)) + ")") ||
+        !getSpaceStats(after)) {
+        return -1;
+    }
+    return std::max<int64_t>(before.freelist_count - after.freelist_count, 0);
+}
+
+bool SQLiteDatabase::vacuumInto(const std::string& absolute_path) {
+    auto stmt = prepare("VACUUM INTO ?");
+    if (!stmt || !stmt->isValid() || !stmt->bindText(1, absolute_path)) {
         return false;
     }
-    
-    // Check for path traversal attempts
-    if (relative_path.find("..") != std::string::npos) {
-        LEAFRA_ERROR() << "Database path cannot contain path traversal sequences (..): " << relative_path;
+    if (!stmt->execute()) {
+        LEAFRA_ERROR() << "Failed to copy database to " << absolute_path << ": " << getLastErrorMessage();
         return false;
     }
-    
-    // Convert relative path to absolute path using file manager
-    std::string absolutePath = FileManager::getAbsolutePath(StorageType::AppStorage, relative_path);
-    if (absolutePath.empty()) {
-        LEAFRA_ERROR() << "Failed to convert relative path to absolute path: " << relative_path;
+    return true;
+}
+
+bool SQLiteDatabase::restoreFrom(const std::string& absolute_path) {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
         return false;
     }
-    
+    sqlite3* source = nullptr;
+    if (sqlite3_open_v2(absolute_path.c_str(), &source, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        LEAFRA_ERROR() << "Failed to open database to restore from: " << absolute_path << " Error: " << sqlite3_errmsg(source);
+        sqlite3_close(source);
+        return false;
+    }
+    
+    // Idle statements were prepared against the schema being replaced
+    clearStatementCache();
+    sqlite3_backup* backup = sqlite3_backup_init(db_, "main", source, "main");
+    int result = backup ? sqlite3_backup_step(backup, -1) : sqlite3_errcode(db_);
+    if (backup) {
+        sqlite3_backup_finish(backup);
+    }
+    sqlite3_close(source);
+    if (result != SQLITE_DONE) {
+        LEAFRA_ERROR() << "Failed to restore database from " << absolute_path << ": " << sqlite3_errstr(result);
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteDatabase::backupTo(const std::string& absolute_path, int pages_per_step, int pause_ms,
+                              const std::function<bool(int remaining, int total)>& progress) {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    const std::string temp_path = absolute_path + ".tmp";
+    std::error_code ec;
+    std::filesystem::remove(temp_path, ec);
+    sqlite3* destination = nullptr;
+    if (sqlite3_open_v2(temp_path.c_str(), &destination, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+        LEAFRA_ERROR() << "Failed to create backup file: " << temp_path << " Error: " << sqlite3_errmsg(destination);
+        sqlite3_close(destination);
+        return false;
+    }
+    
+    sqlite3_backup* backup = sqlite3_backup_init(destination, "main", db_, "main");
+    int result = backup ? SQLITE_OK : sqlite3_errcode(destination);
+    bool cancelled = false;
+    while (backup && (result == SQLITE_OK || result == SQLITE_BUSY || result == SQLITE_LOCKED)) {
+        {
+            // A step inside another thread's transaction would copy pages that may still be rolled back
+            sqlite3_mutex* mutex = sqlite3_db_mutex(db_);
+            sqlite3_mutex_enter(mutex);
+            if (sqlite3_get_autocommit(db_)) {
+                result = sqlite3_backup_step(backup, pages_per_step > 0 ? pages_per_step : -1);
+            }
+            sqlite3_mutex_leave(mutex);
+        }
+        if (result == SQLITE_DONE) {
+            break;
+        }
+        if (progress && !progress(sqlite3_backup_remaining(backup), sqlite3_backup_pagecount(backup))) {
+            cancelled = true;
+            break;
+        }
+        sqlite3_sleep(std::max(pause_ms, 0));
+    }
+    if (backup) {
+        sqlite3_backup_finish(backup);
+    }
+    sqlite3_close(destination);
+    
+    if (result != SQLITE_DONE) {
+        if (cancelled) {
+            LEAFRA_INFO() << "Backup to " << absolute_path << " cancelled";
+        } else {
+            LEAFRA_ERROR() << "Failed to back up database to " << absolute_path << ": " << sqlite3_errstr(result);
+        }
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    std::filesystem::rename(temp_path, absolute_path, ec);
+    if (ec) {
+        LEAFRA_ERROR() << "Failed to move backup into place: " << ec.message();
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+} //backupTo
+
+bool SQLiteDatabase::createdb(const std::string& relative_path, const DatabaseConfig& config) {
+    LEAFRA_DEBUG() << "Creating database: " << relative_path;
+    
+    // Validate that the path is relative (not absolute)
+    if (relative_path.empty()) {
+        LEAFRA_ERROR() << "Database path cannot be empty";
+        return false;
+    }
+    
+    // Check for absolute path indicators
+    if (relative_path[0] == '/' || relative_path[0] == '\\' || 
+        (relative_path.length() > 1 && relative_path[1] == ':')) { // Windows drive letter
+        LEAFRA_ERROR() << "Database path must be relative, not absolute: " << relative_path;
+        return false;
+    }
+    
+    // Check for path traversal attempts
+    if (relative_path.find("..") != std::string::npos) {
+        LEAFRA_ERROR() << "Database path cannot contain path traversal sequences (..): " << relative_path;
+        return false;
+    }
+    
+    // Convert relative path to absolute path using file manager
+    std::string absolutePath = FileManager::getAbsolutePath(StorageType::AppStorage, relative_path);
+    if (absolutePath.empty()) {
+        LEAFRA_ERROR() << "Failed to convert relative path to absolute path: " << relative_path;
+        return false;
+    }
+    
     LEAFRA_DEBUG() << "Converted relative path '" << relative_path << "' to absolute path: " << absolutePath;
     
     // Create parent directories if they don't exist
@@ -534,6 +1308,10 @@ bool SQLiteDatabase::createdb(const std::string& relative_path) {
         newDb.db_ = db;
         newDb.isOpen_ = true;
         
+        // Page size and journal mode are fixed at creation, so apply the profile before any table exists
+        newDb.config_ = config;
+        newDb.applyConnectionProfile();
+        
         bool tablesCreated = newDb.createRAGTables();
         
         // Clean up - the newDb destructor will close the database
@@ -600,7 +1378,11 @@ bool SQLiteDatabase::createRAGTables() {
             filename TEXT NOT NULL,
             url TEXT,
             creation_date DATETIME DEFAULT CURRENT_TIMESTAMP,
-            size INTEGER NOT NULL
+            size INTEGER NOT NULL,
+            file_size INTEGER,
+            file_mtime INTEGER,
+            content_hash TEXT,
+            collection TEXT NOT NULL DEFAULT ''
         )
     )";
     
@@ -620,7 +1402,12 @@ bool SQLiteDatabase::createRAGTables() {
             chunk_token_size INTEGER NOT NULL,
             chunk_size INTEGER NOT NULL,
             chunk_text TEXT NOT NULL,
-            chunk_embedding BLOB,
+            chunk_hash TEXT,
+            chunk_simhash INTEGER,
+            chunk_start INTEGER,
+            chunk_end INTEGER,
+            chunk_doc_offset INTEGER,
+            chunk_page_offset INTEGER,
             FOREIGN KEY (doc_id) REFERENCES docs(id) ON DELETE CASCADE
         )
     )";
@@ -645,20 +1432,91 @@ bool SQLiteDatabase::createRAGTables() {
         return false;
     }
     
+    // Create FAISS delta log table (incremental adds/removals on top of faissindextable)
+    const std::string createFaissDeltaTable = R"(
+        CREATE TABLE IF NOT EXISTS faissdeltatable (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            definition TEXT NOT NULL,
+            op INTEGER NOT NULL,
+            count INTEGER NOT NULL,
+            ids BLOB NOT NULL,
+            vectors BLOB
+        )
+    )";
+    
+    if (!execute(createFaissDeltaTable)) {
+        LEAFRA_ERROR() << "Failed to create faissdeltatable";
+        return false;
+    }
+    
     // Create indexes for better performance
     const std::string createDocsFilenameIndex = "CREATE INDEX IF NOT EXISTS idx_docs_filename ON docs(filename)";
     const std::string createChunksDocIdIndex = "CREATE INDEX IF NOT EXISTS idx_chunks_doc_id ON chunks(doc_id)";
     const std::string createChunksChunkNoIndex = "CREATE INDEX IF NOT EXISTS idx_chunks_chunk_no ON chunks(doc_id, chunk_no)";
+    const std::string createChunksFaissIdIndex = "CREATE UNIQUE INDEX IF NOT EXISTS idx_chunks_faiss_id ON chunks(chunk_faiss_id)";
     const std::string createFaissDefinitionIndex = "CREATE INDEX IF NOT EXISTS idx_faiss_definition ON faissindextable(definition)";
+    const std::string createFaissDeltaDefinitionIndex = "CREATE INDEX IF NOT EXISTS idx_faiss_delta_definition ON faissdeltatable(definition, id)";
     
     if (!execute(createDocsFilenameIndex) || 
         !execute(createChunksDocIdIndex) || 
         !execute(createChunksChunkNoIndex) ||
-        !execute(createFaissDefinitionIndex)) {
+        !execute(createChunksFaissIdIndex) ||
+        !execute(createFaissDefinitionIndex) ||
+        !execute(createFaissDeltaDefinitionIndex)) {
         LEAFRA_ERROR() << "Failed to create indexes";
         return false;
     }
     
+    if (!createChunkEmbeddingsTable()) {
+        LEAFRA_ERROR() << "Failed to create chunk_embeddings table";
+        return false;
+    }
+    
+    if (!createDocTextTable()) {
+        LEAFRA_ERROR() << "Failed to create doc_texts table";
+        return false;
+    }
+    
+    if (!createDocCentroidsTable()) {
+        LEAFRA_ERROR() << "Failed to create doc_centroids table";
+        return false;
+    }
+    
+    if (!createChunkLLMTokensTable()) {
+        LEAFRA_ERROR() << "Failed to create chunk_llm_tokens table";
+        return false;
+    }
+    
+    if (!createChunkRetrievalsTable()) {
+        LEAFRA_ERROR() << "Failed to create chunk_retrievals table";
+        return false;
+    }
+    
+    if (!createIngestionQueueTable()) {
+        LEAFRA_ERROR() << "Failed to create ingestion_queue table";
+        return false;
+    }
+    
+    if (!createIndexModelsTable()) {
+        LEAFRA_ERROR() << "Failed to create index_models table";
+        return false;
+    }
+    
+    if (!createChunkIdSequence()) {
+        LEAFRA_ERROR() << "Failed to create chunk id sequence";
+        return false;
+    }
+    
+    if (!createSyncLogTable()) {
+        LEAFRA_ERROR() << "Failed to create sync_log table";
+        return false;
+    }
+    
+    // Keyword search is optional: builds without FTS5 still get a working database
+    if (!createChunkKeywordIndex()) {
+        LEAFRA_WARNING() << "FTS5 keyword index not available, hybrid search will use vectors only";
+    }
+    
     // Commit the transaction to ensure tables are written to disk
     if (!transaction.commit()) {
         LEAFRA_ERROR() << "Failed to commit RAG tables creation transaction";
@@ -669,13 +1527,512 @@ bool SQLiteDatabase::createRAGTables() {
     return true;
 }
 
+bool SQLiteDatabase::addColumnIfMissing(const std::string& table, const std::string& column, const std::string& definition) {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    auto check_stmt = prepare("SELECT 1 FROM pragma_table_info(?) WHERE name = ?");
+    if (!check_stmt || !check_stmt->isValid()) {
+        LEAFRA_ERROR() << "Failed to prepare column check for " << table << "." << column;
+        return false;
+    }
+    check_stmt->bindText(1, table);
+    check_stmt->bindText(2, column);
+    if (check_stmt->step()) {
+        return true;
+    }
+    
+    if (!execute("ALTER TABLE " + table + " ADD COLUMN " + column + " " + definition)) {
+        LEAFRA_ERROR() << "Failed to add column " << table << "." << column;
+        return false;
+    }
+    LEAFRA_DEBUG() << "Added column " << table << "." << column;
+    return true;
+}
+
+bool SQLiteDatabase::createChunkKeywordIndex() {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    bool existed = false;
+    auto check_stmt = prepare("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'chunks_fts'");
+    if (check_stmt && check_stmt->isValid()) {
+        existed = check_stmt->step();
+    }
+    
+    const std::string createChunksFtsTable = R"(
+        CREATE VIRTUAL TABLE IF NOT EXISTS chunks_fts USING fts5(
+            chunk_text,
+            content='chunks',
+            content_rowid='id',
+            tokenize='unicode61 remove_diacritics 2'
+        )
+    )";
+    if (!existed && !execute(createChunksFtsTable)) {
+        return false;
+    }
+    
+    // External-content tables need the old text to remove entries, so deletes go through the 'delete' command.
+    // Chunk text may be stored compressed or as a range of doc_texts, so the index always sees it through
+    // leafra_chunk_text(); triggers from before that are replaced.
+    const std::string createInsertTrigger = R"(
+        CREATE TRIGGER chunks_fts_insert AFTER INSERT ON chunks BEGIN
+            INSERT INTO chunks_fts (rowid, chunk_text) VALUES (new.id, leafra_chunk_text(new.chunk_text, new.doc_id, new.chunk_start, new.chunk_end));
+        END
+    )";
+    const std::string createDeleteTrigger = R"(
+        CREATE TRIGGER chunks_fts_delete AFTER DELETE ON chunks BEGIN
+            INSERT INTO chunks_fts (chunks_fts, rowid, chunk_text) VALUES ('delete', old.id, leafra_chunk_text(old.chunk_text, old.doc_id, old.chunk_start, old.chunk_end));
+        END
+    )";
+    const std::string createUpdateTrigger = R"(
+        CREATE TRIGGER chunks_fts_update AFTER UPDATE OF chunk_text ON chunks BEGIN
+            INSERT INTO chunks_fts (chunks_fts, rowid, chunk_text) VALUES ('delete', old.id, leafra_chunk_text(old.chunk_text, old.doc_id, old.chunk_start, old.chunk_end));
+            INSERT INTO chunks_fts (rowid, chunk_text) VALUES (new.id, leafra_chunk_text(new.chunk_text, new.doc_id, new.chunk_start, new.chunk_end));
+        END
+    )";
+    
+    int64_t current_triggers = 0;
+    execute("SELECT COUNT(*) FROM sqlite_master WHERE type = 'trigger' AND name LIKE 'chunks_fts_%' "
+            "AND sql LIKE '%leafra_chunk_text(%chunk_start%'", [&current_triggers](const Row& row) {
+        current_triggers = row.getInt64(0);
+        return false;
+    });
+    if (current_triggers != 3) {
+        if (!execute("DROP TRIGGER IF EXISTS chunks_fts_insert") || !execute("DROP TRIGGER IF EXISTS chunks_fts_delete") ||
+            !execute("DROP TRIGGER IF EXISTS chunks_fts_update") ||
+            !execute(createInsertTrigger) || !execute(createDeleteTrigger) || !execute(createUpdateTrigger)) {
+            LEAFRA_ERROR() << "Failed to create chunk keyword index triggers";
+            return false;
+        }
+    }
+    
+    // Index chunks stored before the keyword index existed ('rebuild' would read compressed rows as they are stored)
+    if (!existed && !execute("INSERT INTO chunks_fts (rowid, chunk_text) SELECT id, leafra_chunk_text(chunk_text, doc_id, chunk_start, chunk_end) FROM chunks")) {
+        LEAFRA_ERROR() << "Failed to build chunk keyword index";
+        return false;
+    }
+    
+    if (!existed) {
+        LEAFRA_DEBUG() << "Chunk keyword index created";
+    }
+    return true;
+}
+
+bool SQLiteDatabase::createDocTextTable() {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    if (!addColumnIfMissing("chunks", "chunk_start", "INTEGER") || !addColumnIfMissing("chunks", "chunk_end", "INTEGER")) {
+        return false;
+    }
+    
+    // One row per page of a document's text; page_text is TEXT or a TextCodec blob
+    const std::string createDocTextsTable = R"(
+        CREATE TABLE IF NOT EXISTS doc_texts (
+            doc_id INTEGER NOT NULL,
+            text_start INTEGER NOT NULL,
+            text_end INTEGER NOT NULL,
+            page_text TEXT NOT NULL,
+            PRIMARY KEY (doc_id, text_start)
+        ) WITHOUT ROWID
+    )";
+    // Chunks are deleted before their document, so the keyword index triggers can still read the pages
+    const std::string createDeleteTrigger = R"(
+        CREATE TRIGGER IF NOT EXISTS doc_texts_delete AFTER DELETE ON docs BEGIN
+            DELETE FROM doc_texts WHERE doc_id = old.id;
+        END
+    )";
+    if (!execute(createDocTextsTable) || !execute(createDeleteTrigger)) {
+        LEAFRA_ERROR() << "Failed to create doc_texts table";
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteDatabase::createDocCentroidsTable() {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    const std::string createDocCentroidsTableSql = R"(
+        CREATE TABLE IF NOT EXISTS doc_centroids (
+            doc_id INTEGER PRIMARY KEY,
+            chunk_count INTEGER NOT NULL,
+            format INTEGER NOT NULL,
+            byte_order INTEGER NOT NULL,
+            dimension INTEGER NOT NULL,
+            scale REAL NOT NULL DEFAULT 0,
+            embedding BLOB NOT NULL
+        )
+    )";
+    const std::string createDeleteTrigger = R"(
+        CREATE TRIGGER IF NOT EXISTS doc_centroids_delete AFTER DELETE ON docs BEGIN
+            DELETE FROM doc_centroids WHERE doc_id = old.id;
+        END
+    )";
+    if (!execute(createDocCentroidsTableSql) || !execute(createDeleteTrigger)) {
+        LEAFRA_ERROR() << "Failed to create doc_centroids table";
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteDatabase::createChunkLLMTokensTable() {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    const std::string createChunkLLMTokensTableSql = R"(
+        CREATE TABLE IF NOT EXISTS chunk_llm_tokens (
+            chunk_faiss_id INTEGER PRIMARY KEY,
+            vocab TEXT NOT NULL,
+            tokens BLOB NOT NULL
+        )
+    )";
+    const std::string createDeleteTrigger = R"(
+        CREATE TRIGGER IF NOT EXISTS chunk_llm_tokens_delete AFTER DELETE ON chunks BEGIN
+            DELETE FROM chunk_llm_tokens WHERE chunk_faiss_id = old.chunk_faiss_id;
+        END
+    )";
+    if (!execute(createChunkLLMTokensTableSql) || !execute(createDeleteTrigger)) {
+        LEAFRA_ERROR() << "Failed to create chunk_llm_tokens table";
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteDatabase::createChunkRetrievalsTable() {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    const std::string createChunkRetrievalsTableSql = R"(
+        CREATE TABLE IF NOT EXISTS chunk_retrievals (
+            chunk_faiss_id INTEGER PRIMARY KEY,
+            retrievals INTEGER NOT NULL DEFAULT 0
+        )
+    )";
+    const std::string createDeleteTrigger = R"(
+        CREATE TRIGGER IF NOT EXISTS chunk_retrievals_delete AFTER DELETE ON chunks BEGIN
+            DELETE FROM chunk_retrievals WHERE chunk_faiss_id = old.chunk_faiss_id;
+        END
+    )";
+    if (!execute(createChunkRetrievalsTableSql) || !execute(createDeleteTrigger)) {
+        LEAFRA_ERROR() << "Failed to create chunk_retrievals table";
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteDatabase::createIngestionQueueTable() {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    const std::string createIngestionQueueTableSql = R"(
+        CREATE TABLE IF NOT EXISTS ingestion_queue (
+            file_path TEXT NOT NULL,
+            collection TEXT NOT NULL DEFAULT '',
+            stage TEXT NOT NULL DEFAULT 'queued',
+            content_hash TEXT,
+            status TEXT NOT NULL DEFAULT 'pending',
+            attempts INTEGER NOT NULL DEFAULT 0,
+            updated_at INTEGER NOT NULL DEFAULT (strftime('%s', 'now')),
+            PRIMARY KEY (file_path, collection)
+        )
+    )";
+    if (!execute(createIngestionQueueTableSql)) {
+        LEAFRA_ERROR() << "Failed to create ingestion_queue table";
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteDatabase::createChunkEmbeddingsTable() {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    bool existed = false;
+    auto check_stmt = prepare("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'chunk_embeddings'");
+    if (check_stmt && check_stmt->isValid()) {
+        existed = check_stmt->step();
+    }
+    
+    const std::string createChunkEmbeddingsTableSql = R"(
+        CREATE TABLE IF NOT EXISTS chunk_embeddings (
+            chunk_faiss_id INTEGER PRIMARY KEY,
+            format INTEGER NOT NULL,
+            byte_order INTEGER NOT NULL,
+            dimension INTEGER NOT NULL,
+            scale REAL NOT NULL DEFAULT 0,
+            embedding BLOB NOT NULL
+        )
+    )";
+    const std::string createDeleteTrigger = R"(
+        CREATE TRIGGER IF NOT EXISTS chunk_embeddings_delete AFTER DELETE ON chunks BEGIN
+            DELETE FROM chunk_embeddings WHERE chunk_faiss_id = old.chunk_faiss_id;
+        END
+    )";
+    if (!execute(createChunkEmbeddingsTableSql) || !execute(createDeleteTrigger)) {
+        return false;
+    }
+    if (existed) {
+        return true;
+    }
+    
+    // Databases from before chunk_embeddings stored native-endian fp32 blobs inline in chunks
+    bool has_inline_embeddings = false;
+    auto column_stmt = prepare("SELECT 1 FROM pragma_table_info('chunks') WHERE name = 'chunk_embedding'");
+    if (column_stmt && column_stmt->isValid()) {
+        has_inline_embeddings = column_stmt->step();
+    }
+    if (has_inline_embeddings) {
+        SQLiteTransaction transaction(*this);
+        auto migrate_stmt = prepare(
+            "INSERT OR IGNORE INTO chunk_embeddings (chunk_faiss_id, format, byte_order, dimension, scale, embedding) "
+            "SELECT chunk_faiss_id, ?, ?, length(chunk_embedding) / 4, 0, chunk_embedding FROM chunks "
+            "WHERE chunk_faiss_id IS NOT NULL AND chunk_embedding IS NOT NULL");
+        if (!migrate_stmt || !migrate_stmt->isValid()) {
+            LEAFRA_ERROR() << "Failed to prepare inline embedding migration";
+            return false;
+        }
+        migrate_stmt->bindInt(1, static_cast<int>(EmbeddingStorageFormat::FP32));
+        migrate_stmt->bindInt(2, static_cast<int>(VectorCodec::native_byte_order()));
+        if (!migrate_stmt->execute() || !execute("UPDATE chunks SET chunk_embedding = NULL WHERE chunk_embedding IS NOT NULL")) {
+            LEAFRA_ERROR() << "Failed to migrate inline chunk embeddings: " << getLastErrorMessage();
+            return false;
+        }
+        int migrated = getChanges();
+        if (!transaction.commit()) {
+            LEAFRA_ERROR() << "Failed to commit inline chunk embedding migration";
+            return false;
+        }
+        LEAFRA_INFO() << "Moved " << migrated << " inline chunk embeddings into chunk_embeddings";
+    }
+    return true;
+}
+
+bool SQLiteDatabase::createEmbeddingCacheTable() {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    const std::string createEmbeddingCacheTableSql = R"(
+        CREATE TABLE IF NOT EXISTS embedding_cache (
+            cache_key TEXT PRIMARY KEY,
+            format INTEGER NOT NULL,
+            byte_order INTEGER NOT NULL,
+            dimension INTEGER NOT NULL,
+            scale REAL NOT NULL DEFAULT 0,
+            embedding BLOB NOT NULL,
+            last_used INTEGER NOT NULL
+        )
+    )";
+    const std::string createLastUsedIndex = "CREATE INDEX IF NOT EXISTS idx_embedding_cache_last_used ON embedding_cache(last_used)";
+    return execute(createEmbeddingCacheTableSql) && execute(createLastUsedIndex);
+}
+
+bool SQLiteDatabase::createIndexModelsTable() {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    const std::string createIndexModelsTableSql = R"(
+        CREATE TABLE IF NOT EXISTS index_models (
+            definition TEXT PRIMARY KEY,
+            model_id TEXT NOT NULL,
+            dimension INTEGER NOT NULL,
+            version INTEGER NOT NULL DEFAULT 1,
+            updated_at INTEGER NOT NULL
+        )
+    )";
+    return execute(createIndexModelsTableSql);
+}
+
+bool SQLiteDatabase::createShadowEmbeddingsTable() {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    const std::string createShadowEmbeddingsTableSql = R"(
+        CREATE TABLE IF NOT EXISTS chunk_embeddings_shadow (
+            chunk_faiss_id INTEGER PRIMARY KEY,
+            format INTEGER NOT NULL,
+            byte_order INTEGER NOT NULL,
+            dimension INTEGER NOT NULL,
+            scale REAL NOT NULL DEFAULT 0,
+            embedding BLOB NOT NULL
+        )
+    )";
+    const std::string createDeleteTrigger = R"(
+        CREATE TRIGGER IF NOT EXISTS chunk_embeddings_shadow_delete AFTER DELETE ON chunks BEGIN
+            DELETE FROM chunk_embeddings_shadow WHERE chunk_faiss_id = old.chunk_faiss_id;
+        END
+    )";
+    if (!execute(createShadowEmbeddingsTableSql) || !execute(createDeleteTrigger)) {
+        LEAFRA_ERROR() << "Failed to create chunk_embeddings_shadow table";
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteDatabase::dropShadowEmbeddingsTable() {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    // The trigger belongs to chunks, so dropping the table alone would leave it behind
+    return execute("DROP TRIGGER IF EXISTS chunk_embeddings_shadow_delete") && execute("DROP TABLE IF EXISTS chunk_embeddings_shadow");
+}
+
+bool SQLiteDatabase::createChunkIdSequence() {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    const std::string createIdSequencesTable = R"(
+        CREATE TABLE IF NOT EXISTS id_sequences (
+            name TEXT PRIMARY KEY,
+            next_id INTEGER NOT NULL
+        )
+    )";
+    // Older databases hold doc_id * 1000000 + i ids - continue past the largest so nothing is ever reused
+    const std::string seedChunkIdSequence =
+        "INSERT OR IGNORE INTO id_sequences (name, next_id) "
+        "SELECT 'chunk_faiss_id', COALESCE(MAX(chunk_faiss_id) + 1, 0) FROM chunks";
+    if (!execute(createIdSequencesTable) || !execute(seedChunkIdSequence)) {
+        LEAFRA_ERROR() << "Failed to create chunk id sequence: " << getLastErrorMessage();
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteDatabase::allocateIds(const std::string& sequence, int64_t count, int64_t& first_id) {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    if (count <= 0) {
+        LEAFRA_ERROR() << "Invalid id count: " << count;
+        return false;
+    }
+    
+    // Bump and read back under one write lock; inside a caller's transaction a rollback returns the ids too
+    std::unique_ptr<SQLiteTransaction> transaction;
+    if (!isInTransaction()) {
+        transaction = std::make_unique<SQLiteTransaction>(*this);
+    }
+    
+    auto update_stmt = prepareCached("UPDATE id_sequences SET next_id = next_id + ? WHERE name = ?");
+    if (!update_stmt || !update_stmt->isValid() || !update_stmt->bindInt64(1, count) ||
+        !update_stmt->bindText(2, sequence) || !update_stmt->execute()) {
+        LEAFRA_ERROR() << "Failed to advance id sequence " << sequence << ": " << getLastErrorMessage();
+        return false;
+    }
+    if (getChanges() == 0) {
+        LEAFRA_ERROR() << "Unknown id sequence: " << sequence;
+        return false;
+    }
+    
+    auto select_stmt = prepareCached("SELECT next_id FROM id_sequences WHERE name = ?");
+    if (!select_stmt || !select_stmt->isValid() || !select_stmt->bindText(1, sequence) || !select_stmt->step()) {
+        LEAFRA_ERROR() << "Failed to read id sequence " << sequence << ": " << getLastErrorMessage();
+        return false;
+    }
+    first_id = select_stmt->getCurrentRow().getInt64(0) - count;
+    
+    if (transaction && !transaction->commit()) {
+        LEAFRA_ERROR() << "Failed to commit id allocation for sequence " << sequence;
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteDatabase::createSyncLogTable() {
+    if (!isOpen_) {
+        LEAFRA_ERROR() << "Database not open";
+        return false;
+    }
+    
+    bool existed = false;
+    auto check_stmt = prepare("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'sync_log'");
+    if (check_stmt && check_stmt->isValid()) {
+        existed = check_stmt->step();
+    }
+    
+    const std::string createSyncLogTableSql = R"(
+        CREATE TABLE IF NOT EXISTS sync_log (
+            seq INTEGER PRIMARY KEY AUTOINCREMENT,
+            doc_id INTEGER NOT NULL,
+            url TEXT,
+            collection TEXT NOT NULL DEFAULT '',
+            removed INTEGER NOT NULL DEFAULT 0
+        )
+    )";
+    const std::string createInsertTrigger = R"(
+        CREATE TRIGGER IF NOT EXISTS sync_log_insert AFTER INSERT ON docs BEGIN
+            INSERT INTO sync_log (doc_id, url, collection, removed) VALUES (new.id, new.url, new.collection, 0);
+        END
+    )";
+    const std::string createDeleteTrigger = R"(
+        CREATE TRIGGER IF NOT EXISTS sync_log_delete AFTER DELETE ON docs BEGIN
+            INSERT INTO sync_log (doc_id, url, collection, removed) VALUES (old.id, old.url, old.collection, 1);
+        END
+    )";
+    const std::string createDocIdIndex = "CREATE INDEX IF NOT EXISTS idx_sync_log_doc_id ON sync_log(doc_id)";
+    if (!execute(createSyncLogTableSql) || !execute(createInsertTrigger) || !execute(createDeleteTrigger) ||
+        !execute(createDocIdIndex)) {
+        LEAFRA_ERROR() << "Failed to create sync_log table: " << getLastErrorMessage();
+        return false;
+    }
+    if (existed) {
+        return true;
+    }
+    
+    // Documents stored before the log existed count as added in its first generations
+    if (!execute("INSERT INTO sync_log (doc_id, url, collection, removed) SELECT id, url, collection, 0 FROM docs ORDER BY id")) {
+        LEAFRA_ERROR() << "Failed to seed sync_log: " << getLastErrorMessage();
+        return false;
+    }
+    return true;
+}
+
 // ==============================================================================
 // SQLiteTransaction Implementation
 // ==============================================================================
 
 SQLiteTransaction::SQLiteTransaction(SQLiteDatabase& db) 
-    : db_(db), committed_(false), active_(false) {
+    : db_(db), committed_(false), active_(false), span_("sqlite", "transaction") {
     
+    if (db_.isInTransaction()) {
+        // Nested: a savepoint of the outer transaction (names only need to be unique among open ones)
+        static std::atomic<uint64_t> next_savepoint{0};
+        savepoint_ = "leafra_savepoint_" + std::to_string(next_savepoint.fetch_add(1));
+        if (db_.execute("SAVEPOINT " + savepoint_)) {
+            active_ = true;
+        } else {
+            LEAFRA_ERROR() << "Failed to start savepoint";
+        }
+        return;
+    }
     if (db_.beginTransaction()) {
         active_ = true;
         LEAFRA_DEBUG() << "Transaction started";
@@ -695,9 +2052,20 @@ bool SQLiteTransaction::commit() {
         return false;
     }
     
+    if (!savepoint_.empty()) {
+        if (!db_.execute("RELEASE SAVEPOINT " + savepoint_)) {
+            LEAFRA_ERROR() << "Failed to release savepoint";
+            return false;
+        }
+        committed_ = true;
+        active_ = false;
+        span_.end();
+        return true;
+    }
     if (db_.commitTransaction()) {
         committed_ = true;
         active_ = false;
+        span_.end();
         LEAFRA_DEBUG() << "Transaction committed";
         return true;
     } else {
@@ -711,8 +2079,15 @@ void SQLiteTransaction::rollback() {
         return;
     }
     
-    db_.rollbackTransaction();
+    if (!savepoint_.empty()) {
+        db_.execute("ROLLBACK TO SAVEPOINT " + savepoint_);
+        db_.execute("RELEASE SAVEPOINT " + savepoint_);
+    } else {
+        db_.rollbackTransaction();
+    }
     active_ = false;
+    span_.arg("rolled_back", 1);
+    span_.end();
     LEAFRA_DEBUG() << "Transaction rolled back";
 }
 
@@ -726,63 +2101,121 @@ bool SQLiteTransaction::isActive() const {
 // Stub implementations when SQLite is not available
 // ==============================================================================
 
-SQLiteDatabase::Row::Row(sqlite3_stmt* stmt) : stmt_(nullptr) {}
-int SQLiteDatabase::Row::getInt(int columnIndex) const { return 0; }
-long long SQLiteDatabase::Row::getInt64(int columnIndex) const { return 0; }
-double SQLiteDatabase::Row::getDouble(int columnIndex) const { return 0.0; }
-std::string SQLiteDatabase::Row::getText(int columnIndex) const { return ""; }
-std::vector<uint8_t> SQLiteDatabase::Row::getBlob(int columnIndex) const { return {}; }
-bool SQLiteDatabase::Row::isNull(int columnIndex) const { return true; }
-SQLiteDatabase::ColumnType SQLiteDatabase::Row::getColumnType(int columnIndex) const { return ColumnType::Null; }
-int SQLiteDatabase::Row::getInt(const std::string& columnName) const { return 0; }
-long long SQLiteDatabase::Row::getInt64(const std::string& columnName) const { return 0; }
-double SQLiteDatabase::Row::getDouble(const std::string& columnName) const { return 0.0; }
-std::string SQLiteDatabase::Row::getText(const std::string& columnName) const { return ""; }
-std::vector<uint8_t> SQLiteDatabase::Row::getBlob(const std::string& columnName) const { return {}; }
-bool SQLiteDatabase::Row::isNull(const std::string& columnName) const { return true; }
+SQLiteDatabase::Row::Row(sqlite3_stmt* /*stmt*/) : stmt_(nullptr) {}
+int SQLiteDatabase::Row::getInt(int /*columnIndex*/) const { return 0; }
+long long SQLiteDatabase::Row::getInt64(int /*columnIndex*/) const { return 0; }
+double SQLiteDatabase::Row::getDouble(int /*columnIndex*/) const { return 0.0; }
+std::string SQLiteDatabase::Row::getText(int /*columnIndex*/) const { return ""; }
+std::vector<uint8_t> SQLiteDatabase::Row::getBlob(int /*columnIndex*/) const { return {}; }
+bool SQLiteDatabase::Row::isNull(int /*columnIndex*/) const { return true; }
+std::string_view SQLiteDatabase::Row::getTextView(int /*columnIndex*/) const { return std::string_view(); }
+SQLiteDatabase::BlobView SQLiteDatabase::Row::getBlobView(int /*columnIndex*/) const { return BlobView(); }
+SQLiteDatabase::ColumnType SQLiteDatabase::Row::getColumnType(int /*columnIndex*/) const { return ColumnType::Null; }
+int SQLiteDatabase::Row::getInt(const std::string& /*columnName*/) const { return 0; }
+long long SQLiteDatabase::Row::getInt64(const std::string& /*columnName*/) const { return 0; }
+double SQLiteDatabase::Row::getDouble(const std::string& /*columnName*/) const { return 0.0; }
+std::string SQLiteDatabase::Row::getText(const std::string& /*columnName*/) const { return ""; }
+std::vector<uint8_t> SQLiteDatabase::Row::getBlob(const std::string& /*columnName*/) const { return {}; }
+bool SQLiteDatabase::Row::isNull(const std::string& /*columnName*/) const { return true; }
 int SQLiteDatabase::Row::getColumnCount() const { return 0; }
-std::string SQLiteDatabase::Row::getColumnName(int columnIndex) const { return ""; }
-int SQLiteDatabase::Row::getColumnIndex(const std::string& columnName) const { return -1; }
+std::string SQLiteDatabase::Row::getColumnName(int /*columnIndex*/) const { return ""; }
+int SQLiteDatabase::Row::getColumnIndex(const std::string& /*columnName*/) const { return -1; }
 
-SQLiteDatabase::Statement::Statement(sqlite3* db, const std::string& sql) : stmt_(nullptr), valid_(false) {}
+SQLiteDatabase::Statement::Statement(sqlite3* /*db*/, const std::string& /*sql*/) : stmt_(nullptr), valid_(false) {}
 SQLiteDatabase::Statement::~Statement() {}
-SQLiteDatabase::Statement::Statement(Statement&& other) noexcept : stmt_(nullptr), valid_(false) {}
-SQLiteDatabase::Statement& SQLiteDatabase::Statement::operator=(Statement&& other) noexcept { return *this; }
-bool SQLiteDatabase::Statement::bindInt(int paramIndex, int value) { return false; }
-bool SQLiteDatabase::Statement::bindInt64(int paramIndex, long long value) { return false; }
-bool SQLiteDatabase::Statement::bindDouble(int paramIndex, double value) { return false; }
-bool SQLiteDatabase::Statement::bindText(int paramIndex, const std::string& value) { return false; }
-bool SQLiteDatabase::Statement::bindBlob(int paramIndex, const std::vector<uint8_t>& value) { return false; }
-bool SQLiteDatabase::Statement::bindNull(int paramIndex) { return false; }
-bool SQLiteDatabase::Statement::bindInt(const std::string& paramName, int value) { return false; }
-bool SQLiteDatabase::Statement::bindInt64(const std::string& paramName, long long value) { return false; }
-bool SQLiteDatabase::Statement::bindDouble(const std::string& paramName, double value) { return false; }
-bool SQLiteDatabase::Statement::bindText(const std::string& paramName, const std::string& value) { return false; }
-bool SQLiteDatabase::Statement::bindBlob(const std::string& paramName, const std::vector<uint8_t>& value) { return false; }
-bool SQLiteDatabase::Statement::bindNull(const std::string& paramName) { return false; }
+SQLiteDatabase::Statement::Statement(Statement&& /*other*/) noexcept : stmt_(nullptr), valid_(false) {}
+SQLiteDatabase::Statement& SQLiteDatabase::Statement::operator=(Statement&& /*other*/) noexcept { return *this; }
+bool SQLiteDatabase::Statement::bindInt(int /*paramIndex*/, int /*value*/) { return false; }
+bool SQLiteDatabase::Statement::bindInt64(int /*paramIndex*/, long long /*value*/) { return false; }
+bool SQLiteDatabase::Statement::bindDouble(int /*paramIndex*/, double /*value*/) { return false; }
+bool SQLiteDatabase::Statement::bindText(int /*paramIndex*/, const std::string& /*value*/) { return false; }
+bool SQLiteDatabase::Statement::bindBlob(int /*paramIndex*/, const std::vector<uint8_t>& /*value*/) { return false; }
+bool SQLiteDatabase::Statement::bindNull(int /*paramIndex*/) { return false; }
+bool SQLiteDatabase::Statement::bindTextView(int /*paramIndex*/, std::string_view /*value*/) { return false; }
+bool SQLiteDatabase::Statement::bindBlobView(int /*paramIndex*/, const void* /*data*/, size_t /*size*/) { return false; }
+bool SQLiteDatabase::Statement::clearBindings() { return false; }
+bool SQLiteDatabase::Statement::bindZeroBlob(int /*paramIndex*/, size_t /*size*/) { return false; }
+bool SQLiteDatabase::Statement::bindInt(const std::string& /*paramName*/, int /*value*/) { return false; }
+bool SQLiteDatabase::Statement::bindInt64(const std::string& /*paramName*/, long long /*value*/) { return false; }
+bool SQLiteDatabase::Statement::bindDouble(const std::string& /*paramName*/, double /*value*/) { return false; }
+bool SQLiteDatabase::Statement::bindText(const std::string& /*paramName*/, const std::string& /*value*/) { return false; }
+bool SQLiteDatabase::Statement::bindBlob(const std::string& /*paramName*/, const std::vector<uint8_t>& /*value*/) { return false; }
+bool SQLiteDatabase::Statement::bindNull(const std::string& /*paramName*/) { return false; }
 bool SQLiteDatabase::Statement::step() { return false; }
+bool SQLiteDatabase::Statement::execute() { return false; }
 bool SQLiteDatabase::Statement::reset() { return false; }
 SQLiteDatabase::Row SQLiteDatabase::Statement::getCurrentRow() const { return Row(nullptr); }
+bool SQLiteDatabase::Statement::forEachRow(const std::function<bool(const Row&)>& /*visitor*/) { return false; }
 int SQLiteDatabase::Statement::getParameterCount() const { return 0; }
-int SQLiteDatabase::Statement::getParameterIndex(const std::string& paramName) const { return 0; }
+int SQLiteDatabase::Statement::getParameterIndex(const std::string& /*paramName*/) const { return 0; }
 bool SQLiteDatabase::Statement::isValid() const { return false; }
 
+struct SQLiteDatabase::StatementCache {};
+SQLiteDatabase::CachedStatement::CachedStatement(std::shared_ptr<StatementCache> /*cache*/, std::string /*sql*/,
+                                                 std::unique_ptr<Statement> /*stmt*/, uint64_t /*connection*/) {}
+SQLiteDatabase::CachedStatement::~CachedStatement() {}
+SQLiteDatabase::CachedStatement::CachedStatement(CachedStatement&& /*other*/) noexcept {}
+SQLiteDatabase::CachedStatement& SQLiteDatabase::CachedStatement::operator=(CachedStatement&& /*other*/) noexcept { return *this; }
+void SQLiteDatabase::CachedStatement::release() {}
+SQLiteDatabase::BulkInsert::BulkInsert(SQLiteDatabase& db, const std::string& table,
+                                       const std::vector<std::string>& columns, size_t /*max_rows_per_statement*/)
+    : db_(db), table_(table), columns_(columns), rows_per_statement_(1) {}
+SQLiteDatabase::BulkInsert::Value* SQLiteDatabase::BulkInsert::currentValue(size_t /*column*/) { return nullptr; }
+bool SQLiteDatabase::BulkInsert::bindInt64(size_t /*column*/, long long /*value*/) { return false; }
+bool SQLiteDatabase::BulkInsert::bindDouble(size_t /*column*/, double /*value*/) { return false; }
+bool SQLiteDatabase::BulkInsert::bindTextView(size_t /*column*/, std::string_view /*value*/) { return false; }
+bool SQLiteDatabase::BulkInsert::bindBlobView(size_t /*column*/, const void* /*data*/, size_t /*size*/) { return false; }
+bool SQLiteDatabase::BulkInsert::bindNull(size_t /*column*/) { return false; }
+bool SQLiteDatabase::BulkInsert::endRow() { return false; }
+bool SQLiteDatabase::BulkInsert::flush() { return false; }
+bool SQLiteDatabase::BulkInsert::executeBatch(size_t /*rows*/) { return false; }
+
 SQLiteDatabase::SQLiteDatabase() : db_(nullptr), isOpen_(false) {
     LEAFRA_WARNING() << "SQLite not available - using stub implementation";
 }
 SQLiteDatabase::~SQLiteDatabase() {}
-SQLiteDatabase::SQLiteDatabase(SQLiteDatabase&& other) noexcept : db_(nullptr), isOpen_(false) {}
-SQLiteDatabase& SQLiteDatabase::operator=(SQLiteDatabase&& other) noexcept { return *this; }
-bool SQLiteDatabase::open(const std::string& path, int flags) { 
+SQLiteDatabase::SQLiteDatabase(SQLiteDatabase&& /*other*/) noexcept : db_(nullptr), isOpen_(false) {}
+SQLiteDatabase& SQLiteDatabase::operator=(SQLiteDatabase&& /*other*/) noexcept { return *this; }
+bool SQLiteDatabase::open(const std::string& /*path*/, int /*flags*/) { 
     LEAFRA_ERROR() << "SQLite not available - cannot open database";
     return false; 
 }
+bool SQLiteDatabase::openFile(const std::string& /*path*/, int /*flags*/) { return false; }
 bool SQLiteDatabase::openMemory() { return false; }
 void SQLiteDatabase::close() {}
 bool SQLiteDatabase::isOpen() const { return false; }
-bool SQLiteDatabase::execute(const std::string& sql) { return false; }
-bool SQLiteDatabase::execute(const std::string& sql, const std::function<bool(const Row&)>& rowCallback) { return false; }
-std::unique_ptr<SQLiteDatabase::Statement> SQLiteDatabase::prepare(const std::string& sql) { return nullptr; }
+void SQLiteDatabase::setConfig(const DatabaseConfig& config) { config_ = config; }
+const DatabaseConfig& SQLiteDatabase::getConfig() const { return config_; }
+void SQLiteDatabase::applyConnectionProfile() {}
+bool SQLiteDatabase::execute(const std::string& /*sql*/) { return false; }
+bool SQLiteDatabase::execute(const std::string& /*sql*/, const std::function<bool(const Row&)>& /*rowCallback*/) { return false; }
+std::unique_ptr<SQLiteDatabase::Statement> SQLiteDatabase::prepare(const std::string& /*sql*/) { return nullptr; }
+SQLiteDatabase::CachedStatement SQLiteDatabase::prepareCached(const std::string& /*sql*/) { return CachedStatement(); }
+std::unique_ptr<SQLiteDatabase::BlobHandle> SQLiteDatabase::openBlob(const std::string& /*table*/, const std::string& /*column*/, int64_t /*rowid*/, bool /*writable*/) { return nullptr; }
+SQLiteDatabase::BlobHandle::BlobHandle(sqlite3_blob* /*blob*/) : blob_(nullptr) {}
+SQLiteDatabase::BlobHandle::~BlobHandle() {}
+SQLiteDatabase::BlobHandle::BlobHandle(BlobHandle&& /*other*/) noexcept : blob_(nullptr) {}
+SQLiteDatabase::BlobHandle& SQLiteDatabase::BlobHandle::operator=(BlobHandle&& /*other*/) noexcept { return *this; }
+size_t SQLiteDatabase::BlobHandle::size() const { return 0; }
+bool SQLiteDatabase::BlobHandle::read(void* /*data*/, size_t /*size*/, size_t /*offset*/) { return false; }
+bool SQLiteDatabase::BlobHandle::write(const void* /*data*/, size_t /*size*/, size_t /*offset*/) { return false; }
+SQLiteDatabase::StatementCacheStats SQLiteDatabase::getStatementCacheStats() const { return StatementCacheStats(); }
+void SQLiteDatabase::clearStatementCache() {}
+bool SQLiteDatabase::addColumnIfMissing(const std::string& /*table*/, const std::string& /*column*/, const std::string& /*definition*/) { return false; }
+bool SQLiteDatabase::createChunkKeywordIndex() { return false; }
+bool SQLiteDatabase::createDocTextTable() { return false; }
+bool SQLiteDatabase::createDocCentroidsTable() { return false; }
+bool SQLiteDatabase::createChunkEmbeddingsTable() { return false; }
+bool SQLiteDatabase::createChunkLLMTokensTable() { return false; }
+bool SQLiteDatabase::createChunkRetrievalsTable() { return false; }
+bool SQLiteDatabase::createIngestionQueueTable() { return false; }
+bool SQLiteDatabase::createEmbeddingCacheTable() { return false; }
+bool SQLiteDatabase::createIndexModelsTable() { return false; }
+bool SQLiteDatabase::createShadowEmbeddingsTable() { return false; }
+bool SQLiteDatabase::dropShadowEmbeddingsTable() { return false; }
+bool SQLiteDatabase::createChunkIdSequence() { return false; }
+bool SQLiteDatabase::allocateIds(const std::string& /*sequence*/, int64_t /*count*/, int64_t& /*first_id*/) { return false; }
+bool SQLiteDatabase::createSyncLogTable() { return false; }
 bool SQLiteDatabase::beginTransaction() { return false; }
 bool SQLiteDatabase::commitTransaction() { return false; }
 bool SQLiteDatabase::rollbackTransaction() { return false; }
@@ -791,11 +2224,21 @@ int SQLiteDatabase::getLastInsertRowId() const { return 0; }
 int SQLiteDatabase::getChanges() const { return 0; }
 int SQLiteDatabase::getTotalChanges() const { return 0; }
 std::string SQLiteDatabase::getVersion() const { return "SQLite not available"; }
+std::string SQLiteDatabase::getPath() const { return ""; }
 int SQLiteDatabase::getLastErrorCode() const { return -1; }
 std::string SQLiteDatabase::getLastErrorMessage() const { return "SQLite not available"; }
 std::string SQLiteDatabase::escapeString(const std::string& str) { return str; }
 bool SQLiteDatabase::fileExists(const std::string& path) { return std::filesystem::exists(path); }
-bool SQLiteDatabase::createdb(const std::string& path) { 
+void SQLiteDatabase::getMemoryUsage(int64_t& used_bytes, int64_t& highwater_bytes, bool) { used_bytes = 0; highwater_bytes = 0; }
+int64_t SQLiteDatabase::getCacheMemoryUsage() const { return 0; }
+int64_t SQLiteDatabase::releaseCacheMemory() { return 0; }
+bool SQLiteDatabase::getSpaceStats(SpaceStats& /*stats*/) { return false; }
+int64_t SQLiteDatabase::incrementalVacuum(int64_t /*pages*/) { return -1; }
+bool SQLiteDatabase::vacuumInto(const std::string& /*absolute_path*/) { return false; }
+bool SQLiteDatabase::restoreFrom(const std::string& /*absolute_path*/) { return false; }
+bool SQLiteDatabase::backupTo(const std::string& /*absolute_path*/, int /*pages_per_step*/, int /*pause_ms*/,
+                              const std::function<bool(int remaining, int total)>& /*progress*/) { return false; }
+bool SQLiteDatabase::createdb(const std::string& /*path*/, const DatabaseConfig& /*config*/) { 
     LEAFRA_ERROR() << "SQLite not available - cannot create database";
     return false; 
 }
@@ -805,7 +2248,7 @@ bool SQLiteDatabase::createRAGTables() {
 }
 void SQLiteDatabase::cleanup() {}
 
-SQLiteTransaction::SQLiteTransaction(SQLiteDatabase& db) : db_(db), committed_(false), active_(false) {}
+SQLiteTransaction::SQLiteTransaction(SQLiteDatabase& db) : db_(db), committed_(false), active_(false), span_("sqlite", "transaction") {}
 SQLiteTransaction::~SQLiteTransaction() {}
 bool SQLiteTransaction::commit() { return false; }
 void SQLiteTransaction::rollback() {}
@@ -813,4 +2256,270 @@ bool SQLiteTransaction::isActive() const { return false; }
 
 #endif // LEAFRA_HAS_SQLITE
 
-} // namespace leafra 
\ No newline at end of file
+SQLiteReadPool::Lease::Lease(SQLiteReadPool* pool, SQLiteDatabase* db) : pool_(pool), db_(db) {}
+
+SQLiteReadPool::Lease::~Lease() {
+    release();
+}
+
+SQLiteReadPool::Lease::Lease(Lease&& other) noexcept : pool_(other.pool_), db_(other.db_) {
+    other.pool_ = nullptr;
+    other.db_ = nullptr;
+}
+
+SQLiteReadPool::Lease& SQLiteReadPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        db_ = other.db_;
+        other.pool_ = nullptr;
+        other.db_ = nullptr;
+    }
+    return *this;
+}
+
+void SQLiteReadPool::Lease::release() {
+    if (pool_ && db_) {
+        pool_->release(db_);
+    }
+    pool_ = nullptr;
+    db_ = nullptr;
+}
+
+SQLiteReadPool::~SQLiteReadPool() {
+    close();
+}
+
+bool SQLiteReadPool::open(const std::string& absolute_path, const DatabaseConfig& config, size_t connections) {
+    close();
+    
+    // journal_mode, page_size and auto_vacuum are the writer's to set
+    DatabaseConfig reader_config = config;
+    reader_config.journal_mode.clear();
+    reader_config.page_size = 0;
+    reader_config.auto_vacuum.clear();
+    
+    std::vector<std::unique_ptr<SQLiteDatabase>> opened;
+    for (size_t i = 0; i < connections; ++i) {
+        auto connection = std::make_unique<SQLiteDatabase>();
+        connection->setConfig(reader_config);
+        if (!connection->openFile(absolute_path, static_cast<int>(SQLiteDatabase::OpenFlags::ReadOnly))) {
+            LEAFRA_ERROR() << "Failed to open read connection " << i + 1 << " of " << connections << " to " << absolute_path;
+            return false;
+        }
+        opened.push_back(std::move(connection));
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections_ = std::move(opened);
+    for (const auto& connection : connections_) {
+        idle_.push_back(connection.get());
+    }
+    return true;
+}
+
+void SQLiteReadPool::close() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    returned_.wait(lock, [this]() { return idle_.size() == connections_.size(); });
+    idle_.clear();
+    connections_.clear();
+    lock.unlock();
+    returned_.notify_all();
+}
+
+size_t SQLiteReadPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return connections_.size();
+}
+
+int64_t SQLiteReadPool::getCacheMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t bytes = 0;
+    for (const SQLiteDatabase* db : idle_) {
+        bytes += db->getCacheMemoryUsage();
+    }
+    return bytes;
+}
+
+int64_t SQLiteReadPool::releaseCacheMemory() {
+    // Leased connections are busy with a query; they are left alone
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t freed = 0;
+    for (SQLiteDatabase* db : idle_) {
+        freed += db->releaseCacheMemory();
+    }
+    return freed;
+}
+
+SQLiteReadPool::Lease SQLiteReadPool::acquire(SQLiteDatabase* fallback) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    returned_.wait(lock, [this]() { return !idle_.empty() || connections_.empty(); });
+    if (connections_.empty()) {
+        return Lease(nullptr, fallback);
+    }
+    SQLiteDatabase* db = idle_.back();
+    idle_.pop_back();
+    return Lease(this, db);
+}
+
+void SQLiteReadPool::release(SQLiteDatabase* db) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(db);
+    }
+    returned_.notify_all();
+}
+
+
+SQLiteWriter::SQLiteWriter(SQLiteDatabase& db, size_t max_jobs, int32_t max_delay_ms, size_t max_queued)
+    : db_(db),
+      max_jobs_(std::max<size_t>(max_jobs, 1)),
+      max_delay_(std::max<int32_t>(max_delay_ms, 0)),
+      max_queued_(max_queued) {
+    thread_ = std::thread(&SQLiteWriter::run, this);
+}
+
+SQLiteWriter::~SQLiteWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    changed_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+std::future<bool> SQLiteWriter::submit(Job job, Committed committed) {
+    QueuedJob queued;
+    queued.job = std::move(job);
+    queued.committed = std::move(committed);
+    std::future<bool> future = queued.done.get_future();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this]() { return max_queued_ == 0 || queue_.size() < max_queued_ || stopping_; });
+        if (!stopping_) {
+            queue_.push_back(std::move(queued));
+            submitted_++;
+            lock.unlock();
+            changed_.notify_all();
+            return future;
+        }
+    }
+    LEAFRA_ERROR() << "SQLite writer is stopping, write rejected";
+    if (queued.committed) {
+        queued.committed(false);
+    }
+    queued.done.set_value(false);
+    return future;
+}
+
+void SQLiteWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const size_t target = submitted_;
+    flush_waiters_++;
+    changed_.notify_all();
+    changed_.wait(lock, [this, target]() { return completed_ >= target; });
+    flush_waiters_--;
+}
+
+size_t SQLiteWriter::commit_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return commits_;
+}
+
+size_t SQLiteWriter::job_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return completed_;
+}
+
+void SQLiteWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (queue_.empty()) {
+            if (!group_) {
+                if (stopping_) {
+                    break;
+                }
+                changed_.wait(lock);
+                continue;
+            }
+            // Commit the open group when it is due, someone waits on it or the writer stops
+            if (!stopping_ && flush_waiters_ == 0 && std::chrono::steady_clock::now() < group_deadline_) {
+                changed_.wait_until(lock, group_deadline_);
+                continue;
+            }
+            lock.unlock();
+            {
+                std::lock_guard<std::mutex> connection(connection_mutex_);
+                commitGroup();
+            }
+            lock.lock();
+            continue;
+        }
+        
+        QueuedJob queued = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+        changed_.notify_all();   // Room for a blocked submit
+        {
+            std::lock_guard<std::mutex> connection(connection_mutex_);
+            if (!group_) {
+                group_ = std::make_unique<SQLiteTransaction>(db_);
+                group_deadline_ = std::chrono::steady_clock::now() + max_delay_;
+            }
+            RunJob ran;
+            ran.committed = std::move(queued.committed);
+            ran.done = std::move(queued.done);
+            {
+                SQLiteTransaction savepoint(db_);
+                try {
+                    ran.succeeded = queued.job(db_);
+                } catch (const std::exception& e) {
+                    LEAFRA_ERROR() << "Exception in queued SQLite write: " << e.what();
+                    ran.succeeded = false;
+                }
+                if (ran.succeeded) {
+                    ran.succeeded = savepoint.commit();
+                } else {
+                    savepoint.rollback();
+                }
+            }
+            queued.job = nullptr;   // Let go of what the job captured before the group commits
+            group_jobs_.push_back(std::move(ran));
+            if (group_jobs_.size() >= max_jobs_) {
+                commitGroup();
+            }
+        }
+        lock.lock();
+    }
+}
+
+void SQLiteWriter::commitGroup() {
+    bool committed = true;
+    if (group_ && group_->isActive()) {
+        committed = group_->commit();
+        if (!committed) {
+            LEAFRA_ERROR() << "Group commit of " << group_jobs_.size() << " writes failed: " << db_.getLastErrorMessage();
+        }
+    }
+    group_.reset();   // Rolls back if the commit failed
+    
+    std::vector<RunJob> jobs;
+    jobs.swap(group_jobs_);
+    for (RunJob& job : jobs) {
+        const bool durable = committed && job.succeeded;
+        if (job.committed) {
+            job.committed(durable);
+        }
+        job.done.set_value(durable);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        completed_ += jobs.size();
+        commits_++;
+    }
+    changed_.notify_all();
+}
+
+} // namespace leafra 
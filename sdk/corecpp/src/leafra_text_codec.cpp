@@ -0,0 +1,223 @@
+#include "leafra/leafra_text_codec.h"
+#include <cstring>
+
+namespace leafra {
+
+namespace {
+
+constexpr int kHashBits = 12;
+constexpr size_t kMinMatch = 4;
+constexpr size_t kMaxOffset = 65535;
+constexpr size_t kLastLiterals = 5;         // LZ4: the last 5 bytes are always literals
+constexpr size_t kMatchStartLimit = 12;     // LZ4: the last match starts at least 12 bytes before the end
+
+uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t hash4(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+void write_length(size_t length, std::vector<uint8_t>& out) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+bool read_length(const uint8_t* input, size_t size, size_t& pos, size_t& length) {
+    uint8_t byte;
+    do {
+        if (pos >= size) {
+            return false;
+        }
+        byte = input[pos++];
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+// Literal run then, unless it's the last sequence, a match
+void write_sequence(const uint8_t* literals, size_t literal_length, size_t offset, size_t match_length,
+                    std::vector<uint8_t>& out) {
+    const size_t match_code = match_length >= kMinMatch ? match_length - kMinMatch : 0;
+    uint8_t token = static_cast<uint8_t>((literal_length < 15 ? literal_length : 15) << 4);
+    if (match_length >= kMinMatch) {
+        token |= static_cast<uint8_t>(match_code < 15 ? match_code : 15);
+    }
+    out.push_back(token);
+    if (literal_length >= 15) {
+        write_length(literal_length - 15, out);
+    }
+    out.insert(out.end(), literals, literals + literal_length);
+    if (match_length < kMinMatch) {
+        return;
+    }
+    out.push_back(static_cast<uint8_t>(offset & 0xff));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (match_code >= 15) {
+        write_length(match_code - 15, out);
+    }
+}
+
+void write_varint(uint64_t value, std::vector<uint8_t>& out) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool read_varint(const uint8_t* data, size_t size, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < size; shift += 7) {
+        const uint8_t byte = data[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool TextCodec::parse_compression(const std::string& name, TextCompression& compression) {
+    if (name == "none") { compression = TextCompression::NONE; return true; }
+    if (name == "lz4") { compression = TextCompression::LZ4; return true; }
+    return false;
+}
+
+bool TextCodec::compress(std::string_view text, TextCompression compression, std::vector<uint8_t>& out) {
+    out.clear();
+    if (compression != TextCompression::LZ4 || text.empty()) {
+        return false;
+    }
+    out.push_back(static_cast<uint8_t>(compression));
+    write_varint(text.size(), out);
+    lz4_compress(reinterpret_cast<const uint8_t*>(text.data()), text.size(), out);
+    if (out.size() >= text.size()) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+bool TextCodec::decompress(const uint8_t* data, size_t size, std::string& out) {
+    out.clear();
+    if (!data || size == 0 || data[0] != static_cast<uint8_t>(TextCompression::LZ4)) {
+        return false;
+    }
+    size_t pos = 1;
+    uint64_t original_size = 0;
+    // LZ4 expands at most 255:1, which also bounds what a corrupt size can make us allocate
+    if (!read_varint(data, size, pos, original_size) || original_size > (size - pos) * 255) {
+        return false;
+    }
+    out.resize(static_cast<size_t>(original_size));
+    if (!lz4_decompress(data + pos, size - pos, &out[0], out.size())) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+void TextCodec::encode_tokens(const std::vector<int32_t>& tokens, std::vector<uint8_t>& out) {
+    out.clear();
+    out.reserve(tokens.size() * 2);
+    for (int32_t token : tokens) {
+        write_varint(static_cast<uint32_t>(token), out);
+    }
+}
+
+bool TextCodec::decode_tokens(const uint8_t* data, size_t size, std::vector<int32_t>& out) {
+    out.clear();
+    out.reserve(size / 2);
+    size_t pos = 0;
+    while (pos < size) {
+        uint64_t value = 0;
+        if (!read_varint(data, size, pos, value) || value > 0x7fffffffu) {
+            out.clear();
+            return false;
+        }
+        out.push_back(static_cast<int32_t>(value));
+    }
+    return true;
+}
+
+void TextCodec::lz4_compress(const uint8_t* input, size_t size, std::vector<uint8_t>& out) {
+    size_t anchor = 0;
+    if (size >= kMatchStartLimit + 1) {
+        // Greedy single-probe matcher: last position of each 4-byte hash (offset + 1, 0 = empty)
+        std::vector<uint32_t> table(size_t(1) << kHashBits, 0);
+        const size_t match_end_limit = size - kLastLiterals;
+        size_t pos = 0;
+        while (pos + kMatchStartLimit <= size) {
+            const uint32_t sequence = read32(input + pos);
+            uint32_t& slot = table[hash4(sequence)];
+            const size_t candidate = slot;
+            slot = static_cast<uint32_t>(pos + 1);
+            if (candidate == 0 || pos - (candidate - 1) > kMaxOffset || read32(input + candidate - 1) != sequence) {
+                pos++;
+                continue;
+            }
+            const size_t match = candidate - 1;
+            size_t length = kMinMatch;
+            while (pos + length < match_end_limit && input[match + length] == input[pos + length]) {
+                length++;
+            }
+            write_sequence(input + anchor, pos - anchor, pos - match, length, out);
+            pos += length;
+            anchor = pos;
+        }
+    }
+    write_sequence(input + anchor, size - anchor, 0, 0, out);
+}
+
+bool TextCodec::lz4_decompress(const uint8_t* input, size_t size, char* out, size_t original_size) {
+    size_t in = 0;
+    size_t written = 0;
+    while (in < size) {
+        const uint8_t token = input[in++];
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !read_length(input, size, in, literal_length)) {
+            return false;
+        }
+        if (literal_length > size - in || literal_length > original_size - written) {
+            return false;
+        }
+        std::memcpy(out + written, input + in, literal_length);
+        in += literal_length;
+        written += literal_length;
+        if (in == size) {
+            break;                          // Last sequence has no match
+        }
+
+        if (size - in < 2) {
+            return false;
+        }
+        const size_t offset = input[in] | (static_cast<size_t>(input[in + 1]) << 8);
+        in += 2;
+        size_t match_length = token & 0x0f;
+        if (match_length == 15 && !read_length(input, size, in, match_length)) {
+            return false;
+        }
+        match_length += kMinMatch;
+        if (offset == 0 || offset > written || match_length > original_size - written) {
+            return false;
+        }
+        // Matches may overlap what they produce, so copy forward byte by byte
+        const char* from = out + written - offset;
+        for (size_t i = 0; i < match_length; ++i) {
+            out[written + i] = from[i];
+        }
+        written += match_length;
+    }
+    return written == original_size;
+}
+
+} // namespace leafra
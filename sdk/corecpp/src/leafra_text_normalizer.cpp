@@ -0,0 +1,374 @@
+#include "leafra/leafra_text_normalizer.h"
+#include "leafra/leafra_unicode.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef LEAFRA_HAS_ICU
+#include <unicode/uchar.h>
+#include <unicode/unorm2.h>
+#include <unicode/ustring.h>
+#include <unicode/utf8.h>
+#endif
+
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+#include <arm_neon.h>
+#define LEAFRA_SIMD_NEON 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define LEAFRA_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LEAFRA_SIMD_SSE2 1
+#endif
+
+namespace leafra {
+
+size_t plain_ascii_run_length(const char* data, size_t size, bool check_spaces, bool check_hyphens) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(data);
+    size_t i = 0;
+#if defined(LEAFRA_SIMD_NEON)
+    const uint8x16_t hyphen_mask = vdupq_n_u8(check_hyphens ? 0xff : 0);
+    const uint8x16_t space_mask = vdupq_n_u8(check_spaces ? 0xff : 0);
+    for (; i + 17 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(s + i);
+        uint8x16_t next = vld1q_u8(s + i + 1);
+        uint8x16_t bad = vorrq_u8(vcltq_u8(v, vdupq_n_u8(0x20)), vcgtq_u8(v, vdupq_n_u8(0x7e)));
+        bad = vorrq_u8(bad, vandq_u8(vceqq_u8(v, vdupq_n_u8('-')), hyphen_mask));
+        uint8x16_t double_space = vandq_u8(vceqq_u8(v, vdupq_n_u8(' ')), vceqq_u8(next, vdupq_n_u8(' ')));
+        bad = vorrq_u8(bad, vandq_u8(double_space, space_mask));
+        if (vmaxvq_u8(bad) != 0) break;
+    }
+#elif defined(LEAFRA_SIMD_AVX2)
+    // Signed compares: bytes >= 0x80 are negative and fall below 0x20
+    const __m256i hyphen_mask = _mm256_set1_epi8(check_hyphens ? -1 : 0);
+    const __m256i space_mask = _mm256_set1_epi8(check_spaces ? -1 : 0);
+    for (; i + 33 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + 1));
+        __m256i printable = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(0x1f)),
+                                             _mm256_cmpgt_epi8(_mm256_set1_epi8(0x7f), v));
+        __m256i hyphen = _mm256_and_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('-')), hyphen_mask);
+        __m256i double_space = _mm256_and_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                                _mm256_cmpeq_epi8(next, _mm256_set1_epi8(' ')));
+        __m256i bad = _mm256_or_si256(hyphen, _mm256_and_si256(double_space, space_mask));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(bad)) |
+                        ~static_cast<unsigned>(_mm256_movemask_epi8(printable));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+#elif defined(LEAFRA_SIMD_SSE2)
+    // Signed compares: bytes >= 0x80 are negative and fall below 0x20
+    const __m128i hyphen_mask = _mm_set1_epi8(check_hyphens ? -1 : 0);
+    const __m128i space_mask = _mm_set1_epi8(check_spaces ? -1 : 0);
+    for (; i + 17 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 1));
+        __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(0x1f)),
+                                          _mm_cmplt_epi8(v, _mm_set1_epi8(0x7f)));
+        __m128i hyphen = _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('-')), hyphen_mask);
+        __m128i double_space = _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                             _mm_cmpeq_epi8(next, _mm_set1_epi8(' ')));
+        __m128i bad = _mm_or_si128(hyphen, _mm_and_si128(double_space, space_mask));
+        unsigned mask = (static_cast<unsigned>(_mm_movemask_epi8(bad)) |
+                         ~static_cast<unsigned>(_mm_movemask_epi8(printable))) & 0xffffu;
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+#endif
+    for (; i < size; ++i) {
+        uint8_t c = s[i];
+        if (c < 0x20 || c > 0x7e || (check_hyphens && c == '-') ||
+            (check_spaces && c == ' ' && i + 1 < size && s[i + 1] == ' ')) {
+            break;
+        }
+    }
+    return i;
+}
+
+bool text_normalization_has_nfkc() {
+#ifdef LEAFRA_HAS_ICU
+    UErrorCode status = U_ZERO_ERROR;
+    return unorm2_getNFKCInstance(&status) != nullptr && U_SUCCESS(status);
+#else
+    return false;
+#endif
+}
+
+namespace {
+
+#ifdef LEAFRA_HAS_ICU
+/**
+ * @brief NFKC over the non-ASCII stretches of text; the string is rebuilt only if one changes
+ *
+ * A stretch starts at the ASCII character before the first non-ASCII byte (a combining mark can
+ * attach to it) and ends at an ASCII character followed by another ASCII byte: nothing composes
+ * across that point, so each stretch normalizes independently.
+ */
+bool apply_nfkc(std::string& text) {
+    const size_t size = text.size();
+    size_t i = ascii_run_length(text.data(), size);
+    if (i == size) {
+        return false;   // ASCII is NFKC already; the normalization data is never touched
+    }
+
+    ensure_icu_data();
+    UErrorCode status = U_ZERO_ERROR;
+    const UNormalizer2* nfkc = unorm2_getNFKCInstance(&status);
+    if (U_FAILURE(status) || !nfkc) {
+        return false;
+    }
+
+    std::string rebuilt;
+    size_t copied = 0;
+    bool changed = false;
+    std::vector<UChar> source;
+    std::vector<UChar> normalized;
+    std::string utf8;
+
+    while (i < size) {
+        size_t start = i > 0 ? i - 1 : 0;
+        size_t end = i;
+        while (end < size) {
+            while (end < size && static_cast<uint8_t>(text[end]) >= 0x80) {
+                ++end;
+            }
+            if (end + 1 >= size || static_cast<uint8_t>(text[end + 1]) < 0x80) {
+                break;
+            }
+            ++end;
+        }
+
+        // UTF-8 -> UTF-16 (invalid UTF-8 leaves the stretch untouched)
+        int32_t length = static_cast<int32_t>(end - start);
+        int32_t units = 0;
+        source.resize(static_cast<size_t>(length) + 1);
+        status = U_ZERO_ERROR;
+        u_strFromUTF8(source.data(), static_cast<int32_t>(source.size()), &units, text.data() + start, length, &status);
+        if (U_SUCCESS(status) && unorm2_quickCheck(nfkc, source.data(), units, &status) != UNORM_YES && U_SUCCESS(status)) {
+            normalized.resize(static_cast<size_t>(units) * 3 + 16);
+            int32_t out_units = unorm2_normalize(nfkc, source.data(), units, normalized.data(),
+                                                 static_cast<int32_t>(normalized.size()), &status);
+            if (status == U_BUFFER_OVERFLOW_ERROR) {
+                status = U_ZERO_ERROR;
+                normalized.resize(static_cast<size_t>(out_units));
+                out_units = unorm2_normalize(nfkc, source.data(), units, normalized.data(), out_units, &status);
+            }
+            int32_t out_bytes = 0;
+            if (U_SUCCESS(status)) {
+                u_strToUTF8(nullptr, 0, &out_bytes, normalized.data(), out_units, &status);
+                if (status == U_BUFFER_OVERFLOW_ERROR) {
+                    status = U_ZERO_ERROR;
+                }
+            }
+            if (U_SUCCESS(status)) {
+                utf8.resize(static_cast<size_t>(out_bytes));
+                u_strToUTF8(&utf8[0], out_bytes, nullptr, normalized.data(), out_units, &status);
+                if (status == U_STRING_NOT_TERMINATED_WARNING) {
+                    status = U_ZERO_ERROR;
+                }
+            }
+            if (U_SUCCESS(status) && utf8.compare(0, utf8.size(), text, start, end - start) != 0) {
+                if (!changed) {
+                    rebuilt.reserve(size + size / 16);
+                    changed = true;
+                }
+                rebuilt.append(text, copied, start - copied);
+                rebuilt.append(utf8);
+                copied = end;
+            }
+        }
+        i = end + ascii_run_length(text.data() + end, size - end);
+    }
+
+    if (changed) {
+        rebuilt.append(text, copied, std::string::npos);
+        text.swap(rebuilt);
+    }
+    return changed;
+} //apply_nfkc
+
+// Whether the code point starting at data[0] is lowercase (so a hyphen before the line break split a word)
+bool starts_lowercase(const char* data, size_t size) {
+    uint8_t c = static_cast<uint8_t>(data[0]);
+    if (c < 0x80) {
+        return c >= 'a' && c <= 'z';
+    }
+    int32_t offset = 0;
+    UChar32 cp;
+    U8_NEXT(reinterpret_cast<const uint8_t*>(data), offset, static_cast<int32_t>(size), cp);
+    return cp >= 0 && u_islower(cp);
+}
+#else
+bool starts_lowercase(const char* data, size_t size) {
+    (void)size;
+    uint8_t c = static_cast<uint8_t>(data[0]);
+    return c >= 'a' && c <= 'z';
+}
+#endif
+
+} // anonymous namespace
+
+void normalize_text(std::string& text, const TextNormalizationOptions& options) {
+#ifdef LEAFRA_HAS_ICU
+    if (options.nfkc) {
+        apply_nfkc(text);
+    }
+#endif
+    if (!options.collapse_whitespace && !options.dehyphenate && !options.strip_control) {
+        return;
+    }
+
+    char* buffer = text.empty() ? nullptr : &text[0];
+    const size_t size = text.size();
+    size_t r = 0;                            // read position
+    size_t w = 0;                            // write position (never ahead of r)
+    bool pending_space = false;              // collapsed whitespace not written yet
+
+    auto at_line_start = [&]() { return w == 0 || buffer[w - 1] == '\n'; };
+    auto emit = [&](const char* bytes, size_t count) {
+        if (pending_space) {
+            buffer[w++] = ' ';
+            pending_space = false;
+        }
+        if (w != static_cast<size_t>(bytes - buffer)) {
+            std::memmove(buffer + w, bytes, count);
+        }
+        w += count;
+    };
+    auto horizontal_space = [&](const char* bytes, size_t count) {
+        if (!options.collapse_whitespace) {
+            emit(bytes, count);
+        } else if (!at_line_start()) {
+            pending_space = true;
+        }
+    };
+    auto newline = [&]() {
+        pending_space = false;           // spaces before a line break are dropped
+        // Keep paragraph breaks (one blank line) but no leading or repeated blank lines
+        if (options.collapse_whitespace &&
+            (w == 0 || (w >= 2 && buffer[w - 1] == '\n' && buffer[w - 2] == '\n'))) {
+            return;
+        }
+        buffer[w++] = '\n';
+    };
+    // For a hyphen ending just before after: returns where the next line's text starts if the word continues there
+    auto dehyphenation_target = [&](size_t after) -> size_t {
+        if (!options.dehyphenate || pending_space || w == 0) {
+            return 0;
+        }
+        uint8_t prev = static_cast<uint8_t>(buffer[w - 1]);
+        uint8_t lower = prev | 0x20;
+        if (!(prev >= 0x80 || (lower >= 'a' && lower <= 'z'))) {
+            return 0;
+        }
+        size_t p = after;
+        while (p < size && (buffer[p] == ' ' || buffer[p] == '\t' || buffer[p] == '\r')) {
+            ++p;
+        }
+        if (p >= size || buffer[p] != '\n') {
+            return 0;
+        }
+        ++p;
+        while (p < size && (buffer[p] == ' ' || buffer[p] == '\t')) {
+            ++p;
+        }
+        return p < size && starts_lowercase(buffer + p, size - p) ? p : 0;
+    };
+
+    while (r < size) {
+        // Fast path: plain ASCII is copied as is (or left in place while nothing has been removed)
+        if (!pending_space && !(options.collapse_whitespace && at_line_start())) {
+            size_t run = plain_ascii_run_length(buffer + r, size - r, options.collapse_whitespace, options.dehyphenate);
+            if (options.collapse_whitespace && run > 0 && buffer[r + run - 1] == ' ') {
+                --run;                       // a trailing space may precede a line break
+            }
+            if (run > 0) {
+                emit(buffer + r, run);
+                r += run;
+                continue;
+            }
+        }
+
+        const uint8_t c = static_cast<uint8_t>(buffer[r]);
+        if (c == ' ' || c == '\t') {
+            horizontal_space(buffer + r, 1);
+            ++r;
+        } else if (c == '\n') {
+            newline();
+            ++r;
+        } else if (c == '\r' || c == '\f' || c == '\v') {
+            if (!options.strip_control) {
+                emit(buffer + r, 1);
+            } else if (!(c == '\r' && r + 1 < size && buffer[r + 1] == '\n')) {
+                newline();         // CRLF: the LF writes the line break
+            }
+            ++r;
+        } else if (c < 0x20 || c == 0x7f) {
+            if (!options.strip_control) {
+                emit(buffer + r, 1);
+            }
+            ++r;
+        } else if (c == '-') {
+            size_t target = dehyphenation_target(r + 1);
+            if (target != 0) {
+                r = target;
+            } else {
+                emit(buffer + r, 1);
+                ++r;
+            }
+        } else if (c < 0x80) {
+            emit(buffer + r, 1);
+            ++r;
+        } else {
+            // Multi-byte sequence: a few code points get special treatment, the rest are copied
+            size_t length = c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : c >= 0xc0 ? 2 : 1;
+            if (r + length > size) {
+                length = size - r;
+            }
+            const uint8_t c1 = length > 1 ? static_cast<uint8_t>(buffer[r + 1]) : 0;
+            const uint8_t c2 = length > 2 ? static_cast<uint8_t>(buffer[r + 2]) : 0;
+            if (c == 0xc2 && c1 == 0xa0) {                                    // U+00A0 no-break space
+                horizontal_space(buffer + r, length);
+            } else if (c == 0xc2 && c1 == 0xad) {                             // U+00AD soft hyphen
+                size_t target = dehyphenation_target(r + length);
+                if (target != 0) {
+                    r = target;
+                    continue;
+                }
+                if (!options.strip_control) {
+                    emit(buffer + r, length);
+                }
+            } else if (c == 0xc2 && c1 >= 0x80 && c1 <= 0x9f) {               // C1 controls
+                if (!options.strip_control) {
+                    emit(buffer + r, length);
+                }
+            } else if ((c == 0xe2 && c1 == 0x80 && c2 == 0x8b) ||             // U+200B zero-width space
+                       (c == 0xef && c1 == 0xbb && c2 == 0xbf)) {             // U+FEFF byte order mark
+                if (!options.strip_control) {
+                    emit(buffer + r, length);
+                }
+            } else if (c == 0xe2 && c1 == 0x80 && (c2 == 0xa8 || c2 == 0xa9)) { // U+2028/9 line/paragraph separator
+                if (options.strip_control) {
+                    newline();
+                } else {
+                    emit(buffer + r, length);
+                }
+            } else {
+                emit(buffer + r, length);
+            }
+            r += length;
+        }
+    }
+
+    if (options.collapse_whitespace) {
+        while (w > 0 && buffer[w - 1] == '\n') {
+            --w;
+        }
+    }
+    text.resize(w);
+} //normalize_text
+
+} // namespace leafra
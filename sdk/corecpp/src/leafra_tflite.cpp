@@ -0,0 +1,527 @@
+#include "leafra/leafra_tflite.h"
+#include "leafra/logger.h"
+#include "leafra/leafra_trace.h"
+#include "leafra/leafra_model_registry.h"
+#include "leafra/leafra_simd.h"
+#include "leafra/leafra_hash.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// TensorFlow Lite C API headers
+#include "c_api.h"
+#include "c_api_types.h"
+
+// Delegates are optional - each one is only compiled in when its header ships with the prebuilt library
+#if __has_include("xnnpack_delegate.h")
+#include "xnnpack_delegate.h"
+#define LEAFRA_TFLITE_HAS_XNNPACK 1
+#endif
+
+#if defined(__APPLE__) && __has_include("coreml_delegate.h")
+#include "coreml_delegate.h"
+#define LEAFRA_TFLITE_HAS_COREML_DELEGATE 1
+#endif
+
+#if defined(__APPLE__) && __has_include("metal_delegate.h")
+#include "metal_delegate.h"
+#define LEAFRA_TFLITE_HAS_METAL_DELEGATE 1
+#endif
+
+#if defined(__ANDROID__) && __has_include("tensorflow/lite/delegates/gpu/delegate.h")
+#include "tensorflow/lite/delegates/gpu/delegate.h"
+#define LEAFRA_TFLITE_HAS_GPU_DELEGATE 1
+#endif
+
+#if defined(__ANDROID__) && __has_include("tensorflow/lite/delegates/nnapi/nnapi_delegate_c_api.h")
+#include "tensorflow/lite/delegates/nnapi/nnapi_delegate_c_api.h"
+#define LEAFRA_TFLITE_HAS_NNAPI_DELEGATE 1
+#endif
+
+namespace leafra {
+
+namespace {
+
+size_t elementsPerRow(const TfLiteTensor* tensor) {
+    int32_t dims = TfLiteTensorNumDims(tensor);
+    size_t elements = 1;
+    for (int32_t d = 1; d < dims; ++d) {
+        elements *= static_cast<size_t>(std::max(0, TfLiteTensorDim(tensor, d)));
+    }
+    return elements;
+}
+
+// Real values stored as-is, or as quantized integers of an int8/uint8 tensor
+struct Quantizer {
+    float scale = 0.0f;                     // 0 = not quantized
+    int32_t zero_point = 0;
+
+    template<typename T>
+    T apply(int value) const {
+        if constexpr (std::is_integral_v<T> && sizeof(T) == 1) {
+            if (scale != 0.0f) {
+                long quantized = std::lround(static_cast<float>(value) / scale) + zero_point;
+                return static_cast<T>(std::clamp<long>(quantized, std::numeric_limits<T>::min(), std::numeric_limits<T>::max()));
+            }
+        }
+        return static_cast<T>(value);
+    }
+};
+
+Quantizer quantizerOf(const TfLiteTensor* tensor) {
+    Quantizer quantizer;
+    TfLiteType type = TfLiteTensorType(tensor);
+    if (type == kTfLiteInt8 || type == kTfLiteUInt8) {
+        TfLiteQuantizationParams params = TfLiteTensorQuantizationParams(tensor);
+        quantizer.scale = params.scale;
+        quantizer.zero_point = params.zero_point;
+    }
+    return quantizer;
+}
+
+template<typename T>
+void writeRow(T* row_data, size_t length, const int* values, size_t count, int pad_value, const Quantizer& quantize) {
+    size_t real = std::min(count, length);
+    for (size_t i = 0; i < real; ++i) {
+        row_data[i] = quantize.apply<T>(values[i]);
+    }
+    std::fill(row_data + real, row_data + length, quantize.apply<T>(pad_value));
+}
+
+template<typename T>
+void writeMask(T* row_data, size_t length, size_t real_count, const Quantizer& quantize) {
+    size_t real = std::min(real_count, length);
+    std::fill(row_data, row_data + real, quantize.apply<T>(1));
+    std::fill(row_data + real, row_data + length, quantize.apply<T>(0));
+}
+
+template<typename T>
+void dequantizeRow(const T* values, size_t count, const TfLiteQuantizationParams& params, float* out) {
+    const float scale = params.scale != 0.0f ? params.scale : 1.0f;
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = scale * static_cast<float>(static_cast<int32_t>(values[i]) - params.zero_point);
+    }
+}
+
+// Cache key of a model file: changes with the file (an app update ships a new one) and with the runtime
+std::string cacheToken(const std::string& model_path) {
+    std::error_code ec;
+    const std::filesystem::path path(model_path);
+    ContentHasher hasher;
+    hasher.update(path.filename().string());
+    const uintmax_t size = std::filesystem::file_size(path, ec);
+    hasher.update(&size, sizeof(size));
+    const auto modified = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+    hasher.update(&modified, sizeof(modified));
+    hasher.update(TfLiteVersion());
+    return path.stem().string() + "-" + hasher.hex_digest();
+}
+
+} // namespace
+
+struct TFLiteModel::Impl {
+    using delegate_deleter_t = void (*)(TfLiteDelegate*);
+
+    struct Delegate {
+        std::string name;
+        TfLiteDelegate* delegate;
+        delegate_deleter_t deleter;
+    };
+
+    std::shared_ptr<TfLiteModel> model;     // Read-only flatbuffer, shared by every interpreter built from the same file
+    TfLiteInterpreterOptions* options = nullptr;
+    TfLiteInterpreter* interpreter = nullptr;
+    std::vector<Delegate> delegates;
+    size_t batch_size = 0;
+    size_t sequence_length = 0;
+    mutable std::vector<std::vector<float>> dequantized;    // Per output: the last row read from a quantized output
+    std::string cache_dir;                  // Delegate caches (empty = none); the delegates keep pointers to these strings
+    std::string cache_token;
+    std::string weights_cache_path;
+
+    ~Impl() {
+        // Interpreter must go before the delegates it was built with
+        if (interpreter) {
+            TfLiteInterpreterDelete(interpreter);
+        }
+        for (auto& entry : delegates) {
+            if (entry.delegate && entry.deleter) {
+                entry.deleter(entry.delegate);
+            }
+        }
+        if (options) {
+            TfLiteInterpreterOptionsDelete(options);
+        }
+    }
+
+    void addDelegate(const std::string& name, TfLiteDelegate* delegate, delegate_deleter_t deleter) {
+        if (!delegate) {
+            LEAFRA_WARNING() << "TensorFlow Lite " << name << " delegate could not be created, skipping";
+            return;
+        }
+        TfLiteInterpreterOptionsAddDelegate(options, delegate);
+        delegates.push_back({name, delegate, deleter});
+        LEAFRA_DEBUG() << "  - Delegate enabled: " << name;
+    }
+
+    // Create the cache directory and derive this model's cache names; caching stays off if that fails
+    void prepareCache(const std::string& dir, const std::string& model_path) {
+        if (dir.empty()) {
+            return;
+        }
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        if (ec || !std::filesystem::is_directory(dir, ec)) {
+            LEAFRA_WARNING() << "TensorFlow Lite delegate cache directory " << dir << " is not usable, delegates are rebuilt on every load";
+            return;
+        }
+        cache_dir = dir;
+        cache_token = cacheToken(model_path);
+        weights_cache_path = (std::filesystem::path(dir) / (cache_token + ".xnnpack_cache")).string();
+        LEAFRA_DEBUG() << "  - Delegate cache: " << cache_dir << " (" << cache_token << ")";
+    }
+
+    void createDelegates(const Options& opts) {
+        // Accelerator delegates first; XNNPACK last so it picks up whatever they leave on the CPU
+#ifdef LEAFRA_TFLITE_HAS_COREML_DELEGATE
+        if (opts.enable_coreml) {
+            addDelegate("CoreML", TfLiteCoreMlDelegateCreate(nullptr), TfLiteCoreMlDelegateDelete);
+        }
+#else
+        if (opts.enable_coreml) {
+            LEAFRA_DEBUG() << "TensorFlow Lite CoreML delegate not available in this build";
+        }
+#endif
+#ifdef LEAFRA_TFLITE_HAS_METAL_DELEGATE
+        if (opts.enable_metal) {
+            addDelegate("Metal", TFLGpuDelegateCreate(nullptr), TFLGpuDelegateDelete);
+        }
+#else
+        if (opts.enable_metal) {
+            LEAFRA_DEBUG() << "TensorFlow Lite Metal delegate not available in this build";
+        }
+#endif
+#ifdef LEAFRA_TFLITE_HAS_GPU_DELEGATE
+        if (opts.enable_gpu) {
+            TfLiteGpuDelegateOptionsV2 gpu_options = TfLiteGpuDelegateOptionsV2Default();
+            if (!cache_token.empty()) {
+                // Compiled kernels are written on the first load and read back on the next ones
+                gpu_options.experimental_flags |= TFLITE_GPU_EXPERIMENTAL_FLAGS_ENABLE_SERIALIZATION;
+                gpu_options.serialization_dir = cache_dir.c_str();
+                gpu_options.model_token = cache_token.c_str();
+            }
+            addDelegate("GPU", TfLiteGpuDelegateV2Create(&gpu_options), TfLiteGpuDelegateV2Delete);
+        }
+#else
+        if (opts.enable_gpu) {
+            LEAFRA_DEBUG() << "TensorFlow Lite GPU delegate not available in this build";
+        }
+#endif
+#ifdef LEAFRA_TFLITE_HAS_NNAPI_DELEGATE
+        if (opts.enable_nnapi) {
+            TfLiteNnapiDelegateOptions nnapi_options = TfLiteNnapiDelegateOptionsDefault();
+            addDelegate("NNAPI", TfLiteNnapiDelegateCreate(&nnapi_options), TfLiteNnapiDelegateDelete);
+        }
+#else
+        if (opts.enable_nnapi) {
+            LEAFRA_DEBUG() << "TensorFlow Lite NNAPI delegate not available in this build";
+        }
+#endif
+#ifdef LEAFRA_TFLITE_HAS_XNNPACK
+        if (opts.enable_xnnpack) {
+            TfLiteXNNPackDelegateOptions xnnpack_options = TfLiteXNNPackDelegateOptionsDefault();
+            if (opts.num_threads > 0) {
+                xnnpack_options.num_threads = opts.num_threads;
+            }
+            if (!weights_cache_path.empty()) {
+                // Packed weights are mmapped from the file instead of repacked (written on the first load)
+                xnnpack_options.weight_cache_file_path = weights_cache_path.c_str();
+            }
+            addDelegate("XNNPACK", TfLiteXNNPackDelegateCreate(&xnnpack_options), TfLiteXNNPackDelegateDelete);
+        }
+#else
+        if (opts.enable_xnnpack) {
+            LEAFRA_DEBUG() << "TensorFlow Lite XNNPACK delegate not available in this build";
+        }
+#endif
+    }
+
+    TfLiteTensor* inputTensor(size_t index) const {
+        if (!interpreter || index >= static_cast<size_t>(TfLiteInterpreterGetInputTensorCount(interpreter))) {
+            throw std::runtime_error("TensorFlow Lite input index out of range: " + std::to_string(index));
+        }
+        return TfLiteInterpreterGetInputTensor(interpreter, static_cast<int32_t>(index));
+    }
+
+    const TfLiteTensor* outputTensor(size_t index) const {
+        if (!interpreter || index >= static_cast<size_t>(TfLiteInterpreterGetOutputTensorCount(interpreter))) {
+            throw std::runtime_error("TensorFlow Lite output index out of range: " + std::to_string(index));
+        }
+        return TfLiteInterpreterGetOutputTensor(interpreter, static_cast<int32_t>(index));
+    }
+
+    // Resize every input to [batch_size, sequence_length, ...] and reallocate; returns an error message on failure
+    std::string applyInputShape(size_t batch_size, size_t sequence_length) {
+        size_t input_count = static_cast<size_t>(TfLiteInterpreterGetInputTensorCount(interpreter));
+        for (size_t i = 0; i < input_count; ++i) {
+            const TfLiteTensor* tensor = inputTensor(i);
+            std::vector<int> dims(static_cast<size_t>(TfLiteTensorNumDims(tensor)));
+            for (size_t d = 0; d < dims.size(); ++d) {
+                dims[d] = TfLiteTensorDim(tensor, static_cast<int32_t>(d));
+            }
+            if (dims.empty()) {
+                return "TensorFlow Lite input " + std::to_string(i) + " is a scalar and cannot be batched";
+            }
+            dims[0] = static_cast<int>(batch_size);
+            if (dims.size() > 1) {
+                dims[1] = static_cast<int>(sequence_length);
+            }
+            if (TfLiteInterpreterResizeInputTensor(interpreter, static_cast<int32_t>(i),
+                                                   dims.data(), static_cast<int32_t>(dims.size())) != kTfLiteOk) {
+                return "Failed to resize TensorFlow Lite input " + std::to_string(i) + " to [" +
+                       std::to_string(batch_size) + ", " + std::to_string(sequence_length) + "]";
+            }
+        }
+        if (TfLiteInterpreterAllocateTensors(interpreter) != kTfLiteOk) {
+            return "Failed to reallocate TensorFlow Lite tensors for [" +
+                   std::to_string(batch_size) + ", " + std::to_string(sequence_length) + "]";
+        }
+        return std::string();
+    }
+
+    void* rowPointer(TfLiteTensor* tensor, size_t row, size_t& length) const {
+        if (row >= batch_size) {
+            throw std::runtime_error("TensorFlow Lite row " + std::to_string(row) + " out of range for batch of " + std::to_string(batch_size));
+        }
+        length = elementsPerRow(tensor);
+        char* data = static_cast<char*>(TfLiteTensorData(tensor));
+        if (!data) {
+            throw std::runtime_error("TensorFlow Lite input tensor is not allocated");
+        }
+        size_t element_size = TfLiteTensorByteSize(tensor) / std::max<size_t>(1, batch_size * length);
+        return data + row * length * element_size;
+    }
+};
+
+TFLiteModel::TFLiteModel(const std::string& model_path, const Options& options)
+    : pImpl(std::make_unique<Impl>()) {
+    pImpl->model = ModelRegistry<TfLiteModel>::instance().acquire(model_path, [&]() {
+        TfLiteModel* model = TfLiteModelCreateFromFile(model_path.c_str());
+        return model ? std::shared_ptr<TfLiteModel>(model, TfLiteModelDelete) : nullptr;
+    });
+    if (!pImpl->model) {
+        throw std::runtime_error("Failed to load TensorFlow Lite model from: " + model_path);
+    }
+
+    pImpl->options = TfLiteInterpreterOptionsCreate();
+    if (options.num_threads > 0) {
+        TfLiteInterpreterOptionsSetNumThreads(pImpl->options, options.num_threads);
+    }
+    pImpl->prepareCache(options.cache_dir, model_path);
+    pImpl->createDelegates(options);
+
+    pImpl->interpreter = TfLiteInterpreterCreate(pImpl->model.get(), pImpl->options);
+    if (!pImpl->interpreter) {
+        throw std::runtime_error("Failed to create TensorFlow Lite interpreter");
+    }
+
+    if (TfLiteInterpreterAllocateTensors(pImpl->interpreter) != kTfLiteOk) {
+        throw std::runtime_error("Failed to allocate tensors for TensorFlow Lite interpreter");
+    }
+
+    if (TfLiteInterpreterGetInputTensorCount(pImpl->interpreter) > 0) {
+        const TfLiteTensor* first_input = TfLiteInterpreterGetInputTensor(pImpl->interpreter, 0);
+        pImpl->batch_size = TfLiteTensorNumDims(first_input) > 0 ? static_cast<size_t>(TfLiteTensorDim(first_input, 0)) : 1;
+        pImpl->sequence_length = TfLiteTensorNumDims(first_input) > 1 ? static_cast<size_t>(TfLiteTensorDim(first_input, 1)) : 1;
+    }
+
+    LEAFRA_DEBUG() << "TensorFlow Lite model loaded: " << model_path
+                   << " (inputs: " << getInputCount() << ", outputs: " << getOutputCount()
+                   << ", batch: " << pImpl->batch_size << ")";
+}
+
+TFLiteModel::~TFLiteModel() = default;
+TFLiteModel::TFLiteModel(TFLiteModel&&) noexcept = default;
+TFLiteModel& TFLiteModel::operator=(TFLiteModel&&) noexcept = default;
+
+bool TFLiteModel::isValid() const {
+    return pImpl && pImpl->interpreter != nullptr;
+}
+
+size_t TFLiteModel::getInputCount() const {
+    return isValid() ? static_cast<size_t>(TfLiteInterpreterGetInputTensorCount(pImpl->interpreter)) : 0;
+}
+
+size_t TFLiteModel::getOutputCount() const {
+    return isValid() ? static_cast<size_t>(TfLiteInterpreterGetOutputTensorCount(pImpl->interpreter)) : 0;
+}
+
+std::string TFLiteModel::getInputName(size_t index) const {
+    if (index >= getInputCount()) return "";
+    const char* name = TfLiteTensorName(pImpl->inputTensor(index));
+    return name ? name : "";
+}
+
+std::string TFLiteModel::getOutputName(size_t index) const {
+    if (index >= getOutputCount()) return "";
+    const char* name = TfLiteTensorName(pImpl->outputTensor(index));
+    return name ? name : "";
+}
+
+size_t TFLiteModel::getInputSequenceLength(size_t index) const {
+    return index < getInputCount() ? elementsPerRow(pImpl->inputTensor(index)) : 0;
+}
+
+size_t TFLiteModel::getOutputSize(size_t index) const {
+    return index < getOutputCount() ? elementsPerRow(pImpl->outputTensor(index)) : 0;
+}
+
+std::vector<int32_t> TFLiteModel::getOutputDims(size_t index) const {
+    std::vector<int32_t> dims;
+    if (index >= getOutputCount()) return dims;
+    const TfLiteTensor* tensor = pImpl->outputTensor(index);
+    for (int32_t d = 0; d < TfLiteTensorNumDims(tensor); ++d) {
+        dims.push_back(TfLiteTensorDim(tensor, d));
+    }
+    return dims;
+}
+
+size_t TFLiteModel::getBatchSize() const {
+    return pImpl ? pImpl->batch_size : 0;
+}
+
+size_t TFLiteModel::getSequenceLength() const {
+    return pImpl ? pImpl->sequence_length : 0;
+}
+
+size_t TFLiteModel::getDelegateCount() const {
+    return pImpl ? pImpl->delegates.size() : 0;
+}
+
+std::vector<std::string> TFLiteModel::getDelegateNames() const {
+    std::vector<std::string> names;
+    if (pImpl) {
+        for (const auto& entry : pImpl->delegates) {
+            names.push_back(entry.name);
+        }
+    }
+    return names;
+}
+
+void TFLiteModel::resizeBatch(size_t batch_size) {
+    resizeInputs(batch_size, pImpl ? pImpl->sequence_length : 0);
+}
+
+void TFLiteModel::resizeInputs(size_t batch_size, size_t sequence_length) {
+    if (!isValid()) {
+        throw std::runtime_error("Invalid TensorFlow Lite model");
+    }
+    if (batch_size == 0 || sequence_length == 0) {
+        throw std::runtime_error("TensorFlow Lite batch size and sequence length must be positive");
+    }
+    if (batch_size == pImpl->batch_size && sequence_length == pImpl->sequence_length) {
+        return;
+    }
+
+    std::string error = pImpl->applyInputShape(batch_size, sequence_length);
+    if (!error.empty()) {
+        // Put the previous shape back so the interpreter stays usable after a failed probe
+        std::string restore_error = pImpl->applyInputShape(pImpl->batch_size, pImpl->sequence_length);
+        if (!restore_error.empty()) {
+            LEAFRA_ERROR() << "Failed to restore TensorFlow Lite input shape: " << restore_error;
+        }
+        throw std::runtime_error(error);
+    }
+    pImpl->batch_size = batch_size;
+    pImpl->sequence_length = sequence_length;
+    LEAFRA_DEBUG() << "TensorFlow Lite inputs resized to [" << batch_size << ", " << sequence_length << "]";
+}
+
+void TFLiteModel::setTokenRow(size_t input_index, size_t row, const int* token_ids, size_t count, int pad_value) {
+    TfLiteTensor* tensor = pImpl->inputTensor(input_index);
+    size_t length = 0;
+    void* row_data = pImpl->rowPointer(tensor, row, length);
+    const Quantizer quantize = quantizerOf(tensor);
+    switch (TfLiteTensorType(tensor)) {
+        case kTfLiteInt32: writeRow(static_cast<int32_t*>(row_data), length, token_ids, count, pad_value, quantize); break;
+        case kTfLiteInt64: writeRow(static_cast<int64_t*>(row_data), length, token_ids, count, pad_value, quantize); break;
+        case kTfLiteFloat32: writeRow(static_cast<float*>(row_data), length, token_ids, count, pad_value, quantize); break;
+        case kTfLiteInt8: writeRow(static_cast<int8_t*>(row_data), length, token_ids, count, pad_value, quantize); break;
+        case kTfLiteUInt8: writeRow(static_cast<uint8_t*>(row_data), length, token_ids, count, pad_value, quantize); break;
+        default:
+            throw std::runtime_error("Unsupported TensorFlow Lite input type for input " + std::to_string(input_index));
+    }
+}
+
+void TFLiteModel::setMaskRow(size_t input_index, size_t row, size_t real_count) {
+    TfLiteTensor* tensor = pImpl->inputTensor(input_index);
+    size_t length = 0;
+    void* row_data = pImpl->rowPointer(tensor, row, length);
+    const Quantizer quantize = quantizerOf(tensor);
+    switch (TfLiteTensorType(tensor)) {
+        case kTfLiteInt32: writeMask(static_cast<int32_t*>(row_data), length, real_count, quantize); break;
+        case kTfLiteInt64: writeMask(static_cast<int64_t*>(row_data), length, real_count, quantize); break;
+        case kTfLiteFloat32: writeMask(static_cast<float*>(row_data), length, real_count, quantize); break;
+        case kTfLiteInt8: writeMask(static_cast<int8_t*>(row_data), length, real_count, quantize); break;
+        case kTfLiteUInt8: writeMask(static_cast<uint8_t*>(row_data), length, real_count, quantize); break;
+        default:
+            throw std::runtime_error("Unsupported TensorFlow Lite input type for input " + std::to_string(input_index));
+    }
+}
+
+void TFLiteModel::fillRow(size_t input_index, size_t row, int value) {
+    setTokenRow(input_index, row, nullptr, 0, value);
+}
+
+void TFLiteModel::invoke() {
+    if (!isValid()) {
+        throw std::runtime_error("Invalid TensorFlow Lite model");
+    }
+    LEAFRA_TRACE_SCOPE("tflite", "invoke");
+    if (TfLiteInterpreterInvoke(pImpl->interpreter) != kTfLiteOk) {
+        throw std::runtime_error("TensorFlow Lite inference failed");
+    }
+}
+
+bool TFLiteModel::isOutputQuantized(size_t index) const {
+    return index < getOutputCount() && TfLiteTensorType(pImpl->outputTensor(index)) != kTfLiteFloat32;
+}
+
+const float* TFLiteModel::getOutputRow(size_t output_index, size_t row) const {
+    const TfLiteTensor* tensor = pImpl->outputTensor(output_index);
+    if (row >= pImpl->batch_size) {
+        throw std::runtime_error("TensorFlow Lite output row " + std::to_string(row) + " out of range");
+    }
+    const void* data = TfLiteTensorData(tensor);
+    if (!data) {
+        throw std::runtime_error("TensorFlow Lite output tensor is not allocated");
+    }
+    const size_t length = elementsPerRow(tensor);
+    const TfLiteType type = TfLiteTensorType(tensor);
+    if (type == kTfLiteFloat32) {
+        return static_cast<const float*>(data) + row * length;
+    }
+    
+    if (pImpl->dequantized.size() <= output_index) {
+        pImpl->dequantized.resize(output_index + 1);
+    }
+    std::vector<float>& out = pImpl->dequantized[output_index];
+    out.resize(length);
+    const size_t offset = row * length;
+    const TfLiteQuantizationParams params = TfLiteTensorQuantizationParams(tensor);
+    switch (type) {
+        case kTfLiteInt8: dequantizeRow(static_cast<const int8_t*>(data) + offset, length, params, out.data()); break;
+        case kTfLiteUInt8: dequantizeRow(static_cast<const uint8_t*>(data) + offset, length, params, out.data()); break;
+        case kTfLiteInt16: dequantizeRow(static_cast<const int16_t*>(data) + offset, length, params, out.data()); break;
+        case kTfLiteFloat16: simd::half_to_float(static_cast<const uint16_t*>(data) + offset, out.data(), length); break;
+        default:
+            throw std::runtime_error("Unsupported TensorFlow Lite output type for output " + std::to_string(output_index));
+    }
+    return out.data();
+}
+
+} // namespace leafra
@@ -0,0 +1,111 @@
+#include "leafra/leafra_threadpool.h"
+#include "leafra/logger.h"
+#include "leafra/leafra_trace.h"
+#include <algorithm>
+
+namespace leafra {
+
+ThreadPool::ThreadPool(size_t thread_count, ThreadQoS qos, const std::string& name) {
+    size_t count = std::max<size_t>(1, thread_count);
+    workers_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        workers_.emplace_back([this, i, qos, name] {
+            trace::set_thread_name(name + " " + std::to_string(i));
+            PlatformUtils::set_current_thread_qos(qos);
+            worker_loop();
+        });
+    }
+    LEAFRA_DEBUG() << "ThreadPool " << name << " started with " << count << " workers";
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    task_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    LEAFRA_DEBUG() << "ThreadPool stopped";
+}
+
+bool ThreadPool::submit(task_t task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return false;
+        }
+        tasks_.push_back(std::move(task));
+    }
+    task_cv_.notify_one();
+    return true;
+}
+
+void ThreadPool::wait_idle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this] { return tasks_.empty() && active_tasks_ == 0; });
+}
+
+size_t ThreadPool::resolve_thread_count(int32_t configured) {
+    size_t hardware = std::thread::hardware_concurrency();
+    if (hardware == 0) {
+        hardware = 1;
+    }
+    if (configured <= 0) {
+        return hardware;
+    }
+    return std::min(static_cast<size_t>(configured), hardware);
+}
+
+ThreadBudget ThreadBudget::resolve(const CpuTopology& topology, const Settings& settings) {
+    const int32_t logical = std::max<int32_t>(1, topology.logical_cores);
+    const int32_t performance = std::max<int32_t>(1, std::min(topology.performance_cores, logical));
+
+    ThreadBudget budget;
+    budget.ingest_workers = settings.max_threads > 0 ? static_cast<size_t>(std::min(settings.max_threads, logical))
+                                                     : static_cast<size_t>(logical);
+    budget.query_workers = settings.query_threads > 0 ? static_cast<size_t>(std::min(settings.query_threads, logical))
+                                                      : static_cast<size_t>(std::max<int32_t>(1, performance - 1));
+    budget.llm_threads = settings.llm_threads > 0 ? settings.llm_threads : performance;
+    budget.llm_batch_threads = settings.llm_batch_threads > 0 ? settings.llm_batch_threads : budget.llm_threads;
+    budget.embedding_threads = settings.embedding_threads > 0 ? settings.embedding_threads : std::min<int32_t>(performance, 4);
+    budget.faiss_threads = settings.faiss_threads > 0 ? std::min(settings.faiss_threads, logical) : performance;
+    return budget;
+} //resolve
+
+void ThreadPool::worker_loop() {
+    while (true) {
+        task_t task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            task_cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return; // stopping_ and nothing left to drain
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+            active_tasks_++;
+        }
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            LEAFRA_ERROR() << "ThreadPool task threw exception: " << e.what();
+        } catch (...) {
+            LEAFRA_ERROR() << "ThreadPool task threw unknown exception";
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            active_tasks_--;
+            if (tasks_.empty() && active_tasks_ == 0) {
+                idle_cv_.notify_all();
+            }
+        }
+    }
+} //worker_loop
+
+} // namespace leafra
@@ -0,0 +1,180 @@
+#include "leafra/leafra_token_stream.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace leafra {
+
+namespace {
+
+// Stands in for a character the model never finished
+const char kReplacementCharacter[] = "\xEF\xBF\xBD";
+
+// Bytes in the character a lead byte starts (0 for continuation bytes)
+size_t utf8_sequence_length(unsigned char lead) {
+    if (lead < 0x80) return 1;
+    if ((lead & 0xE0) == 0xC0) return 2;
+    if ((lead & 0xF0) == 0xE0) return 3;
+    if ((lead & 0xF8) == 0xF0) return 4;
+    return 0;
+}
+
+} // anonymous namespace
+
+class TokenStream::Impl {
+public:
+    Impl(token_callback_t consumer, int32_t flush_ms, int32_t flush_tokens)
+        : consumer_(std::move(consumer)), flush_ms_(flush_ms), flush_tokens_(flush_tokens) {
+        if (flush_ms_ > 0 && consumer_) {
+            worker_ = std::thread(&Impl::run, this);
+        }
+    }
+
+    bool push(const std::string& piece) {
+        if (stopped_.load(std::memory_order_relaxed) || !consumer_) {
+            return !stopped_.load(std::memory_order_relaxed);
+        }
+        if (!worker_.joinable()) {
+            // Inline: only the pending tail carries over between pushes
+            partial_ += piece;
+            const size_t complete = complete_utf8_prefix(partial_);
+            if (complete > 0) {
+                std::string text = partial_.substr(0, complete);
+                partial_.erase(0, complete);
+                if (!consumer_(text, false)) {
+                    stopped_.store(true, std::memory_order_relaxed);
+                }
+            }
+            return !stopped_.load(std::memory_order_relaxed);
+        }
+
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const bool was_empty = pending_.empty();
+            partial_ += piece;
+            const size_t complete = complete_utf8_prefix(partial_);
+            pending_.append(partial_, 0, complete);
+            partial_.erase(0, complete);
+            pending_tokens_++;
+            wake = (was_empty && complete > 0) || (flush_tokens_ > 0 && pending_tokens_ >= flush_tokens_);
+        }
+        if (wake) {
+            cv_.notify_one();
+        }
+        return !stopped_.load(std::memory_order_relaxed);
+    }
+
+    void close() {
+        if (closed_) {
+            return;
+        }
+        closed_ = true;
+        if (!consumer_) {
+            return;
+        }
+        if (!worker_.joinable()) {
+            if (!partial_.empty() && !stopped_.load(std::memory_order_relaxed)) {
+                consumer_(kReplacementCharacter, false);
+            }
+            partial_.clear();
+            consumer_("", true);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!partial_.empty()) {
+                pending_ += kReplacementCharacter;
+                partial_.clear();
+            }
+            closing_ = true;
+        }
+        cv_.notify_one();
+        worker_.join();
+    }
+
+    bool stopped() const {
+        return stopped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            // The window opens with the first waiting text, so an idle stream doesn't wake up
+            cv_.wait(lock, [this] { return closing_ || !pending_.empty(); });
+            if (!closing_) {
+                cv_.wait_for(lock, std::chrono::milliseconds(flush_ms_), [this] {
+                    return closing_ || (flush_tokens_ > 0 && pending_tokens_ >= flush_tokens_);
+                });
+            }
+            if (!pending_.empty()) {
+                std::string text;
+                text.swap(pending_);
+                pending_tokens_ = 0;
+                lock.unlock();
+                if (!stopped_.load(std::memory_order_relaxed) && !consumer_(text, false)) {
+                    stopped_.store(true, std::memory_order_relaxed);
+                }
+                lock.lock();
+                continue;
+            }
+            if (closing_) {
+                break;
+            }
+        }
+        lock.unlock();
+        consumer_("", true);
+    }
+
+    token_callback_t consumer_;
+    const int32_t flush_ms_;
+    const int32_t flush_tokens_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::string pending_;               // Complete characters waiting for delivery
+    std::string partial_;               // Start of a character whose remaining bytes haven't arrived
+    int32_t pending_tokens_ = 0;
+    bool closing_ = false;
+    bool closed_ = false;               // Only touched by the producer
+    std::atomic<bool> stopped_{false};
+    std::thread worker_;
+};
+
+TokenStream::TokenStream(token_callback_t consumer, int32_t flush_ms, int32_t flush_tokens)
+    : pImpl(std::make_unique<Impl>(std::move(consumer), flush_ms, flush_tokens)) {}
+
+TokenStream::~TokenStream() {
+    pImpl->close();
+}
+
+bool TokenStream::push(const std::string& piece) {
+    return pImpl->push(piece);
+}
+
+void TokenStream::close() {
+    pImpl->close();
+}
+
+bool TokenStream::stopped() const {
+    return pImpl->stopped();
+}
+
+size_t TokenStream::complete_utf8_prefix(const std::string& text) {
+    // A character is at most 4 bytes, so only the last 3 can belong to an unfinished one
+    const size_t size = text.size();
+    const size_t floor = size > 3 ? size - 3 : 0;
+    for (size_t i = size; i > floor; --i) {
+        const size_t length = utf8_sequence_length(static_cast<unsigned char>(text[i - 1]));
+        if (length == 0) {
+            continue;                       // Continuation byte, keep looking for its lead
+        }
+        return (size - (i - 1) < length) ? i - 1 : size;
+    }
+    return size;                            // Stray continuation bytes are passed through
+}
+
+} // namespace leafra
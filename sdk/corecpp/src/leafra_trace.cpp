@@ -0,0 +1,266 @@
+#include "leafra/leafra_trace.h"
+#include "leafra/leafra_debug.h"
+#include "leafra/logger.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace leafra {
+namespace trace {
+
+namespace {
+
+struct Event {
+    const char* category;
+    const char* name;
+    double start_us;
+    double duration_us;
+    std::string args;
+};
+
+/**
+ * @brief Events of one thread; the mutex is only contended while exporting
+ */
+struct ThreadBuffer {
+    uint32_t tid = 0;
+    std::mutex mutex;
+    std::string thread_name;
+    std::vector<Event> events;
+};
+
+struct TraceState {
+    std::atomic<bool> enabled{false};
+    std::atomic<size_t> max_events_per_thread{262144};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<double> epoch_us{0.0};
+
+    std::mutex registry_mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint32_t next_tid = 1;
+};
+
+TraceState& state() {
+    // Leaked so spans ending during static destruction still find it
+    static TraceState* instance = new TraceState();
+    return *instance;
+}
+
+double now_us() {
+    return debug::timer::now().timestamp * 1e6;
+}
+
+ThreadBuffer& local_buffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+        auto created = std::make_shared<ThreadBuffer>();
+        TraceState& trace = state();
+        std::lock_guard<std::mutex> lock(trace.registry_mutex);
+        created->tid = trace.next_tid++;
+        trace.buffers.push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+void append_escaped(std::string& out, const std::string& value) {
+    for (char c : value) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+}
+
+void append_number(std::string& out, double value) {
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.3f", value);
+    out += number;
+}
+
+void append_key(std::string& args, const char* key) {
+    if (!args.empty()) {
+        args += ',';
+    }
+    args += '"';
+    append_escaped(args, key);
+    args += "\":";
+}
+
+} // namespace
+
+void start(size_t max_events_per_thread) {
+    TraceState& trace = state();
+    clear();
+    trace.max_events_per_thread.store(max_events_per_thread > 0 ? max_events_per_thread : 1, std::memory_order_relaxed);
+    trace.epoch_us.store(now_us(), std::memory_order_relaxed);
+    trace.enabled.store(true, std::memory_order_release);
+}
+
+void stop() {
+    state().enabled.store(false, std::memory_order_release);
+}
+
+bool is_enabled() {
+    return state().enabled.load(std::memory_order_relaxed);
+}
+
+void clear() {
+    TraceState& trace = state();
+    std::lock_guard<std::mutex> lock(trace.registry_mutex);
+    std::vector<std::shared_ptr<ThreadBuffer>> live;
+    for (auto& buffer : trace.buffers) {
+        // Only the registry still holds buffers of threads that have exited
+        if (buffer.use_count() > 1) {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            buffer->events.clear();
+            live.push_back(buffer);
+        }
+    }
+    trace.buffers.swap(live);
+    trace.dropped.store(0, std::memory_order_relaxed);
+}
+
+void set_thread_name(const std::string& name) {
+    ThreadBuffer& buffer = local_buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.thread_name = name;
+}
+
+size_t event_count() {
+    TraceState& trace = state();
+    std::lock_guard<std::mutex> lock(trace.registry_mutex);
+    size_t count = 0;
+    for (auto& buffer : trace.buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+uint64_t dropped_count() {
+    return state().dropped.load(std::memory_order_relaxed);
+}
+
+std::string to_chrome_json() {
+    TraceState& trace = state();
+    double epoch = trace.epoch_us.load(std::memory_order_relaxed);
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&out, &first]() {
+        if (!first) {
+            out += ",\n";
+        }
+        first = false;
+    };
+
+    std::lock_guard<std::mutex> lock(trace.registry_mutex);
+    for (auto& buffer : trace.buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        std::string tid = std::to_string(buffer->tid);
+        if (!buffer->thread_name.empty()) {
+            separator();
+            out += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":\"";
+            append_escaped(out, buffer->thread_name);
+            out += "\"}}";
+        }
+        for (const Event& event : buffer->events) {
+            separator();
+            out += "{\"ph\":\"X\",\"cat\":\"";
+            append_escaped(out, event.category);
+            out += "\",\"name\":\"";
+            append_escaped(out, event.name);
+            out += "\",\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+            append_number(out, event.start_us - epoch);
+            out += ",\"dur\":";
+            append_number(out, event.duration_us);
+            if (!event.args.empty()) {
+                out += ",\"args\":{" + event.args + "}";
+            }
+            out += '}';
+        }
+    }
+    out += "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" +
+           std::to_string(trace.dropped.load(std::memory_order_relaxed)) + "}}\n";
+    return out;
+} //to_chrome_json
+
+bool write_chrome_trace(const std::string& path) {
+    std::string json = to_chrome_json();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    if (!file.flush()) {
+        LEAFRA_ERROR() << "Failed to write trace to " << path;
+        return false;
+    }
+    return true;
+}
+
+// ==============================================================================
+// Span
+// ==============================================================================
+
+Span::Span(const char* category, const char* name) : category_(category), name_(name) {
+    if (state().enabled.load(std::memory_order_relaxed)) {
+        active_ = true;
+        start_us_ = now_us();
+    }
+}
+
+void Span::arg(const char* key, const std::string& value) {
+    if (!active_) {
+        return;
+    }
+    append_key(args_, key);
+    args_ += '"';
+    append_escaped(args_, value);
+    args_ += '"';
+}
+
+void Span::arg(const char* key, double value) {
+    if (!active_) {
+        return;
+    }
+    append_key(args_, key);
+    append_number(args_, value);
+}
+
+void Span::arg_integer(const char* key, int64_t value) {
+    if (!active_) {
+        return;
+    }
+    append_key(args_, key);
+    args_ += std::to_string(value);
+}
+
+void Span::end() {
+    if (!active_) {
+        return;
+    }
+    active_ = false;
+    double end_us = now_us();
+    TraceState& trace = state();
+    ThreadBuffer& buffer = local_buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() >= trace.max_events_per_thread.load(std::memory_order_relaxed)) {
+        trace.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events.push_back({category_, name_, start_us_, end_us - start_us_, std::move(args_)});
+} //end
+
+} // namespace trace
+} // namespace leafra
@@ -1,17 +1,362 @@
 #include "leafra/leafra_unicode.h"
+#include "leafra/leafra_filemanager.h"
+#include "leafra/logger.h"
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cstring>
 #include <mutex>
 #include <vector>
 #include <unordered_map>
 #include <iostream>
 
+// The break iterator headers pull in ICU's C++ API, so they can't join the includes inside the
+// namespace below; sentence splitting uses them only when ICU was enabled for the whole build
+#ifdef LEAFRA_HAS_ICU
+#include <unicode/ubrk.h>
+#include <unicode/utext.h>
+#define LEAFRA_ICU_HAS_BREAK_ITERATOR 1
+#endif
+
+// Apple's icucore and the NDK's ICU serve their own system data and don't export udata_setCommonData
+#if defined(LEAFRA_HAS_ICU) && !defined(__APPLE__) && !defined(__ANDROID__) && __has_include(<unicode/udata.h>)
+#include <unicode/udata.h>
+#define LEAFRA_ICU_HAS_COMMON_DATA 1
+#endif
+
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+// Horizontal min/max (vminvq/vmaxvq) are AArch64-only
+#include <arm_neon.h>
+#define LEAFRA_SIMD_NEON 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define LEAFRA_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LEAFRA_SIMD_SSE2 1
+#endif
+
 #define DEBUG_MISMATCHES 1
 // Simple debug macro to satisfy the debug logging need
 #define LEAFRA_DEBUG_LOG(category, message) std::cout << "[" << category << "] " << message << std::endl
 
 namespace leafra {
 
+// SIMD prefix scans - these don't need ICU, so they live outside the ICU guard
+
+size_t ascii_run_length(const char* data, size_t size) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(data);
+    size_t i = 0;
+#if defined(LEAFRA_SIMD_NEON)
+    for (; i + 16 <= size; i += 16) {
+        if (vmaxvq_u8(vld1q_u8(s + i)) >= 0x80) break;
+    }
+#elif defined(LEAFRA_SIMD_AVX2)
+    for (; i + 32 <= size; i += 32) {
+        int mask = _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i)));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+#elif defined(LEAFRA_SIMD_SSE2)
+    for (; i + 16 <= size; i += 16) {
+        int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+#else
+    // Portable SWAR: test 8 high bits at once
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, s + i, sizeof(word));
+        if (word & 0x8080808080808080ULL) break;
+    }
+#endif
+    for (; i < size && s[i] < 0x80; ++i) {
+    }
+    return i;
+}
+
+size_t ascii_word_run_length(const char* data, size_t size) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(data);
+    size_t i = 0;
+#if defined(LEAFRA_SIMD_NEON)
+    const uint8x16_t case_bit = vdupq_n_u8(0x20);
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(s + i);
+        uint8x16_t lower = vorrq_u8(v, case_bit);
+        uint8x16_t word = vorrq_u8(vandq_u8(vcgeq_u8(v, vdupq_n_u8('0')), vcleq_u8(v, vdupq_n_u8('9'))),
+                                   vandq_u8(vcgeq_u8(lower, vdupq_n_u8('a')), vcleq_u8(lower, vdupq_n_u8('z'))));
+        word = vorrq_u8(word, vceqq_u8(v, vdupq_n_u8('_')));
+        if (vminvq_u8(word) == 0) break;
+    }
+#elif defined(LEAFRA_SIMD_AVX2)
+    // Signed compares: bytes >= 0x80 are negative and never match a range
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        __m256i lower = _mm256_or_si256(v, case_bit);
+        __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+        __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+        __m256i word = _mm256_or_si256(_mm256_or_si256(digit, alpha), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+        unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(word));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+#elif defined(LEAFRA_SIMD_SSE2)
+    // Signed compares: bytes >= 0x80 are negative and never match a range
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i lower = _mm_or_si128(v, case_bit);
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                      _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+        __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                      _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+        __m128i word = _mm_or_si128(_mm_or_si128(digit, alpha), _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+        unsigned mask = static_cast<unsigned>(~_mm_movemask_epi8(word)) & 0xffffu;
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+#endif
+    for (; i < size; ++i) {
+        uint8_t c = s[i];
+        uint8_t lower = c | 0x20;
+        if (!((c >= '0' && c <= '9') || (lower >= 'a' && lower <= 'z') || c == '_')) break;
+    }
+    return i;
+}
+
+void ascii_class_masks(const char* data, size_t size, uint64_t& space_mask, uint64_t& word_mask) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(data);
+    space_mask = 0;
+    word_mask = 0;
+    size_t i = 0;
+#if defined(LEAFRA_SIMD_NEON)
+    // No movemask on NEON: weight each lane by its bit and add the halves horizontally
+    static const uint8_t kLaneBits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t lane_bits = vld1q_u8(kLaneBits);
+    const uint8x16_t case_bit = vdupq_n_u8(0x20);
+    auto to_mask = [&lane_bits](uint8x16_t cmp) {
+        uint8x16_t bits = vandq_u8(cmp, lane_bits);
+        return static_cast<uint64_t>(vaddv_u8(vget_low_u8(bits))) |
+               (static_cast<uint64_t>(vaddv_u8(vget_high_u8(bits))) << 8);
+    };
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(s + i);
+        uint8x16_t lower = vorrq_u8(v, case_bit);
+        uint8x16_t space = vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')),
+                                    vandq_u8(vcgeq_u8(v, vdupq_n_u8('\t')), vcleq_u8(v, vdupq_n_u8('\r'))));
+        uint8x16_t word = vorrq_u8(vandq_u8(vcgeq_u8(v, vdupq_n_u8('0')), vcleq_u8(v, vdupq_n_u8('9'))),
+                                   vandq_u8(vcgeq_u8(lower, vdupq_n_u8('a')), vcleq_u8(lower, vdupq_n_u8('z'))));
+        word = vorrq_u8(word, vceqq_u8(v, vdupq_n_u8('_')));
+        space_mask |= to_mask(space) << i;
+        word_mask |= to_mask(word) << i;
+    }
+#elif defined(LEAFRA_SIMD_AVX2)
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        __m256i lower = _mm256_or_si256(v, case_bit);
+        __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                        _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('\t' - 1)),
+                                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), v)));
+        __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+        __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+        __m256i word = _mm256_or_si256(_mm256_or_si256(digit, alpha), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+        space_mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(space))) << i;
+        word_mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(word))) << i;
+    }
+#elif defined(LEAFRA_SIMD_SSE2)
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i lower = _mm_or_si128(v, case_bit);
+        __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                     _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('\t' - 1)),
+                                                   _mm_cmplt_epi8(v, _mm_set1_epi8('\r' + 1))));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                      _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+        __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                      _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+        __m128i word = _mm_or_si128(_mm_or_si128(digit, alpha), _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+        space_mask |= static_cast<uint64_t>(_mm_movemask_epi8(space) & 0xffff) << i;
+        word_mask |= static_cast<uint64_t>(_mm_movemask_epi8(word) & 0xffff) << i;
+    }
+#endif
+    for (; i < size; ++i) {
+        uint8_t c = s[i];
+        uint8_t lower = c | 0x20;
+        space_mask |= static_cast<uint64_t>(c == ' ' || (c >= '\t' && c <= '\r')) << i;
+        word_mask |= static_cast<uint64_t>((c >= '0' && c <= '9') || (lower >= 'a' && lower <= 'z') || c == '_') << i;
+    }
+}
+
+size_t utf16_to_utf8(const uint16_t* data, size_t count, char* out) {
+    uint8_t* dst = reinterpret_cast<uint8_t*>(out);
+    size_t i = 0;
+    while (i < count) {
+#if defined(LEAFRA_SIMD_NEON)
+        for (; i + 8 <= count; i += 8, dst += 8) {
+            uint16x8_t v = vld1q_u16(data + i);
+            if (vmaxvq_u16(v) >= 0x80) break;
+            vst1_u8(dst, vmovn_u16(v));
+        }
+#elif defined(LEAFRA_SIMD_AVX2) || defined(LEAFRA_SIMD_SSE2)
+        const __m128i non_ascii_bits = _mm_set1_epi16(static_cast<short>(0xFF80));
+        for (; i + 8 <= count; i += 8, dst += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(v, non_ascii_bits), _mm_setzero_si128());
+            if (_mm_movemask_epi8(ascii) != 0xFFFF) break;
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(v, v));
+        }
+#endif
+        // Fewer than 8 ASCII units before the next non-ASCII one (or the end)
+        while (i < count && data[i] < 0x80) {
+            *dst++ = static_cast<uint8_t>(data[i++]);
+        }
+        
+        while (i < count && data[i] >= 0x80) {
+            uint32_t cp = data[i++];
+            if (cp >= 0xD800 && cp <= 0xDFFF) {
+                if (cp <= 0xDBFF && i < count && data[i] >= 0xDC00 && data[i] <= 0xDFFF) {
+                    cp = 0x10000 + ((cp & 0x3FF) << 10) + (data[i++] & 0x3FF);
+                } else {
+                    cp = 0xFFFD;  // Unpaired surrogate
+                }
+            }
+            if (cp < 0x800) {
+                *dst++ = static_cast<uint8_t>(0xC0 | (cp >> 6));
+                *dst++ = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+            } else if (cp < 0x10000) {
+                *dst++ = static_cast<uint8_t>(0xE0 | (cp >> 12));
+                *dst++ = static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3F));
+                *dst++ = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+            } else {
+                *dst++ = static_cast<uint8_t>(0xF0 | (cp >> 18));
+                *dst++ = static_cast<uint8_t>(0x80 | ((cp >> 12) & 0x3F));
+                *dst++ = static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3F));
+                *dst++ = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+            }
+        }
+    }
+    return static_cast<size_t>(dst - reinterpret_cast<uint8_t*>(out));
+}
+
+void utf16_to_utf8(const uint16_t* data, size_t count, std::string& out) {
+    // A BMP unit takes at most 3 bytes; a surrogate pair takes 4 for its 2 units
+    out.resize(count * 3);
+    out.resize(utf16_to_utf8(data, count, &out[0]));
+}
+
+// Rule-based sentence splitting, used without ICU and if the break iterator can't be opened
+static void simple_sentence_boundaries(std::string_view text, std::vector<size_t>& boundaries) {
+    auto is_space = [](unsigned char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v'; };
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        size_t end = 0;
+        if (c == '\n') {
+            end = i + 1;
+        } else if (c == '.' || c == '!' || c == '?') {
+            // Terminator run plus closing quotes/brackets, then it must be followed by whitespace
+            size_t j = i + 1;
+            while (j < text.size() && std::strchr(".!?\"')]", text[j]) != nullptr) j++;
+            if (j == text.size() || is_space(static_cast<unsigned char>(text[j]))) end = j;
+        } else if (c == 0xE3 && i + 2 < text.size() && static_cast<unsigned char>(text[i + 1]) == 0x80 &&
+                   static_cast<unsigned char>(text[i + 2]) == 0x82) {
+            end = i + 3;                                                    // 。
+        } else if (c == 0xEF && i + 2 < text.size() && static_cast<unsigned char>(text[i + 1]) == 0xBC &&
+                   (static_cast<unsigned char>(text[i + 2]) == 0x81 || static_cast<unsigned char>(text[i + 2]) == 0x9F)) {
+            end = i + 3;                                                    // ！ ？
+        }
+        if (end == 0) {
+            i++;
+            continue;
+        }
+        while (end < text.size() && is_space(static_cast<unsigned char>(text[end])) && text[end - 1] != '\n') end++;
+        boundaries.push_back(end);
+        i = end;
+    }
+    if (boundaries.empty() || boundaries.back() != text.size()) {
+        boundaries.push_back(text.size());
+    }
+}
+
+namespace {
+
+// The bundle set_icu_data_file names, mapped by the first ensure_icu_data; never freed, ICU reads it until exit
+struct IcuDataState {
+    std::mutex mutex;
+    std::string path;
+    FileManager::MappedFile file;
+    bool usable = false;
+    std::atomic<bool> settled{false};   // ensure_icu_data has run; usable is final
+};
+
+IcuDataState& icu_data_state() {
+    static IcuDataState* state = new IcuDataState();
+    return *state;
+}
+
+} // anonymous namespace
+
+void set_icu_data_file(const std::string& path) {
+    IcuDataState& state = icu_data_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.settled.load(std::memory_order_acquire)) {
+        if (path != state.path) {
+            LEAFRA_WARNING() << "ICU data is in use already, " << (path.empty() ? std::string("the linked data") : path)
+                             << " takes effect after a restart";
+        }
+        return;
+    }
+    state.path = path;
+}
+
+bool ensure_icu_data() {
+#ifdef LEAFRA_HAS_ICU
+    IcuDataState& state = icu_data_state();
+    if (state.settled.load(std::memory_order_acquire)) {
+        return state.usable;
+    }
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.settled.load(std::memory_order_relaxed)) {
+        state.usable = true;
+        if (!state.path.empty()) {
+#ifdef LEAFRA_ICU_HAS_COMMON_DATA
+            UErrorCode status = U_ZERO_ERROR;
+            if (state.file.open(state.path, FileManager::AccessHint::Random) && state.file.size() > 0) {
+                udata_setCommonData(state.file.data(), &status);
+            } else {
+                status = U_FILE_ACCESS_ERROR;
+            }
+            if (U_FAILURE(status)) {
+                LEAFRA_WARNING() << "ICU data bundle " << state.path << " not used (" << u_errorName(status) << "), falling back to the linked data";
+                state.file.close();
+                state.usable = false;
+            } else {
+                LEAFRA_DEBUG() << "ICU data mapped from " << state.path << " (" << state.file.size() << " bytes)";
+            }
+#else
+            LEAFRA_DEBUG() << "System ICU serves its own data, " << state.path << " is not used";
+#endif
+        }
+        state.settled.store(true, std::memory_order_release);
+    }
+    return state.usable;
+#else
+    return false;
+#endif
+}
+
 #define LEAFRA_HAS_ICU 1 // AD TEMP
 
 #ifdef LEAFRA_HAS_ICU
@@ -19,6 +364,62 @@ namespace leafra {
 #include <unicode/utypes.h>
 #include <unicode/utf8.h>
 
+#ifdef LEAFRA_ICU_HAS_BREAK_ITERATOR
+void find_sentence_boundaries(std::string_view text, std::vector<size_t>& boundaries) {
+    boundaries.clear();
+    if (text.empty()) {
+        return;
+    }
+    
+    // Opening an iterator loads the break rules, so each thread keeps one and only swaps the text
+    struct SentenceIterator {
+        UBreakIterator* iterator = nullptr;
+        ~SentenceIterator() { if (iterator) ubrk_close(iterator); }
+    };
+    thread_local SentenceIterator sentences;
+    
+    UErrorCode status = U_ZERO_ERROR;
+    if (!sentences.iterator) {
+        ensure_icu_data();
+        sentences.iterator = ubrk_open(UBRK_SENTENCE, "", nullptr, 0, &status);
+        if (U_FAILURE(status)) {
+            sentences.iterator = nullptr;
+        }
+    }
+    
+    // UText reads the UTF-8 in place, so the iterator reports byte offsets
+    UText* utext = nullptr;
+    if (sentences.iterator) {
+        status = U_ZERO_ERROR;
+        utext = utext_openUTF8(nullptr, text.data(), static_cast<int64_t>(text.size()), &status);
+        if (U_SUCCESS(status)) {
+            ubrk_setUText(sentences.iterator, utext, &status);
+        }
+        if (U_SUCCESS(status)) {
+            for (int32_t pos = ubrk_next(sentences.iterator); pos != UBRK_DONE; pos = ubrk_next(sentences.iterator)) {
+                boundaries.push_back(static_cast<size_t>(pos));
+            }
+        }
+        // Detach the iterator before the UText goes away
+        UErrorCode reset_status = U_ZERO_ERROR;
+        ubrk_setText(sentences.iterator, nullptr, 0, &reset_status);
+        utext_close(utext);
+    }
+    
+    if (!sentences.iterator || U_FAILURE(status) || boundaries.empty() || boundaries.back() != text.size()) {
+        boundaries.clear();
+        simple_sentence_boundaries(text, boundaries);
+    }
+}
+#else
+void find_sentence_boundaries(std::string_view text, std::vector<size_t>& boundaries) {
+    boundaries.clear();
+    if (!text.empty()) {
+        simple_sentence_boundaries(text, boundaries);
+    }
+}
+#endif
+
 //NONCACHED/SLOW C API FOR UNICODE HANDLING 
 //Use the unicode_cacher.cpp file for the cached version of these functions where possible!!
 
@@ -68,18 +469,19 @@ size_t get_byte_pos_for_char_index(const std::string& text, size_t char_index) {
     size_t current_char = 0;
     size_t byte_pos = 0;
     while (byte_pos < text.length() && current_char < char_index) {
+        // ASCII runs are one character per byte
+        size_t run = std::min(ascii_run_length(text.data() + byte_pos, text.length() - byte_pos),
+                              char_index - current_char);
+        byte_pos += run;
+        current_char += run;
+        if (current_char >= char_index || byte_pos >= text.length()) break;
+        
         size_t next_pos;
         UChar32 c = get_unicode_char_at(text, byte_pos, next_pos);
-
         if (c != U_SENTINEL) {
             current_char++;
         }
-        byte_pos = next_pos;
-        
-        // Safety check
-        if (next_pos <= byte_pos) {
-            byte_pos++;
-        }
+        byte_pos = next_pos > byte_pos ? next_pos : byte_pos + 1;
     }
     
     return byte_pos;
@@ -106,17 +508,18 @@ size_t get_unicode_length(const std::string& text) {
     size_t byte_pos = 0;
     
     while (byte_pos < text.length()) {
+        // Count ASCII runs in bulk, decode only the non-ASCII characters
+        size_t run = ascii_run_length(text.data() + byte_pos, text.length() - byte_pos);
+        char_count += run;
+        byte_pos += run;
+        if (byte_pos >= text.length()) break;
+        
         size_t next_pos;
         UChar32 c = get_unicode_char_at(text, byte_pos, next_pos);
         if (c != U_SENTINEL) {
             char_count++;
         }
-        byte_pos = next_pos;
-        
-        // Safety check to prevent infinite loops
-        if (next_pos <= byte_pos) {
-            byte_pos++;
-        }
+        byte_pos = next_pos > byte_pos ? next_pos : byte_pos + 1;   // Always make progress
     }
     
     return char_count;
@@ -133,11 +536,17 @@ size_t find_word_boundary_helper_for_unicode(const std::string& text, size_t sta
         bool in_word = false;
         
         while (byte_pos < text.length()) {
+            if (in_word) {
+                // Skip the ASCII part of the current word in bulk
+                byte_pos += ascii_word_run_length(text.data() + byte_pos, text.length() - byte_pos);
+                if (byte_pos >= text.length()) break;
+            }
+            
             size_t next_pos;
             UChar32 c = get_unicode_char_at(text, byte_pos, next_pos);
             
             if (c == U_SENTINEL) {
-                byte_pos = next_pos;
+                byte_pos = next_pos > byte_pos ? next_pos : byte_pos + 1;
                 continue;
             }
             
@@ -169,17 +578,19 @@ size_t find_word_boundary_helper_for_unicode(const std::string& text, size_t sta
         
         // Move backward character by character
         while (byte_pos > 0) {
-            // Find previous character position
-            size_t prev_pos = 0;
-            size_t temp_pos = 0;
-            
-            while (temp_pos < byte_pos && temp_pos < text.length()) {
-                prev_pos = temp_pos;
-                UChar32 temp_c = get_unicode_char_at(text, temp_pos, temp_pos);
-                if (temp_c == U_SENTINEL) break;
+            // Find previous character position: step back over continuation bytes to the lead byte
+            // instead of rescanning from the start of the text
+            size_t prev_pos = byte_pos - 1;
+            while (prev_pos > 0 && byte_pos - prev_pos < 4 &&
+                   (static_cast<uint8_t>(text[prev_pos]) & 0xc0) == 0x80) {
+                prev_pos--;
             }
             
             UChar32 prev_c = get_unicode_char_at(text, prev_pos, next_pos);
+            if (prev_c != U_SENTINEL && next_pos < byte_pos) {
+                prev_pos = byte_pos - 1;   // Stray continuation byte
+                prev_c = U_SENTINEL;
+            }
             if (prev_c == U_SENTINEL) {
                 byte_pos = prev_pos;
                 continue;
@@ -203,28 +614,19 @@ size_t find_word_boundary_helper_for_unicode(const std::string& text, size_t sta
 #else
 // Fallback functions for when ICU is not available
 
+void find_sentence_boundaries(std::string_view text, std::vector<size_t>& boundaries) {
+    boundaries.clear();
+    if (!text.empty()) {
+        simple_sentence_boundaries(text, boundaries);
+    }
+}
+
 size_t get_byte_pos_for_char_index(const std::string& text, size_t char_index) {
     if (char_index == 0) return 0;
     if (text.empty()) return 0;
     
-    size_t current_char = 0;
-    size_t byte_pos = 0;
-    
-    while (byte_pos < text.length() && current_char < char_index) {
-        size_t next_pos;
-        UChar32 c = get_unicode_char_at(text, byte_pos, next_pos);
-        if (c != U_SENTINEL) {
-            current_char++;
-        }
-        byte_pos = next_pos;
-        
-        // Safety check
-        if (next_pos <= byte_pos) {
-            byte_pos++;
-        }
-    }
-    
-    return byte_pos;
+    // Fallback: assume byte positions equal character positions
+    return std::min(char_index, text.length());
 }
 
 std::string get_utf8_substring(const std::string& text, size_t start_char_pos, size_t char_count) {
@@ -9,8 +9,6 @@
 // Simple debug macro to satisfy the debug logging need
 #define LEAFRA_DEBUG_LOG(category, message) std::cout << "[" << category << "] " << message << std::endl
 
-#undef DEBUG_MISMATCHES 
-
 namespace leafra {
 
 #define LEAFRA_HAS_ICU 1 // AD TEMP
@@ -21,194 +19,279 @@ namespace leafra {
 #include <unicode/utf8.h>
 #endif
 
-// UnicodeCacher member function implementations
+namespace {
 
-void UnicodeCacher::cleanup_arrays() {
-    if (codepoints_by_byte) {
-        delete[] codepoints_by_byte;
-        codepoints_by_byte = nullptr;
-    }
-    if (next_byte_pos_by_byte) {
-        delete[] next_byte_pos_by_byte;
-        next_byte_pos_by_byte = nullptr;
-    }
-    array_size = 0;
+// Whitespace (bit 0) and word (bit 1) classes of U+0000-U+07FF, which covers 1- and 2-byte UTF-8
+// (Latin, Greek, Cyrillic, Hebrew, Arabic, ...) without a character property lookup per code point
+const uint8_t* two_byte_classes() {
+    static const std::vector<uint8_t> classes = [] {
+        std::vector<uint8_t> table(0x800);
+        for (UChar32 c = 0; c < 0x800; ++c) {
+            table[c] = static_cast<uint8_t>((is_unicode_whitespace(c) ? 1 : 0) | (is_word_char_optimized(c) ? 2 : 0));
+        }
+        return table;
+    }();
+    return classes.data();
 }
 
-void UnicodeCacher::initialize_cache(const std::string& text) {
+} // namespace
+
+// UnicodeCacher member function implementations
+
+void UnicodeCacher::initialize_cache(std::string_view text) {
     //LEAFRA_DEBUG_LOG("CACHE", "Creating new cache entry");
     
-    // Clean up existing arrays
-    cleanup_arrays();
-    
     cached_text = text;
-    array_size = text.size() + 1;
-    
-    // Allocate new arrays
-    codepoints_by_byte = new UChar32[array_size];
-    next_byte_pos_by_byte = new size_t[array_size];
-    
-    // Initialize arrays
-    for (size_t i = 0; i < array_size; ++i) {
-        codepoints_by_byte[i] = U_SENTINEL;
-        next_byte_pos_by_byte[i] = text.size();
-    }
-    
+    char_checkpoints.clear();
+    char_checkpoints.reserve(text.size() / kCheckpointInterval + 1);
+    char_checkpoints.push_back(0);
+    space_bits.assign((text.size() + 63) / 64, 0);
+    word_bits.assign((text.size() + 63) / 64, 0);
+    ClassBits bits;
+    bits.space = space_bits.data();
+    bits.word = word_bits.data();
+    unicode_length_cached = index_range(text, 0, text.size(), 0, &char_checkpoints, &bits);
+} //end of initialize_cache
+
+size_t UnicodeCacher::index_range(std::string_view text, size_t begin, size_t end,
+                                  size_t first_char_index, std::vector<size_t>* checkpoints, ClassBits* bits) {
+    // One decoding pass counts the code points and records every kCheckpointInterval-th boundary
     const uint8_t* s = reinterpret_cast<const uint8_t*>(text.data());
     int32_t len = static_cast<int32_t>(text.length());
-    int32_t i = 0;
+    int32_t i = static_cast<int32_t>(begin);
+    size_t char_index = first_char_index;
+    
+    // Byte classes collect in one 64-bit word at a time. ASCII bytes are classified a whole word
+    // at once on entering it; multibyte code points add their bytes as they're decoded.
+    size_t current_word = begin >> 6;
+    uint64_t space_acc = 0;
+    uint64_t word_acc = 0;
+    auto enter_word = [&](size_t w) {
+        current_word = w;
+        size_t from = std::max(begin, w << 6);
+        size_t to = std::min(end, (w << 6) + 64);
+        ascii_class_masks(text.data() + from, to - from, space_acc, word_acc);
+        space_acc <<= (from & 63);
+        word_acc <<= (from & 63);
+    };
+    auto flush = [&]() {
+        if (current_word < bits->private_from) {
+            bits->head_space |= space_acc;
+            bits->head_word |= word_acc;
+        } else {
+            bits->space[current_word] |= space_acc;
+            bits->word[current_word] |= word_acc;
+        }
+    };
+    auto cover = [&](size_t pos) {      // make pos's word current, flushing the words before it
+        while (current_word < (pos >> 6)) {
+            flush();
+            enter_word(current_word + 1);
+        }
+    };
+    const uint8_t* small_classes = nullptr;
+    if (bits && begin < end) {
+        small_classes = two_byte_classes();
+        enter_word(current_word);
+    }
 
-    while (i < len) {
+    while (i < static_cast<int32_t>(end)) {
+        // ASCII runs are one code point per byte - count them and place their checkpoints arithmetically
+        size_t run = ascii_run_length(text.data() + i, end - static_cast<size_t>(i));
+        if (run > 0) {
+            if (checkpoints) {
+                size_t next_checkpoint = (char_index / kCheckpointInterval + 1) * kCheckpointInterval;
+                while (next_checkpoint <= char_index + run) {
+                    checkpoints->push_back(static_cast<size_t>(i) + (next_checkpoint - char_index));
+                    next_checkpoint += kCheckpointInterval;
+                }
+            }
+            char_index += run;
+            i += static_cast<int32_t>(run);
+            continue;
+        }
+        
         int32_t start = i;
         UChar32 c = 0;
         U8_NEXT(s, i, len, c);
-        if (c >= 0) {
-            // Valid UTF-8 sequence
-            codepoints_by_byte[start] = c;
-            next_byte_pos_by_byte[start] = static_cast<size_t>(i);
-
-            // For continuation bytes, mark them invalid
-            for (int32_t j = start + 1; j < i; ++j) {
-                codepoints_by_byte[j] = U_SENTINEL;
-                next_byte_pos_by_byte[j] = j + 1;  // advance 1 byte like uncached version
-            }
-        } else {
-            // Invalid sequence; mark single byte as invalid
-            codepoints_by_byte[start] = U_SENTINEL;
-            next_byte_pos_by_byte[start] = start + 1;
+        if (c < 0) {
+            // Invalid sequence; skip a single byte like get_unicode_char_at_cached does
             i = start + 1;
+            continue;
+        }
+        if (bits) {
+            uint8_t classes = c < 0x800 ? small_classes[c] : 0;
+            bool space = c < 0x800 ? (classes & 1) != 0 : is_unicode_whitespace(c);
+            bool word = c < 0x800 ? (classes & 2) != 0 : is_word_char_optimized(c);
+            if (space || word) {
+                for (size_t pos = static_cast<size_t>(start); pos < static_cast<size_t>(i); ++pos) {
+                    cover(pos);
+                    space_acc |= static_cast<uint64_t>(space) << (pos & 63);
+                    word_acc |= static_cast<uint64_t>(word) << (pos & 63);
+                }
+            }
         }
-        // If we didn't advance, force advance to prevent infinite loop
-        if (i == start) {
-            i++;
+        if (++char_index % kCheckpointInterval == 0 && checkpoints) {
+            checkpoints->push_back(static_cast<size_t>(i));
         }
     }
-    //calculate the unicode length of the string and cache it
-    if (cached_text.empty()) {
-        unicode_length_cached = 0;
-        return;
+    if (bits && begin < end) {
+        cover(end - 1);
+        flush();
     }
-    size_t byte_pos = 0;    
-    while (byte_pos < cached_text.length()) {
-        size_t next_pos;
-        UChar32 c = get_unicode_char_at_cached(byte_pos, next_pos);
-        if (c != U_SENTINEL) {
-            unicode_length_cached++;
-        }
-        if (next_pos <= byte_pos) {
-            // Defensive fallback: make sure we always advance at least 1 byte
-            byte_pos++;
-        } else {
-            byte_pos = next_pos;
-        }
-    }    
-} //end of initialize_cache
-
-UnicodeCacher::UnicodeCacher() : cached_text(""), codepoints_by_byte(nullptr), next_byte_pos_by_byte(nullptr), array_size(0), unicode_length_cached(0) {}
-
-UnicodeCacher::UnicodeCacher(const std::string& text) : cached_text(""), codepoints_by_byte(nullptr), next_byte_pos_by_byte(nullptr), array_size(0), unicode_length_cached(0) {
-    initialize_cache(text);
-}
-
-UnicodeCacher::~UnicodeCacher() {
-    cleanup_arrays();
-}
+    return char_index - first_char_index;
+} //end of index_range
 
-// Copy constructor
-UnicodeCacher::UnicodeCacher(const UnicodeCacher& other) : cached_text(other.cached_text), codepoints_by_byte(nullptr), next_byte_pos_by_byte(nullptr), array_size(0) {
-    if (other.array_size > 0) {
-        array_size = other.array_size;
-        codepoints_by_byte = new UChar32[array_size];
-        next_byte_pos_by_byte = new size_t[array_size];
-        
-        for (size_t i = 0; i < array_size; ++i) {
-            codepoints_by_byte[i] = other.codepoints_by_byte[i];
-            next_byte_pos_by_byte[i] = other.next_byte_pos_by_byte[i];
+void UnicodeCacher::reinitialize(std::string_view text, size_t segment_bytes, const ParallelFor& parallel_for) {
+    // Segments start on non-continuation bytes. Sequential decoding visits every such byte (a valid
+    // sequence only spans continuation bytes, an invalid one advances a byte at a time), so the
+    // segments decode exactly as the single pass would.
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(text.data());
+    std::vector<size_t> starts(1, 0);
+    if (segment_bytes > 0) {
+        for (size_t pos = segment_bytes; pos < text.size(); pos = starts.back() + segment_bytes) {
+            while (pos < text.size() && (s[pos] & 0xc0) == 0x80) {
+                pos++;
+            }
+            if (pos >= text.size()) {
+                break;
+            }
+            starts.push_back(pos);
         }
     }
+    const size_t segment_count = starts.size();
+    if (segment_count < 2 || !parallel_for) {
+        initialize_cache(text);
+        return;
+    }
+    starts.push_back(text.size());
+    
+    // Pass 1 counts each segment's code points, so pass 2 knows where its checkpoints fall
+    std::vector<size_t> first_index(segment_count + 1, 0);
+    parallel_for(segment_count, [&](size_t k) {
+        first_index[k + 1] = index_range(text, starts[k], starts[k + 1], 0, nullptr, nullptr);
+    });
+    for (size_t k = 0; k < segment_count; ++k) {
+        first_index[k + 1] += first_index[k];
+    }
+    
+    // Pass 2 also marks byte classes; a bitmap word straddling two segments is written directly
+    // by the earlier one and merged from the later one's head afterwards
+    space_bits.assign((text.size() + 63) / 64, 0);
+    word_bits.assign((text.size() + 63) / 64, 0);
+    std::vector<ClassBits> segment_bits(segment_count);
+    std::vector<std::vector<size_t>> segment_checkpoints(segment_count);
+    parallel_for(segment_count, [&](size_t k) {
+        segment_bits[k].space = space_bits.data();
+        segment_bits[k].word = word_bits.data();
+        segment_bits[k].private_from = (starts[k] + 63) >> 6;
+        segment_checkpoints[k].reserve((starts[k + 1] - starts[k]) / kCheckpointInterval + 1);
+        index_range(text, starts[k], starts[k + 1], first_index[k], &segment_checkpoints[k], &segment_bits[k]);
+    });
+    for (size_t k = 1; k < segment_count; ++k) {
+        space_bits[starts[k] >> 6] |= segment_bits[k].head_space;
+        word_bits[starts[k] >> 6] |= segment_bits[k].head_word;
+    }
+    
+    cached_text = text;
+    unicode_length_cached = first_index[segment_count];
+    char_checkpoints.clear();
+    char_checkpoints.reserve(text.size() / kCheckpointInterval + 1);
+    char_checkpoints.push_back(0);
+    for (const auto& checkpoints : segment_checkpoints) {
+        char_checkpoints.insert(char_checkpoints.end(), checkpoints.begin(), checkpoints.end());
+    }
 }
 
-// Assignment operator
-UnicodeCacher& UnicodeCacher::operator=(const UnicodeCacher& other) {
-    if (this != &other) {
-        // Clean up existing resources
-        cleanup_arrays();
-        
-        // Copy data
-        cached_text = other.cached_text;
-        if (other.array_size > 0) {
-            array_size = other.array_size;
-            codepoints_by_byte = new UChar32[array_size];
-            next_byte_pos_by_byte = new size_t[array_size];
-            
-            for (size_t i = 0; i < array_size; ++i) {
-                codepoints_by_byte[i] = other.codepoints_by_byte[i];
-                next_byte_pos_by_byte[i] = other.next_byte_pos_by_byte[i];
-            }
-        }
-    }
-    return *this;
+UnicodeCacher::UnicodeCacher() : unicode_length_cached(0) {
+    char_checkpoints.push_back(0);
+}
+
+UnicodeCacher::UnicodeCacher(std::string_view text) : unicode_length_cached(0) {
+    initialize_cache(text);
 }
 
-void UnicodeCacher::reinitialize(const std::string& text) {
+void UnicodeCacher::reinitialize(std::string_view text) {
     initialize_cache(text);
 }
 
 UChar32 UnicodeCacher::get_unicode_char_at_cached(size_t byte_pos, size_t& next_byte_pos) const {
-#ifdef DEBUG_MISMATCHES
-    size_t control_next_byte_pos = next_byte_pos; 
-    UChar32 control_c = get_unicode_char_at(cached_text, byte_pos, control_next_byte_pos);
-#endif 
     if (byte_pos >= cached_text.size()) {
         next_byte_pos = cached_text.size();
+        return U_SENTINEL;
+    }
 
-#ifdef DEBUG_MISMATCHES
-        if (control_c != U_SENTINEL || control_next_byte_pos != next_byte_pos) {
-            LEAFRA_DEBUG_LOG("CACHE", "MISMATCH byte_pos=" + std::to_string(byte_pos) + 
-            ", text.size()=" + std::to_string(cached_text.size()) +
-            ", control_c=" + std::to_string(control_c) + 
-            ", c=" + "-1" + 
-            ", control_next_byte_pos=" + std::to_string(control_next_byte_pos) + 
-            ", next_byte_pos=" + std::to_string(next_byte_pos));
-        }
-#endif
+    // ASCII needs no decoding
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(cached_text.data());
+    if (s[byte_pos] < 0x80) {
+        next_byte_pos = byte_pos + 1;
+        return static_cast<UChar32>(s[byte_pos]);
+    }
+
+    int32_t i = static_cast<int32_t>(byte_pos);
+    UChar32 c = 0;
+    U8_NEXT(s, i, static_cast<int32_t>(cached_text.size()), c);
+    if (c < 0) {
+        // Invalid or continuation byte: report it and advance 1 byte like the uncached version
+        next_byte_pos = byte_pos + 1;
         return U_SENTINEL;
     }
+    next_byte_pos = static_cast<size_t>(i);
+    return c;
+}
 
-    next_byte_pos = next_byte_pos_by_byte[byte_pos];
+size_t UnicodeCacher::get_previous_char_pos_cached(size_t byte_pos) const {
+    if (byte_pos == 0 || cached_text.empty()) return 0;
+    byte_pos = std::min(byte_pos, cached_text.size());
+    
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(cached_text.data());
+    // A code point spans at most 4 bytes; step back over continuation bytes to its lead byte
+    size_t lead = byte_pos - 1;
+    while (lead > 0 && byte_pos - lead < 4 && (s[lead] & 0xc0) == 0x80) {
+        lead--;
+    }
+    size_t next_pos;
+    if (get_unicode_char_at_cached(lead, next_pos) != U_SENTINEL && next_pos >= byte_pos) {
+        return lead;
+    }
+    return byte_pos - 1;   // Invalid byte - move back one byte
+}
 
-#ifdef DEBUG_MISMATCHES
-    if( control_c != codepoints_by_byte[byte_pos] || control_next_byte_pos != next_byte_pos) {
-        LEAFRA_DEBUG_LOG("CACHE", "MISMATCH byte_pos=" + std::to_string(byte_pos) + 
-        ", text.size()=" + std::to_string(cached_text.size()) +
-        ", control_c=" + std::to_string(control_c) + 
-        ", c=" + std::to_string(codepoints_by_byte[byte_pos]) + 
-        ", control_next_byte_pos=" + std::to_string(control_next_byte_pos) + 
-        ", next_byte_pos=" + std::to_string(next_byte_pos));
+size_t UnicodeCacher::get_char_index_for_byte_pos_cached(size_t byte_pos) const {
+    if (byte_pos == 0 || cached_text.empty()) return 0;
+    if (byte_pos >= cached_text.length()) return unicode_length_cached;
+    
+    // Last checkpoint at or before byte_pos, then decode forward from it
+    auto it = std::upper_bound(char_checkpoints.begin(), char_checkpoints.end(), byte_pos);
+    size_t checkpoint = static_cast<size_t>(it - char_checkpoints.begin()) - 1;
+    size_t char_index = checkpoint * kCheckpointInterval;
+    size_t pos = char_checkpoints[checkpoint];
+    while (pos < byte_pos) {
+        size_t next_pos;
+        if (get_unicode_char_at_cached(pos, next_pos) != U_SENTINEL) {
+            char_index++;
+        }
+        pos = next_pos;
     }
-#endif
-    return codepoints_by_byte[byte_pos];
+    return char_index;
 }
 
 size_t UnicodeCacher::get_byte_pos_for_char_index_cached(size_t char_index) const {
     if (char_index == 0) return 0;
     if (cached_text.empty()) return 0;
+    if (char_index >= unicode_length_cached) return cached_text.length();
     
-    size_t current_char = 0;
-    size_t byte_pos = 0;
+    // Start from the nearest checkpoint and decode at most kCheckpointInterval - 1 code points
+    size_t checkpoint = char_index / kCheckpointInterval;
+    size_t current_char = checkpoint * kCheckpointInterval;
+    size_t byte_pos = char_checkpoints[checkpoint];
     while (byte_pos < cached_text.length() && current_char < char_index) {
         size_t next_pos;
         UChar32 c = get_unicode_char_at_cached(byte_pos, next_pos);
-
         if (c != U_SENTINEL) {
             current_char++;
         }
         byte_pos = next_pos;
-        
-        // Safety check
-        if (next_pos <= byte_pos) {
-            byte_pos++;
-        }
     }
     
     return byte_pos;
@@ -225,91 +308,76 @@ std::string UnicodeCacher::get_utf8_substring_cached(size_t start_char_pos, size
     
     if (start_byte_pos >= end_byte_pos) return "";
     
-    return cached_text.substr(start_byte_pos, end_byte_pos - start_byte_pos);
+    return std::string(cached_text.substr(start_byte_pos, end_byte_pos - start_byte_pos));
 }
 
 size_t UnicodeCacher::get_unicode_length_cached() const {
     return unicode_length_cached;
 }
 
+size_t UnicodeCacher::memory_bytes() const {
+    return char_checkpoints.capacity() * sizeof(size_t) +
+           (space_bits.capacity() + word_bits.capacity()) * sizeof(uint64_t);
+}
+
 
 size_t UnicodeCacher::find_word_boundary_helper_for_unicode_cached(size_t start_byte_pos, bool search_forward) const {
     if (cached_text.empty()) return 0;
     if (start_byte_pos >= cached_text.length()) return cached_text.length();
     
     if (search_forward) {
-        // Search forward for word boundary
-        size_t byte_pos = start_byte_pos;
-        bool in_word = false;
-        
-        while (byte_pos < cached_text.length()) {
-            size_t next_pos;
-            UChar32 c = get_unicode_char_at_cached(byte_pos, next_pos);
-            
-            if (c == U_SENTINEL) {
-                byte_pos = next_pos;
-                continue;
-            }
-            
-            bool is_word_char = is_word_char_optimized(c);
-            
-            if (in_word && !is_word_char) {
-                // End of word found
-                return byte_pos;
-            }
-            
-            in_word = is_word_char;
-            byte_pos = next_pos;
-        }
-        
-        return cached_text.length();
-    } else {
-        // Search backward for word boundary
-        if (start_byte_pos == 0) return 0;
-        
-        size_t byte_pos = start_byte_pos;
-        bool was_in_word = false;
-        
-        // Check current position first
-        size_t next_pos;
-        UChar32 c = get_unicode_char_at_cached(byte_pos, next_pos);
-        if (c != U_SENTINEL) {
-            was_in_word = is_word_char_optimized(c);
-        }
-        
-        // Move backward character by character
-        while (byte_pos > 0) {
-            // Find previous character position
-            size_t prev_pos = 0;
-            size_t temp_pos = 0;
-            
-            while (temp_pos < byte_pos && temp_pos < cached_text.length()) {
-                prev_pos = temp_pos;
-                size_t next_temp_pos;
-                UChar32 temp_c = get_unicode_char_at_cached(temp_pos, next_temp_pos);
-                if (temp_c == U_SENTINEL) break;
-                temp_pos = next_temp_pos;
-            }
-            
-            UChar32 prev_c = get_unicode_char_at_cached(prev_pos, next_pos);
-            if (prev_c == U_SENTINEL) {
-                byte_pos = prev_pos;
-                continue;
-            }
-            
-            bool is_word_char = is_word_char_optimized(prev_c);
-            
-            if (was_in_word && !is_word_char) {
-                // Found word boundary
-                return byte_pos;
-            }
-            
-            was_in_word = is_word_char;
-            byte_pos = prev_pos;
-        }
-        
-        return 0;
+        // End of the word containing start_byte_pos, or of the next word
+        size_t word_start = find_next_byte(ByteClass::WORD, true, start_byte_pos, cached_text.length());
+        return find_next_byte(ByteClass::WORD, false, word_start, cached_text.length());
+    }
+    
+    // Start of the word containing start_byte_pos, or of the previous word
+    if (start_byte_pos == 0) return 0;
+    size_t in_word = byte_in_class(ByteClass::WORD, start_byte_pos)
+        ? start_byte_pos
+        : find_prev_byte(ByteClass::WORD, true, 0, start_byte_pos);
+    if (in_word == std::string::npos) return 0;
+    size_t before_word = find_prev_byte(ByteClass::WORD, false, 0, in_word);
+    return before_word == std::string::npos ? 0 : before_word + 1;
+}
+
+bool UnicodeCacher::byte_in_class(ByteClass cls, size_t byte_pos) const {
+    if (byte_pos >= cached_text.size()) return false;
+    return (class_bits(cls)[byte_pos >> 6] >> (byte_pos & 63)) & 1u;
+}
+
+size_t UnicodeCacher::find_next_byte(ByteClass cls, bool in_class, size_t from, size_t limit) const {
+    limit = std::min(limit, cached_text.size());
+    if (from >= limit) return limit;
+    
+    const std::vector<uint64_t>& bits = class_bits(cls);
+    const uint64_t flip = in_class ? 0 : ~0ULL;
+    const size_t last_word = (limit - 1) >> 6;
+    size_t w = from >> 6;
+    uint64_t word = (bits[w] ^ flip) & (~0ULL << (from & 63));
+    while (word == 0) {
+        if (++w > last_word) return limit;
+        word = bits[w] ^ flip;
+    }
+    // Bits past the end of the text are clear, so a flipped scan can land beyond limit
+    return std::min(limit, (w << 6) + static_cast<size_t>(__builtin_ctzll(word)));
+}
+
+size_t UnicodeCacher::find_prev_byte(ByteClass cls, bool in_class, size_t floor, size_t before) const {
+    before = std::min(before, cached_text.size());
+    if (floor >= before) return std::string::npos;
+    
+    const std::vector<uint64_t>& bits = class_bits(cls);
+    const uint64_t flip = in_class ? 0 : ~0ULL;
+    const size_t first_word = floor >> 6;
+    size_t w = (before - 1) >> 6;
+    uint64_t word = (bits[w] ^ flip) & (~0ULL >> (63 - ((before - 1) & 63)));
+    while (word == 0) {
+        if (w-- == first_word) return std::string::npos;
+        word = bits[w] ^ flip;
     }
+    size_t pos = (w << 6) + 63 - static_cast<size_t>(__builtin_clzll(word));
+    return pos >= floor ? pos : std::string::npos;
 }
 
 
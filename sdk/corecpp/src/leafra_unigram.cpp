@@ -0,0 +1,831 @@
+#include "leafra/leafra_unigram.h"
+#include "leafra/leafra_text_normalizer.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace leafra {
+
+namespace {
+
+// ==============================================================================
+// Protobuf wire format (just what ModelProto needs)
+// ==============================================================================
+
+class ProtoReader {
+public:
+    ProtoReader(const char* data, size_t size) : data_(reinterpret_cast<const uint8_t*>(data)), end_(data_ + size) {}
+    explicit ProtoReader(std::string_view bytes) : ProtoReader(bytes.data(), bytes.size()) {}
+
+    bool done() const { return data_ == end_; }
+
+    bool next(uint32_t& field, uint32_t& wire_type) {
+        uint64_t tag = 0;
+        if (!varint(tag)) {
+            return false;
+        }
+        field = static_cast<uint32_t>(tag >> 3);
+        wire_type = static_cast<uint32_t>(tag & 7u);
+        return field != 0;
+    }
+
+    bool varint(uint64_t& value) {
+        value = 0;
+        for (uint32_t shift = 0; shift < 64 && data_ < end_; shift += 7) {
+            const uint8_t byte = *data_++;
+            value |= static_cast<uint64_t>(byte & 0x7fu) << shift;
+            if (!(byte & 0x80u)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool bytes(std::string_view& value) {
+        uint64_t size = 0;
+        if (!varint(size) || size > static_cast<uint64_t>(end_ - data_)) {
+            return false;
+        }
+        value = std::string_view(reinterpret_cast<const char*>(data_), static_cast<size_t>(size));
+        data_ += size;
+        return true;
+    }
+
+    bool fixed32(uint32_t& value) {
+        if (end_ - data_ < 4) {
+            return false;
+        }
+        value = static_cast<uint32_t>(data_[0]) | (static_cast<uint32_t>(data_[1]) << 8) |
+                (static_cast<uint32_t>(data_[2]) << 16) | (static_cast<uint32_t>(data_[3]) << 24);
+        data_ += 4;
+        return true;
+    }
+
+    bool skip(uint32_t wire_type) {
+        uint64_t ignored = 0;
+        uint32_t ignored32 = 0;
+        std::string_view ignored_bytes;
+        switch (wire_type) {
+            case 0: return varint(ignored);
+            case 1: return fixed32(ignored32) && fixed32(ignored32);
+            case 2: return bytes(ignored_bytes);
+            case 5: return fixed32(ignored32);
+            default: return false;          // Groups are not used by ModelProto
+        }
+    }
+
+private:
+    const uint8_t* data_;
+    const uint8_t* end_;
+};
+
+// ModelProto.SentencePiece.Type
+enum PieceType : uint8_t {
+    NORMAL = 1,
+    UNKNOWN = 2,
+    CONTROL = 3,
+    USER_DEFINED = 4,
+    UNUSED = 5,
+    BYTE = 6
+};
+
+// TrainerSpec.ModelType
+constexpr uint64_t kUnigramModel = 1;
+
+// ==============================================================================
+// Double-array trie
+// ==============================================================================
+
+/**
+ * @brief Byte-labelled double-array trie mapping keys to values
+ *
+ * The child of node n along byte c is base[n] + c + 1 when its check is n; a node ending
+ * a key carries the key's value. Built once from sorted keys, then walked read-only.
+ */
+class DoubleArrayTrie {
+public:
+    /**
+     * @brief Build from keys sorted by their bytes (unsigned), without duplicates or empty keys
+     */
+    void build(const std::vector<std::pair<std::string_view, int32_t>>& keys) {
+        units_.assign(1, Unit());
+        units_[0].check = 0;                // The root is never free
+        free_next_.assign(1, 0);            // Slot 0 heads the circular list of free slots
+        free_prev_.assign(1, 0);
+        trials_.assign(1, 0);
+        grow(512);
+        if (!keys.empty()) {
+            insert(0, keys, 0, keys.size(), 0);
+        }
+
+        // Trailing free slots are never reached by a walk
+        size_t used = units_.size();
+        while (used > 1 && units_[used - 1].check < 0) {
+            used--;
+        }
+        units_.resize(used);
+        units_.shrink_to_fit();
+        free_next_ = std::vector<int32_t>();
+        free_prev_ = std::vector<int32_t>();
+        trials_ = std::vector<uint8_t>();
+    }
+
+    bool empty() const { return units_.size() <= 1; }
+
+    // Whether any key starts with this byte
+    bool has_root_child(uint8_t label) const { return child(0, label) != kNone; }
+
+    /**
+     * @brief Call f(length, value) for every key that is a prefix of data, shortest first
+     */
+    template <typename F>
+    void for_each_prefix(const char* data, size_t size, F&& f) const {
+        size_t node = 0;
+        for (size_t i = 0; i < size; ++i) {
+            node = child(node, static_cast<uint8_t>(data[i]));
+            if (node == kNone) {
+                return;
+            }
+            if (units_[node].value >= 0) {
+                f(i + 1, units_[node].value);
+            }
+        }
+    }
+
+private:
+    struct Unit {
+        int32_t base = 0;
+        int32_t check = -1;                 // Parent node (-1 = free)
+        int32_t value = -1;                 // Key value when a key ends here
+    };
+
+    static constexpr size_t kNone = static_cast<size_t>(-1);
+
+    size_t child(size_t node, uint8_t label) const {
+        const size_t next = static_cast<size_t>(units_[node].base) + label + 1;
+        return next < units_.size() && units_[next].check == static_cast<int32_t>(node) ? next : kNone;
+    }
+
+    bool is_free(size_t index) const { return index >= units_.size() || units_[index].check < 0; }
+
+    // Extend the array, appending the new slots to the free list
+    void grow(size_t size) {
+        const size_t old_size = units_.size();
+        units_.resize(size);
+        free_next_.resize(size);
+        free_prev_.resize(size);
+        trials_.resize(size, 0);
+        for (size_t i = old_size; i < size; ++i) {
+            const int32_t last = free_prev_[0];
+            free_next_[static_cast<size_t>(last)] = static_cast<int32_t>(i);
+            free_prev_[i] = last;
+            free_next_[i] = 0;
+            free_prev_[0] = static_cast<int32_t>(i);
+        }
+    }
+
+    void unlink(size_t slot) {
+        if (free_next_[slot] < 0) {
+            return;                         // Already dropped from the list
+        }
+        free_next_[static_cast<size_t>(free_prev_[slot])] = free_next_[slot];
+        free_prev_[static_cast<size_t>(free_next_[slot])] = free_prev_[slot];
+        free_next_[slot] = -1;
+    }
+
+    // keys[begin, end) share their first depth bytes, which lead to node
+    void insert(size_t node, const std::vector<std::pair<std::string_view, int32_t>>& keys, size_t begin, size_t end, size_t depth) {
+        if (keys[begin].first.size() == depth) {
+            units_[node].value = keys[begin].second;
+            if (++begin == end) {
+                return;
+            }
+        }
+
+        // Distinct next bytes, ascending since the keys are sorted
+        uint8_t labels[256];
+        size_t label_count = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const uint8_t label = static_cast<uint8_t>(keys[i].first[depth]);
+            if (label_count == 0 || labels[label_count - 1] != label) {
+                labels[label_count++] = label;
+            }
+        }
+
+        // The first label takes a free slot from the list; slots that keep failing are dropped
+        // from it. The array always ends in at least 257 free slots, so a base fits before the
+        // list runs out
+        size_t base = 0;
+        for (size_t slot = static_cast<size_t>(free_next_[0]); slot != 0;) {
+            const size_t next = static_cast<size_t>(free_next_[slot]);
+            if (slot > labels[0]) {
+                base = slot - labels[0] - 1;
+                bool fits = true;
+                for (size_t l = 1; l < label_count && fits; ++l) {
+                    fits = is_free(base + labels[l] + 1);
+                }
+                if (fits) {
+                    break;
+                }
+                if (++trials_[slot] >= kMaxTrials) {
+                    unlink(slot);
+                }
+            }
+            slot = next;
+        }
+        units_[node].base = static_cast<int32_t>(base);
+        for (size_t l = 0; l < label_count; ++l) {
+            units_[base + labels[l] + 1].check = static_cast<int32_t>(node);
+            unlink(base + labels[l] + 1);
+        }
+        const size_t last = base + labels[label_count - 1] + 1;
+        if (last + 257 >= units_.size()) {
+            grow(std::max(last + 512, units_.size() + units_.size() / 2));
+        }
+
+        size_t group_begin = begin;
+        for (size_t l = 0; l < label_count; ++l) {
+            size_t group_end = group_begin;
+            while (group_end < end && static_cast<uint8_t>(keys[group_end].first[depth]) == labels[l]) {
+                group_end++;
+            }
+            insert(base + labels[l] + 1, keys, group_begin, group_end, depth + 1);
+            group_begin = group_end;
+        }
+    } //insert
+
+    static constexpr uint8_t kMaxTrials = 16;
+
+    std::vector<Unit> units_;
+    std::vector<int32_t> free_next_;        // Build only: free slot list (-1 = dropped)
+    std::vector<int32_t> free_prev_;
+    std::vector<uint8_t> trials_;           // Build only: failed placements from each free slot
+};
+
+// Sort key for trie construction: unsigned byte order
+bool keyLess(const std::pair<std::string_view, int32_t>& a, const std::pair<std::string_view, int32_t>& b) {
+    return std::lexicographical_compare(a.first.begin(), a.first.end(), b.first.begin(), b.first.end(),
+                                        [](char x, char y) { return static_cast<uint8_t>(x) < static_cast<uint8_t>(y); });
+}
+
+// ==============================================================================
+// Precompiled character map (the Darts-clone double array SentencePiece serializes)
+// ==============================================================================
+
+/**
+ * @brief Read-only view of NormalizerSpec.precompiled_charsmap
+ *
+ * The blob is a little-endian uint32 trie size, the trie's 32-bit units, then the
+ * NUL-terminated replacement strings the trie values point into.
+ */
+class CharsMap {
+public:
+    bool load(std::string_view blob) {
+        units_.clear();
+        replacements_.clear();
+        if (blob.empty()) {
+            return true;                    // Identity normalization
+        }
+        if (blob.size() <= 4) {
+            return false;
+        }
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(blob.data());
+        const uint32_t trie_size = static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+                                   (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+        if (trie_size >= blob.size() || trie_size % 4 != 0) {
+            return false;
+        }
+        units_.resize(trie_size / 4);
+        for (size_t i = 0; i < units_.size(); ++i) {
+            const uint8_t* unit = bytes + 4 + i * 4;
+            units_[i] = static_cast<uint32_t>(unit[0]) | (static_cast<uint32_t>(unit[1]) << 8) |
+                        (static_cast<uint32_t>(unit[2]) << 16) | (static_cast<uint32_t>(unit[3]) << 24);
+        }
+        replacements_.assign(blob.data() + 4 + trie_size, blob.size() - 4 - trie_size);
+        return !units_.empty();
+    }
+
+    bool empty() const { return units_.empty(); }
+
+    // Whether some rule starts with this byte
+    bool has_rule_starting_with(uint8_t byte) const {
+        if (units_.empty()) {
+            return false;
+        }
+        const size_t node = offset(units_[0]) ^ byte;
+        return node < units_.size() && label(units_[node]) == byte;
+    }
+
+    /**
+     * @brief Longest rule matching a prefix of data (Darts commonPrefixSearch)
+     * @return Bytes the rule consumes (0 = none), with its replacement in replacement
+     */
+    size_t longest_match(const char* data, size_t size, std::string_view& replacement) const {
+        size_t longest = 0;
+        uint32_t value = 0;
+        size_t node = units_.empty() ? 0 : offset(units_[0]);
+        for (size_t i = 0; i < size && !units_.empty(); ++i) {
+            const uint8_t byte = static_cast<uint8_t>(data[i]);
+            node ^= byte;
+            if (node >= units_.size() || label(units_[node]) != byte) {
+                break;
+            }
+            const uint32_t unit = units_[node];
+            node ^= offset(unit);
+            if (has_leaf(unit)) {
+                if (node >= units_.size()) {
+                    break;
+                }
+                longest = i + 1;
+                value = units_[node] & ((1u << 31) - 1);
+            }
+        }
+        if (longest == 0 || value >= replacements_.size()) {
+            return 0;
+        }
+        const char* text = replacements_.data() + value;
+        const void* terminator = std::memchr(text, '\0', replacements_.size() - value);
+        replacement = std::string_view(text, terminator ? static_cast<size_t>(static_cast<const char*>(terminator) - text)
+                                                        : replacements_.size() - value);
+        return longest;
+    }
+
+private:
+    static bool has_leaf(uint32_t unit) { return ((unit >> 8) & 1u) == 1u; }
+    static uint32_t label(uint32_t unit) { return unit & ((1u << 31) | 0xffu); }
+    static size_t offset(uint32_t unit) { return (unit >> 10) << ((unit & (1u << 9)) >> 6); }
+
+    std::vector<uint32_t> units_;
+    std::string replacements_;
+};
+
+// ==============================================================================
+// UTF-8 (SentencePiece's rules: overlong forms and surrogates are malformed)
+// ==============================================================================
+
+inline bool isTrailByte(uint8_t byte) {
+    return (byte & 0xc0u) == 0x80u;
+}
+
+inline bool isValidCodepoint(uint32_t c) {
+    return c < 0xd800u || (c >= 0xe000u && c <= 0x10ffffu);
+}
+
+// Length of the well-formed character at data, or 0 if it is malformed
+size_t validCharLength(const char* data, size_t size) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(data);
+    if (s[0] < 0x80u) {
+        return 1;
+    }
+    if (size >= 2 && (s[0] & 0xe0u) == 0xc0u) {
+        const uint32_t c = ((s[0] & 0x1fu) << 6) | (s[1] & 0x3fu);
+        return isTrailByte(s[1]) && c >= 0x80u && isValidCodepoint(c) ? 2 : 0;
+    }
+    if (size >= 3 && (s[0] & 0xf0u) == 0xe0u) {
+        const uint32_t c = ((s[0] & 0x0fu) << 12) | ((s[1] & 0x3fu) << 6) | (s[2] & 0x3fu);
+        return isTrailByte(s[1]) && isTrailByte(s[2]) && c >= 0x800u && isValidCodepoint(c) ? 3 : 0;
+    }
+    if (size >= 4 && (s[0] & 0xf8u) == 0xf0u) {
+        const uint32_t c = ((s[0] & 0x07u) << 18) | ((s[1] & 0x3fu) << 12) | ((s[2] & 0x3fu) << 6) | (s[3] & 0x3fu);
+        return isTrailByte(s[1]) && isTrailByte(s[2]) && isTrailByte(s[3]) && c >= 0x10000u && isValidCodepoint(c) ? 4 : 0;
+    }
+    return 0;
+}
+
+// Lattice step: bytes of the character at data judged by its lead byte alone
+inline size_t leadCharLength(const char* data) {
+    return static_cast<size_t>("\1\1\1\1\1\1\1\1\1\1\1\1\2\2\3\4"[static_cast<uint8_t>(data[0]) >> 4]);
+}
+
+constexpr char kSpaceSymbol[] = "\xe2\x96\x81";     // U+2581, stands in for ' ' in pieces
+constexpr size_t kSpaceSymbolSize = 3;
+constexpr char kReplacementChar[] = "\xef\xbf\xbd";  // U+FFFD, replaces each malformed byte
+constexpr float kUnkPenalty = 10.0f;                 // unk scores below every piece by this
+
+// Best path ending at one byte position of the normalized text
+struct BestPathNode {
+    int32_t id = -1;
+    float score = 0.0f;
+    int32_t starts_at = -1;
+};
+
+// Per-thread buffers: after the first few calls encoding allocates nothing
+struct EncodeScratch {
+    std::string normalized;
+    std::vector<BestPathNode> best_path;
+};
+
+} // namespace
+
+// ==============================================================================
+// UnigramTokenizer
+// ==============================================================================
+
+struct UnigramTokenizer::Impl {
+    struct Piece {
+        float score = 0.0f;
+        uint8_t type = NORMAL;
+    };
+
+    std::vector<Piece> pieces;
+    DoubleArrayTrie vocabulary;             // NORMAL, USER_DEFINED and UNUSED pieces -> ID
+    DoubleArrayTrie user_symbols;           // USER_DEFINED pieces, matched before normalization
+    CharsMap charsmap;
+    int32_t unk_id = -1;
+    int32_t byte_ids[256];                  // <0xXX> pieces for byte fallback
+    bool byte_fallback = false;
+    float min_score = FLT_MAX;
+    float max_score = FLT_MIN;
+
+    bool add_dummy_prefix = true;
+    bool remove_extra_whitespaces = true;
+    bool escape_whitespaces = true;
+    bool ascii_passthrough = false;         // Printable ASCII is never rewritten (bulk-copied)
+
+    /**
+     * @brief Parse a serialized ModelProto into this (empty) Impl
+     */
+    bool parse(std::string_view model, std::string& error) {
+        std::vector<std::pair<std::string_view, int32_t>> normal_keys;
+        std::vector<std::pair<std::string_view, int32_t>> user_keys;
+        std::string_view charsmap_blob;
+        uint64_t model_type = kUnigramModel;
+        bool whitespace_as_suffix = false;
+        std::fill(byte_ids, byte_ids + 256, -1);
+
+        ProtoReader reader(model);
+        uint32_t field = 0;
+        uint32_t wire_type = 0;
+        while (!reader.done()) {
+            if (!reader.next(field, wire_type)) {
+                error = "Malformed model";
+                return false;
+            }
+            std::string_view message;
+            if (wire_type != 2 || field < 1 || field > 3) {
+                if (!reader.skip(wire_type)) {
+                    error = "Malformed model";
+                    return false;
+                }
+                continue;
+            }
+            if (!reader.bytes(message)) {
+                error = "Malformed model";
+                return false;
+            }
+
+            ProtoReader inner(message);
+            uint64_t value = 0;
+            uint32_t bits = 0;
+            std::string_view text;
+            bool ok = true;
+            if (field == 1) {
+                // SentencePiece: piece (1), score (2), type (3)
+                std::string_view piece;
+                Piece info;
+                while (ok && !inner.done()) {
+                    uint32_t f = 0, w = 0;
+                    ok = inner.next(f, w);
+                    if (!ok) break;
+                    if (f == 1 && w == 2) {
+                        ok = inner.bytes(piece);
+                    } else if (f == 2 && w == 5) {
+                        ok = inner.fixed32(bits);
+                        std::memcpy(&info.score, &bits, sizeof(info.score));
+                    } else if (f == 3 && w == 0) {
+                        ok = inner.varint(value);
+                        info.type = static_cast<uint8_t>(value);
+                    } else {
+                        ok = inner.skip(w);
+                    }
+                }
+                if (!ok || piece.empty() || piece.find('\0') != std::string_view::npos) {
+                    error = "Malformed piece " + std::to_string(pieces.size());
+                    return false;
+                }
+                const int32_t id = static_cast<int32_t>(pieces.size());
+                pieces.push_back(info);
+                if (info.type == NORMAL || info.type == USER_DEFINED || info.type == UNUSED) {
+                    normal_keys.emplace_back(piece, id);
+                }
+                if (info.type == USER_DEFINED) {
+                    user_keys.emplace_back(piece, id);
+                }
+                if (info.type == NORMAL) {
+                    min_score = std::min(min_score, info.score);
+                    max_score = std::max(max_score, info.score);
+                }
+                if (info.type == UNKNOWN) {
+                    if (unk_id >= 0) {
+                        error = "More than one unknown piece";
+                        return false;
+                    }
+                    unk_id = id;
+                }
+                if (info.type == BYTE && piece.size() == 6 && piece.compare(0, 3, "<0x") == 0 && piece[5] == '>') {
+                    const unsigned long byte = std::strtoul(std::string(piece.substr(3, 2)).c_str(), nullptr, 16);
+                    byte_ids[byte & 0xffu] = id;
+                }
+            } else {
+                while (ok && !inner.done()) {
+                    uint32_t f = 0, w = 0;
+                    ok = inner.next(f, w);
+                    if (!ok) break;
+                    if (field == 2 && w == 0 && (f == 3 || f == 24 || f == 35)) {
+                        // TrainerSpec: model_type (3), treat_whitespace_as_suffix (24), byte_fallback (35)
+                        ok = inner.varint(value);
+                        if (f == 3) model_type = value;
+                        if (f == 24) whitespace_as_suffix = value != 0;
+                        if (f == 35) byte_fallback = value != 0;
+                    } else if (field == 3 && f == 2 && w == 2) {
+                        // NormalizerSpec: precompiled_charsmap (2)
+                        ok = inner.bytes(text);
+                        charsmap_blob = text;
+                    } else if (field == 3 && w == 0 && f >= 3 && f <= 5) {
+                        // NormalizerSpec: add_dummy_prefix (3), remove_extra_whitespaces (4), escape_whitespaces (5)
+                        ok = inner.varint(value);
+                        if (f == 3) add_dummy_prefix = value != 0;
+                        if (f == 4) remove_extra_whitespaces = value != 0;
+                        if (f == 5) escape_whitespaces = value != 0;
+                    } else {
+                        ok = inner.skip(w);
+                    }
+                }
+                if (!ok) {
+                    error = field == 2 ? "Malformed trainer spec" : "Malformed normalizer spec";
+                    return false;
+                }
+            }
+        }
+
+        if (model_type != kUnigramModel) {
+            error = "Not a unigram model (model_type " + std::to_string(model_type) + ")";
+            return false;
+        }
+        if (whitespace_as_suffix) {
+            error = "treat_whitespace_as_suffix models are not supported";
+            return false;
+        }
+        if (unk_id < 0) {
+            error = "Model has no unknown piece";
+            return false;
+        }
+        if (!charsmap.load(charsmap_blob)) {
+            error = "Malformed precompiled_charsmap";
+            return false;
+        }
+        for (int32_t& id : byte_ids) {
+            if (id < 0) {
+                id = unk_id;
+            }
+        }
+
+        std::sort(normal_keys.begin(), normal_keys.end(), keyLess);
+        std::sort(user_keys.begin(), user_keys.end(), keyLess);
+        for (size_t i = 1; i < normal_keys.size(); ++i) {
+            if (normal_keys[i - 1].first == normal_keys[i].first) {
+                error = "Duplicate piece " + std::string(normal_keys[i].first);
+                return false;
+            }
+        }
+        vocabulary.build(normal_keys);
+        user_symbols.build(user_keys);
+
+        ascii_passthrough = true;
+        for (int byte = 0x20; byte <= 0x7e && ascii_passthrough; ++byte) {
+            ascii_passthrough = !charsmap.has_rule_starting_with(static_cast<uint8_t>(byte)) &&
+                                !user_symbols.has_root_child(static_cast<uint8_t>(byte));
+        }
+        return true;
+    } //parse
+
+    /**
+     * @brief One step of the normalizer: what the text at data becomes and how many bytes it consumes
+     */
+    size_t normalizePrefix(const char* data, size_t size, std::string_view& replacement) const {
+        if (!user_symbols.empty()) {
+            size_t longest = 0;
+            user_symbols.for_each_prefix(data, size, [&longest](size_t length, int32_t) { longest = length; });
+            if (longest > 0) {
+                replacement = std::string_view(data, longest);
+                return longest;
+            }
+        }
+        if (!charsmap.empty()) {
+            const size_t consumed = charsmap.longest_match(data, size, replacement);
+            if (consumed > 0) {
+                return consumed;
+            }
+        }
+        const size_t length = validCharLength(data, size);
+        if (length == 0) {
+            replacement = std::string_view(kReplacementChar, 3);
+            return 1;
+        }
+        replacement = std::string_view(data, length);
+        return length;
+    }
+
+    void appendSpace(std::string& out) const {
+        if (escape_whitespaces) {
+            out.append(kSpaceSymbol, kSpaceSymbolSize);
+        } else {
+            out.push_back(' ');
+        }
+    }
+
+    // Mirrors SentencePiece's Normalizer::Normalize (without the byte alignment)
+    void normalize(std::string_view input, std::string& out) const {
+        out.clear();
+        const char* data = input.data();
+        const size_t size = input.size();
+        size_t pos = 0;
+        std::string_view replacement;
+
+        if (remove_extra_whitespaces) {
+            while (pos < size) {
+                const size_t consumed = normalizePrefix(data + pos, size - pos, replacement);
+                if (replacement != " ") {
+                    break;
+                }
+                pos += consumed;
+            }
+        }
+        if (pos == size) {
+            return;
+        }
+        if (add_dummy_prefix) {
+            appendSpace(out);
+        }
+
+        bool is_prev_space = remove_extra_whitespaces;
+        while (pos < size) {
+            if (ascii_passthrough) {
+                // Printable ASCII maps to itself: copy the run in bulk, handling its spaces inline
+                const size_t run = plain_ascii_run_length(data + pos, size - pos, false, false);
+                const char* p = data + pos;
+                const char* end = p + run;
+                while (p < end) {
+                    const char* space = static_cast<const char*>(std::memchr(p, ' ', static_cast<size_t>(end - p)));
+                    const char* stop = space ? space : end;
+                    if (stop > p) {
+                        out.append(p, static_cast<size_t>(stop - p));
+                        is_prev_space = false;
+                        p = stop;
+                    }
+                    if (p < end) {
+                        if (!is_prev_space) {
+                            appendSpace(out);
+                            is_prev_space = remove_extra_whitespaces;
+                        }
+                        ++p;
+                    }
+                }
+                pos += run;
+                if (pos == size) {
+                    break;
+                }
+            }
+
+            const size_t consumed = normalizePrefix(data + pos, size - pos, replacement);
+            if (is_prev_space) {
+                while (!replacement.empty() && replacement.front() == ' ') {
+                    replacement.remove_prefix(1);
+                }
+            }
+            if (!replacement.empty()) {
+                for (char c : replacement) {
+                    if (escape_whitespaces && c == ' ') {
+                        out.append(kSpaceSymbol, kSpaceSymbolSize);
+                    } else {
+                        out.push_back(c);
+                    }
+                }
+                is_prev_space = replacement.back() == ' ';
+            }
+            pos += consumed;
+            if (!remove_extra_whitespaces) {
+                is_prev_space = false;
+            }
+        }
+
+        if (remove_extra_whitespaces) {
+            const size_t space_size = escape_whitespaces ? kSpaceSymbolSize : 1;
+            const char* space = escape_whitespaces ? kSpaceSymbol : " ";
+            while (out.size() >= space_size && out.compare(out.size() - space_size, space_size, space, space_size) == 0) {
+                out.resize(out.size() - space_size);
+            }
+        }
+    } //normalize
+
+    // Mirrors SentencePiece's unigram Model::EncodeOptimized, including its float/double score arithmetic
+    void viterbi(const std::string& normalized, std::vector<BestPathNode>& best_path, std::vector<int>& ids) const {
+        const size_t size = normalized.size();
+        const char* data = normalized.data();
+        const float unk_score = min_score - kUnkPenalty;
+        best_path.assign(size + 1, BestPathNode());
+
+        size_t starts_at = 0;
+        while (starts_at < size) {
+            const float score_till_here = best_path[starts_at].score;
+            const size_t char_length = std::min(leadCharLength(data + starts_at), size - starts_at);
+            bool has_single_node = false;
+            vocabulary.for_each_prefix(data + starts_at, size - starts_at, [&](size_t length, int32_t id) {
+                const Piece& piece = pieces[static_cast<size_t>(id)];
+                if (piece.type == UNUSED) {
+                    return;
+                }
+                BestPathNode& target = best_path[starts_at + length];
+                const double score = piece.type == USER_DEFINED ? (static_cast<float>(length) * max_score - 0.1)
+                                                                : static_cast<double>(piece.score);
+                const double candidate = score + score_till_here;
+                if (target.starts_at == -1 || candidate > target.score) {
+                    target.score = static_cast<float>(candidate);
+                    target.starts_at = static_cast<int32_t>(starts_at);
+                    target.id = id;
+                }
+                if (length == char_length) {
+                    has_single_node = true;
+                }
+            });
+            if (!has_single_node) {
+                BestPathNode& target = best_path[starts_at + char_length];
+                const float candidate = unk_score + score_till_here;
+                if (target.starts_at == -1 || candidate > target.score) {
+                    target.score = candidate;
+                    target.starts_at = static_cast<int32_t>(starts_at);
+                    target.id = unk_id;
+                }
+            }
+            starts_at += char_length;
+        }
+
+        // Backtrack, then put the pieces in text order (unknown spans become bytes with byte fallback)
+        for (size_t ends_at = size; ends_at > 0;) {
+            const BestPathNode& node = best_path[ends_at];
+            const size_t begin = static_cast<size_t>(node.starts_at);
+            if (node.id == unk_id && byte_fallback) {
+                for (size_t i = ends_at; i > begin; --i) {
+                    ids.push_back(byte_ids[static_cast<uint8_t>(data[i - 1])]);
+                }
+            } else {
+                ids.push_back(node.id);
+            }
+            ends_at = begin;
+        }
+        std::reverse(ids.begin(), ids.end());
+    } //viterbi
+};
+
+UnigramTokenizer::UnigramTokenizer() = default;
+
+UnigramTokenizer::~UnigramTokenizer() = default;
+
+UnigramTokenizer::UnigramTokenizer(UnigramTokenizer&&) noexcept = default;
+
+UnigramTokenizer& UnigramTokenizer::operator=(UnigramTokenizer&&) noexcept = default;
+
+bool UnigramTokenizer::load(std::string_view serialized_model, std::string* error) {
+    auto impl = std::make_unique<Impl>();
+    std::string reason;
+    if (!impl->parse(serialized_model, reason)) {
+        if (error) {
+            *error = reason;
+        }
+        return false;
+    }
+    pImpl = std::move(impl);
+    return true;
+}
+
+bool UnigramTokenizer::is_loaded() const {
+    return pImpl != nullptr;
+}
+
+size_t UnigramTokenizer::piece_count() const {
+    return pImpl ? pImpl->pieces.size() : 0;
+}
+
+void UnigramTokenizer::normalize(std::string_view text, std::string& normalized) const {
+    if (!pImpl) {
+        normalized.clear();
+        return;
+    }
+    pImpl->normalize(text, normalized);
+}
+
+void UnigramTokenizer::encode(std::string_view text, std::vector<int>& ids) const {
+    ids.clear();
+    if (!pImpl) {
+        return;
+    }
+    thread_local EncodeScratch scratch;
+    pImpl->normalize(text, scratch.normalized);
+    if (!scratch.normalized.empty()) {
+        pImpl->viterbi(scratch.normalized, scratch.best_path, ids);
+    }
+}
+
+} // namespace leafra
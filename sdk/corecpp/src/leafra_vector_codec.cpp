@@ -0,0 +1,136 @@
+#include "leafra/leafra_vector_codec.h"
+#include "leafra/leafra_simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace leafra {
+
+namespace {
+
+uint16_t swap16(uint16_t value) {
+    return static_cast<uint16_t>((value >> 8) | (value << 8));
+}
+
+uint32_t swap32(uint32_t value) {
+    return ((value >> 24) & 0xffu) | ((value >> 8) & 0xff00u) | ((value << 8) & 0xff0000u) | (value << 24);
+}
+
+// Blob bytes can be read as halves in place only when they're suitably aligned
+bool halfAligned(const void* data) {
+    return reinterpret_cast<uintptr_t>(data) % alignof(uint16_t) == 0;
+}
+
+} // namespace
+
+bool VectorCodec::parse_format(const std::string& name, EmbeddingStorageFormat& format) {
+    if (name == "none") { format = EmbeddingStorageFormat::NONE; return true; }
+    if (name == "fp32") { format = EmbeddingStorageFormat::FP32; return true; }
+    if (name == "fp16") { format = EmbeddingStorageFormat::FP16; return true; }
+    if (name == "int8") { format = EmbeddingStorageFormat::INT8; return true; }
+    return false;
+}
+
+ByteOrder VectorCodec::native_byte_order() {
+    const uint16_t probe = 1;
+    uint8_t first_byte = 0;
+    std::memcpy(&first_byte, &probe, 1);
+    return first_byte == 1 ? ByteOrder::LITTLE : ByteOrder::BIG;
+}
+
+size_t VectorCodec::encoded_size(EmbeddingStorageFormat format, size_t dimension) {
+    switch (format) {
+        case EmbeddingStorageFormat::FP32: return dimension * sizeof(float);
+        case EmbeddingStorageFormat::FP16: return dimension * sizeof(uint16_t);
+        case EmbeddingStorageFormat::INT8: return dimension;
+        default: return 0;
+    }
+}
+
+bool VectorCodec::encode(const float* values, size_t dimension, EmbeddingStorageFormat format, Encoded& out) {
+    if (!values || dimension == 0 || format == EmbeddingStorageFormat::NONE) {
+        return false;
+    }
+    out.format = format;
+    out.byte_order = native_byte_order();
+    out.scale = 0.0f;
+    out.data.resize(encoded_size(format, dimension));
+
+    switch (format) {
+        case EmbeddingStorageFormat::FP32:
+            std::memcpy(out.data.data(), values, out.data.size());
+            return true;
+        case EmbeddingStorageFormat::FP16: {
+            uint8_t* dst = out.data.data();
+            if (halfAligned(dst)) {
+                simd::float_to_half(values, reinterpret_cast<uint16_t*>(dst), dimension);
+                return true;
+            }
+            for (size_t i = 0; i < dimension; ++i) {
+                uint16_t half = float_to_half(values[i]);
+                std::memcpy(dst + i * sizeof(uint16_t), &half, sizeof(uint16_t));
+            }
+            return true;
+        }
+        case EmbeddingStorageFormat::INT8: {
+            out.scale = simd::max_abs(values, dimension) / 127.0f;
+            const float inverse = out.scale > 0.0f ? 1.0f / out.scale : 0.0f;
+            for (size_t i = 0; i < dimension; ++i) {
+                float q = std::round(values[i] * inverse);
+                int8_t quantized = static_cast<int8_t>(std::max(-127.0f, std::min(127.0f, q)));
+                out.data[i] = static_cast<uint8_t>(quantized);
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool VectorCodec::decode(EmbeddingStorageFormat format, ByteOrder byte_order, float scale,
+                         const uint8_t* data, size_t size, float* out, size_t dimension) {
+    if (!data || !out || dimension == 0 || size != encoded_size(format, dimension)) {
+        return false;
+    }
+    const bool swap = byte_order != native_byte_order();
+
+    switch (format) {
+        case EmbeddingStorageFormat::FP32:
+            std::memcpy(out, data, size);
+            if (swap) {
+                for (size_t i = 0; i < dimension; ++i) {
+                    uint32_t bits;
+                    std::memcpy(&bits, &out[i], sizeof(bits));
+                    bits = swap32(bits);
+                    std::memcpy(&out[i], &bits, sizeof(bits));
+                }
+            }
+            return true;
+        case EmbeddingStorageFormat::FP16:
+            if (!swap && halfAligned(data)) {
+                simd::half_to_float(reinterpret_cast<const uint16_t*>(data), out, dimension);
+                return true;
+            }
+            for (size_t i = 0; i < dimension; ++i) {
+                uint16_t half;
+                std::memcpy(&half, data + i * sizeof(uint16_t), sizeof(uint16_t));
+                out[i] = half_to_float(swap ? swap16(half) : half);
+            }
+            return true;
+        case EmbeddingStorageFormat::INT8:
+            simd::dequantize_i8(reinterpret_cast<const int8_t*>(data), scale, out, dimension);
+            return true;
+        default:
+            return false;
+    }
+}
+
+uint16_t VectorCodec::float_to_half(float value) {
+    return simd::float_to_half(value);
+}
+
+float VectorCodec::half_to_float(uint16_t value) {
+    return simd::half_to_float(value);
+}
+
+} // namespace leafra
@@ -0,0 +1,314 @@
+#include "leafra/leafra_xml.h"
+#include <cstring>
+
+namespace leafra {
+
+namespace {
+
+constexpr size_t kStop = std::string_view::npos;
+
+bool starts_with(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+// True while text is still a possible prefix of (or starts with) the given marker
+bool may_start_with(std::string_view text, std::string_view marker) {
+    size_t n = std::min(text.size(), marker.size());
+    return text.compare(0, n, marker.substr(0, n)) == 0;
+}
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+void append_utf8(uint32_t cp, std::string& out) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x110000) {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Position of the '>' closing a tag that starts at 0, skipping quoted attribute values
+size_t find_tag_end(std::string_view data) {
+    char quote = 0;
+    for (size_t i = 1; i < data.size(); ++i) {
+        char c = data[i];
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '>') {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+} // namespace
+
+bool XmlScanner::stop() {
+    stopped_ = true;
+    return false;
+}
+
+bool XmlScanner::fail(const char* message) {
+    error_ = message;
+    return stop();
+}
+
+std::string_view XmlScanner::attribute(const std::vector<Attribute>& attributes, std::string_view name) {
+    for (const Attribute& attribute : attributes) {
+        if (attribute.name == name) {
+            return attribute.value;
+        }
+    }
+    return {};
+}
+
+void XmlScanner::decode_entities(std::string_view text, std::string& out) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t amp = text.find('&', pos);
+        if (amp == std::string_view::npos) {
+            out.append(text.data() + pos, text.size() - pos);
+            return;
+        }
+        out.append(text.data() + pos, amp - pos);
+        size_t semi = text.find(';', amp);
+        if (semi == std::string_view::npos || semi - amp > 12) {
+            out += '&';
+            pos = amp + 1;
+            continue;
+        }
+
+        std::string_view name = text.substr(amp + 1, semi - amp - 1);
+        if (name == "amp") out += '&';
+        else if (name == "lt") out += '<';
+        else if (name == "gt") out += '>';
+        else if (name == "quot") out += '"';
+        else if (name == "apos") out += '\'';
+        else if (name.size() > 1 && name[0] == '#') {
+            bool hex = name[1] == 'x' || name[1] == 'X';
+            uint32_t cp = 0;
+            bool valid = name.size() > (hex ? 2u : 1u);
+            for (size_t i = hex ? 2 : 1; i < name.size() && valid; ++i) {
+                char c = name[i];
+                int digit = c >= '0' && c <= '9' ? c - '0' :
+                            hex && c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+                            hex && c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+                valid = digit >= 0 && cp < 0x110000;
+                cp = cp * (hex ? 16 : 10) + static_cast<uint32_t>(digit);
+            }
+            if (valid) {
+                append_utf8(cp, out);
+            } else {
+                out.append(text.data() + amp, semi - amp + 1);
+            }
+        } else {
+            // Unknown (DTD-defined) entity - keep it verbatim
+            out.append(text.data() + amp, semi - amp + 1);
+        }
+        pos = semi + 1;
+    }
+}
+
+bool XmlScanner::emit_text(std::string_view raw) {
+    if (raw.empty()) {
+        return true;
+    }
+    if (raw.find('&') == std::string_view::npos) {
+        return handler_.on_text(raw) || stop();
+    }
+    text_.clear();
+    decode_entities(raw, text_);
+    return handler_.on_text(text_) || stop();
+}
+
+bool XmlScanner::handle_tag(std::string_view tag) {
+    // tag is the markup between '<' and '>'
+    if (!tag.empty() && tag[0] == '/') {
+        size_t end = 1;
+        while (end < tag.size() && !is_space(tag[end])) end++;
+        return handler_.on_end_element(tag.substr(1, end - 1)) || stop();
+    }
+
+    bool self_closing = !tag.empty() && tag.back() == '/';
+    if (self_closing) {
+        tag.remove_suffix(1);
+    }
+    size_t pos = 0;
+    while (pos < tag.size() && !is_space(tag[pos])) pos++;
+    std::string_view name = tag.substr(0, pos);
+    if (name.empty()) {
+        return fail("empty element name");
+    }
+
+    attributes_.clear();
+    size_t decode_count = 0;
+    while (pos < tag.size()) {
+        while (pos < tag.size() && is_space(tag[pos])) pos++;
+        if (pos >= tag.size()) break;
+        size_t name_start = pos;
+        while (pos < tag.size() && tag[pos] != '=' && !is_space(tag[pos])) pos++;
+        std::string_view attr_name = tag.substr(name_start, pos - name_start);
+        while (pos < tag.size() && is_space(tag[pos])) pos++;
+        if (pos >= tag.size() || tag[pos] != '=') {
+            return fail("attribute without value");
+        }
+        pos++;
+        while (pos < tag.size() && is_space(tag[pos])) pos++;
+        if (pos >= tag.size() || (tag[pos] != '"' && tag[pos] != '\'')) {
+            return fail("unquoted attribute value");
+        }
+        char quote = tag[pos++];
+        size_t close = tag.find(quote, pos);
+        if (close == std::string_view::npos) {
+            return fail("unterminated attribute value");
+        }
+        std::string_view raw = tag.substr(pos, close - pos);
+        attributes_.push_back({attr_name, raw});
+        if (raw.find('&') != std::string_view::npos) {
+            decode_count++;
+        }
+        pos = close + 1;
+    }
+
+    // Decode referenced values into scratch sized up front, so the views stay valid
+    if (decode_count > 0) {
+        if (values_.size() < decode_count) {
+            values_.resize(decode_count);
+        }
+        size_t v = 0;
+        for (Attribute& attribute : attributes_) {
+            if (attribute.value.find('&') != std::string_view::npos) {
+                values_[v].clear();
+                decode_entities(attribute.value, values_[v]);
+                attribute.value = values_[v++];
+            }
+        }
+    }
+
+    if (!handler_.on_start_element(name, attributes_)) {
+        return stop();
+    }
+    if (self_closing && !handler_.on_end_element(name)) {
+        return stop();
+    }
+    return true;
+}
+
+size_t XmlScanner::scan(std::string_view data, bool at_end) {
+    size_t pos = 0;
+    while (pos < data.size()) {
+        if (data[pos] != '<') {
+            size_t lt = data.find('<', pos);
+            size_t end = lt == std::string_view::npos ? data.size() : lt;
+            if (lt == std::string_view::npos && !at_end) {
+                // Hold back an entity reference cut by the block boundary
+                size_t amp = data.rfind('&');
+                if (amp != std::string_view::npos && amp >= pos &&
+                    data.find(';', amp) == std::string_view::npos) {
+                    end = amp;
+                }
+            }
+            if (!emit_text(data.substr(pos, end - pos))) {
+                return kStop;
+            }
+            pos = end;
+            if (lt == std::string_view::npos) {
+                return pos;
+            }
+            continue;
+        }
+
+        std::string_view rest = data.substr(pos);
+        if (may_start_with(rest, "<!--") && rest.size() < 4) return pos;
+        if (starts_with(rest, "<!--")) {
+            size_t close = rest.find("-->", 4);
+            if (close == std::string_view::npos) return pos;
+            pos += close + 3;
+        } else if (may_start_with(rest, "<![CDATA[") && rest.size() < 9) {
+            return pos;
+        } else if (starts_with(rest, "<![CDATA[")) {
+            size_t close = rest.find("]]>", 9);
+            if (close == std::string_view::npos) return pos;
+            std::string_view cdata = rest.substr(9, close - 9);
+            if (!cdata.empty() && !handler_.on_text(cdata)) {
+                stop();
+                return kStop;
+            }
+            pos += close + 3;
+        } else if (starts_with(rest, "<?")) {
+            size_t close = rest.find("?>", 2);
+            if (close == std::string_view::npos) return pos;
+            pos += close + 2;
+        } else if (starts_with(rest, "<!")) {
+            // DOCTYPE: skip through the internal subset if there is one
+            size_t bracket = rest.find('[');
+            size_t gt = rest.find('>');
+            size_t close = bracket != std::string_view::npos && (gt == std::string_view::npos || bracket < gt)
+                ? rest.find("]>", bracket) : gt;
+            if (close == std::string_view::npos) return pos;
+            pos += close + (rest[close] == ']' ? 2 : 1);
+        } else {
+            size_t close = find_tag_end(rest);
+            if (close == std::string_view::npos) return pos;
+            if (!handle_tag(rest.substr(1, close - 1))) {
+                return kStop;
+            }
+            pos += close + 1;
+        }
+    }
+    return pos;
+}
+
+bool XmlScanner::feed(const char* data, size_t size) {
+    if (stopped_) {
+        return false;
+    }
+    size_t consumed;
+    if (pending_.empty()) {
+        consumed = scan(std::string_view(data, size), false);
+        if (consumed == kStop) {
+            return false;
+        }
+        pending_.assign(data + consumed, size - consumed);
+    } else {
+        pending_.append(data, size);
+        consumed = scan(pending_, false);
+        if (consumed == kStop) {
+            return false;
+        }
+        pending_.erase(0, consumed);
+    }
+    return true;
+}
+
+bool XmlScanner::finish() {
+    if (stopped_) {
+        return false;
+    }
+    size_t consumed = scan(pending_, true);
+    if (consumed == kStop) {
+        return false;
+    }
+    if (consumed < pending_.size()) {
+        pending_.clear();
+        return fail("document ends inside markup");
+    }
+    pending_.clear();
+    return true;
+}
+
+} // namespace leafra
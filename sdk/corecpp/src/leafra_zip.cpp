@@ -0,0 +1,643 @@
+#include "leafra/leafra_zip.h"
+#include <algorithm>
+#include <cstring>
+
+namespace leafra {
+
+namespace {
+
+constexpr uint32_t kLocalHeaderSignature = 0x04034b50;
+constexpr uint32_t kCentralHeaderSignature = 0x02014b50;
+constexpr uint32_t kEndOfCentralDirSignature = 0x06054b50;
+constexpr size_t kEndOfCentralDirSize = 22;
+constexpr size_t kMaxCommentSize = 0xFFFF;
+
+constexpr uint16_t kMethodStored = 0;
+constexpr uint16_t kMethodDeflated = 8;
+
+constexpr size_t kInputBlockSize = 64 * 1024;
+constexpr size_t kWindowSize = 32 * 1024;          // Largest DEFLATE back-reference distance
+constexpr size_t kFlushSize = 64 * 1024;           // Output handed to the sink per call (at most)
+constexpr size_t kMaxMatchLength = 258;
+
+uint16_t read_u16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t read_u32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// ==============================================================================
+// CRC-32 (IEEE 802.3, as used by ZIP)
+// ==============================================================================
+
+struct Crc32Table {
+    uint32_t values[256];
+    Crc32Table() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            values[i] = c;
+        }
+    }
+};
+
+uint32_t crc32_update(uint32_t crc, const unsigned char* data, size_t size) {
+    static const Crc32Table table;
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// ==============================================================================
+// Bit input over a bounded region of the archive, refilled in fixed-size blocks
+// ==============================================================================
+
+class BitInput {
+public:
+    BitInput(std::istream& in, uint64_t size) : in_(in), remaining_(size), buffer_(kInputBlockSize) {}
+
+    // Top up the bit buffer to at least count bits; false if the input runs out first
+    bool need(int count) {
+        while (bit_count_ < count) {
+            if (pos_ == len_ && !refill()) {
+                return false;
+            }
+            bit_buffer_ |= static_cast<uint64_t>(buffer_[pos_++]) << bit_count_;
+            bit_count_ += 8;
+        }
+        return true;
+    }
+
+    int available() const { return bit_count_; }
+    uint32_t peek(int count) const { return static_cast<uint32_t>(bit_buffer_ & ((1ull << count) - 1)); }
+
+    void drop(int count) {
+        bit_buffer_ >>= count;
+        bit_count_ -= count;
+    }
+
+    bool bits(int count, uint32_t& value) {
+        if (!need(count)) {
+            return false;
+        }
+        value = peek(count);
+        drop(count);
+        return true;
+    }
+
+    void align_to_byte() { drop(bit_count_ & 7); }
+
+private:
+    bool refill() {
+        if (remaining_ == 0) {
+            return false;
+        }
+        size_t want = static_cast<size_t>(std::min<uint64_t>(remaining_, buffer_.size()));
+        in_.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(want));
+        size_t got = static_cast<size_t>(in_.gcount());
+        if (got == 0) {
+            return false;
+        }
+        remaining_ -= got;
+        pos_ = 0;
+        len_ = got;
+        return true;
+    }
+
+    std::istream& in_;
+    uint64_t remaining_;
+    std::vector<unsigned char> buffer_;
+    size_t pos_ = 0;
+    size_t len_ = 0;
+    uint64_t bit_buffer_ = 0;
+    int bit_count_ = 0;
+};
+
+// ==============================================================================
+// Canonical Huffman decoding table: a direct lookup for codes up to kFastBits long,
+// and a count-based walk (as in zlib's puff) for the rare longer ones
+// ==============================================================================
+
+constexpr int kMaxCodeBits = 15;
+constexpr int kFastBits = 9;
+
+struct Huffman {
+    uint16_t fast[1 << kFastBits];         // (symbol << 4) | length, 0 if the code is longer
+    uint16_t count[kMaxCodeBits + 1];
+    uint16_t symbol[288];
+
+    // False if the lengths over-subscribe the code space
+    bool build(const uint8_t* lengths, int n) {
+        std::memset(fast, 0, sizeof(fast));
+        std::memset(count, 0, sizeof(count));
+        for (int s = 0; s < n; ++s) {
+            count[lengths[s]]++;
+        }
+        count[0] = 0;
+
+        int left = 1;
+        for (int len = 1; len <= kMaxCodeBits; ++len) {
+            left <<= 1;
+            left -= count[len];
+            if (left < 0) {
+                return false;
+            }
+        }
+
+        uint16_t offsets[kMaxCodeBits + 2];
+        offsets[1] = 0;
+        for (int len = 1; len <= kMaxCodeBits; ++len) {
+            offsets[len + 1] = static_cast<uint16_t>(offsets[len] + count[len]);
+        }
+        for (int s = 0; s < n; ++s) {
+            if (lengths[s] != 0) {
+                symbol[offsets[lengths[s]]++] = static_cast<uint16_t>(s);
+            }
+        }
+
+        // Canonical codes are assigned in symbol order within each length; the lookup
+        // is indexed by the code's bits as they arrive (LSB first), so reverse them
+        uint32_t code = 0;
+        int index = 0;
+        for (int len = 1; len <= kFastBits; ++len) {
+            for (int i = 0; i < count[len]; ++i, ++code, ++index) {
+                uint32_t reversed = 0;
+                for (int b = 0; b < len; ++b) {
+                    reversed |= ((code >> b) & 1u) << (len - 1 - b);
+                }
+                uint16_t entry = static_cast<uint16_t>((symbol[index] << 4) | len);
+                for (uint32_t fill = reversed; fill < (1u << kFastBits); fill += (1u << len)) {
+                    fast[fill] = entry;
+                }
+            }
+            code <<= 1;
+        }
+        return true;
+    }
+
+    // Next symbol, or -1 on exhausted input or an invalid code
+    int decode(BitInput& in) const {
+        in.need(kMaxCodeBits);  // Best effort - the stream may end on a short code
+        uint16_t entry = fast[in.peek(kFastBits)];
+        if (entry != 0 && (entry & 15) <= in.available()) {
+            in.drop(entry & 15);
+            return entry >> 4;
+        }
+
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (int len = 1; len <= kMaxCodeBits; ++len) {
+            uint32_t bit;
+            if (!in.bits(1, bit)) {
+                return -1;
+            }
+            code |= static_cast<int>(bit);
+            int n = count[len];
+            if (code - first < n) {
+                return symbol[index + (code - first)];
+            }
+            index += n;
+            first += n;
+            first <<= 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+};
+
+const uint16_t kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t kDistanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                    8193, 12289, 16385, 24577};
+const uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+struct FixedTables {
+    Huffman literals;
+    Huffman distances;
+    FixedTables() {
+        uint8_t lengths[288];
+        std::fill(lengths, lengths + 144, 8);
+        std::fill(lengths + 144, lengths + 256, 9);
+        std::fill(lengths + 256, lengths + 280, 7);
+        std::fill(lengths + 280, lengths + 288, 8);
+        literals.build(lengths, 288);
+        std::fill(lengths, lengths + 30, 5);
+        distances.build(lengths, 30);
+    }
+};
+
+// ==============================================================================
+// RFC 1951 inflater. Output accumulates after a 32 KiB history window and goes to the
+// sink every kFlushSize bytes, so memory is fixed regardless of the entry size.
+// ==============================================================================
+
+class Inflater {
+public:
+    Inflater(BitInput& in, const ZipReader::DataSink& sink)
+        : in_(in), sink_(sink), out_(kWindowSize + kFlushSize + kMaxMatchLength) {}
+
+    bool run() {
+        uint32_t last = 0;
+        do {
+            uint32_t type;
+            if (!in_.bits(1, last) || !in_.bits(2, type)) {
+                return fail("truncated deflate stream");
+            }
+            bool ok = type == 0 ? stored_block() :
+                      type == 1 ? huffman_block(fixed().literals, fixed().distances) :
+                      type == 2 ? dynamic_block() : fail("invalid deflate block type");
+            if (!ok) {
+                return false;
+            }
+        } while (!last && !stopped_);
+        return flush();
+    }
+
+    bool stopped() const { return stopped_; }
+    uint32_t crc() const { return crc_; }
+    uint64_t produced() const { return produced_; }
+    const std::string& error() const { return error_; }
+
+private:
+    static const FixedTables& fixed() {
+        static const FixedTables tables;
+        return tables;
+    }
+
+    bool fail(const char* message) {
+        error_ = message;
+        return false;
+    }
+
+    bool flush() {
+        if (pos_ > flushed_ && !stopped_) {
+            crc_ = crc32_update(crc_, out_.data() + flushed_, pos_ - flushed_);
+            if (!sink_(reinterpret_cast<const char*>(out_.data() + flushed_), pos_ - flushed_)) {
+                stopped_ = true;
+            }
+        }
+        flushed_ = pos_;
+        return true;
+    }
+
+    // Hand over kFlushSize of pending output; once the buffer is full, slide the last
+    // 32 KiB of history to the front
+    bool make_room() {
+        if (pos_ >= kWindowSize + kFlushSize) {
+            flush();
+            std::memmove(out_.data(), out_.data() + pos_ - kWindowSize, kWindowSize);
+            pos_ = kWindowSize;
+            flushed_ = kWindowSize;
+        } else if (pos_ - flushed_ >= kFlushSize) {
+            flush();
+        }
+        return !stopped_;
+    }
+
+    bool stored_block() {
+        in_.align_to_byte();
+        uint32_t length;
+        uint32_t complement;
+        if (!in_.bits(16, length) || !in_.bits(16, complement)) {
+            return fail("truncated stored block");
+        }
+        if ((length ^ 0xFFFF) != complement) {
+            return fail("corrupt stored block length");
+        }
+        while (length > 0) {
+            uint32_t byte;
+            if (!in_.bits(8, byte)) {
+                return fail("truncated stored block");
+            }
+            out_[pos_++] = static_cast<unsigned char>(byte);
+            produced_++;
+            length--;
+            if (!make_room()) {
+                return true;
+            }
+        }
+        return true;
+    }
+
+    bool huffman_block(const Huffman& literals, const Huffman& distances) {
+        for (;;) {
+            int symbol = literals.decode(in_);
+            if (symbol < 0) {
+                return fail("invalid literal/length code");
+            }
+            if (symbol < 256) {
+                out_[pos_++] = static_cast<unsigned char>(symbol);
+                produced_++;
+            } else if (symbol == 256) {
+                return true;
+            } else {
+                symbol -= 257;
+                if (symbol >= 29) {
+                    return fail("invalid length symbol");
+                }
+                uint32_t extra;
+                if (!in_.bits(kLengthExtra[symbol], extra)) {
+                    return fail("truncated length");
+                }
+                size_t length = kLengthBase[symbol] + extra;
+
+                int dist_symbol = distances.decode(in_);
+                if (dist_symbol < 0 || dist_symbol >= 30) {
+                    return fail("invalid distance code");
+                }
+                if (!in_.bits(kDistanceExtra[dist_symbol], extra)) {
+                    return fail("truncated distance");
+                }
+                size_t distance = kDistanceBase[dist_symbol] + extra;
+                if (distance > produced_ || distance > pos_) {
+                    return fail("distance beyond start of output");
+                }
+
+                // Byte-wise copy: the source may overlap the bytes being written
+                const unsigned char* from = out_.data() + pos_ - distance;
+                unsigned char* to = out_.data() + pos_;
+                for (size_t i = 0; i < length; ++i) {
+                    to[i] = from[i];
+                }
+                pos_ += length;
+                produced_ += length;
+            }
+            if (!make_room()) {
+                return true;
+            }
+        }
+    }
+
+    bool dynamic_block() {
+        static const uint8_t kOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+        uint32_t nlen;
+        uint32_t ndist;
+        uint32_t ncode;
+        if (!in_.bits(5, nlen) || !in_.bits(5, ndist) || !in_.bits(4, ncode)) {
+            return fail("truncated dynamic block header");
+        }
+        nlen += 257;
+        ndist += 1;
+        ncode += 4;
+        if (nlen > 286 || ndist > 30) {
+            return fail("bad dynamic block counts");
+        }
+
+        uint8_t lengths[320] = {0};
+        for (uint32_t i = 0; i < ncode; ++i) {
+            uint32_t value;
+            if (!in_.bits(3, value)) {
+                return fail("truncated code lengths");
+            }
+            lengths[kOrder[i]] = static_cast<uint8_t>(value);
+        }
+        Huffman lencode;
+        if (!lencode.build(lengths, 19)) {
+            return fail("bad code length code");
+        }
+
+        uint32_t index = 0;
+        while (index < nlen + ndist) {
+            int symbol = lencode.decode(in_);
+            if (symbol < 0) {
+                return fail("invalid code length symbol");
+            }
+            if (symbol < 16) {
+                lengths[index++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+            uint8_t value = 0;
+            uint32_t repeat;
+            bool ok;
+            if (symbol == 16) {
+                if (index == 0) {
+                    return fail("repeat with no previous length");
+                }
+                value = lengths[index - 1];
+                ok = in_.bits(2, repeat);
+                repeat += 3;
+            } else if (symbol == 17) {
+                ok = in_.bits(3, repeat);
+                repeat += 3;
+            } else {
+                ok = in_.bits(7, repeat);
+                repeat += 11;
+            }
+            if (!ok || index + repeat > nlen + ndist) {
+                return fail("bad code length repeat");
+            }
+            std::fill(lengths + index, lengths + index + repeat, value);
+            index += repeat;
+        }
+        if (lengths[256] == 0) {
+            return fail("missing end-of-block code");
+        }
+
+        Huffman literals;
+        Huffman distances;
+        if (!literals.build(lengths, static_cast<int>(nlen)) ||
+            !distances.build(lengths + nlen, static_cast<int>(ndist))) {
+            return fail("bad literal/length or distance lengths");
+        }
+        return huffman_block(literals, distances);
+    }
+
+    BitInput& in_;
+    const ZipReader::DataSink& sink_;
+    std::vector<unsigned char> out_;
+    size_t pos_ = 0;
+    size_t flushed_ = 0;
+    uint64_t produced_ = 0;
+    uint32_t crc_ = 0;
+    bool stopped_ = false;
+    std::string error_;
+};
+
+} // namespace
+
+bool ZipReader::fail(const std::string& message) {
+    error_ = message;
+    return false;
+}
+
+bool ZipReader::open(const std::string& path) {
+    entries_.clear();
+    error_.clear();
+    file_.close();
+    file_.clear();
+    file_.open(path, std::ios::binary);
+    if (!file_) {
+        return fail("cannot open file: " + path);
+    }
+
+    file_.seekg(0, std::ios::end);
+    uint64_t file_size = static_cast<uint64_t>(file_.tellg());
+    if (file_size < kEndOfCentralDirSize) {
+        return fail("not a ZIP archive");
+    }
+
+    // The end-of-central-directory record sits in the last 22 bytes plus an optional comment
+    size_t tail_size = static_cast<size_t>(std::min<uint64_t>(file_size, kEndOfCentralDirSize + kMaxCommentSize));
+    std::vector<unsigned char> tail(tail_size);
+    file_.seekg(static_cast<std::streamoff>(file_size - tail_size));
+    file_.read(reinterpret_cast<char*>(tail.data()), static_cast<std::streamsize>(tail_size));
+    if (static_cast<size_t>(file_.gcount()) != tail_size) {
+        return fail("failed to read end of archive");
+    }
+
+    const unsigned char* eocd = nullptr;
+    for (size_t i = tail_size - kEndOfCentralDirSize + 1; i-- > 0;) {
+        if (read_u32(tail.data() + i) == kEndOfCentralDirSignature) {
+            eocd = tail.data() + i;
+            break;
+        }
+    }
+    if (!eocd) {
+        return fail("not a ZIP archive (no end of central directory)");
+    }
+
+    uint16_t entry_count = read_u16(eocd + 10);
+    uint32_t directory_size = read_u32(eocd + 12);
+    uint32_t directory_offset = read_u32(eocd + 16);
+    if (entry_count == 0xFFFF || directory_offset == 0xFFFFFFFFu) {
+        return fail("ZIP64 archives are not supported");
+    }
+    if (static_cast<uint64_t>(directory_offset) + directory_size > file_size) {
+        return fail("central directory lies outside the file");
+    }
+
+    std::vector<unsigned char> directory(directory_size);
+    file_.clear();
+    file_.seekg(directory_offset);
+    file_.read(reinterpret_cast<char*>(directory.data()), static_cast<std::streamsize>(directory_size));
+    if (static_cast<uint32_t>(file_.gcount()) != directory_size) {
+        return fail("failed to read central directory");
+    }
+
+    entries_.reserve(entry_count);
+    size_t pos = 0;
+    for (uint16_t i = 0; i < entry_count; ++i) {
+        if (pos + 46 > directory.size() || read_u32(directory.data() + pos) != kCentralHeaderSignature) {
+            entries_.clear();
+            return fail("corrupt central directory");
+        }
+        const unsigned char* header = directory.data() + pos;
+        uint16_t name_length = read_u16(header + 28);
+        uint16_t extra_length = read_u16(header + 30);
+        uint16_t comment_length = read_u16(header + 32);
+        if (pos + 46 + name_length > directory.size()) {
+            entries_.clear();
+            return fail("corrupt central directory");
+        }
+
+        Entry entry;
+        entry.flags = read_u16(header + 8);
+        entry.method = read_u16(header + 10);
+        entry.crc32 = read_u32(header + 16);
+        entry.compressed_size = read_u32(header + 20);
+        entry.uncompressed_size = read_u32(header + 24);
+        entry.local_header_offset = read_u32(header + 42);
+        entry.name.assign(reinterpret_cast<const char*>(header + 46), name_length);
+        entries_.push_back(std::move(entry));
+
+        pos += 46 + name_length + extra_length + comment_length;
+    }
+    return true;
+}
+
+const ZipReader::Entry* ZipReader::find(const std::string& name) const {
+    for (const Entry& entry : entries_) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool ZipReader::read(const std::string& name, const DataSink& sink) {
+    const Entry* entry = find(name);
+    if (!entry) {
+        return fail("entry not found: " + name);
+    }
+    return read(*entry, sink);
+}
+
+bool ZipReader::read(const Entry& entry, const DataSink& sink) {
+    error_.clear();
+    if (!file_.is_open()) {
+        return fail("archive is not open");
+    }
+    if (entry.flags & 1) {
+        return fail("encrypted entries are not supported: " + entry.name);
+    }
+    if (entry.method != kMethodStored && entry.method != kMethodDeflated) {
+        return fail("unsupported compression method " + std::to_string(entry.method) + ": " + entry.name);
+    }
+    if (entry.compressed_size == 0xFFFFFFFFu || entry.uncompressed_size == 0xFFFFFFFFu) {
+        return fail("ZIP64 entries are not supported: " + entry.name);
+    }
+
+    // The local header's name and extra field lengths can differ from the central directory's
+    unsigned char header[30];
+    file_.clear();
+    file_.seekg(entry.local_header_offset);
+    file_.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (file_.gcount() != static_cast<std::streamsize>(sizeof(header)) || read_u32(header) != kLocalHeaderSignature) {
+        return fail("corrupt local header: " + entry.name);
+    }
+    file_.seekg(static_cast<std::streamoff>(read_u16(header + 26)) + read_u16(header + 28), std::ios::cur);
+
+    uint32_t crc = 0;
+    uint64_t produced = 0;
+    if (entry.method == kMethodStored) {
+        std::vector<char> buffer(kInputBlockSize);
+        uint64_t remaining = entry.compressed_size;
+        while (remaining > 0) {
+            size_t want = static_cast<size_t>(std::min<uint64_t>(remaining, buffer.size()));
+            file_.read(buffer.data(), static_cast<std::streamsize>(want));
+            size_t got = static_cast<size_t>(file_.gcount());
+            if (got == 0) {
+                return fail("truncated entry: " + entry.name);
+            }
+            crc = crc32_update(crc, reinterpret_cast<const unsigned char*>(buffer.data()), got);
+            remaining -= got;
+            produced += got;
+            if (!sink(buffer.data(), got)) {
+                return true;
+            }
+        }
+    } else {
+        BitInput input(file_, entry.compressed_size);
+        Inflater inflater(input, sink);
+        if (!inflater.run()) {
+            return fail(inflater.error() + ": " + entry.name);
+        }
+        if (inflater.stopped()) {
+            return true;
+        }
+        crc = inflater.crc();
+        produced = inflater.produced();
+    }
+
+    if (produced != entry.uncompressed_size) {
+        return fail("size mismatch: " + entry.name);
+    }
+    if (crc != entry.crc32) {
+        return fail("CRC-32 mismatch: " + entry.name);
+    }
+    return true;
+}
+
+} // namespace leafra
@@ -2,7 +2,12 @@
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <condition_variable>
+#include <cstdio>
 #include <cstring>
+#include <ctime>
+#include <memory>
+#include <thread>
 
 // Platform-specific includes
 #ifdef __APPLE__
@@ -17,35 +22,256 @@
 
 namespace leafra {
 
+// ==============================================================================
+// Async queue
+// ==============================================================================
+
+/**
+ * @brief Bounded multi-producer / single-consumer ring of formatted messages
+ *
+ * Each slot carries a sequence number: producers claim a position with one CAS and publish
+ * the slot by bumping its sequence, the drain thread consumes slots in position order.
+ * Messages are swapped in and out, so the string buffers cycle between the logging
+ * threads and the ring instead of being reallocated per message.
+ */
+class Logger::AsyncQueue {
+public:
+    explicit AsyncQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        slots_.reset(new Slot[size]);
+        for (size_t i = 0; i < size; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // Producer side: message is swapped into the slot (and gets the slot's old buffer back)
+    bool try_push(LogLevel level, std::string& message) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.level = level;
+                    slot.message.swap(message);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // Full: the drain thread hasn't consumed this slot's previous lap yet
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer side (drain thread only)
+    bool try_pop(LogLevel& level, std::string& message) {
+        Slot& slot = slots_[dequeue_pos_ & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+            return false;
+        }
+        level = slot.level;
+        message.swap(slot.message);
+        slot.message.clear();
+        slot.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+        dequeue_pos_++;
+        return true;
+    }
+
+    // Positions claimed so far; flush() waits for written to catch up with it
+    size_t claimed() const { return enqueue_pos_.load(std::memory_order_acquire); }
+
+    void wake() {
+        if (sleeping.load(std::memory_order_acquire)) {
+            wake_cv.notify_one();
+        }
+    }
+
+    LogOverflowPolicy policy = LogOverflowPolicy::DROP;
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<size_t> written{0};          // Messages the drain thread has finished with (written or skipped)
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> stop{false};
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;          // Drain thread waits here when the queue is empty
+    std::condition_variable flushed_cv;       // flush() waits here for written to advance
+    std::thread drain_thread;
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        LogLevel level = LogLevel::LEAFRA_INFO;
+        std::string message;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) size_t dequeue_pos_ = 0;
+};
+
+// ==============================================================================
+// Logger
+// ==============================================================================
+
 Logger& Logger::getInstance() {
     static Logger instance;
     return instance;
 }
 
+Logger::~Logger() {
+    AsyncQueue* queue = m_async.exchange(nullptr);
+    if (queue) {
+        m_asyncEnabled.store(false);
+        queue->stop.store(true, std::memory_order_release);
+        queue->wake_cv.notify_one();
+        if (queue->drain_thread.joinable()) {
+            queue->drain_thread.join();
+        }
+        delete queue;
+    }
+}
+
 void Logger::setLogLevel(LogLevel level) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_logLevel = level;
+    m_logLevel.store(static_cast<int32_t>(level), std::memory_order_relaxed);
 }
 
 LogLevel Logger::getLogLevel() const {
-    return m_logLevel;
+    return static_cast<LogLevel>(m_logLevel.load(std::memory_order_relaxed));
 }
 
 void Logger::setShowFileInfo(bool show) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_showFileInfo = show;
+    m_showFileInfo.store(show, std::memory_order_relaxed);
+}
+
+void Logger::setAsync(bool enabled, size_t capacity, LogOverflowPolicy policy) {
+    std::lock_guard<std::mutex> lock(m_asyncMutex);
+    AsyncQueue* queue = m_async.load(std::memory_order_acquire);
+    if (enabled) {
+        if (!queue) {
+            queue = new AsyncQueue(capacity);
+            queue->drain_thread = std::thread(&Logger::drainLoop, this);
+            m_async.store(queue, std::memory_order_release);
+        }
+        queue->policy = policy;
+        m_asyncEnabled.store(true, std::memory_order_release);
+    } else if (m_asyncEnabled.exchange(false, std::memory_order_acq_rel)) {
+        // The drain thread stays parked on its condition variable for a later re-enable
+        flush();
+    }
+}
+
+bool Logger::isAsync() const {
+    return m_asyncEnabled.load(std::memory_order_acquire);
+}
+
+void Logger::flush() {
+    AsyncQueue* queue = m_async.load(std::memory_order_acquire);
+    if (!queue) {
+        std::cout.flush();
+        return;
+    }
+    size_t target = queue->claimed();
+    std::unique_lock<std::mutex> lock(queue->wake_mutex);
+    while (queue->written.load(std::memory_order_acquire) < target) {
+        queue->wake_cv.notify_one();
+        queue->flushed_cv.wait_for(lock, std::chrono::milliseconds(10));
+    }
+}
+
+uint64_t Logger::getDroppedCount() const {
+    AsyncQueue* queue = m_async.load(std::memory_order_acquire);
+    return queue ? queue->dropped.load(std::memory_order_relaxed) : 0;
 }
 
 void Logger::log(LogLevel level, const std::string& message, const char* file, int line) {
-    if (level < m_logLevel) {
+    if (!isEnabled(level)) {
+        return;
+    }
+    
+    // Formatted on the calling thread into a buffer that is reused (and, in async mode,
+    // traded with the queue) across this thread's messages
+    thread_local std::string formattedMessage;
+    formatMessage(level, message, file, line, formattedMessage);
+    
+    AsyncQueue* queue = m_asyncEnabled.load(std::memory_order_acquire) ? m_async.load(std::memory_order_acquire) : nullptr;
+    if (queue) {
+        while (!queue->try_push(level, formattedMessage)) {
+            if (queue->policy == LogOverflowPolicy::DROP) {
+                queue->dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            queue->wake();
+            std::this_thread::yield();
+        }
+        queue->wake();
         return;
     }
     
     std::lock_guard<std::mutex> lock(m_mutex);
-    std::string formattedMessage = formatMessage(level, message, file, line);
     platformLog(level, formattedMessage);
 }
 
+void Logger::drainLoop() {
+    AsyncQueue* queue = nullptr;
+    while (!(queue = m_async.load(std::memory_order_acquire))) {
+        std::this_thread::yield();   // setAsync publishes the queue right after starting this thread
+    }
+    
+    std::string message;
+    std::string dropped_notice;
+    uint64_t reported_drops = 0;
+    for (;;) {
+        size_t batch = 0;
+        LogLevel level;
+        while (queue->try_pop(level, message)) {
+            {
+                // Inline logging may be writing too while async mode is being switched
+                std::lock_guard<std::mutex> lock(m_mutex);
+                platformLog(level, message, false);
+            }
+            queue->written.fetch_add(1, std::memory_order_release);
+            batch++;
+        }
+        
+        uint64_t drops = queue->dropped.load(std::memory_order_relaxed);
+        if (drops != reported_drops) {
+            formatMessage(LogLevel::LEAFRA_WARNING, std::to_string(drops - reported_drops) + " log messages dropped (async log queue full)",
+                          __FILE__, __LINE__, dropped_notice);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            platformLog(LogLevel::LEAFRA_WARNING, dropped_notice, false);
+            reported_drops = drops;
+            batch++;
+        }
+        
+        if (batch > 0) {
+            std::cout.flush();
+            std::lock_guard<std::mutex> lock(queue->wake_mutex);
+            queue->flushed_cv.notify_all();
+            continue;
+        }
+        
+        if (queue->stop.load(std::memory_order_acquire)) {
+            return;
+        }
+        
+        // Producers only notify when they see sleeping set; the timed wait bounds the latency
+        // of a wake-up that raced with it
+        std::unique_lock<std::mutex> lock(queue->wake_mutex);
+        queue->sleeping.store(true, std::memory_order_release);
+        queue->wake_cv.wait_for(lock, std::chrono::milliseconds(50));
+        queue->sleeping.store(false, std::memory_order_release);
+    }
+} //drainLoop
+
 void Logger::debug(const std::string& message, const char* file, int line) {
     log(LogLevel::LEAFRA_DEBUG, message, file, line);
 }
@@ -62,7 +288,7 @@ void Logger::error(const std::string& message, const char* file, int line) {
     log(LogLevel::LEAFRA_ERROR, message, file, line);
 }
 
-void Logger::platformLog(LogLevel level, const std::string& message) {
+void Logger::platformLog(LogLevel level, const std::string& message, bool flush_console) {
 #ifdef __APPLE__
     // iOS/macOS - Use os_log
     os_log_type_t osLogType;
@@ -74,11 +300,13 @@ void Logger::platformLog(LogLevel level, const std::string& message) {
         default:                       osLogType = OS_LOG_TYPE_DEFAULT; break;
     }
     
-    os_log_t log = os_log_create("com.leafra.sdk", "LeafraSDK");
+    // Created once: os_log_create per message is a measurable share of logging cost
+    static os_log_t log = os_log_create("com.leafra.sdk", "LeafraSDK");
     os_log_with_type(log, osLogType, "%{public}s", message.c_str());
     
     // Also output to console for command line applications
-    std::cout << message << std::endl;
+    std::cout << message << '\n';
+    if (flush_console) std::cout.flush();
     
 #elif defined(__ANDROID__)
     // Android - Use __android_log_print
@@ -92,6 +320,7 @@ void Logger::platformLog(LogLevel level, const std::string& message) {
     }
     
     __android_log_print(priority, "LeafraSDK", "%s", message.c_str());
+    (void)flush_console;
     
 #elif defined(_WIN32)
     // Windows - Use OutputDebugStringA
@@ -99,43 +328,53 @@ void Logger::platformLog(LogLevel level, const std::string& message) {
     OutputDebugStringA(windowsMessage.c_str());
     
     // Also output to console for console apps
-    std::cout << message << std::endl;
+    std::cout << message << '\n';
+    if (flush_console) std::cout.flush();
     
 #else
-    // Linux/Other - Use standard output
-    std::cout << message << std::endl;
+    // Linux/Other - Use standard output (the drain thread flushes once per batch)
+    std::cout << message << '\n';
+    if (flush_console) std::cout.flush();
 #endif
 }
 
-std::string Logger::formatMessage(LogLevel level, const std::string& message, 
-                                 const char* file, int line) {
-    std::ostringstream oss;
-    
+void Logger::formatMessage(LogLevel level, const std::string& message,
+                           const char* file, int line, std::string& out) const {
     // Timestamp
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()) % 1000;
+    std::tm local_time{};
+#ifdef _WIN32
+    localtime_s(&local_time, &time_t);
+#else
+    localtime_r(&time_t, &local_time);
+#endif
     
-    oss << std::put_time(std::localtime(&time_t), "%H:%M:%S");
-    oss << "." << std::setfill('0') << std::setw(3) << ms.count();
-    
-    // Log level
-    oss << " [" << levelToString(level) << "]";
+    // Timestamp and log level
+    char prefix[32];
+    int prefix_length = std::snprintf(prefix, sizeof(prefix), "%02d:%02d:%02d.%03d [%s]",
+                                      local_time.tm_hour, local_time.tm_min, local_time.tm_sec,
+                                      static_cast<int>(ms.count()), levelToString(level));
+    out.assign(prefix, prefix_length > 0 ? static_cast<size_t>(prefix_length) : 0);
     
     // File and line (if enabled and available)
-    if (m_showFileInfo && file && line > 0) {
+    if (m_showFileInfo.load(std::memory_order_relaxed) && file && line > 0) {
         const char* filename = std::strrchr(file, '/');
         if (!filename) filename = std::strrchr(file, '\\');
         if (filename) filename++; else filename = file;
         
-        oss << " [" << filename << ":" << line << "]";
+        out += " [";
+        out += filename;
+        out += ':';
+        out += std::to_string(line);
+        out += ']';
     }
     
     // Message
-    oss << " " << message;
-    
-    return oss.str();
+    out += ' ';
+    out += message;
 }
 
 const char* Logger::levelToString(LogLevel level) {
@@ -1,16 +1,29 @@
 #include "leafra/platform_utils.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
 #include <io.h>
 #elif defined(__APPLE__)
+#include <Foundation/Foundation.h>
 #include <mach-o/dyld.h>
+#include <pthread.h>
+#include <pthread/qos.h>
+#include <sys/sysctl.h>
 #include <unistd.h>
 #include <climits>
 #include <cstdlib>
 #else
+#ifdef __ANDROID__
+#include <dlfcn.h>
+#endif
+#include <sys/resource.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 #include <climits>
 #include <cstdlib>
@@ -79,6 +92,205 @@ std::string PlatformUtils::get_platform_info() {
     return get_platform_name() + " (" + get_architecture() + ")";
 }
 
+int32_t PlatformUtils::get_cpu_cores() {
+    unsigned int cores = std::thread::hardware_concurrency();
+    return cores > 0 ? static_cast<int32_t>(cores) : 1;
+}
+
+namespace {
+
+#if !defined(__APPLE__) && !defined(_WIN32)
+/**
+ * @brief Read a single integer from a sysfs file, or -1
+ */
+long long read_sysfs_value(const std::string& path) {
+    std::ifstream file(path);
+    long long value = -1;
+    if (!(file >> value)) {
+        return -1;
+    }
+    return value;
+}
+#endif
+
+CpuTopology detect_cpu_topology() {
+    CpuTopology topology;
+    topology.logical_cores = PlatformUtils::get_cpu_cores();
+    topology.performance_cores = topology.logical_cores;
+    topology.efficiency_cores = 0;
+    
+#if defined(__APPLE__)
+    // perflevel0 is the fastest cluster; a second level exists only on P/E chips
+    int levels = 0;
+    size_t size = sizeof(levels);
+    if (sysctlbyname("hw.nperflevels", &levels, &size, nullptr, 0) == 0 && levels > 1) {
+        int performance = 0;
+        int efficiency = 0;
+        size = sizeof(performance);
+        bool have_performance = sysctlbyname("hw.perflevel0.logicalcpu", &performance, &size, nullptr, 0) == 0;
+        size = sizeof(efficiency);
+        bool have_efficiency = sysctlbyname("hw.perflevel1.logicalcpu", &efficiency, &size, nullptr, 0) == 0;
+        if (have_performance && have_efficiency && performance > 0 && efficiency > 0) {
+            topology.performance_cores = performance;
+            topology.efficiency_cores = efficiency;
+        }
+    }
+#elif !defined(_WIN32)
+    // Linux / Android: cores of the lowest-capacity cluster are the efficiency cores. cpu_capacity
+    // is the scheduler's relative core strength on ARM; the maximum frequency is the fallback.
+    std::map<long long, int32_t> cluster_sizes;
+    for (int32_t cpu = 0; cpu < topology.logical_cores; ++cpu) {
+        std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+        long long capacity = read_sysfs_value(base + "/cpu_capacity");
+        if (capacity <= 0) {
+            capacity = read_sysfs_value(base + "/cpufreq/cpuinfo_max_freq");
+        }
+        if (capacity <= 0) {
+            return topology;  // Unknown for at least one core - treat the CPU as homogeneous
+        }
+        cluster_sizes[capacity]++;
+    }
+    if (cluster_sizes.size() > 1) {
+        topology.efficiency_cores = cluster_sizes.begin()->second;
+        topology.performance_cores = topology.logical_cores - topology.efficiency_cores;
+    }
+#endif
+    return topology;
+} //detect_cpu_topology
+
+} // namespace
+
+CpuTopology PlatformUtils::get_cpu_topology() {
+    static const CpuTopology topology = detect_cpu_topology();
+    return topology;
+}
+
+bool PlatformUtils::set_current_thread_qos(ThreadQoS qos) {
+#if defined(__APPLE__)
+    qos_class_t qos_class = QOS_CLASS_UTILITY;
+    switch (qos) {
+        case ThreadQoS::USER_INITIATED: qos_class = QOS_CLASS_USER_INITIATED; break;
+        case ThreadQoS::UTILITY:        qos_class = QOS_CLASS_UTILITY; break;
+        case ThreadQoS::BACKGROUND:     qos_class = QOS_CLASS_BACKGROUND; break;
+    }
+    return pthread_set_qos_class_self_np(qos_class, 0) == 0;
+#elif defined(_WIN32)
+    int priority = THREAD_PRIORITY_NORMAL;
+    switch (qos) {
+        case ThreadQoS::USER_INITIATED: priority = THREAD_PRIORITY_NORMAL; break;
+        case ThreadQoS::UTILITY:        priority = THREAD_PRIORITY_BELOW_NORMAL; break;
+        case ThreadQoS::BACKGROUND:     priority = THREAD_PRIORITY_LOWEST; break;
+    }
+    return SetThreadPriority(GetCurrentThread(), priority) != 0;
+#else
+    // Nice values are per thread on Linux; 10 is Android's THREAD_PRIORITY_BACKGROUND
+    int nice_value = 0;
+    switch (qos) {
+        case ThreadQoS::USER_INITIATED: nice_value = 0; break;
+        case ThreadQoS::UTILITY:        nice_value = 10; break;
+        case ThreadQoS::BACKGROUND:     nice_value = 19; break;
+    }
+    pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+    return setpriority(PRIO_PROCESS, static_cast<id_t>(tid), nice_value) == 0;
+#endif
+} //set_current_thread_qos
+
+namespace {
+
+#if !defined(__APPLE__) && !defined(_WIN32)
+/**
+ * @brief First line of a sysfs file, or an empty string
+ */
+std::string read_sysfs_line(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+/**
+ * @brief Fill battery_percent / charging from the first battery power supply that reports a capacity
+ */
+void read_sysfs_battery(PowerState& state) {
+    for (const char* supply : {"battery", "BAT0", "BAT1"}) {
+        std::string base = std::string("/sys/class/power_supply/") + supply;
+        long long capacity = read_sysfs_value(base + "/capacity");
+        if (capacity < 0) {
+            continue;
+        }
+        state.battery_percent = static_cast<int32_t>(std::min<long long>(capacity, 100));
+        std::string status = read_sysfs_line(base + "/status");
+        state.charging = status == "Charging" || status == "Full";
+        return;
+    }
+}
+#endif
+
+#ifdef __ANDROID__
+/**
+ * @brief AThermal_getCurrentStatus (API 30), looked up at runtime so older devices still load the SDK
+ * @return ATHERMAL_STATUS_* value, or -1 if unavailable
+ */
+int android_thermal_status() {
+    using acquire_fn = void* (*)();
+    using status_fn = int (*)(void*);
+    static void* manager = nullptr;
+    static status_fn get_status = nullptr;
+    static std::once_flag resolved;
+    std::call_once(resolved, [] {
+        void* library = dlopen("libandroid.so", RTLD_NOW);
+        if (!library) {
+            return;
+        }
+        auto acquire = reinterpret_cast<acquire_fn>(dlsym(library, "AThermal_acquireManager"));
+        get_status = reinterpret_cast<status_fn>(dlsym(library, "AThermal_getCurrentStatus"));
+        manager = acquire ? acquire() : nullptr;
+    });
+    return manager && get_status ? get_status(manager) : -1;
+}
+#endif
+
+} // namespace
+
+PowerState PlatformUtils::get_power_state() {
+    PowerState state;
+#if defined(__APPLE__)
+    @autoreleasepool {
+        NSProcessInfo* process_info = [NSProcessInfo processInfo];
+        switch (process_info.thermalState) {
+            case NSProcessInfoThermalStateNominal:  state.thermal = ThermalState::NOMINAL; break;
+            case NSProcessInfoThermalStateFair:     state.thermal = ThermalState::FAIR; break;
+            case NSProcessInfoThermalStateSerious:  state.thermal = ThermalState::SERIOUS; break;
+            case NSProcessInfoThermalStateCritical: state.thermal = ThermalState::CRITICAL; break;
+        }
+        if (@available(macOS 12.0, iOS 9.0, *)) {
+            state.low_power_mode = process_info.isLowPowerModeEnabled;
+        }
+    }
+#elif defined(_WIN32)
+    SYSTEM_POWER_STATUS status;
+    if (GetSystemPowerStatus(&status)) {
+        state.battery_percent = status.BatteryLifePercent <= 100 ? static_cast<int32_t>(status.BatteryLifePercent) : -1;
+        state.charging = status.ACLineStatus == 1;
+        state.low_power_mode = status.SystemStatusFlag == 1;   // Battery saver
+    }
+#else
+#ifdef __ANDROID__
+    // NONE / LIGHT / MODERATE / SEVERE / CRITICAL / EMERGENCY / SHUTDOWN; MODERATE already hurts UX
+    int status = android_thermal_status();
+    if (status >= 4) {
+        state.thermal = ThermalState::CRITICAL;
+    } else if (status >= 2) {
+        state.thermal = ThermalState::SERIOUS;
+    } else if (status == 1) {
+        state.thermal = ThermalState::FAIR;
+    }
+#endif
+    read_sysfs_battery(state);
+#endif
+    return state;
+} //get_power_state
+
 // Path utilities implementation
 
 char PlatformUtils::get_path_separator() {
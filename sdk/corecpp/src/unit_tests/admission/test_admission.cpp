@@ -0,0 +1,202 @@
+#include "../../../include/leafra/leafra_admission.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+static AdmissionMetrics metrics_of(const AdmissionController& controller, AdmissionResource resource) {
+    return controller.snapshot()[static_cast<size_t>(resource)];
+}
+
+// Wait (bounded) until the given number of callers queue for a resource
+static bool wait_queued(const AdmissionController& controller, AdmissionResource resource, size_t interactive, size_t bulk) {
+    for (int i = 0; i < 2000; ++i) {
+        AdmissionMetrics metrics = metrics_of(controller, resource);
+        if (metrics.queued_interactive == interactive && metrics.queued_bulk == bulk) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+bool test_slots_bound_concurrency() {
+    AdmissionController controller;
+    AdmissionController::Options options;
+    options.slots[static_cast<size_t>(AdmissionResource::EMBEDDER)] = 2;
+    controller.configure(options);
+
+    std::atomic<int> active{0};
+    std::atomic<int> most_active{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 6; ++t) {
+        threads.emplace_back([&, t]() {
+            AdmissionController::Permit permit(controller, AdmissionResource::EMBEDDER,
+                                               t % 2 ? AdmissionLane::BULK : AdmissionLane::INTERACTIVE);
+            int now = ++active;
+            int seen = most_active.load();
+            while (now > seen && !most_active.compare_exchange_weak(seen, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            --active;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    TEST_ASSERT(most_active.load() <= 2, "At most two callers should hold the embedder");
+    AdmissionMetrics metrics = metrics_of(controller, AdmissionResource::EMBEDDER);
+    TEST_ASSERT_EQUAL(std::string("embedder"), metrics.name, "Metrics should name the resource");
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(6), metrics.admitted, "Every caller should be admitted");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(0), metrics.in_flight, "All permits should be released");
+    TEST_ASSERT(metrics.peak_queued > 0, "Callers beyond the slots should have queued");
+    return true;
+}
+
+bool test_interactive_before_bulk() {
+    AdmissionController controller;
+    AdmissionController::Options options;
+    options.slots[static_cast<size_t>(AdmissionResource::LLM)] = 1;
+    controller.configure(options);
+
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    auto holder = std::make_unique<AdmissionController::Permit>(controller, AdmissionResource::LLM, AdmissionLane::BULK);
+
+    std::thread bulk([&]() {
+        AdmissionController::Permit permit(controller, AdmissionResource::LLM, AdmissionLane::BULK);
+        std::lock_guard<std::mutex> lock(order_mutex);
+        order.push_back("bulk");
+    });
+    TEST_ASSERT(wait_queued(controller, AdmissionResource::LLM, 0, 1), "Bulk caller should queue");
+    std::thread interactive([&]() {
+        AdmissionController::Permit permit(controller, AdmissionResource::LLM, AdmissionLane::INTERACTIVE);
+        std::lock_guard<std::mutex> lock(order_mutex);
+        order.push_back("interactive");
+    });
+    TEST_ASSERT(wait_queued(controller, AdmissionResource::LLM, 1, 1), "Interactive caller should queue");
+
+    holder.reset();
+    bulk.join();
+    interactive.join();
+
+    TEST_ASSERT_EQUAL(static_cast<size_t>(2), order.size(), "Both callers should run");
+    TEST_ASSERT_EQUAL(std::string("interactive"), order[0], "Interactive caller should overtake the earlier bulk one");
+    TEST_ASSERT(metrics_of(controller, AdmissionResource::LLM).max_wait_ms > 0.0, "Waits should be recorded");
+    return true;
+}
+
+bool test_full_lane_rejects() {
+    AdmissionController controller;
+    AdmissionController::Options options;
+    options.slots[static_cast<size_t>(AdmissionResource::INDEX)] = 1;
+    options.max_queued = 1;
+    controller.configure(options);
+
+    auto holder = std::make_unique<AdmissionController::Permit>(controller, AdmissionResource::INDEX, AdmissionLane::INTERACTIVE);
+    std::atomic<bool> waiter_admitted{false};
+    std::thread waiter([&]() {
+        AdmissionController::Permit permit(controller, AdmissionResource::INDEX, AdmissionLane::INTERACTIVE);
+        waiter_admitted = permit.admitted();
+    });
+    TEST_ASSERT(wait_queued(controller, AdmissionResource::INDEX, 1, 0), "First waiter should queue");
+
+    {
+        AdmissionController::Permit overflow(controller, AdmissionResource::INDEX, AdmissionLane::INTERACTIVE);
+        TEST_ASSERT(!overflow.admitted(), "A caller beyond max_queued should be rejected at once");
+    }
+    holder.reset();
+    waiter.join();
+
+    TEST_ASSERT(waiter_admitted.load(), "The queued caller should be admitted once the slot frees");
+    AdmissionMetrics metrics = metrics_of(controller, AdmissionResource::INDEX);
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(1), metrics.rejected, "Rejections should be counted");
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(2), metrics.admitted, "Holder and waiter should be counted");
+
+    controller.reset();
+    metrics = metrics_of(controller, AdmissionResource::INDEX);
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(0), metrics.admitted, "reset should clear the counters");
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(0), metrics.rejected, "reset should clear the rejections");
+    return true;
+}
+
+bool test_disabled_admits_all() {
+    AdmissionController controller;
+    AdmissionController::Options options;
+    options.enabled = false;
+    options.slots[static_cast<size_t>(AdmissionResource::LLM)] = 1;
+    controller.configure(options);
+
+    AdmissionController::Permit first(controller, AdmissionResource::LLM, AdmissionLane::INTERACTIVE);
+    AdmissionController::Permit second(controller, AdmissionResource::LLM, AdmissionLane::BULK);
+    TEST_ASSERT(first.admitted() && second.admitted(), "Disabled controller should admit every caller");
+    AdmissionMetrics metrics = metrics_of(controller, AdmissionResource::LLM);
+    TEST_ASSERT_EQUAL(static_cast<size_t>(2), metrics.in_flight, "Disabled controller should still count users");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(0), metrics.slots, "Disabled controller reports no bound");
+    return true;
+}
+
+int main() {
+    std::cout << "=== Admission Controller Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_slots_bound_concurrency);
+    RUN_TEST(test_interactive_before_bulk);
+    RUN_TEST(test_full_lane_rejects);
+    RUN_TEST(test_disabled_admits_all);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,126 @@
+#include "../../../include/leafra/leafra_arena.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+bool test_allocations_are_aligned() {
+    MonotonicArena arena(256);
+    for (size_t alignment : {1, 2, 4, 8, 16, 64}) {
+        void* memory = arena.allocate(3, alignment);
+        TEST_ASSERT(reinterpret_cast<uintptr_t>(memory) % alignment == 0, "Allocation should honour its alignment");
+    }
+    TEST_ASSERT_EQUAL(static_cast<size_t>(18), arena.bytes_used(), "Every requested byte should be counted");
+    return true;
+}
+
+bool test_small_allocations_share_blocks() {
+    MonotonicArena arena(4096);
+    for (int i = 0; i < 1000; ++i) {
+        arena.allocate(24, alignof(uint64_t));
+    }
+    // 24000 bytes out of blocks of 4 KB, 8 KB, 16 KB
+    TEST_ASSERT(arena.block_count() <= 3, "Small allocations should come from a few doubling blocks");
+    TEST_ASSERT(arena.memory_bytes() >= arena.bytes_used(), "Blocks should hold every allocation");
+    return true;
+}
+
+bool test_large_allocation_gets_own_block() {
+    MonotonicArena arena(256);
+    char* large = static_cast<char*>(arena.allocate(100000));
+    large[0] = 'a';
+    large[99999] = 'z';
+    TEST_ASSERT(arena.memory_bytes() >= 100000, "An oversized request should get a block that fits it");
+    return true;
+}
+
+bool test_release_frees_everything() {
+    MonotonicArena arena(256);
+    for (int i = 0; i < 100; ++i) {
+        arena.allocate(64);
+    }
+    arena.release();
+    TEST_ASSERT_EQUAL(static_cast<size_t>(0), arena.memory_bytes(), "release() should free every block");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(0), arena.bytes_used(), "release() should reset the usage");
+    TEST_ASSERT(arena.allocate(8) != nullptr, "The arena should be usable after release()");
+    return true;
+}
+
+bool test_containers_use_the_arena() {
+    MonotonicArena arena(1024);
+    ArenaVector<ArenaString> strings{ArenaAllocator<ArenaString>(arena)};
+    const std::string longer_than_sso(40, 'x');
+    for (int i = 0; i < 100; ++i) {
+        strings.emplace_back(longer_than_sso + std::to_string(i), strings.get_allocator());
+    }
+    TEST_ASSERT_EQUAL(static_cast<size_t>(100), strings.size(), "Vector should hold every string");
+    TEST_ASSERT(std::string_view(strings[42]) == longer_than_sso + "42", "Strings should keep their contents");
+    TEST_ASSERT(strings[42].get_allocator().arena() == &arena, "Strings should allocate from the vector's arena");
+    TEST_ASSERT(arena.bytes_used() >= 100 * longer_than_sso.size(), "String bytes should come from the arena");
+    
+    ArenaVector<uint64_t> numbers{ArenaAllocator<uint64_t>(arena)};
+    numbers.assign(1000, 7);
+    TEST_ASSERT(numbers.back() == 7 && numbers.get_allocator() == strings.get_allocator(), "Allocators of one arena compare equal");
+    return true;
+}
+
+int main() {
+    std::cout << "=== MonotonicArena Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_allocations_are_aligned);
+    RUN_TEST(test_small_allocations_share_blocks);
+    RUN_TEST(test_large_allocation_gets_own_block);
+    RUN_TEST(test_release_frees_everything);
+    RUN_TEST(test_containers_use_the_arena);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,143 @@
+#include "../../../include/leafra/leafra_autotune.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+static std::string temp_profile_path() {
+    return "test_device_profile.txt";
+}
+
+bool test_pick_prefers_smaller_within_tolerance() {
+    std::vector<AutotuneTrial> trials;
+    AutotuneTrial trial;
+    trial.value = 1; trial.cost = 10.0; trials.push_back(trial);
+    trial.value = 4; trial.cost = 5.2; trials.push_back(trial);
+    trial.value = 8; trial.cost = 5.0; trials.push_back(trial);
+    trial.value = 16; trial.cost = 0.0; trials.push_back(trial);    // Failed
+    TEST_ASSERT_EQUAL(8, DeviceProfile::pick(trials, 0.0), "Without tolerance the cheapest trial wins");
+    TEST_ASSERT_EQUAL(4, DeviceProfile::pick(trials, 0.1), "A smaller value within 10% should be preferred");
+    TEST_ASSERT_EQUAL(1, DeviceProfile::pick(trials, 1.0), "Doubling the slack admits the smallest value");
+    TEST_ASSERT_EQUAL(0, DeviceProfile::pick(std::vector<AutotuneTrial>(1, AutotuneTrial()), 0.1), "Only failed trials pick nothing");
+    return true;
+}
+
+bool test_save_load_round_trip() {
+    DeviceProfile profile;
+    profile.device = "iOS/arm64/2P+4E/6";
+    profile.target = AutotuneTarget::THROUGHPUT;
+    profile.embedding_model = "multilingual_e5_small.mlmodelc";
+    profile.embedding_batch_size = 16;
+    profile.llm_model = "Llama-3.2-1B-Instruct-Q4_K_M.gguf";
+    profile.llm_threads = 2;
+    profile.llm_batch_threads = 6;
+    const std::string path = temp_profile_path();
+    TEST_ASSERT(profile.save(path), "Profile should save");
+
+    DeviceProfile loaded;
+    TEST_ASSERT(DeviceProfile::load(path, loaded), "Saved profile should load");
+    TEST_ASSERT_EQUAL(profile.device, loaded.device, "Device should round trip");
+    TEST_ASSERT(loaded.target == AutotuneTarget::THROUGHPUT, "Target should round trip");
+    TEST_ASSERT_EQUAL(profile.embedding_model, loaded.embedding_model, "Embedding model should round trip");
+    TEST_ASSERT_EQUAL(16, loaded.embedding_batch_size, "Batch size should round trip");
+    TEST_ASSERT_EQUAL(profile.llm_model, loaded.llm_model, "LLM model should round trip");
+    TEST_ASSERT_EQUAL(2, loaded.llm_threads, "LLM threads should round trip");
+    TEST_ASSERT_EQUAL(6, loaded.llm_batch_threads, "LLM batch threads should round trip");
+    std::remove(path.c_str());
+
+    TEST_ASSERT(!DeviceProfile::load(path, loaded), "A missing file isn't a profile");
+    std::ofstream(path) << "journal_mode=WAL\n";
+    TEST_ASSERT(!DeviceProfile::load(path, loaded), "Files without the header should be rejected");
+    std::remove(path.c_str());
+    return true;
+}
+
+bool test_apply_matches_models_and_keeps_explicit_threads() {
+    DeviceProfile profile;
+    profile.device = "Linux/x86_64/8P+0E/16";
+    profile.embedding_model = "embed.tflite";
+    profile.embedding_batch_size = 8;
+    profile.llm_model = "model.gguf";
+    profile.llm_threads = 4;
+    profile.llm_batch_threads = 8;
+
+    EmbeddingModelConfig embedding;
+    LLMConfig llm;
+    embedding.model_path = "/models/embed.tflite";
+    llm.model_path = "/models/model.gguf";
+    llm.n_threads = 6;                              // Set explicitly
+    TEST_ASSERT(profile.apply(embedding, llm), "Matching models should take the profile");
+    TEST_ASSERT_EQUAL(8, embedding.batch_size, "Batch size should be applied");
+    TEST_ASSERT_EQUAL(6, llm.n_threads, "Explicit thread counts should be kept");
+    TEST_ASSERT_EQUAL(8, llm.n_threads_batch, "Automatic thread counts should be tuned");
+
+    EmbeddingModelConfig other_embedding;
+    LLMConfig other_llm;
+    other_embedding.model_path = "/models/other.tflite";
+    other_llm.model_path = "/models/other.gguf";
+    const int32_t batch_size = other_embedding.batch_size;
+    TEST_ASSERT(!profile.apply(other_embedding, other_llm), "Other models shouldn't take the profile");
+    TEST_ASSERT_EQUAL(batch_size, other_embedding.batch_size, "Batch size should stay as configured");
+    TEST_ASSERT_EQUAL(std::string("model.gguf"), DeviceProfile::model_name("C:\\models\\model.gguf"), "Windows separators should be stripped");
+    return true;
+}
+
+int main() {
+    std::cout << "=== DeviceProfile Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_pick_prefers_smaller_within_tolerance);
+    RUN_TEST(test_save_load_round_trip);
+    RUN_TEST(test_apply_matches_models_and_keeps_explicit_threads);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,251 @@
+#include "../../../include/leafra/leafra_batcher.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+using IntBatcher = MicroBatcher<int, int>;
+
+// Blocks the batch run that calls wait() until release()
+class Gate {
+public:
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        entered_ = true;
+        cv_.notify_all();
+        cv_.wait(lock, [this] { return open_; });
+    }
+    bool wait_entered() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, std::chrono::seconds(5), [this] { return entered_; });
+    }
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        open_ = true;
+        cv_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool entered_ = false;
+    bool open_ = false;
+};
+
+// Wait (bounded) until the batcher has served the given number of calls
+static bool wait_requests(const IntBatcher& batcher, uint64_t requests) {
+    for (int i = 0; i < 5000 && batcher.stats().requests < requests; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return batcher.stats().requests >= requests;
+}
+
+bool test_idle_call_runs_at_once() {
+    IntBatcher::Options options;
+    options.window = std::chrono::seconds(10);
+    IntBatcher batcher(options, [](std::vector<int>& requests, std::vector<int>& results) {
+        for (size_t i = 0; i < requests.size(); ++i) {
+            results[i] = requests[i] * 2;
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    int result = batcher.submit(21);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    TEST_ASSERT_EQUAL(42, result, "The call should get its own result");
+    TEST_ASSERT(elapsed < std::chrono::seconds(5), "A call with nothing running should not wait for the window");
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(1), batcher.stats().batches, "One run should be counted");
+    return true;
+}
+
+bool test_calls_during_a_run_share_a_batch() {
+    Gate gate;
+    std::atomic<int> runs{0};
+    IntBatcher::Options options;
+    options.max_batch = 8;
+    options.window = std::chrono::seconds(10);
+    IntBatcher batcher(options, [&](std::vector<int>& requests, std::vector<int>& results) {
+        if (runs++ == 0) {
+            gate.wait();
+        }
+        for (size_t i = 0; i < requests.size(); ++i) {
+            results[i] = requests[i] + 100;
+        }
+    });
+
+    std::thread first([&] { batcher.submit(0); });
+    TEST_ASSERT(gate.wait_entered(), "The first call should be running");
+
+    std::vector<int> results(4, -1);
+    std::vector<std::thread> callers;
+    for (int i = 0; i < 4; ++i) {
+        callers.emplace_back([&, i] { results[i] = batcher.submit(i + 1); });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    gate.release();
+    first.join();
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT_EQUAL(i + 101, results[i], "Every call should get the result for its own request");
+    }
+    IntBatcher::Stats stats = batcher.stats();
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(5), stats.requests, "Every call should be served");
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(2), stats.batches, "Calls queued behind the run should share one batch");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(4), stats.largest_batch, "The shared batch should hold the four waiting calls");
+    return true;
+}
+
+bool test_full_batch_runs_without_waiting() {
+    Gate gate;
+    std::atomic<int> runs{0};
+    IntBatcher::Options options;
+    options.max_batch = 3;
+    options.window = std::chrono::seconds(30);
+    IntBatcher batcher(options, [&](std::vector<int>& requests, std::vector<int>& results) {
+        if (runs++ == 0) {
+            gate.wait();
+        }
+        for (size_t i = 0; i < requests.size(); ++i) {
+            results[i] = requests[i];
+        }
+    });
+
+    std::thread first([&] { batcher.submit(0); });
+    TEST_ASSERT(gate.wait_entered(), "The first call should be running");
+    std::vector<std::thread> callers;
+    for (int i = 0; i < 3; ++i) {
+        callers.emplace_back([&, i] { batcher.submit(i + 1); });
+    }
+    // A full batch doesn't wait for the window, nor for the running batch
+    TEST_ASSERT(wait_requests(batcher, 3), "A full batch should run while the first one is still running");
+    gate.release();
+    first.join();
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    TEST_ASSERT_EQUAL(static_cast<size_t>(3), batcher.stats().largest_batch, "The batch should close at max_batch");
+    return true;
+}
+
+bool test_errors_reach_every_caller() {
+    Gate gate;
+    std::atomic<int> runs{0};
+    IntBatcher::Options options;
+    options.window = std::chrono::seconds(10);
+    IntBatcher batcher(options, [&](std::vector<int>&, std::vector<int>&) {
+        if (runs++ == 0) {
+            gate.wait();
+            return;
+        }
+        throw std::runtime_error("inference failed");
+    });
+
+    std::thread first([&] { batcher.submit(0); });
+    TEST_ASSERT(gate.wait_entered(), "The first call should be running");
+    std::atomic<int> failures{0};
+    std::vector<std::thread> callers;
+    for (int i = 0; i < 3; ++i) {
+        callers.emplace_back([&] {
+            try {
+                batcher.submit(1);
+            } catch (const std::runtime_error&) {
+                failures++;
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    gate.release();
+    first.join();
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    TEST_ASSERT_EQUAL(3, failures.load(), "Every caller of the failed batch should see the exception");
+    return true;
+}
+
+bool test_batch_of_one_disables_batching() {
+    IntBatcher::Options options;
+    options.max_batch = 1;
+    IntBatcher batcher(options, [](std::vector<int>& requests, std::vector<int>& results) {
+        results[0] = static_cast<int>(requests.size());
+    });
+    std::vector<std::thread> callers;
+    std::atomic<int> sizes{0};
+    for (int i = 0; i < 8; ++i) {
+        callers.emplace_back([&] { sizes += batcher.submit(i); });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    TEST_ASSERT_EQUAL(8, sizes.load(), "Every call should run alone");
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(8), batcher.stats().batches, "Every call should be its own batch");
+    return true;
+}
+
+int main() {
+    std::cout << "=== Micro-Batcher Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_idle_call_runs_at_once);
+    RUN_TEST(test_calls_during_a_run_share_a_batch);
+    RUN_TEST(test_full_batch_runs_without_waiting);
+    RUN_TEST(test_errors_reach_every_caller);
+    RUN_TEST(test_batch_of_one_disables_batching);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
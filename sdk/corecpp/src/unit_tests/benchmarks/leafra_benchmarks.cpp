@@ -0,0 +1,837 @@
+// Microbenchmarks for the vector kernels and the FAISS, SQLite, SentencePiece and CoreML wrappers
+//
+// Each benchmark repeats one wrapper call on generated data and reports per-call latency
+// (mean / p50 / p95 / p99 / min / max) and throughput. Data comes from a fixed-seed
+// generator, so numbers are comparable between builds and machines. Results are written
+// as one JSON document meant to be archived per commit and diffed over time; suites whose
+// dependency wasn't found at configure time are listed under "skipped".
+//
+// Suites:
+//   simd           batched fp32 / fp16 / int8 dot products and top-k, per instruction set the CPU supports
+//   faiss          add / search / batch_search / save_to_db / restore_from_db per IndexType, 10k-1M vectors
+//   sqlite         chunk insert (BulkInsert in one transaction) and chunk hydration by FAISS id
+//   sentencepiece  encode_as_ids over 256 B - 64 KB of text (needs --sentencepiece-model)
+//   coreml         predict / predict_into / predict_batch at batch sizes 1-32 (needs --coreml-model)
+//
+// Usage: leafra_benchmarks [--filter substring] [--output file.json] [--max-vectors N]
+//                          [--dimension D] [--min-seconds S] [--sentencepiece-model path]
+//                          [--coreml-model path]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../../../include/leafra/types.h"
+#include "../../../include/leafra/leafra_simd.h"
+#ifdef __APPLE__
+#include <TargetConditionals.h>
+#endif
+
+#ifdef LEAFRA_HAS_SQLITE
+#include "../../../include/leafra/leafra_filemanager.h"
+#include "../../../include/leafra/leafra_sqlite.h"
+#endif
+#ifdef LEAFRA_HAS_FAISS
+#include "../../../include/leafra/leafra_faiss.h"
+#endif
+#ifdef LEAFRA_HAS_SENTENCEPIECE
+#include "../../../include/leafra/leafra_sentencepiece.h"
+#endif
+#ifdef LEAFRA_HAS_COREML
+#include "../../../include/leafra/leafra_coreml.h"
+#endif
+
+using namespace leafra;
+
+namespace {
+
+// ==============================================================================
+// Options and reproducible data
+// ==============================================================================
+
+struct Options {
+    std::string filter;                 // Only run benchmarks whose "suite/name" contains this
+    std::string output;                 // JSON file (stdout when empty)
+    size_t max_vectors = 100000;        // Largest FAISS index size (10k, 100k, 1M capped by this)
+    int dimension = 384;                // Embedding dimension
+    double min_seconds = 0.5;           // Minimum measured time per benchmark
+    std::string sentencepiece_model;
+    std::string coreml_model;
+};
+
+struct Lcg {
+    uint32_t state;
+    explicit Lcg(uint32_t seed) : state(seed) {}
+    uint32_t next(uint32_t bound) {
+        state = state * 1103515245u + 12345u;
+        return (state >> 16) % bound;
+    }
+    float uniform() {
+        return static_cast<float>(next(1u << 15)) / static_cast<float>(1u << 15);
+    }
+};
+
+/**
+ * @brief Vectors scattered around a few dozen centroids, so IVF/PQ see realistic structure
+ */
+std::vector<float> generate_vectors(size_t count, int dimension, uint32_t seed) {
+    const size_t centroid_count = 64;
+    Lcg centroid_rng(7);
+    std::vector<float> centroids(centroid_count * dimension);
+    for (float& value : centroids) {
+        value = centroid_rng.uniform() * 2.0f - 1.0f;
+    }
+    Lcg rng(seed);
+    std::vector<float> vectors(count * dimension);
+    for (size_t i = 0; i < count; ++i) {
+        const float* centroid = &centroids[rng.next(centroid_count) * dimension];
+        for (int d = 0; d < dimension; ++d) {
+            vectors[i * dimension + d] = centroid[d] + (rng.uniform() - 0.5f) * 0.4f;
+        }
+    }
+    return vectors;
+}
+
+/**
+ * @brief English-like text of roughly the given size (words from a fixed vocabulary)
+ */
+std::string generate_text(size_t bytes, uint32_t seed) {
+    static const char* const kWords[] = {
+        "the", "document", "retrieval", "index", "embedding", "vector", "search", "query", "model",
+        "chunk", "results", "performance", "latency", "throughput", "memory", "device", "mobile",
+        "information", "processing", "background", "semantic", "language", "context", "answer",
+        "of", "and", "to", "in", "is", "for", "with", "on", "that", "by", "from", "as"};
+    const uint32_t word_count = sizeof(kWords) / sizeof(kWords[0]);
+    Lcg rng(seed);
+    std::string text;
+    text.reserve(bytes + 16);
+    size_t sentence_words = 0;
+    while (text.size() < bytes) {
+        text += kWords[rng.next(word_count)];
+        if (++sentence_words >= 8 + rng.next(12)) {
+            text += ". ";
+            sentence_words = 0;
+        } else {
+            text += ' ';
+        }
+    }
+    text.resize(bytes);
+    return text;
+}
+
+// ==============================================================================
+// Harness
+// ==============================================================================
+
+using Params = std::vector<std::pair<std::string, std::string>>;
+
+struct BenchmarkResult {
+    std::string suite;
+    std::string name;
+    Params params;
+    std::string unit;               // What items_per_call counts (vectors, queries, rows, bytes, samples)
+    uint64_t items_per_call = 1;
+    size_t iterations = 0;
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double p95_ms = 0.0;
+    double p99_ms = 0.0;
+    double min_ms = 0.0;
+    double max_ms = 0.0;
+    double items_per_second = 0.0;
+    std::string error;              // Set when the call failed; timings are then absent
+};
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, index > 0 ? index - 1 : 0)];
+}
+
+class Runner {
+public:
+    explicit Runner(const Options& options) : options_(options) {}
+
+    bool selected(const std::string& suite, const std::string& name) const {
+        return options_.filter.empty() || (suite + "/" + name).find(options_.filter) != std::string::npos;
+    }
+
+    /**
+     * @brief Time body() until min_seconds have been measured (at least once, at most max_iterations)
+     * @param setup Untimed preparation before every call (e.g. a fresh index); may be empty
+     * @param body Returns false when the wrapper call failed, which ends the benchmark
+     */
+    void run(const std::string& suite, const std::string& name, Params params, const std::string& unit,
+             uint64_t items_per_call, const std::function<void()>& setup, const std::function<bool()>& body,
+             size_t max_iterations = 100000) {
+        if (!selected(suite, name)) {
+            return;
+        }
+        BenchmarkResult result;
+        result.suite = suite;
+        result.name = name;
+        result.params = std::move(params);
+        result.unit = unit;
+        result.items_per_call = items_per_call;
+
+        std::vector<double> samples;
+        double measured = 0.0;
+        while (samples.size() < max_iterations && (samples.empty() || measured < options_.min_seconds)) {
+            if (setup) {
+                setup();
+            }
+            auto start = std::chrono::steady_clock::now();
+            bool ok = body();
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (!ok) {
+                result.error = "call failed";
+                break;
+            }
+            samples.push_back(elapsed * 1000.0);
+            measured += elapsed;
+        }
+
+        if (result.error.empty()) {
+            std::vector<double> sorted = samples;
+            std::sort(sorted.begin(), sorted.end());
+            double total_ms = 0.0;
+            for (double sample : sorted) {
+                total_ms += sample;
+            }
+            result.iterations = sorted.size();
+            result.mean_ms = total_ms / static_cast<double>(sorted.size());
+            result.p50_ms = percentile(sorted, 0.50);
+            result.p95_ms = percentile(sorted, 0.95);
+            result.p99_ms = percentile(sorted, 0.99);
+            result.min_ms = sorted.front();
+            result.max_ms = sorted.back();
+            result.items_per_second = total_ms > 0.0
+                ? static_cast<double>(items_per_call) * static_cast<double>(sorted.size()) / (total_ms / 1000.0)
+                : 0.0;
+        }
+        print(result);
+        results_.push_back(std::move(result));
+    } //run
+
+    void skip(const std::string& suite, const std::string& reason) {
+        std::cerr << "⏭️  " << suite << ": " << reason << std::endl;
+        skipped_.emplace_back(suite, reason);
+    }
+
+    std::string to_json() const;
+
+private:
+    static void print(const BenchmarkResult& result) {
+        std::string label = result.suite + "/" + result.name;
+        for (const auto& param : result.params) {
+            label += " " + param.first + "=" + param.second;
+        }
+        std::cerr << std::left << std::setw(56) << label << std::right;
+        if (!result.error.empty()) {
+            std::cerr << "  ❌ " << result.error << std::endl;
+            return;
+        }
+        std::cerr << std::fixed << std::setprecision(3)
+                  << std::setw(12) << result.p50_ms << " ms p50"
+                  << std::setw(12) << result.p95_ms << " ms p95"
+                  << std::setprecision(0) << std::setw(14) << result.items_per_second << " " << result.unit << "/s"
+                  << "  (" << result.iterations << " runs)" << std::endl;
+    }
+
+    const Options& options_;
+    std::vector<BenchmarkResult> results_;
+    std::vector<std::pair<std::string, std::string>> skipped_;
+};
+
+// ==============================================================================
+// JSON output
+// ==============================================================================
+
+std::string json_string(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+std::string json_number(double value) {
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.6g", value);
+    return number;
+}
+
+const char* platform_name() {
+#if defined(__APPLE__)
+#if TARGET_OS_IPHONE
+    return "ios";
+#else
+    return "macos";
+#endif
+#elif defined(__ANDROID__)
+    return "android";
+#elif defined(__linux__)
+    return "linux";
+#elif defined(_WIN32)
+    return "windows";
+#else
+    return "unknown";
+#endif
+}
+
+const char* architecture_name() {
+#if defined(__aarch64__) || defined(__arm64__)
+    return "arm64";
+#elif defined(__x86_64__) || defined(_M_X64)
+    return "x86_64";
+#elif defined(__arm__)
+    return "arm";
+#else
+    return "unknown";
+#endif
+}
+
+std::string Runner::to_json() const {
+    std::time_t now = std::time(nullptr);
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    std::string out = "{\n  \"schema_version\": 1,\n";
+    out += "  \"timestamp\": " + json_string(timestamp) + ",\n";
+    out += "  \"platform\": " + json_string(platform_name()) + ",\n";
+    out += "  \"architecture\": " + json_string(architecture_name()) + ",\n";
+#ifdef __VERSION__
+    out += "  \"compiler\": " + json_string(__VERSION__) + ",\n";
+#endif
+#ifdef NDEBUG
+    out += "  \"build_type\": \"release\",\n";
+#else
+    out += "  \"build_type\": \"debug\",\n";
+#endif
+    out += "  \"options\": {\"max_vectors\": " + std::to_string(options_.max_vectors) +
+           ", \"dimension\": " + std::to_string(options_.dimension) +
+           ", \"min_seconds\": " + json_number(options_.min_seconds) +
+           ", \"filter\": " + json_string(options_.filter) + "},\n";
+
+    out += "  \"results\": [";
+    for (size_t i = 0; i < results_.size(); ++i) {
+        const BenchmarkResult& result = results_[i];
+        out += i == 0 ? "\n" : ",\n";
+        out += "    {\"suite\": " + json_string(result.suite) + ", \"name\": " + json_string(result.name) + ", \"params\": {";
+        for (size_t p = 0; p < result.params.size(); ++p) {
+            out += (p == 0 ? "" : ", ") + json_string(result.params[p].first) + ": " + json_string(result.params[p].second);
+        }
+        out += "}, \"unit\": " + json_string(result.unit) + ", \"items_per_call\": " + std::to_string(result.items_per_call);
+        if (!result.error.empty()) {
+            out += ", \"error\": " + json_string(result.error) + "}";
+            continue;
+        }
+        out += ", \"iterations\": " + std::to_string(result.iterations) +
+               ", \"mean_ms\": " + json_number(result.mean_ms) +
+               ", \"p50_ms\": " + json_number(result.p50_ms) +
+               ", \"p95_ms\": " + json_number(result.p95_ms) +
+               ", \"p99_ms\": " + json_number(result.p99_ms) +
+               ", \"min_ms\": " + json_number(result.min_ms) +
+               ", \"max_ms\": " + json_number(result.max_ms) +
+               ", \"items_per_second\": " + json_number(result.items_per_second) + "}";
+    }
+    out += results_.empty() ? "],\n" : "\n  ],\n";
+
+    out += "  \"skipped\": [";
+    for (size_t i = 0; i < skipped_.size(); ++i) {
+        out += (i == 0 ? "" : ", ") + std::string("{\"suite\": ") + json_string(skipped_[i].first) +
+               ", \"reason\": " + json_string(skipped_[i].second) + "}";
+    }
+    out += "]\n}\n";
+    return out;
+} //to_json
+
+// ==============================================================================
+// Scratch database (AppStorage, removed before and after the run)
+// ==============================================================================
+
+#ifdef LEAFRA_HAS_SQLITE
+const char* const kBenchmarkDatabaseName = "leafra_benchmarks.db";
+
+void remove_benchmark_database() {
+    std::filesystem::path db_path = FileManager::getAbsolutePath(StorageType::AppStorage, kBenchmarkDatabaseName);
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(db_path.parent_path(), ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().filename().string().rfind(kBenchmarkDatabaseName, 0) == 0) {
+            std::filesystem::remove(it->path(), ec);
+        }
+    }
+}
+
+bool open_benchmark_database(SQLiteDatabase& db) {
+    remove_benchmark_database();
+    if (!SQLiteDatabase::createdb(kBenchmarkDatabaseName) || !db.open(kBenchmarkDatabaseName)) {
+        std::cerr << "❌ Failed to create benchmark database" << std::endl;
+        return false;
+    }
+    return true;
+}
+#endif
+
+// ==============================================================================
+// FAISS
+// ==============================================================================
+
+#ifdef LEAFRA_HAS_FAISS
+struct IndexTypeCase {
+    const char* name;
+    FaissIndex::IndexType type;
+};
+
+const IndexTypeCase kIndexTypes[] = {
+    {"FLAT", FaissIndex::IndexType::FLAT},
+    {"IVF_FLAT", FaissIndex::IndexType::IVF_FLAT},
+    {"IVF_PQ", FaissIndex::IndexType::IVF_PQ},
+    {"HNSW", FaissIndex::IndexType::HNSW},
+    {"LSH", FaissIndex::IndexType::LSH},
+    {"SQ8", FaissIndex::IndexType::SQ8},
+    {"SQ_FP16", FaissIndex::IndexType::SQ_FP16},
+    {"HNSW_SQ", FaissIndex::IndexType::HNSW_SQ},
+};
+
+/**
+ * @brief Fresh index of the given type, trained (untimed) on a sample of the data when it needs it
+ */
+std::unique_ptr<FaissIndex> make_index(const IndexTypeCase& type_case, int dimension, const std::vector<float>& data) {
+    auto index = std::make_unique<FaissIndex>(dimension, type_case.type, FaissIndex::MetricType::L2);
+    if (!index->is_trained()) {
+        int count = static_cast<int>(data.size() / dimension);
+        int training_count = std::min(count, 50000);
+        if (index->train(data.data(), training_count) != ResultCode::SUCCESS) {
+            return nullptr;
+        }
+    }
+    return index;
+}
+
+void run_faiss_benchmarks(Runner& runner, const Options& options) {
+    const std::string suite = "faiss";
+    SQLiteDatabase db;
+    if (!open_benchmark_database(db)) {
+        runner.skip(suite, "benchmark database unavailable");
+        return;
+    }
+
+    const int dimension = options.dimension;
+    const int query_count = 256;
+    const int batch_queries = 64;
+    const int k = 10;
+    std::vector<float> queries = generate_vectors(query_count, dimension, 99);
+
+    for (size_t count : {size_t(10000), size_t(100000), size_t(1000000)}) {
+        if (count > options.max_vectors) {
+            continue;
+        }
+        std::vector<float> data = generate_vectors(count, dimension, static_cast<uint32_t>(count));
+        std::vector<int64_t> ids(count);
+        for (size_t i = 0; i < count; ++i) {
+            ids[i] = static_cast<int64_t>(i);
+        }
+        const int n = static_cast<int>(count);
+
+        for (const IndexTypeCase& type_case : kIndexTypes) {
+            Params params = {{"type", type_case.name}, {"vectors", std::to_string(count)}, {"dim", std::to_string(dimension)}};
+
+            // add: one full load into a fresh (already trained) index per call
+            std::unique_ptr<FaissIndex> index;
+            runner.run(suite, "add", params, "vectors", count,
+                       [&] { index = make_index(type_case, dimension, data); },
+                       [&] { return index && index->add_vectors_with_ids(data.data(), ids.data(), n) == ResultCode::SUCCESS; },
+                       5);
+            if (!index || index->get_count() != n) {
+                // add was filtered out (or failed): build the index the remaining benchmarks search
+                index = make_index(type_case, dimension, data);
+                if (!index || index->add_vectors_with_ids(data.data(), ids.data(), n) != ResultCode::SUCCESS) {
+                    std::cerr << "❌ Failed to build " << type_case.name << " index with " << count << " vectors" << std::endl;
+                    continue;
+                }
+            }
+
+            Params search_params = params;
+            search_params.emplace_back("k", std::to_string(k));
+            search_params.emplace_back("memory_bytes", std::to_string(index->get_memory_bytes()));
+            std::vector<FaissIndex::SearchResult> results;
+            int next_query = 0;
+            runner.run(suite, "search", search_params, "queries", 1, nullptr, [&] {
+                const float* query = &queries[static_cast<size_t>(next_query) * dimension];
+                next_query = (next_query + 1) % query_count;
+                return index->search(query, k, results) == ResultCode::SUCCESS && !results.empty();
+            });
+
+            Params batch_params = search_params;
+            batch_params.emplace_back("queries", std::to_string(batch_queries));
+            std::vector<std::vector<FaissIndex::SearchResult>> batch_results;
+            runner.run(suite, "batch_search", batch_params, "queries", batch_queries, nullptr, [&] {
+                return index->batch_search(queries.data(), batch_queries, k, batch_results) == ResultCode::SUCCESS;
+            });
+
+            const std::string definition = std::string("Benchmark.") + type_case.name + "." + std::to_string(count);
+            runner.run(suite, "save_to_db", params, "vectors", count, nullptr,
+                       [&] { return index->save_to_db(db, definition) == ResultCode::SUCCESS; }, 20);
+
+            std::unique_ptr<FaissIndex> restored;
+            runner.run(suite, "restore_from_db", params, "vectors", count,
+                       [&] { restored = std::make_unique<FaissIndex>(dimension, type_case.type, FaissIndex::MetricType::L2); },
+                       [&] { return restored->restore_from_db(db, definition) == ResultCode::SUCCESS && restored->get_count() == n; },
+                       20);
+        }
+    }
+    db.close();
+    remove_benchmark_database();
+} //run_faiss_benchmarks
+#endif
+
+// ==============================================================================
+// SQLite
+// ==============================================================================
+
+#ifdef LEAFRA_HAS_SQLITE
+void run_sqlite_benchmarks(Runner& runner, const Options& options) {
+    (void)options;
+    const std::string suite = "sqlite";
+    SQLiteDatabase db;
+    if (!open_benchmark_database(db)) {
+        runner.skip(suite, "benchmark database unavailable");
+        return;
+    }
+
+    int64_t doc_id = -1;
+    {
+        auto stmt = db.prepareCached("INSERT INTO docs (filename, url, creation_date, size, file_size, file_mtime, content_hash, collection) "
+                                     "VALUES (?, ?, CURRENT_TIMESTAMP, ?, ?, ?, ?, ?)");
+        if (stmt && stmt->bindText(1, "benchmark.txt") && stmt->bindText(2, "/benchmark.txt") && stmt->bindInt64(3, 0) &&
+            stmt->bindInt64(4, 0) && stmt->bindInt64(5, 0) && stmt->bindText(6, "") && stmt->bindText(7, "default") &&
+            stmt->execute()) {
+            doc_id = db.getLastInsertRowId();
+        }
+    }
+    if (doc_id < 0) {
+        runner.skip(suite, "failed to insert benchmark document");
+        return;
+    }
+
+    // ~1 KB chunks, the size a 256-token chunk of English text ends up as
+    std::vector<std::string> texts;
+    for (uint32_t i = 0; i < 64; ++i) {
+        texts.push_back(generate_text(1024, 1000 + i));
+    }
+
+    int64_t next_faiss_id = 0;
+    auto insert_chunks = [&](size_t rows) {
+        SQLiteTransaction transaction(db);
+        SQLiteDatabase::BulkInsert insert(db, "chunks", {"doc_id", "chunk_page_number", "chunk_faiss_id", "chunk_no",
+                                                         "chunk_token_size", "chunk_size", "chunk_text", "chunk_hash"});
+        for (size_t row = 0; row < rows; ++row) {
+            const std::string& text = texts[row % texts.size()];
+            int64_t faiss_id = next_faiss_id++;
+            if (!insert.bindInt64(0, doc_id) || !insert.bindInt64(1, 1) || !insert.bindInt64(2, faiss_id) ||
+                !insert.bindInt64(3, faiss_id) || !insert.bindInt64(4, 256) ||
+                !insert.bindInt64(5, static_cast<long long>(text.size())) || !insert.bindTextView(6, text) ||
+                !insert.bindNull(7) || !insert.endRow()) {
+                return false;
+            }
+        }
+        return insert.flush() && transaction.commit();
+    };
+
+    for (size_t rows : {size_t(100), size_t(1000), size_t(10000)}) {
+        runner.run(suite, "chunk_insert", {{"rows", std::to_string(rows)}, {"chunk_bytes", "1024"}}, "rows", rows, nullptr,
+                   [&] { return insert_chunks(rows); }, 50);
+    }
+
+    // Hydration reads what a search returned: k random chunks by FAISS id, joined with their document
+    const int64_t min_rows = 100000;
+    if (next_faiss_id < min_rows && !insert_chunks(static_cast<size_t>(min_rows - next_faiss_id))) {
+        runner.skip(suite, "failed to fill chunks for hydration");
+        return;
+    }
+    Lcg rng(42);
+    for (int k : {10, 50, 200}) {
+        std::string sql = "SELECT c.chunk_faiss_id, c.doc_id, c.chunk_no, c.chunk_text, c.chunk_page_number, d.filename "
+                          "FROM chunks c JOIN docs d ON c.doc_id = d.id WHERE c.chunk_faiss_id IN (";
+        for (int i = 0; i < k; ++i) {
+            sql += i == 0 ? "?" : ",?";
+        }
+        sql += ")";
+        runner.run(suite, "chunk_hydrate", {{"k", std::to_string(k)}, {"rows", std::to_string(next_faiss_id)}}, "chunks", k, nullptr, [&] {
+            auto stmt = db.prepareCached(sql);
+            if (!stmt) {
+                return false;
+            }
+            for (int i = 0; i < k; ++i) {
+                stmt->bindInt64(i + 1, static_cast<long long>(rng.next(static_cast<uint32_t>(next_faiss_id))));
+            }
+            size_t text_bytes = 0;
+            bool ok = stmt->forEachRow([&text_bytes](const SQLiteDatabase::Row& row) {
+                text_bytes += row.getTextView(3).size();
+                return true;
+            });
+            return ok && text_bytes > 0;
+        });
+    }
+    db.close();
+    remove_benchmark_database();
+} //run_sqlite_benchmarks
+#endif
+
+// ==============================================================================
+// SentencePiece
+// ==============================================================================
+
+#ifdef LEAFRA_HAS_SENTENCEPIECE
+void run_sentencepiece_benchmarks(Runner& runner, const Options& options) {
+    const std::string suite = "sentencepiece";
+    if (options.sentencepiece_model.empty()) {
+        runner.skip(suite, "no --sentencepiece-model given");
+        return;
+    }
+    SentencePieceTokenizer tokenizer;
+    TokenizerConfig config;
+    config.enabled = true;
+    config.model_path = options.sentencepiece_model;
+    if (!tokenizer.load_model(config) || !tokenizer.is_loaded()) {
+        runner.skip(suite, "failed to load " + options.sentencepiece_model);
+        return;
+    }
+
+    std::vector<int> ids;
+    for (size_t bytes : {size_t(256), size_t(4096), size_t(65536)}) {
+        std::string text = generate_text(bytes, static_cast<uint32_t>(bytes));
+        runner.run(suite, "encode_as_ids", {{"text_bytes", std::to_string(bytes)}}, "bytes", bytes, nullptr,
+                   [&] { return tokenizer.encode_as_ids(text, ids) && !ids.empty(); });
+    }
+} //run_sentencepiece_benchmarks
+#endif
+
+// ==============================================================================
+// CoreML
+// ==============================================================================
+
+#ifdef LEAFRA_HAS_COREML
+void run_coreml_benchmarks(Runner& runner, const Options& options) {
+    const std::string suite = "coreml";
+    if (options.coreml_model.empty()) {
+        runner.skip(suite, "no --coreml-model given");
+        return;
+    }
+    std::unique_ptr<CoreMLModel> model;
+    try {
+        model = std::make_unique<CoreMLModel>(options.coreml_model, CoreMLModel::ComputeUnits::All);
+    } catch (const std::exception& e) {
+        runner.skip(suite, std::string("failed to load model: ") + e.what());
+        return;
+    }
+    if (!model->isValid()) {
+        runner.skip(suite, "invalid model " + options.coreml_model);
+        return;
+    }
+
+    // Token-id style inputs: masks are all ones, everything else cycles through plausible ids
+    std::vector<std::vector<float>> sample(model->getInputCount());
+    for (size_t i = 0; i < sample.size(); ++i) {
+        bool mask = model->getInputName(i).find("mask") != std::string::npos;
+        sample[i].resize(model->getInputSize(i));
+        for (size_t j = 0; j < sample[i].size(); ++j) {
+            sample[i][j] = mask ? 1.0f : static_cast<float>(100 + j % 1000);
+        }
+    }
+
+    std::vector<std::vector<float>> outputs(model->getOutputCount());
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        outputs[i].resize(model->getOutputSize(i));
+    }
+    runner.run(suite, "predict", {{"batch", "1"}}, "samples", 1, nullptr, [&] {
+        try {
+            return model->predict(sample, outputs);
+        } catch (const std::exception&) {
+            return false;
+        }
+    });
+
+    // Same sample through the bound buffers (no per-call MLMultiArray / provider allocation)
+    std::vector<const float*> input_buffers;
+    std::vector<size_t> input_sizes;
+    std::vector<float*> output_buffers;
+    for (const auto& input : sample) {
+        input_buffers.push_back(input.data());
+        input_sizes.push_back(input.size());
+    }
+    for (auto& output : outputs) {
+        output_buffers.push_back(output.data());
+    }
+    runner.run(suite, "predict_into", {{"batch", "1"}}, "samples", 1, nullptr, [&] {
+        return model->predict_into(input_buffers, input_sizes, output_buffers);
+    });
+    for (size_t batch : {size_t(4), size_t(16), size_t(32)}) {
+        std::vector<std::vector<std::vector<float>>> batch_inputs(batch, sample);
+        runner.run(suite, "predict_batch", {{"batch", std::to_string(batch)}}, "samples", batch, nullptr, [&] {
+            try {
+                return model->predict_batch(batch_inputs).size() == batch;
+            } catch (const std::exception&) {
+                return false;
+            }
+        });
+    }
+} //run_coreml_benchmarks
+#endif
+
+// ==============================================================================
+// Vector kernels
+// ==============================================================================
+
+void run_simd_benchmarks(Runner& runner, const Options& options) {
+    const std::string suite = "simd";
+    const size_t dimension = static_cast<size_t>(options.dimension);
+    const size_t rows = 1000;               // A re-ranking / MMR candidate pool
+    const size_t score_count = 100000;      // Scores for top-k
+    const size_t k = 10;
+
+    std::vector<float> data = generate_vectors(rows, options.dimension, 5);
+    std::vector<float> query = generate_vectors(1, options.dimension, 6);
+    std::vector<uint16_t> halves(data.size());
+    simd::float_to_half(data.data(), halves.data(), data.size());
+    std::vector<int8_t> quantized(data.size());
+    std::vector<float> scales(rows);
+    for (size_t r = 0; r < rows; ++r) {
+        const float* row = data.data() + r * dimension;
+        scales[r] = simd::max_abs(row, dimension) / 127.0f;
+        for (size_t d = 0; d < dimension; ++d) {
+            quantized[r * dimension + d] = static_cast<int8_t>(std::lround(scales[r] > 0.0f ? row[d] / scales[r] : 0.0f));
+        }
+    }
+    std::vector<float> scores(score_count);
+    Lcg rng(11);
+    for (float& score : scores) {
+        score = rng.uniform();
+    }
+    std::vector<float> out(rows);
+    std::vector<uint32_t> best;
+
+    const simd::Isa original = simd::active_isa();
+    for (simd::Isa isa : {simd::Isa::SCALAR, simd::Isa::NEON, simd::Isa::AVX2, simd::Isa::AVX512}) {
+        if (!simd::set_active_isa(isa)) {
+            continue;
+        }
+        Params params = {{"isa", simd::isa_name(isa)}, {"rows", std::to_string(rows)}, {"dim", std::to_string(dimension)}};
+        runner.run(suite, "dot_batch_f32", params, "rows", rows, nullptr, [&] {
+            simd::dot_batch(query.data(), data.data(), rows, dimension, out.data());
+            return true;
+        });
+        runner.run(suite, "dot_batch_f16", params, "rows", rows, nullptr, [&] {
+            simd::dot_batch_f16(query.data(), halves.data(), rows, dimension, out.data());
+            return true;
+        });
+        runner.run(suite, "dot_batch_i8", params, "rows", rows, nullptr, [&] {
+            simd::dot_batch_i8(query.data(), quantized.data(), scales.data(), rows, dimension, out.data());
+            return true;
+        });
+        Params top_k_params = {{"isa", simd::isa_name(isa)}, {"scores", std::to_string(score_count)}, {"k", std::to_string(k)}};
+        runner.run(suite, "top_k", top_k_params, "scores", score_count, nullptr, [&] {
+            simd::top_k(scores.data(), score_count, k, true, best);
+            return best.size() == k;
+        });
+    }
+    simd::set_active_isa(original);
+} //run_simd_benchmarks
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [--filter substring] [--output file.json] [--max-vectors N]" << std::endl
+              << "       [--dimension D] [--min-seconds S] [--sentencepiece-model path] [--coreml-model path]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            options.output = argv[++i];
+        } else if (arg == "--max-vectors" && i + 1 < argc) {
+            options.max_vectors = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--dimension" && i + 1 < argc) {
+            options.dimension = std::max(8, std::atoi(argv[++i]));
+        } else if (arg == "--min-seconds" && i + 1 < argc) {
+            options.min_seconds = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--sentencepiece-model" && i + 1 < argc) {
+            options.sentencepiece_model = argv[++i];
+        } else if (arg == "--coreml-model" && i + 1 < argc) {
+            options.coreml_model = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::cerr << "=== Leafra Microbenchmarks ===" << std::endl;
+    Runner runner(options);
+
+    run_simd_benchmarks(runner, options);
+#ifdef LEAFRA_HAS_FAISS
+    run_faiss_benchmarks(runner, options);
+#else
+    runner.skip("faiss", "built without FAISS");
+#endif
+#ifdef LEAFRA_HAS_SQLITE
+    run_sqlite_benchmarks(runner, options);
+#else
+    runner.skip("sqlite", "built without SQLite");
+#endif
+#ifdef LEAFRA_HAS_SENTENCEPIECE
+    run_sentencepiece_benchmarks(runner, options);
+#else
+    runner.skip("sentencepiece", "built without SentencePiece");
+#endif
+#ifdef LEAFRA_HAS_COREML
+    run_coreml_benchmarks(runner, options);
+#else
+    runner.skip("coreml", "built without CoreML");
+#endif
+
+    std::string json = runner.to_json();
+    if (options.output.empty()) {
+        std::cout << json;
+        return 0;
+    }
+    std::ofstream file(options.output, std::ios::binary | std::ios::trunc);
+    file << json;
+    if (!file.flush()) {
+        std::cerr << "❌ Failed to write " << options.output << std::endl;
+        return 1;
+    }
+    std::cerr << "📊 Results written to " << options.output << std::endl;
+    return 0;
+}
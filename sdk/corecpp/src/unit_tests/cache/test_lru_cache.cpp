@@ -0,0 +1,161 @@
+#include "../../../include/leafra/leafra_cache.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+bool test_get_and_put() {
+    LRUCache<std::string, std::vector<float> > cache(2);
+    TEST_ASSERT(cache.get("missing") == nullptr, "Empty cache should miss");
+
+    cache.put("a", {1.0f, 2.0f});
+    const auto* value = cache.get("a");
+    TEST_ASSERT(value != nullptr, "Inserted key should hit");
+    TEST_ASSERT_EQUAL(2.0f, (*value)[1], "Cached value should be returned");
+
+    cache.put("a", {3.0f});
+    TEST_ASSERT_EQUAL(static_cast<size_t>(1), cache.size(), "Replacing a key should not add an entry");
+    TEST_ASSERT_EQUAL(3.0f, (*cache.get("a"))[0], "Replacing a key should update its value");
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(2), cache.hits(), "Hits should be counted");
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(1), cache.misses(), "Misses should be counted");
+    return true;
+}
+
+bool test_evicts_least_recently_used() {
+    LRUCache<int, int> cache(2);
+    cache.put(1, 10);
+    cache.put(2, 20);
+    TEST_ASSERT(cache.get(1) != nullptr, "Key 1 should be cached");  // 2 is now least recently used
+
+    cache.put(3, 30);
+    TEST_ASSERT_EQUAL(static_cast<size_t>(2), cache.size(), "Cache should stay within capacity");
+    TEST_ASSERT(cache.get(2) == nullptr, "Least recently used key should be evicted");
+    TEST_ASSERT(cache.get(1) != nullptr, "Recently used key should survive");
+    TEST_ASSERT(cache.get(3) != nullptr, "Newest key should be cached");
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(1), cache.evictions(), "Evictions should be counted");
+
+    cache.set_capacity(1);
+    TEST_ASSERT_EQUAL(static_cast<size_t>(1), cache.size(), "Shrinking should evict down to capacity");
+    TEST_ASSERT(cache.get(3) != nullptr, "Shrinking should keep the most recently used key");
+    return true;
+}
+
+bool test_zero_capacity_and_clear() {
+    LRUCache<int, int> disabled(0);
+    disabled.put(1, 10);
+    TEST_ASSERT(disabled.get(1) == nullptr, "Zero-capacity cache should never store entries");
+
+    LRUCache<int, int> cache(4);
+    cache.put(1, 10);
+    cache.put(2, 20);
+    TEST_ASSERT(cache.erase(1), "Erase should remove an existing key");
+    TEST_ASSERT(!cache.erase(1), "Erase should report missing keys");
+    cache.clear();
+    TEST_ASSERT_EQUAL(static_cast<size_t>(0), cache.size(), "Clear should drop every entry");
+    cache.reset_stats();
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(0), cache.misses(), "reset_stats should zero the counters");
+    return true;
+}
+
+bool test_erase_if() {
+    LRUCache<int, int> cache(4);
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(3, 30);
+    size_t removed = cache.erase_if([](int key, int value) { return key == 1 || value == 30; });
+    TEST_ASSERT_EQUAL(static_cast<size_t>(2), removed, "erase_if should report how many entries it removed");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(1), cache.size(), "Matching entries should be removed");
+    TEST_ASSERT(cache.get(1) == nullptr && cache.get(3) == nullptr, "Removed keys should miss");
+    TEST_ASSERT(cache.get(2) != nullptr, "Other entries should survive");
+
+    cache.put(4, 40);
+    cache.put(5, 50);
+    cache.put(6, 60);
+    cache.put(7, 70);
+    TEST_ASSERT(cache.get(2) == nullptr, "Eviction should still follow recency after erase_if");
+    return true;
+}
+
+bool test_evict_and_for_each() {
+    LRUCache<int, int> cache(4);
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(3, 30);
+    TEST_ASSERT(cache.get(1) != nullptr, "Key 1 should be cached");  // Recency: 1, 3, 2
+
+    std::vector<int> keys;
+    int sum = 0;
+    cache.for_each([&](int key, int value) {
+        keys.push_back(key);
+        sum += value;
+    });
+    TEST_ASSERT(keys == std::vector<int>({1, 3, 2}), "for_each should visit most recently used first");
+    TEST_ASSERT_EQUAL(60, sum, "for_each should visit every value");
+
+    TEST_ASSERT_EQUAL(static_cast<size_t>(1), cache.evict(1), "evict should report how many entries it removed");
+    TEST_ASSERT(cache.get(2) == nullptr, "evict should drop the least recently used entry");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(4), cache.capacity(), "evict should keep the capacity");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(2), cache.evict(10), "evict should stop when the cache is empty");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(0), cache.size(), "Every entry should be evicted");
+    return true;
+}
+
+int main() {
+    std::cout << "=== LRUCache Tests ===" << std::endl;
+    
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+    
+    RUN_TEST(test_get_and_put);
+    RUN_TEST(test_evicts_least_recently_used);
+    RUN_TEST(test_zero_capacity_and_clear);
+    RUN_TEST(test_erase_if);
+    RUN_TEST(test_evict_and_for_each);
+    
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+    
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,155 @@
+#include "../../../include/leafra/leafra_chunk_quality.h"
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+static const char* kProse =
+    "The supplier shall deliver the goods within thirty days of receiving a written order. "
+    "Payment is due on delivery, and late payments accrue interest at the statutory rate.";
+
+// Tokens a subword tokenizer would produce for text of this kind (about four bytes per token for prose)
+static size_t approx_tokens(const std::string& text, double bytes_per_token) {
+    return static_cast<size_t>(text.size() / bytes_per_token);
+}
+
+bool test_score_statistics() {
+    ChunkQualityScore empty = ChunkQuality::score("", 0);
+    TEST_ASSERT_EQUAL(static_cast<size_t>(0), empty.characters, "Empty text has no characters");
+    TEST_ASSERT(empty.alpha_ratio == 0.0 && empty.entropy == 0.0, "Empty text scores zero");
+
+    ChunkQualityScore score = ChunkQuality::score("ab ab\n", 3);
+    TEST_ASSERT_EQUAL(static_cast<size_t>(4), score.characters, "Whitespace is not counted");
+    TEST_ASSERT(score.alpha_ratio == 1.0, "All characters are letters");
+    TEST_ASSERT(score.entropy > 0.999 && score.entropy < 1.001, "Two equally frequent symbols carry one bit");
+    TEST_ASSERT(score.tokens_per_byte == 0.5, "Tokens per byte counts every byte");
+
+    ChunkQualityScore utf8 = ChunkQuality::score("Größe 12", 0);
+    TEST_ASSERT_EQUAL(static_cast<size_t>(7), utf8.characters, "Multi-byte code points count once");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(5), utf8.ascii_characters, "Only ASCII characters enter the entropy");
+    return true;
+}
+
+bool test_prose_passes() {
+    ChunkQualityConfig config;
+    std::string prose(kProse);
+    ChunkQualityScore score = ChunkQuality::score(prose, approx_tokens(prose, 4.0));
+    TEST_ASSERT(ChunkQuality::rejection_reason(score, config) == nullptr, "Ordinary prose passes");
+
+    // Mostly non-ASCII text is judged on length and letters only
+    std::string cjk;
+    for (int i = 0; i < 40; ++i) {
+        cjk += "\xE6\x96\x87\xE4\xBB\xB6";
+    }
+    score = ChunkQuality::score(cjk, approx_tokens(cjk, 3.0));
+    TEST_ASSERT(ChunkQuality::rejection_reason(score, config) == nullptr, "CJK text passes");
+    return true;
+}
+
+bool test_junk_is_rejected() {
+    ChunkQualityConfig config;
+    auto reason = [&config](const std::string& text, size_t tokens) {
+        const char* r = ChunkQuality::rejection_reason(ChunkQuality::score(text, tokens), config);
+        return std::string(r ? r : "");
+    };
+
+    TEST_ASSERT_EQUAL(std::string("length"), reason("Page 3 of 10", 6), "Page numbers are too short");
+
+    std::string toc = "1 Introduction ........................ 3\n2 Background .......................... 7\n"
+                      "3 Methods ............................. 12\n";
+    TEST_ASSERT_EQUAL(std::string("alpha_ratio"), reason(toc, approx_tokens(toc, 4.0)), "Dot leaders are low on letters");
+
+    std::string ruler(80, '=');
+    ruler += " Summary";
+    TEST_ASSERT_EQUAL(std::string("alpha_ratio"), reason(ruler, 10), "Rulers are low on letters");
+
+    std::string repeated;
+    for (int i = 0; i < 20; ++i) {
+        repeated += "aaaa ";
+    }
+    TEST_ASSERT_EQUAL(std::string("entropy"), reason(repeated, 20), "Repeated characters have too little entropy");
+
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::mt19937 rng(7);
+    std::string base64;
+    for (int i = 0; i < 600; ++i) {
+        base64 += alphabet[rng() % 64];
+    }
+    TEST_ASSERT_EQUAL(std::string("entropy"), reason(base64, 0), "Base64 has too much entropy");
+    TEST_ASSERT_EQUAL(std::string("tokens_per_byte"), reason(base64, approx_tokens(base64, 1.6)), "Base64 tokenizes into short pieces");
+    return true;
+}
+
+bool test_thresholds_are_configurable() {
+    ChunkQualityConfig config;
+    std::string toc = "1 Introduction ........................ 3\n";
+    ChunkQualityScore score = ChunkQuality::score(toc, 12);
+    TEST_ASSERT(ChunkQuality::rejection_reason(score, config) != nullptr, "Default thresholds reject the line");
+
+    config.min_chars = 0;
+    config.min_alpha_ratio = 0.0f;
+    config.max_tokens_per_byte = 0.0f;
+    config.min_entropy = 0.0f;
+    config.max_entropy = 0.0f;
+    TEST_ASSERT(ChunkQuality::rejection_reason(score, config) == nullptr, "Disabled thresholds accept anything");
+    return true;
+}
+
+int main() {
+    std::cout << "=== Chunk Quality Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_score_statistics);
+    RUN_TEST(test_prose_passes);
+    RUN_TEST(test_junk_is_rejected);
+    RUN_TEST(test_thresholds_are_configurable);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,297 @@
+// Chunker throughput and memory benchmark
+//
+// Runs chunk_text / chunk_document over generated corpora (ASCII, CJK, mixed-script,
+// emoji-heavy) from 1 KB up to --max-mb and reports MB/s, chunks/s and the peak heap
+// growth of each run. Corpora come from a fixed-seed generator, so numbers are
+// comparable between builds and machines.
+//
+// Usage: bench_chunker [--max-mb N] [--min-seconds S] [--corpus ascii|cjk|mixed|emoji] [--csv]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "../../../include/leafra/leafra_chunker.h"
+
+using namespace leafra;
+
+// ==============================================================================
+// Heap tracking - every allocation carries its size in a header so delete can
+// subtract it; peak is the high-water mark since the last reset
+// ==============================================================================
+
+namespace {
+
+std::atomic<size_t> g_current_bytes{0};
+std::atomic<size_t> g_peak_bytes{0};
+constexpr size_t kHeader = alignof(std::max_align_t);
+
+void* tracked_alloc(size_t size) {
+    void* block = std::malloc(size + kHeader);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t*>(block) = size;
+    size_t current = g_current_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t peak = g_peak_bytes.load(std::memory_order_relaxed);
+    while (current > peak && !g_peak_bytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+    return static_cast<char*>(block) + kHeader;
+}
+
+void tracked_free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    void* block = static_cast<char*>(ptr) - kHeader;
+    g_current_bytes.fetch_sub(*static_cast<size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+} // namespace
+
+void* operator new(size_t size) { return tracked_alloc(size); }
+void* operator new[](size_t size) { return tracked_alloc(size); }
+void operator delete(void* ptr) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { tracked_free(ptr); }
+
+// ==============================================================================
+// Reproducible corpora
+// ==============================================================================
+
+namespace {
+
+struct Lcg {
+    uint32_t state;
+    explicit Lcg(uint32_t seed) : state(seed) {}
+    uint32_t next(uint32_t bound) {
+        state = state * 1103515245u + 12345u;
+        return (state >> 16) % bound;
+    }
+};
+
+const char* const kAsciiWords[] = {
+    "the", "model", "retrieval", "document", "of", "and", "index", "vector", "a", "query",
+    "embedding", "search", "results", "to", "is", "performance", "local", "device", "in", "chunk"
+};
+const char* const kCjkWords[] = {
+    "文档", "检索", "向量", "模型", "的", "数据", "搜索", "结果", "本地", "设备",
+    "日本語", "テキスト", "分割", "処理", "한국어", "문서", "검색", "그리고", "性能", "索引"
+};
+const char* const kMixedWords[] = {
+    "document", "Dokument", "документ", "έγγραφο", "وثيقة", "מסמך", "文档", "café", "naïve", "résumé",
+    "straße", "données", "индекс", "ευρετήριο", "بحث", "search", "検索", "जानकारी", "ข้อมูล", "über"
+};
+const char* const kEmojiWords[] = {
+    "🚀", "launch", "👩‍💻", "code", "🎉", "done", "🇺🇸", "👍🏽", "ship", "🔥",
+    "test", "🌍", "❤️", "data", "👨‍👩‍👧‍👦", "team", "😀", "✅", "bug", "📄"
+};
+
+enum class Corpus { ASCII, CJK, MIXED, EMOJI };
+
+const char* corpus_name(Corpus corpus) {
+    switch (corpus) {
+        case Corpus::ASCII: return "ascii";
+        case Corpus::CJK: return "cjk";
+        case Corpus::MIXED: return "mixed";
+        case Corpus::EMOJI: return "emoji";
+    }
+    return "?";
+}
+
+/**
+ * Generate size_bytes of text (cut at a character boundary) from a fixed seed
+ * Sentences of 6-20 words, paragraphs of 2-6 sentences; CJK joins words without spaces
+ */
+std::string generate_corpus(Corpus corpus, size_t size_bytes) {
+    const char* const* words = corpus == Corpus::ASCII ? kAsciiWords :
+                               corpus == Corpus::CJK ? kCjkWords :
+                               corpus == Corpus::MIXED ? kMixedWords : kEmojiWords;
+    const bool spaced = corpus != Corpus::CJK;
+    const char* sentence_end = spaced ? ". " : "。";
+
+    Lcg rng(0x1eaf5eedu + static_cast<uint32_t>(corpus));
+    std::string text;
+    text.reserve(size_bytes + 64);
+    while (text.size() < size_bytes) {
+        uint32_t sentences = 2 + rng.next(5);
+        for (uint32_t s = 0; s < sentences && text.size() < size_bytes; ++s) {
+            uint32_t count = 6 + rng.next(15);
+            for (uint32_t w = 0; w < count; ++w) {
+                text += words[rng.next(20)];
+                if (spaced && w + 1 < count) {
+                    text += ' ';
+                }
+            }
+            text += sentence_end;
+        }
+        text += "\n\n";
+    }
+    size_t cut = size_bytes;
+    while (cut > 0 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80) {
+        cut--;
+    }
+    text.resize(cut);
+    return text;
+}
+
+// ==============================================================================
+// Benchmark runner
+// ==============================================================================
+
+struct BenchConfig {
+    const char* name;
+    ChunkingOptions options;
+    bool as_document;                       // chunk_document over ~3 KB pages instead of chunk_text
+};
+
+struct Result {
+    double seconds_per_run = 0.0;
+    size_t chunks = 0;
+    size_t peak_bytes = 0;
+    int runs = 0;
+};
+
+Result run_config(LeafraChunker& chunker, const BenchConfig& config, const std::string& text,
+                  const std::vector<std::string_view>& pages, double min_seconds) {
+    Result result;
+    ChunkingScratch scratch;
+    ChunkedDocument document;
+    std::vector<TextChunk> chunks;
+    double total = 0.0;
+    double best = 0.0;
+
+    // Keep running until min_seconds have been measured (at least two runs; the first warms the scratch)
+    for (int run = 0; run < 2 || total < min_seconds; ++run) {
+        size_t baseline = g_current_bytes.load();
+        g_peak_bytes.store(baseline);
+        auto start = std::chrono::steady_clock::now();
+
+        ResultCode code = config.as_document
+            ? chunker.chunk_document(pages, config.options, document, scratch)
+            : chunker.chunk_text(text, config.options, chunks);
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (code != ResultCode::SUCCESS) {
+            std::cerr << "❌ " << config.name << " failed with code " << static_cast<int>(code) << std::endl;
+            return result;
+        }
+        result.peak_bytes = std::max(result.peak_bytes, g_peak_bytes.load() - baseline);
+        result.chunks = config.as_document ? document.chunks.size() : chunks.size();
+        if (run > 0) {
+            total += elapsed;
+            best = result.runs == 0 ? elapsed : std::min(best, elapsed);
+            result.runs++;
+        }
+    }
+    result.seconds_per_run = best;
+    return result;
+}
+
+std::string format_size(size_t bytes) {
+    if (bytes >= 1024 * 1024) return std::to_string(bytes / (1024 * 1024)) + " MB";
+    if (bytes >= 1024) return std::to_string(bytes / 1024) + " KB";
+    return std::to_string(bytes) + " B";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t max_mb = 10;
+    double min_seconds = 0.5;
+    bool csv = false;
+    std::vector<Corpus> corpora = {Corpus::ASCII, Corpus::CJK, Corpus::MIXED, Corpus::EMOJI};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--max-mb" && i + 1 < argc) {
+            max_mb = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--min-seconds" && i + 1 < argc) {
+            min_seconds = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--corpus" && i + 1 < argc) {
+            std::string name = argv[++i];
+            corpora.clear();
+            for (Corpus corpus : {Corpus::ASCII, Corpus::CJK, Corpus::MIXED, Corpus::EMOJI}) {
+                if (name == corpus_name(corpus)) corpora.push_back(corpus);
+            }
+        } else if (arg == "--csv") {
+            csv = true;
+        } else {
+            std::cout << "Usage: " << argv[0] << " [--max-mb N] [--min-seconds S] [--corpus ascii|cjk|mixed|emoji] [--csv]" << std::endl;
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    LeafraChunker chunker;
+    if (chunker.initialize() != ResultCode::SUCCESS) {
+        std::cerr << "❌ Chunker initialization failed" << std::endl;
+        return 1;
+    }
+
+    std::vector<BenchConfig> configs;
+    configs.push_back({"text/tokens-500", ChunkingOptions(500, 0.15, ChunkSizeUnit::TOKENS), false});
+    configs.push_back({"text/chars-1000", ChunkingOptions(1000, 0.15, ChunkSizeUnit::CHARACTERS), false});
+    ChunkingOptions sentence_options(500, 0.15, ChunkSizeUnit::TOKENS);
+    sentence_options.strategy = ChunkingStrategy::SENTENCE;
+    configs.push_back({"text/sentence-500", sentence_options, false});
+    configs.push_back({"document/tokens-500", ChunkingOptions(500, 0.15, ChunkSizeUnit::TOKENS), true});
+
+    const size_t sizes[] = {1024, 64 * 1024, 1024 * 1024, 10 * 1024 * 1024, 100 * 1024 * 1024};
+
+    if (csv) {
+        std::cout << "corpus,size_bytes,config,mb_per_s,chunks_per_s,chunks,peak_bytes,runs" << std::endl;
+    } else {
+        std::cout << "=== LeafraChunker Benchmark ===" << std::endl;
+        std::cout << std::left << std::setw(7) << "corpus" << std::setw(8) << "size" << std::setw(22) << "config"
+                  << std::right << std::setw(10) << "MB/s" << std::setw(13) << "chunks/s"
+                  << std::setw(9) << "chunks" << std::setw(12) << "peak heap" << std::endl;
+    }
+
+    for (Corpus corpus : corpora) {
+        for (size_t size : sizes) {
+            if (size > max_mb * 1024 * 1024) {
+                continue;
+            }
+            std::string text = generate_corpus(corpus, size);
+            std::vector<std::string_view> pages;
+            for (size_t pos = 0; pos < text.size();) {
+                size_t end = std::min(text.size(), pos + 3000);
+                while (end < text.size() && (static_cast<unsigned char>(text[end]) & 0xC0) == 0x80) {
+                    end++;
+                }
+                pages.emplace_back(text.data() + pos, end - pos);
+                pos = end;
+            }
+
+            for (const BenchConfig& config : configs) {
+                Result result = run_config(chunker, config, text, pages, min_seconds);
+                if (result.runs == 0) {
+                    return 1;
+                }
+                double mb_per_s = static_cast<double>(text.size()) / (1024.0 * 1024.0) / result.seconds_per_run;
+                double chunks_per_s = static_cast<double>(result.chunks) / result.seconds_per_run;
+                if (csv) {
+                    std::cout << corpus_name(corpus) << "," << text.size() << "," << config.name << ","
+                              << mb_per_s << "," << chunks_per_s << "," << result.chunks << ","
+                              << result.peak_bytes << "," << result.runs << std::endl;
+                } else {
+                    std::cout << std::left << std::setw(7) << corpus_name(corpus) << std::setw(8) << format_size(size)
+                              << std::setw(22) << config.name << std::right << std::fixed << std::setprecision(1)
+                              << std::setw(10) << mb_per_s << std::setw(13) << std::setprecision(0) << chunks_per_s
+                              << std::setw(9) << result.chunks << std::setw(12) << format_size(result.peak_bytes)
+                              << std::endl;
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -1,11 +1,14 @@
 #include "../../../include/leafra/leafra_chunker.h"
 #include "../../../include/leafra/leafra_debug.h"
 #include <iostream>
+#include <cctype>
 #include <cassert>
 #include <vector>
 #include <string>
 #include <sstream>
 #include <functional>
+#include <thread>
+#include <algorithm>
 
 using namespace leafra;
 
@@ -653,6 +656,329 @@ bool test_chunk_token_ids_storage() {
     return true;
 }
 
+// Test 21b: Exact token chunking with a tokenizer callback
+bool test_exact_token_chunking() {
+    LeafraChunker chunker;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, chunker.initialize(), "Chunker initialization failed");
+    
+    // Every word (with its leading space, SentencePiece style) is one token, ID = its byte offset
+    ChunkingOptions options(8, 0.25, ChunkSizeUnit::EXACT_TOKENS);
+    options.tokenizer = [](const std::string& text, std::vector<int>& ids, TokenOffsets& offsets) {
+        ids.clear();
+        offsets.clear();
+        size_t pos = 0;
+        while (pos < text.length()) {
+            size_t begin = pos;
+            while (pos < text.length() && std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+            while (pos < text.length() && !std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+            ids.push_back(static_cast<int>(begin));
+            offsets.emplace_back(begin, pos);
+        }
+        return true;
+    };
+    
+    std::string text = "One two three four five six. Seven eight nine ten eleven twelve. Thirteen fourteen fifteen sixteen.";
+    std::vector<TextChunk> chunks;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, chunker.chunk_text(text, options, chunks), "Exact token chunking failed");
+    TEST_ASSERT(chunks.size() > 1, "Text should span several chunks");
+    
+    for (const auto& chunk : chunks) {
+        TEST_ASSERT(chunk.has_token_ids(), "Chunks should carry the document's token IDs");
+        TEST_ASSERT(chunk.token_ids.size() <= options.chunk_size, "Chunk should not exceed the token budget");
+        TEST_ASSERT_EQUAL(chunk.token_ids.size(), chunk.estimated_tokens, "Token count should be exact");
+        TEST_ASSERT(chunk.start_index >= static_cast<size_t>(chunk.token_ids.front()), "Chunk should start at its first token");
+    }
+    TEST_ASSERT(chunks[0].content == "One two three four five six.", "First chunk should end at the sentence boundary");
+    
+    // Missing tokenizer is a parameter error
+    options.tokenizer = nullptr;
+    TEST_ASSERT_RESULT_CODE(ResultCode::ERROR_INVALID_PARAMETER, chunker.chunk_text(text, options, chunks),
+                            "EXACT_TOKENS without a tokenizer should fail");
+    return true;
+}
+
+// Test 21c: Reentrant chunking into caller-owned results
+bool test_reentrant_chunking() {
+    LeafraChunker chunker;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, chunker.initialize(), "Chunker initialization failed");
+    const LeafraChunker& shared = chunker;
+    ChunkingOptions options(20, 0.1, ChunkSizeUnit::TOKENS);
+    
+    std::vector<std::string> pages_a = {"Alpha page one has some words in it.", "Alpha page two has more words."};
+    std::vector<std::string> pages_b = {"Beta document with a single page of text."};
+    
+    // Results own their text, so earlier chunks survive later calls with the same scratch
+    ChunkingScratch scratch;
+    ChunkedDocument doc_a, doc_b;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, shared.chunk_document(pages_a, options, doc_a, scratch), "First document failed");
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, shared.chunk_document(pages_b, options, doc_b, scratch), "Second document failed");
+    TEST_ASSERT(doc_a.owns_text(), "Joined pages should be owned by the result");
+    TEST_ASSERT(!doc_a.chunks.empty() && doc_a.chunks[0].content.substr(0, 5) == "Alpha", "First result should be intact");
+    TEST_ASSERT(doc_a.page_starts().size() == 2 && doc_a.page_starts()[0] == 0 &&
+                doc_a.text().substr(doc_a.page_starts()[1], pages_a[1].size()) == pages_a[1],
+                "Page starts should locate each page in the joined text");
+    
+    // Moving a result keeps its chunk views valid
+    ChunkedDocument moved = std::move(doc_b);
+    TEST_ASSERT(!moved.chunks.empty() && moved.chunks[0].content.substr(0, 4) == "Beta", "Moved result should be intact");
+    
+    // chunk_text borrows the caller's string
+    std::string text = "Borrowed text is chunked in place.";
+    ChunkedDocument borrowed;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, shared.chunk_text(text, options, borrowed, scratch), "chunk_text failed");
+    TEST_ASSERT(!borrowed.owns_text(), "Single text should be borrowed");
+    TEST_ASSERT(borrowed.chunks[0].content.data() >= text.data() &&
+                borrowed.chunks[0].content.data() < text.data() + text.size(), "Chunks should view the caller's text");
+    
+    // One chunker, several threads, one scratch each
+    std::vector<size_t> counts(4, 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < counts.size(); ++t) {
+        threads.emplace_back([&, t]() {
+            ChunkingScratch thread_scratch;
+            ChunkedDocument result;
+            for (int i = 0; i < 50; ++i) {
+                if (shared.chunk_document(pages_a, options, result, thread_scratch) == ResultCode::SUCCESS) {
+                    counts[t] = result.chunks.size();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t count : counts) {
+        TEST_ASSERT_EQUAL(doc_a.chunks.size(), count, "Every thread should get the same chunks");
+    }
+    return true;
+}
+
+bool test_page_range_lookup() {
+    LeafraChunker chunker;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, chunker.initialize(), "Chunker initialization failed");
+    
+    // Short pages and large chunks, so most chunks cross at least one page break
+    std::vector<std::string> storage;
+    for (int i = 0; i < 40; ++i) {
+        storage.push_back("Page " + std::to_string(i) + " holds a few words of text.");
+    }
+    std::vector<std::string_view> pages(storage.begin(), storage.end());
+    
+    ChunkingScratch scratch;
+    ChunkedDocument doc;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS,
+                            chunker.chunk_document(pages, ChunkingOptions(30, 0.2, ChunkSizeUnit::TOKENS), doc, scratch),
+                            "Page view chunking failed");
+    TEST_ASSERT(doc.chunks.size() > 1, "Should produce several chunks");
+    
+    // Recompute each chunk's pages from the joined text
+    std::vector<size_t> page_starts;
+    size_t offset = 0;
+    for (const auto& page : storage) {
+        page_starts.push_back(offset);
+        offset += page.size() + 2;
+    }
+    auto page_of = [&](size_t pos) {
+        size_t page = 0;
+        while (page + 1 < page_starts.size() && page_starts[page + 1] <= pos) ++page;
+        return page;
+    };
+    
+    bool found_span = false;
+    for (const auto& chunk : doc.chunks) {
+        size_t content_end = static_cast<size_t>(chunk.content.data() - doc.text().data()) + chunk.content.size();
+        TEST_ASSERT_EQUAL(page_of(chunk.start_index), chunk.page_number, "Start page should match");
+        TEST_ASSERT_EQUAL(page_of(content_end - 1), chunk.end_page_number, "End page should match");
+        found_span = found_span || chunk.end_page_number > chunk.page_number;
+    }
+    TEST_ASSERT(found_span, "Some chunk should span a page break");
+    
+    // A single page never spans
+    std::vector<std::string_view> single = {pages[0]};
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS,
+                            chunker.chunk_document(single, ChunkingOptions(30, 0.2, ChunkSizeUnit::TOKENS), doc, scratch),
+                            "Single page chunking failed");
+    TEST_ASSERT(!doc.chunks.empty() && doc.chunks[0].end_page_number == 0, "Single page should stay on page 0");
+    return true;
+}
+
+bool test_streaming_chunking() {
+    LeafraChunker chunker;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, chunker.initialize(), "Chunker initialization failed");
+    ChunkingOptions options(40, 0.15, ChunkSizeUnit::TOKENS);
+    
+    // Uniform text, so the density sampled from the head matches the whole document
+    std::vector<std::string> pages;
+    for (int i = 0; i < 200; ++i) {
+        pages.push_back("Streaming page text flows into the chunker one page at a time, "
+                        "and settled chunks leave before the rest of the document arrives.");
+    }
+    
+    std::vector<TextChunk> expected;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, chunker.chunk_document(pages, options, expected), "Batch chunking failed");
+    
+    std::vector<std::string> contents;
+    std::vector<TextChunk> streamed;
+    size_t max_buffered = 0;
+    StreamingChunker stream(chunker, options, [&](TextChunk& chunk) {
+        contents.emplace_back(chunk.content);
+        streamed.push_back(chunk);
+        return true;
+    });
+    for (const auto& page : pages) {
+        TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, stream.add_page(page), "add_page failed");
+        max_buffered = std::max(max_buffered, stream.buffered_bytes());
+    }
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, stream.finish(), "finish failed");
+    
+    TEST_ASSERT_EQUAL(expected.size(), streamed.size(), "Streaming should produce the same chunks");
+    for (size_t i = 0; i < expected.size(); ++i) {
+        TEST_ASSERT(contents[i] == expected[i].content, "Chunk content should match");
+        TEST_ASSERT_EQUAL(expected[i].start_index, streamed[i].start_index, "Chunk start should match");
+        TEST_ASSERT_EQUAL(expected[i].page_number, streamed[i].page_number, "Chunk page should match");
+        TEST_ASSERT_EQUAL(expected[i].end_page_number, streamed[i].end_page_number, "Chunk end page should match");
+    }
+    TEST_ASSERT(max_buffered < 16 * 1024, "Only a window of the document should stay buffered");
+    
+    // A sink returning false stops the stream
+    size_t received = 0;
+    StreamingChunker stopped(chunker, options, [&](TextChunk&) { return ++received < 3; });
+    ResultCode result = ResultCode::SUCCESS;
+    for (size_t i = 0; i < pages.size() && result == ResultCode::SUCCESS; ++i) {
+        result = stopped.add_page(pages[i]);
+    }
+    TEST_ASSERT_RESULT_CODE(ResultCode::ERROR_CANCELLED, result, "Sink should cancel the stream");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(3), received, "No chunks after cancelling");
+    
+    // EXACT_TOKENS needs the whole document and is rejected
+    ChunkingOptions exact(40, 0.1, ChunkSizeUnit::EXACT_TOKENS);
+    StreamingChunker rejected(chunker, exact, [](TextChunk&) { return true; });
+    TEST_ASSERT_RESULT_CODE(ResultCode::ERROR_INVALID_PARAMETER, rejected.add_page("text"), "EXACT_TOKENS should be rejected");
+    return true;
+}
+
+bool test_parallel_chunking() {
+    LeafraChunker chunker;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, chunker.initialize(), "Chunker initialization failed");
+    
+    // Varied words, paragraphs and multi-byte text, so segments start next to multi-byte characters
+    const char* words[] = {"alpha", "be", "gamma", "déjà", "epsilon", "zeta", "über", "theta", "iota", "kappa-lambda"};
+    std::string text;
+    unsigned int seed = 7;
+    for (int i = 0; i < 30000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        text += words[(seed >> 16) % 10];
+        text += ((seed >> 8) % 23 == 0) ? "\n\n" : ((seed >> 8) % 7 == 0 ? ". " : " ");
+    }
+    std::vector<std::string> pages = {text.substr(0, text.size() / 2), text.substr(text.size() / 2)};
+    
+    ChunkingOptions options(50, 0.2, ChunkSizeUnit::TOKENS);
+    std::vector<TextChunk> sequential;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, chunker.chunk_document(pages, options, sequential), "Sequential chunking failed");
+    std::vector<std::string> expected;
+    for (const auto& chunk : sequential) {
+        expected.emplace_back(chunk.content);
+    }
+    
+    std::vector<std::thread> workers;
+    options.submit_task = [&workers](std::function<void()> task) {
+        if (workers.size() >= 3) {
+            return false;
+        }
+        workers.emplace_back(std::move(task));
+        return true;
+    };
+    options.parallel_segment_bytes = 4096;
+    ChunkingScratch scratch;
+    ChunkedDocument parallel;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, chunker.chunk_document(pages, options, parallel, scratch), "Parallel chunking failed");
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    TEST_ASSERT(!workers.empty(), "Large text should be indexed on the workers");
+    
+    TEST_ASSERT_EQUAL(sequential.size(), parallel.chunks.size(), "Parallel chunking should match sequential");
+    for (size_t i = 0; i < sequential.size(); ++i) {
+        TEST_ASSERT_EQUAL(sequential[i].start_index, parallel.chunks[i].start_index, "Chunk start should match");
+        TEST_ASSERT_EQUAL(sequential[i].end_index, parallel.chunks[i].end_index, "Chunk end should match");
+        TEST_ASSERT_EQUAL(sequential[i].page_number, parallel.chunks[i].page_number, "Chunk page should match");
+        TEST_ASSERT(expected[i] == parallel.chunks[i].content, "Chunk content should match");
+    }
+    
+    // A pool that rejects every task leaves all the work to the calling thread
+    options.submit_task = [](std::function<void()>) { return false; };
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, chunker.chunk_document(pages, options, parallel, scratch), "Inline chunking failed");
+    TEST_ASSERT_EQUAL(sequential.size(), parallel.chunks.size(), "Inline segments should match sequential");
+    return true;
+}
+
+bool test_sentence_chunking() {
+    LeafraChunker chunker;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, chunker.initialize(), "Chunker initialization failed");
+    
+    std::string text =
+        "Introduction\n"
+        "The first sentence opens the paper. The second sentence, which wraps\n"
+        "onto a new line, explains the method. A third one closes the paragraph!\n\n"
+        "A second paragraph follows here. It has two sentences.\n\n"
+        "# Results\n"
+        "| Model | Score |\n"
+        "| A | 0.91 |\n"
+        "| B | 0.87 |\n\n"
+        "The results section ends with a remark. ";
+    for (int i = 0; i < 60; ++i) {
+        text += "overlong ";
+    }
+    text += "sentence.\n";
+    
+    ChunkingOptions options(30, 0.0, ChunkSizeUnit::TOKENS);
+    options.strategy = ChunkingStrategy::SENTENCE;
+    std::vector<TextChunk> chunks;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, chunker.chunk_text(text, options, chunks), "Sentence chunking failed");
+    TEST_ASSERT(chunks.size() >= 4, "Text should produce several chunks");
+    
+    bool results_heading_starts_chunk = false;
+    bool table_intact = false;
+    for (const auto& chunk : chunks) {
+        std::string content(chunk.content);
+        TEST_ASSERT(content.find("paper. The second") == std::string::npos || content.find("explains the method.") != std::string::npos,
+                    "Wrapped sentence should stay in one chunk");
+        if (content.find("overlong") == std::string::npos) {
+            char last = content.back();
+            TEST_ASSERT(last == '.' || last == '!' || last == '|' || content == "Introduction",
+                        "Chunks should end at a sentence or row end: " + content);
+            TEST_ASSERT(chunk.estimated_tokens <= options.chunk_size, "Chunk should fit the budget");
+        }
+        if (content.rfind("# Results", 0) == 0) {
+            results_heading_starts_chunk = true;
+            table_intact = content.find("| B | 0.87 |") != std::string::npos;
+        }
+        TEST_ASSERT(content.find("It has two sentences.") == std::string::npos || content.find("# Results") == std::string::npos ||
+                    content.rfind("# Results", 0) == 0, "Headings should begin a chunk");
+    }
+    TEST_ASSERT(results_heading_starts_chunk, "Heading should start a chunk");
+    TEST_ASSERT(table_intact, "A table that fits should stay with its heading");
+    TEST_ASSERT(std::string(chunks.back().content).find("sentence.") != std::string::npos, "Oversized sentence should be split");
+    
+    // Overlap carries whole sentences into the next chunk
+    std::string prose;
+    for (int i = 0; i < 20; ++i) {
+        prose += "Sentence number " + std::to_string(i) + " is short. ";
+    }
+    options.overlap_percentage = 0.3;
+    std::vector<TextChunk> overlapped;
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, chunker.chunk_text(prose, options, overlapped), "Sentence chunking with overlap failed");
+    bool carried = false;
+    for (size_t i = 1; i < overlapped.size(); ++i) {
+        if (overlapped[i].start_index < overlapped[i - 1].end_index) {
+            carried = true;
+            TEST_ASSERT(std::string(overlapped[i].content).rfind("Sentence number", 0) == 0, "Overlap should start at a sentence start");
+        }
+    }
+    TEST_ASSERT(carried, "Overlap should repeat sentences");
+    return true;
+}
+
 // Test 22: Comprehensive UTF-8 International Text Chunking
 bool test_utf8_international_chunking() {
     std::cout << "\n--- Testing UTF-8 International Content Chunking ---" << std::endl;
@@ -849,6 +1175,12 @@ int main(int argc, char* argv[]) {
     RUN_TEST(test_token_chunking_error_handling);
     RUN_TEST(test_approximation_methods_comparison);
     RUN_TEST(test_chunk_token_ids_storage);
+    RUN_TEST(test_exact_token_chunking);
+    RUN_TEST(test_reentrant_chunking);
+    RUN_TEST(test_page_range_lookup);
+    RUN_TEST(test_streaming_chunking);
+    RUN_TEST(test_parallel_chunking);
+    RUN_TEST(test_sentence_chunking);
     RUN_TEST(test_utf8_international_chunking);
     
     // Print results
@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include <cassert>
+#include <cctype>
 #include <algorithm>
 #include <functional>
 #include "../../../include/leafra/leafra_chunker.h"
@@ -303,6 +304,156 @@ void test_utf8_performance() {
     std::cout << "test_utf8_performance COMPLETED\n";
 }
 
+void test_unicode_cacher_positions() {
+    std::cout << "Testing UnicodeCacher position mapping... ";
+    
+    // Long enough to span several checkpoints, mixing 1-4 byte characters
+    std::string text;
+    for (int i = 0; i < 100; ++i) {
+        text += "ab é 中 🌍 ";
+    }
+    UnicodeCacher cacher(text);
+    size_t length = std::count_if(text.begin(), text.end(), [](char c) {
+        return (static_cast<unsigned char>(c) & 0xC0) != 0x80;   // count lead bytes
+    });
+    assert(cacher.get_unicode_length_cached() == length);
+    
+    size_t byte_pos = 0;
+    for (size_t ci = 0; ci < length; ++ci) {
+        assert(cacher.get_byte_pos_for_char_index_cached(ci) == byte_pos);
+        assert(cacher.get_char_index_for_byte_pos_cached(byte_pos) == ci);
+        size_t next_pos;
+        cacher.get_unicode_char_at_cached(byte_pos, next_pos);
+        assert(cacher.get_previous_char_pos_cached(next_pos) == byte_pos);
+        byte_pos = next_pos;
+    }
+    assert(cacher.get_byte_pos_for_char_index_cached(length) == text.length());
+    assert(cacher.get_char_index_for_byte_pos_cached(text.length()) == length);
+    
+    // Reinitializing replaces the cached length instead of adding to it
+    std::string shorter = "abc";
+    cacher.reinitialize(shorter);
+    assert(cacher.get_unicode_length_cached() == 3);
+    assert(cacher.get_byte_pos_for_char_index_cached(2) == 2);
+    
+    // Segmented indexing (run inline here) matches the single pass, including across invalid bytes
+    text.insert(301, "\xE2\x82 \x80\xFF");
+    UnicodeCacher single(text);
+    UnicodeCacher segmented;
+    ParallelFor inline_for = [](size_t count, const std::function<void(size_t)>& body) {
+        for (size_t k = 0; k < count; ++k) body(k);
+    };
+    for (size_t segment_bytes : {7, 64, 300, 1000}) {
+        segmented.reinitialize(text, segment_bytes, inline_for);
+        assert(segmented.get_unicode_length_cached() == single.get_unicode_length_cached());
+        for (size_t ci = 0; ci <= single.get_unicode_length_cached(); ++ci) {
+            assert(segmented.get_byte_pos_for_char_index_cached(ci) == single.get_byte_pos_for_char_index_cached(ci));
+        }
+        for (size_t pos = 0; pos < text.length(); ++pos) {
+            assert(segmented.byte_in_class(UnicodeCacher::ByteClass::WHITESPACE, pos) ==
+                   single.byte_in_class(UnicodeCacher::ByteClass::WHITESPACE, pos));
+            assert(segmented.byte_in_class(UnicodeCacher::ByteClass::WORD, pos) ==
+                   single.byte_in_class(UnicodeCacher::ByteClass::WORD, pos));
+        }
+    }
+    
+    // Byte class bitmaps: every byte of a code point is marked, invalid bytes are in neither class
+    using ByteClass = UnicodeCacher::ByteClass;
+    assert(single.byte_in_class(ByteClass::WORD, 0) && !single.byte_in_class(ByteClass::WHITESPACE, 0));
+    assert(single.byte_in_class(ByteClass::WHITESPACE, 2));
+    assert(single.byte_in_class(ByteClass::WORD, 3) && single.byte_in_class(ByteClass::WORD, 4));   // é
+    assert(!single.byte_in_class(ByteClass::WORD, 305) && !single.byte_in_class(ByteClass::WHITESPACE, 305));
+    
+    // Bit scans agree with a byte-by-byte search in both directions, across 64-byte words
+    for (ByteClass cls : {ByteClass::WHITESPACE, ByteClass::WORD}) {
+        for (bool in_class : {true, false}) {
+            for (size_t from = 0; from < text.length(); from += 3) {
+                size_t limit = std::min(text.length(), from + 150);
+                size_t expected = from;
+                while (expected < limit && single.byte_in_class(cls, expected) != in_class) expected++;
+                assert(single.find_next_byte(cls, in_class, from, limit) == expected);
+                
+                size_t floor = from > 150 ? from - 150 : 0;
+                size_t prev = from;
+                while (prev > floor && single.byte_in_class(cls, prev - 1) != in_class) prev--;
+                size_t expected_prev = prev > floor ? prev - 1 : std::string::npos;
+                assert(single.find_prev_byte(cls, in_class, floor, from) == expected_prev);
+            }
+        }
+    }
+    
+    std::cout << "✓\n";
+}
+
+void test_ascii_scan_kernels() {
+    std::cout << "Testing ASCII scan kernels... ";
+    
+    // Non-ASCII and non-word bytes at every offset, so each lane of the vector paths gets hit
+    std::string text = generate_long_utf8_text() + " plain_ascii_words_0123456789 and MORE text";
+    for (size_t start = 0; start < text.length(); ++start) {
+        size_t expected_ascii = start;
+        while (expected_ascii < text.length() && static_cast<unsigned char>(text[expected_ascii]) < 0x80) {
+            expected_ascii++;
+        }
+        assert(ascii_run_length(text.data() + start, text.length() - start) == expected_ascii - start);
+        
+        size_t expected_word = start;
+        while (expected_word < text.length() && static_cast<unsigned char>(text[expected_word]) < 0x80 &&
+               (std::isalnum(static_cast<unsigned char>(text[expected_word])) || text[expected_word] == '_')) {
+            expected_word++;
+        }
+        assert(ascii_word_run_length(text.data() + start, text.length() - start) == expected_word - start);
+    }
+    
+    // Bulk ASCII counting must agree with the cacher's decoding
+    UnicodeCacher cacher(text);
+    assert(get_unicode_length(text) == cacher.get_unicode_length_cached());
+    for (size_t ci = 0; ci <= cacher.get_unicode_length_cached(); ci += 7) {
+        assert(get_byte_pos_for_char_index(text, ci) == cacher.get_byte_pos_for_char_index_cached(ci));
+    }
+    
+    std::cout << "✓\n";
+}
+
+void test_utf16_transcoder() {
+    std::cout << "Testing UTF-16 to UTF-8 transcoder... ";
+    
+    // Round trip through an independent UTF-8 -> UTF-16 encoder; the prefix loop moves
+    // every non-ASCII character across each lane of the 8-unit ASCII blocks
+    std::string text = generate_long_utf8_text() + " 🚀 tail_ascii_run_longer_than_one_block";
+    std::vector<uint16_t> utf16;
+    size_t pos = 0;
+    while (pos < text.length()) {
+        size_t next = pos;
+        UChar32 cp = get_unicode_char_at(text, pos, next);
+        if (cp >= 0x10000) {
+            utf16.push_back(static_cast<uint16_t>(0xD800 + ((cp - 0x10000) >> 10)));
+            utf16.push_back(static_cast<uint16_t>(0xDC00 + ((cp - 0x10000) & 0x3FF)));
+        } else {
+            utf16.push_back(static_cast<uint16_t>(cp));
+        }
+        pos = next;
+    }
+    std::string out;
+    utf16_to_utf8(utf16.data(), utf16.size(), out);
+    assert(out == text);
+    for (size_t start = 0; start < 16 && start < utf16.size(); ++start) {
+        std::string tail;
+        utf16_to_utf8(utf16.data() + start, utf16.size() - start, tail);
+        assert(text.size() >= tail.size() && text.compare(text.size() - tail.size(), tail.size(), tail) == 0);
+    }
+    
+    // Unpaired surrogates become U+FFFD; a pair split by the buffer end is unpaired too
+    const uint16_t broken[] = {'a', 0xD83D, 'b', 0xDE80, 'c', 0xD83D, 0xDE80, 0xD83D};
+    utf16_to_utf8(broken, sizeof(broken) / sizeof(broken[0]), out);
+    assert(out == "a\xEF\xBF\xBD" "b\xEF\xBF\xBD" "c\xF0\x9F\x9A\x80\xEF\xBF\xBD");
+    
+    utf16_to_utf8(broken, 0, out);
+    assert(out.empty());
+    
+    std::cout << "✓\n";
+}
+
 // Helper function to setup debug based on command line arguments
 bool setup_debug_mode(int argc, char* argv[]) {
     bool debug_enabled = true; // Default: debug enabled
@@ -352,6 +503,15 @@ int main(int argc, char* argv[]) {
          test_utf8_performance();
          std::cout << std::endl;
         
+         test_unicode_cacher_positions();
+         std::cout << std::endl;
+        
+         test_ascii_scan_kernels();
+         std::cout << std::endl;
+        
+         test_utf16_transcoder();
+         std::cout << std::endl;
+        
         std::cout << "✅ All comprehensive UTF-8 tests passed!" << std::endl;
         return 0;
     } catch (const std::exception& e) {
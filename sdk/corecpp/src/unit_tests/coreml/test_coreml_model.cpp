@@ -292,6 +292,63 @@ void test_model_prediction() {
     TEST_END()
 }
 
+// Test batched prediction matches single-sample prediction
+void test_batch_prediction() {
+    TEST_START("test_batch_prediction")
+    
+    CoreMLModel model(MODEL_PATH);
+    
+    // Build a few samples with different real token lengths
+    const size_t batch_count = 4;
+    std::vector<std::vector<std::vector<float>>> batch_inputs;
+    for (size_t b = 0; b < batch_count; ++b) {
+        size_t real_tokens = 16 + b * 32;
+        std::vector<float> input_ids(EXPECTED_INPUT_SIZE, 0.0f);
+        std::vector<float> attention_mask(EXPECTED_INPUT_SIZE, 0.0f);
+        input_ids[0] = 0.0f; // BOS
+        for (size_t i = 1; i < real_tokens - 1; ++i) {
+            input_ids[i] = static_cast<float>(100 + (i * 7 + b) % 1000);
+        }
+        input_ids[real_tokens - 1] = 2.0f; // EOS
+        for (size_t i = 0; i < real_tokens; ++i) {
+            attention_mask[i] = 1.0f;
+        }
+        batch_inputs.push_back({attention_mask, input_ids});
+    }
+    
+    auto batch_outputs = model.predict_batch(batch_inputs);
+    ASSERT_EQ(batch_count, batch_outputs.size());
+    
+    const float tolerance = 1e-4f;
+    for (size_t b = 0; b < batch_count; ++b) {
+        ASSERT_EQ(EXPECTED_OUTPUT_COUNT, batch_outputs[b].size());
+        ASSERT_EQ(EXPECTED_OUTPUT_SIZE, batch_outputs[b][0].size());
+        
+        auto single_outputs = model.predict(batch_inputs[b]);
+        for (size_t i = 0; i < EXPECTED_OUTPUT_SIZE; ++i) {
+            ASSERT_TRUE(std::abs(batch_outputs[b][0][i] - single_outputs[0][i]) < tolerance);
+        }
+    }
+    
+    // Empty batch is a no-op
+    auto empty_outputs = model.predict_batch({});
+    ASSERT_TRUE(empty_outputs.empty());
+    
+    // A malformed sample rejects the whole batch
+    batch_inputs[1][0].resize(EXPECTED_INPUT_SIZE - 1);
+    bool caught_exception = false;
+    try {
+        model.predict_batch(batch_inputs);
+    } catch (const std::runtime_error&) {
+        caught_exception = true;
+    }
+    ASSERT_TRUE(caught_exception);
+    
+    std::cout << "(batch of " << batch_count << " matches single predictions) ";
+    
+    TEST_END()
+}
+
 // Test prediction with pre-allocated outputs
 void test_prediction_with_preallocated_outputs() {
     TEST_START("test_prediction_with_preallocated_outputs")
@@ -335,6 +392,59 @@ void test_prediction_with_preallocated_outputs() {
     TEST_END()
 }
 
+// Test zero-copy prediction over bound buffers matches predict()
+void test_prediction_into_bound_buffers() {
+    TEST_START("test_prediction_into_bound_buffers")
+    
+    CoreMLModel model(MODEL_PATH);
+    
+    std::vector<float> attention_mask(EXPECTED_INPUT_SIZE, 0.0f);
+    std::vector<float> input_ids(EXPECTED_INPUT_SIZE, 0.0f);
+    std::vector<float> result(EXPECTED_OUTPUT_SIZE, 0.0f);
+    std::vector<const float*> inputs = {attention_mask.data(), input_ids.data()};
+    std::vector<size_t> sizes = {EXPECTED_INPUT_SIZE, EXPECTED_INPUT_SIZE};
+    std::vector<float*> outputs = {result.data()};
+    
+    const float tolerance = 1e-4f;
+    for (size_t round = 0; round < 3; ++round) {
+        // New values in the same buffers: the bound MLMultiArrays must see them
+        size_t real_tokens = 8 + round * 40;
+        std::fill(attention_mask.begin(), attention_mask.end(), 0.0f);
+        std::fill(input_ids.begin(), input_ids.end(), 0.0f);
+        for (size_t i = 0; i < real_tokens; ++i) {
+            attention_mask[i] = 1.0f;
+            input_ids[i] = static_cast<float>(i == 0 ? 0 : (i == real_tokens - 1 ? 2 : 100 + (i * 13 + round) % 1000));
+        }
+        
+        ASSERT_TRUE(model.predict_into(inputs, sizes, outputs));
+        auto expected = model.predict({attention_mask, input_ids});
+        for (size_t i = 0; i < EXPECTED_OUTPUT_SIZE; ++i) {
+            ASSERT_TRUE(std::abs(result[i] - expected[0][i]) < tolerance);
+        }
+    }
+    
+    // Native int32 ids / mask give the same embedding, converted only if the model isn't an Int32 export
+    std::vector<int32_t> int_mask(attention_mask.begin(), attention_mask.end());
+    std::vector<int32_t> int_ids(input_ids.begin(), input_ids.end());
+    std::vector<uint16_t> half_result(EXPECTED_OUTPUT_SIZE, 0);
+    std::vector<CoreMLModel::InputBuffer> typed_inputs = {
+        {int_mask.data(), EXPECTED_INPUT_SIZE, CoreMLModel::DataType::Int32},
+        {int_ids.data(), EXPECTED_INPUT_SIZE, CoreMLModel::DataType::Int32}
+    };
+    std::vector<CoreMLModel::OutputBuffer> typed_outputs = {{half_result.data(), CoreMLModel::DataType::Float16}};
+    ASSERT_TRUE(model.predict_into(typed_inputs, typed_outputs));
+    ASSERT_TRUE(half_result[0] != 0 || half_result[1] != 0);
+    ASSERT_EQ(2u, CoreMLModel::getDataTypeSize(CoreMLModel::DataType::Float16));
+    
+    // Wrong sizes and counts are rejected
+    ASSERT_TRUE(!model.predict_into(inputs, {EXPECTED_INPUT_SIZE - 1, EXPECTED_INPUT_SIZE}, outputs));
+    ASSERT_TRUE(!model.predict_into({attention_mask.data()}, {EXPECTED_INPUT_SIZE}, outputs));
+    
+    std::cout << "(bound buffers match copied prediction) ";
+    
+    TEST_END()
+}
+
 // Test prediction error handling
 void test_prediction_error_handling() {
     TEST_START("test_prediction_error_handling")
@@ -555,7 +665,9 @@ int main() {
     test_introspection_edge_cases();
     test_batch_introspection();
     test_model_prediction();
+    test_batch_prediction();
     test_prediction_with_preallocated_outputs();
+    test_prediction_into_bound_buffers();
     test_prediction_error_handling();
     test_prediction_performance();
     test_metadata_caching_performance();
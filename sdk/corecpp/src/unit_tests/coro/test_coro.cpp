@@ -0,0 +1,147 @@
+#include "../../../include/leafra/leafra_coro.h"
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+static co::task<int> answer() {
+    co_return 21;
+}
+
+static co::task<int> doubled() {
+    int value = co_await answer();
+    co_return value * 2;
+}
+
+static co::task<int> failing() {
+    throw std::runtime_error("boom");
+    co_return 0;
+}
+
+// Collects every token of a stream, then reports the stream's result
+static co::task<std::string> collect(co::token_stream& stream) {
+    std::string text;
+    while (std::optional<std::string> token = co_await stream.next()) {
+        text += *token;
+    }
+    co_return text;
+}
+
+bool test_task_chain() {
+    TEST_ASSERT_EQUAL(42, co::sync_wait(doubled()), "Awaited task should feed the awaiting one");
+    return true;
+}
+
+bool test_task_exception() {
+    bool thrown = false;
+    try {
+        co::sync_wait(failing());
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    TEST_ASSERT(thrown, "Exception should propagate to the awaiter");
+    return true;
+}
+
+bool test_stream_from_other_thread() {
+    std::pair<co::token_stream, co::token_stream::producer> created = co::token_stream::create();
+    co::token_stream::producer feed = created.second;
+    std::thread producer([feed]() {
+        for (const char* token : {"Hello", ", ", "world"}) {
+            feed.push(token);
+        }
+        feed.finish(ResultCode::SUCCESS, {});
+    });
+    std::string text = co::sync_wait(collect(created.first));
+    producer.join();
+
+    TEST_ASSERT_EQUAL(std::string("Hello, world"), text, "Every token should arrive in order");
+    TEST_ASSERT(created.first.result() == ResultCode::SUCCESS, "Result should be reported");
+    TEST_ASSERT(!feed.push("late"), "Push after finish should be refused");
+    return true;
+}
+
+bool test_buffered_tokens_and_result() {
+    std::pair<co::token_stream, co::token_stream::producer> created = co::token_stream::create();
+    TEST_ASSERT(created.second.push("a"), "Push before the consumer waits should be buffered");
+    TEST_ASSERT(created.second.push("b"), "Second push should be buffered");
+    created.second.finish(ResultCode::ERROR_BUSY, {});
+
+    std::string text = co::sync_wait(collect(created.first));
+    TEST_ASSERT_EQUAL(std::string("ab"), text, "Buffered tokens should be delivered before the end");
+    TEST_ASSERT(created.first.result() == ResultCode::ERROR_BUSY, "Failure result should be reported");
+    return true;
+}
+
+bool test_dropped_stream_stops_producer() {
+    co::token_stream::producer feed = [] {
+        std::pair<co::token_stream, co::token_stream::producer> created = co::token_stream::create();
+        return created.second;
+    }();
+    TEST_ASSERT(!feed.push("ignored"), "Push to a dropped stream should ask the producer to stop");
+    feed.finish(ResultCode::SUCCESS, {});
+    return true;
+}
+
+int main() {
+    std::cout << "=== Coroutine API Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_task_chain);
+    RUN_TEST(test_task_exception);
+    RUN_TEST(test_stream_from_other_thread);
+    RUN_TEST(test_buffered_tokens_and_result);
+    RUN_TEST(test_dropped_stream_stops_producer);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
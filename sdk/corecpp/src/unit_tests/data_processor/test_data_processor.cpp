@@ -0,0 +1,228 @@
+#include "../../../include/leafra/data_processor.h"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+static data_buffer_t random_bytes(size_t size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    data_buffer_t bytes(size);
+    for (byte_t& byte : bytes) {
+        byte = static_cast<byte_t>(rng());
+    }
+    return bytes;
+}
+
+// What each algorithm did before the SIMD kernels
+static data_buffer_t reference(const data_buffer_t& input, const ProcessingOptions& options) {
+    data_buffer_t output;
+    byte_t sum = 0;
+    switch (options.algorithm) {
+        case ProcessingAlgorithm::SIMPLE_TRANSFORM:
+            for (byte_t byte : input) {
+                output.push_back(static_cast<byte_t>((byte + 1) % 256));
+            }
+            break;
+        case ProcessingAlgorithm::REVERSE:
+            output.assign(input.rbegin(), input.rend());
+            break;
+        case ProcessingAlgorithm::ACCUMULATE:
+            for (byte_t byte : input) {
+                sum = static_cast<byte_t>((sum + byte) % 256);
+                output.push_back(sum);
+            }
+            break;
+        case ProcessingAlgorithm::FILTER:
+            for (byte_t byte : input) {
+                if (byte >= options.threshold) {
+                    output.push_back(byte);
+                }
+            }
+            break;
+    }
+    return output;
+}
+
+static const ProcessingAlgorithm kAlgorithms[] = {ProcessingAlgorithm::SIMPLE_TRANSFORM, ProcessingAlgorithm::REVERSE,
+                                                  ProcessingAlgorithm::ACCUMULATE, ProcessingAlgorithm::FILTER};
+
+bool test_kernels_match_reference() {
+    DataProcessor processor;
+    data_buffer_t output;
+    for (ProcessingAlgorithm algorithm : kAlgorithms) {
+        for (int threshold : {0, 1, 128, 255}) {
+            ProcessingOptions options;
+            options.algorithm = algorithm;
+            options.threshold = static_cast<byte_t>(threshold);
+            // Every tail length around the 8- and 16-byte blocks, then a large buffer
+            for (size_t size : {1, 7, 8, 9, 15, 16, 17, 31, 33, 100, 1000, 65537}) {
+                data_buffer_t input = random_bytes(size, static_cast<uint32_t>(size * 31 + threshold));
+                TEST_ASSERT(processor.process_advanced(input, output, options) == ResultCode::SUCCESS, "Processing succeeds");
+                TEST_ASSERT(output == reference(input, options), "Output matches the reference");
+            }
+        }
+    }
+    // process() is SIMPLE_TRANSFORM
+    data_buffer_t input = random_bytes(300, 7);
+    TEST_ASSERT(processor.process(input, output) == ResultCode::SUCCESS, "process succeeds");
+    TEST_ASSERT(output == reference(input, ProcessingOptions()), "process transforms");
+    TEST_ASSERT(processor.process(data_buffer_t(), output) == ResultCode::ERROR_INVALID_PARAMETER, "Empty input is rejected");
+    return true;
+}
+
+bool test_filter_runs() {
+    // All-kept and all-dropped blocks take the fast paths
+    DataProcessor processor;
+    ProcessingOptions options;
+    options.algorithm = ProcessingAlgorithm::FILTER;
+    options.threshold = 100;
+    data_buffer_t input(64, 200);
+    std::fill(input.begin() + 16, input.begin() + 40, byte_t(3));
+    input[45] = 1;
+    data_buffer_t output;
+    TEST_ASSERT(processor.process_advanced(input, output, options) == ResultCode::SUCCESS, "Filter succeeds");
+    TEST_ASSERT(output == reference(input, options), "Runs are filtered");
+    TEST_ASSERT_EQUAL(size_t(39), output.size(), "Kept byte count");
+    return true;
+}
+
+bool test_in_place_and_spans() {
+    DataProcessor processor;
+    for (ProcessingAlgorithm algorithm : kAlgorithms) {
+        ProcessingOptions options;
+        options.algorithm = algorithm;
+        data_buffer_t input = random_bytes(4099, 11);
+        data_buffer_t data = input;
+        TEST_ASSERT(processor.process_in_place(data, options) == ResultCode::SUCCESS, "In place succeeds");
+        TEST_ASSERT(data == reference(input, options), "In place matches the reference");
+        TEST_ASSERT(data.capacity() >= input.size(), "Capacity is kept");
+
+        data_buffer_t output(input.size());
+        size_t output_size = 0;
+        TEST_ASSERT(processor.process(input.data(), input.size(), output.data(), output_size, options) == ResultCode::SUCCESS, "Span succeeds");
+        output.resize(output_size);
+        TEST_ASSERT(output == reference(input, options), "Span matches the reference");
+    }
+    // Partly overlapping buffers are neither in place nor apart
+    data_buffer_t data = random_bytes(64, 3);
+    size_t output_size = 0;
+    TEST_ASSERT(processor.process(data.data(), 32, data.data() + 8, output_size, ProcessingOptions()) == ResultCode::ERROR_INVALID_PARAMETER,
+                "Overlap is rejected");
+    return true;
+}
+
+bool test_stream_blocks() {
+    data_buffer_t input = random_bytes(10007, 5);
+    for (ProcessingAlgorithm algorithm : {ProcessingAlgorithm::SIMPLE_TRANSFORM, ProcessingAlgorithm::ACCUMULATE, ProcessingAlgorithm::FILTER}) {
+        DataProcessor processor;
+        ProcessingOptions options;
+        options.algorithm = algorithm;
+        options.buffer_size = 333;      // Block edges fall mid-vector
+        size_t position = 0;
+        size_t largest_block = 0;
+        data_buffer_t output;
+        ResultCode result = processor.process_stream(
+            [&](byte_t* data, size_t capacity) {
+                largest_block = std::max(largest_block, capacity);
+                size_t size = std::min(capacity, input.size() - position);
+                std::copy(input.begin() + position, input.begin() + position + size, data);
+                position += size;
+                return size;
+            },
+            [&](const byte_t* data, size_t size) {
+                output.insert(output.end(), data, data + size);
+                return true;
+            },
+            options);
+        TEST_ASSERT(result == ResultCode::SUCCESS, "Stream succeeds");
+        TEST_ASSERT_EQUAL(size_t(333), largest_block, "Blocks are buffer_size bytes");
+        TEST_ASSERT(output == reference(input, options), "Stream matches the reference (ACCUMULATE carries across blocks)");
+        TEST_ASSERT_EQUAL(input.size(), processor.get_processed_count(), "Processed bytes are counted");
+    }
+
+    DataProcessor processor;
+    ProcessingOptions options;
+    options.buffer_size = 0;        // Falls back to the processor's buffer size
+    TEST_ASSERT(processor.set_buffer_size(64) == ResultCode::SUCCESS, "Buffer size set");
+    TEST_ASSERT(processor.set_buffer_size(0) == ResultCode::ERROR_INVALID_PARAMETER, "Zero buffer size is rejected");
+    TEST_ASSERT_EQUAL(size_t(64), processor.get_buffer_size(), "Buffer size kept");
+    size_t blocks = 0;
+    ResultCode result = processor.process_stream(
+        [&](byte_t* data, size_t capacity) {
+            std::fill(data, data + capacity, byte_t(1));
+            return capacity;
+        },
+        [&](const byte_t*, size_t size) {
+            return size == 64 && ++blocks < 3;
+        },
+        options);
+    TEST_ASSERT(result == ResultCode::ERROR_PROCESSING_FAILED, "A writer can stop the stream");
+    TEST_ASSERT_EQUAL(size_t(3), blocks, "Stopped after the third block");
+
+    options.algorithm = ProcessingAlgorithm::REVERSE;
+    TEST_ASSERT(processor.process_stream([](byte_t*, size_t) { return size_t(0); },
+                                         [](const byte_t*, size_t) { return true; }, options) == ResultCode::ERROR_INVALID_PARAMETER,
+                "REVERSE can't stream");
+    return true;
+}
+
+int main() {
+    std::cout << "=== Data Processor Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_kernels_match_reference);
+    RUN_TEST(test_filter_runs);
+    RUN_TEST(test_in_place_and_spans);
+    RUN_TEST(test_stream_blocks);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,408 @@
+#include "../../../include/leafra/leafra_embedding.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <vector>
+#include <string>
+#include <thread>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+// Deterministic backend: embedding = {sum of real tokens, real length, first token, last padded token}
+class FakeBackend : public IEmbeddingBackend {
+public:
+    FakeBackend(size_t sequence_length, size_t max_batch, bool token_based = true)
+        : sequence_length_(sequence_length), max_batch_(max_batch), token_based_(token_based) {}
+
+    std::string getName() const override { return "fake"; }
+    bool isReady() const override { return true; }
+    bool requiresTokenIds() const override { return token_based_; }
+    size_t getSequenceLength() const override { return token_based_ ? sequence_length_ : 0; }
+    std::vector<size_t> getSequenceBuckets() const override { return buckets; }
+    size_t getEmbeddingDimension() const override { return 4; }
+    size_t getMaxBatchSize() const override { return max_batch_; }
+
+    bool embedBatch(const EmbeddingBatch& batch, float* output) override {
+        calls++;
+        inference_thread = std::this_thread::get_id();
+        seen_rows.push_back(batch.rows);
+        if (on_call) {
+            on_call(calls);
+        }
+        largest_batch = std::max(largest_batch, batch.rows);
+        seen_lengths.push_back(batch.sequence_length);
+        if (fail_batches && batch.rows > 1) {
+            return false;
+        }
+        for (size_t row = 0; row < batch.rows; ++row) {
+            float* out = output + row * 4;
+            if (!token_based_) {
+                out[0] = static_cast<float>(batch.texts[row].size());
+                out[1] = 0.0f;
+                out[2] = 0.0f;
+                out[3] = 0.0f;
+                continue;
+            }
+            float sum = 0.0f;
+            size_t mask_count = 0;
+            for (size_t i = 0; i < batch.sequence_length; ++i) {
+                if (batch.row_mask(row)[i]) {
+                    sum += static_cast<float>(batch.row_tokens(row)[i]);
+                    mask_count++;
+                }
+            }
+            out[0] = sum;
+            out[1] = static_cast<float>(mask_count);
+            out[2] = static_cast<float>(batch.row_tokens(row)[0]);
+            out[3] = static_cast<float>(batch.row_tokens(row)[batch.sequence_length - 1]);
+        }
+        return true;
+    }
+
+    size_t calls = 0;
+    size_t largest_batch = 0;
+    bool fail_batches = false;
+    std::vector<size_t> buckets;
+    std::vector<size_t> seen_lengths;
+    std::thread::id inference_thread;
+    std::vector<size_t> seen_rows;
+    std::function<void(size_t call)> on_call;     // Runs at the start of every embedBatch
+
+private:
+    size_t sequence_length_;
+    size_t max_batch_;
+    bool token_based_;
+};
+
+static TextChunk make_chunk(const std::vector<int>& tokens) {
+    TextChunk chunk;
+    chunk.token_ids = tokens;
+    return chunk;
+}
+
+bool test_padding_and_mask() {
+    auto backend = std::make_unique<FakeBackend>(8, 4);
+    EmbeddingScheduler::Options options;
+    options.pad_token = 9;
+    options.normalize = false;
+    EmbeddingScheduler scheduler(std::move(backend), options);
+
+    std::vector<TextChunk> chunks = {make_chunk({1, 2, 3}), make_chunk({1, 1, 1, 1, 1, 1, 1, 1, 1, 1})};
+    size_t embedded = scheduler.embed_chunks(chunks);
+    TEST_ASSERT_EQUAL(static_cast<size_t>(2), embedded, "Both chunks should be embedded");
+
+    TEST_ASSERT_EQUAL(6.0f, chunks[0].embedding[0], "Only real tokens should be masked in");
+    TEST_ASSERT_EQUAL(3.0f, chunks[0].embedding[1], "Mask should cover the real tokens");
+    TEST_ASSERT_EQUAL(9.0f, chunks[0].embedding[3], "Short rows should be padded with pad_token");
+    TEST_ASSERT_EQUAL(8.0f, chunks[1].embedding[1], "Long rows should be trimmed to the sequence length");
+    return true;
+}
+
+bool test_batching_respects_backend_limit() {
+    auto backend = std::make_unique<FakeBackend>(4, 3);
+    FakeBackend* fake = backend.get();
+    EmbeddingScheduler::Options options;
+    options.batch_size = 32;
+    EmbeddingScheduler scheduler(std::move(backend), options);
+
+    TEST_ASSERT_EQUAL(static_cast<size_t>(3), scheduler.get_effective_batch_size(), "Batch size should be clamped to the backend maximum");
+
+    std::vector<TextChunk> chunks;
+    for (int i = 0; i < 7; ++i) {
+        chunks.push_back(make_chunk({i + 1, 2}));
+    }
+    chunks.push_back(TextChunk()); // no tokens - skipped
+
+    size_t embedded = scheduler.embed_chunks(chunks);
+    TEST_ASSERT_EQUAL(static_cast<size_t>(7), embedded, "Chunks with tokens should be embedded");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(3), fake->calls, "7 rows with batch 3 should take 3 calls");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(3), fake->largest_batch, "No call should exceed the batch limit");
+    TEST_ASSERT(!chunks.back().has_embedding(), "Chunk without token IDs should be skipped");
+    return true;
+}
+
+bool test_normalization() {
+    EmbeddingScheduler scheduler(std::make_unique<FakeBackend>(4, 2), EmbeddingScheduler::Options());
+
+    std::vector<TextChunk> chunks = {make_chunk({3, 4})};
+    TEST_ASSERT_EQUAL(static_cast<size_t>(1), scheduler.embed_chunks(chunks), "Chunk should be embedded");
+
+    double norm_sq = 0.0;
+    for (float value : chunks[0].embedding) {
+        norm_sq += value * value;
+    }
+    TEST_ASSERT(std::abs(norm_sq - 1.0) < 1e-5, "Embedding should be L2-normalized");
+    return true;
+}
+
+bool test_batch_failure_falls_back_to_single_rows() {
+    auto backend = std::make_unique<FakeBackend>(4, 4);
+    FakeBackend* fake = backend.get();
+    fake->fail_batches = true;
+    EmbeddingScheduler::Options options;
+    options.normalize = false;
+    EmbeddingScheduler scheduler(std::move(backend), options);
+
+    std::vector<TextChunk> chunks = {make_chunk({1}), make_chunk({2}), make_chunk({3})};
+    size_t embedded = scheduler.embed_chunks(chunks);
+    TEST_ASSERT_EQUAL(static_cast<size_t>(3), embedded, "Rows should be retried individually");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(4), fake->calls, "One failed batch plus three single-row calls");
+    TEST_ASSERT_EQUAL(2.0f, chunks[1].embedding[0], "Retried rows should keep their own embedding");
+    return true;
+}
+
+bool test_embed_tokens() {
+    EmbeddingScheduler::Options options;
+    options.normalize = false;
+    EmbeddingScheduler scheduler(std::make_unique<FakeBackend>(4, 4), options);
+
+    std::vector<float> embedding;
+    TEST_ASSERT(scheduler.embed_tokens({5, 6}, embedding), "Single sequence should embed");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(4), embedding.size(), "Embedding should have backend dimension");
+    TEST_ASSERT_EQUAL(11.0f, embedding[0], "Embedding should reflect the tokens");
+    TEST_ASSERT(!scheduler.embed_tokens({}, embedding), "Empty token list should be rejected");
+    TEST_ASSERT(!scheduler.embed_text("text", embedding), "Text path should be rejected by token backends");
+    return true;
+}
+
+bool test_text_backend() {
+    EmbeddingScheduler::Options options;
+    options.normalize = false;
+    EmbeddingScheduler scheduler(std::make_unique<FakeBackend>(0, 1, false), options);
+
+    std::string text = "hello world";
+    std::vector<TextChunk> chunks(2);
+    chunks[0].content = text;  // chunks[1] has no text
+    TEST_ASSERT_EQUAL(static_cast<size_t>(1), scheduler.embed_chunks(chunks), "Only chunks with text should be embedded");
+    TEST_ASSERT_EQUAL(11.0f, chunks[0].embedding[0], "Text backend should receive the chunk text");
+
+    std::vector<float> embedding;
+    TEST_ASSERT(scheduler.embed_text("query: hi", embedding), "Single text should embed");
+    TEST_ASSERT_EQUAL(9.0f, embedding[0], "Text backend should receive the query text");
+    TEST_ASSERT(!scheduler.embed_tokens({1, 2}, embedding), "Token path should be rejected by text backends");
+    return true;
+}
+
+bool test_skips_embedded_chunks() {
+    auto backend = std::make_unique<FakeBackend>(4, 8);
+    FakeBackend* fake = backend.get();
+    EmbeddingScheduler::Options options;
+    options.normalize = false;
+    EmbeddingScheduler scheduler(std::move(backend), options);
+
+    std::vector<TextChunk> chunks = {make_chunk({1, 2}), make_chunk({3})};
+    chunks[0].embedding = {42.0f};
+    TEST_ASSERT_EQUAL(static_cast<size_t>(1), scheduler.embed_chunks(chunks), "Only chunks without embeddings should be embedded");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(1), fake->calls, "Embedded chunks should not reach the backend");
+    TEST_ASSERT_EQUAL(42.0f, chunks[0].embedding[0], "Existing embeddings should be kept");
+    return true;
+}
+
+bool test_embed_chunk_batch() {
+    auto backend = std::make_unique<FakeBackend>(8, 2);
+    EmbeddingScheduler::Options options;
+    options.normalize = false;
+    EmbeddingScheduler scheduler(std::move(backend), options);
+
+    // Row 1 has no tokens, row 2 already carries a reused embedding
+    std::vector<TextChunk> chunks(4);
+    ChunkBatch batch;
+    batch.tokens.clear();
+    for (const std::vector<int>& row : {std::vector<int>{1, 2, 3}, std::vector<int>{}, std::vector<int>{7}, std::vector<int>{4, 4}}) {
+        batch.tokens.ids.insert(batch.tokens.ids.end(), row.begin(), row.end());
+        batch.tokens.end_sequence();
+    }
+    batch.reset_embeddings(chunks.size(), 4);
+    batch.embedding(2)[0] = 42.0f;
+    batch.embedded[2] = 1;
+
+    TEST_ASSERT_EQUAL(static_cast<size_t>(2), scheduler.embed_chunk_batch(chunks, batch), "Rows with tokens and no embedding should be embedded");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(4), batch.rows(), "Matrix should keep one row per chunk");
+    TEST_ASSERT_EQUAL(6.0f, batch.embedding(0)[0], "Row 0 should be written into its matrix row");
+    TEST_ASSERT_EQUAL(8.0f, batch.embedding(3)[0], "Row 3 should be written into its matrix row");
+    TEST_ASSERT(!batch.has_embedding(1), "Rows without tokens should stay missing");
+    TEST_ASSERT_EQUAL(42.0f, batch.embedding(2)[0], "Reused embeddings should be kept");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(3), batch.embedding_count(), "Embedded rows should be flagged");
+    return true;
+}
+
+bool test_sequence_bucketing() {
+    auto backend = std::make_unique<FakeBackend>(16, 8);
+    FakeBackend* fake = backend.get();
+    fake->buckets = {4, 8, 32};  // 32 exceeds the model length and is ignored
+    EmbeddingScheduler::Options options;
+    options.normalize = false;
+    EmbeddingScheduler scheduler(std::move(backend), options);
+
+    TEST_ASSERT_EQUAL(static_cast<size_t>(4), scheduler.select_sequence_length(3), "Short rows should use the smallest bucket");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(8), scheduler.select_sequence_length(5), "Rows should use the smallest bucket that fits");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(16), scheduler.select_sequence_length(40), "Long rows should use the full length");
+
+    // Interleaved lengths: each bucket is batched separately
+    std::vector<TextChunk> chunks = {make_chunk({1, 2}), make_chunk({1, 1, 1, 1, 1, 1}), make_chunk({3}),
+                                     make_chunk(std::vector<int>(20, 1)), make_chunk({1, 1, 1, 1, 1, 1, 1})};
+    TEST_ASSERT_EQUAL(static_cast<size_t>(5), scheduler.embed_chunks(chunks), "All chunks should be embedded");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(3), fake->calls, "One call per bucket");
+    TEST_ASSERT(fake->seen_lengths == std::vector<size_t>({4, 8, 16}), "Buckets should be padded to their own length");
+    TEST_ASSERT_EQUAL(3.0f, chunks[0].embedding[0], "Embeddings should map back to their chunks");
+    TEST_ASSERT_EQUAL(3.0f, chunks[2].embedding[0], "Embeddings should map back to their chunks");
+    TEST_ASSERT_EQUAL(6.0f, chunks[1].embedding[1], "Mid-length chunk should keep all its tokens");
+    TEST_ASSERT_EQUAL(16.0f, chunks[3].embedding[1], "Overlong chunk should be trimmed to the full length");
+
+    std::vector<float> embedding;
+    TEST_ASSERT(scheduler.embed_tokens({5, 6}, embedding), "Query should embed");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(4), fake->seen_lengths.back(), "Queries should use the smallest bucket");
+    return true;
+}
+
+bool test_pipelined_matches_sequential() {
+    std::vector<std::vector<TextChunk> > results;
+    std::vector<std::thread::id> threads;
+    for (size_t depth : {static_cast<size_t>(1), static_cast<size_t>(2), static_cast<size_t>(3)}) {
+        auto backend = std::make_unique<FakeBackend>(8, 3);
+        FakeBackend* fake = backend.get();
+        EmbeddingScheduler::Options options;
+        options.pipeline_depth = depth;
+        EmbeddingScheduler scheduler(std::move(backend), options);
+
+        std::vector<TextChunk> chunks;
+        for (int i = 0; i < 10; ++i) {
+            chunks.push_back(make_chunk({i + 1, 2 * i + 1, 3}));
+        }
+        TEST_ASSERT_EQUAL(static_cast<size_t>(10), scheduler.embed_chunks(chunks), "Every chunk should be embedded");
+        TEST_ASSERT_EQUAL(static_cast<size_t>(4), fake->calls, "10 rows with batch 3 should take 4 calls");
+        results.push_back(chunks);
+        threads.push_back(fake->inference_thread);
+    }
+
+    TEST_ASSERT(threads[0] == std::this_thread::get_id(), "Depth 1 should run inference on the calling thread");
+    TEST_ASSERT(threads[1] != std::this_thread::get_id(), "Pipelined inference should run on the inference thread");
+    for (size_t run = 1; run < results.size(); ++run) {
+        for (size_t i = 0; i < results[0].size(); ++i) {
+            TEST_ASSERT(results[run][i].embedding == results[0][i].embedding, "Pipelined embeddings should match sequential ones");
+        }
+    }
+    return true;
+}
+
+bool test_pipelined_failure_falls_back_to_single_rows() {
+    auto backend = std::make_unique<FakeBackend>(4, 2);
+    FakeBackend* fake = backend.get();
+    fake->fail_batches = true;
+    EmbeddingScheduler::Options options;
+    options.normalize = false;
+    EmbeddingScheduler scheduler(std::move(backend), options);
+
+    std::vector<TextChunk> chunks = {make_chunk({1}), make_chunk({2}), make_chunk({3}), make_chunk({4}), make_chunk({5})};
+    TEST_ASSERT_EQUAL(static_cast<size_t>(5), scheduler.embed_chunks(chunks), "Failed batches should be retried individually");
+    TEST_ASSERT_EQUAL(static_cast<size_t>(7), fake->calls, "Three batches (two failing) plus four single-row retries");
+    TEST_ASSERT_EQUAL(4.0f, chunks[3].embedding[0], "Retried rows should keep their own embedding");
+    TEST_ASSERT_EQUAL(5.0f, chunks[4].embedding[0], "The single-row batch should succeed in the pipeline");
+    return true;
+}
+
+bool test_queries_preempt_bulk_embedding() {
+    for (size_t depth : {static_cast<size_t>(1), static_cast<size_t>(2)}) {
+        auto backend = std::make_unique<FakeBackend>(4, 2);
+        FakeBackend* fake = backend.get();
+        EmbeddingScheduler::Options options;
+        options.normalize = false;
+        options.pipeline_depth = depth;
+        EmbeddingScheduler scheduler(std::move(backend), options);
+
+        // A query arrives while the second bulk batch runs
+        std::thread query;
+        std::vector<float> query_embedding;
+        bool query_ok = false;
+        fake->on_call = [&](size_t call) {
+            if (call == 2) {
+                query = std::thread([&]() { query_ok = scheduler.embed_tokens({7}, query_embedding); });
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+        };
+
+        std::vector<TextChunk> chunks;
+        for (int i = 0; i < 12; ++i) {
+            chunks.push_back(make_chunk({i + 1, 1}));
+        }
+        size_t embedded = scheduler.embed_chunks(chunks);
+        query.join();
+
+        TEST_ASSERT_EQUAL(static_cast<size_t>(12), embedded, "Bulk embedding should complete after yielding");
+        TEST_ASSERT(query_ok, "Query should embed during bulk embedding");
+        TEST_ASSERT_EQUAL(7.0f, query_embedding[0], "Query should get its own embedding");
+        TEST_ASSERT_EQUAL(static_cast<size_t>(7), fake->calls, "Six bulk batches plus the query");
+        size_t query_call = std::find(fake->seen_rows.begin(), fake->seen_rows.end(), static_cast<size_t>(1)) - fake->seen_rows.begin();
+        TEST_ASSERT(query_call <= depth + 1, "Query should wait for the batches in flight only, not the whole import");
+        TEST_ASSERT_EQUAL(13.0f, chunks[11].embedding[0], "Bulk rows after the query should keep their own embeddings");
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "=== EmbeddingScheduler Tests ===" << std::endl;
+    
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+    
+    RUN_TEST(test_padding_and_mask);
+    RUN_TEST(test_batching_respects_backend_limit);
+    RUN_TEST(test_normalization);
+    RUN_TEST(test_batch_failure_falls_back_to_single_rows);
+    RUN_TEST(test_embed_tokens);
+    RUN_TEST(test_text_backend);
+    RUN_TEST(test_sequence_bucketing);
+    RUN_TEST(test_skips_embedded_chunks);
+    RUN_TEST(test_embed_chunk_batch);
+    RUN_TEST(test_pipelined_matches_sequential);
+    RUN_TEST(test_pipelined_failure_falls_back_to_single_rows);
+    RUN_TEST(test_queries_preempt_bulk_embedding);
+    
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+    
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,213 @@
+#include "../../../include/leafra/leafra_events.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+/**
+ * @brief Handler that can be held inside its callback until released
+ */
+struct GatedHandler {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool open = true;
+    bool entered = false;
+    std::vector<Event> events;
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        open = false;
+    }
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex);
+        open = true;
+        cv.notify_all();
+    }
+    void wait_entered() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return entered; });
+    }
+    void operator()(const Event& event) {
+        std::unique_lock<std::mutex> lock(mutex);
+        entered = true;
+        cv.notify_all();
+        cv.wait(lock, [this] { return open; });
+        events.push_back(event);
+    }
+};
+
+bool test_sync_delivery() {
+    EventDispatcher dispatcher;
+    std::vector<Event> events;
+    std::thread::id delivered_on;
+    dispatcher.set_handler([&](const Event& event) {
+        events.push_back(event);
+        delivered_on = std::this_thread::get_id();
+    });
+    dispatcher.post(EventType::DOCUMENT_STORED, "stored", "/docs/a.txt");
+    TEST_ASSERT(!dispatcher.is_async(), "Synchronous by default");
+    TEST_ASSERT_EQUAL(size_t(1), events.size(), "Delivered before post returns");
+    TEST_ASSERT(delivered_on == std::this_thread::get_id(), "Delivered on the posting thread");
+    TEST_ASSERT(events[0].type == EventType::DOCUMENT_STORED, "Event type");
+    TEST_ASSERT_EQUAL(std::string("stored"), events[0].message, "Event message");
+    TEST_ASSERT_EQUAL(std::string("/docs/a.txt"), events[0].file_path, "Event file path");
+    TEST_ASSERT(events[0].timestamp > 0, "Event timestamp");
+
+    // A handler that raises another event (as an SDK call from a callback would) doesn't deadlock
+    dispatcher.set_handler([&](const Event& event) {
+        events.push_back(event);
+        if (event.type == EventType::CUSTOM_EVENT) {
+            dispatcher.post(EventType::WARNING, "nested");
+        }
+    });
+    dispatcher.post(EventType::CUSTOM_EVENT, "outer");
+    TEST_ASSERT_EQUAL(size_t(3), events.size(), "Nested event delivered");
+    return true;
+}
+
+bool test_async_order_and_flush() {
+    EventDispatcher dispatcher;
+    std::vector<std::string> messages;
+    std::atomic<bool> on_other_thread{true};
+    std::thread::id main_thread = std::this_thread::get_id();
+    dispatcher.set_handler([&](const Event& event) {
+        if (std::this_thread::get_id() == main_thread) {
+            on_other_thread = false;
+        }
+        messages.push_back(event.message);
+    });
+    dispatcher.configure(true, 8, false);
+    TEST_ASSERT(dispatcher.is_async(), "Async after configure");
+    for (int i = 0; i < 500; ++i) {
+        dispatcher.post(EventType::DOCUMENT_STORED, std::to_string(i));
+    }
+    dispatcher.flush();
+    TEST_ASSERT_EQUAL(size_t(500), messages.size(), "Non-progress events are never dropped");
+    for (int i = 0; i < 500; ++i) {
+        TEST_ASSERT_EQUAL(std::to_string(i), messages[i], "Posting order preserved");
+    }
+    TEST_ASSERT(on_other_thread, "Delivered on the dispatcher thread");
+
+    dispatcher.configure(false, 0, false);
+    TEST_ASSERT(!dispatcher.is_async(), "Back to synchronous delivery");
+    dispatcher.post(EventType::WARNING, "inline");
+    TEST_ASSERT_EQUAL(std::string("inline"), messages.back(), "Synchronous after switching back");
+    return true;
+}
+
+bool test_slow_consumer_does_not_block_progress() {
+    EventDispatcher dispatcher;
+    GatedHandler handler;
+    dispatcher.set_handler([&handler](const Event& event) { handler(event); });
+    dispatcher.configure(true, 4, true);
+
+    handler.close();
+    dispatcher.post(EventType::INGESTION_STARTED, "started");
+    handler.wait_entered();  // The dispatcher is now stuck inside the handler
+
+    // Progress events coalesce into the queue tail and never wait for the consumer
+    for (int i = 0; i < 100; ++i) {
+        dispatcher.post(EventType::INGESTION_PROGRESS, "progress " + std::to_string(i));
+    }
+    dispatcher.post(EventType::DOCUMENT_STORED, "stored a");
+    dispatcher.post(EventType::INGESTION_PROGRESS, "progress a");
+    dispatcher.post(EventType::DOCUMENT_STORED, "stored b");
+    dispatcher.post(EventType::INGESTION_PROGRESS, "dropped");  // Queue of 4 is full
+    TEST_ASSERT_EQUAL(uint64_t(99), dispatcher.coalesced_count(), "Progress events coalesced");
+    TEST_ASSERT_EQUAL(uint64_t(1), dispatcher.dropped_count(), "Progress event dropped when full");
+
+    handler.release();
+    dispatcher.flush();
+    std::vector<std::string> expected = {"started", "progress 99", "stored a", "progress a", "stored b"};
+    TEST_ASSERT_EQUAL(expected.size(), handler.events.size(), "Delivered events");
+    for (size_t i = 0; i < expected.size(); ++i) {
+        TEST_ASSERT_EQUAL(expected[i], handler.events[i].message, "Delivered in order, latest progress kept");
+    }
+    return true;
+}
+
+bool test_shutdown_delivers_queued_events() {
+    std::vector<std::string> messages;
+    {
+        EventDispatcher dispatcher;
+        dispatcher.set_handler([&messages](const Event& event) {
+            if (event.message == "throws") {
+                throw std::runtime_error("handler failure");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            messages.push_back(event.message);
+        });
+        dispatcher.configure(true, 64, false);
+        dispatcher.post(EventType::CUSTOM_EVENT, "throws");
+        for (int i = 0; i < 20; ++i) {
+            dispatcher.post(EventType::CUSTOM_EVENT, std::to_string(i));
+        }
+    }
+    TEST_ASSERT_EQUAL(size_t(20), messages.size(), "Destructor delivers what was queued; a throwing handler is survived");
+    return true;
+}
+
+int main() {
+    std::cout << "=== Event Dispatcher Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_sync_delivery);
+    RUN_TEST(test_async_order_and_flush);
+    RUN_TEST(test_slow_consumer_does_not_block_progress);
+    RUN_TEST(test_shutdown_delivers_queued_events);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
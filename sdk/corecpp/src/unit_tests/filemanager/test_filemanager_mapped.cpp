@@ -0,0 +1,148 @@
+#include "../../../include/leafra/leafra_filemanager.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+
+using namespace leafra;
+namespace fs = std::filesystem;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+// File under the system temp directory, removed when the test ends
+class TempFile {
+public:
+    TempFile(const std::string& name, const std::string& contents)
+        : path_((fs::temp_directory_path() / ("leafra_mapped_" + name)).string()) {
+        std::ofstream out(path_, std::ios::binary);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+    ~TempFile() {
+        std::error_code ec;
+        fs::remove(path_, ec);
+    }
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+bool test_maps_file_contents() {
+    std::string contents;
+    for (int i = 0; i < 10000; ++i) {
+        contents += "line " + std::to_string(i) + "\n";
+    }
+    TempFile file("contents.txt", contents);
+
+    FileManager::MappedFile mapped = FileManager::mapFile(file.path(), FileManager::AccessHint::Sequential);
+    TEST_ASSERT(mapped.isOpen(), "File should open");
+    TEST_ASSERT(mapped.size() == contents.size(), "Size should match the file");
+    TEST_ASSERT(mapped.view() == contents, "View should match the file contents");
+
+    FileManager::MappedFile random = FileManager::mapFile(file.path(), FileManager::AccessHint::Random);
+    TEST_ASSERT(random.isOpen() && random.view() == contents, "Random access hint maps the same bytes");
+    return true;
+}
+
+bool test_empty_file() {
+    TempFile file("empty.txt", "");
+
+    FileManager::MappedFile mapped = FileManager::mapFile(file.path());
+    TEST_ASSERT(mapped.isOpen(), "Empty file should open");
+    TEST_ASSERT(mapped.size() == 0, "Empty file maps to an empty view");
+    TEST_ASSERT(mapped.view().empty(), "View should be empty");
+    return true;
+}
+
+bool test_missing_file() {
+    std::string missing = (fs::temp_directory_path() / "leafra_mapped_does_not_exist.txt").string();
+
+    FileManager::MappedFile mapped = FileManager::mapFile(missing);
+    TEST_ASSERT(!mapped.isOpen(), "Missing file should not open");
+    TEST_ASSERT(mapped.size() == 0, "Missing file has no contents");
+    return true;
+}
+
+bool test_move_and_close() {
+    TempFile file("move.txt", "moved contents");
+
+    FileManager::MappedFile first = FileManager::mapFile(file.path());
+    TEST_ASSERT(first.isOpen(), "File should open");
+
+    FileManager::MappedFile second(std::move(first));
+    TEST_ASSERT(!first.isOpen(), "Moved-from mapping should be closed");
+    TEST_ASSERT(second.isOpen() && second.view() == "moved contents", "Moved-to mapping keeps the contents");
+
+    FileManager::MappedFile third;
+    third = std::move(second);
+    TEST_ASSERT(third.isOpen() && third.view() == "moved contents", "Move assignment keeps the contents");
+
+    third.close();
+    TEST_ASSERT(!third.isOpen() && third.size() == 0, "Closed mapping is empty");
+    return true;
+}
+
+bool test_prefetch_file() {
+    const std::string contents(64 * 1024, 'x');
+    TempFile file("prefetch.bin", contents);
+    TempFile empty("prefetch_empty.bin", "");
+
+#ifdef _WIN32
+    TEST_ASSERT(FileManager::prefetchFile(file.path()) == 0, "Prefetch is a no-op on Windows");
+#else
+    TEST_ASSERT(FileManager::prefetchFile(file.path()) == contents.size(), "Prefetch should request the whole file");
+#endif
+    TEST_ASSERT(FileManager::prefetchFile(empty.path()) == 0, "Empty files have nothing to prefetch");
+    TEST_ASSERT(FileManager::prefetchFile(file.path() + ".missing") == 0, "Missing files have nothing to prefetch");
+    TEST_ASSERT(FileManager::prefetchFile(fs::temp_directory_path().string()) == 0, "Directories are not prefetched");
+    return true;
+}
+
+int main() {
+    std::cout << "=== Mapped File Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_maps_file_contents);
+    RUN_TEST(test_empty_file);
+    RUN_TEST(test_missing_file);
+    RUN_TEST(test_move_and_close);
+    RUN_TEST(test_prefetch_file);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All mapped file tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include <cstring>
+#include <filesystem>
 
 using namespace leafra;
 
@@ -185,6 +186,35 @@ bool test_storage_base_paths() {
     return true;
 }
 
+bool test_storage_base_path_override() {
+    std::cout << "\n  Testing storage base path override..." << std::endl;
+    
+    // A shared container directory (e.g. an app group) replaces the platform location
+    const std::filesystem::path shared = std::filesystem::temp_directory_path() / "leafra_shared_container";
+    std::filesystem::create_directories(shared);
+    const std::string platform_base = FileManager::getStorageBasePath(StorageType::AppStorage);
+    
+    FileManager::setStorageBasePath(StorageType::AppStorage, shared.string());
+    TEST_ASSERT(FileManager::getStorageBasePath(StorageType::AppStorage) == shared.string(), "Override should be the base path");
+    TEST_ASSERT(FileManager::getAbsolutePath(StorageType::AppStorage, "leafra.db") == (shared / "leafra.db").string(),
+                "Paths should resolve inside the override");
+    
+    const char* content = "Shared container test";
+    ResultCode result = FileManager::createFile(StorageType::AppStorage, "shared.txt", content, strlen(content));
+    TEST_ASSERT_RESULT_CODE(ResultCode::SUCCESS, result, "Should create file in the shared container");
+    TEST_ASSERT(std::filesystem::exists(shared / "shared.txt"), "File should be in the shared container");
+    FileManager::deleteFile(StorageType::AppStorage, "shared.txt");
+    
+    // Document storage keeps its own location, and clearing the override restores the platform one
+    TEST_ASSERT(FileManager::getStorageBasePath(StorageType::DocumentStorage) != shared.string(),
+                "Other storage types should not be affected");
+    FileManager::setStorageBasePath(StorageType::AppStorage, "");
+    TEST_ASSERT(FileManager::getStorageBasePath(StorageType::AppStorage) == platform_base, "Clearing should restore the platform path");
+    
+    std::filesystem::remove_all(shared);
+    return true;
+}
+
 bool test_nested_directories_in_storages() {
     std::cout << "\n  Testing nested directories in different storages..." << std::endl;
     
@@ -264,6 +294,7 @@ int main() {
     RUN_TEST(test_document_storage_operations);
     RUN_TEST(test_storage_isolation);
     RUN_TEST(test_storage_base_paths);
+    RUN_TEST(test_storage_base_path_override);
     RUN_TEST(test_nested_directories_in_storages);
     RUN_TEST(test_cross_storage_operations);
     
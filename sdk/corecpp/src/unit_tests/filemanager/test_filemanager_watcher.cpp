@@ -0,0 +1,209 @@
+#include "../../../include/leafra/leafra_filemanager.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace leafra;
+namespace fs = std::filesystem;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+// Collects the batches reported by a watcher
+class ChangeCollector {
+public:
+    FileWatcher::ChangeCallback callback() {
+        return [this](const FileWatcher::Changes& changes) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batches_++;
+            modified_.insert(modified_.end(), changes.modified.begin(), changes.modified.end());
+            removed_.insert(removed_.end(), changes.removed.begin(), changes.removed.end());
+            cv_.notify_all();
+        };
+    }
+
+    // Wait until path was reported as modified (or removed)
+    bool waitFor(const std::string& path, bool removed, int timeout_ms = 5000) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&]() {
+            const std::vector<std::string>& paths = removed ? removed_ : modified_;
+            return std::find(paths.begin(), paths.end(), path) != paths.end();
+        });
+    }
+
+    bool reported(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return std::find(modified_.begin(), modified_.end(), path) != modified_.end() ||
+               std::find(removed_.begin(), removed_.end(), path) != removed_.end();
+    }
+
+    int batches() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batches_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::string> modified_;
+    std::vector<std::string> removed_;
+    int batches_ = 0;
+};
+
+static fs::path makeTempDirectory(const std::string& name) {
+    fs::path directory = fs::temp_directory_path() / ("leafra_watcher_" + name);
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    return fs::canonical(directory);
+}
+
+static void writeFile(const fs::path& path, const std::string& content) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+bool test_reports_created_modified_and_removed_files() {
+    fs::path root = makeTempDirectory("basic");
+    writeFile(root / "existing.txt", "already here");
+
+    ChangeCollector collector;
+    FileWatcher watcher;
+    FileWatcher::Options options;
+    options.debounce_ms = 50;
+    TEST_ASSERT(watcher.start(root.string(), options, collector.callback()) == ResultCode::SUCCESS, "Watcher should start");
+
+    std::string created = (root / "created.txt").string();
+    writeFile(created, "new");
+    TEST_ASSERT(collector.waitFor(created, false), "Created file should be reported");
+    TEST_ASSERT(!collector.reported((root / "existing.txt").string()), "Baseline contents should not be reported");
+
+    writeFile(root / "existing.txt", "changed contents");
+    TEST_ASSERT(collector.waitFor((root / "existing.txt").string(), false), "Modified file should be reported");
+
+    fs::remove(created);
+    TEST_ASSERT(collector.waitFor(created, true), "Deleted file should be reported as removed");
+
+    watcher.stop();
+    TEST_ASSERT(!watcher.isRunning(), "Watcher should be stopped");
+    fs::remove_all(root);
+    return true;
+}
+
+bool test_new_subdirectories_and_filters() {
+    fs::path root = makeTempDirectory("subdirs");
+
+    ChangeCollector collector;
+    FileWatcher watcher;
+    FileWatcher::Options options;
+    options.debounce_ms = 50;
+    options.extensions = {".PDF", "txt"};
+    TEST_ASSERT(watcher.start(root.string(), options, collector.callback()) == ResultCode::SUCCESS, "Watcher should start");
+
+    fs::create_directories(root / "nested" / "deeper");
+    writeFile(root / "nested" / "deeper" / "report.pdf", "pdf bytes");
+    writeFile(root / "nested" / "image.png", "png bytes");
+    writeFile(root / ".hidden.txt", "hidden");
+    TEST_ASSERT(collector.waitFor((root / "nested" / "deeper" / "report.pdf").string(), false),
+                "Files in new subdirectories should be reported");
+
+    std::string later = (root / "nested" / "deeper" / "later.txt").string();
+    writeFile(later, "written after the directory was picked up");
+    TEST_ASSERT(collector.waitFor(later, false), "New subdirectories should be watched");
+    TEST_ASSERT(!collector.reported((root / "nested" / "image.png").string()), "Filtered extensions should not be reported");
+    TEST_ASSERT(!collector.reported((root / ".hidden.txt").string()), "Hidden files should not be reported");
+
+    fs::remove_all(root / "nested");
+    TEST_ASSERT(collector.waitFor(later, true), "Files of a deleted directory should be reported as removed");
+
+    watcher.stop();
+    fs::remove_all(root);
+    return true;
+}
+
+bool test_changes_are_debounced() {
+    fs::path root = makeTempDirectory("debounce");
+
+    ChangeCollector collector;
+    FileWatcher watcher;
+    FileWatcher::Options options;
+    options.debounce_ms = 300;
+    TEST_ASSERT(watcher.start(root.string(), options, collector.callback()) == ResultCode::SUCCESS, "Watcher should start");
+
+    for (int i = 0; i < 20; ++i) {
+        writeFile(root / ("file" + std::to_string(i) + ".txt"), "burst " + std::to_string(i));
+    }
+    TEST_ASSERT(collector.waitFor((root / "file19.txt").string(), false), "Burst should be reported");
+    TEST_ASSERT(collector.batches() == 1, "A burst of writes should arrive as one batch");
+
+    watcher.stop();
+    fs::remove_all(root);
+    return true;
+}
+
+bool test_start_rejects_missing_directory() {
+    FileWatcher watcher;
+    ChangeCollector collector;
+    fs::path missing = fs::temp_directory_path() / "leafra_watcher_does_not_exist";
+    fs::remove_all(missing);
+    TEST_ASSERT(watcher.start(missing.string(), FileWatcher::Options(), collector.callback()) == ResultCode::ERROR_NOT_FOUND,
+                "Missing directory should be rejected");
+    TEST_ASSERT(!watcher.isRunning(), "Watcher should not run");
+    return true;
+}
+
+int main() {
+    std::cout << "=== FileWatcher Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    if (!FileWatcher::isSupported()) {
+        std::cout << "File watching not supported on this platform, skipping" << std::endl;
+        return 0;
+    }
+
+    RUN_TEST(test_reports_created_modified_and_removed_files);
+    RUN_TEST(test_new_subdirectories_and_filters);
+    RUN_TEST(test_changes_are_debounced);
+    RUN_TEST(test_start_rejects_missing_directory);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All watcher tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,185 @@
+#include "../../../include/leafra/leafra_governor.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+static ThroughputLimits make_ceiling() {
+    ThroughputLimits ceiling;
+    ceiling.ingest_workers = 4;
+    ceiling.embedding_batch_size = 32;
+    ceiling.llm_threads = 4;
+    ceiling.llm_batch_threads = 8;
+    ceiling.faiss_threads = 4;
+    return ceiling;
+}
+
+static PowerState make_power(ThermalState thermal, int32_t battery_percent = -1, bool charging = false, bool low_power_mode = false) {
+    PowerState power;
+    power.thermal = thermal;
+    power.battery_percent = battery_percent;
+    power.charging = charging;
+    power.low_power_mode = low_power_mode;
+    return power;
+}
+
+bool test_throttle_scale() {
+    TEST_ASSERT_EQUAL(1.0, ThroughputGovernor::throttle_scale(make_power(ThermalState::NOMINAL), 20), "Nominal runs at full speed");
+    TEST_ASSERT_EQUAL(0.75, ThroughputGovernor::throttle_scale(make_power(ThermalState::FAIR), 20), "Fair");
+    TEST_ASSERT_EQUAL(0.5, ThroughputGovernor::throttle_scale(make_power(ThermalState::SERIOUS), 20), "Serious");
+    TEST_ASSERT_EQUAL(0.25, ThroughputGovernor::throttle_scale(make_power(ThermalState::CRITICAL), 20), "Critical");
+    TEST_ASSERT_EQUAL(0.5, ThroughputGovernor::throttle_scale(make_power(ThermalState::NOMINAL, 80, false, true), 20), "Low-power mode halves");
+    TEST_ASSERT_EQUAL(0.5, ThroughputGovernor::throttle_scale(make_power(ThermalState::NOMINAL, 15), 20), "Low battery halves");
+    TEST_ASSERT_EQUAL(1.0, ThroughputGovernor::throttle_scale(make_power(ThermalState::NOMINAL, 15, true), 20), "Charging is not throttled");
+    TEST_ASSERT_EQUAL(0.125, ThroughputGovernor::throttle_scale(make_power(ThermalState::SERIOUS, 10, false, true), 20), "Factors multiply");
+    return true;
+}
+
+bool test_scale_limits_floor() {
+    ThroughputLimits half = ThroughputGovernor::scale_limits(make_ceiling(), 0.5);
+    TEST_ASSERT_EQUAL(size_t(2), half.ingest_workers, "Ingest workers halved");
+    TEST_ASSERT_EQUAL(size_t(16), half.embedding_batch_size, "Batch size halved");
+    TEST_ASSERT_EQUAL(2, half.llm_threads, "LLM threads halved");
+    TEST_ASSERT_EQUAL(4, half.llm_batch_threads, "LLM batch threads halved");
+    TEST_ASSERT_EQUAL(2, half.faiss_threads, "FAISS threads halved");
+
+    ThroughputLimits floor = ThroughputGovernor::scale_limits(make_ceiling(), 0.01);
+    TEST_ASSERT_EQUAL(size_t(1), floor.ingest_workers, "Never below one worker");
+    TEST_ASSERT_EQUAL(size_t(1), floor.embedding_batch_size, "Never below one row");
+    TEST_ASSERT_EQUAL(1, floor.llm_threads, "Never below one thread");
+    return true;
+}
+
+bool test_reported_state_wins() {
+    ThroughputGovernor governor;
+    governor.configure(ThroughputGovernor::Options(), make_ceiling());
+
+    TEST_ASSERT(governor.report_power_state(make_power(ThermalState::SERIOUS)), "Throttling changes the limits");
+    TEST_ASSERT_EQUAL(size_t(2), governor.limits().ingest_workers, "Serious halves ingestion");
+    TEST_ASSERT(!governor.update(true), "Platform sampling stops once the host reports");
+    TEST_ASSERT_EQUAL(0.5, governor.state().scale, "Reported scale kept");
+
+    ThroughputLimits ceiling = make_ceiling();
+    ceiling.llm_threads = 6;
+    governor.set_ceiling(ceiling);
+    TEST_ASSERT_EQUAL(3, governor.limits().llm_threads, "A new ceiling is scaled too");
+
+    TEST_ASSERT(governor.report_power_state(make_power(ThermalState::NOMINAL, 90, true)), "Cooling down restores the limits");
+    TEST_ASSERT_EQUAL(6, governor.limits().llm_threads, "Full ceiling again");
+    return true;
+}
+
+bool test_disabled_governor() {
+    ThroughputGovernor::Options options;
+    options.enabled = false;
+    ThroughputGovernor governor;
+    governor.configure(options, make_ceiling());
+    TEST_ASSERT(!governor.report_power_state(make_power(ThermalState::CRITICAL)), "Disabled governor never rescales");
+    TEST_ASSERT_EQUAL(size_t(4), governor.limits().ingest_workers, "Limits stay at the ceiling");
+    TEST_ASSERT(governor.state().power.thermal == ThermalState::CRITICAL, "Reported state still visible");
+    return true;
+}
+
+bool test_interactive_scope_limits_ingestion() {
+    ThroughputGovernor::Options options;
+    options.interactive_ingest_workers = 1;
+    ThroughputGovernor governor;
+    governor.configure(options, make_ceiling());
+    governor.report_power_state(make_power(ThermalState::NOMINAL));
+    TEST_ASSERT_EQUAL(size_t(4), governor.state().ingest_allowance, "Full allowance when idle");
+
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    std::atomic<bool> query_running{true};
+    std::atomic<int> peak_during_query{0};
+    std::vector<std::thread> workers;
+    {
+        ThroughputGovernor::InteractiveScope query(governor);
+        TEST_ASSERT_EQUAL(size_t(1), governor.state().ingest_allowance, "One document at a time while a query runs");
+        for (int i = 0; i < 4; ++i) {
+            workers.emplace_back([&] {
+                for (int document = 0; document < 3; ++document) {
+                    ThroughputGovernor::IngestPermit permit(governor);
+                    int now = ++active;
+                    if (query_running) {
+                        peak_during_query = std::max(peak_during_query.load(), now);
+                    }
+                    peak = std::max(peak.load(), now);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                    --active;
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        query_running = false;
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    TEST_ASSERT_EQUAL(1, peak_during_query.load(), "Ingestion held to one document during the query");
+    TEST_ASSERT(peak.load() <= 4, "Never above the ceiling");
+    TEST_ASSERT_EQUAL(0, governor.state().interactive_calls, "Scope released");
+    return true;
+}
+
+int main() {
+    std::cout << "=== Throughput Governor Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_throttle_scale);
+    RUN_TEST(test_scale_limits_floor);
+    RUN_TEST(test_reported_state_wins);
+    RUN_TEST(test_disabled_governor);
+    RUN_TEST(test_interactive_scope_limits_ingestion);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
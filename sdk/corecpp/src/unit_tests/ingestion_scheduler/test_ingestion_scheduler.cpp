@@ -0,0 +1,217 @@
+#include "../../../include/leafra/leafra_ingestion_scheduler.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+static std::vector<std::string> make_paths(const std::string& prefix, size_t count) {
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < count; ++i) {
+        paths.push_back(prefix + std::to_string(i) + ".pdf");
+    }
+    return paths;
+}
+
+// Wait (bounded) until a run blocked in acquire() outranks the holder
+static bool wait_preempted(const IngestionScheduler::Run& run) {
+    for (int i = 0; i < 2000 && !run.preempted(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return run.preempted();
+}
+
+bool test_list_order() {
+    IngestionScheduler scheduler;
+    const std::vector<std::string> paths = make_paths("a", 3);
+    IngestionScheduler::Run run(scheduler, paths, IngestionPriority::NORMAL);
+    run.acquire();
+    size_t index = 99;
+    for (size_t expected = 0; expected < paths.size(); ++expected) {
+        TEST_ASSERT(run.next(index), "Every file should be handed out");
+        TEST_ASSERT_EQUAL(expected, index, "Files should come in list order");
+    }
+    TEST_ASSERT(!run.next(index), "Nothing should be left");
+    TEST_ASSERT_EQUAL(0u, run.remaining(), "Remaining count should reach zero");
+    TEST_ASSERT(!run.preempted(), "A finished run is never preempted");
+    return true;
+}
+
+bool test_bump_goes_first() {
+    IngestionScheduler scheduler;
+    const std::vector<std::string> paths = make_paths("a", 5);
+    IngestionScheduler::Run run(scheduler, paths, IngestionPriority::BACKGROUND);
+    run.acquire();
+    size_t index = 99;
+    TEST_ASSERT(run.next(index) && index == 0, "First file in list order");
+    TEST_ASSERT(scheduler.bump("a3.pdf"), "Pending file should be found");
+    TEST_ASSERT(!scheduler.bump("a0.pdf"), "A file already handed out can't be bumped");
+    TEST_ASSERT(!scheduler.bump("missing.pdf"), "Unknown file can't be bumped");
+    TEST_ASSERT(run.next(index) && index == 3, "Bumped file should be next");
+    std::vector<size_t> rest;
+    while (run.next(index)) {
+        rest.push_back(index);
+    }
+    TEST_ASSERT(rest == std::vector<size_t>({1, 2, 4}), "The rest should follow in list order, skipping the bumped file");
+    return true;
+}
+
+bool test_higher_priority_preempts() {
+    IngestionScheduler scheduler;
+    const std::vector<std::string> background_paths = make_paths("b", 4);
+    const std::vector<std::string> interactive_paths = make_paths("i", 2);
+    IngestionScheduler::Run background(scheduler, background_paths, IngestionPriority::BACKGROUND);
+    background.acquire();
+    size_t index = 0;
+    TEST_ASSERT(background.next(index), "Background run starts");
+    
+    std::vector<std::string> order;
+    std::mutex order_mutex;
+    std::thread interactive_thread([&]() {
+        IngestionScheduler::Run interactive(scheduler, interactive_paths, IngestionPriority::INTERACTIVE);
+        interactive.acquire();
+        size_t next = 0;
+        while (interactive.next(next)) {
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(interactive_paths[next]);
+        }
+        interactive.release();
+    });
+    
+    TEST_ASSERT(wait_preempted(background), "Waiting interactive run should preempt the background run");
+    TEST_ASSERT(!background.next(index), "Preempted run gets no more files");
+    background.release();
+    background.acquire();   // Returns once the interactive run is done
+    interactive_thread.join();
+    TEST_ASSERT_EQUAL(2u, order.size(), "Interactive run should finish while the background run waits");
+    TEST_ASSERT(!background.preempted(), "Nobody outranks the background run any more");
+    size_t left = 0;
+    while (background.next(index)) {
+        left++;
+    }
+    TEST_ASSERT_EQUAL(3u, left, "Background run should continue with the files it didn't start");
+    return true;
+}
+
+bool test_equal_priority_waits() {
+    IngestionScheduler scheduler;
+    const std::vector<std::string> first_paths = make_paths("f", 3);
+    const std::vector<std::string> second_paths = make_paths("s", 1);
+    IngestionScheduler::Run first(scheduler, first_paths, IngestionPriority::NORMAL);
+    first.acquire();
+    
+    std::atomic<bool> second_ran{false};
+    std::thread second_thread([&]() {
+        IngestionScheduler::Run second(scheduler, second_paths, IngestionPriority::NORMAL);
+        second.acquire();
+        second_ran = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    
+    size_t index = 0;
+    size_t handed_out = 0;
+    while (first.next(index)) {
+        handed_out++;
+    }
+    TEST_ASSERT_EQUAL(3u, handed_out, "A run of the same priority shouldn't preempt");
+    TEST_ASSERT(!second_ran, "The second run waits for the turn");
+    first.release();
+    second_thread.join();
+    TEST_ASSERT(second_ran, "The second run gets the turn once released");
+    return true;
+}
+
+bool test_bump_preempts_holder() {
+    IngestionScheduler scheduler;
+    const std::vector<std::string> holder_paths = make_paths("h", 3);
+    const std::vector<std::string> waiting_paths = make_paths("w", 3);
+    IngestionScheduler::Run holder(scheduler, holder_paths, IngestionPriority::NORMAL);
+    holder.acquire();
+    
+    std::atomic<size_t> first_index{99};
+    std::thread waiting_thread([&]() {
+        IngestionScheduler::Run waiting(scheduler, waiting_paths, IngestionPriority::BACKGROUND);
+        waiting.acquire();
+        size_t index = 0;
+        if (waiting.next(index)) {
+            first_index = index;
+        }
+        waiting.release();
+    });
+    while (scheduler.run_count() < 2) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    TEST_ASSERT(!holder.preempted(), "A waiting background run doesn't preempt");
+    
+    TEST_ASSERT(scheduler.bump("w2.pdf"), "File of the waiting run should be found");
+    TEST_ASSERT(wait_preempted(holder), "Bumped file makes its run interactive");
+    holder.release();
+    waiting_thread.join();
+    TEST_ASSERT_EQUAL(2u, first_index.load(), "The waiting run should start with the bumped file");
+    holder.acquire();
+    TEST_ASSERT_EQUAL(3u, holder.remaining(), "Holder keeps all its files");
+    return true;
+}
+
+int main() {
+    std::cout << "=== Ingestion Scheduler Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_list_order);
+    RUN_TEST(test_bump_goes_first);
+    RUN_TEST(test_higher_priority_preempts);
+    RUN_TEST(test_equal_priority_waits);
+    RUN_TEST(test_bump_preempts_holder);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,167 @@
+#include "../../../include/leafra/leafra_large_pages.h"
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+bool test_parse_policy() {
+    LargePagePolicy policy = LargePagePolicy::EXPLICIT;
+    TEST_ASSERT(large_pages::parse_policy("off", policy), "off parses");
+    TEST_ASSERT(policy == LargePagePolicy::OFF, "off is OFF");
+    TEST_ASSERT(large_pages::parse_policy("transparent", policy), "transparent parses");
+    TEST_ASSERT(policy == LargePagePolicy::TRANSPARENT, "transparent is TRANSPARENT");
+    TEST_ASSERT(large_pages::parse_policy("explicit", policy), "explicit parses");
+    TEST_ASSERT(policy == LargePagePolicy::EXPLICIT, "explicit is EXPLICIT");
+    TEST_ASSERT(!large_pages::parse_policy("huge", policy), "Unknown names are rejected");
+    TEST_ASSERT(policy == LargePagePolicy::EXPLICIT, "Rejected names leave the policy alone");
+    TEST_ASSERT_EQUAL(std::string("transparent"), std::string(large_pages::policy_name(LargePagePolicy::TRANSPARENT)), "Name round trip");
+    return true;
+}
+
+bool test_advise_respects_policy() {
+    std::vector<char> buffer(3 * large_pages::kHugePageBytes);
+    large_pages::set_policy(LargePagePolicy::OFF);
+    TEST_ASSERT_EQUAL(size_t(0), large_pages::advise(buffer.data(), buffer.size()), "Nothing is advised under OFF");
+
+    large_pages::set_policy(LargePagePolicy::TRANSPARENT);
+    TEST_ASSERT_EQUAL(size_t(0), large_pages::advise(buffer.data(), large_pages::kHugePageBytes - 1), "Buffers under a huge page are skipped");
+    size_t advised = large_pages::advise(buffer.data(), buffer.size());
+    TEST_ASSERT(advised <= buffer.size(), "Advice stays inside the buffer");
+    TEST_ASSERT(advised % large_pages::kHugePageBytes == 0, "Advice covers whole huge pages");
+#if defined(__linux__)
+    if (large_pages::supported()) {
+        TEST_ASSERT(advised >= 2 * large_pages::kHugePageBytes, "At least two whole huge pages fit in three");
+    }
+#endif
+    large_pages::set_policy(LargePagePolicy::OFF);
+    return true;
+}
+
+bool test_allocator_round_trip() {
+    for (LargePagePolicy policy : {LargePagePolicy::OFF, LargePagePolicy::TRANSPARENT, LargePagePolicy::EXPLICIT}) {
+        large_pages::set_policy(policy);
+        std::vector<float, LargePageAllocator<float> > matrix(1024 * 1024);
+        TEST_ASSERT(reinterpret_cast<uintptr_t>(matrix.data()) % 64 == 0, "Mapped buffers are 64-byte aligned");
+        for (size_t i = 0; i < matrix.size(); ++i) {
+            matrix[i] = static_cast<float>(i);
+        }
+        // Growing reallocates through the allocator; small buffers use the heap
+        matrix.resize(matrix.size() * 2, 1.0f);
+        std::vector<float, LargePageAllocator<float> > small(16, 2.0f);
+        TEST_ASSERT_EQUAL(1048575.0f, matrix[1048575], "Contents survive reallocation");
+        TEST_ASSERT_EQUAL(1.0f, matrix.back(), "Appended values are kept");
+        TEST_ASSERT_EQUAL(2.0f, small[15], "Small buffers work");
+    }
+    // Freed under a different policy than it was allocated with
+    large_pages::set_policy(LargePagePolicy::EXPLICIT);
+    std::vector<float, LargePageAllocator<float> >* matrix = new std::vector<float, LargePageAllocator<float> >(1024 * 1024, 3.0f);
+    large_pages::set_policy(LargePagePolicy::OFF);
+    delete matrix;
+
+    LargePageMetrics metrics = large_pages::metrics();
+    TEST_ASSERT_EQUAL(uint64_t(0), metrics.explicit_bytes, "Reserved pages are all returned");
+    return true;
+}
+
+bool test_advise_file() {
+#if defined(__linux__)
+    char path[] = "/tmp/leafra_large_pages_XXXXXX";
+    int fd = mkstemp(path);
+    TEST_ASSERT(fd >= 0, "Temp file created");
+    const size_t size = 4 * large_pages::kHugePageBytes;
+    TEST_ASSERT(ftruncate(fd, static_cast<off_t>(size)) == 0, "Temp file sized");
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    TEST_ASSERT(mapping != MAP_FAILED, "Temp file mapped");
+
+    large_pages::set_policy(LargePagePolicy::OFF);
+    TEST_ASSERT_EQUAL(size_t(0), large_pages::advise_file(path), "Nothing is advised under OFF");
+    large_pages::set_policy(LargePagePolicy::TRANSPARENT);
+    size_t advised = large_pages::advise_file(path);
+    TEST_ASSERT(advised <= size, "Only the file's mapping is advised");
+    TEST_ASSERT_EQUAL(size_t(0), large_pages::advise_file("/nonexistent/model.gguf"), "Missing files are ignored");
+    large_pages::set_policy(LargePagePolicy::OFF);
+
+    munmap(mapping, size);
+    close(fd);
+    std::remove(path);
+#endif
+    return true;
+}
+
+bool test_metrics_report_policy() {
+    large_pages::set_policy(LargePagePolicy::TRANSPARENT);
+    LargePageMetrics metrics = large_pages::metrics();
+    TEST_ASSERT_EQUAL(std::string("transparent"), metrics.policy, "Policy is reported");
+    large_pages::set_policy(LargePagePolicy::OFF);
+    TEST_ASSERT_EQUAL(std::string("off"), large_pages::metrics().policy, "Policy changes are reported");
+    return true;
+}
+
+int main() {
+    std::cout << "=== Large Page Tests ===" << std::endl;
+    std::cout << "Transparent huge pages: " << (large_pages::supported() ? "available" : "unavailable") << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_parse_policy);
+    RUN_TEST(test_advise_respects_policy);
+    RUN_TEST(test_allocator_round_trip);
+    RUN_TEST(test_advise_file);
+    RUN_TEST(test_metrics_report_policy);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,452 @@
+// Throughput and latency benchmark for LlamaCppModel
+//
+// Loads a GGUF model once per point of an n_batch / n_ubatch / n_threads / n_gpu_layers sweep
+// and measures, per point: load time, weight and KV cache memory, prompt evaluation speed and
+// time to first token at several prompt lengths, and decode speed. Every measurement is
+// repeated and its median reported. Results are written as one JSON document, so models,
+// quantizations and llama.cpp builds can be compared per device class.
+//
+// Usage: bench_llamacpp --model path.gguf [--output file.json] [--prompt-lengths 128,512,2048]
+//                       [--decode-tokens N] [--repetitions R] [--n-ctx N] [--n-batch list]
+//                       [--n-ubatch list] [--threads list] [--gpu-layers list] [--flash-attn]
+
+#include "../../../include/leafra/leafra_llamacpp.h"
+#include "../../../include/leafra/types.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef __APPLE__
+#include <TargetConditionals.h>
+#endif
+
+using namespace leafra;
+using namespace leafra::llamacpp;
+
+namespace {
+
+// ==============================================================================
+// Options
+// ==============================================================================
+
+struct Options {
+    std::string model;
+    std::string output;                                 // JSON file (stdout when empty)
+    std::vector<int32_t> prompt_lengths = {128, 512, 2048};
+    int32_t decode_tokens = 128;
+    int32_t repetitions = 3;                            // Runs per measurement (median reported)
+    int32_t n_ctx = 4096;
+    bool flash_attn = false;
+
+    // Sweep axes (every combination is measured; n_ubatch > n_batch is skipped)
+    std::vector<int32_t> n_batch = {512};
+    std::vector<int32_t> n_ubatch = {512};
+    std::vector<int32_t> n_threads = {-1};
+    std::vector<int32_t> n_gpu_layers = {-1};
+};
+
+std::vector<int32_t> parse_list(const std::string& value) {
+    std::vector<int32_t> values;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            values.push_back(static_cast<int32_t>(std::strtol(item.c_str(), nullptr, 10)));
+        }
+    }
+    return values;
+}
+
+double median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ==============================================================================
+// JSON output
+// ==============================================================================
+
+std::string json_string(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+std::string json_number(double value) {
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.6g", value);
+    return number;
+}
+
+const char* platform_name() {
+#if defined(__APPLE__)
+#if TARGET_OS_IPHONE
+    return "ios";
+#else
+    return "macos";
+#endif
+#elif defined(__ANDROID__)
+    return "android";
+#elif defined(__linux__)
+    return "linux";
+#elif defined(_WIN32)
+    return "windows";
+#else
+    return "unknown";
+#endif
+}
+
+const char* architecture_name() {
+#if defined(__aarch64__) || defined(__arm64__)
+    return "arm64";
+#elif defined(__x86_64__) || defined(_M_X64)
+    return "x86_64";
+#elif defined(__arm__)
+    return "arm";
+#else
+    return "unknown";
+#endif
+}
+
+// ==============================================================================
+// Measurements
+// ==============================================================================
+
+struct PromptResult {
+    int32_t tokens = 0;
+    double prompt_eval_ms = 0.0;
+    double prompt_tokens_per_second = 0.0;
+    double ttft_ms = 0.0;                   // Call to first streamed token (prompt evaluation + first sample)
+};
+
+struct PointResult {
+    int32_t n_batch = 0;
+    int32_t n_ubatch = 0;
+    int32_t n_threads = 0;
+    int32_t n_gpu_layers = 0;
+    double load_ms = 0.0;
+    double warmup_ms = 0.0;                 // First decode after loading (pages in weights, compiles GPU kernels)
+    uint64_t weight_bytes = 0;
+    uint64_t kv_cache_bytes = 0;
+    std::vector<PromptResult> prompts;
+    int32_t decode_tokens = 0;              // Tokens actually generated (less than asked if the model ended its answer)
+    double decode_ms = 0.0;
+    double decode_tokens_per_second = 0.0;
+    std::string error;                      // Set when the point failed; measurements are then absent
+};
+
+/**
+ * @brief Prompt of exactly count tokens (BOS included) cut from repeated English-like text
+ */
+std::vector<int32_t> make_prompt(LlamaCppModel& model, int32_t count) {
+    static const std::string kParagraph =
+        "The retrieval pipeline splits each document into chunks, embeds them and stores the vectors in an "
+        "index next to the chunk text. A question is embedded the same way, the closest chunks are found, and "
+        "the language model answers from them. Latency on a mobile device depends on the prompt length, the "
+        "batch sizes used to evaluate it and how many layers run on the GPU. ";
+    std::string text;
+    std::vector<int32_t> tokens;
+    while (static_cast<int32_t>(tokens.size()) < count) {
+        for (int i = 0; i < 16; ++i) {
+            text += kParagraph;
+        }
+        tokens = model.tokenize(text, true);
+        if (tokens.empty()) {
+            break;
+        }
+    }
+    if (static_cast<int32_t>(tokens.size()) > count) {
+        tokens.resize(static_cast<size_t>(count));
+    }
+    return tokens;
+}
+
+/**
+ * @brief One generation from a fresh context, timing the first streamed token
+ * @return false if the generation failed
+ */
+bool timed_generation(LlamaCppModel& model, const std::vector<int32_t>& prompt, int32_t max_tokens,
+                      double& ttft_ms, GenerationStats& stats) {
+    model.reset_context();
+    ttft_ms = 0.0;
+    bool first = true;
+    auto start = std::chrono::steady_clock::now();
+    bool ok = model.generate_from_tokens(prompt, [&](const std::string&, bool) {
+        if (first) {
+            ttft_ms = elapsed_ms(start);
+            first = false;
+        }
+        return true;
+    }, max_tokens);
+    stats = model.get_last_stats();
+    return ok && !first;
+}
+
+PointResult run_point(const Options& options, int32_t n_batch, int32_t n_ubatch, int32_t n_threads, int32_t n_gpu_layers,
+                      std::string& model_info) {
+    PointResult result;
+    result.n_batch = n_batch;
+    result.n_ubatch = n_ubatch;
+    result.n_threads = n_threads;
+    result.n_gpu_layers = n_gpu_layers;
+
+    leafra::LLMConfig config(options.model);
+    config.n_ctx = options.n_ctx;
+    config.n_batch = n_batch;
+    config.n_ubatch = n_ubatch;
+    config.n_threads = n_threads;
+    config.n_threads_batch = n_threads;
+    config.n_gpu_layers = n_gpu_layers;
+    config.n_predict = options.decode_tokens;
+    config.flash_attn = options.flash_attn;
+    config.reuse_prompt_cache = false;      // Every run evaluates its whole prompt
+    config.temperature = 0.0f;
+    config.seed = 42;
+
+    LlamaCppModel model;
+    auto load_start = std::chrono::steady_clock::now();
+    if (!model.load_model(config)) {
+        result.error = "load failed: " + model.get_last_error();
+        return result;
+    }
+    result.load_ms = elapsed_ms(load_start);
+    if (model_info.empty()) {
+        model_info = model.get_model_info();
+    }
+    model.get_memory_usage(result.kv_cache_bytes, result.weight_bytes);
+
+    auto warmup_start = std::chrono::steady_clock::now();
+    model.warm_up();
+    result.warmup_ms = elapsed_ms(warmup_start);
+
+    for (int32_t length : options.prompt_lengths) {
+        if (length <= 0 || length + 1 > options.n_ctx) {
+            continue;
+        }
+        std::vector<int32_t> prompt = make_prompt(model, length);
+        if (static_cast<int32_t>(prompt.size()) != length) {
+            result.error = "could not build a " + std::to_string(length) + "-token prompt";
+            return result;
+        }
+        std::vector<double> eval_ms;
+        std::vector<double> ttft_ms;
+        for (int32_t run = 0; run < options.repetitions; ++run) {
+            double ttft = 0.0;
+            GenerationStats stats;
+            if (!timed_generation(model, prompt, 1, ttft, stats)) {
+                result.error = "generation failed: " + model.get_last_error();
+                return result;
+            }
+            eval_ms.push_back(stats.prompt_eval_time);
+            ttft_ms.push_back(ttft);
+        }
+        PromptResult prompt_result;
+        prompt_result.tokens = length;
+        prompt_result.prompt_eval_ms = median(eval_ms);
+        prompt_result.prompt_tokens_per_second = prompt_result.prompt_eval_ms > 0.0 ? length / (prompt_result.prompt_eval_ms / 1000.0) : 0.0;
+        prompt_result.ttft_ms = median(ttft_ms);
+        result.prompts.push_back(prompt_result);
+        std::cerr << "   prompt " << std::setw(5) << length << " tokens: " << std::fixed << std::setprecision(1)
+                  << std::setw(9) << prompt_result.prompt_tokens_per_second << " tok/s, TTFT "
+                  << std::setw(8) << prompt_result.ttft_ms << " ms" << std::endl;
+    }
+
+    // Decode after a short prompt, so the generated tokens dominate the time
+    std::vector<int32_t> prompt = make_prompt(model, std::min<int32_t>(32, options.n_ctx / 2));
+    std::vector<double> decode_ms;
+    std::vector<double> decode_tokens;
+    for (int32_t run = 0; run < options.repetitions; ++run) {
+        double ttft = 0.0;
+        GenerationStats stats;
+        if (!timed_generation(model, prompt, options.decode_tokens, ttft, stats)) {
+            result.error = "generation failed: " + model.get_last_error();
+            return result;
+        }
+        decode_ms.push_back(stats.generation_time);
+        decode_tokens.push_back(stats.generated_tokens);
+    }
+    result.decode_ms = median(decode_ms);
+    result.decode_tokens = static_cast<int32_t>(median(decode_tokens));
+    result.decode_tokens_per_second = result.decode_ms > 0.0 ? result.decode_tokens / (result.decode_ms / 1000.0) : 0.0;
+    std::cerr << "   decode " << std::setw(5) << result.decode_tokens << " tokens: " << std::fixed << std::setprecision(1)
+              << std::setw(9) << result.decode_tokens_per_second << " tok/s" << std::endl;
+    return result;
+} //run_point
+
+std::string to_json(const Options& options, const std::string& model_info, const std::vector<PointResult>& points) {
+    std::time_t now = std::time(nullptr);
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    std::error_code size_error;
+    uintmax_t model_bytes = std::filesystem::file_size(options.model, size_error);
+
+    std::string out = "{\n  \"schema_version\": 1,\n";
+    out += "  \"timestamp\": " + json_string(timestamp) + ",\n";
+    out += "  \"platform\": " + json_string(platform_name()) + ",\n";
+    out += "  \"architecture\": " + json_string(architecture_name()) + ",\n";
+#ifdef __VERSION__
+    out += "  \"compiler\": " + json_string(__VERSION__) + ",\n";
+#endif
+#ifdef NDEBUG
+    out += "  \"build_type\": \"release\",\n";
+#else
+    out += "  \"build_type\": \"debug\",\n";
+#endif
+    out += "  \"llama_version\": " + json_string(global::get_version()) + ",\n";
+    out += "  \"system_info\": " + json_string(global::get_system_info()) + ",\n";
+    out += "  \"model\": {\"file\": " + json_string(std::filesystem::path(options.model).filename().string()) +
+           ", \"file_bytes\": " + std::to_string(size_error ? 0 : model_bytes) +
+           ", \"info\": " + json_string(model_info) + "},\n";
+    out += "  \"options\": {\"n_ctx\": " + std::to_string(options.n_ctx) +
+           ", \"decode_tokens\": " + std::to_string(options.decode_tokens) +
+           ", \"repetitions\": " + std::to_string(options.repetitions) +
+           ", \"flash_attn\": " + (options.flash_attn ? "true" : "false") + "},\n";
+
+    out += "  \"results\": [";
+    for (size_t i = 0; i < points.size(); ++i) {
+        const PointResult& point = points[i];
+        out += i == 0 ? "\n" : ",\n";
+        out += "    {\"params\": {\"n_batch\": " + std::to_string(point.n_batch) +
+               ", \"n_ubatch\": " + std::to_string(point.n_ubatch) +
+               ", \"n_threads\": " + std::to_string(point.n_threads) +
+               ", \"n_gpu_layers\": " + std::to_string(point.n_gpu_layers) + "}";
+        if (!point.error.empty()) {
+            out += ", \"error\": " + json_string(point.error) + "}";
+            continue;
+        }
+        out += ",\n     \"load_ms\": " + json_number(point.load_ms) +
+               ", \"warmup_ms\": " + json_number(point.warmup_ms) +
+               ", \"weight_bytes\": " + std::to_string(point.weight_bytes) +
+               ", \"kv_cache_bytes\": " + std::to_string(point.kv_cache_bytes) + ",\n     \"prompt_eval\": [";
+        for (size_t p = 0; p < point.prompts.size(); ++p) {
+            const PromptResult& prompt = point.prompts[p];
+            out += p == 0 ? "" : ", ";
+            out += "{\"tokens\": " + std::to_string(prompt.tokens) +
+                   ", \"ms\": " + json_number(prompt.prompt_eval_ms) +
+                   ", \"tokens_per_second\": " + json_number(prompt.prompt_tokens_per_second) +
+                   ", \"ttft_ms\": " + json_number(prompt.ttft_ms) + "}";
+        }
+        out += "],\n     \"decode\": {\"tokens\": " + std::to_string(point.decode_tokens) +
+               ", \"ms\": " + json_number(point.decode_ms) +
+               ", \"tokens_per_second\": " + json_number(point.decode_tokens_per_second) + "}}";
+    }
+    out += points.empty() ? "]\n}\n" : "\n  ]\n}\n";
+    return out;
+} //to_json
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " --model path.gguf [--output file.json] [--prompt-lengths 128,512,2048]" << std::endl
+              << "       [--decode-tokens N] [--repetitions R] [--n-ctx N] [--n-batch list] [--n-ubatch list]" << std::endl
+              << "       [--threads list] [--gpu-layers list] [--flash-attn]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--model" && i + 1 < argc) {
+            options.model = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            options.output = argv[++i];
+        } else if (arg == "--prompt-lengths" && i + 1 < argc) {
+            options.prompt_lengths = parse_list(argv[++i]);
+        } else if (arg == "--decode-tokens" && i + 1 < argc) {
+            options.decode_tokens = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--n-ctx" && i + 1 < argc) {
+            options.n_ctx = std::max(64, std::atoi(argv[++i]));
+        } else if (arg == "--n-batch" && i + 1 < argc) {
+            options.n_batch = parse_list(argv[++i]);
+        } else if (arg == "--n-ubatch" && i + 1 < argc) {
+            options.n_ubatch = parse_list(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.n_threads = parse_list(argv[++i]);
+        } else if (arg == "--gpu-layers" && i + 1 < argc) {
+            options.n_gpu_layers = parse_list(argv[++i]);
+        } else if (arg == "--flash-attn") {
+            options.flash_attn = true;
+        } else {
+            print_usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (options.model.empty() || !utils::is_valid_model_file(options.model)) {
+        std::cerr << "❌ --model must name a GGUF model file" << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::cerr << "=== LlamaCpp Benchmarks ===" << std::endl;
+    global::initialize(true);
+
+    std::vector<PointResult> points;
+    std::string model_info;
+    for (int32_t n_batch : options.n_batch) {
+        for (int32_t n_ubatch : options.n_ubatch) {
+            if (n_ubatch > n_batch) {
+                continue;
+            }
+            for (int32_t n_threads : options.n_threads) {
+                for (int32_t n_gpu_layers : options.n_gpu_layers) {
+                    std::cerr << "⏱️  n_batch=" << n_batch << " n_ubatch=" << n_ubatch << " n_threads=" << n_threads
+                              << " n_gpu_layers=" << n_gpu_layers << std::endl;
+                    points.push_back(run_point(options, n_batch, n_ubatch, n_threads, n_gpu_layers, model_info));
+                    if (!points.back().error.empty()) {
+                        std::cerr << "   ❌ " << points.back().error << std::endl;
+                    }
+                }
+            }
+        }
+    }
+    global::cleanup();
+
+    std::string json = to_json(options, model_info, points);
+    if (options.output.empty()) {
+        std::cout << json;
+        return 0;
+    }
+    std::ofstream file(options.output, std::ios::binary | std::ios::trunc);
+    file << json;
+    if (!file.flush()) {
+        std::cerr << "❌ Failed to write " << options.output << std::endl;
+        return 1;
+    }
+    std::cerr << "📊 Results written to " << options.output << std::endl;
+    return 0;
+}
@@ -12,6 +12,7 @@
 #include <vector>
 #include <chrono>
 #include <cassert>
+#include <cmath>
 #include <memory>
 #include <sstream>
 #include <fstream>
@@ -522,6 +523,14 @@ public:
         if (perplexity > 0) {
             ASSERT_GT(perplexity, 0.0);
             std::cout << "   Perplexity for '" << test_text << "': " << perplexity << std::endl;
+            
+            // Batched scoring agrees with the single-text path
+            std::vector<double> batched = model_->score_texts({test_text, "asdf qwer zxcv uiop", test_text});
+            ASSERT_EQ(batched.size(), static_cast<size_t>(3));
+            ASSERT_TRUE(std::fabs(batched[0] - perplexity) < perplexity * 1e-3);
+            ASSERT_TRUE(std::fabs(batched[2] - perplexity) < perplexity * 1e-3);
+            ASSERT_GT(batched[1], 0.0);
+            std::cout << "   Batched perplexities: " << batched[0] << ", " << batched[1] << ", " << batched[2] << std::endl;
         } else {
             std::cout << "   Note: Perplexity calculation failed or not supported" << std::endl;
         }
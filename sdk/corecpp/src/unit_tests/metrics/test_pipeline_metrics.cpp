@@ -0,0 +1,349 @@
+#include "../../../include/leafra/leafra_metrics.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+bool test_bucket_bounds() {
+    // Every value lands in a bucket whose upper bound covers it and whose predecessor doesn't
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> values = {0, 1, 15, 16, 17, 31, 32, 1000, 1u << 20, ~uint64_t(0)};
+    for (int i = 0; i < 10000; ++i) {
+        values.push_back(rng() >> (rng() % 64));
+    }
+    for (uint64_t value : values) {
+        size_t index = LatencyHistogram::bucket_index(value);
+        TEST_ASSERT(index < LatencyHistogram::kBucketCount, "Bucket index in range");
+        TEST_ASSERT(LatencyHistogram::bucket_upper_bound(index) >= value, "Upper bound covers the value");
+        if (index > 0) {
+            TEST_ASSERT(LatencyHistogram::bucket_upper_bound(index - 1) < value, "Previous bucket ends below the value");
+        }
+        if (value >= LatencyHistogram::kSubBuckets) {
+            // Relative bucket width bounds the percentile error
+            double width = static_cast<double>(LatencyHistogram::bucket_upper_bound(index) - LatencyHistogram::bucket_upper_bound(index - 1));
+            TEST_ASSERT(width / static_cast<double>(value) <= 1.0 / LatencyHistogram::kSubBuckets, "Bucket width within 1/16 of the value");
+        }
+    }
+    return true;
+}
+
+bool test_percentiles() {
+    LatencyHistogram histogram;
+    TEST_ASSERT_EQUAL(uint64_t(0), histogram.percentile_micros(0.5), "Empty histogram reports 0");
+
+    std::vector<uint64_t> values;
+    std::mt19937_64 rng(11);
+    for (int i = 0; i < 20000; ++i) {
+        uint64_t value = 100 + rng() % 50000;
+        values.push_back(value);
+        histogram.record(value, 3);
+    }
+    std::sort(values.begin(), values.end());
+    for (double q : {0.5, 0.95, 0.99}) {
+        uint64_t exact = values[static_cast<size_t>(q * values.size()) - 1];
+        uint64_t estimate = histogram.percentile_micros(q);
+        TEST_ASSERT(estimate >= exact, "Percentile is an upper bound");
+        TEST_ASSERT(static_cast<double>(estimate) <= exact * 1.07, "Percentile within ~6%");
+    }
+    TEST_ASSERT_EQUAL(values.back(), histogram.percentile_micros(1.0), "p100 is the maximum");
+    TEST_ASSERT_EQUAL(values.back(), histogram.max_micros(), "Maximum is exact");
+    TEST_ASSERT_EQUAL(uint64_t(20000), histogram.count(), "Count");
+    TEST_ASSERT_EQUAL(uint64_t(60000), histogram.items(), "Items");
+
+    histogram.reset();
+    TEST_ASSERT_EQUAL(uint64_t(0), histogram.count(), "Reset clears the count");
+    TEST_ASSERT_EQUAL(uint64_t(0), histogram.percentile_micros(0.99), "Reset clears the buckets");
+    return true;
+}
+
+bool test_recorder_snapshot() {
+    PipelineMetricsRecorder recorder;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&recorder] {
+            for (int i = 0; i < 1000; ++i) {
+                recorder.record(PipelineStage::FAISS_SEARCH, std::chrono::microseconds(2000), 2);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    {
+        PipelineMetricsRecorder::ScopedStage timing(recorder, PipelineStage::PARSE);
+        timing.set_items(5);
+    }
+    {
+        PipelineMetricsRecorder::ScopedStage timing(recorder, PipelineStage::PARSE);
+        timing.cancel();
+    }
+
+    PipelineMetrics metrics = recorder.snapshot();
+    TEST_ASSERT_EQUAL(static_cast<size_t>(PipelineStage::COUNT), metrics.stages.size(), "One entry per stage");
+    const StageMetrics& search = metrics.stage(PipelineStage::FAISS_SEARCH);
+    TEST_ASSERT_EQUAL(std::string("faiss_search"), search.name, "Stage name");
+    TEST_ASSERT_EQUAL(uint64_t(4000), search.count, "Concurrent records all counted");
+    TEST_ASSERT_EQUAL(uint64_t(8000), search.items, "Items summed");
+    TEST_ASSERT(search.total_ms > 7999.0 && search.total_ms < 8001.0, "Total latency");
+    TEST_ASSERT(search.p50_ms >= 2.0 && search.p99_ms <= 2.13, "Percentiles of a constant latency");
+    TEST_ASSERT_EQUAL(uint64_t(1), metrics.stage(PipelineStage::PARSE).count, "Cancelled scope isn't recorded");
+    TEST_ASSERT_EQUAL(uint64_t(5), metrics.stage(PipelineStage::PARSE).items, "Scope items");
+    TEST_ASSERT_EQUAL(uint64_t(0), metrics.stage(PipelineStage::LLM_DECODE).count, "Untouched stage is empty");
+    TEST_ASSERT_EQUAL(std::string("faiss_save"), metrics.stage(PipelineStage::FAISS_SAVE).name, "Snapshot stage name");
+    TEST_ASSERT(recorder.typical_ms(PipelineStage::FAISS_SEARCH) == search.p50_ms, "Typical latency is the median");
+    TEST_ASSERT(recorder.typical_ms(PipelineStage::LLM_DECODE) == 0.0, "No typical latency before the first record");
+
+    recorder.reset();
+    TEST_ASSERT_EQUAL(uint64_t(0), recorder.snapshot().stage(PipelineStage::FAISS_SEARCH).count, "Reset clears every stage");
+    return true;
+}
+
+bool test_memory_accounting() {
+    MemoryAccountant& memory = MemoryAccountant::instance();
+    memory.reset_peaks();
+    const uint64_t base = memory.total();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([] {
+            // Thread-local style reservations: grow, shrink, released at scope exit
+            MemoryAccountant::Reservation held(MemorySubsystem::DOCUMENTS);
+            for (int i = 1; i <= 100; ++i) {
+                held.resize(static_cast<uint64_t>(i) * 1000);
+            }
+            held.resize(500);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    TEST_ASSERT_EQUAL(uint64_t(0), memory.current(MemorySubsystem::DOCUMENTS), "Reservations released");
+    TEST_ASSERT(memory.peak(MemorySubsystem::DOCUMENTS) >= 100000, "High-water mark kept after release");
+    TEST_ASSERT(memory.peak(MemorySubsystem::DOCUMENTS) <= 400000, "High-water mark bounded by concurrent holders");
+
+    memory.set(MemorySubsystem::FAISS_INDEX, 3000);
+    memory.set(MemorySubsystem::FAISS_INDEX, 1000);
+    memory.note_peak(MemorySubsystem::SQLITE, 7000);
+    std::vector<MemoryMetrics> usage = memory.snapshot();
+    TEST_ASSERT_EQUAL(static_cast<size_t>(MemorySubsystem::COUNT), usage.size(), "One entry per subsystem");
+    const MemoryMetrics& faiss = usage[static_cast<size_t>(MemorySubsystem::FAISS_INDEX)];
+    TEST_ASSERT_EQUAL(std::string("faiss_index"), faiss.name, "Subsystem name");
+    TEST_ASSERT_EQUAL(uint64_t(1000), faiss.current_bytes, "Polled value replaces the previous one");
+    TEST_ASSERT_EQUAL(uint64_t(3000), faiss.peak_bytes, "Polled high-water mark");
+    TEST_ASSERT_EQUAL(uint64_t(7000), memory.peak(MemorySubsystem::SQLITE), "Component-reported peak");
+    TEST_ASSERT_EQUAL(base + 1000, memory.total(), "Total follows the subsystems");
+
+    // Budgets: per subsystem and for the total
+    TEST_ASSERT(!memory.over_budget(), "No budget set");
+    memory.set_budget(MemorySubsystem::FAISS_INDEX, 999);
+    TEST_ASSERT(memory.over_budget(), "Subsystem over its budget");
+    memory.set_budget(MemorySubsystem::FAISS_INDEX, 0);
+    memory.set_total_budget(base + 500);
+    TEST_ASSERT(memory.over_budget(), "Total over its budget");
+    memory.set(MemorySubsystem::FAISS_INDEX, 0);
+    TEST_ASSERT(!memory.over_budget(), "Back under budget");
+    memory.set_total_budget(0);
+
+    memory.reset_peaks();
+    TEST_ASSERT_EQUAL(uint64_t(0), memory.peak(MemorySubsystem::FAISS_INDEX), "Reset restarts from current usage");
+
+    uint64_t resident = 0;
+    uint64_t peak_resident = 0;
+    if (process_resident_memory(resident, peak_resident)) {
+        TEST_ASSERT(resident > 0 && peak_resident >= resident, "Process resident size");
+    }
+    return true;
+}
+
+bool test_memory_reclaim() {
+    MemoryAccountant& memory = MemoryAccountant::instance();
+    std::vector<std::string> order;
+    uint64_t cache_bytes = 3000;
+    uint64_t scratch_bytes = 2000;
+    uint64_t model_bytes = 10000;
+    memory.set(MemorySubsystem::QUERY_CACHES, cache_bytes);
+
+    // A cache that gives back exactly what is asked, scratch that frees everything at once
+    auto cache = std::make_unique<MemoryAccountant::Reclaimer>(
+        "cache", MemorySubsystem::QUERY_CACHES, ReclaimPriority::CACHE, [&] { return cache_bytes; },
+        [&](uint64_t bytes) {
+            order.push_back("cache");
+            uint64_t freed = std::min(bytes, cache_bytes);
+            cache_bytes -= freed;
+            memory.set(MemorySubsystem::QUERY_CACHES, cache_bytes);
+            return freed;
+        });
+    MemoryAccountant::Reclaimer model("model", MemorySubsystem::LLM_WEIGHTS, ReclaimPriority::MODEL, [&] { return model_bytes; },
+        [&](uint64_t) {
+            order.push_back("model");
+            uint64_t freed = model_bytes;
+            model_bytes = 0;
+            return freed;
+        });
+    MemoryAccountant::Reclaimer scratch("scratch", MemorySubsystem::CHUNKING_SCRATCH, ReclaimPriority::SCRATCH, [&] { return scratch_bytes; },
+        [&](uint64_t) {
+            order.push_back("scratch");
+            uint64_t freed = scratch_bytes;
+            scratch_bytes = 0;
+            return freed;
+        });
+
+    TEST_ASSERT_EQUAL(uint64_t(15000), memory.reclaimable(), "Reclaimable sums every reclaimer");
+    TEST_ASSERT_EQUAL(uint64_t(5000), memory.reclaimable(ReclaimPriority::WARM_STATE), "Models excluded by priority");
+
+    TEST_ASSERT_EQUAL(uint64_t(1000), memory.reclaim(1000), "Small request served by the cache alone");
+    TEST_ASSERT(order == std::vector<std::string>({"cache"}), "Cheapest reclaimer asked first");
+    TEST_ASSERT_EQUAL(uint64_t(2000), memory.current(MemorySubsystem::QUERY_CACHES), "Cache reported its new size");
+
+    order.clear();
+    TEST_ASSERT_EQUAL(uint64_t(4000), memory.reclaim(3000), "Scratch frees more than the remainder");
+    TEST_ASSERT(order == std::vector<std::string>({"cache", "scratch"}), "Priority order, model untouched");
+
+    order.clear();
+    TEST_ASSERT_EQUAL(uint64_t(0), memory.reclaim(UINT64_MAX, ReclaimPriority::WARM_STATE), "Nothing left below the model");
+    TEST_ASSERT(order.empty(), "Empty reclaimers aren't called");
+    TEST_ASSERT_EQUAL(uint64_t(10000), memory.reclaim(1, ReclaimPriority::MODEL, MemorySubsystem::LLM_WEIGHTS), "Subsystem filter");
+
+    // Excess over budgets
+    memory.set(MemorySubsystem::QUERY_CACHES, 3000);
+    memory.set_budget(MemorySubsystem::QUERY_CACHES, 1000);
+    TEST_ASSERT_EQUAL(uint64_t(2000), memory.excess(MemorySubsystem::QUERY_CACHES), "Subsystem excess");
+    memory.set_budget(MemorySubsystem::QUERY_CACHES, 0);
+    TEST_ASSERT_EQUAL(uint64_t(0), memory.excess(MemorySubsystem::QUERY_CACHES), "No budget, no excess");
+    memory.set_total_budget(memory.total() - 100);
+    TEST_ASSERT_EQUAL(uint64_t(100), memory.excess(), "Total excess");
+    memory.set_total_budget(0);
+    memory.set(MemorySubsystem::QUERY_CACHES, 0);
+
+    cache.reset();
+    TEST_ASSERT_EQUAL(uint64_t(0), memory.reclaimable(ReclaimPriority::CACHE), "Removed with its registration");
+    return true;
+}
+
+size_t count_occurrences(const std::string& text, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + needle.size())) {
+        count++;
+    }
+    return count;
+}
+
+bool test_trace_export() {
+    {
+        LEAFRA_TRACE_SCOPE("test", "before_start");
+    }
+    trace::start();
+    TEST_ASSERT(trace::is_enabled(), "Tracing enabled after start");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([t] {
+            trace::set_thread_name("Worker " + std::to_string(t));
+            for (int i = 0; i < 10; ++i) {
+                trace::Span outer("test", "outer");
+                outer.arg("index", i);
+                outer.arg("file", std::string("dir/\"quoted\"\n.txt"));
+                LEAFRA_TRACE_SCOPE("test", "inner");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    PipelineMetricsRecorder recorder;
+    {
+        PipelineMetricsRecorder::ScopedStage timing(recorder, PipelineStage::EMBED);
+        timing.set_items(7);
+    }
+    trace::stop();
+    {
+        LEAFRA_TRACE_SCOPE("test", "after_stop");
+    }
+
+    TEST_ASSERT_EQUAL(size_t(61), trace::event_count(), "Spans recorded only while tracing");
+    std::string json = trace::to_chrome_json();
+    TEST_ASSERT(json.rfind("{\"traceEvents\":[", 0) == 0, "Chrome trace object");
+    TEST_ASSERT_EQUAL(size_t(30), count_occurrences(json, "\"name\":\"outer\""), "Outer spans");
+    TEST_ASSERT_EQUAL(size_t(30), count_occurrences(json, "\"name\":\"inner\""), "Inner spans");
+    TEST_ASSERT_EQUAL(size_t(3), count_occurrences(json, "\"name\":\"thread_name\""), "Thread name metadata");
+    TEST_ASSERT(json.find("\"name\":\"Worker 2\"") != std::string::npos, "Thread name exported");
+    TEST_ASSERT(json.find("\"file\":\"dir/\\\"quoted\\\"\\n.txt\"") != std::string::npos, "Argument escaped");
+    TEST_ASSERT(json.find("\"cat\":\"pipeline\",\"name\":\"embed\"") != std::string::npos, "Pipeline stage span");
+    TEST_ASSERT(json.find("\"items\":7") != std::string::npos, "Stage items argument");
+    TEST_ASSERT(json.find("before_start") == std::string::npos && json.find("after_stop") == std::string::npos,
+                "Nothing recorded outside start/stop");
+
+    trace::start(5);
+    for (int i = 0; i < 8; ++i) {
+        LEAFRA_TRACE_SCOPE("test", "capped");
+    }
+    trace::stop();
+    TEST_ASSERT_EQUAL(size_t(5), trace::event_count(), "Per-thread limit");
+    TEST_ASSERT_EQUAL(uint64_t(3), trace::dropped_count(), "Dropped spans counted");
+    trace::clear();
+    TEST_ASSERT_EQUAL(size_t(0), trace::event_count(), "Clear discards events");
+    return true;
+}
+
+int main() {
+    std::cout << "=== Pipeline Metrics Tests ===" << std::endl;
+    
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+    
+    RUN_TEST(test_bucket_bounds);
+    RUN_TEST(test_percentiles);
+    RUN_TEST(test_recorder_snapshot);
+    RUN_TEST(test_trace_export);
+    RUN_TEST(test_memory_accounting);
+    RUN_TEST(test_memory_reclaim);
+    
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+    
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,145 @@
+#include "../../../include/leafra/leafra_model_registry.h"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+struct FakeModel {
+    std::string path;
+};
+
+static std::shared_ptr<FakeModel> load_fake(const std::string& path, int& loads) {
+    loads++;
+    return std::make_shared<FakeModel>(FakeModel{path});
+}
+
+bool test_same_key_is_shared() {
+    auto& registry = ModelRegistry<FakeModel>::instance();
+    int loads = 0;
+    bool shared = true;
+    auto first = registry.acquire("a.gguf|gpu=0", [&]() { return load_fake("a.gguf", loads); }, &shared);
+    TEST_ASSERT(first != nullptr, "The first acquire should load");
+    TEST_ASSERT(!shared, "A fresh load isn't shared");
+
+    auto second = registry.acquire("a.gguf|gpu=0", [&]() { return load_fake("a.gguf", loads); }, &shared);
+    TEST_ASSERT(shared, "The second acquire should share");
+    TEST_ASSERT(first.get() == second.get(), "Both holders should get the same model");
+    TEST_ASSERT_EQUAL(1, loads, "The model should be loaded once");
+
+    auto other = registry.acquire("a.gguf|gpu=99", [&]() { return load_fake("a.gguf", loads); });
+    TEST_ASSERT(other.get() != first.get(), "Different load options need their own model");
+    TEST_ASSERT_EQUAL(2, loads, "Different options should load again");
+    TEST_ASSERT_EQUAL(size_t(2), registry.live_count(), "Two models should be alive");
+    return true;
+}
+
+bool test_last_holder_frees() {
+    auto& registry = ModelRegistry<FakeModel>::instance();
+    int loads = 0;
+    std::weak_ptr<FakeModel> watch;
+    {
+        auto model = registry.acquire("b.tflite", [&]() { return load_fake("b.tflite", loads); });
+        watch = model;
+    }
+    TEST_ASSERT(watch.expired(), "The registry shouldn't keep a model alive");
+    TEST_ASSERT_EQUAL(size_t(0), registry.live_count(), "Nothing should be alive once released");
+
+    auto reloaded = registry.acquire("b.tflite", [&]() { return load_fake("b.tflite", loads); });
+    TEST_ASSERT_EQUAL(2, loads, "A released model should load again");
+    return true;
+}
+
+bool test_failed_load_is_not_registered() {
+    auto& registry = ModelRegistry<FakeModel>::instance();
+    auto missing = registry.acquire("missing", []() { return std::shared_ptr<FakeModel>(); });
+    TEST_ASSERT(missing == nullptr, "A failed load returns nullptr");
+
+    int loads = 0;
+    auto retried = registry.acquire("missing", [&]() { return load_fake("missing", loads); });
+    TEST_ASSERT(retried != nullptr && loads == 1, "A failed load should be retried next time");
+    return true;
+}
+
+bool test_concurrent_acquire_loads_once() {
+    auto& registry = ModelRegistry<FakeModel>::instance();
+    std::atomic<int> loads{0};
+    std::vector<std::shared_ptr<FakeModel>> models(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < models.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            models[i] = registry.acquire("c.gguf", [&]() {
+                loads++;
+                return std::make_shared<FakeModel>(FakeModel{"c.gguf"});
+            });
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    TEST_ASSERT_EQUAL(1, loads.load(), "Cores starting together should load once");
+    for (const auto& model : models) {
+        TEST_ASSERT(model.get() == models[0].get(), "Every thread should get the same model");
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "=== ModelRegistry Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_same_key_is_shared);
+    RUN_TEST(test_last_holder_frees);
+    RUN_TEST(test_failed_load_is_not_registered);
+    RUN_TEST(test_concurrent_acquire_loads_once);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
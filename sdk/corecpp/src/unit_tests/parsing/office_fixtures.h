@@ -0,0 +1,375 @@
+#pragma once
+
+// Office Open XML packages for test_office_parsing, written with Python's zipfile
+// (ZIP_DEFLATED) so the inflater is exercised on real encoder output.
+//
+// kDocxFixture: word/document.xml with entities, a tab-stop definition, a line break,
+//   deleted text and a field code, an explicit page break followed by Word's rendered
+//   break, a 2x2 table, a paragraph-level section break; docProps/core.xml with
+//   title "Quarterly Report" and creator "Jane Doe".
+// kXlsxFixture: sheets "Sales" (-> /xl/worksheets/sales.xml) and "Notes & Misc"
+//   (-> worksheets/notes.xml) listed in the opposite order of their relationships;
+//   shared strings with a rich-text run and a phonetic run; a number, a boolean after
+//   an empty column, an inline string containing a newline and a t="str" cell.
+// kLargeZipFixture: big.txt = "entry NNN of the generated payload\n" for i in 0..5999
+//   with NNN = i % 400 (210000 bytes), well past the 32 KiB window.
+
+const unsigned char kDocxFixture[] = {
+    0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0xc7, 0x1c,
+    0x17, 0x3c, 0x0a, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x5b, 0x43,
+    0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x5f, 0x54, 0x79, 0x70, 0x65, 0x73, 0x5d, 0x2e, 0x78, 0x6d,
+    0x6c, 0xb3, 0x09, 0xa9, 0x2c, 0x48, 0x2d, 0xd6, 0xb7, 0x03, 0x00, 0x50, 0x4b, 0x03, 0x04, 0x14,
+    0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0xbf, 0xc6, 0x74, 0xaa, 0x92, 0x01, 0x00,
+    0x00, 0xcc, 0x03, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00, 0x77, 0x6f, 0x72, 0x64, 0x2f, 0x64, 0x6f,
+    0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x78, 0x6d, 0x6c, 0x95, 0x53, 0x4d, 0x4f, 0xc3, 0x30,
+    0x0c, 0xbd, 0xf3, 0x2b, 0xa2, 0x20, 0x71, 0x83, 0x6c, 0x05, 0x01, 0x2a, 0x6b, 0x10, 0x43, 0xc0,
+    0x85, 0xc3, 0x04, 0xe3, 0x07, 0xa4, 0x89, 0xb7, 0x55, 0xb4, 0x49, 0x94, 0x84, 0x95, 0xf1, 0xeb,
+    0x71, 0xd2, 0x8e, 0xf1, 0x31, 0x86, 0x38, 0x59, 0x8e, 0x9f, 0xfd, 0xfc, 0x1c, 0x7b, 0x74, 0xf9,
+    0xda, 0xd4, 0x64, 0x09, 0xce, 0x57, 0x46, 0x17, 0x74, 0x78, 0x34, 0xa0, 0x04, 0xb4, 0x34, 0xaa,
+    0xd2, 0xf3, 0x82, 0x3e, 0x4d, 0x6f, 0x0f, 0xcf, 0x29, 0xf1, 0x41, 0x68, 0x25, 0x6a, 0xa3, 0xa1,
+    0xa0, 0x2b, 0xf0, 0xf4, 0x92, 0xef, 0x8d, 0xda, 0x5c, 0x19, 0xf9, 0xd2, 0x80, 0x0e, 0x04, 0x2b,
+    0x68, 0x9f, 0xb7, 0x05, 0x5d, 0x84, 0x60, 0x73, 0xc6, 0xbc, 0x5c, 0x40, 0x23, 0xfc, 0x91, 0xb1,
+    0xa0, 0x31, 0x36, 0x33, 0xae, 0x11, 0x01, 0x5d, 0x37, 0x67, 0xad, 0x71, 0xca, 0x3a, 0x23, 0xc1,
+    0x7b, 0x24, 0x68, 0x6a, 0x96, 0x0d, 0x06, 0xa7, 0xac, 0x11, 0x95, 0xa6, 0x1c, 0x4b, 0x96, 0x46,
+    0xad, 0x52, 0x6d, 0x1b, 0x3d, 0x3b, 0x71, 0xd1, 0x04, 0x51, 0xfa, 0xde, 0x92, 0x36, 0x5f, 0x8a,
+    0xba, 0xa0, 0x35, 0xcc, 0x02, 0x45, 0xc7, 0x1a, 0x5f, 0xd0, 0xb3, 0x6c, 0x40, 0x19, 0x1f, 0xb1,
+    0x35, 0x92, 0x7d, 0x64, 0x76, 0xe9, 0xfc, 0x5a, 0xcc, 0x0e, 0xf6, 0xb3, 0xe3, 0xe3, 0x0b, 0x72,
+    0x20, 0x1a, 0x7b, 0x41, 0xc6, 0xc2, 0x25, 0x74, 0x82, 0x7e, 0x02, 0x8a, 0x92, 0x25, 0x1b, 0x05,
+    0xe5, 0xde, 0x0a, 0x89, 0x72, 0xad, 0x03, 0x0f, 0x6e, 0x09, 0x94, 0x13, 0x8c, 0x7f, 0x49, 0x8b,
+    0x3c, 0x9b, 0x66, 0x7b, 0xae, 0xfb, 0x4a, 0x43, 0x8f, 0x42, 0x39, 0xae, 0x2b, 0xc8, 0x43, 0x6b,
+    0xb6, 0x31, 0x2a, 0xa8, 0xa7, 0xf0, 0x1a, 0x38, 0x5a, 0x08, 0xa0, 0x62, 0x70, 0xfd, 0x84, 0xd1,
+    0x4a, 0xfb, 0xe0, 0x92, 0x33, 0xb9, 0xba, 0xbb, 0x89, 0xc1, 0xcd, 0xcb, 0xef, 0x2d, 0x94, 0x0e,
+    0xe7, 0x12, 0x56, 0x36, 0xf6, 0x2e, 0xe6, 0xd0, 0x4f, 0x66, 0xc3, 0x59, 0x0b, 0x1f, 0x1e, 0x40,
+    0x2b, 0x70, 0xa0, 0x26, 0x08, 0x18, 0x3b, 0x10, 0xcf, 0x7d, 0x9b, 0x8f, 0x20, 0x8d, 0x56, 0x24,
+    0xe6, 0x6d, 0x57, 0x1a, 0xca, 0x3a, 0x21, 0x3b, 0xb1, 0x92, 0x7f, 0x13, 0x7f, 0x35, 0xfc, 0x99,
+    0x96, 0x5e, 0xe4, 0x76, 0xfc, 0x78, 0x07, 0x9e, 0x25, 0x9a, 0xbd, 0x5d, 0x6c, 0xd9, 0x3f, 0xd9,
+    0x76, 0xe0, 0x3b, 0xb6, 0x64, 0x50, 0xe2, 0xf7, 0x0d, 0xf4, 0x20, 0xc3, 0xc4, 0xb1, 0x2d, 0xab,
+    0x75, 0x83, 0xe3, 0x32, 0x33, 0x12, 0x01, 0x78, 0x3f, 0x7f, 0xaf, 0xc7, 0x74, 0x51, 0xb9, 0x5d,
+    0x03, 0xee, 0x98, 0x12, 0xf5, 0xfc, 0xf1, 0x0d, 0x7f, 0x12, 0xaf, 0x6a, 0x98, 0x65, 0x27, 0xeb,
+    0x0d, 0x5f, 0xc7, 0x59, 0x7f, 0x2b, 0x69, 0x65, 0xfa, 0x3b, 0xe4, 0xef, 0x50, 0x4b, 0x03, 0x04,
+    0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0xb9, 0x53, 0x76, 0x99, 0xa4, 0x00,
+    0x00, 0x00, 0xf6, 0x00, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00, 0x64, 0x6f, 0x63, 0x50, 0x72, 0x6f,
+    0x70, 0x73, 0x2f, 0x63, 0x6f, 0x72, 0x65, 0x2e, 0x78, 0x6d, 0x6c, 0x65, 0x8e, 0xbd, 0x0e, 0x82,
+    0x30, 0x14, 0x85, 0x5f, 0xa5, 0xb9, 0x3b, 0x52, 0x10, 0x13, 0xd3, 0xb4, 0x65, 0x31, 0x0e, 0x4e,
+    0x6a, 0x70, 0x71, 0x23, 0xe5, 0xc6, 0x34, 0x81, 0x96, 0x5c, 0xaa, 0x01, 0x9f, 0x5e, 0x50, 0xd4,
+    0x18, 0xc7, 0xf3, 0x9d, 0x9f, 0x1c, 0x99, 0xf7, 0x4d, 0xcd, 0x6e, 0x48, 0x9d, 0xf5, 0x4e, 0x41,
+    0xb2, 0xe0, 0xc0, 0xd0, 0x19, 0x5f, 0x59, 0x77, 0x51, 0x70, 0x2a, 0xb6, 0xd1, 0x1a, 0x72, 0x2d,
+    0x4d, 0x2b, 0x8c, 0x27, 0xdc, 0x93, 0x6f, 0x91, 0x82, 0xc5, 0x8e, 0x8d, 0x35, 0xd7, 0x09, 0xd3,
+    0x2a, 0xe8, 0x61, 0x16, 0x95, 0x51, 0x30, 0x7c, 0x45, 0x40, 0x6a, 0x3a, 0x05, 0x77, 0xd0, 0xb2,
+    0x32, 0x22, 0xd8, 0x50, 0xa3, 0x3e, 0x5c, 0x4b, 0x1a, 0x79, 0x3d, 0xb0, 0x23, 0xb6, 0x9e, 0x82,
+    0x8c, 0x3f, 0xd6, 0x14, 0x32, 0x84, 0x65, 0xf0, 0xa4, 0x77, 0xa5, 0x43, 0xb6, 0xf1, 0xf8, 0xb4,
+    0xdf, 0x50, 0xce, 0x93, 0x2f, 0x80, 0x95, 0x4e, 0x79, 0x9a, 0x45, 0x3c, 0x89, 0x78, 0x5a, 0xf0,
+    0xa5, 0xe0, 0x99, 0xe0, 0xab, 0xf3, 0xd4, 0xf8, 0x4d, 0xc9, 0xf8, 0xef, 0xbc, 0x7e, 0x00, 0x50,
+    0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0xc7,
+    0x1c, 0x17, 0x3c, 0x0a, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x5b, 0x43, 0x6f,
+    0x6e, 0x74, 0x65, 0x6e, 0x74, 0x5f, 0x54, 0x79, 0x70, 0x65, 0x73, 0x5d, 0x2e, 0x78, 0x6d, 0x6c,
+    0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d,
+    0xbf, 0xc6, 0x74, 0xaa, 0x92, 0x01, 0x00, 0x00, 0xcc, 0x03, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x3b, 0x00, 0x00, 0x00, 0x77, 0x6f,
+    0x72, 0x64, 0x2f, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x78, 0x6d, 0x6c, 0x50,
+    0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0xb9,
+    0x53, 0x76, 0x99, 0xa4, 0x00, 0x00, 0x00, 0xf6, 0x00, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0xfc, 0x01, 0x00, 0x00, 0x64, 0x6f, 0x63,
+    0x50, 0x72, 0x6f, 0x70, 0x73, 0x2f, 0x63, 0x6f, 0x72, 0x65, 0x2e, 0x78, 0x6d, 0x6c, 0x50, 0x4b,
+    0x05, 0x06, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x03, 0x00, 0xbf, 0x00, 0x00, 0x00, 0xcf, 0x02,
+    0x00, 0x00, 0x00, 0x00,
+};
+
+const unsigned char kXlsxFixture[] = {
+    0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0x56, 0x23,
+    0x19, 0xf4, 0x77, 0x00, 0x00, 0x00, 0xac, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x00, 0x00, 0x78, 0x6c,
+    0x2f, 0x77, 0x6f, 0x72, 0x6b, 0x62, 0x6f, 0x6f, 0x6b, 0x2e, 0x78, 0x6d, 0x6c, 0xb3, 0xb1, 0xaf,
+    0xc8, 0xcd, 0x51, 0x28, 0x4b, 0x2d, 0x2a, 0xce, 0xcc, 0xcf, 0xb3, 0x55, 0x32, 0xd4, 0x33, 0x50,
+    0xb2, 0xb7, 0xb3, 0x29, 0xcf, 0x2f, 0xca, 0x4e, 0xca, 0xcf, 0xcf, 0x56, 0x00, 0x4a, 0xe6, 0x15,
+    0x5b, 0x15, 0xd9, 0x2a, 0x15, 0x29, 0xd9, 0xd9, 0x14, 0x67, 0xa4, 0xa6, 0x96, 0x14, 0x43, 0x69,
+    0x85, 0xbc, 0xc4, 0xdc, 0x54, 0x5b, 0xa5, 0xe0, 0xc4, 0x9c, 0xd4, 0x62, 0x25, 0x05, 0xb0, 0x90,
+    0x67, 0x0a, 0xd0, 0x00, 0x25, 0x85, 0x22, 0xab, 0x4c, 0x20, 0xa3, 0xc8, 0x33, 0xc5, 0x48, 0x49,
+    0x1f, 0x55, 0xb1, 0x5f, 0x7e, 0x49, 0x6a, 0xb1, 0x82, 0x5a, 0x62, 0x6e, 0x81, 0xb5, 0x82, 0x6f,
+    0x66, 0x71, 0x32, 0x92, 0x3e, 0x23, 0x24, 0x7d, 0x86, 0x20, 0x7d, 0xfa, 0x30, 0xdb, 0xf4, 0x61,
+    0x8e, 0xb1, 0x03, 0x00, 0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64,
+    0x4e, 0x5d, 0x2e, 0x84, 0x62, 0xfd, 0x61, 0x00, 0x00, 0x00, 0xa6, 0x00, 0x00, 0x00, 0x1a, 0x00,
+    0x00, 0x00, 0x78, 0x6c, 0x2f, 0x5f, 0x72, 0x65, 0x6c, 0x73, 0x2f, 0x77, 0x6f, 0x72, 0x6b, 0x62,
+    0x6f, 0x6f, 0x6b, 0x2e, 0x78, 0x6d, 0x6c, 0x2e, 0x72, 0x65, 0x6c, 0x73, 0xb3, 0xb1, 0xaf, 0xc8,
+    0xcd, 0x51, 0x28, 0x4b, 0x2d, 0x2a, 0xce, 0xcc, 0xcf, 0xb3, 0x55, 0x32, 0xd4, 0x33, 0x50, 0xb2,
+    0xb7, 0xb3, 0x09, 0x4a, 0xcd, 0x49, 0x2c, 0x01, 0x0a, 0x14, 0x67, 0x64, 0x16, 0x14, 0xa3, 0x72,
+    0x15, 0x3c, 0x53, 0x6c, 0x95, 0x8a, 0x3c, 0x53, 0x0c, 0x95, 0x14, 0x42, 0x12, 0x8b, 0xd2, 0x53,
+    0x4b, 0x6c, 0x95, 0xca, 0xf3, 0x8b, 0xb2, 0x8b, 0x33, 0x52, 0x53, 0x4b, 0x8a, 0xf5, 0xf3, 0xf2,
+    0x4b, 0x52, 0x8b, 0xf5, 0x80, 0x46, 0x2a, 0xe9, 0x63, 0xd7, 0x66, 0x84, 0xd0, 0xa6, 0x5f, 0x91,
+    0xa3, 0x8f, 0xa4, 0xb5, 0x38, 0x31, 0x07, 0xa1, 0x55, 0x1f, 0xd5, 0x05, 0x00, 0x50, 0x4b, 0x03,
+    0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0x59, 0x24, 0x2c, 0x79, 0x5f,
+    0x00, 0x00, 0x00, 0x90, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x78, 0x6c, 0x2f, 0x73, 0x68,
+    0x61, 0x72, 0x65, 0x64, 0x53, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x73, 0x2e, 0x78, 0x6d, 0x6c, 0xb3,
+    0xb1, 0xaf, 0xc8, 0xcd, 0x51, 0x28, 0x4b, 0x2d, 0x2a, 0xce, 0xcc, 0xcf, 0xb3, 0x55, 0x32, 0xd4,
+    0x33, 0x50, 0xb2, 0xb7, 0xb3, 0x29, 0x2e, 0x2e, 0x01, 0x12, 0x99, 0x76, 0x36, 0x25, 0x76, 0x41,
+    0xa9, 0xe9, 0x40, 0x19, 0x1b, 0x7d, 0xa0, 0x80, 0x3e, 0x48, 0x04, 0x84, 0x8b, 0x40, 0x12, 0x21,
+    0xf9, 0x10, 0xc1, 0x22, 0x28, 0xbf, 0x24, 0x31, 0x07, 0x2e, 0x00, 0x57, 0x59, 0x62, 0xe7, 0x97,
+    0x5f, 0x54, 0x92, 0x01, 0x96, 0x28, 0x0a, 0xc8, 0x00, 0x09, 0x3c, 0x6e, 0xee, 0x7b, 0xdc, 0xbc,
+    0xe7, 0x71, 0xd3, 0x4e, 0xa8, 0x6a, 0x90, 0x28, 0x58, 0xbd, 0x3e, 0xc8, 0x56, 0x00, 0x50, 0x4b,
+    0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0x3b, 0x43, 0xa7, 0xd7,
+    0x9b, 0x00, 0x00, 0x00, 0x36, 0x01, 0x00, 0x00, 0x17, 0x00, 0x00, 0x00, 0x78, 0x6c, 0x2f, 0x77,
+    0x6f, 0x72, 0x6b, 0x73, 0x68, 0x65, 0x65, 0x74, 0x73, 0x2f, 0x73, 0x61, 0x6c, 0x65, 0x73, 0x2e,
+    0x78, 0x6d, 0x6c, 0x7d, 0x90, 0x51, 0x0e, 0x82, 0x30, 0x0c, 0x86, 0xdf, 0x3d, 0x05, 0xd9, 0x01,
+    0x28, 0x0c, 0x7d, 0x2b, 0x25, 0x10, 0x6e, 0xe0, 0x09, 0x90, 0x2c, 0x71, 0x11, 0x21, 0xd9, 0x9a,
+    0xc1, 0xf1, 0x1d, 0x43, 0x07, 0xfa, 0xe0, 0xd3, 0xba, 0xff, 0xff, 0xfb, 0x35, 0x2d, 0x56, 0xcb,
+    0x73, 0x48, 0x9c, 0x32, 0x56, 0x4f, 0x63, 0x29, 0xf2, 0x34, 0x13, 0x15, 0xe1, 0x3c, 0x99, 0x87,
+    0xbd, 0x2b, 0xc5, 0x84, 0xe1, 0x69, 0x3b, 0xee, 0x08, 0xcd, 0x34, 0x27, 0xc6, 0x67, 0x04, 0x61,
+    0xbf, 0x16, 0x75, 0x2e, 0x12, 0x2e, 0x85, 0xf5, 0x7f, 0x47, 0x19, 0x82, 0x23, 0x84, 0xfe, 0xed,
+    0x35, 0x47, 0x2f, 0x8f, 0x1e, 0x78, 0x46, 0x04, 0xc9, 0x08, 0x92, 0x87, 0xb0, 0xfc, 0x01, 0xc9,
+    0xa0, 0x9e, 0x65, 0x7a, 0xf9, 0x36, 0xda, 0xad, 0xe9, 0xf6, 0x6f, 0x42, 0xf1, 0x99, 0xd0, 0x14,
+    0x21, 0xac, 0xc7, 0x41, 0x8f, 0xea, 0xca, 0xc6, 0xeb, 0xda, 0x12, 0x32, 0x6d, 0xca, 0x89, 0xd5,
+    0xc2, 0x08, 0x7e, 0x5d, 0x58, 0xe5, 0x9d, 0x03, 0x87, 0xf5, 0x61, 0xbf, 0xca, 0x0b, 0x50, 0x4b,
+    0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0x88, 0x0e, 0xf3, 0xc2,
+    0x59, 0x00, 0x00, 0x00, 0x75, 0x00, 0x00, 0x00, 0x17, 0x00, 0x00, 0x00, 0x78, 0x6c, 0x2f, 0x77,
+    0x6f, 0x72, 0x6b, 0x73, 0x68, 0x65, 0x65, 0x74, 0x73, 0x2f, 0x6e, 0x6f, 0x74, 0x65, 0x73, 0x2e,
+    0x78, 0x6d, 0x6c, 0x4d, 0x4c, 0x5b, 0x0a, 0x80, 0x20, 0x10, 0xbc, 0x8a, 0xec, 0x01, 0x32, 0xff,
+    0xb7, 0x95, 0xa0, 0x8b, 0x88, 0x08, 0x45, 0xa5, 0xb0, 0x2e, 0xda, 0xf1, 0xdb, 0xfa, 0xa9, 0x8f,
+    0x79, 0x30, 0xcc, 0x0c, 0xfa, 0xeb, 0x3c, 0x4c, 0x4b, 0x5c, 0xb7, 0x92, 0x27, 0x70, 0xc3, 0x08,
+    0x9e, 0xb0, 0x17, 0xde, 0xeb, 0x9a, 0x92, 0x10, 0xbe, 0xb2, 0x04, 0x09, 0x84, 0x5c, 0xba, 0x61,
+    0xed, 0x00, 0x61, 0x7c, 0xcc, 0xec, 0xc0, 0xc8, 0x04, 0x55, 0x58, 0x93, 0x46, 0xb9, 0x48, 0x42,
+    0xdb, 0x08, 0x6d, 0x54, 0x68, 0x59, 0xf9, 0xb7, 0xb6, 0xdf, 0xe9, 0x0d, 0x50, 0x4b, 0x01, 0x02,
+    0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0x56, 0x23, 0x19, 0xf4,
+    0x77, 0x00, 0x00, 0x00, 0xac, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x78, 0x6c, 0x2f, 0x77, 0x6f, 0x72,
+    0x6b, 0x62, 0x6f, 0x6f, 0x6b, 0x2e, 0x78, 0x6d, 0x6c, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14,
+    0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0x2e, 0x84, 0x62, 0xfd, 0x61, 0x00, 0x00,
+    0x00, 0xa6, 0x00, 0x00, 0x00, 0x1a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x80, 0x01, 0xa4, 0x00, 0x00, 0x00, 0x78, 0x6c, 0x2f, 0x5f, 0x72, 0x65, 0x6c, 0x73, 0x2f,
+    0x77, 0x6f, 0x72, 0x6b, 0x62, 0x6f, 0x6f, 0x6b, 0x2e, 0x78, 0x6d, 0x6c, 0x2e, 0x72, 0x65, 0x6c,
+    0x73, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e,
+    0x5d, 0x59, 0x24, 0x2c, 0x79, 0x5f, 0x00, 0x00, 0x00, 0x90, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x3d, 0x01, 0x00, 0x00, 0x78,
+    0x6c, 0x2f, 0x73, 0x68, 0x61, 0x72, 0x65, 0x64, 0x53, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x73, 0x2e,
+    0x78, 0x6d, 0x6c, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d,
+    0x64, 0x4e, 0x5d, 0x3b, 0x43, 0xa7, 0xd7, 0x9b, 0x00, 0x00, 0x00, 0x36, 0x01, 0x00, 0x00, 0x17,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0xce, 0x01, 0x00,
+    0x00, 0x78, 0x6c, 0x2f, 0x77, 0x6f, 0x72, 0x6b, 0x73, 0x68, 0x65, 0x65, 0x74, 0x73, 0x2f, 0x73,
+    0x61, 0x6c, 0x65, 0x73, 0x2e, 0x78, 0x6d, 0x6c, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00,
+    0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0x88, 0x0e, 0xf3, 0xc2, 0x59, 0x00, 0x00, 0x00,
+    0x75, 0x00, 0x00, 0x00, 0x17, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x80, 0x01, 0x9e, 0x02, 0x00, 0x00, 0x78, 0x6c, 0x2f, 0x77, 0x6f, 0x72, 0x6b, 0x73, 0x68, 0x65,
+    0x65, 0x74, 0x73, 0x2f, 0x6e, 0x6f, 0x74, 0x65, 0x73, 0x2e, 0x78, 0x6d, 0x6c, 0x50, 0x4b, 0x05,
+    0x06, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x05, 0x00, 0x51, 0x01, 0x00, 0x00, 0x2c, 0x03, 0x00,
+    0x00, 0x00, 0x00,
+};
+
+const unsigned char kLargeZipFixture[] = {
+    0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0xa1, 0x00,
+    0x3b, 0x9c, 0x2a, 0x0d, 0x00, 0x00, 0x50, 0x34, 0x03, 0x00, 0x07, 0x00, 0x00, 0x00, 0x62, 0x69,
+    0x67, 0x2e, 0x74, 0x78, 0x74, 0xed, 0xdb, 0xb1, 0x8d, 0x20, 0xe8, 0x71, 0x05, 0x61, 0x5f, 0x51,
+    0x6c, 0x08, 0xd7, 0x7f, 0xcf, 0xec, 0xcc, 0x86, 0x73, 0x00, 0x97, 0x92, 0x21, 0x90, 0x02, 0x71,
+    0x0e, 0xb3, 0x97, 0x23, 0x47, 0x40, 0x35, 0x2a, 0x81, 0xf2, 0x3f, 0xeb, 0x79, 0xcf, 0xa8, 0xdf,
+    0xff, 0xf8, 0xeb, 0x5f, 0xff, 0xfe, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf8, 0xe7, 0xdf, 0x7f, 0xfc,
+    0xf5, 0x5f, 0xbf, 0x7f, 0xfc, 0xe7, 0xef, 0x7f, 0xfc, 0xfe, 0xd7, 0x9f, 0x7f, 0xfd, 0xfe, 0xdb,
+    0x8f, 0xff, 0xf9, 0xf3, 0xdf, 0xff, 0xfd, 0xcf, 0x3f, 0xff, 0xf6, 0x1f, 0xbf, 0xff, 0x8f, 0x8c,
+    0x93, 0xe7, 0x64, 0x9d, 0x7c, 0x38, 0xf9, 0x74, 0xf2, 0xd3, 0xc9, 0x97, 0x93, 0x6f, 0x27, 0xbf,
+    0x94, 0x8c, 0xaf, 0x3b, 0xbe, 0xee, 0xf8, 0xba, 0xe3, 0xeb, 0x8e, 0xaf, 0x3b, 0xbe, 0xee, 0xf8,
+    0xba, 0xe3, 0xeb, 0x8e, 0xaf, 0x3b, 0xbe, 0xee, 0xf3, 0x75, 0x9f, 0xaf, 0xfb, 0x7c, 0xdd, 0xe7,
+    0xeb, 0x3e, 0x5f, 0xf7, 0xf9, 0xba, 0xcf, 0xd7, 0x7d, 0xbe, 0xee, 0xf3, 0x75, 0x9f, 0xaf, 0xbb,
+    0xbe, 0xee, 0xfa, 0xba, 0xeb, 0xeb, 0xae, 0xaf, 0xbb, 0xbe, 0xee, 0xfa, 0xba, 0xeb, 0xeb, 0xae,
+    0xaf, 0xbb, 0xbe, 0xee, 0xfa, 0xba, 0x1f, 0xbe, 0xee, 0x87, 0xaf, 0xfb, 0xe1, 0xeb, 0x7e, 0xf8,
+    0xba, 0x1f, 0xbe, 0xee, 0x87, 0xaf, 0xfb, 0xe1, 0xeb, 0x7e, 0xf8, 0xba, 0x1f, 0xbe, 0xee, 0x87,
+    0xaf, 0xfb, 0xe9, 0xeb, 0x7e, 0xfa, 0xba, 0x9f, 0xbe, 0xee, 0xa7, 0xaf, 0xfb, 0xe9, 0xeb, 0x7e,
+    0xfa, 0xba, 0x9f, 0xbe, 0xee, 0xa7, 0xaf, 0xfb, 0xe9, 0xeb, 0x7e, 0xfa, 0xba, 0x3f, 0x7d, 0xdd,
+    0x9f, 0xbe, 0xee, 0x4f, 0x5f, 0xf7, 0xa7, 0xaf, 0xfb, 0xd3, 0xd7, 0xfd, 0xe9, 0xeb, 0xfe, 0xf4,
+    0x75, 0x7f, 0xfa, 0xba, 0x3f, 0x7d, 0xdd, 0x9f, 0xbe, 0xee, 0x97, 0xaf, 0xfb, 0xe5, 0xeb, 0x7e,
+    0xf9, 0xba, 0x5f, 0xbe, 0xee, 0x97, 0xaf, 0xfb, 0xe5, 0xeb, 0x7e, 0xf9, 0xba, 0x5f, 0xbe, 0xee,
+    0x97, 0xaf, 0xfb, 0xe5, 0xeb, 0x7e, 0xfb, 0xba, 0xdf, 0xbe, 0xee, 0xb7, 0xaf, 0xfb, 0xed, 0xeb,
+    0x7e, 0xfb, 0xba, 0xdf, 0xbe, 0xee, 0xb7, 0xaf, 0xfb, 0xed, 0xeb, 0x7e, 0xfb, 0xba, 0xdf, 0xbe,
+    0xee, 0x2f, 0x5f, 0xf7, 0x97, 0xaf, 0xfb, 0xcb, 0xd7, 0xfd, 0xe5, 0xeb, 0xfe, 0xf2, 0x75, 0x7f,
+    0xf9, 0xba, 0xbf, 0x7c, 0xdd, 0x5f, 0xbe, 0xee, 0x2f, 0x5f, 0xf7, 0x97, 0xae, 0x3b, 0xfe, 0xd5,
+    0xc6, 0xbf, 0xda, 0xf8, 0x57, 0x1b, 0xff, 0x6a, 0xe3, 0x5f, 0x6d, 0xfc, 0xab, 0x8d, 0x7f, 0xb5,
+    0xf1, 0xaf, 0x36, 0xfe, 0xd5, 0xc6, 0xbf, 0xda, 0xf8, 0x57, 0x1b, 0xff, 0x6a, 0xe3, 0x5f, 0x6d,
+    0xfc, 0xab, 0x8d, 0x7f, 0xb5, 0xf1, 0xaf, 0x36, 0xfe, 0xd5, 0xc6, 0xbf, 0xda, 0xf8, 0x57, 0x1b,
+    0xff, 0x6a, 0xe3, 0x5f, 0x6d, 0xfc, 0xab, 0x8d, 0x7f, 0xb5, 0xf1, 0xaf, 0x36, 0xfe, 0xd5, 0xc6,
+    0xbf, 0xda, 0xf8, 0x57, 0x1b, 0xff, 0x6a, 0xe3, 0x5f, 0x6d, 0xfc, 0xab, 0x8d, 0x7f, 0xb5, 0xf1,
+    0xaf, 0x36, 0xfe, 0xd5, 0xc6, 0xbf, 0xda, 0xf8, 0x57, 0x1b, 0xff, 0x6a, 0xe3, 0x5f, 0x6d, 0xfc,
+    0xab, 0x8d, 0x7f, 0xb5, 0xf1, 0xaf, 0x36, 0xfe, 0xd5, 0xc6, 0xbf, 0xda, 0xf8, 0x57, 0x1b, 0xff,
+    0x6a, 0xe3, 0x5f, 0x6d, 0xfc, 0xab, 0x8d, 0x7f, 0xb5, 0xf1, 0xaf, 0x36, 0xfe, 0xd5, 0xc6, 0xbf,
+    0xda, 0xf8, 0x57, 0x1b, 0xff, 0x6a, 0xe3, 0x5f, 0x6d, 0xfc, 0xab, 0x8d, 0x7f, 0xb5, 0xf1, 0xaf,
+    0x36, 0xfe, 0xd5, 0xc6, 0xbf, 0xda, 0xf8, 0x57, 0x1b, 0xff, 0x6a, 0xe3, 0x5f, 0x6d, 0xfc, 0xab,
+    0x8d, 0x7f, 0xb5, 0xf1, 0xaf, 0x36, 0xfe, 0xd5, 0xc6, 0xbf, 0xda, 0xf8, 0x57, 0x1b, 0xff, 0x6a,
+    0xe3, 0x5f, 0x6d, 0xfc, 0xab, 0x8d, 0x7f, 0xb5, 0xf1, 0xaf, 0x36, 0xfe, 0xd5, 0xc6, 0xbf, 0xda,
+    0xf8, 0x57, 0x1b, 0xff, 0x6a, 0xe3, 0x5f, 0x6d, 0xfc, 0xab, 0x8d, 0x7f, 0xb5, 0xf1, 0xaf, 0x36,
+    0xfe, 0xd5, 0xc6, 0xbf, 0xda, 0xf8, 0x57, 0x1b, 0xff, 0x6a, 0xe3, 0x5f, 0x6d, 0xfc, 0xab, 0x8d,
+    0x7f, 0xb5, 0xf1, 0xaf, 0x36, 0xfe, 0xd5, 0xc6, 0xbf, 0xda, 0xf8, 0x57, 0x1b, 0xff, 0x6a, 0xe3,
+    0x5f, 0x6d, 0xfc, 0xab, 0x8d, 0x7f, 0xb5, 0xf1, 0xaf, 0x36, 0xfe, 0xd5, 0xc6, 0xbf, 0xda, 0xf8,
+    0x57, 0x1b, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf,
+    0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6,
+    0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a,
+    0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf,
+    0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff,
+    0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3,
+    0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d,
+    0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda,
+    0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab,
+    0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf,
+    0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc,
+    0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf,
+    0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6,
+    0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a,
+    0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf,
+    0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff,
+    0x6a, 0xcf, 0xbf, 0xda, 0xf3, 0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xcf, 0xbf, 0xda, 0xf3,
+    0xaf, 0xf6, 0xfc, 0xab, 0x3d, 0xff, 0x6a, 0xeb, 0x5f, 0x6d, 0xfd, 0xab, 0xad, 0x7f, 0xb5, 0xf5,
+    0xaf, 0xb6, 0xfe, 0xd5, 0xd6, 0xbf, 0xda, 0xfa, 0x57, 0x5b, 0xff, 0x6a, 0xeb, 0x5f, 0x6d, 0xfd,
+    0xab, 0xad, 0x7f, 0xb5, 0xf5, 0xaf, 0xb6, 0xfe, 0xd5, 0xd6, 0xbf, 0xda, 0xfa, 0x57, 0x5b, 0xff,
+    0x6a, 0xeb, 0x5f, 0x6d, 0xfd, 0xab, 0xad, 0x7f, 0xb5, 0xf5, 0xaf, 0xb6, 0xfe, 0xd5, 0xd6, 0xbf,
+    0xda, 0xfa, 0x57, 0x5b, 0xff, 0x6a, 0xeb, 0x5f, 0x6d, 0xfd, 0xab, 0xad, 0x7f, 0xb5, 0xf5, 0xaf,
+    0xb6, 0xfe, 0xd5, 0xd6, 0xbf, 0xda, 0xfa, 0x57, 0x5b, 0xff, 0x6a, 0xeb, 0x5f, 0x6d, 0xfd, 0xab,
+    0xad, 0x7f, 0xb5, 0xf5, 0xaf, 0xb6, 0xfe, 0xd5, 0xd6, 0xbf, 0xda, 0xfa, 0x57, 0x5b, 0xff, 0x6a,
+    0xeb, 0x5f, 0x6d, 0xfd, 0xab, 0xad, 0x7f, 0xb5, 0xf5, 0xaf, 0xb6, 0xfe, 0xd5, 0xd6, 0xbf, 0xda,
+    0xfa, 0x57, 0x5b, 0xff, 0x6a, 0xeb, 0x5f, 0x6d, 0xfd, 0xab, 0xad, 0x7f, 0xb5, 0xf5, 0xaf, 0xb6,
+    0xfe, 0xd5, 0xd6, 0xbf, 0xda, 0xfa, 0x57, 0x5b, 0xff, 0x6a, 0xeb, 0x5f, 0x6d, 0xfd, 0xab, 0xad,
+    0x7f, 0xb5, 0xf5, 0xaf, 0xb6, 0xfe, 0xd5, 0xd6, 0xbf, 0xda, 0xfa, 0x57, 0x5b, 0xff, 0x6a, 0xeb,
+    0x5f, 0x6d, 0xfd, 0xab, 0xad, 0x7f, 0xb5, 0xf5, 0xaf, 0xb6, 0xfe, 0xd5, 0xd6, 0xbf, 0xda, 0xfa,
+    0x57, 0x5b, 0xff, 0x6a, 0xeb, 0x5f, 0x6d, 0xfd, 0xab, 0xad, 0x7f, 0xb5, 0xf5, 0xaf, 0xb6, 0xfe,
+    0xd5, 0xd6, 0xbf, 0xda, 0xfa, 0x57, 0x5b, 0xff, 0x6a, 0xeb, 0x5f, 0x6d, 0xfd, 0xab, 0xad, 0x7f,
+    0xb5, 0xf5, 0xaf, 0xb6, 0xfe, 0xd5, 0xd6, 0xbf, 0xda, 0xfa, 0x57, 0x5b, 0xff, 0x6a, 0xeb, 0x5f,
+    0x6d, 0xfd, 0xab, 0xad, 0x7f, 0xb5, 0xf5, 0xaf, 0xb6, 0xfe, 0xd5, 0xd6, 0xbf, 0xda, 0xfa, 0x57,
+    0x5b, 0xff, 0x6a, 0xeb, 0x5f, 0x6d, 0xfd, 0xab, 0xad, 0x7f, 0xb5, 0xf5, 0xaf, 0x56, 0xaf, 0x76,
+    0x91, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x21, 0xa9, 0x57, 0x3b,
+    0x48, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x90, 0xd4, 0xab, 0x1d,
+    0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x48, 0xea, 0xd5, 0x0e,
+    0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x24, 0xf5, 0x6a, 0x07,
+    0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x91, 0x7a, 0xb5, 0x8b,
+    0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x0d, 0x49, 0xbd, 0xda, 0x41,
+    0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0x86, 0xa4, 0x5e, 0xed, 0x20,
+    0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x43, 0x52, 0xaf, 0x76, 0x90,
+    0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x21, 0xa9, 0x57, 0x3b, 0x48,
+    0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x88, 0xd4, 0xab, 0x5d, 0xa4,
+    0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x48, 0xea, 0xd5, 0x0e, 0x52,
+    0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x24, 0xf5, 0x6a, 0x07, 0xa9,
+    0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x92, 0x7a, 0xb5, 0x83, 0xd4,
+    0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x0d, 0x49, 0xbd, 0xda, 0x41, 0xea,
+    0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0x46, 0xa4, 0x5e, 0xed, 0x22, 0xf5,
+    0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x43, 0x52, 0xaf, 0x76, 0x90, 0x7a,
+    0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x21, 0xa9, 0x57, 0x3b, 0x48, 0xbd,
+    0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x90, 0xd4, 0xab, 0x1d, 0xa4, 0x5e,
+    0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x48, 0xea, 0xd5, 0x0e, 0x52, 0xaf,
+    0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x22, 0xf5, 0x6a, 0x17, 0xa9, 0x57,
+    0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x92, 0x7a, 0xb5, 0x83, 0xd4, 0xab,
+    0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x0d, 0x49, 0xbd, 0xda, 0x41, 0xea, 0xd5,
+    0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0x86, 0xa4, 0x5e, 0xed, 0x20, 0xf5, 0x6a,
+    0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x43, 0x52, 0xaf, 0x76, 0x90, 0x7a, 0x35,
+    0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x11, 0xa9, 0x57, 0xbb, 0x48, 0xbd, 0x1a,
+    0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x90, 0xd4, 0xab, 0x1d, 0xa4, 0x5e, 0x8d,
+    0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x48, 0xea, 0xd5, 0x0e, 0x52, 0xaf, 0xc6,
+    0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x24, 0xf5, 0x6a, 0x07, 0xa9, 0x57, 0x63,
+    0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x92, 0x7a, 0xb5, 0x83, 0xd4, 0xab, 0x31,
+    0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x48, 0xbd, 0xda, 0x45, 0xea, 0xd5, 0x98,
+    0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0x86, 0xa4, 0x5e, 0xed, 0x20, 0xf5, 0x6a, 0x4c,
+    0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x43, 0x52, 0xaf, 0x76, 0x90, 0x7a, 0x35, 0x26,
+    0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x21, 0xa9, 0x57, 0x3b, 0x48, 0xbd, 0x1a, 0x93,
+    0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x90, 0xd4, 0xab, 0x1d, 0xa4, 0x5e, 0x8d, 0x49,
+    0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x44, 0xea, 0xd5, 0x2e, 0x52, 0xaf, 0xc6, 0xa4,
+    0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x24, 0xf5, 0x6a, 0x07, 0xa9, 0x57, 0x63, 0x52,
+    0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x92, 0x7a, 0xb5, 0x83, 0xd4, 0xab, 0x31, 0xa9,
+    0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x0d, 0x49, 0xbd, 0xda, 0x41, 0xea, 0xd5, 0x98, 0xd4,
+    0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0x86, 0xa4, 0x5e, 0xed, 0x20, 0xf5, 0x6a, 0x4c, 0xea,
+    0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x23, 0x52, 0xaf, 0x76, 0x91, 0x7a, 0x35, 0x26, 0xf5,
+    0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x21, 0xa9, 0x57, 0x3b, 0x48, 0xbd, 0x1a, 0x93, 0x7a,
+    0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x90, 0xd4, 0xab, 0x1d, 0xa4, 0x5e, 0x8d, 0x49, 0xbd,
+    0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x48, 0xea, 0xd5, 0x0e, 0x52, 0xaf, 0xc6, 0xa4, 0x5e,
+    0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x24, 0xf5, 0x6a, 0x07, 0xa9, 0x57, 0x63, 0x52, 0xaf,
+    0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x91, 0x7a, 0xb5, 0x8b, 0xd4, 0xab, 0x31, 0xa9, 0x57,
+    0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x0d, 0x49, 0xbd, 0xda, 0x41, 0xea, 0xd5, 0x98, 0xd4, 0xab,
+    0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0x86, 0xa4, 0x5e, 0xed, 0x20, 0xf5, 0x6a, 0x4c, 0xea, 0xd5,
+    0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x43, 0x52, 0xaf, 0x76, 0x90, 0x7a, 0x35, 0x26, 0xf5, 0x6a,
+    0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x21, 0xa9, 0x57, 0x3b, 0x48, 0xbd, 0x1a, 0x93, 0x7a, 0x35,
+    0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x88, 0xd4, 0xab, 0x5d, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a,
+    0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x48, 0xea, 0xd5, 0x0e, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d,
+    0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x24, 0xf5, 0x6a, 0x07, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6,
+    0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x92, 0x7a, 0xb5, 0x83, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63,
+    0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x0d, 0x49, 0xbd, 0xda, 0x41, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31,
+    0xa9, 0x57, 0x63, 0x52, 0xaf, 0x46, 0xa4, 0x5e, 0xed, 0x22, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98,
+    0xd4, 0xab, 0x31, 0xa9, 0x57, 0x43, 0x52, 0xaf, 0x76, 0x90, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c,
+    0xea, 0xd5, 0x98, 0xd4, 0xab, 0x21, 0xa9, 0x57, 0x3b, 0x48, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26,
+    0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x90, 0xd4, 0xab, 0x1d, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93,
+    0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x48, 0xea, 0xd5, 0x0e, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49,
+    0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x22, 0xf5, 0x6a, 0x17, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4,
+    0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x92, 0x7a, 0xb5, 0x83, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52,
+    0xaf, 0xc6, 0xa4, 0x5e, 0x0d, 0x49, 0xbd, 0xda, 0x41, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9,
+    0x57, 0x63, 0x52, 0xaf, 0x86, 0xa4, 0x5e, 0xed, 0x20, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4,
+    0xab, 0x31, 0xa9, 0x57, 0x43, 0x52, 0xaf, 0x76, 0x90, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea,
+    0xd5, 0x98, 0xd4, 0xab, 0x11, 0xa9, 0x57, 0xbb, 0x48, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5,
+    0x6a, 0x4c, 0xea, 0xd5, 0x90, 0xd4, 0xab, 0x1d, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a,
+    0x35, 0x26, 0xf5, 0x6a, 0x48, 0xea, 0xd5, 0x0e, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd,
+    0x1a, 0x93, 0x7a, 0x35, 0x24, 0xf5, 0x6a, 0x07, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e,
+    0x8d, 0x49, 0xbd, 0x1a, 0x92, 0x7a, 0xb5, 0x83, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf,
+    0xc6, 0xa4, 0x5e, 0x8d, 0x48, 0xbd, 0xda, 0x45, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57,
+    0x63, 0x52, 0xaf, 0x86, 0xa4, 0x5e, 0xed, 0x20, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab,
+    0x31, 0xa9, 0x57, 0x43, 0x52, 0xaf, 0x76, 0x90, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5,
+    0x98, 0xd4, 0xab, 0x21, 0xa9, 0x57, 0x3b, 0x48, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a,
+    0x4c, 0xea, 0xd5, 0x90, 0xd4, 0xab, 0x1d, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35,
+    0x26, 0xf5, 0x6a, 0x44, 0xea, 0xd5, 0x2e, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a,
+    0x93, 0x7a, 0x35, 0x24, 0xf5, 0x6a, 0x07, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d,
+    0x49, 0xbd, 0x1a, 0x92, 0x7a, 0xb5, 0x83, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6,
+    0xa4, 0x5e, 0x0d, 0x49, 0xbd, 0xda, 0x41, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63,
+    0x52, 0xaf, 0x86, 0xa4, 0x5e, 0xed, 0x20, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31,
+    0xa9, 0x57, 0x23, 0x52, 0xaf, 0x76, 0x91, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98,
+    0xd4, 0xab, 0x21, 0xa9, 0x57, 0x3b, 0x48, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c,
+    0xea, 0xd5, 0x90, 0xd4, 0xab, 0x1d, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26,
+    0xf5, 0x6a, 0x48, 0xea, 0xd5, 0x0e, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93,
+    0x7a, 0x35, 0x24, 0xf5, 0x6a, 0x07, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49,
+    0xbd, 0x1a, 0x91, 0x7a, 0xb5, 0x8b, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4,
+    0x5e, 0x0d, 0x49, 0xbd, 0xda, 0x41, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52,
+    0xaf, 0x86, 0xa4, 0x5e, 0xed, 0x20, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9,
+    0x57, 0x43, 0x52, 0xaf, 0x76, 0x90, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4,
+    0xab, 0x21, 0xa9, 0x57, 0x3b, 0x48, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea,
+    0xd5, 0x88, 0xd4, 0xab, 0x5d, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5,
+    0x6a, 0x48, 0xea, 0xd5, 0x0e, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a,
+    0x35, 0x24, 0xf5, 0x6a, 0x07, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd,
+    0x1a, 0x92, 0x7a, 0xb5, 0x83, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e,
+    0x0d, 0x49, 0xbd, 0xda, 0x41, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf,
+    0x46, 0xa4, 0x5e, 0xed, 0x22, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57,
+    0x43, 0x52, 0xaf, 0x76, 0x90, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab,
+    0x21, 0xa9, 0x57, 0x3b, 0x48, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5,
+    0x90, 0xd4, 0xab, 0x1d, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a,
+    0x48, 0xea, 0xd5, 0x0e, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35,
+    0x22, 0xf5, 0x6a, 0x17, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a,
+    0x92, 0x7a, 0xb5, 0x83, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x0d,
+    0x49, 0xbd, 0xda, 0x41, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0x86,
+    0xa4, 0x5e, 0xed, 0x20, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x43,
+    0x52, 0xaf, 0x76, 0x90, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x11,
+    0xa9, 0x57, 0xbb, 0x48, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x90,
+    0xd4, 0xab, 0x1d, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x48,
+    0xea, 0xd5, 0x0e, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x24,
+    0xf5, 0x6a, 0x07, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x92,
+    0x7a, 0xb5, 0x83, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x48,
+    0xbd, 0xda, 0x45, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0x86, 0xa4,
+    0x5e, 0xed, 0x20, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x43, 0x52,
+    0xaf, 0x76, 0x90, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x21, 0xa9,
+    0x57, 0x3b, 0x48, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x90, 0xd4,
+    0xab, 0x1d, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x44, 0xea,
+    0xd5, 0x2e, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x24, 0xf5,
+    0x6a, 0x07, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x92, 0x7a,
+    0xb5, 0x83, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x0d, 0x49, 0xbd,
+    0xda, 0x41, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0x86, 0xa4, 0x5e,
+    0xed, 0x20, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x23, 0x52, 0xaf,
+    0x76, 0x91, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x21, 0xa9, 0x57,
+    0x3b, 0x48, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x90, 0xd4, 0xab,
+    0x1d, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x48, 0xea, 0xd5,
+    0x0e, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x24, 0xf5, 0x6a,
+    0x07, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x91, 0x7a, 0xb5,
+    0x8b, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x0d, 0x49, 0xbd, 0xda,
+    0x41, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0x86, 0xa4, 0x5e, 0xed,
+    0x20, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x43, 0x52, 0xaf, 0x76,
+    0x90, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x21, 0xa9, 0x57, 0x3b,
+    0x48, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x88, 0xd4, 0xab, 0x5d,
+    0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x48, 0xea, 0xd5, 0x0e,
+    0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x24, 0xf5, 0x6a, 0x07,
+    0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x92, 0x7a, 0xb5, 0x83,
+    0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0xc6, 0xa4, 0x5e, 0x0d, 0x49, 0xbd, 0xda, 0x41,
+    0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x63, 0x52, 0xaf, 0x46, 0xa4, 0x5e, 0xed, 0x22,
+    0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x31, 0xa9, 0x57, 0x43, 0x52, 0xaf, 0x76, 0x90,
+    0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x98, 0xd4, 0xab, 0x21, 0xa9, 0x57, 0x3b, 0x48,
+    0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x4c, 0xea, 0xd5, 0x90, 0xd4, 0xab, 0x1d, 0xa4,
+    0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0x35, 0x26, 0xf5, 0x6a, 0x48, 0xea, 0xd5, 0x0e, 0x52,
+    0xaf, 0xc6, 0xa4, 0x5e, 0x8d, 0x49, 0xbd, 0x1a, 0x93, 0x7a, 0xb5, 0xff, 0x4f, 0xfe, 0x17, 0x50,
+    0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x1d, 0x64, 0x4e, 0x5d, 0xa1,
+    0x00, 0x3b, 0x9c, 0x2a, 0x0d, 0x00, 0x00, 0x50, 0x34, 0x03, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x62, 0x69, 0x67,
+    0x2e, 0x74, 0x78, 0x74, 0x50, 0x4b, 0x05, 0x06, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00,
+    0x35, 0x00, 0x00, 0x00, 0x4f, 0x0d, 0x00, 0x00, 0x00, 0x00,
+};
@@ -0,0 +1,671 @@
+#include "../../../include/leafra/leafra_parsing.h"
+#include "../../../include/leafra/leafra_parse_cache.h"
+#include "../../../include/leafra/leafra_xml.h"
+#include "../../../include/leafra/leafra_zip.h"
+#include "office_fixtures.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+// Writes bytes to a file in the temp directory and removes it again
+class TempFile {
+public:
+    TempFile(const std::string& name, const void* data, size_t size)
+        : path_((std::filesystem::temp_directory_path() / ("leafra_parsing_" + name)).string()) {
+        std::ofstream out(path_, std::ios::binary);
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+    ~TempFile() {
+        std::error_code ignored;
+        std::filesystem::remove(path_, ignored);
+    }
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+// Records scanner events as one line each
+class RecordingHandler : public XmlScanner::Handler {
+public:
+    bool on_start_element(std::string_view name, const std::vector<XmlScanner::Attribute>& attributes) override {
+        log += "<" + std::string(name);
+        for (const auto& attribute : attributes) {
+            log += " " + std::string(attribute.name) + "=" + std::string(attribute.value);
+        }
+        log += ">\n";
+        return true;
+    }
+    bool on_end_element(std::string_view name) override {
+        flush_text();
+        log += "</" + std::string(name) + ">\n";
+        return true;
+    }
+    bool on_text(std::string_view text) override {
+        text_.append(text.data(), text.size());
+        return true;
+    }
+    void flush_text() {
+        if (!text_.empty()) {
+            log += "text(" + text_ + ")\n";
+            text_.clear();
+        }
+    }
+
+    std::string log;
+
+private:
+    std::string text_;
+};
+
+std::string expected_large_payload() {
+    std::string text;
+    char line[64];
+    for (int i = 0; i < 6000; ++i) {
+        snprintf(line, sizeof(line), "entry %03d of the generated payload\n", i % 400);
+        text += line;
+    }
+    return text;
+}
+
+static const char kXmlSample[] =
+    "<?xml version=\"1.0\"?><!DOCTYPE root [<!ENTITY x \"y\">]>"
+    "<root a='1 &amp; 2' b=\"&lt;&#x41;&#66;\"><!-- comment > here -->"
+    "<item/>Caf&#233; &amp; bar<![CDATA[<raw> & ]]><w:t xml:space=\"preserve\"> x </w:t></root>";
+
+bool test_xml_scanner_events() {
+    RecordingHandler handler;
+    XmlScanner scanner(handler);
+    TEST_ASSERT(scanner.feed(kXmlSample, sizeof(kXmlSample) - 1), "Feed should succeed");
+    TEST_ASSERT(scanner.finish(), "Finish should succeed");
+
+    std::string expected =
+        "<root a=1 & 2 b=<AB>\n"
+        "<item>\n"
+        "</item>\n"
+        "<w:t xml:space=preserve>\n"
+        "text(Caf\xC3\xA9 & bar<raw> &  x )\n"
+        "</w:t>\n"
+        "</root>\n";
+    TEST_ASSERT_EQUAL(expected, handler.log, "Event log should match");
+    return true;
+}
+
+bool test_xml_scanner_byte_at_a_time() {
+    RecordingHandler whole;
+    XmlScanner whole_scanner(whole);
+    whole_scanner.feed(kXmlSample, sizeof(kXmlSample) - 1);
+    whole_scanner.finish();
+
+    // Every token and entity reference gets split at some point
+    RecordingHandler split;
+    XmlScanner split_scanner(split);
+    for (size_t i = 0; i + 1 < sizeof(kXmlSample); ++i) {
+        TEST_ASSERT(split_scanner.feed(kXmlSample + i, 1), "Byte feed should succeed");
+    }
+    TEST_ASSERT(split_scanner.finish(), "Finish should succeed");
+    TEST_ASSERT_EQUAL(whole.log, split.log, "Split feeding should produce the same events");
+    return true;
+}
+
+bool test_xml_scanner_malformed() {
+    RecordingHandler handler;
+    XmlScanner scanner(handler);
+    const char unterminated[] = "<root><item attr=\"x";
+    TEST_ASSERT(scanner.feed(unterminated, sizeof(unterminated) - 1), "Partial markup waits for more input");
+    TEST_ASSERT(!scanner.finish(), "Finish inside markup should fail");
+    TEST_ASSERT(!scanner.last_error().empty(), "Error should be reported");
+
+    RecordingHandler other;
+    XmlScanner unquoted(other);
+    const char bad[] = "<root attr=1/>";
+    TEST_ASSERT(!unquoted.feed(bad, sizeof(bad) - 1), "Unquoted attribute should fail");
+    return true;
+}
+
+bool test_zip_inflate_large_entry() {
+    TempFile file("large.zip", kLargeZipFixture, sizeof(kLargeZipFixture));
+    ZipReader zip;
+    TEST_ASSERT(zip.open(file.path()), "Archive should open: " + zip.last_error());
+    TEST_ASSERT_EQUAL(size_t(1), zip.entries().size(), "One entry expected");
+    const ZipReader::Entry* entry = zip.find("big.txt");
+    TEST_ASSERT(entry != nullptr, "Entry should be found");
+    TEST_ASSERT_EQUAL(8, static_cast<int>(entry->method), "Entry should be deflated");
+
+    std::string text;
+    size_t calls = 0;
+    size_t largest = 0;
+    bool ok = zip.read(*entry, [&](const char* data, size_t size) {
+        text.append(data, size);
+        calls++;
+        largest = std::max(largest, size);
+        return true;
+    });
+    TEST_ASSERT(ok, "Read should succeed: " + zip.last_error());
+    TEST_ASSERT(text == expected_large_payload(), "Inflated text should match the original");
+    TEST_ASSERT(calls > 1, "Output should arrive in several blocks");
+    TEST_ASSERT(largest <= 64 * 1024 + 258, "Blocks should stay bounded");
+    return true;
+}
+
+bool test_zip_sink_stop_and_corruption() {
+    TempFile file("stop.zip", kLargeZipFixture, sizeof(kLargeZipFixture));
+    ZipReader zip;
+    TEST_ASSERT(zip.open(file.path()), "Archive should open");
+    size_t calls = 0;
+    bool ok = zip.read("big.txt", [&](const char*, size_t) { calls++; return false; });
+    TEST_ASSERT(ok, "Stopping from the sink is not an error");
+    TEST_ASSERT_EQUAL(size_t(1), calls, "Sink should not be called after it stops");
+    TEST_ASSERT(!zip.read("missing.txt", [](const char*, size_t) { return true; }), "Missing entry should fail");
+
+    // Damage the compressed stream: inflate or the CRC-32 check must notice
+    std::vector<unsigned char> damaged(kLargeZipFixture, kLargeZipFixture + sizeof(kLargeZipFixture));
+    uint32_t local = zip.find("big.txt")->local_header_offset;
+    damaged[local + 30 + 7 + 200] ^= 0x5A;
+    TempFile damaged_file("damaged.zip", damaged.data(), damaged.size());
+    ZipReader damaged_zip;
+    TEST_ASSERT(damaged_zip.open(damaged_file.path()), "Central directory is intact");
+    TEST_ASSERT(!damaged_zip.read("big.txt", [](const char*, size_t) { return true; }), "Damaged data should fail");
+    TEST_ASSERT(!damaged_zip.last_error().empty(), "Error should be reported");
+
+    TempFile truncated("truncated.zip", kLargeZipFixture, sizeof(kLargeZipFixture) / 2);
+    ZipReader truncated_zip;
+    TEST_ASSERT(!truncated_zip.open(truncated.path()), "Truncated archive should not open");
+    return true;
+}
+
+bool test_docx_pages_and_metadata() {
+    TempFile file("report.docx", kDocxFixture, sizeof(kDocxFixture));
+    DOCXParsingAdapter adapter;
+    ParsedDocument document = adapter.parse(file.path());
+    TEST_ASSERT(document.isValid, "DOCX should parse: " + document.errorMessage);
+    TEST_ASSERT_EQUAL(size_t(3), document.pages.size(), "Page break, rendered break and section break give 3 pages");
+    TEST_ASSERT_EQUAL(std::string("Caf\xC3\xA9 & Bar\t tab\nLine\ntwo\n"), document.pages[0], "First page text");
+    TEST_ASSERT_EQUAL(std::string("Second page\nA1\tB1\nA2\tB2\nEnd of section\n"), document.pages[1], "Second page with table");
+    TEST_ASSERT_EQUAL(std::string("Third page\n"), document.pages[2], "Third page text");
+    TEST_ASSERT_EQUAL(std::string("Quarterly Report"), document.title, "Title from core properties");
+    TEST_ASSERT_EQUAL(std::string("Jane Doe"), document.author, "Author from core properties");
+    TEST_ASSERT_EQUAL(std::string("2024-01-02T03:04:05Z"), document.getMetadata("CreationDate"), "Creation date");
+    return true;
+}
+
+bool test_docx_streaming_stop() {
+    TempFile file("stream.docx", kDocxFixture, sizeof(kDocxFixture));
+    DOCXParsingAdapter adapter;
+    std::vector<std::string> pages;
+    bool in_order = true;
+    ParsedDocument document = adapter.parse(file.path(), [&](size_t index, std::string_view text) {
+        in_order = in_order && index == pages.size();
+        pages.emplace_back(text);
+        return pages.size() < 2;
+    });
+    TEST_ASSERT(in_order, "Pages arrive in order");
+    TEST_ASSERT(document.isValid, "Stopped parse is still valid");
+    TEST_ASSERT(document.pages.empty(), "Streaming parse keeps no pages");
+    TEST_ASSERT_EQUAL(size_t(2), document.getPageCount(), "Parse should stop after the second page");
+    TEST_ASSERT_EQUAL(size_t(2), pages.size(), "Sink saw two pages");
+    return true;
+}
+
+bool test_xlsx_sheets() {
+    TempFile file("sales.xlsx", kXlsxFixture, sizeof(kXlsxFixture));
+    ExcelParsingAdapter adapter;
+    ParsedDocument document = adapter.parse(file.path());
+    TEST_ASSERT(document.isValid, "XLSX should parse: " + document.errorMessage);
+    TEST_ASSERT_EQUAL(size_t(2), document.pages.size(), "One page per sheet");
+    TEST_ASSERT_EQUAL(std::string("# Sales\nRegion\tTotal\nNorth\t42.5\t\tTRUE\n\tinline text\n"), document.pages[0],
+                      "Sales sheet rendered as tab-separated rows");
+    TEST_ASSERT_EQUAL(std::string("# Notes & Misc\nnote\n"), document.pages[1], "Notes sheet");
+    TEST_ASSERT_EQUAL(std::string("2"), document.getMetadata("SheetCount"), "Sheet count");
+    TEST_ASSERT_EQUAL(std::string("4"), document.getMetadata("RowCount"), "Row count");
+    TEST_ASSERT_EQUAL(std::string("Sales, Notes & Misc"), document.getMetadata("Sheets"), "Sheet names");
+    return true;
+}
+
+bool test_xlsx_page_split() {
+    TempFile file("split.xlsx", kXlsxFixture, sizeof(kXlsxFixture));
+    ExcelParsingAdapter adapter;
+    ParsingConfig config;
+    config.sheet_page_bytes = 16;
+    adapter.configure(nullptr, config);
+
+    std::vector<std::string> pages;
+    ParsedDocument document = adapter.parse(file.path(), [&](size_t, std::string_view text) {
+        pages.emplace_back(text);
+        return true;
+    });
+    TEST_ASSERT(document.isValid, "XLSX should parse");
+    TEST_ASSERT_EQUAL(size_t(4), pages.size(), "Small page size splits sheets at rows");
+    TEST_ASSERT_EQUAL(std::string("# Sales\nRegion\tTotal\n"), pages[0], "First page holds one row");
+    TEST_ASSERT_EQUAL(std::string("# Sales\n\tinline text\n"), pages[2], "Continuation pages repeat the sheet header");
+    TEST_ASSERT_EQUAL(std::string("# Notes & Misc\nnote\n"), pages[3], "Next sheet starts a new page");
+    return true;
+}
+
+bool test_csv_paging() {
+    std::string csv;
+    for (int i = 0; i < 8000; ++i) {
+        csv += std::to_string(i) + ",value " + std::to_string(i * 3);
+        csv += i % 10 == 0 ? ",\"quoted\nacross lines\"\n" : ",plain\n";
+    }
+    TempFile file("rows.csv", csv.data(), csv.size());
+
+    ExcelParsingAdapter adapter;
+    ParsingConfig config;
+    config.sheet_page_bytes = 32 * 1024;
+    adapter.configure(nullptr, config);
+    ParsedDocument document = adapter.parse(file.path());
+    TEST_ASSERT(document.isValid, "CSV should parse: " + document.errorMessage);
+    TEST_ASSERT_EQUAL(std::string("CSV"), document.fileType, "File type");
+    TEST_ASSERT(document.pages.size() > 1, "Large CSV should span several pages");
+
+    std::string joined;
+    for (const std::string& page : document.pages) {
+        TEST_ASSERT(!page.empty() && page.back() == '\n', "Pages end at a row end");
+        TEST_ASSERT(std::count(page.begin(), page.end(), '"') % 2 == 0, "Pages never end inside a quoted field");
+        joined += page;
+    }
+    TEST_ASSERT(joined == csv, "Pages should reassemble the file");
+    TEST_ASSERT_EQUAL(std::string("8000"), document.getMetadata("RowCount"), "Quoted newlines are not rows");
+    return true;
+}
+
+bool test_unsupported_inputs() {
+    DOCXParsingAdapter docx;
+    ExcelParsingAdapter excel;
+    ParsedDocument doc = docx.parse("/nonexistent/legacy.doc");
+    TEST_ASSERT(!doc.isValid && doc.errorMessage.find(".doc") != std::string::npos, "Legacy .doc is rejected");
+    ParsedDocument xls = excel.parse("/nonexistent/legacy.xls");
+    TEST_ASSERT(!xls.isValid && xls.errorMessage.find(".xls") != std::string::npos, "Legacy .xls is rejected");
+
+    const char not_zip[] = "plain text, not an archive";
+    TempFile file("fake.docx", not_zip, sizeof(not_zip) - 1);
+    ParsedDocument fake = docx.parse(file.path());
+    TEST_ASSERT(!fake.isValid && !fake.errorMessage.empty(), "Non-ZIP input is reported");
+
+    TempFile wrong("wrong.docx", kXlsxFixture, sizeof(kXlsxFixture));
+    ParsedDocument wrong_package = docx.parse(wrong.path());
+    TEST_ASSERT(!wrong_package.isValid, "A workbook is not a Word document");
+    return true;
+}
+
+// Creates an empty directory in the temp directory and removes it again
+class TempDirectory {
+public:
+    explicit TempDirectory(const std::string& name)
+        : path_((std::filesystem::temp_directory_path() / ("leafra_parsing_" + name)).string()) {
+        std::error_code ignored;
+        std::filesystem::remove_all(path_, ignored);
+    }
+    ~TempDirectory() {
+        std::error_code ignored;
+        std::filesystem::remove_all(path_, ignored);
+    }
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+static ParsedDocument makeCacheDocument(size_t page_bytes) {
+    ParsedDocument document;
+    document.filePath = "/docs/report.docx";
+    document.fileType = "DOCX";
+    document.title = "Quarterly report";
+    document.author = "Finance";
+    document.metadata["Subject"] = "Q3";
+    document.metadata["Empty"] = "";
+    document.pages.push_back(std::string(page_bytes, 'a'));
+    document.pages.push_back("");
+    document.pages.push_back(std::string("binary\0text", 11));
+    document.isValid = true;
+    return document;
+}
+
+bool test_parse_cache_round_trip() {
+    TempDirectory directory("cache_round_trip");
+    ParseCache cache(directory.path(), 0);
+    ParsedDocument original = makeCacheDocument(1000);
+
+    ParsedDocument loaded;
+    TEST_ASSERT(!cache.load("0123456789abcdef", "DOCXParsingAdapter/1", loaded), "Empty cache should miss");
+    TEST_ASSERT(cache.store("0123456789abcdef", "DOCXParsingAdapter/1", original), "Store should succeed");
+    TEST_ASSERT(cache.load("0123456789abcdef", "DOCXParsingAdapter/1", loaded), "Stored entry should load");
+    TEST_ASSERT(loaded.isValid, "Loaded document should be valid");
+    TEST_ASSERT(loaded.filePath.empty(), "File path is left to the caller");
+    TEST_ASSERT_EQUAL(original.fileType, loaded.fileType, "File type");
+    TEST_ASSERT_EQUAL(original.title, loaded.title, "Title");
+    TEST_ASSERT_EQUAL(original.author, loaded.author, "Author");
+    TEST_ASSERT(original.metadata == loaded.metadata, "Metadata should round-trip");
+    TEST_ASSERT(original.pages == loaded.pages, "Pages should round-trip byte for byte");
+
+    // Another parser version or other content is a different entry
+    TEST_ASSERT(!cache.load("0123456789abcdef", "DOCXParsingAdapter/2", loaded), "Parser key change should miss");
+    TEST_ASSERT(!cache.load("fedcba9876543210", "DOCXParsingAdapter/1", loaded), "Other content should miss");
+
+    // Failed parses are never cached
+    ParsedDocument failed;
+    failed.errorMessage = "broken";
+    TEST_ASSERT(!cache.store("1111111111111111", "DOCXParsingAdapter/1", failed), "Invalid documents are not stored");
+
+    // Truncated or corrupted entries are rejected, not half-loaded
+    std::string encoded;
+    ParseCache::serialize(original, encoded);
+    ParsedDocument decoded;
+    TEST_ASSERT(ParseCache::deserialize(encoded, decoded), "Serialized document should decode");
+    for (size_t cut : {size_t(0), size_t(3), size_t(20), encoded.size() / 2, encoded.size() - 1}) {
+        TEST_ASSERT(!ParseCache::deserialize(std::string_view(encoded).substr(0, cut), decoded), "Truncated data should be rejected");
+    }
+    TEST_ASSERT(!ParseCache::deserialize(encoded + "x", decoded), "Trailing bytes should be rejected");
+
+    for (const auto& entry : std::filesystem::directory_iterator(directory.path())) {
+        std::filesystem::resize_file(entry.path(), 40);
+    }
+    TEST_ASSERT(!cache.load("0123456789abcdef", "DOCXParsingAdapter/1", loaded), "Truncated entry file should miss");
+    return true;
+}
+
+bool test_parse_cache_trim() {
+    TempDirectory directory("cache_trim");
+    // Each entry is a bit over 10 KB, so three fit and the fourth forces an eviction
+    ParseCache cache(directory.path(), 35 * 1024);
+    ParsedDocument document = makeCacheDocument(10 * 1024);
+    const std::vector<std::string> hashes = {"aaaaaaaaaaaaaaaa", "bbbbbbbbbbbbbbbb", "cccccccccccccccc", "dddddddddddddddd"};
+
+    for (size_t i = 0; i < 3; ++i) {
+        TEST_ASSERT(cache.store(hashes[i], "TextParsingAdapter/1/0", document), "Store should succeed");
+    }
+    // Age the entries so their order doesn't depend on the file system's timestamp resolution
+    auto now = std::filesystem::file_time_type::clock::now();
+    for (const auto& entry : std::filesystem::directory_iterator(directory.path())) {
+        for (size_t i = 0; i < 3; ++i) {
+            if (entry.path().filename().string().rfind(hashes[i], 0) == 0) {
+                std::filesystem::last_write_time(entry.path(), now - std::chrono::minutes(30 - 10 * static_cast<int>(i)));
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(size_t(0), cache.trim(), "Cache within its limit keeps every entry");
+
+    // Reading the oldest entry makes the second one the least recently used
+    ParsedDocument loaded;
+    TEST_ASSERT(cache.load(hashes[0], "TextParsingAdapter/1/0", loaded), "Oldest entry should load");
+    TEST_ASSERT(cache.store(hashes[3], "TextParsingAdapter/1/0", document), "Store should succeed");
+    TEST_ASSERT_EQUAL(size_t(1), cache.trim(), "One entry should be evicted");
+    TEST_ASSERT(cache.load(hashes[0], "TextParsingAdapter/1/0", loaded), "Recently read entry should survive");
+    TEST_ASSERT(!cache.load(hashes[1], "TextParsingAdapter/1/0", loaded), "Least recently used entry should be evicted");
+    TEST_ASSERT(cache.load(hashes[3], "TextParsingAdapter/1/0", loaded), "Newest entry should survive");
+    return true;
+}
+
+bool test_parser_cache_keys() {
+    FileParsingWrapper parser;
+    TEST_ASSERT(parser.initialize(), "Parser should initialize");
+    ParsingConfig config;
+    config.text_page_bytes = 4096;
+    parser.configure(nullptr, config);
+    std::string small_pages = parser.getCacheKey("/docs/notes.txt");
+    config.text_page_bytes = 8192;
+    parser.configure(nullptr, config);
+    std::string large_pages = parser.getCacheKey("/docs/notes.txt");
+
+    TEST_ASSERT(!small_pages.empty(), "Text files should have a cache key");
+    TEST_ASSERT(small_pages != large_pages, "Page size changes the text adapter's output and its key");
+    TEST_ASSERT(parser.getCacheKey("/docs/report.docx") != small_pages, "Adapters have distinct keys");
+    TEST_ASSERT(parser.getCacheKey("/docs/image.png").empty(), "Unsupported files have no key");
+    return true;
+}
+
+bool test_repeated_line_removal() {
+    const char* bodies[] = {"Revenue grew", "Costs fell", "Margins held", "Hiring paused", "Churn dropped", "Outlook"};
+    std::vector<std::string> pages;
+    for (int i = 1; i <= 6; ++i) {
+        pages.push_back("ACME Corp - Confidential\n\n" + std::string(bodies[i - 1]) + " this quarter.\n  Page " +
+                        std::to_string(i) + " of 6  \n");
+    }
+    pages[3] = "Only an unusual page\nwith its own layout";
+    RepeatedLineOptions options;
+    size_t removed = removeRepeatedLines(pages, options);
+
+    TEST_ASSERT(removed > 0, "Repeated lines should be removed");
+    TEST_ASSERT_EQUAL(std::string("\nRevenue grew this quarter.\n"), pages[0], "Header, footer and page number go");
+    TEST_ASSERT_EQUAL(std::string("Only an unusual page\nwith its own layout"), pages[3], "Pages without the boilerplate stay");
+
+    // "More content." repeats too, but sits deeper than one edge line from the top
+    std::vector<std::string> shallow = {"Head\nA1\nMore\nTail 1", "Head\nB2\nMore\nTail 2",
+                                        "Head\nC3\nMore\nTail 3", "Head\nD4\nMore\nTail 4"};
+    options.edge_lines = 1;
+    removeRepeatedLines(shallow, options);
+    TEST_ASSERT_EQUAL(std::string("A1\nMore\n"), shallow[0], "Only edge lines are candidates");
+
+    std::vector<std::string> few = {"Head\nx", "Head\ny", "Head\nz"};
+    TEST_ASSERT_EQUAL(static_cast<size_t>(0), removeRepeatedLines(few, RepeatedLineOptions()), "Short documents are left alone");
+
+    ParsingConfig config;
+    FileParsingWrapper parser;
+    TEST_ASSERT(parser.initialize(), "Parser should initialize");
+    parser.configure(nullptr, config);
+    std::string stripping = parser.getCacheKey("/docs/report.pdf");
+    config.pdf_strip_boilerplate = false;
+    parser.configure(nullptr, config);
+    TEST_ASSERT(parser.getCacheKey("/docs/report.pdf") != stripping, "Boilerplate removal changes the PDF cache key");
+    return true;
+}
+
+// Counts constructions and configure() calls of a stub adapter for ".lazy" files
+struct LazyAdapterCounters {
+    std::atomic<int> constructed{0};
+    std::atomic<int> configured{0};
+};
+
+class LazyStubAdapter : public IFileParsingAdapter {
+public:
+    explicit LazyStubAdapter(LazyAdapterCounters& counters) : counters_(counters) { counters_.constructed++; }
+    bool canHandle(const std::string& extension) const override { return extension == "lazy"; }
+    ParsedDocument parse(const std::string& filePath) const override {
+        ParsedDocument result;
+        result.filePath = filePath;
+        result.pages.push_back("page bytes " + std::to_string(page_bytes_));
+        result.isValid = true;
+        return result;
+    }
+    std::vector<std::string> getSupportedExtensions() const override { return {"lazy"}; }
+    std::string getName() const override { return "LazyStubAdapter"; }
+    void configure(const TaskSubmitFunction&, const ParsingConfig& config) override {
+        page_bytes_ = config.text_page_bytes;
+        counters_.configured++;
+    }
+
+private:
+    LazyAdapterCounters& counters_;
+    int32_t page_bytes_ = 0;
+};
+
+bool test_lazy_adapter_construction() {
+    LazyAdapterCounters counters;
+    FileParsingWrapper parser;
+    TEST_ASSERT(parser.initialize(), "Parser should initialize");
+    parser.registerAdapter({"LAZY"}, [&counters] { return std::make_unique<LazyStubAdapter>(counters); });
+
+    ParsingConfig config;
+    config.text_page_bytes = 1234;
+    parser.configure(nullptr, config);
+    TEST_ASSERT(parser.isFileTypeSupported("/docs/a.lazy"), "Registered extension should be supported");
+    auto extensions = parser.getSupportedExtensions();
+    TEST_ASSERT(std::find(extensions.begin(), extensions.end(), "lazy") != extensions.end(), "Extensions are listed before construction");
+    TEST_ASSERT_EQUAL(0, counters.constructed.load(), "Support checks don't construct the adapter");
+
+    // Concurrent first parses share a single construction, configured with the earlier settings
+    std::vector<std::thread> threads;
+    std::atomic<int> matching{0};
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&parser, &matching] {
+            ParsedDocument document = parser.parseFile("/docs/a.lazy");
+            if (document.isValid && document.pages.size() == 1 && document.pages[0] == "page bytes 1234") {
+                matching++;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    TEST_ASSERT_EQUAL(8, matching.load(), "Every parse should see the configured adapter");
+    TEST_ASSERT_EQUAL(1, counters.constructed.load(), "Adapter should be constructed once");
+    TEST_ASSERT_EQUAL(1, counters.configured.load(), "Adapter should be configured on construction");
+
+    // Later settings reach already constructed adapters
+    config.text_page_bytes = 99;
+    parser.configure(nullptr, config);
+    TEST_ASSERT_EQUAL(std::string("page bytes 99"), parser.parseFile("/docs/b.lazy").pages[0], "Reconfigured adapter");
+    TEST_ASSERT_EQUAL(2, counters.configured.load(), "Constructed adapter should be reconfigured");
+    return true;
+}
+
+// Five 100-byte pages for any ".pages" file
+class PagedStubAdapter : public IFileParsingAdapter {
+public:
+    bool canHandle(const std::string& extension) const override { return extension == "pages"; }
+    ParsedDocument parse(const std::string& filePath) const override {
+        ParsedDocument result;
+        result.filePath = filePath;
+        result.pages.assign(5, std::string(100, 'x'));
+        result.isValid = true;
+        return result;
+    }
+    std::vector<std::string> getSupportedExtensions() const override { return {"pages"}; }
+    std::string getName() const override { return "PagedStubAdapter"; }
+};
+
+bool test_extraction_budget() {
+    ParsingConfig config;
+    TEST_ASSERT(!ExtractionBudget(config).active(), "No limits by default");
+
+    // Text limit: the page crossing it and every later page are refused
+    config.max_text_mb = 1;
+    ExtractionBudget text(config);
+    TEST_ASSERT(text.charge(1024 * 1024, 0.0), "Page within the text limit is kept");
+    TEST_ASSERT(!text.exhausted(), "Exactly at the limit is not over it");
+    TEST_ASSERT(!text.charge(1, 0.0), "Page over the text limit is refused");
+    TEST_ASSERT(!text.charge(0, 0.0), "Later pages are refused too");
+    TEST_ASSERT(text.limit() == DocumentLimit::MAX_TEXT, "Text limit is reported");
+
+    // A slow page is kept but ends the extraction
+    config = ParsingConfig();
+    config.page_timeout_ms = 10;
+    ExtractionBudget page_time(config);
+    TEST_ASSERT(page_time.charge(10, 50.0), "Slow page is kept");
+    TEST_ASSERT(page_time.exhausted(), "Slow page is the last one");
+    TEST_ASSERT(page_time.limit() == DocumentLimit::PAGE_TIME, "Page time limit is reported");
+
+    config = ParsingConfig();
+    config.document_timeout_ms = 1;
+    ExtractionBudget document_time(config);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    TEST_ASSERT(document_time.exhausted(), "Document time runs out");
+    TEST_ASSERT(document_time.limit() == DocumentLimit::DOCUMENT_TIME, "Document time limit is reported");
+    TEST_ASSERT_EQUAL(std::string("document_time"), std::string(documentLimitName(document_time.limit())), "Limit name");
+
+    // The wrapper applies the page limit to adapters that don't check it themselves
+    FileParsingWrapper parser;
+    TEST_ASSERT(parser.initialize(), "Parser should initialize");
+    parser.registerAdapter(std::make_unique<PagedStubAdapter>());
+    config = ParsingConfig();
+    config.max_pages = 3;
+    parser.configure(nullptr, config);
+    ParsedDocument document = parser.parseFile("/docs/a.pages");
+    TEST_ASSERT_EQUAL(3, static_cast<int>(document.pages.size()), "Pages past max_pages are left out");
+    TEST_ASSERT(document.limit == DocumentLimit::MAX_PAGES, "Page limit is reported");
+
+    size_t streamed = 0;
+    document = parser.parseFile("/docs/a.pages", [&streamed](size_t, std::string_view) {
+        streamed++;
+        return true;
+    });
+    TEST_ASSERT_EQUAL(3, static_cast<int>(streamed), "Streaming parse stops at max_pages");
+    TEST_ASSERT(document.limit == DocumentLimit::MAX_PAGES, "Streaming parse reports the page limit");
+
+    config.max_pages = 5;
+    parser.configure(nullptr, config);
+    document = parser.parseFile("/docs/a.pages");
+    TEST_ASSERT_EQUAL(5, static_cast<int>(document.pages.size()), "Documents within the limit are complete");
+    TEST_ASSERT(document.limit == DocumentLimit::NONE, "No limit is reported within the limits");
+    return true;
+}
+
+int main() {
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    std::cout << "=== Office Parsing Tests ===" << std::endl;
+
+    RUN_TEST(test_xml_scanner_events);
+    RUN_TEST(test_xml_scanner_byte_at_a_time);
+    RUN_TEST(test_xml_scanner_malformed);
+    RUN_TEST(test_zip_inflate_large_entry);
+    RUN_TEST(test_zip_sink_stop_and_corruption);
+    RUN_TEST(test_docx_pages_and_metadata);
+    RUN_TEST(test_docx_streaming_stop);
+    RUN_TEST(test_xlsx_sheets);
+    RUN_TEST(test_xlsx_page_split);
+    RUN_TEST(test_csv_paging);
+    RUN_TEST(test_unsupported_inputs);
+    RUN_TEST(test_parse_cache_round_trip);
+    RUN_TEST(test_parse_cache_trim);
+    RUN_TEST(test_parser_cache_keys);
+    RUN_TEST(test_repeated_line_removal);
+    RUN_TEST(test_lazy_adapter_construction);
+    RUN_TEST(test_extraction_budget);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+    
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
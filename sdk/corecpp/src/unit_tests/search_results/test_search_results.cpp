@@ -0,0 +1,143 @@
+#include "../../../include/leafra/leafra_search_results.h"
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+bool test_hits_view_stored_text() {
+    SearchResultSet results;
+    results.reset(2, 256);
+    std::string source = "first chunk";
+    SearchHit& first = results.add(7, 0.5f);
+    first.doc_id = 1;
+    first.content = results.store_text(source);
+    source = "overwritten";
+    
+    TEST_ASSERT_EQUAL(1u, results.size(), "One hit added");
+    TEST_ASSERT(results[0].content == std::string_view("first chunk"), "Text is a copy owned by the set");
+    TEST_ASSERT(results[0].content.data() != source.data(), "View points into the set");
+    TEST_ASSERT_EQUAL(7, results[0].id, "Id kept");
+    TEST_ASSERT(results.store_text(std::string_view()).empty(), "Empty text stores nothing");
+    return true;
+}
+
+bool test_filenames_are_interned() {
+    SearchResultSet results;
+    results.reset(3, 256);
+    std::string_view a = results.intern_filename(1, "report.pdf");
+    std::string_view b = results.intern_filename(2, "notes.txt");
+    std::string_view again = results.intern_filename(1, "report.pdf");
+    
+    TEST_ASSERT(a.data() == again.data(), "Same document shares one filename copy");
+    TEST_ASSERT(a.data() != b.data(), "Other documents get their own");
+    TEST_ASSERT_EQUAL(2u, results.document_count(), "Two distinct documents");
+    TEST_ASSERT_EQUAL(std::string("report.pdf").size() + std::string("notes.txt").size(), results.text_bytes(), "Each filename stored once");
+    return true;
+}
+
+bool test_reset_sizes_one_block() {
+    SearchResultSet results;
+    const std::string chunk(1000, 'x');
+    results.reset(20, 20 * chunk.size() + 64);
+    for (int i = 0; i < 20; ++i) {
+        SearchHit& hit = results.add(i, 0.0f);
+        hit.content = results.store_text(chunk);
+        hit.filename = results.intern_filename(i % 3, "shared.pdf");
+    }
+    const size_t expected_text = 20 * chunk.size() + 3 * std::string("shared.pdf").size();
+    TEST_ASSERT_EQUAL(expected_text, results.text_bytes(), "Chunk text plus three filenames");
+    TEST_ASSERT(results.memory_bytes() < 20 * chunk.size() + 64 + 4096 + 20 * sizeof(SearchHit) + 256, "All text fits the reserved block");
+    return true;
+}
+
+bool test_move_keeps_views() {
+    SearchResultSet results;
+    results.reset(1, 64);
+    SearchHit& hit = results.add(3, 1.0f);
+    hit.content = results.store_text("moved text");
+    const char* data = results[0].content.data();
+    
+    SearchResultSet moved(std::move(results));
+    TEST_ASSERT_EQUAL(1u, moved.size(), "Hit moved along");
+    TEST_ASSERT(moved[0].content.data() == data, "Text was not copied");
+    TEST_ASSERT(moved[0].content == std::string_view("moved text"), "View still valid");
+    return true;
+}
+
+bool test_remove_hits_keeps_order() {
+    SearchResultSet results;
+    for (int i = 0; i < 5; ++i) {
+        results.add(i, static_cast<float>(i));
+    }
+    results.remove_hits_if([](const SearchHit& hit) { return hit.id % 2 == 1; });
+    TEST_ASSERT_EQUAL(3u, results.size(), "Odd ids dropped");
+    TEST_ASSERT_EQUAL(0, results[0].id, "Order kept");
+    TEST_ASSERT_EQUAL(2, results[1].id, "Order kept");
+    TEST_ASSERT_EQUAL(4, results[2].id, "Order kept");
+    
+    results.clear();
+    TEST_ASSERT(results.empty(), "clear drops the hits");
+    TEST_ASSERT_EQUAL(0u, results.text_bytes(), "clear drops the text");
+    return true;
+}
+
+int main() {
+    std::cout << "=== SearchResultSet Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_hits_view_stored_text);
+    RUN_TEST(test_filenames_are_interned);
+    RUN_TEST(test_reset_sizes_one_block);
+    RUN_TEST(test_move_keeps_views);
+    RUN_TEST(test_remove_hits_keeps_order);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,353 @@
+#include "../../../include/leafra/leafra_simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+// Every instruction set this CPU runs, scalar first
+static std::vector<simd::Isa> supported_isas() {
+    std::vector<simd::Isa> isas;
+    const simd::Isa original = simd::active_isa();
+    for (simd::Isa isa : {simd::Isa::SCALAR, simd::Isa::NEON, simd::Isa::AVX2, simd::Isa::AVX512}) {
+        if (simd::set_active_isa(isa)) {
+            isas.push_back(isa);
+        }
+    }
+    simd::set_active_isa(original);
+    return isas;
+}
+
+static std::vector<float> sample_vector(size_t count, float phase) {
+    std::vector<float> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = std::sin(static_cast<float>(i) * 0.37f + phase) * 0.12f;
+    }
+    return values;
+}
+
+static bool close_to(double expected, float actual) {
+    return std::fabs(expected - static_cast<double>(actual)) <= 1e-4 * std::max(1.0, std::fabs(expected));
+}
+
+// Odd lengths exercise every tail path
+static const size_t kLengths[] = {0, 1, 7, 15, 16, 17, 33, 100, 384, 769};
+
+bool test_fp32_kernels_match_reference() {
+    for (simd::Isa isa : supported_isas()) {
+        simd::set_active_isa(isa);
+        for (size_t count : kLengths) {
+            std::vector<float> a = sample_vector(count, 0.0f);
+            std::vector<float> b = sample_vector(count, 1.3f);
+            double dot = 0.0, norm = 0.0, l2 = 0.0;
+            for (size_t i = 0; i < count; ++i) {
+                dot += static_cast<double>(a[i]) * b[i];
+                norm += static_cast<double>(a[i]) * a[i];
+                l2 += (static_cast<double>(a[i]) - b[i]) * (static_cast<double>(a[i]) - b[i]);
+            }
+            TEST_ASSERT(close_to(dot, simd::dot(a.data(), b.data(), count)), simd::isa_name(isa) << " dot, length " << count);
+            TEST_ASSERT(close_to(norm, simd::squared_norm(a.data(), count)), simd::isa_name(isa) << " norm, length " << count);
+            TEST_ASSERT(close_to(l2, simd::squared_l2(a.data(), b.data(), count)), simd::isa_name(isa) << " L2, length " << count);
+
+            std::vector<float> unit(count);
+            if (count > 0) {
+                TEST_ASSERT(simd::l2_normalize(b.data(), unit.data(), count), "Non-zero vector should normalize");
+                TEST_ASSERT(close_to(1.0, simd::squared_norm(unit.data(), count)), simd::isa_name(isa) << " unit length");
+            }
+        }
+    }
+    return true;
+}
+
+bool test_batches_match_single_calls() {
+    const size_t dimension = 37;
+    const size_t count = 11;
+    std::vector<float> query = sample_vector(dimension, 0.5f);
+    std::vector<float> rows(count * dimension);
+    std::vector<const float*> pointers(count);
+    for (size_t r = 0; r < count; ++r) {
+        std::vector<float> row = sample_vector(dimension, static_cast<float>(r));
+        std::copy(row.begin(), row.end(), rows.begin() + r * dimension);
+        pointers[count - 1 - r] = rows.data() + r * dimension;
+    }
+    for (simd::Isa isa : supported_isas()) {
+        simd::set_active_isa(isa);
+        std::vector<float> dots(count), scattered(count), distances(count);
+        simd::dot_batch(query.data(), rows.data(), count, dimension, dots.data());
+        simd::dot_batch(query.data(), pointers.data(), count, dimension, scattered.data());
+        simd::squared_l2_batch(query.data(), rows.data(), count, dimension, distances.data());
+        for (size_t r = 0; r < count; ++r) {
+            const float* row = rows.data() + r * dimension;
+            TEST_ASSERT(close_to(simd::dot(query.data(), row, dimension), dots[r]), simd::isa_name(isa) << " dot batch row " << r);
+            TEST_ASSERT(close_to(dots[r], scattered[count - 1 - r]), simd::isa_name(isa) << " scattered batch row " << r);
+            TEST_ASSERT(close_to(simd::squared_l2(query.data(), row, dimension), distances[r]), simd::isa_name(isa) << " L2 batch row " << r);
+        }
+    }
+    return true;
+}
+
+bool test_half_kernels() {
+    TEST_ASSERT_EQUAL(0x3c00, simd::float_to_half(1.0f), "1.0 should encode exactly");
+    TEST_ASSERT_EQUAL(-2.0f, simd::half_to_float(0xc000), "-2.0 should decode exactly");
+
+    std::vector<float> values = sample_vector(769, 0.2f);
+    values[3] = 1e-6f;                      // Subnormal half
+    values[4] = 70000.0f;                   // Overflows to inf
+    values[5] = -0.0f;
+    std::vector<uint16_t> expected(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        expected[i] = simd::float_to_half(values[i]);
+    }
+    std::vector<float> query = sample_vector(values.size(), 0.9f);
+    for (simd::Isa isa : supported_isas()) {
+        simd::set_active_isa(isa);
+        std::vector<uint16_t> halves(values.size());
+        simd::float_to_half(values.data(), halves.data(), values.size());
+        TEST_ASSERT(halves == expected, simd::isa_name(isa) << " conversion should round like the scalar one");
+
+        std::vector<float> decoded(values.size());
+        simd::half_to_float(halves.data(), decoded.data(), halves.size());
+        double dot = 0.0, norm = 0.0;
+        for (size_t i = 0; i < decoded.size(); ++i) {
+            TEST_ASSERT_EQUAL(simd::half_to_float(halves[i]), decoded[i], simd::isa_name(isa) << " decode element " << i);
+            if (std::isfinite(decoded[i])) {
+                dot += static_cast<double>(query[i]) * decoded[i];
+                norm += static_cast<double>(decoded[i]) * decoded[i];
+            }
+        }
+        halves[4] = 0;                      // Keep the inf out of the sums
+        TEST_ASSERT(close_to(dot, simd::dot_f16(query.data(), halves.data(), halves.size())), simd::isa_name(isa) << " fp16 dot");
+        TEST_ASSERT(close_to(norm, simd::squared_norm_f16(halves.data(), halves.size())), simd::isa_name(isa) << " fp16 norm");
+    }
+    return true;
+}
+
+bool test_int8_kernels() {
+    const size_t count = 385;
+    std::vector<int8_t> a(count), b(count);
+    for (size_t i = 0; i < count; ++i) {
+        a[i] = static_cast<int8_t>(static_cast<int>(i * 37 % 255) - 127);
+        b[i] = static_cast<int8_t>(i % 2 ? -128 : 127 - static_cast<int>(i % 100));
+    }
+    int32_t expected = 0;
+    for (size_t i = 0; i < count; ++i) {
+        expected += static_cast<int32_t>(a[i]) * b[i];
+    }
+    std::vector<float> query = sample_vector(count, 0.4f);
+    const float scales[2] = {0.01f, 0.5f};
+    std::vector<int8_t> rows(a);
+    rows.insert(rows.end(), b.begin(), b.end());
+    for (simd::Isa isa : supported_isas()) {
+        simd::set_active_isa(isa);
+        TEST_ASSERT_EQUAL(expected, simd::dot_i8(a.data(), b.data(), count), simd::isa_name(isa) << " int8 dot is exact");
+
+        std::vector<float> dequantized(count);
+        simd::dequantize_i8(a.data(), 0.25f, dequantized.data(), count);
+        double dot = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            TEST_ASSERT_EQUAL(a[i] * 0.25f, dequantized[i], simd::isa_name(isa) << " dequantize element " << i);
+            dot += static_cast<double>(query[i]) * a[i];
+        }
+        TEST_ASSERT(close_to(dot, simd::dot_f32_i8(query.data(), a.data(), count)), simd::isa_name(isa) << " float x int8 dot");
+
+        float batch[2];
+        simd::dot_batch_i8(query.data(), rows.data(), scales, 2, count, batch);
+        TEST_ASSERT(close_to(dot * scales[0], batch[0]), simd::isa_name(isa) << " int8 batch applies the row scale");
+    }
+    return true;
+}
+
+bool test_max_abs() {
+    std::vector<float> values = sample_vector(101, 0.0f);
+    values[77] = -3.5f;
+    for (simd::Isa isa : supported_isas()) {
+        simd::set_active_isa(isa);
+        TEST_ASSERT_EQUAL(3.5f, simd::max_abs(values.data(), values.size()), simd::isa_name(isa) << " max_abs");
+        TEST_ASSERT_EQUAL(0.0f, simd::max_abs(values.data(), 0), "Empty vector");
+    }
+    return true;
+}
+
+bool test_hamming() {
+    std::vector<uint8_t> codes(5 * 77);
+    uint32_t state = 12345;
+    for (uint8_t& byte : codes) {
+        state = state * 1103515245u + 12345u;
+        byte = static_cast<uint8_t>(state >> 16);
+    }
+    for (simd::Isa isa : supported_isas()) {
+        simd::set_active_isa(isa);
+        for (size_t size : {size_t(0), size_t(1), size_t(8), size_t(16), size_t(32), size_t(48), size_t(77)}) {
+            uint32_t expected = 0;
+            for (size_t i = 0; i < size; ++i) {
+                for (uint32_t bits = codes[i] ^ codes[77 + i]; bits; bits &= bits - 1) {
+                    expected++;
+                }
+            }
+            TEST_ASSERT_EQUAL(expected, simd::hamming(codes.data(), codes.data() + 77, size),
+                              simd::isa_name(isa) << " hamming over " << size << " bytes");
+        }
+        uint32_t distances[4];
+        simd::hamming_batch(codes.data(), codes.data() + 77, 4, 77, distances);
+        for (size_t row = 0; row < 4; ++row) {
+            TEST_ASSERT_EQUAL(simd::hamming(codes.data(), codes.data() + 77 * (row + 1), 77), distances[row],
+                              simd::isa_name(isa) << " hamming batch row " << row);
+        }
+        TEST_ASSERT_EQUAL(0u, simd::hamming(codes.data(), codes.data(), 77), "A code is at distance 0 from itself");
+    }
+    return true;
+}
+
+bool test_top_k_matches_stable_sort() {
+    std::vector<float> scores(1000);
+    for (size_t i = 0; i < scores.size(); ++i) {
+        scores[i] = std::round(std::sin(static_cast<float>(i) * 1.7f) * 20.0f);   // Plenty of ties
+    }
+    for (simd::Isa isa : supported_isas()) {
+        simd::set_active_isa(isa);
+        for (bool largest : {true, false}) {
+            std::vector<uint32_t> order(scores.size());
+            std::iota(order.begin(), order.end(), 0u);
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+                return largest ? scores[a] > scores[b] : scores[a] < scores[b];
+            });
+            for (size_t k : {size_t(0), size_t(1), size_t(10), size_t(100), size_t(1000), size_t(5000)}) {
+                std::vector<uint32_t> best;
+                simd::top_k(scores.data(), scores.size(), k, largest, best);
+                std::vector<uint32_t> expected(order.begin(), order.begin() + std::min(k, order.size()));
+                TEST_ASSERT(best == expected, simd::isa_name(isa) << " top-" << k << (largest ? " largest" : " smallest"));
+            }
+        }
+        TEST_ASSERT_EQUAL(size_t(0), simd::argmax(scores.data(), 0), "argmax of nothing is count");
+        size_t expected_argmax = static_cast<size_t>(std::max_element(scores.begin(), scores.end()) - scores.begin());
+        TEST_ASSERT_EQUAL(expected_argmax, simd::argmax(scores.data(), scores.size()), simd::isa_name(isa) << " argmax");
+    }
+    return true;
+}
+
+bool test_pool_tokens_matches_reference() {
+    const size_t tokens = 9;
+    std::vector<int32_t> mask = {0, 1, 1, 0, 1, 1, 1, 0, 0};   // Leading and inner padding are skipped too
+    for (simd::Isa isa : supported_isas()) {
+        simd::set_active_isa(isa);
+        for (size_t dimension : kLengths) {
+            if (dimension == 0) {
+                continue;
+            }
+            std::vector<float> states(tokens * dimension);
+            for (size_t t = 0; t < tokens; ++t) {
+                std::vector<float> row = sample_vector(dimension, static_cast<float>(t) * 0.9f);
+                std::copy(row.begin(), row.end(), states.begin() + t * dimension);
+            }
+            for (simd::Pooling pooling : {simd::Pooling::MEAN, simd::Pooling::CLS, simd::Pooling::MAX}) {
+                std::vector<double> expected(dimension, pooling == simd::Pooling::MAX ? -1e9 : 0.0);
+                size_t real = 0;
+                for (size_t t = 0; t < tokens; ++t) {
+                    if (!mask[t] || (pooling == simd::Pooling::CLS && real > 0)) {
+                        continue;
+                    }
+                    for (size_t d = 0; d < dimension; ++d) {
+                        double value = states[t * dimension + d];
+                        expected[d] = pooling == simd::Pooling::MAX ? std::max(expected[d], value) : expected[d] + value;
+                    }
+                    real++;
+                }
+                double norm = 0.0;
+                for (size_t d = 0; d < dimension; ++d) {
+                    expected[d] /= pooling == simd::Pooling::MEAN ? static_cast<double>(real) : 1.0;
+                    norm += expected[d] * expected[d];
+                }
+
+                std::vector<float> pooled(dimension), unit(dimension);
+                TEST_ASSERT(simd::pool_tokens(states.data(), mask.data(), tokens, dimension, pooling, false, pooled.data()),
+                            "Masked rows with real tokens should pool");
+                TEST_ASSERT(simd::pool_tokens(states.data(), mask.data(), tokens, dimension, pooling, true, unit.data()),
+                            "Non-zero pooled vector should normalize");
+                for (size_t d = 0; d < dimension; ++d) {
+                    TEST_ASSERT(close_to(expected[d], pooled[d]), simd::isa_name(isa) << " pooled value " << d << ", length " << dimension);
+                    TEST_ASSERT(close_to(expected[d] / std::sqrt(norm), unit[d]),
+                                simd::isa_name(isa) << " fused normalized value " << d << ", length " << dimension);
+                }
+            }
+        }
+    }
+
+    const size_t dimension = 5;
+    std::vector<float> states(2 * dimension, 1.0f);
+    std::vector<int32_t> padding(2, 0);
+    std::vector<float> pooled(dimension, 3.0f);
+    TEST_ASSERT(!simd::pool_tokens(states.data(), padding.data(), 2, dimension, simd::Pooling::MEAN, true, pooled.data()),
+                "A fully masked row has nothing to pool");
+    TEST_ASSERT_EQUAL(0.0f, pooled[0], "A fully masked row pools to zeros");
+    TEST_ASSERT(simd::pool_tokens(states.data(), nullptr, 2, dimension, simd::Pooling::MEAN, false, pooled.data()),
+                "No mask means every token is real");
+    TEST_ASSERT(close_to(1.0, pooled[dimension - 1]), "Mean of equal rows is the row");
+    return true;
+}
+
+int main() {
+    std::cout << "=== SIMD Kernel Tests ===" << std::endl;
+    std::cout << "Detected: " << simd::isa_name(simd::detected_isa()) << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_fp32_kernels_match_reference);
+    RUN_TEST(test_batches_match_single_calls);
+    RUN_TEST(test_half_kernels);
+    RUN_TEST(test_int8_kernels);
+    RUN_TEST(test_max_abs);
+    RUN_TEST(test_hamming);
+    RUN_TEST(test_top_k_matches_stable_sort);
+    RUN_TEST(test_pool_tokens_matches_reference);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,165 @@
+#include "../../../include/leafra/leafra_simhash.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+
+static std::string sample_text(size_t words, uint32_t seed) {
+    static const char* vocabulary[] = {"invoice", "payment", "terms", "net", "thirty", "days", "customer", "supplier",
+                                       "delivery", "goods", "services", "tax", "total", "amount", "due", "contract",
+                                       "party", "agreement", "notice", "written", "period", "renewal", "liability", "law"};
+    std::mt19937 rng(seed);
+    std::string text;
+    for (size_t i = 0; i < words; ++i) {
+        text += vocabulary[rng() % (sizeof(vocabulary) / sizeof(vocabulary[0]))];
+        text += (i % 12 == 11) ? ". " : " ";
+    }
+    return text;
+}
+
+bool test_fingerprint_basics() {
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(0), SimHash::fingerprint(""), "Empty text has no fingerprint");
+    TEST_ASSERT_EQUAL(static_cast<uint64_t>(0), SimHash::fingerprint(" ,.;-- !"), "Punctuation only has no fingerprint");
+    TEST_ASSERT_EQUAL(SimHash::fingerprint("Hello World, again"), SimHash::fingerprint("hello   world again!"),
+                      "Case, spacing and punctuation are ignored");
+    TEST_ASSERT(SimHash::fingerprint("one") != 0, "A text shorter than a shingle still has a fingerprint");
+    std::string text = sample_text(200, 1);
+    TEST_ASSERT_EQUAL(SimHash::fingerprint(text), SimHash::fingerprint(text), "Fingerprints are deterministic");
+    TEST_ASSERT_EQUAL(0, SimHash::distance(0x1234, 0x1234), "Distance of equal values");
+    TEST_ASSERT_EQUAL(64, SimHash::distance(0, ~0ULL), "Distance counts every differing bit");
+    return true;
+}
+
+bool test_near_duplicates_are_close() {
+    std::string original = sample_text(300, 7);
+    std::string edited = original;
+    edited.replace(edited.find("payment"), 7, "receipt");           // one changed word
+    std::string unrelated = sample_text(300, 8);
+
+    int32_t near = SimHash::distance(SimHash::fingerprint(original), SimHash::fingerprint(edited));
+    int32_t far = SimHash::distance(SimHash::fingerprint(original), SimHash::fingerprint(unrelated));
+    TEST_ASSERT(near <= 3, "One changed word moves the fingerprint by only a few bits (got " << near << ")");
+    TEST_ASSERT(far > 10, "Unrelated text lands far away (got " << far << ")");
+    return true;
+}
+
+// Every stored fingerprint within max_distance must be found, whichever bits differ (band pigeonhole)
+bool test_index_matches_brute_force() {
+    std::mt19937_64 rng(99);
+    for (int32_t max_distance : {0, 2, 3, 7}) {
+        NearDuplicateIndex index(max_distance);
+        std::vector<uint64_t> stored;
+        for (int i = 0; i < 2000; ++i) {
+            uint64_t value = rng() | 1;
+            stored.push_back(value);
+            index.add(value, i);
+        }
+        TEST_ASSERT_EQUAL(stored.size(), index.size(), "Every fingerprint is stored");
+
+        std::vector<NearDuplicateIndex::Match> matches;
+        for (int probe = 0; probe < 500; ++probe) {
+            uint64_t query = stored[rng() % stored.size()];
+            int32_t flips = static_cast<int32_t>(rng() % (max_distance + 2));
+            for (int32_t f = 0; f < flips; ++f) {
+                query ^= 1ULL << (rng() % 64);
+            }
+            index.find(query, matches, stored.size());
+            size_t expected = 0;
+            for (uint64_t value : stored) {
+                expected += SimHash::distance(query, value) <= max_distance ? 1 : 0;
+            }
+            TEST_ASSERT_EQUAL(expected, matches.size(), "Index finds exactly the fingerprints within range");
+            for (size_t m = 1; m < matches.size(); ++m) {
+                TEST_ASSERT(matches[m - 1].distance <= matches[m].distance, "Matches are nearest first");
+            }
+        }
+    }
+    return true;
+}
+
+bool test_index_ordering_and_limits() {
+    NearDuplicateIndex index(3);
+    index.add(0, 1);                                                 // ignored
+    index.add(0xff00ff00ff00ff00ULL, 10);
+    index.add(0xff00ff00ff00ff00ULL, 11);
+    index.add(0xff00ff00ff00ff01ULL, 12);
+    TEST_ASSERT_EQUAL(static_cast<size_t>(3), index.size(), "Zero fingerprints are not stored");
+
+    std::vector<NearDuplicateIndex::Match> matches;
+    index.find(0xff00ff00ff00ff01ULL, matches);
+    TEST_ASSERT_EQUAL(static_cast<size_t>(3), matches.size(), "All three are within range");
+    TEST_ASSERT_EQUAL(static_cast<int64_t>(12), matches[0].id, "Exact match first");
+    TEST_ASSERT_EQUAL(static_cast<int64_t>(10), matches[1].id, "Ties keep insertion order");
+
+    index.find(0xff00ff00ff00ff01ULL, matches, 1);
+    TEST_ASSERT_EQUAL(static_cast<size_t>(1), matches.size(), "max_results caps the matches");
+    index.find(0x00ff00ff00ff00ffULL, matches);
+    TEST_ASSERT(matches.empty(), "Distant fingerprints don't match");
+
+    index.clear();
+    index.find(0xff00ff00ff00ff00ULL, matches);
+    TEST_ASSERT(matches.empty() && index.size() == 0, "clear() empties the index");
+    return true;
+}
+
+int main() {
+    std::cout << "=== SimHash Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_fingerprint_basics);
+    RUN_TEST(test_near_duplicates_are_close);
+    RUN_TEST(test_index_matches_brute_force);
+    RUN_TEST(test_index_ordering_and_limits);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -8,10 +8,18 @@
 #include <string>
 #include <vector>
 #include <filesystem>
+#include <cstring>
+#include <cmath>
+#include <atomic>
+#include <future>
+#include <mutex>
 
 #include "leafra/leafra_sqlite.h"
 #include "leafra/leafra_filemanager.h"
 #include "leafra/logger.h"
+#include "leafra/leafra_vector_codec.h"
+#include "leafra/leafra_text_codec.h"
+#include "leafra/leafra_bundle.h"
 
 using namespace leafra;
 
@@ -155,7 +163,7 @@ void test_transactions() {
     
     // Verify data was rolled back
     row_count = 0;
-    result = db.execute("SELECT * FROM transaction_test", [&row_count](const SQLiteDatabase::Row& row) {
+    result = db.execute("SELECT * FROM transaction_test", [&row_count](const SQLiteDatabase::Row&) {
         row_count++;
         return true;
     });
@@ -171,7 +179,7 @@ void test_transactions() {
     
     // Verify automatic rollback
     row_count = 0;
-    result = db.execute("SELECT * FROM transaction_test", [&row_count](const SQLiteDatabase::Row& row) {
+    result = db.execute("SELECT * FROM transaction_test", [&row_count](const SQLiteDatabase::Row&) {
         row_count++;
         return true;
     });
@@ -336,6 +344,1150 @@ void test_column_access() {
     cleanupTestDatabase("test_columns.db");
 }
 
+void test_bulk_insert() {
+    std::cout << "\n=== Testing Bulk Insert ===" << std::endl;
+    
+    cleanupTestDatabase("test_bulk.db");
+    bool created = SQLiteDatabase::createdb("test_bulk.db");
+    TEST_ASSERT(created == true, "Setup: Create test database");
+    
+    SQLiteDatabase db;
+    bool opened = db.open("test_bulk.db");
+    TEST_ASSERT(opened == true, "Setup: Open test database");
+    
+    bool result = db.execute("CREATE TABLE bulk_test (id INTEGER, name TEXT, data BLOB)");
+    TEST_ASSERT(result == true, "Setup: Create test table");
+    
+    // 150 rows with 64 rows per statement: two full batches plus a remainder
+    const int row_count = 150;
+    std::vector<std::string> names;
+    std::vector<std::vector<float>> vectors;
+    for (int i = 0; i < row_count; ++i) {
+        names.push_back("row_" + std::to_string(i));
+        vectors.push_back(std::vector<float>(4, static_cast<float>(i)));
+    }
+    
+    {
+        SQLiteTransaction transaction(db);
+        SQLiteDatabase::BulkInsert insert(db, "bulk_test", {"id", "name", "data"}, 64);
+        bool rows_ok = true;
+        for (int i = 0; i < row_count; ++i) {
+            insert.bindInt64(0, i);
+            insert.bindTextView(1, names[i]);
+            insert.bindBlobView(2, vectors[i].data(), vectors[i].size() * sizeof(float));
+            rows_ok = insert.endRow() && rows_ok;
+        }
+        TEST_ASSERT(rows_ok == true, "Bulk insert rows");
+        TEST_ASSERT(insert.flush() == true, "Bulk insert flush remainder");
+        TEST_ASSERT(insert.getRowsInserted() == static_cast<size_t>(row_count), "All rows reported inserted");
+        TEST_ASSERT(transaction.commit() == true, "Commit bulk insert transaction");
+    }
+    
+    int rows_read = 0;
+    bool values_match = true;
+    result = db.execute("SELECT id, name, data FROM bulk_test ORDER BY id", [&](const SQLiteDatabase::Row& row) {
+        int id = row.getInt(0);
+        auto blob = row.getBlob(2);
+        std::vector<float> expected(4, static_cast<float>(id));
+        values_match = values_match && id == rows_read && row.getText(1) == names[id] &&
+                       blob.size() == expected.size() * sizeof(float) &&
+                       std::memcmp(blob.data(), expected.data(), blob.size()) == 0;
+        rows_read++;
+        return true;
+    });
+    TEST_ASSERT(result == true && rows_read == row_count, "Read back all bulk inserted rows");
+    TEST_ASSERT(values_match == true, "Bulk inserted values should match");
+    
+    db.close();
+    cleanupTestDatabase("test_bulk.db");
+}
+
+void test_zero_copy_rows() {
+    std::cout << "\n=== Testing Zero-Copy Row Access ===" << std::endl;
+    
+    cleanupTestDatabase("test_views.db");
+    bool created = SQLiteDatabase::createdb("test_views.db");
+    TEST_ASSERT(created == true, "Setup: Create test database");
+    
+    SQLiteDatabase db;
+    bool opened = db.open("test_views.db");
+    TEST_ASSERT(opened == true, "Setup: Open test database");
+    
+    bool result = db.execute("CREATE TABLE view_test (id INTEGER, name TEXT, data BLOB)");
+    TEST_ASSERT(result == true, "Setup: Create test table");
+    
+    auto insert_stmt = db.prepare("INSERT INTO view_test (id, name, data) VALUES (?, ?, ?)");
+    std::vector<uint8_t> test_blob{0x10, 0x20, 0x30};
+    for (int i = 0; i < 3; ++i) {
+        insert_stmt->bindInt(1, i);
+        insert_stmt->bindText(2, "name_" + std::to_string(i));
+        insert_stmt->bindBlob(3, test_blob);
+        insert_stmt->execute();
+        insert_stmt->reset();
+    }
+    db.execute("INSERT INTO view_test (id, name, data) VALUES (3, NULL, NULL)");
+    
+    auto select_stmt = db.prepare("SELECT id, name, data FROM view_test ORDER BY id");
+    int visited = 0;
+    bool views_match = true;
+    bool stepped = select_stmt->forEachRow([&](const SQLiteDatabase::Row& row) {
+        int id = row.getInt(0);
+        std::string_view name = row.getTextView(1);
+        SQLiteDatabase::BlobView blob = row.getBlobView(2);
+        if (id < 3) {
+            views_match = views_match && name == "name_" + std::to_string(id) &&
+                          blob.size == test_blob.size() && std::memcmp(blob.data, test_blob.data(), blob.size) == 0;
+        } else {
+            views_match = views_match && name.empty() && blob.empty();
+        }
+        visited++;
+        return true;
+    });
+    TEST_ASSERT(stepped == true, "forEachRow should step through all rows");
+    TEST_ASSERT(visited == 4, "forEachRow should visit every row");
+    TEST_ASSERT(views_match == true, "Text and blob views should match stored values (NULL = empty)");
+    
+    select_stmt->reset();
+    visited = 0;
+    select_stmt->forEachRow([&](const SQLiteDatabase::Row&) {
+        visited++;
+        return visited < 2;
+    });
+    TEST_ASSERT(visited == 2, "Returning false from the visitor should stop iteration");
+    
+    db.close();
+    cleanupTestDatabase("test_views.db");
+}
+
+void test_statement_cache() {
+    std::cout << "\n=== Testing Prepared Statement Cache ===" << std::endl;
+    
+    cleanupTestDatabase("test_stmt_cache.db");
+    bool created = SQLiteDatabase::createdb("test_stmt_cache.db");
+    TEST_ASSERT(created == true, "Setup: Create test database");
+    
+    SQLiteDatabase db;
+    DatabaseConfig config;
+    config.statement_cache_size = 2;
+    db.setConfig(config);
+    bool opened = db.open("test_stmt_cache.db");
+    TEST_ASSERT(opened == true, "Setup: Open test database");
+    
+    bool result = db.execute("CREATE TABLE cache_test (id INTEGER, name TEXT)");
+    TEST_ASSERT(result == true, "Setup: Create test table");
+    
+    const std::string insert_sql = "INSERT INTO cache_test (id, name) VALUES (?, ?)";
+    for (int i = 0; i < 3; ++i) {
+        auto stmt = db.prepareCached(insert_sql);
+        TEST_ASSERT(stmt && stmt->isValid(), "Cached statement should be valid");
+        stmt->bindInt(1, i);
+        if (i < 2) {
+            stmt->bindText(2, "name_" + std::to_string(i));
+        }
+        stmt->execute();
+    }
+    SQLiteDatabase::StatementCacheStats stats = db.getStatementCacheStats();
+    TEST_ASSERT(stats.misses == 1 && stats.hits == 2, "Reused SQL should be served from the cache");
+    TEST_ASSERT(stats.entries == 1 && stats.capacity == 2, "Returned statement should be idle in the cache");
+    
+    // The third insert skipped binding the name, so a stale binding would show up here
+    auto check_stmt = db.prepare("SELECT COUNT(*) FROM cache_test WHERE id = 2 AND name IS NULL");
+    TEST_ASSERT(check_stmt->step() && check_stmt->getCurrentRow().getInt(0) == 1,
+                "Leased statements should come back with bindings cleared");
+    
+    {
+        auto first = db.prepareCached(insert_sql);
+        auto second = db.prepareCached(insert_sql);
+        TEST_ASSERT(first.get() != second.get(), "Concurrent leases of the same SQL should be distinct statements");
+    }
+    db.prepareCached("SELECT 1");
+    db.prepareCached("SELECT 2");
+    stats = db.getStatementCacheStats();
+    TEST_ASSERT(stats.entries == 2 && stats.evictions == 1, "Cache should evict the least recently used statement");
+    
+    db.clearStatementCache();
+    stats = db.getStatementCacheStats();
+    TEST_ASSERT(stats.entries == 0 && stats.hits == 0, "Clearing should drop idle statements and statistics");
+    
+    SQLiteDatabase::CachedStatement outstanding = db.prepareCached(insert_sql);
+    db.close();
+    outstanding = SQLiteDatabase::CachedStatement();
+    TEST_ASSERT(db.getStatementCacheStats().entries == 0, "Leases returned after close should not be cached");
+    
+    cleanupTestDatabase("test_stmt_cache.db");
+}
+
+void test_chunk_keyword_index() {
+    std::cout << "\n=== Testing Chunk Keyword Index ===" << std::endl;
+    
+    cleanupTestDatabase("test_keyword.db");
+    bool created = SQLiteDatabase::createdb("test_keyword.db");
+    TEST_ASSERT(created == true, "Setup: Create test database");
+    
+    SQLiteDatabase db;
+    bool opened = db.open("test_keyword.db");
+    TEST_ASSERT(opened == true, "Setup: Open test database");
+    
+    bool available = db.createChunkKeywordIndex();
+    TEST_ASSERT(available == true, "Keyword index should be available on an FTS5-enabled SQLite");
+    if (!available) {
+        db.close();
+        cleanupTestDatabase("test_keyword.db");
+        return;
+    }
+    
+    db.execute("INSERT INTO docs (id, filename, url, size) VALUES (1, 'manual.pdf', 'manual.pdf', 100)");
+    db.execute("INSERT INTO chunks (doc_id, chunk_page_number, chunk_no, chunk_token_size, chunk_size, chunk_text) "
+               "VALUES (1, 1, 0, 5, 30, 'Replace filter part AB-1234 yearly')");
+    db.execute("INSERT INTO chunks (doc_id, chunk_page_number, chunk_no, chunk_token_size, chunk_size, chunk_text) "
+               "VALUES (1, 2, 1, 4, 25, 'The pump runs quietly')");
+    
+    auto count_matches = [&](const std::string& expression) {
+        auto stmt = db.prepare("SELECT COUNT(*) FROM chunks_fts WHERE chunks_fts MATCH ?");
+        stmt->bindText(1, expression);
+        return stmt->step() ? stmt->getCurrentRow().getInt(0) : -1;
+    };
+    TEST_ASSERT(count_matches("\"AB-1234\"") == 1, "Inserted chunks should be searchable by exact term");
+    TEST_ASSERT(count_matches("pump") == 1, "Keyword index should match single words");
+    
+    db.execute("UPDATE chunks SET chunk_text = 'The pump was replaced' WHERE chunk_no = 1");
+    TEST_ASSERT(count_matches("quietly") == 0 && count_matches("replaced") == 1, "Updates should reindex chunk text");
+    
+    db.execute("DELETE FROM chunks WHERE chunk_no = 0");
+    TEST_ASSERT(count_matches("\"AB-1234\"") == 0, "Deleted chunks should leave the keyword index");
+    
+    // Older databases get the index rebuilt from the chunks they already hold
+    db.execute("DROP TRIGGER chunks_fts_insert");
+    db.execute("DROP TRIGGER chunks_fts_delete");
+    db.execute("DROP TRIGGER chunks_fts_update");
+    db.execute("DROP TABLE chunks_fts");
+    TEST_ASSERT(db.createChunkKeywordIndex() == true, "Keyword index should be recreated on an existing database");
+    TEST_ASSERT(count_matches("replaced") == 1, "Recreated keyword index should cover existing chunks");
+    
+    db.close();
+    cleanupTestDatabase("test_keyword.db");
+}
+
+void test_compressed_chunk_text() {
+    std::cout << "\n=== Testing Compressed Chunk Text ===" << std::endl;
+    
+    cleanupTestDatabase("test_compressed_text.db");
+    bool created = SQLiteDatabase::createdb("test_compressed_text.db");
+    TEST_ASSERT(created == true, "Setup: Create test database");
+    
+    SQLiteDatabase db;
+    bool opened = db.open("test_compressed_text.db");
+    TEST_ASSERT(opened == true, "Setup: Open test database");
+    if (!db.createChunkKeywordIndex()) {
+        db.close();
+        cleanupTestDatabase("test_compressed_text.db");
+        return;
+    }
+    
+    std::string text;
+    for (int i = 0; i < 20; ++i) {
+        text += "Inspect valve VX-99 before every pressure test of the cooling loop. ";
+    }
+    std::vector<uint8_t> blob;
+    TEST_ASSERT(TextCodec::compress(text, TextCompression::LZ4, blob), "Repetitive chunk text should compress");
+    
+    db.execute("INSERT INTO docs (id, filename, url, size) VALUES (1, 'manual.pdf', 'manual.pdf', 100)");
+    auto insert = db.prepare("INSERT INTO chunks (doc_id, chunk_page_number, chunk_no, chunk_token_size, chunk_size, chunk_text) "
+                             "VALUES (1, 1, ?, 10, ?, ?)");
+    insert->bindInt(1, 0);
+    insert->bindInt64(2, static_cast<long long>(text.size()));
+    insert->bindBlobView(3, blob.data(), blob.size());
+    TEST_ASSERT(insert->execute(), "Compressed chunk text should insert as a blob");
+    insert->reset();
+    insert->bindInt(1, 1);
+    insert->bindInt64(2, 21);
+    insert->bindText(3, "The pump runs quietly");
+    TEST_ASSERT(insert->execute(), "Plain chunk text should still insert as text");
+    
+    auto count_matches = [&](const std::string& expression) {
+        auto stmt = db.prepare("SELECT COUNT(*) FROM chunks_fts WHERE chunks_fts MATCH ?");
+        stmt->bindText(1, expression);
+        return stmt->step() ? stmt->getCurrentRow().getInt(0) : -1;
+    };
+    TEST_ASSERT(count_matches("\"VX-99\"") == 1, "Compressed chunks should be indexed by their text");
+    TEST_ASSERT(count_matches("pump") == 1, "Plain chunks should be indexed as before");
+    
+    std::string restored;
+    db.execute("SELECT leafra_chunk_text(chunk_text) FROM chunks WHERE chunk_no = 0", [&restored](const SQLiteDatabase::Row& row) {
+        restored = row.getText(0);
+        return false;
+    });
+    TEST_ASSERT(restored == text, "leafra_chunk_text() should decompress stored blobs");
+    
+    // Indexes built over existing rows, and triggers from before compression, see the text too
+    db.execute("DROP TRIGGER chunks_fts_insert");
+    db.execute("DROP TRIGGER chunks_fts_delete");
+    db.execute("DROP TRIGGER chunks_fts_update");
+    db.execute("DROP TABLE chunks_fts");
+    db.execute("CREATE TRIGGER chunks_fts_insert AFTER INSERT ON chunks BEGIN SELECT 1; END");
+    TEST_ASSERT(db.createChunkKeywordIndex() == true, "Keyword index should be recreated over compressed rows");
+    TEST_ASSERT(count_matches("\"VX-99\"") == 1, "Recreated keyword index should cover compressed chunks");
+    
+    db.execute("DELETE FROM chunks WHERE chunk_no = 0");
+    TEST_ASSERT(count_matches("\"VX-99\"") == 0, "Deleted compressed chunks should leave the keyword index");
+    TEST_ASSERT(count_matches("pump") == 1, "Other chunks should stay indexed");
+    
+    db.close();
+    cleanupTestDatabase("test_compressed_text.db");
+}
+
+void test_offset_chunk_text() {
+    std::cout << "\n=== Testing Offset Chunk Text ===" << std::endl;
+    
+    cleanupTestDatabase("test_offset_text.db");
+    bool created = SQLiteDatabase::createdb("test_offset_text.db");
+    TEST_ASSERT(created == true, "Setup: Create test database");
+    
+    SQLiteDatabase db;
+    bool opened = db.open("test_offset_text.db");
+    TEST_ASSERT(opened == true, "Setup: Open test database");
+    TEST_ASSERT(db.createDocTextTable() == true, "doc_texts should be available (and creating it again a no-op)");
+    const bool keyword_index = db.createChunkKeywordIndex();
+    
+    // Document text in 16-byte pages, the second one compressed; chunks are ranges that cross page boundaries
+    const std::string text = "Check the gasket. Torque bolts to 40 Nm. Then run the leak test on loop B-7.";
+    db.execute("INSERT INTO docs (id, filename, url, size) VALUES (1, 'manual.pdf', 'manual.pdf', 100)");
+    auto page = db.prepare("INSERT INTO doc_texts (doc_id, text_start, text_end, page_text) VALUES (1, ?, ?, ?)");
+    std::vector<uint8_t> blob;
+    for (size_t start = 0; start < text.size(); start += 16) {
+        const std::string part = text.substr(start, 16);
+        page->bindInt64(1, static_cast<long long>(start));
+        page->bindInt64(2, static_cast<long long>(start + part.size()));
+        if (start == 16) {
+            // compress() leaves text this short alone, so the blob (LZ4 tag, size, payload) is put together by hand
+            blob.assign({static_cast<uint8_t>(TextCompression::LZ4), static_cast<uint8_t>(part.size())});
+            TextCodec::lz4_compress(reinterpret_cast<const uint8_t*>(part.data()), part.size(), blob);
+            page->bindBlobView(3, blob.data(), blob.size());
+        } else {
+            page->bindText(3, part);
+        }
+        TEST_ASSERT(page->execute(), "Document text pages should insert");
+        page->reset();
+    }
+    
+    auto chunk = db.prepare("INSERT INTO chunks (doc_id, chunk_page_number, chunk_no, chunk_token_size, chunk_size, chunk_text, "
+                            "chunk_start, chunk_end) VALUES (1, 1, ?, 5, ?, '', ?, ?)");
+    const size_t ranges[][2] = {{0, 40}, {18, text.size()}};
+    for (int i = 0; i < 2; ++i) {
+        chunk->bindInt(1, i);
+        chunk->bindInt64(2, static_cast<long long>(ranges[i][1] - ranges[i][0]));
+        chunk->bindInt64(3, static_cast<long long>(ranges[i][0]));
+        chunk->bindInt64(4, static_cast<long long>(ranges[i][1]));
+        TEST_ASSERT(chunk->execute(), "Offset chunks should insert");
+        chunk->reset();
+    }
+    
+    std::vector<std::string> texts;
+    db.execute("SELECT leafra_chunk_text(chunk_text, doc_id, chunk_start, chunk_end) FROM chunks ORDER BY chunk_no",
+               [&texts](const SQLiteDatabase::Row& row) {
+        texts.push_back(row.getText(0));
+        return true;
+    });
+    TEST_ASSERT(texts.size() == 2 && texts[0] == text.substr(0, 40) && texts[1] == text.substr(18),
+                "Offset chunks should resolve to their range of the document text");
+    
+    if (keyword_index) {
+        auto count_matches = [&](const std::string& expression) {
+            auto stmt = db.prepare("SELECT COUNT(*) FROM chunks_fts WHERE chunks_fts MATCH ?");
+            stmt->bindText(1, expression);
+            return stmt->step() ? stmt->getCurrentRow().getInt(0) : -1;
+        };
+        TEST_ASSERT(count_matches("torque") == 2 && count_matches("gasket") == 1, "Offset chunks should be keyword searchable");
+        db.execute("DELETE FROM chunks WHERE doc_id = 1");
+        TEST_ASSERT(count_matches("torque") == 0, "Deleted offset chunks should leave the keyword index");
+    } else {
+        db.execute("DELETE FROM chunks WHERE doc_id = 1");
+    }
+    
+    db.execute("DELETE FROM docs WHERE id = 1");
+    int remaining = -1;
+    db.execute("SELECT COUNT(*) FROM doc_texts", [&remaining](const SQLiteDatabase::Row& row) {
+        remaining = row.getInt(0);
+        return false;
+    });
+    TEST_ASSERT(remaining == 0, "Deleting a document should remove its text pages");
+    
+    db.close();
+    cleanupTestDatabase("test_offset_text.db");
+}
+
+void test_chunk_embeddings_table() {
+    std::cout << "\n=== Testing Chunk Embeddings Table ===" << std::endl;
+    
+    cleanupTestDatabase("test_chunk_embeddings.db");
+    SQLiteDatabase db;
+    bool opened = db.open("test_chunk_embeddings.db");
+    TEST_ASSERT(opened == true, "Setup: Open test database");
+    
+    // Schema of databases created before chunk_embeddings existed
+    db.execute("CREATE TABLE chunks (id INTEGER PRIMARY KEY AUTOINCREMENT, doc_id INTEGER NOT NULL, "
+               "chunk_faiss_id INTEGER, chunk_text TEXT NOT NULL, chunk_embedding BLOB)");
+    std::vector<float> embedding{0.25f, -0.5f, 1.0f};
+    const uint8_t* embedding_bytes = reinterpret_cast<const uint8_t*>(embedding.data());
+    std::vector<uint8_t> embedding_blob(embedding_bytes, embedding_bytes + embedding.size() * sizeof(float));
+    auto insert_stmt = db.prepare("INSERT INTO chunks (doc_id, chunk_faiss_id, chunk_text, chunk_embedding) VALUES (1, ?, 'text', ?)");
+    for (int64_t faiss_id : {1000000, 1000001}) {
+        insert_stmt->bindInt64(1, faiss_id);
+        insert_stmt->bindBlob(2, embedding_blob);
+        insert_stmt->execute();
+        insert_stmt->reset();
+    }
+    
+    bool created = db.createChunkEmbeddingsTable();
+    TEST_ASSERT(created == true, "Chunk embeddings table should be created on an existing database");
+    
+    auto select_stmt = db.prepare("SELECT format, byte_order, dimension, embedding FROM chunk_embeddings WHERE chunk_faiss_id = 1000001");
+    bool found = select_stmt->step();
+    TEST_ASSERT(found == true, "Inline embeddings should be moved into chunk_embeddings");
+    if (found) {
+        const auto& row = select_stmt->getCurrentRow();
+        std::vector<float> decoded(embedding.size());
+        SQLiteDatabase::BlobView blob = row.getBlobView(3);
+        bool decoded_ok = VectorCodec::decode(static_cast<EmbeddingStorageFormat>(row.getInt(0)), static_cast<ByteOrder>(row.getInt(1)),
+                                              0.0f, blob.data, blob.size, decoded.data(), decoded.size());
+        TEST_ASSERT(row.getInt(2) == 3 && decoded_ok && decoded == embedding, "Moved embeddings should decode as fp32");
+    }
+    select_stmt.reset();
+    
+    auto inline_stmt = db.prepare("SELECT COUNT(*) FROM chunks WHERE chunk_embedding IS NOT NULL");
+    TEST_ASSERT(inline_stmt->step() && inline_stmt->getCurrentRow().getInt(0) == 0, "Inline embedding blobs should be cleared");
+    inline_stmt.reset();
+    
+    db.execute("DELETE FROM chunks WHERE chunk_faiss_id = 1000000");
+    auto count_stmt = db.prepare("SELECT COUNT(*) FROM chunk_embeddings");
+    TEST_ASSERT(count_stmt->step() && count_stmt->getCurrentRow().getInt(0) == 1, "Deleting a chunk should delete its embedding");
+    count_stmt.reset();
+    
+    TEST_ASSERT(db.createChunkEmbeddingsTable() == true, "Creating the table again should be a no-op");
+    
+    db.close();
+    cleanupTestDatabase("test_chunk_embeddings.db");
+}
+
+void test_doc_centroids_table() {
+    std::cout << "\n=== Testing Document Centroids Table ===" << std::endl;
+    
+    cleanupTestDatabase("test_doc_centroids.db");
+    bool created = SQLiteDatabase::createdb("test_doc_centroids.db");
+    TEST_ASSERT(created == true, "Setup: Create test database");
+    
+    SQLiteDatabase db;
+    bool opened = db.open("test_doc_centroids.db");
+    TEST_ASSERT(opened == true, "Setup: Open test database");
+    TEST_ASSERT(db.createDocCentroidsTable() == true, "Creating the table again should be a no-op");
+    
+    db.execute("INSERT INTO docs (id, filename, url, size) VALUES (1, 'a.pdf', 'a.pdf', 10), (2, 'b.pdf', 'b.pdf', 10)");
+    std::vector<float> centroid{0.5f, 0.5f, 0.0f};
+    VectorCodec::Encoded encoded;
+    VectorCodec::encode(centroid.data(), centroid.size(), EmbeddingStorageFormat::FP32, encoded);
+    auto insert_stmt = db.prepare("INSERT INTO doc_centroids (doc_id, chunk_count, format, byte_order, dimension, scale, embedding) "
+                                  "VALUES (?, 2, ?, ?, 3, 0, ?)");
+    for (int64_t doc_id : {1, 2}) {
+        insert_stmt->bindInt64(1, doc_id);
+        insert_stmt->bindInt(2, static_cast<int>(encoded.format));
+        insert_stmt->bindInt(3, static_cast<int>(encoded.byte_order));
+        insert_stmt->bindBlob(4, encoded.data);
+        insert_stmt->execute();
+        insert_stmt->reset();
+    }
+    
+    db.execute("DELETE FROM docs WHERE id = 1");
+    auto count_stmt = db.prepare("SELECT doc_id FROM doc_centroids");
+    TEST_ASSERT(count_stmt->step() && count_stmt->getCurrentRow().getInt(0) == 2 && !count_stmt->step(),
+                "Deleting a document should delete its centroid");
+    count_stmt.reset();
+    
+    db.close();
+    cleanupTestDatabase("test_doc_centroids.db");
+}
+
+void test_chunk_llm_tokens_table() {
+    std::cout << "\n=== Testing Chunk LLM Tokens Table ===" << std::endl;
+    
+    cleanupTestDatabase("test_chunk_llm_tokens.db");
+    bool created = SQLiteDatabase::createdb("test_chunk_llm_tokens.db");
+    TEST_ASSERT(created == true, "Setup: Create test database");
+    
+    SQLiteDatabase db;
+    bool opened = db.open("test_chunk_llm_tokens.db");
+    TEST_ASSERT(opened == true, "Setup: Open test database");
+    TEST_ASSERT(db.createChunkLLMTokensTable() == true, "Creating the table again should be a no-op");
+    
+    db.execute("INSERT INTO docs (id, filename, url, size) VALUES (1, 'a.pdf', 'a.pdf', 10)");
+    db.execute("INSERT INTO chunks (doc_id, chunk_page_number, chunk_faiss_id, chunk_no, chunk_token_size, chunk_size, chunk_text) "
+               "VALUES (1, 1, 7, 1, 1, 3, 'one'), (1, 1, 8, 2, 1, 3, 'two')");
+    const std::vector<int32_t> tokens{1, 300, 70000};
+    std::vector<uint8_t> blob;
+    TextCodec::encode_tokens(tokens, blob);
+    auto insert_stmt = db.prepare("INSERT INTO chunk_llm_tokens (chunk_faiss_id, vocab, tokens) VALUES (?, 'model.gguf:32000', ?)");
+    for (int64_t faiss_id : {7, 8}) {
+        insert_stmt->bindInt64(1, faiss_id);
+        insert_stmt->bindBlob(2, blob);
+        insert_stmt->execute();
+        insert_stmt->reset();
+    }
+    insert_stmt.reset();
+    
+    auto select_stmt = db.prepare("SELECT tokens FROM chunk_llm_tokens WHERE chunk_faiss_id = 8");
+    bool found = select_stmt->step();
+    TEST_ASSERT(found == true, "Stored tokens should be found by chunk id");
+    if (found) {
+        SQLiteDatabase::BlobView stored = select_stmt->getCurrentRow().getBlobView(0);
+        std::vector<int32_t> decoded;
+        TEST_ASSERT(TextCodec::decode_tokens(stored.data, stored.size, decoded) && decoded == tokens, "Stored tokens should decode");
+    }
+    select_stmt.reset();
+    
+    db.execute("DELETE FROM chunks WHERE chunk_faiss_id = 7");
+    auto count_stmt = db.prepare("SELECT chunk_faiss_id FROM chunk_llm_tokens");
+    TEST_ASSERT(count_stmt->step() && count_stmt->getCurrentRow().getInt(0) == 8 && !count_stmt->step(),
+                "Deleting a chunk should delete its tokens");
+    count_stmt.reset();
+    
+    db.close();
+    cleanupTestDatabase("test_chunk_llm_tokens.db");
+}
+
+void test_chunk_retrievals_table() {
+    std::cout << "\n=== Testing Chunk Retrievals Table ===" << std::endl;
+    
+    cleanupTestDatabase("test_chunk_retrievals.db");
+    bool created = SQLiteDatabase::createdb("test_chunk_retrievals.db");
+    TEST_ASSERT(created == true, "Setup: Create test database");
+    
+    SQLiteDatabase db;
+    bool opened = db.open("test_chunk_retrievals.db");
+    TEST_ASSERT(opened == true, "Setup: Open test database");
+    TEST_ASSERT(db.createChunkRetrievalsTable() == true, "Creating the table again should be a no-op");
+    
+    db.execute("INSERT INTO docs (id, filename, url, size) VALUES (1, 'a.pdf', 'a.pdf', 10)");
+    db.execute("INSERT INTO chunks (doc_id, chunk_page_number, chunk_faiss_id, chunk_no, chunk_token_size, chunk_size, chunk_text) "
+               "VALUES (1, 1, 7, 1, 1, 3, 'one'), (1, 1, 8, 2, 1, 3, 'two')");
+    auto upsert_stmt = db.prepare("INSERT INTO chunk_retrievals (chunk_faiss_id, retrievals) VALUES (?, ?) "
+                                  "ON CONFLICT(chunk_faiss_id) DO UPDATE SET retrievals = retrievals + excluded.retrievals");
+    const int64_t counts[][2] = {{7, 2}, {8, 1}, {8, 4}};
+    for (const auto& count : counts) {
+        upsert_stmt->bindInt64(1, count[0]);
+        upsert_stmt->bindInt64(2, count[1]);
+        upsert_stmt->execute();
+        upsert_stmt->reset();
+    }
+    upsert_stmt.reset();
+    
+    auto top_stmt = db.prepare("SELECT chunk_faiss_id, retrievals FROM chunk_retrievals ORDER BY retrievals DESC");
+    TEST_ASSERT(top_stmt->step() && top_stmt->getCurrentRow().getInt(0) == 8 && top_stmt->getCurrentRow().getInt(1) == 5,
+                "Counts for the same chunk should add up");
+    top_stmt.reset();
+    
+    db.execute("DELETE FROM chunks WHERE chunk_faiss_id = 8");
+    auto count_stmt = db.prepare("SELECT chunk_faiss_id FROM chunk_retrievals");
+    TEST_ASSERT(count_stmt->step() && count_stmt->getCurrentRow().getInt(0) == 7 && !count_stmt->step(),
+                "Deleting a chunk should delete its retrieval count");
+    count_stmt.reset();
+    
+    db.close();
+    cleanupTestDatabase("test_chunk_retrievals.db");
+}
+
+void test_ingestion_queue_table() {
+    std::cout << "\n=== Testing Ingestion Queue Table ===" << std::endl;
+    
+    cleanupTestDatabase("test_ingestion_queue.db");
+    TEST_ASSERT(SQLiteDatabase::createdb("test_ingestion_queue.db"), "Setup: Create test database");
+    SQLiteDatabase db;
+    TEST_ASSERT(db.open("test_ingestion_queue.db"), "Setup: Open test database");
+    TEST_ASSERT(db.createIngestionQueueTable() == true, "Creating the table again should be a no-op");
+    
+    // Queuing a file again resets it to pending and keeps its attempt count
+    auto queue_stmt = db.prepare("INSERT INTO ingestion_queue (file_path, collection) VALUES (?, ?) "
+                                 "ON CONFLICT(file_path, collection) DO UPDATE SET status = 'pending', stage = 'queued'");
+    const char* paths[] = {"a.pdf", "b.pdf", "a.pdf"};
+    for (const char* path : paths) {
+        queue_stmt->bindText(1, path);
+        queue_stmt->bindText(2, "");
+        queue_stmt->execute();
+        queue_stmt->reset();
+    }
+    queue_stmt.reset();
+    db.execute("UPDATE ingestion_queue SET status = 'failed', attempts = 1 WHERE file_path = 'b.pdf'");
+    db.execute("INSERT INTO ingestion_queue (file_path, collection) VALUES ('b.pdf', '') "
+               "ON CONFLICT(file_path, collection) DO UPDATE SET status = 'pending', stage = 'queued'");
+    
+    int64_t attempts = -1;
+    std::string status;
+    db.execute("SELECT status, attempts FROM ingestion_queue WHERE file_path = 'b.pdf'", [&](const SQLiteDatabase::Row& row) {
+        status = row.getText(0);
+        attempts = row.getInt64(1);
+        return true;
+    });
+    TEST_ASSERT(status == "pending" && attempts == 1, "Requeued file should be pending with its attempts kept");
+    
+    // A document's row only turns done if its transaction commits
+    {
+        SQLiteTransaction transaction(db);
+        db.execute("UPDATE ingestion_queue SET status = 'done' WHERE file_path = 'a.pdf'");
+    }
+    {
+        SQLiteTransaction transaction(db);
+        db.execute("UPDATE ingestion_queue SET status = 'done' WHERE file_path = 'b.pdf'");
+        transaction.commit();
+    }
+    
+    std::vector<std::string> pending;
+    db.execute("SELECT file_path FROM ingestion_queue WHERE status = 'pending' ORDER BY file_path", [&](const SQLiteDatabase::Row& row) {
+        pending.push_back(row.getText(0));
+        return true;
+    });
+    TEST_ASSERT(pending.size() == 1 && pending[0] == "a.pdf", "Only the rolled back document should still be pending");
+    
+    db.close();
+    cleanupTestDatabase("test_ingestion_queue.db");
+}
+
+void test_embedding_cache_table() {
+    std::cout << "\n=== Testing Embedding Cache Table ===" << std::endl;
+    
+    SQLiteDatabase db;
+    bool opened = db.openMemory();
+    TEST_ASSERT(opened == true, "Setup: Open in-memory database");
+    
+    TEST_ASSERT(db.createEmbeddingCacheTable() == true, "Embedding cache table should be created");
+    TEST_ASSERT(db.createEmbeddingCacheTable() == true, "Creating the table again should be a no-op");
+    
+    auto insert_stmt = db.prepare("INSERT OR REPLACE INTO embedding_cache (cache_key, format, byte_order, dimension, scale, embedding, last_used) "
+                                  "VALUES (?, 1, 0, 2, 0, x'0000803f00000040', ?)");
+    for (int i = 0; i < 3; ++i) {
+        insert_stmt->bindText(1, "key" + std::to_string(i));
+        insert_stmt->bindInt64(2, 100 + i);
+        insert_stmt->execute();
+        insert_stmt->reset();
+    }
+    insert_stmt->bindText(1, "key0");
+    insert_stmt->bindInt64(2, 200);
+    insert_stmt->execute();
+    insert_stmt.reset();
+    
+    auto count_stmt = db.prepare("SELECT COUNT(*) FROM embedding_cache");
+    TEST_ASSERT(count_stmt->step() && count_stmt->getCurrentRow().getInt(0) == 3, "Cache keys should be unique");
+    count_stmt.reset();
+    
+    // Oldest last_used goes first, as the end-of-ingestion trim does it
+    db.execute("DELETE FROM embedding_cache WHERE cache_key IN (SELECT cache_key FROM embedding_cache ORDER BY last_used, rowid LIMIT 1)");
+    auto oldest_stmt = db.prepare("SELECT MIN(last_used) FROM embedding_cache");
+    TEST_ASSERT(oldest_stmt->step() && oldest_stmt->getCurrentRow().getInt(0) == 102, "Least recently used entry should be evicted");
+    oldest_stmt.reset();
+    
+    db.close();
+}
+
+void test_index_model_tables() {
+    std::cout << "\n=== Testing Index Model Tables ===" << std::endl;
+    
+    SQLiteDatabase db;
+    bool opened = db.openMemory();
+    TEST_ASSERT(opened == true, "Setup: Open in-memory database");
+    
+    db.execute("CREATE TABLE chunks (id INTEGER PRIMARY KEY AUTOINCREMENT, doc_id INTEGER NOT NULL, "
+               "chunk_faiss_id INTEGER, chunk_text TEXT NOT NULL)");
+    TEST_ASSERT(db.createIndexModelsTable() == true, "Index models table should be created");
+    TEST_ASSERT(db.createIndexModelsTable() == true, "Creating the table again should be a no-op");
+    
+    // A re-index records the new model under the same definition with the next version
+    db.execute("INSERT INTO index_models (definition, model_id, dimension, updated_at) VALUES ('PrimaryDocEmbeddings', 'coreml:a', 384, 1)");
+    db.execute("INSERT INTO index_models (definition, model_id, dimension, version, updated_at) "
+               "SELECT definition, 'coreml:b', 768, version + 1, 2 FROM index_models WHERE definition = 'PrimaryDocEmbeddings' "
+               "ON CONFLICT(definition) DO UPDATE SET model_id = excluded.model_id, dimension = excluded.dimension, "
+               "version = excluded.version, updated_at = excluded.updated_at");
+    auto model_stmt = db.prepare("SELECT model_id, dimension, version FROM index_models");
+    bool found = model_stmt->step();
+    TEST_ASSERT(found && model_stmt->getCurrentRow().getText(0) == "coreml:b" && model_stmt->getCurrentRow().getInt(1) == 768 &&
+                model_stmt->getCurrentRow().getInt(2) == 2, "Index model should be replaced with the next version");
+    model_stmt.reset();
+    
+    TEST_ASSERT(db.createShadowEmbeddingsTable() == true, "Shadow embeddings table should be created");
+    TEST_ASSERT(db.createShadowEmbeddingsTable() == true, "Creating the table again should be a no-op");
+    db.execute("INSERT INTO chunks (doc_id, chunk_faiss_id, chunk_text) VALUES (1, 1000000, 'a'), (1, 1000001, 'b')");
+    db.execute("INSERT INTO chunk_embeddings_shadow (chunk_faiss_id, format, byte_order, dimension, embedding) "
+               "VALUES (1000000, 1, 0, 2, x'0000803f00000040'), (1000001, 1, 0, 2, x'0000803f00000040')");
+    db.execute("DELETE FROM chunks WHERE chunk_faiss_id = 1000000");
+    auto count_stmt = db.prepare("SELECT COUNT(*) FROM chunk_embeddings_shadow");
+    TEST_ASSERT(count_stmt->step() && count_stmt->getCurrentRow().getInt(0) == 1, "Deleting a chunk should delete its shadow embedding");
+    count_stmt.reset();
+    
+    // Dropped after the swap along with its trigger, so chunks can still be deleted
+    TEST_ASSERT(db.dropShadowEmbeddingsTable() == true, "Shadow embeddings table should be dropped");
+    TEST_ASSERT(db.dropShadowEmbeddingsTable() == true, "Dropping it again should be a no-op");
+    TEST_ASSERT(db.execute("DELETE FROM chunks WHERE chunk_faiss_id = 1000001") == true, "Chunks should be deleted without the shadow table");
+    
+    db.close();
+}
+
+void test_add_column_if_missing() {
+    std::cout << "\n=== Testing Schema Upgrade Helpers ===" << std::endl;
+    
+    SQLiteDatabase db;
+    bool opened = db.openMemory();
+    TEST_ASSERT(opened == true, "Setup: Open in-memory database");
+    
+    db.execute("CREATE TABLE docs (id INTEGER PRIMARY KEY, filename TEXT NOT NULL)");
+    db.execute("INSERT INTO docs (filename) VALUES ('report.pdf')");
+    
+    TEST_ASSERT(db.addColumnIfMissing("docs", "content_hash", "TEXT") == true, "Missing column should be added");
+    TEST_ASSERT(db.addColumnIfMissing("docs", "content_hash", "TEXT") == true, "Existing column should be left alone");
+    
+    auto stmt = db.prepare("SELECT content_hash FROM docs");
+    TEST_ASSERT(stmt->step() && stmt->getCurrentRow().isNull(0), "Existing rows should get NULL in the new column");
+    stmt.reset();
+    
+    db.close();
+}
+
+void test_chunk_id_sequence() {
+    std::cout << "\n=== Testing Chunk Id Sequence ===" << std::endl;
+    
+    SQLiteDatabase db;
+    bool opened = db.openMemory();
+    TEST_ASSERT(opened == true, "Setup: Open in-memory database");
+    
+    // Chunks from before the sequence carry doc_id * 1000000 + i ids
+    db.execute("CREATE TABLE chunks (id INTEGER PRIMARY KEY AUTOINCREMENT, doc_id INTEGER NOT NULL, chunk_faiss_id INTEGER)");
+    db.execute("INSERT INTO chunks (doc_id, chunk_faiss_id) VALUES (2, 2000000), (2, 2000001)");
+    
+    TEST_ASSERT(db.createChunkIdSequence() == true, "Chunk id sequence should be created");
+    TEST_ASSERT(db.createChunkIdSequence() == true, "Creating the sequence again should be a no-op");
+    
+    int64_t first_id = -1;
+    TEST_ASSERT(db.allocateIds("chunk_faiss_id", 3, first_id) && first_id == 2000002, "Sequence should continue after existing ids");
+    TEST_ASSERT(db.allocateIds("chunk_faiss_id", 2, first_id) && first_id == 2000005, "Blocks should be consecutive");
+    
+    {
+        SQLiteTransaction transaction(db);
+        TEST_ASSERT(db.allocateIds("chunk_faiss_id", 4, first_id) && first_id == 2000007, "Allocation should join an open transaction");
+        transaction.rollback();
+    }
+    TEST_ASSERT(db.allocateIds("chunk_faiss_id", 1, first_id) && first_id == 2000007, "Rolled back ids should be handed out again");
+    
+    TEST_ASSERT(db.allocateIds("missing_sequence", 1, first_id) == false, "Unknown sequences should fail");
+    TEST_ASSERT(db.allocateIds("chunk_faiss_id", 0, first_id) == false, "Empty blocks should be rejected");
+    
+    SQLiteDatabase fresh;
+    fresh.openMemory();
+    fresh.execute("CREATE TABLE chunks (id INTEGER PRIMARY KEY AUTOINCREMENT, chunk_faiss_id INTEGER)");
+    fresh.createChunkIdSequence();
+    TEST_ASSERT(fresh.allocateIds("chunk_faiss_id", 1, first_id) && first_id == 0, "An empty database should start at 0");
+    fresh.close();
+    
+    db.close();
+}
+
+void test_sync_log_table() {
+    std::cout << "\n=== Testing Sync Log ===" << std::endl;
+    
+    SQLiteDatabase db;
+    bool opened = db.openMemory();
+    TEST_ASSERT(opened == true, "Setup: Open in-memory database");
+    
+    db.execute("CREATE TABLE docs (id INTEGER PRIMARY KEY AUTOINCREMENT, url TEXT, collection TEXT NOT NULL DEFAULT '')");
+    db.execute("INSERT INTO docs (url) VALUES ('/a.pdf'), ('/b.pdf')");
+    TEST_ASSERT(db.createSyncLogTable() == true, "Sync log should be created");
+    TEST_ASSERT(db.createSyncLogTable() == true, "Creating the log again should be a no-op");
+    
+    auto count_stmt = db.prepare("SELECT COUNT(*), MAX(seq) FROM sync_log WHERE removed = 0");
+    TEST_ASSERT(count_stmt->step() && count_stmt->getCurrentRow().getInt(0) == 2 && count_stmt->getCurrentRow().getInt(1) == 2,
+                "Documents stored before the log should be logged once as added");
+    count_stmt.reset();
+    
+    // Re-ingesting a file removes the old document and adds a new one: both advance the generation
+    db.execute("DELETE FROM docs WHERE url = '/a.pdf'");
+    db.execute("INSERT INTO docs (url, collection) VALUES ('/a.pdf', 'work')");
+    auto since_stmt = db.prepare("SELECT doc_id, url, collection, removed FROM sync_log WHERE seq > 2 ORDER BY seq");
+    TEST_ASSERT(since_stmt->step() && since_stmt->getCurrentRow().getInt(0) == 1 && since_stmt->getCurrentRow().getInt(3) == 1,
+                "A deleted document should be logged as removed");
+    TEST_ASSERT(since_stmt->step() && since_stmt->getCurrentRow().getInt(0) == 3 && since_stmt->getCurrentRow().getText(2) == "work" &&
+                since_stmt->getCurrentRow().getInt(3) == 0, "An inserted document should be logged as added with its collection");
+    TEST_ASSERT(!since_stmt->step(), "Nothing else should be logged");
+    since_stmt.reset();
+    
+    db.close();
+}
+
+void test_vector_functions() {
+    std::cout << "\n=== Testing SQL Vector Functions ===" << std::endl;
+    
+    SQLiteDatabase db;
+    bool opened = db.openMemory();
+    TEST_ASSERT(opened == true, "Setup: Open in-memory database");
+    
+    // 1.0, 2.0 and 3.0, 4.0 as little-endian fp32
+    auto pair_stmt = db.prepare("SELECT vec_dot(x'0000803f00000040', x'0000404000008040'), "
+                                "vec_l2(x'0000803f00000040', x'0000404000008040'), "
+                                "vec_cosine(x'0000803f00000040', x'0000803f00000040')");
+    TEST_ASSERT(pair_stmt && pair_stmt->step(), "Vector functions should be registered");
+    TEST_ASSERT(std::abs(pair_stmt->getCurrentRow().getDouble(0) - 11.0) < 1e-5, "vec_dot should return the inner product");
+    TEST_ASSERT(std::abs(pair_stmt->getCurrentRow().getDouble(1) - 8.0) < 1e-5, "vec_l2 should return the squared distance");
+    TEST_ASSERT(std::abs(pair_stmt->getCurrentRow().getDouble(2) - 1.0) < 1e-5, "vec_cosine of a vector with itself should be 1");
+    pair_stmt.reset();
+    
+    auto mismatch_stmt = db.prepare("SELECT vec_dot(x'0000803f00000040', x'0000803f')");
+    TEST_ASSERT(mismatch_stmt->step() && mismatch_stmt->getCurrentRow().isNull(0), "Mismatched dimensions should give NULL");
+    mismatch_stmt.reset();
+    
+    // Stored form: the codec columns of chunk_embeddings decode the row before scoring
+    db.execute("CREATE TABLE chunk_embeddings (chunk_faiss_id INTEGER PRIMARY KEY, format INTEGER, byte_order INTEGER, "
+               "scale REAL, embedding BLOB)");
+    db.execute("INSERT INTO chunk_embeddings VALUES (1, 1, 0, 1.0, x'0000803f00000000'), (2, 1, 0, 1.0, x'000000000000803f'), "
+               "(3, 1, 0, 1.0, x'0000003f0000003f'), (4, 1, 0, 1.0, x'0000803f')");
+    auto top_stmt = db.prepare("SELECT chunk_faiss_id, vec_dot(embedding, format, byte_order, scale, x'0000803f00000000') AS score "
+                               "FROM chunk_embeddings WHERE score IS NOT NULL ORDER BY score DESC LIMIT 2");
+    TEST_ASSERT(top_stmt->step() && top_stmt->getCurrentRow().getInt64(0) == 1, "The closest stored embedding should rank first");
+    TEST_ASSERT(top_stmt->step() && top_stmt->getCurrentRow().getInt64(0) == 3, "The next closest should rank second");
+    TEST_ASSERT(!top_stmt->step(), "LIMIT should bound the scan's results");
+    top_stmt.reset();
+    
+    db.close();
+}
+
+void test_blob_streaming() {
+    std::cout << "\n=== Testing Incremental BLOB I/O ===" << std::endl;
+    
+    SQLiteDatabase db;
+    bool opened = db.openMemory();
+    TEST_ASSERT(opened == true, "Setup: Open in-memory database");
+    db.execute("CREATE TABLE blobs (id INTEGER PRIMARY KEY, data BLOB NOT NULL)");
+    
+    const size_t size = 3 * 65536 + 17;
+    auto insert_stmt = db.prepare("INSERT INTO blobs (data) VALUES (?)");
+    TEST_ASSERT(insert_stmt->bindZeroBlob(1, size) && insert_stmt->execute(), "A zeroblob should reserve the value");
+    insert_stmt.reset();
+    int64_t rowid = db.getLastInsertRowId();
+    
+    std::vector<uint8_t> pattern(size);
+    for (size_t i = 0; i < size; ++i) {
+        pattern[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    {
+        auto writer = db.openBlob("blobs", "data", rowid, true);
+        TEST_ASSERT(writer && writer->size() == size, "The reserved BLOB should open with its size");
+        bool written = true;
+        for (size_t offset = 0; offset < size; offset += 65536) {
+            written = written && writer->write(pattern.data() + offset, std::min<size_t>(65536, size - offset), offset);
+        }
+        TEST_ASSERT(written, "Pieces should be written in place");
+        TEST_ASSERT(!writer->write(pattern.data(), 2, size - 1), "Writes past the end should fail");
+    }
+    
+    auto reader = db.openBlob("blobs", "data", rowid, false);
+    std::vector<uint8_t> read_back(size);
+    TEST_ASSERT(reader && reader->read(read_back.data(), 17, 0) && reader->read(read_back.data() + 17, size - 17, 17),
+                "Pieces should read back");
+    TEST_ASSERT(read_back == pattern, "Streamed bytes should match what was written");
+    TEST_ASSERT(!reader->write(pattern.data(), 1, 0), "A read-only handle should refuse writes");
+    reader.reset();
+    TEST_ASSERT(db.openBlob("blobs", "data", rowid + 1, false) == nullptr, "A missing row should not open");
+    
+    db.close();
+}
+
+void test_bundle_round_trip() {
+    std::cout << "\n=== Testing Bundle Export / Import ===" << std::endl;
+    
+    const std::string source_path = "test_bundle_source.db";
+    const std::string target_path = "test_bundle_target.db";
+    const std::string bundle_path = FileManager::getAbsolutePath(StorageType::AppStorage, "test_bundle.leafrabundle");
+    cleanupTestDatabase(source_path);
+    cleanupTestDatabase(target_path);
+    std::filesystem::remove(bundle_path);
+    
+    SQLiteDatabase source;
+    TEST_ASSERT(source.open(source_path), "Setup: Open source database");
+    source.execute("CREATE TABLE docs (id INTEGER PRIMARY KEY, filename TEXT NOT NULL)");
+    source.execute("CREATE TABLE chunks (id INTEGER PRIMARY KEY, doc_id INTEGER, chunk_text TEXT, chunk_embedding BLOB)");
+    source.execute("INSERT INTO docs (filename) VALUES ('manual.pdf'), ('faq.md')");
+    source.execute("INSERT INTO chunks (doc_id, chunk_text, chunk_embedding) VALUES (1, 'first', x'0102'), (2, 'second', NULL)");
+    
+    TEST_ASSERT(source.vacuumInto(bundle_path), "VACUUM INTO should write the bundle");
+    TEST_ASSERT(!source.vacuumInto(bundle_path), "VACUUM INTO should not overwrite an existing file");
+    
+    SQLiteDatabase bundle;
+    TEST_ASSERT(bundle.openFile(bundle_path, static_cast<int>(SQLiteDatabase::OpenFlags::ReadWrite)), "Bundle should open by absolute path");
+    BundleManifest manifest;
+    manifest.embedding_model = "tensorflow_lite:model.tflite";
+    manifest.dimension = 384;
+    manifest.chunk_size = 500;
+    manifest.chunk_overlap = 0.15;
+    TEST_ASSERT(RagBundle::write_manifest(bundle, manifest), "Manifest should be written");
+    TEST_ASSERT(manifest.documents == 2 && manifest.chunks == 2, "Manifest should count documents and chunks");
+    
+    BundleManifest loaded;
+    TEST_ASSERT(RagBundle::read_manifest(bundle, loaded), "Manifest should be read back");
+    TEST_ASSERT(loaded.format_version == RagBundle::kFormatVersion && loaded.dimension == 384 &&
+                loaded.embedding_model == manifest.embedding_model && loaded.chunk_overlap == 0.15, "Manifest fields should round-trip");
+    TEST_ASSERT(RagBundle::verify(bundle, loaded), "Untouched bundle should verify");
+    
+    bundle.execute("UPDATE chunks SET chunk_text = 'tampered' WHERE id = 2");
+    TEST_ASSERT(!RagBundle::verify(bundle, loaded), "Modified bundle should fail verification");
+    bundle.execute("UPDATE chunks SET chunk_text = 'second' WHERE id = 2");
+    TEST_ASSERT(RagBundle::verify(bundle, loaded), "Restored contents should verify again");
+    
+    // A delta is marked as one and gets its own format version, so older SDKs refuse it
+    manifest.delta = true;
+    manifest.delta_since = 4;
+    manifest.delta_through = 9;
+    TEST_ASSERT(RagBundle::write_manifest(bundle, manifest), "Delta manifest should be written");
+    TEST_ASSERT(RagBundle::read_manifest(bundle, loaded) && loaded.delta && loaded.delta_since == 4 && loaded.delta_through == 9 &&
+                loaded.format_version == RagBundle::kDeltaFormatVersion, "Delta fields should round-trip");
+    manifest.delta = false;
+    TEST_ASSERT(RagBundle::write_manifest(bundle, manifest), "Manifest should be rewritten");
+    TEST_ASSERT(RagBundle::read_manifest(bundle, loaded) && !loaded.delta && loaded.format_version == RagBundle::kFormatVersion,
+                "A bundle manifest should not read back as a delta");
+    bundle.close();
+    
+    SQLiteDatabase target;
+    TEST_ASSERT(target.open(target_path), "Setup: Open target database");
+    target.execute("CREATE TABLE docs (id INTEGER PRIMARY KEY, filename TEXT NOT NULL)");
+    target.execute("INSERT INTO docs (filename) VALUES ('old.txt')");
+    TEST_ASSERT(target.restoreFrom(bundle_path), "Target should be restored from the bundle");
+    auto stmt = target.prepare("SELECT filename FROM docs ORDER BY id");
+    TEST_ASSERT(stmt && stmt->step() && stmt->getCurrentRow().getText(0) == "manual.pdf", "Restored database should hold the bundle's documents");
+    stmt.reset();
+    TEST_ASSERT(RagBundle::read_manifest(target, loaded) && RagBundle::verify(target, loaded), "Restored database should verify against its manifest");
+    TEST_ASSERT(!target.restoreFrom(bundle_path + ".missing"), "Restoring from a missing file should fail");
+    
+    source.close();
+    target.close();
+    cleanupTestDatabase(source_path);
+    cleanupTestDatabase(target_path);
+    std::filesystem::remove(bundle_path);
+}
+
+void test_online_backup() {
+    std::cout << "\n=== Testing Online Backup ===" << std::endl;
+    
+    const std::string source_path = "test_backup_source.db";
+    const std::string backup_path = FileManager::getAbsolutePath(StorageType::AppStorage, "test_backup_copy.db");
+    cleanupTestDatabase(source_path);
+    std::filesystem::remove(backup_path);
+    
+    SQLiteDatabase source;
+    TEST_ASSERT(source.open(source_path), "Setup: Open source database");
+    source.execute("CREATE TABLE chunks (id INTEGER PRIMARY KEY, chunk_text TEXT)");
+    source.beginTransaction();
+    for (int i = 0; i < 2000; ++i) {
+        source.execute("INSERT INTO chunks (chunk_text) VALUES ('" + std::string(200, 'a' + i % 26) + "')");
+    }
+    source.commitTransaction();
+    
+    // Rows committed between steps through the same connection end up in the copy
+    int steps = 0;
+    bool written = source.backupTo(backup_path, 8, 0, [&source, &steps](int remaining, int total) {
+        if (steps++ == 0) {
+            source.execute("INSERT INTO chunks (chunk_text) VALUES ('added during backup')");
+        }
+        return remaining <= total;
+    });
+    TEST_ASSERT(written, "Incremental backup should complete");
+    TEST_ASSERT(steps > 1, "Backup should take several steps");
+    TEST_ASSERT(!std::filesystem::exists(backup_path + ".tmp"), "Temporary backup file should be renamed away");
+    
+    SQLiteDatabase copy;
+    TEST_ASSERT(copy.openFile(backup_path), "Backup should open read-only");
+    auto stmt = copy.prepare("SELECT COUNT(*), SUM(chunk_text = 'added during backup') FROM chunks");
+    TEST_ASSERT(stmt && stmt->step(), "Backup should be readable");
+    TEST_ASSERT(stmt->getCurrentRow().getInt64(0) == 2001 && stmt->getCurrentRow().getInt64(1) == 1,
+                "Backup should include the row written while it ran");
+    stmt.reset();
+    copy.close();
+    
+    std::filesystem::remove(backup_path);
+    TEST_ASSERT(!source.backupTo(backup_path, 8, 0, [](int, int) { return false; }), "Cancelled backup should fail");
+    TEST_ASSERT(!std::filesystem::exists(backup_path) && !std::filesystem::exists(backup_path + ".tmp"),
+                "Cancelled backup should leave no file behind");
+    
+    source.close();
+    cleanupTestDatabase(source_path);
+}
+
+void test_incremental_vacuum() {
+    std::cout << "\n=== Testing Incremental Vacuum ===" << std::endl;
+    
+    cleanupTestDatabase("test_vacuum.db");
+    TEST_ASSERT(SQLiteDatabase::createdb("test_vacuum.db"), "Setup: Create test database");
+    SQLiteDatabase db;
+    TEST_ASSERT(db.open("test_vacuum.db"), "Setup: Open test database");
+    
+    SQLiteDatabase::SpaceStats stats;
+    TEST_ASSERT(db.getSpaceStats(stats), "Space stats should be readable");
+    TEST_ASSERT(stats.auto_vacuum == 2, "New databases should use auto_vacuum = INCREMENTAL");
+    
+    db.beginTransaction();
+    for (int i = 0; i < 500; ++i) {
+        db.execute("INSERT INTO docs (filename, size) VALUES ('" + std::string(2000, 'x') + "', 1)");
+    }
+    db.commitTransaction();
+    db.execute("DELETE FROM docs");
+    TEST_ASSERT(db.getSpaceStats(stats) && stats.freelist_count > 20, "Deleted rows should leave free pages");
+    const int64_t free_pages = stats.freelist_count;
+    const int64_t pages = stats.page_count;
+    
+    TEST_ASSERT(db.incrementalVacuum(10) == 10, "A slice should release the pages asked for");
+    TEST_ASSERT(db.getSpaceStats(stats) && stats.freelist_count == free_pages - 10 && stats.page_count == pages - 10,
+                "Released pages should leave the file");
+    TEST_ASSERT(db.incrementalVacuum(0) == free_pages - 10, "Vacuum without a limit should release the rest");
+    TEST_ASSERT(db.getSpaceStats(stats) && stats.freelist_count == 0, "Freelist should be empty afterwards");
+    TEST_ASSERT(db.incrementalVacuum(0) == 0, "Nothing left to release");
+    
+    TEST_ASSERT(db.getCacheMemoryUsage() > 0, "Writes should have filled the page cache");
+    TEST_ASSERT(db.releaseCacheMemory() > 0, "Unused cache pages should be released");
+    auto stmt = db.prepare("SELECT COUNT(*) FROM docs");
+    TEST_ASSERT(stmt && stmt->step() && stmt->getCurrentRow().getInt64(0) == 0, "Queries should still work after releasing the cache");
+    stmt.reset();
+    
+    db.close();
+    TEST_ASSERT(db.getCacheMemoryUsage() == 0 && db.releaseCacheMemory() == 0, "Closed connection holds no cache");
+    cleanupTestDatabase("test_vacuum.db");
+}
+
+void test_read_pool() {
+    std::cout << "\n=== Testing Read Connection Pool ===" << std::endl;
+    
+    cleanupTestDatabase("test_read_pool.db");
+    TEST_ASSERT(SQLiteDatabase::createdb("test_read_pool.db"), "Setup: Create test database");
+    SQLiteDatabase writer;
+    TEST_ASSERT(writer.open("test_read_pool.db"), "Setup: Open writer connection");
+    writer.execute("INSERT INTO docs (filename, size) VALUES ('a.pdf', 1)");
+    
+    SQLiteReadPool pool;
+    auto fallback = pool.acquire(&writer);
+    TEST_ASSERT(fallback && !fallback.isPooled() && &*fallback == &writer, "Empty pool should hand out the fallback");
+    fallback = SQLiteReadPool::Lease();
+    
+    TEST_ASSERT(!writer.getPath().empty(), "Writer should report its file");
+    TEST_ASSERT(pool.open(writer.getPath(), writer.getConfig(), 2) && pool.size() == 2, "Pool should open two connections");
+    {
+        auto first = pool.acquire(&writer);
+        auto second = pool.acquire(&writer);
+        TEST_ASSERT(first.isPooled() && second.isPooled() && &*first != &*second, "Leases should get distinct connections");
+        
+        // WAL readers see the last commit while the writer's transaction is open
+        writer.beginTransaction();
+        writer.execute("INSERT INTO docs (filename, size) VALUES ('b.pdf', 1)");
+        int64_t count = -1;
+        auto stmt = first->prepareCached("SELECT COUNT(*) FROM docs");
+        TEST_ASSERT(stmt.isValid() && stmt->step(), "Reader should query during a write transaction");
+        count = stmt->getCurrentRow().getInt64(0);
+        TEST_ASSERT(count == 1, "Reader should not see uncommitted rows");
+        writer.commitTransaction();
+        
+        TEST_ASSERT(!second->execute("DELETE FROM docs"), "Pooled connections should be read-only");
+    }
+    {
+        auto again = pool.acquire(&writer);
+        auto stmt = again->prepareCached("SELECT COUNT(*) FROM docs");
+        TEST_ASSERT(stmt.isValid() && stmt->step() && stmt->getCurrentRow().getInt64(0) == 2, "Returned connections should see new commits");
+    }
+    
+    pool.close();
+    TEST_ASSERT(pool.size() == 0 && !pool.acquire(&writer).isPooled(), "Closed pool should fall back to the writer");
+    writer.close();
+    cleanupTestDatabase("test_read_pool.db");
+}
+
+void test_nested_transactions() {
+    std::cout << "\n=== Testing Nested Transactions ===" << std::endl;
+    
+    cleanupTestDatabase("test_nested.db");
+    TEST_ASSERT(SQLiteDatabase::createdb("test_nested.db"), "Setup: Create test database");
+    SQLiteDatabase db;
+    TEST_ASSERT(db.open("test_nested.db"), "Setup: Open test database");
+    db.execute("CREATE TABLE nested_test (value INTEGER)");
+    
+    {
+        SQLiteTransaction outer(db);
+        db.execute("INSERT INTO nested_test VALUES (1)");
+        {
+            SQLiteTransaction kept(db);
+            TEST_ASSERT(kept.isActive(), "Nested transaction should open a savepoint");
+            db.execute("INSERT INTO nested_test VALUES (2)");
+            TEST_ASSERT(kept.commit(), "Releasing the savepoint should succeed");
+            TEST_ASSERT(db.isInTransaction(), "Outer transaction should stay open");
+        }
+        {
+            SQLiteTransaction dropped(db);
+            db.execute("INSERT INTO nested_test VALUES (3)");
+            dropped.rollback();
+            TEST_ASSERT(db.isInTransaction(), "Rolling back a savepoint should keep the outer transaction");
+        }
+        TEST_ASSERT(outer.commit(), "Outer commit should succeed");
+    }
+    
+    int64_t total = 0;
+    db.execute("SELECT SUM(value) FROM nested_test", [&total](const SQLiteDatabase::Row& row) {
+        total = row.getInt64(0);
+        return true;
+    });
+    TEST_ASSERT(total == 3, "Only the rolled back savepoint's row should be missing");
+    
+    db.close();
+    cleanupTestDatabase("test_nested.db");
+}
+
+void test_group_commit_writer() {
+    std::cout << "\n=== Testing Group Commit Writer ===" << std::endl;
+    
+    cleanupTestDatabase("test_writer.db");
+    TEST_ASSERT(SQLiteDatabase::createdb("test_writer.db"), "Setup: Create test database");
+    SQLiteDatabase db;
+    TEST_ASSERT(db.open("test_writer.db"), "Setup: Open test database");
+    db.execute("CREATE TABLE writer_test (value INTEGER)");
+    
+    std::vector<std::future<bool>> durable;
+    std::atomic<int> callbacks{0};
+    {
+        SQLiteWriter writer(db, 4, 10000, 2);
+        for (int i = 0; i < 10; ++i) {
+            durable.push_back(writer.submit([i](SQLiteDatabase& connection) {
+                connection.execute("INSERT INTO writer_test VALUES (" + std::to_string(i) + ")");
+                return i != 5;   // Job 5 fails and rolls back only its own row
+            }, [&callbacks](bool) { callbacks++; }));
+        }
+        writer.flush();
+        TEST_ASSERT(writer.job_count() == 10, "Flush should wait for every job");
+        TEST_ASSERT(writer.commit_count() == 3, "Ten jobs in groups of four should take three commits");
+        
+        // The connection stays usable from other threads under the writer's connection lock
+        std::lock_guard<std::mutex> connection(writer.connection_mutex());
+        TEST_ASSERT(!db.isInTransaction(), "No transaction should be left open after a flush");
+    }
+    
+    int durable_count = 0;
+    for (size_t i = 0; i < durable.size(); ++i) {
+        const bool committed = durable[i].get();
+        TEST_ASSERT(committed == (i != 5), "Only the failed job should report not durable");
+        durable_count += committed ? 1 : 0;
+    }
+    TEST_ASSERT(durable_count == 9 && callbacks == 10, "Every job's callback should run");
+    
+    int64_t rows = 0;
+    db.execute("SELECT COUNT(*) FROM writer_test WHERE value != 5", [&rows](const SQLiteDatabase::Row& row) {
+        rows = row.getInt64(0);
+        return true;
+    });
+    int64_t failed_rows = -1;
+    db.execute("SELECT COUNT(*) FROM writer_test WHERE value = 5", [&failed_rows](const SQLiteDatabase::Row& row) {
+        failed_rows = row.getInt64(0);
+        return true;
+    });
+    TEST_ASSERT(rows == 9 && failed_rows == 0, "Successful jobs' rows should be committed, the failed one rolled back");
+    
+    db.close();
+    cleanupTestDatabase("test_writer.db");
+}
+
 int main() {
     std::cout << "🧪 LeafraSDK SQLite Unit Tests - Advanced Operations" << std::endl;
     std::cout << "====================================================" << std::endl;
@@ -349,6 +1501,30 @@ int main() {
     test_error_handling();
     test_data_types();
     test_column_access();
+    test_bulk_insert();
+    test_zero_copy_rows();
+    test_statement_cache();
+    test_chunk_keyword_index();
+    test_compressed_chunk_text();
+    test_offset_chunk_text();
+    test_chunk_embeddings_table();
+    test_doc_centroids_table();
+    test_chunk_llm_tokens_table();
+    test_chunk_retrievals_table();
+    test_ingestion_queue_table();
+    test_embedding_cache_table();
+    test_index_model_tables();
+    test_add_column_if_missing();
+    test_chunk_id_sequence();
+    test_sync_log_table();
+    test_vector_functions();
+    test_blob_streaming();
+    test_bundle_round_trip();
+    test_online_backup();
+    test_incremental_vacuum();
+    test_read_pool();
+    test_nested_transactions();
+    test_group_commit_writer();
     
     // Print results
     std::cout << "\n📊 Test Results:" << std::endl;
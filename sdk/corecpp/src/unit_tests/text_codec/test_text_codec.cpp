@@ -0,0 +1,170 @@
+#include "../../../include/leafra/leafra_text_codec.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+static std::string sample_prose() {
+    std::string text;
+    const char* sentences[] = {
+        "The retrieval pipeline splits each document into overlapping chunks. ",
+        "Every chunk is embedded and stored together with its page number. ",
+        "Searches combine the vector index with the keyword index over the chunk text. ",
+        "Überschriften und Absätze bleiben erhalten, auch mit Umlauten. "
+    };
+    for (int i = 0; i < 40; ++i) {
+        text += sentences[(i * 7) % 4];
+        text += std::to_string(i);
+        text += ' ';
+    }
+    return text;
+}
+
+bool test_parse_compression() {
+    TextCompression compression = TextCompression::NONE;
+    TEST_ASSERT(TextCodec::parse_compression("lz4", compression), "lz4 should parse");
+    TEST_ASSERT(compression == TextCompression::LZ4, "lz4 should map to LZ4");
+    TEST_ASSERT(TextCodec::parse_compression("none", compression), "none should parse");
+    TEST_ASSERT(compression == TextCompression::NONE, "none should map to NONE");
+    TEST_ASSERT(!TextCodec::parse_compression("zstd", compression), "Unknown codecs should be rejected");
+    return true;
+}
+
+bool test_round_trip() {
+    const std::string text = sample_prose();
+    std::vector<uint8_t> blob;
+    TEST_ASSERT(TextCodec::compress(text, TextCompression::LZ4, blob), "Repetitive prose should compress");
+    TEST_ASSERT(blob.size() < text.size() / 2, "Repetitive prose should at least halve");
+
+    std::string restored;
+    TEST_ASSERT(TextCodec::decompress(blob.data(), blob.size(), restored), "Compressed text should decompress");
+    TEST_ASSERT_EQUAL(text, restored, "Round trip should be lossless");
+
+    // Long runs exercise overlapping matches and the extended length bytes
+    std::string runs(5000, 'a');
+    runs += std::string(300, 'b') + "tail of the run";
+    TEST_ASSERT(TextCodec::compress(runs, TextCompression::LZ4, blob), "Runs should compress");
+    TEST_ASSERT(TextCodec::decompress(blob.data(), blob.size(), restored), "Runs should decompress");
+    TEST_ASSERT_EQUAL(runs, restored, "Runs should round trip");
+    return true;
+}
+
+bool test_incompressible_text_is_left_alone() {
+    std::vector<uint8_t> blob;
+    TEST_ASSERT(!TextCodec::compress("short chunk", TextCompression::LZ4, blob), "Short text shouldn't be compressed");
+    TEST_ASSERT(blob.empty(), "Nothing should be written for text left alone");
+    TEST_ASSERT(!TextCodec::compress(sample_prose(), TextCompression::NONE, blob), "NONE never compresses");
+
+    std::string noise;
+    uint32_t state = 12345;
+    for (int i = 0; i < 2000; ++i) {
+        state = state * 1103515245u + 12345u;
+        noise += static_cast<char>(33 + (state >> 16) % 90);
+    }
+    TEST_ASSERT(!TextCodec::compress(noise, TextCompression::LZ4, blob), "Random text shouldn't grow into a blob");
+    return true;
+}
+
+bool test_corrupt_input_is_rejected() {
+    const std::string text = sample_prose();
+    std::vector<uint8_t> blob;
+    TextCodec::compress(text, TextCompression::LZ4, blob);
+    std::string restored;
+
+    std::vector<uint8_t> truncated(blob.begin(), blob.begin() + blob.size() / 2);
+    TEST_ASSERT(!TextCodec::decompress(truncated.data(), truncated.size(), restored), "Truncated blobs should be rejected");
+
+    std::vector<uint8_t> unknown = blob;
+    unknown[0] = 0x7f;
+    TEST_ASSERT(!TextCodec::decompress(unknown.data(), unknown.size(), restored), "Unknown codec tags should be rejected");
+
+    // A size far beyond what the payload can expand to is refused before allocating
+    const uint8_t huge[] = {1, 0xff, 0xff, 0xff, 0xff, 0x0f, 0x10, 'x'};
+    TEST_ASSERT(!TextCodec::decompress(huge, sizeof(huge), restored), "Oversized lengths should be rejected");
+
+    // Flipping payload bytes must never read or write out of bounds
+    for (size_t i = 2; i < blob.size(); i += 3) {
+        std::vector<uint8_t> flipped = blob;
+        flipped[i] ^= 0x5a;
+        TextCodec::decompress(flipped.data(), flipped.size(), restored);
+    }
+    return true;
+}
+
+bool test_token_round_trip() {
+    const std::vector<int32_t> tokens = {0, 1, 127, 128, 16383, 16384, 151935, 2147483647};
+    std::vector<uint8_t> blob;
+    TextCodec::encode_tokens(tokens, blob);
+    TEST_ASSERT_EQUAL(size_t(1 + 1 + 1 + 2 + 2 + 3 + 3 + 5), blob.size(), "Ids should take one byte per 7 bits");
+
+    std::vector<int32_t> restored;
+    TEST_ASSERT(TextCodec::decode_tokens(blob.data(), blob.size(), restored), "Encoded tokens should decode");
+    TEST_ASSERT(restored == tokens, "Token round trip should be lossless");
+
+    TEST_ASSERT(TextCodec::decode_tokens(blob.data(), 0, restored) && restored.empty(), "An empty value holds no tokens");
+    blob.pop_back();
+    TEST_ASSERT(!TextCodec::decode_tokens(blob.data(), blob.size(), restored), "Truncated values should be rejected");
+    const uint8_t too_large[] = {0xff, 0xff, 0xff, 0xff, 0x0f};
+    TEST_ASSERT(!TextCodec::decode_tokens(too_large, sizeof(too_large), restored), "Ids beyond int32_t should be rejected");
+    return true;
+}
+
+int main() {
+    std::cout << "=== TextCodec Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_parse_compression);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_incompressible_text_is_left_alone);
+    RUN_TEST(test_corrupt_input_is_rejected);
+    RUN_TEST(test_token_round_trip);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
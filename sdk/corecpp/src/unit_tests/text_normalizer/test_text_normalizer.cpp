@@ -0,0 +1,184 @@
+#include "../../../include/leafra/leafra_text_normalizer.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+
+static std::string normalized(std::string text, const TextNormalizationOptions& options = TextNormalizationOptions()) {
+    normalize_text(text, options);
+    return text;
+}
+
+static TextNormalizationOptions only_nfkc() {
+    TextNormalizationOptions options;
+    options.collapse_whitespace = false;
+    options.dehyphenate = false;
+    options.strip_control = false;
+    return options;
+}
+
+bool test_whitespace_collapsing() {
+    TEST_ASSERT_EQUAL(std::string("a b c"), normalized("a   b\t\tc"), "Runs of spaces and tabs collapse");
+    TEST_ASSERT_EQUAL(std::string("line one\nline two"), normalized("  line one   \n   line two  "), "Spaces around line breaks go");
+    TEST_ASSERT_EQUAL(std::string("para one\n\npara two"), normalized("\n\npara one\n\n\n\n\npara two\n\n"),
+                      "At most one blank line, none at the ends");
+    TEST_ASSERT_EQUAL(std::string("no break space"), normalized("no\xC2\xA0" "break space"), "NBSP is a space");
+    TEST_ASSERT_EQUAL(std::string(""), normalized(" \t\n \n"), "Whitespace-only page becomes empty");
+
+    // Long plain runs go through the SIMD fast path; the result must not depend on where blocks split
+    std::string sentence = "The quick brown fox jumps over the lazy dog. ";
+    std::string long_text;
+    std::string expected;
+    for (int i = 0; i < 40; ++i) {
+        long_text += sentence + (i % 7 == 0 ? "   \n" : "");
+        expected += sentence;
+        if (i % 7 == 0) {
+            expected.back() = '\n';
+        }
+    }
+    while (!expected.empty() && (expected.back() == ' ' || expected.back() == '\n')) {
+        expected.pop_back();
+    }
+    TEST_ASSERT_EQUAL(expected, normalized(long_text), "Long text collapses like short text");
+
+    TextNormalizationOptions off;
+    off.collapse_whitespace = false;
+    TEST_ASSERT_EQUAL(std::string("a   b \n"), normalized("a   b \n", off), "Whitespace kept when collapsing is off");
+    return true;
+}
+
+bool test_dehyphenation() {
+    TEST_ASSERT_EQUAL(std::string("an example of it"), normalized("an exam-\nple of it"), "Hyphen at a line break joins the word");
+    TEST_ASSERT_EQUAL(std::string("an example"), normalized("an exam-  \r\n   ple"), "Spaces and CRLF around the break are skipped");
+    TEST_ASSERT_EQUAL(std::string("information"), normalized("infor\xC2\xAD\nmation"), "Soft hyphen at a line break joins");
+    TEST_ASSERT_EQUAL(std::string("information"), normalized("infor\xC2\xADmation"), "Soft hyphen inside a line is dropped");
+    TEST_ASSERT_EQUAL(std::string("Jean-\nPaul"), normalized("Jean-\nPaul"), "Uppercase continuation is not joined");
+    TEST_ASSERT_EQUAL(std::string("well-known"), normalized("well-known"), "Hyphen inside a line is kept");
+    TEST_ASSERT_EQUAL(std::string("list\n-\nitem"), normalized("list\n-\nitem"), "Hyphen not after a letter is kept");
+    TEST_ASSERT_EQUAL(std::string("a -\nb"), normalized("a -\nb"), "Spaced dash is not a hyphenation");
+
+    TextNormalizationOptions off;
+    off.dehyphenate = false;
+    TEST_ASSERT_EQUAL(std::string("exam-\nple"), normalized("exam-\nple", off), "Hyphenation kept when dehyphenation is off");
+    return true;
+}
+
+bool test_control_stripping() {
+    TEST_ASSERT_EQUAL(std::string("a\nb\nc\nd"), normalized("a\r\nb\rc\fd"), "CR, CRLF and FF become line breaks");
+    TEST_ASSERT_EQUAL(std::string("abc"), normalized("a\x01\x7f" "b\x1b" "c"), "C0 controls and DEL are dropped");
+    TEST_ASSERT_EQUAL(std::string("text"), normalized("\xEF\xBB\xBFte\xE2\x80\x8Bxt"), "BOM and zero-width space are dropped");
+    TEST_ASSERT_EQUAL(std::string("ab"), normalized("a\xC2\x85" "b"), "C1 controls are dropped");
+    TEST_ASSERT_EQUAL(std::string("one\ntwo"), normalized("one\xE2\x80\xA8two"), "Line separator becomes a line break");
+    TEST_ASSERT_EQUAL(std::string("caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC"), normalized("caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC"),
+                      "Other non-ASCII text is copied unchanged");
+
+    TextNormalizationOptions off;
+    off.strip_control = false;
+    off.collapse_whitespace = false;
+    TEST_ASSERT_EQUAL(std::string("a\x01" "b\r\n"), normalized("a\x01" "b\r\n", off), "Controls kept when stripping is off");
+    return true;
+}
+
+bool test_nfkc() {
+    if (!text_normalization_has_nfkc()) {
+        std::cout << "(ICU not available, skipped) ";
+        return true;
+    }
+    TEST_ASSERT_EQUAL(std::string("file office"), normalized("\xEF\xAC\x81le o\xEF\xAC\x83" "ce", only_nfkc()), "Ligatures are expanded");
+    TEST_ASSERT_EQUAL(std::string("ABC 123"), normalized("\xEF\xBC\xA1\xEF\xBC\xA2\xEF\xBC\xA3 \xEF\xBC\x91\xEF\xBC\x92\xEF\xBC\x93", only_nfkc()),
+                      "Full-width forms become ASCII");
+    TEST_ASSERT_EQUAL(std::string("caf\xC3\xA9!"), normalized("cafe\xCC\x81!", only_nfkc()), "Combining mark composes with the ASCII letter before it");
+    TEST_ASSERT_EQUAL(std::string("caf\xC3\xA9"), normalized("caf\xC3\xA9", only_nfkc()), "Normalized text is untouched");
+    TEST_ASSERT_EQUAL(std::string("x y"), normalized("x\xC2\xA0\xC2\xA0y"), "NFKC spaces are collapsed afterwards");
+    return true;
+}
+
+// The SIMD scan must agree with a byte loop wherever the run ends
+bool test_plain_run_matches_scalar() {
+    std::mt19937 rng(42);
+    const char alphabet[] = {'a', 'b', ' ', '-', '\n', '\t', '\x7f', '\xC3', 'Z', '.'};
+    for (int round = 0; round < 2000; ++round) {
+        size_t length = rng() % 100;
+        std::string text(length, 'x');
+        for (size_t i = 0; i < length; ++i) {
+            text[i] = (rng() % 8 == 0) ? alphabet[rng() % sizeof(alphabet)] : static_cast<char>('a' + rng() % 26);
+        }
+        for (int flags = 0; flags < 4; ++flags) {
+            bool spaces = (flags & 1) != 0;
+            bool hyphens = (flags & 2) != 0;
+            size_t expected = 0;
+            while (expected < length) {
+                unsigned char c = static_cast<unsigned char>(text[expected]);
+                if (c < 0x20 || c > 0x7e || (hyphens && c == '-') ||
+                    (spaces && c == ' ' && expected + 1 < length && text[expected + 1] == ' ')) {
+                    break;
+                }
+                ++expected;
+            }
+            TEST_ASSERT_EQUAL(expected, plain_ascii_run_length(text.data(), length, spaces, hyphens), "Run length matches byte loop");
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "=== Text Normalizer Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_whitespace_collapsing);
+    RUN_TEST(test_dehyphenation);
+    RUN_TEST(test_control_stripping);
+    RUN_TEST(test_nfkc);
+    RUN_TEST(test_plain_run_matches_scalar);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,163 @@
+#include "../../../include/leafra/leafra_threadpool.h"
+#include "../../../include/leafra/platform_utils.h"
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+static CpuTopology make_topology(int32_t logical, int32_t performance, int32_t efficiency) {
+    CpuTopology topology;
+    topology.logical_cores = logical;
+    topology.performance_cores = performance;
+    topology.efficiency_cores = efficiency;
+    return topology;
+}
+
+bool test_heterogeneous_budget() {
+    // A phone with 2 performance and 4 efficiency cores
+    ThreadBudget::Settings settings;
+    ThreadBudget budget = ThreadBudget::resolve(make_topology(6, 2, 4), settings);
+    TEST_ASSERT_EQUAL(2, budget.llm_threads, "LLM stays on the performance cores");
+    TEST_ASSERT_EQUAL(2, budget.llm_batch_threads, "Prompt processing follows the LLM threads");
+    TEST_ASSERT_EQUAL(2, budget.embedding_threads, "TFLite stays on the performance cores");
+    TEST_ASSERT_EQUAL(2, budget.faiss_threads, "FAISS stays on the performance cores");
+    TEST_ASSERT_EQUAL(size_t(1), budget.query_workers, "Query pool: performance cores minus the caller");
+    TEST_ASSERT_EQUAL(size_t(4), budget.ingest_workers, "Ingestion pool keeps max_threads");
+    return true;
+}
+
+bool test_homogeneous_budget() {
+    ThreadBudget::Settings settings;
+    settings.max_threads = 0;
+    ThreadBudget budget = ThreadBudget::resolve(make_topology(8, 8, 0), settings);
+    TEST_ASSERT_EQUAL(8, budget.llm_threads, "Every core is a performance core");
+    TEST_ASSERT_EQUAL(4, budget.embedding_threads, "TFLite capped at 4 threads");
+    TEST_ASSERT_EQUAL(size_t(7), budget.query_workers, "Query pool");
+    TEST_ASSERT_EQUAL(size_t(8), budget.ingest_workers, "max_threads <= 0 uses every core");
+
+    ThreadBudget single = ThreadBudget::resolve(make_topology(1, 1, 0), settings);
+    TEST_ASSERT_EQUAL(size_t(1), single.query_workers, "At least one query worker");
+    TEST_ASSERT_EQUAL(1, single.llm_threads, "At least one LLM thread");
+    return true;
+}
+
+bool test_configured_counts_win() {
+    ThreadBudget::Settings settings;
+    settings.max_threads = 64;
+    settings.query_threads = 3;
+    settings.llm_threads = 3;
+    settings.llm_batch_threads = 6;
+    settings.embedding_threads = 1;
+    settings.faiss_threads = 16;
+    ThreadBudget budget = ThreadBudget::resolve(make_topology(8, 4, 4), settings);
+    TEST_ASSERT_EQUAL(3, budget.llm_threads, "Configured n_threads");
+    TEST_ASSERT_EQUAL(6, budget.llm_batch_threads, "Configured n_threads_batch");
+    TEST_ASSERT_EQUAL(1, budget.embedding_threads, "Configured tflite_num_threads");
+    TEST_ASSERT_EQUAL(8, budget.faiss_threads, "faiss_threads clamped to the hardware");
+    TEST_ASSERT_EQUAL(size_t(3), budget.query_workers, "Configured query_threads");
+    TEST_ASSERT_EQUAL(size_t(8), budget.ingest_workers, "max_threads clamped to the hardware");
+    return true;
+}
+
+bool test_detected_topology() {
+    CpuTopology topology = PlatformUtils::get_cpu_topology();
+    TEST_ASSERT_EQUAL(PlatformUtils::get_cpu_cores(), topology.logical_cores, "Logical cores");
+    TEST_ASSERT(topology.performance_cores >= 1, "At least one performance core");
+    TEST_ASSERT(topology.efficiency_cores >= 0, "Efficiency cores");
+    TEST_ASSERT_EQUAL(topology.logical_cores, topology.performance_cores + topology.efficiency_cores, "Cores add up");
+    return true;
+}
+
+bool test_pool_applies_qos() {
+    std::mutex mutex;
+    std::vector<int> priorities;
+    std::atomic<int> ran{0};
+    {
+        ThreadPool pool(2, ThreadQoS::UTILITY, "TestUtility");
+        TEST_ASSERT_EQUAL(size_t(2), pool.size(), "Pool size");
+        for (int i = 0; i < 8; ++i) {
+            pool.submit([&] {
+#if defined(__linux__) && !defined(__ANDROID__)
+                int priority = getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)));
+                std::lock_guard<std::mutex> lock(mutex);
+                priorities.push_back(priority);
+#endif
+                ran++;
+            });
+        }
+        pool.wait_idle();
+    }
+    TEST_ASSERT_EQUAL(8, ran.load(), "Every task ran");
+    for (int priority : priorities) {
+        TEST_ASSERT_EQUAL(10, priority, "Utility workers run at nice 10");
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "=== Thread Budget Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_heterogeneous_budget);
+    RUN_TEST(test_homogeneous_budget);
+    RUN_TEST(test_configured_counts_win);
+    RUN_TEST(test_detected_topology);
+    RUN_TEST(test_pool_applies_qos);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,172 @@
+#include "../../../include/leafra/leafra_token_stream.h"
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+struct Recorder {
+    std::mutex mutex;
+    std::vector<std::string> pieces;
+    std::string text;
+    int finals = 0;
+    std::thread::id thread;
+    bool stop_after_first = false;
+
+    token_callback_t callback() {
+        return [this](const std::string& token, bool is_final) {
+            std::lock_guard<std::mutex> lock(mutex);
+            thread = std::this_thread::get_id();
+            if (is_final) {
+                finals++;
+                return true;
+            }
+            pieces.push_back(token);
+            text += token;
+            return !stop_after_first;
+        };
+    }
+};
+
+bool test_complete_utf8_prefix() {
+    TEST_ASSERT_EQUAL(size_t(5), TokenStream::complete_utf8_prefix("hello"), "ASCII is always complete");
+    TEST_ASSERT_EQUAL(size_t(2), TokenStream::complete_utf8_prefix("ab\xC3"), "A lone 2-byte lead is held back");
+    TEST_ASSERT_EQUAL(size_t(4), TokenStream::complete_utf8_prefix("ab\xC3\xBC"), "A finished 2-byte character is complete");
+    TEST_ASSERT_EQUAL(size_t(1), TokenStream::complete_utf8_prefix("a\xF0\x9F\x98"), "A 4-byte character missing its last byte is held back");
+    TEST_ASSERT_EQUAL(size_t(5), TokenStream::complete_utf8_prefix("a\xF0\x9F\x98\x80"), "A finished emoji is complete");
+    TEST_ASSERT_EQUAL(size_t(0), TokenStream::complete_utf8_prefix(""), "Empty text");
+    return true;
+}
+
+bool test_inline_delivery_joins_split_characters() {
+    Recorder recorder;
+    {
+        TokenStream stream(recorder.callback(), 0, 16);
+        TEST_ASSERT(stream.push("Gr"), "push should succeed");
+        TEST_ASSERT(stream.push("\xC3"), "push should succeed");
+        TEST_ASSERT(stream.push("\xBC\xC3\x9F"), "push should succeed");
+        TEST_ASSERT(stream.push("e"), "push should succeed");
+    }
+    TEST_ASSERT_EQUAL(std::string("Gr\xC3\xBC\xC3\x9F" "e"), recorder.text, "Text should be delivered whole");
+    TEST_ASSERT_EQUAL(size_t(3), recorder.pieces.size(), "The push ending mid-character delivers nothing");
+    TEST_ASSERT_EQUAL(std::this_thread::get_id(), recorder.thread, "Inline delivery runs on the caller's thread");
+    TEST_ASSERT_EQUAL(1, recorder.finals, "Final is delivered once");
+    return true;
+}
+
+bool test_coalesced_delivery() {
+    Recorder recorder;
+    TokenStream stream(recorder.callback(), 50, 4);
+    for (int i = 0; i < 8; ++i) {
+        TEST_ASSERT(stream.push("t"), "push should succeed");
+    }
+    stream.push("\xE2\x82");                // First two bytes of the euro sign
+    stream.push("\xAC!");
+    stream.close();
+    stream.close();
+
+    TEST_ASSERT_EQUAL(std::string("tttttttt\xE2\x82\xAC!"), recorder.text, "Everything pushed is delivered in order");
+    TEST_ASSERT(recorder.pieces.size() < 10, "Pieces should be coalesced");
+    TEST_ASSERT(recorder.thread != std::this_thread::get_id(), "Coalesced delivery runs on its own thread");
+    TEST_ASSERT_EQUAL(1, recorder.finals, "Final is delivered once, however often close is called");
+    for (const std::string& piece : recorder.pieces) {
+        TEST_ASSERT_EQUAL(piece.size(), TokenStream::complete_utf8_prefix(piece), "No piece ends mid-character");
+    }
+    return true;
+}
+
+bool test_unfinished_character_is_replaced() {
+    Recorder recorder;
+    {
+        TokenStream stream(recorder.callback(), 5, 16);
+        stream.push("ok\xF0\x9F");
+    }
+    TEST_ASSERT_EQUAL(std::string("ok\xEF\xBF\xBD"), recorder.text, "A truncated character becomes U+FFFD");
+    TEST_ASSERT_EQUAL(1, recorder.finals, "Final is delivered once");
+    return true;
+}
+
+bool test_consumer_stop() {
+    Recorder recorder;
+    recorder.stop_after_first = true;
+    TokenStream stream(recorder.callback(), 1, 1);
+    stream.push("first");
+    bool stopped = false;
+    for (int i = 0; i < 200 && !stopped; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        stopped = !stream.push("more");
+    }
+    TEST_ASSERT(stopped, "push should report the consumer's stop");
+    TEST_ASSERT(stream.stopped(), "stopped() should report the consumer's stop");
+    stream.close();
+    TEST_ASSERT_EQUAL(size_t(1), recorder.pieces.size(), "Nothing is delivered after the consumer stops");
+    TEST_ASSERT_EQUAL(1, recorder.finals, "Final is still delivered");
+
+    Recorder inline_recorder;
+    inline_recorder.stop_after_first = true;
+    TokenStream inline_stream(inline_recorder.callback(), 0, 0);
+    TEST_ASSERT(!inline_stream.push("first"), "Inline push reports the stop immediately");
+    return true;
+}
+
+int main() {
+    std::cout << "=== TokenStream Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_complete_utf8_prefix);
+    RUN_TEST(test_inline_delivery_joins_split_characters);
+    RUN_TEST(test_coalesced_delivery);
+    RUN_TEST(test_unfinished_character_is_replaced);
+    RUN_TEST(test_consumer_stop);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,463 @@
+#include "../../../include/leafra/leafra_unigram.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef LEAFRA_HAS_SENTENCEPIECE
+#include <sentencepiece_processor.h>
+#endif
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+// ==============================================================================
+// Serialized ModelProto builder
+// ==============================================================================
+
+enum PieceType { NORMAL = 1, UNKNOWN = 2, CONTROL = 3, USER_DEFINED = 4, UNUSED = 5, BYTE = 6 };
+
+static void put_varint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+static void put_bytes(std::string& out, uint32_t field, const std::string& bytes) {
+    put_varint(out, (field << 3) | 2);
+    put_varint(out, bytes.size());
+    out += bytes;
+}
+
+static void put_bool(std::string& out, uint32_t field, bool value) {
+    put_varint(out, field << 3);
+    put_varint(out, value ? 1 : 0);
+}
+
+struct ModelBuilder {
+    std::string pieces;
+    std::string trainer;
+    std::string normalizer;
+
+    ModelBuilder& piece(const std::string& text, float score, PieceType type = NORMAL) {
+        std::string message;
+        put_bytes(message, 1, text);
+        put_varint(message, (2 << 3) | 5);
+        uint32_t bits;
+        std::memcpy(&bits, &score, sizeof(bits));
+        for (int i = 0; i < 4; ++i) {
+            message.push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+        }
+        if (type != NORMAL) {
+            put_varint(message, 3 << 3);
+            put_varint(message, type);
+        }
+        put_bytes(pieces, 1, message);
+        return *this;
+    }
+
+    std::string build() const {
+        std::string model = pieces;
+        if (!trainer.empty()) {
+            put_bytes(model, 2, trainer);
+        }
+        if (!normalizer.empty()) {
+            put_bytes(model, 3, normalizer);
+        }
+        return model;
+    }
+};
+
+// <unk> 0, <s> 1, </s> 2, then a small English vocabulary
+static ModelBuilder base_model() {
+    ModelBuilder builder;
+    builder.piece("<unk>", 0.0f, UNKNOWN).piece("<s>", 0.0f, CONTROL).piece("</s>", 0.0f, CONTROL)
+        .piece("\xe2\x96\x81", -2.0f)               // 3  ▁
+        .piece("\xe2\x96\x81he", -3.0f)             // 4  ▁he
+        .piece("llo", -2.5f)                        // 5
+        .piece("\xe2\x96\x81hello", -4.0f)          // 6  ▁hello
+        .piece("h", -5.0f)                          // 7
+        .piece("e", -5.0f)                          // 8
+        .piece("l", -5.0f)                          // 9
+        .piece("o", -5.0f)                          // 10
+        .piece("\xe2\x96\x81world", -4.5f)          // 11 ▁world
+        .piece("w", -5.0f)                          // 12
+        .piece("r", -5.0f)                          // 13
+        .piece("d", -5.0f)                          // 14
+        .piece("\xe2\x96\x81hell", -3.5f)           // 15 ▁hell
+        .piece("\xe2\x96\x81wor", -4.0f, UNUSED)    // 16 (never selected)
+        .piece("A", -5.0f);                         // 17
+    return builder;
+}
+
+static std::vector<int> encode(const UnigramTokenizer& tokenizer, const std::string& text) {
+    std::vector<int> ids;
+    tokenizer.encode(text, ids);
+    return ids;
+}
+
+static std::string join(const std::vector<int>& ids) {
+    std::ostringstream out;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        out << (i ? " " : "") << ids[i];
+    }
+    return out.str();
+}
+
+// ==============================================================================
+// Darts-clone character map builder (one 256-unit block per node)
+// ==============================================================================
+
+static std::string build_charsmap(const std::vector<std::pair<std::string, std::string>>& rules) {
+    struct Node {
+        int children[256];
+        int value = -1;
+        Node() { std::fill(children, children + 256, -1); }
+    };
+    std::vector<Node> nodes(1);
+    std::string replacements;
+    for (const auto& rule : rules) {
+        int node = 0;
+        for (unsigned char c : rule.first) {
+            if (nodes[node].children[c] < 0) {
+                nodes[node].children[c] = static_cast<int>(nodes.size());
+                nodes.emplace_back();
+            }
+            node = nodes[node].children[c];
+        }
+        nodes[node].value = static_cast<int>(replacements.size());
+        replacements += rule.second;
+        replacements.push_back('\0');
+    }
+
+    // Node n sits at position[n]; its children sit in block (n + 1) at block + label, its leaf at block + 0
+    std::vector<uint32_t> units(256 * (nodes.size() + 1), 0);
+    std::vector<uint32_t> position(nodes.size(), 0);
+    std::vector<uint32_t> label(nodes.size(), 0);
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        for (int c = 0; c < 256; ++c) {
+            if (nodes[n].children[c] >= 0) {
+                position[nodes[n].children[c]] = static_cast<uint32_t>(256 * (n + 1) + c);
+                label[nodes[n].children[c]] = static_cast<uint32_t>(c);
+            }
+        }
+    }
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        const uint32_t block = static_cast<uint32_t>(256 * (n + 1));
+        const uint32_t offset = position[n] ^ block;
+        units[position[n]] = (offset << 10) | (nodes[n].value >= 0 ? (1u << 8) : 0u) | label[n];
+        if (nodes[n].value >= 0) {
+            units[block] = (1u << 31) | static_cast<uint32_t>(nodes[n].value);
+        }
+    }
+
+    std::string blob;
+    const uint32_t trie_size = static_cast<uint32_t>(units.size() * 4);
+    for (int i = 0; i < 4; ++i) {
+        blob.push_back(static_cast<char>((trie_size >> (8 * i)) & 0xff));
+    }
+    for (uint32_t unit : units) {
+        for (int i = 0; i < 4; ++i) {
+            blob.push_back(static_cast<char>((unit >> (8 * i)) & 0xff));
+        }
+    }
+    return blob + replacements;
+}
+
+// ==============================================================================
+// Tests
+// ==============================================================================
+
+bool test_viterbi_picks_best_path() {
+    UnigramTokenizer tokenizer;
+    std::string error;
+    TEST_ASSERT(tokenizer.load(base_model().build(), &error), "Model should load: " << error);
+    TEST_ASSERT_EQUAL(size_t(18), tokenizer.piece_count(), "Every piece is counted");
+
+    // ▁hello (-4) beats ▁hell + o (-8.5) and ▁he + llo (-5.5)
+    TEST_ASSERT_EQUAL(std::string("6 11"), join(encode(tokenizer, "hello world")), "hello world");
+    TEST_ASSERT_EQUAL(std::string("4 9"), join(encode(tokenizer, "hel")), "▁he + l");
+    TEST_ASSERT_EQUAL(std::string(""), join(encode(tokenizer, "")), "Empty text has no pieces");
+    TEST_ASSERT_EQUAL(std::string(""), join(encode(tokenizer, "   ")), "Whitespace-only text has no pieces");
+
+    // UNUSED ▁wor is in the trie but never chosen: ▁ + w + o + r
+    TEST_ASSERT_EQUAL(std::string("3 12 10 13"), join(encode(tokenizer, "wor")), "UNUSED pieces are skipped");
+
+    std::vector<int> ids(100, 7);
+    tokenizer.encode("hello", ids);
+    TEST_ASSERT_EQUAL(std::string("6"), join(ids), "encode clears the output first");
+    return true;
+}
+
+bool test_unknown_characters() {
+    UnigramTokenizer tokenizer;
+    TEST_ASSERT(tokenizer.load(base_model().build()), "Model should load");
+
+    // One unknown piece per character with no single-character piece
+    TEST_ASSERT_EQUAL(std::string("6 3 0"), join(encode(tokenizer, "hello \xe2\x98\x83")), "Snowman is unknown");
+    TEST_ASSERT_EQUAL(std::string("6 3 0 0"), join(encode(tokenizer, "hello zz")), "Each unknown character is its own piece");
+
+    // A malformed byte becomes U+FFFD (one unknown piece per byte)
+    TEST_ASSERT_EQUAL(std::string("6 3 0 0"), join(encode(tokenizer, "hello \xff\xfe")), "Malformed bytes");
+    std::string normalized;
+    tokenizer.normalize("a\xc0\xaf", normalized);      // Overlong '/'
+    TEST_ASSERT_EQUAL(std::string("\xe2\x96\x81" "a\xef\xbf\xbd\xef\xbf\xbd"), normalized, "Overlong forms are malformed");
+    return true;
+}
+
+bool test_whitespace_rules() {
+    UnigramTokenizer tokenizer;
+    TEST_ASSERT(tokenizer.load(base_model().build()), "Model should load");
+
+    std::string normalized;
+    tokenizer.normalize("  hello   world  ", normalized);
+    TEST_ASSERT_EQUAL(std::string("\xe2\x96\x81hello\xe2\x96\x81world"), normalized, "Extra whitespace is removed");
+    TEST_ASSERT_EQUAL(join(encode(tokenizer, "hello world")), join(encode(tokenizer, "  hello   world  ")), "Same IDs");
+
+    // Tabs are not spaces without a character map rule for them
+    tokenizer.normalize("hello\tworld", normalized);
+    TEST_ASSERT_EQUAL(std::string("\xe2\x96\x81hello\tworld"), normalized, "Tab is kept");
+
+    ModelBuilder raw = base_model();
+    put_bool(raw.normalizer, 3, false);                 // add_dummy_prefix
+    put_bool(raw.normalizer, 4, false);                 // remove_extra_whitespaces
+    UnigramTokenizer untrimmed;
+    TEST_ASSERT(untrimmed.load(raw.build()), "Model should load");
+    untrimmed.normalize(" hello  world ", normalized);
+    TEST_ASSERT_EQUAL(std::string("\xe2\x96\x81hello\xe2\x96\x81\xe2\x96\x81world\xe2\x96\x81"), normalized, "Whitespace kept");
+    untrimmed.normalize("hello", normalized);
+    TEST_ASSERT_EQUAL(std::string("hello"), normalized, "No dummy prefix");
+
+    ModelBuilder unescaped = base_model();
+    put_bool(unescaped.normalizer, 5, false);           // escape_whitespaces
+    UnigramTokenizer plain;
+    TEST_ASSERT(plain.load(unescaped.build()), "Model should load");
+    plain.normalize("  hello   world  ", normalized);
+    TEST_ASSERT_EQUAL(std::string(" hello world"), normalized, "Spaces stay spaces");
+    return true;
+}
+
+bool test_character_map() {
+    // Full-width A, a ligature and a tab, the way NFKC-style maps rewrite them; tab becomes a space
+    ModelBuilder builder = base_model();
+    put_bytes(builder.normalizer, 1, "test_map");
+    put_bytes(builder.normalizer, 2, build_charsmap({{"\xef\xbc\xa1", "A"}, {"\xef\xac\x81", "fi"}, {"\t", " "},
+                                                     {"\xef\xbc", "?"}}));
+    UnigramTokenizer tokenizer;
+    std::string error;
+    TEST_ASSERT(tokenizer.load(builder.build(), &error), "Model with a character map should load: " << error);
+
+    std::string normalized;
+    tokenizer.normalize("\xef\xbc\xa1 \xef\xac\x81x", normalized);
+    TEST_ASSERT_EQUAL(std::string("\xe2\x96\x81" "A\xe2\x96\x81" "fix"), normalized, "Longest rule wins");
+    tokenizer.normalize("hello\t\t world", normalized);
+    TEST_ASSERT_EQUAL(std::string("\xe2\x96\x81hello\xe2\x96\x81world"), normalized, "Mapped whitespace collapses");
+    tokenizer.normalize("\t\thello\t", normalized);
+    TEST_ASSERT_EQUAL(std::string("\xe2\x96\x81hello"), normalized, "Mapped whitespace is trimmed");
+    TEST_ASSERT_EQUAL(std::string("3 17"), join(encode(tokenizer, "\xef\xbc\xa1")), "Full-width A encodes as A");
+    return true;
+}
+
+bool test_user_defined_and_byte_fallback() {
+    ModelBuilder builder = base_model();
+    builder.piece("<sep>", 0.0f, USER_DEFINED);                             // 18
+    for (int b = 0; b < 256; ++b) {
+        char name[8];
+        std::snprintf(name, sizeof(name), "<0x%02X>", b);
+        builder.piece(name, 0.0f, BYTE);                                    // 19 + b
+    }
+    put_bool(builder.trainer, 35, true);                                    // byte_fallback
+    UnigramTokenizer tokenizer;
+    std::string error;
+    TEST_ASSERT(tokenizer.load(builder.build(), &error), "Model should load: " << error);
+
+    // User-defined symbols are never split, even inside a word
+    TEST_ASSERT_EQUAL(std::string("6 18 11"), join(encode(tokenizer, "hello<sep> world")), "User-defined symbol");
+    // Unknown characters fall back to their UTF-8 bytes
+    TEST_ASSERT_EQUAL(std::string("6 3 " + std::to_string(19 + 0xe2) + " " + std::to_string(19 + 0x98) + " " +
+                                  std::to_string(19 + 0x83)),
+                      join(encode(tokenizer, "hello \xe2\x98\x83")), "Byte fallback");
+    return true;
+}
+
+bool test_rejects_unsupported_models() {
+    UnigramTokenizer tokenizer;
+    std::string error;
+    TEST_ASSERT(!tokenizer.load("\x0a\xff", &error), "Truncated model is rejected");
+    TEST_ASSERT(!error.empty(), "Reason is reported");
+    TEST_ASSERT(!tokenizer.is_loaded(), "Nothing is loaded after a failure");
+
+    ModelBuilder bpe = base_model();
+    put_varint(bpe.trainer, 3 << 3);
+    put_varint(bpe.trainer, 2);                                             // model_type = BPE
+    TEST_ASSERT(!tokenizer.load(bpe.build(), &error), "BPE models are left to SentencePiece");
+
+    ModelBuilder no_unk;
+    no_unk.piece("a", -1.0f);
+    TEST_ASSERT(!tokenizer.load(no_unk.build(), &error), "A model needs an unknown piece");
+
+    TEST_ASSERT(tokenizer.load(base_model().build()), "Model should load");
+    TEST_ASSERT(!tokenizer.load(bpe.build(), &error), "BPE still rejected");
+    TEST_ASSERT(tokenizer.is_loaded(), "A failed load keeps the previous model");
+    return true;
+}
+
+bool test_concurrent_encoding() {
+    UnigramTokenizer tokenizer;
+    TEST_ASSERT(tokenizer.load(base_model().build()), "Model should load");
+    const std::string text = "hello world hell wor hello \xe2\x98\x83 hello";
+    const std::vector<int> expected = encode(tokenizer, text);
+
+    std::vector<int> mismatches(4, 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < mismatches.size(); ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<int> ids;
+            for (int i = 0; i < 2000; ++i) {
+                tokenizer.encode(i % 2 ? text : "hello", ids);
+                if (i % 2 && ids != expected) {
+                    mismatches[t]++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int count : mismatches) {
+        TEST_ASSERT_EQUAL(0, count, "Threads share the tokenizer through their own scratch buffers");
+    }
+    return true;
+}
+
+#ifdef LEAFRA_HAS_SENTENCEPIECE
+// Bit-identical IDs on a real model (LEAFRA_TEST_SENTENCEPIECE_MODEL=path/to/sentencepiece.model);
+// a build that links SentencePiece fails here rather than passing without the comparison
+bool test_matches_sentencepiece() {
+    const char* model_path = std::getenv("LEAFRA_TEST_SENTENCEPIECE_MODEL");
+    TEST_ASSERT(model_path && *model_path, "LEAFRA_TEST_SENTENCEPIECE_MODEL should name a unigram .model (e.g. multilingual-e5-small's)");
+    std::ifstream file(model_path, std::ios::binary);
+    TEST_ASSERT(file.good(), "Can't open " << model_path);
+    std::string model((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    sentencepiece::SentencePieceProcessor processor;
+    TEST_ASSERT(processor.LoadFromSerializedProto(model).ok(), "SentencePiece should load the model");
+    UnigramTokenizer tokenizer;
+    std::string error;
+    TEST_ASSERT(tokenizer.load(model, &error), "Native engine should load the model: " << error);
+
+    std::vector<std::string> texts = {
+        "", " ", "Hello world", "  leading and trailing  ", "tabs\tand\nnewlines\r\n",
+        "Ｆｕｌｌ－ｗｉｄｔｈ ｔｅｘｔ", "ﬁnancial ﬂow", "Ünïcödé façade naïve", "日本語のテキスト、句読点。",
+        "Привет, мир!", "مرحبا بالعالم", "emoji 😀👍🏽 and ZWJ 👨‍👩‍👧", "malformed \xff\xc0\xaf bytes",
+        "a b c​d", "numbers 1234567890 ½ ² ①", "URL https://example.com/path?q=1&x=y",
+    };
+    // Generated mixtures exercise lengths and character classes the list misses
+    uint32_t state = 12345;
+    const char* fragments[] = {"the ", "ing", " ", "  ", "é", "日", "\t", "😀", "ﬁ", "Ａ", ".", "问题", "-", "x"};
+    for (int t = 0; t < 500; ++t) {
+        std::string text;
+        for (int n = 0; n < 40; ++n) {
+            state = state * 1103515245u + 12345u;
+            text += fragments[(state >> 16) % (sizeof(fragments) / sizeof(fragments[0]))];
+        }
+        texts.push_back(text);
+    }
+
+    std::vector<int> expected;
+    std::vector<int> actual;
+    for (const std::string& text : texts) {
+        TEST_ASSERT(processor.Encode(text, &expected).ok(), "SentencePiece encode");
+        tokenizer.encode(text, actual);
+        TEST_ASSERT(expected == actual, "IDs differ for '" << text << "': " << join(expected) << " vs " << join(actual));
+    }
+
+    // Throughput on the concatenated corpus
+    std::string corpus;
+    for (const std::string& text : texts) {
+        corpus += text + "\n";
+    }
+    auto time = [&](auto&& encode_once) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 20; ++i) {
+            encode_once();
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    double reference = time([&] { processor.Encode(corpus, &expected); });
+    double native = time([&] { tokenizer.encode(corpus, actual); });
+    TEST_ASSERT(expected == actual, "IDs differ on the whole corpus");
+    std::cout << "(" << reference / native << "x SentencePiece) ";
+    return true;
+}
+#endif
+
+int main() {
+    std::cout << "=== Unigram Tokenizer Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_viterbi_picks_best_path);
+    RUN_TEST(test_unknown_characters);
+    RUN_TEST(test_whitespace_rules);
+    RUN_TEST(test_character_map);
+    RUN_TEST(test_user_defined_and_byte_fallback);
+    RUN_TEST(test_rejects_unsupported_models);
+    RUN_TEST(test_concurrent_encoding);
+#ifdef LEAFRA_HAS_SENTENCEPIECE
+    RUN_TEST(test_matches_sentencepiece);
+#endif
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
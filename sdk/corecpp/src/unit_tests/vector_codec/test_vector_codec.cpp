@@ -0,0 +1,150 @@
+#include "../../../include/leafra/leafra_vector_codec.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace leafra;
+
+// Simple test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(expected, actual, message) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << "FAIL: " << message << " - Expected: " << (expected) \
+                      << ", Actual: " << (actual) << " at line " << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(test_func) \
+    do { \
+        std::cout << "Running " << #test_func << "... "; \
+        if (test_func()) { \
+            std::cout << "PASS" << std::endl; \
+            passed_tests++; \
+        } else { \
+            std::cout << "FAIL" << std::endl; \
+            failed_tests++; \
+        } \
+        total_tests++; \
+    } while(0)
+
+static std::vector<float> sample_embedding() {
+    std::vector<float> values(384);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = std::sin(static_cast<float>(i) * 0.37f) * 0.12f;
+    }
+    return values;
+}
+
+bool test_half_conversion() {
+    TEST_ASSERT_EQUAL(0x3c00, VectorCodec::float_to_half(1.0f), "1.0 should encode exactly");
+    TEST_ASSERT_EQUAL(0xc000, VectorCodec::float_to_half(-2.0f), "-2.0 should encode exactly");
+    TEST_ASSERT_EQUAL(0x7bff, VectorCodec::float_to_half(65504.0f), "Largest half should encode exactly");
+    TEST_ASSERT_EQUAL(0x7c00, VectorCodec::float_to_half(1.0e6f), "Overflow should become inf");
+    TEST_ASSERT_EQUAL(0x0001, VectorCodec::float_to_half(std::ldexp(1.0f, -24)), "Smallest subnormal should encode exactly");
+    TEST_ASSERT_EQUAL(0x3c00, VectorCodec::float_to_half(1.0f + std::ldexp(1.0f, -11)), "Ties should round to even");
+    TEST_ASSERT(std::isnan(VectorCodec::half_to_float(VectorCodec::float_to_half(std::numeric_limits<float>::quiet_NaN()))),
+                "NaN should stay NaN");
+    TEST_ASSERT_EQUAL(std::ldexp(1.0f, -24), VectorCodec::half_to_float(0x0001), "Subnormal halves should decode exactly");
+
+    // Every finite half survives a round trip through float
+    for (uint32_t bits = 0; bits < 0x10000u; ++bits) {
+        uint16_t half = static_cast<uint16_t>(bits);
+        if ((half & 0x7c00u) == 0x7c00u) {
+            continue;
+        }
+        TEST_ASSERT_EQUAL(half, VectorCodec::float_to_half(VectorCodec::half_to_float(half)), "Half round trip");
+    }
+    return true;
+}
+
+bool test_round_trip_formats() {
+    const std::vector<float> values = sample_embedding();
+    std::vector<float> decoded(values.size());
+    VectorCodec::Encoded encoded;
+
+    struct Case { EmbeddingStorageFormat format; size_t bytes; float tolerance; };
+    const Case cases[] = {
+        {EmbeddingStorageFormat::FP32, values.size() * 4, 0.0f},
+        {EmbeddingStorageFormat::FP16, values.size() * 2, 1.0e-4f},
+        {EmbeddingStorageFormat::INT8, values.size(), 0.12f / 127.0f},
+    };
+    for (const Case& c : cases) {
+        TEST_ASSERT(VectorCodec::encode(values.data(), values.size(), c.format, encoded), "Encode should succeed");
+        TEST_ASSERT_EQUAL(c.bytes, encoded.data.size(), "Encoded size should match the format");
+        TEST_ASSERT(VectorCodec::decode(encoded.format, encoded.byte_order, encoded.scale, encoded.data.data(),
+                                        encoded.data.size(), decoded.data(), decoded.size()), "Decode should succeed");
+        for (size_t i = 0; i < values.size(); ++i) {
+            TEST_ASSERT(std::fabs(values[i] - decoded[i]) <= c.tolerance, "Decoded value should be within tolerance");
+        }
+    }
+
+    TEST_ASSERT(!VectorCodec::encode(values.data(), values.size(), EmbeddingStorageFormat::NONE, encoded),
+                "NONE should not encode");
+    TEST_ASSERT(!VectorCodec::decode(EmbeddingStorageFormat::FP16, VectorCodec::native_byte_order(), 0.0f,
+                                     encoded.data.data(), encoded.data.size() - 1, decoded.data(), decoded.size()),
+                "Decode should reject a size mismatch");
+    return true;
+}
+
+bool test_foreign_byte_order() {
+    const std::vector<float> values = sample_embedding();
+    std::vector<float> decoded(values.size());
+    const ByteOrder foreign = VectorCodec::native_byte_order() == ByteOrder::LITTLE ? ByteOrder::BIG : ByteOrder::LITTLE;
+    VectorCodec::Encoded encoded;
+
+    // Simulate a database written on a host of the other byte order
+    VectorCodec::encode(values.data(), values.size(), EmbeddingStorageFormat::FP16, encoded);
+    for (size_t i = 0; i + 1 < encoded.data.size(); i += 2) {
+        std::swap(encoded.data[i], encoded.data[i + 1]);
+    }
+    VectorCodec::decode(EmbeddingStorageFormat::FP16, foreign, 0.0f, encoded.data.data(), encoded.data.size(),
+                        decoded.data(), decoded.size());
+    TEST_ASSERT(std::fabs(values[7] - decoded[7]) <= 1.0e-4f, "FP16 should be swapped from a foreign byte order");
+
+    VectorCodec::encode(values.data(), values.size(), EmbeddingStorageFormat::FP32, encoded);
+    for (size_t i = 0; i + 3 < encoded.data.size(); i += 4) {
+        std::swap(encoded.data[i], encoded.data[i + 3]);
+        std::swap(encoded.data[i + 1], encoded.data[i + 2]);
+    }
+    VectorCodec::decode(EmbeddingStorageFormat::FP32, foreign, 0.0f, encoded.data.data(), encoded.data.size(),
+                        decoded.data(), decoded.size());
+    TEST_ASSERT_EQUAL(values[7], decoded[7], "FP32 should be swapped from a foreign byte order");
+    return true;
+}
+
+int main() {
+    std::cout << "=== VectorCodec Tests ===" << std::endl;
+
+    int total_tests = 0;
+    int passed_tests = 0;
+    int failed_tests = 0;
+
+    RUN_TEST(test_half_conversion);
+    RUN_TEST(test_round_trip_formats);
+    RUN_TEST(test_foreign_byte_order);
+
+    // Print summary
+    std::cout << "\n=== Test Summary ===" << std::endl;
+    std::cout << "Total tests: " << total_tests << std::endl;
+    std::cout << "Passed: " << passed_tests << std::endl;
+    std::cout << "Failed: " << failed_tests << std::endl;
+
+    if (failed_tests == 0) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ " << failed_tests << " test(s) failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,269 @@
+#include "LeafraConfigEntries.h"
+#include "leafra/leafra_chunker.h"
+#include "leafra/logger.h"
+
+#include <cstdlib>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+
+namespace leafra {
+namespace android {
+
+namespace {
+
+template<typename T>
+void parse_value(const std::string& text, T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        value = text == "true" || text == "1";
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        value = text;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        value = static_cast<T>(std::strtod(text.c_str(), nullptr));
+    } else {
+        static_assert(std::is_integral_v<T>, "Unsupported config field type");
+        value = static_cast<T>(std::strtoll(text.c_str(), nullptr, 10));   // JS numbers arrive as "32" or "32.0"
+    }
+}
+
+using EntrySetter = std::function<void(Config& config, const std::string& value)>;
+
+#define LEAFRA_CONFIG_ENTRY(field) \
+    {#field, [](Config& config, const std::string& value) { parse_value(value, config.field); }}
+#define LEAFRA_CONFIG_SECTION_ENTRY(section, field) \
+    {#section "." #field, [](Config& config, const std::string& value) { parse_value(value, config.section.field); }}
+
+const std::unordered_map<std::string, EntrySetter>& entry_setters() {
+    static const std::unordered_map<std::string, EntrySetter> setters = {
+        LEAFRA_CONFIG_ENTRY(name),
+        LEAFRA_CONFIG_ENTRY(version),
+        LEAFRA_CONFIG_ENTRY(debug_mode),
+        LEAFRA_CONFIG_ENTRY(async_logging),
+        LEAFRA_CONFIG_ENTRY(log_queue_capacity),
+        LEAFRA_CONFIG_ENTRY(log_drop_when_full),
+        LEAFRA_CONFIG_ENTRY(async_events),
+        LEAFRA_CONFIG_ENTRY(event_queue_capacity),
+        LEAFRA_CONFIG_ENTRY(coalesce_progress_events),
+        LEAFRA_CONFIG_ENTRY(trace_enabled),
+        LEAFRA_CONFIG_ENTRY(trace_max_events_per_thread),
+        LEAFRA_CONFIG_ENTRY(memory_budget_mb),
+        LEAFRA_CONFIG_ENTRY(max_threads),
+        LEAFRA_CONFIG_ENTRY(icu_data_path),
+        LEAFRA_CONFIG_ENTRY(large_pages),
+        LEAFRA_CONFIG_ENTRY(query_threads),
+        LEAFRA_CONFIG_ENTRY(watch_debounce_ms),
+        LEAFRA_CONFIG_ENTRY(background_load),
+        LEAFRA_CONFIG_ENTRY(prefetch_after_initialize),
+        LEAFRA_CONFIG_ENTRY(prefetch_hot_chunks),
+        LEAFRA_CONFIG_ENTRY(buffer_size),
+        LEAFRA_CONFIG_ENTRY(leafra_document_database_name),
+        LEAFRA_CONFIG_ENTRY(storage_directory),
+        LEAFRA_CONFIG_ENTRY(attach_read_only),
+        LEAFRA_CONFIG_ENTRY(attach_refresh_interval_ms),
+        LEAFRA_CONFIG_ENTRY(device_profile_name),
+
+        // Chunking configuration
+        LEAFRA_CONFIG_SECTION_ENTRY(chunking, enabled),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunking, chunk_size),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunking, overlap_percentage),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunking, preserve_word_boundaries),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunking, include_metadata),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunking, parallel_segment_bytes),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunking, max_chunks),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunking, print_chunks_full),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunking, print_chunks_brief),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunking, max_lines),
+
+        // Parsing configuration
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, pdf_parallel_min_pages),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, pdf_max_document_handles),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, pdf_strip_boilerplate),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, pdf_boilerplate_min_ratio),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, pdf_boilerplate_min_pages),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, pdf_boilerplate_edge_lines),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, text_page_bytes),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, sheet_page_bytes),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, cache_enabled),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, cache_max_mb),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, normalize_text),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, normalize_nfkc),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, normalize_whitespace),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, normalize_dehyphenate),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, normalize_strip_control),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, max_pages),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, max_text_mb),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, page_timeout_ms),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, document_timeout_ms),
+        LEAFRA_CONFIG_SECTION_ENTRY(parsing, skip_over_limit),
+
+        // Tokenizer configuration
+        LEAFRA_CONFIG_SECTION_ENTRY(tokenizer, enabled),
+        LEAFRA_CONFIG_SECTION_ENTRY(tokenizer, model_name),
+        LEAFRA_CONFIG_SECTION_ENTRY(tokenizer, model_path),
+        LEAFRA_CONFIG_SECTION_ENTRY(tokenizer, model_json_path),
+
+        // Embedding model configuration
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, enabled),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, framework),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, model_path),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, pooling),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, pipeline_depth),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, cache_enabled),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, cache_max_entries),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, coreml_compute_units),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, coreml_cache_compiled),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, coreml_prewarm),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, query_instance),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, query_coreml_compute_units),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, tflite_enable_coreml_delegate),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, tflite_enable_metal_delegate),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, tflite_enable_xnnpack_delegate),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, tflite_num_threads),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, tflite_use_nnapi),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, tflite_delegate_cache_dir),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, executorch_method),
+        LEAFRA_CONFIG_SECTION_ENTRY(embedding_inference, executorch_num_threads),
+
+        // Vector search configuration
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, enabled),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, dimension),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, index_type),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, metric),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, index_dimension),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, nlist),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, nprobe),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, m),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, nbits),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, hnsw_m),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, ef_search),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, lsh_nbits),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, ivf_train_min_vectors),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, auto_ivf_threshold),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, auto_ivf_type),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, rerank_factor),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, binary_rerank_candidates),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, gpu_flat_search),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, gpu_min_vectors),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, faiss_threads),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, bulk_add_vectors),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, hot_index),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, hot_merge_interval_ms),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, document_prefilter),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, exact_scan_max_chunks),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, query_batch_size),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, query_batch_window_us),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, index_definition),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, auto_save),
+        LEAFRA_CONFIG_SECTION_ENTRY(vector_search, auto_load),
+
+        // Near-duplicate chunk configuration
+        LEAFRA_CONFIG_SECTION_ENTRY(near_duplicates, enabled),
+        LEAFRA_CONFIG_SECTION_ENTRY(near_duplicates, policy),
+        LEAFRA_CONFIG_SECTION_ENTRY(near_duplicates, max_distance),
+        LEAFRA_CONFIG_SECTION_ENTRY(near_duplicates, shingle_words),
+        LEAFRA_CONFIG_SECTION_ENTRY(near_duplicates, min_chars),
+        
+        // Chunk quality filter configuration
+        LEAFRA_CONFIG_SECTION_ENTRY(chunk_quality, enabled),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunk_quality, min_chars),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunk_quality, min_alpha_ratio),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunk_quality, max_tokens_per_byte),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunk_quality, min_entropy),
+        LEAFRA_CONFIG_SECTION_ENTRY(chunk_quality, max_entropy),
+        
+        // Throughput governor configuration
+        LEAFRA_CONFIG_SECTION_ENTRY(governor, enabled),
+        LEAFRA_CONFIG_SECTION_ENTRY(governor, poll_interval_ms),
+        LEAFRA_CONFIG_SECTION_ENTRY(governor, low_battery_percent),
+        LEAFRA_CONFIG_SECTION_ENTRY(governor, interactive_ingest_workers),
+        
+        // Admission control configuration
+        LEAFRA_CONFIG_SECTION_ENTRY(admission, enabled),
+        LEAFRA_CONFIG_SECTION_ENTRY(admission, max_concurrent_embeddings),
+        LEAFRA_CONFIG_SECTION_ENTRY(admission, max_concurrent_searches),
+        LEAFRA_CONFIG_SECTION_ENTRY(admission, max_concurrent_generations),
+        LEAFRA_CONFIG_SECTION_ENTRY(admission, max_queued_requests),
+
+        // LLM configuration
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, enabled),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, model_path),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, draft_model_path),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, n_draft),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, lookup_ngram),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, low_memory_model_path),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, idle_unload_seconds),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, stream_flush_ms),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, stream_flush_tokens),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, framework),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, n_ctx),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, n_predict),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, max_context_tokens),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, n_batch),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, n_ubatch),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, n_threads),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, n_threads_batch),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, n_seq_max),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, temperature),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, top_p),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, top_k),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, min_p),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, repeat_penalty),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, repeat_last_n),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, tfs_z),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, typical_p),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, n_gpu_layers),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, gpu_memory_margin_mb),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, use_mmap),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, use_mlock),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, context_shift),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, n_keep),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, warmup),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, reuse_prompt_cache),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, prefill_during_retrieval),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, cache_chunk_tokens),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, hot_chunk_cache_size),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, hot_chunk_min_retrievals),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, numa),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, type_k),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, type_v),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, flash_attn),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, system_prompt),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, seed),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, debug_mode),
+        LEAFRA_CONFIG_SECTION_ENTRY(llm, verbose_prompt),
+        {"chunking.size_unit", [](Config& config, const std::string& value) {
+            config.chunking.size_unit = value == "TOKENS" ? ChunkSizeUnit::TOKENS
+                                      : value == "EXACT_TOKENS" ? ChunkSizeUnit::EXACT_TOKENS
+                                      : ChunkSizeUnit::CHARACTERS;
+        }},
+        {"chunking.strategy", [](Config& config, const std::string& value) {
+            config.chunking.strategy = value == "SENTENCE" ? ChunkingStrategy::SENTENCE : ChunkingStrategy::FIXED;
+        }},
+        {"chunking.token_method", [](Config& config, const std::string&) {
+            config.chunking.token_method = TokenApproximationMethod::SIMPLE;   // The only available method
+        }},
+    };
+    return setters;
+}
+
+#undef LEAFRA_CONFIG_ENTRY
+#undef LEAFRA_CONFIG_SECTION_ENTRY
+
+} // namespace
+
+Config config_from_entries(const std::vector<std::string>& keys, const std::vector<std::string>& values) {
+    Config config;
+    const auto& setters = entry_setters();
+    for (size_t i = 0; i < keys.size() && i < values.size(); ++i) {
+        auto it = setters.find(keys[i]);
+        if (it == setters.end()) {
+            LEAFRA_DEBUG() << "Ignoring unknown config entry: " << keys[i];
+            continue;
+        }
+        it->second(config, values[i]);
+    }
+    return config;
+} //config_from_entries
+
+} // namespace android
+} // namespace leafra
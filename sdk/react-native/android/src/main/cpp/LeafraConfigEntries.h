@@ -0,0 +1,24 @@
+#pragma once
+
+#include "leafra/types.h"
+#include <string>
+#include <vector>
+
+namespace leafra {
+namespace android {
+
+/**
+ * @brief Build a Config from flattened configuration entries
+ *
+ * The Java module flattens the JS config object into parallel key / value arrays
+ * ("llm.n_ctx" -> "2048"), so the whole configuration crosses JNI in one call. Keys are
+ * the ones the iOS bridge reads from its dictionary; unknown keys are logged and ignored.
+ *
+ * @param keys Field paths ("name", "section.field")
+ * @param values String form of each value (booleans as "true" / "false")
+ * @return Configuration with every recognized entry applied over the defaults
+ */
+Config config_from_entries(const std::vector<std::string>& keys, const std::vector<std::string>& values);
+
+} // namespace android
+} // namespace leafra
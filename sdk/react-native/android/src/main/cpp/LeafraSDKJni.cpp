@@ -0,0 +1,559 @@
+#include <jni.h>
+#include <fbjni/fbjni.h>
+#include <ReactCommon/CallInvokerHolder.h>
+
+#include "LeafraConfigEntries.h"
+#include "LeafraSDKJSI.h"
+#include "LeafraTokenText.h"
+#include "leafra/leafra_core.h"
+#include "leafra/leafra_threadpool.h"
+#include "leafra/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// JNI side of com.leafra.sdk.LeafraSDKNative. Long-running calls are queued on the SDK's own
+// worker pool and report back through Java callbacks; results cross as bulk primitive arrays
+// (search results) or direct ByteBuffers (embeddings) instead of per-element JNI calls.
+
+namespace leafra {
+namespace android {
+
+namespace {
+
+JavaVM* g_vm = nullptr;
+
+// Classes and methods resolved once in JNI_OnLoad (FindClass can't see app classes from SDK threads)
+struct JavaBindings {
+    jclass string_class = nullptr;
+    jclass search_results_class = nullptr;
+    jclass byte_buffer_class = nullptr;
+    jmethodID search_results_init = nullptr;
+    jmethodID allocate_direct = nullptr;
+    jmethodID callback_invoke = nullptr;
+    jmethodID tokens_on_tokens = nullptr;
+    jmethodID progress_on_progress = nullptr;
+};
+
+JavaBindings g_java;
+
+struct ThreadDetacher {
+    ~ThreadDetacher() {
+        if (g_vm) {
+            g_vm->DetachCurrentThread();
+        }
+    }
+};
+
+// JNIEnv of the calling thread; SDK worker threads are attached on first use and detached when they exit
+JNIEnv* current_env() {
+    JNIEnv* env = nullptr;
+    if (g_vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) == JNI_OK) {
+        return env;
+    }
+    if (g_vm->AttachCurrentThread(&env, nullptr) != JNI_OK) {
+        return nullptr;
+    }
+    thread_local ThreadDetacher detacher;
+    return env;
+}
+
+// Local references made by a task on an attached worker thread are freed when it returns
+class LocalFrame {
+public:
+    LocalFrame(JNIEnv* env, jint capacity) : env_(env), pushed_(env->PushLocalFrame(capacity) == 0) {}
+    ~LocalFrame() {
+        if (pushed_) {
+            env_->PopLocalFrame(nullptr);
+        }
+    }
+
+private:
+    JNIEnv* env_;
+    bool pushed_;
+};
+
+class GlobalRef {
+public:
+    GlobalRef(JNIEnv* env, jobject object) : object_(object ? env->NewGlobalRef(object) : nullptr) {}
+    ~GlobalRef() {
+        if (object_) {
+            if (JNIEnv* env = current_env()) {
+                env->DeleteGlobalRef(object_);
+            }
+        }
+    }
+    GlobalRef(const GlobalRef&) = delete;
+    GlobalRef& operator=(const GlobalRef&) = delete;
+
+    jobject get() const { return object_; }
+
+private:
+    jobject object_;
+};
+
+bool clear_java_exception(JNIEnv* env, const char* context) {
+    if (!env->ExceptionCheck()) {
+        return false;
+    }
+    env->ExceptionDescribe();
+    env->ExceptionClear();
+    LEAFRA_WARNING() << "Java exception in " << context;
+    return true;
+}
+
+// Java strings are UTF-16; NewStringUTF / GetStringUTFChars use modified UTF-8, which mangles emoji
+jstring to_jstring(JNIEnv* env, std::string_view text) {
+    std::u16string utf16;
+    utf16.reserve(text.size());
+    for (size_t i = 0; i < text.size();) {
+        unsigned char byte = static_cast<unsigned char>(text[i]);
+        uint32_t code_point = 0xFFFD;
+        size_t length = byte < 0x80 ? 1 : byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+        if (i + length <= text.size()) {
+            code_point = length == 1 ? (byte < 0x80 ? byte : 0xFFFD) : byte & (0xFF >> (length + 1));
+            for (size_t k = 1; k < length; ++k) {
+                code_point = (code_point << 6) | (static_cast<unsigned char>(text[i + k]) & 0x3F);
+            }
+        }
+        i += length;
+        if (code_point >= 0x10000) {
+            code_point -= 0x10000;
+            utf16.push_back(static_cast<char16_t>(0xD800 + (code_point >> 10)));
+            utf16.push_back(static_cast<char16_t>(0xDC00 + (code_point & 0x3FF)));
+        } else {
+            utf16.push_back(static_cast<char16_t>(code_point));
+        }
+    }
+    return env->NewString(reinterpret_cast<const jchar*>(utf16.data()), static_cast<jsize>(utf16.size()));
+}
+
+std::string from_jstring(JNIEnv* env, jstring value) {
+    if (!value) {
+        return std::string();
+    }
+    jsize length = env->GetStringLength(value);
+    const jchar* chars = env->GetStringChars(value, nullptr);
+    std::string utf8;
+    utf8.reserve(static_cast<size_t>(length));
+    for (jsize i = 0; i < length; ++i) {
+        uint32_t code_point = chars[i];
+        if (code_point >= 0xD800 && code_point < 0xDC00 && i + 1 < length && chars[i + 1] >= 0xDC00 && chars[i + 1] < 0xE000) {
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (chars[++i] - 0xDC00);
+        }
+        if (code_point < 0x80) {
+            utf8.push_back(static_cast<char>(code_point));
+        } else if (code_point < 0x800) {
+            utf8.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+            utf8.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        } else if (code_point < 0x10000) {
+            utf8.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+            utf8.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            utf8.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        } else {
+            utf8.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+            utf8.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+            utf8.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            utf8.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+    }
+    env->ReleaseStringChars(value, chars);
+    return utf8;
+}
+
+std::vector<std::string> from_jstring_array(JNIEnv* env, jobjectArray values) {
+    std::vector<std::string> strings;
+    jsize count = values ? env->GetArrayLength(values) : 0;
+    strings.reserve(static_cast<size_t>(count));
+    for (jsize i = 0; i < count; ++i) {
+        jstring value = static_cast<jstring>(env->GetObjectArrayElement(values, i));
+        strings.push_back(from_jstring(env, value));
+        env->DeleteLocalRef(value);
+    }
+    return strings;
+}
+
+const char* stage_name(IngestionStage stage) {
+    switch (stage) {
+        case IngestionStage::QUEUED:     return "queued";
+        case IngestionStage::PARSING:    return "parsing";
+        case IngestionStage::CHUNKING:   return "chunking";
+        case IngestionStage::TOKENIZING: return "tokenizing";
+        case IngestionStage::EMBEDDING:  return "embedding";
+        case IngestionStage::STORING:    return "storing";
+        case IngestionStage::COMPLETED:  return "completed";
+        case IngestionStage::FAILED:     return "failed";
+        case IngestionStage::CANCELLED:  return "cancelled";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Column-wise SearchResults: one bulk array per field instead of a JNI call per value
+ *
+ * Takes a std::vector<FaissIndex::SearchResult> or a SearchResultSet. Hits of the same
+ * document share one Java filename string.
+ */
+template <typename Hits>
+jobject to_search_results(JNIEnv* env, const Hits& results) {
+    jsize count = static_cast<jsize>(results.size());
+    std::vector<jlong> ids(results.size());
+    std::vector<jfloat> distances(results.size());
+    std::vector<jlong> doc_ids(results.size());
+    std::vector<jint> chunk_indices(results.size());
+    std::vector<jint> page_numbers(results.size());
+    std::vector<jlong> text_starts(results.size());
+    std::vector<jlong> text_ends(results.size());
+    std::vector<jlong> page_text_starts(results.size());
+    jobjectArray contents = env->NewObjectArray(count, g_java.string_class, nullptr);
+    jobjectArray filenames = env->NewObjectArray(count, g_java.string_class, nullptr);
+    std::vector<std::pair<std::string_view, jstring>> filename_strings;
+    for (jsize i = 0; i < count; ++i) {
+        const auto& result = results[static_cast<size_t>(i)];
+        ids[i] = result.id;
+        distances[i] = result.distance;
+        doc_ids[i] = result.doc_id;
+        chunk_indices[i] = result.chunk_index;
+        page_numbers[i] = result.page_number;
+        text_starts[i] = result.text_start;
+        text_ends[i] = result.text_end;
+        page_text_starts[i] = result.page_text_start;
+        if (!result.content.empty()) {
+            jstring content = to_jstring(env, result.content);
+            env->SetObjectArrayElement(contents, i, content);
+            env->DeleteLocalRef(content);
+        }
+        if (!result.filename.empty()) {
+            const std::string_view name(result.filename);
+            auto known = std::find_if(filename_strings.begin(), filename_strings.end(),
+                                      [&](const std::pair<std::string_view, jstring>& entry) { return entry.first == name; });
+            if (known == filename_strings.end()) {
+                filename_strings.emplace_back(name, to_jstring(env, name));
+                known = filename_strings.end() - 1;
+            }
+            env->SetObjectArrayElement(filenames, i, known->second);
+        }
+    }
+    for (const auto& entry : filename_strings) {
+        env->DeleteLocalRef(entry.second);
+    }
+
+    jlongArray id_array = env->NewLongArray(count);
+    jfloatArray distance_array = env->NewFloatArray(count);
+    jlongArray doc_id_array = env->NewLongArray(count);
+    jintArray chunk_index_array = env->NewIntArray(count);
+    jintArray page_number_array = env->NewIntArray(count);
+    jlongArray text_start_array = env->NewLongArray(count);
+    jlongArray text_end_array = env->NewLongArray(count);
+    jlongArray page_text_start_array = env->NewLongArray(count);
+    env->SetLongArrayRegion(id_array, 0, count, ids.data());
+    env->SetFloatArrayRegion(distance_array, 0, count, distances.data());
+    env->SetLongArrayRegion(doc_id_array, 0, count, doc_ids.data());
+    env->SetIntArrayRegion(chunk_index_array, 0, count, chunk_indices.data());
+    env->SetIntArrayRegion(page_number_array, 0, count, page_numbers.data());
+    env->SetLongArrayRegion(text_start_array, 0, count, text_starts.data());
+    env->SetLongArrayRegion(text_end_array, 0, count, text_ends.data());
+    env->SetLongArrayRegion(page_text_start_array, 0, count, page_text_starts.data());
+    return env->NewObject(g_java.search_results_class, g_java.search_results_init, id_array, distance_array, doc_id_array,
+                          chunk_index_array, page_number_array, text_start_array, text_end_array, page_text_start_array,
+                          contents, filenames);
+} //to_search_results
+
+/**
+ * @brief Embedding in a native-order direct ByteBuffer (Java views it with asFloatBuffer())
+ */
+jobject to_direct_buffer(JNIEnv* env, const std::vector<float>& embedding) {
+    jint bytes = static_cast<jint>(embedding.size() * sizeof(float));
+    jobject buffer = env->CallStaticObjectMethod(g_java.byte_buffer_class, g_java.allocate_direct, bytes);
+    if (clear_java_exception(env, "ByteBuffer.allocateDirect") || !buffer) {
+        return nullptr;
+    }
+    std::memcpy(env->GetDirectBufferAddress(buffer), embedding.data(), static_cast<size_t>(bytes));
+    return buffer;
+}
+
+void complete(JNIEnv* env, const GlobalRef& callback, ResultCode result, jobject payload) {
+    env->CallVoidMethod(callback.get(), g_java.callback_invoke, static_cast<jint>(result), payload);
+    clear_java_exception(env, "NativeCallback.invoke");
+}
+
+/**
+ * @brief Batches generated tokens into TokenListener calls at most once per frame
+ *
+ * Tokens produced within one frame interval of the last delivery are held and sent together;
+ * an incomplete UTF-8 tail is kept until the next token completes the character.
+ */
+class TokenBatcher {
+public:
+    explicit TokenBatcher(std::shared_ptr<GlobalRef> listener) : listener_(std::move(listener)) {}
+
+    bool push(const std::string& token) {
+        pending_ += token;
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_flush_ >= kFlushInterval) {
+            flush(false);
+            last_flush_ = now;
+        }
+        return !cancelled_;
+    }
+
+    void flush(bool final) {
+        size_t length = final ? pending_.size() : complete_utf8_length(pending_);
+        if (length == 0 || cancelled_) {
+            return;
+        }
+        JNIEnv* env = current_env();
+        if (!env) {
+            return;
+        }
+        jstring text = to_jstring(env, pending_.substr(0, length));
+        pending_.erase(0, length);
+        jboolean keep_going = env->CallBooleanMethod(listener_->get(), g_java.tokens_on_tokens, text);
+        env->DeleteLocalRef(text);
+        if (clear_java_exception(env, "TokenListener.onTokens") || !keep_going) {
+            cancelled_ = true;
+        }
+    }
+
+private:
+    static constexpr std::chrono::milliseconds kFlushInterval{16};
+
+    std::shared_ptr<GlobalRef> listener_;
+    std::string pending_;
+    std::chrono::steady_clock::time_point last_flush_;
+    bool cancelled_ = false;
+};
+
+struct NativeSDK {
+    std::shared_ptr<LeafraCore> core = LeafraCore::create();
+    std::mutex job_mutex;
+    std::shared_ptr<IngestionJob> ingestion_job;
+    ThreadPool workers{2, ThreadQoS::USER_INITIATED, "LeafraJNI"};
+};
+
+NativeSDK* from_handle(jlong handle) {
+    return reinterpret_cast<NativeSDK*>(handle);
+}
+
+/**
+ * @brief Run task on the SDK worker pool with an attached JNIEnv and a local reference frame
+ */
+template<typename Task>
+void run_on_workers(JNIEnv* env, NativeSDK* sdk, jobject callback, Task task) {
+    auto callback_ref = std::make_shared<GlobalRef>(env, callback);
+    bool submitted = sdk->workers.submit([callback_ref, task]() {
+        JNIEnv* worker_env = current_env();
+        if (!worker_env) {
+            LEAFRA_ERROR() << "Failed to attach SDK worker thread to the JVM";
+            return;
+        }
+        LocalFrame frame(worker_env, 32);
+        task(worker_env, *callback_ref);
+    });
+    if (!submitted) {
+        complete(env, *callback_ref, ResultCode::ERROR_CANCELLED, nullptr);
+    }
+}
+
+} // namespace
+} // namespace android
+} // namespace leafra
+
+using namespace leafra;
+using namespace leafra::android;
+
+extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void*) {
+    g_vm = vm;
+    return facebook::jni::initialize(vm, [] {
+        JNIEnv* env = facebook::jni::Environment::current();
+        auto global_class = [env](const char* name) {
+            jclass local = env->FindClass(name);
+            jclass global = static_cast<jclass>(env->NewGlobalRef(local));
+            env->DeleteLocalRef(local);
+            return global;
+        };
+        g_java.string_class = global_class("java/lang/String");
+        g_java.search_results_class = global_class("com/leafra/sdk/SearchResults");
+        g_java.byte_buffer_class = global_class("java/nio/ByteBuffer");
+        g_java.search_results_init = env->GetMethodID(g_java.search_results_class, "<init>",
+                                                      "([J[F[J[I[I[J[J[J[Ljava/lang/String;[Ljava/lang/String;)V");
+        g_java.allocate_direct = env->GetStaticMethodID(g_java.byte_buffer_class, "allocateDirect", "(I)Ljava/nio/ByteBuffer;");
+
+        jclass callback_class = env->FindClass("com/leafra/sdk/NativeCallback");
+        g_java.callback_invoke = env->GetMethodID(callback_class, "invoke", "(ILjava/lang/Object;)V");
+        jclass tokens_class = env->FindClass("com/leafra/sdk/TokenListener");
+        g_java.tokens_on_tokens = env->GetMethodID(tokens_class, "onTokens", "(Ljava/lang/String;)Z");
+        jclass progress_class = env->FindClass("com/leafra/sdk/ProgressListener");
+        g_java.progress_on_progress = env->GetMethodID(progress_class, "onProgress", "(Ljava/lang/String;IILjava/lang/String;JID)V");
+        env->DeleteLocalRef(callback_class);
+        env->DeleteLocalRef(tokens_class);
+        env->DeleteLocalRef(progress_class);
+    });
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeCreate(JNIEnv*, jclass) {
+    return reinterpret_cast<jlong>(new NativeSDK());
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeDestroy(JNIEnv*, jclass, jlong handle) {
+    delete from_handle(handle);
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeInitialize(
+    JNIEnv* env, jclass, jlong handle, jobjectArray keys, jobjectArray values, jobject callback) {
+    NativeSDK* sdk = from_handle(handle);
+    Config config = config_from_entries(from_jstring_array(env, keys), from_jstring_array(env, values));
+    std::shared_ptr<LeafraCore> core = sdk->core;
+    run_on_workers(env, sdk, callback, [core, config](JNIEnv* worker_env, const GlobalRef& done) {
+        complete(worker_env, done, core->initialize(config), nullptr);
+    });
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeShutdown(JNIEnv* env, jclass, jlong handle, jobject callback) {
+    NativeSDK* sdk = from_handle(handle);
+    std::shared_ptr<LeafraCore> core = sdk->core;
+    run_on_workers(env, sdk, callback, [core](JNIEnv* worker_env, const GlobalRef& done) {
+        complete(worker_env, done, core->shutdown(), nullptr);
+    });
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeIsInitialized(JNIEnv*, jclass, jlong handle) {
+    return from_handle(handle)->core->is_initialized() ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jstring JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeGetVersion(JNIEnv* env, jclass) {
+    return to_jstring(env, LeafraCore::get_version());
+}
+
+extern "C" JNIEXPORT jstring JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeGetPlatform(JNIEnv* env, jclass) {
+    return to_jstring(env, LeafraCore::get_platform());
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeProcessUserFiles(
+    JNIEnv* env, jclass, jlong handle, jobjectArray paths, jobject callback) {
+    NativeSDK* sdk = from_handle(handle);
+    std::vector<std::string> file_paths = from_jstring_array(env, paths);
+    std::shared_ptr<LeafraCore> core = sdk->core;
+    run_on_workers(env, sdk, callback, [core, file_paths](JNIEnv* worker_env, const GlobalRef& done) {
+        complete(worker_env, done, core->process_user_files(file_paths), nullptr);
+    });
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeProcessUserFilesAsync(
+    JNIEnv* env, jclass, jlong handle, jobjectArray paths, jobject progress, jobject callback) {
+    NativeSDK* sdk = from_handle(handle);
+    if (!sdk->core->is_initialized()) {
+        return JNI_FALSE;
+    }
+    auto progress_ref = std::make_shared<GlobalRef>(env, progress);
+    auto callback_ref = std::make_shared<GlobalRef>(env, callback);
+
+    // Callbacks arrive on the core's ingestion workers
+    IngestionOptions options;
+    options.on_progress = [progress_ref](const IngestionProgress& p) {
+        JNIEnv* worker_env = current_env();
+        if (!worker_env || !progress_ref->get()) {
+            return;
+        }
+        LocalFrame frame(worker_env, 4);
+        jstring path = to_jstring(worker_env, p.file_path);
+        jstring stage = to_jstring(worker_env, stage_name(p.stage));
+        worker_env->CallVoidMethod(progress_ref->get(), g_java.progress_on_progress, path, static_cast<jint>(p.file_index),
+                                   static_cast<jint>(p.total_files), stage, static_cast<jlong>(p.bytes),
+                                   static_cast<jint>(p.chunks), static_cast<jdouble>(p.elapsed_ms));
+        clear_java_exception(worker_env, "ProgressListener.onProgress");
+    };
+    options.on_complete = [callback_ref](ResultCode result) {
+        if (JNIEnv* worker_env = current_env()) {
+            complete(worker_env, *callback_ref, result, nullptr);
+        }
+    };
+
+    // Cancel any previous job; the core serializes ingestion runs anyway
+    std::lock_guard<std::mutex> lock(sdk->job_mutex);
+    if (sdk->ingestion_job && !sdk->ingestion_job->is_done()) {
+        sdk->ingestion_job->cancel();
+    }
+    sdk->ingestion_job = sdk->core->process_user_files_async(from_jstring_array(env, paths), options);
+    return sdk->ingestion_job ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeCancelUserFileProcessing(JNIEnv*, jclass, jlong handle) {
+    NativeSDK* sdk = from_handle(handle);
+    std::lock_guard<std::mutex> lock(sdk->job_mutex);
+    if (sdk->ingestion_job) {
+        sdk->ingestion_job->cancel();
+    }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeHandleMemoryPressure(
+    JNIEnv*, jclass, jlong handle, jboolean critical) {
+    NativeSDK* sdk = from_handle(handle);
+    std::shared_ptr<LeafraCore> core = sdk->core;
+    const MemoryPressure pressure = critical ? MemoryPressure::CRITICAL : MemoryPressure::MODERATE;
+    // Unloading the LLM waits for running generations, so keep it off the main thread
+    sdk->workers.submit([core, pressure]() { core->handle_memory_pressure(pressure); });
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeSemanticSearch(
+    JNIEnv* env, jclass, jlong handle, jstring query, jint max_results, jobject callback) {
+    NativeSDK* sdk = from_handle(handle);
+    std::string query_text = from_jstring(env, query);
+    std::shared_ptr<LeafraCore> core = sdk->core;
+    run_on_workers(env, sdk, callback, [core, query_text, max_results](JNIEnv* worker_env, const GlobalRef& done) {
+        SearchResultSet results;
+        ResultCode result = core->semantic_search(query_text, max_results, results);
+        complete(worker_env, done, result, to_search_results(worker_env, results));
+    });
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeSemanticSearchWithLLM(
+    JNIEnv* env, jclass, jlong handle, jstring query, jint max_results, jobject listener, jobject callback) {
+    NativeSDK* sdk = from_handle(handle);
+    std::string query_text = from_jstring(env, query);
+    auto listener_ref = std::make_shared<GlobalRef>(env, listener);
+    std::shared_ptr<LeafraCore> core = sdk->core;
+    run_on_workers(env, sdk, callback, [core, query_text, max_results, listener_ref](JNIEnv* worker_env, const GlobalRef& done) {
+        std::vector<FaissIndex::SearchResult> results;
+#ifdef LEAFRA_HAS_LLAMACPP
+        auto batcher = std::make_shared<TokenBatcher>(listener_ref);
+        ResultCode result = core->semantic_search_with_llm(query_text, max_results, results,
+            [batcher](const std::string& token, bool) { return batcher->push(token); });
+        batcher->flush(true);
+#else
+        ResultCode result = ResultCode::ERROR_NOT_IMPLEMENTED;
+#endif
+        complete(worker_env, done, result, to_search_results(worker_env, results));
+    });
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeEmbedQuery(
+    JNIEnv* env, jclass, jlong handle, jstring query, jobject callback) {
+    NativeSDK* sdk = from_handle(handle);
+    std::string query_text = from_jstring(env, query);
+    std::shared_ptr<LeafraCore> core = sdk->core;
+    run_on_workers(env, sdk, callback, [core, query_text](JNIEnv* worker_env, const GlobalRef& done) {
+        std::vector<float> embedding;
+        ResultCode result = core->embed_query(query_text, embedding);
+        complete(worker_env, done, result, result == ResultCode::SUCCESS ? to_direct_buffer(worker_env, embedding) : nullptr);
+    });
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_com_leafra_sdk_LeafraSDKNative_nativeInstallJSI(
+    JNIEnv*, jclass, jlong handle, jlong runtime_pointer, jobject call_invoker_holder) {
+    auto* runtime = reinterpret_cast<facebook::jsi::Runtime*>(runtime_pointer);
+    if (!runtime || !call_invoker_holder) {
+        return JNI_FALSE;
+    }
+    facebook::jni::alias_ref<facebook::react::CallInvokerHolder::javaobject> holder{
+        reinterpret_cast<facebook::react::CallInvokerHolder::javaobject>(call_invoker_holder)};
+    jsi_bindings::install(*runtime, holder->cthis()->getCallInvoker(), from_handle(handle)->core);
+    return JNI_TRUE;
+}
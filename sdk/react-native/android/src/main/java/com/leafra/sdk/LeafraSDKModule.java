@@ -0,0 +1,316 @@
+package com.leafra.sdk;
+
+import android.content.ComponentCallbacks2;
+import android.content.res.Configuration;
+
+import androidx.annotation.NonNull;
+
+import com.facebook.react.bridge.Arguments;
+import com.facebook.react.bridge.Promise;
+import com.facebook.react.bridge.ReactApplicationContext;
+import com.facebook.react.bridge.ReactContextBaseJavaModule;
+import com.facebook.react.bridge.ReactMethod;
+import com.facebook.react.bridge.ReadableArray;
+import com.facebook.react.bridge.ReadableMap;
+import com.facebook.react.bridge.ReadableMapKeySetIterator;
+import com.facebook.react.bridge.WritableArray;
+import com.facebook.react.bridge.WritableMap;
+import com.facebook.react.modules.core.DeviceEventManagerModule;
+import com.facebook.react.turbomodule.core.CallInvokerHolderImpl;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.FloatBuffer;
+import java.util.ArrayList;
+import java.util.List;
+
+/**
+ * React Native module "LeafraSDK" for Android, with the same methods and events as the iOS module.
+ *
+ * Everything runs on the native SDK worker pool; promises are settled from there. install() adds the
+ * global.LeafraSDKJSI fast path shared with iOS (see cpp/LeafraSDKJSI.h). onTrimMemory is forwarded to the
+ * SDK, which gives back caches first and the LLM only when memory runs critically low.
+ */
+public class LeafraSDKModule extends ReactContextBaseJavaModule implements ComponentCallbacks2 {
+    private static final String TOKEN_EVENT = "LeafraSDKTokenEvent";
+    private static final String PROGRESS_EVENT = "LeafraSDKIngestionProgress";
+    private static final int ERROR_CANCELLED = -7;    // ResultCode::ERROR_CANCELLED
+
+    private long handle;
+
+    public LeafraSDKModule(ReactApplicationContext reactContext) {
+        super(reactContext);
+        handle = LeafraSDKNative.nativeCreate();
+        reactContext.getApplicationContext().registerComponentCallbacks(this);
+    }
+
+    @NonNull
+    @Override
+    public String getName() {
+        return "LeafraSDK";
+    }
+
+    @Override
+    public void invalidate() {
+        getReactApplicationContext().getApplicationContext().unregisterComponentCallbacks(this);
+        if (handle != 0) {
+            LeafraSDKNative.nativeDestroy(handle);
+            handle = 0;
+        }
+        super.invalidate();
+    }
+
+    @Override
+    public void onTrimMemory(int level) {
+        if (handle == 0 || level < TRIM_MEMORY_RUNNING_LOW) {
+            return;
+        }
+        boolean critical = level == TRIM_MEMORY_RUNNING_CRITICAL || level >= TRIM_MEMORY_COMPLETE;
+        LeafraSDKNative.nativeHandleMemoryPressure(handle, critical);
+    }
+
+    @Override
+    public void onLowMemory() {
+        if (handle != 0) {
+            LeafraSDKNative.nativeHandleMemoryPressure(handle, true);
+        }
+    }
+
+    @Override
+    public void onConfigurationChanged(@NonNull Configuration newConfig) {}
+
+    // Required by NativeEventEmitter
+    @ReactMethod
+    public void addListener(String eventName) {}
+
+    @ReactMethod
+    public void removeListeners(double count) {}
+
+    @ReactMethod
+    public void initialize(ReadableMap config, Promise promise) {
+        List<String> keys = new ArrayList<>();
+        List<String> values = new ArrayList<>();
+        flattenConfig(config, "", keys, values);
+        LeafraSDKNative.nativeInitialize(handle, keys.toArray(new String[0]), values.toArray(new String[0]),
+            (result, payload) -> settle(promise, "INITIALIZATION_ERROR", result, result));
+    }
+
+    @ReactMethod
+    public void shutdown(Promise promise) {
+        LeafraSDKNative.nativeShutdown(handle, (result, payload) -> settle(promise, "SHUTDOWN_ERROR", result, result));
+    }
+
+    @ReactMethod
+    public void isInitialized(Promise promise) {
+        promise.resolve(LeafraSDKNative.nativeIsInitialized(handle));
+    }
+
+    @ReactMethod
+    public void getVersion(Promise promise) {
+        promise.resolve(LeafraSDKNative.nativeGetVersion());
+    }
+
+    @ReactMethod
+    public void getPlatform(Promise promise) {
+        promise.resolve(LeafraSDKNative.nativeGetPlatform());
+    }
+
+    @ReactMethod
+    public void processUserFiles(ReadableArray fileUrls, Promise promise) {
+        String[] paths = toPaths(fileUrls);
+        LeafraSDKNative.nativeProcessUserFiles(handle, paths, (result, payload) -> {
+            WritableMap map = Arguments.createMap();
+            map.putInt("result", result);
+            WritableArray processed = Arguments.createArray();
+            for (String path : paths) {
+                processed.pushString(path);
+            }
+            map.putArray("processedFiles", processed);
+            map.putString("message", result == 0 ? "Successfully processed " + paths.length + " files" : "Failed to process some files");
+            promise.resolve(map);
+        });
+    }
+
+    @ReactMethod
+    public void processUserFilesAsync(ReadableArray fileUrls, Promise promise) {
+        String[] paths = toPaths(fileUrls);
+        ProgressListener progress = (filePath, fileIndex, totalFiles, stage, bytes, chunks, elapsedMs) -> {
+            WritableMap info = Arguments.createMap();
+            info.putString("filePath", filePath);
+            info.putInt("fileIndex", fileIndex);
+            info.putInt("totalFiles", totalFiles);
+            info.putString("stage", stage);
+            info.putDouble("bytes", bytes);
+            info.putInt("chunks", chunks);
+            info.putDouble("elapsedMs", elapsedMs);
+            emit(PROGRESS_EVENT, info);
+        };
+        boolean started = LeafraSDKNative.nativeProcessUserFilesAsync(handle, paths, progress, (result, payload) -> {
+            WritableMap map = Arguments.createMap();
+            map.putInt("result", result);
+            String message = "Failed to process some files";
+            if (result == 0) {
+                message = "Successfully processed " + paths.length + " files";
+            } else if (result == ERROR_CANCELLED) {
+                message = "File processing cancelled";
+            }
+            map.putString("message", message);
+            promise.resolve(map);
+        });
+        if (!started) {
+            promise.reject("PROCESS_FILES_ERROR", "SDK not initialized");
+        }
+    }
+
+    @ReactMethod
+    public void cancelProcessUserFiles(Promise promise) {
+        LeafraSDKNative.nativeCancelUserFileProcessing(handle);
+        promise.resolve(true);
+    }
+
+    @ReactMethod
+    public void semanticSearch(String query, double maxResults, Promise promise) {
+        LeafraSDKNative.nativeSemanticSearch(handle, query, (int) maxResults,
+            (result, payload) -> promise.resolve(toSearchResponse(result, (SearchResults) payload)));
+    }
+
+    @ReactMethod
+    public void semanticSearchWithLLM(String query, double maxResults, Promise promise) {
+        TokenListener listener = text -> {
+            WritableMap body = Arguments.createMap();
+            body.putString("token", text);
+            emit(TOKEN_EVENT, body);
+            return true;
+        };
+        LeafraSDKNative.nativeSemanticSearchWithLLM(handle, query, (int) maxResults, listener,
+            (result, payload) -> promise.resolve(toSearchResponse(result, (SearchResults) payload)));
+    }
+
+    /**
+     * Query embedding as a number array. Native code hands over a direct ByteBuffer, which is read
+     * in one bulk get; JSI callers get the ArrayBuffer from global.LeafraSDKJSI.embedQuery instead.
+     */
+    @ReactMethod
+    public void embedQuery(String query, Promise promise) {
+        LeafraSDKNative.nativeEmbedQuery(handle, query, (result, payload) -> {
+            if (result != 0 || payload == null) {
+                promise.reject("EMBED_QUERY_ERROR", "Query embedding failed with code " + result);
+                return;
+            }
+            FloatBuffer buffer = ((ByteBuffer) payload).order(ByteOrder.nativeOrder()).asFloatBuffer();
+            float[] values = new float[buffer.remaining()];
+            buffer.get(values);
+            WritableArray embedding = Arguments.createArray();
+            for (float value : values) {
+                embedding.pushDouble(value);
+            }
+            promise.resolve(embedding);
+        });
+    }
+
+    /**
+     * Install global.LeafraSDKJSI; call once from JS on startup (returns false without a JS runtime,
+     * e.g. when debugging in a remote JS engine).
+     */
+    @ReactMethod(isBlockingSynchronousMethod = true)
+    public boolean install() {
+        ReactApplicationContext context = getReactApplicationContext();
+        long runtimePointer = context.getJavaScriptContextHolder().get();
+        CallInvokerHolderImpl callInvoker = (CallInvokerHolderImpl) context.getCatalystInstance().getJSCallInvokerHolder();
+        if (runtimePointer == 0 || callInvoker == null) {
+            return false;
+        }
+        return LeafraSDKNative.nativeInstallJSI(handle, runtimePointer, callInvoker);
+    }
+
+    private void emit(String eventName, WritableMap body) {
+        ReactApplicationContext context = getReactApplicationContext();
+        if (context.hasActiveReactInstance()) {
+            context.getJSModule(DeviceEventManagerModule.RCTDeviceEventEmitter.class).emit(eventName, body);
+        }
+    }
+
+    private static void settle(Promise promise, String errorCode, int result, Object value) {
+        if (result == 0) {
+            promise.resolve(value);
+        } else {
+            promise.reject(errorCode, "LeafraSDK call failed with code " + result);
+        }
+    }
+
+    private static WritableMap toSearchResponse(int result, SearchResults results) {
+        WritableArray array = Arguments.createArray();
+        int count = results != null ? results.size() : 0;
+        for (int i = 0; i < count; ++i) {
+            WritableMap item = Arguments.createMap();
+            item.putDouble("id", results.ids[i]);
+            item.putDouble("distance", results.distances[i]);
+            if (results.docIds[i] != -1) {
+                item.putDouble("docId", results.docIds[i]);
+            }
+            if (results.chunkIndices[i] != -1) {
+                item.putInt("chunkIndex", results.chunkIndices[i]);
+            }
+            if (results.pageNumbers[i] != -1) {
+                item.putInt("pageNumber", results.pageNumbers[i]);
+            }
+            if (results.textStarts[i] != -1 && results.textEnds[i] != -1) {
+                item.putDouble("textStart", results.textStarts[i]);
+                item.putDouble("textEnd", results.textEnds[i]);
+            }
+            if (results.pageTextStarts[i] != -1) {
+                item.putDouble("pageTextStart", results.pageTextStarts[i]);
+            }
+            if (results.contents[i] != null) {
+                item.putString("content", results.contents[i]);
+            }
+            if (results.filenames[i] != null) {
+                item.putString("filename", results.filenames[i]);
+            }
+            array.pushMap(item);
+        }
+        WritableMap map = Arguments.createMap();
+        map.putInt("result", result);
+        map.putArray("results", array);
+        return map;
+    }
+
+    private static String[] toPaths(ReadableArray fileUrls) {
+        String[] paths = new String[fileUrls.size()];
+        for (int i = 0; i < paths.length; ++i) {
+            String url = fileUrls.getString(i);
+            paths[i] = url.startsWith("file://") ? url.substring("file://".length()) : url;
+        }
+        return paths;
+    }
+
+    // Nested JS objects become dotted keys ("llm.n_ctx"), matching LeafraConfigEntries.cpp
+    private static void flattenConfig(ReadableMap map, String prefix, List<String> keys, List<String> values) {
+        ReadableMapKeySetIterator iterator = map.keySetIterator();
+        while (iterator.hasNextKey()) {
+            String key = iterator.nextKey();
+            String path = prefix + key;
+            switch (map.getType(key)) {
+                case Map:
+                    flattenConfig(map.getMap(key), path + ".", keys, values);
+                    break;
+                case Boolean:
+                    keys.add(path);
+                    values.add(map.getBoolean(key) ? "true" : "false");
+                    break;
+                case Number: {
+                    double number = map.getDouble(key);
+                    keys.add(path);
+                    values.add(number == Math.rint(number) && Math.abs(number) < 1e15 ? Long.toString((long) number) : Double.toString(number));
+                    break;
+                }
+                case String:
+                    keys.add(path);
+                    values.add(map.getString(key));
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
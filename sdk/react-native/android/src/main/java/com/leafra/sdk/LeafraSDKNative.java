@@ -0,0 +1,40 @@
+package com.leafra.sdk;
+
+import com.facebook.react.turbomodule.core.CallInvokerHolderImpl;
+
+/**
+ * JNI entry points of libLeafraSDKAndroid. Handles are owned by LeafraSDKModule.
+ */
+final class LeafraSDKNative {
+    static {
+        System.loadLibrary("LeafraSDKAndroid");
+    }
+
+    private LeafraSDKNative() {}
+
+    static native long nativeCreate();
+    static native void nativeDestroy(long handle);
+
+    /** Config is passed flattened: dotted keys ("embedding_model_config.model_path") and string values. */
+    static native void nativeInitialize(long handle, String[] keys, String[] values, NativeCallback callback);
+    static native void nativeShutdown(long handle, NativeCallback callback);
+    static native boolean nativeIsInitialized(long handle);
+    static native String nativeGetVersion();
+    static native String nativeGetPlatform();
+
+    static native void nativeProcessUserFiles(long handle, String[] paths, NativeCallback callback);
+    static native boolean nativeProcessUserFilesAsync(long handle, String[] paths, ProgressListener progress, NativeCallback callback);
+    static native void nativeCancelUserFileProcessing(long handle);
+
+    /** Runs on the SDK worker pool; critical also gives up the LLM. */
+    static native void nativeHandleMemoryPressure(long handle, boolean critical);
+
+    /** Payload: SearchResults */
+    static native void nativeSemanticSearch(long handle, String query, int maxResults, NativeCallback callback);
+    /** Payload: SearchResults */
+    static native void nativeSemanticSearchWithLLM(long handle, String query, int maxResults, TokenListener listener, NativeCallback callback);
+    /** Payload: native-order direct ByteBuffer of floats */
+    static native void nativeEmbedQuery(long handle, String query, NativeCallback callback);
+
+    static native boolean nativeInstallJSI(long handle, long runtimePointer, CallInvokerHolderImpl callInvokerHolder);
+}
@@ -0,0 +1,12 @@
+package com.leafra.sdk;
+
+/**
+ * Completion of an asynchronous native call, invoked on an SDK worker thread.
+ */
+public interface NativeCallback {
+    /**
+     * @param result  LeafraSDK ResultCode (0 = success)
+     * @param payload Call specific result (SearchResults, a direct ByteBuffer or null)
+     */
+    void invoke(int result, Object payload);
+}
@@ -0,0 +1,8 @@
+package com.leafra.sdk;
+
+/**
+ * Per-file ingestion progress, invoked on SDK worker threads.
+ */
+public interface ProgressListener {
+    void onProgress(String filePath, int fileIndex, int totalFiles, String stage, long bytes, int chunks, double elapsedMs);
+}
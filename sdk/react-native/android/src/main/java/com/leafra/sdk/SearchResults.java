@@ -0,0 +1,38 @@
+package com.leafra.sdk;
+
+/**
+ * Semantic search results in column form, filled from native code with one bulk array per field.
+ * Metadata that is unavailable is -1 (numbers) or null (strings).
+ */
+public final class SearchResults {
+    public final long[] ids;
+    public final float[] distances;
+    public final long[] docIds;
+    public final int[] chunkIndices;
+    public final int[] pageNumbers;
+    /** Byte range of each hit's content in its document's extracted text (pages joined by a blank line) */
+    public final long[] textStarts;
+    public final long[] textEnds;
+    /** Where each hit's content starts within its page's text */
+    public final long[] pageTextStarts;
+    public final String[] contents;
+    public final String[] filenames;
+
+    SearchResults(long[] ids, float[] distances, long[] docIds, int[] chunkIndices, int[] pageNumbers,
+                  long[] textStarts, long[] textEnds, long[] pageTextStarts, String[] contents, String[] filenames) {
+        this.ids = ids;
+        this.distances = distances;
+        this.docIds = docIds;
+        this.chunkIndices = chunkIndices;
+        this.pageNumbers = pageNumbers;
+        this.textStarts = textStarts;
+        this.textEnds = textEnds;
+        this.pageTextStarts = pageTextStarts;
+        this.contents = contents;
+        this.filenames = filenames;
+    }
+
+    public int size() {
+        return ids.length;
+    }
+}
@@ -0,0 +1,12 @@
+package com.leafra.sdk;
+
+/**
+ * Receives generated text, one or more tokens per call (batched to at most one call per frame).
+ */
+public interface TokenListener {
+    /**
+     * @param text Newly generated text (always complete UTF-8 characters)
+     * @return false to stop generation
+     */
+    boolean onTokens(String text);
+}
@@ -0,0 +1,309 @@
+#include "LeafraSDKJSI.h"
+#include "LeafraTokenText.h"
+#include "leafra/leafra_core.h"
+#include "leafra/leafra_threadpool.h"
+#include "leafra/logger.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace leafra {
+namespace jsi_bindings {
+
+using namespace facebook;
+
+namespace {
+
+// Resolve / reject of one JS Promise. JS values may only be touched (and destroyed) on the JS thread.
+struct PromiseHandle {
+    std::shared_ptr<jsi::Function> resolve;
+    std::shared_ptr<jsi::Function> reject;
+};
+
+using PromiseStart = std::function<void(jsi::Runtime& runtime, std::shared_ptr<PromiseHandle> handle)>;
+
+jsi::Value create_promise(jsi::Runtime& runtime, PromiseStart start) {
+    auto executor = jsi::Function::createFromHostFunction(
+        runtime, jsi::PropNameID::forAscii(runtime, "executor"), 2,
+        [start = std::move(start)](jsi::Runtime& rt, const jsi::Value&, const jsi::Value* args, size_t) -> jsi::Value {
+            auto handle = std::make_shared<PromiseHandle>();
+            handle->resolve = std::make_shared<jsi::Function>(args[0].asObject(rt).asFunction(rt));
+            handle->reject = std::make_shared<jsi::Function>(args[1].asObject(rt).asFunction(rt));
+            start(rt, handle);
+            return jsi::Value::undefined();
+        });
+    return runtime.global().getPropertyAsFunction(runtime, "Promise").callAsConstructor(runtime, executor);
+}
+
+void reject_promise(jsi::Runtime& runtime, const PromiseHandle& handle, const std::string& message) {
+    jsi::Value error = runtime.global().getPropertyAsFunction(runtime, "Error")
+                           .callAsConstructor(runtime, jsi::String::createFromUtf8(runtime, message));
+    handle.reject->call(runtime, error);
+}
+
+jsi::Object search_result_object(jsi::Runtime& runtime, const FaissIndex::SearchResult& result) {
+    jsi::Object object(runtime);
+    object.setProperty(runtime, "id", static_cast<double>(result.id));
+    object.setProperty(runtime, "distance", static_cast<double>(result.distance));
+
+    // Optional chunk metadata (same keys as the bridge module)
+    if (result.doc_id != -1) {
+        object.setProperty(runtime, "docId", static_cast<double>(result.doc_id));
+    }
+    if (result.chunk_index != -1) {
+        object.setProperty(runtime, "chunkIndex", result.chunk_index);
+    }
+    if (result.page_number != -1) {
+        object.setProperty(runtime, "pageNumber", result.page_number);
+    }
+    if (!result.content.empty()) {
+        object.setProperty(runtime, "content", jsi::String::createFromUtf8(runtime, result.content));
+    }
+    if (!result.filename.empty()) {
+        object.setProperty(runtime, "filename", jsi::String::createFromUtf8(runtime, result.filename));
+    }
+    return object;
+}
+
+jsi::Object search_response(jsi::Runtime& runtime, ResultCode code, const std::vector<FaissIndex::SearchResult>& results) {
+    jsi::Array array(runtime, results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        array.setValueAtIndex(runtime, i, search_result_object(runtime, results[i]));
+    }
+    jsi::Object response(runtime);
+    response.setProperty(runtime, "result", static_cast<int>(code));
+    response.setProperty(runtime, "results", array);
+    return response;
+}
+
+// Embedding handed to JS as the backing store of an ArrayBuffer (no copy)
+class FloatBuffer : public jsi::MutableBuffer {
+public:
+    explicit FloatBuffer(std::vector<float> values) : values_(std::move(values)) {}
+    size_t size() const override { return values_.size() * sizeof(float); }
+    uint8_t* data() override { return reinterpret_cast<uint8_t*>(values_.data()); }
+
+private:
+    std::vector<float> values_;
+};
+
+/**
+ * @brief Coalesces generated tokens into as few JS calls as the JS thread can take
+ *
+ * push() appends to a pending string and schedules a flush only if none is queued yet, so
+ * tokens produced while the JS thread is busy (rendering the previous ones) are delivered
+ * together in one callback instead of one bridge event per token.
+ */
+class TokenStream : public std::enable_shared_from_this<TokenStream> {
+public:
+    TokenStream(jsi::Runtime& runtime, std::shared_ptr<react::CallInvoker> js_invoker, jsi::Function on_tokens)
+        : runtime_(runtime), js_invoker_(std::move(js_invoker)),
+          on_tokens_(std::make_shared<jsi::Function>(std::move(on_tokens))) {}
+
+    // Generation thread; returns false once JS asked to stop
+    bool push(const std::string& token) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_ += token;
+            if (flush_scheduled_) {
+                return !cancelled_;
+            }
+            flush_scheduled_ = true;
+        }
+        std::shared_ptr<TokenStream> self = shared_from_this();
+        js_invoker_->invokeAsync([self]() { self->flush(false); });
+        return !cancelled_;
+    }
+
+    // JS thread
+    void flush(bool final) {
+        std::string text;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t length = final ? pending_.size() : complete_utf8_length(pending_);
+            text.assign(pending_, 0, length);
+            pending_.erase(0, length);
+            flush_scheduled_ = false;
+        }
+        if (text.empty() || !on_tokens_ || cancelled_) {
+            return;
+        }
+        try {
+            jsi::Value keep_going = on_tokens_->call(runtime_, jsi::String::createFromUtf8(runtime_, text));
+            if (keep_going.isBool() && !keep_going.getBool()) {
+                cancelled_ = true;
+            }
+        } catch (const jsi::JSError& e) {
+            LEAFRA_WARNING() << "onTokens callback threw, stopping generation: " << e.getMessage();
+            cancelled_ = true;
+        }
+    }
+
+    // JS thread: drop the JS callback here rather than on whichever thread releases the stream last
+    void release() {
+        on_tokens_.reset();
+    }
+
+private:
+    jsi::Runtime& runtime_;
+    std::shared_ptr<react::CallInvoker> js_invoker_;
+    std::shared_ptr<jsi::Function> on_tokens_;
+    std::mutex mutex_;
+    std::string pending_;
+    bool flush_scheduled_ = false;
+    std::atomic<bool> cancelled_{false};
+};
+
+class LeafraHostObject : public jsi::HostObject {
+public:
+    LeafraHostObject(std::shared_ptr<react::CallInvoker> js_invoker, std::shared_ptr<LeafraCore> core)
+        : js_invoker_(std::move(js_invoker)), core_(std::move(core)),
+          workers_(std::make_shared<ThreadPool>(2, ThreadQoS::USER_INITIATED, "LeafraJSI")) {}
+
+    jsi::Value get(jsi::Runtime& runtime, const jsi::PropNameID& name) override {
+        std::string property = name.utf8(runtime);
+        if (property == "semanticSearch") {
+            return jsi::Function::createFromHostFunction(runtime, name, 2,
+                [this](jsi::Runtime& rt, const jsi::Value&, const jsi::Value* args, size_t count) {
+                    return semanticSearch(rt, args, count);
+                });
+        }
+        if (property == "semanticSearchWithLLM") {
+            return jsi::Function::createFromHostFunction(runtime, name, 3,
+                [this](jsi::Runtime& rt, const jsi::Value&, const jsi::Value* args, size_t count) {
+                    return semanticSearchWithLLM(rt, args, count);
+                });
+        }
+        if (property == "embedQuery") {
+            return jsi::Function::createFromHostFunction(runtime, name, 1,
+                [this](jsi::Runtime& rt, const jsi::Value&, const jsi::Value* args, size_t count) {
+                    return embedQuery(rt, args, count);
+                });
+        }
+        return jsi::Value::undefined();
+    }
+
+    std::vector<jsi::PropNameID> getPropertyNames(jsi::Runtime& runtime) override {
+        std::vector<jsi::PropNameID> names;
+        names.push_back(jsi::PropNameID::forAscii(runtime, "semanticSearch"));
+        names.push_back(jsi::PropNameID::forAscii(runtime, "semanticSearchWithLLM"));
+        names.push_back(jsi::PropNameID::forAscii(runtime, "embedQuery"));
+        return names;
+    }
+
+private:
+    /**
+     * @brief Run work on a native thread and settle the promise on the JS thread with what it returns
+     *
+     * work runs off the JS thread and returns a settle step, which runs on the JS thread.
+     */
+    using SettleStep = std::function<void(jsi::Runtime& runtime, const PromiseHandle& handle)>;
+
+    jsi::Value runAsync(jsi::Runtime& runtime, std::function<SettleStep()> work) {
+        std::shared_ptr<react::CallInvoker> js_invoker = js_invoker_;
+        std::shared_ptr<ThreadPool> workers = workers_;
+        return create_promise(runtime, [js_invoker, workers, work](jsi::Runtime& rt, std::shared_ptr<PromiseHandle> handle) {
+            jsi::Runtime* target = &rt;
+            bool submitted = workers->submit([js_invoker, work, target, handle]() mutable {
+                SettleStep settle;
+                try {
+                    settle = work();
+                } catch (const std::exception& e) {
+                    std::string message = e.what();
+                    settle = [message](jsi::Runtime& runtime, const PromiseHandle& promise) { reject_promise(runtime, promise, message); };
+                }
+                // The handle moves to the JS thread, so its JS functions are released there
+                js_invoker->invokeAsync([settle, target, handle = std::move(handle)]() { settle(*target, *handle); });
+            });
+            if (!submitted) {
+                reject_promise(rt, *handle, "LeafraSDK is shutting down");
+            }
+        });
+    }
+
+    jsi::Value semanticSearch(jsi::Runtime& runtime, const jsi::Value* args, size_t count) {
+        if (count < 2 || !args[0].isString() || !args[1].isNumber()) {
+            throw jsi::JSError(runtime, "semanticSearch(query, maxResults) expects a string and a number");
+        }
+        std::string query = args[0].asString(runtime).utf8(runtime);
+        int max_results = static_cast<int>(args[1].asNumber());
+        std::shared_ptr<LeafraCore> core = core_;
+
+        return runAsync(runtime, [core, query, max_results]() -> SettleStep {
+            std::vector<FaissIndex::SearchResult> results;
+            ResultCode code = core->semantic_search(query, max_results, results);
+            return [code, results = std::move(results)](jsi::Runtime& rt, const PromiseHandle& handle) {
+                if (code != ResultCode::SUCCESS) {
+                    reject_promise(rt, handle, "Semantic search failed (result " + std::to_string(static_cast<int>(code)) + ")");
+                    return;
+                }
+                handle.resolve->call(rt, search_response(rt, code, results));
+            };
+        });
+    }
+
+    jsi::Value semanticSearchWithLLM(jsi::Runtime& runtime, const jsi::Value* args, size_t count) {
+        if (count < 3 || !args[0].isString() || !args[1].isNumber() || !args[2].isObject() || !args[2].asObject(runtime).isFunction(runtime)) {
+            throw jsi::JSError(runtime, "semanticSearchWithLLM(query, maxResults, onTokens) expects a string, a number and a function");
+        }
+        std::string query = args[0].asString(runtime).utf8(runtime);
+        int max_results = static_cast<int>(args[1].asNumber());
+        auto stream = std::make_shared<TokenStream>(runtime, js_invoker_, args[2].asObject(runtime).asFunction(runtime));
+        std::shared_ptr<LeafraCore> core = core_;
+
+        return runAsync(runtime, [core, query, max_results, stream]() -> SettleStep {
+            std::vector<FaissIndex::SearchResult> results;
+            ResultCode code = core->semantic_search_with_llm(query, max_results, results,
+                [stream](const std::string& token, bool) { return stream->push(token); });
+            // Queued after every pending token flush, so JS sees all tokens before the promise settles
+            return [code, results = std::move(results), stream](jsi::Runtime& rt, const PromiseHandle& handle) {
+                stream->flush(true);
+                stream->release();
+                if (code != ResultCode::SUCCESS) {
+                    reject_promise(rt, handle, "Semantic search with LLM failed (result " + std::to_string(static_cast<int>(code)) + ")");
+                    return;
+                }
+                handle.resolve->call(rt, search_response(rt, code, results));
+            };
+        });
+    }
+
+    jsi::Value embedQuery(jsi::Runtime& runtime, const jsi::Value* args, size_t count) {
+        if (count < 1 || !args[0].isString()) {
+            throw jsi::JSError(runtime, "embedQuery(query) expects a string");
+        }
+        std::string query = args[0].asString(runtime).utf8(runtime);
+        std::shared_ptr<LeafraCore> core = core_;
+
+        return runAsync(runtime, [core, query]() -> SettleStep {
+            auto embedding = std::make_shared<std::vector<float>>();
+            ResultCode code = core->embed_query(query, *embedding);
+            return [code, embedding](jsi::Runtime& rt, const PromiseHandle& handle) {
+                if (code != ResultCode::SUCCESS) {
+                    reject_promise(rt, handle, "Query embedding failed (result " + std::to_string(static_cast<int>(code)) + ")");
+                    return;
+                }
+                jsi::ArrayBuffer buffer(rt, std::make_shared<FloatBuffer>(std::move(*embedding)));
+                handle.resolve->call(rt, buffer);
+            };
+        });
+    }
+
+    std::shared_ptr<react::CallInvoker> js_invoker_;
+    std::shared_ptr<LeafraCore> core_;
+    std::shared_ptr<ThreadPool> workers_;   // Searches and generations run here, never on the JS thread
+};
+
+} // namespace
+
+void install(jsi::Runtime& runtime, std::shared_ptr<react::CallInvoker> js_invoker, std::shared_ptr<LeafraCore> core) {
+    auto host = std::make_shared<LeafraHostObject>(std::move(js_invoker), std::move(core));
+    runtime.global().setProperty(runtime, "LeafraSDKJSI", jsi::Object::createFromHostObject(runtime, host));
+    LEAFRA_INFO() << "⚡ LeafraSDK JSI bindings installed";
+} //install
+
+} // namespace jsi_bindings
+} // namespace leafra
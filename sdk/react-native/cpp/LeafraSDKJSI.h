@@ -0,0 +1,37 @@
+#pragma once
+
+#include <jsi/jsi.h>
+#include <ReactCommon/CallInvoker.h>
+#include <memory>
+
+namespace leafra {
+
+class LeafraCore;
+
+namespace jsi_bindings {
+
+/**
+ * @brief Install the `LeafraSDKJSI` object on the JS global
+ *
+ * JSI fast path next to the bridge module: results are created as JS values straight from
+ * the C++ structs (no NSDictionary / NSArray boxing), embeddings come back as ArrayBuffers
+ * over the C++ vector itself, and generated tokens are streamed through a coalesced callback
+ * (all tokens produced while the JS thread was busy arrive in one call).
+ *
+ * All methods return Promises; the work runs on a small pool of native threads and results
+ * are settled on the JS thread through js_invoker.
+ *
+ * global.LeafraSDKJSI.semanticSearch(query, maxResults) -> Promise<{result, results}>
+ * global.LeafraSDKJSI.semanticSearchWithLLM(query, maxResults, onTokens) -> Promise<{result, results}>
+ *     onTokens(text) receives one or more tokens per call; returning false stops generation
+ * global.LeafraSDKJSI.embedQuery(query) -> Promise<ArrayBuffer> (view it as a Float32Array)
+ *
+ * @param runtime JS runtime (call on the JS thread)
+ * @param js_invoker Schedules work on the JS thread
+ * @param core SDK instance shared with the bridge module
+ */
+void install(facebook::jsi::Runtime& runtime, std::shared_ptr<facebook::react::CallInvoker> js_invoker,
+             std::shared_ptr<LeafraCore> core);
+
+} // namespace jsi_bindings
+} // namespace leafra
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+
+namespace leafra {
+
+/**
+ * @brief Length of text without a trailing, still incomplete UTF-8 sequence
+ *
+ * Tokens can end in the middle of a multi-byte character; streaming bindings deliver
+ * the complete prefix and keep the tail until the next token completes it.
+ */
+inline size_t complete_utf8_length(const std::string& text) {
+    size_t lead = text.size();
+    size_t continuation = 0;
+    while (lead > 0 && continuation < 3 && (static_cast<unsigned char>(text[lead - 1]) & 0xC0) == 0x80) {
+        lead--;
+        continuation++;
+    }
+    if (lead == 0) {
+        return text.size();
+    }
+    unsigned char byte = static_cast<unsigned char>(text[lead - 1]);
+    size_t expected = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+    return expected > continuation + 1 ? lead - 1 : text.size();
+}
+
+} // namespace leafra
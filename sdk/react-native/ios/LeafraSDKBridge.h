@@ -2,6 +2,11 @@
 
 #import <Foundation/Foundation.h>
 
+#ifdef __cplusplus
+#include <memory>
+namespace leafra { class LeafraCore; }
+#endif
+
 /**
  * @brief Bridge class between Objective-C and C++ LeafraSDK
  * 
@@ -11,6 +16,8 @@
 @interface LeafraSDKBridge : NSObject
 
 typedef void (^EventCallback)(NSString *message);
+typedef void (^IngestionProgressCallback)(NSDictionary *progress);
+typedef void (^IngestionCompletionCallback)(NSDictionary *result);
 
 /**
  * @brief Initialize the SDK with configuration
@@ -61,6 +68,37 @@ typedef void (^EventCallback)(NSString *message);
  */
 - (NSDictionary *)processUserFiles:(NSArray<NSString *> *)fileUrls error:(NSError **)error;
 
+/**
+ * @brief Process user files in the background without blocking the calling thread
+ * @param fileUrls Array of file URL strings to process
+ * @param progress Block called with per-file progress dictionaries (stage, bytes, chunks, elapsedMs)
+ * @param completion Block called once with the final result dictionary
+ * @param error Error pointer for error handling
+ * @return YES if the job was started, NO otherwise
+ */
+- (BOOL)processUserFilesAsync:(NSArray<NSString *> *)fileUrls
+                     progress:(IngestionProgressCallback)progress
+                   completion:(IngestionCompletionCallback)completion
+                        error:(NSError **)error;
+
+/**
+ * @brief Index every supported document under a directory (enumerated natively, no per-file URLs)
+ * @param directoryUrl Directory URL or path
+ * @param extensions Extensions to include, e.g. @[@"pdf"] (nil or empty = all supported)
+ * @param recursive Descend into subdirectories
+ * @param error Error pointer for error handling
+ * @return Dictionary containing result code and message
+ */
+- (NSDictionary *)processDirectory:(NSString *)directoryUrl
+                        extensions:(NSArray<NSString *> *)extensions
+                         recursive:(BOOL)recursive
+                             error:(NSError **)error;
+
+/**
+ * @brief Cancel the running background file processing job (if any)
+ */
+- (void)cancelUserFileProcessing;
+
 /**
  * @brief Calculate distance between two 2D points
  * @param p1 First point dictionary with x, y keys
@@ -120,4 +158,12 @@ typedef void (^EventCallback)(NSString *message);
  */
 - (void)setEventCallback:(EventCallback)callback;
 
+#ifdef __cplusplus
+/**
+ * @brief C++ core shared with the JSI bindings
+ * @return The SDK instance this bridge drives
+ */
+- (std::shared_ptr<leafra::LeafraCore>)core;
+#endif
+
 @end 
\ No newline at end of file
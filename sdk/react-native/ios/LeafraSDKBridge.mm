@@ -7,11 +7,16 @@
 
 #include <memory>
 
+#if TARGET_OS_IPHONE
+#import <UIKit/UIKit.h>
+#endif
+
 @interface LeafraSDKBridge()
 @property (nonatomic, assign) std::shared_ptr<leafra::LeafraCore> coreSDK;
 @property (nonatomic, assign) std::shared_ptr<leafra::MathUtils> mathUtils;
 @property (nonatomic, assign) std::shared_ptr<leafra::DataProcessor> dataProcessor;
 @property (nonatomic, copy) void (^eventCallback)(NSString *message);
+@property (nonatomic, assign) std::shared_ptr<leafra::IngestionJob> ingestionJob;
 @end
 
 @implementation LeafraSDKBridge
@@ -37,11 +42,20 @@
                 });
             }
         });
+        
+#if TARGET_OS_IPHONE
+        // Give back caches, then the LLM, before iOS kills the app for holding a multi-GB model
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(handleMemoryWarning:)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
+#endif
     }
     return self;
 }
 
 - (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
     // Clear the callback to prevent crashes
     if (_coreSDK) {
         _coreSDK->set_event_callback(nullptr);
@@ -49,6 +63,17 @@
     _eventCallback = nil;
 }
 
+- (void)handleMemoryWarning:(NSNotification *)notification {
+    std::shared_ptr<leafra::LeafraCore> core = _coreSDK;
+    if (!core) {
+        return;
+    }
+    // Unloading waits for running generations, so keep it off the main thread
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        core->handle_memory_pressure();
+    });
+}
+
 #pragma mark - Helper Methods
 
 - (NSString *)resolveFrameworkResourcePath:(NSString *)frameworkRelativePath {
@@ -104,15 +129,75 @@
     if (dict[@"debug_mode"]) {
         config.debug_mode = [dict[@"debug_mode"] boolValue];
     }
+    if (dict[@"async_logging"]) {
+        config.async_logging = [dict[@"async_logging"] boolValue];
+    }
+    if (dict[@"log_queue_capacity"]) {
+        config.log_queue_capacity = [dict[@"log_queue_capacity"] intValue];
+    }
+    if (dict[@"log_drop_when_full"]) {
+        config.log_drop_when_full = [dict[@"log_drop_when_full"] boolValue];
+    }
+    if (dict[@"async_events"]) {
+        config.async_events = [dict[@"async_events"] boolValue];
+    }
+    if (dict[@"event_queue_capacity"]) {
+        config.event_queue_capacity = [dict[@"event_queue_capacity"] intValue];
+    }
+    if (dict[@"coalesce_progress_events"]) {
+        config.coalesce_progress_events = [dict[@"coalesce_progress_events"] boolValue];
+    }
+    if (dict[@"trace_enabled"]) {
+        config.trace_enabled = [dict[@"trace_enabled"] boolValue];
+    }
+    if (dict[@"trace_max_events_per_thread"]) {
+        config.trace_max_events_per_thread = [dict[@"trace_max_events_per_thread"] intValue];
+    }
+    if (dict[@"memory_budget_mb"]) {
+        config.memory_budget_mb = [dict[@"memory_budget_mb"] intValue];
+    }
     if (dict[@"max_threads"]) {
         config.max_threads = [dict[@"max_threads"] intValue];
     }
+    if (dict[@"icu_data_path"]) {
+        config.icu_data_path = [dict[@"icu_data_path"] UTF8String];
+    }
+    if (dict[@"large_pages"]) {
+        config.large_pages = [dict[@"large_pages"] UTF8String];
+    }
+    if (dict[@"query_threads"]) {
+        config.query_threads = [dict[@"query_threads"] intValue];
+    }
+    if (dict[@"watch_debounce_ms"]) {
+        config.watch_debounce_ms = [dict[@"watch_debounce_ms"] intValue];
+    }
+    if (dict[@"background_load"]) {
+        config.background_load = [dict[@"background_load"] boolValue];
+    }
+    if (dict[@"prefetch_after_initialize"]) {
+        config.prefetch_after_initialize = [dict[@"prefetch_after_initialize"] boolValue];
+    }
+    if (dict[@"prefetch_hot_chunks"]) {
+        config.prefetch_hot_chunks = [dict[@"prefetch_hot_chunks"] intValue];
+    }
     if (dict[@"buffer_size"]) {
         config.buffer_size = [dict[@"buffer_size"] unsignedIntegerValue];
     }
     if (dict[@"leafra_document_database_name"]) {
         config.leafra_document_database_name = [dict[@"leafra_document_database_name"] UTF8String];
     }
+    if (dict[@"storage_directory"]) {
+        config.storage_directory = [dict[@"storage_directory"] UTF8String];
+    }
+    if (dict[@"attach_read_only"]) {
+        config.attach_read_only = [dict[@"attach_read_only"] boolValue];
+    }
+    if (dict[@"attach_refresh_interval_ms"]) {
+        config.attach_refresh_interval_ms = [dict[@"attach_refresh_interval_ms"] intValue];
+    }
+    if (dict[@"device_profile_name"]) {
+        config.device_profile_name = [dict[@"device_profile_name"] UTF8String];
+    }
     
     // Chunking configuration
     if (dict[@"chunking"]) {
@@ -132,14 +217,28 @@
         if (chunkingDict[@"include_metadata"]) {
             config.chunking.include_metadata = [chunkingDict[@"include_metadata"] boolValue];
         }
+        if (chunkingDict[@"parallel_segment_bytes"]) {
+            config.chunking.parallel_segment_bytes = [chunkingDict[@"parallel_segment_bytes"] unsignedIntegerValue];
+        }
+        if (chunkingDict[@"max_chunks"]) {
+            config.chunking.max_chunks = [chunkingDict[@"max_chunks"] unsignedIntegerValue];
+        }
         if (chunkingDict[@"size_unit"]) {
             NSString *sizeUnit = chunkingDict[@"size_unit"];
             if ([sizeUnit isEqualToString:@"TOKENS"]) {
                 config.chunking.size_unit = leafra::ChunkSizeUnit::TOKENS;
+            } else if ([sizeUnit isEqualToString:@"EXACT_TOKENS"]) {
+                config.chunking.size_unit = leafra::ChunkSizeUnit::EXACT_TOKENS;
             } else {
                 config.chunking.size_unit = leafra::ChunkSizeUnit::CHARACTERS;
             }
         }
+        if (chunkingDict[@"strategy"]) {
+            NSString *strategy = chunkingDict[@"strategy"];
+            config.chunking.strategy = [strategy isEqualToString:@"SENTENCE"]
+                ? leafra::ChunkingStrategy::SENTENCE
+                : leafra::ChunkingStrategy::FIXED;
+        }
         if (chunkingDict[@"token_method"]) {
             NSString *tokenMethod = chunkingDict[@"token_method"];
             if ([tokenMethod isEqualToString:@"SIMPLE"]) {
@@ -159,6 +258,71 @@
         }
     }
     
+    // Parsing configuration
+    if (dict[@"parsing"]) {
+        NSDictionary *parsingDict = dict[@"parsing"];
+        if (parsingDict[@"pdf_parallel_min_pages"]) {
+            config.parsing.pdf_parallel_min_pages = [parsingDict[@"pdf_parallel_min_pages"] intValue];
+        }
+        if (parsingDict[@"pdf_max_document_handles"]) {
+            config.parsing.pdf_max_document_handles = [parsingDict[@"pdf_max_document_handles"] intValue];
+        }
+        if (parsingDict[@"pdf_strip_boilerplate"]) {
+            config.parsing.pdf_strip_boilerplate = [parsingDict[@"pdf_strip_boilerplate"] boolValue];
+        }
+        if (parsingDict[@"pdf_boilerplate_min_ratio"]) {
+            config.parsing.pdf_boilerplate_min_ratio = [parsingDict[@"pdf_boilerplate_min_ratio"] floatValue];
+        }
+        if (parsingDict[@"pdf_boilerplate_min_pages"]) {
+            config.parsing.pdf_boilerplate_min_pages = [parsingDict[@"pdf_boilerplate_min_pages"] intValue];
+        }
+        if (parsingDict[@"pdf_boilerplate_edge_lines"]) {
+            config.parsing.pdf_boilerplate_edge_lines = [parsingDict[@"pdf_boilerplate_edge_lines"] intValue];
+        }
+        if (parsingDict[@"text_page_bytes"]) {
+            config.parsing.text_page_bytes = [parsingDict[@"text_page_bytes"] intValue];
+        }
+        if (parsingDict[@"sheet_page_bytes"]) {
+            config.parsing.sheet_page_bytes = [parsingDict[@"sheet_page_bytes"] intValue];
+        }
+        if (parsingDict[@"cache_enabled"]) {
+            config.parsing.cache_enabled = [parsingDict[@"cache_enabled"] boolValue];
+        }
+        if (parsingDict[@"cache_max_mb"]) {
+            config.parsing.cache_max_mb = [parsingDict[@"cache_max_mb"] intValue];
+        }
+        if (parsingDict[@"normalize_text"]) {
+            config.parsing.normalize_text = [parsingDict[@"normalize_text"] boolValue];
+        }
+        if (parsingDict[@"normalize_nfkc"]) {
+            config.parsing.normalize_nfkc = [parsingDict[@"normalize_nfkc"] boolValue];
+        }
+        if (parsingDict[@"normalize_whitespace"]) {
+            config.parsing.normalize_whitespace = [parsingDict[@"normalize_whitespace"] boolValue];
+        }
+        if (parsingDict[@"normalize_dehyphenate"]) {
+            config.parsing.normalize_dehyphenate = [parsingDict[@"normalize_dehyphenate"] boolValue];
+        }
+        if (parsingDict[@"normalize_strip_control"]) {
+            config.parsing.normalize_strip_control = [parsingDict[@"normalize_strip_control"] boolValue];
+        }
+        if (parsingDict[@"max_pages"]) {
+            config.parsing.max_pages = [parsingDict[@"max_pages"] intValue];
+        }
+        if (parsingDict[@"max_text_mb"]) {
+            config.parsing.max_text_mb = [parsingDict[@"max_text_mb"] intValue];
+        }
+        if (parsingDict[@"page_timeout_ms"]) {
+            config.parsing.page_timeout_ms = [parsingDict[@"page_timeout_ms"] intValue];
+        }
+        if (parsingDict[@"document_timeout_ms"]) {
+            config.parsing.document_timeout_ms = [parsingDict[@"document_timeout_ms"] intValue];
+        }
+        if (parsingDict[@"skip_over_limit"]) {
+            config.parsing.skip_over_limit = [parsingDict[@"skip_over_limit"] boolValue];
+        }
+    }
+    
     // Tokenizer configuration
     if (dict[@"tokenizer"]) {
         NSDictionary *tokenizerDict = dict[@"tokenizer"];
@@ -191,9 +355,33 @@
             NSString *resolvedPath = [self resolveFrameworkResourcePath:embeddingDict[@"model_path"]];
             config.embedding_inference.model_path = [resolvedPath UTF8String];
         }
+        if (embeddingDict[@"pooling"]) {
+            config.embedding_inference.pooling = [embeddingDict[@"pooling"] UTF8String];
+        }
+        if (embeddingDict[@"pipeline_depth"]) {
+            config.embedding_inference.pipeline_depth = [embeddingDict[@"pipeline_depth"] intValue];
+        }
+        if (embeddingDict[@"cache_enabled"]) {
+            config.embedding_inference.cache_enabled = [embeddingDict[@"cache_enabled"] boolValue];
+        }
+        if (embeddingDict[@"cache_max_entries"]) {
+            config.embedding_inference.cache_max_entries = [embeddingDict[@"cache_max_entries"] intValue];
+        }
         if (embeddingDict[@"coreml_compute_units"]) {
             config.embedding_inference.coreml_compute_units = [embeddingDict[@"coreml_compute_units"] UTF8String];
         }
+        if (embeddingDict[@"coreml_cache_compiled"]) {
+            config.embedding_inference.coreml_cache_compiled = [embeddingDict[@"coreml_cache_compiled"] boolValue];
+        }
+        if (embeddingDict[@"coreml_prewarm"]) {
+            config.embedding_inference.coreml_prewarm = [embeddingDict[@"coreml_prewarm"] boolValue];
+        }
+        if (embeddingDict[@"query_instance"]) {
+            config.embedding_inference.query_instance = [embeddingDict[@"query_instance"] boolValue];
+        }
+        if (embeddingDict[@"query_coreml_compute_units"]) {
+            config.embedding_inference.query_coreml_compute_units = [embeddingDict[@"query_coreml_compute_units"] UTF8String];
+        }
         if (embeddingDict[@"tflite_enable_coreml_delegate"]) {
             config.embedding_inference.tflite_enable_coreml_delegate = [embeddingDict[@"tflite_enable_coreml_delegate"] boolValue];
         }
@@ -209,6 +397,15 @@
         if (embeddingDict[@"tflite_use_nnapi"]) {
             config.embedding_inference.tflite_use_nnapi = [embeddingDict[@"tflite_use_nnapi"] boolValue];
         }
+        if (embeddingDict[@"tflite_delegate_cache_dir"]) {
+            config.embedding_inference.tflite_delegate_cache_dir = [embeddingDict[@"tflite_delegate_cache_dir"] UTF8String];
+        }
+        if (embeddingDict[@"executorch_method"]) {
+            config.embedding_inference.executorch_method = [embeddingDict[@"executorch_method"] UTF8String];
+        }
+        if (embeddingDict[@"executorch_num_threads"]) {
+            config.embedding_inference.executorch_num_threads = [embeddingDict[@"executorch_num_threads"] intValue];
+        }
     }
     
     // Vector search configuration
@@ -226,6 +423,9 @@
         if (vectorDict[@"metric"]) {
             config.vector_search.metric = [vectorDict[@"metric"] UTF8String];
         }
+        if (vectorDict[@"index_dimension"]) {
+            config.vector_search.index_dimension = [vectorDict[@"index_dimension"] intValue];
+        }
         if (vectorDict[@"nlist"]) {
             config.vector_search.nlist = [vectorDict[@"nlist"] intValue];
         }
@@ -241,9 +441,57 @@
         if (vectorDict[@"hnsw_m"]) {
             config.vector_search.hnsw_m = [vectorDict[@"hnsw_m"] intValue];
         }
+        if (vectorDict[@"ef_search"]) {
+            config.vector_search.ef_search = [vectorDict[@"ef_search"] intValue];
+        }
         if (vectorDict[@"lsh_nbits"]) {
             config.vector_search.lsh_nbits = [vectorDict[@"lsh_nbits"] intValue];
         }
+        if (vectorDict[@"ivf_train_min_vectors"]) {
+            config.vector_search.ivf_train_min_vectors = [vectorDict[@"ivf_train_min_vectors"] intValue];
+        }
+        if (vectorDict[@"auto_ivf_threshold"]) {
+            config.vector_search.auto_ivf_threshold = [vectorDict[@"auto_ivf_threshold"] intValue];
+        }
+        if (vectorDict[@"auto_ivf_type"]) {
+            config.vector_search.auto_ivf_type = [vectorDict[@"auto_ivf_type"] UTF8String];
+        }
+        if (vectorDict[@"rerank_factor"]) {
+            config.vector_search.rerank_factor = [vectorDict[@"rerank_factor"] intValue];
+        }
+        if (vectorDict[@"binary_rerank_candidates"]) {
+            config.vector_search.binary_rerank_candidates = [vectorDict[@"binary_rerank_candidates"] intValue];
+        }
+        if (vectorDict[@"gpu_flat_search"]) {
+            config.vector_search.gpu_flat_search = [vectorDict[@"gpu_flat_search"] boolValue];
+        }
+        if (vectorDict[@"gpu_min_vectors"]) {
+            config.vector_search.gpu_min_vectors = [vectorDict[@"gpu_min_vectors"] intValue];
+        }
+        if (vectorDict[@"faiss_threads"]) {
+            config.vector_search.faiss_threads = [vectorDict[@"faiss_threads"] intValue];
+        }
+        if (vectorDict[@"bulk_add_vectors"]) {
+            config.vector_search.bulk_add_vectors = [vectorDict[@"bulk_add_vectors"] intValue];
+        }
+        if (vectorDict[@"hot_index"]) {
+            config.vector_search.hot_index = [vectorDict[@"hot_index"] boolValue];
+        }
+        if (vectorDict[@"hot_merge_interval_ms"]) {
+            config.vector_search.hot_merge_interval_ms = [vectorDict[@"hot_merge_interval_ms"] intValue];
+        }
+        if (vectorDict[@"document_prefilter"]) {
+            config.vector_search.document_prefilter = [vectorDict[@"document_prefilter"] intValue];
+        }
+        if (vectorDict[@"exact_scan_max_chunks"]) {
+            config.vector_search.exact_scan_max_chunks = [vectorDict[@"exact_scan_max_chunks"] intValue];
+        }
+        if (vectorDict[@"query_batch_size"]) {
+            config.vector_search.query_batch_size = [vectorDict[@"query_batch_size"] intValue];
+        }
+        if (vectorDict[@"query_batch_window_us"]) {
+            config.vector_search.query_batch_window_us = [vectorDict[@"query_batch_window_us"] intValue];
+        }
         if (vectorDict[@"index_definition"]) {
             config.vector_search.index_definition = [vectorDict[@"index_definition"] UTF8String];
         }
@@ -254,7 +502,87 @@
             config.vector_search.auto_load = [vectorDict[@"auto_load"] boolValue];
         }
     }
-    
+
+    // Near-duplicate chunk configuration
+    if (dict[@"near_duplicates"]) {
+        NSDictionary *nearDuplicatesDict = dict[@"near_duplicates"];
+        if (nearDuplicatesDict[@"enabled"]) {
+            config.near_duplicates.enabled = [nearDuplicatesDict[@"enabled"] boolValue];
+        }
+        if (nearDuplicatesDict[@"policy"]) {
+            config.near_duplicates.policy = [nearDuplicatesDict[@"policy"] UTF8String];
+        }
+        if (nearDuplicatesDict[@"max_distance"]) {
+            config.near_duplicates.max_distance = [nearDuplicatesDict[@"max_distance"] intValue];
+        }
+        if (nearDuplicatesDict[@"shingle_words"]) {
+            config.near_duplicates.shingle_words = [nearDuplicatesDict[@"shingle_words"] intValue];
+        }
+        if (nearDuplicatesDict[@"min_chars"]) {
+            config.near_duplicates.min_chars = [nearDuplicatesDict[@"min_chars"] intValue];
+        }
+    }
+
+    // Chunk quality filter configuration
+    if (dict[@"chunk_quality"]) {
+        NSDictionary *chunkQualityDict = dict[@"chunk_quality"];
+        if (chunkQualityDict[@"enabled"]) {
+            config.chunk_quality.enabled = [chunkQualityDict[@"enabled"] boolValue];
+        }
+        if (chunkQualityDict[@"min_chars"]) {
+            config.chunk_quality.min_chars = [chunkQualityDict[@"min_chars"] intValue];
+        }
+        if (chunkQualityDict[@"min_alpha_ratio"]) {
+            config.chunk_quality.min_alpha_ratio = [chunkQualityDict[@"min_alpha_ratio"] floatValue];
+        }
+        if (chunkQualityDict[@"max_tokens_per_byte"]) {
+            config.chunk_quality.max_tokens_per_byte = [chunkQualityDict[@"max_tokens_per_byte"] floatValue];
+        }
+        if (chunkQualityDict[@"min_entropy"]) {
+            config.chunk_quality.min_entropy = [chunkQualityDict[@"min_entropy"] floatValue];
+        }
+        if (chunkQualityDict[@"max_entropy"]) {
+            config.chunk_quality.max_entropy = [chunkQualityDict[@"max_entropy"] floatValue];
+        }
+    }
+
+    // Throughput governor configuration
+    if (dict[@"governor"]) {
+        NSDictionary *governorDict = dict[@"governor"];
+        if (governorDict[@"enabled"]) {
+            config.governor.enabled = [governorDict[@"enabled"] boolValue];
+        }
+        if (governorDict[@"poll_interval_ms"]) {
+            config.governor.poll_interval_ms = [governorDict[@"poll_interval_ms"] intValue];
+        }
+        if (governorDict[@"low_battery_percent"]) {
+            config.governor.low_battery_percent = [governorDict[@"low_battery_percent"] intValue];
+        }
+        if (governorDict[@"interactive_ingest_workers"]) {
+            config.governor.interactive_ingest_workers = [governorDict[@"interactive_ingest_workers"] intValue];
+        }
+    }
+
+    // Admission control configuration
+    if (dict[@"admission"]) {
+        NSDictionary *admissionDict = dict[@"admission"];
+        if (admissionDict[@"enabled"]) {
+            config.admission.enabled = [admissionDict[@"enabled"] boolValue];
+        }
+        if (admissionDict[@"max_concurrent_embeddings"]) {
+            config.admission.max_concurrent_embeddings = [admissionDict[@"max_concurrent_embeddings"] intValue];
+        }
+        if (admissionDict[@"max_concurrent_searches"]) {
+            config.admission.max_concurrent_searches = [admissionDict[@"max_concurrent_searches"] intValue];
+        }
+        if (admissionDict[@"max_concurrent_generations"]) {
+            config.admission.max_concurrent_generations = [admissionDict[@"max_concurrent_generations"] intValue];
+        }
+        if (admissionDict[@"max_queued_requests"]) {
+            config.admission.max_queued_requests = [admissionDict[@"max_queued_requests"] intValue];
+        }
+    }
+
     // LLM configuration
     if (dict[@"llm"]) {
         NSDictionary *llmDict = dict[@"llm"];
@@ -265,6 +593,29 @@
             NSString *resolvedPath = [self resolveFrameworkResourcePath:llmDict[@"model_path"]];
             config.llm.model_path = [resolvedPath UTF8String];
         }
+        if (llmDict[@"draft_model_path"]) {
+            NSString *resolvedDraftPath = [self resolveFrameworkResourcePath:llmDict[@"draft_model_path"]];
+            config.llm.draft_model_path = [resolvedDraftPath UTF8String];
+        }
+        if (llmDict[@"n_draft"]) {
+            config.llm.n_draft = [llmDict[@"n_draft"] intValue];
+        }
+        if (llmDict[@"lookup_ngram"]) {
+            config.llm.lookup_ngram = [llmDict[@"lookup_ngram"] intValue];
+        }
+        if (llmDict[@"low_memory_model_path"]) {
+            NSString *resolvedLowMemoryPath = [self resolveFrameworkResourcePath:llmDict[@"low_memory_model_path"]];
+            config.llm.low_memory_model_path = [resolvedLowMemoryPath UTF8String];
+        }
+        if (llmDict[@"idle_unload_seconds"]) {
+            config.llm.idle_unload_seconds = [llmDict[@"idle_unload_seconds"] intValue];
+        }
+        if (llmDict[@"stream_flush_ms"]) {
+            config.llm.stream_flush_ms = [llmDict[@"stream_flush_ms"] intValue];
+        }
+        if (llmDict[@"stream_flush_tokens"]) {
+            config.llm.stream_flush_tokens = [llmDict[@"stream_flush_tokens"] intValue];
+        }
         if (llmDict[@"framework"]) {
             config.llm.framework = [llmDict[@"framework"] UTF8String];
         }
@@ -274,6 +625,9 @@
         if (llmDict[@"n_predict"]) {
             config.llm.n_predict = [llmDict[@"n_predict"] intValue];
         }
+        if (llmDict[@"max_context_tokens"]) {
+            config.llm.max_context_tokens = [llmDict[@"max_context_tokens"] intValue];
+        }
         if (llmDict[@"n_batch"]) {
             config.llm.n_batch = [llmDict[@"n_batch"] intValue];
         }
@@ -286,6 +640,9 @@
         if (llmDict[@"n_threads_batch"]) {
             config.llm.n_threads_batch = [llmDict[@"n_threads_batch"] intValue];
         }
+        if (llmDict[@"n_seq_max"]) {
+            config.llm.n_seq_max = [llmDict[@"n_seq_max"] intValue];
+        }
         if (llmDict[@"temperature"]) {
             config.llm.temperature = [llmDict[@"temperature"] floatValue];
         }
@@ -313,15 +670,51 @@
         if (llmDict[@"n_gpu_layers"]) {
             config.llm.n_gpu_layers = [llmDict[@"n_gpu_layers"] intValue];
         }
+        if (llmDict[@"gpu_memory_margin_mb"]) {
+            config.llm.gpu_memory_margin_mb = [llmDict[@"gpu_memory_margin_mb"] intValue];
+        }
         if (llmDict[@"use_mmap"]) {
             config.llm.use_mmap = [llmDict[@"use_mmap"] boolValue];
         }
         if (llmDict[@"use_mlock"]) {
             config.llm.use_mlock = [llmDict[@"use_mlock"] boolValue];
         }
+        if (llmDict[@"context_shift"]) {
+            config.llm.context_shift = [llmDict[@"context_shift"] boolValue];
+        }
+        if (llmDict[@"n_keep"]) {
+            config.llm.n_keep = [llmDict[@"n_keep"] intValue];
+        }
+        if (llmDict[@"warmup"]) {
+            config.llm.warmup = [llmDict[@"warmup"] boolValue];
+        }
+        if (llmDict[@"reuse_prompt_cache"]) {
+            config.llm.reuse_prompt_cache = [llmDict[@"reuse_prompt_cache"] boolValue];
+        }
+        if (llmDict[@"prefill_during_retrieval"]) {
+            config.llm.prefill_during_retrieval = [llmDict[@"prefill_during_retrieval"] boolValue];
+        }
+        if (llmDict[@"cache_chunk_tokens"]) {
+            config.llm.cache_chunk_tokens = [llmDict[@"cache_chunk_tokens"] boolValue];
+        }
+        if (llmDict[@"hot_chunk_cache_size"]) {
+            config.llm.hot_chunk_cache_size = [llmDict[@"hot_chunk_cache_size"] intValue];
+        }
+        if (llmDict[@"hot_chunk_min_retrievals"]) {
+            config.llm.hot_chunk_min_retrievals = [llmDict[@"hot_chunk_min_retrievals"] intValue];
+        }
         if (llmDict[@"numa"]) {
             config.llm.numa = [llmDict[@"numa"] boolValue];
         }
+        if (llmDict[@"type_k"]) {
+            config.llm.type_k = [llmDict[@"type_k"] UTF8String];
+        }
+        if (llmDict[@"type_v"]) {
+            config.llm.type_v = [llmDict[@"type_v"] UTF8String];
+        }
+        if (llmDict[@"flash_attn"]) {
+            config.llm.flash_attn = [llmDict[@"flash_attn"] boolValue];
+        }
         if (llmDict[@"system_prompt"]) {
             config.llm.system_prompt = [llmDict[@"system_prompt"] UTF8String];
         }
@@ -454,6 +847,7 @@
     
     // Convert input array to C++ data buffer
     leafra::data_buffer_t inputBuffer;
+    inputBuffer.reserve(input.count);
     for (NSNumber *num in input) {
         inputBuffer.push_back([num unsignedCharValue]);
     }
@@ -477,6 +871,37 @@
     };
 }
 
+- (std::vector<std::string>)filePathsFromUrls:(NSArray<NSString *> *)fileUrls {
+    std::vector<std::string> filePaths;
+    filePaths.reserve(fileUrls.count);
+    for (NSString *urlString in fileUrls) {
+        // Convert file URL to local path
+        NSURL *url = [NSURL URLWithString:urlString];
+        if (url && url.isFileURL) {
+            filePaths.push_back([url.path UTF8String]);
+        } else {
+            // If it's not a file URL, try to use the string directly
+            filePaths.push_back([urlString UTF8String]);
+        }
+    }
+    return filePaths;
+}
+
+- (NSString *)stringFromIngestionStage:(leafra::IngestionStage)stage {
+    switch (stage) {
+        case leafra::IngestionStage::QUEUED: return @"queued";
+        case leafra::IngestionStage::PARSING: return @"parsing";
+        case leafra::IngestionStage::CHUNKING: return @"chunking";
+        case leafra::IngestionStage::TOKENIZING: return @"tokenizing";
+        case leafra::IngestionStage::EMBEDDING: return @"embedding";
+        case leafra::IngestionStage::STORING: return @"storing";
+        case leafra::IngestionStage::COMPLETED: return @"completed";
+        case leafra::IngestionStage::FAILED: return @"failed";
+        case leafra::IngestionStage::CANCELLED: return @"cancelled";
+    }
+    return @"unknown";
+}
+
 - (NSDictionary *)processUserFiles:(NSArray<NSString *> *)fileUrls error:(NSError **)error {
     if (!_coreSDK) {
         if (error) {
@@ -487,19 +912,7 @@
     }
     
     // Convert NSArray of NSString to std::vector<std::string>
-    std::vector<std::string> filePaths;
-    for (NSString *urlString in fileUrls) {
-        // Convert file URL to local path
-        NSURL *url = [NSURL URLWithString:urlString];
-        if (url && url.isFileURL) {
-            std::string path = [url.path UTF8String];
-            filePaths.push_back(path);
-        } else {
-            // If it's not a file URL, try to use the string directly
-            std::string path = [urlString UTF8String];
-            filePaths.push_back(path);
-        }
-    }
+    std::vector<std::string> filePaths = [self filePathsFromUrls:fileUrls];
     
     // Call the C++ SDK method
     leafra::ResultCode result = _coreSDK->process_user_files(filePaths);
@@ -525,6 +938,108 @@
     };
 }
 
+- (BOOL)processUserFilesAsync:(NSArray<NSString *> *)fileUrls
+                     progress:(IngestionProgressCallback)progress
+                   completion:(IngestionCompletionCallback)completion
+                        error:(NSError **)error {
+    if (!_coreSDK || !_coreSDK->is_initialized()) {
+        if (error) {
+            *error = [self errorFromResultCode:leafra::ResultCode::ERROR_INITIALIZATION_FAILED
+                                       message:@"SDK not initialized"];
+        }
+        return NO;
+    }
+    
+    std::vector<std::string> filePaths = [self filePathsFromUrls:fileUrls];
+    NSUInteger fileCount = filePaths.size();
+    
+    IngestionProgressCallback progressBlock = [progress copy];
+    IngestionCompletionCallback completionBlock = [completion copy];
+    LeafraSDKBridge* __weak weakSelf = self;
+    
+    leafra::IngestionOptions options;
+    options.on_progress = [weakSelf, progressBlock](const leafra::IngestionProgress& p) {
+        LeafraSDKBridge* strongSelf = weakSelf;
+        if (!strongSelf || !progressBlock) {
+            return;
+        }
+        NSDictionary *info = @{
+            @"filePath": [NSString stringWithUTF8String:p.file_path.c_str()],
+            @"fileIndex": @(p.file_index),
+            @"totalFiles": @(p.total_files),
+            @"stage": [strongSelf stringFromIngestionStage:p.stage],
+            @"bytes": @(p.bytes),
+            @"chunks": @(p.chunks),
+            @"elapsedMs": @(p.elapsed_ms)
+        };
+        progressBlock(info);
+    };
+    options.on_complete = [completionBlock, fileCount](leafra::ResultCode result) {
+        if (!completionBlock) {
+            return;
+        }
+        NSString *message = @"Failed to process some files";
+        if (result == leafra::ResultCode::SUCCESS) {
+            message = [NSString stringWithFormat:@"Successfully processed %lu files", (unsigned long)fileCount];
+        } else if (result == leafra::ResultCode::ERROR_CANCELLED) {
+            message = @"File processing cancelled";
+        }
+        completionBlock(@{
+            @"result": @((int)result),
+            @"message": message
+        });
+    };
+    
+    // Cancel any previous job; the core serializes ingestion runs anyway
+    if (_ingestionJob && !_ingestionJob->is_done()) {
+        _ingestionJob->cancel();
+    }
+    _ingestionJob = _coreSDK->process_user_files_async(filePaths, options);
+    if (!_ingestionJob) {
+        if (error) {
+            *error = [self errorFromResultCode:leafra::ResultCode::ERROR_PROCESSING_FAILED
+                                       message:@"Failed to start file processing"];
+        }
+        return NO;
+    }
+    return YES;
+}
+
+- (NSDictionary *)processDirectory:(NSString *)directoryUrl
+                        extensions:(NSArray<NSString *> *)extensions
+                         recursive:(BOOL)recursive
+                             error:(NSError **)error {
+    if (!_coreSDK) {
+        if (error) {
+            *error = [self errorFromResultCode:leafra::ResultCode::ERROR_INITIALIZATION_FAILED
+                                       message:@"SDK not initialized"];
+        }
+        return @{@"result": @((int)leafra::ResultCode::ERROR_INITIALIZATION_FAILED), @"message": @"SDK not initialized"};
+    }
+    
+    std::vector<std::string> directory = [self filePathsFromUrls:@[directoryUrl]];
+    std::vector<std::string> filters;
+    for (NSString *extension in extensions) {
+        filters.push_back([extension UTF8String]);
+    }
+    
+    leafra::ResultCode result = _coreSDK->process_directory(directory[0], filters, recursive);
+    if (result != leafra::ResultCode::SUCCESS && error) {
+        *error = [self errorFromResultCode:result message:@"Failed to process directory"];
+    }
+    
+    return @{
+        @"result": @((int)result),
+        @"message": result == leafra::ResultCode::SUCCESS ? @"Successfully processed directory" : @"Failed to process some files"
+    };
+}
+
+- (void)cancelUserFileProcessing {
+    if (_ingestionJob) {
+        _ingestionJob->cancel();
+    }
+}
+
 - (NSNumber *)calculateDistance2D:(NSDictionary *)p1 point2:(NSDictionary *)p2 error:(NSError **)error {
     if (!_mathUtils) {
         if (error) {
@@ -615,6 +1130,13 @@
     if (result.page_number != -1) {
         dict[@"pageNumber"] = @(result.page_number);
     }
+    if (result.text_start != -1 && result.text_end != -1) {
+        dict[@"textStart"] = @(result.text_start);
+        dict[@"textEnd"] = @(result.text_end);
+    }
+    if (result.page_text_start != -1) {
+        dict[@"pageTextStart"] = @(result.page_text_start);
+    }
     if (!result.content.empty()) {
         dict[@"content"] = [NSString stringWithUTF8String:result.content.c_str()];
     }
@@ -625,6 +1147,53 @@
     return dict;
 }
 
+// Hits of the same document share one NSString for the filename (filenames caches them by doc_id)
+- (NSDictionary *)dictionaryFromSearchHit:(const leafra::SearchHit&)hit
+                                filenames:(NSMutableDictionary<NSNumber *, NSString *> *)filenames {
+    NSMutableDictionary *dict = [NSMutableDictionary dictionary];
+    
+    dict[@"id"] = @(hit.id);
+    dict[@"distance"] = @(hit.distance);
+    
+    // Optional chunk metadata
+    if (hit.doc_id != -1) {
+        dict[@"docId"] = @(hit.doc_id);
+    }
+    if (hit.chunk_index != -1) {
+        dict[@"chunkIndex"] = @(hit.chunk_index);
+    }
+    if (hit.page_number != -1) {
+        dict[@"pageNumber"] = @(hit.page_number);
+    }
+    if (hit.text_start != -1 && hit.text_end != -1) {
+        dict[@"textStart"] = @(hit.text_start);
+        dict[@"textEnd"] = @(hit.text_end);
+    }
+    if (hit.page_text_start != -1) {
+        dict[@"pageTextStart"] = @(hit.page_text_start);
+    }
+    if (!hit.content.empty()) {
+        dict[@"content"] = [[NSString alloc] initWithBytes:hit.content.data()
+                                                    length:hit.content.size()
+                                                  encoding:NSUTF8StringEncoding];
+    }
+    if (!hit.filename.empty()) {
+        NSNumber *docKey = @(hit.doc_id);
+        NSString *filename = filenames[docKey];
+        if (!filename) {
+            filename = [[NSString alloc] initWithBytes:hit.filename.data()
+                                                length:hit.filename.size()
+                                              encoding:NSUTF8StringEncoding];
+            if (filename) {
+                filenames[docKey] = filename;
+            }
+        }
+        dict[@"filename"] = filename;
+    }
+    
+    return dict;
+}
+
 - (NSDictionary *)semanticSearch:(NSString *)query maxResults:(NSNumber *)maxResults error:(NSError **)error {
     if (!_coreSDK) {
         if (error) {
@@ -636,7 +1205,7 @@
     
     std::string queryString = [query UTF8String];
     int maxResultsInt = [maxResults intValue];
-    std::vector<leafra::FaissIndex::SearchResult> searchResults;
+    leafra::SearchResultSet searchResults;
     
     leafra::ResultCode result = _coreSDK->semantic_search(queryString, maxResultsInt, searchResults);
     
@@ -646,8 +1215,9 @@
     
     // Convert search results to NSArray
     NSMutableArray *resultsArray = [NSMutableArray arrayWithCapacity:searchResults.size()];
-    for (const auto& searchResult : searchResults) {
-        [resultsArray addObject:[self dictionaryFromSearchResult:searchResult]];
+    NSMutableDictionary<NSNumber *, NSString *> *filenames = [NSMutableDictionary dictionary];
+    for (const leafra::SearchHit& hit : searchResults) {
+        [resultsArray addObject:[self dictionaryFromSearchHit:hit filenames:filenames]];
     }
     
     return @{
@@ -670,9 +1240,13 @@
     std::vector<leafra::FaissIndex::SearchResult> searchResults;
     
     // Create token callback that sends tokens via React Native event emitter
+    // (llm.stream_flush_ms coalesces tokens into fewer, larger events delivered off the decode thread)
     auto tokenCallback = [self](const std::string& token, bool isEnd) -> bool {
-        if (_eventCallback) {
-            NSString *tokenString = [NSString stringWithUTF8String:token.c_str()];
+        if (_eventCallback && !token.empty()) {
+            NSString *tokenString = [[NSString alloc] initWithBytes:token.data() length:token.size() encoding:NSUTF8StringEncoding];
+            if (!tokenString) {
+                return true;
+            }
             
             dispatch_async(dispatch_get_main_queue(), ^{
                 // Send token event to React Native
@@ -706,4 +1280,8 @@
     _eventCallback = [callback copy];
 }
 
+- (std::shared_ptr<leafra::LeafraCore>)core {
+    return _coreSDK;
+}
+
 @end 
\ No newline at end of file
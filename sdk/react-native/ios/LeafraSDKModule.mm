@@ -2,6 +2,9 @@
 #import "LeafraSDKBridge.h"
 #import <React/RCTLog.h>
 #import <React/RCTUtils.h>
+#import <React/RCTBridge+Private.h>
+#import <ReactCommon/RCTTurboModule.h>
+#include "../cpp/LeafraSDKJSI.h"
 
 @interface LeafraSDKModule()
 @property (nonatomic, assign) BOOL hasListeners;
@@ -40,7 +43,7 @@ RCT_EXPORT_MODULE(LeafraSDK);
 }
 
 - (NSArray<NSString *> *)supportedEvents {
-    return @[@"LeafraSDKEvent", @"LeafraSDKTokenEvent"];
+    return @[@"LeafraSDKEvent", @"LeafraSDKTokenEvent", @"LeafraSDKIngestionProgress"];
 }
 
 - (void)startObserving {
@@ -64,6 +67,19 @@ RCT_EXPORT_MODULE(LeafraSDK);
     [[NSNotificationCenter defaultCenter] removeObserver:self];
 }
 
+#pragma mark - JSI
+
+// Installs global.LeafraSDKJSI (zero-copy results, coalesced token streaming); call once from JS before using it
+RCT_EXPORT_BLOCKING_SYNCHRONOUS_METHOD(install) {
+    RCTCxxBridge *cxxBridge = (RCTCxxBridge *)self.bridge;
+    if (!cxxBridge || !cxxBridge.runtime) {
+        RCTLogWarn(@"LeafraSDK JSI bindings need a JSI runtime (remote debugging is not supported)");
+        return @NO;
+    }
+    leafra::jsi_bindings::install(*(facebook::jsi::Runtime *)cxxBridge.runtime, cxxBridge.jsCallInvoker, [self.sdkBridge core]);
+    return @YES;
+}
+
 #pragma mark - SDK Methods
 
 RCT_EXPORT_METHOD(initialize:(NSDictionary *)config
@@ -137,7 +153,7 @@ RCT_EXPORT_METHOD(processData:(NSArray<NSNumber *> *)input
 RCT_EXPORT_METHOD(processUserFiles:(NSArray<NSString *> *)fileUrls
                   resolver:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject) {
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
         NSError *error = nil;
         NSDictionary *result = [self.sdkBridge processUserFiles:fileUrls error:&error];
         
@@ -151,6 +167,55 @@ RCT_EXPORT_METHOD(processUserFiles:(NSArray<NSString *> *)fileUrls
     });
 }
 
+RCT_EXPORT_METHOD(processUserFilesAsync:(NSArray<NSString *> *)fileUrls
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+    LeafraSDKModule* __weak weakSelf = self;
+    NSError *error = nil;
+    BOOL started = [self.sdkBridge processUserFilesAsync:fileUrls
+        progress:^(NSDictionary *progress) {
+            LeafraSDKModule* strongSelf = weakSelf;
+            if (strongSelf && strongSelf.hasListeners) {
+                [strongSelf sendEventWithName:@"LeafraSDKIngestionProgress" body:progress];
+            }
+        }
+        completion:^(NSDictionary *result) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                resolve(result);
+            });
+        }
+        error:&error];
+    
+    if (!started) {
+        reject(@"PROCESS_FILES_ERROR", error.localizedDescription, error);
+    }
+}
+
+RCT_EXPORT_METHOD(processDirectory:(NSString *)directoryUrl
+                  extensions:(NSArray<NSString *> *)extensions
+                  recursive:(BOOL)recursive
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        NSError *error = nil;
+        NSDictionary *result = [self.sdkBridge processDirectory:directoryUrl extensions:extensions recursive:recursive error:&error];
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (error) {
+                reject(@"PROCESS_DIRECTORY_ERROR", error.localizedDescription, error);
+            } else {
+                resolve(result);
+            }
+        });
+    });
+}
+
+RCT_EXPORT_METHOD(cancelProcessUserFiles:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+    [self.sdkBridge cancelUserFileProcessing];
+    resolve(@YES);
+}
+
 RCT_EXPORT_METHOD(calculateDistance2D:(NSDictionary *)p1
                   point2:(NSDictionary *)p2
                   resolver:(RCTPromiseResolveBlock)resolve
@@ -212,7 +277,7 @@ RCT_EXPORT_METHOD(semanticSearch:(NSString *)query
                   maxResults:(NSNumber *)maxResults
                   resolver:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject) {
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
         NSError *error = nil;
         NSDictionary *result = [self.sdkBridge semanticSearch:query maxResults:maxResults error:&error];
         
@@ -230,7 +295,7 @@ RCT_EXPORT_METHOD(semanticSearchWithLLM:(NSString *)query
                   maxResults:(NSNumber *)maxResults
                   resolver:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject) {
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
         NSError *error = nil;
         NSDictionary *result = [self.sdkBridge semanticSearchWithLLM:query maxResults:maxResults error:&error];
         